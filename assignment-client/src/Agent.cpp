@@ -53,8 +53,7 @@ static const int RECEIVED_AUDIO_STREAM_CAPACITY_FRAMES = 10;
 
 Agent::Agent(ReceivedMessage& message) :
     ThreadedAssignment(message),
-    _entityEditSender(),
-    _receivedAudioStream(RECEIVED_AUDIO_STREAM_CAPACITY_FRAMES, RECEIVED_AUDIO_STREAM_CAPACITY_FRAMES) {
+    _entityEditSender() {
     DependencyManager::get<EntityScriptingInterface>()->setPacketSender(&_entityEditSender);
 
     ResourceManager::init();
@@ -137,10 +136,15 @@ void Agent::handleJurisdictionPacket(QSharedPointer<ReceivedMessage> message, Sh
 }
 
 void Agent::handleAudioPacket(QSharedPointer<ReceivedMessage> message) {
-    _receivedAudioStream.parseData(*message);
+    if (!_receivedAudioStream) {
+        // we only keep a stream (and its decoder) while the script is listening
+        return;
+    }
 
-    _lastReceivedAudioLoudness = _receivedAudioStream.getNextOutputFrameLoudness();
-    _receivedAudioStream.clearBuffer();
+    _receivedAudioStream->parseData(*message);
+
+    _lastReceivedAudioLoudness = _receivedAudioStream->getNextOutputFrameLoudness();
+    _receivedAudioStream->clearBuffer();
 }
 
 const QString AGENT_LOGGING_NAME = "agent";
@@ -271,23 +275,41 @@ void Agent::selectAudioFormat(const QString& selectedCodecName) {
     qDebug() << "Selected Codec:" << _selectedCodecName;
 
     // release any old codec encoder/decoder first...
-    if (_codec && _encoder) {
-        _codec->releaseEncoder(_encoder);
-        _encoder = nullptr;
-        _codec = nullptr;
+    releaseEncoder();
+    _codec = nullptr;
+    if (_receivedAudioStream) {
+        _receivedAudioStream->cleanupCodec();
     }
-    _receivedAudioStream.cleanupCodec();
 
     auto codecPlugins = PluginManager::getInstance()->getCodecPlugins();
     for (auto& plugin : codecPlugins) {
         if (_selectedCodecName == plugin->getName()) {
             _codec = plugin;
-            _receivedAudioStream.setupCodec(plugin, _selectedCodecName, AudioConstants::STEREO); 
-            _encoder = plugin->createEncoder(AudioConstants::SAMPLE_RATE, AudioConstants::MONO);
             qDebug() << "Selected Codec Plugin:" << _codec.get();
             break;
         }
     }
+
+    // the encoder and decoder are only needed while we send and hear audio, most agents never do either
+    if (_receivedAudioStream) {
+        _receivedAudioStream->setupCodec(_codec, _selectedCodecName, AudioConstants::STEREO);
+    }
+    if (_isAvatar) {
+        createEncoder();
+    }
+}
+
+void Agent::createEncoder() {
+    if (_codec && !_encoder) {
+        _encoder = _codec->createEncoder(AudioConstants::SAMPLE_RATE, AudioConstants::MONO);
+    }
+}
+
+void Agent::releaseEncoder() {
+    if (_codec && _encoder) {
+        _codec->releaseEncoder(_encoder);
+        _encoder = nullptr;
+    }
 }
 
 void Agent::scriptRequestFinished() {
@@ -361,6 +383,7 @@ void Agent::executeScript() {
     packetReceiver.registerListener(PacketType::BulkAvatarData, avatarHashMap.data(), "processAvatarDataPacket");
     packetReceiver.registerListener(PacketType::KillAvatar, avatarHashMap.data(), "processKillAvatar");
     packetReceiver.registerListener(PacketType::AvatarIdentity, avatarHashMap.data(), "processAvatarIdentityPacket");
+    packetReceiver.registerListener(PacketType::AvatarEntityData, avatarHashMap.data(), "processAvatarEntityDataPacket");
 
     // register ourselves to the script engine
     _scriptEngine->registerGlobalObject("Agent", this);
@@ -392,7 +415,7 @@ void Agent::executeScript() {
     connect(this, &Agent::startAvatarAudioTimer, audioTimerWorker, &AvatarAudioTimer::start);
     connect(this, &Agent::stopAvatarAudioTimer, audioTimerWorker, &AvatarAudioTimer::stop);
     connect(&_avatarAudioTimerThread, &QThread::finished, audioTimerWorker, &QObject::deleteLater); 
-    _avatarAudioTimerThread.start();
+    // the thread is started by setIsAvatar, an agent that never becomes an avatar doesn't need it
     
     // 60Hz timer for avatar
     QObject::connect(_scriptEngine.get(), &ScriptEngine::update, this, &Agent::processAgentAvatar);
@@ -431,6 +454,15 @@ void Agent::setIsListeningToAudioStream(bool isListeningToAudioStream) {
 
     }
     _isListeningToAudioStream = isListeningToAudioStream; 
+
+    if (_isListeningToAudioStream && !_receivedAudioStream) {
+        _receivedAudioStream.reset(new MixedAudioStream(RECEIVED_AUDIO_STREAM_CAPACITY_FRAMES,
+                                                        RECEIVED_AUDIO_STREAM_CAPACITY_FRAMES));
+        _receivedAudioStream->setupCodec(_codec, _selectedCodecName, AudioConstants::STEREO);
+    } else if (!_isListeningToAudioStream) {
+        _receivedAudioStream.reset();
+        _lastReceivedAudioLoudness = 0.0f;
+    }
 }
 
 void Agent::setIsAvatar(bool isAvatar) {
@@ -451,7 +483,12 @@ void Agent::setIsAvatar(bool isAvatar) {
         // start the timers
         _avatarIdentityTimer->start(AVATAR_IDENTITY_PACKET_SEND_INTERVAL_MSECS);
 
+        createEncoder();
+
         // tell the avatarAudioTimer to start ticking
+        if (!_avatarAudioTimerThread.isRunning()) {
+            _avatarAudioTimerThread.start();
+        }
         emit startAvatarAudioTimer();
 
     }
@@ -481,6 +518,7 @@ void Agent::setIsAvatar(bool isAvatar) {
             });
         }
         emit stopAvatarAudioTimer();
+        releaseEncoder();
     }
 }
 
@@ -644,8 +682,6 @@ void Agent::aboutToFinish() {
     _avatarAudioTimerThread.quit();
 
     // cleanup codec & encoder
-    if (_codec && _encoder) {
-        _codec->releaseEncoder(_encoder);
-        _encoder = nullptr;
-    }
+    releaseEncoder();
+    _receivedAudioStream.reset();
 }
@@ -82,13 +82,15 @@ private:
     void negotiateAudioFormat();
     void selectAudioFormat(const QString& selectedCodecName);
     void encodeFrameOfZeros(QByteArray& encodedZeros);
+    void createEncoder();
+    void releaseEncoder();
 
     std::unique_ptr<ScriptEngine> _scriptEngine;
     EntityEditPacketSender _entityEditSender;
     EntityTreeHeadlessViewer _entityViewer;
 
-    MixedAudioStream _receivedAudioStream;
-    float _lastReceivedAudioLoudness;
+    std::unique_ptr<MixedAudioStream> _receivedAudioStream; // only while listening to the audio stream
+    float _lastReceivedAudioLoudness { 0.0f };
 
     void setAvatarSound(SharedSoundPointer avatarSound) { _avatarSound = avatarSound; }
 
@@ -25,7 +25,7 @@ public:
     AssignmentClient(Assignment::Type requestAssignmentType, QString assignmentPool,
                      quint16 listenPort,
                      QUuid walletUUID, QString assignmentServerHostname, quint16 assignmentServerPort,
-                     quint16 assignmentMonitorPort);
+                     quint16 assignmentMonitorPort, int numReceiveThreads = 1);
     ~AssignmentClient();
 private slots:
     void sendAssignmentRequest();
@@ -17,6 +17,7 @@
 #include <SharedUtil.h>
 #include <HifiConfigVariantMap.h>
 #include <ShutdownEventListener.h>
+#include <Trace.h>
 
 #include "Assignment.h"
 #include "AssignmentClient.h"
@@ -93,6 +94,18 @@ AssignmentClientApp::AssignmentClientApp(int argc, char* argv[]) :
     const QCommandLineOption logDirectoryOption(ASSIGNMENT_LOG_DIRECTORY, "directory to store logs", "log-directory");
     parser.addOption(logDirectoryOption);
 
+    const QCommandLineOption receiveThreadsOption(ASSIGNMENT_RECEIVE_THREADS_OPTION,
+                                                  "number of threads receiving UDP packets (Linux only)", "thread-count");
+    parser.addOption(receiveThreadsOption);
+
+    const QCommandLineOption traceOption(ASSIGNMENT_TRACE_OPTION,
+                                         "record a trace of all the threads from startup, to open in chrome://tracing", "trace-file");
+    parser.addOption(traceOption);
+
+    const QCommandLineOption traceDurationOption(ASSIGNMENT_TRACE_DURATION_OPTION,
+                                                 "seconds of the trace, 10 by default", "seconds");
+    parser.addOption(traceDurationOption);
+
     if (!parser.parse(QCoreApplication::arguments())) {
         qCritical() << parser.errorText() << endl;
         parser.showHelp();
@@ -136,6 +149,11 @@ AssignmentClientApp::AssignmentClientApp(int argc, char* argv[]) :
         httpStatusPort = parser.value(httpStatusPortOption).toUShort();
     }
 
+    int numReceiveThreads = 1;
+    if (parser.isSet(receiveThreadsOption)) {
+        numReceiveThreads = parser.value(receiveThreadsOption).toInt();
+    }
+
     QString logDirectory;
 
     if (parser.isSet(logDirectoryOption)) {
@@ -207,19 +225,29 @@ AssignmentClientApp::AssignmentClientApp(int argc, char* argv[]) :
 
     QThread::currentThread()->setObjectName("main thread");
 
+    if (parser.isSet(traceOption)) {
+        const int DEFAULT_TRACE_DURATION_SECONDS = 10;
+        int traceSeconds = DEFAULT_TRACE_DURATION_SECONDS;
+        if (parser.isSet(traceDurationOption)) {
+            traceSeconds = parser.value(traceDurationOption).toInt();
+        }
+        Tracer::record(parser.value(traceOption), traceSeconds);
+    }
+
     DependencyManager::registerInheritance<LimitedNodeList, NodeList>();
 
     if (numForks || minForks || maxForks) {
         AssignmentClientMonitor* monitor =  new AssignmentClientMonitor(numForks, minForks, maxForks,
                                                                         requestAssignmentType, assignmentPool,
                                                                         listenPort, walletUUID, assignmentServerHostname,
-                                                                        assignmentServerPort, httpStatusPort, logDirectory);
+                                                                        assignmentServerPort, httpStatusPort, logDirectory,
+                                                                        numReceiveThreads);
         monitor->setParent(this);
         connect(this, &QCoreApplication::aboutToQuit, monitor, &AssignmentClientMonitor::aboutToQuit);
     } else {
         AssignmentClient* client = new AssignmentClient(requestAssignmentType, assignmentPool, listenPort,
                                                         walletUUID, assignmentServerHostname,
-                                                        assignmentServerPort, monitorPort);
+                                                        assignmentServerPort, monitorPort, numReceiveThreads);
         client->setParent(this);
         connect(this, &QCoreApplication::aboutToQuit, client, &AssignmentClient::aboutToQuit);
     }
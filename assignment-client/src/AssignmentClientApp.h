@@ -27,6 +27,9 @@ const QString ASSIGNMENT_MAX_FORKS_OPTION = "max";
 const QString ASSIGNMENT_CLIENT_MONITOR_PORT_OPTION = "monitor-port";
 const QString ASSIGNMENT_HTTP_STATUS_PORT = "http-status-port";
 const QString ASSIGNMENT_LOG_DIRECTORY = "log-directory";
+const QString ASSIGNMENT_RECEIVE_THREADS_OPTION = "receive-threads";
+const QString ASSIGNMENT_TRACE_OPTION = "trace";
+const QString ASSIGNMENT_TRACE_DURATION_OPTION = "trace-duration";
 
 class AssignmentClientApp : public QCoreApplication {
     Q_OBJECT
@@ -33,7 +33,8 @@ AssignmentClientMonitor::AssignmentClientMonitor(const unsigned int numAssignmen
                                                  const unsigned int maxAssignmentClientForks,
                                                  Assignment::Type requestAssignmentType, QString assignmentPool,
                                                  quint16 listenPort, QUuid walletUUID, QString assignmentServerHostname,
-                                                 quint16 assignmentServerPort, quint16 httpStatusServerPort, QString logDirectory) :
+                                                 quint16 assignmentServerPort, quint16 httpStatusServerPort, QString logDirectory,
+                                                 int numReceiveThreads) :
     _httpManager(QHostAddress::LocalHost, httpStatusServerPort, "", this),
     _numAssignmentClientForks(numAssignmentClientForks),
     _minAssignmentClientForks(minAssignmentClientForks),
@@ -42,7 +43,8 @@ AssignmentClientMonitor::AssignmentClientMonitor(const unsigned int numAssignmen
     _assignmentPool(assignmentPool),
     _walletUUID(walletUUID),
     _assignmentServerHostname(assignmentServerHostname),
-    _assignmentServerPort(assignmentServerPort)
+    _assignmentServerPort(assignmentServerPort),
+    _numReceiveThreads(numReceiveThreads)
 
 {
     qDebug() << "_requestAssignmentType =" << _requestAssignmentType;
@@ -154,6 +156,10 @@ void AssignmentClientMonitor::spawnChildClient() {
         _childArguments.append("--" + ASSIGNMENT_TYPE_OVERRIDE_OPTION);
         _childArguments.append(QString::number(_requestAssignmentType));
     }
+    if (_numReceiveThreads > 1) {
+        _childArguments.append("--" + ASSIGNMENT_RECEIVE_THREADS_OPTION);
+        _childArguments.append(QString::number(_numReceiveThreads));
+    }
 
     // tell children which assignment monitor port to use
     // for now they simply talk to us on localhost
@@ -38,7 +38,8 @@ public:
     AssignmentClientMonitor(const unsigned int numAssignmentClientForks, const unsigned int minAssignmentClientForks,
                             const unsigned int maxAssignmentClientForks, Assignment::Type requestAssignmentType,
                             QString assignmentPool, quint16 listenPort, QUuid walletUUID, QString assignmentServerHostname,
-                            quint16 assignmentServerPort, quint16 httpStatusServerPort, QString logDirectory);
+                            quint16 assignmentServerPort, quint16 httpStatusServerPort, QString logDirectory,
+                            int numReceiveThreads = 1);
     ~AssignmentClientMonitor();
 
     void stopChildProcesses();
@@ -71,6 +72,7 @@ private:
     QUuid _walletUUID;
     QString _assignmentServerHostname;
     quint16 _assignmentServerPort;
+    int _numReceiveThreads;
 
     QMap<qint64, ACProcess> _childProcesses;
 
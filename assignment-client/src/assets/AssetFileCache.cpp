@@ -0,0 +1,101 @@
+//
+//  AssetFileCache.cpp
+//  assignment-client/src/assets
+//
+//  Created by Sam Gateau on 10/15/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AssetFileCache.h"
+
+#include <QtCore/QFile>
+
+AssetFileCache::AssetFileCache(const QDir& filesDirectory, qint64 maxSize, qint64 maxFileSize) :
+    _filesDirectory(filesDirectory),
+    _maxSize(maxSize),
+    _maxFileSize(maxFileSize)
+{
+}
+
+QByteArray AssetFileCache::getFile(const AssetHash& hash) {
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    auto it = _entries.find(hash);
+    if (it != _entries.end()) {
+        // wait for the request reading the file, the entry is gone if that read failed
+        _loaded.wait(lock, [&] {
+            it = _entries.find(hash);
+            return it == _entries.end() || !it->isLoading;
+        });
+        if (it == _entries.end()) {
+            return QByteArray();
+        }
+        touch(*it, hash);
+        return it->data;
+    }
+
+    // read the file outside of the lock, the other requests for it wait on the loading entry
+    _entries.insert(hash, Entry());
+    lock.unlock();
+
+    QByteArray data;
+    QFile file { _filesDirectory.filePath(hash) };
+    if (file.open(QIODevice::ReadOnly) && file.size() <= _maxFileSize) {
+        data = file.readAll();
+    }
+
+    lock.lock();
+    it = _entries.find(hash);
+    if (it != _entries.end()) {
+        if (data.isEmpty()) {
+            _entries.erase(it);
+        } else {
+            it->data = data;
+            it->isLoading = false;
+            touch(*it, hash);
+            _size += data.size();
+            evict();
+        }
+    }
+    _loaded.notify_all();
+
+    return data.isEmpty() ? QByteArray() : data;
+}
+
+void AssetFileCache::removeFile(const AssetHash& hash) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto it = _entries.find(hash);
+    if (it != _entries.end()) {
+        if (!it->isLoading) {
+            _lru.remove(it->lruKey);
+            _size -= it->data.size();
+        }
+        _entries.erase(it);
+        _loaded.notify_all();
+    }
+}
+
+void AssetFileCache::touch(Entry& entry, const AssetHash& hash) {
+    if (entry.lruKey != 0) {
+        _lru.remove(entry.lruKey);
+    }
+    entry.lruKey = ++_lastLRUKey;
+    _lru.insert(entry.lruKey, hash);
+}
+
+void AssetFileCache::evict() {
+    // drop the least recently requested files, the requests still sending them hold their own reference
+    while (_size > _maxSize && !_lru.isEmpty()) {
+        auto oldest = _lru.begin();
+        auto it = _entries.find(oldest.value());
+        if (it != _entries.end()) {
+            _size -= it->data.size();
+            _entries.erase(it);
+        }
+        _lru.erase(oldest);
+    }
+}
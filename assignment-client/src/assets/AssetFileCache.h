@@ -0,0 +1,61 @@
+//
+//  AssetFileCache.h
+//  assignment-client/src/assets
+//
+//  Created by Sam Gateau on 10/15/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AssetFileCache_h
+#define hifi_AssetFileCache_h
+
+#include <condition_variable>
+#include <mutex>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QDir>
+#include <QtCore/QHash>
+#include <QtCore/QMap>
+
+#include "AssetUtils.h"
+
+// Keeps the content of the most requested asset files in memory, so a crowd entering a domain at once
+// doesn't read the same avatars and skyboxes from disk for every client.
+// The requests for a file still being read wait for that read instead of reading it again.
+class AssetFileCache {
+public:
+    AssetFileCache(const QDir& filesDirectory, qint64 maxSize, qint64 maxFileSize);
+
+    /// Returns the content of the asset file, shared with the other requests for it.
+    /// Returns a null array if the file is too large to be cached or can't be read, the caller reads it itself.
+    QByteArray getFile(const AssetHash& hash);
+
+    /// Drops the file from the cache, to be called when the file is deleted
+    void removeFile(const AssetHash& hash);
+
+private:
+    struct Entry {
+        QByteArray data;
+        bool isLoading { true };
+        quint64 lruKey { 0 };
+    };
+
+    void touch(Entry& entry, const AssetHash& hash);
+    void evict();
+
+    const QDir _filesDirectory;
+    const qint64 _maxSize;
+    const qint64 _maxFileSize;
+
+    std::mutex _mutex;
+    std::condition_variable _loaded;
+    QHash<AssetHash, Entry> _entries;
+    QMap<quint64, AssetHash> _lru;
+    quint64 _lastLRUKey { 0 };
+    qint64 _size { 0 };
+};
+
+#endif // hifi_AssetFileCache_h
@@ -12,21 +12,31 @@
 
 #include "AssetServer.h"
 
+#include <algorithm>
+
 #include <QtCore/QCoreApplication>
 #include <QtCore/QCryptographicHash>
 #include <QtCore/QDateTime>
 #include <QtCore/QDir>
 #include <QtCore/QFile>
 #include <QtCore/QFileInfo>
+#include <QtCore/QJsonArray>
 #include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QMessageAuthenticationCode>
+#include <QtCore/QSaveFile>
 #include <QtCore/QString>
+#include <QtCore/QUrlQuery>
 
+#include <ResourceManager.h>
 #include <ServerPathUtils.h>
 
 #include "NetworkLogging.h"
 #include "NodeType.h"
+#include "AssetFileCache.h"
 #include "SendAssetTask.h"
 #include "UploadAssetTask.h"
+#include "udt/BBRCC.h"
 
 const QString ASSET_SERVER_LOGGING_TARGET_NAME = "asset-server";
 
@@ -47,6 +57,10 @@ AssetServer::AssetServer(ReceivedMessage& message) :
     packetReceiver.registerListener(PacketType::AssetMappingOperation, this, "handleAssetMappingOperation");
 }
 
+AssetServer::~AssetServer() {
+    // the task pool is destroyed first and waits for the tasks still reading from the file cache
+}
+
 void AssetServer::run() {
 
     qDebug() << "Waiting for connection to domain to request settings from domain-server.";
@@ -89,6 +103,34 @@ void AssetServer::completeSetup() {
                     " (" << maxBandwidth << "bits/s)";
     }
 
+    // pick the congestion control for the connections that transfer assets, Vegas unless BBR is asked for
+    static const QString CONGESTION_CONTROL_OPTION = "congestion_control";
+    static const QString BBR_CONGESTION_CONTROL = "bbr";
+    if (assetServerObject[CONGESTION_CONTROL_OPTION].toString() == BBR_CONGESTION_CONTROL) {
+        nodeList->setCongestionControlFactory(std::unique_ptr<udt::CongestionControlVirtualFactory> {
+            new udt::CongestionControlFactory<udt::BBRCC>()
+        });
+        qInfo() << "Using BBR congestion control for asset transfers.";
+    }
+
+    // the files directory may be mirrored on an http server or CDN, the clients then download the files from there
+    static const QString MIRROR_URL_OPTION = "mirror_url";
+    static const QString MIRROR_SIGNING_KEY_OPTION = "mirror_signing_key";
+    auto mirrorURLString = assetServerObject[MIRROR_URL_OPTION].toString();
+    if (!mirrorURLString.isEmpty()) {
+        if (!mirrorURLString.endsWith('/')) {
+            mirrorURLString += '/';
+        }
+        _mirrorURL = QUrl(mirrorURLString);
+        if (_mirrorURL.isValid() && (_mirrorURL.scheme() == URL_SCHEME_HTTP || _mirrorURL.scheme() == URL_SCHEME_HTTPS)) {
+            _mirrorSigningKey = assetServerObject[MIRROR_SIGNING_KEY_OPTION].toString();
+            qInfo() << "Clients will download the asset files from the mirror at" << _mirrorURL.toDisplayString();
+        } else {
+            qWarning() << "Ignoring the asset files mirror url" << mirrorURLString << "- it is not an http url.";
+            _mirrorURL = QUrl();
+        }
+    }
+
     // get the path to the asset folder from the domain server settings
     static const QString ASSETS_PATH_OPTION = "assets_path";
     auto assetsJSONValue = assetServerObject[ASSETS_PATH_OPTION];
@@ -121,6 +163,11 @@ void AssetServer::completeSetup() {
         return;
     }
 
+    // The hot files are kept in memory up to these sizes, the larger files are always streamed from the disk
+    static const qint64 MAX_FILE_CACHE_SIZE = 512 * 1024 * 1024;
+    static const qint64 MAX_CACHED_FILE_SIZE = 64 * 1024 * 1024;
+    _fileCache.reset(new AssetFileCache(_filesDirectory, MAX_FILE_CACHE_SIZE, MAX_CACHED_FILE_SIZE));
+
     // load whatever mappings we currently have from the local file
     if (loadMappingsFromFile()) {
         qInfo() << "Serving files from: " << _filesDirectory.path();
@@ -150,14 +197,11 @@ void AssetServer::cleanupUnmappedFiles() {
 
     auto files = _filesDirectory.entryInfoList(QDir::Files);
 
-    // grab the currently mapped hashes
-    auto mappedHashes = _fileMappings.values();
-
     qInfo() << "Performing unmapped asset cleanup.";
 
     for (const auto& fileInfo : files) {
         if (hashFileRegex.exactMatch(fileInfo.fileName())) {
-            if (!mappedHashes.contains(fileInfo.fileName())) {
+            if (!_hashMappingCounts.contains(fileInfo.fileName())) {
                 // remove the unmapped file
                 QFile removeableFile { fileInfo.absoluteFilePath() };
 
@@ -213,7 +257,7 @@ void AssetServer::handleGetMappingOperation(ReceivedMessage& message, SharedNode
 
     auto it = _fileMappings.find(assetPath);
     if (it != _fileMappings.end()) {
-        auto assetHash = it->toString();
+        auto assetHash = it.value();
         replyPacket.writePrimitive(AssetServerError::NoError);
         replyPacket.write(QByteArray::fromHex(assetHash.toUtf8()));
     } else {
@@ -222,25 +266,57 @@ void AssetServer::handleGetMappingOperation(ReceivedMessage& message, SharedNode
 }
 
 void AssetServer::handleGetAllMappingOperation(ReceivedMessage& message, SharedNodePointer senderNode, NLPacketList& replyPacket) {
-    replyPacket.writePrimitive(AssetServerError::NoError);
+    // the mappings are sent by pages: the paths starting with the prefix, after the last path of the previous page
+    AssetPath prefix = message.readString();
+    AssetPath startAfter = message.readString();
+
+    int limit { 0 };
+    message.readPrimitive(&limit);
 
-    auto count = _fileMappings.size();
+    auto begin = _fileMappings.lowerBound(prefix);
+    if (!startAfter.isEmpty() && startAfter >= prefix) {
+        begin = _fileMappings.upperBound(startAfter);
+    }
+
+    auto isInPage = [&](Mappings::iterator it) {
+        return it != _fileMappings.end() && it.key().startsWith(prefix);
+    };
+
+    int count = 0;
+    auto end = begin;
+    while (isInPage(end) && (limit <= 0 || count < limit)) {
+        ++end;
+        ++count;
+    }
+
+    replyPacket.writePrimitive(AssetServerError::NoError);
 
     replyPacket.writePrimitive(count);
 
-    for (auto it = _fileMappings.cbegin(); it != _fileMappings.cend(); ++ it) {
+    for (auto it = begin; it != end; ++it) {
         replyPacket.writeString(it.key());
-        replyPacket.write(QByteArray::fromHex(it.value().toString().toUtf8()));
+        replyPacket.write(QByteArray::fromHex(it.value().toUtf8()));
     }
+
+    uint8_t hasMore = isInPage(end) ? 1 : 0;
+    replyPacket.writePrimitive(hasMore);
 }
 
 void AssetServer::handleSetMappingOperation(ReceivedMessage& message, SharedNodePointer senderNode, NLPacketList& replyPacket) {
     if (senderNode->getCanWriteToAssetServer()) {
-        QString assetPath = message.readString();
+        int numberOfMappings { 0 };
+        message.readPrimitive(&numberOfMappings);
 
-        auto assetHash = message.read(SHA256_HASH_LENGTH).toHex();
+        Mappings mappings;
 
-        if (setMapping(assetPath, assetHash)) {
+        for (int i = 0; i < numberOfMappings; ++i) {
+            QString assetPath = message.readString();
+            auto assetHash = message.read(SHA256_HASH_LENGTH).toHex();
+
+            mappings.insert(assetPath, assetHash);
+        }
+
+        if (setMappings(mappings)) {
             replyPacket.writePrimitive(AssetServerError::NoError);
         } else {
             replyPacket.writePrimitive(AssetServerError::MappingOperationFailed);
@@ -298,8 +374,7 @@ void AssetServer::handleAssetGetInfo(QSharedPointer<ReceivedMessage> message, Sh
     message->readPrimitive(&messageID);
     assetHash = message->readWithoutCopy(SHA256_HASH_LENGTH);
 
-    auto size = qint64(sizeof(MessageID) + SHA256_HASH_LENGTH + sizeof(AssetServerError) + sizeof(qint64));
-    auto replyPacket = NLPacket::create(PacketType::AssetGetInfoReply, size, true);
+    auto replyPacket = NLPacket::create(PacketType::AssetGetInfoReply, -1, true);
 
     QByteArray hexHash = assetHash.toHex();
 
@@ -313,6 +388,7 @@ void AssetServer::handleAssetGetInfo(QSharedPointer<ReceivedMessage> message, Sh
         qDebug() << "Opening file: " << fileInfo.filePath();
         replyPacket->writePrimitive(AssetServerError::NoError);
         replyPacket->writePrimitive(fileInfo.size());
+        replyPacket->writeString(_mirrorURL.isValid() ? getMirrorURL(fileName).toString() : QString());
     } else {
         qDebug() << "Asset not found: " << QString(hexHash);
         replyPacket->writePrimitive(AssetServerError::AssetNotFound);
@@ -322,6 +398,25 @@ void AssetServer::handleAssetGetInfo(QSharedPointer<ReceivedMessage> message, Sh
     nodeList->sendPacket(std::move(replyPacket), *senderNode);
 }
 
+QUrl AssetServer::getMirrorURL(const QString& hexHash) const {
+    QUrl url = _mirrorURL.resolved(QUrl(hexHash));
+
+    if (!_mirrorSigningKey.isEmpty()) {
+        // the mirror checks the HMAC of the path and expiry time, so the links handed out can't be reused for long
+        static const qint64 MIRROR_URL_LIFETIME_SECS = 60 * 60;
+        auto expires = QString::number(QDateTime::currentDateTimeUtc().toTime_t() + MIRROR_URL_LIFETIME_SECS);
+        auto signature = QMessageAuthenticationCode::hash((url.path() + expires).toUtf8(), _mirrorSigningKey.toUtf8(),
+                                                          QCryptographicHash::Sha256).toHex();
+
+        QUrlQuery query;
+        query.addQueryItem("expires", expires);
+        query.addQueryItem("signature", QString(signature));
+        url.setQuery(query);
+    }
+
+    return url;
+}
+
 void AssetServer::handleAssetGet(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
 
     auto minSize = qint64(sizeof(MessageID) + SHA256_HASH_LENGTH + sizeof(DataOffset) + sizeof(DataOffset));
@@ -332,7 +427,7 @@ void AssetServer::handleAssetGet(QSharedPointer<ReceivedMessage> message, Shared
     }
 
     // Queue task
-    auto task = new SendAssetTask(message, senderNode, _filesDirectory);
+    auto task = new SendAssetTask(message, senderNode, _filesDirectory, *_fileCache, _assetGetUsecs);
     _taskPool.start(task);
 }
 
@@ -386,6 +481,8 @@ void AssetServer::sendStatsPacket() {
         connectionStats["5. Period (us)"] = stat.second.packetSendPeriod;
         connectionStats["6. Up (Mb/s)"] = stat.second.sentBytes * megabitsPerSecPerByte;
         connectionStats["7. Down (Mb/s)"] = stat.second.receivedBytes * megabitsPerSecPerByte;
+        connectionStats["8. Bottleneck (P/s)"] = stat.second.bottleneckBandwidth;
+        connectionStats["9. Min RTT (us)"] = stat.second.minRTT;
         nodeStats["Connection Stats"] = connectionStats;
 
         using Events = udt::ConnectionStats::Stats::Event;
@@ -428,72 +525,133 @@ void AssetServer::sendStatsPacket() {
         serverStats[uuid] = nodeStats;
     }
 
+    QJsonObject metrics;
+    metrics["asset_get_usecs"] = _assetGetUsecs.takeSnapshot().toJson();
+    serverStats[STATS_METRICS_KEY] = metrics;
+
     // send off the stats packets
     ThreadedAssignment::addPacketStatsAndSendStatsPacket(serverStats);
 }
 
 static const QString MAP_FILE_NAME = "map.json";
 
+// The mapping changes are appended to this log, and folded into the map file once the log gets long
+static const QString MAP_LOG_FILE_NAME = "map.log";
+static const int MIN_LOGGED_MAPPING_CHANGES_BEFORE_SNAPSHOT = 10000;
+
+static const QString LOG_SET_KEY = "set";
+static const QString LOG_DELETE_KEY = "delete";
+
 bool AssetServer::loadMappingsFromFile() {
 
     auto mapFilePath = _resourcesDirectory.absoluteFilePath(MAP_FILE_NAME);
 
+    Mappings mappings;
+
     QFile mapFile { mapFilePath };
     if (mapFile.exists()) {
+        QJsonParseError error;
+        QJsonDocument jsonDocument;
+
         if (mapFile.open(QIODevice::ReadOnly)) {
-            QJsonParseError error;
+            jsonDocument = QJsonDocument::fromJson(mapFile.readAll(), &error);
+        }
+
+        if (!mapFile.isOpen() || error.error != QJsonParseError::NoError) {
+            qCritical() << "Failed to read mapping file at" << mapFilePath;
+            return false;
+        }
 
-            auto jsonDocument = QJsonDocument::fromJson(mapFile.readAll(), &error);
+        auto jsonObject = jsonDocument.object();
+        for (auto it = jsonObject.constBegin(); it != jsonObject.constEnd(); ++it) {
+            mappings.insert(it.key(), it.value().toString());
+        }
+    } else {
+        qInfo() << "No existing mappings loaded from file since no file was found at" << mapFilePath;
+    }
 
-            if (error.error == QJsonParseError::NoError) {
-                _fileMappings = jsonDocument.object().toVariantHash();
+    // replay the changes made since the map file was written
+    auto logFilePath = _resourcesDirectory.absoluteFilePath(MAP_LOG_FILE_NAME);
 
-                // remove any mappings that don't match the expected format
-                auto it = _fileMappings.begin();
-                while (it != _fileMappings.end()) {
-                    bool shouldDrop = false;
+    QFile logFile { logFilePath };
+    if (logFile.exists()) {
+        if (!logFile.open(QIODevice::ReadOnly)) {
+            qCritical() << "Failed to read mapping log file at" << logFilePath;
+            return false;
+        }
 
-                    if (!isValidFilePath(it.key())) {
-                        qWarning() << "Will not keep mapping for" << it.key() << "since it is not a valid path.";
-                        shouldDrop = true;
-                    }
+        while (!logFile.atEnd()) {
+            QJsonParseError error;
+            auto entry = QJsonDocument::fromJson(logFile.readLine(), &error).object();
 
-                    if (!isValidHash(it.value().toString())) {
-                        qWarning() << "Will not keep mapping for" << it.key() << "since it does not have a valid hash.";
-                        shouldDrop = true;
-                    }
+            if (error.error != QJsonParseError::NoError) {
+                // only the last change can be cut short, by a crash while it was appended, it was never acknowledged
+                qWarning() << "Ignoring an incomplete mapping change at the end of" << logFilePath;
+                break;
+            }
 
-                    if (shouldDrop) {
-                        it = _fileMappings.erase(it);
-                    } else {
-                        ++it;
-                    }
-                }
+            for (const auto& path : entry[LOG_DELETE_KEY].toArray()) {
+                mappings.remove(path.toString());
+            }
 
-                qInfo() << "Loaded" << _fileMappings.count() << "mappings from map file at" << mapFilePath;
-                return true;
+            auto setMappings = entry[LOG_SET_KEY].toObject();
+            for (auto it = setMappings.constBegin(); it != setMappings.constEnd(); ++it) {
+                mappings.insert(it.key(), it.value().toString());
             }
+
+            _numLoggedMappingChanges += setMappings.size() + entry[LOG_DELETE_KEY].toArray().size();
         }
+    }
 
-        qCritical() << "Failed to read mapping file at" << mapFilePath;
-        return false;
-    } else {
-        qInfo() << "No existing mappings loaded from file since no file was found at" << mapFilePath;
+    // remove any mappings that don't match the expected format
+    _fileMappings.clear();
+    _hashMappingCounts.clear();
+
+    for (auto it = mappings.constBegin(); it != mappings.constEnd(); ++it) {
+        bool shouldDrop = false;
+
+        if (!isValidFilePath(it.key())) {
+            qWarning() << "Will not keep mapping for" << it.key() << "since it is not a valid path.";
+            shouldDrop = true;
+        }
+
+        if (!isValidHash(it.value())) {
+            qWarning() << "Will not keep mapping for" << it.key() << "since it does not have a valid hash.";
+            shouldDrop = true;
+        }
+
+        if (!shouldDrop) {
+            insertMapping(it.key(), it.value());
+        }
     }
 
+    qInfo() << "Loaded" << _fileMappings.count() << "mappings from map file at" << mapFilePath
+        << "and" << _numLoggedMappingChanges << "changes from" << logFilePath;
     return true;
 }
 
 bool AssetServer::writeMappingsToFile() {
     auto mapFilePath = _resourcesDirectory.absoluteFilePath(MAP_FILE_NAME);
 
-    QFile mapFile { mapFilePath };
-    if (mapFile.open(QIODevice::WriteOnly)) {
-        auto jsonObject = QJsonObject::fromVariantHash(_fileMappings);
-        QJsonDocument jsonDocument { jsonObject };
+    QJsonObject jsonObject;
+    for (auto it = _fileMappings.constBegin(); it != _fileMappings.constEnd(); ++it) {
+        jsonObject.insert(it.key(), it.value());
+    }
+    QJsonDocument jsonDocument { jsonObject };
 
-        if (mapFile.write(jsonDocument.toJson()) != -1) {
+    // replace the map file at once, so a crash can't leave half of it behind
+    QSaveFile mapFile { mapFilePath };
+    if (mapFile.open(QIODevice::WriteOnly)) {
+        if (mapFile.write(jsonDocument.toJson()) != -1 && mapFile.commit()) {
             qDebug() << "Wrote JSON mappings to file at" << mapFilePath;
+
+            // the map file now has all the logged changes
+            QFile logFile { _resourcesDirectory.absoluteFilePath(MAP_LOG_FILE_NAME) };
+            if (logFile.exists() && !logFile.resize(0)) {
+                qWarning() << "Failed to clear the mapping log file, its changes will be replayed on the map file";
+            }
+            _numLoggedMappingChanges = 0;
+
             return true;
         } else {
             qWarning() << "Failed to write JSON mappings to file at" << mapFilePath;
@@ -505,40 +663,120 @@ bool AssetServer::writeMappingsToFile() {
     return false;
 }
 
-bool AssetServer::setMapping(AssetPath path, AssetHash hash) {
-    path = path.trimmed();
+bool AssetServer::writeMappingChangesToFile(const Mappings& setMappings, const AssetPathList& deletedPaths) {
+    auto logFilePath = _resourcesDirectory.absoluteFilePath(MAP_LOG_FILE_NAME);
 
-    if (!isValidFilePath(path)) {
-        qWarning() << "Cannot set a mapping for invalid path:" << path << "=>" << hash;
-        return false;
+    QJsonObject setObject;
+    for (auto it = setMappings.constBegin(); it != setMappings.constEnd(); ++it) {
+        setObject.insert(it.key(), it.value());
+    }
+
+    QJsonObject entry;
+    entry[LOG_SET_KEY] = setObject;
+    entry[LOG_DELETE_KEY] = QJsonArray::fromStringList(deletedPaths);
+
+    // one change per line, written and flushed before the change is acknowledged
+    auto line = QJsonDocument(entry).toJson(QJsonDocument::Compact) + '\n';
+
+    QFile logFile { logFilePath };
+    if (logFile.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        auto sizeBefore = logFile.size();
+
+        if (logFile.write(line) == line.size() && logFile.flush()) {
+            _numLoggedMappingChanges += setMappings.size() + deletedPaths.size();
+            return true;
+        }
+
+        qWarning() << "Failed to write mapping changes to log file at" << logFilePath;
+
+        // don't leave a partial line followed by the next changes
+        logFile.resize(sizeBefore);
+    } else {
+        qWarning() << "Failed to open mapping log file at" << logFilePath;
     }
 
-    if (!isValidHash(hash)) {
-        qWarning() << "Cannot set a mapping for invalid hash" << path << "=>" << hash;
+    return false;
+}
+
+bool AssetServer::commitMappingChanges(const Mappings& setMappings, const AssetPathList& deletedPaths) {
+    if (!writeMappingChangesToFile(setMappings, deletedPaths)) {
         return false;
     }
 
-    // remember what the old mapping was in case persistence fails
-    auto oldMapping = _fileMappings.value(path).toString();
+    for (const auto& path : deletedPaths) {
+        removeMapping(path);
+    }
 
-    // update the in memory QHash
-    _fileMappings[path] = hash;
+    for (auto it = setMappings.constBegin(); it != setMappings.constEnd(); ++it) {
+        insertMapping(it.key(), it.value());
+    }
 
-    // attempt to write to file
-    if (writeMappingsToFile()) {
-        // persistence succeeded, we are good to go
-        qDebug() << "Set mapping:" << path << "=>" << hash;
-        return true;
-    } else {
-        // failed to persist this mapping to file - put back the old one in our in-memory representation
-        if (oldMapping.isEmpty()) {
-            _fileMappings.remove(path);
-        } else {
-            _fileMappings[path] = oldMapping;
+    // fold the log into the map file once it has about as many changes as there are mappings,
+    // so rewriting the map file stays a small cost per change
+    if (_numLoggedMappingChanges >= std::max(MIN_LOGGED_MAPPING_CHANGES_BEFORE_SNAPSHOT, _fileMappings.size())) {
+        writeMappingsToFile();
+    }
+
+    return true;
+}
+
+void AssetServer::insertMapping(const AssetPath& path, const AssetHash& hash) {
+    auto it = _fileMappings.find(path);
+    if (it != _fileMappings.end()) {
+        if (it.value() == hash) {
+            return;
         }
+        removeMapping(path);
+    }
+
+    _fileMappings.insert(path, hash);
+    ++_hashMappingCounts[hash];
+}
+
+void AssetServer::removeMapping(const AssetPath& path) {
+    auto it = _fileMappings.find(path);
+    if (it == _fileMappings.end()) {
+        return;
+    }
+
+    auto countIt = _hashMappingCounts.find(it.value());
+    if (countIt != _hashMappingCounts.end() && --countIt.value() <= 0) {
+        _hashMappingCounts.erase(countIt);
+    }
+
+    _fileMappings.erase(it);
+}
 
-        qWarning() << "Failed to persist mapping:" << path << "=>" << hash;
+bool AssetServer::setMappings(const Mappings& mappings) {
+    Mappings validMappings;
 
+    for (auto it = mappings.constBegin(); it != mappings.constEnd(); ++it) {
+        auto path = it.key().trimmed();
+        auto& hash = it.value();
+
+        if (!isValidFilePath(path)) {
+            qWarning() << "Cannot set a mapping for invalid path:" << path << "=>" << hash;
+            return false;
+        }
+
+        if (!isValidHash(hash)) {
+            qWarning() << "Cannot set a mapping for invalid hash" << path << "=>" << hash;
+            return false;
+        }
+
+        validMappings.insert(path, hash);
+    }
+
+    // attempt to write to file, the in memory mappings only change once that succeeded
+    if (commitMappingChanges(validMappings, AssetPathList())) {
+        if (validMappings.size() == 1) {
+            qDebug() << "Set mapping:" << validMappings.firstKey() << "=>" << validMappings.first();
+        } else {
+            qDebug() << "Set" << validMappings.size() << "mappings";
+        }
+        return true;
+    } else {
+        qWarning() << "Failed to persist" << validMappings.size() << "mappings";
         return false;
     }
 }
@@ -548,72 +786,57 @@ bool pathIsFolder(const AssetPath& path) {
 }
 
 bool AssetServer::deleteMappings(AssetPathList& paths) {
-    // take a copy of the current mappings in case persistence of these deletes fails
-    auto oldMappings = _fileMappings;
-
+    AssetPathList deletedPaths;
     QSet<QString> hashesToCheckForDeletion;
 
-    // enumerate the paths to delete and remove them all
+    // enumerate the paths to delete
     for (auto& path : paths) {
 
         path = path.trimmed();
 
         // figure out if this path will delete a file or folder
         if (pathIsFolder(path)) {
-            // enumerate the in memory file mappings and remove anything that matches
-            auto it = _fileMappings.begin();
-            auto sizeBefore = _fileMappings.size();
-
-            while (it != _fileMappings.end()) {
-                if (it.key().startsWith(path)) {
-                    // add this hash to the list we need to check for asset removal from the server
-                    hashesToCheckForDeletion << it.value().toString();
-
-                    it = _fileMappings.erase(it);
-                } else {
-                    ++it;
-                }
+            // the mappings in the folder are the range of paths starting with it
+            int numDeleted = 0;
+
+            for (auto it = _fileMappings.lowerBound(path); it != _fileMappings.end() && it.key().startsWith(path); ++it) {
+                // add this hash to the list we need to check for asset removal from the server
+                hashesToCheckForDeletion << it.value();
+                deletedPaths << it.key();
+                ++numDeleted;
             }
 
-            auto sizeNow = _fileMappings.size();
-            if (sizeBefore != sizeNow) {
-                qDebug() << "Deleted" << sizeBefore - sizeNow << "mappings in folder: " << path;
+            if (numDeleted > 0) {
+                qDebug() << "Deleted" << numDeleted << "mappings in folder: " << path;
             } else {
                 qDebug() << "Did not find any mappings to delete in folder:" << path;
             }
 
         } else {
-            auto oldMapping = _fileMappings.take(path);
-            if (!oldMapping.isNull()) {
+            auto it = _fileMappings.find(path);
+            if (it != _fileMappings.end()) {
                 // add this hash to the list we need to check for asset removal from server
-                hashesToCheckForDeletion << oldMapping.toString();
+                hashesToCheckForDeletion << it.value();
+                deletedPaths << path;
 
-                qDebug() << "Deleted a mapping:" << path << "=>" << oldMapping.toString();
+                qDebug() << "Deleted a mapping:" << path << "=>" << it.value();
             } else {
                 qDebug() << "Unable to delete a mapping that was not found:" << path;
             }
         }
     }
 
-    // deleted the old mappings, attempt to persist to file
-    if (writeMappingsToFile()) {
-        // persistence succeeded we are good to go
-
-        // grab the current mapped hashes
-        auto mappedHashes = _fileMappings.values();
-
-        // enumerate the mapped hashes and clear the list of hashes to check for anything that's present
-        for (auto& hashVariant : mappedHashes) {
-            auto it = hashesToCheckForDeletion.find(hashVariant.toString());
-            if (it != hashesToCheckForDeletion.end()) {
-                hashesToCheckForDeletion.erase(it);
+    // attempt to persist the deletes, the in memory mappings only change once that succeeded
+    if (commitMappingChanges(Mappings(), deletedPaths)) {
+        // we now have a set of hashes, the ones no other path maps to are unmapped - we will delete those asset files
+        for (auto& hash : hashesToCheckForDeletion) {
+            if (_hashMappingCounts.contains(hash)) {
+                continue;
             }
-        }
 
-        // we now have a set of hashes that are unmapped - we will delete those asset files
-        for (auto& hash : hashesToCheckForDeletion) {
             // remove the unmapped file
             QFile removeableFile { _filesDirectory.absoluteFilePath(hash) };
+            _fileCache->removeFile(hash);
 
             if (removeableFile.remove()) {
                 qDebug() << "\tDeleted" << hash << "from asset files directory since it is now unmapped.";
@@ -624,11 +847,7 @@ bool AssetServer::deleteMappings(AssetPathList& paths) {
 
         return true;
     } else {
-        qWarning() << "Failed to persist deleted mappings, rolling back";
-
-        // we didn't delete the previous mapping, put it back in our in-memory representation
-        _fileMappings = oldMappings;
-
+        qWarning() << "Failed to persist deleted mappings";
         return false;
     }
 }
@@ -653,34 +872,24 @@ bool AssetServer::renameMapping(AssetPath oldPath, AssetPath newPath) {
             return false;
         }
 
-        // take a copy of the old mappings
-        auto oldMappings = _fileMappings;
-
-        // iterate the current mappings and adjust any that matches the renamed folder
-        auto it = oldMappings.begin();
+        // the mappings in the folder are the range of paths starting with it
+        Mappings renamedMappings;
+        AssetPathList oldPaths;
 
-        while (it != oldMappings.end()) {
-            if (it.key().startsWith(oldPath)) {
-                auto newKey = it.key();
-                newKey.replace(0, oldPath.size(), newPath);
+        for (auto it = _fileMappings.lowerBound(oldPath); it != _fileMappings.end() && it.key().startsWith(oldPath); ++it) {
+            auto newKey = it.key();
+            newKey.replace(0, oldPath.size(), newPath);
 
-                // remove the old version from the in memory file mappings
-                _fileMappings.remove(it.key());
-                _fileMappings.insert(newKey, it.value());
-            }
-
-            ++it;
+            oldPaths << it.key();
+            renamedMappings.insert(newKey, it.value());
         }
 
-        if (writeMappingsToFile()) {
+        if (commitMappingChanges(renamedMappings, oldPaths)) {
             // persisted the changed mappings, return success
             qDebug() << "Renamed folder mapping:" << oldPath << "=>" << newPath;
 
             return true;
         } else {
-            // couldn't persist the renamed paths, rollback and return failure
-            _fileMappings = oldMappings;
-
             qWarning() << "Failed to persist renamed folder mapping:" << oldPath << "=>" << newPath;
 
             return false;
@@ -693,32 +902,19 @@ bool AssetServer::renameMapping(AssetPath oldPath, AssetPath newPath) {
             return false;
         }
 
-        // take the old hash to remove the old mapping
-        auto oldSourceMapping = _fileMappings.take(oldPath).toString();
-
-        // in case we're overwriting, keep the current destination mapping for potential rollback
-        auto oldDestinationMapping = _fileMappings.value(newPath);
+        auto it = _fileMappings.find(oldPath);
 
-        if (!oldSourceMapping.isEmpty()) {
-            _fileMappings[newPath] = oldSourceMapping;
+        if (it != _fileMappings.end()) {
+            // the destination mapping, if any, is overwritten
+            Mappings renamedMappings;
+            renamedMappings.insert(newPath, it.value());
 
-            if (writeMappingsToFile()) {
+            if (commitMappingChanges(renamedMappings, AssetPathList { oldPath })) {
                 // persisted the renamed mapping, return success
                 qDebug() << "Renamed mapping:" << oldPath << "=>" << newPath;
 
                 return true;
             } else {
-                // we couldn't persist the renamed mapping, rollback and return failure
-                _fileMappings[oldPath] = oldSourceMapping;
-
-                if (!oldDestinationMapping.isNull()) {
-                    // put back the overwritten mapping for the destination path
-                    _fileMappings[newPath] = oldDestinationMapping.toString();
-                } else {
-                    // clear the new mapping
-                    _fileMappings.remove(newPath);
-                }
-
                 qDebug() << "Failed to persist renamed mapping:" << oldPath << "=>" << newPath;
 
                 return false;
@@ -12,18 +12,26 @@
 #ifndef hifi_AssetServer_h
 #define hifi_AssetServer_h
 
+#include <memory>
+
 #include <QtCore/QDir>
+#include <QtCore/QHash>
+#include <QtCore/QMap>
 #include <QtCore/QThreadPool>
 
+#include <Histogram.h>
 #include <ThreadedAssignment.h>
 
 #include "AssetUtils.h"
 #include "ReceivedMessage.h"
 
+class AssetFileCache;
+
 class AssetServer : public ThreadedAssignment {
     Q_OBJECT
 public:
     AssetServer(ReceivedMessage& message);
+    ~AssetServer();
 
 public slots:
     void run() override;
@@ -39,7 +47,8 @@ private slots:
     void sendStatsPacket() override;
 
 private:
-    using Mappings = QVariantHash;
+    // Sorted by path, so the mappings in a folder or in a page of GetAll are a range of the map
+    using Mappings = QMap<AssetPath, AssetHash>;
 
     void handleGetMappingOperation(ReceivedMessage& message, SharedNodePointer senderNode, NLPacketList& replyPacket);
     void handleGetAllMappingOperation(ReceivedMessage& message, SharedNodePointer senderNode, NLPacketList& replyPacket);
@@ -51,8 +60,18 @@ private:
     bool loadMappingsFromFile();
     bool writeMappingsToFile();
 
-    /// Set the mapping for path to hash
-    bool setMapping(AssetPath path, AssetHash hash);
+    /// Appends the changes to the mapping log file, returns `true` once they are on disk
+    bool writeMappingChangesToFile(const Mappings& setMappings, const AssetPathList& deletedPaths);
+
+    /// Persists then applies the changes, the deletes before the sets. Returns `true` if successful
+    bool commitMappingChanges(const Mappings& setMappings, const AssetPathList& deletedPaths);
+
+    // Update the in memory mappings and the number of paths mapped to each hash
+    void insertMapping(const AssetPath& path, const AssetHash& hash);
+    void removeMapping(const AssetPath& path);
+
+    /// Set the mappings of the paths to the hashes, all of them or none
+    bool setMappings(const Mappings& mappings);
 
     /// Delete mapping `path`. Returns `true` if deletion of mappings succeeds, else `false`.
     bool deleteMappings(AssetPathList& paths);
@@ -63,11 +82,22 @@ private:
     // deletes any unmapped files from the local asset directory
     void cleanupUnmappedFiles();
 
+    /// Returns the url of the file on the http mirror of the files directory, signed when a signing key is set
+    QUrl getMirrorURL(const QString& hexHash) const;
+
     Mappings _fileMappings;
+    QHash<AssetHash, int> _hashMappingCounts;
+    int _numLoggedMappingChanges { 0 };
 
     QDir _resourcesDirectory;
     QDir _filesDirectory;
+    std::unique_ptr<AssetFileCache> _fileCache; // declared before the task pool, so it outlives the tasks using it
+    // from the request to the reply sent, waiting for a task thread included - declared before the task pool too
+    Histogram _assetGetUsecs;
     QThreadPool _taskPool;
+
+    QUrl _mirrorURL;
+    QString _mirrorSigningKey;
 };
 
 #endif
@@ -11,6 +11,8 @@
 
 #include "SendAssetTask.h"
 
+#include <algorithm>
+
 #include <QFile>
 
 #include <DependencyManager.h>
@@ -18,15 +20,20 @@
 #include <NLPacket.h>
 #include <NLPacketList.h>
 #include <NodeList.h>
+#include <SharedUtil.h>
 #include <udt/Packet.h>
 
 #include "AssetUtils.h"
 
-SendAssetTask::SendAssetTask(QSharedPointer<ReceivedMessage> message, const SharedNodePointer& sendToNode, const QDir& resourcesDir) :
+SendAssetTask::SendAssetTask(QSharedPointer<ReceivedMessage> message, const SharedNodePointer& sendToNode,
+                             const QDir& resourcesDir, AssetFileCache& fileCache, Histogram& sendTimes) :
     QRunnable(),
     _message(message),
     _senderNode(sendToNode),
-    _resourcesDir(resourcesDir)
+    _resourcesDir(resourcesDir),
+    _fileCache(fileCache),
+    _sendTimes(sendTimes),
+    _queuedTime(usecTimestampNow())
 {
     
 }
@@ -58,29 +65,61 @@ void SendAssetTask::run() {
     if (end <= start) {
         replyPacketList->writePrimitive(AssetServerError::InvalidByteRange);
     } else {
-        QString filePath = _resourcesDir.filePath(QString(hexHash));
-        
-        QFile file { filePath };
-
-        if (file.open(QIODevice::ReadOnly)) {
-            if (file.size() < end) {
+        // The popular files are sent from memory, read once for all the requests coming at the same time
+        QByteArray cachedFile = _fileCache.getFile(hexHash);
+        if (!cachedFile.isNull()) {
+            if (cachedFile.size() < end) {
                 replyPacketList->writePrimitive(AssetServerError::InvalidByteRange);
                 qCDebug(networking) << "Bad byte range: " << hexHash << " " << start << ":" << end;
             } else {
                 auto size = end - start;
-                file.seek(start);
                 replyPacketList->writePrimitive(AssetServerError::NoError);
                 replyPacketList->writePrimitive(size);
-                replyPacketList->write(file.read(size));
-                qCDebug(networking) << "Sending asset: " << hexHash;
+                replyPacketList->write(cachedFile.constData() + start, size);
+                qCDebug(networking) << "Sending cached asset: " << hexHash;
             }
-            file.close();
         } else {
-            qCDebug(networking) << "Asset not found: " << filePath << "(" << hexHash << ")";
-            replyPacketList->writePrimitive(AssetServerError::AssetNotFound);
+            sendFileRange(*replyPacketList, hexHash, start, end);
         }
     }
 
     auto nodeList = DependencyManager::get<NodeList>();
     nodeList->sendPacketList(std::move(replyPacketList), *_senderNode);
+
+    _sendTimes.record(usecTimestampNow() - _queuedTime);
+}
+
+void SendAssetTask::sendFileRange(NLPacketList& replyPacketList, const QString& hexHash, DataOffset start, DataOffset end) {
+    QString filePath = _resourcesDir.filePath(hexHash);
+
+    QFile file { filePath };
+
+    if (file.open(QIODevice::ReadOnly)) {
+        if (file.size() < end) {
+            replyPacketList.writePrimitive(AssetServerError::InvalidByteRange);
+            qCDebug(networking) << "Bad byte range: " << hexHash << " " << start << ":" << end;
+        } else {
+            auto size = end - start;
+            file.seek(start);
+            replyPacketList.writePrimitive(AssetServerError::NoError);
+            replyPacketList.writePrimitive(size);
+
+            // Stream the range from the file into the packets rather than reading it all at once
+            static const qint64 FILE_READ_SIZE = 1024 * 1024;
+            QByteArray buffer;
+            for (qint64 remaining = size; remaining > 0; remaining -= buffer.size()) {
+                buffer = file.read(std::min(remaining, FILE_READ_SIZE));
+                if (buffer.isEmpty()) {
+                    qCWarning(networking) << "Failed to read asset: " << hexHash << " at " << end - remaining;
+                    break;
+                }
+                replyPacketList.write(buffer);
+            }
+            qCDebug(networking) << "Sending asset: " << hexHash;
+        }
+        file.close();
+    } else {
+        qCDebug(networking) << "Asset not found: " << filePath << "(" << hexHash << ")";
+        replyPacketList.writePrimitive(AssetServerError::AssetNotFound);
+    }
 }
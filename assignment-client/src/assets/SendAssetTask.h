@@ -17,22 +17,30 @@
 #include <QtCore/QString>
 #include <QtCore/QRunnable>
 
+#include "AssetFileCache.h"
 #include "AssetUtils.h"
 #include "AssetServer.h"
 #include "Node.h"
 
 class NLPacket;
+class NLPacketList;
 
 class SendAssetTask : public QRunnable {
 public:
-    SendAssetTask(QSharedPointer<ReceivedMessage> message, const SharedNodePointer& sendToNode, const QDir& resourcesDir);
+    SendAssetTask(QSharedPointer<ReceivedMessage> message, const SharedNodePointer& sendToNode,
+                  const QDir& resourcesDir, AssetFileCache& fileCache, Histogram& sendTimes);
 
     void run() override;
 
 private:
+    void sendFileRange(NLPacketList& replyPacketList, const QString& hexHash, DataOffset start, DataOffset end);
+
     QSharedPointer<ReceivedMessage> _message;
     SharedNodePointer _senderNode;
     QDir _resourcesDir;
+    AssetFileCache& _fileCache;
+    Histogram& _sendTimes;
+    quint64 _queuedTime;
 };
 
 #endif
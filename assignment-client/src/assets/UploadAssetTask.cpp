@@ -11,8 +11,11 @@
 
 #include "UploadAssetTask.h"
 
-#include <QtCore/QBuffer>
-#include <QtCore/QFile>
+#include <cstring>
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QFileInfo>
+#include <QtCore/QSaveFile>
 
 #include <AssetUtils.h>
 #include <NodeList.h>
@@ -29,16 +32,18 @@ UploadAssetTask::UploadAssetTask(QSharedPointer<ReceivedMessage> receivedMessage
 }
 
 void UploadAssetTask::run() {
+    // read the header in place, the file data is hashed and written straight from the message
     auto data = _receivedMessage->getMessage();
-    
-    QBuffer buffer { &data };
-    buffer.open(QIODevice::ReadOnly);
-    
-    MessageID messageID;
-    buffer.read(reinterpret_cast<char*>(&messageID), sizeof(messageID));
-    
-    uint64_t fileSize;
-    buffer.read(reinterpret_cast<char*>(&fileSize), sizeof(fileSize));
+    int offset = 0;
+
+    MessageID messageID { 0 };
+    uint64_t fileSize { 0 };
+    if (data.size() >= qint64(sizeof(messageID) + sizeof(fileSize))) {
+        memcpy(&messageID, data.constData() + offset, sizeof(messageID));
+        offset += sizeof(messageID);
+        memcpy(&fileSize, data.constData() + offset, sizeof(fileSize));
+        offset += sizeof(fileSize);
+    }
     
     qDebug() << "UploadAssetTask reading a file of " << fileSize << "bytes from"
         << uuidStringWithoutCurlyBraces(_senderNode->getUUID());
@@ -48,56 +53,45 @@ void UploadAssetTask::run() {
     
     if (fileSize > MAX_UPLOAD_SIZE) {
         replyPacket->writePrimitive(AssetServerError::AssetTooLarge);
+    } else if (fileSize > uint64_t(data.size() - offset)) {
+        qWarning() << "Upload from" << uuidStringWithoutCurlyBraces(_senderNode->getUUID())
+            << "is shorter than its announced size - upload failed.";
+        replyPacket->writePrimitive(AssetServerError::FileOperationFailed);
     } else {
-        QByteArray fileData = buffer.read(fileSize);
-        
-        auto hash = hashData(fileData);
+        const char* fileData = data.constData() + offset;
+
+        QCryptographicHash hasher(QCryptographicHash::Sha256);
+        hasher.addData(fileData, int(fileSize));
+        auto hash = hasher.result();
         auto hexHash = hash.toHex();
         
         qDebug() << "Hash for uploaded file from" << uuidStringWithoutCurlyBraces(_senderNode->getUUID())
             << "is: (" << hexHash << ") ";
         
-        QFile file { _resourcesDir.filePath(QString(hexHash)) };
-
-        bool existingCorrectFile = false;
-        
-        if (file.exists()) {
-            // check if the local file has the correct contents, otherwise we overwrite
-            if (file.open(QIODevice::ReadOnly) && hashData(file.readAll()) == hash) {
-                qDebug() << "Not overwriting existing verified file: " << hexHash;
+        QString filePath = _resourcesDir.filePath(QString(hexHash));
 
-                existingCorrectFile = true;
+        // the files are only ever renamed into place once complete, so a file of the right size has the right contents
+        QFileInfo existingFile { filePath };
+        if (existingFile.exists() && existingFile.size() == qint64(fileSize)) {
+            qDebug() << "Not overwriting existing file: " << hexHash;
 
-                replyPacket->writePrimitive(AssetServerError::NoError);
-                replyPacket->write(hash);
-            } else {
-                qDebug() << "Overwriting an existing file whose contents did not match the expected hash: " << hexHash;
-                file.close();
-            }
-        }
-
-        if (!existingCorrectFile) {
-            if (file.open(QIODevice::WriteOnly) && file.write(fileData) == qint64(fileSize)) {
+            replyPacket->writePrimitive(AssetServerError::NoError);
+            replyPacket->write(hash);
+        } else {
+            // write to a temporary file renamed over the hash-named file on commit, so the file is never seen half written
+            QSaveFile file { filePath };
+            if (file.open(QIODevice::WriteOnly) && file.write(fileData, fileSize) == qint64(fileSize) && file.commit()) {
                 qDebug() << "Wrote file" << hexHash << "to disk. Upload complete";
-                file.close();
 
                 replyPacket->writePrimitive(AssetServerError::NoError);
                 replyPacket->write(hash);
             } else {
+                // the temporary file is removed when the save file is discarded
                 qWarning() << "Failed to upload or write to file" << hexHash << " - upload failed.";
-
-                // upload has failed - remove the file and return an error
-                auto removed = file.remove();
-
-                if (!removed) {
-                    qWarning() << "Removal of failed upload file" << hexHash << "failed.";
-                }
                 
                 replyPacket->writePrimitive(AssetServerError::FileOperationFailed);
             }
         }
-
-
     }
     
     auto nodeList = DependencyManager::get<NodeList>();
@@ -0,0 +1,133 @@
+//
+//  AudioCrowdBed.cpp
+//  assignment-client/src/audio
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <string.h>
+
+#include <NumericalConstants.h>
+
+#include "PositionalAudioStream.h"
+
+#include "AudioCrowdBed.h"
+
+void AudioCrowdBed::setZones(const QHash<QString, AABox>& zones) {
+    _beds.clear();
+    _slots.clear();
+    _pendingStreams.clear();
+
+    for (auto& zone : zones) {
+        Bed bed;
+        bed.zone = zone;
+        bed.hasZone = true;
+        bed.center = zone.calcCenter();
+        _beds.push_back(bed);
+    }
+
+    // the last bed catches every stream that is not in a zone
+    _beds.emplace_back();
+}
+
+void AudioCrowdBed::clear() {
+    for (auto& bed : _beds) {
+        for (auto& sector : bed.sectors) {
+            sector.totalWeight = 0.0f;
+            sector.numSources = 0;
+        }
+    }
+    _pendingStreams.clear();
+    _slots.clear();
+}
+
+void AudioCrowdBed::addStream(const PositionalAudioStream& stream, float gain) {
+    // only mono streams with a frame of audio this frame are mixed into the bed
+    if (stream.isStereo() || !stream.lastPopSucceeded() || stream.getLastPopOutputLoudness() == 0.0f) {
+        return;
+    }
+
+    int bedIndex = (int)_beds.size() - 1;
+    for (int i = 0; i < bedIndex; ++i) {
+        if (_beds[i].zone.contains(stream.getPosition())) {
+            bedIndex = i;
+            break;
+        }
+    }
+
+    _pendingStreams.push_back({ &stream, gain, bedIndex });
+}
+
+void AudioCrowdBed::finalize() {
+    // the catch-all bed is centered on the streams it holds
+    Bed& defaultBed = _beds.back();
+    glm::vec3 positionSum;
+    int numDefaultStreams = 0;
+    for (auto& pendingStream : _pendingStreams) {
+        if (!_beds[pendingStream.bed].hasZone) {
+            positionSum += pendingStream.stream->getPosition();
+            ++numDefaultStreams;
+        }
+    }
+    if (numDefaultStreams > 0) {
+        defaultBed.center = positionSum / (float)numDefaultStreams;
+    }
+
+    for (auto& pendingStream : _pendingStreams) {
+        mixStream(pendingStream);
+    }
+
+    // turn the weighted position sums into positions
+    for (auto& bed : _beds) {
+        for (auto& sector : bed.sectors) {
+            if (sector.numSources > 0) {
+                sector.position /= sector.totalWeight;
+            }
+        }
+    }
+}
+
+void AudioCrowdBed::mixStream(const PendingStream& pendingStream) {
+    const PositionalAudioStream& stream = *pendingStream.stream;
+    Bed& bed = _beds[pendingStream.bed];
+
+    // pick the sector from the world space azimuth of the stream around the center of its bed
+    glm::vec3 offset = stream.getPosition() - bed.center;
+    float angle = atan2f(offset.x, -offset.z) + PI;
+    int sectorIndex = (int)(angle / TWO_PI * NUM_SECTORS);
+    sectorIndex = glm::clamp(sectorIndex, 0, NUM_SECTORS - 1);
+
+    Sector& sector = bed.sectors[sectorIndex];
+    if (sector.numSources == 0) {
+        memset(sector.samples, 0, sizeof(sector.samples));
+        sector.position = glm::vec3();
+    }
+
+    // weight the position by loudness so the sector is heard from where its loudest sources are
+    float weight = stream.getLastPopOutputTrailingLoudness() + EPSILON;
+    sector.position += stream.getPosition() * weight;
+    sector.totalWeight += weight;
+    ++sector.numSources;
+
+    // read the popped frame in place, in at most two runs
+    AudioRingBuffer::ConstIterator::Span spans[2];
+    stream.getLastPopOutput().getSpans(AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL, spans[0], spans[1]);
+    float scale = pendingStream.gain / AudioConstants::MAX_SAMPLE_VALUE;
+    float* sectorSamples = sector.samples;
+    for (auto& span : spans) {
+        for (int i = 0; i < span.numSamples; ++i) {
+            sectorSamples[i] += span.samples[i] * scale;
+        }
+        sectorSamples += span.numSamples;
+    }
+
+    _slots[&stream] = { pendingStream.bed, sectorIndex, pendingStream.gain };
+}
+
+const AudioCrowdBed::Slot* AudioCrowdBed::slotForStream(const PositionalAudioStream* stream) const {
+    auto it = _slots.find(stream);
+    return it != _slots.end() ? &it->second : nullptr;
+}
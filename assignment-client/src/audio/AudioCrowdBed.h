@@ -0,0 +1,84 @@
+//
+//  AudioCrowdBed.h
+//  assignment-client/src/audio
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioCrowdBed_h
+#define hifi_AudioCrowdBed_h
+
+#include <unordered_map>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <QtCore/QHash>
+#include <QtCore/QString>
+
+#include <AABox.h>
+#include <AudioConstants.h>
+
+class PositionalAudioStream;
+
+/// A spatially coarse, pre-mixed bed of the mono streams in the domain.
+/// Every stream is mixed once per frame into one of a few azimuth sectors around the center of its audio zone,
+/// so that listeners can pull distant sources from a sector instead of running an HRTF per source.
+class AudioCrowdBed {
+public:
+    static const int NUM_SECTORS = 8;
+
+    struct Sector {
+        float samples[AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL];
+        glm::vec3 position;     // loudness weighted position of the sources in this sector
+        float totalWeight { 0.0f };
+        int numSources { 0 };
+    };
+
+    // where a stream was mixed into the bed, and the gain it was mixed with
+    struct Slot {
+        int bed;
+        int sector;
+        float gain;
+    };
+
+    AudioCrowdBed() : _beds(1) {}
+
+    // one bed per audio zone, streams outside of every zone go to an extra bed centered on all of them
+    void setZones(const QHash<QString, AABox>& zones);
+
+    // the following are called from the AudioMixer assignment thread once per frame, before any mixing
+    void clear();
+    void addStream(const PositionalAudioStream& stream, float gain);
+    void finalize();
+
+    // the following are read-only and safe to call from the mix workers
+    int getNumBeds() const { return (int)_beds.size(); }
+    const Sector& getSector(int bed, int sector) const { return _beds[bed].sectors[sector]; }
+    const Slot* slotForStream(const PositionalAudioStream* stream) const;
+
+private:
+    struct Bed {
+        AABox zone;
+        bool hasZone { false };
+        glm::vec3 center;
+        Sector sectors[NUM_SECTORS];
+    };
+
+    struct PendingStream {
+        const PositionalAudioStream* stream;
+        float gain;
+        int bed;
+    };
+
+    void mixStream(const PendingStream& pendingStream);
+
+    std::vector<Bed> _beds;
+    std::vector<PendingStream> _pendingStreams;
+    std::unordered_map<const PositionalAudioStream*, Slot> _slots;
+};
+
+#endif // hifi_AudioCrowdBed_h
@@ -159,7 +159,7 @@ static inline float fastexp2(float x) {
 }
 
 float AudioMixer::gainForSource(const PositionalAudioStream& streamToAdd,
-                                const AvatarAudioStream& listeningNodeStream, const glm::vec3& relativePosition, bool isEcho) {
+                                const AvatarAudioStream& listeningNodeStream, const glm::vec3& relativePosition, bool isEcho) const {
     float gain = 1.0f;
 
     float distanceBetween = glm::length(relativePosition);
@@ -198,25 +198,32 @@ float AudioMixer::gainForSource(const PositionalAudioStream& streamToAdd,
         }
     }
 
-    if (distanceBetween >= ATTENUATION_BEGINS_AT_DISTANCE) {
+    // multiply the current attenuation coefficient by the distance coefficient
+    gain *= gainForDistance(distanceBetween, attenuationPerDoublingInDistance);
 
-        // translate the zone setting to gain per log2(distance)
-        float g = 1.0f - attenuationPerDoublingInDistance;
-        g = (g < EPSILON) ? EPSILON : g;
-        g = (g > 1.0f) ? 1.0f : g;
-
-        // calculate the distance coefficient using the distance to this node
-        float distanceCoefficient = fastexp2(fastlog2(g) * fastlog2(distanceBetween/ATTENUATION_BEGINS_AT_DISTANCE));
+    return gain;
+}
 
-        // multiply the current attenuation coefficient by the distance coefficient
-        gain *= distanceCoefficient;
+float AudioMixer::gainForDistance(float distance, float attenuationPerDoublingInDistance) const {
+    if (distance < ATTENUATION_BEGINS_AT_DISTANCE) {
+        return 1.0f;
     }
 
-    return gain;
+    // translate the zone setting to gain per log2(distance)
+    float g = 1.0f - attenuationPerDoublingInDistance;
+    g = (g < EPSILON) ? EPSILON : g;
+    g = (g > 1.0f) ? 1.0f : g;
+
+    // calculate the distance coefficient using the distance to this node
+    return fastexp2(fastlog2(g) * fastlog2(distance / ATTENUATION_BEGINS_AT_DISTANCE));
 }
 
 float AudioMixer::azimuthForSource(const PositionalAudioStream& streamToAdd, const AvatarAudioStream& listeningNodeStream,
-                                   const glm::vec3& relativePosition) {
+                                   const glm::vec3& relativePosition) const {
+    return azimuthForPosition(listeningNodeStream, relativePosition);
+}
+
+float AudioMixer::azimuthForPosition(const AvatarAudioStream& listeningNodeStream, const glm::vec3& relativePosition) const {
     glm::quat inverseOrientation = glm::inverse(listeningNodeStream.getOrientation());
 
     //  Compute sample delay for the two ears to create phase panning
@@ -236,195 +243,12 @@ float AudioMixer::azimuthForSource(const PositionalAudioStream& streamToAdd, con
     }
 }
 
-void AudioMixer::addStreamToMixForListeningNodeWithStream(AudioMixerClientData& listenerNodeData,
-                                                          const PositionalAudioStream& streamToAdd,
-                                                          const QUuid& sourceNodeID,
-                                                          const AvatarAudioStream& listeningNodeStream) {
-
-
-    // to reduce artifacts we calculate the gain and azimuth for every source for this listener
-    // even if we are not going to end up mixing in this source
-
-    ++_totalMixes;
-
-    // this ensures that the tail of any previously mixed audio or the first block of new audio sounds correct
-
-    // check if this is a server echo of a source back to itself
-    bool isEcho = (&streamToAdd == &listeningNodeStream);
-
-    glm::vec3 relativePosition = streamToAdd.getPosition() - listeningNodeStream.getPosition();
-
-    // figure out the distance between source and listener
-    float distance = glm::max(glm::length(relativePosition), EPSILON);
-
-    // figure out the gain for this source at the listener
-    float gain = gainForSource(streamToAdd, listeningNodeStream, relativePosition, isEcho);
-
-    // figure out the azimuth to this source at the listener
-    float azimuth = isEcho ? 0.0f : azimuthForSource(streamToAdd, listeningNodeStream, relativePosition);
-
-    float repeatedFrameFadeFactor = 1.0f;
-
-    static const int HRTF_DATASET_INDEX = 1;
-
-    if (!streamToAdd.lastPopSucceeded()) {
-        bool forceSilentBlock = true;
-
-        if (!streamToAdd.getLastPopOutput().isNull()) {
-            bool isInjector = dynamic_cast<const InjectedAudioStream*>(&streamToAdd);
-
-            // in an injector, just go silent - the injector has likely ended
-            // in other inputs (microphone, &c.), repeat with fade to avoid the harsh jump to silence
-
-            // we'll repeat the last block until it has a block to mix
-            // and we'll gradually fade that repeated block into silence.
-
-            // calculate its fade factor, which depends on how many times it's already been repeated.
-            repeatedFrameFadeFactor = calculateRepeatedFrameFadeFactor(streamToAdd.getConsecutiveNotMixedCount() - 1);
-            if (!isInjector && repeatedFrameFadeFactor > 0.0f) {
-                // apply the repeatedFrameFadeFactor to the gain
-                gain *= repeatedFrameFadeFactor;
-
-                forceSilentBlock = false;
-            }
-        }
-
-        if (forceSilentBlock) {
-            // we're deciding not to repeat either since we've already done it enough times or repetition with fade is disabled
-            // in this case we will call renderSilent with a forced silent block
-            // this ensures the correct tail from the previously mixed block and the correct spatialization of first block
-            // of any upcoming audio
-
-            if (!streamToAdd.isStereo() && !isEcho) {
-                // get the existing listener-source HRTF object, or create a new one
-                auto& hrtf = listenerNodeData.hrtfForStream(sourceNodeID, streamToAdd.getStreamIdentifier());
-
-                // this is not done for stereo streams since they do not go through the HRTF
-                static int16_t silentMonoBlock[AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL] = {};
-                hrtf.renderSilent(silentMonoBlock, _mixedSamples, HRTF_DATASET_INDEX, azimuth, distance, gain,
-                                  AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
-
-                ++_hrtfSilentRenders;;
-            }
-
-            return;
-        }
-    }
-
-    // grab the stream from the ring buffer
-    AudioRingBuffer::ConstIterator streamPopOutput = streamToAdd.getLastPopOutput();
-
-    if (streamToAdd.isStereo() || isEcho) {
-        // this is a stereo source or server echo so we do not pass it through the HRTF
-        // simply apply our calculated gain to each sample
-        if (streamToAdd.isStereo()) {
-            for (int i = 0; i < AudioConstants::NETWORK_FRAME_SAMPLES_STEREO; ++i) {
-                _mixedSamples[i] += float(streamPopOutput[i] * gain / AudioConstants::MAX_SAMPLE_VALUE);
-            }
-
-            ++_manualStereoMixes;
-        } else {
-            for (int i = 0; i < AudioConstants::NETWORK_FRAME_SAMPLES_STEREO; i += 2) {
-                auto monoSample = float(streamPopOutput[i / 2] * gain / AudioConstants::MAX_SAMPLE_VALUE);
-                _mixedSamples[i] += monoSample;
-                _mixedSamples[i + 1] += monoSample;
-            }
-
-            ++_manualEchoMixes;
-        }
-
-        return;
-    }
-
-    // get the existing listener-source HRTF object, or create a new one
-    auto& hrtf = listenerNodeData.hrtfForStream(sourceNodeID, streamToAdd.getStreamIdentifier());
-
-    static int16_t streamBlock[AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL];
-
-    streamPopOutput.readSamples(streamBlock, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
-
-    // if the frame we're about to mix is silent, simply call render silent and move on
-    if (streamToAdd.getLastPopOutputLoudness() == 0.0f) {
-        // silent frame from source
-
-        // we still need to call renderSilent via the HRTF for mono source
-        hrtf.renderSilent(streamBlock, _mixedSamples, HRTF_DATASET_INDEX, azimuth, distance, gain,
-                          AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
-
-        ++_hrtfSilentRenders;
-
-        return;
-    }
-
-    if (_performanceThrottlingRatio > 0.0f
-        && streamToAdd.getLastPopOutputTrailingLoudness() / glm::length(relativePosition) <= _minAudibilityThreshold) {
-        // the mixer is struggling so we're going to drop off some streams
-
-        // we call renderSilent via the HRTF with the actual frame data and a gain of 0.0
-        hrtf.renderSilent(streamBlock, _mixedSamples, HRTF_DATASET_INDEX, azimuth, distance, 0.0f,
-                          AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
-
-        ++_hrtfStruggleRenders;
-
-        return;
-    }
-
-    ++_hrtfRenders;
-
-    // mono stream, call the HRTF with our block and calculated azimuth and gain
-    hrtf.render(streamBlock, _mixedSamples, HRTF_DATASET_INDEX, azimuth, distance, gain,
-                AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
-}
-
-bool AudioMixer::prepareMixForListeningNode(Node* node) {
-    AvatarAudioStream* nodeAudioStream = static_cast<AudioMixerClientData*>(node->getLinkedData())->getAvatarAudioStream();
-    AudioMixerClientData* listenerNodeData = static_cast<AudioMixerClientData*>(node->getLinkedData());
-
-    // zero out the client mix for this node
-    memset(_mixedSamples, 0, sizeof(_mixedSamples));
-
-    // loop through all other nodes that have sufficient audio to mix
-
-    DependencyManager::get<NodeList>()->eachNode([&](const SharedNodePointer& otherNode){
-        // make sure that we have audio data for this other node and that it isn't being ignored by our listening node
-        if (otherNode->getLinkedData() && !node->isIgnoringNodeWithID(otherNode->getUUID())) {
-            AudioMixerClientData* otherNodeClientData = (AudioMixerClientData*) otherNode->getLinkedData();
-
-            // enumerate the ARBs attached to the otherNode and add all that should be added to mix
-            auto streamsCopy = otherNodeClientData->getAudioStreams();
-
-            for (auto& streamPair : streamsCopy) {
-
-                auto otherNodeStream = streamPair.second;
-
-                if (*otherNode != *node || otherNodeStream->shouldLoopbackForNode()) {
-                    addStreamToMixForListeningNodeWithStream(*listenerNodeData, *otherNodeStream, otherNode->getUUID(),
-                                                             *nodeAudioStream);
-                }
-            }
-        }
-    });
-
-    // use the per listner AudioLimiter to render the mixed data...
-    listenerNodeData->audioLimiter.render(_mixedSamples, _clampedSamples, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
-
-    // check for silent audio after the peak limitor has converted the samples
-    bool hasAudio = false;
-    for (int i = 0; i < AudioConstants::NETWORK_FRAME_SAMPLES_STEREO; ++i) {
-        if (_clampedSamples[i] != 0) {
-            hasAudio = true;
-            break;
-        }
-    }
-    return hasAudio;
-}
-
 void AudioMixer::sendAudioEnvironmentPacket(SharedNodePointer node) {
     // Send stream properties
     bool hasReverb = false;
     float reverbTime, wetLevel;
-    // find reverb properties
-    for (int i = 0; i < _zoneReverbSettings.size(); ++i) {
+    // find reverb properties, unless the reverb is already in the mix
+    for (int i = 0; i < _zoneReverbSettings.size() && !isServerReverbEnabled(); ++i) {
         AudioMixerClientData* data = static_cast<AudioMixerClientData*>(node->getLinkedData());
         glm::vec3 streamPosition = data->getAvatarAudioStream()->getPosition();
         AABox box = _audioZones[_zoneReverbSettings[i].zone];
@@ -483,7 +307,18 @@ void AudioMixer::sendAudioEnvironmentPacket(SharedNodePointer node) {
 }
 
 void AudioMixer::handleNodeAudioPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode) {
-    getOrCreateClientData(sendingNode.data());
+    auto clientData = getOrCreateClientData(sendingNode.data());
+
+    PacketType packetType = message->getType();
+    if (packetType == PacketType::MicrophoneAudioWithEcho || packetType == PacketType::MicrophoneAudioNoEcho
+        || packetType == PacketType::SilentAudioFrame) {
+        quint64 gap = clientData->takeMicPacketGap(usecTimestampNow());
+        if (gap > 0) {
+            quint64 interval = AudioConstants::NETWORK_FRAME_USECS;
+            _micPacketJitterUsecs.record(gap > interval ? gap - interval : interval - gap);
+        }
+    }
+
     DependencyManager::get<NodeList>()->updateNodeWithDataFromPacket(message, sendingNode);
 }
 
@@ -569,6 +404,12 @@ void AudioMixer::handleNegotiateAudioFormat(QSharedPointer<ReceivedMessage> mess
     }
     qDebug() << "all requested and available codecs:" << codecList;
 
+    // clients that can synthesize runs of silence locally say so after their codecs
+    bool supportsSilentRuns = false;
+    if (message->getBytesLeftToRead() >= (qint64)sizeof(supportsSilentRuns)) {
+        message->readPrimitive(&supportsSilentRuns);
+    }
+
     // choose first codec
     if (!selectedCodecName.isEmpty()) {
         if (codecPlugins.size() > 0) {
@@ -584,7 +425,8 @@ void AudioMixer::handleNegotiateAudioFormat(QSharedPointer<ReceivedMessage> mess
 
     auto clientData = getOrCreateClientData(sendingNode.data());
     clientData->setupCodec(selectedCodec, selectedCodecName);
-    qDebug() << "selectedCodecName:" << selectedCodecName;
+    clientData->setSupportsSilentRuns(supportsSilentRuns);
+    qDebug() << "selectedCodecName:" << selectedCodecName << "silent runs:" << supportsSilentRuns;
     clientData->sendSelectAudioFormat(sendingNode, selectedCodecName);
 }
 
@@ -651,9 +493,9 @@ void AudioMixer::removeHRTFsForFinishedInjector(const QUuid& streamID) {
     }
 }
 
-QString AudioMixer::percentageForMixStats(int counter) {
-    if (_totalMixes > 0) {
-        float mixPercentage = (float(counter) / _totalMixes) * 100.0f;
+QString AudioMixer::percentageForMixStats(int counter, int totalMixes) {
+    if (totalMixes > 0) {
+        float mixPercentage = (float(counter) / totalMixes) * 100.0f;
         return QString::number(mixPercentage, 'f', 2);
     } else {
         return QString("0.0");
@@ -671,29 +513,57 @@ void AudioMixer::sendStatsPacket() {
     statsObject["trailing_sleep_percentage"] = _trailingSleepRatio * 100.0f;
     statsObject["performance_throttling_ratio"] = _performanceThrottlingRatio;
 
+    // gather up the stats from each of the mix workers
+    AudioMixerStats mixerStats;
+    QJsonObject workerStats;
+    int workerIndex = 0;
+    _workerPool.each([&](AudioMixerWorker& worker) {
+        mixerStats.accumulate(worker.stats);
+
+        QJsonObject workerObject;
+        int numMixedFrames = worker.getNumMixedFrames();
+        workerObject["avg_mix_usecs"] = numMixedFrames > 0 ? (double)worker.getTotalMixUsecs() / numMixedFrames : 0.0;
+        workerObject["max_mix_usecs"] = (double)worker.getMaxMixUsecs();
+        workerObject["avg_listeners_per_frame"] = (float)worker.stats.sumListeners / (float)_numStatFrames;
+        workerStats[QString("worker_%1").arg(workerIndex++)] = workerObject;
+
+        worker.stats.reset();
+        worker.resetTiming();
+    });
+
     statsObject["avg_streams_per_frame"] = (float)_sumStreams / (float)_numStatFrames;
-    statsObject["avg_listeners_per_frame"] = (float)_sumListeners / (float)_numStatFrames;
+    statsObject["avg_listeners_per_frame"] = (float)mixerStats.sumListeners / (float)_numStatFrames;
 
     QJsonObject mixStats;
-    mixStats["%_hrtf_mixes"] = percentageForMixStats(_hrtfRenders);
-    mixStats["%_hrtf_silent_mixes"] = percentageForMixStats(_hrtfSilentRenders);
-    mixStats["%_hrtf_struggle_mixes"] = percentageForMixStats(_hrtfStruggleRenders);
-    mixStats["%_manual_stereo_mixes"] = percentageForMixStats(_manualStereoMixes);
-    mixStats["%_manual_echo_mixes"] = percentageForMixStats(_manualEchoMixes);
+    mixStats["%_hrtf_mixes"] = percentageForMixStats(mixerStats.hrtfRenders, mixerStats.totalMixes);
+    mixStats["%_hrtf_silent_mixes"] = percentageForMixStats(mixerStats.hrtfSilentRenders, mixerStats.totalMixes);
+    mixStats["%_hrtf_struggle_mixes"] = percentageForMixStats(mixerStats.hrtfStruggleRenders, mixerStats.totalMixes);
+    mixStats["%_manual_stereo_mixes"] = percentageForMixStats(mixerStats.manualStereoMixes, mixerStats.totalMixes);
+    mixStats["%_manual_echo_mixes"] = percentageForMixStats(mixerStats.manualEchoMixes, mixerStats.totalMixes);
+    mixStats["%_crowd_bed_mixes"] = percentageForMixStats(mixerStats.crowdBedMixes, mixerStats.totalMixes);
+    mixStats["%_budget_dropped_mixes"] = percentageForMixStats(mixerStats.budgetDroppedStreams, mixerStats.totalMixes);
 
-    mixStats["total_mixes"] = _totalMixes;
-    mixStats["avg_mixes_per_block"] = _totalMixes / _numStatFrames;
+    mixStats["total_mixes"] = mixerStats.totalMixes;
+    mixStats["avg_mixes_per_block"] = mixerStats.totalMixes / _numStatFrames;
 
     statsObject["mix_stats"] = mixStats;
 
+    statsObject["trailing_mix_percentage"] = _trailingMixRatio * 100.0f;
+    statsObject["stream_budget"] = _streamBudget; // 0 is unlimited
+    statsObject["avg_budget_dropped_streams_per_frame"] = (float)mixerStats.budgetDroppedStreams / (float)_numStatFrames;
+
+    statsObject["%_shared_encodes"] = percentageForMixStats(mixerStats.sharedEncodes, mixerStats.sumListeners);
+    statsObject["%_silent_run_frames"] = percentageForMixStats(mixerStats.silentRunFrames, mixerStats.sumListeners);
+
+    statsObject["mix_threads"] = _workerPool.numThreads();
+    statsObject["mix_workers"] = workerStats;
+
+    QJsonObject metrics;
+    metrics["mix_usecs"] = _mixUsecs.takeSnapshot().toJson();
+    metrics["mic_packet_jitter_usecs"] = _micPacketJitterUsecs.takeSnapshot().toJson();
+    statsObject[STATS_METRICS_KEY] = metrics;
+
     _sumStreams = 0;
-    _sumListeners = 0;
-    _hrtfRenders = 0;
-    _hrtfSilentRenders = 0;
-    _hrtfStruggleRenders = 0;
-    _manualStereoMixes = 0;
-    _manualEchoMixes = 0;
-    _totalMixes = 0;
     _numStatFrames = 0;
 
     // add stats for each listerner
@@ -759,6 +629,10 @@ void AudioMixer::domainSettingsRequestComplete() {
     // check the settings object to see if we have anything we can parse out
     parseSettingsObject(settingsObject);
 
+    // the environment, stats and mute packets for a client are small, they share datagrams when sent together
+    nodeList->setCoalescedPacketTypes({ PacketType::AudioEnvironment, PacketType::AudioStreamStats,
+                                        PacketType::MuteEnvironment, PacketType::NoisyMute });
+
     // queue up a connection to start broadcasting mixes now that we're ready to go
     QMetaObject::invokeMethod(this, "broadcastMixes", Qt::QueuedConnection);
 }
@@ -820,7 +694,16 @@ void AudioMixer::broadcastMixes() {
             }
         }
 
-        // mix
+        if (isCrowdBedEnabled()) {
+            _crowdBed.clear();
+        }
+        if (isServerReverbEnabled()) {
+            _reverbBus.clear();
+        }
+
+        int frameStreams = 0;
+
+        // pop a frame from every stream before any mix is prepared, since each mix reads from all of them
         nodeList->eachNode([&](const SharedNodePointer& node) {
             if (node->getLinkedData()) {
                 AudioMixerClientData* nodeData = (AudioMixerClientData*)node->getLinkedData();
@@ -828,7 +711,23 @@ void AudioMixer::broadcastMixes() {
                 // this function will attempt to pop a frame from each audio stream.
                 // a pointer to the popped data is stored as a member in InboundAudioStream.
                 // That's how the popped audio data will be read for mixing (but only if the pop was successful)
-                _sumStreams += nodeData->checkBuffersBeforeFrameSend();
+                frameStreams += nodeData->checkBuffersBeforeFrameSend();
+
+                if (isCrowdBedEnabled() || isServerReverbEnabled()) {
+                    for (auto& streamPair : nodeData->getAudioStreams()) {
+                        auto& stream = streamPair.second;
+                        float gain = 1.0f;
+                        if (stream->getType() == PositionalAudioStream::Injector) {
+                            gain = reinterpret_cast<const InjectedAudioStream*>(stream.get())->getAttenuationRatio();
+                        }
+                        if (isCrowdBedEnabled()) {
+                            _crowdBed.addStream(*stream, gain);
+                        }
+                        if (isServerReverbEnabled()) {
+                            _reverbBus.addStream(*stream, gain);
+                        }
+                    }
+                }
 
                 // if the stream should be muted, send mute packet
                 if (nodeData->getAvatarAudioStream()
@@ -843,73 +742,56 @@ void AudioMixer::broadcastMixes() {
 
                 if (node->getType() == NodeType::Agent && node->getActiveSocket()
                     && nodeData->getAvatarAudioStream()) {
+                    _workerPool.queueListener(node);
+                }
+            }
+        });
 
-                    bool mixHasAudio = prepareMixForListeningNode(node.data());
-
-                    std::unique_ptr<NLPacket> mixPacket;
-
-                    if (mixHasAudio || nodeData->shouldFlushEncoder()) {
-                        
-                        int mixPacketBytes = sizeof(quint16) + AudioConstants::MAX_CODEC_NAME_LENGTH_ON_WIRE 
-                                                             + AudioConstants::NETWORK_FRAME_BYTES_STEREO;
-                        mixPacket = NLPacket::create(PacketType::MixedAudio, mixPacketBytes);
-
-                        // pack sequence number
-                        quint16 sequence = nodeData->getOutgoingSequenceNumber();
-                        mixPacket->writePrimitive(sequence);
-
-                        // write the codec
-                        QString codecInPacket = nodeData->getCodecName();
-                        mixPacket->writeString(codecInPacket);
+        if (isCrowdBedEnabled()) {
+            _crowdBed.finalize();
+        }
+        if (isServerReverbEnabled()) {
+            _reverbBus.finalize();
+        }
 
-                        QByteArray encodedBuffer;
-                        if (mixHasAudio) {
-                            QByteArray decodedBuffer(reinterpret_cast<char*>(_clampedSamples), AudioConstants::NETWORK_FRAME_BYTES_STEREO);
-                            nodeData->encode(decodedBuffer, encodedBuffer);
-                        } else {
-                            // time to flush, which resets the shouldFlush until next time we encode something
-                            nodeData->encodeFrameOfZeros(encodedBuffer);
-                        }
-                        // pack mixed audio samples
-                        mixPacket->write(encodedBuffer.constData(), encodedBuffer.size());
-                    
-                    } else {
-                        int silentPacketBytes = sizeof(quint16) + sizeof(quint16) + AudioConstants::MAX_CODEC_NAME_LENGTH_ON_WIRE;
-                        mixPacket = NLPacket::create(PacketType::SilentAudioFrame, silentPacketBytes);
-
-                        // pack sequence number
-                        quint16 sequence = nodeData->getOutgoingSequenceNumber();
-                        mixPacket->writePrimitive(sequence);
-
-                        // write the codec
-                        QString codecInPacket = nodeData->getCodecName();
-                        mixPacket->writeString(codecInPacket);
-
-                        // pack number of silent audio samples
-                        quint16 numSilentSamples = AudioConstants::NETWORK_FRAME_SAMPLES_STEREO;
-                        mixPacket->writePrimitive(numSilentSamples);
-                    }
+        // mix, this returns once every worker has prepared the packets for its listeners
+        quint64 mixStart = usecTimestampNow();
+        _workerPool.mix();
+        quint64 mixUsecs = usecTimestampNow() - mixStart;
+        _mixUsecs.record(mixUsecs);
+        updateStreamBudget(mixUsecs, frameStreams);
+
+        // send out the mixes
+        _workerPool.each([&](AudioMixerWorker& worker) {
+            for (auto& mixPair : worker.getMixPackets()) {
+                auto& node = mixPair.first;
+                AudioMixerClientData* nodeData = (AudioMixerClientData*)node->getLinkedData();
 
-                    // Send audio environment
-                    sendAudioEnvironmentPacket(node);
+                // Send audio environment
+                sendAudioEnvironmentPacket(node);
 
-                    // send mixed audio packet
-                    nodeList->sendPacket(std::move(mixPacket), *node);
+                // send mixed audio packet, there is none for frames the client synthesizes during a silent run
+                if (mixPair.second) {
+                    nodeList->sendPacket(std::move(mixPair.second), *node);
                     nodeData->incrementOutgoingMixedAudioSequenceNumber();
+                }
 
-                    // send an audio stream stats packet to the client approximately every second
-                    ++currentFrame;
-                    currentFrame %= numFramesPerSecond;
-
-                    if (nodeData->shouldSendStats(currentFrame)) {
-                        nodeData->sendAudioStreamStatsPackets(node);
-                    }
+                // send an audio stream stats packet to the client approximately every second
+                ++currentFrame;
+                currentFrame %= numFramesPerSecond;
 
-                    ++_sumListeners;
+                if (nodeData->shouldSendStats(currentFrame)) {
+                    nodeData->sendAudioStreamStatsPackets(node);
                 }
             }
+
+            worker.clearFrame();
         });
 
+        // don't hold what this frame packed until the next flush
+        nodeList->flushCoalescedPackets();
+
+        _sumStreams += frameStreams;
         ++_numStatFrames;
 
         // play nice with qt event-looping
@@ -941,6 +823,52 @@ void AudioMixer::broadcastMixes() {
     }
 }
 
+void AudioMixer::updateStreamBudget(quint64 mixUsecs, int numStreams) {
+    const int TRAILING_MIX_FRAMES = 10;
+    const float CURRENT_FRAME_RATIO = 1.0f / TRAILING_MIX_FRAMES;
+    const float PREVIOUS_FRAMES_RATIO = 1.0f - CURRENT_FRAME_RATIO;
+
+    const float BUDGET_TRIGGER_MIX_RATIO = 0.80f;
+    const float BUDGET_RECOVER_MIX_RATIO = 0.50f;
+
+    const float BUDGET_CUT_RATIO = 0.75f;
+    const int BUDGET_RECOVER_STEP = 2;
+    const int MIN_STREAM_BUDGET = 4;
+
+    // ratio of frame spent mixing / total frame time
+    _trailingMixRatio = (PREVIOUS_FRAMES_RATIO * _trailingMixRatio) +
+        ((CURRENT_FRAME_RATIO * mixUsecs) / (float) AudioConstants::NETWORK_FRAME_USECS);
+
+    if (++_framesSinceBudgetChange < TRAILING_MIX_FRAMES) {
+        return;
+    }
+
+    int previousBudget = _streamBudget;
+
+    if (_trailingMixRatio >= BUDGET_TRIGGER_MIX_RATIO) {
+        // the mix is about to miss the frame, cut the number of streams each listener mixes
+        int currentBudget = (_streamBudget > 0) ? _streamBudget : numStreams;
+        _streamBudget = std::max(MIN_STREAM_BUDGET, (int)(currentBudget * BUDGET_CUT_RATIO));
+    } else if (_trailingMixRatio <= BUDGET_RECOVER_MIX_RATIO && _streamBudget > 0) {
+        // there is time to spare, give listeners back some streams
+        _streamBudget += BUDGET_RECOVER_STEP;
+        if (_streamBudget >= numStreams) {
+            _streamBudget = 0;
+        }
+    }
+
+    if (_streamBudget != previousBudget) {
+        _framesSinceBudgetChange = 0;
+
+        qDebug() << "Mixing" << _trailingMixRatio << "of frame";
+        if (_streamBudget > 0) {
+            qDebug() << "Stream budget per listener is" << _streamBudget;
+        } else {
+            qDebug() << "Stream budget per listener is unlimited";
+        }
+    }
+}
+
 void AudioMixer::parseSettingsObject(const QJsonObject &settingsObject) {
     if (settingsObject.contains(AUDIO_BUFFER_GROUP_KEY)) {
         QJsonObject audioBufferGroupObject = settingsObject[AUDIO_BUFFER_GROUP_KEY].toObject();
@@ -963,6 +891,17 @@ void AudioMixer::parseSettingsObject(const QJsonObject &settingsObject) {
             _numStaticJitterFrames = -1;
         }
 
+        // check if we have been asked to protect the mixed audio we send with forward error correction
+        const QString FORWARD_ERROR_CORRECTION_JSON_KEY = "forward_error_correction";
+        auto nodeList = DependencyManager::get<NodeList>();
+        if (audioBufferGroupObject[FORWARD_ERROR_CORRECTION_JSON_KEY].toBool()) {
+            qDebug() << "Enabling forward error correction for mixed audio.";
+            nodeList->setForwardErrorCorrectionPacketTypes({ PacketType::MixedAudio, PacketType::SilentAudioFrame,
+                                                             PacketType::SilentAudioRun });
+        } else {
+            nodeList->setForwardErrorCorrectionPacketTypes({});
+        }
+
         // check for deprecated audio settings
         auto deprecationNotice = [](const QString& setting, const QString& value) {
             qInfo().nospace() << "[DEPRECATION NOTICE] " << setting << "(" << value << ") has been deprecated, and has no effect";
@@ -1035,6 +974,42 @@ void AudioMixer::parseSettingsObject(const QJsonObject &settingsObject) {
             }
         }
 
+        const QString MIX_THREADS = "mix_threads";
+        if (audioEnvGroupObject[MIX_THREADS].isString()) {
+            bool ok = false;
+            int numThreads = audioEnvGroupObject[MIX_THREADS].toString().toInt(&ok);
+            if (ok) {
+                _workerPool.setNumThreads(numThreads);
+                qDebug() << "Mixing with" << _workerPool.numThreads() << "threads";
+            }
+        }
+
+        const QString CROWD_BED_DISTANCE = "crowd_bed_distance";
+        if (audioEnvGroupObject[CROWD_BED_DISTANCE].isString()) {
+            bool ok = false;
+            float crowdBedDistance = audioEnvGroupObject[CROWD_BED_DISTANCE].toString().toFloat(&ok);
+            if (ok && crowdBedDistance >= 0.0f) {
+                _crowdBedDistance = crowdBedDistance;
+                qDebug() << "Crowd bed distance changed to" << _crowdBedDistance;
+            }
+        }
+
+        const QString CROWD_BED_HRTF_SOURCES = "crowd_bed_hrtf_sources";
+        if (audioEnvGroupObject[CROWD_BED_HRTF_SOURCES].isString()) {
+            bool ok = false;
+            int crowdBedHRTFSources = audioEnvGroupObject[CROWD_BED_HRTF_SOURCES].toString().toInt(&ok);
+            if (ok && crowdBedHRTFSources >= 0) {
+                _crowdBedHRTFSources = crowdBedHRTFSources;
+                qDebug() << "Crowd bed HRTF sources changed to" << _crowdBedHRTFSources;
+            }
+        }
+
+        const QString SERVER_REVERB = "server_reverb";
+        if (audioEnvGroupObject[SERVER_REVERB].isBool()) {
+            _serverReverb = audioEnvGroupObject[SERVER_REVERB].toBool();
+            qDebug() << "Server reverb" << (_serverReverb ? "enabled" : "disabled");
+        }
+
         const QString FILTER_KEY = "enable_filter";
         if (audioEnvGroupObject[FILTER_KEY].isBool()) {
             _enableFilter = audioEnvGroupObject[FILTER_KEY].toBool();
@@ -1086,6 +1061,9 @@ void AudioMixer::parseSettingsObject(const QJsonObject &settingsObject) {
             }
         }
 
+        // there is one crowd bed per zone
+        _crowdBed.setZones(_audioZones);
+
         const QString ATTENUATION_COEFFICIENTS = "attenuation_coefficients";
         if (audioEnvGroupObject[ATTENUATION_COEFFICIENTS].isArray()) {
             const QJsonArray& coefficients = audioEnvGroupObject[ATTENUATION_COEFFICIENTS].toArray();
@@ -1143,6 +1121,7 @@ void AudioMixer::parseSettingsObject(const QJsonObject &settingsObject) {
                         settings.wetLevel = wetLevel;
 
                         _zoneReverbSettings.push_back(settings);
+                        _reverbBus.addZone(_audioZones[zone], reverbTime, wetLevel);
                         qDebug() << "Added Reverb:" << zone << reverbTime << wetLevel;
                     }
                 }
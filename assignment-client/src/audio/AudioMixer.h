@@ -15,9 +15,14 @@
 #include <AABox.h>
 #include <AudioHRTF.h>
 #include <AudioRingBuffer.h>
+#include <Histogram.h>
 #include <ThreadedAssignment.h>
 #include <UUIDHasher.h>
 
+#include "AudioCrowdBed.h"
+#include "AudioMixerWorkerPool.h"
+#include "AudioReverbBus.h"
+
 class PositionalAudioStream;
 class AvatarAudioStream;
 class AudioHRTF;
@@ -27,6 +32,8 @@ const int SAMPLE_PHASE_DELAY_AT_90 = 20;
 
 const int READ_DATAGRAMS_STATS_WINDOW_SECONDS = 30;
 
+const int DEFAULT_CROWD_BED_HRTF_SOURCES = 4;
+
 /// Handles assignments of type AudioMixer - mixing streams of audio and re-distributing to various clients.
 class AudioMixer : public ThreadedAssignment {
     Q_OBJECT
@@ -54,32 +61,34 @@ private slots:
     void removeHRTFsForFinishedInjector(const QUuid& streamID);
 
 private:
+    friend class AudioMixerWorker;
+
     AudioMixerClientData* getOrCreateClientData(Node* node);
     void domainSettingsRequestComplete();
-    
-    /// adds one stream to the mix for a listening node
-    void addStreamToMixForListeningNodeWithStream(AudioMixerClientData& listenerNodeData,
-                                                  const PositionalAudioStream& streamToAdd,
-                                                  const QUuid& sourceNodeID,
-                                                  const AvatarAudioStream& listeningNodeStream);
 
+    // these are read concurrently by the mix workers, and must not modify the mixer
     float gainForSource(const PositionalAudioStream& streamToAdd, const AvatarAudioStream& listeningNodeStream,
-                        const glm::vec3& relativePosition, bool isEcho);
+                        const glm::vec3& relativePosition, bool isEcho) const;
     float azimuthForSource(const PositionalAudioStream& streamToAdd, const AvatarAudioStream& listeningNodeStream,
-                           const glm::vec3& relativePosition);
+                           const glm::vec3& relativePosition) const;
+    float azimuthForPosition(const AvatarAudioStream& listeningNodeStream, const glm::vec3& relativePosition) const;
+    float gainForDistance(float distance, float attenuationPerDoublingInDistance) const;
 
-    /// prepares and sends a mix to one Node
-    bool prepareMixForListeningNode(Node* node);
+    bool isCrowdBedEnabled() const { return _crowdBedDistance > 0.0f; }
+    bool isServerReverbEnabled() const { return _serverReverb && _reverbBus.hasZones(); }
 
     /// Send Audio Environment packet for a single node
     void sendAudioEnvironmentPacket(SharedNodePointer node);
 
     void perSecondActions();
 
-    QString percentageForMixStats(int counter);
+    QString percentageForMixStats(int counter, int totalMixes);
 
     bool shouldMute(float quietestFrame);
 
+    // cuts the number of streams mixed per listener when the mix takes up too much of the frame
+    void updateStreamBudget(quint64 mixUsecs, int numStreams);
+
     void parseSettingsObject(const QJsonObject& settingsObject);
 
     float _trailingSleepRatio;
@@ -87,20 +96,24 @@ private:
     float _performanceThrottlingRatio;
     float _attenuationPerDoublingInDistance;
     float _noiseMutingThreshold;
+    float _crowdBedDistance { 0.0f }; // 0 disables the crowd bed
+    int _crowdBedHRTFSources { DEFAULT_CROWD_BED_HRTF_SOURCES };
+    bool _serverReverb { false }; // the reverb of the zones is rendered here instead of by the clients
+    int _streamBudget { 0 }; // 0 is unlimited
+    float _trailingMixRatio { 0.0f };
+    int _framesSinceBudgetChange { 0 };
     int _numStatFrames { 0 };
     int _sumStreams { 0 };
-    int _sumListeners { 0 };
-    int _hrtfRenders { 0 };
-    int _hrtfSilentRenders { 0 };
-    int _hrtfStruggleRenders { 0 };
-    int _manualStereoMixes { 0 };
-    int _manualEchoMixes { 0 };
-    int _totalMixes { 0 };
+
+    Histogram _mixUsecs; // of the frames, all the workers mixing
+    Histogram _micPacketJitterUsecs; // how far the microphone packets of the listeners arrive off their frame interval
 
     QString _codecPreferenceOrder;
 
-    float _mixedSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
-    int16_t _clampedSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
+    AudioCrowdBed _crowdBed;
+    AudioReverbBus _reverbBus;
+
+    AudioMixerWorkerPool _workerPool { *this };
 
     QHash<QString, AABox> _audioZones;
     struct ZonesSettings {
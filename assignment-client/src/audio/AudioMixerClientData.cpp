@@ -14,6 +14,7 @@
 #include <QtCore/QDebug>
 #include <QtCore/QJsonArray>
 
+#include <LogHandler.h>
 #include <udt/PacketHeaders.h>
 #include <UUID.h>
 
@@ -365,10 +366,11 @@ QJsonObject AudioMixerClientData::getAudioStreamStats() {
 }
 
 void AudioMixerClientData::handleMismatchAudioFormat(SharedNodePointer node, const QString& currentCodec, const QString& recievedCodec) {
-    qDebug() << __FUNCTION__ <<
+    // mismatched packets keep coming until the client switches codecs
+    HIFI_LOG_EVERY_MSECS(1000, qDebug() << __FUNCTION__ <<
         "sendingNode:" << *node <<
         "currentCodec:" << currentCodec <<
-        "receivedCodec:" << recievedCodec;
+        "receivedCodec:" << recievedCodec);
     sendSelectAudioFormat(node, currentCodec);
 }
 
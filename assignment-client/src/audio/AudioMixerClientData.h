@@ -38,7 +38,8 @@ public:
     AudioStreamMap getAudioStreams() { QReadLocker readLock { &_streamsLock }; return _audioStreams; }
     AvatarAudioStream* getAvatarAudioStream();
 
-    // the following methods should be called from the AudioMixer assignment thread ONLY
+    // the following methods should be called from the AudioMixer assignment thread,
+    // or from the mix worker that owns this listener for the frame ONLY
     // they are not thread-safe
 
     // returns a new or existing HRTF object for the given stream from the given node
@@ -83,10 +84,30 @@ public:
         _shouldFlushEncoder = true;
     }
     void encodeFrameOfZeros(QByteArray& encodedZeros);
+
+    // true when the encoding of a mix only depends on the mix, so it can be shared with listeners using the same codec
+    bool canShareEncodedMix() const { return _encoder && _encoder->isStateless(); }
+    // for a listener sent an encoding shared with another listener, the encoder will need a flush just as after encode
+    void useSharedEncodedMix() { _shouldFlushEncoder = true; }
     bool shouldFlushEncoder() { return _shouldFlushEncoder; }
 
     QString getCodecName() { return _selectedCodecName; }
     
+    // runs of silence sent as a single SilentAudioRun packet, for clients that asked for them while negotiating a format
+    void setSupportsSilentRuns(bool supportsSilentRuns) { _supportsSilentRuns = supportsSilentRuns; }
+    bool supportsSilentRuns() const { return _supportsSilentRuns; }
+    bool isInSilentRun() const { return _silentRunFramesLeft > 0; }
+    void startSilentRun(int numFrames) { _silentRunFramesLeft = numFrames - 1; } // the first frame is the run packet itself
+    void continueSilentRun() { --_silentRunFramesLeft; }
+    void endSilentRun() { _silentRunFramesLeft = 0; }
+
+    // the usecs since the previous microphone packet of the client, 0 for the first one
+    quint64 takeMicPacketGap(quint64 now) {
+        quint64 gap = (_lastMicPacketTime != 0 && now > _lastMicPacketTime) ? now - _lastMicPacketTime : 0;
+        _lastMicPacketTime = now;
+        return gap;
+    }
+
     bool shouldMuteClient() { return _shouldMuteClient; }
     void setShouldMuteClient(bool shouldMuteClient) { _shouldMuteClient = shouldMuteClient; }
 
@@ -111,6 +132,8 @@ private:
 
     int _frameToSendStats { 0 };
 
+    quint64 _lastMicPacketTime { 0 };
+
     CodecPluginPointer _codec;
     QString _selectedCodecName;
     Encoder* _encoder{ nullptr }; // for outbound mixed stream
@@ -119,6 +142,9 @@ private:
     bool _shouldFlushEncoder { false };
 
     bool _shouldMuteClient { false };
+
+    bool _supportsSilentRuns { false };
+    int _silentRunFramesLeft { 0 };
 };
 
 #endif // hifi_AudioMixerClientData_h
@@ -0,0 +1,39 @@
+//
+//  AudioMixerStats.cpp
+//  assignment-client/src/audio
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioMixerStats.h"
+
+void AudioMixerStats::reset() {
+    sumListeners = 0;
+    totalMixes = 0;
+    hrtfRenders = 0;
+    hrtfSilentRenders = 0;
+    hrtfStruggleRenders = 0;
+    manualStereoMixes = 0;
+    manualEchoMixes = 0;
+    crowdBedMixes = 0;
+    budgetDroppedStreams = 0;
+    sharedEncodes = 0;
+    silentRunFrames = 0;
+}
+
+void AudioMixerStats::accumulate(const AudioMixerStats& otherStats) {
+    sumListeners += otherStats.sumListeners;
+    totalMixes += otherStats.totalMixes;
+    hrtfRenders += otherStats.hrtfRenders;
+    hrtfSilentRenders += otherStats.hrtfSilentRenders;
+    hrtfStruggleRenders += otherStats.hrtfStruggleRenders;
+    manualStereoMixes += otherStats.manualStereoMixes;
+    manualEchoMixes += otherStats.manualEchoMixes;
+    crowdBedMixes += otherStats.crowdBedMixes;
+    budgetDroppedStreams += otherStats.budgetDroppedStreams;
+    sharedEncodes += otherStats.sharedEncodes;
+    silentRunFrames += otherStats.silentRunFrames;
+}
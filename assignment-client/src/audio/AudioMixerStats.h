@@ -0,0 +1,35 @@
+//
+//  AudioMixerStats.h
+//  assignment-client/src/audio
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioMixerStats_h
+#define hifi_AudioMixerStats_h
+
+// counters gathered while mixing, kept per mix worker and summed up for the stats packet
+struct AudioMixerStats {
+    int sumListeners { 0 };
+
+    int totalMixes { 0 };
+
+    int hrtfRenders { 0 };
+    int hrtfSilentRenders { 0 };
+    int hrtfStruggleRenders { 0 };
+    int manualStereoMixes { 0 };
+    int manualEchoMixes { 0 };
+    int crowdBedMixes { 0 };
+    int budgetDroppedStreams { 0 };
+
+    int sharedEncodes { 0 };
+    int silentRunFrames { 0 };
+
+    void reset();
+    void accumulate(const AudioMixerStats& otherStats);
+};
+
+#endif // hifi_AudioMixerStats_h
@@ -0,0 +1,574 @@
+//
+//  AudioMixerWorker.cpp
+//  assignment-client/src/audio
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <algorithm>
+#include <limits>
+
+#include <glm/glm.hpp>
+
+#include <QtCore/QHash>
+
+#include <NodeList.h>
+#include <SharedUtil.h>
+
+#include "AudioMixer.h"
+#include "AudioMixerClientData.h"
+#include "AvatarAudioStream.h"
+#include "InjectedAudioStream.h"
+
+#include "AudioMixerWorker.h"
+
+static const int HRTF_DATASET_INDEX = 1;
+
+// a silent run announces one second of silence, so an idle listener gets one packet per second
+static const int SILENT_RUN_FRAMES = 100;
+
+void AudioMixerWorker::clearFrame() {
+    _listeners.clear();
+    _mixPackets.clear();
+}
+
+void AudioMixerWorker::resetTiming() {
+    _totalMixUsecs = 0;
+    _maxMixUsecs = 0;
+    _numMixedFrames = 0;
+}
+
+void AudioMixerWorker::mixQueuedListeners() {
+    quint64 start = usecTimestampNow();
+
+    _encodedMixes.clear();
+
+    for (auto& node : _listeners) {
+        AudioMixerClientData* nodeData = static_cast<AudioMixerClientData*>(node->getLinkedData());
+
+        bool mixHasAudio = prepareMixForListeningNode(node.data());
+
+        _mixPackets.emplace_back(node, createMixPacket(*nodeData, mixHasAudio));
+
+        ++stats.sumListeners;
+    }
+
+    quint64 mixUsecs = usecTimestampNow() - start;
+    _totalMixUsecs += mixUsecs;
+    _maxMixUsecs = std::max(_maxMixUsecs, mixUsecs);
+    ++_numMixedFrames;
+}
+
+std::unique_ptr<NLPacket> AudioMixerWorker::createMixPacket(AudioMixerClientData& nodeData, bool mixHasAudio) {
+    std::unique_ptr<NLPacket> mixPacket;
+
+    if (mixHasAudio || nodeData.shouldFlushEncoder()) {
+        // audio breaks any run of silence the client is synthesizing
+        nodeData.endSilentRun();
+
+        int mixPacketBytes = sizeof(quint16) + AudioConstants::MAX_CODEC_NAME_LENGTH_ON_WIRE
+                                             + AudioConstants::NETWORK_FRAME_BYTES_STEREO;
+        mixPacket = NLPacket::create(PacketType::MixedAudio, mixPacketBytes);
+
+        // pack sequence number
+        quint16 sequence = nodeData.getOutgoingSequenceNumber();
+        mixPacket->writePrimitive(sequence);
+
+        // write the codec
+        QString codecInPacket = nodeData.getCodecName();
+        mixPacket->writeString(codecInPacket);
+
+        QByteArray encodedBuffer;
+        if (mixHasAudio) {
+            encodeMix(nodeData, encodedBuffer);
+        } else {
+            // time to flush, which resets the shouldFlush until next time we encode something
+            nodeData.encodeFrameOfZeros(encodedBuffer);
+        }
+        // pack mixed audio samples
+        mixPacket->write(encodedBuffer.constData(), encodedBuffer.size());
+
+    } else if (nodeData.isInSilentRun()) {
+        // the client synthesizes this frame itself, nothing is sent and the sequence number does not move
+        nodeData.continueSilentRun();
+
+        ++stats.silentRunFrames;
+
+    } else {
+        bool isSilentRun = nodeData.supportsSilentRuns();
+        PacketType packetType = isSilentRun ? PacketType::SilentAudioRun : PacketType::SilentAudioFrame;
+
+        int silentPacketBytes = sizeof(quint16) + sizeof(quint16) + AudioConstants::MAX_CODEC_NAME_LENGTH_ON_WIRE
+                                + (isSilentRun ? sizeof(quint16) : 0);
+        mixPacket = NLPacket::create(packetType, silentPacketBytes);
+
+        // pack sequence number
+        quint16 sequence = nodeData.getOutgoingSequenceNumber();
+        mixPacket->writePrimitive(sequence);
+
+        // write the codec
+        QString codecInPacket = nodeData.getCodecName();
+        mixPacket->writeString(codecInPacket);
+
+        // pack number of silent audio samples
+        quint16 numSilentSamples = AudioConstants::NETWORK_FRAME_SAMPLES_STEREO;
+        mixPacket->writePrimitive(numSilentSamples);
+
+        if (isSilentRun) {
+            // pack the number of frames this run lasts, unless audio comes back first
+            quint16 numSilentFrames = SILENT_RUN_FRAMES;
+            mixPacket->writePrimitive(numSilentFrames);
+
+            nodeData.startSilentRun(SILENT_RUN_FRAMES);
+        }
+    }
+
+    return mixPacket;
+}
+
+void AudioMixerWorker::encodeMix(AudioMixerClientData& nodeData, QByteArray& encodedBuffer) {
+    QByteArray decodedBuffer(reinterpret_cast<char*>(_clampedSamples), AudioConstants::NETWORK_FRAME_BYTES_STEREO);
+
+    if (!nodeData.canShareEncodedMix()) {
+        nodeData.encode(decodedBuffer, encodedBuffer);
+        return;
+    }
+
+    // listeners with the same stateless codec and a bit-identical mix share one encoding
+    QString codecName = nodeData.getCodecName();
+    uint mixHash = qHash(decodedBuffer, qHash(codecName));
+
+    auto it = _encodedMixes.find(mixHash);
+    if (it != _encodedMixes.end() && it->second.codecName == codecName && it->second.decodedBuffer == decodedBuffer) {
+        encodedBuffer = it->second.encodedBuffer;
+        nodeData.useSharedEncodedMix();
+
+        ++stats.sharedEncodes;
+        return;
+    }
+
+    nodeData.encode(decodedBuffer, encodedBuffer);
+
+    // on a hash collision the first mix keeps the entry, the other is simply not shared
+    if (it == _encodedMixes.end()) {
+        _encodedMixes.emplace(mixHash, EncodedMix { codecName, decodedBuffer, encodedBuffer });
+    }
+}
+
+void AudioMixerWorker::addStreamToMixForListeningNodeWithStream(AudioMixerClientData& listenerNodeData,
+                                                                const PositionalAudioStream& streamToAdd,
+                                                                const QUuid& sourceNodeID,
+                                                                const AvatarAudioStream& listeningNodeStream) {
+
+
+    // to reduce artifacts we calculate the gain and azimuth for every source for this listener
+    // even if we are not going to end up mixing in this source
+
+    ++stats.totalMixes;
+
+    // this ensures that the tail of any previously mixed audio or the first block of new audio sounds correct
+
+    // check if this is a server echo of a source back to itself
+    bool isEcho = (&streamToAdd == &listeningNodeStream);
+
+    glm::vec3 relativePosition = streamToAdd.getPosition() - listeningNodeStream.getPosition();
+
+    // figure out the distance between source and listener
+    float distance = glm::max(glm::length(relativePosition), EPSILON);
+
+    // figure out the gain for this source at the listener
+    float gain = _mixer.gainForSource(streamToAdd, listeningNodeStream, relativePosition, isEcho);
+
+    // figure out the azimuth to this source at the listener
+    float azimuth = isEcho ? 0.0f : _mixer.azimuthForSource(streamToAdd, listeningNodeStream, relativePosition);
+
+    float repeatedFrameFadeFactor = 1.0f;
+
+    if (!streamToAdd.lastPopSucceeded()) {
+        bool forceSilentBlock = true;
+
+        if (!streamToAdd.getLastPopOutput().isNull()) {
+            bool isInjector = dynamic_cast<const InjectedAudioStream*>(&streamToAdd);
+
+            // in an injector, just go silent - the injector has likely ended
+            // in other inputs (microphone, &c.), repeat with fade to avoid the harsh jump to silence
+
+            // we'll repeat the last block until it has a block to mix
+            // and we'll gradually fade that repeated block into silence.
+
+            // calculate its fade factor, which depends on how many times it's already been repeated.
+            repeatedFrameFadeFactor = calculateRepeatedFrameFadeFactor(streamToAdd.getConsecutiveNotMixedCount() - 1);
+            if (!isInjector && repeatedFrameFadeFactor > 0.0f) {
+                // apply the repeatedFrameFadeFactor to the gain
+                gain *= repeatedFrameFadeFactor;
+
+                forceSilentBlock = false;
+            }
+        }
+
+        if (forceSilentBlock) {
+            // we're deciding not to repeat either since we've already done it enough times or repetition with fade is disabled
+            // in this case we will call renderSilent with a forced silent block
+            // this ensures the correct tail from the previously mixed block and the correct spatialization of first block
+            // of any upcoming audio
+
+            if (!streamToAdd.isStereo() && !isEcho) {
+                // get the existing listener-source HRTF object, or create a new one
+                auto& hrtf = listenerNodeData.hrtfForStream(sourceNodeID, streamToAdd.getStreamIdentifier());
+
+                // this is not done for stereo streams since they do not go through the HRTF
+                // it is only ever read from, so it is safe to share between mix workers
+                static int16_t silentMonoBlock[AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL] = {};
+                hrtf.renderSilent(silentMonoBlock, _mixedSamples, HRTF_DATASET_INDEX, azimuth, distance, gain,
+                                  AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+
+                ++stats.hrtfSilentRenders;
+            }
+
+            return;
+        }
+    }
+
+    // grab the stream from the ring buffer
+    AudioRingBuffer::ConstIterator streamPopOutput = streamToAdd.getLastPopOutput();
+
+    if (streamToAdd.isStereo() || isEcho) {
+        // this is a stereo source or server echo so we do not pass it through the HRTF
+        // simply apply our calculated gain to each sample, ramped by the listener-source HRTF object
+        auto& hrtf = listenerNodeData.hrtfForStream(sourceNodeID, streamToAdd.getStreamIdentifier());
+
+        if (streamToAdd.isStereo()) {
+            const int16_t* streamBlock = readStreamBlock(streamPopOutput, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO);
+            hrtf.mixStereo(streamBlock, _mixedSamples, gain, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+
+            ++stats.manualStereoMixes;
+        } else {
+            const int16_t* streamBlock = readStreamBlock(streamPopOutput, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+            hrtf.mixMono(streamBlock, _mixedSamples, gain, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+
+            ++stats.manualEchoMixes;
+        }
+
+        return;
+    }
+
+    // get the existing listener-source HRTF object, or create a new one
+    auto& hrtf = listenerNodeData.hrtfForStream(sourceNodeID, streamToAdd.getStreamIdentifier());
+
+    const int16_t* streamBlock = readStreamBlock(streamPopOutput, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+
+    // if the frame we're about to mix is silent, simply call render silent and move on
+    if (streamToAdd.getLastPopOutputLoudness() == 0.0f) {
+        // silent frame from source
+
+        // we still need to call renderSilent via the HRTF for mono source
+        hrtf.renderSilent(streamBlock, _mixedSamples, HRTF_DATASET_INDEX, azimuth, distance, gain,
+                          AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+
+        ++stats.hrtfSilentRenders;
+
+        return;
+    }
+
+    if (_mixer._performanceThrottlingRatio > 0.0f
+        && streamToAdd.getLastPopOutputTrailingLoudness() / glm::length(relativePosition) <= _mixer._minAudibilityThreshold) {
+        // the mixer is struggling so we're going to drop off some streams
+
+        // we call renderSilent via the HRTF with the actual frame data and a gain of 0.0
+        hrtf.renderSilent(streamBlock, _mixedSamples, HRTF_DATASET_INDEX, azimuth, distance, 0.0f,
+                          AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+
+        ++stats.hrtfStruggleRenders;
+
+        return;
+    }
+
+    ++stats.hrtfRenders;
+
+    // mono stream, queue the HRTF render with our block and calculated azimuth and gain
+    // a block that was copied out of the ring buffer is kept with the batch, and pointed to once it can no longer move
+    if (streamBlock == _streamBlock) {
+        _hrtfBatchSamples.insert(_hrtfBatchSamples.end(), _streamBlock,
+                                 _streamBlock + AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+        streamBlock = nullptr;
+    }
+    _hrtfBatch.push_back({ &hrtf, streamBlock, azimuth, distance, gain });
+}
+
+const int16_t* AudioMixerWorker::readStreamBlock(AudioRingBuffer::ConstIterator& streamPopOutput, int numSamples) {
+    // the popped frame is not written to until the next frame, so it can be read in place unless it wraps
+    const int16_t* streamBlock = streamPopOutput.contiguousSamples(numSamples);
+    if (!streamBlock) {
+        streamPopOutput.readSamples(_streamBlock, numSamples);
+        streamBlock = _streamBlock;
+    }
+    return streamBlock;
+}
+
+void AudioMixerWorker::renderHRTFBatch() {
+    int numCopiedBlocks = 0;
+    for (auto& source : _hrtfBatch) {
+        if (!source.input) {
+            source.input = &_hrtfBatchSamples[numCopiedBlocks++ * AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL];
+        }
+    }
+
+    AudioHRTF::renderBatch(_hrtfBatch.data(), (int)_hrtfBatch.size(), _mixedSamples, HRTF_DATASET_INDEX,
+                           AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+
+    _hrtfBatch.clear();
+    _hrtfBatchSamples.clear();
+}
+
+bool AudioMixerWorker::prepareMixForListeningNode(Node* node) {
+    AvatarAudioStream* nodeAudioStream = static_cast<AudioMixerClientData*>(node->getLinkedData())->getAvatarAudioStream();
+    AudioMixerClientData* listenerNodeData = static_cast<AudioMixerClientData*>(node->getLinkedData());
+
+    // zero out the client mix for this node
+    memset(_mixedSamples, 0, sizeof(_mixedSamples));
+
+    const AudioCrowdBed& crowdBed = _mixer._crowdBed;
+    bool useCrowdBed = _mixer.isCrowdBedEnabled();
+    if (useCrowdBed) {
+        prepareCrowdSectorGains(*nodeAudioStream);
+        _farStreams.clear();
+    }
+
+    // when the mixer is over budget, streams are ranked before they are mixed
+    int streamBudget = _mixer._streamBudget;
+    _budgetedStreams.clear();
+
+    // loop through all other nodes that have sufficient audio to mix
+
+    DependencyManager::get<NodeList>()->eachNode([&](const SharedNodePointer& otherNode){
+        // make sure that we have audio data for this other node
+        if (!otherNode->getLinkedData()) {
+            return;
+        }
+
+        // streams of an ignored node are still in the crowd bed, so they cannot be skipped when it is in use
+        bool isIgnored = node->isIgnoringNodeWithID(otherNode->getUUID());
+        if (isIgnored && !useCrowdBed) {
+            return;
+        }
+
+        AudioMixerClientData* otherNodeClientData = (AudioMixerClientData*) otherNode->getLinkedData();
+
+        // enumerate the ARBs attached to the otherNode and add all that should be added to mix
+        auto streamsCopy = otherNodeClientData->getAudioStreams();
+
+        for (auto& streamPair : streamsCopy) {
+
+            auto otherNodeStream = streamPair.second;
+
+            bool shouldMix = !isIgnored && (*otherNode != *node || otherNodeStream->shouldLoopbackForNode());
+
+            const AudioCrowdBed::Slot* slot = useCrowdBed ? crowdBed.slotForStream(otherNodeStream.get()) : nullptr;
+            if (slot) {
+                float distance = glm::length(otherNodeStream->getPosition() - nodeAudioStream->getPosition());
+
+                if (shouldMix && distance > _mixer._crowdBedDistance) {
+                    // this far source is heard from the bed, unless it turns out to be one of the loudest
+                    float loudness = otherNodeStream->getLastPopOutputTrailingLoudness() / distance;
+                    _farStreams.push_back({ otherNodeStream, otherNode->getUUID(), slot, loudness });
+                    continue;
+                }
+
+                // this listener should not hear this stream from the bed, take it back out
+                removeStreamFromCrowdBed(*otherNodeStream, *slot);
+            }
+
+            if (shouldMix) {
+                if (streamBudget > 0) {
+                    _budgetedStreams.push_back({ otherNodeStream, otherNode->getUUID(),
+                                                 audibilityAtListener(*otherNodeStream, *nodeAudioStream) });
+                } else {
+                    addStreamToMixForListeningNodeWithStream(*listenerNodeData, *otherNodeStream, otherNode->getUUID(),
+                                                             *nodeAudioStream);
+                }
+            }
+        }
+    });
+
+    if (streamBudget > 0) {
+        mixBudgetedStreams(*listenerNodeData, *nodeAudioStream, streamBudget);
+    }
+
+    if (useCrowdBed) {
+        mixFarStreams(*listenerNodeData, *nodeAudioStream);
+        mixCrowdBed();
+    }
+
+    // render every audible mono stream through its HRTF in one pass over the mix
+    renderHRTFBatch();
+
+    // the listeners in a reverb zone share the wet mix of the zone
+    if (_mixer.isServerReverbEnabled()) {
+        mixReverbBus(*nodeAudioStream);
+    }
+
+    // use the per listner AudioLimiter to render the mixed data...
+    listenerNodeData->audioLimiter.render(_mixedSamples, _clampedSamples, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+
+    // check for silent audio after the peak limitor has converted the samples
+    bool hasAudio = false;
+    for (int i = 0; i < AudioConstants::NETWORK_FRAME_SAMPLES_STEREO; ++i) {
+        if (_clampedSamples[i] != 0) {
+            hasAudio = true;
+            break;
+        }
+    }
+    return hasAudio;
+}
+
+float AudioMixerWorker::audibilityAtListener(const PositionalAudioStream& stream,
+                                             const AvatarAudioStream& listeningNodeStream) const {
+    // the listener always keeps its own echo
+    if (&stream == &listeningNodeStream) {
+        return std::numeric_limits<float>::max();
+    }
+
+    // rank by loudness above the noise floor of the stream, so constant background noise is shed first
+    float loudness = glm::max(stream.getLastPopOutputTrailingLoudness() - stream.getQuietestFrameLoudness(), 0.0f);
+    float distance = glm::max(glm::length(stream.getPosition() - listeningNodeStream.getPosition()), EPSILON);
+    return loudness / distance;
+}
+
+void AudioMixerWorker::mixBudgetedStreams(AudioMixerClientData& listenerNodeData,
+                                          const AvatarAudioStream& listeningNodeStream, int streamBudget) {
+    int numMixedStreams = std::min((int)_budgetedStreams.size(), streamBudget);
+
+    std::nth_element(_budgetedStreams.begin(), _budgetedStreams.begin() + numMixedStreams, _budgetedStreams.end(),
+                     [](const BudgetedStream& a, const BudgetedStream& b) { return a.audibility > b.audibility; });
+
+    for (int i = 0; i < (int)_budgetedStreams.size(); ++i) {
+        auto& budgetedStream = _budgetedStreams[i];
+        if (i < numMixedStreams) {
+            addStreamToMixForListeningNodeWithStream(listenerNodeData, *budgetedStream.stream, budgetedStream.sourceNodeID,
+                                                     listeningNodeStream);
+        } else {
+            dropStreamFromMix(listenerNodeData, *budgetedStream.stream, budgetedStream.sourceNodeID, listeningNodeStream);
+        }
+    }
+}
+
+void AudioMixerWorker::dropStreamFromMix(AudioMixerClientData& listenerNodeData, const PositionalAudioStream& streamToDrop,
+                                         const QUuid& sourceNodeID, const AvatarAudioStream& listeningNodeStream) {
+    ++stats.totalMixes;
+    ++stats.budgetDroppedStreams;
+
+    if (streamToDrop.isStereo()) {
+        return;
+    }
+
+    // fade the HRTF out with a gain of 0.0, after the first block renderSilent is free
+    static int16_t silentMonoBlock[AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL] = {};
+
+    glm::vec3 relativePosition = streamToDrop.getPosition() - listeningNodeStream.getPosition();
+    float distance = glm::max(glm::length(relativePosition), EPSILON);
+    float azimuth = _mixer.azimuthForSource(streamToDrop, listeningNodeStream, relativePosition);
+
+    auto& hrtf = listenerNodeData.hrtfForStream(sourceNodeID, streamToDrop.getStreamIdentifier());
+    hrtf.renderSilent(silentMonoBlock, _mixedSamples, HRTF_DATASET_INDEX, azimuth, distance, 0.0f,
+                      AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+}
+
+void AudioMixerWorker::prepareCrowdSectorGains(const AvatarAudioStream& listeningNodeStream) {
+    const AudioCrowdBed& crowdBed = _mixer._crowdBed;
+
+    _crowdSectorGains.resize(crowdBed.getNumBeds() * AudioCrowdBed::NUM_SECTORS);
+
+    for (int bed = 0; bed < crowdBed.getNumBeds(); ++bed) {
+        for (int i = 0; i < AudioCrowdBed::NUM_SECTORS; ++i) {
+            auto& sectorGain = _crowdSectorGains[bed * AudioCrowdBed::NUM_SECTORS + i];
+            const AudioCrowdBed::Sector& sector = crowdBed.getSector(bed, i);
+
+            if (sector.numSources == 0) {
+                sectorGain = glm::vec2(0.0f);
+                continue;
+            }
+
+            glm::vec3 relativePosition = sector.position - listeningNodeStream.getPosition();
+            float distance = glm::max(glm::length(relativePosition), EPSILON);
+            float gain = _mixer.gainForDistance(distance, _mixer._attenuationPerDoublingInDistance);
+
+            // constant power pan, the sector is too coarse to be worth an HRTF
+            float pan = sinf(_mixer.azimuthForPosition(listeningNodeStream, relativePosition));
+            sectorGain.x = gain * sqrtf(0.5f * (1.0f - pan));
+            sectorGain.y = gain * sqrtf(0.5f * (1.0f + pan));
+        }
+    }
+}
+
+void AudioMixerWorker::mixFarStreams(AudioMixerClientData& listenerNodeData, const AvatarAudioStream& listeningNodeStream) {
+    int numHRTFStreams = std::min((int)_farStreams.size(), _mixer._crowdBedHRTFSources);
+
+    // the loudest far streams at this listener keep their own HRTF
+    std::nth_element(_farStreams.begin(), _farStreams.begin() + numHRTFStreams, _farStreams.end(),
+                     [](const FarStream& a, const FarStream& b) { return a.loudness > b.loudness; });
+
+    for (int i = 0; i < (int)_farStreams.size(); ++i) {
+        auto& farStream = _farStreams[i];
+        if (i < numHRTFStreams) {
+            removeStreamFromCrowdBed(*farStream.stream, *farStream.slot);
+            addStreamToMixForListeningNodeWithStream(listenerNodeData, *farStream.stream, farStream.sourceNodeID,
+                                                     listeningNodeStream);
+        } else {
+            ++stats.totalMixes;
+            ++stats.crowdBedMixes;
+        }
+    }
+}
+
+void AudioMixerWorker::mixCrowdBed() {
+    const AudioCrowdBed& crowdBed = _mixer._crowdBed;
+
+    for (int bed = 0; bed < crowdBed.getNumBeds(); ++bed) {
+        for (int i = 0; i < AudioCrowdBed::NUM_SECTORS; ++i) {
+            const AudioCrowdBed::Sector& sector = crowdBed.getSector(bed, i);
+            if (sector.numSources == 0) {
+                continue;
+            }
+
+            const glm::vec2& sectorGain = _crowdSectorGains[bed * AudioCrowdBed::NUM_SECTORS + i];
+            for (int j = 0; j < AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL; ++j) {
+                _mixedSamples[2 * j] += sector.samples[j] * sectorGain.x;
+                _mixedSamples[2 * j + 1] += sector.samples[j] * sectorGain.y;
+            }
+        }
+    }
+}
+
+void AudioMixerWorker::mixReverbBus(const AvatarAudioStream& listeningNodeStream) {
+    const AudioReverbBus::Bus* bus = _mixer._reverbBus.busForPosition(listeningNodeStream.getPosition());
+    if (!bus) {
+        return;
+    }
+
+    // same balance as the client reverb, the dry mix fades as the wet level goes up
+    float dryLevel = 1.0f - bus->wetLevel;
+    for (int i = 0; i < AudioConstants::NETWORK_FRAME_SAMPLES_STEREO; ++i) {
+        _mixedSamples[i] = _mixedSamples[i] * dryLevel + bus->samples[i] * bus->wetLevel;
+    }
+}
+
+void AudioMixerWorker::removeStreamFromCrowdBed(const PositionalAudioStream& stream, const AudioCrowdBed::Slot& slot) {
+    const glm::vec2& sectorGain = _crowdSectorGains[slot.bed * AudioCrowdBed::NUM_SECTORS + slot.sector];
+
+    // subtract exactly what mixCrowdBed will add for this stream
+    AudioRingBuffer::ConstIterator::Span spans[2];
+    stream.getLastPopOutput().getSpans(AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL, spans[0], spans[1]);
+    float scale = slot.gain / AudioConstants::MAX_SAMPLE_VALUE;
+    float* mixedSamples = _mixedSamples;
+    for (auto& span : spans) {
+        for (int i = 0; i < span.numSamples; ++i) {
+            float sample = span.samples[i] * scale;
+            mixedSamples[2 * i] -= sample * sectorGain.x;
+            mixedSamples[2 * i + 1] -= sample * sectorGain.y;
+        }
+        mixedSamples += 2 * span.numSamples;
+    }
+}
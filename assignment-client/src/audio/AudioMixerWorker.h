@@ -0,0 +1,140 @@
+//
+//  AudioMixerWorker.h
+//  assignment-client/src/audio
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioMixerWorker_h
+#define hifi_AudioMixerWorker_h
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QString>
+
+#include <AudioConstants.h>
+#include <AudioHRTF.h>
+#include <AudioRingBuffer.h>
+#include <NLPacket.h>
+#include <Node.h>
+
+#include "AudioCrowdBed.h"
+#include "AudioMixerStats.h"
+
+class AudioMixer;
+class AudioMixerClientData;
+class AvatarAudioStream;
+class PositionalAudioStream;
+
+/// Mixes audio for the set of listeners handed to it for a frame.
+/// A worker owns its mix buffers, so several workers can mix concurrently for different listeners.
+class AudioMixerWorker {
+public:
+    using MixPacket = std::pair<SharedNodePointer, std::unique_ptr<NLPacket>>;
+    using MixPackets = std::vector<MixPacket>;
+
+    AudioMixerWorker(const AudioMixer& mixer) : _mixer(mixer) {}
+
+    // the following methods are called between frames from the AudioMixer assignment thread
+    void queueListener(const SharedNodePointer& node) { _listeners.push_back(node); }
+    int getNumQueuedListeners() const { return (int)_listeners.size(); }
+    MixPackets& getMixPackets() { return _mixPackets; }
+    void clearFrame();
+
+    /// prepares a mix packet for every queued listener, called from the worker's own thread
+    void mixQueuedListeners();
+
+    AudioMixerStats stats;
+
+    // timing of mixQueuedListeners since the last resetTiming
+    quint64 getTotalMixUsecs() const { return _totalMixUsecs; }
+    quint64 getMaxMixUsecs() const { return _maxMixUsecs; }
+    int getNumMixedFrames() const { return _numMixedFrames; }
+    void resetTiming();
+
+private:
+    /// prepares a mix for one node, returns true if the mix has audio
+    bool prepareMixForListeningNode(Node* node);
+
+    /// adds one stream to the mix for a listening node
+    void addStreamToMixForListeningNodeWithStream(AudioMixerClientData& listenerNodeData,
+                                                  const PositionalAudioStream& streamToAdd,
+                                                  const QUuid& sourceNodeID,
+                                                  const AvatarAudioStream& listeningNodeStream);
+
+    // per listener stream budget, used when the mixer is running out of frame time
+    float audibilityAtListener(const PositionalAudioStream& stream, const AvatarAudioStream& listeningNodeStream) const;
+    void mixBudgetedStreams(AudioMixerClientData& listenerNodeData, const AvatarAudioStream& listeningNodeStream,
+                            int streamBudget);
+    void dropStreamFromMix(AudioMixerClientData& listenerNodeData, const PositionalAudioStream& streamToDrop,
+                           const QUuid& sourceNodeID, const AvatarAudioStream& listeningNodeStream);
+
+    // crowd bed mixing, see AudioCrowdBed
+    void prepareCrowdSectorGains(const AvatarAudioStream& listeningNodeStream);
+    void mixFarStreams(AudioMixerClientData& listenerNodeData, const AvatarAudioStream& listeningNodeStream);
+    void mixCrowdBed();
+    void removeStreamFromCrowdBed(const PositionalAudioStream& stream, const AudioCrowdBed::Slot& slot);
+
+    // adds the wet mix of the reverb zone of the listener, see AudioReverbBus
+    void mixReverbBus(const AvatarAudioStream& listeningNodeStream);
+
+    // returns the samples of a popped frame, in place in the ring buffer when possible or copied to _streamBlock
+    const int16_t* readStreamBlock(AudioRingBuffer::ConstIterator& streamPopOutput, int numSamples);
+
+    // renders the HRTFs queued for the current listener into the mix
+    void renderHRTFBatch();
+
+    std::unique_ptr<NLPacket> createMixPacket(AudioMixerClientData& nodeData, bool mixHasAudio);
+    void encodeMix(AudioMixerClientData& nodeData, QByteArray& encodedBuffer);
+
+    const AudioMixer& _mixer;
+
+    std::vector<SharedNodePointer> _listeners;
+    MixPackets _mixPackets;
+
+    float _mixedSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
+    int16_t _clampedSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
+    int16_t _streamBlock[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
+
+    struct FarStream {
+        std::shared_ptr<PositionalAudioStream> stream;
+        QUuid sourceNodeID;
+        const AudioCrowdBed::Slot* slot;
+        float loudness;
+    };
+    std::vector<FarStream> _farStreams;
+
+    struct BudgetedStream {
+        std::shared_ptr<PositionalAudioStream> stream;
+        QUuid sourceNodeID;
+        float audibility;
+    };
+    std::vector<BudgetedStream> _budgetedStreams;
+    std::vector<glm::vec2> _crowdSectorGains; // left and right gain for each sector of each bed
+
+    // audible mono streams of the current listener, rendered together by renderHRTFBatch
+    std::vector<AudioHRTF::Source> _hrtfBatch;
+    std::vector<int16_t> _hrtfBatchSamples;
+
+    // encoded mixes of the current frame, keyed by a hash of the codec and the mix
+    struct EncodedMix {
+        QString codecName;
+        QByteArray decodedBuffer;
+        QByteArray encodedBuffer;
+    };
+    std::unordered_map<uint, EncodedMix> _encodedMixes;
+
+    quint64 _totalMixUsecs { 0 };
+    quint64 _maxMixUsecs { 0 };
+    int _numMixedFrames { 0 };
+};
+
+#endif // hifi_AudioMixerWorker_h
@@ -0,0 +1,117 @@
+//
+//  AudioMixerWorkerPool.cpp
+//  assignment-client/src/audio
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QtCore/QDebug>
+
+#include <UUIDHasher.h>
+
+#include "AudioMixerWorkerPool.h"
+
+static const int MAX_MIX_THREADS = 64;
+
+AudioMixerWorkerPool::AudioMixerWorkerPool(const AudioMixer& mixer, int numThreads) : _mixer(mixer) {
+    setNumThreads(numThreads);
+}
+
+AudioMixerWorkerPool::~AudioMixerWorkerPool() {
+    stopThreads();
+}
+
+void AudioMixerWorkerPool::stopThreads() {
+    {
+        Lock lock(_mutex);
+        _shouldStop = true;
+    }
+    _frameReady.notify_all();
+
+    for (auto& thread : _threads) {
+        thread.join();
+    }
+    _threads.clear();
+
+    _shouldStop = false;
+}
+
+void AudioMixerWorkerPool::setNumThreads(int numThreads) {
+    if (numThreads <= 0) {
+        numThreads = std::max(1, (int)std::thread::hardware_concurrency());
+    }
+    numThreads = std::min(numThreads, MAX_MIX_THREADS);
+
+    if (numThreads == this->numThreads()) {
+        return;
+    }
+
+    qDebug() << "Resizing audio mix worker pool from" << this->numThreads() << "to" << numThreads << "threads";
+
+    stopThreads();
+
+    _workers.clear();
+    for (int i = 0; i < numThreads; ++i) {
+        _workers.emplace_back(new AudioMixerWorker(_mixer));
+    }
+
+    // with a single worker the mix runs on the calling thread, there is no need for a separate one
+    if (numThreads > 1) {
+        for (auto& worker : _workers) {
+            _threads.emplace_back(&AudioMixerWorkerPool::run, this, worker.get(), _frame);
+        }
+    }
+}
+
+void AudioMixerWorkerPool::queueListener(const SharedNodePointer& node) {
+    size_t index = std::hash<QUuid>()(node->getUUID()) % _workers.size();
+    _workers[index]->queueListener(node);
+}
+
+void AudioMixerWorkerPool::mix() {
+    if (_threads.empty()) {
+        _workers.front()->mixQueuedListeners();
+        return;
+    }
+
+    {
+        Lock lock(_mutex);
+        _numPendingWorkers = (int)_workers.size();
+        ++_frame;
+    }
+    _frameReady.notify_all();
+
+    // wait on every worker before any mix packet is sent
+    Lock lock(_mutex);
+    _frameDone.wait(lock, [&] { return _numPendingWorkers == 0; });
+}
+
+void AudioMixerWorkerPool::run(AudioMixerWorker* worker, int startFrame) {
+    int lastFrame = startFrame;
+
+    while (true) {
+        {
+            Lock lock(_mutex);
+            _frameReady.wait(lock, [&] { return _shouldStop || _frame != lastFrame; });
+
+            if (_shouldStop) {
+                return;
+            }
+            lastFrame = _frame;
+        }
+
+        worker->mixQueuedListeners();
+
+        bool isLastWorker = false;
+        {
+            Lock lock(_mutex);
+            isLastWorker = (--_numPendingWorkers == 0);
+        }
+        if (isLastWorker) {
+            _frameDone.notify_one();
+        }
+    }
+}
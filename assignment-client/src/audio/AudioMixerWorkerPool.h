@@ -0,0 +1,69 @@
+//
+//  AudioMixerWorkerPool.h
+//  assignment-client/src/audio
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioMixerWorkerPool_h
+#define hifi_AudioMixerWorkerPool_h
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "AudioMixerWorker.h"
+
+/// Splits the listeners of a frame between a set of AudioMixerWorkers, each running on its own thread.
+/// A listener is always handed to the same worker, so its HRTF state is only ever touched by one thread.
+class AudioMixerWorkerPool {
+public:
+    AudioMixerWorkerPool(const AudioMixer& mixer, int numThreads = 1);
+    ~AudioMixerWorkerPool();
+
+    AudioMixerWorkerPool(const AudioMixerWorkerPool&) = delete;
+    AudioMixerWorkerPool& operator=(const AudioMixerWorkerPool&) = delete;
+
+    // must be called between frames, 0 uses one thread per available core
+    void setNumThreads(int numThreads);
+    int numThreads() const { return (int)_workers.size(); }
+
+    // queue a listener on the worker that owns it
+    void queueListener(const SharedNodePointer& node);
+
+    // mix for every queued listener, blocks until all workers have finished the frame
+    void mix();
+
+    template <typename Functor>
+    void each(Functor functor) {
+        for (auto& worker : _workers) {
+            functor(*worker);
+        }
+    }
+
+private:
+    using Mutex = std::mutex;
+    using Lock = std::unique_lock<Mutex>;
+
+    void run(AudioMixerWorker* worker, int startFrame);
+    void stopThreads();
+
+    const AudioMixer& _mixer;
+
+    std::vector<std::unique_ptr<AudioMixerWorker>> _workers;
+    std::vector<std::thread> _threads;
+
+    Mutex _mutex;
+    std::condition_variable _frameReady;
+    std::condition_variable _frameDone;
+    int _frame { 0 };
+    int _numPendingWorkers { 0 };
+    bool _shouldStop { false };
+};
+
+#endif // hifi_AudioMixerWorkerPool_h
@@ -0,0 +1,90 @@
+//
+//  AudioReverbBus.cpp
+//  assignment-client/src/audio
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <string.h>
+
+#include "PositionalAudioStream.h"
+
+#include "AudioReverbBus.h"
+
+void AudioReverbBus::addZone(const AABox& zone, float reverbTime, float wetLevel) {
+    Bus bus;
+    bus.zone = zone;
+    bus.wetLevel = glm::clamp(wetLevel / 100.0f, 0.0f, 1.0f);
+
+    // the reverb defaults to fully wet, the wet level is applied by the mix workers
+    bus.reverb.reset(new AudioReverb(AudioConstants::SAMPLE_RATE));
+    ReverbParameters parameters;
+    bus.reverb->getParameters(&parameters);
+    parameters.reverbTime = reverbTime;
+    bus.reverb->setParameters(&parameters);
+
+    _buses.push_back(std::move(bus));
+}
+
+void AudioReverbBus::clear() {
+    for (auto& bus : _buses) {
+        memset(bus.samples, 0, sizeof(bus.samples));
+    }
+}
+
+void AudioReverbBus::addStream(const PositionalAudioStream& stream, float gain) {
+    if (!stream.lastPopSucceeded() || stream.getLastPopOutputLoudness() == 0.0f) {
+        return;
+    }
+
+    for (auto& bus : _buses) {
+        if (!bus.zone.contains(stream.getPosition())) {
+            continue;
+        }
+
+        // the send is not panned, the reverb is diffuse anyway
+        bool isStereo = stream.isStereo();
+        int numSamples = isStereo ? AudioConstants::NETWORK_FRAME_SAMPLES_STEREO :
+                                    AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
+        AudioRingBuffer::ConstIterator::Span spans[2];
+        stream.getLastPopOutput().getSpans(numSamples, spans[0], spans[1]);
+
+        float scale = gain / AudioConstants::MAX_SAMPLE_VALUE;
+        float* busSamples = bus.samples;
+        for (auto& span : spans) {
+            if (isStereo) {
+                for (int i = 0; i < span.numSamples; ++i) {
+                    busSamples[i] += span.samples[i] * scale;
+                }
+                busSamples += span.numSamples;
+            } else {
+                for (int i = 0; i < span.numSamples; ++i) {
+                    float sample = span.samples[i] * scale;
+                    busSamples[2*i+0] += sample;
+                    busSamples[2*i+1] += sample;
+                }
+                busSamples += 2 * span.numSamples;
+            }
+        }
+        break;
+    }
+}
+
+void AudioReverbBus::finalize() {
+    // the reverb of an empty zone still renders, so its tail rings out
+    for (auto& bus : _buses) {
+        bus.reverb->render(bus.samples, bus.samples, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+    }
+}
+
+const AudioReverbBus::Bus* AudioReverbBus::busForPosition(const glm::vec3& position) const {
+    for (auto& bus : _buses) {
+        if (bus.zone.contains(position)) {
+            return &bus;
+        }
+    }
+    return nullptr;
+}
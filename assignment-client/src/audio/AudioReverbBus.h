@@ -0,0 +1,53 @@
+//
+//  AudioReverbBus.h
+//  assignment-client/src/audio
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioReverbBus_h
+#define hifi_AudioReverbBus_h
+
+#include <memory>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <AABox.h>
+#include <AudioConstants.h>
+#include <AudioReverb.h>
+
+class PositionalAudioStream;
+
+/// The reverb of the audio zones, rendered on the mixer.
+/// Every stream in a reverb zone is sent once per frame to the bus of that zone, and one reverb per zone renders it,
+/// so that the listeners in the zone all get the same wet mix and their clients can skip their local reverb.
+class AudioReverbBus {
+public:
+    struct Bus {
+        AABox zone;
+        float wetLevel; // [0, 1]
+        std::unique_ptr<AudioReverb> reverb;
+        float samples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO]; // the wet output, once finalized
+    };
+
+    // one bus per reverb zone, wetLevel is in percent as in the audio environment packet
+    void addZone(const AABox& zone, float reverbTime, float wetLevel);
+    bool hasZones() const { return !_buses.empty(); }
+
+    // the following are called from the AudioMixer assignment thread once per frame, before any mixing
+    void clear();
+    void addStream(const PositionalAudioStream& stream, float gain);
+    void finalize();
+
+    // read-only and safe to call from the mix workers, returns nullptr outside of every reverb zone
+    const Bus* busForPosition(const glm::vec3& position) const;
+
+private:
+    std::vector<Bus> _buses;
+};
+
+#endif // hifi_AudioReverbBus_h
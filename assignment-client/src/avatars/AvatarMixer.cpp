@@ -10,10 +10,11 @@
 //
 
 #include <cfloat>
-#include <random>
 #include <memory>
+#include <random>
 
 #include <QtCore/QCoreApplication>
+#include <QtCore/QDataStream>
 #include <QtCore/QDateTime>
 #include <QtCore/QJsonObject>
 #include <QtCore/QTimer>
@@ -31,19 +32,25 @@
 
 const QString AVATAR_MIXER_LOGGING_NAME = "avatar-mixer";
 
-const int AVATAR_MIXER_BROADCAST_FRAMES_PER_SECOND = 60;
 const unsigned int AVATAR_DATA_SEND_INTERVAL_MSECS = (1.0f / (float) AVATAR_MIXER_BROADCAST_FRAMES_PER_SECOND) * 1000;
 
+// the identities of our avatars are re-sent to the other shards this often, on top of whenever they change
+const quint64 SHARD_IDENTITY_RESEND_FRAMES = 5 * AVATAR_MIXER_BROADCAST_FRAMES_PER_SECOND;
+
 AvatarMixer::AvatarMixer(ReceivedMessage& message) :
     ThreadedAssignment(message),
-    _broadcastThread()
+    _broadcastThread(),
+    _workerPool(*this)
 {
     // make sure we hear about node kills so we can tell the other nodes
     connect(DependencyManager::get<NodeList>().data(), &NodeList::nodeKilled, this, &AvatarMixer::nodeKilled);
 
     auto& packetReceiver = DependencyManager::get<NodeList>()->getPacketReceiver();
-    packetReceiver.registerListener(PacketType::AvatarData, this, "handleAvatarDataPacket");
+    // avatar data only needs the lock of the sender's data, so parse it right on the thread that received it
+    packetReceiver.registerDirectHandler(PacketType::AvatarData, this, &AvatarMixer::handleAvatarDataPacket);
     packetReceiver.registerListener(PacketType::AvatarIdentity, this, "handleAvatarIdentityPacket");
+    packetReceiver.registerListener(PacketType::AvatarEntityDataRequest, this, "handleAvatarEntityDataRequestPacket");
+    packetReceiver.registerListener(PacketType::ReplicatedBulkAvatarData, this, "handleReplicatedBulkAvatarDataPacket");
     packetReceiver.registerListener(PacketType::KillAvatar, this, "handleKillAvatarPacket");
     packetReceiver.registerListener(PacketType::NodeIgnoreRequest, this, "handleNodeIgnoreRequestPacket");
 
@@ -60,14 +67,8 @@ AvatarMixer::~AvatarMixer() {
     _broadcastThread.wait();
 }
 
-// An 80% chance of sending a identity packet within a 5 second interval.
-// assuming 60 htz update rate.
-const float IDENTITY_SEND_PROBABILITY = 1.0f / 187.0f;
-
-// NOTE: some additional optimizations to consider.
-//    1) use the view frustum to cull those avatars that are out of view. Since avatar data doesn't need to be present
-//       if the avatar is not in view or in the keyhole.
 void AvatarMixer::broadcastAvatarData() {
+    quint64 broadcastStart = usecTimestampNow();
     int idleTime = AVATAR_DATA_SEND_INTERVAL_MSECS;
 
     if (_lastFrameTimestamp.time_since_epoch().count() > 0) {
@@ -131,10 +132,48 @@ void AvatarMixer::broadcastAvatarData() {
 
     auto nodeList = DependencyManager::get<NodeList>();
 
-    // setup for distributed random floating point values
-    std::random_device randomDevice;
-    std::mt19937 generator(randomDevice());
-    std::uniform_real_distribution<float> distribution;
+    // snapshot every avatar once, so that the workers never lock the data of another node
+    ++_broadcastFrame;
+    _broadcastAvatars.clear();
+    _broadcastAvatarGrid.clear();
+    auto addBroadcastAvatar = [&](const QUuid& id, AvatarMixerClientData* data, QSharedPointer<QObject> owner) {
+        if (data->updateSnapshot()) {
+            const AvatarMixerClientData::AvatarSnapshot& snapshot = data->getSnapshot();
+            _broadcastAvatarGrid.insert((int)_broadcastAvatars.size(), snapshot.globalPosition,
+                                        snapshot.identityChangeTimestamp > _lastFrameTimestamp);
+            _broadcastAvatars.push_back({ id, data, owner });
+        }
+    };
+
+    // the other avatar mixer shards of the domain, if there are any
+    std::vector<SharedNodePointer> shards;
+
+    nodeList->eachNode([&](const SharedNodePointer& otherNode) {
+        if (otherNode->getType() == NodeType::AvatarMixer) {
+            if (otherNode->getActiveSocket()) {
+                shards.push_back(otherNode);
+            }
+            return;
+        }
+
+        AvatarMixerClientData* otherNodeData = reinterpret_cast<AvatarMixerClientData*>(otherNode->getLinkedData());
+        if (otherNodeData) {
+            addBroadcastAvatar(otherNode->getUUID(), otherNodeData, otherNode);
+        }
+    });
+    _numLocalBroadcastAvatars = (int)_broadcastAvatars.size();
+
+    {
+        std::lock_guard<std::mutex> lock(_replicatedAvatarsMutex);
+        for (auto& replicatedAvatar : _replicatedAvatars) {
+            auto& data = replicatedAvatar.second.data;
+            addBroadcastAvatar(replicatedAvatar.first, data.data(), data);
+        }
+    }
+
+    if (!shards.empty()) {
+        replicateToShards(shards);
+    }
 
     nodeList->eachMatchingNode(
         [&](const SharedNodePointer& node)->bool {
@@ -150,261 +189,171 @@ void AvatarMixer::broadcastAvatarData() {
             return true;
         },
         [&](const SharedNodePointer& node) {
-            AvatarMixerClientData* nodeData = reinterpret_cast<AvatarMixerClientData*>(node->getLinkedData());
-            MutexTryLocker lock(nodeData->getMutex());
-            if (!lock.isLocked()) {
-                return;
-            }
-            ++_sumListeners;
-
-            AvatarData& avatar = nodeData->getAvatar();
-            glm::vec3 myPosition = avatar.getClientGlobalPosition();
-
-            // reset the internal state for correct random number distribution
-            distribution.reset();
-
-            // reset the max distance for this frame
-            float maxAvatarDistanceThisFrame = 0.0f;
-
-            // reset the number of sent avatars
-            nodeData->resetNumAvatarsSentLastFrame();
-
-            // keep a counter of the number of considered avatars
-            int numOtherAvatars = 0;
-
-            // keep track of outbound data rate specifically for avatar data
-            int numAvatarDataBytes = 0;
-
-            // keep track of the number of other avatars held back in this frame
-            int numAvatarsHeldBack = 0;
-
-            // keep track of the number of other avatar frames skipped
-            int numAvatarsWithSkippedFrames = 0;
-
-            // use the data rate specifically for avatar data for FRD adjustment checks
-            float avatarDataRateLastSecond = nodeData->getOutboundAvatarDataKbps();
-
-            // Check if it is time to adjust what we send this client based on the observed
-            // bandwidth to this node. We do this once a second, which is also the window for
-            // the bandwidth reported by node->getOutboundBandwidth();
-            if (nodeData->getNumFramesSinceFRDAdjustment() > AVATAR_MIXER_BROADCAST_FRAMES_PER_SECOND) {
-
-                const float FRD_ADJUSTMENT_ACCEPTABLE_RATIO = 0.8f;
-                const float HYSTERISIS_GAP = (1 - FRD_ADJUSTMENT_ACCEPTABLE_RATIO);
-                const float HYSTERISIS_MIDDLE_PERCENTAGE =  (1 - (HYSTERISIS_GAP * 0.5f));
-
-                // get the current full rate distance so we can work with it
-                float currentFullRateDistance = nodeData->getFullRateDistance();
-
-                if (avatarDataRateLastSecond > _maxKbpsPerNode) {
-
-                    // is the FRD greater than the farthest avatar?
-                    // if so, before we calculate anything, set it to that distance
-                    currentFullRateDistance = std::min(currentFullRateDistance, nodeData->getMaxAvatarDistance());
+            _workerPool.queueListener(node);
+        }
+    );
 
-                    // we're adjusting the full rate distance to target a bandwidth in the middle
-                    // of the hysterisis gap
-                    currentFullRateDistance *= (_maxKbpsPerNode * HYSTERISIS_MIDDLE_PERCENTAGE) / avatarDataRateLastSecond;
+    // this returns once every worker has prepared the packets for its listeners
+    _workerPool.broadcast();
 
-                    nodeData->setFullRateDistance(currentFullRateDistance);
-                    nodeData->resetNumFramesSinceFRDAdjustment();
-                } else if (currentFullRateDistance < nodeData->getMaxAvatarDistance()
-                           && avatarDataRateLastSecond < _maxKbpsPerNode * FRD_ADJUSTMENT_ACCEPTABLE_RATIO) {
-                    // we are constrained AND we've recovered to below the acceptable ratio
-                    // lets adjust the full rate distance to target a bandwidth in the middle of the hyterisis gap
-                    currentFullRateDistance *= (_maxKbpsPerNode * HYSTERISIS_MIDDLE_PERCENTAGE) / avatarDataRateLastSecond;
+    _workerPool.each([&](AvatarMixerWorker& worker) {
+        for (auto& listenerPackets : worker.getListenerPackets()) {
+            auto& node = listenerPackets.node;
 
-                    nodeData->setFullRateDistance(currentFullRateDistance);
-                    nodeData->resetNumFramesSinceFRDAdjustment();
-                }
-            } else {
-                nodeData->incrementNumFramesSinceFRDAdjustment();
+            for (auto& identityPacket : listenerPackets.identityPackets) {
+                nodeList->sendPacket(std::move(identityPacket), *node);
             }
 
-            // setup a PacketList for the avatarPackets
-            auto avatarPacketList = NLPacketList::create(PacketType::BulkAvatarData);
-
-            // this is an AGENT we have received head data from
-            // send back a packet with other active node data to this node
-            nodeList->eachMatchingNode(
-                [&](const SharedNodePointer& otherNode)->bool {
-                    // make sure we have data for this avatar, that it isn't the same node,
-                    // and isn't an avatar that the viewing node has ignored
-                    if (!otherNode->getLinkedData()
-                        || otherNode->getUUID() == node->getUUID()
-                        || node->isIgnoringNodeWithID(otherNode->getUUID())) {
-                        return false;
-                    } else {
-                        return true;
-                    }
-                },
-                [&](const SharedNodePointer& otherNode) {
-                    ++numOtherAvatars;
-
-                    AvatarMixerClientData* otherNodeData = reinterpret_cast<AvatarMixerClientData*>(otherNode->getLinkedData());
-                    MutexTryLocker lock(otherNodeData->getMutex());
-                    if (!lock.isLocked()) {
-                        return;
-                    }
-
-                    // make sure we send out identity packets to and from new arrivals.
-                    bool forceSend = !otherNodeData->checkAndSetHasReceivedFirstPacketsFrom(node->getUUID());
+            // send the avatar data PacketList
+            nodeList->sendPacketList(std::move(listenerPackets.avatarPacketList), *node);
+        }
 
-                    if (otherNodeData->getIdentityChangeTimestamp().time_since_epoch().count() > 0
-                        && (forceSend
-                            || otherNodeData->getIdentityChangeTimestamp() > _lastFrameTimestamp
-                            || distribution(generator) < IDENTITY_SEND_PROBABILITY)) {
+        _sumListeners += worker.sumListeners;
+        _sumIdentityPackets += worker.sumIdentityPackets;
+        worker.sumListeners = 0;
+        worker.sumIdentityPackets = 0;
 
-                        QByteArray individualData = otherNodeData->getAvatar().identityByteArray();
+        worker.clearFrame();
+    });
 
-                        auto identityPacket = NLPacket::create(PacketType::AvatarIdentity, individualData.size());
+    _broadcastAvatars.clear();
 
-                        individualData.replace(0, NUM_BYTES_RFC4122_UUID, otherNode->getUUID().toRfc4122());
+    _broadcastUsecs.record(usecTimestampNow() - broadcastStart);
+    _lastFrameTimestamp = p_high_resolution_clock::now();
+}
 
-                        identityPacket->write(individualData);
+void AvatarMixer::replicateToShards(const std::vector<SharedNodePointer>& shards) {
+    auto nodeList = DependencyManager::get<NodeList>();
 
-                        nodeList->sendPacket(std::move(identityPacket), *node);
+    // setup for distributed random floating point values
+    std::random_device randomDevice;
+    std::mt19937 generator(randomDevice());
+    std::uniform_real_distribution<float> distribution;
 
-                        ++_sumIdentityPackets;
-                    }
+    bool shouldResendIdentities = _broadcastFrame % SHARD_IDENTITY_RESEND_FRAMES == 0;
 
-                    AvatarData& otherAvatar = otherNodeData->getAvatar();
-                    //  Decide whether to send this avatar's data based on it's distance from us
+    for (auto& shard : shards) {
+        auto avatarPacketList = NLPacketList::create(PacketType::ReplicatedBulkAvatarData);
 
-                    //  The full rate distance is the distance at which EVERY update will be sent for this avatar
-                    //  at twice the full rate distance, there will be a 50% chance of sending this avatar's update
-                    glm::vec3 otherPosition = otherAvatar.getClientGlobalPosition();
-                    float distanceToAvatar = glm::length(myPosition - otherPosition);
+        // only our own agents are replicated, every shard hears from every other one directly
+        for (int i = 0; i < _numLocalBroadcastAvatars; ++i) {
+            const BroadcastAvatar& avatar = _broadcastAvatars[i];
+            const AvatarMixerClientData::AvatarSnapshot& snapshot = avatar.data->getSnapshot();
 
-                    // potentially update the max full rate distance for this frame
-                    maxAvatarDistanceThisFrame = std::max(maxAvatarDistanceThisFrame, distanceToAvatar);
+            if (shouldResendIdentities || snapshot.identityChangeTimestamp > _lastFrameTimestamp) {
+                QByteArray identityData = snapshot.identityData;
+                identityData.replace(0, NUM_BYTES_RFC4122_UUID, avatar.id.toRfc4122());
 
-                    if (distanceToAvatar != 0.0f
-                        && distribution(generator) > (nodeData->getFullRateDistance() / distanceToAvatar)) {
-                        return;
-                    }
+                auto identityPacket = NLPacket::create(PacketType::AvatarIdentity, identityData.size());
+                identityPacket->write(identityData);
+                nodeList->sendPacket(std::move(identityPacket), *shard);
+            }
 
-                    AvatarDataSequenceNumber lastSeqToReceiver = nodeData->getLastBroadcastSequenceNumber(otherNode->getUUID());
-                    AvatarDataSequenceNumber lastSeqFromSender = otherNodeData->getLastReceivedSequenceNumber();
+            // the other shard hears about every frame, so like a listener at full rate it only needs the deltas
+            const QByteArray& avatarData = distribution(generator) < AVATAR_SEND_FULL_UPDATE_RATIO ?
+                snapshot.fullData : snapshot.deltaData;
 
-                    if (lastSeqToReceiver > lastSeqFromSender && lastSeqToReceiver != UINT16_MAX) {
-                        // we got out out of order packets from the sender, track it
-                        otherNodeData->incrementNumOutOfOrderSends();
-                    }
+            avatarPacketList->startSegment();
+            avatarPacketList->write(avatar.id.toRfc4122());
+            avatarPacketList->writePrimitive(snapshot.sequenceNumber);
+            avatarPacketList->write(avatarData);
+            avatarPacketList->endSegment();
+        }
 
-                    // make sure we haven't already sent this data from this sender to this receiver
-                    // or that somehow we haven't sent
-                    if (lastSeqToReceiver == lastSeqFromSender && lastSeqToReceiver != 0) {
-                        ++numAvatarsHeldBack;
-                        return;
-                    } else if (lastSeqFromSender - lastSeqToReceiver > 1) {
-                        // this is a skip - we still send the packet but capture the presence of the skip so we see it happening
-                        ++numAvatarsWithSkippedFrames;
-                    }
+        avatarPacketList->closeCurrentPacket(true);
+        nodeList->sendPacketList(std::move(avatarPacketList), *shard);
+    }
+}
 
-                    // we're going to send this avatar
+void AvatarMixer::removeAvatarFromListeners(const QUuid& avatarID) {
+    auto nodeList = DependencyManager::get<NodeList>();
 
-                    // increment the number of avatars sent to this reciever
-                    nodeData->incrementNumAvatarsSentLastFrame();
+    // this was an avatar we were sending to other people
+    // send a kill packet for it to our other nodes
+    auto killPacket = NLPacket::create(PacketType::KillAvatar, NUM_BYTES_RFC4122_UUID);
+    killPacket->write(avatarID.toRfc4122());
 
-                    // set the last sent sequence number for this sender on the receiver
-                    nodeData->setLastBroadcastSequenceNumber(otherNode->getUUID(),
-                                                             otherNodeData->getLastReceivedSequenceNumber());
+    nodeList->broadcastToNodes(std::move(killPacket), NodeSet() << NodeType::Agent);
 
-                    // start a new segment in the PacketList for this avatar
-                    avatarPacketList->startSegment();
+    // we also want to remove sequence number data for this avatar on our other avatars
+    // so invoke the appropriate method on the AvatarMixerClientData for other avatars
+    nodeList->eachMatchingNode(
+        [&](const SharedNodePointer& node)->bool {
+            if (!node->getLinkedData()) {
+                return false;
+            }
 
-                    numAvatarDataBytes += avatarPacketList->write(otherNode->getUUID().toRfc4122());
-                    numAvatarDataBytes +=
-                        avatarPacketList->write(otherAvatar.toByteArray(false, distribution(generator) < AVATAR_SEND_FULL_UPDATE_RATIO));
+            if (node->getUUID() == avatarID) {
+                return false;
+            }
 
-                    avatarPacketList->endSegment();
-            });
+            return true;
+        },
+        [&](const SharedNodePointer& node) {
+            QMetaObject::invokeMethod(node->getLinkedData(),
+                                      "removeLastBroadcastSequenceNumber",
+                                      Qt::AutoConnection,
+                                      Q_ARG(const QUuid&, avatarID));
+        }
+    );
+}
 
-            // close the current packet so that we're always sending something
-            avatarPacketList->closeCurrentPacket(true);
+AvatarMixerClientData* AvatarMixer::replicatedAvatarData(const QUuid& avatarID, const QUuid& shardID) {
+    std::lock_guard<std::mutex> lock(_replicatedAvatarsMutex);
 
-            // send the avatar data PacketList
-            nodeList->sendPacketList(std::move(avatarPacketList), *node);
+    auto it = _replicatedAvatars.find(avatarID);
+    if (it == _replicatedAvatars.end()) {
+        QSharedPointer<AvatarMixerClientData> data { new AvatarMixerClientData };
+        data->getAvatar().setDomainMinimumScale(_domainMinimumScale);
+        data->getAvatar().setDomainMaximumScale(_domainMaximumScale);
 
-            // record the bytes sent for other avatar data in the AvatarMixerClientData
-            nodeData->recordSentAvatarData(numAvatarDataBytes);
+        it = _replicatedAvatars.insert({ avatarID, { shardID, data } }).first;
+    }
 
-            // record the number of avatars held back this frame
-            nodeData->recordNumOtherAvatarStarves(numAvatarsHeldBack);
-            nodeData->recordNumOtherAvatarSkips(numAvatarsWithSkippedFrames);
+    // an avatar belongs to the shard we last heard about it from
+    it->second.shardID = shardID;
+    return it->second.data.data();
+}
 
-            if (numOtherAvatars == 0) {
-                // update the full rate distance to FLOAT_MAX since we didn't have any other avatars to send
-                nodeData->setMaxAvatarDistance(FLT_MAX);
-            } else {
-                nodeData->setMaxAvatarDistance(maxAvatarDistanceThisFrame);
-            }
+void AvatarMixer::removeReplicatedAvatar(const QUuid& avatarID) {
+    {
+        std::lock_guard<std::mutex> lock(_replicatedAvatarsMutex);
+        if (_replicatedAvatars.erase(avatarID) == 0) {
+            return;
         }
-    );
-
-    // We're done encoding this version of the otherAvatars.  Update their "lastSent" joint-states so
-    // that we can notice differences, next time around.
-    nodeList->eachMatchingNode(
-        [&](const SharedNodePointer& otherNode)->bool {
-            if (!otherNode->getLinkedData()) {
-                return false;
-            }
-            if (otherNode->getType() != NodeType::Agent) {
-                return false;
-            }
-            if (!otherNode->getActiveSocket()) {
-                return false;
-            }
-            return true;
-        },
-        [&](const SharedNodePointer& otherNode) {
-            AvatarMixerClientData* otherNodeData = reinterpret_cast<AvatarMixerClientData*>(otherNode->getLinkedData());
-            MutexTryLocker lock(otherNodeData->getMutex());
-            if (!lock.isLocked()) {
-                return;
-            }
-            AvatarData& otherAvatar = otherNodeData->getAvatar();
-            otherAvatar.doneEncoding(false);
-        });
+    }
 
-    _lastFrameTimestamp = p_high_resolution_clock::now();
+    removeAvatarFromListeners(avatarID);
 }
 
 void AvatarMixer::nodeKilled(SharedNodePointer killedNode) {
     if (killedNode->getType() == NodeType::Agent
         && killedNode->getLinkedData()) {
-        auto nodeList = DependencyManager::get<NodeList>();
+        removeAvatarFromListeners(killedNode->getUUID());
 
-        // this was an avatar we were sending to other people
-        // send a kill packet for it to our other nodes
+        // the other shards replicate this avatar, they need to drop it too
         auto killPacket = NLPacket::create(PacketType::KillAvatar, NUM_BYTES_RFC4122_UUID);
         killPacket->write(killedNode->getUUID().toRfc4122());
-
-        nodeList->broadcastToNodes(std::move(killPacket), NodeSet() << NodeType::Agent);
-
-        // we also want to remove sequence number data for this avatar on our other avatars
-        // so invoke the appropriate method on the AvatarMixerClientData for other avatars
-        nodeList->eachMatchingNode(
-            [&](const SharedNodePointer& node)->bool {
-                if (!node->getLinkedData()) {
-                    return false;
-                }
-
-                if (node->getUUID() == killedNode->getUUID()) {
-                    return false;
+        DependencyManager::get<NodeList>()->broadcastToNodes(std::move(killPacket), NodeSet() << NodeType::AvatarMixer);
+    } else if (killedNode->getType() == NodeType::AvatarMixer) {
+        // the avatars replicated from a shard that went away go with it
+        std::vector<QUuid> orphanedAvatars;
+        {
+            std::lock_guard<std::mutex> lock(_replicatedAvatarsMutex);
+            for (auto& replicatedAvatar : _replicatedAvatars) {
+                if (replicatedAvatar.second.shardID == killedNode->getUUID()) {
+                    orphanedAvatars.push_back(replicatedAvatar.first);
                 }
-
-                return true;
-            },
-            [&](const SharedNodePointer& node) {
-                QMetaObject::invokeMethod(node->getLinkedData(),
-                                          "removeLastBroadcastSequenceNumber",
-                                          Qt::AutoConnection,
-                                          Q_ARG(const QUuid&, QUuid(killedNode->getUUID())));
             }
-        );
+        }
+
+        for (auto& avatarID : orphanedAvatars) {
+            removeReplicatedAvatar(avatarID);
+        }
     }
+
+    // send the kill packets for this node now, instead of on the next flush
+    DependencyManager::get<NodeList>()->flushCoalescedPackets();
 }
 
 void AvatarMixer::handleAvatarDataPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
@@ -412,8 +361,38 @@ void AvatarMixer::handleAvatarDataPacket(QSharedPointer<ReceivedMessage> message
     nodeList->updateNodeWithDataFromPacket(message, senderNode);
 }
 
+void AvatarMixer::handleReplicatedBulkAvatarDataPacket(QSharedPointer<ReceivedMessage> message,
+                                                       SharedNodePointer senderNode) {
+    while (message->getBytesLeftToRead()) {
+        QUuid avatarID = QUuid::fromRfc4122(message->readWithoutCopy(NUM_BYTES_RFC4122_UUID));
+
+        AvatarDataSequenceNumber sequenceNumber;
+        message->readPrimitive(&sequenceNumber);
+
+        int positionBeforeRead = message->getPosition();
+        QByteArray byteArray = message->readWithoutCopy(message->getBytesLeftToRead());
+
+        AvatarMixerClientData* avatarData = replicatedAvatarData(avatarID, senderNode->getUUID());
+        int bytesRead = avatarData->parseReplicatedData(sequenceNumber, byteArray);
+        message->seek(positionBeforeRead + bytesRead);
+    }
+}
+
 void AvatarMixer::handleAvatarIdentityPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
     auto nodeList = DependencyManager::get<NodeList>();
+
+    if (senderNode->getType() == NodeType::AvatarMixer) {
+        // the identity of an avatar replicated from another shard, which is carried in the packet
+        AvatarData::Identity identity;
+        AvatarData::parseAvatarIdentityPacket(message->getMessage(), identity);
+
+        AvatarMixerClientData* nodeData = replicatedAvatarData(identity.uuid, senderNode->getUUID());
+        if (nodeData->getAvatar().processAvatarIdentity(identity)) {
+            QMutexLocker nodeDataLocker(&nodeData->getMutex());
+            nodeData->flagIdentityChange();
+        }
+        return;
+    }
     nodeList->getOrCreateLinkedData(senderNode);
 
     if (senderNode->getLinkedData()) {
@@ -432,8 +411,52 @@ void AvatarMixer::handleAvatarIdentityPacket(QSharedPointer<ReceivedMessage> mes
     }
 }
 
-void AvatarMixer::handleKillAvatarPacket(QSharedPointer<ReceivedMessage> message) {
-    DependencyManager::get<NodeList>()->processKillNode(*message);
+void AvatarMixer::handleAvatarEntityDataRequestPacket(QSharedPointer<ReceivedMessage> message,
+                                                      SharedNodePointer senderNode) {
+    QUuid avatarID = QUuid::fromRfc4122(message->readWithoutCopy(NUM_BYTES_RFC4122_UUID));
+    if (senderNode->isIgnoringNodeWithID(avatarID)) {
+        return;
+    }
+
+    QVector<QUuid> entityIDs;
+    while (message->getBytesLeftToRead() >= NUM_BYTES_RFC4122_UUID) {
+        entityIDs.push_back(QUuid::fromRfc4122(message->readWithoutCopy(NUM_BYTES_RFC4122_UUID)));
+    }
+
+    // the avatar is either one of our agents or one replicated from another shard
+    auto nodeList = DependencyManager::get<NodeList>();
+    AvatarEntityMap avatarEntityData;
+    SharedNodePointer avatarNode = nodeList->nodeWithUUID(avatarID);
+    AvatarMixerClientData* avatarNodeData = avatarNode ?
+        dynamic_cast<AvatarMixerClientData*>(avatarNode->getLinkedData()) : nullptr;
+    if (avatarNodeData) {
+        avatarEntityData = avatarNodeData->getAvatar().copyAvatarEntityData(entityIDs);
+    } else {
+        std::lock_guard<std::mutex> lock(_replicatedAvatarsMutex);
+        auto it = _replicatedAvatars.find(avatarID);
+        if (it == _replicatedAvatars.end()) {
+            return;
+        }
+        avatarEntityData = it->second.data->getAvatar().copyAvatarEntityData(entityIDs);
+    }
+
+    // the entities that went away since the listener's identity are left out, its next identity drops them
+    QByteArray entityData;
+    QDataStream entityDataStream(&entityData, QIODevice::WriteOnly);
+    entityDataStream << avatarEntityData;
+
+    auto packetList = NLPacketList::create(PacketType::AvatarEntityData, QByteArray(), true, true);
+    packetList->write(avatarID.toRfc4122());
+    packetList->write(entityData);
+    nodeList->sendPacketList(std::move(packetList), *senderNode);
+}
+
+void AvatarMixer::handleKillAvatarPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
+    if (senderNode && senderNode->getType() == NodeType::AvatarMixer) {
+        removeReplicatedAvatar(QUuid::fromRfc4122(message->readWithoutCopy(NUM_BYTES_RFC4122_UUID)));
+    } else {
+        DependencyManager::get<NodeList>()->processKillNode(*message);
+    }
 }
 
 void AvatarMixer::handleNodeIgnoreRequestPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
@@ -448,6 +471,11 @@ void AvatarMixer::sendStatsPacket() {
 
     statsObject["trailing_sleep_percentage"] = _trailingSleepRatio * 100;
     statsObject["performance_throttling_ratio"] = _performanceThrottlingRatio;
+    statsObject["broadcast_threads"] = _workerPool.numThreads();
+
+    QJsonObject metrics;
+    metrics["broadcast_usecs"] = _broadcastUsecs.takeSnapshot().toJson();
+    statsObject[STATS_METRICS_KEY] = metrics;
 
     QJsonObject avatarsObject;
 
@@ -511,10 +539,16 @@ void AvatarMixer::run() {
 void AvatarMixer::domainSettingsRequestComplete() {
     auto nodeList = DependencyManager::get<NodeList>();
     nodeList->addNodeTypeToInterestSet(NodeType::Agent);
+
+    // the domain can run several avatar mixer shards, which replicate their avatars to each other
+    nodeList->addNodeTypeToInterestSet(NodeType::AvatarMixer);
     
     // parse the settings to pull out the values we need
     parseDomainServerSettings(nodeList->getDomainHandler().getSettingsObject());
 
+    // a shard that goes away kills all of its avatars at once, pack those per listener
+    nodeList->setCoalescedPacketTypes({ PacketType::KillAvatar });
+
     float domainMinimumScale = _domainMinimumScale;
     float domainMaximumScale = _domainMaximumScale;
 
@@ -557,6 +591,17 @@ void AvatarMixer::parseDomainServerSettings(const QJsonObject& domainSettings) {
     _maxKbpsPerNode = nodeBandwidthValue.toDouble(DEFAULT_NODE_SEND_BANDWIDTH) * KILO_PER_MEGA;
     qDebug() << "The maximum send bandwidth per node is" << _maxKbpsPerNode << "kbps.";
 
+    const QString BROADCAST_THREADS_KEY = "broadcast_threads";
+    QJsonValue broadcastThreadsValue = domainSettings[AVATAR_MIXER_SETTINGS_KEY].toObject()[BROADCAST_THREADS_KEY];
+    if (broadcastThreadsValue.isString()) {
+        bool ok = false;
+        int numThreads = broadcastThreadsValue.toString().toInt(&ok);
+        if (ok) {
+            _workerPool.setNumThreads(numThreads);
+        }
+    }
+    qDebug() << "Broadcasting avatar data with" << _workerPool.numThreads() << "threads";
+
     const QString AVATARS_SETTINGS_KEY = "avatars";
 
     static const QString MIN_SCALE_OPTION = "min_avatar_scale";
@@ -15,16 +15,44 @@
 #ifndef hifi_AvatarMixer_h
 #define hifi_AvatarMixer_h
 
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <Histogram.h>
 #include <PortableHighResolutionClock.h>
+#include <UUIDHasher.h>
 
 #include <ThreadedAssignment.h>
 
+#include "AvatarMixerWorkerPool.h"
+#include "AvatarSpatialGrid.h"
+
+const int AVATAR_MIXER_BROADCAST_FRAMES_PER_SECOND = 60;
+
+class AvatarMixerClientData;
+
 /// Handles assignments of type AvatarMixer - distribution of avatar data to various clients
 class AvatarMixer : public ThreadedAssignment {
     Q_OBJECT
 public:
+    /// an avatar with a snapshot for the current frame, either one of our agents or one replicated from another shard
+    struct BroadcastAvatar {
+        QUuid id;
+        AvatarMixerClientData* data;
+        QSharedPointer<QObject> owner; // keeps the data alive until the end of the frame
+    };
+
     AvatarMixer(ReceivedMessage& message);
     ~AvatarMixer();
+
+    // the following are read by the broadcast workers while a frame is being prepared
+    float getMaxKbpsPerNode() const { return _maxKbpsPerNode; }
+    p_high_resolution_clock::time_point getLastFrameTimestamp() const { return _lastFrameTimestamp; }
+    const std::vector<BroadcastAvatar>& getBroadcastAvatars() const { return _broadcastAvatars; }
+    const AvatarSpatialGrid& getBroadcastAvatarGrid() const { return _broadcastAvatarGrid; }
+    quint64 getBroadcastFrame() const { return _broadcastFrame; }
+
 public slots:
     /// runs the avatar mixer
     void run() override;
@@ -36,7 +64,9 @@ public slots:
 private slots:
     void handleAvatarDataPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
     void handleAvatarIdentityPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
-    void handleKillAvatarPacket(QSharedPointer<ReceivedMessage> message);
+    void handleAvatarEntityDataRequestPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
+    void handleReplicatedBulkAvatarDataPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
+    void handleKillAvatarPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
     void handleNodeIgnoreRequestPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
     void domainSettingsRequestComplete();
     void handlePacketVersionMismatch(PacketType type, const HifiSockAddr& senderSockAddr, const QUuid& senderUUID);
@@ -44,8 +74,13 @@ private slots:
 
 private:
     void broadcastAvatarData();
+    void replicateToShards(const std::vector<SharedNodePointer>& shards);
     void parseDomainServerSettings(const QJsonObject& domainSettings);
 
+    AvatarMixerClientData* replicatedAvatarData(const QUuid& avatarID, const QUuid& shardID);
+    void removeReplicatedAvatar(const QUuid& avatarID);
+    void removeAvatarFromListeners(const QUuid& avatarID);
+
     QThread _broadcastThread;
 
     p_high_resolution_clock::time_point _lastFrameTimestamp;
@@ -57,12 +92,29 @@ private:
     int _numStatFrames { 0 };
     int _sumIdentityPackets { 0 };
 
+    Histogram _broadcastUsecs; // of the frames, from the snapshot of the avatars to the packets sent
+
     float _maxKbpsPerNode = 0.0f;
 
     float _domainMinimumScale { MIN_AVATAR_SCALE };
     float _domainMaximumScale { MAX_AVATAR_SCALE };
 
     QTimer* _broadcastTimer = nullptr;
+
+    // the avatars with a snapshot for the current frame
+    std::vector<BroadcastAvatar> _broadcastAvatars;
+    AvatarSpatialGrid _broadcastAvatarGrid; // indexes into _broadcastAvatars
+    int _numLocalBroadcastAvatars { 0 }; // our own agents come first in _broadcastAvatars
+
+    // the avatars of the agents connected to the other avatar mixer shards of the domain, by avatar ID
+    struct ReplicatedAvatar {
+        QUuid shardID;
+        QSharedPointer<AvatarMixerClientData> data;
+    };
+    std::mutex _replicatedAvatarsMutex;
+    std::unordered_map<QUuid, ReplicatedAvatar> _replicatedAvatars;
+    quint64 _broadcastFrame { 0 };
+    AvatarMixerWorkerPool _workerPool;
 };
 
 #endif // hifi_AvatarMixer_h
@@ -9,7 +9,9 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <HeadData.h>
 #include <udt/PacketHeaders.h>
+#include <TryLocker.h>
 
 #include "AvatarMixerClientData.h"
 
@@ -21,6 +23,46 @@ int AvatarMixerClientData::parseData(ReceivedMessage& message) {
     return _avatar->parseDataFromBuffer(message.readWithoutCopy(message.getBytesLeftToRead()));
 }
 
+int AvatarMixerClientData::parseReplicatedData(AvatarDataSequenceNumber sequenceNumber, const QByteArray& buffer) {
+    QMutexLocker lock(&getMutex());
+    _lastReceivedSequenceNumber = sequenceNumber;
+    return _avatar->parseDataFromBuffer(buffer);
+}
+
+bool AvatarMixerClientData::updateSnapshot() {
+    MutexTryLocker lock(getMutex());
+    if (!lock.isLocked()) {
+        // keep the last snapshot, its sequence number stops it from being sent twice
+        return _snapshot.isValid;
+    }
+
+    _snapshot.globalPosition = _avatar->getClientGlobalPosition();
+    _snapshot.sequenceNumber = _lastReceivedSequenceNumber;
+
+    if (!_snapshot.isValid || _snapshot.identityChangeTimestamp != _identityChangeTimestamp) {
+        _snapshot.identityChangeTimestamp = _identityChangeTimestamp;
+        _snapshot.identityData = _avatar->identityByteArray();
+        _snapshot.listenerIdentityData = _avatar->identityByteArray(true);
+    }
+
+    // encode once for every listener, then update the "lastSent" joint-states so that we can notice differences next time
+    _snapshot.minimalData = _avatar->toMinimalByteArray();
+    _snapshot.deltaData = _avatar->toByteArray(false, false);
+    _snapshot.fullData = _avatar->toByteArray(false, true);
+    _avatar->doneEncoding(false);
+
+    // the avatar looks from its position towards its look at position, or straight ahead when it has none
+    glm::vec3 lookAtOffset = _avatar->getHeadData()->getLookAtPosition() - _snapshot.globalPosition;
+    if (glm::dot(lookAtOffset, lookAtOffset) > EPSILON) {
+        _snapshot.viewDirection = glm::normalize(lookAtOffset);
+    } else {
+        _snapshot.viewDirection = _avatar->getOrientation() * IDENTITY_FRONT;
+    }
+
+    _snapshot.isValid = true;
+    return true;
+}
+
 bool AvatarMixerClientData::checkAndSetHasReceivedFirstPacketsFrom(const QUuid& uuid) {
     if (_hasReceivedFirstPacketsFrom.find(uuid) == _hasReceivedFirstPacketsFrom.end()) {
         _hasReceivedFirstPacketsFrom.insert(uuid);
@@ -39,6 +81,11 @@ uint16_t AvatarMixerClientData::getLastBroadcastSequenceNumber(const QUuid& node
     }
 }
 
+quint64 AvatarMixerClientData::getLastBroadcastFrame(const QUuid& nodeUUID) const {
+    auto nodeMatch = _lastBroadcastFrames.find(nodeUUID);
+    return nodeMatch != _lastBroadcastFrames.end() ? nodeMatch->second : 0;
+}
+
 void AvatarMixerClientData::loadJSONStats(QJsonObject& jsonObject) const {
     jsonObject["display_name"] = _avatar->getDisplayName();
     jsonObject["full_rate_distance"] = _fullRateDistance;
@@ -46,7 +93,7 @@ void AvatarMixerClientData::loadJSONStats(QJsonObject& jsonObject) const {
     jsonObject["num_avs_sent_last_frame"] = _numAvatarsSentLastFrame;
     jsonObject["avg_other_av_starves_per_second"] = getAvgNumOtherAvatarStarvesPerSecond();
     jsonObject["avg_other_av_skips_per_second"] = getAvgNumOtherAvatarSkipsPerSecond();
-    jsonObject["total_num_out_of_order_sends"] = _numOutOfOrderSends;
+    jsonObject["total_num_out_of_order_sends"] = _numOutOfOrderSends.load();
 
     jsonObject[OUTBOUND_AVATAR_DATA_STATS_KEY] = getOutboundAvatarDataKbps();
     jsonObject[INBOUND_AVATAR_DATA_STATS_KEY] = _avatar->getAverageBytesReceivedPerSecond() / (float) BYTES_PER_KILOBIT;
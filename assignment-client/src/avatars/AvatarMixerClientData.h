@@ -13,6 +13,7 @@
 #define hifi_AvatarMixerClientData_h
 
 #include <algorithm>
+#include <atomic>
 #include <cfloat>
 #include <unordered_map>
 #include <unordered_set>
@@ -21,6 +22,7 @@
 #include <QtCore/QUrl>
 
 #include <AvatarData.h>
+#include <GLMHelpers.h>
 #include <NodeData.h>
 #include <NumericalConstants.h>
 #include <udt/PacketHeaders.h>
@@ -36,15 +38,45 @@ class AvatarMixerClientData : public NodeData {
 public:
     using HRCTime = p_high_resolution_clock::time_point;
 
+    // the avatar as of the latest parse the broadcast thread saw, the broadcast workers read it without locking
+    struct AvatarSnapshot {
+        bool isValid { false };
+        glm::vec3 globalPosition;
+        glm::vec3 viewDirection { IDENTITY_FRONT };
+        AvatarDataSequenceNumber sequenceNumber { 0 };
+        HRCTime identityChangeTimestamp;
+        QByteArray identityData;
+        QByteArray listenerIdentityData; // with the versions of the avatar entities, which listeners fetch on demand
+
+        // the avatar data encoded once per frame at each level of detail, listeners pick one of them
+        QByteArray minimalData;     // transform only, every joint flagged as unchanged
+        QByteArray deltaData;       // the joints that changed since the last frame
+        QByteArray fullData;        // every joint
+    };
+
     int parseData(ReceivedMessage& message) override;
+
+    // parses the data of an avatar replicated from another avatar mixer shard, returns the number of bytes read
+    int parseReplicatedData(AvatarDataSequenceNumber sequenceNumber, const QByteArray& buffer);
     AvatarData& getAvatar() { return *_avatar; }
 
+    // called from the broadcast thread before the workers run, returns false if there was never a snapshot
+    bool updateSnapshot();
+    const AvatarSnapshot& getSnapshot() const { return _snapshot; }
+
     bool checkAndSetHasReceivedFirstPacketsFrom(const QUuid& uuid);
 
     uint16_t getLastBroadcastSequenceNumber(const QUuid& nodeUUID) const;
     void setLastBroadcastSequenceNumber(const QUuid& nodeUUID, uint16_t sequenceNumber)
         { _lastBroadcastSequenceNumbers[nodeUUID] = sequenceNumber; }
-    Q_INVOKABLE void removeLastBroadcastSequenceNumber(const QUuid& nodeUUID) { _lastBroadcastSequenceNumbers.erase(nodeUUID); }
+    Q_INVOKABLE void removeLastBroadcastSequenceNumber(const QUuid& nodeUUID) {
+        _lastBroadcastSequenceNumbers.erase(nodeUUID);
+        _lastBroadcastFrames.erase(nodeUUID);
+    }
+
+    // the broadcast frame the data of a node was last sent to us in, 0 if it never was
+    quint64 getLastBroadcastFrame(const QUuid& nodeUUID) const;
+    void setLastBroadcastFrame(const QUuid& nodeUUID, quint64 frame) { _lastBroadcastFrames[nodeUUID] = frame; }
 
     uint16_t getLastReceivedSequenceNumber() const { return _lastReceivedSequenceNumber; }
 
@@ -84,10 +116,13 @@ private:
 
     uint16_t _lastReceivedSequenceNumber { 0 };
     std::unordered_map<QUuid, uint16_t> _lastBroadcastSequenceNumbers;
+    std::unordered_map<QUuid, quint64> _lastBroadcastFrames;
     std::unordered_set<QUuid> _hasReceivedFirstPacketsFrom;
 
     HRCTime _identityChangeTimestamp;
 
+    AvatarSnapshot _snapshot;
+
     float _fullRateDistance = FLT_MAX;
     float _maxAvatarDistance = FLT_MAX;
 
@@ -96,7 +131,7 @@ private:
 
     SimpleMovingAverage _otherAvatarStarves;
     SimpleMovingAverage _otherAvatarSkips;
-    int _numOutOfOrderSends = 0;
+    std::atomic<int> _numOutOfOrderSends { 0 };
 
     SimpleMovingAverage _avgOtherAvatarDataRate;
 };
@@ -0,0 +1,304 @@
+//
+//  AvatarMixerWorker.cpp
+//  assignment-client/src/avatars
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <algorithm>
+#include <cfloat>
+
+#include <glm/glm.hpp>
+
+#include <TryLocker.h>
+#include <UUID.h>
+#include <ViewFrustum.h>
+
+#include "AvatarMixer.h"
+#include "AvatarMixerClientData.h"
+
+#include "AvatarMixerWorker.h"
+
+// An 80% chance of sending a identity packet within a 5 second interval.
+// assuming 60 htz update rate.
+const float IDENTITY_SEND_PROBABILITY = 1.0f / 187.0f;
+
+// avatars further than this many full rate distances are sent without joints, see broadcastToListener
+const float MINIMAL_DATA_FULL_RATE_DISTANCE_RATIO = 2.0f;
+
+// the view of a listener is a cone around the direction it looks in, wider than the default field of view
+// so that it still covers HMDs and quick head turns
+const float VIEW_CONE_COS_HALF_ANGLE = 0.5f; // 60 degrees
+
+// avatars this close are always treated as in view, like the keyhole of a ViewFrustum
+const float VIEW_KEYHOLE_RADIUS = DEFAULT_CENTER_SPHERE_RADIUS;
+
+// the share of frames an avatar out of the listener's view is sent in
+const float OUT_OF_VIEW_BROADCAST_RATE = 0.25f;
+
+// an avatar with new data goes out at least this often, whatever its priority
+const quint64 MAX_FRAMES_BETWEEN_BROADCASTS = AVATAR_MIXER_BROADCAST_FRAMES_PER_SECOND;
+
+// the share of frames, between 0 and 1, the data of an avatar should be sent to a listener in
+static float broadcastRate(const AvatarMixerClientData::AvatarSnapshot& listener, float fullRateDistance,
+                           const glm::vec3& otherPosition, float distanceToAvatar) {
+    //  The full rate distance is the distance at which EVERY update will be sent for this avatar
+    //  at twice the full rate distance, this avatar's update will be sent every other frame
+    float rate = distanceToAvatar > fullRateDistance ? fullRateDistance / distanceToAvatar : 1.0f;
+
+    if (distanceToAvatar > VIEW_KEYHOLE_RADIUS) {
+        float cosAngle = glm::dot(listener.viewDirection, (otherPosition - listener.globalPosition) / distanceToAvatar);
+        if (cosAngle < VIEW_CONE_COS_HALF_ANGLE) {
+            rate *= OUT_OF_VIEW_BROADCAST_RATE;
+        }
+    }
+
+    return rate;
+}
+
+AvatarMixerWorker::AvatarMixerWorker(const AvatarMixer& mixer) : _mixer(mixer) {
+    std::random_device randomDevice;
+    _generator.seed(randomDevice());
+}
+
+void AvatarMixerWorker::clearFrame() {
+    _listeners.clear();
+    _listenerPackets.clear();
+}
+
+void AvatarMixerWorker::broadcastToQueuedListeners() {
+    for (auto& node : _listeners) {
+        broadcastToListener(node);
+    }
+}
+
+void AvatarMixerWorker::broadcastToListener(const SharedNodePointer& node) {
+    AvatarMixerClientData* nodeData = reinterpret_cast<AvatarMixerClientData*>(node->getLinkedData());
+    MutexTryLocker lock(nodeData->getMutex());
+    if (!lock.isLocked()) {
+        return;
+    }
+    ++sumListeners;
+
+    glm::vec3 myPosition = nodeData->getSnapshot().globalPosition;
+    float maxKbpsPerNode = _mixer.getMaxKbpsPerNode();
+    quint64 broadcastFrame = _mixer.getBroadcastFrame();
+
+    // reset the internal state for correct random number distribution
+    _distribution.reset();
+
+    // reset the max distance for this frame
+    float maxAvatarDistanceThisFrame = 0.0f;
+
+    // reset the number of sent avatars
+    nodeData->resetNumAvatarsSentLastFrame();
+
+    // keep a counter of the number of considered avatars
+    int numOtherAvatars = 0;
+
+    // keep track of outbound data rate specifically for avatar data
+    int numAvatarDataBytes = 0;
+
+    // keep track of the number of other avatars held back in this frame
+    int numAvatarsHeldBack = 0;
+
+    // keep track of the number of other avatar frames skipped
+    int numAvatarsWithSkippedFrames = 0;
+
+    // use the data rate specifically for avatar data for FRD adjustment checks
+    float avatarDataRateLastSecond = nodeData->getOutboundAvatarDataKbps();
+
+    // Check if it is time to adjust what we send this client based on the observed
+    // bandwidth to this node. We do this once a second, which is also the window for
+    // the bandwidth reported by node->getOutboundBandwidth();
+    if (nodeData->getNumFramesSinceFRDAdjustment() > AVATAR_MIXER_BROADCAST_FRAMES_PER_SECOND) {
+
+        const float FRD_ADJUSTMENT_ACCEPTABLE_RATIO = 0.8f;
+        const float HYSTERISIS_GAP = (1 - FRD_ADJUSTMENT_ACCEPTABLE_RATIO);
+        const float HYSTERISIS_MIDDLE_PERCENTAGE =  (1 - (HYSTERISIS_GAP * 0.5f));
+
+        // get the current full rate distance so we can work with it
+        float currentFullRateDistance = nodeData->getFullRateDistance();
+
+        if (avatarDataRateLastSecond > maxKbpsPerNode) {
+
+            // is the FRD greater than the farthest avatar?
+            // if so, before we calculate anything, set it to that distance
+            currentFullRateDistance = std::min(currentFullRateDistance, nodeData->getMaxAvatarDistance());
+
+            // we're adjusting the full rate distance to target a bandwidth in the middle
+            // of the hysterisis gap
+            currentFullRateDistance *= (maxKbpsPerNode * HYSTERISIS_MIDDLE_PERCENTAGE) / avatarDataRateLastSecond;
+
+            nodeData->setFullRateDistance(currentFullRateDistance);
+            nodeData->resetNumFramesSinceFRDAdjustment();
+        } else if (currentFullRateDistance < nodeData->getMaxAvatarDistance()
+                   && avatarDataRateLastSecond < maxKbpsPerNode * FRD_ADJUSTMENT_ACCEPTABLE_RATIO) {
+            // we are constrained AND we've recovered to below the acceptable ratio
+            // lets adjust the full rate distance to target a bandwidth in the middle of the hyterisis gap
+            currentFullRateDistance *= (maxKbpsPerNode * HYSTERISIS_MIDDLE_PERCENTAGE) / avatarDataRateLastSecond;
+
+            nodeData->setFullRateDistance(currentFullRateDistance);
+            nodeData->resetNumFramesSinceFRDAdjustment();
+        }
+    } else {
+        nodeData->incrementNumFramesSinceFRDAdjustment();
+    }
+
+    ListenerPackets listenerPackets;
+    listenerPackets.node = node;
+
+    // setup a PacketList for the avatarPackets
+    listenerPackets.avatarPacketList = NLPacketList::create(PacketType::BulkAvatarData);
+    auto& avatarPacketList = listenerPackets.avatarPacketList;
+
+    const std::vector<AvatarMixer::BroadcastAvatar>& broadcastAvatars = _mixer.getBroadcastAvatars();
+    const AvatarSpatialGrid& avatarGrid = _mixer.getBroadcastAvatarGrid();
+    float fullRateDistance = nodeData->getFullRateDistance();
+
+    // this is an AGENT we have received head data from
+    // send back a packet with other active node data to this node
+    const std::vector<AvatarSpatialGrid::Cell>& cells = avatarGrid.getCells();
+    for (int cellIndex = 0; cellIndex < (int)cells.size(); ++cellIndex) {
+        const AvatarSpatialGrid::Cell& cell = cells[cellIndex];
+        if (cell.avatars.empty()) {
+            continue;
+        }
+
+        // a cell past the full rate distance holds no avatar with a rate above fullRateDistance / cellDistance,
+        // so it only needs to be looked at that often, in a frame staggered by its index.
+        // Its identity changes are still sent as soon as they happen.
+        int framesPerCellVisit = 1;
+        float cellDistance = avatarGrid.getMinimumDistance(cell, myPosition);
+        if (cellDistance > fullRateDistance) {
+            framesPerCellVisit = (int)std::min(cellDistance / fullRateDistance, (float)MAX_FRAMES_BETWEEN_BROADCASTS);
+        }
+        if (framesPerCellVisit > 1 && !cell.hasIdentityChange
+            && (broadcastFrame + cellIndex) % framesPerCellVisit != 0) {
+            // still account for the avatars of the cell, with their furthest possible distance
+            numOtherAvatars += (int)cell.avatars.size();
+            maxAvatarDistanceThisFrame = std::max(maxAvatarDistanceThisFrame,
+                                                  avatarGrid.getMaximumDistance(cell, myPosition));
+            continue;
+        }
+
+        for (int avatarIndex : cell.avatars) {
+            const AvatarMixer::BroadcastAvatar& otherAvatarEntry = broadcastAvatars[avatarIndex];
+            const QUuid& otherID = otherAvatarEntry.id;
+
+            // make sure it isn't the same node, and isn't an avatar that the viewing node has ignored
+            if (otherID == node->getUUID() || node->isIgnoringNodeWithID(otherID)) {
+                continue;
+            }
+
+            ++numOtherAvatars;
+
+            AvatarMixerClientData* otherNodeData = otherAvatarEntry.data;
+            const AvatarMixerClientData::AvatarSnapshot& otherAvatar = otherNodeData->getSnapshot();
+
+            // make sure we send out identity packets to and from new arrivals.
+            bool forceSend = !nodeData->checkAndSetHasReceivedFirstPacketsFrom(otherID);
+
+            if (otherAvatar.identityChangeTimestamp.time_since_epoch().count() > 0
+                && (forceSend
+                    || otherAvatar.identityChangeTimestamp > _mixer.getLastFrameTimestamp()
+                    || _distribution(_generator) < IDENTITY_SEND_PROBABILITY * framesPerCellVisit)) {
+
+                QByteArray individualData = otherAvatar.listenerIdentityData;
+
+                auto identityPacket = NLPacket::create(PacketType::AvatarIdentity, individualData.size());
+
+                individualData.replace(0, NUM_BYTES_RFC4122_UUID, otherID.toRfc4122());
+
+                identityPacket->write(individualData);
+
+                listenerPackets.identityPackets.push_back(std::move(identityPacket));
+
+                ++sumIdentityPackets;
+            }
+
+            //  Decide whether to send this avatar's data based on its priority for us: its rate, from how far it is
+            //  and whether we are looking at it, times the number of frames since we last sent it
+            float distanceToAvatar = glm::length(myPosition - otherAvatar.globalPosition);
+
+            // potentially update the max full rate distance for this frame
+            maxAvatarDistanceThisFrame = std::max(maxAvatarDistanceThisFrame, distanceToAvatar);
+
+            quint64 lastBroadcastFrame = nodeData->getLastBroadcastFrame(otherID);
+            if (lastBroadcastFrame != 0 && distanceToAvatar != 0.0f) {
+                quint64 framesSinceBroadcast = broadcastFrame - lastBroadcastFrame;
+                float rate = broadcastRate(nodeData->getSnapshot(), fullRateDistance,
+                                           otherAvatar.globalPosition, distanceToAvatar);
+                if (rate * framesSinceBroadcast < 1.0f && framesSinceBroadcast < MAX_FRAMES_BETWEEN_BROADCASTS) {
+                    continue;
+                }
+            }
+
+            AvatarDataSequenceNumber lastSeqToReceiver = nodeData->getLastBroadcastSequenceNumber(otherID);
+            AvatarDataSequenceNumber lastSeqFromSender = otherAvatar.sequenceNumber;
+
+            if (lastSeqToReceiver > lastSeqFromSender && lastSeqToReceiver != UINT16_MAX) {
+                // we got out out of order packets from the sender, track it
+                otherNodeData->incrementNumOutOfOrderSends();
+            }
+
+            // make sure we haven't already sent this data from this sender to this receiver
+            // or that somehow we haven't sent
+            if (lastSeqToReceiver == lastSeqFromSender && lastSeqToReceiver != 0) {
+                ++numAvatarsHeldBack;
+                continue;
+            } else if (lastSeqFromSender - lastSeqToReceiver > 1) {
+                // this is a skip - we still send the packet but capture the presence of the skip so we see it happening
+                ++numAvatarsWithSkippedFrames;
+            }
+
+            // we're going to send this avatar
+
+            // increment the number of avatars sent to this reciever
+            nodeData->incrementNumAvatarsSentLastFrame();
+
+            // set the last sent sequence number and frame for this sender on the receiver
+            nodeData->setLastBroadcastSequenceNumber(otherID, lastSeqFromSender);
+            nodeData->setLastBroadcastFrame(otherID, broadcastFrame);
+
+            // start a new segment in the PacketList for this avatar
+            avatarPacketList->startSegment();
+
+            // past twice the full rate distance the avatar is sent less than half of the time, which is too sparse
+            // for its joint deltas to be worth it, so it only gets its transform between the occasional full updates
+            const QByteArray* avatarData = &otherAvatar.deltaData;
+            if (_distribution(_generator) < AVATAR_SEND_FULL_UPDATE_RATIO) {
+                avatarData = &otherAvatar.fullData;
+            } else if (distanceToAvatar > MINIMAL_DATA_FULL_RATE_DISTANCE_RATIO * fullRateDistance) {
+                avatarData = &otherAvatar.minimalData;
+            }
+
+            numAvatarDataBytes += avatarPacketList->write(otherID.toRfc4122());
+            numAvatarDataBytes += avatarPacketList->write(*avatarData);
+
+            avatarPacketList->endSegment();
+        }
+    }
+
+    // close the current packet so that we're always sending something
+    avatarPacketList->closeCurrentPacket(true);
+
+    // record the bytes sent for other avatar data in the AvatarMixerClientData
+    nodeData->recordSentAvatarData(numAvatarDataBytes);
+
+    // record the number of avatars held back this frame
+    nodeData->recordNumOtherAvatarStarves(numAvatarsHeldBack);
+    nodeData->recordNumOtherAvatarSkips(numAvatarsWithSkippedFrames);
+
+    if (numOtherAvatars == 0) {
+        // update the full rate distance to FLOAT_MAX since we didn't have any other avatars to send
+        nodeData->setMaxAvatarDistance(FLT_MAX);
+    } else {
+        nodeData->setMaxAvatarDistance(maxAvatarDistanceThisFrame);
+    }
+
+    _listenerPackets.push_back(std::move(listenerPackets));
+}
@@ -0,0 +1,62 @@
+//
+//  AvatarMixerWorker.h
+//  assignment-client/src/avatars
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AvatarMixerWorker_h
+#define hifi_AvatarMixerWorker_h
+
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <NLPacket.h>
+#include <NLPacketList.h>
+#include <Node.h>
+
+class AvatarMixer;
+
+/// Prepares the avatar data packets for the set of listeners handed to it for a frame.
+/// Other avatars are only read through the snapshot taken by the AvatarMixer before the frame,
+/// so several workers can broadcast concurrently for different listeners.
+class AvatarMixerWorker {
+public:
+    struct ListenerPackets {
+        SharedNodePointer node;
+        std::vector<std::unique_ptr<NLPacket>> identityPackets;
+        std::unique_ptr<NLPacketList> avatarPacketList;
+    };
+
+    AvatarMixerWorker(const AvatarMixer& mixer);
+
+    // the following methods are called between frames from the AvatarMixer broadcast thread
+    void queueListener(const SharedNodePointer& node) { _listeners.push_back(node); }
+    std::vector<ListenerPackets>& getListenerPackets() { return _listenerPackets; }
+    void clearFrame();
+
+    /// prepares the packets for every queued listener, called from the worker's own thread
+    void broadcastToQueuedListeners();
+
+    // counters for the current frame, collected by the AvatarMixer after each frame
+    int sumListeners { 0 };
+    int sumIdentityPackets { 0 };
+
+private:
+    void broadcastToListener(const SharedNodePointer& node);
+
+    const AvatarMixer& _mixer;
+
+    std::vector<SharedNodePointer> _listeners;
+    std::vector<ListenerPackets> _listenerPackets;
+
+    // setup for distributed random floating point values, one generator per worker
+    std::mt19937 _generator;
+    std::uniform_real_distribution<float> _distribution;
+};
+
+#endif // hifi_AvatarMixerWorker_h
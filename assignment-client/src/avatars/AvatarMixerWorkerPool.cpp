@@ -0,0 +1,117 @@
+//
+//  AvatarMixerWorkerPool.cpp
+//  assignment-client/src/avatars
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QtCore/QDebug>
+
+#include <UUIDHasher.h>
+
+#include "AvatarMixerWorkerPool.h"
+
+static const int MAX_BROADCAST_THREADS = 64;
+
+AvatarMixerWorkerPool::AvatarMixerWorkerPool(const AvatarMixer& mixer, int numThreads) : _mixer(mixer) {
+    setNumThreads(numThreads);
+}
+
+AvatarMixerWorkerPool::~AvatarMixerWorkerPool() {
+    stopThreads();
+}
+
+void AvatarMixerWorkerPool::stopThreads() {
+    {
+        Lock lock(_mutex);
+        _shouldStop = true;
+    }
+    _frameReady.notify_all();
+
+    for (auto& thread : _threads) {
+        thread.join();
+    }
+    _threads.clear();
+
+    _shouldStop = false;
+}
+
+void AvatarMixerWorkerPool::setNumThreads(int numThreads) {
+    if (numThreads <= 0) {
+        numThreads = std::max(1, (int)std::thread::hardware_concurrency());
+    }
+    numThreads = std::min(numThreads, MAX_BROADCAST_THREADS);
+
+    if (numThreads == this->numThreads()) {
+        return;
+    }
+
+    qDebug() << "Resizing avatar broadcast worker pool from" << this->numThreads() << "to" << numThreads << "threads";
+
+    stopThreads();
+
+    _workers.clear();
+    for (int i = 0; i < numThreads; ++i) {
+        _workers.emplace_back(new AvatarMixerWorker(_mixer));
+    }
+
+    // with a single worker the broadcast runs on the calling thread, there is no need for a separate one
+    if (numThreads > 1) {
+        for (auto& worker : _workers) {
+            _threads.emplace_back(&AvatarMixerWorkerPool::run, this, worker.get(), _frame);
+        }
+    }
+}
+
+void AvatarMixerWorkerPool::queueListener(const SharedNodePointer& node) {
+    size_t index = std::hash<QUuid>()(node->getUUID()) % _workers.size();
+    _workers[index]->queueListener(node);
+}
+
+void AvatarMixerWorkerPool::broadcast() {
+    if (_threads.empty()) {
+        _workers.front()->broadcastToQueuedListeners();
+        return;
+    }
+
+    {
+        Lock lock(_mutex);
+        _numPendingWorkers = (int)_workers.size();
+        ++_frame;
+    }
+    _frameReady.notify_all();
+
+    // wait on every worker before any avatar packet is sent
+    Lock lock(_mutex);
+    _frameDone.wait(lock, [&] { return _numPendingWorkers == 0; });
+}
+
+void AvatarMixerWorkerPool::run(AvatarMixerWorker* worker, int startFrame) {
+    int lastFrame = startFrame;
+
+    while (true) {
+        {
+            Lock lock(_mutex);
+            _frameReady.wait(lock, [&] { return _shouldStop || _frame != lastFrame; });
+
+            if (_shouldStop) {
+                return;
+            }
+            lastFrame = _frame;
+        }
+
+        worker->broadcastToQueuedListeners();
+
+        bool isLastWorker = false;
+        {
+            Lock lock(_mutex);
+            isLastWorker = (--_numPendingWorkers == 0);
+        }
+        if (isLastWorker) {
+            _frameDone.notify_one();
+        }
+    }
+}
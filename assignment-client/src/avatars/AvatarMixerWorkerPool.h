@@ -0,0 +1,69 @@
+//
+//  AvatarMixerWorkerPool.h
+//  assignment-client/src/avatars
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AvatarMixerWorkerPool_h
+#define hifi_AvatarMixerWorkerPool_h
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "AvatarMixerWorker.h"
+
+/// Splits the listeners of a frame between a set of AvatarMixerWorkers, each running on its own thread.
+/// A listener is always handed to the same worker, so its per listener state is only ever touched by one thread.
+class AvatarMixerWorkerPool {
+public:
+    AvatarMixerWorkerPool(const AvatarMixer& mixer, int numThreads = 1);
+    ~AvatarMixerWorkerPool();
+
+    AvatarMixerWorkerPool(const AvatarMixerWorkerPool&) = delete;
+    AvatarMixerWorkerPool& operator=(const AvatarMixerWorkerPool&) = delete;
+
+    // must be called between frames, 0 uses one thread per available core
+    void setNumThreads(int numThreads);
+    int numThreads() const { return (int)_workers.size(); }
+
+    // queue a listener on the worker that owns it
+    void queueListener(const SharedNodePointer& node);
+
+    // prepare the packets for every queued listener, blocks until all workers have finished the frame
+    void broadcast();
+
+    template <typename Functor>
+    void each(Functor functor) {
+        for (auto& worker : _workers) {
+            functor(*worker);
+        }
+    }
+
+private:
+    using Mutex = std::mutex;
+    using Lock = std::unique_lock<Mutex>;
+
+    void run(AvatarMixerWorker* worker, int startFrame);
+    void stopThreads();
+
+    const AvatarMixer& _mixer;
+
+    std::vector<std::unique_ptr<AvatarMixerWorker>> _workers;
+    std::vector<std::thread> _threads;
+
+    Mutex _mutex;
+    std::condition_variable _frameReady;
+    std::condition_variable _frameDone;
+    int _frame { 0 };
+    int _numPendingWorkers { 0 };
+    bool _shouldStop { false };
+};
+
+#endif // hifi_AvatarMixerWorkerPool_h
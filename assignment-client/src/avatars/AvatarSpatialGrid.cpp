@@ -0,0 +1,82 @@
+//
+//  AvatarSpatialGrid.cpp
+//  assignment-client/src/avatars
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <algorithm>
+
+#include "AvatarSpatialGrid.h"
+
+const float AvatarSpatialGrid::DEFAULT_CELL_SIZE = 16.0f; // meters
+
+// each axis of a key holds a signed cell coordinate in 21 bits
+const int KEY_BITS_PER_AXIS = 21;
+const int64_t KEY_AXIS_OFFSET = 1 << (KEY_BITS_PER_AXIS - 1);
+const int64_t KEY_AXIS_MASK = (1 << KEY_BITS_PER_AXIS) - 1;
+
+void AvatarSpatialGrid::clear() {
+    // drop the cells that stayed empty for a whole frame, keep the others so that their key lookups survive
+    auto end = std::remove_if(_cells.begin(), _cells.end(), [](const Cell& cell) { return cell.avatars.empty(); });
+    if (end != _cells.end()) {
+        _cells.erase(end, _cells.end());
+        _cellIndices.clear();
+        for (int i = 0; i < (int)_cells.size(); ++i) {
+            glm::vec3 cellMinimum;
+            _cellIndices[keyForPosition(_cells[i].minimum + 0.5f * _cellSize, cellMinimum)] = i;
+        }
+    }
+
+    for (auto& cell : _cells) {
+        cell.avatars.clear();
+        cell.hasIdentityChange = false;
+    }
+    _numAvatars = 0;
+}
+
+void AvatarSpatialGrid::insert(int avatar, const glm::vec3& position, bool hasIdentityChange) {
+    glm::vec3 cellMinimum;
+    uint64_t key = keyForPosition(position, cellMinimum);
+
+    auto it = _cellIndices.find(key);
+    int index;
+    if (it == _cellIndices.end()) {
+        index = (int)_cells.size();
+        _cellIndices[key] = index;
+        _cells.push_back(Cell());
+        _cells.back().minimum = cellMinimum;
+    } else {
+        index = it->second;
+    }
+
+    Cell& cell = _cells[index];
+    cell.avatars.push_back(avatar);
+    cell.hasIdentityChange = cell.hasIdentityChange || hasIdentityChange;
+    ++_numAvatars;
+}
+
+float AvatarSpatialGrid::getMinimumDistance(const Cell& cell, const glm::vec3& point) const {
+    glm::vec3 nearest = glm::clamp(point, cell.minimum, cell.minimum + _cellSize);
+    return glm::length(point - nearest);
+}
+
+float AvatarSpatialGrid::getMaximumDistance(const Cell& cell, const glm::vec3& point) const {
+    glm::vec3 center = cell.minimum + 0.5f * _cellSize;
+    return glm::length(glm::abs(point - center) + 0.5f * _cellSize);
+}
+
+uint64_t AvatarSpatialGrid::keyForPosition(const glm::vec3& position, glm::vec3& cellMinimum) const {
+    glm::vec3 coordinates = glm::floor(position / _cellSize);
+    cellMinimum = coordinates * _cellSize;
+
+    uint64_t key = 0;
+    for (int axis = 0; axis < 3; ++axis) {
+        int64_t coordinate = std::max(-KEY_AXIS_OFFSET, std::min((int64_t)coordinates[axis], KEY_AXIS_OFFSET - 1));
+        key = (key << KEY_BITS_PER_AXIS) | (uint64_t)((coordinate + KEY_AXIS_OFFSET) & KEY_AXIS_MASK);
+    }
+    return key;
+}
@@ -0,0 +1,55 @@
+//
+//  AvatarSpatialGrid.h
+//  assignment-client/src/avatars
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AvatarSpatialGrid_h
+#define hifi_AvatarSpatialGrid_h
+
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+/// A sparse uniform grid of avatar positions, so that a listener can deal with a whole cell of far avatars at once.
+/// The cells are kept from frame to frame and only their contents are rebuilt.
+class AvatarSpatialGrid {
+public:
+    static const float DEFAULT_CELL_SIZE;
+
+    struct Cell {
+        glm::vec3 minimum;
+        std::vector<int> avatars;
+        bool hasIdentityChange { false }; // one of the avatars changed its identity since the last frame
+    };
+
+    AvatarSpatialGrid(float cellSize = DEFAULT_CELL_SIZE) : _cellSize(cellSize) {}
+
+    // the following are called once per frame before any query
+    void clear();
+    void insert(int avatar, const glm::vec3& position, bool hasIdentityChange);
+
+    // every cell, some of which can be empty
+    const std::vector<Cell>& getCells() const { return _cells; }
+    int getNumAvatars() const { return _numAvatars; }
+
+    // the distances from a point to the nearest and to the furthest point of a cell
+    float getMinimumDistance(const Cell& cell, const glm::vec3& point) const;
+    float getMaximumDistance(const Cell& cell, const glm::vec3& point) const;
+
+private:
+    uint64_t keyForPosition(const glm::vec3& position, glm::vec3& cellMinimum) const;
+
+    float _cellSize;
+    std::vector<Cell> _cells;
+    std::unordered_map<uint64_t, int> _cellIndices;
+    int _numAvatars { 0 };
+};
+
+#endif // hifi_AvatarSpatialGrid_h
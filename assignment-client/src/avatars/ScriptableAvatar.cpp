@@ -9,6 +9,8 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <mutex>
+
 #include <QThread>
 
 #include <GLMHelpers.h>
@@ -26,6 +28,7 @@ void ScriptableAvatar::startAnimation(const QString& url, float fps, float prior
     _animation = DependencyManager::get<AnimationCache>()->getAnimation(url);
     _animationDetails = AnimationDetails("", QUrl(url), fps, 0, loop, hold, false, firstFrame, lastFrame, true, firstFrame);
     _maskedJoints = maskedJoints;
+    _poseTrack.reset();
 }
 
 void ScriptableAvatar::stopAnimation() {
@@ -34,6 +37,7 @@ void ScriptableAvatar::stopAnimation() {
         return;
     }
     _animation.clear();
+    _poseTrack.reset();
 }
 
 AnimationDetails ScriptableAvatar::getAnimationDetails() {
@@ -49,8 +53,59 @@ AnimationDetails ScriptableAvatar::getAnimationDetails() {
 void ScriptableAvatar::setSkeletonModelURL(const QUrl& skeletonModelURL) {
     _bind.reset();
     _animSkeleton.reset();
+    _poseTrack.reset();
     AvatarData::setSkeletonModelURL(skeletonModelURL);
 }
+
+std::shared_ptr<const ScriptableAvatar::PoseTrack> ScriptableAvatar::getPoseTrack() {
+    // the tracks are built once, and live as long as an avatar is playing them
+    static std::mutex poseTracksMutex;
+    static QHash<QString, std::weak_ptr<const PoseTrack>> poseTracks;
+
+    QString key = _animation->getURL().toString() + "|" + _skeletonFBXURL.toString() + "|" + _maskedJoints.join(",");
+    std::lock_guard<std::mutex> lock(poseTracksMutex);
+    auto poseTrack = poseTracks.value(key).lock();
+    if (poseTrack) {
+        return poseTrack;
+    }
+
+    const QVector<FBXJoint>& modelJoints = _bind->getGeometry().joints;
+    QStringList animationJointNames = _animation->getJointNames();
+
+    // As long as we need the model preRotations anyway, let's get the jointIndex from the bind skeleton rather than
+    // trusting the .fst (which is sometimes not updated to match changes to .fbx).
+    std::vector<int> mappings(animationJointNames.size(), -1);
+    for (int i = 0; i < animationJointNames.size(); i++) {
+        const QString& name = animationJointNames[i];
+        if (!_maskedJoints.contains(name)) {
+            mappings[i] = _bind->getGeometry().getJointIndex(name);
+        }
+    }
+
+    const QVector<FBXAnimationFrame>& frames = _animation->getFramesReference();
+    auto newPoseTrack = std::make_shared<PoseTrack>(frames.size());
+    for (int frame = 0; frame < frames.size(); frame++) {
+        std::vector<AnimPose> poses = _animSkeleton->getRelativeDefaultPoses();
+        for (int i = 0; i < (int)mappings.size(); i++) {
+            int mapping = mappings[i];
+            if (mapping != -1) {
+                // Eventually, this should probably deal with post rotations and translations, too.
+                poses[mapping].rot = modelJoints[mapping].preRotation * frames[frame].rotations.at(i);
+            }
+        }
+        _animSkeleton->convertRelativePosesToAbsolute(poses);
+
+        std::vector<glm::quat>& rotations = (*newPoseTrack)[frame];
+        rotations.reserve(poses.size());
+        for (auto& pose : poses) {
+            rotations.push_back(pose.rot);
+        }
+    }
+
+    poseTracks.insert(key, newPoseTrack);
+    return newPoseTrack;
+}
+
 void ScriptableAvatar::update(float deltatime) {
     if (_bind.isNull() && !_skeletonFBXURL.isEmpty()) { // AvatarData will parse the .fst, but not get the .fbx skeleton.
         _bind = DependencyManager::get<AnimationCache>()->getAnimation(_skeletonFBXURL);
@@ -68,43 +123,33 @@ void ScriptableAvatar::update(float deltatime) {
             }
             _animationDetails.currentFrame = currentFrame;
 
-            const QVector<FBXJoint>& modelJoints = _bind->getGeometry().joints;
-            QStringList animationJointNames = _animation->getJointNames();
+            if (!_poseTrack) {
+                _poseTrack = getPoseTrack();
+            }
 
-            const int nJoints = modelJoints.size();
+            const int nJoints = _bind->getGeometry().joints.size();
             if (_jointData.size() != nJoints) {
                 _jointData.resize(nJoints);
             }
-            
-            const int frameCount = _animation->getFrames().size();
-            const FBXAnimationFrame& floorFrame = _animation->getFrames().at((int)glm::floor(currentFrame) % frameCount);
-            const FBXAnimationFrame& ceilFrame = _animation->getFrames().at((int)glm::ceil(currentFrame) % frameCount);
+
+            // blend the absolute rotations of the two frames around the current time, rather than posing the skeleton
+            const int frameCount = (int)_poseTrack->size();
+            const std::vector<glm::quat>& floorFrame = (*_poseTrack)[(int)glm::floor(currentFrame) % frameCount];
+            const std::vector<glm::quat>& ceilFrame = (*_poseTrack)[(int)glm::ceil(currentFrame) % frameCount];
             const float frameFraction = glm::fract(currentFrame);
-            std::vector<AnimPose> poses = _animSkeleton->getRelativeDefaultPoses();
-            
-            for (int i = 0; i < animationJointNames.size(); i++) {
-                const QString& name = animationJointNames[i];
-                // As long as we need the model preRotations anyway, let's get the jointIndex from the bind skeleton rather than
-                // trusting the .fst (which is sometimes not updated to match changes to .fbx).
-                int mapping = _bind->getGeometry().getJointIndex(name);
-                if (mapping != -1 && !_maskedJoints.contains(name)) {
-                    // Eventually, this should probably deal with post rotations and translations, too.
-                    poses[mapping].rot = modelJoints[mapping].preRotation *
-                        safeMix(floorFrame.rotations.at(i), ceilFrame.rotations.at(i), frameFraction);;
-                 }
-            }
-            _animSkeleton->convertRelativePosesToAbsolute(poses);
+
             for (int i = 0; i < nJoints; i++) {
                 JointData& data = _jointData[i];
-                AnimPose& pose = poses[i];
-                if (data.rotation != pose.rot) {
-                    data.rotation = pose.rot;
+                glm::quat rotation = safeMix(floorFrame[i], ceilFrame[i], frameFraction);
+                if (data.rotation != rotation) {
+                    data.rotation = rotation;
                     data.rotationSet = true;
                 }
             }
 
         } else {
             _animation.clear();
+            _poseTrack.reset();
         }
     }
 }
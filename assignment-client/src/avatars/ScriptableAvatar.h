@@ -32,11 +32,16 @@ private slots:
     void update(float deltatime);
     
 private:
+    // the absolute rotations of the skeleton joints for each frame of an animation
+    using PoseTrack = std::vector<std::vector<glm::quat>>;
+    std::shared_ptr<const PoseTrack> getPoseTrack();
+
     AnimationPointer _animation;
     AnimationDetails _animationDetails;
     QStringList _maskedJoints;
     AnimationPointer _bind; // a sleazy way to get the skeleton, given the various library/cmake dependencies
     std::shared_ptr<AnimSkeleton> _animSkeleton;
+    std::shared_ptr<const PoseTrack> _poseTrack; // shared by the avatars playing the same animation on the same skeleton
 };
 
 #endif // hifi_ScriptableAvatar_h
@@ -0,0 +1,68 @@
+//
+//  EntityNodeData.cpp
+//  assignment-client/src/entities
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityNodeData.h"
+
+#include <algorithm>
+
+const float EntityNodeData::DEFAULT_MOVER_FULL_RATE_DISTANCE = 50.0f;
+const int EntityNodeData::DEFAULT_MOVER_BUDGET = 1000;
+
+// a mover just past the full rate distance gets the highest of these rates, one five times as far gets the lowest
+static const float MAX_FAR_MOVER_RATE = 5.0f; // Hz
+static const float MIN_FAR_MOVER_RATE = 1.0f; // Hz
+
+bool EntityNodeData::shouldSendItem(const QUuid& itemID, quint64 itemLastChanged, float distance, bool isMoving) {
+    auto sentEntity = _sentEntities.constFind(itemID);
+    if (sentEntity == _sentEntities.constEnd()) {
+        return true; // the viewer doesn't have this one yet
+    }
+
+    if (sentEntity->lastChanged >= itemLastChanged) {
+        // the viewer has this change already, we are only looking at it again because another change was put off
+        return false;
+    }
+
+    // A mover comes to rest with a change of its own, which is sent right away, so the viewer always ends up with where
+    // it stopped. In between the viewer extrapolates from the velocities it was last sent.
+    if (!isMoving || distance <= _moverFullRateDistance) {
+        return true;
+    }
+
+    quint64 now = usecTimestampNow();
+    updateBudgetPeriod(now);
+
+    float rate = std::max(MIN_FAR_MOVER_RATE, MAX_FAR_MOVER_RATE * _moverFullRateDistance / distance);
+    quint64 updateInterval = (quint64)((float)USECS_PER_SECOND / rate);
+    bool isDue = now - sentEntity->sentAt >= updateInterval;
+    bool isInBudget = _moverBudgetBytesPerSecond <= 0 || _bytesSentInBudgetPeriod < _moverBudgetBytesPerSecond;
+
+    if (isDue && isInBudget) {
+        return true;
+    }
+
+    deferItem(itemLastChanged);
+    return false;
+}
+
+void EntityNodeData::itemSent(const QUuid& itemID, quint64 itemLastChanged, int bytes) {
+    quint64 now = usecTimestampNow();
+    updateBudgetPeriod(now);
+
+    _sentEntities[itemID] = { itemLastChanged, now };
+    _bytesSentInBudgetPeriod += bytes;
+}
+
+void EntityNodeData::updateBudgetPeriod(quint64 now) {
+    if (now - _budgetPeriodStart >= USECS_PER_SECOND) {
+        _budgetPeriodStart = now;
+        _bytesSentInBudgetPeriod = 0;
+    }
+}
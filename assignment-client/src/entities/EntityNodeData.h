@@ -12,19 +12,47 @@
 #ifndef hifi_EntityNodeData_h
 #define hifi_EntityNodeData_h
 
+#include <QtCore/QHash>
+
+#include <NumericalConstants.h>
 #include <udt/PacketHeaders.h>
 
 #include "../octree/OctreeQueryNode.h"
 
 class EntityNodeData : public OctreeQueryNode {
 public:
+    static const float DEFAULT_MOVER_FULL_RATE_DISTANCE; // meters
+    static const int DEFAULT_MOVER_BUDGET; // kbps
+
     virtual PacketType getMyPacketType() const override { return PacketType::EntityData; }
 
     quint64 getLastDeletedEntitiesSentAt() const { return _lastDeletedEntitiesSentAt; }
     void setLastDeletedEntitiesSentAt(quint64 sentAt) { _lastDeletedEntitiesSentAt = sentAt; }
 
+    // Moving entities past the full rate distance are updated at a rate that drops with their distance, and only while
+    // the entity data sent to this viewer stays in its budget. A budget of 0 kbps is no budget.
+    void setMoverFullRateDistance(float distance) { _moverFullRateDistance = distance; }
+    void setMoverBudget(int kbps) { _moverBudgetBytesPerSecond = kbps * BYTES_PER_KILOBIT; }
+
+    virtual bool shouldSendItem(const QUuid& itemID, quint64 itemLastChanged, float distance, bool isMoving) override;
+    virtual void itemSent(const QUuid& itemID, quint64 itemLastChanged, int bytes) override;
+
 private:
+    void updateBudgetPeriod(quint64 now);
+
     quint64 _lastDeletedEntitiesSentAt { usecTimestampNow() };
+
+    // the change of each entity this viewer has, and when it was sent
+    struct SentEntity {
+        quint64 lastChanged;
+        quint64 sentAt;
+    };
+    QHash<QUuid, SentEntity> _sentEntities;
+
+    float _moverFullRateDistance { DEFAULT_MOVER_FULL_RATE_DISTANCE };
+    int _moverBudgetBytesPerSecond { DEFAULT_MOVER_BUDGET * BYTES_PER_KILOBIT };
+    quint64 _budgetPeriodStart { 0 };
+    int _bytesSentInBudgetPeriod { 0 };
 };
 
 #endif // hifi_EntityNodeData_h
@@ -48,7 +48,10 @@ void EntityServer::handleEntityPacket(QSharedPointer<ReceivedMessage> message, S
 }
 
 std::unique_ptr<OctreeQueryNode> EntityServer::createOctreeQueryNode() {
-    return std::unique_ptr<OctreeQueryNode> { new EntityNodeData() };
+    EntityNodeData* nodeData = new EntityNodeData();
+    nodeData->setMoverFullRateDistance(_moverFullRateDistance);
+    nodeData->setMoverBudget(_moverBudget);
+    return std::unique_ptr<OctreeQueryNode> { nodeData };
 }
 
 OctreePointer EntityServer::createTree() {
@@ -285,6 +288,17 @@ void EntityServer::readAdditionalConfiguration(const QJsonObject& settingsSectio
     } else {
         tree->setEntityScriptSourceWhitelist("");
     }
+
+    int moverFullRateDistance;
+    if (readOptionInt("moverFullRateDistance", settingsSectionObject, moverFullRateDistance)) {
+        _moverFullRateDistance = (float)moverFullRateDistance;
+    } else {
+        _moverFullRateDistance = EntityNodeData::DEFAULT_MOVER_FULL_RATE_DISTANCE;
+    }
+
+    if (!readOptionInt("moverUpdateBudget", settingsSectionObject, _moverBudget)) {
+        _moverBudget = EntityNodeData::DEFAULT_MOVER_BUDGET;
+    }
 }
 
 void EntityServer::nodeAdded(SharedNodePointer node) {
@@ -304,9 +318,25 @@ void EntityServer::nodeKilled(SharedNodePointer node) {
 // set of stats to have, but we'd probably want a different data structure if we keep it very long.
 // Since this version uses a single shared QMap for all senders, there could be some lock contention 
 // on this QWriteLocker
-void EntityServer::trackSend(const QUuid& dataID, quint64 dataLastEdited, const QUuid& sessionID) {
+void EntityServer::trackSend(const QUuid& dataID, quint64 dataLastEdited, bool sentAllData, const QUuid& sessionID) {
+    quint64 now = usecTimestampNow();
     QWriteLocker locker(&_viewerSendingStatsLock);
-    _viewerSendingStats[sessionID][dataID] = { usecTimestampNow(), dataLastEdited };
+    ViewerSendingStats& stats = _viewerSendingStats[sessionID][dataID];
+    stats.lastSent = now;
+    stats.lastEdited = dataLastEdited;
+    if (sentAllData) {
+        stats.lastSentAllData = now;
+    }
+}
+
+quint64 EntityServer::getLastSentAllData(const QUuid& dataID, const QUuid& sessionID) {
+    QReadLocker locker(&_viewerSendingStatsLock);
+    auto viewerData = _viewerSendingStats.constFind(sessionID);
+    if (viewerData == _viewerSendingStats.constEnd()) {
+        return 0;
+    }
+    auto stats = viewerData->constFind(dataID);
+    return stats == viewerData->constEnd() ? 0 : stats->lastSentAllData;
 }
 
 void EntityServer::trackViewerGone(const QUuid& sessionID) {
@@ -317,6 +347,43 @@ void EntityServer::trackViewerGone(const QUuid& sessionID) {
     }
 }
 
+static int countEntitiesInSubtree(const OctreeElementPointer& element) {
+    int numEntities = 0;
+    std::static_pointer_cast<EntityTreeElement>(element)->forEachEntity([&](EntityItemPointer entity) {
+        ++numEntities;
+    });
+    for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
+        OctreeElementPointer child = element->getChildAtIndex(i);
+        if (child) {
+            numEntities += countEntitiesInSubtree(child);
+        }
+    }
+    return numEntities;
+}
+
+QJsonObject EntityServer::getJurisdictionLoad() {
+    // how the entities of our jurisdiction spread over the octants it would be split into
+    QJsonObject octantEntities;
+    EntityTreePointer tree = std::static_pointer_cast<EntityTree>(_tree);
+    tree->withReadLock([&] {
+        OctreeElementPointer jurisdictionRoot = tree->getRoot();
+        OctalCodePtr rootCode = _jurisdiction ? _jurisdiction->getRootOctalCode() : nullptr;
+        if (rootCode) {
+            OctreeElementPointer element = tree->nodeForOctalCode(jurisdictionRoot, rootCode.get(), nullptr);
+            if (element) {
+                jurisdictionRoot = element;
+            }
+        }
+        for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
+            OctreeElementPointer child = jurisdictionRoot->getChildAtIndex(i);
+            if (child) {
+                octantEntities[octalCodeToHexString(child->getOctalCode())] = countEntitiesInSubtree(child);
+            }
+        }
+    });
+    return octantEntities;
+}
+
 QString EntityServer::serverSubclassStats() {
     QLocale locale(QLocale::English);
     QString statsString;
@@ -17,14 +17,16 @@
 #include <memory>
 
 #include "EntityItem.h"
+#include "EntityNodeData.h"
 #include "EntityServerConsts.h"
 #include "EntityTree.h"
 
 /// Handles assignments of type EntityServer - sending entities to various clients.
 
 struct ViewerSendingStats {
-    quint64 lastSent;
-    quint64 lastEdited;
+    quint64 lastSent { 0 };
+    quint64 lastEdited { 0 };
+    quint64 lastSentAllData { 0 }; // the viewer has every property of the entity as of this time
 };
 
 class SimpleEntitySimulation;
@@ -55,8 +57,10 @@ public:
     virtual void entityCreated(const EntityItem& newEntity, const SharedNodePointer& senderNode) override;
     virtual void readAdditionalConfiguration(const QJsonObject& settingsSectionObject) override;
     virtual QString serverSubclassStats() override;
+    virtual QJsonObject getJurisdictionLoad() override;
 
-    virtual void trackSend(const QUuid& dataID, quint64 dataLastEdited, const QUuid& sessionID) override;
+    virtual void trackSend(const QUuid& dataID, quint64 dataLastEdited, bool sentAllData, const QUuid& sessionID) override;
+    virtual quint64 getLastSentAllData(const QUuid& dataID, const QUuid& sessionID) override;
     virtual void trackViewerGone(const QUuid& sessionID) override;
 
 public slots:
@@ -76,6 +80,9 @@ private:
 
     QReadWriteLock _viewerSendingStatsLock;
     QMap<QUuid, QMap<QUuid, ViewerSendingStats>> _viewerSendingStats;
+
+    float _moverFullRateDistance { EntityNodeData::DEFAULT_MOVER_FULL_RATE_DISTANCE };
+    int _moverBudget { EntityNodeData::DEFAULT_MOVER_BUDGET };
 };
 
 #endif // hifi_EntityServer_h
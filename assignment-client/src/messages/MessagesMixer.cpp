@@ -15,6 +15,8 @@
 #include <LogHandler.h>
 #include <MessagesClient.h>
 #include <NodeList.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
 #include <udt/PacketHeaders.h>
 #include "MessagesMixer.h"
 
@@ -30,27 +32,59 @@ MessagesMixer::MessagesMixer(ReceivedMessage& message) : ThreadedAssignment(mess
 }
 
 void MessagesMixer::nodeKilled(SharedNodePointer killedNode) {
-    for (auto& channel : _channelSubscribers) {
-        channel.remove(killedNode->getUUID());
+    auto channel = _channelSubscribers.begin();
+    while (channel != _channelSubscribers.end()) {
+        channel->remove(killedNode->getUUID());
+        if (channel->isEmpty()) {
+            channel = _channelSubscribers.erase(channel);
+        } else {
+            ++channel;
+        }
     }
 }
 
 void MessagesMixer::handleMessages(QSharedPointer<ReceivedMessage> receivedMessage, SharedNodePointer senderNode) {
-    QString channel, message;
-    QUuid senderID;
-    MessagesClient::decodeMessagesPacket(receivedMessage, channel, message, senderID);
+    // only the channel is read, the message is passed on as it was sent (see MessagesClient::encodeMessagesPacket)
+    quint16 channelLength;
+    receivedMessage->readPrimitive(&channelLength);
+    QString channel = QString::fromUtf8(receivedMessage->read(channelLength));
 
+    ChannelStats& stats = _channelStats[channel];
+    stats.receivedMessages++;
+
+    if (_maxChannelMessagesPerSecond > 0) {
+        quint64 now = usecTimestampNow();
+        if (now - stats.windowStart > USECS_PER_SECOND) {
+            stats.windowStart = now;
+            stats.messagesInWindow = 0;
+        }
+        if (stats.messagesInWindow >= _maxChannelMessagesPerSecond) {
+            stats.droppedMessages++;
+            return;
+        }
+        stats.messagesInWindow++;
+    }
+
+    auto subscribers = _channelSubscribers.constFind(channel);
+    if (subscribers == _channelSubscribers.constEnd()) {
+        return;
+    }
+
+    // the payload is shared by the packet lists of all the subscribers
+    QByteArray payload = receivedMessage->getMessage();
     auto nodeList = DependencyManager::get<NodeList>();
 
-    nodeList->eachMatchingNode(
-        [&](const SharedNodePointer& node)->bool {
-        return node->getType() == NodeType::Agent && node->getActiveSocket() &&
-                _channelSubscribers[channel].contains(node->getUUID());
-    },
-        [&](const SharedNodePointer& node) {
-        auto packetList = MessagesClient::encodeMessagesPacket(channel, message, senderID);
-        nodeList->sendPacketList(std::move(packetList), *node);
-    });
+    for (auto& subscriberID : *subscribers) {
+        SharedNodePointer node = nodeList->nodeWithUUID(subscriberID);
+        if (node && node->getType() == NodeType::Agent && node->getActiveSocket()) {
+            auto packetList = NLPacketList::create(PacketType::MessagesData, QByteArray(), true, true);
+            packetList->write(payload);
+            nodeList->sendPacketList(std::move(packetList), *node);
+
+            stats.sentMessages++;
+            stats.sentBytes += payload.size();
+        }
+    }
 }
 
 void MessagesMixer::handleMessagesSubscribe(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
@@ -60,8 +94,12 @@ void MessagesMixer::handleMessagesSubscribe(QSharedPointer<ReceivedMessage> mess
 
 void MessagesMixer::handleMessagesUnsubscribe(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
     QString channel = QString::fromUtf8(message->getMessage());
-    if (_channelSubscribers.contains(channel)) {
-        _channelSubscribers[channel].remove(senderNode->getUUID());
+    auto subscribers = _channelSubscribers.find(channel);
+    if (subscribers != _channelSubscribers.end()) {
+        subscribers->remove(senderNode->getUUID());
+        if (subscribers->isEmpty()) {
+            _channelSubscribers.erase(subscribers);
+        }
     }
 }
 
@@ -78,10 +116,63 @@ void MessagesMixer::sendStatsPacket() {
     });
 
     statsObject["messages"] = messagesMixerObject;
+
+    // add stats for each channel
+    QJsonObject channelsObject;
+    auto channel = _channelStats.begin();
+    while (channel != _channelStats.end()) {
+        ChannelStats& stats = channel.value();
+        if (stats.receivedMessages == 0 && !_channelSubscribers.contains(channel.key())) {
+            // forget the channels that went quiet
+            channel = _channelStats.erase(channel);
+            continue;
+        }
+
+        QJsonObject channelStats;
+        channelStats["subscribers"] = _channelSubscribers.value(channel.key()).size();
+        channelStats["received_messages"] = stats.receivedMessages;
+        channelStats["dropped_messages"] = stats.droppedMessages;
+        channelStats["sent_messages"] = stats.sentMessages;
+        channelStats["sent_bytes"] = (double)stats.sentBytes;
+        channelsObject[channel.key()] = channelStats;
+
+        stats.receivedMessages = 0;
+        stats.droppedMessages = 0;
+        stats.sentMessages = 0;
+        stats.sentBytes = 0;
+        ++channel;
+    }
+    statsObject["channels"] = channelsObject;
+
     ThreadedAssignment::addPacketStatsAndSendStatsPacket(statsObject);
 }
 
 void MessagesMixer::run() {
+    DomainHandler& domainHandler = DependencyManager::get<NodeList>()->getDomainHandler();
+    connect(&domainHandler, &DomainHandler::settingsReceived, this, &MessagesMixer::domainSettingsRequestComplete);
+
     ThreadedAssignment::commonInit(MESSAGES_MIXER_LOGGING_NAME, NodeType::MessagesMixer);
     DependencyManager::get<NodeList>()->addNodeTypeToInterestSet(NodeType::Agent);
+}
+
+void MessagesMixer::domainSettingsRequestComplete() {
+    auto nodeList = DependencyManager::get<NodeList>();
+    parseDomainServerSettings(nodeList->getDomainHandler().getSettingsObject());
+}
+
+void MessagesMixer::parseDomainServerSettings(const QJsonObject& domainSettings) {
+    const QString MESSAGES_MIXER_SETTINGS_KEY = "messages_mixer";
+    const QString MAX_CHANNEL_MESSAGES_PER_SECOND_KEY = "max_channel_messages_per_second";
+
+    QJsonValue maxMessagesValue = domainSettings[MESSAGES_MIXER_SETTINGS_KEY].toObject()[MAX_CHANNEL_MESSAGES_PER_SECOND_KEY];
+    if (maxMessagesValue.isString()) {
+        bool ok = false;
+        int maxMessages = maxMessagesValue.toString().toInt(&ok);
+        if (ok) {
+            _maxChannelMessagesPerSecond = std::max(maxMessages, 0);
+        }
+    }
+    if (_maxChannelMessagesPerSecond > 0) {
+        qDebug() << "Forwarding at most" << _maxChannelMessagesPerSecond << "messages per second on each channel";
+    }
 }
\ No newline at end of file
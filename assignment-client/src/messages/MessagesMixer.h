@@ -29,12 +29,29 @@ public slots:
     void sendStatsPacket() override;
 
 private slots:
+    void domainSettingsRequestComplete();
     void handleMessages(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
     void handleMessagesSubscribe(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
     void handleMessagesUnsubscribe(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
 
 private:
-    QHash<QString,QSet<QUuid>> _channelSubscribers;
+    void parseDomainServerSettings(const QJsonObject& domainSettings);
+
+    struct ChannelStats {
+        quint64 windowStart { 0 };
+        int messagesInWindow { 0 };
+
+        // since the last stats packet
+        int receivedMessages { 0 };
+        int droppedMessages { 0 };
+        int sentMessages { 0 };
+        qint64 sentBytes { 0 };
+    };
+
+    QHash<QString, QSet<QUuid>> _channelSubscribers;
+    QHash<QString, ChannelStats> _channelStats;
+
+    int _maxChannelMessagesPerSecond { 0 }; // 0: no limit
 };
 
 #endif // hifi_MessagesMixer_h
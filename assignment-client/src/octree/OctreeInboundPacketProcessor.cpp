@@ -22,6 +22,23 @@
 static QUuid DEFAULT_NODE_ID_REF;
 const quint64 TOO_LONG_SINCE_LAST_NACK = 1 * USECS_PER_SECOND;
 
+// every edit packet starts with its sequence number and the time it was sent, the edits follow
+const int EDIT_PACKET_HEADER_SIZE = sizeof(unsigned short int) + sizeof(quint64);
+
+class EditsDecoder : public QRunnable {
+public:
+    EditsDecoder(OctreePointer tree, QSharedPointer<ReceivedMessage> message) :
+        _tree(tree), _message(message) { }
+
+    virtual void run() override {
+        _tree->decodeEditsAhead(*_message, _message->getPosition() + EDIT_PACKET_HEADER_SIZE);
+    }
+
+private:
+    OctreePointer _tree;
+    QSharedPointer<ReceivedMessage> _message;
+};
+
 OctreeInboundPacketProcessor::OctreeInboundPacketProcessor(OctreeServer* myServer) :
     _myServer(myServer),
     _receivedPacketCount(0),
@@ -57,6 +74,24 @@ unsigned long OctreeInboundPacketProcessor::getMaxWait() const {
     return (nextNackTime - now) / USECS_PER_MSEC + 1;
 }
 
+void OctreeInboundPacketProcessor::preProcessPackets(const std::list<NodeSharedReceivedMessagePair>& packets) {
+    auto tree = _myServer->getOctree();
+
+    // a lone packet is decoded by processPacket() as it is applied, there is nothing to overlap it with
+    if (_shuttingDown || packets.size() < 2 || !tree->canDecodeEditsAhead()) {
+        return;
+    }
+
+    // decode the edits of all of the packets in parallel, outside of the tree lock - processPacket() still applies
+    // them one packet after the other, in the order they arrived
+    for (auto& packetPair : packets) {
+        if (tree->handlesEditPacketType(packetPair.second->getType())) {
+            _decodePool.start(new EditsDecoder(tree, packetPair.second));
+        }
+    }
+    _decodePool.waitForDone();
+}
+
 void OctreeInboundPacketProcessor::preProcess() {
     // check if it's time to send a nack. If yes, do so
     quint64 now = usecTimestampNow();
@@ -78,6 +113,7 @@ void OctreeInboundPacketProcessor::midProcess() {
 void OctreeInboundPacketProcessor::processPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode) {
     if (_shuttingDown) {
         qDebug() << "OctreeInboundPacketProcessor::processPacket() while shutting down... ignoring incoming packet";
+        _myServer->getOctree()->releaseEditsDecodedAhead(*message);
         return;
     }
 
@@ -141,52 +177,53 @@ void OctreeInboundPacketProcessor::processPacket(QSharedPointer<ReceivedMessage>
         }
         
         const unsigned char* editData = nullptr;
-        
-        while (message->getBytesLeftToRead() > 0) {
 
-            editData = reinterpret_cast<const unsigned char*>(message->getRawMessage() + message->getPosition());
+        // all of the edits of the packet are applied in one lock section, when they were decoded ahead by
+        // preProcessPackets() that is the only work left to do under the lock
+        quint64 startLock = usecTimestampNow();
+        _myServer->getOctree()->withWriteLock([&] {
+            lockWaitTime = usecTimestampNow() - startLock;
+            while (message->getBytesLeftToRead() > 0) {
 
-            int maxSize = message->getBytesLeftToRead();
+                editData = reinterpret_cast<const unsigned char*>(message->getRawMessage() + message->getPosition());
 
-            if (debugProcessPacket) {
-                qDebug() << " --- inside while loop ---";
-                qDebug() << "    maxSize=" << maxSize;
-                qDebug("OctreeInboundPacketProcessor::processPacket() %hhu "
-                       "payload=%p payloadLength=%lld editData=%p payloadPosition=%lld maxSize=%d",
-                       (unsigned char)packetType, message->getRawMessage(), message->getSize(), editData,
-                        message->getPosition(), maxSize);
-            }
+                int maxSize = message->getBytesLeftToRead();
+
+                if (debugProcessPacket) {
+                    qDebug() << " --- inside while loop ---";
+                    qDebug() << "    maxSize=" << maxSize;
+                    qDebug("OctreeInboundPacketProcessor::processPacket() %hhu "
+                           "payload=%p payloadLength=%lld editData=%p payloadPosition=%lld maxSize=%d",
+                           (unsigned char)packetType, message->getRawMessage(), message->getSize(), editData,
+                            message->getPosition(), maxSize);
+                }
 
-            quint64 startProcess, startLock = usecTimestampNow();
-            int editDataBytesRead;
-            _myServer->getOctree()->withWriteLock([&] {
-                startProcess = usecTimestampNow();
-                editDataBytesRead =
+                quint64 startProcess = usecTimestampNow();
+                int editDataBytesRead =
                     _myServer->getOctree()->processEditPacketData(*message, editData, maxSize, sendingNode);
-            });
-            quint64 endProcess = usecTimestampNow();
+                quint64 endProcess = usecTimestampNow();
 
-            if (debugProcessPacket) {
-                qDebug() << "OctreeInboundPacketProcessor::processPacket() after processEditPacketData()..."
-                    << "editDataBytesRead=" << editDataBytesRead;
-            }
+                if (debugProcessPacket) {
+                    qDebug() << "OctreeInboundPacketProcessor::processPacket() after processEditPacketData()..."
+                        << "editDataBytesRead=" << editDataBytesRead;
+                }
 
-            editsInPacket++;
-            quint64 thisProcessTime = endProcess - startProcess;
-            quint64 thisLockWaitTime = startProcess - startLock;
-            processTime += thisProcessTime;
-            lockWaitTime += thisLockWaitTime;
+                editsInPacket++;
+                quint64 thisProcessTime = endProcess - startProcess;
+                processTime += thisProcessTime;
 
-            // skip to next edit record in the packet
-            message->seek(message->getPosition() + editDataBytesRead);
+                // skip to next edit record in the packet
+                message->seek(message->getPosition() + editDataBytesRead);
 
-            if (debugProcessPacket) {
-                qDebug() << "    editDataBytesRead=" << editDataBytesRead;
-                qDebug() << "    AFTER processEditPacketData payload position=" << message->getPosition();
-                qDebug() << "    AFTER processEditPacketData payload size=" << message->getSize();
-            }
+                if (debugProcessPacket) {
+                    qDebug() << "    editDataBytesRead=" << editDataBytesRead;
+                    qDebug() << "    AFTER processEditPacketData payload position=" << message->getPosition();
+                    qDebug() << "    AFTER processEditPacketData payload size=" << message->getSize();
+                }
 
-        }
+            }
+        });
+        _myServer->getOctree()->releaseEditsDecodedAhead(*message);
 
         if (debugProcessPacket) {
             qDebug("OctreeInboundPacketProcessor::processPacket() DONE LOOPING FOR %hhu "
@@ -221,6 +258,10 @@ void OctreeInboundPacketProcessor::trackInboundPacket(const QUuid& nodeUUID, uns
     _totalElementsInPacket += editsInPacket;
     _totalPackets++;
 
+    _processTimes.record(processTime);
+    _lockWaitTimes.record(lockWaitTime);
+    _queueDepths.record(packetsToProcessCount());
+
     QWriteLocker locker(&_senderStatsLock);
 
     // find the individual senders stats and track them there too...
@@ -14,6 +14,9 @@
 #ifndef hifi_OctreeInboundPacketProcessor_h
 #define hifi_OctreeInboundPacketProcessor_h
 
+#include <QtCore/QThreadPool>
+
+#include <Histogram.h>
 #include <ReceivedPacketProcessor.h>
 
 #include "SequenceNumberStats.h"
@@ -72,6 +75,11 @@ public:
 
     void resetStats();
 
+    // the distributions per edit packet, in usecs, and of the packets waiting behind it
+    Histogram& getProcessTimes() { return _processTimes; }
+    Histogram& getLockWaitTimes() { return _lockWaitTimes; }
+    Histogram& getQueueDepths() { return _queueDepths; }
+
     NodeToSenderStatsMap getSingleSenderStats() { QReadLocker locker(&_senderStatsLock); return _singleSenderStats; }
 
     virtual void terminating() override { _shuttingDown = true; ReceivedPacketProcessor::terminating(); }
@@ -82,6 +90,7 @@ protected:
 
     virtual unsigned long getMaxWait() const override;
     virtual void preProcess() override;
+    virtual void preProcessPackets(const std::list<NodeSharedReceivedMessagePair>& packets) override;
     virtual void midProcess() override;
 
 private:
@@ -99,11 +108,17 @@ private:
     std::atomic<uint64_t> _totalLockWaitTime;
     std::atomic<uint64_t> _totalElementsInPacket;
     std::atomic<uint64_t> _totalPackets;
+
+    Histogram _processTimes;
+    Histogram _lockWaitTimes;
+    Histogram _queueDepths;
     
     NodeToSenderStatsMap _singleSenderStats;
     QReadWriteLock _senderStatsLock;
 
     std::atomic<uint64_t> _lastNackTime;
     bool _shuttingDown;
+
+    QThreadPool _decodePool;
 };
 #endif // hifi_OctreeInboundPacketProcessor_h
@@ -96,13 +96,20 @@ void OctreeQueryNode::resetOctreePacket() {
         return;
     }
 
+    rememberLastOctreePayload();
+    writeOctreePacketHeader();
+}
+
+void OctreeQueryNode::rememberLastOctreePayload() {
     // Whenever we call this, we will keep a copy of the last packet, so we can determine if the last packet has
     // changed since we last reset it. Since we know that no two packets can ever be identical without being the same
     // scene information, (e.g. the root node packet of a static scene), we can use this as a strategy for reducing
     // packet send rate.
     _lastOctreePacketLength = _octreePacket->getPayloadSize();
     memcpy(_lastOctreePayload.data(), _octreePacket->getPayload(), _lastOctreePacketLength);
+}
 
+void OctreeQueryNode::writeOctreePacketHeader() {
     // If we're moving, and the client asked for low res, then we force monochrome, otherwise, use
     // the clients requested color state.
     OCTREE_PACKET_FLAGS flags = 0;
@@ -207,6 +214,15 @@ bool OctreeQueryNode::updateCurrentViewFrustum() {
         _lodChanged = false;
     }
 
+    if (_lastClientHasInterestBox != hasInterestBox() || _lastClientInterestTypes != getInterestTypes() ||
+            (hasInterestBox() && (_lastClientInterestBox.getCorner() != getInterestBox().getCorner() ||
+                                  _lastClientInterestBox.getDimensions() != getInterestBox().getDimensions()))) {
+        _lastClientHasInterestBox = hasInterestBox();
+        _lastClientInterestBox = getInterestBox();
+        _lastClientInterestTypes = getInterestTypes();
+        _lodChanged = true;
+    }
+
     // When we first detect that the view stopped changing, we record this.
     // but we don't change it back to false until we've completely sent this
     // scene.
@@ -222,6 +238,12 @@ void OctreeQueryNode::setViewSent(bool viewSent) {
     if (viewSent) {
         _viewFrustumJustStoppedChanging = false;
         _lodChanged = false;
+
+        // a scene coarser than the client asked for was sent, the next one is a full scene a level finer
+        if (_joinCoarseLevels > 0) {
+            --_joinCoarseLevels;
+            _lodChanged = true;
+        }
     }
 }
 
@@ -294,6 +316,29 @@ void OctreeQueryNode::packetSent(const NLPacket& packet) {
     _sequenceNumber++;
 }
 
+void OctreeQueryNode::octreePacketSent() {
+    if (_isShuttingDown) {
+        return;
+    }
+
+    rememberLastOctreePayload();
+
+    // the history keeps the sent packet itself instead of a copy, and hands back the packet that fell out of it, which
+    // the next octree packet is written in. The deletes packets share the history, so those can't be reused.
+    auto recycledPacket = _sentPacketHistory.packetSent(_sequenceNumber, std::move(_octreePacket));
+    _sequenceNumber++;
+
+    if (recycledPacket && recycledPacket->getType() == _myPacketType) {
+        _octreePacket = std::move(recycledPacket);
+        OctreeSendThread::_totalRecycledPackets++;
+    } else {
+        _octreePacket = NLPacket::create(_myPacketType);
+        OctreeSendThread::_totalAllocatedPackets++;
+    }
+
+    writeOctreePacketHeader();
+}
+
 bool OctreeQueryNode::hasNextNackedPacket() const {
     return !_nackedSequenceNumbers.isEmpty();
 }
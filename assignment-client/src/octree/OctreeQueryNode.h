@@ -13,6 +13,7 @@
 #define hifi_OctreeQueryNode_h
 
 #include <iostream>
+#include <limits>
 
 #include <NodeData.h>
 #include <OctreeConstants.h>
@@ -20,6 +21,7 @@
 #include <OctreePacketData.h>
 #include <OctreeQuery.h>
 #include <OctreeSceneStats.h>
+#include "OctreeServerConsts.h"
 #include "SentPacketHistory.h"
 #include <qqueue.h>
 
@@ -73,10 +75,21 @@ public:
     bool moveShouldDump() const;
 
     quint64 getLastTimeBagEmpty() const { return _lastTimeBagEmpty; }
-    void setLastTimeBagEmpty() { _lastTimeBagEmpty = _sceneSendStartTime; }
+    void setLastTimeBagEmpty() { _lastTimeBagEmpty = std::min(_sceneSendStartTime, _oldestDeferredChange); }
+
+    // Servers can put off sending the change of an item to a viewer, for instance to update far moving items at a lower
+    // rate. The next scene then looks at everything that changed since the oldest change that was put off, and
+    // shouldSendItem() is expected to skip the items the viewer already has.
+    virtual bool shouldSendItem(const QUuid& itemID, quint64 itemLastChanged, float distance, bool isMoving) { return true; }
+    virtual void itemSent(const QUuid& itemID, quint64 itemLastChanged, int bytes) { }
+    void deferItem(quint64 itemLastChanged) { _oldestDeferredChange = std::min(_oldestDeferredChange, itemLastChanged); }
 
     bool hasLodChanged() const { return _lodChanged; }
 
+    // added to the client's boundary level adjust while the first scenes after joining are sent, see
+    // JOIN_SCENE_COARSE_LEVELS
+    int getJoinBoundaryLevelAdjust() const { return _joinCoarseLevels; }
+
     OctreeSceneStats stats;
 
     void dumpOutOfView();
@@ -86,12 +99,15 @@ public:
     unsigned int getlastOctreePacketLength() const { return _lastOctreePacketLength; }
     int getDuplicatePacketCount() const { return _duplicatePacketCount; }
 
-    void sceneStart(quint64 sceneSendStartTime) { _sceneSendStartTime = sceneSendStartTime; }
+    void sceneStart(quint64 sceneSendStartTime) {
+        _sceneSendStartTime = sceneSendStartTime;
+        _oldestDeferredChange = std::numeric_limits<quint64>::max();
+    }
 
     void nodeKilled();
     bool isShuttingDown() const { return _isShuttingDown; }
 
-    void octreePacketSent() { packetSent(*_octreePacket); }
+    void octreePacketSent(); // keeps the sent octree packet in the history and starts the next one
     void packetSent(const NLPacket& packet);
 
     OCTREE_PACKET_SEQUENCE getSequenceNumber() const { return _sequenceNumber; }
@@ -104,6 +120,9 @@ private:
     OctreeQueryNode(const OctreeQueryNode &);
     OctreeQueryNode& operator= (const OctreeQueryNode&);
 
+    void rememberLastOctreePayload();
+    void writeOctreePacketHeader();
+
     bool _viewSent { false };
     std::unique_ptr<NLPacket> _octreePacket;
     bool _octreePacketWaiting;
@@ -130,6 +149,12 @@ private:
     bool _lodChanged { false };
     bool _lodInitialized { false };
 
+    // a new region of interest is sent as a full scene, like a change of LOD
+    bool _lastClientHasInterestBox { false };
+    AABox _lastClientInterestBox;
+    quint32 _lastClientInterestTypes { ALL_INTEREST_TYPES };
+    int _joinCoarseLevels { JOIN_SCENE_COARSE_LEVELS };
+
     OCTREE_PACKET_SEQUENCE _sequenceNumber { 0 };
 
     quint64 _lastRootTimestamp { 0 };
@@ -141,6 +166,7 @@ private:
     QQueue<OCTREE_PACKET_SEQUENCE> _nackedSequenceNumbers;
 
     quint64 _sceneSendStartTime = 0;
+    quint64 _oldestDeferredChange { std::numeric_limits<quint64>::max() };
 
     std::array<char, udt::MAX_PACKET_SIZE> _lastOctreePayload;
 };
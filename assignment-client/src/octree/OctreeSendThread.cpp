@@ -128,6 +128,9 @@ AtomicUIntStat OctreeSendThread::_totalPackets { 0 };
 AtomicUIntStat OctreeSendThread::_totalSpecialBytes { 0 };
 AtomicUIntStat OctreeSendThread::_totalSpecialPackets { 0 };
 
+AtomicUIntStat OctreeSendThread::_totalAllocatedPackets { 0 };
+AtomicUIntStat OctreeSendThread::_totalRecycledPackets { 0 };
+
 
 int OctreeSendThread::handlePacketSend(SharedNodePointer node, OctreeQueryNode* nodeData, int& trueBytesSent,
                                        int& truePacketsSent, bool dontSuppressDuplicate) {
@@ -292,8 +295,7 @@ int OctreeSendThread::handlePacketSend(SharedNodePointer node, OctreeQueryNode*
         trueBytesSent += nodeData->getPacket().getPayloadSize();
         truePacketsSent++;
         packetsSent++;
-        nodeData->octreePacketSent();
-        nodeData->resetOctreePacket();
+        nodeData->octreePacketSent(); // also starts the next packet
     }
 
     return packetsSent;
@@ -336,7 +338,8 @@ int OctreeSendThread::packetDistributor(SharedNodePointer node, OctreeQueryNode*
     int targetSize = MAX_OCTREE_PACKET_DATA_SIZE;
     targetSize = nodeData->getAvailable() - sizeof(OCTREE_PACKET_INTERNAL_SECTION_SIZE);
 
-    _packetData.changeSettings(true, targetSize); // FIXME - eventually support only compressed packets
+    int compressionLevel = OctreePacketData::compressionLevelForPacketType(nodeData->getMyPacketType());
+    _packetData.changeSettings(true, targetSize, compressionLevel); // FIXME - eventually support only compressed packets
 
     // If the current view frustum has changed OR we have nothing to send, then search against
     // the current view frustum for things to send.
@@ -424,8 +427,11 @@ int OctreeSendThread::packetDistributor(SharedNodePointer node, OctreeQueryNode*
                     float octreeSizeScale = nodeData->getOctreeSizeScale();
                     int boundaryLevelAdjustClient = nodeData->getBoundaryLevelAdjust();
 
+                    // a client that is moving, or has only just joined, first gets the parts of the scene that look
+                    // largest to it
+                    int lowResAdjust = viewFrustumChanged ? LOW_RES_MOVING_ADJUST : NO_BOUNDARY_ADJUST;
                     int boundaryLevelAdjust = boundaryLevelAdjustClient +
-                                              (viewFrustumChanged ? LOW_RES_MOVING_ADJUST : NO_BOUNDARY_ADJUST);
+                                              std::max(lowResAdjust, nodeData->getJoinBoundaryLevelAdjust());
 
                     EncodeBitstreamParams params(INT_MAX, WANT_EXISTS_BITS, DONT_CHOP,
                                                  viewFrustumChanged,
@@ -434,14 +440,27 @@ int OctreeSendThread::packetDistributor(SharedNodePointer node, OctreeQueryNode*
                                                  isFullScene, &nodeData->stats, _myServer->getJurisdiction(),
                                                  &nodeData->extraEncodeData);
                     nodeData->copyCurrentViewFrustum(params.viewFrustum);
+                    params.hasInterestBox = nodeData->hasInterestBox();
+                    params.interestBox = nodeData->getInterestBox();
+                    params.interestTypes = nodeData->getInterestTypes();
                     if (viewFrustumChanged) {
                         nodeData->copyLastKnownViewFrustum(params.lastViewFrustum);
                     }
 
                     // Our trackSend() function is implemented by the server subclass, and will be called back
                     // during the encodeTreeBitstream() as new entities/data elements are sent
-                    params.trackSend = [this, node](const QUuid& dataID, quint64 dataEdited) {
-                        _myServer->trackSend(dataID, dataEdited, node->getUUID());
+                    params.trackSend = [this, node](const QUuid& dataID, quint64 dataEdited, bool sentAllData) {
+                        _myServer->trackSend(dataID, dataEdited, sentAllData, node->getUUID());
+                    };
+                    params.getLastSentAllData = [this, node](const QUuid& dataID) {
+                        return _myServer->getLastSentAllData(dataID, node->getUUID());
+                    };
+                    params.shouldSendItem = [nodeData](const QUuid& dataID, quint64 itemLastChanged,
+                                                       float distance, bool isMoving) {
+                        return nodeData->shouldSendItem(dataID, itemLastChanged, distance, isMoving);
+                    };
+                    params.itemSent = [nodeData](const QUuid& dataID, quint64 itemLastChanged, int bytes) {
+                        nodeData->itemSent(dataID, itemLastChanged, bytes);
                     };
 
                     // TODO: should this include the lock time or not? This stat is sent down to the client,
@@ -525,7 +544,7 @@ int OctreeSendThread::packetDistributor(SharedNodePointer node, OctreeQueryNode*
                     // a larger compressed size then uncompressed size
                     targetSize = nodeData->getAvailable() - sizeof(OCTREE_PACKET_INTERNAL_SECTION_SIZE) - COMPRESS_PADDING;
                 }
-                _packetData.changeSettings(true, targetSize); // will do reset - NOTE: Always compressed
+                _packetData.changeSettings(true, targetSize, compressionLevel); // will do reset - NOTE: Always compressed
 
             }
             OctreeServer::trackTreeWaitTime(lockWaitElapsedUsec);
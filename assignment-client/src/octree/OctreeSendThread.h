@@ -42,6 +42,10 @@ public:
     static AtomicUIntStat _totalSpecialBytes;
     static AtomicUIntStat _totalSpecialPackets;
 
+    // octree packets created for the next send, and ones reused from what fell out of a client's sent packet history
+    static AtomicUIntStat _totalAllocatedPackets;
+    static AtomicUIntStat _totalRecycledPackets;
+
     static AtomicUIntStat _usleepTime;
     static AtomicUIntStat _usleepCalls;
 
@@ -428,6 +428,9 @@ bool OctreeServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
         quint64 totalOutboundSpecialPackets = OctreeSendThread::_totalSpecialPackets;
         quint64 totalOutboundSpecialBytes = OctreeSendThread::_totalSpecialBytes;
 
+        quint64 totalAllocatedPackets = OctreeSendThread::_totalAllocatedPackets;
+        quint64 totalRecycledPackets = OctreeSendThread::_totalRecycledPackets;
+
         statsString += QString("          Total Clients Connected: %1 clients\r\n")
             .arg(locale.toString((uint)getCurrentClientCount()).rightJustified(COLUMN_WIDTH, ' '));
 
@@ -626,6 +629,11 @@ bool OctreeServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
             .arg(locale.toString((uint)totalOutboundSpecialBytes).rightJustified(COLUMN_WIDTH, ' '));
 
 
+        statsString += QString("          Total Allocated Packets: %1 packets\r\n")
+            .arg(locale.toString((uint)totalAllocatedPackets).rightJustified(COLUMN_WIDTH, ' '));
+        statsString += QString("           Total Recycled Packets: %1 packets\r\n")
+            .arg(locale.toString((uint)totalRecycledPackets).rightJustified(COLUMN_WIDTH, ' '));
+
         statsString += QString("               Total Wasted Bytes: %1 bytes\r\n")
             .arg(locale.toString((uint)totalWastedBytes).rightJustified(COLUMN_WIDTH, ' '));
         statsString += QString().sprintf("            Total OctalCode Bytes: %s bytes (%5.2f%%)\r\n",
@@ -1053,7 +1061,11 @@ void OctreeServer::readConfiguration() {
 
         qDebug() << "persistFilePath=" << _persistFilePath;
 
-        _persistAsFileType = "json.gz";
+        if (!readOptionString("persistAsFileType", settingsSectionObject, _persistAsFileType)
+            || !PERSIST_EXTENSIONS.contains(_persistAsFileType)) {
+            _persistAsFileType = "json.gz";
+        }
+        qDebug() << "persistAsFileType=" << _persistAsFileType;
 
         _persistInterval = OctreePersistThread::DEFAULT_PERSIST_INTERVAL;
         readOptionInt(QString("persistInterval"), settingsSectionObject, _persistInterval);
@@ -1491,6 +1503,8 @@ void OctreeServer::sendStatsPacket() {
     dataObject1["4. totalBytesOctalCodes"] = (double)OctreePacketData::getTotalBytesOfOctalCodes();
     dataObject1["5. totalBytesBitMasks"] = (double)OctreePacketData::getTotalBytesOfBitMasks();
     dataObject1["6. totalBytesBitMasks"] = (double)OctreePacketData::getTotalBytesOfColor();
+    dataObject1["7. totalAllocatedPackets"] = (double)OctreeSendThread::_totalAllocatedPackets;
+    dataObject1["8. totalRecycledPackets"] = (double)OctreeSendThread::_totalRecycledPackets;
 
     QJsonObject timingArray1;
     timingArray1["1. avgLoopTime"] = getAverageLoopTime();
@@ -1534,6 +1548,19 @@ void OctreeServer::sendStatsPacket() {
     
     QJsonObject statsObject;
     statsObject[QString(getMyServerName()) + "Server"] = jsonArray;
+
+    if (_octreeInboundPacketProcessor) {
+        QJsonObject metrics;
+        metrics["edit_process_usecs"] = _octreeInboundPacketProcessor->getProcessTimes().takeSnapshot().toJson();
+        metrics["edit_lock_wait_usecs"] = _octreeInboundPacketProcessor->getLockWaitTimes().takeSnapshot().toJson();
+        metrics["edit_queue_depth"] = _octreeInboundPacketProcessor->getQueueDepths().takeSnapshot().toJson();
+        statsObject[STATS_METRICS_KEY] = metrics;
+    }
+
+    QJsonObject jurisdictionLoad = getJurisdictionLoad();
+    if (!jurisdictionLoad.isEmpty()) {
+        statsObject[STATS_JURISDICTION_LOAD_KEY] = jurisdictionLoad;
+    }
     addPacketStatsAndSendStatsPacket(statsObject);
 }
 
@@ -17,6 +17,7 @@
 #include <QStringList>
 #include <QDateTime>
 #include <QtCore/QCoreApplication>
+#include <QtCore/QJsonObject>
 
 #include <HTTPManager.h>
 
@@ -79,7 +80,9 @@ public:
     virtual bool hasSpecialPacketsToSend(const SharedNodePointer& node) { return false; }
     virtual int sendSpecialPackets(const SharedNodePointer& node, OctreeQueryNode* queryNode, int& packetsSent) { return 0; }
     virtual QString serverSubclassStats() { return QString(); }
-    virtual void trackSend(const QUuid& dataID, quint64 dataLastEdited, const QUuid& viewerNode) { }
+    virtual QJsonObject getJurisdictionLoad() { return QJsonObject(); }
+    virtual void trackSend(const QUuid& dataID, quint64 dataLastEdited, bool sentAllData, const QUuid& viewerNode) { }
+    virtual quint64 getLastSentAllData(const QUuid& dataID, const QUuid& viewerNode) { return 0; }
     virtual void trackViewerGone(const QUuid& viewerNode) { }
 
     static float SKIP_TIME; // use this for trackXXXTime() calls for non-times
@@ -27,4 +27,10 @@ const int MAX_FILENAME_LENGTH = 1024;
 const int INTERVALS_PER_SECOND = 90;
 const int OCTREE_SEND_INTERVAL_USECS = (1000 * 1000)/INTERVALS_PER_SECOND;
 
+/// A client that just joined is first sent full scenes at this many levels coarser than the LOD it asked for, one
+/// level finer per completed scene. The coarse scenes only hold what is large on screen (big or nearby), so that
+/// arrives before the far away and small items. Each level up cuts the LOD distance in half, which leaves about an
+/// eighth of the items in range, so resending them in the finer scenes costs little.
+const int JOIN_SCENE_COARSE_LEVELS = 3;
+
 #endif // hifi_OctreeServerConsts_h
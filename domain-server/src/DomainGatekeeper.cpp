@@ -15,8 +15,11 @@
 #include <openssl/rsa.h>
 #include <openssl/x509.h>
 
+#include <QtCore/QRunnable>
+
 #include <AccountManager.h>
 #include <Assignment.h>
+#include <SharedUtil.h>
 
 #include "DomainServer.h"
 #include "DomainServerNodeData.h"
@@ -106,20 +109,24 @@ void DomainGatekeeper::processConnectRequestPacket(QSharedPointer<ReceivedMessag
     }
 
     if (node) {
-        // set the sending sock addr and node interest set on this node
-        DomainServerNodeData* nodeData = reinterpret_cast<DomainServerNodeData*>(node->getLinkedData());
-        nodeData->setSendingSockAddr(message->getSenderSockAddr());
-        nodeData->setNodeInterestSet(nodeConnection.interestList.toSet());
-        nodeData->setPlaceName(nodeConnection.placeName);
-
-        // signal that we just connected a node so the DomainServer can get it a list
-        // and broadcast its presence right away
-        emit connectedNode(node);
+        connectNode(node, nodeConnection);
     } else {
         qDebug() << "Refusing connection from node at" << message->getSenderSockAddr();
     }
 }
 
+void DomainGatekeeper::connectNode(const SharedNodePointer& node, const NodeConnectionData& nodeConnection) {
+    // set the sending sock addr and node interest set on this node
+    DomainServerNodeData* nodeData = reinterpret_cast<DomainServerNodeData*>(node->getLinkedData());
+    nodeData->setSendingSockAddr(nodeConnection.senderSockAddr);
+    nodeData->setNodeInterestSet(nodeConnection.interestList.toSet());
+    nodeData->setPlaceName(nodeConnection.placeName);
+
+    // signal that we just connected a node so the DomainServer can get it a list
+    // and broadcast its presence right away
+    emit connectedNode(node);
+}
+
 NodePermissions DomainGatekeeper::setPermissionsForUser(bool isLocalUser, QString verifiedUsername, const QHostAddress& senderAddress) {
     NodePermissions userPerms;
 
@@ -218,8 +225,8 @@ NodePermissions DomainGatekeeper::setPermissionsForUser(bool isLocalUser, QStrin
 
 void DomainGatekeeper::updateNodePermissions() {
     // If the permissions were changed on the domain-server webpage (and nothing else was), a restart isn't required --
-    // we reprocess the permissions map and update the nodes here.  The node list is frequently sent out to all
-    // the connected nodes, so these changes are propagated to other nodes.
+    // we reprocess the permissions map and update the nodes here.  The changed nodes are recorded in the domain list,
+    // so these changes are propagated to other nodes with their next list.
 
     QList<SharedNodePointer> nodesToKill;
 
@@ -251,6 +258,10 @@ void DomainGatekeeper::updateNodePermissions() {
             userPerms = setPermissionsForUser(isLocalUser, verifiedUsername, connectingAddr.getAddress());
         }
 
+        if (node->getPermissions().permissions != userPerms.permissions) {
+            // the nodes that know about this one are sent its new permissions with their next list
+            _server->recordDomainListChange(node);
+        }
         node->setPermissions(userPerms);
 
         if (!userPerms.can(NodePermissions::Permission::canConnectToDomain)) {
@@ -348,15 +359,14 @@ SharedNodePointer DomainGatekeeper::processAgentConnectRequest(const NodeConnect
             qDebug() << "stalling login because we have no username-signature:" << username;
 #endif
             return SharedNodePointer();
-        } else if (verifyUserSignature(username, usernameSignature, nodeConnection.senderSockAddr)) {
+        } else if (verifyUserSignature(username, usernameSignature, nodeConnection) == SignatureVerification::Verified) {
             // they sent us a username and the signature verifies it
             getGroupMemberships(username);
             verifiedUsername = username;
         } else {
-            // they sent us a username, but it didn't check out
-            requestUserPublicKey(username);
+            // they sent us a username, but it didn't check out yet, the pending ones are picked up once verified
 #ifdef WANT_DEBUG
-            qDebug() << "stalling login because signature verification failed:" << username;
+            qDebug() << "stalling login because signature verification failed or is pending:" << username;
 #endif
             return SharedNodePointer();
         }
@@ -460,72 +470,142 @@ SharedNodePointer DomainGatekeeper::addVerifiedNodeFromConnectRequest(const Node
     return newNode;
 }
 
-bool DomainGatekeeper::verifyUserSignature(const QString& username,
-                                           const QByteArray& usernameSignature,
-                                           const HifiSockAddr& senderSockAddr) {
-    // it's possible this user can be allowed to connect, but we need to check their username signature
-    auto lowerUsername = username.toLower();
-    QByteArray publicKeyArray = _userPublicKeys.value(lowerUsername);
-
-    const QUuid& connectionToken = _connectionTokenHash.value(lowerUsername);
+// Checks a username signature against the user's public key on the signature verification pool
+class UserSignatureVerifier : public QRunnable {
+public:
+    enum Result {
+        Verified,
+        SignatureMismatch,
+        UnusableKey
+    };
 
-    if (!publicKeyArray.isEmpty() && !connectionToken.isNull()) {
-        // if we do have a public key for the user, check for a signature match
+    UserSignatureVerifier(DomainGatekeeper* gatekeeper, const QString& lowerUsername, const QByteArray& usernameSignature,
+                          const QByteArray& publicKey, const QUuid& connectionToken) :
+        _gatekeeper(gatekeeper),
+        _lowerUsername(lowerUsername),
+        _usernameSignature(usernameSignature),
+        _publicKey(publicKey),
+        _connectionToken(connectionToken) {}
 
-        const unsigned char* publicKeyData = reinterpret_cast<const unsigned char*>(publicKeyArray.constData());
+    virtual void run() override {
+        const unsigned char* publicKeyData = reinterpret_cast<const unsigned char*>(_publicKey.constData());
 
         // first load up the public key into an RSA struct
-        RSA* rsaPublicKey = d2i_RSA_PUBKEY(NULL, &publicKeyData, publicKeyArray.size());
+        RSA* rsaPublicKey = d2i_RSA_PUBKEY(NULL, &publicKeyData, _publicKey.size());
 
-        QByteArray lowercaseUsernameUTF8 = lowerUsername.toUtf8();
-        QByteArray usernameWithToken = QCryptographicHash::hash(lowercaseUsernameUTF8.append(connectionToken.toRfc4122()),
+        QByteArray lowercaseUsernameUTF8 = _lowerUsername.toUtf8();
+        QByteArray usernameWithToken = QCryptographicHash::hash(lowercaseUsernameUTF8.append(_connectionToken.toRfc4122()),
                                                                 QCryptographicHash::Sha256);
 
+        int result = UnusableKey;
         if (rsaPublicKey) {
             int decryptResult = RSA_verify(NID_sha256,
                                            reinterpret_cast<const unsigned char*>(usernameWithToken.constData()),
                                            usernameWithToken.size(),
-                                           reinterpret_cast<const unsigned char*>(usernameSignature.constData()),
-                                           usernameSignature.size(),
+                                           reinterpret_cast<const unsigned char*>(_usernameSignature.constData()),
+                                           _usernameSignature.size(),
                                            rsaPublicKey);
+            result = (decryptResult == 1) ? Verified : SignatureMismatch;
+
+            // free up the public key, we don't need it anymore
+            RSA_free(rsaPublicKey);
+        }
 
-            if (decryptResult == 1) {
-                qDebug() << "Username signature matches for" << username;
+        QMetaObject::invokeMethod(_gatekeeper, "handleUserSignatureVerification", Qt::QueuedConnection,
+                                  Q_ARG(QString, _lowerUsername), Q_ARG(QByteArray, _usernameSignature), Q_ARG(int, result));
+    }
 
-                // free up the public key and remove connection token before we return
-                RSA_free(rsaPublicKey);
-                _connectionTokenHash.remove(username);
+private:
+    DomainGatekeeper* _gatekeeper;
+    QString _lowerUsername;
+    QByteArray _usernameSignature;
+    QByteArray _publicKey;
+    QUuid _connectionToken;
+};
+
+DomainGatekeeper::SignatureVerification DomainGatekeeper::verifyUserSignature(const QString& username,
+                                                                              const QByteArray& usernameSignature,
+                                                                              const NodeConnectionData& nodeConnection) {
+    // it's possible this user can be allowed to connect, but we need to check their username signature
+    auto lowerUsername = username.toLower();
 
-                return true;
+    // a signature the pool verified lets in the connect request it was checked for
+    auto verifiedSignature = _verifiedUserSignatures.find(lowerUsername);
+    if (verifiedSignature != _verifiedUserSignatures.end() && verifiedSignature.value() == usernameSignature) {
+        _verifiedUserSignatures.erase(verifiedSignature);
+        return SignatureVerification::Verified;
+    }
 
-            } else {
-                if (!senderSockAddr.isNull()) {
-                    qDebug() << "Error decrypting username signature for " << username << "- denying connection.";
-                    sendConnectionDeniedPacket("Error decrypting username signature.", senderSockAddr,
-                        DomainHandler::ConnectionRefusedReason::LoginError);
-                }
+    auto pendingVerification = _pendingSignatureVerifications.find(lowerUsername);
+    if (pendingVerification != _pendingSignatureVerifications.end()) {
+        // the user keeps checking in while the pool is on it, pick up with their latest request
+        if (pendingVerification->usernameSignature == usernameSignature) {
+            pendingVerification->nodeConnection = nodeConnection;
+        }
+        return SignatureVerification::Pending;
+    }
 
-                // free up the public key, we don't need it anymore
-                RSA_free(rsaPublicKey);
-            }
+    QByteArray publicKeyArray = _userPublicKeys.value(lowerUsername).key;
 
-        } else {
+    const QUuid& connectionToken = _connectionTokenHash.value(lowerUsername);
 
-            // we can't let this user in since we couldn't convert their public key to an RSA key we could use
-            if (!senderSockAddr.isNull()) {
-                qDebug() << "Couldn't convert data to RSA key for" << username << "- denying connection.";
-                sendConnectionDeniedPacket("Couldn't convert data to RSA key.", senderSockAddr,
-                    DomainHandler::ConnectionRefusedReason::LoginError);
-            }
+    if (!publicKeyArray.isEmpty() && !connectionToken.isNull()) {
+        // if we do have a public key for the user, check for a signature match off of the main thread
+        _pendingSignatureVerifications.insert(lowerUsername, { nodeConnection, username, usernameSignature });
+        _signatureVerificationPool.start(new UserSignatureVerifier(this, lowerUsername, usernameSignature,
+                                                                   publicKeyArray, connectionToken));
+        return SignatureVerification::Pending;
+    }
+
+    qDebug() << "Insufficient data to decrypt username signature - delaying connection.";
+
+    requestUserPublicKey(username); // no joy.  maybe next time?
+    return SignatureVerification::Failed;
+}
+
+void DomainGatekeeper::handleUserSignatureVerification(QString lowerUsername, QByteArray usernameSignature, int result) {
+    auto pendingVerification = _pendingSignatureVerifications.find(lowerUsername);
+    if (pendingVerification == _pendingSignatureVerifications.end()
+        || pendingVerification->usernameSignature != usernameSignature) {
+        return;
+    }
+    PendingSignatureVerification pending = pendingVerification.value();
+    _pendingSignatureVerifications.erase(pendingVerification);
+
+    const HifiSockAddr& senderSockAddr = pending.nodeConnection.senderSockAddr;
+
+    if (result == UserSignatureVerifier::Verified) {
+        qDebug() << "Username signature matches for" << pending.username;
+
+        // remove the connection token, then resume the connect request of the user
+        _connectionTokenHash.remove(lowerUsername);
+        _verifiedUserSignatures.insert(lowerUsername, usernameSignature);
+
+        SharedNodePointer node = processAgentConnectRequest(pending.nodeConnection, pending.username,
+                                                            pending.usernameSignature);
+        _verifiedUserSignatures.remove(lowerUsername);
+
+        if (node) {
+            connectNode(node, pending.nodeConnection);
+        } else {
+            qDebug() << "Refusing connection from node at" << senderSockAddr;
         }
+        return;
+    }
+
+    if (result == UserSignatureVerifier::SignatureMismatch) {
+        qDebug() << "Error decrypting username signature for " << pending.username << "- denying connection.";
+        sendConnectionDeniedPacket("Error decrypting username signature.", senderSockAddr,
+            DomainHandler::ConnectionRefusedReason::LoginError);
     } else {
-        if (!senderSockAddr.isNull()) {
-            qDebug() << "Insufficient data to decrypt username signature - delaying connection.";
-        }
+        // we can't let this user in since we couldn't convert their public key to an RSA key we could use
+        qDebug() << "Couldn't convert data to RSA key for" << pending.username << "- denying connection.";
+        sendConnectionDeniedPacket("Couldn't convert data to RSA key.", senderSockAddr,
+            DomainHandler::ConnectionRefusedReason::LoginError);
     }
 
-    requestUserPublicKey(username); // no joy.  maybe next time?
-    return false;
+    // their key may have just changed, don't wait for the cached one to expire
+    requestUserPublicKey(pending.username, true);
 }
 
 bool DomainGatekeeper::isWithinMaxCapacity() {
@@ -561,7 +641,7 @@ void DomainGatekeeper::preloadAllowedUserPublicKeys() {
     }
 }
 
-void DomainGatekeeper::requestUserPublicKey(const QString& username) {
+void DomainGatekeeper::requestUserPublicKey(const QString& username, bool force) {
     // don't request public keys for the standard psuedo-account-names
     if (NodePermissions::standardNames.contains(username, Qt::CaseInsensitive)) {
         return;
@@ -572,9 +652,15 @@ void DomainGatekeeper::requestUserPublicKey(const QString& username) {
         // public-key request for this username is already flight, not rerequesting
         return;
     }
+
+    // a recently fetched key is used as is, it is fetched again when a signature doesn't verify with it
+    static const quint64 PUBLIC_KEY_TTL_USECS = 10 * 60 * USECS_PER_SECOND;
+    auto publicKey = _userPublicKeys.find(lowerUsername);
+    if (!force && publicKey != _userPublicKeys.end() && usecTimestampNow() - publicKey->fetchedAt < PUBLIC_KEY_TTL_USECS) {
+        return;
+    }
     _inFlightPublicKeyRequests += lowerUsername;
 
-    // even if we have a public key for them right now, request a new one in case it has just changed
     JSONCallbackParameters callbackParams;
     callbackParams.jsonCallbackReceiver = this;
     callbackParams.jsonCallbackMethod = "publicKeyJSONCallback";
@@ -611,8 +697,9 @@ void DomainGatekeeper::publicKeyJSONCallback(QNetworkReply& requestReply) {
         const QString JSON_DATA_KEY = "data";
         const QString JSON_PUBLIC_KEY_KEY = "public_key";
 
-        _userPublicKeys[username.toLower()] =
-            QByteArray::fromBase64(jsonObject[JSON_DATA_KEY].toObject()[JSON_PUBLIC_KEY_KEY].toString().toUtf8());
+        UserPublicKey& publicKey = _userPublicKeys[username.toLower()];
+        publicKey.key = QByteArray::fromBase64(jsonObject[JSON_DATA_KEY].toObject()[JSON_PUBLIC_KEY_KEY].toString().toUtf8());
+        publicKey.fetchedAt = usecTimestampNow();
     }
 
     _inFlightPublicKeyRequests.remove(username);
@@ -769,10 +856,18 @@ void DomainGatekeeper::processICEPingReplyPacket(QSharedPointer<ReceivedMessage>
     }
 }
 
-void DomainGatekeeper::getGroupMemberships(const QString& username) {
+void DomainGatekeeper::getGroupMemberships(const QString& username, bool force) {
     // loop through the groups mentioned on the settings page and ask if this user is in each.  The replies
     // will be received asynchronously and permissions will be updated as the answers come in.
 
+    // memberships fetched a moment ago, by the previous connect request or the last refresh, are still good
+    static const quint64 GROUP_MEMBERSHIPS_TTL_USECS = 60 * USECS_PER_SECOND;
+    auto fetchedAt = _groupMembershipsFetchedAt.find(username.toLower());
+    if (!force && fetchedAt != _groupMembershipsFetchedAt.end()
+        && usecTimestampNow() - fetchedAt.value() < GROUP_MEMBERSHIPS_TTL_USECS) {
+        return;
+    }
+
     QJsonObject json;
     QSet<QString> groupIDSet;
     foreach (QUuid groupID, _server->_settingsManager.getGroupIDs() + _server->_settingsManager.getBlacklistGroupIDs()) {
@@ -851,6 +946,7 @@ void DomainGatekeeper::getIsGroupMemberJSONCallback(QNetworkReply& requestReply)
             QUuid rankID = QUuid(rank["id"].toString());
             _server->_settingsManager.recordGroupMembership(username, groupID, rankID);
         }
+        _groupMembershipsFetchedAt[username.toLower()] = usecTimestampNow();
     } else {
         qDebug() << "getIsGroupMember api call returned:" << QJsonDocument(jsonObject).toJson(QJsonDocument::Compact);
     }
@@ -917,6 +1013,7 @@ void DomainGatekeeper::refreshGroupsCache() {
     nodeList->eachNode([&](const SharedNodePointer& node) {
         if (!node->getPermissions().isAssignment) {
             // this node is an agent
+            // only the memberships that have outlived their TTL are asked for again, spreading out the requests
             const QString& verifiedUserName = node->getPermissions().getVerifiedUserName();
             if (!verifiedUserName.isEmpty()) {
                 getGroupMemberships(verifiedUserName);
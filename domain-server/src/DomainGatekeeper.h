@@ -17,6 +17,7 @@
 #include <unordered_map>
 
 #include <QtCore/QObject>
+#include <QtCore/QThreadPool>
 #include <QtNetwork/QNetworkReply>
 
 #include <DomainHandler.h>
@@ -61,6 +62,8 @@ public slots:
 
     void refreshGroupsCache();
 
+    void handleUserSignatureVerification(QString lowerUsername, QByteArray usernameSignature, int result);
+
 signals:
     void killNode(SharedNodePointer node);
     void connectedNode(SharedNodePointer node);
@@ -78,9 +81,15 @@ private:
                                                  const QByteArray& usernameSignature);
     SharedNodePointer addVerifiedNodeFromConnectRequest(const NodeConnectionData& nodeConnection,
                                                         QUuid nodeID = QUuid());
-    
-    bool verifyUserSignature(const QString& username, const QByteArray& usernameSignature,
-                             const HifiSockAddr& senderSockAddr);
+    void connectNode(const SharedNodePointer& node, const NodeConnectionData& nodeConnection);
+
+    enum class SignatureVerification {
+        Verified,
+        Pending,
+        Failed
+    };
+    SignatureVerification verifyUserSignature(const QString& username, const QByteArray& usernameSignature,
+                                              const NodeConnectionData& nodeConnection);
     bool isWithinMaxCapacity();
     
     bool shouldAllowConnectionFromNode(const QString& username, const QByteArray& usernameSignature,
@@ -93,7 +102,7 @@ private:
     
     void pingPunchForConnectingPeer(const SharedNetworkPeer& peer);
     
-    void requestUserPublicKey(const QString& username);
+    void requestUserPublicKey(const QString& username, bool force = false);
     
     DomainServer* _server;
     
@@ -102,16 +111,34 @@ private:
     QHash<QUuid, SharedNetworkPeer> _icePeers;
     
     QHash<QString, QUuid> _connectionTokenHash;
-    QHash<QString, QByteArray> _userPublicKeys;
+
+    struct UserPublicKey {
+        QByteArray key;
+        quint64 fetchedAt { 0 };
+    };
+    QHash<QString, UserPublicKey> _userPublicKeys;
     QSet<QString> _inFlightPublicKeyRequests; // keep track of which we've already asked for
     QSet<QString> _domainOwnerFriends; // keep track of friends of the domain owner
     QSet<QString> _inFlightGroupMembershipsRequests; // keep track of which we've already asked for
+    QHash<QString, quint64> _groupMembershipsFetchedAt; // so the memberships of a burst of joins are only asked once
+
+    // the connect request waiting on the worker pool to verify its username signature, by lowercase username
+    struct PendingSignatureVerification {
+        NodeConnectionData nodeConnection;
+        QString username;
+        QByteArray usernameSignature;
+    };
+    QHash<QString, PendingSignatureVerification> _pendingSignatureVerifications;
+    QHash<QString, QByteArray> _verifiedUserSignatures;
 
     NodePermissions setPermissionsForUser(bool isLocalUser, QString verifiedUsername, const QHostAddress& senderAddress);
 
-    void getGroupMemberships(const QString& username);
+    void getGroupMemberships(const QString& username, bool force = false);
     // void getIsGroupMember(const QString& username, const QUuid groupID);
     void getDomainOwnerFriendsList();
+
+    // last so that it waits for the verifications in flight before the rest of the gatekeeper goes away
+    QThreadPool _signatureVerificationPool;
 };
 
 
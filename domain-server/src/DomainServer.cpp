@@ -11,6 +11,7 @@
 
 #include "DomainServer.h"
 
+#include <algorithm>
 #include <memory>
 #include <random>
 
@@ -28,6 +29,7 @@
 #include <AccountManager.h>
 #include <BuildInfo.h>
 #include <DependencyManager.h>
+#include <Gzip.h>
 #include <HifiConfigVariantMap.h>
 #include <HTTPConnection.h>
 #include <LogUtils.h>
@@ -36,6 +38,7 @@
 #include <SettingHandle.h>
 #include <SharedUtil.h>
 #include <ShutdownEventListener.h>
+#include <Trace.h>
 #include <UUID.h>
 #include <LogHandler.h>
 #include <ServerPathUtils.h>
@@ -213,6 +216,13 @@ void DomainServer::parseCommandLine() {
     const QCommandLineOption masterConfigOption("master-config", "Deprecated config-file option");
     parser.addOption(masterConfigOption);
 
+    const QCommandLineOption traceOption("trace", "record a trace of all the threads from startup, to open in chrome://tracing",
+                                         "trace-file");
+    parser.addOption(traceOption);
+
+    const QCommandLineOption traceDurationOption("trace-duration", "seconds of the trace, 10 by default", "seconds");
+    parser.addOption(traceDurationOption);
+
 
     if (!parser.parse(QCoreApplication::arguments())) {
         qWarning() << parser.errorText() << endl;
@@ -241,6 +251,15 @@ void DomainServer::parseCommandLine() {
         _overrideDomainID = true;
         qDebug() << "domain-server ID is" << _overridingDomainID;
     }
+
+    if (parser.isSet(traceOption)) {
+        const int DEFAULT_TRACE_DURATION_SECONDS = 10;
+        int traceSeconds = DEFAULT_TRACE_DURATION_SECONDS;
+        if (parser.isSet(traceDurationOption)) {
+            traceSeconds = parser.value(traceDurationOption).toInt();
+        }
+        Tracer::record(parser.value(traceOption), traceSeconds);
+    }
 }
 
 DomainServer::~DomainServer() {
@@ -547,6 +566,13 @@ void DomainServer::setupNodeListAndAssignments() {
     // add whatever static assignments that have been parsed to the queue
     addStaticAssignmentsToQueue();
 
+    // watch the load the mixers report, to grow and shrink the avatar mixer shards past the configured ones
+    const int MIXER_LOAD_CHECK_INTERVAL_MSECS = 10 * MSECS_PER_SECOND;
+    _numConfiguredAvatarMixerShards = _avatarMixerShards.size();
+    _mixerLoadTimer = new QTimer(this);
+    connect(_mixerLoadTimer, &QTimer::timeout, this, &DomainServer::checkMixerLoad);
+    _mixerLoadTimer->start(MIXER_LOAD_CHECK_INTERVAL_MSECS);
+
     // set a custom packetVersionMatch as the verify packet operator for the udt::Socket
     nodeList->setPacketFilterOperator(&DomainServer::packetVersionMatch);
 }
@@ -726,7 +752,13 @@ void DomainServer::parseAssignmentConfigs(QSet<Assignment::Type>& excludedTypes)
 void DomainServer::addStaticAssignmentToAssignmentHash(Assignment* newAssignment) {
     qDebug() << "Inserting assignment" << *newAssignment << "to static assignment hash.";
     newAssignment->setIsStatic(true);
-    _allAssignments.insert(newAssignment->getUUID(), SharedAssignmentPointer(newAssignment));
+
+    SharedAssignmentPointer sharedAssignment(newAssignment);
+    _allAssignments.insert(newAssignment->getUUID(), sharedAssignment);
+
+    if (newAssignment->getType() == Assignment::AvatarMixerType) {
+        _avatarMixerShards.push_back(sharedAssignment);
+    }
 }
 
 void DomainServer::populateStaticScriptedAssignmentsFromSettings() {
@@ -824,10 +856,20 @@ void DomainServer::populateDefaultStaticAssignmentsExcludingTypes(const QSet<Ass
                 }
             }
             
+            int numAssignments = 1;
+            if (defaultedType == Assignment::AvatarMixerType) {
+                // a domain can split its avatars over several avatar mixer shards
+                static const QString AVATAR_MIXER_SHARDS_KEYPATH = "avatar_mixer.num_shards";
+                QVariant numShardsValue = _settingsManager.valueOrDefaultValueForKeyPath(AVATAR_MIXER_SHARDS_KEYPATH);
+                numAssignments = std::max(numShardsValue.toString().toInt(), 1);
+            }
+
             // type has not been set from a command line or config file config, use the default
-            // by clearing whatever exists and writing a single default assignment with no payload
-            Assignment* newAssignment = new Assignment(Assignment::CreateCommand, (Assignment::Type) defaultedType);
-            addStaticAssignmentToAssignmentHash(newAssignment);
+            // by clearing whatever exists and writing default assignments with no payload
+            for (int i = 0; i < numAssignments; ++i) {
+                Assignment* newAssignment = new Assignment(Assignment::CreateCommand, (Assignment::Type) defaultedType);
+                addStaticAssignmentToAssignmentHash(newAssignment);
+            }
         }
     }
 }
@@ -837,18 +879,33 @@ void DomainServer::processListRequestPacket(QSharedPointer<ReceivedMessage> mess
     QDataStream packetStream(message->getMessage());
     NodeConnectionData nodeRequestData = NodeConnectionData::fromDataStream(packetStream, message->getSenderSockAddr(), false);
 
-    // update this node's sockets in case they have changed
-    sendingNode->setPublicSocket(nodeRequestData.publicSockAddr);
-    sendingNode->setLocalSocket(nodeRequestData.localSockAddr);
+    // the version of the domain list this node already has, zero asks for the full list
+    quint32 knownListVersion = 0;
+    if (!packetStream.atEnd()) {
+        packetStream >> knownListVersion;
+    }
+
+    // update this node's sockets in case they have changed, the nodes that know about it need the new ones
+    if (sendingNode->getPublicSocket() != nodeRequestData.publicSockAddr
+        || sendingNode->getLocalSocket() != nodeRequestData.localSockAddr) {
+        sendingNode->setPublicSocket(nodeRequestData.publicSockAddr);
+        sendingNode->setLocalSocket(nodeRequestData.localSockAddr);
+        recordDomainListChange(sendingNode);
+    }
     
     // update the NodeInterestSet in case there have been any changes
     DomainServerNodeData* nodeData = reinterpret_cast<DomainServerNodeData*>(sendingNode->getLinkedData());
-    nodeData->setNodeInterestSet(nodeRequestData.interestList.toSet());
+    NodeSet nodeInterestSet = nodeRequestData.interestList.toSet();
+    if (nodeInterestSet != nodeData->getNodeInterestSet()) {
+        // the nodes of the types it is now interested in were never sent, resync with the full list
+        nodeData->setNodeInterestSet(nodeInterestSet);
+        knownListVersion = 0;
+    }
 
     // update the connecting hostname in case it has changed
     nodeData->setPlaceName(nodeRequestData.placeName);
 
-    sendDomainListToNode(sendingNode, message->getSenderSockAddr());
+    sendDomainListToNode(sendingNode, message->getSenderSockAddr(), knownListVersion);
 }
 
 unsigned int DomainServer::countConnectedUsers() {
@@ -908,6 +965,16 @@ QUrl DomainServer::oauthAuthorizationURL(const QUuid& stateUUID) {
 void DomainServer::handleConnectedNode(SharedNodePointer newNode) {
     DomainServerNodeData* nodeData = static_cast<DomainServerNodeData*>(newNode->getLinkedData());
 
+    // our other connected nodes are sent this node with the next list they ask for
+    recordDomainListChange(newNode);
+
+    if (_pendingAvatarMixerShard && nodeData->getAssignmentUUID() == _pendingAvatarMixerShard->getUUID()) {
+        // the shard we added is up, move its share of the agents over to it
+        _avatarMixerShards.push_back(_pendingAvatarMixerShard);
+        _pendingAvatarMixerShard.reset();
+        resyncAvatarMixerShards();
+    }
+
     // reply back to the user with a PacketType::DomainList
     sendDomainListToNode(newNode, nodeData->getSendingSockAddr());
 
@@ -915,14 +982,25 @@ void DomainServer::handleConnectedNode(SharedNodePointer newNode) {
     if (newNode->getType() == NodeType::Agent && !nodeData->wasAssigned()) {
         emit userConnected();
     }
-
-    // send out this node to our other connected nodes
-    broadcastNewNode(newNode);
 }
 
-void DomainServer::sendDomainListToNode(const SharedNodePointer& node, const HifiSockAddr &senderSockAddr) {
-    const int NUM_DOMAIN_LIST_EXTENDED_HEADER_BYTES = NUM_BYTES_RFC4122_UUID + NUM_BYTES_RFC4122_UUID + 2;
-    
+void DomainServer::sendDomainListToNode(const SharedNodePointer& node, const HifiSockAddr &senderSockAddr,
+                                        quint32 knownListVersion) {
+    const int NUM_DOMAIN_LIST_EXTENDED_HEADER_BYTES = NUM_BYTES_RFC4122_UUID + NUM_BYTES_RFC4122_UUID + 2
+        + sizeof(quint32);
+
+    DomainServerNodeData* nodeData = reinterpret_cast<DomainServerNodeData*>(node->getLinkedData());
+
+    // store the nodeInterestSet on this DomainServerNodeData, in case it has changed
+    auto& nodeInterestSet = nodeData->getNodeInterestSet();
+
+    // the nodes of an unauthenticated node are held back, so it is left at version zero to get them all later
+    quint32 listVersion = nodeData->isAuthenticated() ? _domainListVersion : 0;
+
+    // only the changes since the version the node has are sent, unless they have dropped out of the change log
+    bool isDelta = listVersion != 0 && knownListVersion != 0 && knownListVersion >= _oldestDeltaListVersion
+        && knownListVersion <= _domainListVersion;
+
     // setup the extended header for the domain list packets
     // this data is at the beginning of each of the domain list packets
     QByteArray extendedHeader(NUM_DOMAIN_LIST_EXTENDED_HEADER_BYTES, 0);
@@ -933,38 +1011,70 @@ void DomainServer::sendDomainListToNode(const SharedNodePointer& node, const Hif
     extendedHeaderStream << limitedNodeList->getSessionUUID();
     extendedHeaderStream << node->getUUID();
     extendedHeaderStream << node->getPermissions();
+    extendedHeaderStream << listVersion;
 
-    auto domainListPackets = NLPacketList::create(PacketType::DomainList, extendedHeader);
+    // the list is sent reliably since the node takes the version as soon as one of its packets is in
+    auto domainListPackets = NLPacketList::create(PacketType::DomainList, extendedHeader, true);
 
     // always send the node their own UUID back
     QDataStream domainListStream(domainListPackets.get());
 
-    DomainServerNodeData* nodeData = reinterpret_cast<DomainServerNodeData*>(node->getLinkedData());
+    auto isNodeListedForNode = [&](const SharedNodePointer& otherNode) {
+        return otherNode->getUUID() != node->getUUID() && nodeInterestSet.contains(otherNode->getType())
+            && isNodeVisibleToNode(otherNode, node);
+    };
 
-    // store the nodeInterestSet on this DomainServerNodeData, in case it has changed
-    auto& nodeInterestSet = nodeData->getNodeInterestSet();
+    auto addNodeToList = [&](const SharedNodePointer& otherNode) {
+        // since we're about to add a node to the packet we start a segment
+        domainListPackets->startSegment();
 
-    if (nodeInterestSet.size() > 0) {
+        const bool isRemoved = false;
+        domainListStream << isRemoved;
 
-        // DTLSServerSession* dtlsSession = _isUsingDTLS ? _dtlsSessions[senderSockAddr] : NULL;
-        if (nodeData->isAuthenticated()) {
-            // if this authenticated node has any interest types, send back those nodes as well
-            limitedNodeList->eachNode([&](const SharedNodePointer& otherNode){
-                if (otherNode->getUUID() != node->getUUID() && nodeInterestSet.contains(otherNode->getType())) {
-                    
-                    // since we're about to add a node to the packet we start a segment
-                    domainListPackets->startSegment();
+        // don't send avatar nodes to other avatars, that will come from avatar mixer
+        domainListStream << *otherNode.data();
+
+        // pack the secret that these two nodes will use to communicate with each other
+        domainListStream << connectionSecretForNodes(node, otherNode);
 
-                    // don't send avatar nodes to other avatars, that will come from avatar mixer
-                    domainListStream << *otherNode.data();
+        // we've added the node we wanted so end the segment now
+        domainListPackets->endSegment();
+    };
 
-                    // pack the secret that these two nodes will use to communicate with each other
-                    domainListStream << connectionSecretForNodes(node, otherNode);
+    if (nodeInterestSet.size() > 0) {
 
-                    // we've added the node we wanted so end the segment now
-                    domainListPackets->endSegment();
+        // DTLSServerSession* dtlsSession = _isUsingDTLS ? _dtlsSessions[senderSockAddr] : NULL;
+        if (nodeData->isAuthenticated()) {
+            if (isDelta) {
+                // walk back the change log to the version the node has, each changed node goes out once
+                QSet<QUuid> changedNodes;
+                for (auto it = _domainListChanges.rbegin();
+                     it != _domainListChanges.rend() && it->version > knownListVersion; ++it) {
+                    if (changedNodes.contains(it->nodeUUID)) {
+                        continue;
+                    }
+                    changedNodes.insert(it->nodeUUID);
+
+                    SharedNodePointer otherNode = limitedNodeList->nodeWithUUID(it->nodeUUID);
+                    if (otherNode && isNodeListedForNode(otherNode)) {
+                        addNodeToList(otherNode);
+                    } else if (it->nodeUUID != node->getUUID() && nodeInterestSet.contains(it->nodeType)) {
+                        // the node is gone or no longer visible to this one, like an avatar mixer shard it moved off of,
+                        // nodes that never heard of it just ignore its removal
+                        domainListPackets->startSegment();
+                        const bool isRemoved = true;
+                        domainListStream << isRemoved << it->nodeUUID;
+                        domainListPackets->endSegment();
+                    }
                 }
-            });
+            } else {
+                // if this authenticated node has any interest types, send back those nodes as well
+                limitedNodeList->eachNode([&](const SharedNodePointer& otherNode){
+                    if (isNodeListedForNode(otherNode)) {
+                        addNodeToList(otherNode);
+                    }
+                });
+            }
         }
     }
     
@@ -975,6 +1085,18 @@ void DomainServer::sendDomainListToNode(const SharedNodePointer& node, const Hif
     limitedNodeList->sendPacketList(std::move(domainListPackets), *node);
 }
 
+void DomainServer::recordDomainListChange(const SharedNodePointer& node) {
+    static const size_t MAX_DOMAIN_LIST_CHANGES = 4096;
+
+    _domainListChanges.push_back({ ++_domainListVersion, node->getUUID(), node->getType() });
+
+    // the nodes with a version older than the log get the full list again
+    while (_domainListChanges.size() > MAX_DOMAIN_LIST_CHANGES) {
+        _oldestDeltaListVersion = _domainListChanges.front().version;
+        _domainListChanges.pop_front();
+    }
+}
+
 QUuid DomainServer::connectionSecretForNodes(const SharedNodePointer& nodeA, const SharedNodePointer& nodeB) {
     DomainServerNodeData* nodeAData = dynamic_cast<DomainServerNodeData*>(nodeA->getLinkedData());
     DomainServerNodeData* nodeBData = dynamic_cast<DomainServerNodeData*>(nodeB->getLinkedData());
@@ -996,41 +1118,139 @@ QUuid DomainServer::connectionSecretForNodes(const SharedNodePointer& nodeA, con
     return QUuid();
 }
 
-void DomainServer::broadcastNewNode(const SharedNodePointer& addedNode) {
+bool DomainServer::isNodeVisibleToNode(const SharedNodePointer& otherNode, const SharedNodePointer& node) {
+    if (otherNode->getType() != NodeType::AvatarMixer || node->getType() != NodeType::Agent
+        || _avatarMixerShards.size() <= 1) {
+        return true;
+    }
 
-    auto limitedNodeList = DependencyManager::get<LimitedNodeList>();
+    // with several avatar mixer shards an agent is only told about the one its session UUID hashes to
+    DomainServerNodeData* mixerData = reinterpret_cast<DomainServerNodeData*>(otherNode->getLinkedData());
+    if (!mixerData) {
+        return false;
+    }
+
+    for (int shardIndex = 0; shardIndex < _avatarMixerShards.size(); ++shardIndex) {
+        if (_avatarMixerShards[shardIndex]->getUUID() == mixerData->getAssignmentUUID()) {
+            return (int)(qHash(node->getUUID()) % (uint)_avatarMixerShards.size()) == shardIndex;
+        }
+    }
 
-    auto addNodePacket = NLPacket::create(PacketType::DomainServerAddedNode);
+    // an avatar mixer we did not hand out as a shard, tell everyone about it like before
+    return true;
+}
+
+void DomainServer::resyncAvatarMixerShards() {
+    // the agents get the shard their session now hashes to, and lose the one they were on, with their next list
+    DependencyManager::get<LimitedNodeList>()->eachNode([this](const SharedNodePointer& node) {
+        if (node->getType() == NodeType::AvatarMixer) {
+            recordDomainListChange(node);
+        }
+    });
+}
 
-    // setup the add packet for this new node
-    QDataStream addNodeStream(addNodePacket.get());
+void DomainServer::checkMixerLoad() {
+    // a mixer is busy for the part of its frames it doesn't sleep in, sustained over a few checks
+    const float BUSY_MIXER_LOAD = 75.0f;
+    const float IDLE_MIXER_LOAD = 25.0f;
+    const int NUM_LOAD_CHECKS_TO_SCALE = 3;
 
-    addNodeStream << *addedNode.data();
+    auto limitedNodeList = DependencyManager::get<LimitedNodeList>();
 
-    int connectionSecretIndex = addNodePacket->pos();
+    if (_drainingAvatarMixerShard) {
+        // its agents moved off at the last check, drop the assignment so it isn't handed out again and let it go
+        QUuid drainedAssignmentUUID = _drainingAvatarMixerShard->getUUID();
+        _allAssignments.remove(drainedAssignmentUUID);
+        _unfulfilledAssignments.removeAll(_drainingAvatarMixerShard);
+        _drainingAvatarMixerShard.reset();
 
-    limitedNodeList->eachMatchingNode(
-        [&](const SharedNodePointer& node)->bool {
-            if (node->getLinkedData() && node->getActiveSocket() && node != addedNode) {
-                // is the added Node in this node's interest list?
-                DomainServerNodeData* nodeData = dynamic_cast<DomainServerNodeData*>(node->getLinkedData());
-                return nodeData->getNodeInterestSet().contains(addedNode->getType());
-            } else {
-                return false;
+        // kill it outside of the node list iteration
+        SharedNodePointer drainedNode;
+        limitedNodeList->eachNode([&](const SharedNodePointer& node) {
+            auto nodeData = static_cast<DomainServerNodeData*>(node->getLinkedData());
+            if (nodeData && nodeData->getAssignmentUUID() == drainedAssignmentUUID) {
+                drainedNode = node;
             }
-        },
-        [&](const SharedNodePointer& node) {
-            addNodePacket->seek(connectionSecretIndex);
+        });
+        if (drainedNode) {
+            qDebug() << "Stopping drained avatar mixer shard" << drainedNode->getUUID();
+            handleKillNode(drainedNode);
+        }
+    }
 
-            QByteArray rfcConnectionSecret = connectionSecretForNodes(node, addedNode).toRfc4122();
+    _mixerLoads.clear();
+    float sumShardLoads = 0.0f;
+    int numLoadedShards = 0;
 
-            // replace the bytes at the end of the packet for the connection secret between these nodes
-            addNodePacket->write(rfcConnectionSecret);
+    limitedNodeList->eachNode([&](const SharedNodePointer& node) {
+        if (node->getType() != NodeType::AvatarMixer && node->getType() != NodeType::AudioMixer) {
+            return;
+        }
+        auto nodeData = static_cast<DomainServerNodeData*>(node->getLinkedData());
+        QJsonObject stats = nodeData->getStatsJSONObject();
+        if (!stats.contains("trailing_sleep_percentage")) {
+            return;
+        }
 
-            // send off this packet to the node
-            limitedNodeList->sendUnreliablePacket(*addNodePacket, *node);
+        float load = 100.0f - (float)stats["trailing_sleep_percentage"].toDouble();
+        _mixerLoads[node->getUUID()] = load;
+
+        if (node->getType() == NodeType::AudioMixer) {
+            // the audio mixer can't be sharded, its stream budget and HRTF struggle renders are all it has
+            if (load >= BUSY_MIXER_LOAD) {
+                qDebug() << "Audio mixer" << node->getUUID() << "is busy for" << load << "% of its frames with"
+                    << stats["mix_stats"].toObject()["%_hrtf_struggle_mixes"].toString() << "% struggling HRTF mixes";
+            }
+            return;
+        }
+
+        for (auto& shard : _avatarMixerShards) {
+            if (shard->getUUID() == nodeData->getAssignmentUUID()) {
+                sumShardLoads += load;
+                ++numLoadedShards;
+                break;
+            }
         }
-    );
+    });
+
+    static const QString AVATAR_MIXER_MAX_SHARDS_KEYPATH = "avatar_mixer.max_shards";
+    int maxShards = _settingsManager.valueOrDefaultValueForKeyPath(AVATAR_MIXER_MAX_SHARDS_KEYPATH).toString().toInt();
+
+    if (maxShards <= _numConfiguredAvatarMixerShards || numLoadedShards == 0
+        || _pendingAvatarMixerShard || _drainingAvatarMixerShard) {
+        // not scaling, or still waiting on the last change
+        _numBusyMixerLoadChecks = 0;
+        _numIdleMixerLoadChecks = 0;
+        return;
+    }
+
+    float averageShardLoad = sumShardLoads / numLoadedShards;
+    _numBusyMixerLoadChecks = (averageShardLoad >= BUSY_MIXER_LOAD) ? _numBusyMixerLoadChecks + 1 : 0;
+    _numIdleMixerLoadChecks = (averageShardLoad <= IDLE_MIXER_LOAD) ? _numIdleMixerLoadChecks + 1 : 0;
+
+    if (_numBusyMixerLoadChecks >= NUM_LOAD_CHECKS_TO_SCALE && _avatarMixerShards.size() < maxShards) {
+        // queue another shard, a spare child of an assignment-client monitor picks it up and the monitor forks a new spare
+        qDebug() << "Avatar mixer shards are busy for" << averageShardLoad << "% of their frames, adding shard"
+            << _avatarMixerShards.size() + 1;
+
+        Assignment* newAssignment = new Assignment(Assignment::CreateCommand, Assignment::AvatarMixerType);
+        newAssignment->setIsStatic(true);
+        _pendingAvatarMixerShard = SharedAssignmentPointer(newAssignment);
+        _allAssignments.insert(newAssignment->getUUID(), _pendingAvatarMixerShard);
+        _unfulfilledAssignments.enqueue(_pendingAvatarMixerShard);
+
+        _numBusyMixerLoadChecks = 0;
+    } else if (_numIdleMixerLoadChecks >= NUM_LOAD_CHECKS_TO_SCALE
+               && _avatarMixerShards.size() > _numConfiguredAvatarMixerShards) {
+        // move the agents off of the last added shard, it is stopped at the next check
+        qDebug() << "Avatar mixer shards are busy for" << averageShardLoad << "% of their frames, draining shard"
+            << _avatarMixerShards.size();
+
+        _drainingAvatarMixerShard = _avatarMixerShards.takeLast();
+        resyncAvatarMixerShards();
+
+        _numIdleMixerLoadChecks = 0;
+    }
 }
 
 void DomainServer::processRequestAssignmentPacket(QSharedPointer<ReceivedMessage> message) {
@@ -1575,6 +1795,134 @@ QJsonObject DomainServer::jsonObjectForNode(const SharedNodePointer& node) {
     return nodeJson;
 }
 
+void DomainServer::updateStatsSnapshot() {
+    static const quint64 STATS_SNAPSHOT_MAX_AGE_USECS = USECS_PER_SECOND;
+
+    quint64 now = usecTimestampNow();
+    if (now - _statsSnapshotTimestamp < STATS_SNAPSHOT_MAX_AGE_USECS) {
+        return;
+    }
+    _statsSnapshotTimestamp = now;
+
+    auto nodeList = DependencyManager::get<LimitedNodeList>();
+
+    QJsonArray nodesJSONArray;
+    QJsonObject assignedNodesJSON;
+    QHash<QString, int> nodeTypeCounts;
+    QByteArray nodeUptimes;
+    QMap<QString, QByteArray> nodeHistograms; // the lines of each histogram the nodes report, by metric name
+    QByteArray jurisdictionLoads;
+
+    // enumerate the NodeList once for the nodes, the assigned nodes and the metrics
+    nodeList->eachNode([&](const SharedNodePointer& node){
+        QJsonObject nodeJSON = jsonObjectForNode(node);
+        nodesJSONArray.append(nodeJSON);
+
+        DomainServerNodeData* nodeData = reinterpret_cast<DomainServerNodeData*>(node->getLinkedData());
+        if (!nodeData->getAssignmentUUID().isNull()) {
+            // add the node using the UUID as the key
+            QString uuidString = uuidStringWithoutCurlyBraces(nodeData->getAssignmentUUID());
+            assignedNodesJSON[uuidString] = nodeJSON;
+        }
+
+        QString nodeTypeName = nodeJSON[JSON_KEY_TYPE].toString();
+        ++nodeTypeCounts[nodeTypeName];
+        nodeUptimes += QString("domain_server_node_uptime_seconds{uuid=\"%1\",type=\"%2\"} %3\n")
+            .arg(nodeJSON[JSON_KEY_UUID].toString()).arg(nodeTypeName).arg(nodeJSON[JSON_KEY_UPTIME].toString()).toUtf8();
+
+        // the Histogram snapshots of the node, as summaries
+        QJsonObject histograms = nodeData->getStatsJSONObject()[STATS_METRICS_KEY].toObject();
+        for (auto it = histograms.constBegin(); it != histograms.constEnd(); ++it) {
+            QJsonObject histogram = it.value().toObject();
+            QString name = "hifi_" + it.key();
+            QString labels = QString("uuid=\"%1\",type=\"%2\"").arg(nodeJSON[JSON_KEY_UUID].toString()).arg(nodeTypeName);
+            QByteArray& lines = nodeHistograms[name];
+            lines += QString("%1{%2,quantile=\"0.5\"} %3\n").arg(name, labels).arg(histogram["p50"].toDouble()).toUtf8();
+            lines += QString("%1{%2,quantile=\"0.99\"} %3\n").arg(name, labels).arg(histogram["p99"].toDouble()).toUtf8();
+            lines += QString("%1{%2,quantile=\"0.999\"} %3\n").arg(name, labels).arg(histogram["p999"].toDouble()).toUtf8();
+            lines += QString("%1_count{%2} %3\n").arg(name, labels).arg(histogram["count"].toDouble()).toUtf8();
+        }
+
+        // the entities in each octant of the entity servers' jurisdictions, to see which ones to split
+        QJsonObject jurisdictionLoad = nodeData->getStatsJSONObject()[STATS_JURISDICTION_LOAD_KEY].toObject();
+        for (auto it = jurisdictionLoad.constBegin(); it != jurisdictionLoad.constEnd(); ++it) {
+            jurisdictionLoads += QString("domain_server_jurisdiction_entities{uuid=\"%1\",octant=\"%2\"} %3\n")
+                .arg(nodeJSON[JSON_KEY_UUID].toString()).arg(it.key()).arg(it.value().toDouble()).toUtf8();
+        }
+    });
+
+    QJsonObject nodesJSON;
+    nodesJSON["nodes"] = nodesJSONArray;
+    _nodesSnapshot = { QJsonDocument(nodesJSON).toJson(), QByteArray() };
+
+    QJsonObject queuedAssignmentsJSON;
+
+    // add the queued but unfilled assignments to the json
+    foreach(const SharedAssignmentPointer& assignment, _unfulfilledAssignments) {
+        QJsonObject queuedAssignmentJSON;
+
+        QString uuidString = uuidStringWithoutCurlyBraces(assignment->getUUID());
+        queuedAssignmentJSON[JSON_KEY_TYPE] = QString(assignment->getTypeName());
+
+        // if the assignment has a pool, add it
+        if (!assignment->getPool().isEmpty()) {
+            queuedAssignmentJSON[JSON_KEY_POOL] = assignment->getPool();
+        }
+
+        // add this queued assignment to the JSON
+        queuedAssignmentsJSON[uuidString] = queuedAssignmentJSON;
+    }
+
+    QJsonObject assignmentJSON;
+    assignmentJSON["fulfilled"] = assignedNodesJSON;
+    assignmentJSON["queued"] = queuedAssignmentsJSON;
+    _assignmentsSnapshot = { QJsonDocument(assignmentJSON).toJson(), QByteArray() };
+
+    QByteArray metrics;
+    metrics += "# TYPE domain_server_nodes gauge\n";
+    for (auto it = nodeTypeCounts.constBegin(); it != nodeTypeCounts.constEnd(); ++it) {
+        metrics += QString("domain_server_nodes{type=\"%1\"} %2\n").arg(it.key()).arg(it.value()).toUtf8();
+    }
+    metrics += "# TYPE domain_server_users gauge\n";
+    metrics += QString("domain_server_users %1\n").arg(countConnectedUsers()).toUtf8();
+    metrics += "# TYPE domain_server_queued_assignments gauge\n";
+    metrics += QString("domain_server_queued_assignments %1\n").arg(_unfulfilledAssignments.size()).toUtf8();
+    metrics += "# TYPE domain_server_domain_list_version counter\n";
+    metrics += QString("domain_server_domain_list_version %1\n").arg(_domainListVersion).toUtf8();
+    metrics += "# TYPE domain_server_avatar_mixer_shards gauge\n";
+    metrics += QString("domain_server_avatar_mixer_shards %1\n").arg(_avatarMixerShards.size()).toUtf8();
+    metrics += "# TYPE domain_server_mixer_load_percentage gauge\n";
+    for (auto it = _mixerLoads.constBegin(); it != _mixerLoads.constEnd(); ++it) {
+        metrics += QString("domain_server_mixer_load_percentage{uuid=\"%1\"} %2\n")
+            .arg(uuidStringWithoutCurlyBraces(it.key())).arg(it.value()).toUtf8();
+    }
+    metrics += "# TYPE domain_server_node_uptime_seconds gauge\n";
+    metrics += nodeUptimes;
+    metrics += "# TYPE domain_server_jurisdiction_entities gauge\n";
+    metrics += jurisdictionLoads;
+    for (auto it = nodeHistograms.constBegin(); it != nodeHistograms.constEnd(); ++it) {
+        metrics += QString("# TYPE %1 summary\n").arg(it.key()).toUtf8();
+        metrics += it.value();
+    }
+    _metricsSnapshot = { metrics, QByteArray() };
+}
+
+void DomainServer::respondWithStatsSnapshot(HTTPConnection* connection, StatsSnapshotEntry& entry, const char* contentType) {
+    // the monitoring tools that accept it get the snapshot gzipped, compressed once for all of them
+    if (connection->requestHeaders().value("Accept-Encoding").contains("gzip")) {
+        if (entry.gzippedBody.isEmpty()) {
+            gzip(entry.body, entry.gzippedBody);
+        }
+        if (!entry.gzippedBody.isEmpty()) {
+            Headers headers;
+            headers.insert("Content-Encoding", "gzip");
+            connection->respond(HTTPConnection::StatusCode200, entry.gzippedBody, contentType, headers);
+            return;
+        }
+    }
+    connection->respond(HTTPConnection::StatusCode200, entry.body, contentType);
+}
+
 QDir pathForAssignmentScriptsDirectory() {
     static const QString SCRIPTS_DIRECTORY_NAME = "/scripts/";
 
@@ -1599,6 +1947,7 @@ bool DomainServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
 
     const QString URI_ASSIGNMENT = "/assignment";
     const QString URI_NODES = "/nodes";
+    const QString URI_METRICS = "/metrics";
     const QString URI_SETTINGS = "/settings";
 
     const QString UUID_REGEX_STRING = "[0-9a-f]{8}-[0-9a-f]{4}-[0-9a-f]{4}-[0-9a-f]{4}-[0-9a-f]{12}";
@@ -1673,47 +2022,8 @@ bool DomainServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
     if (connection->requestOperation() == QNetworkAccessManager::GetOperation) {
         if (url.path() == "/assignments.json") {
             // user is asking for json list of assignments
-
-            // setup the JSON
-            QJsonObject assignmentJSON;
-            QJsonObject assignedNodesJSON;
-
-            // enumerate the NodeList to find the assigned nodes
-            nodeList->eachNode([this, &assignedNodesJSON](const SharedNodePointer& node){
-                DomainServerNodeData* nodeData = reinterpret_cast<DomainServerNodeData*>(node->getLinkedData());
-
-                if (!nodeData->getAssignmentUUID().isNull()) {
-                    // add the node using the UUID as the key
-                    QString uuidString = uuidStringWithoutCurlyBraces(nodeData->getAssignmentUUID());
-                    assignedNodesJSON[uuidString] = jsonObjectForNode(node);
-                }
-            });
-
-            assignmentJSON["fulfilled"] = assignedNodesJSON;
-
-            QJsonObject queuedAssignmentsJSON;
-
-            // add the queued but unfilled assignments to the json
-            foreach(const SharedAssignmentPointer& assignment, _unfulfilledAssignments) {
-                QJsonObject queuedAssignmentJSON;
-
-                QString uuidString = uuidStringWithoutCurlyBraces(assignment->getUUID());
-                queuedAssignmentJSON[JSON_KEY_TYPE] = QString(assignment->getTypeName());
-
-                // if the assignment has a pool, add it
-                if (!assignment->getPool().isEmpty()) {
-                    queuedAssignmentJSON[JSON_KEY_POOL] = assignment->getPool();
-                }
-
-                // add this queued assignment to the JSON
-                queuedAssignmentsJSON[uuidString] = queuedAssignmentJSON;
-            }
-
-            assignmentJSON["queued"] = queuedAssignmentsJSON;
-
-            // print out the created JSON
-            QJsonDocument assignmentDocument(assignmentJSON);
-            connection->respond(HTTPConnection::StatusCode200, assignmentDocument.toJson(), qPrintable(JSON_MIME_TYPE));
+            updateStatsSnapshot();
+            respondWithStatsSnapshot(connection, _assignmentsSnapshot, qPrintable(JSON_MIME_TYPE));
 
             // we've processed this request
             return true;
@@ -1736,23 +2046,14 @@ bool DomainServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
 
             return true;
         } else if (url.path() == QString("%1.json").arg(URI_NODES)) {
-            // setup the JSON
-            QJsonObject rootJSON;
-            QJsonArray nodesJSONArray;
+            updateStatsSnapshot();
+            respondWithStatsSnapshot(connection, _nodesSnapshot, qPrintable(JSON_MIME_TYPE));
 
-            // enumerate the NodeList to find the assigned nodes
-            nodeList->eachNode([this, &nodesJSONArray](const SharedNodePointer& node){
-                // add the node using the UUID as the key
-                nodesJSONArray.append(jsonObjectForNode(node));
-            });
-
-            rootJSON["nodes"] = nodesJSONArray;
-
-            // print out the created JSON
-            QJsonDocument nodesDocument(rootJSON);
-
-            // send the response
-            connection->respond(HTTPConnection::StatusCode200, nodesDocument.toJson(), qPrintable(JSON_MIME_TYPE));
+            return true;
+        } else if (url.path() == URI_METRICS) {
+            // the same snapshot in the Prometheus text exposition format
+            updateStatsSnapshot();
+            respondWithStatsSnapshot(connection, _metricsSnapshot, "text/plain; version=0.0.4");
 
             return true;
         } else {
@@ -1766,17 +2067,12 @@ bool DomainServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
                 // see if we have a node that matches this ID
                 SharedNodePointer matchingNode = nodeList->nodeWithUUID(matchingUUID);
                 if (matchingNode) {
-                    // create a QJsonDocument with the stats QJsonObject
-                    QJsonObject statsObject =
-                        reinterpret_cast<DomainServerNodeData*>(matchingNode->getLinkedData())->getStatsJSONObject();
-
-                    // add the node type to the JSON data for output purposes
-                    statsObject["node_type"] = NodeType::getNodeTypeName(matchingNode->getType()).toLower().replace(' ', '-');
-
-                    QJsonDocument statsDocument(statsObject);
+                    // the stats are serialized once per stats packet from the node, however often they're asked for
+                    auto nodeData = reinterpret_cast<DomainServerNodeData*>(matchingNode->getLinkedData());
 
                     // send the response
-                    connection->respond(HTTPConnection::StatusCode200, statsDocument.toJson(), qPrintable(JSON_MIME_TYPE));
+                    connection->respond(HTTPConnection::StatusCode200, nodeData->getStatsJSON(matchingNode->getType()),
+                                        qPrintable(JSON_MIME_TYPE));
 
                     // tell the caller we processed the request
                     return true;
@@ -2148,6 +2444,9 @@ void DomainServer::nodeAdded(SharedNodePointer node) {
 }
 
 void DomainServer::nodeKilled(SharedNodePointer node) {
+    // the removal goes out with the domain lists of the nodes checking in
+    recordDomainListChange(node);
+
     // if this peer connected via ICE then remove them from our ICE peers hash
     _gatekeeper.removeICEPeer(node->getUUID());
 
@@ -2354,8 +2653,6 @@ void DomainServer::processNodeDisconnectRequestPacket(QSharedPointer<ReceivedMes
 
     qDebug() << "Received a disconnect request from node with UUID" << nodeUUID;
 
-    // we want to check what type this node was before going to kill it so that we can avoid sending the RemovedNode
-    // packet to nodes that don't care about this type
     auto nodeToKill = limitedNodeList->nodeWithUUID(nodeUUID);
 
     if (nodeToKill) {
@@ -2364,25 +2661,8 @@ void DomainServer::processNodeDisconnectRequestPacket(QSharedPointer<ReceivedMes
 }
 
 void DomainServer::handleKillNode(SharedNodePointer nodeToKill) {
-    auto nodeType = nodeToKill->getType();
-    auto limitedNodeList = DependencyManager::get<LimitedNodeList>();
-    const QUuid& nodeUUID = nodeToKill->getUUID();
-
-    limitedNodeList->killNodeWithUUID(nodeUUID);
-
-    static auto removedNodePacket = NLPacket::create(PacketType::DomainServerRemovedNode, NUM_BYTES_RFC4122_UUID);
-
-    removedNodePacket->reset();
-    removedNodePacket->write(nodeUUID.toRfc4122());
-
-    // broadcast out the DomainServerRemovedNode message
-    limitedNodeList->eachMatchingNode([&nodeType](const SharedNodePointer& otherNode) -> bool {
-        // only send the removed node packet to nodes that care about the type of node this was
-        auto nodeLinkedData = dynamic_cast<DomainServerNodeData*>(otherNode->getLinkedData());
-        return (nodeLinkedData != nullptr) && nodeLinkedData->getNodeInterestSet().contains(nodeType);
-    }, [&limitedNodeList](const SharedNodePointer& otherNode){
-        limitedNodeList->sendUnreliablePacket(*removedNodePacket, *otherNode);
-    });
+    // the nodes that know about this one are told it is gone with the next list they ask for
+    DependencyManager::get<LimitedNodeList>()->killNodeWithUUID(nodeToKill->getUUID());
 }
 
 void DomainServer::processICEServerHeartbeatDenialPacket(QSharedPointer<ReceivedMessage> message) {
@@ -12,6 +12,8 @@
 #ifndef hifi_DomainServer_h
 #define hifi_DomainServer_h
 
+#include <deque>
+
 #include <QtCore/QCoreApplication>
 #include <QtCore/QHash>
 #include <QtCore/QJsonObject>
@@ -84,6 +86,8 @@ private slots:
 
     void handleConnectedNode(SharedNodePointer newNode);
 
+    void checkMixerLoad();
+
     void handleTempDomainSuccess(QNetworkReply& requestReply);
     void handleTempDomainError(QNetworkReply& requestReply);
 
@@ -130,10 +134,13 @@ private:
 
     void handleKillNode(SharedNodePointer nodeToKill);
 
-    void sendDomainListToNode(const SharedNodePointer& node, const HifiSockAddr& senderSockAddr);
+    void sendDomainListToNode(const SharedNodePointer& node, const HifiSockAddr& senderSockAddr,
+                              quint32 knownListVersion = 0);
+    void recordDomainListChange(const SharedNodePointer& node);
 
     QUuid connectionSecretForNodes(const SharedNodePointer& nodeA, const SharedNodePointer& nodeB);
-    void broadcastNewNode(const SharedNodePointer& node);
+    bool isNodeVisibleToNode(const SharedNodePointer& otherNode, const SharedNodePointer& node);
+    void resyncAvatarMixerShards();
 
     void parseAssignmentConfigs(QSet<Assignment::Type>& excludedTypes);
     void addStaticAssignmentToAssignmentHash(Assignment* newAssignment);
@@ -157,6 +164,13 @@ private:
     QJsonObject jsonForSocket(const HifiSockAddr& socket);
     QJsonObject jsonObjectForNode(const SharedNodePointer& node);
 
+    struct StatsSnapshotEntry {
+        QByteArray body;
+        QByteArray gzippedBody;
+    };
+    void updateStatsSnapshot();
+    void respondWithStatsSnapshot(HTTPConnection* connection, StatsSnapshotEntry& entry, const char* contentType);
+
     void setupGroupCacheRefresh();
 
     SubnetList _acSubnetWhitelist;
@@ -168,8 +182,35 @@ private:
 
     QHash<QUuid, SharedAssignmentPointer> _allAssignments;
     QQueue<SharedAssignmentPointer> _unfulfilledAssignments;
+    QVector<SharedAssignmentPointer> _avatarMixerShards; // an agent only connects to the shard its session hashes to
+
+    // past the configured shards, avatar mixer shards are added while the avatar mixers stay busy and drained once idle
+    int _numConfiguredAvatarMixerShards { 0 };
+    SharedAssignmentPointer _pendingAvatarMixerShard;
+    SharedAssignmentPointer _drainingAvatarMixerShard;
+    int _numBusyMixerLoadChecks { 0 };
+    int _numIdleMixerLoadChecks { 0 };
+    QHash<QUuid, float> _mixerLoads; // percentage of the frame each mixer is busy for, by node UUID
+    QTimer* _mixerLoadTimer { nullptr };
     TransactionHash _pendingAssignmentCredits;
 
+    // every added, updated or removed node bumps the domain list version, so that a node checking in with the
+    // version it has is only sent the nodes that changed since, as long as they are still in the change log
+    struct DomainListChange {
+        quint32 version;
+        QUuid nodeUUID;
+        NodeType_t nodeType;
+    };
+    quint32 _domainListVersion { 1 };
+    quint32 _oldestDeltaListVersion { 1 };
+    std::deque<DomainListChange> _domainListChanges;
+
+    // the nodes, assignments and metrics served to the monitoring polls, serialized at most once a second
+    quint64 _statsSnapshotTimestamp { 0 };
+    StatsSnapshotEntry _nodesSnapshot;
+    StatsSnapshotEntry _assignmentsSnapshot;
+    StatsSnapshotEntry _metricsSnapshot;
+
     bool _isUsingDTLS;
 
     QUrl _oauthProviderURL;
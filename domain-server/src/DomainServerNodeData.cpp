@@ -25,10 +25,26 @@ DomainServerNodeData::DomainServerNodeData() {
     _paymentIntervalTimer.start();
 }
 
+const QByteArray& DomainServerNodeData::getStatsJSON(NodeType_t nodeType) {
+    if (_statsJSON.isEmpty()) {
+        auto document = QJsonDocument::fromBinaryData(_statsBinaryData);
+        QJsonObject statsObject = overrideValuesIfNeeded(document.object());
+
+        // add the node type to the JSON data for output purposes
+        statsObject["node_type"] = NodeType::getNodeTypeName(nodeType).toLower().replace(' ', '-');
+
+        _statsJSON = QJsonDocument(statsObject).toJson();
+    }
+    return _statsJSON;
+}
+
+QJsonObject DomainServerNodeData::getStatsJSONObject() const {
+    return QJsonDocument::fromBinaryData(_statsBinaryData).object();
+}
+
 void DomainServerNodeData::updateJSONStats(QByteArray statsByteArray) {
-    auto document = QJsonDocument::fromBinaryData(statsByteArray);
-    Q_ASSERT(document.isObject());
-    _statsJSONObject = overrideValuesIfNeeded(document.object());
+    _statsBinaryData = statsByteArray;
+    _statsJSON.clear();
 }
 
 QJsonObject DomainServerNodeData::overrideValuesIfNeeded(const QJsonObject& newStats) {
@@ -25,7 +25,9 @@ class DomainServerNodeData : public NodeData {
 public:
     DomainServerNodeData();
 
-    const QJsonObject& getStatsJSONObject() const { return _statsJSONObject; }
+    // the stats the node sent are only parsed and serialized when asked for, then kept until it sends new ones
+    const QByteArray& getStatsJSON(NodeType_t nodeType);
+    QJsonObject getStatsJSONObject() const;
 
     void updateJSONStats(QByteArray statsByteArray);
 
@@ -74,7 +76,8 @@ private:
     QElapsedTimer _paymentIntervalTimer;
     
     using StringPairHash = QHash<QPair<QString, QString>, QString>;
-    QJsonObject _statsJSONObject;
+    QByteArray _statsBinaryData;
+    QByteArray _statsJSON;
     static StringPairHash _overrideHash;
     
     HifiSockAddr _sendingSockAddr;
@@ -82,8 +82,7 @@ void DomainServerSettingsManager::processSettingsRequestPacket(QSharedPointer<Re
     Assignment::Type type;
     message->readPrimitive(&type);
 
-    QJsonObject responseObject = responseObjectForType(QString::number(type));
-    auto json = QJsonDocument(responseObject).toJson();
+    auto json = settingsJSONForType(QString::number(type));
 
     auto packetList = NLPacketList::create(PacketType::DomainSettings, QByteArray(), true, true);
 
@@ -725,8 +724,9 @@ QStringList DomainServerSettingsManager::getAllNames() const {
 }
 
 NodePermissions DomainServerSettingsManager::getStandardPermissionsForName(const NodePermissionsKey& name) const {
-    if (_standardAgentPermissions.contains(name)) {
-        return *(_standardAgentPermissions[name].get());
+    NodePermissionsPointer permissions = _standardAgentPermissions[name];
+    if (permissions) {
+        return *permissions;
     }
     NodePermissions nullPermissions;
     nullPermissions.setAll(false);
@@ -735,8 +735,9 @@ NodePermissions DomainServerSettingsManager::getStandardPermissionsForName(const
 
 NodePermissions DomainServerSettingsManager::getPermissionsForName(const QString& name) const {
     NodePermissionsKey nameKey = NodePermissionsKey(name, 0);
-    if (_agentPermissions.contains(nameKey)) {
-        return *(_agentPermissions[nameKey].get());
+    NodePermissionsPointer permissions = _agentPermissions[nameKey];
+    if (permissions) {
+        return *permissions;
     }
     NodePermissions nullPermissions;
     nullPermissions.setAll(false);
@@ -745,8 +746,9 @@ NodePermissions DomainServerSettingsManager::getPermissionsForName(const QString
 
 NodePermissions DomainServerSettingsManager::getPermissionsForIP(const QHostAddress& address) const {
     NodePermissionsKey ipKey = NodePermissionsKey(address.toString(), 0);
-    if (_ipPermissions.contains(ipKey)) {
-        return *(_ipPermissions[ipKey].get());
+    NodePermissionsPointer permissions = _ipPermissions[ipKey];
+    if (permissions) {
+        return *permissions;
     }
     NodePermissions nullPermissions;
     nullPermissions.setAll(false);
@@ -755,8 +757,9 @@ NodePermissions DomainServerSettingsManager::getPermissionsForIP(const QHostAddr
 
 NodePermissions DomainServerSettingsManager::getPermissionsForGroup(const QString& groupName, QUuid rankID) const {
     NodePermissionsKey groupRankKey = NodePermissionsKey(groupName, rankID);
-    if (_groupPermissions.contains(groupRankKey)) {
-        return *(_groupPermissions[groupRankKey].get());
+    NodePermissionsPointer permissions = _groupPermissions[groupRankKey];
+    if (permissions) {
+        return *permissions;
     }
     NodePermissions nullPermissions;
     nullPermissions.setAll(false);
@@ -776,8 +779,9 @@ NodePermissions DomainServerSettingsManager::getPermissionsForGroup(const QUuid&
 
 NodePermissions DomainServerSettingsManager::getForbiddensForGroup(const QString& groupName, QUuid rankID) const {
     NodePermissionsKey groupRankKey = NodePermissionsKey(groupName, rankID);
-    if (_groupForbiddens.contains(groupRankKey)) {
-        return *(_groupForbiddens[groupRankKey].get());
+    NodePermissionsPointer permissions = _groupForbiddens[groupRankKey];
+    if (permissions) {
+        return *permissions;
     }
     NodePermissions allForbiddens;
     allForbiddens.setAll(true);
@@ -836,9 +840,7 @@ bool DomainServerSettingsManager::handlePublicHTTPRequest(HTTPConnection* connec
         QString typeValue = settingsQuery.queryItemValue(SETTINGS_TYPE_QUERY_KEY);
 
         if (!typeValue.isEmpty()) {
-            QJsonObject responseObject = responseObjectForType(typeValue);
-
-            connection->respond(HTTPConnection::StatusCode200, QJsonDocument(responseObject).toJson(), "application/json");
+            connection->respond(HTTPConnection::StatusCode200, settingsJSONForType(typeValue), "application/json");
 
             return true;
         } else {
@@ -890,6 +892,15 @@ bool DomainServerSettingsManager::handleAuthenticatedHTTPRequest(HTTPConnection
     return false;
 }
 
+QByteArray DomainServerSettingsManager::settingsJSONForType(const QString& typeValue) {
+    // the assignment clients of a type ask for the same settings, often many at once when they restart together
+    auto it = _settingsJSONByType.find(typeValue);
+    if (it == _settingsJSONByType.end()) {
+        it = _settingsJSONByType.insert(typeValue, QJsonDocument(responseObjectForType(typeValue)).toJson());
+    }
+    return it.value();
+}
+
 QJsonObject DomainServerSettingsManager::responseObjectForType(const QString& typeValue, bool isAuthenticated) {
     QJsonObject responseObject;
 
@@ -1214,6 +1225,8 @@ void DomainServerSettingsManager::sortPermissions() {
 }
 
 void DomainServerSettingsManager::persistToFile() {
+    _settingsJSONByType.clear();
+
     sortPermissions();
 
     // make sure we have the dir the settings file is supposed to live in
@@ -110,6 +110,8 @@ private:
     QStringList _argumentList;
 
     QJsonObject responseObjectForType(const QString& typeValue, bool isAuthenticated = false);
+    // the serialized settings for an assignment type, cached until the settings change
+    QByteArray settingsJSONForType(const QString& typeValue);
     bool recurseJSONObjectAndOverwriteSettings(const QJsonObject& postedObject);
 
     void updateSetting(const QString& key, const QJsonValue& newValue, QVariantMap& settingMap,
@@ -121,6 +123,7 @@ private:
     double _descriptionVersion;
     QJsonArray _descriptionArray;
     HifiConfigVariantMap _configMap;
+    QHash<QString, QByteArray> _settingsJSONByType; // cleared by persistToFile, which every settings change goes through
 
     friend class DomainServer;
 
@@ -11,8 +11,12 @@
 
 #include "IceServer.h"
 
+#include <algorithm>
+#include <thread>
+
 #include <openssl/x509.h>
 
+#include <QtCore/QCommandLineParser>
 #include <QtCore/QJsonDocument>
 #include <QtCore/QTimer>
 #include <QtNetwork/QNetworkReply>
@@ -27,15 +31,54 @@
 const int CLEAR_INACTIVE_PEERS_INTERVAL_MSECS = 1 * 1000;
 const int PEER_SILENCE_THRESHOLD_MSECS = 5 * 1000;
 
+// a peer is never scheduled further than the silence threshold, so the wheel needs one slot past it
+const int NUM_EXPIRY_SLOTS = PEER_SILENCE_THRESHOLD_MSECS / CLEAR_INACTIVE_PEERS_INTERVAL_MSECS + 2;
+
+const int MAX_DEFAULT_RECEIVE_THREADS = 8;
+
 IceServer::IceServer(int argc, char* argv[]) :
     QCoreApplication(argc, argv),
     _id(QUuid::createUuid()),
-    _serverSocket(0, false),
-    _activePeers()
+    _serverSocket(0, false)
 {
-    // start the ice-server socket
-    qDebug() << "ice-server socket is listening on" << ICE_SERVER_DEFAULT_PORT;
-    _serverSocket.bind(QHostAddress::AnyIPv4, ICE_SERVER_DEFAULT_PORT);
+    QCommandLineParser parser;
+    parser.setApplicationDescription("High Fidelity ICE Server");
+    parser.addHelpOption();
+
+    const QCommandLineOption receiveThreadsOption("receive-threads",
+                                                  "number of threads receiving UDP packets (Linux only)", "thread-count");
+    parser.addOption(receiveThreadsOption);
+
+    const QCommandLineOption siblingsOption("siblings",
+                                            "comma separated host:port of the other ice-servers sharing the peer table",
+                                            "siblings");
+    parser.addOption(siblingsOption);
+
+    parser.process(*this);
+
+    int numReceiveThreads = std::min(std::max((int)std::thread::hardware_concurrency(), 1), MAX_DEFAULT_RECEIVE_THREADS);
+    if (parser.isSet(receiveThreadsOption)) {
+        numReceiveThreads = std::max(parser.value(receiveThreadsOption).toInt(), 1);
+    }
+
+    if (parser.isSet(siblingsOption)) {
+        for (auto& sibling : parser.value(siblingsOption).split(',', QString::SkipEmptyParts)) {
+            QString hostname = sibling.section(':', 0, 0);
+            quint16 port = sibling.contains(':') ? sibling.section(':', 1, 1).toUShort() : ICE_SERVER_DEFAULT_PORT;
+
+            HifiSockAddr siblingSockAddr { hostname, port, true };
+            if (siblingSockAddr.getAddress().isNull()) {
+                qWarning() << "Could not resolve the address of sibling ice-server" << sibling << "- it will be ignored.";
+            } else {
+                qDebug() << "Sharing the peer table with sibling ice-server" << siblingSockAddr;
+                _siblings.push_back(siblingSockAddr);
+            }
+        }
+    }
+
+    for (auto& shard : _peerShards) {
+        shard.expiryWheel.resize(NUM_EXPIRY_SLOTS);
+    }
 
     // set processPacket as the verified packet callback for the udt::Socket
     _serverSocket.setPacketHandler([this](std::unique_ptr<udt::Packet> packet) { processPacket(std::move(packet));  });
@@ -44,6 +87,11 @@ IceServer::IceServer(int argc, char* argv[]) :
     using std::placeholders::_1;
     _serverSocket.setPacketFilterOperator(std::bind(&IceServer::packetVersionMatch, this, _1));
 
+    // start the ice-server socket, once the handlers are set since the receive threads start handling packets right away
+    qDebug() << "ice-server socket is listening on" << ICE_SERVER_DEFAULT_PORT;
+    _serverSocket.setNumReceiveThreads(numReceiveThreads);
+    _serverSocket.bind(QHostAddress::AnyIPv4, ICE_SERVER_DEFAULT_PORT);
+
     // setup our timer to clear inactive peers
     QTimer* inactivePeerTimer = new QTimer(this);
     connect(inactivePeerTimer, &QTimer::timeout, this, &IceServer::clearInactivePeers);
@@ -68,27 +116,48 @@ bool IceServer::packetVersionMatch(const udt::Packet& packet) {
 void IceServer::processPacket(std::unique_ptr<udt::Packet> packet) {
 
     auto nlPacket = NLPacket::fromBase(std::move(packet));
-    
+
+    if (nlPacket->getType() == PacketType::ICEServerRelay) {
+        processRelayPacket(*nlPacket);
+    } else {
+        processPeerPacket(*nlPacket, HifiSockAddr());
+    }
+}
+
+void IceServer::processPeerPacket(NLPacket& packet, const HifiSockAddr& relayingSibling) {
+    // this can run on any of the socket threads at once - the state of a peer is only touched with its shard locked,
+    // and the RSA verification and the packet writes happen outside of the lock
+    bool isRelayed = !relayingSibling.isNull();
+
     // make sure that this packet at least looks like something we can read
-    if (nlPacket->getPayloadSize() >= NLPacket::localHeaderSize(PacketType::ICEServerHeartbeat)) {
+    if (packet.getPayloadSize() >= NLPacket::localHeaderSize(PacketType::ICEServerHeartbeat)) {
         
-        if (nlPacket->getType() == PacketType::ICEServerHeartbeat) {
-            SharedNetworkPeer peer = addOrUpdateHeartbeatingPeer(*nlPacket);
-            if (peer) {
-                // so that we can send packets to the heartbeating peer when we need, we need to activate a socket now
-                peer->activateMatchingOrNewSymmetricSocket(nlPacket->getSenderSockAddr());
+        if (packet.getType() == PacketType::ICEServerHeartbeat) {
+            bool isVerified = addOrUpdateHeartbeatingPeer(packet, relayingSibling);
+
+            if (isRelayed) {
+                // the sibling the peer heartbeats to has already answered it
+                return;
+            }
 
+            // the ACK and denied packets are created for each reply since several threads may be writing them
+            if (isVerified) {
                 // we have an active and verified heartbeating peer
                 // send them an ACK packet so they know that they are being heard and ready for ICE
-                static auto ackPacket = NLPacket::create(PacketType::ICEServerHeartbeatACK);
-                _serverSocket.writePacket(*ackPacket, nlPacket->getSenderSockAddr());
+                auto ackPacket = NLPacket::create(PacketType::ICEServerHeartbeatACK);
+                _serverSocket.writePacket(*ackPacket, packet.getSenderSockAddr());
+
+                // let our siblings know about this peer so that they can answer queries for it
+                for (auto& sibling : _siblings) {
+                    relayPacketToSibling(packet, sibling);
+                }
             } else {
                 // we couldn't verify this peer - respond back to them so they know they may need to perform keypair re-generation
-                static auto deniedPacket = NLPacket::create(PacketType::ICEServerHeartbeatDenied);
-                _serverSocket.writePacket(*deniedPacket, nlPacket->getSenderSockAddr());
+                auto deniedPacket = NLPacket::create(PacketType::ICEServerHeartbeatDenied);
+                _serverSocket.writePacket(*deniedPacket, packet.getSenderSockAddr());
             }
-        } else if (nlPacket->getType() == PacketType::ICEServerQuery) {
-            QDataStream heartbeatStream(nlPacket.get());
+        } else if (packet.getType() == PacketType::ICEServerQuery) {
+            QDataStream heartbeatStream(&packet);
             
             // this is a node hoping to connect to a heartbeating peer - do we have the heartbeating peer?
             QUuid senderUUID;
@@ -101,29 +170,89 @@ void IceServer::processPacket(std::unique_ptr<udt::Packet> packet) {
             // check if this node also included a UUID that they would like to connect to
             QUuid connectRequestID;
             heartbeatStream >> connectRequestID;
+
+            QByteArray matchingPeerInformation;
+            HifiSockAddr matchingPeerSocket;
+            HifiSockAddr matchingPeerSibling;
+
+            {
+                auto& shard = shardForPeer(connectRequestID);
+                std::lock_guard<std::mutex> lock(shard.mutex);
+
+                auto it = shard.activePeers.find(connectRequestID);
+                if (it != shard.activePeers.end()) {
+                    matchingPeerInformation = it->peer->toByteArray();
+                    matchingPeerSibling = it->relayingSibling;
+
+                    if (matchingPeerSibling.isNull() && it->peer->getActiveSocket()) {
+                        matchingPeerSocket = *it->peer->getActiveSocket();
+                    }
+                }
+            }
             
-            SharedNetworkPeer matchingPeer = _activePeers.value(connectRequestID);
-            
-            if (matchingPeer) {
-                
-                qDebug() << "Sending information for peer" << connectRequestID << "to peer" << senderUUID;
-                
-                // we have the peer they want to connect to - send them pack the information for that peer
-                sendPeerInformationPacket(*matchingPeer, &nlPacket->getSenderSockAddr());
-                
-                // we also need to send them to the active peer they are hoping to connect to
-                // create a dummy peer object we can pass to sendPeerInformationPacket
-                
-                NetworkPeer dummyPeer(senderUUID, publicSocket, localSocket);
-                sendPeerInformationPacket(dummyPeer, matchingPeer->getActiveSocket());
-            } else {
+            if (!matchingPeerInformation.isEmpty()) {
+
+                if (!isRelayed) {
+                    qDebug() << "Sending information for peer" << connectRequestID << "to peer" << senderUUID;
+
+                    // we have the peer they want to connect to - send them pack the information for that peer
+                    sendPeerInformationPacket(matchingPeerInformation, packet.getSenderSockAddr());
+                }
+
+                if (!matchingPeerSocket.isNull()) {
+                    // we also need to send them to the active peer they are hoping to connect to
+                    // create a dummy peer object we can pass to sendPeerInformationPacket
+                    NetworkPeer dummyPeer(senderUUID, publicSocket, localSocket);
+                    sendPeerInformationPacket(dummyPeer.toByteArray(), matchingPeerSocket);
+                } else if (!matchingPeerSibling.isNull() && !isRelayed) {
+                    // only the sibling the peer heartbeats to has a hole through the peer's NAT, it sends them the sender
+                    relayPacketToSibling(packet, matchingPeerSibling);
+                }
+            } else if (!isRelayed) {
                 qDebug() << "Peer" << senderUUID << "asked for" << connectRequestID << "but no matching peer found";
             }
         }
     }
 }
 
-SharedNetworkPeer IceServer::addOrUpdateHeartbeatingPeer(NLPacket& packet) {
+void IceServer::processRelayPacket(NLPacket& packet) {
+    // the relayed packet carries the address it was sent from, we only take that from the siblings we were given
+    if (!_siblings.contains(packet.getSenderSockAddr())) {
+        qDebug() << "Ignoring a relayed packet from" << packet.getSenderSockAddr() << "which is not a sibling ice-server";
+        return;
+    }
+
+    QDataStream relayStream(&packet);
+
+    HifiSockAddr senderSockAddr;
+    relayStream >> senderSockAddr;
+
+    qint64 relayedSize = packet.bytesLeftToRead();
+    if (relayedSize < NLPacket::totalHeaderSize(PacketType::ICEServerHeartbeat)) {
+        return;
+    }
+
+    std::unique_ptr<char[]> relayedData { new char[relayedSize] };
+    packet.read(relayedData.get(), relayedSize);
+
+    auto relayedPacket = NLPacket::fromReceivedPacket(std::move(relayedData), relayedSize, senderSockAddr);
+
+    if (packetVersionMatch(*relayedPacket) && relayedPacket->getType() != PacketType::ICEServerRelay) {
+        processPeerPacket(*relayedPacket, packet.getSenderSockAddr());
+    }
+}
+
+void IceServer::relayPacketToSibling(const NLPacket& packet, const HifiSockAddr& siblingSockAddr) {
+    auto relayPacket = NLPacket::create(PacketType::ICEServerRelay);
+
+    QDataStream relayStream(relayPacket.get());
+    relayStream << packet.getSenderSockAddr();
+    relayPacket->write(packet.getData(), packet.getDataSize());
+
+    _serverSocket.writePacket(*relayPacket, siblingSockAddr);
+}
+
+bool IceServer::addOrUpdateHeartbeatingPeer(NLPacket& packet, const HifiSockAddr& relayingSibling) {
 
     // pull the UUID, public and private sock addrs for this peer
     QUuid senderUUID;
@@ -138,69 +267,105 @@ SharedNetworkPeer IceServer::addOrUpdateHeartbeatingPeer(NLPacket& packet) {
 
     // make sure this is a verified heartbeat before performing any more processing
     if (isVerifiedHeartbeat(senderUUID, signedPlaintext, signature)) {
+        auto& shard = shardForPeer(senderUUID);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        quint64 now = usecTimestampNow();
+
         // make sure we have this sender in our peer hash
-        SharedNetworkPeer matchingPeer = _activePeers.value(senderUUID);
+        auto it = shard.activePeers.find(senderUUID);
 
-        if (!matchingPeer) {
+        if (it == shard.activePeers.end()) {
             // if we don't have this sender we need to create them now
-            matchingPeer = QSharedPointer<NetworkPeer>::create(senderUUID, publicSocket, localSocket);
-            _activePeers.insert(senderUUID, matchingPeer);
+            auto matchingPeer = QSharedPointer<NetworkPeer>::create(senderUUID, publicSocket, localSocket);
+            it = shard.activePeers.insert(senderUUID, { matchingPeer, relayingSibling });
+            scheduleExpiry(shard, senderUUID, now, now);
 
             qDebug() << "Added a new network peer" << *matchingPeer;
         } else {
             // we already had the peer so just potentially update their sockets
-            matchingPeer->setPublicSocket(publicSocket);
-            matchingPeer->setLocalSocket(localSocket);
+            it->peer->setPublicSocket(publicSocket);
+            it->peer->setLocalSocket(localSocket);
+
+            // the peer heartbeats to whichever ice-server it last reached
+            it->relayingSibling = relayingSibling;
+        }
+
+        // so that we can send packets to the heartbeating peer when we need, we need to activate a socket now
+        if (relayingSibling.isNull()) {
+            it->peer->activateMatchingOrNewSymmetricSocket(packet.getSenderSockAddr());
         }
 
         // update our last heard microstamp for this network peer to now
-        matchingPeer->setLastHeardMicrostamp(usecTimestampNow());
+        it->peer->setLastHeardMicrostamp(now);
         
-        return matchingPeer;
+        return true;
     } else {
-        // not verified, return the empty peer object
-        return SharedNetworkPeer();
+        // not verified
+        return false;
     }
 }
 
 bool IceServer::isVerifiedHeartbeat(const QUuid& domainID, const QByteArray& plaintext, const QByteArray& signature) {
-    // make sure we're not already waiting for a public key for this domain-server
-    if (!_pendingPublicKeyRequests.contains(domainID)) {
+    auto& shard = shardForPeer(domainID);
+
+    bool hasPublicKey = false;
+    RSASharedPtr rsaPublicKey;
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        // make sure we're not already waiting for a public key for this domain-server
+        if (shard.pendingPublicKeyRequests.contains(domainID)) {
+            return false;
+        }
+
         // check if we have a public key for this domain ID - if we do not then fire off the request for it
-        auto it = _domainPublicKeys.find(domainID);
-        if (it != _domainPublicKeys.end()) {
-
-            // attempt to verify the signature for this heartbeat
-            const auto rsaPublicKey = it->second.get();
-
-            if (rsaPublicKey) {
-                auto hashedPlaintext = QCryptographicHash::hash(plaintext, QCryptographicHash::Sha256);
-                int verificationResult = RSA_verify(NID_sha256,
-                                                    reinterpret_cast<const unsigned char*>(hashedPlaintext.constData()),
-                                                    hashedPlaintext.size(),
-                                                    reinterpret_cast<const unsigned char*>(signature.constData()),
-                                                    signature.size(),
-                                                    rsaPublicKey);
-
-                if (verificationResult == 1) {
-                    // this is the only success case - we return true here to indicate that the heartbeat is verified
-                    return true;
-                } else {
-                    qDebug() << "Failed to verify heartbeat for" << domainID << "- re-requesting public key from API.";
-                }
+        auto it = shard.domainPublicKeys.find(domainID);
+        if (it != shard.domainPublicKeys.end()) {
+            hasPublicKey = true;
+            rsaPublicKey = it->second;
+        }
+    }
 
+    if (hasPublicKey) {
+        // attempt to verify the signature for this heartbeat
+        if (rsaPublicKey) {
+            auto hashedPlaintext = QCryptographicHash::hash(plaintext, QCryptographicHash::Sha256);
+            int verificationResult = RSA_verify(NID_sha256,
+                                                reinterpret_cast<const unsigned char*>(hashedPlaintext.constData()),
+                                                hashedPlaintext.size(),
+                                                reinterpret_cast<const unsigned char*>(signature.constData()),
+                                                signature.size(),
+                                                rsaPublicKey.get());
+
+            if (verificationResult == 1) {
+                // this is the only success case - we return true here to indicate that the heartbeat is verified
+                return true;
             } else {
-                // we can't let this user in since we couldn't convert their public key to an RSA key we could use
-                qWarning() << "Public key for" << domainID << "is not a usable RSA* public key.";
-                qWarning() << "Re-requesting public key from API";
+                qDebug() << "Failed to verify heartbeat for" << domainID << "- re-requesting public key from API.";
             }
+
+        } else {
+            // we can't let this user in since we couldn't convert their public key to an RSA key we could use
+            qWarning() << "Public key for" << domainID << "is not a usable RSA* public key.";
+            qWarning() << "Re-requesting public key from API";
         }
+    }
 
-        // we could not verify this heartbeat (missing public key, could not load public key, bad actor)
-        // ask the metaverse API for the right public key and return false to indicate that this is not verified
-        requestDomainPublicKey(domainID);
+    // we could not verify this heartbeat (missing public key, could not load public key, bad actor)
+    // ask the metaverse API for the right public key and return false to indicate that this is not verified
+    {
+        // add this to the set of pending public key requests, another thread may have beaten us to it
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (shard.pendingPublicKeyRequests.contains(domainID)) {
+            return false;
+        }
+        shard.pendingPublicKeyRequests.insert(domainID);
     }
 
+    // the request is made from the main thread, which owns the QNetworkAccessManager
+    QMetaObject::invokeMethod(this, "requestDomainPublicKey", Qt::QueuedConnection, Q_ARG(QUuid, domainID));
+
     return false;
 }
 
@@ -218,15 +383,13 @@ void IceServer::requestDomainPublicKey(const QUuid& domainID) {
 
     qDebug() << "Requesting public key for domain with ID" << domainID;
 
-    // add this to the set of pending public key requests
-    _pendingPublicKeyRequests.insert(domainID);
-
     networkAccessManager.get(publicKeyRequest);
 }
 
 void IceServer::publicKeyReplyFinished(QNetworkReply* reply) {
     // get the domain ID from the QNetworkReply attribute
     QUuid domainID = reply->request().attribute(QNetworkRequest::User).toUuid();
+    auto& shard = shardForPeer(domainID);
 
     if (reply->error() == QNetworkReply::NoError) {
         // pull out the public key and store it for this domain
@@ -253,7 +416,8 @@ void IceServer::publicKeyReplyFinished(QNetworkReply* reply) {
                 RSA* rsaPublicKey = d2i_RSA_PUBKEY(NULL, &publicKeyData, apiPublicKey.size());
 
                 if (rsaPublicKey) {
-                    _domainPublicKeys[domainID] = { rsaPublicKey, RSA_free };
+                    std::lock_guard<std::mutex> lock(shard.mutex);
+                    shard.domainPublicKeys[domainID] = RSASharedPtr(rsaPublicKey, RSA_free);
                 } else {
                     qWarning() << "Could not convert in-memory public key for" << domainID << "to usable RSA public key.";
                     qWarning() << "Public key will be re-requested on next heartbeat.";
@@ -274,38 +438,69 @@ void IceServer::publicKeyReplyFinished(QNetworkReply* reply) {
     }
 
     // remove this domain ID from the list of pending public key requests
-    _pendingPublicKeyRequests.remove(domainID);
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.pendingPublicKeyRequests.remove(domainID);
+    }
 
     reply->deleteLater();
 }
 
-void IceServer::sendPeerInformationPacket(const NetworkPeer& peer, const HifiSockAddr* destinationSockAddr) {
+void IceServer::sendPeerInformationPacket(const QByteArray& peerInformation, const HifiSockAddr& destinationSockAddr) {
     auto peerPacket = NLPacket::create(PacketType::ICEServerPeerInformation);
 
-    // get the byte array for this peer
-    peerPacket->write(peer.toByteArray());
+    // write the byte array for this peer
+    peerPacket->write(peerInformation);
     
     // write the current packet
-    _serverSocket.writePacket(*peerPacket, *destinationSockAddr);
+    _serverSocket.writePacket(*peerPacket, destinationSockAddr);
+}
+
+void IceServer::scheduleExpiry(PeerShard& shard, const QUuid& peerID, quint64 lastHeardMicrostamp, quint64 now) {
+    // the peer is checked again on the first tick past the time it would have been silent for too long
+    const quint64 TICK_USECS = CLEAR_INACTIVE_PEERS_INTERVAL_MSECS * USECS_PER_MSEC;
+    quint64 expiryTime = lastHeardMicrostamp + PEER_SILENCE_THRESHOLD_MSECS * USECS_PER_MSEC;
+    quint64 usecsLeft = expiryTime > now ? expiryTime - now : 0;
+
+    int ticks = std::min((int)(usecsLeft / TICK_USECS) + 1, NUM_EXPIRY_SLOTS - 1);
+    shard.expiryWheel[(shard.currentExpirySlot + ticks) % NUM_EXPIRY_SLOTS].push_back(peerID);
 }
 
 void IceServer::clearInactivePeers() {
-    NetworkPeerHash::iterator peerItem = _activePeers.begin();
+    std::vector<QUuid> dueIDs;
 
-    while (peerItem != _activePeers.end()) {
-        SharedNetworkPeer peer = peerItem.value();
+    for (auto& shard : _peerShards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
 
-        if ((usecTimestampNow() - peer->getLastHeardMicrostamp()) > (PEER_SILENCE_THRESHOLD_MSECS * 1000)) {
-            qDebug() << "Removing peer from memory for inactivity -" << *peer;
+        // only the peers in the slot of this tick can have gone silent
+        shard.currentExpirySlot = (shard.currentExpirySlot + 1) % NUM_EXPIRY_SLOTS;
+        dueIDs.swap(shard.expiryWheel[shard.currentExpirySlot]);
 
-            // if we had a public key for this domain, remove it now
-            _domainPublicKeys.erase(peer->getUUID());
+        quint64 now = usecTimestampNow();
 
-            // remove the peer object
-            peerItem = _activePeers.erase(peerItem);
-        } else {
-            // we didn't kill this peer, push the iterator forwards
-            ++peerItem;
+        for (auto& peerID : dueIDs) {
+            auto it = shard.activePeers.find(peerID);
+            if (it == shard.activePeers.end()) {
+                continue;
+            }
+
+            SharedNetworkPeer peer = it->peer;
+
+            quint64 lastHeard = peer->getLastHeardMicrostamp();
+            if (now > lastHeard && (now - lastHeard) > (PEER_SILENCE_THRESHOLD_MSECS * USECS_PER_MSEC)) {
+                qDebug() << "Removing peer from memory for inactivity -" << *peer;
+
+                // if we had a public key for this domain, remove it now
+                shard.domainPublicKeys.erase(peerID);
+
+                // remove the peer object
+                shard.activePeers.erase(it);
+            } else {
+                // we heard from this peer since it was scheduled, check it again when it could next expire
+                scheduleExpiry(shard, peerID, lastHeard, now);
+            }
         }
+
+        dueIDs.clear();
     }
 }
@@ -12,8 +12,15 @@
 #ifndef hifi_IceServer_h
 #define hifi_IceServer_h
 
+#include <array>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
 #include <QtCore/QCoreApplication>
 #include <QtCore/QSharedPointer>
+#include <QtCore/QVector>
 #include <QUdpSocket>
 
 #include <openssl/rsa.h>
@@ -34,28 +41,53 @@ public:
     IceServer(int argc, char* argv[]);
 private slots:
     void clearInactivePeers();
+    void requestDomainPublicKey(const QUuid& domainID);
     void publicKeyReplyFinished(QNetworkReply* reply);
 private:
     bool packetVersionMatch(const udt::Packet& packet);
+
+    // packets are handled on the socket thread and on its receive threads, see processPeerPacket
     void processPacket(std::unique_ptr<udt::Packet> packet);
-    
-    SharedNetworkPeer addOrUpdateHeartbeatingPeer(NLPacket& incomingPacket);
-    void sendPeerInformationPacket(const NetworkPeer& peer, const HifiSockAddr* destinationSockAddr);
+    void processPeerPacket(NLPacket& packet, const HifiSockAddr& relayingSibling);
+    void processRelayPacket(NLPacket& packet);
+
+    bool addOrUpdateHeartbeatingPeer(NLPacket& incomingPacket, const HifiSockAddr& relayingSibling);
+    void sendPeerInformationPacket(const QByteArray& peerInformation, const HifiSockAddr& destinationSockAddr);
+    void relayPacketToSibling(const NLPacket& packet, const HifiSockAddr& siblingSockAddr);
 
     bool isVerifiedHeartbeat(const QUuid& domainID, const QByteArray& plaintext, const QByteArray& signature);
-    void requestDomainPublicKey(const QUuid& domainID);
 
     QUuid _id;
     udt::Socket _serverSocket;
 
-    using NetworkPeerHash = QHash<QUuid, SharedNetworkPeer>;
-    NetworkPeerHash _activePeers;
+    // the other ice-servers sharing the peer table, each relays the heartbeats it verifies to the others
+    QVector<HifiSockAddr> _siblings;
+
+    using RSASharedPtr = std::shared_ptr<RSA>;
+
+    struct ActivePeer {
+        SharedNetworkPeer peer;
+        HifiSockAddr relayingSibling; // the sibling the peer heartbeats to, null if it heartbeats to us
+    };
+
+    // The peers and the public keys of their domains are split by UUID, so the threads handling packets only
+    // contend for the peers they are handling. Each shard expires its peers with a wheel of one second slots holding
+    // every peer once: a peer that was heard from since it was put in a slot is moved to the slot it now expires in.
+    struct PeerShard {
+        std::mutex mutex;
+        QHash<QUuid, ActivePeer> activePeers;
+        std::unordered_map<QUuid, RSASharedPtr> domainPublicKeys;
+        QSet<QUuid> pendingPublicKeyRequests;
+        std::vector<std::vector<QUuid>> expiryWheel;
+        int currentExpirySlot { 0 };
+    };
+
+    static const int NUM_PEER_SHARDS = 16;
 
-    using RSAUniquePtr = std::unique_ptr<RSA, std::function<void(RSA*)>>;
-    using DomainPublicKeyHash = std::unordered_map<QUuid, RSAUniquePtr>;
-    DomainPublicKeyHash _domainPublicKeys;
+    PeerShard& shardForPeer(const QUuid& peerID) { return _peerShards[qHash(peerID) % NUM_PEER_SHARDS]; }
+    void scheduleExpiry(PeerShard& shard, const QUuid& peerID, quint64 lastHeardMicrostamp, quint64 now);
 
-    QSet<QUuid> _pendingPublicKeyRequests;
+    std::array<PeerShard, NUM_PEER_SHARDS> _peerShards;
 };
 
 #endif // hifi_IceServer_h
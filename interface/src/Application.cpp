@@ -23,6 +23,8 @@
 #include <QtCore/QMimeData>
 #include <QtCore/QThreadPool>
 
+#include <QtConcurrent/QtConcurrentRun>
+
 #include <QtGui/QScreen>
 #include <QtGui/QWindow>
 #include <QtGui/QDesktopServices>
@@ -506,6 +508,10 @@ Q_GUI_EXPORT void qt_gl_set_global_share_context(QOpenGLContext *context);
 
 Setting::Handle<int> sessionRunTime{ "sessionRunTime", 0 };
 
+static void logStartupStage(const QElapsedTimer& startupTimer, const char* stage) {
+    qCDebug(interfaceapp, "Startup stage %s done at %4.2f seconds.", stage, (double)startupTimer.elapsed() / 1000.0);
+}
+
 Application::Application(int& argc, char** argv, QElapsedTimer& startupTimer, bool runServer, QString runServerPathOption) :
     QApplication(argc, argv),
     _shouldRunServer(runServer),
@@ -606,16 +612,10 @@ Application::Application(int& argc, char** argv, QElapsedTimer& startupTimer, bo
         determinedSandboxState = true;
     });
 
-    // SandboxUtils::runLocalSandbox currently has 2 sec delay after spawning sandbox, so 4
-    // sec here is ok I guess.  TODO: ping sandbox so we know it is up, perhaps?
-    quint64 MAX_WAIT_TIME = USECS_PER_SECOND * 4;
+    // The sandbox state is only needed to pick the startup location, so the status request runs while the
+    // rest of the application initializes, and we only wait for its answer at the end of the constructor.
     auto startWaiting = usecTimestampNow();
-    while (!determinedSandboxState && (usecTimestampNow() - startWaiting <= MAX_WAIT_TIME)) {
-        QCoreApplication::processEvents();
-        // updateHeartbeat() while polling so we don't scare the deadlock watchdog
-        updateHeartbeat();
-        usleep(USECS_PER_MSEC * 50); // 20hz
-    }
+    logStartupStage(startupTimer, "essentials");
 
     _bookmarks = new Bookmarks();  // Before setting up the menu
 
@@ -842,6 +842,7 @@ Application::Application(int& argc, char** argv, QElapsedTimer& startupTimer, bo
     initializeGL();
     // Make sure we don't time out during slow operations at startup
     updateHeartbeat();
+    logStartupStage(startupTimer, "window and GL");
 
 
     // sessionRunTime will be reset soon by loadSettings. Grab it now to get previous session value.
@@ -1067,8 +1068,10 @@ Application::Application(int& argc, char** argv, QElapsedTimer& startupTimer, bo
     scriptEngines->loadScripts();
     // Make sure we don't time out during slow operations at startup
     updateHeartbeat();
+    logStartupStage(startupTimer, "input and scripts");
 
     loadSettings();
+    logStartupStage(startupTimer, "settings");
 
     // Now that we've loaded the menu and thus switched to the previous display plugin
     // we can unlock the desktop repositioning code, since all the positions will be 
@@ -1323,6 +1326,17 @@ Application::Application(int& argc, char** argv, QElapsedTimer& startupTimer, bo
 
 
 
+    // SandboxUtils::runLocalSandbox currently has 2 sec delay after spawning sandbox, so 4
+    // sec here is ok I guess.  TODO: ping sandbox so we know it is up, perhaps?
+    quint64 MAX_WAIT_TIME = USECS_PER_SECOND * 4;
+    while (!determinedSandboxState && (usecTimestampNow() - startWaiting <= MAX_WAIT_TIME)) {
+        QCoreApplication::processEvents();
+        // updateHeartbeat() while polling so we don't scare the deadlock watchdog
+        updateHeartbeat();
+        usleep(USECS_PER_MSEC * 50); // 20hz
+    }
+    logStartupStage(startupTimer, "sandbox check");
+
     // Get sandbox content set version, if available
     auto acDirPath = PathUtils::getRootDataDirectory() + BuildInfo::MODIFIED_ORGANIZATION + "/assignment-client/";
     auto contentVersionPath = acDirPath + "content-version.txt";
@@ -1880,6 +1894,9 @@ void Application::paintGL() {
     Finally clearFlag([this] { _inPaint = false; });
 
     _frameCount++;
+    if (_frameCount == 1) {
+        qCDebug(interfaceapp, "First frame time: %4.2f seconds.", (double)_sessionRunTimer.elapsed() / 1000.0);
+    }
 
     auto lastPaintBegin = usecTimestampNow();
     PROFILE_RANGE_EX(__FUNCTION__, 0xff0000ff, (uint64_t)_frameCount);
@@ -1913,6 +1930,7 @@ void Application::paintGL() {
     RenderArgs renderArgs(_gpuContext, getEntities(), lodManager->getOctreeSizeScale(),
                           lodManager->getBoundaryLevelAdjust(), RenderArgs::DEFAULT_RENDER_MODE,
                           RenderArgs::MONO, RenderArgs::RENDER_DEBUG_NONE);
+    renderArgs._meshLODBias = lodManager->getMeshLODBias();
     {
         QMutexLocker viewLocker(&_viewMutex);
         renderArgs.setViewFrustum(_viewFrustum);
@@ -3487,6 +3505,8 @@ void Application::init() {
     DependencyManager::get<NodeList>()->sendDomainServerCheckIn();
 
     getEntities()->init();
+    // the entity data is decompressed on the octree packet processor thread, and read into the tree once per frame
+    getEntities()->setStagingData(true);
     {
         QMutexLocker viewLocker(&_viewMutex);
         getEntities()->setViewFrustum(_viewFrustum);
@@ -3500,10 +3520,16 @@ void Application::init() {
             return 0.0f;
         }
 
+        bool isInView;
+        {
+            QMutexLocker viewLocker(&_viewMutex);
+            isInView = _viewFrustum.sphereIntersectsFrustum(item.getPosition(), 0.5f * glm::length(dims));
+        }
         auto distance = glm::distance(getMyAvatar()->getPosition(), item.getPosition());
-        return atan2(maxSize, distance);
+        return Model::computeLoadingPriority(maxSize, distance, isInView);
     });
 
+    _shapeManager.enableDiskCache(QStandardPaths::writableLocation(QStandardPaths::DataLocation) + "/shapes");
     ObjectMotionState::setShapeManager(&_shapeManager);
     _physicsEngine->init();
 
@@ -4021,6 +4047,7 @@ void Application::update(float deltaTime) {
             PROFILE_RANGE_EX("StepSimulation", 0xffff8000, (uint64_t)getActiveDisplayPlugin()->presentCount());
             PerformanceTimer perfTimer("stepSimulation");
             getEntities()->getTree()->withWriteLock([&] {
+                _physicsEngine->setLODCenter(myAvatar->getPosition());
                 _physicsEngine->stepSimulation();
             });
         }
@@ -4031,6 +4058,7 @@ void Application::update(float deltaTime) {
                 getEntities()->getTree()->withWriteLock([&] {
                     PerformanceTimer perfTimer("handleOutgoingChanges");
                     const VectorOfMotionStates& outgoingChanges = _physicsEngine->getOutgoingChanges();
+                    _entitySimulation->setViewPosition(avatarManager->getMyAvatar()->getPosition());
                     _entitySimulation->handleOutgoingChanges(outgoingChanges);
                     avatarManager->handleOutgoingChanges(outgoingChanges);
                 });
@@ -4935,6 +4963,11 @@ bool Application::nearbyEntitiesAreReadyForPhysics() {
     if (!entityTree) {
         return false;
     }
+    // the entity data received so far isn't all in the tree yet
+    if (getEntities()->getNumStagedChanges() > 0) {
+        _nearbyEntitiesStabilityCount = 0;
+        return false;
+    }
 
     QVector<EntityItemPointer> entities;
     entityTree->withReadLock([&] {
@@ -5435,9 +5468,16 @@ void Application::takeSnapshot(bool notify, float aspectRatio) {
         player->setMedia(QUrl::fromLocalFile(inf.absoluteFilePath()));
         player->play();
 
-        QString path = Snapshot::saveSnapshot(getActiveDisplayPlugin()->getScreenshot(aspectRatio));
+        // Where the snapshot goes is resolved here on the main thread, the frame is then read back without stalling
+        // the rendering and encoded on a worker thread
+        auto destination = Snapshot::getDestination();
+        getActiveDisplayPlugin()->requestScreenshot(aspectRatio, [notify, destination](QImage image) {
+            QtConcurrent::run([notify, destination, image] {
+                QString path = image.isNull() ? QString() : Snapshot::saveSnapshot(image, destination);
 
-        emit DependencyManager::get<WindowScriptingInterface>()->snapshotTaken(path, notify);
+                emit DependencyManager::get<WindowScriptingInterface>()->snapshotTaken(path, notify);
+            });
+        });
     });
 }
 
@@ -68,6 +68,9 @@ public:
     Q_INVOKABLE QString getLODFeedbackText();
     Q_INVOKABLE void setOctreeSizeScale(float sizeScale);
     Q_INVOKABLE float getOctreeSizeScale() const { return _octreeSizeScale; }
+
+    // The automatic adjustment of the size scale from the frame rate also biases the simplified mesh levels of detail
+    float getMeshLODBias() const { return _octreeSizeScale / DEFAULT_OCTREE_SIZE_SCALE; }
     
     Q_INVOKABLE void setBoundaryLevelAdjust(int boundaryLevelAdjust);
     Q_INVOKABLE int getBoundaryLevelAdjust() const { return _boundaryLevelAdjust; }
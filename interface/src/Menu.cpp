@@ -22,6 +22,7 @@
 #include <display-plugins/DisplayPlugin.h>
 #include <PathUtils.h>
 #include <SettingHandle.h>
+#include <Trace.h>
 #include <UserActivityLogger.h>
 #include <VrMenu.h>
 #include <ScriptEngines.h>
@@ -594,6 +595,15 @@ Menu::Menu() {
     addCheckableActionToQMenuAndActionHash(timingMenu, MenuOption::PipelineWarnings);
     addCheckableActionToQMenuAndActionHash(timingMenu, MenuOption::LogExtraTimings);
     addCheckableActionToQMenuAndActionHash(timingMenu, MenuOption::SuppressShortTimings);
+    // the trace is written to the traces directory of the application data when unchecked
+    action = addCheckableActionToQMenuAndActionHash(timingMenu, MenuOption::RecordTrace);
+    connect(action, &QAction::toggled, [](bool checked) {
+        if (checked) {
+            Tracer::start();
+        } else {
+            Tracer::stop(Tracer::getDefaultPath());
+        }
+    });
 
 
     // Developer > Audio >>>
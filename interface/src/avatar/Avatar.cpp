@@ -187,8 +187,9 @@ void Avatar::updateAvatarEntities() {
     // - if queueEditEntityMessage sees clientOnly flag it does _myAvatar->updateAvatarEntity()
     // - updateAvatarEntity saves the bytes and sets _avatarEntityDataLocallyEdited
     // - MyAvatar::update notices _avatarEntityDataLocallyEdited and calls sendIdentityPacket
-    // - sendIdentityPacket sends the entity bytes to the server which relays them to other interfaces
-    // - AvatarHashMap::processAvatarIdentityPacket on other interfaces call avatar->setAvatarEntityData()
+    // - sendIdentityPacket sends the entity bytes to the server which relays their versions to other interfaces
+    // - AvatarHashMap::processAvatarIdentityPacket on other interfaces fetches the versions they miss, and calls
+    //   avatar->setAvatarEntityData() with them and again when the missing ones arrive
     // - setAvatarEntityData saves the bytes and sets _avatarEntityDataChanged = true
     // - (My)Avatar::simulate notices _avatarEntityDataChanged and here we are...
 
@@ -277,19 +278,53 @@ void Avatar::updateAvatarEntities() {
 
 
 
+// Animation LOD: the rate at which the rig of an avatar is evaluated, from its angular radius on screen.
+// The LOD bias lowers as the frame rate drops, moving the avatars to the slower tiers.
+static float computeAnimationUpdatePeriod(float radius, float distance, float lodBias) {
+    struct Tier {
+        float minAngularRadius;
+        float updatePeriod;
+    };
+    static const Tier TIERS[] = {
+        { 0.05f, 0.0f },            // every frame
+        { 0.025f, 1.0f / 30.0f },
+        { 0.0125f, 1.0f / 15.0f }
+    };
+    static const float MIN_UPDATE_PERIOD = 1.0f / 5.0f;
+
+    float angularRadius = distance > EPSILON ? lodBias * radius / distance : 1.0f;
+    for (const auto& tier : TIERS) {
+        if (angularRadius >= tier.minAngularRadius) {
+            return tier.updatePeriod;
+        }
+    }
+    return MIN_UPDATE_PERIOD;
+}
+
 void Avatar::simulate(float deltaTime) {
-    PerformanceTimer perfTimer("simulate");
+    ViewFrustum viewFrustum;
+    ViewFrustum displayViewFrustum;
+    qApp->copyViewFrustum(viewFrustum);
+    qApp->copyDisplayViewFrustum(displayViewFrustum);
 
+    preSimulate(deltaTime);
+    simulateConcurrently(deltaTime, viewFrustum, displayViewFrustum);
+    postSimulate();
+}
+
+void Avatar::preSimulate(float deltaTime) {
     if (!isDead() && !_motionState) {
         DependencyManager::get<AvatarManager>()->addAvatarToSimulation(this);
     }
     animateScaleChanges(deltaTime);
+}
+
+void Avatar::simulateConcurrently(float deltaTime, const ViewFrustum& viewFrustum, const ViewFrustum& displayViewFrustum) {
+    PerformanceTimer perfTimer("simulate");
 
     // update the shouldAnimate flag to match whether or not we will render the avatar.
     const float MINIMUM_VISIBILITY_FOR_ON = 0.4f;
     const float MAXIMUM_VISIBILITY_FOR_OFF = 0.6f;
-    ViewFrustum viewFrustum;
-    qApp->copyViewFrustum(viewFrustum);
     float visibility = calculateRenderAccuracy(viewFrustum.getPosition(),
             getBounds(), DependencyManager::get<LODManager>()->getOctreeSizeScale());
     if (!_shouldAnimate) {
@@ -302,18 +337,42 @@ void Avatar::simulate(float deltaTime) {
         qCDebug(interfaceapp) << "Optimizing" << (isMyAvatar() ? "myself" : getSessionUUID()) << "for visibility" << visibility;
     }
 
-    // simple frustum check
+    // simple frustum check, against the bounds of the mesh rendered last frame
     float boundingRadius = getBoundingRadius();
-    qApp->copyDisplayViewFrustum(viewFrustum);
-    bool avatarPositionInView = viewFrustum.sphereIntersectsFrustum(getPosition(), boundingRadius);
-    bool avatarMeshInView = viewFrustum.boxIntersectsFrustum(_skeletonModel->getRenderableMeshBound());
-
-    if (_shouldAnimate && !_shouldSkipRender && (avatarPositionInView || avatarMeshInView)) {
+    bool avatarPositionInView = displayViewFrustum.sphereIntersectsFrustum(getPosition(), boundingRadius);
+    bool avatarMeshInView = displayViewFrustum.boxIntersectsFrustum(_skeletonModel->getRenderableMeshBound());
+    bool isInView = avatarPositionInView || avatarMeshInView;
+
+    float distance = glm::distance(displayViewFrustum.getPosition(), getPosition());
+    if (!_skeletonModel->isLoadingComplete()) {
+        // the skeleton resources can be shared with other avatars, the priority is set in postSimulate
+        _loadingPriority = Model::computeLoadingPriority(2.0f * boundingRadius, distance, isInView);
+    }
+
+    _jointsChanged = false;
+    bool shouldSimulateJoints = _shouldAnimate && !_shouldSkipRender && isInView;
+    if (shouldSimulateJoints && !_wasInView) {
+        // back in view, jump straight to the latest joints instead of blending from the pose it was left in
+        _hasNewJointRotations = true;
+        _hasNewJointTranslations = true;
+    }
+    _wasInView = shouldSimulateJoints;
+
+    if (shouldSimulateJoints) {
+        // the avatars small on screen animate at a reduced rate and without ik
+        float animationUpdatePeriod = 0.0f;
+        if (!isMyAvatar()) {
+            animationUpdatePeriod = computeAnimationUpdatePeriod(boundingRadius, distance,
+                DependencyManager::get<LODManager>()->getMeshLODBias());
+            _skeletonModel->setAnimationUpdatePeriod(animationUpdatePeriod);
+            _skeletonModel->getRig()->setEnableInverseKinematics(animationUpdatePeriod == 0.0f);
+        }
         {
             PerformanceTimer perfTimer("skeleton");
             _skeletonModel->getRig()->copyJointsFromJointData(_jointData);
-            _skeletonModel->simulate(deltaTime, _hasNewJointRotations || _hasNewJointTranslations);
-            locationChanged(); // joints changed, so if there are any children, update them.
+            // the interpolated joints change every frame
+            _skeletonModel->simulate(deltaTime, _hasNewJointRotations || _hasNewJointTranslations || animationUpdatePeriod > 0.0f);
+            _jointsChanged = true; // joints changed, so if there are any children, update them.
             _hasNewJointRotations = false;
             _hasNewJointTranslations = false;
         }
@@ -353,7 +412,19 @@ void Avatar::simulate(float deltaTime) {
 
     measureMotionDerivatives(deltaTime);
 
-    simulateAttachments(deltaTime);
+    // the attachments follow the joints, which didn't move out of view
+    if (shouldSimulateJoints) {
+        simulateAttachments(deltaTime);
+    }
+}
+
+void Avatar::postSimulate() {
+    if (!_skeletonModel->isLoadingComplete()) {
+        _skeletonModel->setLoadingPriority(_loadingPriority);
+    }
+    if (_jointsChanged) {
+        locationChanged();
+    }
     updatePalms();
     updateAvatarEntities();
 }
@@ -442,7 +513,7 @@ void Avatar::removeFromScene(AvatarSharedPointer self, std::shared_ptr<render::S
 
 void Avatar::updateRenderItem(render::PendingChanges& pendingChanges) {
     if (render::Item::isValidID(_renderItemID)) {
-        pendingChanges.updateItem<render::Payload<AvatarData>>(_renderItemID, [](render::Payload<AvatarData>& p) {});
+        pendingChanges.updateItem(_renderItemID);
     }
 }
 
@@ -814,7 +885,7 @@ void Avatar::renderDisplayName(gpu::Batch& batch, const ViewFrustum& view, const
         batch.setModelTransform(textTransform);
         {
             PROFILE_RANGE_BATCH(batch, __FUNCTION__":renderText");
-            renderer->draw(batch, text_x, -text_y, nameUTF8.data(), textColor);
+            renderer->draw(batch, _displayNameDrawInfo, text_x, -text_y, nameUTF8.data(), textColor);
         }
     }
 }
@@ -924,29 +995,30 @@ glm::vec3 Avatar::getAbsoluteJointTranslationInObjectFrame(int index) const {
 }
 
 int Avatar::getJointIndex(const QString& name) const {
-    if (QThread::currentThread() != thread()) {
-        int result;
-        QMetaObject::invokeMethod(const_cast<Avatar*>(this), "getJointIndex", Qt::BlockingQueuedConnection,
-            Q_RETURN_ARG(int, result), Q_ARG(const QString&, name));
-        return result;
-    }
     int result = getFauxJointIndex(name);
     if (result != -1) {
         return result;
     }
+    if (QThread::currentThread() != thread()) {
+        // the names of the last skeleton that was set up, rather than waiting for the main thread
+        return _jointIndicesCache.get().value(name) - 1;
+    }
     return _skeletonModel->isActive() ? _skeletonModel->getFBXGeometry().getJointIndex(name) : -1;
 }
 
 QStringList Avatar::getJointNames() const {
     if (QThread::currentThread() != thread()) {
-        QStringList result;
-        QMetaObject::invokeMethod(const_cast<Avatar*>(this), "getJointNames", Qt::BlockingQueuedConnection,
-            Q_RETURN_ARG(QStringList, result));
-        return result;
+        return _jointNamesCache.get();
     }
     return _skeletonModel->isActive() ? _skeletonModel->getFBXGeometry().getJointNames() : QStringList();
 }
 
+void Avatar::cacheJointNames() {
+    const FBXGeometry& geometry = _skeletonModel->getFBXGeometry();
+    _jointNamesCache.set(geometry.getJointNames());
+    _jointIndicesCache.set(geometry.jointIndices);
+}
+
 glm::vec3 Avatar::getJointPosition(int index) const {
     if (QThread::currentThread() != thread()) {
         glm::vec3 position;
@@ -978,6 +1050,8 @@ void Avatar::scaleVectorRelativeToPosition(glm::vec3 &positionToScale) const {
 
 void Avatar::setSkeletonModelURL(const QUrl& skeletonModelURL) {
     AvatarData::setSkeletonModelURL(skeletonModelURL);
+    _jointNamesCache.set(QStringList());
+    _jointIndicesCache.set(QHash<QString, int>());
     if (QThread::currentThread() == thread()) {
         _skeletonModel->setURL(_skeletonModelURL);
     } else {
@@ -1038,7 +1112,7 @@ void Avatar::setAttachmentData(const QVector<AttachmentData>& attachmentData) {
 }
 
 
-int Avatar::parseDataFromBuffer(const QByteArray& buffer) {
+void Avatar::applyNetworkState(const AvatarNetworkState& state) {
     if (!_initialized) {
         // now that we have data for this Avatar we are go for init
         init();
@@ -1047,7 +1121,7 @@ int Avatar::parseDataFromBuffer(const QByteArray& buffer) {
     // change in position implies movement
     glm::vec3 oldPosition = getPosition();
 
-    int bytesRead = AvatarData::parseDataFromBuffer(buffer);
+    AvatarData::applyNetworkState(state);
 
     const float MOVE_DISTANCE_THRESHOLD = 0.001f;
     _moving = glm::distance(oldPosition, getPosition()) > MOVE_DISTANCE_THRESHOLD;
@@ -1057,8 +1131,6 @@ int Avatar::parseDataFromBuffer(const QByteArray& buffer) {
     if (_moving || _hasNewJointRotations || _hasNewJointTranslations) {
         locationChanged();
     }
-
-    return bytesRead;
 }
 
 int Avatar::_jointConesID = GeometryCache::UNKNOWN_ID;
@@ -21,6 +21,7 @@
 #include <ShapeInfo.h>
 
 #include <render/Scene.h>
+#include <text/Font.h>
 
 #include "Head.h"
 #include "SkeletonModel.h"
@@ -50,6 +51,7 @@ enum ScreenTintLayer {
 };
 
 class AvatarMotionState;
+class ViewFrustum;
 class Texture;
 
 class Avatar : public AvatarData {
@@ -66,6 +68,15 @@ public:
     void init();
     void updateAvatarEntities();
     void simulate(float deltaTime);
+
+    // simulate() in three steps, so the avatars can be simulated side by side on worker threads:
+    // the scale and physics changes come before, and the changes of the entities and shared resources after,
+    // on the main thread
+    void preSimulate(float deltaTime);
+    // the frustums are copied once per frame by the caller, instead of by each avatar
+    void simulateConcurrently(float deltaTime, const ViewFrustum& viewFrustum, const ViewFrustum& displayViewFrustum);
+    void postSimulate();
+
     virtual void simulateAttachments(float deltaTime);
 
     virtual void render(RenderArgs* renderArgs, const glm::vec3& cameraPosition);
@@ -120,8 +131,6 @@ public:
 
     void setShowDisplayName(bool showDisplayName);
 
-    virtual int parseDataFromBuffer(const QByteArray& buffer) override;
-
     static void renderJointConnectingCone( gpu::Batch& batch, glm::vec3 position1, glm::vec3 position2,
                                                 float radius1, float radius2, const glm::vec4& color);
 
@@ -153,6 +162,10 @@ public:
 
     virtual void rebuildCollisionShape();
 
+    // copies the joint names of the skeleton for getJointIndex() and getJointNames() off the main thread, called by the
+    // skeleton model once its joints are set up
+    void cacheJointNames();
+
     virtual void computeShapeInfo(ShapeInfo& shapeInfo);
     void getCapsule(glm::vec3& start, glm::vec3& end, float& radius);
 
@@ -187,6 +200,8 @@ public slots:
     void setModelURLFinished(bool success);
 
 protected:
+    virtual void applyNetworkState(const AvatarNetworkState& state) override;
+
     friend class AvatarManager;
 
     void setMotionState(AvatarMotionState* motionState);
@@ -246,16 +261,25 @@ protected:
     ThreadSafeValueCache<glm::quat> _leftPalmRotationCache { glm::quat() };
     ThreadSafeValueCache<glm::vec3> _rightPalmPositionCache { glm::vec3() };
     ThreadSafeValueCache<glm::quat> _rightPalmRotationCache { glm::quat() };
+    ThreadSafeValueCache<QStringList> _jointNamesCache;
+    ThreadSafeValueCache<QHash<QString, int>> _jointIndicesCache; // 1-based, like FBXGeometry::jointIndices
 
 private:
     int _leftPointerGeometryID { 0 };
     int _rightPointerGeometryID { 0 };
     int _nameRectGeometryID { 0 };
+    // the glyph quads of the display name, the renderer is shared by all the avatars
+    mutable Font::DrawInfo _displayNameDrawInfo;
     bool _initialized;
     bool _shouldAnimate { true };
     bool _shouldSkipRender { false };
     bool _isLookAtTarget { false };
 
+    // left by simulateConcurrently for postSimulate
+    bool _jointsChanged { false };
+    bool _wasInView { false }; // the avatars out of view only move their root, and catch up when they come back
+    float _loadingPriority { 0.0f };
+
     float getBoundingRadius() const;
 
     static int _jointConesID;
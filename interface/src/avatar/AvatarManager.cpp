@@ -9,9 +9,12 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <atomic>
+#include <functional>
 #include <string>
 
 #include <QScriptEngine>
+#include <QtCore/QRunnable>
 
 #if defined(__GNUC__) && !defined(__clang__)
 #pragma GCC diagnostic push
@@ -45,6 +48,9 @@
 // in the update loop
 static const quint64 MIN_TIME_BETWEEN_MY_AVATAR_DATA_SENDS = (1000 * 1000) / 70;
 
+// the avatar entities of the avatars within this many meters are fetched as soon as they are known
+static const float AVATAR_ENTITY_FETCH_RADIUS = 50.0f;
+
 // We add _myAvatar into the hash with all the other AvatarData, and we use the default NULL QUid as the key.
 const QUuid MY_AVATAR_KEY;  // NULL key
 
@@ -74,13 +80,20 @@ AvatarManager::AvatarManager(QObject* parent) :
 
     auto nodeList = DependencyManager::get<NodeList>();
     auto& packetReceiver = nodeList->getPacketReceiver();
-    packetReceiver.registerListener(PacketType::BulkAvatarData, this, "processAvatarDataPacket");
+    // the avatar data is decoded on the network thread, and applied by updateOtherAvatars
+    _decodeAvatarDataOnNetworkThread = true;
+    packetReceiver.registerDirectListener(PacketType::BulkAvatarData, this, "processAvatarDataPacket");
     packetReceiver.registerListener(PacketType::KillAvatar, this, "processKillAvatar");
     packetReceiver.registerListener(PacketType::AvatarIdentity, this, "processAvatarIdentityPacket");
+    packetReceiver.registerListener(PacketType::AvatarEntityData, this, "processAvatarEntityDataPacket");
 
     // when we hear that the user has ignored an avatar by session UUID
     // immediately remove that avatar instead of waiting for the absence of packets from avatar mixer
     connect(nodeList.data(), &NodeList::ignoredNode, this, &AvatarManager::removeAvatar);
+
+    // leave a core for the render thread, the main thread simulates avatars too
+    const int RESERVED_THREADS = 2;
+    _simulationThreadPool.setMaxThreadCount(std::max(1, QThread::idealThreadCount() - RESERVED_THREADS));
 }
 
 AvatarManager::~AvatarManager() {
@@ -139,11 +152,17 @@ void AvatarManager::updateOtherAvatars(float deltaTime) {
 
     // simulate avatars
     auto hashCopy = getHashCopy();
+    std::vector<std::shared_ptr<Avatar>> simulatedAvatars;
 
     AvatarHash::iterator avatarIterator = hashCopy.begin();
     while (avatarIterator != hashCopy.end()) {
         auto avatar = std::static_pointer_cast<Avatar>(avatarIterator.value());
 
+        if (avatar != _myAvatar) {
+            // take the latest data decoded on the network thread
+            avatar->applyReceivedNetworkState();
+        }
+
         if (avatar == _myAvatar || !avatar->isInitialized()) {
             // DO NOT update _myAvatar!  Its update has already been done earlier in the main loop.
             // DO NOT update or fade out uninitialized Avatars
@@ -152,18 +171,69 @@ void AvatarManager::updateOtherAvatars(float deltaTime) {
             removeAvatar(avatarIterator.key());
             ++avatarIterator;
         } else {
-            avatar->simulate(deltaTime);
+            avatar->preSimulate(deltaTime);
+            simulatedAvatars.push_back(avatar);
             ++avatarIterator;
-
-            avatar->updateRenderItem(pendingChanges);
         }
     }
-    qApp->getMain3DScene()->enqueuePendingChanges(pendingChanges);
+
+    // the avatars that came close enough since their identity get the entity data they still miss
+    fetchMissingAvatarEntities();
+
+    simulateAvatarsConcurrently(simulatedAvatars, deltaTime);
+
+    // the changes to the scene, the entities and the shared resources are applied back on the main thread
+    for (auto& avatar : simulatedAvatars) {
+        avatar->postSimulate();
+        avatar->updateRenderItem(pendingChanges);
+    }
+    qApp->getMain3DScene()->enqueuePendingChanges(std::move(pendingChanges));
 
     // simulate avatar fades
     simulateAvatarFades(deltaTime);
 }
 
+namespace {
+
+class AvatarSimulationTask : public QRunnable {
+public:
+    AvatarSimulationTask(const std::function<void()>& simulate) : _simulate(simulate) {}
+    void run() override { _simulate(); }
+
+private:
+    std::function<void()> _simulate;
+};
+
+}
+
+void AvatarManager::simulateAvatarsConcurrently(const std::vector<std::shared_ptr<Avatar>>& avatars, float deltaTime) {
+    PerformanceTimer perfTimer("simulateAvatars");
+
+    // every avatar is culled against the same frustums, copied once for the frame
+    ViewFrustum viewFrustum;
+    ViewFrustum displayViewFrustum;
+    qApp->copyViewFrustum(viewFrustum);
+    qApp->copyDisplayViewFrustum(displayViewFrustum);
+
+    // each thread takes the next avatar left, so the threads done early take on the work of the others
+    std::atomic<size_t> nextAvatar { 0 };
+    auto simulateAvatars = [&] {
+        for (size_t i = nextAvatar++; i < avatars.size(); i = nextAvatar++) {
+            avatars[i]->simulateConcurrently(deltaTime, viewFrustum, displayViewFrustum);
+        }
+    };
+
+    // a couple of avatars aren't worth waking up the threads
+    const int MIN_AVATARS_PER_THREAD = 2;
+    int numThreads = std::min(_simulationThreadPool.maxThreadCount(), (int)avatars.size() / MIN_AVATARS_PER_THREAD - 1);
+    for (int i = 0; i < numThreads; i++) {
+        _simulationThreadPool.start(new AvatarSimulationTask(simulateAvatars));
+    }
+
+    simulateAvatars();
+    _simulationThreadPool.waitForDone();
+}
+
 void AvatarManager::postUpdate(float deltaTime) {
     auto hashCopy = getHashCopy();
     AvatarHash::iterator avatarIterator = hashCopy.begin();
@@ -232,6 +302,10 @@ void AvatarManager::removeAvatar(const QUuid& sessionUUID) {
     }
 }
 
+bool AvatarManager::shouldFetchAvatarEntities(const AvatarData& avatar) const {
+    return glm::distance(avatar.getPosition(), _myAvatar->getPosition()) < AVATAR_ENTITY_FETCH_RADIUS;
+}
+
 void AvatarManager::handleRemovedAvatar(const AvatarSharedPointer& removedAvatar) {
     AvatarHashMap::handleRemovedAvatar(removedAvatar);
 
@@ -15,6 +15,7 @@
 #include <QtCore/QHash>
 #include <QtCore/QObject>
 #include <QtCore/QSharedPointer>
+#include <QtCore/QThreadPool>
 
 #include <AvatarHashMap.h>
 #include <PhysicsEngine.h>
@@ -87,12 +88,18 @@ private:
 
     void simulateAvatarFades(float deltaTime);
 
+    // simulates the avatars side by side on the main thread and the simulation threads
+    void simulateAvatarsConcurrently(const std::vector<std::shared_ptr<Avatar>>& avatars, float deltaTime);
+
     // virtual overrides
     virtual AvatarSharedPointer newSharedAvatar() override;
     virtual AvatarSharedPointer addAvatar(const QUuid& sessionUUID, const QWeakPointer<Node>& mixerWeakPointer) override;
 
     virtual void handleRemovedAvatar(const AvatarSharedPointer& removedAvatar) override;
 
+    // the entities of the avatars further away are only fetched when they come closer
+    virtual bool shouldFetchAvatarEntities(const AvatarData& avatar) const override;
+
     QVector<AvatarSharedPointer> _avatarFades;
     std::shared_ptr<MyAvatar> _myAvatar;
     quint64 _lastSendAvatarDataTime = 0; // Controls MyAvatar send data rate.
@@ -106,6 +113,8 @@ private:
     SetOfAvatarMotionStates _motionStatesThatMightUpdate;
     SetOfMotionStates _motionStatesToAddToPhysics;
     VectorOfMotionStates _motionStatesToRemoveFromPhysics;
+
+    QThreadPool _simulationThreadPool;
 };
 
 Q_DECLARE_METATYPE(AvatarManager::LocalLight)
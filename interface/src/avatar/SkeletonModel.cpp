@@ -42,7 +42,7 @@ SkeletonModel::~SkeletonModel() {
 void SkeletonModel::initJointStates() {
     const FBXGeometry& geometry = getFBXGeometry();
     glm::mat4 modelOffset = glm::scale(_scale) * glm::translate(_offset);
-    _rig->initJointStates(geometry, modelOffset);
+    _rig->initJointStates(_renderGeometry->getFBXGeometryPointer(), modelOffset);
 
     // Determine the default eye position for avatar scale = 1.0
     int headJointIndex = geometry.headJointIndex;
@@ -68,6 +68,7 @@ void SkeletonModel::initJointStates() {
     _headClipDistance = -(meshExtents.minimum.z / _scale.z - _defaultEyeModelPosition.z);
     _headClipDistance = std::max(_headClipDistance, DEFAULT_NEAR_CLIP);
 
+    _owningAvatar->cacheJointNames();
     _owningAvatar->rebuildCollisionShape();
     emit skeletonLoaded();
 }
@@ -45,35 +45,22 @@ void SoftAttachmentModel::updateClusterMatrices(glm::vec3 modelPosition, glm::qu
 
     const FBXGeometry& geometry = getFBXGeometry();
 
-    glm::mat4 modelToWorld = glm::mat4_cast(modelOrientation);
-    for (int i = 0; i < _meshStates.size(); i++) {
-        MeshState& state = _meshStates[i];
-        const FBXMesh& mesh = geometry.meshes.at(i);
-
-        for (int j = 0; j < mesh.clusters.size(); j++) {
-            const FBXCluster& cluster = mesh.clusters.at(j);
-
-            // TODO: cache these look ups as an optimization
-            int jointIndexOverride = getJointIndexOverride(cluster.jointIndex);
-            glm::mat4 jointMatrix;
-            if (jointIndexOverride >= 0 && jointIndexOverride < _rigOverride->getJointStateCount()) {
-                jointMatrix = _rigOverride->getJointTransform(jointIndexOverride);
-            } else {
-                jointMatrix = _rig->getJointTransform(cluster.jointIndex);
-            }
-            state.clusterMatrices[j] = modelToWorld * jointMatrix * cluster.inverseBindMatrix;
+    // pose the joints once for all the meshes, from the override rig when it has them
+    int numJoints = _rig->getJointStateCount();
+    _jointPoses.resize(numJoints);
+    for (int i = 0; i < numJoints; i++) {
+        int jointIndexOverride = getJointIndexOverride(i);
+        AnimPose jointPose;
+        if (jointIndexOverride >= 0 && jointIndexOverride < _rigOverride->getJointStateCount()) {
+            jointPose = _rigOverride->getJointPose(jointIndexOverride);
+        } else {
+            jointPose = _rig->getJointPose(i);
         }
+        _jointPoses[i] = AnimPose(jointPose.scale, modelOrientation * jointPose.rot, modelOrientation * jointPose.trans);
+    }
 
-        // Once computed the cluster matrices, update the buffer(s)
-        if (mesh.clusters.size() > 1) {
-            if (!state.clusterBuffer) {
-                state.clusterBuffer = std::make_shared<gpu::Buffer>(state.clusterMatrices.size() * sizeof(glm::mat4),
-                                                                    (const gpu::Byte*) state.clusterMatrices.constData());
-            } else {
-                state.clusterBuffer->setSubData(0, state.clusterMatrices.size() * sizeof(glm::mat4),
-                                                (const gpu::Byte*) state.clusterMatrices.constData());
-            }
-        }
+    for (int i = 0; i < _meshStates.size(); i++) {
+        updateClusterTransforms(_meshStates[i], geometry.meshes.at(i), _jointPoses, nullptr);
     }
 
     // post the blender if we're not currently waiting for one to finish
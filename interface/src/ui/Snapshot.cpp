@@ -68,8 +68,15 @@ SnapshotMetaData* Snapshot::parseSnapshotData(QString snapshotPath) {
 }
 
 QString Snapshot::saveSnapshot(QImage image) {
+    return saveSnapshot(image, getDestination());
+}
+
+QString Snapshot::saveSnapshot(QImage image, const Destination& destination) {
 
-    QFile* snapshotFile = savedFileForSnapshot(image, false);
+    QFile* snapshotFile = savedFileForSnapshot(image, destination, false);
+    if (!snapshotFile) {
+        return QString();
+    }
 
     // we don't need the snapshot file, so close it, grab its filename and delete it
     snapshotFile->close();
@@ -86,11 +93,11 @@ QTemporaryFile* Snapshot::saveTempSnapshot(QImage image) {
     return static_cast<QTemporaryFile*>(savedFileForSnapshot(image, true));
 }
 
-QFile* Snapshot::savedFileForSnapshot(QImage & shot, bool isTemporary) {
+Snapshot::Destination Snapshot::getDestination(bool isTemporary) {
+    Destination destination;
 
     // adding URL to snapshot
-    QUrl currentURL = DependencyManager::get<AddressManager>()->currentShareableAddress();
-    shot.setText(URL, currentURL.toString());
+    destination.url = DependencyManager::get<AddressManager>()->currentShareableAddress();
 
     QString username = DependencyManager::get<AccountManager>()->getAccountInfo().getUsername();
     // normalize username, replace all non alphanumeric with '-'
@@ -98,9 +105,7 @@ QFile* Snapshot::savedFileForSnapshot(QImage & shot, bool isTemporary) {
 
     QDateTime now = QDateTime::currentDateTime();
 
-    QString filename = FILENAME_PATH_FORMAT.arg(username, now.toString(DATETIME_FORMAT));
-
-    const int IMAGE_QUALITY = 100;
+    destination.filename = FILENAME_PATH_FORMAT.arg(username, now.toString(DATETIME_FORMAT));
 
     if (!isTemporary) {
         QString snapshotFullPath = snapshotsLocation.get();
@@ -116,20 +121,34 @@ QFile* Snapshot::savedFileForSnapshot(QImage & shot, bool isTemporary) {
                 snapshotFullPath.append(QDir::separator());
             }
 
-            snapshotFullPath.append(filename);
+            destination.directory = snapshotFullPath;
+        }
+    }
 
-            QFile* imageFile = new QFile(snapshotFullPath);
-            imageFile->open(QIODevice::WriteOnly);
+    return destination;
+}
 
-            shot.save(imageFile, 0, IMAGE_QUALITY);
-            imageFile->close();
+QFile* Snapshot::savedFileForSnapshot(QImage & shot, bool isTemporary) {
+    return savedFileForSnapshot(shot, getDestination(isTemporary), isTemporary);
+}
 
-            return imageFile;
-        }
+QFile* Snapshot::savedFileForSnapshot(QImage & shot, const Destination& destination, bool isTemporary) {
+
+    shot.setText(URL, destination.url.toString());
+
+    const int IMAGE_QUALITY = 100;
+
+    if (!destination.directory.isEmpty()) {
+        QFile* imageFile = new QFile(destination.directory + destination.filename);
+        imageFile->open(QIODevice::WriteOnly);
+
+        shot.save(imageFile, 0, IMAGE_QUALITY);
+        imageFile->close();
 
+        return imageFile;
     }
     // Either we were asked for a tempororary, or the user didn't set a directory.
-    QTemporaryFile* imageTempFile = new QTemporaryFile(QDir::tempPath() + "/XXXXXX-" + filename);
+    QTemporaryFile* imageTempFile = new QTemporaryFile(QDir::tempPath() + "/XXXXXX-" + destination.filename);
 
     if (!imageTempFile->open()) {
         qDebug() << "Unable to open QTemporaryFile for temp snapshot. Will not save.";
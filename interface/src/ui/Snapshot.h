@@ -34,7 +34,17 @@ private:
 
 class Snapshot {
 public:
+    // Where and under which URL a snapshot is saved, resolved on the main thread so that the image can then be
+    // encoded and saved from any thread
+    struct Destination {
+        QUrl url;
+        QString directory; // empty for a temporary file
+        QString filename;
+    };
+    static Destination getDestination(bool isTemporary = false);
+
     static QString saveSnapshot(QImage image);
+    static QString saveSnapshot(QImage image, const Destination& destination);
     static QTemporaryFile* saveTempSnapshot(QImage image);
     static SnapshotMetaData* parseSnapshotData(QString snapshotPath);
 
@@ -42,6 +52,7 @@ public:
     static void uploadSnapshot(const QString& filename);
 private:
     static QFile* savedFileForSnapshot(QImage & image, bool isTemporary);
+    static QFile* savedFileForSnapshot(QImage & image, const Destination& destination, bool isTemporary);
 };
 
 #endif // hifi_Snapshot_h
@@ -11,6 +11,7 @@
 #include "Line3DOverlay.h"
 
 #include <GeometryCache.h>
+#include <GLMHelpers.h>
 #include <RegisteredMetaTypes.h>
 
 
@@ -103,8 +104,23 @@ void Line3DOverlay::render(RenderArgs* args) {
         } else if (_glow > 0.0f) {
             geometryCache->renderGlowLine(*batch, _start, _end, colorv4, _glow, _glowWidth, _geometryCacheID);
         } else {
-            geometryCache->bindSimpleProgram(*batch, false, false, false, true, true);
-            geometryCache->renderLine(*batch, _start, _end, colorv4, _geometryCacheID);
+            // Plain lines are drawn as instances of the unit line shape, so all of them go in one draw per pipeline
+            glm::vec3 direction = _end - _start;
+            float length = glm::length(direction);
+            if (length < EPSILON) {
+                return;
+            }
+            Transform transform = getTransform();
+            transform.postTranslate(0.5f * (_start + _end));
+            transform.postRotate(rotationBetween(Vectors::UNIT_X, direction / length));
+            transform.postScale(glm::vec3(length, 1.0f, 1.0f));
+            batch->setModelTransform(transform);
+
+            auto pipeline = args->_pipeline;
+            if (!pipeline) {
+                pipeline = geometryCache->getWireShapePipeline();
+            }
+            geometryCache->renderWireShapeInstance(*batch, GeometryCache::Line, colorv4, pipeline);
         }
     }
 }
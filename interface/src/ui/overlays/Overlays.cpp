@@ -54,6 +54,10 @@ void Overlays::cleanupAllOverlays() {
         _overlaysWorld.clear();
         _panels.clear();
     }
+    {
+        QMutexLocker pendingEditsLock(&_pendingEditsMutex);
+        _pendingEdits.clear();
+    }
     cleanupOverlaysToDelete();
 }
 
@@ -65,6 +69,7 @@ void Overlays::update(float deltatime) {
 
     {
         QWriteLocker lock(&_lock);
+        applyPendingEdits();
         foreach(Overlay::Pointer thisOverlay, _overlaysHUD) {
             thisOverlay->update(deltatime);
         }
@@ -76,6 +81,28 @@ void Overlays::update(float deltatime) {
     cleanupOverlaysToDelete();
 }
 
+void Overlays::queueEdit(unsigned int id, const QVariantMap& properties) {
+    QMutexLocker pendingEditsLock(&_pendingEditsMutex);
+    QVariantMap& edits = _pendingEdits[id];
+    for (auto it = properties.cbegin(); it != properties.cend(); ++it) {
+        edits[it.key()] = it.value();
+    }
+}
+
+void Overlays::applyPendingEdits() {
+    QHash<unsigned int, QVariantMap> pendingEdits;
+    {
+        QMutexLocker pendingEditsLock(&_pendingEditsMutex);
+        pendingEdits.swap(_pendingEdits);
+    }
+    for (auto it = pendingEdits.cbegin(); it != pendingEdits.cend(); ++it) {
+        Overlay::Pointer thisOverlay = getOverlay(it.key());
+        if (thisOverlay) {
+            thisOverlay->setProperties(it.value());
+        }
+    }
+}
+
 void Overlays::cleanupOverlaysToDelete() {
     if (!_overlaysToDelete.isEmpty()) {
         render::ScenePointer scene = qApp->getMain3DScene();
@@ -209,7 +236,13 @@ unsigned int Overlays::addOverlay(Overlay::Pointer overlay) {
 }
 
 unsigned int Overlays::cloneOverlay(unsigned int id) {
-    Overlay::Pointer thisOverlay = getOverlay(id);
+    Overlay::Pointer thisOverlay;
+    {
+        // the clone gets the edits made so far
+        QWriteLocker lock(&_lock);
+        applyPendingEdits();
+        thisOverlay = getOverlay(id);
+    }
 
     if (thisOverlay) {
         unsigned int cloneId = addOverlay(Overlay::Pointer(thisOverlay->createClone()));
@@ -224,36 +257,33 @@ unsigned int Overlays::cloneOverlay(unsigned int id) {
 }
 
 bool Overlays::editOverlay(unsigned int id, const QVariant& properties) {
-    QWriteLocker lock(&_lock);
-
-    Overlay::Pointer thisOverlay = getOverlay(id);
-    if (thisOverlay) {
-        thisOverlay->setProperties(properties.toMap());
-
-        return true;
+    {
+        QReadLocker lock(&_lock);
+        if (!getOverlay(id)) {
+            return false;
+        }
     }
-    return false;
+    queueEdit(id, properties.toMap());
+    return true;
 }
 
 bool Overlays::editOverlays(const QVariant& propertiesById) {
     QVariantMap map = propertiesById.toMap();
     bool success = true;
-    QWriteLocker lock(&_lock);
-    for (const auto& key : map.keys()) {
+    QReadLocker lock(&_lock);
+    for (auto it = map.cbegin(); it != map.cend(); ++it) {
         bool convertSuccess;
-        unsigned int id = key.toUInt(&convertSuccess);
+        unsigned int id = it.key().toUInt(&convertSuccess);
         if (!convertSuccess) {
             success = false;
             continue;
         }
 
-        Overlay::Pointer thisOverlay = getOverlay(id);
-        if (!thisOverlay) {
+        if (!getOverlay(id)) {
             success = false;
             continue;
         }
-        QVariant properties = map[key];
-        thisOverlay->setProperties(properties.toMap());
+        queueEdit(id, it.value().toMap());
     }
     return success;
 }
@@ -271,6 +301,10 @@ void Overlays::deleteOverlay(unsigned int id) {
             return;
         }
     }
+    {
+        QMutexLocker pendingEditsLock(&_pendingEditsMutex);
+        _pendingEdits.remove(id);
+    }
 
     auto attachable = std::dynamic_pointer_cast<PanelAttachable>(overlayToDelete);
     if (attachable && attachable->getParentPanel()) {
@@ -376,6 +410,15 @@ OverlayPropertyResult Overlays::getProperty(unsigned int id, const QString& prop
     Overlay::Pointer thisOverlay = getOverlay(id);
     QReadLocker lock(&_lock);
     if (thisOverlay && thisOverlay->supportsGetProperty()) {
+        // a value edited since the last update isn't on the overlay yet
+        {
+            QMutexLocker pendingEditsLock(&_pendingEditsMutex);
+            auto edits = _pendingEdits.constFind(id);
+            if (edits != _pendingEdits.cend() && edits->contains(property)) {
+                result.value = edits->value(property);
+                return result;
+            }
+        }
         result.value = thisOverlay->getProperty(property);
     }
     return result;
@@ -18,6 +18,7 @@
 #ifndef hifi_Overlays_h
 #define hifi_Overlays_h
 
+#include <QMutex>
 #include <QReadWriteLock>
 #include <QScriptValue>
 
@@ -86,7 +87,8 @@ public slots:
     unsigned int cloneOverlay(unsigned int id);
 
     /// edits an overlay updating only the included properties, will return the identified OverlayID in case of
-    /// successful edit, if the input id is for an unknown overlay this function will have no effect
+    /// successful edit, if the input id is for an unknown overlay this function will have no effect.
+    /// The edits are merged and applied to the overlays once per frame, by update()
     bool editOverlay(unsigned int id, const QVariant& properties);
 
     /// edits an overlay updating only the included properties, will return the identified OverlayID in case of
@@ -151,6 +153,10 @@ signals:
 private:
     void cleanupOverlaysToDelete();
 
+    void queueEdit(unsigned int id, const QVariantMap& properties);
+    // applies the queued edits, must be called with the write lock
+    void applyPendingEdits();
+
     QMap<unsigned int, Overlay::Pointer> _overlaysHUD;
     QMap<unsigned int, Overlay::Pointer> _overlaysWorld;
     QMap<unsigned int, OverlayPanel::Pointer> _panels;
@@ -159,6 +165,10 @@ private:
 
     QReadWriteLock _lock;
     QReadWriteLock _deleteLock;
+
+    // the properties edited since the last update, by overlay, the latest value of each property wins
+    QHash<unsigned int, QVariantMap> _pendingEdits;
+    QMutex _pendingEditsMutex;
     QScriptEngine* _scriptEngine;
     bool _enabled = true;
 };
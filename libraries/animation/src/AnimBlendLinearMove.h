@@ -64,8 +64,8 @@ protected:
 
     float _phase = 0.0f;
 
-    QString _alphaVar;
-    QString _desiredSpeedVar;
+    AnimVarKey _alphaVar;
+    AnimVarKey _desiredSpeedVar;
 
     std::vector<float> _characteristicSpeeds;
 
@@ -13,6 +13,7 @@
 
 #include <string>
 #include "AnimationCache.h"
+#include "AnimCompressedClip.h"
 #include "AnimNode.h"
 
 // Playback a single animation timeline.
@@ -58,18 +59,16 @@ protected:
 
     virtual void setCurrentFrameInternal(float frame) override;
 
-    void copyFromNetworkAnim();
-    void buildMirrorAnim();
-
     // for AnimDebugDraw rendering
     virtual const AnimPoseVec& getPosesInternal() const override;
 
     AnimationPointer _networkAnim;
     AnimPoseVec _poses;
 
-    // _anim[frame][joint]
-    std::vector<AnimPoseVec> _anim;
-    std::vector<AnimPoseVec> _mirrorAnim;
+    // the frames retargeted onto the skeleton, shared with the other clips of the animation
+    AnimCompressedClip::Pointer _clip;
+    AnimPoseVec _prevFrame;
+    AnimPoseVec _nextFrame;
 
     QString _url;
     float _startFrame;
@@ -79,12 +78,12 @@ protected:
     bool _mirrorFlag;
     float _frame;
 
-    QString _startFrameVar;
-    QString _endFrameVar;
-    QString _timeScaleVar;
-    QString _loopFlagVar;
-    QString _mirrorFlagVar;
-    QString _frameVar;
+    AnimVarKey _startFrameVar;
+    AnimVarKey _endFrameVar;
+    AnimVarKey _timeScaleVar;
+    AnimVarKey _loopFlagVar;
+    AnimVarKey _mirrorFlagVar;
+    AnimVarKey _frameVar;
 
     // no copies
     AnimClip(const AnimClip&) = delete;
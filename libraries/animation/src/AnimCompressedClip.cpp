@@ -0,0 +1,302 @@
+//
+//  AnimCompressedClip.cpp
+//
+//  Created by Sam Gateau on 10/15/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AnimCompressedClip.h"
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <tuple>
+
+#include "AnimationLogging.h"
+
+// the largest error left by dropping a key: the dot of the interpolated and the actual rotation, about 0.1 degree,
+// and a thousandth of the bone length
+static const float ROTATION_TOLERANCE = 0.9999996f;
+static const float TRANSLATION_TOLERANCE = 0.001f;
+static const float MIN_TRANSLATION_TOLERANCE = 0.00001f;
+
+static const float QUAT_QUANTIZATION_SCALE = 32767.0f;
+
+AnimCompressedClip::Pointer AnimCompressedClip::getClip(const AnimationPointer& animation, const AnimSkeleton::ConstPointer& skeleton,
+                                                        bool usePreAndPostPose) {
+    using Key = std::tuple<QString, const AnimSkeleton*, bool>;
+    struct Entry {
+        std::weak_ptr<const AnimSkeleton> skeleton;
+        std::weak_ptr<const AnimCompressedClip> clip;
+    };
+    static std::mutex mutex;
+    static std::map<Key, Entry> clips;
+
+    QString url = animation->getURL().toString();
+    Key key(url, skeleton.get(), usePreAndPostPose);
+    auto findClip = [&]() -> Pointer {
+        auto it = clips.find(key);
+        if (it != clips.end() && it->second.skeleton.lock() == skeleton) {
+            return it->second.clip.lock();
+        }
+        return nullptr;
+    };
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (auto clip = findClip()) {
+            return clip;
+        }
+    }
+
+    // retarget outside of the lock, the clips of the other animations don't wait for this one
+    auto newClip = std::make_shared<const AnimCompressedClip>(animation->getGeometry(), url, skeleton, usePreAndPostPose);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (auto clip = findClip()) {
+        return clip;
+    }
+    for (auto it = clips.begin(); it != clips.end();) {
+        if (it->second.clip.expired()) {
+            it = clips.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    clips[key] = { skeleton, newClip };
+    return newClip;
+}
+
+AnimCompressedClip::AnimCompressedClip(const FBXGeometry& geom, const QString& url, const AnimSkeleton::ConstPointer& skeleton,
+                                       bool usePreAndPostPose) :
+    _skeleton(skeleton)
+{
+    // build a mapping from animation joint indices to skeleton joint indices.
+    // by matching joints with the same name.
+    AnimSkeleton animSkeleton(geom);
+    const auto animJointCount = animSkeleton.getNumJoints();
+    const auto skeletonJointCount = _skeleton->getNumJoints();
+    std::vector<int> jointMap;
+    jointMap.reserve(animJointCount);
+    for (int i = 0; i < animJointCount; i++) {
+        int skeletonJoint = _skeleton->nameToJointIndex(animSkeleton.getJointName(i));
+        if (skeletonJoint == -1) {
+            qCWarning(animation) << "animation contains joint =" << animSkeleton.getJointName(i) << " which is not in the skeleton, url =" << url;
+        }
+        jointMap.push_back(skeletonJoint);
+    }
+
+    int frameCount = geom.animationFrames.size();
+    if (frameCount > std::numeric_limits<uint16_t>::max()) {
+        qCWarning(animation) << "animation has" << frameCount << "frames, only the first" << std::numeric_limits<uint16_t>::max() << "are played, url =" << url;
+        frameCount = std::numeric_limits<uint16_t>::max();
+    }
+    _numFrames = frameCount;
+
+    // the full precision frames are only kept until they're compressed
+    std::vector<AnimPoseVec> frames(frameCount);
+    for (int frame = 0; frame < frameCount; frame++) {
+
+        const FBXAnimationFrame& fbxAnimFrame = geom.animationFrames[frame];
+
+        // init all joints in animation to default pose
+        // this will give us a resonable result for bones in the model skeleton but not in the animation.
+        frames[frame] = _skeleton->getRelativeDefaultPoses();
+
+        for (int animJoint = 0; animJoint < animJointCount; animJoint++) {
+            int skeletonJoint = jointMap[animJoint];
+
+            const glm::vec3& fbxAnimTrans = fbxAnimFrame.translations[animJoint];
+            const glm::quat& fbxAnimRot = fbxAnimFrame.rotations[animJoint];
+
+            // skip joints that are in the animation but not in the skeleton.
+            if (skeletonJoint >= 0 && skeletonJoint < skeletonJointCount) {
+
+                AnimPose preRot, postRot;
+                if (usePreAndPostPose) {
+                    preRot = animSkeleton.getPreRotationPose(animJoint);
+                    postRot = animSkeleton.getPostRotationPose(animJoint);
+                } else {
+                    // In order to support Blender, which does not have preRotation FBX support, we use the models defaultPose as the reference frame for the animations.
+                    preRot = AnimPose(glm::vec3(1.0f), _skeleton->getRelativeBindPose(skeletonJoint).rot, glm::vec3());
+                    postRot = AnimPose::identity;
+                }
+
+                // cancel out scale
+                preRot.scale = glm::vec3(1.0f);
+                postRot.scale = glm::vec3(1.0f);
+
+                AnimPose rot(glm::vec3(1.0f), fbxAnimRot, glm::vec3());
+
+                // adjust translation offsets, so large translation animatons on the reference skeleton
+                // will be adjusted when played on a skeleton with short limbs.
+                const glm::vec3& fbxZeroTrans = geom.animationFrames[0].translations[animJoint];
+                const AnimPose& relDefaultPose = _skeleton->getRelativeDefaultPose(skeletonJoint);
+                float boneLengthScale = 1.0f;
+                const float EPSILON = 0.0001f;
+                if (fabsf(glm::length(fbxZeroTrans)) > EPSILON) {
+                    boneLengthScale = glm::length(relDefaultPose.trans) / glm::length(fbxZeroTrans);
+                }
+
+                AnimPose trans = AnimPose(glm::vec3(1.0f), glm::quat(), relDefaultPose.trans + boneLengthScale * (fbxAnimTrans - fbxZeroTrans));
+
+                frames[frame][skeletonJoint] = trans * preRot * rot * postRot;
+            }
+        }
+    }
+
+    compress(frames, _tracks);
+}
+
+void AnimCompressedClip::getFrame(int frame, bool mirror, AnimPoseVec& poses) const {
+    poses.resize(_skeleton->getNumJoints());
+    if (_numFrames == 0) {
+        return;
+    }
+    frame = std::min(std::max(0, frame), _numFrames - 1);
+
+    if (mirror) {
+        std::call_once(_mirrorTracksBuilt, [this] {
+            std::vector<AnimPoseVec> frames(_numFrames);
+            for (int i = 0; i < _numFrames; i++) {
+                decompress(_tracks, i, frames[i]);
+                _skeleton->mirrorRelativePoses(frames[i]);
+            }
+            compress(frames, _mirrorTracks);
+        });
+        decompress(_mirrorTracks, frame, poses);
+    } else {
+        decompress(_tracks, frame, poses);
+    }
+}
+
+static AnimCompressedClip::QuantizedQuat quantize(const glm::quat& rotation);
+
+// Returns the frames of the samples to keep as keys, so the samples in between are interpolated from their keys within
+// tolerance. The keys are picked greedily, each one as far as the interpolation from the previous one allows.
+template <typename T, typename Fits>
+static std::vector<int> reduceKeys(const std::vector<T>& samples, Fits fits) {
+    std::vector<int> keys { 0 };
+    int numSamples = (int)samples.size();
+
+    // most tracks don't move at all
+    bool isConstant = true;
+    for (int i = 1; i < numSamples && isConstant; i++) {
+        isConstant = fits(samples[0], samples[0], 0.0f, samples[i]);
+    }
+    if (isConstant) {
+        return keys;
+    }
+
+    int start = 0;
+    while (start < numSamples - 1) {
+        int end = start + 1;
+        while (end + 1 < numSamples) {
+            int candidate = end + 1;
+            bool fitsAll = true;
+            for (int i = start + 1; i < candidate && fitsAll; i++) {
+                float alpha = (float)(i - start) / (float)(candidate - start);
+                fitsAll = fits(samples[start], samples[candidate], alpha, samples[i]);
+            }
+            if (!fitsAll) {
+                break;
+            }
+            end = candidate;
+        }
+        keys.push_back(end);
+        start = end;
+    }
+    return keys;
+}
+
+void AnimCompressedClip::compress(const std::vector<AnimPoseVec>& frames, Tracks& tracks) const {
+    int numJoints = _skeleton->getNumJoints();
+    tracks.clear();
+    tracks.resize(numJoints);
+    if (frames.empty()) {
+        return;
+    }
+
+    std::vector<glm::quat> rotations(frames.size());
+    std::vector<glm::vec3> translations(frames.size());
+    for (int joint = 0; joint < numJoints; joint++) {
+        for (size_t frame = 0; frame < frames.size(); frame++) {
+            rotations[frame] = frames[frame][joint].rot;
+            translations[frame] = frames[frame][joint].trans;
+
+            // keep the rotations in the same hemisphere, so the keys interpolate the short way
+            if (frame > 0 && glm::dot(rotations[frame], rotations[frame - 1]) < 0.0f) {
+                rotations[frame] = -rotations[frame];
+            }
+        }
+
+        JointTrack& track = tracks[joint];
+        auto rotationKeys = reduceKeys(rotations, [](const glm::quat& a, const glm::quat& b, float alpha, const glm::quat& actual) {
+            glm::quat interpolated = glm::normalize(glm::lerp(a, b, alpha));
+            return fabsf(glm::dot(interpolated, actual)) >= ROTATION_TOLERANCE;
+        });
+        for (int key : rotationKeys) {
+            track.rotationFrames.push_back((uint16_t)key);
+            track.rotations.push_back(quantize(rotations[key]));
+        }
+
+        float tolerance = std::max(TRANSLATION_TOLERANCE * glm::length(_skeleton->getRelativeDefaultPose(joint).trans),
+                                   MIN_TRANSLATION_TOLERANCE);
+        auto translationKeys = reduceKeys(translations, [tolerance](const glm::vec3& a, const glm::vec3& b, float alpha,
+                                                                    const glm::vec3& actual) {
+            return glm::distance(glm::mix(a, b, alpha), actual) <= tolerance;
+        });
+        for (int key : translationKeys) {
+            track.translationFrames.push_back((uint16_t)key);
+            track.translations.push_back(translations[key]);
+        }
+    }
+}
+
+static AnimCompressedClip::QuantizedQuat quantize(const glm::quat& rotation) {
+    glm::quat q = glm::normalize(rotation);
+    return {
+        (int16_t)glm::round(q.x * QUAT_QUANTIZATION_SCALE), (int16_t)glm::round(q.y * QUAT_QUANTIZATION_SCALE),
+        (int16_t)glm::round(q.z * QUAT_QUANTIZATION_SCALE), (int16_t)glm::round(q.w * QUAT_QUANTIZATION_SCALE)
+    };
+}
+
+static glm::quat dequantize(const AnimCompressedClip::QuantizedQuat& rotation) {
+    return glm::normalize(glm::quat((float)rotation.w, (float)rotation.x, (float)rotation.y, (float)rotation.z));
+}
+
+// Finds the keys around the frame, and how far the frame is between them
+static void findKeys(const std::vector<uint16_t>& keyFrames, int frame, int& prevKey, int& nextKey, float& alpha) {
+    auto next = std::upper_bound(keyFrames.begin(), keyFrames.end(), (uint16_t)frame);
+    nextKey = std::min((int)(next - keyFrames.begin()), (int)keyFrames.size() - 1);
+    prevKey = std::max(0, (int)(next - keyFrames.begin()) - 1);
+    if (nextKey == prevKey) {
+        alpha = 0.0f;
+    } else {
+        alpha = (float)(frame - keyFrames[prevKey]) / (float)(keyFrames[nextKey] - keyFrames[prevKey]);
+    }
+}
+
+void AnimCompressedClip::decompress(const Tracks& tracks, int frame, AnimPoseVec& poses) const {
+    poses.resize(tracks.size());
+    for (size_t joint = 0; joint < tracks.size(); joint++) {
+        const JointTrack& track = tracks[joint];
+        AnimPose& pose = poses[joint];
+        pose.scale = glm::vec3(1.0f);
+
+        int prevKey, nextKey;
+        float alpha;
+        findKeys(track.rotationFrames, frame, prevKey, nextKey, alpha);
+        if (alpha == 0.0f) {
+            pose.rot = dequantize(track.rotations[prevKey]);
+        } else {
+            pose.rot = glm::normalize(glm::lerp(dequantize(track.rotations[prevKey]), dequantize(track.rotations[nextKey]), alpha));
+        }
+
+        findKeys(track.translationFrames, frame, prevKey, nextKey, alpha);
+        pose.trans = glm::mix(track.translations[prevKey], track.translations[nextKey], alpha);
+    }
+}
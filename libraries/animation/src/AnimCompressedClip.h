@@ -0,0 +1,69 @@
+//
+//  AnimCompressedClip.h
+//
+//  Created by Sam Gateau on 10/15/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AnimCompressedClip_h
+#define hifi_AnimCompressedClip_h
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "AnimationCache.h"
+#include "AnimSkeleton.h"
+
+// The frames of an animation retargeted onto a skeleton, shared by all the clips playing that animation on that skeleton.
+// Each joint keeps only the keyframes its motion can't be linearly interpolated from, with the rotations quantized to
+// 16 bits per component, so the joints that don't move or move steadily take almost no memory.
+class AnimCompressedClip {
+public:
+    using Pointer = std::shared_ptr<const AnimCompressedClip>;
+
+    // Returns the clip of the loaded animation on the skeleton, retargeting it on first use
+    static Pointer getClip(const AnimationPointer& animation, const AnimSkeleton::ConstPointer& skeleton, bool usePreAndPostPose);
+
+    AnimCompressedClip(const FBXGeometry& animGeometry, const QString& url, const AnimSkeleton::ConstPointer& skeleton,
+                       bool usePreAndPostPose);
+
+    int getNumFrames() const { return _numFrames; }
+
+    // Decompresses the relative poses of the skeleton at the frame, the mirrored tracks are built on first use
+    void getFrame(int frame, bool mirror, AnimPoseVec& poses) const;
+
+    struct QuantizedQuat {
+        int16_t x, y, z, w;
+    };
+
+protected:
+    struct JointTrack {
+        std::vector<uint16_t> rotationFrames;
+        std::vector<QuantizedQuat> rotations;
+        std::vector<uint16_t> translationFrames;
+        std::vector<glm::vec3> translations;
+    };
+    using Tracks = std::vector<JointTrack>;
+
+    // frames[frame][joint]
+    void compress(const std::vector<AnimPoseVec>& frames, Tracks& tracks) const;
+    void decompress(const Tracks& tracks, int frame, AnimPoseVec& poses) const;
+
+    AnimSkeleton::ConstPointer _skeleton;
+    int _numFrames { 0 };
+    Tracks _tracks;
+
+    mutable std::once_flag _mirrorTracksBuilt;
+    mutable Tracks _mirrorTracks;
+
+    // no copies
+    AnimCompressedClip(const AnimCompressedClip&) = delete;
+    AnimCompressedClip& operator=(const AnimCompressedClip&) = delete;
+};
+
+#endif // hifi_AnimCompressedClip_h
@@ -569,7 +569,7 @@ void AnimExpression::evalUnaryMinus(const AnimVariantMap& map, std::stack<OpCode
 
     switch (rhs.type) {
     case OpCode::Identifier: {
-        const AnimVariant& var = map.get(rhs.strVal);
+        const AnimVariant& var = map.get(rhs.varKey);
         switch (var.getType()) {
         case AnimVariant::Type::Bool:
             qCWarning(animation) << "AnimExpression: type missmatch for unary minus, expected a number not a bool";
@@ -612,7 +612,7 @@ AnimExpression::OpCode AnimExpression::coerseToValue(const AnimVariantMap& map,
     switch (opCode.type) {
     case OpCode::Identifier:
         {
-            const AnimVariant& var = map.get(opCode.strVal);
+            const AnimVariant& var = map.get(opCode.varKey);
             switch (var.getType()) {
             case AnimVariant::Type::Bool:
                 return OpCode((bool)var.getBool());
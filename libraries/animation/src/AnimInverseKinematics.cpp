@@ -145,17 +145,37 @@ void AnimInverseKinematics::solveWithCyclicCoordinateDescent(const std::vector<I
         accumulator.clearAndClean();
     }
 
-    float maxError = FLT_MAX;
-    int numLoops = 0;
+    // the poses start from the last frame's solution relaxed toward the under poses, so the targets that
+    // moved little are often already met, and are only held in place rather than solved again
+    std::vector<float> errors(targets.size(), FLT_MAX);
+    auto computeErrors = [&] {
+        float maxError = 0.0f;
+        for (size_t i = 0; i < targets.size(); i++) {
+            if (targets[i].getType() == IKTarget::Type::RotationAndPosition || targets[i].getType() == IKTarget::Type::HmdHead ||
+                targets[i].getType() == IKTarget::Type::HipsRelativeRotationAndPosition) {
+                errors[i] = glm::length(absolutePoses[targets[i].getIndex()].trans - targets[i].getTranslation());
+                if (errors[i] > maxError) {
+                    maxError = errors[i];
+                }
+            }
+        }
+        return maxError;
+    };
+
     const int MAX_IK_LOOPS = 16;
     const float MAX_ERROR_TOLERANCE = 0.1f; // cm
-    while (maxError > MAX_ERROR_TOLERANCE && numLoops < MAX_IK_LOOPS) {
+    float maxError = computeErrors();
+    int numLoops = 0;
+    do {
         ++numLoops;
 
-        // solve all targets
+        // solve the targets not yet met, the others hold their chains so the joints they share with the
+        // targets being solved still average toward where they are
         int lowestMovedIndex = (int)_relativePoses.size();
-        for (auto& target: targets) {
-            int lowIndex = solveTargetWithCCD(target, absolutePoses);
+        for (size_t i = 0; i < targets.size(); i++) {
+            const IKTarget& target = targets[i];
+            bool isMet = errors[i] <= MAX_ERROR_TOLERANCE && target.getType() != IKTarget::Type::HmdHead;
+            int lowIndex = isMet ? holdTargetChain(target) : solveTargetWithCCD(target, absolutePoses);
             if (lowIndex < lowestMovedIndex) {
                 lowestMovedIndex = lowIndex;
             }
@@ -177,18 +197,8 @@ void AnimInverseKinematics::solveWithCyclicCoordinateDescent(const std::vector<I
             }
         }
 
-        // compute maxError
-        maxError = 0.0f;
-        for (size_t i = 0; i < targets.size(); i++) {
-            if (targets[i].getType() == IKTarget::Type::RotationAndPosition || targets[i].getType() == IKTarget::Type::HmdHead ||
-                targets[i].getType() == IKTarget::Type::HipsRelativeRotationAndPosition) {
-                float error = glm::length(absolutePoses[targets[i].getIndex()].trans - targets[i].getTranslation());
-                if (error > maxError) {
-                    maxError = error;
-                }
-            }
-        }
-    }
+        maxError = computeErrors();
+    } while (maxError > MAX_ERROR_TOLERANCE && numLoops < MAX_IK_LOOPS);
 
     // finally set the relative rotation of each tip to agree with absolute target rotation
     for (auto& target: targets) {
@@ -375,6 +385,30 @@ int AnimInverseKinematics::solveTargetWithCCD(const IKTarget& target, AnimPoseVe
     return lowestMovedIndex;
 }
 
+int AnimInverseKinematics::holdTargetChain(const IKTarget& target) {
+    // adds the current rotations of the joints solveTargetWithCCD would pivot, which marks them as affected by IK
+    // and weighs the joints shared with other targets toward staying put, without the cost of the constraints
+    int lowestHeldIndex = (int)_relativePoses.size();
+    if (target.getType() == IKTarget::Type::RotationOnly) {
+        return lowestHeldIndex;
+    }
+
+    int pivotIndex = _skeleton->getParentIndex(target.getIndex());
+    if (pivotIndex == -1) {
+        return lowestHeldIndex;
+    }
+    int pivotsParentIndex = _skeleton->getParentIndex(pivotIndex);
+    while (pivotIndex != _hipsIndex && pivotsParentIndex != -1) {
+        _accumulators[pivotIndex].add(_relativePoses[pivotIndex].rot, target.getWeight());
+        if (pivotIndex < lowestHeldIndex) {
+            lowestHeldIndex = pivotIndex;
+        }
+        pivotIndex = pivotsParentIndex;
+        pivotsParentIndex = _skeleton->getParentIndex(pivotIndex);
+    }
+    return lowestHeldIndex;
+}
+
 //virtual
 const AnimPoseVec& AnimInverseKinematics::evaluate(const AnimVariantMap& animVars, float dt, AnimNode::Triggers& triggersOut) {
     // don't call this function, call overlay() instead
@@ -43,6 +43,7 @@ protected:
     void computeTargets(const AnimVariantMap& animVars, std::vector<IKTarget>& targets, const AnimPoseVec& underPoses);
     void solveWithCyclicCoordinateDescent(const std::vector<IKTarget>& targets);
     int solveTargetWithCCD(const IKTarget& target, AnimPoseVec& absolutePoses);
+    int holdTargetChain(const IKTarget& target);
     virtual void setSkeletonInternal(AnimSkeleton::ConstPointer skeleton) override;
 
     // for AnimDebugDraw rendering
@@ -68,9 +69,9 @@ protected:
             jointIndex(-1)
         {}
 
-        QString positionVar;
-        QString rotationVar;
-        QString typeVar;
+        AnimVarKey positionVar;
+        AnimVarKey rotationVar;
+        AnimVarKey typeVar;
         QString jointName;
         int jointIndex; // cached joint index
     };
@@ -39,7 +39,7 @@ public:
         };
 
         JointVar(const QString& varIn, const QString& jointNameIn, Type typeIn) : var(varIn), jointName(jointNameIn), type(typeIn), jointIndex(-1), hasPerformedJointLookup(false) {}
-        QString var = "";
+        AnimVarKey var;
         QString jointName = "";
         Type type = Type::AbsoluteRotation;
         int jointIndex = -1;
@@ -59,7 +59,7 @@ protected:
 
     AnimPoseVec _poses;
     float _alpha;
-    QString _alphaVar;
+    AnimVarKey _alphaVar;
 
     std::vector<JointVar> _jointVars;
 
@@ -8,10 +8,13 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <mutex>
+
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QFile>
+#include <QHash>
 
 #include "AnimNode.h"
 #include "AnimClip.h"
@@ -571,9 +574,23 @@ bool processStateMachineNode(AnimNode::Pointer node, const QJsonObject& jsonObj,
     return true;
 }
 
+// the graphs parsed by the loaders still alive
+static std::mutex loadedGraphsMutex;
+static QHash<QUrl, std::weak_ptr<const QJsonObject>> loadedGraphs;
+
 AnimNodeLoader::AnimNodeLoader(const QUrl& url) :
     _url(url)
 {
+    {
+        std::lock_guard<std::mutex> lock(loadedGraphsMutex);
+        _graph = loadedGraphs.value(url).lock();
+    }
+    if (_graph) {
+        // signal once the caller had a chance to connect, as a download would
+        QMetaObject::invokeMethod(this, "onGraphLoaded", Qt::QueuedConnection);
+        return;
+    }
+
     _resource = QSharedPointer<Resource>::create(url);
     _resource->setSelf(_resource);
     connect(_resource.data(), &Resource::loaded, this, &AnimNodeLoader::onRequestDone);
@@ -581,7 +598,7 @@ AnimNodeLoader::AnimNodeLoader(const QUrl& url) :
     _resource->ensureLoading();
 }
 
-AnimNode::Pointer AnimNodeLoader::load(const QByteArray& contents, const QUrl& jsonUrl) {
+AnimNodeLoader::Graph AnimNodeLoader::parse(const QByteArray& contents, const QUrl& jsonUrl) {
 
     // convert string into a json doc
     QJsonParseError error;
@@ -613,11 +630,24 @@ AnimNode::Pointer AnimNodeLoader::load(const QByteArray& contents, const QUrl& j
         return nullptr;
     }
 
-    return loadNode(rootVal.toObject(), jsonUrl);
+    return std::make_shared<const QJsonObject>(rootVal.toObject());
+}
+
+AnimNode::Pointer AnimNodeLoader::load(const QJsonObject& root, const QUrl& jsonUrl) {
+    return loadNode(root, jsonUrl);
 }
 
 void AnimNodeLoader::onRequestDone(const QByteArray data) {
-    auto node = load(data, _url);
+    _graph = parse(data, _url);
+    if (_graph) {
+        std::lock_guard<std::mutex> lock(loadedGraphsMutex);
+        loadedGraphs.insert(_url, _graph);
+    }
+    onGraphLoaded();
+}
+
+void AnimNodeLoader::onGraphLoaded() {
+    auto node = _graph ? load(*_graph, _url) : nullptr;
     if (node) {
         emit success(node);
     } else {
@@ -13,6 +13,7 @@
 
 #include <memory>
 
+#include <QJsonObject>
 #include <QNetworkReply>
 #include <QString>
 #include <QUrl>
@@ -32,17 +33,24 @@ signals:
     void error(int error, QString str);
 
 protected:
+    using Graph = std::shared_ptr<const QJsonObject>;
+
     // synchronous
-    static AnimNode::Pointer load(const QByteArray& contents, const QUrl& jsonUrl);
+    static Graph parse(const QByteArray& contents, const QUrl& jsonUrl);
+    static AnimNode::Pointer load(const QJsonObject& root, const QUrl& jsonUrl);
 
 protected slots:
     void onRequestDone(const QByteArray data);
     void onRequestError(QNetworkReply::NetworkError error);
+    void onGraphLoaded();
 
 protected:
     QUrl _url;
     QSharedPointer<Resource> _resource;
 
+    // the parsed graph is shared by the loaders of its url, each of them builds its own nodes from it
+    Graph _graph;
+
 private:
 
     // no copies
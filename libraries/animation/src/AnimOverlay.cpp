@@ -52,6 +52,13 @@ const AnimPoseVec& AnimOverlay::evaluate(const AnimVariantMap& animVars, float d
 
     if (_children.size() >= 2) {
         auto& underPoses = _children[1]->evaluate(animVars, dt, triggersOut);
+
+        if (_alpha == 0.0f) {
+            // the overlay is faded out (the ik of a distant avatar for instance), don't evaluate it
+            _poses = underPoses;
+            return _poses;
+        }
+
         auto& overPoses = _children[0]->overlay(animVars, dt, triggersOut, underPoses);
 
         if (underPoses.size() > 0 && underPoses.size() == overPoses.size()) {
@@ -60,8 +60,8 @@ public:
     float _alpha;
     std::vector<float> _boneSetVec;
 
-    QString _boneSetVar;
-    QString _alphaVar;
+    AnimVarKey _boneSetVar;
+    AnimVarKey _alphaVar;
 
     void buildFullBodyBoneSet();
     void buildUpperBodyBoneSet();
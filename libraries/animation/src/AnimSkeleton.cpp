@@ -10,6 +10,9 @@
 
 #include "AnimSkeleton.h"
 
+#include <map>
+#include <mutex>
+
 #include <glm/gtx/transform.hpp>
 
 #include <GLMHelpers.h>
@@ -26,6 +29,29 @@ AnimSkeleton::AnimSkeleton(const FBXGeometry& fbxGeometry) {
     buildSkeletonFromJoints(joints);
 }
 
+AnimSkeleton::Pointer AnimSkeleton::getSharedSkeleton(const std::shared_ptr<const FBXGeometry>& fbxGeometry) {
+    using GeometryKey = std::weak_ptr<const FBXGeometry>;
+    static std::mutex mutex;
+    static std::map<GeometryKey, std::weak_ptr<AnimSkeleton>, std::owner_less<GeometryKey>> skeletons;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto it = skeletons.begin(); it != skeletons.end();) {
+        if (it->second.expired()) {
+            it = skeletons.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    auto& sharedSkeleton = skeletons[fbxGeometry];
+    Pointer skeleton = sharedSkeleton.lock();
+    if (!skeleton) {
+        skeleton = std::make_shared<AnimSkeleton>(*fbxGeometry);
+        sharedSkeleton = skeleton;
+    }
+    return skeleton;
+}
+
 AnimSkeleton::AnimSkeleton(const std::vector<FBXJoint>& joints) {
     buildSkeletonFromJoints(joints);
 }
@@ -118,26 +144,21 @@ void AnimSkeleton::convertAbsoluteRotationsToRelative(std::vector<glm::quat>& ro
     }
 }
 
-void AnimSkeleton::saveNonMirroredPoses(const AnimPoseVec& poses) const {
-    _nonMirroredPoses.clear();
-    for (int i = 0; i < (int)_nonMirroredIndices.size(); ++i) {
-        _nonMirroredPoses.push_back(poses[_nonMirroredIndices[i]]);
-    }
-}
-
-void AnimSkeleton::restoreNonMirroredPoses(AnimPoseVec& poses) const {
+void AnimSkeleton::mirrorRelativePoses(AnimPoseVec& poses) const {
+    // the skeleton is shared by the rigs, so the poses that don't mirror are saved locally
+    AnimPoseVec nonMirroredPoses;
+    nonMirroredPoses.reserve(_nonMirroredIndices.size());
     for (int i = 0; i < (int)_nonMirroredIndices.size(); ++i) {
-        int index = _nonMirroredIndices[i];
-        poses[index] = _nonMirroredPoses[i];
+        nonMirroredPoses.push_back(poses[_nonMirroredIndices[i]]);
     }
-}
 
-void AnimSkeleton::mirrorRelativePoses(AnimPoseVec& poses) const {
-    saveNonMirroredPoses(poses);
     convertRelativePosesToAbsolute(poses);
     mirrorAbsolutePoses(poses);
     convertAbsolutePosesToRelative(poses);
-    restoreNonMirroredPoses(poses);
+
+    for (int i = 0; i < (int)_nonMirroredIndices.size(); ++i) {
+        poses[_nonMirroredIndices[i]] = nonMirroredPoses[i];
+    }
 }
 
 void AnimSkeleton::mirrorAbsolutePoses(AnimPoseVec& poses) const {
@@ -25,6 +25,10 @@ public:
 
     explicit AnimSkeleton(const FBXGeometry& fbxGeometry);
     explicit AnimSkeleton(const std::vector<FBXJoint>& joints);
+
+    // The skeletons are immutable, so all the rigs of a geometry share its skeleton
+    static Pointer getSharedSkeleton(const std::shared_ptr<const FBXGeometry>& fbxGeometry);
+
     int nameToJointIndex(const QString& jointName) const;
     const QString& getJointName(int jointIndex) const;
     int getNumJoints() const;
@@ -57,9 +61,6 @@ public:
 
     void convertAbsoluteRotationsToRelative(std::vector<glm::quat>& rotations) const;
 
-    void saveNonMirroredPoses(const AnimPoseVec& poses) const;
-    void restoreNonMirroredPoses(AnimPoseVec& poses) const;
-
     void mirrorRelativePoses(AnimPoseVec& poses) const;
     void mirrorAbsolutePoses(AnimPoseVec& poses) const;
 
@@ -76,7 +77,6 @@ protected:
     AnimPoseVec _absoluteDefaultPoses;
     AnimPoseVec _relativePreRotationPoses;
     AnimPoseVec _relativePostRotationPoses;
-    mutable AnimPoseVec _nonMirroredPoses;
     std::vector<int> _nonMirroredIndices;
     std::vector<int> _mirrorMap;
 
@@ -65,7 +65,7 @@ protected:
             friend AnimStateMachine;
             Transition(const QString& var, State::Pointer state) : _var(var), _state(state) {}
         protected:
-            QString _var;
+            AnimVarKey _var;
             State::Pointer _state;
         };
 
@@ -96,9 +96,9 @@ protected:
         float _interpDuration; // frames
         InterpType _interpType;
 
-        QString _interpTargetVar;
-        QString _interpDurationVar;
-        QString _interpTypeVar;
+        AnimVarKey _interpTargetVar;
+        AnimVarKey _interpDurationVar;
+        AnimVarKey _interpTypeVar;
 
         std::vector<Transition> _transitions;
 
@@ -142,7 +142,7 @@ protected:
     State::Pointer _currentState;
     std::vector<State::Pointer> _states;
 
-    QString _currentStateVar;
+    AnimVarKey _currentStateVar;
 
 private:
     // no copies
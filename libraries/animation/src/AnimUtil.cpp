@@ -11,10 +11,7 @@
 #include "AnimUtil.h"
 #include "GLMHelpers.h"
 
-// TODO: use restrict keyword
-// TODO: excellent candidate for simd vectorization.
-
-void blend(size_t numPoses, const AnimPose* a, const AnimPose* b, float alpha, AnimPose* result) {
+static void blendScalar(size_t numPoses, const AnimPose* a, const AnimPose* b, float alpha, AnimPose* result) {
     for (size_t i = 0; i < numPoses; i++) {
         const AnimPose& aPose = a[i];
         const AnimPose& bPose = b[i];
@@ -33,6 +30,95 @@ void blend(size_t numPoses, const AnimPose* a, const AnimPose* b, float alpha, A
     }
 }
 
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+
+#include <cstddef>
+#include <emmintrin.h>
+
+#include "CPUDetect.h"
+
+// The simd versions read the poses as arrays of floats
+static_assert(sizeof(AnimPose) == ANIM_POSE_FLOATS * sizeof(float), "AnimPose must be packed floats");
+static_assert(offsetof(AnimPose, rot) == ANIM_POSE_ROT_OFFSET * sizeof(float), "AnimPose rotation must follow the scale");
+
+// Blends the poses 4 at a time, with the rotations transposed to one register per component.
+// Returns the number of poses blended, the rest are left to the scalar version.
+static size_t blend_SSE(size_t numPoses, const AnimPose* a, const AnimPose* b, float alpha, AnimPose* result) {
+    const int POSES = 4;
+    const __m128 alphaA = _mm_set1_ps(1.0f - alpha);
+    const __m128 alphaB = _mm_set1_ps(alpha);
+    const __m128 signBit = _mm_set1_ps(-0.0f);
+
+    size_t numBlended = numPoses - numPoses % POSES;
+    for (size_t i = 0; i < numBlended; i += POSES) {
+        const float* pa = reinterpret_cast<const float*>(a + i);
+        const float* pb = reinterpret_cast<const float*>(b + i);
+        float* pr = reinterpret_cast<float*>(result + i);
+
+        __m128 a0 = _mm_loadu_ps(pa + 0 * ANIM_POSE_FLOATS + ANIM_POSE_ROT_OFFSET);
+        __m128 a1 = _mm_loadu_ps(pa + 1 * ANIM_POSE_FLOATS + ANIM_POSE_ROT_OFFSET);
+        __m128 a2 = _mm_loadu_ps(pa + 2 * ANIM_POSE_FLOATS + ANIM_POSE_ROT_OFFSET);
+        __m128 a3 = _mm_loadu_ps(pa + 3 * ANIM_POSE_FLOATS + ANIM_POSE_ROT_OFFSET);
+        __m128 b0 = _mm_loadu_ps(pb + 0 * ANIM_POSE_FLOATS + ANIM_POSE_ROT_OFFSET);
+        __m128 b1 = _mm_loadu_ps(pb + 1 * ANIM_POSE_FLOATS + ANIM_POSE_ROT_OFFSET);
+        __m128 b2 = _mm_loadu_ps(pb + 2 * ANIM_POSE_FLOATS + ANIM_POSE_ROT_OFFSET);
+        __m128 b3 = _mm_loadu_ps(pb + 3 * ANIM_POSE_FLOATS + ANIM_POSE_ROT_OFFSET);
+        _MM_TRANSPOSE4_PS(a0, a1, a2, a3);
+        _MM_TRANSPOSE4_PS(b0, b1, b2, b3);
+
+        // adjust signs if necessary
+        __m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a0, b0), _mm_mul_ps(a1, b1)),
+                                _mm_add_ps(_mm_mul_ps(a2, b2), _mm_mul_ps(a3, b3)));
+        __m128 sign = _mm_and_ps(_mm_cmplt_ps(dot, _mm_setzero_ps()), signBit);
+        b0 = _mm_xor_ps(b0, sign);
+        b1 = _mm_xor_ps(b1, sign);
+        b2 = _mm_xor_ps(b2, sign);
+        b3 = _mm_xor_ps(b3, sign);
+
+        // nlerp
+        __m128 r0 = _mm_add_ps(_mm_mul_ps(a0, alphaA), _mm_mul_ps(b0, alphaB));
+        __m128 r1 = _mm_add_ps(_mm_mul_ps(a1, alphaA), _mm_mul_ps(b1, alphaB));
+        __m128 r2 = _mm_add_ps(_mm_mul_ps(a2, alphaA), _mm_mul_ps(b2, alphaB));
+        __m128 r3 = _mm_add_ps(_mm_mul_ps(a3, alphaA), _mm_mul_ps(b3, alphaB));
+        __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(r0, r0), _mm_mul_ps(r1, r1)),
+                                               _mm_add_ps(_mm_mul_ps(r2, r2), _mm_mul_ps(r3, r3))));
+        r0 = _mm_div_ps(r0, length);
+        r1 = _mm_div_ps(r1, length);
+        r2 = _mm_div_ps(r2, length);
+        r3 = _mm_div_ps(r3, length);
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+        // lerp the 4 poses as a whole, the lerped rotations are then replaced by the normalized ones
+        for (int j = 0; j < POSES * ANIM_POSE_FLOATS; j += 4) {
+            __m128 va = _mm_loadu_ps(pa + j);
+            __m128 vb = _mm_loadu_ps(pb + j);
+            _mm_storeu_ps(pr + j, _mm_add_ps(_mm_mul_ps(va, alphaA), _mm_mul_ps(vb, alphaB)));
+        }
+
+        _mm_storeu_ps(pr + 0 * ANIM_POSE_FLOATS + ANIM_POSE_ROT_OFFSET, r0);
+        _mm_storeu_ps(pr + 1 * ANIM_POSE_FLOATS + ANIM_POSE_ROT_OFFSET, r1);
+        _mm_storeu_ps(pr + 2 * ANIM_POSE_FLOATS + ANIM_POSE_ROT_OFFSET, r2);
+        _mm_storeu_ps(pr + 3 * ANIM_POSE_FLOATS + ANIM_POSE_ROT_OFFSET, r3);
+    }
+    return numBlended;
+}
+
+size_t blend_AVX(size_t numPoses, const AnimPose* a, const AnimPose* b, float alpha, AnimPose* result);
+
+void blend(size_t numPoses, const AnimPose* a, const AnimPose* b, float alpha, AnimPose* result) {
+    static auto f = cpuSupportsAVX() ? blend_AVX : blend_SSE;
+    size_t numBlended = (*f)(numPoses, a, b, alpha, result); // dispatch
+    blendScalar(numPoses - numBlended, a + numBlended, b + numBlended, alpha, result + numBlended);
+}
+
+#else
+
+void blend(size_t numPoses, const AnimPose* a, const AnimPose* b, float alpha, AnimPose* result) {
+    blendScalar(numPoses, a, b, alpha, result);
+}
+
+#endif
+
 float accumulateTime(float startFrame, float endFrame, float timeScale, float currentFrame, float dt, bool loopFlag,
                      const QString& id, AnimNode::Triggers& triggersOut) {
 
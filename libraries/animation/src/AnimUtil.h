@@ -13,7 +13,12 @@
 
 #include "AnimNode.h"
 
+// The layout of AnimPose as floats, used by the simd versions of blend
+const int ANIM_POSE_FLOATS = 10;
+const int ANIM_POSE_ROT_OFFSET = 3;
+
 // this is where the magic happens
+// the poses are blended in order, result may be a or b
 void blend(size_t numPoses, const AnimPose* a, const AnimPose* b, float alpha, AnimPose* result);
 
 float accumulateTime(float startFrame, float endFrame, float timeScale, float currentFrame, float dt, bool loopFlag,
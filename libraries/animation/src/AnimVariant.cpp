@@ -9,6 +9,8 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <QHash>
+#include <QReadWriteLock>
 #include <QScriptEngine>
 #include <QScriptValueIterator>
 #include <QThread>
@@ -17,6 +19,53 @@
 
 const AnimVariant AnimVariant::False = AnimVariant();
 
+// the slots of the names, grown by the anim graphs and scripts as they use new vars
+static QReadWriteLock& slotsLock() {
+    static QReadWriteLock lock;
+    return lock;
+}
+
+static QHash<QString, int>& slotsByName() {
+    static QHash<QString, int> slots;
+    return slots;
+}
+
+static std::vector<QString>& namesBySlot() {
+    static std::vector<QString> names;
+    return names;
+}
+
+AnimVarKey::AnimVarKey(const QString& name) {
+    if (name.isEmpty()) {
+        return;
+    }
+    {
+        QReadLocker locker(&slotsLock());
+        auto iter = slotsByName().constFind(name);
+        if (iter != slotsByName().constEnd()) {
+            _slot = iter.value();
+            return;
+        }
+    }
+    QWriteLocker locker(&slotsLock());
+    auto iter = slotsByName().constFind(name);
+    if (iter != slotsByName().constEnd()) {
+        _slot = iter.value();
+    } else {
+        _slot = (int)namesBySlot().size();
+        namesBySlot().push_back(name);
+        slotsByName().insert(name, _slot);
+    }
+}
+
+QString AnimVarKey::nameOfSlot(int slot) {
+    if (slot < 0) {
+        return QString();
+    }
+    QReadLocker locker(&slotsLock());
+    return namesBySlot()[slot];
+}
+
 QScriptValue AnimVariantMap::animVariantMapToScriptValue(QScriptEngine* engine, const QStringList& names, bool useNames) const {
     if (QThread::currentThread() != engine->thread()) {
         qCWarning(animation) << "Cannot create Javacript object from non-script thread" << QThread::currentThread();
@@ -51,24 +100,34 @@ QScriptValue AnimVariantMap::animVariantMapToScriptValue(QScriptEngine* engine,
     };
     if (useNames) { // copy only the requested names
         for (const QString& name : names) {
-            auto search = _map.find(name);
-            if (search != _map.end()) {
-                setOne(name, search->second);
-            } else if (_triggers.count(name) == 1) {
+            AnimVarKey key(name);
+            const AnimVariant* variant = find(key);
+            if (variant) {
+                setOne(name, *variant);
+            } else if (isTriggerSet(key)) {
                 target.setProperty(name, true);
             } // scripts are allowed to request names that do not exist
         }
 
     } else {  // copy all of them
-        for (auto& pair : _map) {
-            setOne(pair.first, pair.second);
+        for (int slot = 0; slot < (int)_map.size(); slot++) {
+            if (_isSet[slot]) {
+                setOne(AnimVarKey::nameOfSlot(slot), _map[slot]);
+            }
         }
     }
     return target;
 }
 void AnimVariantMap::copyVariantsFrom(const AnimVariantMap& other) {
-    for (auto& pair : other._map) {
-        _map[pair.first] = pair.second;
+    if (other._map.size() > _map.size()) {
+        _map.resize(other._map.size());
+        _isSet.resize(other._isSet.size(), false);
+    }
+    for (int slot = 0; slot < (int)other._map.size(); slot++) {
+        if (other._isSet[slot]) {
+            _map[slot] = other._map[slot];
+            _isSet[slot] = true;
+        }
     }
 }
 
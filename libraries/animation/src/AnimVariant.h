@@ -15,8 +15,7 @@
 #include <functional>
 #include <glm/glm.hpp>
 #include <glm/gtx/quaternion.hpp>
-#include <map>
-#include <set>
+#include <vector>
 #include <QScriptValue>
 #include <StreamUtils.h>
 #include <GLMHelpers.h>
@@ -114,93 +113,100 @@ protected:
     } _val;
 };
 
+// The name of an anim var resolved once to its slot in the AnimVariantMaps, so the nodes holding their vars as keys
+// look them up by index instead of comparing strings at every evaluation.
+// The slots are shared by all the maps, the names are never released.
+class AnimVarKey {
+public:
+    AnimVarKey() {}
+    AnimVarKey(const QString& name);
+    AnimVarKey(const char* name) : AnimVarKey(QString(name)) {}
+
+    bool isEmpty() const { return _slot < 0; }
+    int getSlot() const { return _slot; }
+    QString getName() const { return nameOfSlot(_slot); }
+
+    static QString nameOfSlot(int slot);
+
+    bool operator==(const AnimVarKey& other) const { return _slot == other._slot; }
+    bool operator!=(const AnimVarKey& other) const { return _slot != other._slot; }
+
+private:
+    int _slot { -1 };
+};
+
+inline QDebug operator<<(QDebug debug, const AnimVarKey& key) {
+    return debug << key.getName();
+}
+
 class AnimVariantMap {
 public:
 
-    bool lookup(const QString& key, bool defaultValue) const {
+    bool lookup(const AnimVarKey& key, bool defaultValue) const {
         // check triggers first, then map
-        if (key.isEmpty()) {
-            return defaultValue;
-        } else if (_triggers.find(key) != _triggers.end()) {
+        if (isTriggerSet(key)) {
             return true;
         } else {
-            auto iter = _map.find(key);
-            return iter != _map.end() ? iter->second.getBool() : defaultValue;
+            const AnimVariant* variant = find(key);
+            return variant ? variant->getBool() : defaultValue;
         }
     }
 
-    int lookup(const QString& key, int defaultValue) const {
-        if (key.isEmpty()) {
-            return defaultValue;
-        } else {
-            auto iter = _map.find(key);
-            return iter != _map.end() ? iter->second.getInt() : defaultValue;
-        }
+    int lookup(const AnimVarKey& key, int defaultValue) const {
+        const AnimVariant* variant = find(key);
+        return variant ? variant->getInt() : defaultValue;
     }
 
-    float lookup(const QString& key, float defaultValue) const {
-        if (key.isEmpty()) {
-            return defaultValue;
-        } else {
-            auto iter = _map.find(key);
-            return iter != _map.end() ? iter->second.getFloat() : defaultValue;
-        }
+    float lookup(const AnimVarKey& key, float defaultValue) const {
+        const AnimVariant* variant = find(key);
+        return variant ? variant->getFloat() : defaultValue;
     }
 
-    const glm::vec3& lookupRaw(const QString& key, const glm::vec3& defaultValue) const {
-        if (key.isEmpty()) {
-            return defaultValue;
-        } else {
-            auto iter = _map.find(key);
-            return iter != _map.end() ? iter->second.getVec3() : defaultValue;
-        }
+    const glm::vec3& lookupRaw(const AnimVarKey& key, const glm::vec3& defaultValue) const {
+        const AnimVariant* variant = find(key);
+        return variant ? variant->getVec3() : defaultValue;
     }
 
-    glm::vec3 lookupRigToGeometry(const QString& key, const glm::vec3& defaultValue) const {
-        if (key.isEmpty()) {
-            return defaultValue;
-        } else {
-            auto iter = _map.find(key);
-            return iter != _map.end() ? transformPoint(_rigToGeometryMat, iter->second.getVec3()) : defaultValue;
-        }
+    glm::vec3 lookupRigToGeometry(const AnimVarKey& key, const glm::vec3& defaultValue) const {
+        const AnimVariant* variant = find(key);
+        return variant ? transformPoint(_rigToGeometryMat, variant->getVec3()) : defaultValue;
     }
 
-    const glm::quat& lookupRaw(const QString& key, const glm::quat& defaultValue) const {
-        if (key.isEmpty()) {
-            return defaultValue;
-        } else {
-            auto iter = _map.find(key);
-            return iter != _map.end() ? iter->second.getQuat() : defaultValue;
-        }
+    const glm::quat& lookupRaw(const AnimVarKey& key, const glm::quat& defaultValue) const {
+        const AnimVariant* variant = find(key);
+        return variant ? variant->getQuat() : defaultValue;
     }
 
-    glm::quat lookupRigToGeometry(const QString& key, const glm::quat& defaultValue) const {
-        if (key.isEmpty()) {
-            return defaultValue;
-        } else {
-            auto iter = _map.find(key);
-            return iter != _map.end() ? _rigToGeometryRot * iter->second.getQuat() : defaultValue;
-        }
+    glm::quat lookupRigToGeometry(const AnimVarKey& key, const glm::quat& defaultValue) const {
+        const AnimVariant* variant = find(key);
+        return variant ? _rigToGeometryRot * variant->getQuat() : defaultValue;
     }
 
-    const QString& lookup(const QString& key, const QString& defaultValue) const {
-        if (key.isEmpty()) {
-            return defaultValue;
-        } else {
-            auto iter = _map.find(key);
-            return iter != _map.end() ? iter->second.getString() : defaultValue;
-        }
+    const QString& lookup(const AnimVarKey& key, const QString& defaultValue) const {
+        const AnimVariant* variant = find(key);
+        return variant ? variant->getString() : defaultValue;
     }
 
-    void set(const QString& key, bool value) { _map[key] = AnimVariant(value); }
-    void set(const QString& key, int value) { _map[key] = AnimVariant(value); }
-    void set(const QString& key, float value) { _map[key] = AnimVariant(value); }
-    void set(const QString& key, const glm::vec3& value) { _map[key] = AnimVariant(value); }
-    void set(const QString& key, const glm::quat& value) { _map[key] = AnimVariant(value); }
-    void set(const QString& key, const QString& value) { _map[key] = AnimVariant(value); }
-    void unset(const QString& key) { _map.erase(key); }
+    void set(const AnimVarKey& key, bool value) { setVariant(key, AnimVariant(value)); }
+    void set(const AnimVarKey& key, int value) { setVariant(key, AnimVariant(value)); }
+    void set(const AnimVarKey& key, float value) { setVariant(key, AnimVariant(value)); }
+    void set(const AnimVarKey& key, const glm::vec3& value) { setVariant(key, AnimVariant(value)); }
+    void set(const AnimVarKey& key, const glm::quat& value) { setVariant(key, AnimVariant(value)); }
+    void set(const AnimVarKey& key, const QString& value) { setVariant(key, AnimVariant(value)); }
+    void unset(const AnimVarKey& key) {
+        if (find(key)) {
+            _isSet[key.getSlot()] = false;
+        }
+    }
 
-    void setTrigger(const QString& key) { _triggers.insert(key); }
+    void setTrigger(const AnimVarKey& key) {
+        if (!key.isEmpty()) {
+            if (key.getSlot() >= (int)_triggers.size()) {
+                _triggers.resize(key.getSlot() + 1, false);
+            }
+            _triggers[key.getSlot()] = true;
+        }
+    }
     void clearTriggers() { _triggers.clear(); }
 
     void setRigToGeometryTransform(const glm::mat4& rigToGeometry) {
@@ -208,16 +214,12 @@ public:
         _rigToGeometryRot = glmExtractRotation(rigToGeometry);
     }
 
-    void clearMap() { _map.clear(); }
-    bool hasKey(const QString& key) const { return _map.find(key) != _map.end(); }
+    void clearMap() { _map.clear(); _isSet.clear(); }
+    bool hasKey(const AnimVarKey& key) const { return find(key) != nullptr; }
 
-    const AnimVariant& get(const QString& key) const {
-        auto iter = _map.find(key);
-        if (iter != _map.end()) {
-            return iter->second;
-        } else {
-            return AnimVariant::False;
-        }
+    const AnimVariant& get(const AnimVarKey& key) const {
+        const AnimVariant* variant = find(key);
+        return variant ? *variant : AnimVariant::False;
     }
 
     // Answer a Plain Old Javascript Object (for the given engine) all of our values set as properties.
@@ -229,25 +231,30 @@ public:
 #ifdef NDEBUG
     void dump() const {
         qCDebug(animation) << "AnimVariantMap =";
-        for (auto& pair : _map) {
-            switch (pair.second.getType()) {
+        for (int slot = 0; slot < (int)_map.size(); slot++) {
+            if (!_isSet[slot]) {
+                continue;
+            }
+            const AnimVariant& variant = _map[slot];
+            QString name = AnimVarKey::nameOfSlot(slot);
+            switch (variant.getType()) {
             case AnimVariant::Type::Bool:
-                qCDebug(animation) << "    " << pair.first << "=" << pair.second.getBool();
+                qCDebug(animation) << "    " << name << "=" << variant.getBool();
                 break;
             case AnimVariant::Type::Int:
-                qCDebug(animation) << "    " << pair.first << "=" << pair.second.getInt();
+                qCDebug(animation) << "    " << name << "=" << variant.getInt();
                 break;
             case AnimVariant::Type::Float:
-                qCDebug(animation) << "    " << pair.first << "=" << pair.second.getFloat();
+                qCDebug(animation) << "    " << name << "=" << variant.getFloat();
                 break;
             case AnimVariant::Type::Vec3:
-                qCDebug(animation) << "    " << pair.first << "=" << pair.second.getVec3();
+                qCDebug(animation) << "    " << name << "=" << variant.getVec3();
                 break;
             case AnimVariant::Type::Quat:
-                qCDebug(animation) << "    " << pair.first << "=" << pair.second.getQuat();
+                qCDebug(animation) << "    " << name << "=" << variant.getQuat();
                 break;
             case AnimVariant::Type::String:
-                qCDebug(animation) << "    " << pair.first << "=" << pair.second.getString();
+                qCDebug(animation) << "    " << name << "=" << variant.getString();
                 break;
             default:
                 assert(("invalid AnimVariant::Type", false));
@@ -257,8 +264,33 @@ public:
 #endif
 
 protected:
-    std::map<QString, AnimVariant> _map;
-    std::set<QString> _triggers;
+    const AnimVariant* find(const AnimVarKey& key) const {
+        int slot = key.getSlot();
+        return (slot >= 0 && slot < (int)_map.size() && _isSet[slot]) ? &_map[slot] : nullptr;
+    }
+
+    bool isTriggerSet(const AnimVarKey& key) const {
+        int slot = key.getSlot();
+        return slot >= 0 && slot < (int)_triggers.size() && _triggers[slot];
+    }
+
+    void setVariant(const AnimVarKey& key, const AnimVariant& variant) {
+        int slot = key.getSlot();
+        if (slot < 0) {
+            return;
+        }
+        if (slot >= (int)_map.size()) {
+            _map.resize(slot + 1);
+            _isSet.resize(slot + 1, false);
+        }
+        _map[slot] = variant;
+        _isSet[slot] = true;
+    }
+
+    // indexed by the slots of the keys
+    std::vector<AnimVariant> _map;
+    std::vector<bool> _isSet;
+    std::vector<bool> _triggers;
     glm::mat4 _rigToGeometryMat;
     glm::quat _rigToGeometryRot;
 };
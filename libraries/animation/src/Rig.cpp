@@ -27,6 +27,7 @@
 #include "AnimClip.h"
 #include "AnimInverseKinematics.h"
 #include "AnimSkeleton.h"
+#include "AnimUtil.h"
 #include "IKTarget.h"
 
 static bool isEqual(const glm::vec3& u, const glm::vec3& v) {
@@ -163,11 +164,19 @@ void Rig::destroyAnimGraph() {
 }
 
 void Rig::initJointStates(const FBXGeometry& geometry, const glm::mat4& modelOffset) {
+    initJointStates(geometry, std::make_shared<AnimSkeleton>(geometry), modelOffset);
+}
+
+void Rig::initJointStates(const std::shared_ptr<const FBXGeometry>& geometry, const glm::mat4& modelOffset) {
+    initJointStates(*geometry, AnimSkeleton::getSharedSkeleton(geometry), modelOffset);
+}
+
+void Rig::initJointStates(const FBXGeometry& geometry, AnimSkeleton::Pointer skeleton, const glm::mat4& modelOffset) {
     _geometryOffset = AnimPose(geometry.offset);
     _invGeometryOffset = _geometryOffset.inverse();
     setModelOffset(modelOffset);
 
-    _animSkeleton = std::make_shared<AnimSkeleton>(geometry);
+    _animSkeleton = skeleton;
 
     _internalPoseSet._relativePoses.clear();
     _internalPoseSet._relativePoses = _animSkeleton->getRelativeDefaultPoses();
@@ -192,9 +201,17 @@ void Rig::initJointStates(const FBXGeometry& geometry, const glm::mat4& modelOff
 }
 
 void Rig::reset(const FBXGeometry& geometry) {
+    reset(geometry, std::make_shared<AnimSkeleton>(geometry));
+}
+
+void Rig::reset(const std::shared_ptr<const FBXGeometry>& geometry) {
+    reset(*geometry, AnimSkeleton::getSharedSkeleton(geometry));
+}
+
+void Rig::reset(const FBXGeometry& geometry, AnimSkeleton::Pointer skeleton) {
     _geometryOffset = AnimPose(geometry.offset);
     _invGeometryOffset = _geometryOffset.inverse();
-    _animSkeleton = std::make_shared<AnimSkeleton>(geometry);
+    _animSkeleton = skeleton;
 
     _internalPoseSet._relativePoses.clear();
     _internalPoseSet._relativePoses = _animSkeleton->getRelativeDefaultPoses();
@@ -460,6 +477,10 @@ void Rig::calcAnimAlpha(float speed, const std::vector<float>& referenceSpeeds,
 }
 
 void Rig::setEnableInverseKinematics(bool enable) {
+    if (enable != _enableInverseKinematics) {
+        // the ik overlay isn't evaluated while it is faded out
+        _animVars.set("ikOverlayAlpha", enable ? 1.0f : 0.0f);
+    }
     _enableInverseKinematics = enable;
 }
 
@@ -784,15 +805,6 @@ void Rig::computeMotionAnimationState(float deltaTime, const glm::vec3& worldPos
         }
 
         t += deltaTime;
-
-        if (_enableInverseKinematics != _lastEnableInverseKinematics) {
-            if (_enableInverseKinematics) {
-                _animVars.set("ikOverlayAlpha", 1.0f);
-            } else {
-                _animVars.set("ikOverlayAlpha", 0.0f);
-            }
-        }
-        _lastEnableInverseKinematics = _enableInverseKinematics;
     }
 
     _lastFront = front;
@@ -886,6 +898,45 @@ void Rig::updateAnimations(float deltaTime, glm::mat4 rootTransform) {
 
     setModelOffset(rootTransform);
 
+    evaluateAnimations(deltaTime);
+
+    // back at full rate, the next reduced rate update starts over from these poses
+    _prevReducedRatePoses.clear();
+    _nextReducedRatePoses.clear();
+    _reducedRateTime = 0.0f;
+
+    updatePoses();
+}
+
+void Rig::updateAnimationsAtReducedRate(float deltaTime, glm::mat4 rootTransform, float updatePeriod) {
+
+    PROFILE_RANGE_EX(__FUNCTION__, 0xffff00ff, 0);
+
+    setModelOffset(rootTransform);
+
+    _reducedRateTime += deltaTime;
+    if (_reducedRateTime >= updatePeriod || _nextReducedRatePoses.size() != _internalPoseSet._relativePoses.size()) {
+        evaluateAnimations(_reducedRateTime);
+
+        if (_nextReducedRatePoses.size() == _internalPoseSet._relativePoses.size()) {
+            _prevReducedRatePoses.swap(_nextReducedRatePoses);
+        } else {
+            _prevReducedRatePoses = _internalPoseSet._relativePoses;
+        }
+        _nextReducedRatePoses = _internalPoseSet._relativePoses;
+        _reducedRateTime = 0.0f;
+    }
+
+    float alpha = glm::clamp(_reducedRateTime / updatePeriod, 0.0f, 1.0f);
+    size_t numPoses = _nextReducedRatePoses.size();
+    if (numPoses > 0 && _prevReducedRatePoses.size() == numPoses && _internalPoseSet._relativePoses.size() == numPoses) {
+        ::blend(numPoses, &_prevReducedRatePoses[0], &_nextReducedRatePoses[0], alpha, &_internalPoseSet._relativePoses[0]);
+    }
+
+    updatePoses();
+}
+
+void Rig::evaluateAnimations(float deltaTime) {
     if (_animNode) {
 
         updateAnimationStateHandlers();
@@ -905,6 +956,9 @@ void Rig::updateAnimations(float deltaTime, glm::mat4 rootTransform) {
     }
 
     applyOverridePoses();
+}
+
+void Rig::updatePoses() {
     buildAbsoluteRigPoses(_internalPoseSet._relativePoses, _internalPoseSet._absolutePoses);
 
     // copy internal poses to external poses
@@ -1227,6 +1281,14 @@ glm::mat4 Rig::getJointTransform(int jointIndex) const {
     }
 }
 
+AnimPose Rig::getJointPose(int jointIndex) const {
+    if (isIndexValid(jointIndex)) {
+        return _internalPoseSet._absolutePoses[jointIndex];
+    } else {
+        return AnimPose::identity;
+    }
+}
+
 void Rig::copyJointsIntoJointData(QVector<JointData>& jointDataVec) const {
 
     const AnimPose geometryToRigPose(_geometryToRigTransform);
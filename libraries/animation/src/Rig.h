@@ -92,6 +92,10 @@ public:
 
     void initJointStates(const FBXGeometry& geometry, const glm::mat4& modelOffset);
     void reset(const FBXGeometry& geometry);
+
+    // share the skeleton with the other rigs of the geometry
+    void initJointStates(const std::shared_ptr<const FBXGeometry>& geometry, const glm::mat4& modelOffset);
+    void reset(const std::shared_ptr<const FBXGeometry>& geometry);
     bool jointStatesEmpty();
     int getJointStateCount() const;
     int indexOfJoint(const QString& jointName) const;
@@ -142,6 +146,7 @@ public:
 
     // rig space
     glm::mat4 getJointTransform(int jointIndex) const;
+    AnimPose getJointPose(int jointIndex) const;
 
     // Start or stop animations as needed.
     void computeMotionAnimationState(float deltaTime, const glm::vec3& worldPosition, const glm::vec3& worldVelocity, const glm::quat& worldRotation, CharacterControllerState ccState);
@@ -149,6 +154,10 @@ public:
     // Regardless of who started the animations or how many, update the joints.
     void updateAnimations(float deltaTime, glm::mat4 rootTransform);
 
+    // Evaluates the animations once per updatePeriod, and interpolates the joints from the last two evaluations
+    // in between, so they lag one period behind. Used by the animation LOD of the distant avatars.
+    void updateAnimationsAtReducedRate(float deltaTime, glm::mat4 rootTransform, float updatePeriod);
+
     // legacy
     void inverseKinematics(int endIndex, glm::vec3 targetPosition, const glm::quat& targetRotation, float priority,
                            const QVector<int>& freeLineage, glm::mat4 rootTransform);
@@ -217,9 +226,14 @@ signals:
     void onLoadComplete();
 
 protected:
+    void initJointStates(const FBXGeometry& geometry, AnimSkeleton::Pointer skeleton, const glm::mat4& modelOffset);
+    void reset(const FBXGeometry& geometry, AnimSkeleton::Pointer skeleton);
+
     bool isIndexValid(int index) const { return _animSkeleton && index >= 0 && index < _animSkeleton->getNumJoints(); }
     void updateAnimationStateHandlers();
     void applyOverridePoses();
+    void evaluateAnimations(float deltaTime);
+    void updatePoses();
     void buildAbsoluteRigPoses(const AnimPoseVec& relativePoses, AnimPoseVec& absolutePosesOut);
 
     void updateNeckJoint(int index, const HeadParameters& params);
@@ -246,6 +260,11 @@ protected:
     PoseSet _externalPoseSet;
     mutable QReadWriteLock _externalPoseSetLock;
 
+    // The last two evaluations of updateAnimationsAtReducedRate, and the time since the last one
+    AnimPoseVec _prevReducedRatePoses;
+    AnimPoseVec _nextReducedRatePoses;
+    float _reducedRateTime { 0.0f };
+
     AnimPoseVec _absoluteDefaultPoses; // rig space, not relative to parent.
 
     glm::mat4 _geometryToRigTransform;
@@ -311,7 +330,6 @@ protected:
 
     std::map<QString, AnimNode::Pointer> _origRoleAnimations;
 
-    bool _lastEnableInverseKinematics { true };
     bool _enableInverseKinematics { true };
 
     mutable uint32_t _jointNameWarningCount { 0 };
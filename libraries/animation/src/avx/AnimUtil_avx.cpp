@@ -0,0 +1,107 @@
+//
+//  AnimUtil_avx.cpp
+//  libraries/animation/src/avx
+//
+//  Created by Sam Gateau on 10/15/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+
+#include <immintrin.h>
+
+#include "../AnimUtil.h"
+
+#ifndef __AVX__
+#error Must be compiled with /arch:AVX or -mavx.
+#endif
+
+// transposes the 4x4 matrix in each 128-bit lane
+static inline void transpose4x2(__m256& r0, __m256& r1, __m256& r2, __m256& r3) {
+    __m256 t0 = _mm256_unpacklo_ps(r0, r1);
+    __m256 t1 = _mm256_unpackhi_ps(r0, r1);
+    __m256 t2 = _mm256_unpacklo_ps(r2, r3);
+    __m256 t3 = _mm256_unpackhi_ps(r2, r3);
+    r0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+    r1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+    r2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    r3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+}
+
+// loads the rotations of poses i and i + 4 in the low and high lanes
+static inline __m256 loadRotations(const float* p, int i) {
+    __m128 lo = _mm_loadu_ps(p + i * ANIM_POSE_FLOATS + ANIM_POSE_ROT_OFFSET);
+    __m128 hi = _mm_loadu_ps(p + (i + 4) * ANIM_POSE_FLOATS + ANIM_POSE_ROT_OFFSET);
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(lo), hi, 1);
+}
+
+static inline void storeRotations(float* p, int i, __m256 r) {
+    _mm_storeu_ps(p + i * ANIM_POSE_FLOATS + ANIM_POSE_ROT_OFFSET, _mm256_castps256_ps128(r));
+    _mm_storeu_ps(p + (i + 4) * ANIM_POSE_FLOATS + ANIM_POSE_ROT_OFFSET, _mm256_extractf128_ps(r, 1));
+}
+
+// Blends the poses 8 at a time, see blend_SSE
+size_t blend_AVX(size_t numPoses, const AnimPose* a, const AnimPose* b, float alpha, AnimPose* result) {
+    const int POSES = 8;
+    const __m256 alphaA = _mm256_set1_ps(1.0f - alpha);
+    const __m256 alphaB = _mm256_set1_ps(alpha);
+    const __m256 signBit = _mm256_set1_ps(-0.0f);
+
+    size_t numBlended = numPoses - numPoses % POSES;
+    for (size_t i = 0; i < numBlended; i += POSES) {
+        const float* pa = reinterpret_cast<const float*>(a + i);
+        const float* pb = reinterpret_cast<const float*>(b + i);
+        float* pr = reinterpret_cast<float*>(result + i);
+
+        __m256 a0 = loadRotations(pa, 0);
+        __m256 a1 = loadRotations(pa, 1);
+        __m256 a2 = loadRotations(pa, 2);
+        __m256 a3 = loadRotations(pa, 3);
+        __m256 b0 = loadRotations(pb, 0);
+        __m256 b1 = loadRotations(pb, 1);
+        __m256 b2 = loadRotations(pb, 2);
+        __m256 b3 = loadRotations(pb, 3);
+        transpose4x2(a0, a1, a2, a3);
+        transpose4x2(b0, b1, b2, b3);
+
+        // adjust signs if necessary
+        __m256 dot = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(a0, b0), _mm256_mul_ps(a1, b1)),
+                                   _mm256_add_ps(_mm256_mul_ps(a2, b2), _mm256_mul_ps(a3, b3)));
+        __m256 sign = _mm256_and_ps(_mm256_cmp_ps(dot, _mm256_setzero_ps(), _CMP_LT_OQ), signBit);
+        b0 = _mm256_xor_ps(b0, sign);
+        b1 = _mm256_xor_ps(b1, sign);
+        b2 = _mm256_xor_ps(b2, sign);
+        b3 = _mm256_xor_ps(b3, sign);
+
+        // nlerp
+        __m256 r0 = _mm256_add_ps(_mm256_mul_ps(a0, alphaA), _mm256_mul_ps(b0, alphaB));
+        __m256 r1 = _mm256_add_ps(_mm256_mul_ps(a1, alphaA), _mm256_mul_ps(b1, alphaB));
+        __m256 r2 = _mm256_add_ps(_mm256_mul_ps(a2, alphaA), _mm256_mul_ps(b2, alphaB));
+        __m256 r3 = _mm256_add_ps(_mm256_mul_ps(a3, alphaA), _mm256_mul_ps(b3, alphaB));
+        __m256 length = _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(r0, r0), _mm256_mul_ps(r1, r1)),
+                                                     _mm256_add_ps(_mm256_mul_ps(r2, r2), _mm256_mul_ps(r3, r3))));
+        r0 = _mm256_div_ps(r0, length);
+        r1 = _mm256_div_ps(r1, length);
+        r2 = _mm256_div_ps(r2, length);
+        r3 = _mm256_div_ps(r3, length);
+        transpose4x2(r0, r1, r2, r3);
+
+        // lerp the 8 poses as a whole, the lerped rotations are then replaced by the normalized ones
+        for (int j = 0; j < POSES * ANIM_POSE_FLOATS; j += 8) {
+            __m256 va = _mm256_loadu_ps(pa + j);
+            __m256 vb = _mm256_loadu_ps(pb + j);
+            _mm256_storeu_ps(pr + j, _mm256_add_ps(_mm256_mul_ps(va, alphaA), _mm256_mul_ps(vb, alphaB)));
+        }
+
+        storeRotations(pr, 0, r0);
+        storeRotations(pr, 1, r1);
+        storeRotations(pr, 2, r2);
+        storeRotations(pr, 3, r3);
+    }
+    return numBlended;
+}
+
+#endif
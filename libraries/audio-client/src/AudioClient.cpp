@@ -9,6 +9,7 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
 #include <cstring>
 #include <math.h>
 #include <sys/stat.h>
@@ -35,6 +36,7 @@
 #include <QtMultimedia/QAudioInput>
 #include <QtMultimedia/QAudioOutput>
 
+#include <LogHandler.h>
 #include <NodeList.h>
 #include <plugins/CodecPlugin.h>
 #include <plugins/PluginManager.h>
@@ -64,6 +66,48 @@ static const int DEFAULT_BUFFER_FRAMES = 1;
 static const bool DEFAULT_STARVE_DETECTION_ENABLED = true;
 static const int STARVE_DETECTION_THRESHOLD = 3;
 static const int STARVE_DETECTION_PERIOD = 10 * 1000; // 10 Seconds
+static const int STARVE_FREE_SHRINK_PERIOD = 30 * 1000; // 30 Seconds
+
+// packets waiting for the output device to pull them, a second of audio
+static const int AUDIO_PACKET_QUEUE_CAPACITY = 100;
+
+// local injectors mixed at once, past this the lowest priority ones are not heard
+static const size_t MAX_LOCAL_INJECTOR_VOICES = 32;
+
+//
+// on x86 architecture, assume that SSE2 is present
+//
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+
+#include <emmintrin.h>
+
+static void convertToFloat(const int16_t* src, float* dst, int numSamples) {
+    const __m128 scale = _mm_set1_ps(1/32768.0f);
+    int i = 0;
+    for (; i + 8 <= numSamples; i += 8) {
+        __m128i x0 = _mm_loadu_si128((const __m128i*)&src[i]);
+
+        // sign-extend to int32
+        __m128i x1 = _mm_srai_epi32(_mm_unpacklo_epi16(x0, x0), 16);
+        __m128i x2 = _mm_srai_epi32(_mm_unpackhi_epi16(x0, x0), 16);
+
+        _mm_storeu_ps(&dst[i+0], _mm_mul_ps(_mm_cvtepi32_ps(x1), scale));
+        _mm_storeu_ps(&dst[i+4], _mm_mul_ps(_mm_cvtepi32_ps(x2), scale));
+    }
+    for (; i < numSamples; i++) {
+        dst[i] = (float)src[i] * (1/32768.0f);
+    }
+}
+
+#else
+
+static void convertToFloat(const int16_t* src, float* dst, int numSamples) {
+    for (int i = 0; i < numSamples; i++) {
+        dst[i] = (float)src[i] * (1/32768.0f);
+    }
+}
+
+#endif
 
 Setting::Handle<bool> dynamicJitterBufferEnabled("dynamicJitterBuffersEnabled",
     InboundAudioStream::DEFAULT_DYNAMIC_JITTER_BUFFER_ENABLED);
@@ -125,6 +169,7 @@ AudioClient::AudioClient() :
     _inputRingBuffer(0),
     _receivedAudioStream(RECEIVED_AUDIO_STREAM_CAPACITY_FRAMES),
     _isStereoInput(false),
+    _audioPacketQueue(AUDIO_PACKET_QUEUE_CAPACITY),
     _outputStarveDetectionStartTimeMsec(0),
     _outputStarveDetectionCount(0),
     _outputBufferSizeFrames("audioOutputBufferFrames", DEFAULT_BUFFER_FRAMES),
@@ -177,8 +222,10 @@ AudioClient::AudioClient() :
     auto& packetReceiver = DependencyManager::get<NodeList>()->getPacketReceiver();
     packetReceiver.registerListener(PacketType::AudioStreamStats, &_stats, "processStreamStatsPacket");
     packetReceiver.registerListener(PacketType::AudioEnvironment, this, "handleAudioEnvironmentDataPacket");
-    packetReceiver.registerListener(PacketType::SilentAudioFrame, this, "handleAudioDataPacket");
-    packetReceiver.registerListener(PacketType::MixedAudio, this, "handleAudioDataPacket");
+    packetReceiver.registerDirectHandlerForTypes({ PacketType::SilentAudioFrame, PacketType::SilentAudioRun, PacketType::MixedAudio },
+        this, [this](QSharedPointer<ReceivedMessage> message, SharedNodePointer) {
+            queueAudioDataPacket(message);
+        });
     packetReceiver.registerListener(PacketType::NoisyMute, this, "handleNoisyMutePacket");
     packetReceiver.registerListener(PacketType::MuteEnvironment, this, "handleMuteEnvironmentPacket");
     packetReceiver.registerListener(PacketType::SelectedAudioFormat, this, "handleSelectedAudioFormat");
@@ -198,8 +245,15 @@ void AudioClient::beforeAboutToQuit() {
 }
 
 
+void AudioClient::updateEncoderNetworkConditions(float lossRate, int rttMsecs) {
+    if (_encoder) {
+        _encoder->setNetworkConditions(lossRate, rttMsecs);
+    }
+}
+
 void AudioClient::handleMismatchAudioFormat(SharedNodePointer node, const QString& currentCodec, const QString& recievedCodec) {
-    qCDebug(audioclient) << __FUNCTION__ << "sendingNode:" << *node << "currentCodec:" << currentCodec << "recievedCodec:" << recievedCodec;
+    HIFI_LOG_EVERY_MSECS(1000, qCDebug(audioclient) << __FUNCTION__ << "sendingNode:" << *node
+        << "currentCodec:" << currentCodec << "recievedCodec:" << recievedCodec);
     selectAudioFormat(recievedCodec);
 }
 
@@ -568,6 +622,23 @@ void AudioClient::handleAudioDataPacket(QSharedPointer<ReceivedMessage> message)
     }
 }
 
+// Called on the network thread, the audio thread parses the packet when the output device next pulls samples
+void AudioClient::queueAudioDataPacket(QSharedPointer<ReceivedMessage> message) {
+    if (!_audioPacketQueue.push(message)) {
+        int dropped = ++_droppedAudioPackets;
+        if (dropped == 1 || dropped % AUDIO_PACKET_QUEUE_CAPACITY == 0) {
+            qCDebug(audioclient) << "Audio packet queue is full, dropped" << dropped << "packets";
+        }
+    }
+}
+
+void AudioClient::processQueuedAudioDataPackets() {
+    QSharedPointer<ReceivedMessage> message;
+    while (_audioPacketQueue.pop(message)) {
+        handleAudioDataPacket(message);
+    }
+}
+
 AudioClient::Gate::Gate(AudioClient* audioClient) :
     _audioClient(audioClient) {}
 
@@ -653,6 +724,10 @@ void AudioClient::negotiateAudioFormat() {
         negotiateFormatPacket->writeString(codecName);
     }
 
+    // the received audio stream synthesizes runs of silence, so the mixer can stop sending while our mix is silent
+    bool supportsSilentRuns = true;
+    negotiateFormatPacket->writePrimitive(supportsSilentRuns);
+
     // grab our audio mixer from the NodeList, if it exists
     SharedNodePointer audioMixer = nodeList->soloNodeOfType(NodeType::AudioMixer);
 
@@ -742,7 +817,9 @@ void AudioClient::configureReverb() {
     p.earlyMixRight = _reverbOptions->getEarlyMixRight();
     p.lateMixLeft = _reverbOptions->getLateMixLeft();
     p.lateMixRight = _reverbOptions->getLateMixRight();
-    p.wetDryMix = _reverbOptions->getWetDryMix();
+    // the listener reverb only renders the send bus, the wet level is applied when it is mixed back in
+    p.wetDryMix = 100.0f;
+    _listenerReverbWetLevel = glm::clamp(_reverbOptions->getWetDryMix() / 100.0f, 0.0f, 1.0f);
 
     _listenerReverb.setParameters(&p);
 
@@ -1009,40 +1086,54 @@ void AudioClient::handleRecordedAudioInput(const QByteArray& audio) {
     emitAudioPacket(encodedBuffer.data(), encodedBuffer.size(), _outgoingAvatarAudioSequenceNumber, audioTransform, PacketType::MicrophoneAudioWithEcho, _selectedCodecName);
 }
 
-void AudioClient::mixLocalAudioInjectors(float* mixBuffer) {
+// adds the unspatialized frame of a local injector to the reverb send bus, the reverb is diffuse anyway
+static void mixReverbSend(const int16_t* samples, bool isStereo, float gain, float* sendBuffer) {
+    float scale = gain / AudioConstants::MAX_SAMPLE_VALUE;
+    if (isStereo) {
+        for (int i = 0; i < AudioConstants::NETWORK_FRAME_SAMPLES_STEREO; i++) {
+            sendBuffer[i] += samples[i] * scale;
+        }
+    } else {
+        for (int i = 0; i < AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL; i++) {
+            float sample = samples[i] * scale;
+            sendBuffer[2*i+0] += sample;
+            sendBuffer[2*i+1] += sample;
+        }
+    }
+}
+
+void AudioClient::mixLocalAudioInjectors(float* mixBuffer, float* reverbSendBuffer) {
 
     QVector<AudioInjector*> injectorsToRemove;
     
     // lock the injector vector
     Lock lock(_injectorsMutex);
 
+    // read a frame from every injector, the ones that lose their voice still move on in time
+    _localInjectorVoices.clear();
+    _localInjectorSamples.resize(getActiveLocalAudioInjectors().size() * AudioConstants::NETWORK_FRAME_SAMPLES_STEREO);
+
     for (AudioInjector* injector : getActiveLocalAudioInjectors()) {
         if (injector->getLocalBuffer()) {
 
             qint64 samplesToRead = injector->isStereo() ? AudioConstants::NETWORK_FRAME_BYTES_STEREO : AudioConstants::NETWORK_FRAME_BYTES_PER_CHANNEL;
 
             // get one frame from the injector (mono or stereo)
-            memset(_scratchBuffer, 0, sizeof(_scratchBuffer));
-            if (0 < injector->getLocalBuffer()->readData((char*)_scratchBuffer, samplesToRead)) {
-                
-                if (injector->isStereo()) {
+            int samplesOffset = (int)_localInjectorVoices.size() * AudioConstants::NETWORK_FRAME_SAMPLES_STEREO;
+            int16_t* samples = &_localInjectorSamples[samplesOffset];
+            memset(samples, 0, AudioConstants::NETWORK_FRAME_BYTES_STEREO);
+            if (0 < injector->getLocalBuffer()->readData((char*)samples, samplesToRead)) {
 
-                    // stereo gets directly mixed into mixBuffer
-                    for (int i = 0; i < AudioConstants::NETWORK_FRAME_SAMPLES_STEREO; i++) {
-                        mixBuffer[i] += (float)_scratchBuffer[i] * (1/32768.0f);
-                    }
-                    
-                } else {
+                LocalInjectorVoice voice { injector, samplesOffset, 0.0f, 0.0f, injector->getVolume() };
+                if (!injector->isStereo()) {
 
                     // calculate distance, gain and azimuth for hrtf
                     glm::vec3 relativePosition = injector->getPosition() - _positionGetter();
-                    float distance = glm::max(glm::length(relativePosition), EPSILON);
-                    float gain = gainForSource(distance, injector->getVolume()); 
-                    float azimuth = azimuthForSource(relativePosition);         
-                
-                    // mono gets spatialized into mixBuffer
-                    injector->getLocalHRTF().render(_scratchBuffer, mixBuffer, 1, azimuth, distance, gain, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+                    voice.distance = glm::max(glm::length(relativePosition), EPSILON);
+                    voice.gain = gainForSource(voice.distance, injector->getVolume());
+                    voice.azimuth = azimuthForSource(relativePosition);
                 }
+                _localInjectorVoices.push_back(voice);
             
             } else {
                 
@@ -1058,6 +1149,43 @@ void AudioClient::mixLocalAudioInjectors(float* mixBuffer) {
             injectorsToRemove.append(injector);
         }
     }
+
+    // past the voice limit, the lowest priority and then the quietest injectors are not mixed this frame
+    if (_localInjectorVoices.size() > MAX_LOCAL_INJECTOR_VOICES) {
+        std::nth_element(_localInjectorVoices.begin(), _localInjectorVoices.begin() + MAX_LOCAL_INJECTOR_VOICES,
+            _localInjectorVoices.end(), [](const LocalInjectorVoice& a, const LocalInjectorVoice& b) {
+                float priorityA = a.injector->getPriority();
+                float priorityB = b.injector->getPriority();
+                return priorityA > priorityB || (priorityA == priorityB && a.gain > b.gain);
+            });
+        _localInjectorVoices.resize(MAX_LOCAL_INJECTOR_VOICES);
+    }
+
+    for (const auto& voice : _localInjectorVoices) {
+        const int16_t* samples = &_localInjectorSamples[voice.samplesOffset];
+        AudioInjector* injector = voice.injector;
+
+        // each injector sends to the reverb at its own level
+        float sendGain = (injector->isStereo() ? 1.0f : voice.gain) * injector->getReverbSend();
+        if (reverbSendBuffer && sendGain > 0.0f) {
+            mixReverbSend(samples, injector->isStereo(), sendGain, reverbSendBuffer);
+        }
+
+        if (injector->isStereo()) {
+
+            // stereo gets directly mixed into mixBuffer
+            injector->getLocalHRTF().mixStereo(samples, mixBuffer, 1.0f, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+
+        } else {
+
+            // mono gets spatialized into mixBuffer, all at once below
+            _localInjectorBatch.push_back({ &injector->getLocalHRTF(), samples, voice.azimuth, voice.distance, voice.gain });
+        }
+    }
+
+    AudioHRTF::renderBatch(_localInjectorBatch.data(), (int)_localInjectorBatch.size(), mixBuffer, 1,
+                           AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+    _localInjectorBatch.clear();
     
     for (AudioInjector* injector : injectorsToRemove) {
         qCDebug(audioclient) << "removing injector";
@@ -1074,20 +1202,28 @@ void AudioClient::processReceivedSamples(const QByteArray& decodedBuffer, QByteA
     int16_t* outputSamples = reinterpret_cast<int16_t*>(outputBuffer.data());
 
     // convert network audio to float
-    for (int i = 0; i < AudioConstants::NETWORK_FRAME_SAMPLES_STEREO; i++) {
-        _mixBuffer[i] = (float)decodedSamples[i] * (1/32768.0f);
-    }
+    convertToFloat(decodedSamples, _mixBuffer, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO);
         
+    // the network mix is sent to the reverb bus in full
+    bool hasReverb = _reverb || _receivedAudioStream.hasReverb();
+    if (hasReverb) {
+        memcpy(_reverbSendBuffer, _mixBuffer, sizeof(_reverbSendBuffer));
+    }
+
     // mix in active injectors
     if (getActiveLocalAudioInjectors().size() > 0) {
-        mixLocalAudioInjectors(_mixBuffer);
+        mixLocalAudioInjectors(_mixBuffer, hasReverb ? _reverbSendBuffer : nullptr);
     }
 
-    // apply stereo reverb
-    bool hasReverb = _reverb || _receivedAudioStream.hasReverb();
+    // render the reverb bus once, and mix it back in
     if (hasReverb) {
         updateReverbOptions();
-        _listenerReverb.render(_mixBuffer, _mixBuffer, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+        _listenerReverb.render(_reverbSendBuffer, _reverbSendBuffer, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+
+        float dryLevel = 1.0f - _listenerReverbWetLevel;
+        for (int i = 0; i < AudioConstants::NETWORK_FRAME_SAMPLES_STEREO; i++) {
+            _mixBuffer[i] = _mixBuffer[i] * dryLevel + _reverbSendBuffer[i] * _listenerReverbWetLevel;
+        }
     }
 
     if (_networkToOutputResampler) {
@@ -1277,6 +1413,18 @@ void AudioClient::outputNotify() {
                 }
             }
         }
+        _lastOutputStarveMsec = usecTimestampNow() / USECS_PER_MSEC;
+    } else if (_outputStarveDetectionEnabled.get() && _sessionOutputBufferSizeFrames > _outputBufferSizeFrames.get()) {
+        // the buffer only grew for the starves, give a frame back once the output has been starve free for a while
+        quint64 now = usecTimestampNow() / USECS_PER_MSEC;
+        if (_lastOutputStarveMsec == 0) {
+            _lastOutputStarveMsec = now;
+        } else if (now > _lastOutputStarveMsec && (int)(now - _lastOutputStarveMsec) > STARVE_FREE_SHRINK_PERIOD) {
+            int newOutputBufferSizeFrames = setOutputBufferSize(_sessionOutputBufferSizeFrames - 1, false);
+            qCDebug(audioclient, "No starves in %d ms, output buffer reduced to %d frames",
+                    STARVE_FREE_SHRINK_PERIOD, newOutputBufferSizeFrames);
+            _lastOutputStarveMsec = now;
+        }
     }
 }
 
@@ -1301,6 +1449,9 @@ bool AudioClient::switchOutputToAudioDevice(const QAudioDeviceInfo& outputDevice
         _networkToOutputResampler = NULL;
     }
 
+    // the packets that queued up while switching are stale by the time the new device pulls
+    _audioPacketQueue.clear();
+
     if (!outputDeviceInfo.isNull()) {
         qCDebug(audioclient) << "The audio output device " << outputDeviceInfo.deviceName() << "is available.";
         _outputAudioDeviceName = outputDeviceInfo.deviceName().trimmed();
@@ -1447,6 +1598,9 @@ float AudioClient::gainForSource(float distance, float volume) {
 }
 
 qint64 AudioClient::AudioOutputIODevice::readData(char * data, qint64 maxSize) {
+    // parse what the network delivered since the last pull, so the samples go out with no queued hop in between
+    _audio->processQueuedAudioDataPackets();
+
     auto samplesRequested = maxSize / AudioConstants::SAMPLE_SIZE;
     int samplesPopped;
     int bytesWritten;
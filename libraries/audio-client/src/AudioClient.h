@@ -12,6 +12,7 @@
 #ifndef hifi_AudioClient_h
 #define hifi_AudioClient_h
 
+#include <atomic>
 #include <fstream>
 #include <memory>
 #include <vector>
@@ -38,6 +39,7 @@
 #include <RingBufferHistory.h>
 #include <SettingHandle.h>
 #include <Sound.h>
+#include <SPSCQueue.h>
 #include <StDev.h>
 #include <AudioHRTF.h>
 #include <AudioSRC.h>
@@ -147,6 +149,7 @@ public slots:
     void handleMuteEnvironmentPacket(QSharedPointer<ReceivedMessage> message);
     void handleSelectedAudioFormat(QSharedPointer<ReceivedMessage> message);
     void handleMismatchAudioFormat(SharedNodePointer node, const QString& currentCodec, const QString& recievedCodec);
+    void updateEncoderNetworkConditions(float lossRate, int rttMsecs);
 
     void sendDownstreamAudioStatsPacket() { _stats.publish(); }
     void handleAudioInput();
@@ -216,7 +219,9 @@ protected:
 
 private:
     void outputFormatChanged();
-    void mixLocalAudioInjectors(float* mixBuffer);
+    void queueAudioDataPacket(QSharedPointer<ReceivedMessage> message);
+    void processQueuedAudioDataPackets();
+    void mixLocalAudioInjectors(float* mixBuffer, float* reverbSendBuffer);
     float azimuthForSource(const glm::vec3& relativePosition);
     float gainForSource(float distance, float volume);
 
@@ -263,11 +268,16 @@ private:
     MixedProcessedAudioStream _receivedAudioStream;
     bool _isStereoInput;
 
+    // audio packets, pushed from the network thread and parsed by the output device as it pulls samples
+    SPSCQueue<QSharedPointer<ReceivedMessage>> _audioPacketQueue;
+    std::atomic<int> _droppedAudioPackets { 0 };
+
     QString _inputAudioDeviceName;
     QString _outputAudioDeviceName;
 
     quint64 _outputStarveDetectionStartTimeMsec;
     int _outputStarveDetectionCount;
+    quint64 _lastOutputStarveMsec { 0 };
 
     Setting::Handle<int> _outputBufferSizeFrames;
     int _sessionOutputBufferSizeFrames;
@@ -289,7 +299,8 @@ private:
     AudioEffectOptions _zoneReverbOptions;
     AudioEffectOptions* _reverbOptions;
     AudioReverb _sourceReverb { AudioConstants::SAMPLE_RATE };
-    AudioReverb _listenerReverb { AudioConstants::SAMPLE_RATE };
+    AudioReverb _listenerReverb { AudioConstants::SAMPLE_RATE }; // renders the send bus, fully wet
+    float _listenerReverbWetLevel { 0.0f };
 
     // possible streams needed for resample
     AudioSRC* _inputToNetworkResampler;
@@ -297,7 +308,20 @@ private:
 
     // for local hrtf-ing
     float _mixBuffer[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
+    float _reverbSendBuffer[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
     int16_t _scratchBuffer[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
+
+    // a frame read from a local injector, ranked against the others for a voice
+    struct LocalInjectorVoice {
+        AudioInjector* injector;
+        int samplesOffset;
+        float azimuth;
+        float distance;
+        float gain;
+    };
+    std::vector<LocalInjectorVoice> _localInjectorVoices;
+    std::vector<int16_t> _localInjectorSamples;
+    std::vector<AudioHRTF::Source> _localInjectorBatch;
     AudioLimiter _audioLimiter;
 
     // Adds Reverb
@@ -50,6 +50,7 @@ void AudioIOStats::reset() {
     _interface->updateMixerStream(AudioStreamStats());
     _interface->updateClientStream(AudioStreamStats());
     _interface->updateInjectorStreams(QHash<QUuid, AudioStreamStats>());
+    _interface->updateLatencies(_inputMsUnplayed, _outputMsUnplayed);
 }
 
 void AudioIOStats::sentPacket() const {
@@ -84,6 +85,10 @@ void AudioIOStats::processStreamStatsPacket(QSharedPointer<ReceivedMessage> mess
 
         if (streamStats._streamType == PositionalAudioStream::Microphone) {
             _interface->updateMixerStream(streamStats);
+
+            // the mixer's view of our microphone stream tells the encoder how the link is doing
+            QMetaObject::invokeMethod(DependencyManager::get<AudioClient>().data(), "updateEncoderNetworkConditions",
+                Q_ARG(float, streamStats._packetStreamWindowStats.getLostRate()), Q_ARG(int, sendingNode ? sendingNode->getPingMs() : 0));
         } else {
             _injectorStreams[streamStats._streamIdentifier] = streamStats;
         }
@@ -113,6 +118,7 @@ void AudioIOStats::publish() {
     // update the interface
     _interface->updateLocalBuffers(_inputMsRead, _inputMsUnplayed, _outputMsUnplayed, _packetTimegaps);
     _interface->updateClientStream(stats);
+    _interface->updateLatencies(_inputMsUnplayed, _outputMsUnplayed);
 
     // prepare a packet to the mixer
     int statsPacketSize = sizeof(appendFlag) + sizeof(numStreamStatsToPack) + sizeof(stats);
@@ -182,6 +188,21 @@ void AudioStatsInterface::updateLocalBuffers(const MovingMinMaxAvg<float>& input
     sentTimegapMsAvgWindow(timegaps.getWindowAverage() / USECS_PER_MSEC);
 }
 
+void AudioStatsInterface::updateLatencies(const MovingMinMaxAvg<float>& inputMsUnplayed,
+    const MovingMinMaxAvg<float>& outputMsUnplayed) {
+    inputLatencyMs(inputMsUnplayed.getWindowAverage());
+
+    // the ping is a round trip, the same as the trip up to the mixer and back down to us
+    networkLatencyMs(pingMs());
+
+    // the mixer holds our stream in its jitter buffer, then mixes it on its next frame
+    mixerLatencyMs((_mixer->framesAvailableAvg() + 1) * AudioConstants::NETWORK_FRAME_MSECS);
+    clientLatencyMs(_client->framesAvailableAvg() * AudioConstants::NETWORK_FRAME_MSECS);
+    outputLatencyMs(outputMsUnplayed.getWindowAverage());
+
+    totalLatencyMs(inputLatencyMs() + networkLatencyMs() + mixerLatencyMs() + clientLatencyMs() + outputLatencyMs());
+}
+
 void AudioStatsInterface::updateInjectorStreams(const QHash<QUuid, AudioStreamStats>& stats) {
     // Get existing injectors
     auto injectorIds = _injectors->dynamicPropertyNames();
@@ -79,6 +79,14 @@ class AudioStatsInterface : public QObject {
     AUDIO_PROPERTY(quint64, sentTimegapMsMaxWindow);
     AUDIO_PROPERTY(quint64, sentTimegapMsAvgWindow);
 
+    // where the mouth to ear latency goes, each stage averaged over its window
+    AUDIO_PROPERTY(float, inputLatencyMs);
+    AUDIO_PROPERTY(float, networkLatencyMs);
+    AUDIO_PROPERTY(float, mixerLatencyMs);
+    AUDIO_PROPERTY(float, clientLatencyMs);
+    AUDIO_PROPERTY(float, outputLatencyMs);
+    AUDIO_PROPERTY(float, totalLatencyMs);
+
     Q_PROPERTY(AudioStreamStatsInterface* mixerStream READ getMixerStream NOTIFY mixerStreamChanged);
     Q_PROPERTY(AudioStreamStatsInterface* clientStream READ getClientStream NOTIFY clientStreamChanged);
     Q_PROPERTY(QObject* injectorStreams READ getInjectorStreams NOTIFY injectorStreamsChanged);
@@ -95,6 +103,8 @@ public:
     void updateMixerStream(const AudioStreamStats& stats) { _mixer->updateStream(stats); emit mixerStreamChanged(); }
     void updateClientStream(const AudioStreamStats& stats) { _client->updateStream(stats); emit clientStreamChanged(); }
     void updateInjectorStreams(const QHash<QUuid, AudioStreamStats>& stats);
+    void updateLatencies(const MovingMinMaxAvg<float>& inputMsUnplayed,
+                         const MovingMinMaxAvg<float>& outputMsUnplayed);
 
 signals:
     void mixerStreamChanged();
@@ -170,7 +170,7 @@ static const float TWOPI = 6.283185307f;
 #include <emmintrin.h>
 
 // 1 channel input, 4 channel output
-static void FIR_1x4_SSE(float* src, float* dst0, float* dst1, float* dst2, float* dst3, float coef[4][HRTF_TAPS], int numFrames) {
+void FIR_1x4_SSE(float* src, float* dst0, float* dst1, float* dst2, float* dst3, float coef[4][HRTF_TAPS], int numFrames) {
 
     float* coef0 = coef[0] + HRTF_TAPS - 1;     // process backwards
     float* coef1 = coef[1] + HRTF_TAPS - 1;
@@ -227,13 +227,32 @@ static void FIR_1x4_SSE(float* src, float* dst0, float* dst1, float* dst2, float
 #include "CPUDetect.h"
 
 void FIR_1x4_AVX(float* src, float* dst0, float* dst1, float* dst2, float* dst3, float coef[4][HRTF_TAPS], int numFrames);
+void FIR_1x4_AVX2(float* src, float* dst0, float* dst1, float* dst2, float* dst3, float coef[4][HRTF_TAPS], int numFrames);
 
 static void FIR_1x4(float* src, float* dst0, float* dst1, float* dst2, float* dst3, float coef[4][HRTF_TAPS], int numFrames) {
 
-    static auto f = cpuSupportsAVX() ? FIR_1x4_AVX : FIR_1x4_SSE;
+    static auto f = cpuSupportsAVX2() ? FIR_1x4_AVX2 : (cpuSupportsAVX() ? FIR_1x4_AVX : FIR_1x4_SSE);
     (*f)(src, dst0, dst1, dst2, dst3, coef, numFrames); // dispatch
 }
 
+void mixMono_1x2_SSE(const int16_t* src, float* dst, float gain0, float gain1, const float* win, int numFrames);
+void mixMono_1x2_AVX2(const int16_t* src, float* dst, float gain0, float gain1, const float* win, int numFrames);
+
+static void mixMono_1x2(const int16_t* src, float* dst, float gain0, float gain1, const float* win, int numFrames) {
+
+    static auto f = cpuSupportsAVX2() ? mixMono_1x2_AVX2 : mixMono_1x2_SSE;
+    (*f)(src, dst, gain0, gain1, win, numFrames); // dispatch
+}
+
+void mixStereo_2x2_SSE(const int16_t* src, float* dst, float gain0, float gain1, const float* win, int numFrames);
+void mixStereo_2x2_AVX2(const int16_t* src, float* dst, float gain0, float gain1, const float* win, int numFrames);
+
+static void mixStereo_2x2(const int16_t* src, float* dst, float gain0, float gain1, const float* win, int numFrames) {
+
+    static auto f = cpuSupportsAVX2() ? mixStereo_2x2_AVX2 : mixStereo_2x2_SSE;
+    (*f)(src, dst, gain0, gain1, win, numFrames); // dispatch
+}
+
 // 4 channel planar to interleaved
 static void interleave_4x4(float* src0, float* src1, float* src2, float* src3, float* dst, int numFrames) {
 
@@ -396,6 +415,335 @@ static void interpolate(float* dst, const float* src0, const float* src1, float
     }
 }
 
+// convert int16 to float, with gain
+static void convert_1x1(const int16_t* src, float* dst, float gain, int numFrames) {
+
+    __m128 g0 = _mm_set1_ps(gain);
+
+    assert(numFrames % 8 == 0);
+
+    for (int i = 0; i < numFrames; i += 8) {
+
+        __m128i x0 = _mm_loadu_si128((const __m128i*)&src[i]);
+
+        // sign-extend to int32
+        __m128i x1 = _mm_srai_epi32(_mm_unpacklo_epi16(x0, x0), 16);
+        __m128i x2 = _mm_srai_epi32(_mm_unpackhi_epi16(x0, x0), 16);
+
+        _mm_storeu_ps(&dst[i+0], _mm_mul_ps(_mm_cvtepi32_ps(x1), g0));
+        _mm_storeu_ps(&dst[i+4], _mm_mul_ps(_mm_cvtepi32_ps(x2), g0));
+    }
+}
+
+// 1 channel int16 input, 2 channel output with gain crossfade and accumulation (interleaved)
+void mixMono_1x2_SSE(const int16_t* src, float* dst, float gain0, float gain1, const float* win, int numFrames) {
+
+    __m128 g0 = _mm_set1_ps(gain0 * (1/32768.0f));
+    __m128 g1 = _mm_set1_ps(gain1 * (1/32768.0f));
+
+    assert(numFrames % 4 == 0);
+
+    for (int i = 0; i < numFrames; i += 4) {
+
+        // crossfade old/new gain
+        __m128 f0 = _mm_loadu_ps(&win[i]);
+        __m128 g = _mm_add_ps(g1, _mm_mul_ps(f0, _mm_sub_ps(g0, g1)));
+
+        __m128i x0 = _mm_loadl_epi64((const __m128i*)&src[i]);
+        x0 = _mm_srai_epi32(_mm_unpacklo_epi16(x0, x0), 16);
+
+        __m128 x1 = _mm_mul_ps(_mm_cvtepi32_ps(x0), g);
+
+        // mono to interleaved stereo, and accumulate
+        __m128 y0 = _mm_loadu_ps(&dst[2*i+0]);
+        __m128 y1 = _mm_loadu_ps(&dst[2*i+4]);
+
+        y0 = _mm_add_ps(y0, _mm_unpacklo_ps(x1, x1));
+        y1 = _mm_add_ps(y1, _mm_unpackhi_ps(x1, x1));
+
+        _mm_storeu_ps(&dst[2*i+0], y0);
+        _mm_storeu_ps(&dst[2*i+4], y1);
+    }
+}
+
+// 2 channel int16 input, 2 channel output with gain crossfade and accumulation (interleaved)
+void mixStereo_2x2_SSE(const int16_t* src, float* dst, float gain0, float gain1, const float* win, int numFrames) {
+
+    __m128 g0 = _mm_set1_ps(gain0 * (1/32768.0f));
+    __m128 g1 = _mm_set1_ps(gain1 * (1/32768.0f));
+
+    assert(numFrames % 4 == 0);
+
+    for (int i = 0; i < numFrames; i += 4) {
+
+        // crossfade old/new gain
+        __m128 f0 = _mm_loadu_ps(&win[i]);
+        __m128 g = _mm_add_ps(g1, _mm_mul_ps(f0, _mm_sub_ps(g0, g1)));
+
+        __m128i x0 = _mm_loadu_si128((const __m128i*)&src[2*i]);
+
+        // sign-extend to int32
+        __m128i x1 = _mm_srai_epi32(_mm_unpacklo_epi16(x0, x0), 16);
+        __m128i x2 = _mm_srai_epi32(_mm_unpackhi_epi16(x0, x0), 16);
+
+        // the same gain for both channels of a frame
+        __m128 y0 = _mm_loadu_ps(&dst[2*i+0]);
+        __m128 y1 = _mm_loadu_ps(&dst[2*i+4]);
+
+        y0 = _mm_add_ps(y0, _mm_mul_ps(_mm_cvtepi32_ps(x1), _mm_unpacklo_ps(g, g)));
+        y1 = _mm_add_ps(y1, _mm_mul_ps(_mm_cvtepi32_ps(x2), _mm_unpackhi_ps(g, g)));
+
+        _mm_storeu_ps(&dst[2*i+0], y0);
+        _mm_storeu_ps(&dst[2*i+4], y1);
+    }
+}
+
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+
+#include <arm_neon.h>
+
+// 1 channel input, 4 channel output
+static void FIR_1x4(float* src, float* dst0, float* dst1, float* dst2, float* dst3, float coef[4][HRTF_TAPS], int numFrames) {
+
+    float* coef0 = coef[0] + HRTF_TAPS - 1;     // process backwards
+    float* coef1 = coef[1] + HRTF_TAPS - 1;
+    float* coef2 = coef[2] + HRTF_TAPS - 1;
+    float* coef3 = coef[3] + HRTF_TAPS - 1;
+
+    assert(numFrames % 4 == 0);
+
+    for (int i = 0; i < numFrames; i += 4) {
+
+        float32x4_t acc0 = vdupq_n_f32(0.0f);
+        float32x4_t acc1 = vdupq_n_f32(0.0f);
+        float32x4_t acc2 = vdupq_n_f32(0.0f);
+        float32x4_t acc3 = vdupq_n_f32(0.0f);
+
+        float* ps = &src[i - HRTF_TAPS + 1];    // process forwards
+
+        assert(HRTF_TAPS % 4 == 0);
+
+        for (int k = 0; k < HRTF_TAPS; k += 4) {
+
+            float32x4_t x0 = vld1q_f32(&ps[k+0]);
+            float32x4_t x1 = vld1q_f32(&ps[k+1]);
+            float32x4_t x2 = vld1q_f32(&ps[k+2]);
+            float32x4_t x3 = vld1q_f32(&ps[k+3]);
+
+            acc0 = vmlaq_n_f32(acc0, x0, coef0[-k-0]);
+            acc1 = vmlaq_n_f32(acc1, x0, coef1[-k-0]);
+            acc2 = vmlaq_n_f32(acc2, x0, coef2[-k-0]);
+            acc3 = vmlaq_n_f32(acc3, x0, coef3[-k-0]);
+
+            acc0 = vmlaq_n_f32(acc0, x1, coef0[-k-1]);
+            acc1 = vmlaq_n_f32(acc1, x1, coef1[-k-1]);
+            acc2 = vmlaq_n_f32(acc2, x1, coef2[-k-1]);
+            acc3 = vmlaq_n_f32(acc3, x1, coef3[-k-1]);
+
+            acc0 = vmlaq_n_f32(acc0, x2, coef0[-k-2]);
+            acc1 = vmlaq_n_f32(acc1, x2, coef1[-k-2]);
+            acc2 = vmlaq_n_f32(acc2, x2, coef2[-k-2]);
+            acc3 = vmlaq_n_f32(acc3, x2, coef3[-k-2]);
+
+            acc0 = vmlaq_n_f32(acc0, x3, coef0[-k-3]);
+            acc1 = vmlaq_n_f32(acc1, x3, coef1[-k-3]);
+            acc2 = vmlaq_n_f32(acc2, x3, coef2[-k-3]);
+            acc3 = vmlaq_n_f32(acc3, x3, coef3[-k-3]);
+        }
+
+        vst1q_f32(&dst0[i], acc0);
+        vst1q_f32(&dst1[i], acc1);
+        vst1q_f32(&dst2[i], acc2);
+        vst1q_f32(&dst3[i], acc3);
+    }
+}
+
+// 4 channel planar to interleaved
+static void interleave_4x4(float* src0, float* src1, float* src2, float* src3, float* dst, int numFrames) {
+
+    assert(numFrames % 4 == 0);
+
+    for (int i = 0; i < numFrames; i += 4) {
+
+        float32x4x4_t x;
+        x.val[0] = vld1q_f32(&src0[i]);
+        x.val[1] = vld1q_f32(&src1[i]);
+        x.val[2] = vld1q_f32(&src2[i]);
+        x.val[3] = vld1q_f32(&src3[i]);
+
+        vst4q_f32(&dst[4*i], x);    // interleaving store
+    }
+}
+
+// process 2 cascaded biquads on 4 channels (interleaved)
+// biquads computed in parallel, by adding one sample of delay
+static void biquad2_4x4(float* src, float* dst, float coef[5][8], float state[3][8], int numFrames) {
+
+    // prevent denormals, since flush-to-zero is not assumed
+    float32x4_t bias = vdupq_n_f32(1.0e-20f);
+
+    // restore state
+    float32x4_t y00 = vld1q_f32(&state[0][0]);
+    float32x4_t w10 = vld1q_f32(&state[1][0]);
+    float32x4_t w20 = vld1q_f32(&state[2][0]);
+
+    float32x4_t y01;
+    float32x4_t w11 = vld1q_f32(&state[1][4]);
+    float32x4_t w21 = vld1q_f32(&state[2][4]);
+
+    // first biquad coefs
+    float32x4_t b00 = vld1q_f32(&coef[0][0]);
+    float32x4_t b10 = vld1q_f32(&coef[1][0]);
+    float32x4_t b20 = vld1q_f32(&coef[2][0]);
+    float32x4_t a10 = vld1q_f32(&coef[3][0]);
+    float32x4_t a20 = vld1q_f32(&coef[4][0]);
+
+    // second biquad coefs
+    float32x4_t b01 = vld1q_f32(&coef[0][4]);
+    float32x4_t b11 = vld1q_f32(&coef[1][4]);
+    float32x4_t b21 = vld1q_f32(&coef[2][4]);
+    float32x4_t a11 = vld1q_f32(&coef[3][4]);
+    float32x4_t a21 = vld1q_f32(&coef[4][4]);
+
+    for (int i = 0; i < numFrames; i++) {
+
+        float32x4_t x00 = vaddq_f32(vld1q_f32(&src[4*i]), bias);
+        float32x4_t x01 = y00;  // first biquad output
+
+        // transposed Direct Form II
+        y00 = vmlaq_f32(w10, x00, b00);
+        y01 = vmlaq_f32(w11, x01, b01);
+
+        w10 = vmlaq_f32(w20, x00, b10);
+        w11 = vmlaq_f32(w21, x01, b11);
+
+        w20 = vmulq_f32(x00, b20);
+        w21 = vmulq_f32(x01, b21);
+
+        w10 = vmlsq_f32(w10, y00, a10);
+        w11 = vmlsq_f32(w11, y01, a11);
+
+        w20 = vmlsq_f32(w20, y00, a20);
+        w21 = vmlsq_f32(w21, y01, a21);
+
+        vst1q_f32(&dst[4*i], y01);  // second biquad output
+    }
+
+    // save state
+    vst1q_f32(&state[0][0], y00);
+    vst1q_f32(&state[1][0], w10);
+    vst1q_f32(&state[2][0], w20);
+
+    vst1q_f32(&state[1][4], w11);
+    vst1q_f32(&state[2][4], w21);
+}
+
+// crossfade 4 inputs into 2 outputs with accumulation (interleaved)
+static void crossfade_4x2(float* src, float* dst, const float* win, int numFrames) {
+
+    assert(numFrames % 4 == 0);
+
+    for (int i = 0; i < numFrames; i += 4) {
+
+        float32x4_t f0 = vld1q_f32(&win[i]);
+
+        float32x4x4_t x = vld4q_f32(&src[4*i]);     // deinterleaving load
+        float32x4x2_t y = vld2q_f32(&dst[2*i]);
+
+        // crossfade
+        float32x4_t x0 = vmlaq_f32(x.val[2], f0, vsubq_f32(x.val[0], x.val[2]));
+        float32x4_t x1 = vmlaq_f32(x.val[3], f0, vsubq_f32(x.val[1], x.val[3]));
+
+        // accumulate
+        y.val[0] = vaddq_f32(y.val[0], x0);
+        y.val[1] = vaddq_f32(y.val[1], x1);
+
+        vst2q_f32(&dst[2*i], y);    // interleaving store
+    }
+}
+
+// linear interpolation with gain
+static void interpolate(float* dst, const float* src0, const float* src1, float frac, float gain) {
+
+    float32x4_t f0 = vdupq_n_f32(HRTF_GAIN * gain * (1.0f - frac));
+    float32x4_t f1 = vdupq_n_f32(HRTF_GAIN * gain * frac);
+
+    assert(HRTF_TAPS % 4 == 0);
+
+    for (int k = 0; k < HRTF_TAPS; k += 4) {
+
+        float32x4_t x0 = vld1q_f32(&src0[k]);
+        float32x4_t x1 = vld1q_f32(&src1[k]);
+
+        vst1q_f32(&dst[k], vmlaq_f32(vmulq_f32(f0, x0), f1, x1));
+    }
+}
+
+// convert int16 to float, with gain
+static void convert_1x1(const int16_t* src, float* dst, float gain, int numFrames) {
+
+    assert(numFrames % 8 == 0);
+
+    for (int i = 0; i < numFrames; i += 8) {
+
+        int16x8_t x0 = vld1q_s16(&src[i]);
+
+        float32x4_t x1 = vcvtq_f32_s32(vmovl_s16(vget_low_s16(x0)));
+        float32x4_t x2 = vcvtq_f32_s32(vmovl_s16(vget_high_s16(x0)));
+
+        vst1q_f32(&dst[i+0], vmulq_n_f32(x1, gain));
+        vst1q_f32(&dst[i+4], vmulq_n_f32(x2, gain));
+    }
+}
+
+// 1 channel int16 input, 2 channel output with gain crossfade and accumulation (interleaved)
+static void mixMono_1x2(const int16_t* src, float* dst, float gain0, float gain1, const float* win, int numFrames) {
+
+    float32x4_t g0 = vdupq_n_f32(gain0 * (1/32768.0f));
+    float32x4_t g1 = vdupq_n_f32(gain1 * (1/32768.0f));
+
+    assert(numFrames % 4 == 0);
+
+    for (int i = 0; i < numFrames; i += 4) {
+
+        // crossfade old/new gain
+        float32x4_t g = vmlaq_f32(g1, vld1q_f32(&win[i]), vsubq_f32(g0, g1));
+
+        float32x4_t x0 = vmulq_f32(vcvtq_f32_s32(vmovl_s16(vld1_s16(&src[i]))), g);
+
+        float32x4x2_t y = vld2q_f32(&dst[2*i]);
+
+        y.val[0] = vaddq_f32(y.val[0], x0);
+        y.val[1] = vaddq_f32(y.val[1], x0);
+
+        vst2q_f32(&dst[2*i], y);
+    }
+}
+
+// 2 channel int16 input, 2 channel output with gain crossfade and accumulation (interleaved)
+static void mixStereo_2x2(const int16_t* src, float* dst, float gain0, float gain1, const float* win, int numFrames) {
+
+    float32x4_t g0 = vdupq_n_f32(gain0 * (1/32768.0f));
+    float32x4_t g1 = vdupq_n_f32(gain1 * (1/32768.0f));
+
+    assert(numFrames % 4 == 0);
+
+    for (int i = 0; i < numFrames; i += 4) {
+
+        // crossfade old/new gain
+        float32x4_t g = vmlaq_f32(g1, vld1q_f32(&win[i]), vsubq_f32(g0, g1));
+
+        int16x4x2_t x = vld2_s16(&src[2*i]);    // deinterleaving load
+
+        float32x4x2_t y = vld2q_f32(&dst[2*i]);
+
+        y.val[0] = vmlaq_f32(y.val[0], vcvtq_f32_s32(vmovl_s16(x.val[0])), g);
+        y.val[1] = vmlaq_f32(y.val[1], vcvtq_f32_s32(vmovl_s16(x.val[1])), g);
+
+        vst2q_f32(&dst[2*i], y);
+    }
+}
+
 #else   // portable reference code
 
 // 1 channel input, 4 channel output
@@ -668,8 +1016,49 @@ static void interpolate(float* dst, const float* src0, const float* src1, float
     }
 }
 
+// convert int16 to float, with gain
+static void convert_1x1(const int16_t* src, float* dst, float gain, int numFrames) {
+
+    for (int i = 0; i < numFrames; i++) {
+        dst[i] = (float)src[i] * gain;
+    }
+}
+
+// 1 channel int16 input, 2 channel output with gain crossfade and accumulation (interleaved)
+static void mixMono_1x2(const int16_t* src, float* dst, float gain0, float gain1, const float* win, int numFrames) {
+
+    for (int i = 0; i < numFrames; i++) {
+
+        float gain = gain1 + win[i] * (gain0 - gain1);
+        float x = (float)src[i] * gain * (1/32768.0f);
+
+        dst[2*i+0] += x;
+        dst[2*i+1] += x;
+    }
+}
+
+// 2 channel int16 input, 2 channel output with gain crossfade and accumulation (interleaved)
+static void mixStereo_2x2(const int16_t* src, float* dst, float gain0, float gain1, const float* win, int numFrames) {
+
+    for (int i = 0; i < numFrames; i++) {
+
+        float gain = (gain1 + win[i] * (gain0 - gain1)) * (1/32768.0f);
+
+        dst[2*i+0] += (float)src[2*i+0] * gain;
+        dst[2*i+1] += (float)src[2*i+1] * gain;
+    }
+}
+
 #endif
 
+// accumulate, simple enough to be vectorized by the compiler
+static void accumulate(float* dst, const float* src, int numSamples) {
+
+    for (int i = 0; i < numSamples; i++) {
+        dst[i] += src[i];
+    }
+}
+
 // design a 2nd order Thiran allpass
 static void ThiranBiquad(float f, float& b0, float& b1, float& b2, float& a1, float& a2) {
 
@@ -836,17 +1225,56 @@ static void setFilters(float firCoef[4][HRTF_TAPS], float bqCoef[5][8], int dela
     bqCoef[4][channel+5] = a2;
 }
 
-void AudioHRTF::render(int16_t* input, float* output, int index, float azimuth, float distance, float gain, int numFrames) {
+void AudioHRTF::render(const int16_t* input, float* output, int index, float azimuth, float distance, float gain, int numFrames) {
 
     assert(index >= 0);
     assert(index < HRTF_TABLES);
     assert(numFrames == HRTF_BLOCK);
 
+    float bqBuffer[4 * HRTF_BLOCK];                 // 4-channel (interleaved)
+
+    renderBlock(input, bqBuffer, index, azimuth, distance, gain);
+
+    // crossfade old/new output and accumulate
+    crossfade_4x2(bqBuffer, output, crossfadeTable, HRTF_BLOCK);
+}
+
+void AudioHRTF::renderBatch(const Source* sources, int numSources, float* output, int index, int numFrames) {
+
+    assert(index >= 0);
+    assert(index < HRTF_TABLES);
+    assert(numFrames == HRTF_BLOCK);
+
+    if (numSources <= 0) {
+        return;
+    }
+
+    float bqBuffer[4 * HRTF_BLOCK];                 // 4-channel (interleaved)
+    float bqMix[4 * HRTF_BLOCK];                    // 4-channel (interleaved)
+
+    // the old/new outputs of every source share the same crossfade,
+    // so they are summed here and crossfaded into the output once
+    sources[0].hrtf->renderBlock(sources[0].input, bqMix, index, 
+                                 sources[0].azimuth, sources[0].distance, sources[0].gain);
+
+    for (int i = 1; i < numSources; i++) {
+        const Source& source = sources[i];
+
+        source.hrtf->renderBlock(source.input, bqBuffer, index, source.azimuth, source.distance, source.gain);
+
+        accumulate(bqMix, bqBuffer, 4 * HRTF_BLOCK);
+    }
+
+    // crossfade old/new output and accumulate
+    crossfade_4x2(bqMix, output, crossfadeTable, HRTF_BLOCK);
+}
+
+void AudioHRTF::renderBlock(const int16_t* input, float* bqBuffer, int index, float azimuth, float distance, float gain) {
+
     float in[HRTF_TAPS + HRTF_BLOCK];               // mono
     float firCoef[4][HRTF_TAPS];                    // 4-channel
     float firBuffer[4][HRTF_DELAY + HRTF_BLOCK];    // 4-channel
     float bqCoef[5][8];                             // 4-channel (interleaved)
-    float bqBuffer[4 * HRTF_BLOCK];                 // 4-channel (interleaved)
     int delay[4];                                   // 4-channel (interleaved)
 
     // to avoid polluting the cache, old filters are recomputed instead of stored
@@ -861,9 +1289,7 @@ void AudioHRTF::render(int16_t* input, float* output, int index, float azimuth,
     _gainState = gain;
 
     // convert mono input to float
-    for (int i = 0; i < HRTF_BLOCK; i++) {
-        in[HRTF_TAPS+i] = (float)input[i] * (1/32768.0f);
-    }
+    convert_1x1(input, &in[HRTF_TAPS], (1/32768.0f), HRTF_BLOCK);
 
     // FIR state update
     memcpy(in, _firState, HRTF_TAPS * sizeof(float));
@@ -915,13 +1341,10 @@ void AudioHRTF::render(int16_t* input, float* output, int index, float azimuth,
     _bqState[1][R2] = _bqState[1][R3];
     _bqState[2][R2] = _bqState[2][R3];
 
-    // crossfade old/new output and accumulate
-    crossfade_4x2(bqBuffer, output, crossfadeTable, HRTF_BLOCK);
-
     _silentState = false;
 }
 
-void AudioHRTF::renderSilent(int16_t* input, float* output, int index, float azimuth, float distance, float gain, int numFrames) {
+void AudioHRTF::renderSilent(const int16_t* input, float* output, int index, float azimuth, float distance, float gain, int numFrames) {
 
     // process the first silent block, to flush internal state
     if (!_silentState) {
@@ -935,3 +1358,25 @@ void AudioHRTF::renderSilent(int16_t* input, float* output, int index, float azi
 
     _silentState = true;
 }
+
+void AudioHRTF::mixMono(const int16_t* input, float* output, float gain, int numFrames) {
+
+    assert(numFrames == HRTF_BLOCK);
+
+    // crossfade old/new gain and accumulate
+    mixMono_1x2(input, output, _gainState, gain, crossfadeTable, numFrames);
+
+    // new parameters become old
+    _gainState = gain;
+}
+
+void AudioHRTF::mixStereo(const int16_t* input, float* output, float gain, int numFrames) {
+
+    assert(numFrames == HRTF_BLOCK);
+
+    // crossfade old/new gain and accumulate
+    mixStereo_2x2(input, output, _gainState, gain, crossfadeTable, numFrames);
+
+    // new parameters become old
+    _gainState = gain;
+}
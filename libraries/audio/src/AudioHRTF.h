@@ -37,17 +37,52 @@ public:
     // gain: gain factor for distance attenuation
     // numFrames: must be HRTF_BLOCK in this version
     //
-    void render(int16_t* input, float* output, int index, float azimuth, float distance, float gain, int numFrames);
+    void render(const int16_t* input, float* output, int index, float azimuth, float distance, float gain, int numFrames);
+
+    //
+    // One source of a batched render
+    // hrtf: the listener-source state, updated as if render() had been called
+    // the other fields are the same as for render()
+    //
+    struct Source {
+        AudioHRTF* hrtf;
+        const int16_t* input;
+        float azimuth;
+        float distance;
+        float gain;
+    };
+
+    //
+    // Batched render of several sources for a single listener
+    // Work buffers are shared by every source, and the output is crossfaded and accumulated once per batch.
+    // output: interleaved stereo mix buffer (accumulates into existing output)
+    // index: HRTF subject index
+    // numFrames: must be HRTF_BLOCK in this version
+    //
+    static void renderBatch(const Source* sources, int numSources, float* output, int index, int numFrames);
 
     //
     // Fast path when input is known to be silent
     //
-    void renderSilent(int16_t* input, float* output, int index, float azimuth, float distance, float gain, int numFrames);
+    void renderSilent(const int16_t* input, float* output, int index, float azimuth, float distance, float gain, int numFrames);
+
+    //
+    // Non-spatialized direct mix, for sources that do not go through the HRTF
+    // input: mono source (mixMono) or interleaved stereo source (mixStereo)
+    // output: interleaved stereo mix buffer (accumulates into existing output)
+    // gain: gain factor, crossfaded from the gain of the previous call
+    // numFrames: must be HRTF_BLOCK in this version
+    //
+    void mixMono(const int16_t* input, float* output, float gain, int numFrames);
+    void mixStereo(const int16_t* input, float* output, float gain, int numFrames);
 
 private:
     AudioHRTF(const AudioHRTF&) = delete;
     AudioHRTF& operator=(const AudioHRTF&) = delete;
 
+    // renders one source into 4-channel old/new filter outputs, before the crossfade
+    void renderBlock(const int16_t* input, float* bqBuffer, int index, float azimuth, float distance, float gain);
+
     // SIMD channel assignmentS
     enum Channel {
         L0, R0,
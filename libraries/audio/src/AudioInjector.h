@@ -64,6 +64,8 @@ public:
     float getVolume() const { return _options.volume; }
     glm::vec3 getPosition() const { return _options.position; }
     bool isStereo() const { return _options.stereo; }
+    float getPriority() const { return _options.priority; }
+    float getReverbSend() const { return _options.reverbSend; }
 
     bool stateHas(AudioInjectorState state) const ;
     static void setLocalAudioInterface(AbstractAudioInterface* audioInterface) { _localAudioInterface = audioInterface; }
@@ -11,6 +11,8 @@
 
 #include "AudioInjectorManager.h"
 
+#include <algorithm>
+
 #include <QtCore/QCoreApplication>
 
 #include <SharedUtil.h>
@@ -18,28 +20,29 @@
 #include "AudioConstants.h"
 #include "AudioInjector.h"
 
+static const int MAX_INJECTORS_PER_THREAD = 40; // calculated based on AudioInjector time to send frame, with sufficient padding
+static const int MAX_INJECTOR_SUBMISSIONS = 256;
+
+// a network frame is ~10ms, so a 1ms tick keeps the frames on time and a 64 tick wheel holds a few frames ahead
+static const uint64_t WHEEL_TICK_USECS = 1000;
+static const uint64_t WHEEL_SIZE = 64;
+
+AudioInjectorManager::AudioInjectorManager() :
+    _maxInjectors(MAX_INJECTORS_PER_THREAD),
+    _submissions(MAX_INJECTOR_SUBMISSIONS),
+    _wheel(WHEEL_SIZE)
+{
+}
+
 AudioInjectorManager::~AudioInjectorManager() {
     _shouldStop = true;
-    
-    Lock lock(_injectorsMutex);
-    
-    // make sure any still living injectors are stopped and deleted
-    while (!_injectors.empty()) {
-        // grab the injector at the front
-        auto& timePointerPair = _injectors.top();
-        
-        // ask it to stop and be deleted
-        timePointerPair.second->stopAndDeleteLater();
-        
-        _injectors.pop();
+
+    // in case the thread is waiting for injectors wake it up now, it stops the still living injectors on its way out
+    {
+        Lock lock(_waitMutex);
+        _injectorReady.notify_one();
     }
     
-    // get rid of the lock now that we've stopped all living injectors
-    lock.unlock();
-    
-    // in case the thread is waiting for injectors wake it up now
-    _injectorReady.notify_one();
-    
     // quit and wait on the manager thread, if we ever created it
     if (_thread) {
         _thread->quit();
@@ -59,112 +62,236 @@ void AudioInjectorManager::createThread() {
 }
 
 void AudioInjectorManager::run() {
+    _currentTick = usecTimestampNow() / WHEEL_TICK_USECS;
+
     while (!_shouldStop) {
-        // wait until the next injector is ready, or until we get a new injector given to us
-        Lock lock(_injectorsMutex);
-        
-        if (_injectors.size() > 0) {
-            // when does the next injector need to send a frame?
-            // do we get to wait or should we just go for it now?
-            
-            auto timeInjectorPair = _injectors.top();
-            
-            auto nextTimestamp = timeInjectorPair.first;
-            int64_t difference = int64_t(nextTimestamp - usecTimestampNow());
-            
-            if (difference > 0) {
-                _injectorReady.wait_for(lock, std::chrono::microseconds(difference));
-            }
-            
-            if (_injectors.size() > 0) {
-                // loop through the injectors in the map and send whatever frames need to go out
-                auto front = _injectors.top();
-
-                // create an InjectorQueue to hold injectors to be queued
-                // this allows us to call processEvents even if a single injector wants to be re-queued immediately
-                std::vector<TimeInjectorPointerPair> heldInjectors;
-                heldInjectors.reserve(_injectors.size());
-
-                while (_injectors.size() > 0 && front.first <= usecTimestampNow()) {
-                    // either way we're popping this injector off - get a copy first
-                    auto injector = front.second;
-                    _injectors.pop();
-                    
-                    if (!injector.isNull()) {
-                        // this is an injector that's ready to go, have it send a frame now
-                        auto nextCallDelta = injector->injectNextFrame();
-
-                        if (nextCallDelta >= 0 && !injector->isFinished()) {
-                            // enqueue the injector with the correct timing in our holding queue
-                            heldInjectors.emplace(heldInjectors.end(), usecTimestampNow() + nextCallDelta, injector);
-                        }
-                    }
-                    
-                    if (_injectors.size() > 0) {
-                        front = _injectors.top();
-                    } else {
-                        // no more injectors to look at, break
-                        break;
-                    }
-                }
-
-                // if there are injectors in the holding queue, push them to our persistent queue now
-                while (!heldInjectors.empty()) {
-                    _injectors.push(heldInjectors.back());
-                    heldInjectors.pop_back();
-                }
-            }
+        uint64_t nowTick = usecTimestampNow() / WHEEL_TICK_USECS;
+
+        takeSubmissions(nowTick);
+
+        // service the slots of every tick we went past since the last pass, at most one lap of the wheel
+        if (nowTick >= _currentTick + WHEEL_SIZE) {
+            _currentTick = nowTick - WHEEL_SIZE + 1;
+        }
+        for (; _currentTick <= nowTick; ++_currentTick) {
+            serviceSlot(_currentTick, nowTick);
+        }
+
+        // let the calls queued to the injectors on this thread (restarts, stops, deletes) happen
+        QCoreApplication::processEvents();
+
+        // sleep until the next scheduled tick, or until we get a new injector given to us
+        uint64_t nextTick = 0;
+        bool hasNextTick = findNextTick(nextTick);
+        waitForInjectors(hasNextTick, nextTick);
+    }
+
+    stopAllInjectors();
+}
+
+void AudioInjectorManager::waitForInjectors(bool hasNextTick, uint64_t nextTick) {
+    Lock lock(_waitMutex);
 
+    // publish that we are about to sleep before checking for submissions, a producer pushes before checking if we sleep,
+    // so either we see its injector or it sees us waiting
+    _isWaiting = true;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if (_submissions.isEmpty() && !_shouldStop) {
+        if (hasNextTick) {
+            uint64_t wakeTime = nextTick * WHEEL_TICK_USECS;
+            uint64_t now = usecTimestampNow();
+            if (wakeTime > now) {
+                _injectorReady.wait_for(lock, std::chrono::microseconds(wakeTime - now));
+            }
         } else {
             // we have no current injectors, wait until we get at least one before we do anything
             _injectorReady.wait(lock);
         }
-        
-        // unlock the lock in case something in process events needs to modify the queue
-        lock.unlock();
-        
-        QCoreApplication::processEvents();
     }
+
+    _isWaiting = false;
 }
 
-static const int MAX_INJECTORS_PER_THREAD = 40; // calculated based on AudioInjector time to send frame, with sufficient padding
+void AudioInjectorManager::notifyInjectorReadyCondition() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
 
-bool AudioInjectorManager::wouldExceedLimits() { // Should be called inside of a lock.
-    if (_injectors.size() >= MAX_INJECTORS_PER_THREAD) {
-        qDebug() << "AudioInjectorManager::threadInjector could not thread AudioInjector - at max of"
-            << MAX_INJECTORS_PER_THREAD << "current audio injectors.";
-        return true;
+    // only take the lock when the thread is (about to be) asleep
+    if (_isWaiting) {
+        Lock lock(_waitMutex);
+        _injectorReady.notify_one();
+    }
+}
+
+void AudioInjectorManager::takeSubmissions(uint64_t nowTick) {
+    InjectorQPointer injector;
+    while (_submissions.pop(injector)) {
+        // new injectors send their first frame now
+        schedule(nowTick, injector);
+        _injectionOrder.push_back(injector);
+
+        if (_overflowPolicy == OverflowPolicy::StopOldest) {
+            while (_numScheduled > _maxInjectors && stopOldestInjector()) {}
+        }
+    }
+
+    // forget the injectors that are done, so the injection order doesn't grow with every sound ever played
+    if (_injectionOrder.size() > 2 * (size_t)std::max(_numScheduled, (int)MAX_INJECTORS_PER_THREAD)) {
+        _injectionOrder.erase(std::remove_if(_injectionOrder.begin(), _injectionOrder.end(),
+            [](const InjectorQPointer& injector) {
+                return injector.isNull() || injector->stateHas(AudioInjectorState::NetworkInjectionFinished);
+            }), _injectionOrder.end());
+    }
+}
+
+void AudioInjectorManager::schedule(uint64_t tick, InjectorQPointer injector) {
+    // the slots before _currentTick have been serviced already for this lap
+    tick = std::max(tick, _currentTick);
+    _wheel[tick % WHEEL_SIZE].emplace_back(tick, injector);
+    ++_numScheduled;
+}
+
+void AudioInjectorManager::serviceSlot(uint64_t slotTick, uint64_t nowTick) {
+    auto& slot = _wheel[slotTick % WHEEL_SIZE];
+    if (slot.empty()) {
+        return;
+    }
+
+    // take out the injectors that are due, the ones scheduled a lap or more ahead stay in the slot
+    auto due = std::partition(slot.begin(), slot.end(), [nowTick](const TickInjectorPointerPair& entry) {
+        return entry.first > nowTick;
+    });
+    _dueInjectors.assign(std::make_move_iterator(due), std::make_move_iterator(slot.end()));
+    slot.erase(due, slot.end());
+    _numScheduled -= (int)_dueInjectors.size();
+
+    for (auto& entry : _dueInjectors) {
+        auto& injector = entry.second;
+        bool isRescheduled = false;
+
+        if (!injector.isNull()) {
+            // this is an injector that's ready to go, have it send a frame now
+            auto nextCallDelta = injector->injectNextFrame();
+
+            if (nextCallDelta >= 0 && !injector->isFinished()) {
+                // reschedule it at the first tick at or after its next frame, past the slot we are servicing
+                uint64_t nextTick = (usecTimestampNow() + nextCallDelta + WHEEL_TICK_USECS - 1) / WHEEL_TICK_USECS;
+                schedule(std::max(nextTick, slotTick + 1), injector);
+                isRescheduled = true;
+            }
+        }
+
+        if (!isRescheduled) {
+            --_numInjectors;
+        }
+    }
+    _dueInjectors.clear();
+}
+
+bool AudioInjectorManager::findNextTick(uint64_t& nextTick) const {
+    if (_numScheduled == 0) {
+        return false;
+    }
+
+    // the first non empty slot, its entries may be a lap ahead in which case we just wake up early
+    for (uint64_t tick = _currentTick; tick < _currentTick + WHEEL_SIZE; ++tick) {
+        if (!_wheel[tick % WHEEL_SIZE].empty()) {
+            nextTick = tick;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool AudioInjectorManager::stopOldestInjector() {
+    while (!_injectionOrder.empty()) {
+        InjectorQPointer injector = _injectionOrder.front();
+        _injectionOrder.pop_front();
+
+        if (injector.isNull() || injector->stateHas(AudioInjectorState::NetworkInjectionFinished)) {
+            continue;
+        }
+
+        for (auto& slot : _wheel) {
+            auto it = std::find_if(slot.begin(), slot.end(), [&injector](const TickInjectorPointerPair& entry) {
+                return entry.second == injector;
+            });
+            if (it != slot.end()) {
+                slot.erase(it);
+                --_numScheduled;
+                --_numInjectors;
+
+                qDebug() << "AudioInjectorManager stopped its oldest AudioInjector - at max of"
+                    << _maxInjectors.load() << "current audio injectors.";
+                injector->finishNetworkInjection();
+                return true;
+            }
+        }
     }
     return false;
 }
 
+void AudioInjectorManager::stopAllInjectors() {
+    // make sure any still living injectors are stopped and deleted
+    InjectorQPointer injector;
+    while (_submissions.pop(injector)) {
+        if (!injector.isNull()) {
+            injector->stopAndDeleteLater();
+        }
+    }
+
+    for (auto& slot : _wheel) {
+        for (auto& entry : slot) {
+            if (!entry.second.isNull()) {
+                entry.second->stopAndDeleteLater();
+            }
+        }
+        slot.clear();
+    }
+    _numScheduled = 0;
+    _injectionOrder.clear();
+}
+
+bool AudioInjectorManager::reserveInjector() {
+    if (_numInjectors++ >= _maxInjectors && _overflowPolicy == OverflowPolicy::RejectNew) {
+        --_numInjectors;
+        qDebug() << "AudioInjectorManager::threadInjector could not thread AudioInjector - at max of"
+            << _maxInjectors.load() << "current audio injectors.";
+        return false;
+    }
+    return true;
+}
+
+bool AudioInjectorManager::submitInjector(AudioInjector* injector) {
+    if (!_submissions.push(InjectorQPointer { injector })) {
+        --_numInjectors;
+        qDebug() << "AudioInjectorManager::threadInjector could not thread AudioInjector - its queue is full.";
+        return false;
+    }
+
+    // wake the thread so we can inject two frames for this injector immediately
+    notifyInjectorReadyCondition();
+    return true;
+}
+
 bool AudioInjectorManager::threadInjector(AudioInjector* injector) {
     if (_shouldStop) {
         qDebug() << "AudioInjectorManager::threadInjector asked to thread injector but is shutting down.";
         return false;
     }
-    
-    // guard the injectors vector with a mutex
-    Lock lock(_injectorsMutex);
-    
-    if (wouldExceedLimits()) {
+
+    if (!reserveInjector()) {
         return false;
-    } else {
-        if (!_thread) {
-            createThread();
-        }
-        
-        // move the injector to the QThread
-        injector->moveToThread(_thread);
-        
-        // add the injector to the queue with a send timestamp of now
-        _injectors.emplace(usecTimestampNow(), InjectorQPointer { injector });
-        
-        // notify our wait condition so we can inject two frames for this injector immediately
-        _injectorReady.notify_one();
-        
-        return true;
     }
+
+    std::call_once(_threadCreated, [this] {
+        createThread();
+    });
+
+    // move the injector to the QThread
+    injector->moveToThread(_thread);
+
+    return submitInjector(injector);
 }
 
 bool AudioInjectorManager::restartFinishedInjector(AudioInjector* injector) {
@@ -173,17 +300,9 @@ bool AudioInjectorManager::restartFinishedInjector(AudioInjector* injector) {
         return false;
     }
 
-    // guard the injectors vector with a mutex
-    Lock lock(_injectorsMutex);
-
-    if (wouldExceedLimits()) {
+    if (!reserveInjector()) {
         return false;
-    } else {
-        // add the injector to the queue with a send timestamp of now
-        _injectors.emplace(usecTimestampNow(), InjectorQPointer { injector });
-        
-        // notify our wait condition so we can inject two frames for this injector immediately
-        _injectorReady.notify_one();
     }
-    return true;
+
+    return submitInjector(injector);
 }
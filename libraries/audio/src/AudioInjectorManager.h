@@ -14,57 +14,91 @@
 #ifndef hifi_AudioInjectorManager_h
 #define hifi_AudioInjectorManager_h
 
+#include <atomic>
 #include <condition_variable>
-#include <queue>
+#include <deque>
 #include <mutex>
+#include <vector>
 
 #include <QtCore/QPointer>
 #include <QtCore/QThread>
 
 #include <DependencyManager.h>
+#include <MPSCQueue.h>
 
 class AudioInjector;
 
+// Sends the network frames of the threaded AudioInjectors from a single thread.
+// Injectors are handed over through a lock-free queue, and scheduled on a timer wheel of WHEEL_TICK_USECS ticks,
+// so all the injectors due at the same frame boundary are serviced in one wake-up.
 class AudioInjectorManager : public QObject, public Dependency {
     Q_OBJECT
     SINGLETON_DEPENDENCY
 public:
+    // what happens to a new injector when the manager already has its maximum of injectors
+    enum class OverflowPolicy {
+        RejectNew,      // the new injector is not threaded
+        StopOldest      // the oldest injector stops sending, to make room for the new one
+    };
+
     ~AudioInjectorManager();
+
+    void setMaxInjectors(int maxInjectors) { _maxInjectors = maxInjectors; }
+    int getMaxInjectors() const { return _maxInjectors; }
+
+    void setOverflowPolicy(OverflowPolicy policy) { _overflowPolicy = policy; }
+    OverflowPolicy getOverflowPolicy() const { return _overflowPolicy; }
+
 private slots:
     void run();
 private:
     
     using InjectorQPointer = QPointer<AudioInjector>;
-    using TimeInjectorPointerPair = std::pair<uint64_t, InjectorQPointer>;
-    
-    struct greaterTime {
-        bool operator() (const TimeInjectorPointerPair& x, const TimeInjectorPointerPair& y) const {
-            return x.first > y.first;
-        }
-    };
-    
-    using InjectorQueue = std::priority_queue<TimeInjectorPointerPair,
-                                              std::deque<TimeInjectorPointerPair>,
-                                              greaterTime>;
+    using TickInjectorPointerPair = std::pair<uint64_t, InjectorQPointer>;
     using Mutex = std::mutex;
     using Lock = std::unique_lock<Mutex>;
     
     bool threadInjector(AudioInjector* injector);
     bool restartFinishedInjector(AudioInjector* injector);
-    void notifyInjectorReadyCondition() { _injectorReady.notify_one(); }
-    bool wouldExceedLimits();
+    bool reserveInjector();
+    bool submitInjector(AudioInjector* injector);
+    void notifyInjectorReadyCondition();
+    void waitForInjectors(bool hasNextTick, uint64_t nextTick);
+
+    // the timer wheel, only touched by the manager thread
+    void takeSubmissions(uint64_t nowTick);
+    void schedule(uint64_t tick, InjectorQPointer injector);
+    void serviceSlot(uint64_t slotTick, uint64_t nowTick);
+    bool findNextTick(uint64_t& nextTick) const;
+    bool stopOldestInjector();
+    void stopAllInjectors();
     
-    AudioInjectorManager() {};
+    AudioInjectorManager();
     AudioInjectorManager(const AudioInjectorManager&) = delete;
     AudioInjectorManager& operator=(const AudioInjectorManager&) = delete;
     
     void createThread();
     
     QThread* _thread { nullptr };
-    bool _shouldStop { false };
-    InjectorQueue _injectors;
-    Mutex _injectorsMutex;
+    std::once_flag _threadCreated;
+    std::atomic<bool> _shouldStop { false };
+
+    std::atomic<int> _maxInjectors;
+    std::atomic<OverflowPolicy> _overflowPolicy { OverflowPolicy::RejectNew };
+    std::atomic<int> _numInjectors { 0 };
+    MPSCQueue<InjectorQPointer> _submissions;
+
+    // the manager thread only sleeps under this lock, so a producer that sees it waiting can't miss waking it
+    std::atomic<bool> _isWaiting { false };
+    Mutex _waitMutex;
     std::condition_variable _injectorReady;
+
+    // the entries of the injectors due at a tick are in the slot of that tick modulo the wheel size
+    std::vector<std::vector<TickInjectorPointerPair>> _wheel;
+    uint64_t _currentTick { 0 };
+    std::vector<TickInjectorPointerPair> _dueInjectors;
+    int _numScheduled { 0 };
+    std::deque<InjectorQPointer> _injectionOrder;
     
     friend class AudioInjector;
 };
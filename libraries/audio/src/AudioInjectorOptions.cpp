@@ -21,7 +21,9 @@ AudioInjectorOptions::AudioInjectorOptions() :
     stereo(false),
     ignorePenumbra(false),
     localOnly(false),
-    secondOffset(0.0)
+    secondOffset(0.0),
+    priority(0.0f),
+    reverbSend(1.0f)
 {
 
 }
@@ -35,6 +37,8 @@ QScriptValue injectorOptionsToScriptValue(QScriptEngine* engine, const AudioInje
     obj.setProperty("ignorePenumbra", injectorOptions.ignorePenumbra);
     obj.setProperty("localOnly", injectorOptions.localOnly);
     obj.setProperty("secondOffset", injectorOptions.secondOffset);
+    obj.setProperty("priority", injectorOptions.priority);
+    obj.setProperty("reverbSend", injectorOptions.reverbSend);
     return obj;
 }
 
@@ -66,4 +70,12 @@ void injectorOptionsFromScriptValue(const QScriptValue& object, AudioInjectorOpt
     if (object.property("secondOffset").isValid()) {
         injectorOptions.secondOffset = object.property("secondOffset").toNumber();
     }
+
+    if (object.property("priority").isValid()) {
+        injectorOptions.priority = object.property("priority").toNumber();
+    }
+
+    if (object.property("reverbSend").isValid()) {
+        injectorOptions.reverbSend = glm::clamp((float)object.property("reverbSend").toNumber(), 0.0f, 1.0f);
+    }
  }
\ No newline at end of file
@@ -28,6 +28,8 @@ public:
     bool ignorePenumbra;
     bool localOnly;
     float secondOffset;
+    float priority; // when more local injectors play than can be mixed, the higher priority ones are heard
+    float reverbSend; // level sent to the reverb bus of a local injector, from 0 (dry) to 1
 };
 
 Q_DECLARE_METATYPE(AudioInjectorOptions);
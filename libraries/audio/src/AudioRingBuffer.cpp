@@ -73,68 +73,81 @@ void AudioRingBuffer::resizeForFrameSize(int numFrameSamples) {
     reset();
 }
 
-int AudioRingBuffer::readSamples(int16_t* destination, int maxSamples) {
-    return readData((char*)destination, maxSamples * sizeof(int16_t)) / sizeof(int16_t);
+int AudioRingBuffer::readData(char* data, int maxSize) {
+    return readSamples((int16_t*)data, maxSize / sizeof(int16_t)) * sizeof(int16_t);
 }
 
-int AudioRingBuffer::writeSamples(const int16_t* source, int maxSamples) {
-    return writeData((char*)source, maxSamples * sizeof(int16_t)) / sizeof(int16_t);
+int AudioRingBuffer::writeData(const char* data, int maxSize) {
+    return writeSamples((const int16_t*)data, maxSize / sizeof(int16_t)) * sizeof(int16_t);
 }
 
-int AudioRingBuffer::readData(char *data, int maxSize) {
+int AudioRingBuffer::readSamples(int16_t* destination, int maxSamples) {
     // only copy up to the number of samples we have available
-    int maxSamples = maxSize / sizeof(int16_t);
     int numReadSamples = std::min(maxSamples, samplesAvailable());
 
-    if (_nextOutput + numReadSamples > _buffer + _bufferLength) {
-        // we're going to need to do two reads to get this data, it wraps around the edge
-        int numSamplesToEnd = (_buffer + _bufferLength) - _nextOutput;
-
-        // read to the end of the buffer
-        memcpy(data, _nextOutput, numSamplesToEnd * sizeof(int16_t));
-
-        // read the rest from the beginning of the buffer
-        memcpy(data + (numSamplesToEnd * sizeof(int16_t)), _buffer, (numReadSamples - numSamplesToEnd) * sizeof(int16_t));
-    } else {
-        memcpy(data, _nextOutput, numReadSamples * sizeof(int16_t));
-    }
+    // at most two copies, the second when the data wraps around the edge
+    ConstIterator::Span head, tail;
+    nextOutput().getSpans(numReadSamples, head, tail);
+    memcpy(destination, head.samples, head.numSamples * sizeof(int16_t));
+    memcpy(destination + head.numSamples, tail.samples, tail.numSamples * sizeof(int16_t));
 
     shiftReadPosition(numReadSamples);
 
-    return numReadSamples * sizeof(int16_t);
+    return numReadSamples;
 }
 
-int AudioRingBuffer::writeData(const char* data, int maxSize) {
+int AudioRingBuffer::writeSamples(const int16_t* source, int maxSamples) {
     // only copy up to the number of samples we have capacity for
-    int maxSamples = maxSize / sizeof(int16_t);
     int numWriteSamples = std::min(maxSamples, _sampleCapacity);
-    int samplesRoomFor = _sampleCapacity - samplesAvailable();
-
-    if (numWriteSamples > samplesRoomFor) {
-        // there's not enough room for this write. erase old data to make room for this new data
-        int samplesToDelete = numWriteSamples - samplesRoomFor;
-        _nextOutput = shiftedPositionAccomodatingWrap(_nextOutput, samplesToDelete);
-        _overflowCount++;
-
-        qCDebug(audio) << qPrintable(RING_BUFFER_OVERFLOW_DEBUG);
-    }
+    makeRoomForWrite(numWriteSamples);
 
     if (_endOfLastWrite + numWriteSamples > _buffer + _bufferLength) {
         // we're going to need to do two writes to set this data, it wraps around the edge
         int numSamplesToEnd = (_buffer + _bufferLength) - _endOfLastWrite;
 
         // write to the end of the buffer
-        memcpy(_endOfLastWrite, data, numSamplesToEnd * sizeof(int16_t));
+        memcpy(_endOfLastWrite, source, numSamplesToEnd * sizeof(int16_t));
 
         // write the rest to the beginning of the buffer
-        memcpy(_buffer, data + (numSamplesToEnd * sizeof(int16_t)), (numWriteSamples - numSamplesToEnd) * sizeof(int16_t));
+        memcpy(_buffer, source + numSamplesToEnd, (numWriteSamples - numSamplesToEnd) * sizeof(int16_t));
     } else {
-        memcpy(_endOfLastWrite, data, numWriteSamples * sizeof(int16_t));
+        memcpy(_endOfLastWrite, source, numWriteSamples * sizeof(int16_t));
     }
 
     _endOfLastWrite = shiftedPositionAccomodatingWrap(_endOfLastWrite, numWriteSamples);
 
-    return numWriteSamples * sizeof(int16_t);
+    return numWriteSamples;
+}
+
+int16_t* AudioRingBuffer::beginWrite(int numSamples) {
+    // the buffer always has at least one frame free after the last write, that is never read from
+    if (!_buffer || numSamples > _numFrameSamples || _endOfLastWrite + numSamples > _buffer + _bufferLength) {
+        return nullptr;
+    }
+    return _endOfLastWrite;
+}
+
+int AudioRingBuffer::commitWrite(int numSamples) {
+    int numWriteSamples = std::min(numSamples, _numFrameSamples);
+
+    makeRoomForWrite(numWriteSamples);
+
+    _endOfLastWrite = shiftedPositionAccomodatingWrap(_endOfLastWrite, numWriteSamples);
+
+    return numWriteSamples;
+}
+
+void AudioRingBuffer::makeRoomForWrite(int numWriteSamples) {
+    int samplesRoomFor = _sampleCapacity - samplesAvailable();
+
+    if (numWriteSamples > samplesRoomFor) {
+        // there's not enough room for this write. erase old data to make room for this new data
+        int samplesToDelete = numWriteSamples - samplesRoomFor;
+        _nextOutput = shiftedPositionAccomodatingWrap(_nextOutput, samplesToDelete);
+        _overflowCount++;
+
+        qCDebug(audio) << qPrintable(RING_BUFFER_OVERFLOW_DEBUG);
+    }
 }
 
 int AudioRingBuffer::samplesAvailable() const {
@@ -14,6 +14,8 @@
 
 #include "AudioConstants.h"
 
+#include <algorithm>
+
 #include <QtCore/QIODevice>
 
 #include <SharedUtil.h>
@@ -49,6 +51,15 @@ public:
     /// Returns number of written samples
     int writeSamples(const int16_t* source, int maxSamples);
 
+    /// Zero-copy write: returns where the next numSamples will be written, so they can be decoded there in place,
+    /// or nullptr if they do not fit contiguously before the end of the buffer
+    /// The samples are only added to the buffer by commitWrite
+    int16_t* beginWrite(int numSamples);
+
+    /// Adds numSamples written in place after beginWrite, overwriting old data the same way writeSamples does
+    /// Returns number of written samples
+    int commitWrite(int numSamples);
+
     /// Write up to maxSamples silent samples (will only write until other data exists in the buffer)
     /// This method will not overwrite existing data in the buffer, instead dropping silent samples that would overflow
     /// Returns number of written silent samples
@@ -103,6 +114,19 @@ public:
         ConstIterator operator+(int i);
         ConstIterator operator-(int i);
 
+        /// Returns the next numSamples in place when they are contiguous in the buffer, or nullptr when they wrap
+        const int16_t* contiguousSamples(int numSamples) const;
+
+        /// A contiguous run of samples in the buffer
+        struct Span {
+            const int16_t* samples;
+            int numSamples;
+        };
+
+        /// Splits the next numSamples into the run up to the end of the buffer and the run wrapped to its start,
+        /// so they can be read in place, tail.numSamples is 0 when they do not wrap
+        void getSpans(int numSamples, Span& head, Span& tail) const;
+
         void readSamples(int16_t* dest, int numSamples);
         void readSamplesWithFade(int16_t* dest, int numSamples, float fade);
 
@@ -124,6 +148,7 @@ public:
     float getFrameLoudness(ConstIterator frameStart) const;
 
 protected:
+    void makeRoomForWrite(int numWriteSamples);
     int16_t* shiftedPositionAccomodatingWrap(int16_t* position, int numSamplesShift) const;
     float getFrameLoudness(const int16_t* frameStart) const;
 
@@ -194,13 +219,28 @@ inline AudioRingBuffer::ConstIterator AudioRingBuffer::ConstIterator::operator-(
 }
 
 inline int16_t* AudioRingBuffer::ConstIterator::atShiftedBy(int i) {
-    i = (_at - _bufferFirst + i) % _bufferLength;
-    if (i < 0) {
+    // shifts are within one length of the buffer, so wrapping needs no division
+    i += (int)(_at - _bufferFirst);
+    if (i >= _bufferLength) {
+        i -= _bufferLength;
+    } else if (i < 0) {
         i += _bufferLength;
     }
     return _bufferFirst + i;
 }
 
+inline const int16_t* AudioRingBuffer::ConstIterator::contiguousSamples(int numSamples) const {
+    return (_bufferLast - _at + 1 >= numSamples) ? _at : nullptr;
+}
+
+inline void AudioRingBuffer::ConstIterator::getSpans(int numSamples, Span& head, Span& tail) const {
+    int samplesToEnd = (int)(_bufferLast - _at + 1);
+    head.samples = _at;
+    head.numSamples = std::min(numSamples, samplesToEnd);
+    tail.samples = _bufferFirst;
+    tail.numSamples = numSamples - head.numSamples;
+}
+
 inline void AudioRingBuffer::ConstIterator::readSamples(int16_t* dest, int numSamples) {
     auto samplesToEnd = _bufferLast - _at + 1;
 
@@ -12,6 +12,9 @@
 #include <assert.h>
 #include <string.h>
 #include <algorithm>
+#include <map>
+#include <mutex>
+#include <tuple>
 
 #include "AudioSRC.h"
 #include "AudioSRCData.h"
@@ -92,7 +95,7 @@ static void cubicInterpolation(const float* input, float* output, int inputSize,
     }
 }
 
-int AudioSRC::createRationalFilter(int upFactor, int downFactor, float gain) {
+int AudioSRC::createRationalFilter(Filter& filter, int upFactor, int downFactor, float gain) {
     int numTaps = PROTOTYPE_TAPS;
     int numPhases = upFactor;
     int numCoefs = numTaps * numPhases;
@@ -117,7 +120,7 @@ int AudioSRC::createRationalFilter(int upFactor, int downFactor, float gain) {
     cubicInterpolation(prototypeFilter, tempFilter, prototypeCoefs, numCoefs, gain);
 
     // create the polyphase filter
-    _polyphaseFilter = (float*)aligned_malloc(numTaps * numPhases * sizeof(float), 32); // SIMD8
+    filter.polyphaseFilter = (float*)aligned_malloc(numTaps * numPhases * sizeof(float), 32); // SIMD8
 
     // rearrange into polyphase form, ordered by use
     for (int i = 0; i < numPhases; i++) {
@@ -126,23 +129,23 @@ int AudioSRC::createRationalFilter(int upFactor, int downFactor, float gain) {
 
             // the filter taps are reversed, so convolution is implemented as dot-product
             float f = tempFilter[(numTaps - j - 1) * numPhases + phase];
-            _polyphaseFilter[numTaps * i + j] = f;
+            filter.polyphaseFilter[numTaps * i + j] = f;
         }
     }
 
     delete[] tempFilter;
 
     // precompute the input steps
-    _stepTable = new int[numPhases];
+    filter.stepTable = new int[numPhases];
 
     for (int i = 0; i < numPhases; i++) {
-        _stepTable[i] = (((int64_t)(i+1) * downFactor) / upFactor) - (((int64_t)(i+0) * downFactor) / upFactor);
+        filter.stepTable[i] = (((int64_t)(i+1) * downFactor) / upFactor) - (((int64_t)(i+0) * downFactor) / upFactor);
     }
 
     return numTaps;
 }
 
-int AudioSRC::createIrrationalFilter(int upFactor, int downFactor, float gain) {
+int AudioSRC::createIrrationalFilter(Filter& filter, int upFactor, int downFactor, float gain) {
     int numTaps = PROTOTYPE_TAPS;
     int numPhases = upFactor;
     int numCoefs = numTaps * numPhases;
@@ -167,7 +170,7 @@ int AudioSRC::createIrrationalFilter(int upFactor, int downFactor, float gain) {
     cubicInterpolation(prototypeFilter, tempFilter, prototypeCoefs, numCoefs, gain);
 
     // create the polyphase filter, with extra phase at the end to simplify coef interpolation
-    _polyphaseFilter = (float*)aligned_malloc(numTaps * (numPhases + 1) * sizeof(float), 32);   // SIMD8
+    filter.polyphaseFilter = (float*)aligned_malloc(numTaps * (numPhases + 1) * sizeof(float), 32);   // SIMD8
 
     // rearrange into polyphase form, ordered by fractional delay
     for (int phase = 0; phase < numPhases; phase++) {
@@ -175,24 +178,51 @@ int AudioSRC::createIrrationalFilter(int upFactor, int downFactor, float gain) {
 
             // the filter taps are reversed, so convolution is implemented as dot-product
             float f = tempFilter[(numTaps - j - 1) * numPhases + phase];
-            _polyphaseFilter[numTaps * phase + j] = f;
+            filter.polyphaseFilter[numTaps * phase + j] = f;
         }
     }
 
     delete[] tempFilter;
 
     // by construction, the last tap of the first phase must be zero
-    assert(_polyphaseFilter[numTaps - 1] == 0.0f);
+    assert(filter.polyphaseFilter[numTaps - 1] == 0.0f);
 
     // so the extra phase is just the first, shifted by one
-    _polyphaseFilter[numTaps * numPhases + 0] = 0.0f;
+    filter.polyphaseFilter[numTaps * numPhases + 0] = 0.0f;
     for (int j = 1; j < numTaps; j++) {
-        _polyphaseFilter[numTaps * numPhases + j] = _polyphaseFilter[j-1];
+        filter.polyphaseFilter[numTaps * numPhases + j] = filter.polyphaseFilter[j-1];
     }
 
     return numTaps;
 }
 
+AudioSRC::Filter::~Filter() {
+    aligned_free(polyphaseFilter);
+    delete[] stepTable;
+}
+
+// The filters are shared by all the converters at the same ratio, so they are only built by the first one.
+// A filter stays in here as long as a converter uses it.
+std::shared_ptr<const AudioSRC::Filter> AudioSRC::getFilter(int upFactor, int downFactor, bool isRational) {
+    static std::mutex filtersMutex;
+    static std::map<std::tuple<int, int, bool>, std::weak_ptr<const Filter>> filters;
+
+    std::lock_guard<std::mutex> lock(filtersMutex);
+    auto& cachedFilter = filters[std::make_tuple(upFactor, downFactor, isRational)];
+    std::shared_ptr<const Filter> filter = cachedFilter.lock();
+    if (!filter) {
+        auto newFilter = std::make_shared<Filter>();
+        if (isRational) {
+            newFilter->numTaps = createRationalFilter(*newFilter, upFactor, downFactor, 1.0f);
+        } else {
+            newFilter->numTaps = createIrrationalFilter(*newFilter, upFactor, downFactor, 1.0f);
+        }
+        filter = newFilter;
+        cachedFilter = filter;
+    }
+    return filter;
+}
+
 //
 // on x86 architecture, assume that SSE2 is present
 //
@@ -1098,15 +1128,11 @@ AudioSRC::AudioSRC(int inputSampleRate, int outputSampleRate, int numChannels) {
         _step = ((int64_t)_inputSampleRate << 32) / _outputSampleRate;
     }
 
-    _polyphaseFilter = nullptr;
-    _stepTable = nullptr;
-
-    // create the polyphase filter
-    if (_step == 0) {
-        _numTaps = createRationalFilter(_upFactor, _downFactor, 1.0f);
-    } else {
-        _numTaps = createIrrationalFilter(_upFactor, _downFactor, 1.0f);
-    }
+    // get the polyphase filter
+    _filter = getFilter(_upFactor, _downFactor, _step == 0);
+    _polyphaseFilter = _filter->polyphaseFilter;
+    _stepTable = _filter->stepTable;
+    _numTaps = _filter->numTaps;
 
     //printf("up=%d down=%.3f taps=%d\n", _upFactor, _downFactor + (LO32(_step)<<SRC_PHASEBITS) * Q32_TO_FLOAT, _numTaps);
 
@@ -1132,9 +1158,6 @@ AudioSRC::AudioSRC(int inputSampleRate, int outputSampleRate, int numChannels) {
 }
 
 AudioSRC::~AudioSRC() {
-    aligned_free(_polyphaseFilter);
-    delete[] _stepTable;
-
     delete[] _history[0];
     delete[] _history[1];
 
@@ -13,6 +13,7 @@
 #define hifi_AudioSRC_h
 
 #include <stdint.h>
+#include <memory>
 
 static const int SRC_MAX_CHANNELS = 2;
 
@@ -51,8 +52,19 @@ public:
     int getExactInput(int outputFrames);
 
 private:
-    float* _polyphaseFilter;
-    int* _stepTable;
+    // the polyphase filter and input steps of one conversion ratio
+    struct Filter {
+        float* polyphaseFilter { nullptr };
+        int* stepTable { nullptr };
+        int numTaps { 0 };
+        ~Filter();
+    };
+
+    static std::shared_ptr<const Filter> getFilter(int upFactor, int downFactor, bool isRational);
+
+    std::shared_ptr<const Filter> _filter;
+    const float* _polyphaseFilter;
+    const int* _stepTable;
 
     float* _history[SRC_MAX_CHANNELS];
     float* _inputs[SRC_MAX_CHANNELS];
@@ -72,8 +84,8 @@ private:
     int64_t _offset;
     int64_t _step;
 
-    int createRationalFilter(int upFactor, int downFactor, float gain);
-    int createIrrationalFilter(int upFactor, int downFactor, float gain);
+    static int createRationalFilter(Filter& filter, int upFactor, int downFactor, float gain);
+    static int createIrrationalFilter(Filter& filter, int upFactor, int downFactor, float gain);
 
     int multirateFilter1(const float* input0, float* output0, int inputFrames);
     int multirateFilter2(const float* input0, const float* input1, float* output0, float* output1, int inputFrames);
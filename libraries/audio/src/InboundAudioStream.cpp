@@ -67,6 +67,8 @@ void InboundAudioStream::reset() {
     _lastPopOutput = AudioRingBuffer::ConstIterator();
     _isStarved = true;
     _hasStarted = false;
+    _isInSilentRun = false;
+    _silentRunFrames = 0;
     resetStats();
     // FIXME: calling cleanupCodec() seems to be the cause of the buzzsaw -- we get an assert
     // after this is called in AudioClient.  Ponder and fix...
@@ -129,6 +131,15 @@ int InboundAudioStream::parseData(ReceivedMessage& message) {
     int propertyBytes = parseStreamProperties(message.getType(), message.readWithoutCopy(message.getBytesLeftToRead()), networkFrames);
     message.seek(prePropertyPosition + propertyBytes);
 
+    // any packet ends a run of silence, a silent run packet starts a new one
+    bool isSilentRun = message.getType() == PacketType::SilentAudioRun;
+    quint16 numSilentRunFrames = 0;
+    if (isSilentRun) {
+        message.readPrimitive(&numSilentRunFrames);
+    }
+    _isInSilentRun = false;
+    _silentRunFrames = 0;
+
     // handle this packet based on its arrival status.
     switch (arrivalInfo._status) {
         case SequenceNumberStats::Early: {
@@ -142,9 +153,16 @@ int InboundAudioStream::parseData(ReceivedMessage& message) {
         }
         case SequenceNumberStats::OnTime: {
             // Packet is on time; parse its data to the ringbuffer
-            if (message.getType() == PacketType::SilentAudioFrame) {
+            if (message.getType() == PacketType::SilentAudioFrame || isSilentRun) {
                 // FIXME - Some codecs need to know about these silent frames... and can produce better output
                 writeDroppableSilentFrames(networkFrames);
+
+                if (isSilentRun) {
+                    // the sender stops sending until the run is over, the rest of the run is synthesized as it is played
+                    _isInSilentRun = true;
+                    _silentRunFrames = std::max(numSilentRunFrames - 1, 0);
+                    _silentRunFrameSamples = networkFrames;
+                }
             } else {
                 // note: PCM and no codec are identical
                 bool selectedPCM = _selectedCodecName == "pcm" || _selectedCodecName == "";
@@ -196,7 +214,7 @@ int InboundAudioStream::parseData(ReceivedMessage& message) {
 }
 
 int InboundAudioStream::parseStreamProperties(PacketType type, const QByteArray& packetAfterSeqNum, int& numAudioSamples) {
-    if (type == PacketType::SilentAudioFrame) {
+    if (type == PacketType::SilentAudioFrame || type == PacketType::SilentAudioRun) {
         quint16 numSilentSamples = 0;
         memcpy(&numSilentSamples, packetAfterSeqNum.constData(), sizeof(quint16));
         numAudioSamples = numSilentSamples;
@@ -209,14 +227,21 @@ int InboundAudioStream::parseStreamProperties(PacketType type, const QByteArray&
 }
 
 int InboundAudioStream::parseAudioData(PacketType type, const QByteArray& packetAfterStreamProperties) {
-    QByteArray decodedBuffer;
-    if (_decoder) {
-        _decoder->decode(packetAfterStreamProperties, decodedBuffer);
-    } else {
-        decodedBuffer = packetAfterStreamProperties;
+    if (!_decoder) {
+        return _ringBuffer.writeData(packetAfterStreamProperties.data(), packetAfterStreamProperties.size());
     }
-    auto actualSize = decodedBuffer.size();
-    return _ringBuffer.writeData(decodedBuffer.data(), actualSize);
+
+    // decode straight into the ring buffer, unless this frame would wrap around its end
+    int numFrameSamples = _ringBuffer.getNumFrameSamples();
+    int16_t* frameSlot = _ringBuffer.beginWrite(numFrameSamples);
+    if (frameSlot) {
+        int numDecodedSamples = _decoder->decodeInPlace(packetAfterStreamProperties, frameSlot, numFrameSamples);
+        return _ringBuffer.commitWrite(numDecodedSamples) * sizeof(int16_t);
+    }
+
+    QByteArray decodedBuffer;
+    _decoder->decode(packetAfterStreamProperties, decodedBuffer);
+    return _ringBuffer.writeData(decodedBuffer.data(), decodedBuffer.size());
 }
 
 int InboundAudioStream::writeDroppableSilentFrames(int silentFrames) {
@@ -255,6 +280,10 @@ int InboundAudioStream::writeDroppableSilentFrames(int silentFrames) {
 }
 
 int InboundAudioStream::popSamples(int maxSamples, bool allOrNothing) {
+    if (_silentRunFrames > 0) {
+        writeSilentRunFrames(maxSamples);
+    }
+
     int samplesPopped = 0;
     int samplesAvailable = _ringBuffer.samplesAvailable();
     if (_isStarved) {
@@ -281,6 +310,21 @@ int InboundAudioStream::popSamples(int maxSamples, bool allOrNothing) {
     return samplesPopped;
 }
 
+void InboundAudioStream::writeSilentRunFrames(int samplesToPop) {
+    // keep the desired jitter buffer of silence ahead of what is popped, so audio that ends the run does not starve
+    int samplesWanted = samplesToPop + _desiredJitterBufferFrames * _ringBuffer.getNumFrameSamples();
+
+    while (_silentRunFrames > 0 && _ringBuffer.samplesAvailable() < samplesWanted) {
+        writeDroppableSilentFrames(_silentRunFrameSamples);
+        --_silentRunFrames;
+    }
+
+    if (_isStarved && _ringBuffer.framesAvailable() >= _desiredJitterBufferFrames) {
+        qCInfo(audiostream, "Starve ended");
+        _isStarved = false;
+    }
+}
+
 int InboundAudioStream::popFrames(int maxFrames, bool allOrNothing) {
     int numFrameSamples = _ringBuffer.getNumFrameSamples();
     int samplesPopped = popSamples(maxFrames * numFrameSamples, allOrNothing);
@@ -384,7 +428,8 @@ void InboundAudioStream::packetReceivedUpdateTimingStats() {
     // discard the first few packets we receive since they usually have gaps that aren't represensative of normal jitter
     const quint32 NUM_INITIAL_PACKETS_DISCARD = 1000; // 10s
     quint64 now = usecTimestampNow();
-    if (_incomingSequenceNumberStats.getReceived() > NUM_INITIAL_PACKETS_DISCARD) {
+    // the gap after a silent run is the run itself, not jitter
+    if (_incomingSequenceNumberStats.getReceived() > NUM_INITIAL_PACKETS_DISCARD && !_isInSilentRun) {
         quint64 gap = now - _lastPacketReceivedTime;
         _timeGapStatsForStatsPacket.update(gap);
 
@@ -417,7 +462,35 @@ void InboundAudioStream::packetReceivedUpdateTimingStats() {
 }
 
 int InboundAudioStream::writeFramesForDroppedPackets(int networkFrames) {
-    return writeLastFrameRepeatedWithFade(networkFrames);
+    int samplesToWrite = networkFrames * _numChannels;
+
+    if (_decoder) {
+        // have the codec conceal the lost frames when it can, it sounds better than repeating the last one
+        int numFrameSamples = _ringBuffer.getNumFrameSamples();
+        while (samplesToWrite >= numFrameSamples) {
+            int numConcealedSamples = 0;
+            int16_t* frameSlot = _ringBuffer.beginWrite(numFrameSamples);
+            if (frameSlot) {
+                numConcealedSamples = _decoder->concealLostFrame(frameSlot, numFrameSamples);
+                _ringBuffer.commitWrite(numConcealedSamples);
+            } else {
+                // this frame would wrap around the end of the ring buffer
+                QByteArray concealedBuffer(numFrameSamples * sizeof(int16_t), 0);
+                numConcealedSamples = _decoder->concealLostFrame(reinterpret_cast<int16_t*>(concealedBuffer.data()), numFrameSamples);
+                _ringBuffer.writeData(concealedBuffer.data(), numConcealedSamples * sizeof(int16_t));
+            }
+
+            if (numConcealedSamples == 0) {
+                break;
+            }
+            samplesToWrite -= numConcealedSamples;
+        }
+    }
+
+    if (samplesToWrite > 0) {
+        writeLastFrameRepeatedWithFade(samplesToWrite / _numChannels);
+    }
+    return networkFrames;
 }
 
 int InboundAudioStream::writeLastFrameRepeatedWithFade(int frames) {
@@ -137,6 +137,9 @@ protected:
     /// writes silent frames to the buffer that may be dropped to reduce latency caused by the buffer
     virtual int writeDroppableSilentFrames(int silentFrames);
 
+    /// writes the frames of a silent run that are needed to pop samplesToPop, see PacketType::SilentAudioRun
+    void writeSilentRunFrames(int samplesToPop);
+
     /// writes the last written frame repeatedly, gradually fading to silence.
     /// used for writing samples for dropped packets.
     virtual int writeLastFrameRepeatedWithFade(int frames);
@@ -156,6 +159,11 @@ protected:
     bool _isStarved { true };
     bool _hasStarted { false };
 
+    // silent run announced by the sender, and the frames of it still to be synthesized
+    bool _isInSilentRun { false };
+    int _silentRunFrames { 0 };
+    int _silentRunFrameSamples { 0 };
+
     // stats
 
     int _consecutiveNotMixedCount { 0 };
@@ -15,6 +15,8 @@
 
 #include <QDataStream>
 #include <QtCore/QDebug>
+#include <QtCore/QRunnable>
+#include <QtCore/QThreadPool>
 #include <QtNetwork/QNetworkRequest>
 #include <QtNetwork/QNetworkReply>
 #include <qendian.h>
@@ -51,62 +53,110 @@ Sound::Sound(const QUrl& url, bool isStereo) :
 
 }
 
+// Decodes a downloaded sound off the main thread, and resamples it once to the rate everything mixes at
+class SoundProcessor : public QRunnable {
+public:
+    SoundProcessor(const QWeakPointer<Resource>& sound, const QUrl& url, const QByteArray& data, bool isStereo) :
+        _sound(sound), _url(url), _data(data), _isStereo(isStereo) {}
+
+    virtual void run() override;
+
+private:
+    QByteArray resample(const QByteArray& rawAudioByteArray, int sampleRate);
+    int interpretAsWav(const QByteArray& inputAudioByteArray, QByteArray& outputAudioByteArray);
+
+    QWeakPointer<Resource> _sound;
+    QUrl _url;
+    QByteArray _data;
+    bool _isStereo;
+    float _duration { 0.0f };
+};
+
 void Sound::downloadFinished(const QByteArray& data) {
-    // replace our byte array with the downloaded data
-    QByteArray rawAudioByteArray = QByteArray(data);
-    QString fileName = getURL().fileName().toLower();
+    QThreadPool::globalInstance()->start(new SoundProcessor(_self, getURL(), data, _isStereo));
+}
+
+void Sound::setAudioData(const QByteArray& audioData, bool isStereo, float duration) {
+    _byteArray = audioData;
+    _isStereo = isStereo;
+    _duration = duration;
+
+    finishedLoading(true);
+
+    _isReady = true;
+    emit ready();
+}
+
+void SoundProcessor::run() {
+    QByteArray outputAudioByteArray;
+    QString fileName = _url.fileName().toLower();
 
     static const QString WAV_EXTENSION = ".wav";
     static const QString RAW_EXTENSION = ".raw";
+    static const int RAW_SAMPLE_RATE = 48000;
     if (fileName.endsWith(WAV_EXTENSION)) {
 
-        QByteArray outputAudioByteArray;
+        QByteArray wavAudioByteArray;
 
-        interpretAsWav(rawAudioByteArray, outputAudioByteArray);
-        downSample(outputAudioByteArray);
+        int sampleRate = interpretAsWav(_data, wavAudioByteArray);
+        if (sampleRate > 0) {
+            outputAudioByteArray = resample(wavAudioByteArray, sampleRate);
+        }
     } else if (fileName.endsWith(RAW_EXTENSION)) {
         // check if this was a stereo raw file
         // since it's raw the only way for us to know that is if the file was called .stereo.raw
-        if (fileName.toLower().endsWith("stereo.raw")) {
+        if (fileName.endsWith("stereo.raw")) {
             _isStereo = true;
-            qCDebug(audio) << "Processing sound of" << rawAudioByteArray.size() << "bytes from" << getURL() << "as stereo audio file.";
+            qCDebug(audio) << "Processing sound of" << _data.size() << "bytes from" << _url << "as stereo audio file.";
         }
 
         // Process as RAW file
-        downSample(rawAudioByteArray);
+        int numChannels = _isStereo ? 2 : 1;
+        _duration = (float)_data.size() / (RAW_SAMPLE_RATE * numChannels * sizeof(AudioConstants::AudioSample));
+        outputAudioByteArray = resample(_data, RAW_SAMPLE_RATE);
     } else {
         qCDebug(audio) << "Unknown sound file type";
     }
 
-    finishedLoading(true);
-
-    _isReady = true;
-    emit ready();
+    // Ensure the sound has not been deleted
+    auto sound = _sound.toStrongRef();
+    if (!sound) {
+        qCDebug(audio) << "Abandoning load of" << _url << "; sound was deleted";
+        return;
+    }
+    QMetaObject::invokeMethod(sound.data(), "setAudioData", Q_ARG(QByteArray, outputAudioByteArray),
+                              Q_ARG(bool, _isStereo), Q_ARG(float, _duration));
 }
 
-void Sound::downSample(const QByteArray& rawAudioByteArray) {
+QByteArray SoundProcessor::resample(const QByteArray& rawAudioByteArray, int sampleRate) {
     // assume that this was a RAW file and is now an array of samples that are
-    // signed, 16-bit, 48Khz
+    // signed, 16-bit, at the given sample rate
 
     // we want to convert it to the format that the audio-mixer wants
     // which is signed, 16-bit, 24Khz
+    // the local injectors mix at that rate too, the output device resamples the whole mix once
 
     int numChannels = _isStereo ? 2 : 1;
-    AudioSRC resampler(48000, AudioConstants::SAMPLE_RATE, numChannels);
+    int numSourceFrames = rawAudioByteArray.size() / (numChannels * sizeof(AudioConstants::AudioSample));
+    if (sampleRate == AudioConstants::SAMPLE_RATE) {
+        return rawAudioByteArray.left(numSourceFrames * numChannels * sizeof(AudioConstants::AudioSample));
+    }
+
+    AudioSRC resampler(sampleRate, AudioConstants::SAMPLE_RATE, numChannels);
 
     // resize to max possible output
-    int numSourceFrames = rawAudioByteArray.size() / (numChannels * sizeof(AudioConstants::AudioSample));
     int maxDestinationFrames = resampler.getMaxOutput(numSourceFrames);
     int maxDestinationBytes = maxDestinationFrames * numChannels * sizeof(AudioConstants::AudioSample);
-    _byteArray.resize(maxDestinationBytes);
+    QByteArray byteArray(maxDestinationBytes, 0);
 
-    int numDestinationFrames = resampler.render((int16_t*)rawAudioByteArray.data(), 
-                                                (int16_t*)_byteArray.data(), 
+    int numDestinationFrames = resampler.render((const int16_t*)rawAudioByteArray.constData(),
+                                                (int16_t*)byteArray.data(),
                                                 numSourceFrames);
 
     // truncate to actual output
     int numDestinationBytes = numDestinationFrames * numChannels * sizeof(AudioConstants::AudioSample);
-    _byteArray.resize(numDestinationBytes);
+    byteArray.resize(numDestinationBytes);
+    return byteArray;
 }
 
 //
@@ -160,7 +210,8 @@ struct CombinedHeader {
     WAVEHeader  wave;
 };
 
-void Sound::interpretAsWav(const QByteArray& inputAudioByteArray, QByteArray& outputAudioByteArray) {
+// returns the sample rate of the wav, or 0 if it could not be read
+int SoundProcessor::interpretAsWav(const QByteArray& inputAudioByteArray, QByteArray& outputAudioByteArray) {
 
     CombinedHeader fileHeader;
 
@@ -174,34 +225,36 @@ void Sound::interpretAsWav(const QByteArray& inputAudioByteArray, QByteArray& ou
             // descriptor.id == "RIFX" also signifies BigEndian file
             // waveStream.setByteOrder(QDataStream::BigEndian);
             qCDebug(audio) << "Currently not supporting big-endian audio files.";
-            return;
+            return 0;
         }
 
         if (strncmp(fileHeader.riff.type, "WAVE", 4) != 0
             || strncmp(fileHeader.wave.descriptor.id, "fmt", 3) != 0) {
             qCDebug(audio) << "Not a WAVE Audio file.";
-            return;
+            return 0;
         }
 
         // added the endianess check as an extra level of security
 
         if (qFromLittleEndian<quint16>(fileHeader.wave.audioFormat) != 1) {
             qCDebug(audio) << "Currently not supporting non PCM audio files.";
-            return;
+            return 0;
         }
         if (qFromLittleEndian<quint16>(fileHeader.wave.numChannels) == 2) {
             _isStereo = true;
         } else if (qFromLittleEndian<quint16>(fileHeader.wave.numChannels) > 2) {
             qCDebug(audio) << "Currently not support audio files with more than 2 channels.";
+            return 0;
         }
 
         if (qFromLittleEndian<quint16>(fileHeader.wave.bitsPerSample) != 16) {
             qCDebug(audio) << "Currently not supporting non 16bit audio files.";
-            return;
+            return 0;
         }
-        if (qFromLittleEndian<quint32>(fileHeader.wave.sampleRate) != 48000) {
-            qCDebug(audio) << "Currently not supporting non 48KHz audio files.";
-            return;
+        int sampleRate = (int)qFromLittleEndian<quint32>(fileHeader.wave.sampleRate);
+        if (sampleRate <= 0) {
+            qCDebug(audio) << "Invalid sample rate in wav audio file.";
+            return 0;
         }
 
         // Skip any extra data in the WAVE chunk
@@ -218,7 +271,7 @@ void Sound::interpretAsWav(const QByteArray& inputAudioByteArray, QByteArray& ou
                 waveStream.skipRawData(dataHeader.descriptor.size);
             } else {
                 qCDebug(audio) << "Could not read wav audio data header.";
-                return;
+                return 0;
             }
         }
 
@@ -230,9 +283,10 @@ void Sound::interpretAsWav(const QByteArray& inputAudioByteArray, QByteArray& ou
         }
 
         _duration = (float) (outputAudioByteArraySize / (fileHeader.wave.sampleRate * fileHeader.wave.numChannels * fileHeader.wave.bitsPerSample / 8.0f));
+        return sampleRate;
 
     } else {
         qCDebug(audio) << "Could not read wav audio file header.";
-        return;
+        return 0;
     }
 }
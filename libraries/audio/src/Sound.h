@@ -33,16 +33,17 @@ public:
 
 signals:
     void ready();
-    
+
+protected:
+    // called back by the background decode, with the samples in the network format
+    Q_INVOKABLE void setAudioData(const QByteArray& audioData, bool isStereo, float duration);
+
 private:
     QByteArray _byteArray;
     bool _isStereo;
     bool _isReady;
-    float _duration; // In seconds
-    
-    void downSample(const QByteArray& rawAudioByteArray);
-    void interpretAsWav(const QByteArray& inputAudioByteArray, QByteArray& outputAudioByteArray);
-    
+    float _duration { 0.0f }; // In seconds
+
     virtual void downloadFinished(const QByteArray& data) override;
 };
 
@@ -0,0 +1,167 @@
+//
+//  AudioHRTF_avx2.cpp
+//  libraries/audio/src/avx2
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+
+#include <assert.h>
+#include <immintrin.h>
+
+#include "../AudioHRTF.h"
+
+#ifndef __AVX2__
+#error Must be compiled with /arch:AVX2 or -mavx2 -mfma.
+#endif
+
+// 1 channel input, 4 channel output
+void FIR_1x4_AVX2(float* src, float* dst0, float* dst1, float* dst2, float* dst3, float coef[4][HRTF_TAPS], int numFrames) {
+
+    float* coef0 = coef[0] + HRTF_TAPS - 1;     // process backwards
+    float* coef1 = coef[1] + HRTF_TAPS - 1;
+    float* coef2 = coef[2] + HRTF_TAPS - 1;
+    float* coef3 = coef[3] + HRTF_TAPS - 1;
+
+    assert(numFrames % 8 == 0);
+
+    for (int i = 0; i < numFrames; i += 8) {
+
+        __m256 acc0 = _mm256_setzero_ps();
+        __m256 acc1 = _mm256_setzero_ps();
+        __m256 acc2 = _mm256_setzero_ps();
+        __m256 acc3 = _mm256_setzero_ps();
+
+        float* ps = &src[i - HRTF_TAPS + 1];    // process forwards
+
+        assert(HRTF_TAPS % 8 == 0);
+
+        for (int k = 0; k < HRTF_TAPS; k += 8) {
+
+            __m256 x0 = _mm256_loadu_ps(&ps[k+0]);
+            __m256 x1 = _mm256_loadu_ps(&ps[k+1]);
+            __m256 x2 = _mm256_loadu_ps(&ps[k+2]);
+            __m256 x3 = _mm256_loadu_ps(&ps[k+3]);
+            __m256 x4 = _mm256_loadu_ps(&ps[k+4]);
+            __m256 x5 = _mm256_loadu_ps(&ps[k+5]);
+            __m256 x6 = _mm256_loadu_ps(&ps[k+6]);
+            __m256 x7 = _mm256_loadu_ps(&ps[k+7]);
+
+            acc0 = _mm256_fmadd_ps(_mm256_broadcast_ss(&coef0[-k-0]), x0, acc0);
+            acc1 = _mm256_fmadd_ps(_mm256_broadcast_ss(&coef1[-k-0]), x0, acc1);
+            acc2 = _mm256_fmadd_ps(_mm256_broadcast_ss(&coef2[-k-0]), x0, acc2);
+            acc3 = _mm256_fmadd_ps(_mm256_broadcast_ss(&coef3[-k-0]), x0, acc3);
+
+            acc0 = _mm256_fmadd_ps(_mm256_broadcast_ss(&coef0[-k-1]), x1, acc0);
+            acc1 = _mm256_fmadd_ps(_mm256_broadcast_ss(&coef1[-k-1]), x1, acc1);
+            acc2 = _mm256_fmadd_ps(_mm256_broadcast_ss(&coef2[-k-1]), x1, acc2);
+            acc3 = _mm256_fmadd_ps(_mm256_broadcast_ss(&coef3[-k-1]), x1, acc3);
+
+            acc0 = _mm256_fmadd_ps(_mm256_broadcast_ss(&coef0[-k-2]), x2, acc0);
+            acc1 = _mm256_fmadd_ps(_mm256_broadcast_ss(&coef1[-k-2]), x2, acc1);
+            acc2 = _mm256_fmadd_ps(_mm256_broadcast_ss(&coef2[-k-2]), x2, acc2);
+            acc3 = _mm256_fmadd_ps(_mm256_broadcast_ss(&coef3[-k-2]), x2, acc3);
+
+            acc0 = _mm256_fmadd_ps(_mm256_broadcast_ss(&coef0[-k-3]), x3, acc0);
+            acc1 = _mm256_fmadd_ps(_mm256_broadcast_ss(&coef1[-k-3]), x3, acc1);
+            acc2 = _mm256_fmadd_ps(_mm256_broadcast_ss(&coef2[-k-3]), x3, acc2);
+            acc3 = _mm256_fmadd_ps(_mm256_broadcast_ss(&coef3[-k-3]), x3, acc3);
+
+            acc0 = _mm256_fmadd_ps(_mm256_broadcast_ss(&coef0[-k-4]), x4, acc0);
+            acc1 = _mm256_fmadd_ps(_mm256_broadcast_ss(&coef1[-k-4]), x4, acc1);
+            acc2 = _mm256_fmadd_ps(_mm256_broadcast_ss(&coef2[-k-4]), x4, acc2);
+            acc3 = _mm256_fmadd_ps(_mm256_broadcast_ss(&coef3[-k-4]), x4, acc3);
+
+            acc0 = _mm256_fmadd_ps(_mm256_broadcast_ss(&coef0[-k-5]), x5, acc0);
+            acc1 = _mm256_fmadd_ps(_mm256_broadcast_ss(&coef1[-k-5]), x5, acc1);
+            acc2 = _mm256_fmadd_ps(_mm256_broadcast_ss(&coef2[-k-5]), x5, acc2);
+            acc3 = _mm256_fmadd_ps(_mm256_broadcast_ss(&coef3[-k-5]), x5, acc3);
+
+            acc0 = _mm256_fmadd_ps(_mm256_broadcast_ss(&coef0[-k-6]), x6, acc0);
+            acc1 = _mm256_fmadd_ps(_mm256_broadcast_ss(&coef1[-k-6]), x6, acc1);
+            acc2 = _mm256_fmadd_ps(_mm256_broadcast_ss(&coef2[-k-6]), x6, acc2);
+            acc3 = _mm256_fmadd_ps(_mm256_broadcast_ss(&coef3[-k-6]), x6, acc3);
+
+            acc0 = _mm256_fmadd_ps(_mm256_broadcast_ss(&coef0[-k-7]), x7, acc0);
+            acc1 = _mm256_fmadd_ps(_mm256_broadcast_ss(&coef1[-k-7]), x7, acc1);
+            acc2 = _mm256_fmadd_ps(_mm256_broadcast_ss(&coef2[-k-7]), x7, acc2);
+            acc3 = _mm256_fmadd_ps(_mm256_broadcast_ss(&coef3[-k-7]), x7, acc3);
+        }
+
+        _mm256_storeu_ps(&dst0[i], acc0);
+        _mm256_storeu_ps(&dst1[i], acc1);
+        _mm256_storeu_ps(&dst2[i], acc2);
+        _mm256_storeu_ps(&dst3[i], acc3);
+    }
+
+    _mm256_zeroupper();
+}
+
+// 1 channel int16 input, 2 channel output with gain crossfade and accumulation (interleaved)
+void mixMono_1x2_AVX2(const int16_t* src, float* dst, float gain0, float gain1, const float* win, int numFrames) {
+
+    __m256 g0 = _mm256_set1_ps(gain0 * (1/32768.0f));
+    __m256 g1 = _mm256_set1_ps(gain1 * (1/32768.0f));
+
+    assert(numFrames % 8 == 0);
+
+    for (int i = 0; i < numFrames; i += 8) {
+
+        // crossfade old/new gain
+        __m256 g = _mm256_fmadd_ps(_mm256_loadu_ps(&win[i]), _mm256_sub_ps(g0, g1), g1);
+
+        __m256i x0 = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)&src[i]));
+        __m256 x1 = _mm256_mul_ps(_mm256_cvtepi32_ps(x0), g);
+
+        // mono to interleaved stereo
+        __m256 lo = _mm256_unpacklo_ps(x1, x1);     // [ 0 0 1 1 | 4 4 5 5 ]
+        __m256 hi = _mm256_unpackhi_ps(x1, x1);     // [ 2 2 3 3 | 6 6 7 7 ]
+
+        __m256 y0 = _mm256_add_ps(_mm256_loadu_ps(&dst[2*i+0]), _mm256_permute2f128_ps(lo, hi, 0x20));
+        __m256 y1 = _mm256_add_ps(_mm256_loadu_ps(&dst[2*i+8]), _mm256_permute2f128_ps(lo, hi, 0x31));
+
+        _mm256_storeu_ps(&dst[2*i+0], y0);
+        _mm256_storeu_ps(&dst[2*i+8], y1);
+    }
+
+    _mm256_zeroupper();
+}
+
+// 2 channel int16 input, 2 channel output with gain crossfade and accumulation (interleaved)
+void mixStereo_2x2_AVX2(const int16_t* src, float* dst, float gain0, float gain1, const float* win, int numFrames) {
+
+    __m256 g0 = _mm256_set1_ps(gain0 * (1/32768.0f));
+    __m256 g1 = _mm256_set1_ps(gain1 * (1/32768.0f));
+
+    assert(numFrames % 8 == 0);
+
+    for (int i = 0; i < numFrames; i += 8) {
+
+        // crossfade old/new gain
+        __m256 g = _mm256_fmadd_ps(_mm256_loadu_ps(&win[i]), _mm256_sub_ps(g0, g1), g1);
+
+        // the same gain for both channels of a frame
+        __m256 lo = _mm256_unpacklo_ps(g, g);       // [ 0 0 1 1 | 4 4 5 5 ]
+        __m256 hi = _mm256_unpackhi_ps(g, g);       // [ 2 2 3 3 | 6 6 7 7 ]
+
+        __m256 gain2 = _mm256_permute2f128_ps(lo, hi, 0x20);
+        __m256 gain3 = _mm256_permute2f128_ps(lo, hi, 0x31);
+
+        __m256i x0 = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)&src[2*i+0]));
+        __m256i x1 = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)&src[2*i+8]));
+
+        __m256 y0 = _mm256_fmadd_ps(_mm256_cvtepi32_ps(x0), gain2, _mm256_loadu_ps(&dst[2*i+0]));
+        __m256 y1 = _mm256_fmadd_ps(_mm256_cvtepi32_ps(x1), gain3, _mm256_loadu_ps(&dst[2*i+8]));
+
+        _mm256_storeu_ps(&dst[2*i+0], y0);
+        _mm256_storeu_ps(&dst[2*i+8], y1);
+    }
+
+    _mm256_zeroupper();
+}
+
+#endif
@@ -16,6 +16,7 @@
 #include <cstring>
 #include <stdint.h>
 
+#include <QtCore/QCryptographicHash>
 #include <QtCore/QDataStream>
 #include <QtCore/QThread>
 #include <QtCore/QUuid>
@@ -89,7 +90,9 @@ namespace AvatarDataPacket {
     struct JointData {
         uint8_t numJoints;
         uint8_t rotationValidityBits[ceil(numJoints / 8)];     // one bit per joint, if true then a compressed rotation follows.
+        uint8_t rotationCoarseBits[ceil(numJoints / 8)];       // one bit per joint, if true its rotation is a FourByteQuat
         SixByteQuat rotation[numValidRotations];  // encodeded and compressed by packOrientationQuatToSixBytes()
+                                                  // or packOrientationQuatToFourBytes() for coarse joints
         uint8_t translationValidityBits[ceil(numJoints / 8)];  // one bit per joint, if true then a compressed translation follows.
         SixByteTrans translation[numValidTranslations];  // encodeded and compressed by packFloatVec3ToSignedTwoByteFixed()
     };
@@ -181,6 +184,14 @@ void AvatarData::setHandPosition(const glm::vec3& handPosition) {
 }
 
 QByteArray AvatarData::toByteArray(bool cullSmallChanges, bool sendAll) {
+    return encodeByteArray(cullSmallChanges, sendAll, true);
+}
+
+QByteArray AvatarData::toMinimalByteArray() {
+    return encodeByteArray(false, false, false);
+}
+
+QByteArray AvatarData::encodeByteArray(bool cullSmallChanges, bool sendAll, bool sendJoints) {
     // TODO: DRY this up to a shared method
     // that can pack any type given the number of bytes
     // and return the number of bytes to push the pointer
@@ -270,6 +281,8 @@ QByteArray AvatarData::toByteArray(bool cullSmallChanges, bool sendAll) {
         destinationBuffer += _headData->_blendshapeCoefficients.size() * sizeof(float);
     }
 
+    updateCoarseJointRotations();
+
     QReadLocker readLock(&_jointDataLock);
 
     // joint rotation data
@@ -287,7 +300,7 @@ QByteArray AvatarData::toByteArray(bool cullSmallChanges, bool sendAll) {
 
     for (int i=0; i < _jointData.size(); i++) {
         const JointData& data = _jointData[i];
-        if (sendAll || _lastSentJointData[i].rotation != data.rotation) {
+        if (sendJoints && (sendAll || _lastSentJointData[i].rotation != data.rotation)) {
             if (sendAll ||
                 !cullSmallChanges ||
                 fabsf(glm::dot(data.rotation, _lastSentJointData[i].rotation)) <= AVATAR_MIN_ROTATION_DOT) {
@@ -308,12 +321,32 @@ QByteArray AvatarData::toByteArray(bool cullSmallChanges, bool sendAll) {
         *destinationBuffer++ = validity;
     }
 
+    // coarse rotation bits, the rotations of these joints are packed with less precision
+    validity = 0;
+    validityBit = 0;
+    for (int i = 0; i < _jointData.size(); i++) {
+        if (isCoarseJointRotation(i)) {
+            validity |= (1 << validityBit);
+        }
+        if (++validityBit == BITS_IN_BYTE) {
+            *destinationBuffer++ = validity;
+            validityBit = validity = 0;
+        }
+    }
+    if (validityBit != 0) {
+        *destinationBuffer++ = validity;
+    }
+
     validityBit = 0;
     validity = *validityPosition++;
     for (int i = 0; i < _jointData.size(); i ++) {
         const JointData& data = _jointData[i];
         if (validity & (1 << validityBit)) {
-            destinationBuffer += packOrientationQuatToSixBytes(destinationBuffer, data.rotation);
+            if (isCoarseJointRotation(i)) {
+                destinationBuffer += packOrientationQuatToFourBytes(destinationBuffer, data.rotation);
+            } else {
+                destinationBuffer += packOrientationQuatToSixBytes(destinationBuffer, data.rotation);
+            }
         }
         if (++validityBit == BITS_IN_BYTE) {
             validityBit = 0;
@@ -335,7 +368,7 @@ QByteArray AvatarData::toByteArray(bool cullSmallChanges, bool sendAll) {
     float maxTranslationDimension = 0.0;
     for (int i=0; i < _jointData.size(); i++) {
         const JointData& data = _jointData[i];
-        if (sendAll || _lastSentJointData[i].translation != data.translation) {
+        if (sendJoints && (sendAll || _lastSentJointData[i].translation != data.translation)) {
             if (sendAll ||
                 !cullSmallChanges ||
                 glm::distance(data.translation, _lastSentJointData[i].translation) > AVATAR_MIN_TRANSLATION) {
@@ -440,7 +473,7 @@ bool AvatarData::shouldLogError(const quint64& now) {
 }
 
 
-const unsigned char* unpackFauxJoint(const unsigned char* sourceBuffer, ThreadSafeValueCache<glm::mat4>& matrixCache) {
+const unsigned char* unpackFauxJoint(const unsigned char* sourceBuffer, glm::mat4& matrix) {
     glm::quat orientation;
     glm::vec3 position;
     Transform transform;
@@ -448,7 +481,7 @@ const unsigned char* unpackFauxJoint(const unsigned char* sourceBuffer, ThreadSa
     sourceBuffer += unpackFloatVec3FromSignedTwoByteFixed(sourceBuffer, position, TRANSLATION_COMPRESSION_RADIX);
     transform.setTranslation(position);
     transform.setRotation(orientation);
-    matrixCache.set(transform.getMatrix());
+    matrix = transform.getMatrix();
     return sourceBuffer;
 }
 
@@ -465,10 +498,28 @@ const unsigned char* unpackFauxJoint(const unsigned char* sourceBuffer, ThreadSa
 
 // read data in packet starting at byte offset and return number of bytes parsed
 int AvatarData::parseDataFromBuffer(const QByteArray& buffer) {
-    // lazily allocate memory for HeadData in case we're not an Avatar instance
-    if (!_headData) {
-        _headData = new HeadData(this);
+    int bytesRead = decodeNetworkState(buffer);
+    applyNetworkState(_networkState);
+    return bytesRead;
+}
+
+int AvatarData::receiveDataFromBuffer(const QByteArray& buffer) {
+    int bytesRead = decodeNetworkState(buffer);
+    _receivedNetworkStates.getWriteBuffer() = _networkState;
+    _receivedNetworkStates.publish();
+    return bytesRead;
+}
+
+bool AvatarData::applyReceivedNetworkState() {
+    if (!_receivedNetworkStates.consume()) {
+        return false;
     }
+    applyNetworkState(_receivedNetworkStates.getReadBuffer());
+    return true;
+}
+
+int AvatarData::decodeNetworkState(const QByteArray& buffer) {
+    AvatarNetworkState& state = _networkState;
 
     const unsigned char* startPosition = reinterpret_cast<const unsigned char*>(buffer.data());
     const unsigned char* endPosition = startPosition + buffer.size();
@@ -480,14 +531,15 @@ int AvatarData::parseDataFromBuffer(const QByteArray& buffer) {
     sourceBuffer += sizeof(AvatarDataPacket::Header);
 
     glm::vec3 position = glm::vec3(header->position[0], header->position[1], header->position[2]);
-    _globalPosition = glm::vec3(header->globalPosition[0], header->globalPosition[1], header->globalPosition[2]);
+    state.globalPosition = glm::vec3(header->globalPosition[0], header->globalPosition[1], header->globalPosition[2]);
     if (isNaN(position)) {
         if (shouldLogError(now)) {
             qCWarning(avatars) << "Discard AvatarData packet: position NaN, uuid " << getSessionUUID();
         }
         return buffer.size();
     }
-    setLocalPosition(position);
+    state.localPosition = position;
+    state.isValid = true;
 
     float pitch, yaw, roll;
     unpackFloatAngleFromTwoByte(header->localOrientation + 0, &yaw);
@@ -499,14 +551,8 @@ int AvatarData::parseDataFromBuffer(const QByteArray& buffer) {
         }
         return buffer.size();
     }
-
-    glm::quat currentOrientation = getLocalOrientation();
     glm::vec3 newEulerAngles(pitch, yaw, roll);
-    glm::quat newOrientation = glm::quat(glm::radians(newEulerAngles));
-    if (currentOrientation != newOrientation) {
-        _hasNewJointRotations = true;
-        setLocalOrientation(newOrientation);
-    }
+    state.localOrientation = glm::quat(glm::radians(newEulerAngles));
 
     float scale;
     unpackFloatRatioFromTwoByte((uint8_t*)&header->scale, scale);
@@ -516,7 +562,7 @@ int AvatarData::parseDataFromBuffer(const QByteArray& buffer) {
         }
         return buffer.size();
     }
-    setTargetScale(scale);
+    state.targetScale = scale;
 
     glm::vec3 lookAt = glm::vec3(header->lookAtPosition[0], header->lookAtPosition[1], header->lookAtPosition[2]);
     if (isNaN(lookAt)) {
@@ -525,7 +571,7 @@ int AvatarData::parseDataFromBuffer(const QByteArray& buffer) {
         }
         return buffer.size();
     }
-    _headData->_lookAtPosition = lookAt;
+    state.lookAtPosition = lookAt;
 
     float audioLoudness = header->audioLoudness;
     if (isNaN(audioLoudness)) {
@@ -534,22 +580,20 @@ int AvatarData::parseDataFromBuffer(const QByteArray& buffer) {
         }
         return buffer.size();
     }
-    _headData->_audioLoudness = audioLoudness;
+    state.audioLoudness = audioLoudness;
 
     glm::quat sensorToWorldQuat;
     unpackOrientationQuatFromSixBytes(header->sensorToWorldQuat, sensorToWorldQuat);
     float sensorToWorldScale;
     unpackFloatScalarFromSignedTwoByteFixed((int16_t*)&header->sensorToWorldScale, &sensorToWorldScale, SENSOR_TO_WORLD_SCALE_RADIX);
     glm::vec3 sensorToWorldTrans(header->sensorToWorldTrans[0], header->sensorToWorldTrans[1], header->sensorToWorldTrans[2]);
-    glm::mat4 sensorToWorldMatrix = createMatFromScaleQuatAndPos(glm::vec3(sensorToWorldScale), sensorToWorldQuat, sensorToWorldTrans);
-
-    _sensorToWorldMatrixCache.set(sensorToWorldMatrix);
+    state.sensorToWorldMatrix = createMatFromScaleQuatAndPos(glm::vec3(sensorToWorldScale), sensorToWorldQuat, sensorToWorldTrans);
 
     { // bitFlags and face data
         uint8_t bitItems = header->flags;
 
         // key state, stored as a semi-nibble in the bitItems
-        _keyState = (KeyState)getSemiNibbleAt(bitItems, KEY_STATE_START_BIT);
+        state.keyState = (KeyState)getSemiNibbleAt(bitItems, KEY_STATE_START_BIT);
 
         // hand state, stored as a semi-nibble plus a bit in the bitItems
         // we store the hand state as well as other items in a shared bitset. The hand state is an octal, but is split
@@ -558,11 +602,11 @@ int AvatarData::parseDataFromBuffer(const QByteArray& buffer) {
         //     |x,x|H0,H1|x,x,x|H2|
         //     +---+-----+-----+--+
         // Hand state - H0,H1,H2 is found in the 3rd, 4th, and 8th bits
-        _handState = getSemiNibbleAt(bitItems, HAND_STATE_START_BIT)
+        state.handState = getSemiNibbleAt(bitItems, HAND_STATE_START_BIT)
             + (oneAtBit(bitItems, HAND_STATE_FINGER_POINTING_BIT) ? IS_FINGER_POINTING_FLAG : 0);
 
-        _headData->_isFaceTrackerConnected = oneAtBit(bitItems, IS_FACESHIFT_CONNECTED);
-        _headData->_isEyeTrackerConnected = oneAtBit(bitItems, IS_EYE_TRACKER_CONNECTED);
+        state.isFaceTrackerConnected = oneAtBit(bitItems, IS_FACESHIFT_CONNECTED);
+        state.isEyeTrackerConnected = oneAtBit(bitItems, IS_EYE_TRACKER_CONNECTED);
         bool hasReferential = oneAtBit(bitItems, HAS_REFERENTIAL);
 
         if (hasReferential) {
@@ -571,27 +615,27 @@ int AvatarData::parseDataFromBuffer(const QByteArray& buffer) {
             sourceBuffer += sizeof(AvatarDataPacket::ParentInfo);
 
             QByteArray byteArray((const char*)parentInfo->parentUUID, NUM_BYTES_RFC4122_UUID);
-            _parentID = QUuid::fromRfc4122(byteArray);
-            _parentJointIndex = parentInfo->parentJointIndex;
+            state.parentID = QUuid::fromRfc4122(byteArray);
+            state.parentJointIndex = parentInfo->parentJointIndex;
         } else {
-            _parentID = QUuid();
+            state.parentID = QUuid();
         }
 
-        if (_headData->_isFaceTrackerConnected) {
+        if (state.isFaceTrackerConnected) {
             PACKET_READ_CHECK(FaceTrackerInfo, sizeof(AvatarDataPacket::FaceTrackerInfo));
             auto faceTrackerInfo = reinterpret_cast<const AvatarDataPacket::FaceTrackerInfo*>(sourceBuffer);
             sourceBuffer += sizeof(AvatarDataPacket::FaceTrackerInfo);
 
-            _headData->_leftEyeBlink = faceTrackerInfo->leftEyeBlink;
-            _headData->_rightEyeBlink = faceTrackerInfo->rightEyeBlink;
-            _headData->_averageLoudness = faceTrackerInfo->averageLoudness;
-            _headData->_browAudioLift = faceTrackerInfo->browAudioLift;
+            state.leftEyeBlink = faceTrackerInfo->leftEyeBlink;
+            state.rightEyeBlink = faceTrackerInfo->rightEyeBlink;
+            state.averageLoudness = faceTrackerInfo->averageLoudness;
+            state.browAudioLift = faceTrackerInfo->browAudioLift;
 
             int numCoefficients = faceTrackerInfo->numBlendshapeCoefficients;
             const int coefficientsSize = sizeof(float) * numCoefficients;
             PACKET_READ_CHECK(FaceTrackerCoefficients, coefficientsSize);
-            _headData->_blendshapeCoefficients.resize(numCoefficients);  // make sure there's room for the copy!
-            memcpy(_headData->_blendshapeCoefficients.data(), sourceBuffer, coefficientsSize);
+            state.blendshapeCoefficients.resize(numCoefficients);  // make sure there's room for the copy!
+            memcpy(state.blendshapeCoefficients.data(), sourceBuffer, coefficientsSize);
             sourceBuffer += coefficientsSize;
         }
     }
@@ -621,20 +665,49 @@ int AvatarData::parseDataFromBuffer(const QByteArray& buffer) {
         }
     }
 
-    // each joint rotation is stored in 6 bytes.
-    QWriteLocker writeLock(&_jointDataLock);
-    _jointData.resize(numJoints);
+    PACKET_READ_CHECK(JointRotationCoarseBits, bytesOfValidity);
+
+    int numValidCoarseJointRotations = 0;
+    QVector<bool> coarseRotations;
+    coarseRotations.resize(numJoints);
+    { // coarse rotation bits
+        unsigned char validity = 0;
+        int validityBit = 0;
+        for (int i = 0; i < numJoints; i++) {
+            if (validityBit == 0) {
+                validity = *sourceBuffer++;
+            }
+            bool coarse = (bool)(validity & (1 << validityBit));
+            if (coarse && validRotations[i]) {
+                ++numValidCoarseJointRotations;
+            }
+            coarseRotations[i] = coarse;
+            validityBit = (validityBit + 1) % BITS_IN_BYTE;
+        }
+    }
+
+    // each joint rotation is stored in 6 bytes, or 4 bytes for coarse joints.
+    state.jointData.resize(numJoints);
+    state.coarseJointRotations = coarseRotations;
 
     const int COMPRESSED_QUATERNION_SIZE = 6;
-    PACKET_READ_CHECK(JointRotations, numValidJointRotations * COMPRESSED_QUATERNION_SIZE);
+    const int COARSE_COMPRESSED_QUATERNION_SIZE = 4;
+    PACKET_READ_CHECK(JointRotations, (numValidJointRotations - numValidCoarseJointRotations) * COMPRESSED_QUATERNION_SIZE
+                                      + numValidCoarseJointRotations * COARSE_COMPRESSED_QUATERNION_SIZE);
     for (int i = 0; i < numJoints; i++) {
-        JointData& data = _jointData[i];
+        JointData& data = state.jointData[i];
         if (validRotations[i]) {
-            sourceBuffer += unpackOrientationQuatFromSixBytes(sourceBuffer, data.rotation);
-            _hasNewJointRotations = true;
+            if (coarseRotations[i]) {
+                sourceBuffer += unpackOrientationQuatFromFourBytes(sourceBuffer, data.rotation);
+            } else {
+                sourceBuffer += unpackOrientationQuatFromSixBytes(sourceBuffer, data.rotation);
+            }
             data.rotationSet = true;
         }
     }
+    if (numValidJointRotations > 0) {
+        ++state.jointRotationsVersion;
+    }
 
     PACKET_READ_CHECK(JointTranslationValidityBits, bytesOfValidity);
 
@@ -663,13 +736,15 @@ int AvatarData::parseDataFromBuffer(const QByteArray& buffer) {
     PACKET_READ_CHECK(JointTranslation, numValidJointTranslations * COMPRESSED_TRANSLATION_SIZE);
 
     for (int i = 0; i < numJoints; i++) {
-        JointData& data = _jointData[i];
+        JointData& data = state.jointData[i];
         if (validTranslations[i]) {
             sourceBuffer += unpackFloatVec3FromSignedTwoByteFixed(sourceBuffer, data.translation, TRANSLATION_COMPRESSION_RADIX);
-            _hasNewJointTranslations = true;
             data.translationSet = true;
         }
     }
+    if (numValidJointTranslations > 0) {
+        ++state.jointTranslationsVersion;
+    }
 
     #ifdef WANT_DEBUG
     if (numValidJointRotations > 15) {
@@ -680,14 +755,68 @@ int AvatarData::parseDataFromBuffer(const QByteArray& buffer) {
     #endif
 
     // faux joints
-    sourceBuffer = unpackFauxJoint(sourceBuffer, _controllerLeftHandMatrixCache);
-    sourceBuffer = unpackFauxJoint(sourceBuffer, _controllerRightHandMatrixCache);
+    sourceBuffer = unpackFauxJoint(sourceBuffer, state.controllerLeftHandMatrix);
+    sourceBuffer = unpackFauxJoint(sourceBuffer, state.controllerRightHandMatrix);
 
     int numBytesRead = sourceBuffer - startPosition;
     _averageBytesReceived.updateAverage(numBytesRead);
     return numBytesRead;
 }
 
+void AvatarData::applyNetworkState(const AvatarNetworkState& state) {
+    if (!state.isValid) {
+        return;
+    }
+
+    // lazily allocate memory for HeadData in case we're not an Avatar instance
+    if (!_headData) {
+        _headData = new HeadData(this);
+    }
+
+    _globalPosition = state.globalPosition;
+    setLocalPosition(state.localPosition);
+
+    if (getLocalOrientation() != state.localOrientation) {
+        _hasNewJointRotations = true;
+        setLocalOrientation(state.localOrientation);
+    }
+
+    setTargetScale(state.targetScale);
+    _headData->_lookAtPosition = state.lookAtPosition;
+    _headData->_audioLoudness = state.audioLoudness;
+    _sensorToWorldMatrixCache.set(state.sensorToWorldMatrix);
+
+    _keyState = state.keyState;
+    _handState = state.handState;
+    _headData->_isFaceTrackerConnected = state.isFaceTrackerConnected;
+    _headData->_isEyeTrackerConnected = state.isEyeTrackerConnected;
+    _parentID = state.parentID;
+    _parentJointIndex = state.parentJointIndex;
+
+    _headData->_leftEyeBlink = state.leftEyeBlink;
+    _headData->_rightEyeBlink = state.rightEyeBlink;
+    _headData->_averageLoudness = state.averageLoudness;
+    _headData->_browAudioLift = state.browAudioLift;
+    _headData->_blendshapeCoefficients = state.blendshapeCoefficients;
+
+    {
+        QWriteLocker writeLock(&_jointDataLock);
+        _jointData = state.jointData;
+        _coarseJointRotations = state.coarseJointRotations;
+    }
+    if (state.jointRotationsVersion != _appliedJointRotationsVersion) {
+        _appliedJointRotationsVersion = state.jointRotationsVersion;
+        _hasNewJointRotations = true;
+    }
+    if (state.jointTranslationsVersion != _appliedJointTranslationsVersion) {
+        _appliedJointTranslationsVersion = state.jointTranslationsVersion;
+        _hasNewJointTranslations = true;
+    }
+
+    _controllerLeftHandMatrixCache.set(state.controllerLeftHandMatrix);
+    _controllerRightHandMatrixCache.set(state.controllerRightHandMatrix);
+}
+
 int AvatarData::getAverageBytesReceivedPerSecond() const {
     return lrint(_averageBytesReceived.getAverageSampleValuePerSecond());
 }
@@ -743,16 +872,14 @@ void AvatarData::clearJointData(int index) {
     }
 }
 
+// The joint data is a copy of the pose (taken once per frame on the thread of the avatar) under _jointDataLock, so the
+// reads below don't need to go through the thread of the avatar.
+
 bool AvatarData::isJointDataValid(int index) const {
     if (index == -1) {
         return false;
     }
-    if (QThread::currentThread() != thread()) {
-        bool result;
-        QMetaObject::invokeMethod(const_cast<AvatarData*>(this), "isJointDataValid", Qt::BlockingQueuedConnection,
-            Q_RETURN_ARG(bool, result), Q_ARG(int, index));
-        return result;
-    }
+    QReadLocker readLock(&_jointDataLock);
     return index < _jointData.size();
 }
 
@@ -760,12 +887,6 @@ glm::quat AvatarData::getJointRotation(int index) const {
     if (index == -1) {
         return glm::quat();
     }
-    if (QThread::currentThread() != thread()) {
-        glm::quat result;
-        QMetaObject::invokeMethod(const_cast<AvatarData*>(this), "getJointRotation", Qt::BlockingQueuedConnection,
-            Q_RETURN_ARG(glm::quat, result), Q_ARG(int, index));
-        return result;
-    }
     QReadLocker readLock(&_jointDataLock);
     return index < _jointData.size() ? _jointData.at(index).rotation : glm::quat();
 }
@@ -775,23 +896,11 @@ glm::vec3 AvatarData::getJointTranslation(int index) const {
     if (index == -1) {
         return glm::vec3();
     }
-    if (QThread::currentThread() != thread()) {
-        glm::vec3 result;
-        QMetaObject::invokeMethod(const_cast<AvatarData*>(this), "getJointTranslation", Qt::BlockingQueuedConnection,
-            Q_RETURN_ARG(glm::vec3, result), Q_ARG(int, index));
-        return result;
-    }
     QReadLocker readLock(&_jointDataLock);
     return index < _jointData.size() ? _jointData.at(index).translation : glm::vec3();
 }
 
 glm::vec3 AvatarData::getJointTranslation(const QString& name) const {
-    if (QThread::currentThread() != thread()) {
-        glm::vec3 result;
-        QMetaObject::invokeMethod(const_cast<AvatarData*>(this), "getJointTranslation", Qt::BlockingQueuedConnection,
-            Q_RETURN_ARG(glm::vec3, result), Q_ARG(const QString&, name));
-        return result;
-    }
     return getJointTranslation(getJointIndex(name));
 }
 
@@ -864,33 +973,14 @@ void AvatarData::clearJointData(const QString& name) {
 }
 
 bool AvatarData::isJointDataValid(const QString& name) const {
-    if (QThread::currentThread() != thread()) {
-        bool result;
-        QMetaObject::invokeMethod(const_cast<AvatarData*>(this), "isJointDataValid", Qt::BlockingQueuedConnection,
-            Q_RETURN_ARG(bool, result), Q_ARG(const QString&, name));
-        return result;
-    }
     return isJointDataValid(getJointIndex(name));
 }
 
 glm::quat AvatarData::getJointRotation(const QString& name) const {
-    if (QThread::currentThread() != thread()) {
-        glm::quat result;
-        QMetaObject::invokeMethod(const_cast<AvatarData*>(this), "getJointRotation", Qt::BlockingQueuedConnection,
-            Q_RETURN_ARG(glm::quat, result), Q_ARG(const QString&, name));
-        return result;
-    }
     return getJointRotation(getJointIndex(name));
 }
 
 QVector<glm::quat> AvatarData::getJointRotations() const {
-    if (QThread::currentThread() != thread()) {
-        QVector<glm::quat> result;
-        QMetaObject::invokeMethod(const_cast<AvatarData*>(this),
-                                  "getJointRotations", Qt::BlockingQueuedConnection,
-                                  Q_RETURN_ARG(QVector<glm::quat>, result));
-        return result;
-    }
     QReadLocker readLock(&_jointDataLock);
     QVector<glm::quat> jointRotations(_jointData.size());
     for (int i = 0; i < _jointData.size(); ++i) {
@@ -901,37 +991,24 @@ QVector<glm::quat> AvatarData::getJointRotations() const {
 
 void AvatarData::setJointRotations(QVector<glm::quat> jointRotations) {
     if (QThread::currentThread() != thread()) {
-        QVector<glm::quat> result;
-        QMetaObject::invokeMethod(const_cast<AvatarData*>(this),
-                                  "setJointRotations", Qt::BlockingQueuedConnection,
-                                  Q_ARG(QVector<glm::quat>, jointRotations));
-    }
-    QWriteLocker writeLock(&_jointDataLock);
-    if (_jointData.size() < jointRotations.size()) {
-        _jointData.resize(jointRotations.size());
+        // like the other joint setters this is applied in order on the thread of the avatar, the caller doesn't wait
+        QMetaObject::invokeMethod(this, "setJointRotations", Q_ARG(QVector<glm::quat>, jointRotations));
+        return;
     }
+    // setJointRotation() takes the lock and grows the joint data as needed
     for (int i = 0; i < jointRotations.size(); ++i) {
-        if (i < _jointData.size()) {
-            setJointRotation(i, jointRotations[i]);
-        }
+        setJointRotation(i, jointRotations[i]);
     }
 }
 
 void AvatarData::setJointTranslations(QVector<glm::vec3> jointTranslations) {
     if (QThread::currentThread() != thread()) {
-        QVector<glm::quat> result;
-        QMetaObject::invokeMethod(const_cast<AvatarData*>(this),
-                                  "setJointTranslations", Qt::BlockingQueuedConnection,
-                                  Q_ARG(QVector<glm::vec3>, jointTranslations));
-    }
-    QWriteLocker writeLock(&_jointDataLock);
-    if (_jointData.size() < jointTranslations.size()) {
-        _jointData.resize(jointTranslations.size());
+        QMetaObject::invokeMethod(this, "setJointTranslations", Q_ARG(QVector<glm::vec3>, jointTranslations));
+        return;
     }
+    // setJointTranslation() takes the lock and grows the joint data as needed
     for (int i = 0; i < jointTranslations.size(); ++i) {
-        if (i < _jointData.size()) {
-            setJointTranslation(i, jointTranslations[i]);
-        }
+        setJointTranslation(i, jointTranslations[i]);
     }
 }
 
@@ -965,6 +1042,34 @@ int AvatarData::getJointIndex(const QString& name) const {
     return _jointIndices.value(name) - 1;
 }
 
+void AvatarData::updateCoarseJointRotations() {
+    // the fingers don't need the precision of the rest of the skeleton
+    static const QStringList COARSE_JOINT_PREFIXES = {
+        "LeftHandThumb", "LeftHandIndex", "LeftHandMiddle", "LeftHandRing", "LeftHandPinky",
+        "RightHandThumb", "RightHandIndex", "RightHandMiddle", "RightHandRing", "RightHandPinky"
+    };
+
+    QStringList jointNames = getJointNames();
+    if (jointNames.isEmpty() || jointNames == _coarseJointRotationNames) {
+        // avatars without a skeleton keep the precision they were last received with
+        return;
+    }
+
+    QVector<bool> coarseRotations(jointNames.size(), false);
+    for (int i = 0; i < jointNames.size(); i++) {
+        for (auto& prefix : COARSE_JOINT_PREFIXES) {
+            if (jointNames[i].startsWith(prefix)) {
+                coarseRotations[i] = true;
+                break;
+            }
+        }
+    }
+
+    QWriteLocker writeLock(&_jointDataLock);
+    _coarseJointRotations = coarseRotations;
+    _coarseJointRotationNames = jointNames;
+}
+
 QStringList AvatarData::getJointNames() const {
     QReadLocker readLock(&_jointDataLock);
     return _jointNames;
@@ -973,7 +1078,8 @@ QStringList AvatarData::getJointNames() const {
 void AvatarData::parseAvatarIdentityPacket(const QByteArray& data, Identity& identityOut) {
     QDataStream packetStream(data);
 
-    packetStream >> identityOut.uuid >> identityOut.skeletonModelURL >> identityOut.attachmentData >> identityOut.displayName >> identityOut.avatarEntityData;
+    packetStream >> identityOut.uuid >> identityOut.skeletonModelURL >> identityOut.attachmentData >> identityOut.displayName >> identityOut.avatarEntityData
+        >> identityOut.avatarEntityVersions;
 }
 
 static const QUrl emptyURL("");
@@ -1013,18 +1119,31 @@ bool AvatarData::processAvatarIdentity(const Identity& identity) {
     return hasIdentityChanged;
 }
 
-QByteArray AvatarData::identityByteArray() {
+QByteArray AvatarData::identityByteArray(bool withAvatarEntityVersions) {
     QByteArray identityData;
     QDataStream identityStream(&identityData, QIODevice::Append);
     const QUrl& urlToSend = cannonicalSkeletonModelURL(emptyURL);
 
     _avatarEntitiesLock.withReadLock([&] {
-        identityStream << getSessionUUID() << urlToSend << _attachmentData << _displayName << _avatarEntityData;
+        identityStream << getSessionUUID() << urlToSend << _attachmentData << _displayName;
+        if (withAvatarEntityVersions) {
+            AvatarEntityVersions avatarEntityVersions;
+            for (auto it = _avatarEntityData.constBegin(); it != _avatarEntityData.constEnd(); ++it) {
+                avatarEntityVersions.insert(it.key(), avatarEntityVersion(it.value()));
+            }
+            identityStream << AvatarEntityMap() << avatarEntityVersions;
+        } else {
+            identityStream << _avatarEntityData << AvatarEntityVersions();
+        }
     });
 
     return identityData;
 }
 
+QByteArray AvatarData::avatarEntityVersion(const QByteArray& entityData) {
+    return QCryptographicHash::hash(entityData, QCryptographicHash::Md5);
+}
+
 void AvatarData::setSkeletonModelURL(const QUrl& skeletonModelURL) {
     const QUrl& expanded = skeletonModelURL.isEmpty() ? AvatarData::defaultFullAvatarModelUrl() : skeletonModelURL;
     if (expanded == _skeletonModelURL) {
@@ -1789,6 +1908,19 @@ AvatarEntityIDs AvatarData::getAndClearRecentlyDetachedIDs() {
     return result;
 }
 
+AvatarEntityMap AvatarData::copyAvatarEntityData(const QVector<QUuid>& entityIDs) const {
+    AvatarEntityMap result;
+    _avatarEntitiesLock.withReadLock([&] {
+        for (auto& entityID : entityIDs) {
+            auto it = _avatarEntityData.constFind(entityID);
+            if (it != _avatarEntityData.constEnd()) {
+                result.insert(entityID, it.value());
+            }
+        }
+    });
+    return result;
+}
+
 // thread-safe
 glm::mat4 AvatarData::getSensorToWorldMatrix() const {
     return _sensorToWorldMatrixCache.get();
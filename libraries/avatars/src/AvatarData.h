@@ -55,6 +55,7 @@ typedef unsigned long long quint64;
 #include <NumericalConstants.h>
 #include <Packed.h>
 #include <ThreadSafeValueCache.h>
+#include <TripleBuffer.h>
 #include <SharedUtil.h>
 
 #include "AABox.h"
@@ -66,6 +67,7 @@ using AvatarWeakPointer = std::weak_ptr<AvatarData>;
 using AvatarHash = QHash<QUuid, AvatarSharedPointer>;
 using AvatarEntityMap = QMap<QUuid, QByteArray>;
 using AvatarEntityIDs = QSet<QUuid>;
+using AvatarEntityVersions = QMap<QUuid, QByteArray>; // the hash of the data of each entity, see avatarEntityVersion
 
 using AvatarDataSequenceNumber = uint16_t;
 
@@ -136,6 +138,37 @@ enum KeyState {
 class QDataStream;
 
 class AttachmentData;
+
+// the state of an avatar as its data packets describe it, decoded apart from the avatar so that the
+// network thread doesn't touch the avatar the main thread simulates. The packets only carry the joints
+// that changed, so the state accumulates over the packets
+struct AvatarNetworkState {
+    bool isValid { false };
+    glm::vec3 localPosition;
+    glm::vec3 globalPosition;
+    glm::quat localOrientation;
+    float targetScale { 1.0f };
+    glm::vec3 lookAtPosition;
+    float audioLoudness { 0.0f };
+    glm::mat4 sensorToWorldMatrix;
+    KeyState keyState { NO_KEY_DOWN };
+    char handState { 0 };
+    bool isFaceTrackerConnected { false };
+    bool isEyeTrackerConnected { false };
+    QUuid parentID;
+    quint16 parentJointIndex { 0 };
+    float leftEyeBlink { 0.0f };
+    float rightEyeBlink { 0.0f };
+    float averageLoudness { 0.0f };
+    float browAudioLift { 0.0f };
+    QVector<float> blendshapeCoefficients;
+    QVector<JointData> jointData;
+    QVector<bool> coarseJointRotations;
+    quint32 jointRotationsVersion { 0 }; // bumped by the packets that carry joint rotations
+    quint32 jointTranslationsVersion { 0 }; // bumped by the packets that carry joint translations
+    glm::mat4 controllerLeftHandMatrix;
+    glm::mat4 controllerRightHandMatrix;
+};
 class Transform;
 using TransformPointer = std::shared_ptr<Transform>;
 
@@ -195,6 +228,9 @@ public:
     virtual QByteArray toByteArray(bool cullSmallChanges, bool sendAll);
     virtual void doneEncoding(bool cullSmallChanges);
 
+    /// the same packing as toByteArray, with every joint flagged as unchanged, for receivers that only need the transform
+    QByteArray toMinimalByteArray();
+
     /// \return true if an error should be logged
     bool shouldLogError(const quint64& now);
 
@@ -203,6 +239,15 @@ public:
     /// \return number of bytes parsed
     virtual int parseDataFromBuffer(const QByteArray& buffer);
 
+    /// decodes the data like parseDataFromBuffer, but only hands it over to be applied by applyReceivedNetworkState,
+    /// so the avatar is left to the thread that simulates it
+    /// \return number of bytes parsed
+    int receiveDataFromBuffer(const QByteArray& buffer);
+
+    /// applies the latest state handed over by receiveDataFromBuffer, if any
+    /// \return true if there was one
+    bool applyReceivedNetworkState();
+
     // Body Rotation (degrees)
     float getBodyYaw() const;
     void setBodyYaw(float bodyYaw);
@@ -305,6 +350,9 @@ public:
         QVector<AttachmentData> attachmentData;
         QString displayName;
         AvatarEntityMap avatarEntityData;
+
+        // sent by the avatar mixer to its listeners instead of the entity data, which they fetch when they don't have it
+        AvatarEntityVersions avatarEntityVersions;
     };
 
     static void parseAvatarIdentityPacket(const QByteArray& data, Identity& identityOut);
@@ -312,7 +360,10 @@ public:
     // returns true if identity has changed, false otherwise.
     bool processAvatarIdentity(const Identity& identity);
 
-    QByteArray identityByteArray();
+    // with the versions of the avatar entities rather than their data when withAvatarEntityVersions is true
+    QByteArray identityByteArray(bool withAvatarEntityVersions = false);
+
+    static QByteArray avatarEntityVersion(const QByteArray& entityData);
 
     const QUrl& getSkeletonModelURL() const { return _skeletonModelURL; }
     const QString& getDisplayName() const { return _displayName; }
@@ -359,6 +410,9 @@ public:
     void setAvatarEntityDataChanged(bool value) { _avatarEntityDataChanged = value; }
     AvatarEntityIDs getAndClearRecentlyDetachedIDs();
 
+    // thread safe, the data of those of the given entities the avatar has
+    AvatarEntityMap copyAvatarEntityData(const QVector<QUuid>& entityIDs) const;
+
     // thread safe
     Q_INVOKABLE glm::mat4 getSensorToWorldMatrix() const;
     Q_INVOKABLE glm::mat4 getControllerLeftHandMatrix() const;
@@ -391,6 +445,8 @@ protected:
 
     QVector<JointData> _jointData; ///< the state of the skeleton joints
     QVector<JointData> _lastSentJointData; ///< the state of the skeleton joints last time we transmitted
+    QVector<bool> _coarseJointRotations; ///< the joints whose rotations are sent with less precision, see updateCoarseJointRotations
+    QStringList _coarseJointRotationNames; ///< the joint names _coarseJointRotations was computed from
     mutable QReadWriteLock _jointDataLock;
 
     // key state
@@ -450,7 +506,24 @@ protected:
 
     int getFauxJointIndex(const QString& name) const;
 
+    void updateCoarseJointRotations();
+    bool isCoarseJointRotation(int index) const {
+        return index < _coarseJointRotations.size() && _coarseJointRotations[index];
+    }
+
+    /// decodes a data packet into _networkState
+    /// \return number of bytes parsed
+    int decodeNetworkState(const QByteArray& buffer);
+    virtual void applyNetworkState(const AvatarNetworkState& state);
+
+    AvatarNetworkState _networkState; ///< only touched by the thread that reads the packets
+    TripleBuffer<AvatarNetworkState> _receivedNetworkStates;
+    quint32 _appliedJointRotationsVersion { 0 };
+    quint32 _appliedJointTranslationsVersion { 0 };
+
 private:
+    QByteArray encodeByteArray(bool cullSmallChanges, bool sendAll, bool sendJoints);
+
     friend void avatarStateFromFrame(const QByteArray& frameData, AvatarData* _avatar);
     static QUrl _defaultFullAvatarModelUrl;
     // privatize the copy constructor and assignment operator so they cannot be called
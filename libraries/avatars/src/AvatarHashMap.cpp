@@ -10,14 +10,19 @@
 //
 
 #include <QtCore/QDataStream>
+#include <QtCore/QSet>
 
 #include <NodeList.h>
+#include <NumericalConstants.h>
 #include <udt/PacketHeaders.h>
 #include <SharedUtil.h>
 
 #include "AvatarLogging.h"
 #include "AvatarHashMap.h"
 
+const quint64 AVATAR_ENTITY_REQUEST_RETRY_USECS = 2 * USECS_PER_SECOND;
+const int MAX_AVATAR_ENTITY_DATA_VERSIONS = 1024;
+
 AvatarHashMap::AvatarHashMap() {
     auto nodeList = DependencyManager::get<NodeList>();
 
@@ -111,10 +116,15 @@ void AvatarHashMap::processAvatarDataPacket(QSharedPointer<ReceivedMessage> mess
         auto nodeList = DependencyManager::get<NodeList>();
 
         if (sessionUUID != _lastOwnerSessionUUID && !nodeList->isIgnoringNode(sessionUUID)) {
-            auto avatar = newOrExistingAvatar(sessionUUID, sendingNode);
-
-            // have the matching (or new) avatar parse the data from the packet
-            int bytesRead = avatar->parseDataFromBuffer(byteArray);
+            int bytesRead;
+            if (_decodeAvatarDataOnNetworkThread) {
+                bytesRead = receiveAvatarData(sessionUUID, byteArray, sendingNode);
+            } else {
+                auto avatar = newOrExistingAvatar(sessionUUID, sendingNode);
+
+                // have the matching (or new) avatar parse the data from the packet
+                bytesRead = avatar->parseDataFromBuffer(byteArray);
+            }
             message->seek(positionBeforeRead + bytesRead);
         } else {
             // create a dummy AvatarData class to throw this data on the ground
@@ -125,6 +135,37 @@ void AvatarHashMap::processAvatarDataPacket(QSharedPointer<ReceivedMessage> mess
     }
 }
 
+int AvatarHashMap::receiveAvatarData(const QUuid& sessionUUID, const QByteArray& data, const SharedNodePointer& sendingNode) {
+    QMutexLocker locker(&_newAvatarDataLock);
+    if (!_newAvatarDataCounts.contains(sessionUUID)) {
+        auto avatar = findAvatar(sessionUUID);
+        if (avatar) {
+            locker.unlock();
+            return avatar->receiveDataFromBuffer(data);
+        }
+    }
+    _newAvatarDataCounts[sessionUUID]++;
+    locker.unlock();
+
+    // the size of the data is only known once it is parsed, and the data is copied out of the message
+    AvatarData dummyData;
+    int bytesRead = dummyData.parseDataFromBuffer(data);
+    QMetaObject::invokeMethod(this, "receiveNewAvatarData", Q_ARG(QUuid, sessionUUID),
+                              Q_ARG(QByteArray, QByteArray(data.constData(), bytesRead)),
+                              Q_ARG(SharedNodePointer, sendingNode));
+    return bytesRead;
+}
+
+void AvatarHashMap::receiveNewAvatarData(QUuid sessionUUID, QByteArray data, SharedNodePointer sendingNode) {
+    auto avatar = newOrExistingAvatar(sessionUUID, sendingNode);
+    avatar->receiveDataFromBuffer(data);
+
+    QMutexLocker locker(&_newAvatarDataLock);
+    if (--_newAvatarDataCounts[sessionUUID] <= 0) {
+        _newAvatarDataCounts.remove(sessionUUID);
+    }
+}
+
 void AvatarHashMap::processAvatarIdentityPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode) {
     AvatarData::Identity identity;
     AvatarData::parseAvatarIdentityPacket(message->getMessage(), identity);
@@ -134,10 +175,126 @@ void AvatarHashMap::processAvatarIdentityPacket(QSharedPointer<ReceivedMessage>
     if (!nodeList->isIgnoringNode(identity.uuid)) {
         // mesh URL for a UUID, find avatar in our list
         auto avatar = newOrExistingAvatar(identity.uuid, sendingNode);
+        if (identity.avatarEntityData.isEmpty()) {
+            identity.avatarEntityData = resolveAvatarEntities(avatar, identity.avatarEntityVersions);
+        }
         avatar->processAvatarIdentity(identity);
     }
 }
 
+void AvatarHashMap::processAvatarEntityDataPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode) {
+    QUuid sessionUUID = QUuid::fromRfc4122(message->readWithoutCopy(NUM_BYTES_RFC4122_UUID));
+
+    AvatarEntityMap avatarEntityData;
+    QDataStream entityDataStream(message->readAll());
+    entityDataStream >> avatarEntityData;
+
+    for (auto it = avatarEntityData.constBegin(); it != avatarEntityData.constEnd(); ++it) {
+        _avatarEntityDataByVersion.insert(AvatarData::avatarEntityVersion(it.value()), it.value());
+    }
+
+    if (_avatarEntityDataByVersion.size() > MAX_AVATAR_ENTITY_DATA_VERSIONS) {
+        // drop the versions no avatar is wearing anymore
+        QSet<QByteArray> wornVersions;
+        for (auto& versions : _avatarEntityVersions) {
+            for (auto& version : versions) {
+                wornVersions.insert(version);
+            }
+        }
+        auto it = _avatarEntityDataByVersion.begin();
+        while (it != _avatarEntityDataByVersion.end()) {
+            if (wornVersions.contains(it.key())) {
+                ++it;
+            } else {
+                it = _avatarEntityDataByVersion.erase(it);
+            }
+        }
+    }
+
+    auto avatar = findAvatar(sessionUUID);
+    auto versions = _avatarEntityVersions.constFind(sessionUUID);
+    if (avatar && versions != _avatarEntityVersions.constEnd()) {
+        AvatarEntityVersions latestVersions = versions.value();
+        avatar->setAvatarEntityData(resolveAvatarEntities(avatar, latestVersions));
+    }
+}
+
+AvatarEntityMap AvatarHashMap::resolveAvatarEntities(const AvatarSharedPointer& avatar,
+                                                     const AvatarEntityVersions& versions) {
+    const QUuid& sessionUUID = avatar->getSessionUUID();
+    if (versions.isEmpty()) {
+        _avatarEntityVersions.remove(sessionUUID);
+        _avatarEntityRequestTimes.remove(sessionUUID);
+        return AvatarEntityMap();
+    }
+    _avatarEntityVersions.insert(sessionUUID, versions);
+
+    AvatarEntityMap currentEntityData = avatar->getAvatarEntityData();
+    AvatarEntityMap entityData;
+    bool isMissingData = false;
+    for (auto it = versions.constBegin(); it != versions.constEnd(); ++it) {
+        auto data = _avatarEntityDataByVersion.constFind(it.value());
+        if (data != _avatarEntityDataByVersion.constEnd()) {
+            entityData.insert(it.key(), data.value());
+        } else {
+            isMissingData = true;
+
+            // an entity that changed keeps its previous version until the new one arrives
+            auto current = currentEntityData.constFind(it.key());
+            if (current != currentEntityData.constEnd()) {
+                entityData.insert(it.key(), current.value());
+            }
+        }
+    }
+
+    if (!isMissingData) {
+        _avatarEntityRequestTimes.remove(sessionUUID);
+    } else {
+        if (!_avatarEntityRequestTimes.contains(sessionUUID)) {
+            _avatarEntityRequestTimes.insert(sessionUUID, 0);
+        }
+        if (shouldFetchAvatarEntities(*avatar)) {
+            requestMissingAvatarEntities(avatar);
+        }
+    }
+    return entityData;
+}
+
+void AvatarHashMap::requestMissingAvatarEntities(const AvatarSharedPointer& avatar) {
+    const QUuid& sessionUUID = avatar->getSessionUUID();
+    quint64 now = usecTimestampNow();
+    quint64& lastRequestTime = _avatarEntityRequestTimes[sessionUUID];
+    if (now - lastRequestTime < AVATAR_ENTITY_REQUEST_RETRY_USECS) {
+        return;
+    }
+
+    auto nodeList = DependencyManager::get<NodeList>();
+    SharedNodePointer avatarMixer = nodeList->soloNodeOfType(NodeType::AvatarMixer);
+    if (!avatarMixer || !avatarMixer->getActiveSocket()) {
+        return;
+    }
+
+    auto packetList = NLPacketList::create(PacketType::AvatarEntityDataRequest, QByteArray(), true, true);
+    packetList->write(sessionUUID.toRfc4122());
+    const AvatarEntityVersions& versions = _avatarEntityVersions[sessionUUID];
+    for (auto it = versions.constBegin(); it != versions.constEnd(); ++it) {
+        if (!_avatarEntityDataByVersion.contains(it.value())) {
+            packetList->write(it.key().toRfc4122());
+        }
+    }
+    nodeList->sendPacketList(std::move(packetList), *avatarMixer);
+    lastRequestTime = now;
+}
+
+void AvatarHashMap::fetchMissingAvatarEntities() {
+    for (auto& sessionUUID : _avatarEntityRequestTimes.keys()) {
+        auto avatar = findAvatar(sessionUUID);
+        if (avatar && shouldFetchAvatarEntities(*avatar)) {
+            requestMissingAvatarEntities(avatar);
+        }
+    }
+}
+
 void AvatarHashMap::processKillAvatar(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode) {
     // read the node id
     QUuid sessionUUID = QUuid::fromRfc4122(message->readWithoutCopy(NUM_BYTES_RFC4122_UUID));
@@ -155,6 +312,9 @@ void AvatarHashMap::removeAvatar(const QUuid& sessionUUID) {
 }
 
 void AvatarHashMap::handleRemovedAvatar(const AvatarSharedPointer& removedAvatar) {
+    _avatarEntityVersions.remove(removedAvatar->getSessionUUID());
+    _avatarEntityRequestTimes.remove(removedAvatar->getSessionUUID());
+
     qDebug() << "Removed avatar with UUID" << uuidStringWithoutCurlyBraces(removedAvatar->getSessionUUID())
         << "from AvatarHashMap";
     emit avatarRemovedEvent(removedAvatar->getSessionUUID());
@@ -13,6 +13,7 @@
 #define hifi_AvatarHashMap_h
 
 #include <QtCore/QHash>
+#include <QtCore/QMutex>
 #include <QtCore/QSharedPointer>
 #include <QtCore/QUuid>
 
@@ -56,8 +57,11 @@ private slots:
     
     void processAvatarDataPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode);
     void processAvatarIdentityPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode);
+    void processAvatarEntityDataPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode);
     void processKillAvatar(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode);
 
+    void receiveNewAvatarData(QUuid sessionUUID, QByteArray data, SharedNodePointer sendingNode);
+
 protected:
     AvatarHashMap();
 
@@ -69,13 +73,41 @@ protected:
     
     virtual void handleRemovedAvatar(const AvatarSharedPointer& removedAvatar);
 
+    // whether the data of the avatar entities of an avatar is fetched now, or left until it is asked for again
+    virtual bool shouldFetchAvatarEntities(const AvatarData& avatar) const { return true; }
+
+    // asks the avatar mixer again for the avatar entity data that is still missing, of the avatars it should be fetched for
+    void fetchMissingAvatarEntities();
+
     AvatarHash _avatarHash;
     // "Case-based safety": Most access to the _avatarHash is on the same thread. Write access is protected by a write-lock.
     // If you read from a different thread, you must read-lock the _hashLock. (Scripted write access is not supported).
     QReadWriteLock _hashLock;
 
+    // set by the hash maps that simulate their avatars on their own thread, and take the avatar data packets directly
+    // on the network thread: the packets are then only decoded, and the avatars apply the latest of them with
+    // AvatarData::applyReceivedNetworkState
+    bool _decodeAvatarDataOnNetworkThread { false };
+
 private:
+    int receiveAvatarData(const QUuid& sessionUUID, const QByteArray& data, const SharedNodePointer& sendingNode);
+
+    // the entity data of the given versions that is known, and for the rest what the avatar has until it arrives
+    AvatarEntityMap resolveAvatarEntities(const AvatarSharedPointer& avatar, const AvatarEntityVersions& versions);
+    void requestMissingAvatarEntities(const AvatarSharedPointer& avatar);
+
     QUuid _lastOwnerSessionUUID;
+
+    // the avatars that don't exist yet are created on the thread of the hash map, with their first data. Until that
+    // data is decoded, the data that follows it goes the same way, to be decoded in order
+    QMutex _newAvatarDataLock;
+    QHash<QUuid, int> _newAvatarDataCounts;
+
+    // the avatar mixer only sends the versions of the avatar entities in the identities, each avatar's latest ones are
+    // kept here, and the data of each version, which is shared by the avatars wearing the same entities, is fetched once
+    QHash<QUuid, AvatarEntityVersions> _avatarEntityVersions;
+    QHash<QByteArray, QByteArray> _avatarEntityDataByVersion;
+    QHash<QUuid, quint64> _avatarEntityRequestTimes; // of the avatars that miss some of their entity data
 };
 
 #endif // hifi_AvatarHashMap_h
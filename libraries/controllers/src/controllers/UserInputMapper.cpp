@@ -570,7 +570,10 @@ bool UserInputMapper::applyRoute(const Route::Pointer& route, bool force) {
                 qCDebug(controllers) << "Applying valid pose";
             }
         }
-        // no filters yet for pose
+        // Apply each of the filters.
+        for (const auto& filter : route->filters) {
+            value = filter->apply(value);
+        }
         destination->apply(value, source);
     } else {
         // Fetch the value, may have been overriden by previous loopback routes
@@ -22,6 +22,8 @@
 #include "filters/DeadZoneFilter.h"
 #include "filters/HysteresisFilter.h"
 #include "filters/InvertFilter.h"
+#include "filters/OneEuroFilter.h"
+#include "filters/PredictFilter.h"
 #include "filters/PulseFilter.h"
 #include "filters/ScaleFilter.h"
 
@@ -35,6 +37,8 @@ REGISTER_FILTER_CLASS_INSTANCE(ConstrainToPositiveIntegerFilter, "constrainToPos
 REGISTER_FILTER_CLASS_INSTANCE(DeadZoneFilter, "deadZone")
 REGISTER_FILTER_CLASS_INSTANCE(HysteresisFilter, "hysteresis")
 REGISTER_FILTER_CLASS_INSTANCE(InvertFilter, "invert")
+REGISTER_FILTER_CLASS_INSTANCE(OneEuroFilter, "oneEuro")
+REGISTER_FILTER_CLASS_INSTANCE(PredictFilter, "predict")
 REGISTER_FILTER_CLASS_INSTANCE(ScaleFilter, "scale")
 REGISTER_FILTER_CLASS_INSTANCE(PulseFilter, "pulse")
 
@@ -21,6 +21,8 @@
 
 #include <QtCore/QEasingCurve>
 
+#include "../Pose.h"
+
 class QJsonValue;
 
 namespace controller {
@@ -34,6 +36,8 @@ namespace controller {
         using Factory = hifi::SimpleFactory<Filter, QString>;
 
         virtual float apply(float value) const = 0;
+        // poses pass unchanged through the filters that only make sense for values
+        virtual Pose apply(Pose value) const { return value; }
         // Factory features
         virtual bool parseParameters(const QJsonValue& parameters) { return true; }
 
@@ -0,0 +1,100 @@
+//
+//  Created by Sam Gateau on 10/15/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "OneEuroFilter.h"
+
+#include <algorithm>
+
+#include <QtCore/QJsonObject>
+
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
+using namespace controller;
+
+// a sample arriving later than this after the previous one restarts the filter rather than blending from a stale value
+static const float MAX_DELTA_TIME = 0.25f;
+
+// the weight of a new sample for a low pass filter at cutoff Hz
+static float smoothingFactor(float cutoff, float deltaTime) {
+    float timeConstant = 1.0f / (TWO_PI * cutoff);
+    return 1.0f / (1.0f + timeConstant / deltaTime);
+}
+
+float OneEuroFilter::updateDeltaTime() const {
+    quint64 now = usecTimestampNow();
+    float deltaTime = (_previousTime == 0) ? 0.0f : (float)(now - _previousTime) / (float)USECS_PER_SECOND;
+    _previousTime = now;
+    return (deltaTime > MAX_DELTA_TIME) ? 0.0f : deltaTime;
+}
+
+float OneEuroFilter::apply(float value) const {
+    float deltaTime = updateDeltaTime();
+    if (deltaTime <= 0.0f) {
+        _value = value;
+        _derivative = 0.0f;
+        return value;
+    }
+
+    float derivative = (value - _value) / deltaTime;
+    _derivative += smoothingFactor(_derivativeCutoff, deltaTime) * (derivative - _derivative);
+
+    float cutoff = _minCutoff + _beta * fabsf(_derivative);
+    _value += smoothingFactor(cutoff, deltaTime) * (value - _value);
+    return _value;
+}
+
+Pose OneEuroFilter::apply(Pose value) const {
+    if (!value.isValid()) {
+        _previousTime = 0;
+        return value;
+    }
+
+    float deltaTime = updateDeltaTime();
+    if (deltaTime <= 0.0f) {
+        _translation = value.translation;
+        _translationSpeed = 0.0f;
+        _rotation = value.rotation;
+        _rotationSpeed = 0.0f;
+        return value;
+    }
+
+    float translationSpeed = glm::length(value.translation - _translation) / deltaTime;
+    _translationSpeed += smoothingFactor(_derivativeCutoff, deltaTime) * (translationSpeed - _translationSpeed);
+    float translationCutoff = _minCutoff + _beta * _translationSpeed;
+    _translation = glm::mix(_translation, value.translation, smoothingFactor(translationCutoff, deltaTime));
+
+    float cosHalfAngle = std::min(fabsf(glm::dot(value.rotation, _rotation)), 1.0f);
+    float rotationSpeed = 2.0f * acosf(cosHalfAngle) / deltaTime;
+    _rotationSpeed += smoothingFactor(_derivativeCutoff, deltaTime) * (rotationSpeed - _rotationSpeed);
+    float rotationCutoff = _minCutoff + _beta * _rotationSpeed;
+    _rotation = safeMix(_rotation, value.rotation, smoothingFactor(rotationCutoff, deltaTime));
+
+    value.translation = _translation;
+    value.rotation = _rotation;
+    return value;
+}
+
+bool OneEuroFilter::parseParameters(const QJsonValue& parameters) {
+    static const QString JSON_MIN_CUTOFF = QStringLiteral("minCutoff");
+    static const QString JSON_BETA = QStringLiteral("beta");
+    static const QString JSON_DERIVATIVE_CUTOFF = QStringLiteral("derivativeCutoff");
+    if (parameters.isObject()) {
+        auto obj = parameters.toObject();
+        if (obj.contains(JSON_MIN_CUTOFF)) {
+            _minCutoff = obj[JSON_MIN_CUTOFF].toDouble();
+        }
+        if (obj.contains(JSON_BETA)) {
+            _beta = obj[JSON_BETA].toDouble();
+        }
+        if (obj.contains(JSON_DERIVATIVE_CUTOFF)) {
+            _derivativeCutoff = obj[JSON_DERIVATIVE_CUTOFF].toDouble();
+        }
+    }
+    return _minCutoff > 0.0f && _derivativeCutoff > 0.0f;
+}
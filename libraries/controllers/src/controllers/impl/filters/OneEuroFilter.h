@@ -0,0 +1,52 @@
+//
+//  Created by Sam Gateau on 10/15/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+#ifndef hifi_Controllers_Filters_OneEuro_h
+#define hifi_Controllers_Filters_OneEuro_h
+
+#include "../Filter.h"
+
+namespace controller {
+
+// A 1 euro filter (Casiez et al. 2012): a low pass filter whose cutoff frequency rises with the speed of the input,
+// so it smooths the jitter of a still input without lagging behind a fast moving one.
+// For poses, the translation and the rotation are filtered separately, the velocities pass through.
+class OneEuroFilter : public Filter {
+    REGISTER_FILTER_CLASS(OneEuroFilter);
+public:
+    OneEuroFilter() {}
+    OneEuroFilter(float minCutoff, float beta) : _minCutoff(minCutoff), _beta(beta) {}
+
+    virtual float apply(float value) const override;
+    virtual Pose apply(Pose value) const override;
+
+    virtual bool parseParameters(const QJsonValue& parameters) override;
+
+private:
+    // the seconds since the previous sample, 0 for the first sample and after a gap
+    float updateDeltaTime() const;
+
+    float _minCutoff { 1.0f }; // Hz, the cutoff at rest
+    float _beta { 0.5f }; // Hz per unit per second the input moves
+    float _derivativeCutoff { 1.0f }; // Hz, the cutoff of the speed estimate
+
+    mutable quint64 _previousTime { 0 };
+
+    mutable float _value { 0.0f };
+    mutable float _derivative { 0.0f };
+
+    mutable vec3 _translation;
+    mutable float _translationSpeed { 0.0f };
+    mutable quat _rotation;
+    mutable float _rotationSpeed { 0.0f };
+};
+
+}
+
+#endif
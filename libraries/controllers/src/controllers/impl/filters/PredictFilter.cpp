@@ -0,0 +1,42 @@
+//
+//  Created by Sam Gateau on 10/15/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PredictFilter.h"
+
+#include <QtCore/QJsonObject>
+
+#include <NumericalConstants.h>
+
+using namespace controller;
+
+// longer predictions overshoot more than they save
+static const float MAX_HORIZON = 0.1f;
+
+Pose PredictFilter::apply(Pose value) const {
+    if (!value.isValid() || _horizon <= 0.0f) {
+        return value;
+    }
+
+    value.translation += value.velocity * _horizon;
+
+    float angularSpeed = glm::length(value.angularVelocity);
+    if (angularSpeed > EPSILON) {
+        glm::quat deltaRotation = glm::angleAxis(angularSpeed * _horizon, value.angularVelocity / angularSpeed);
+        value.rotation = glm::normalize(deltaRotation * value.rotation);
+    }
+    return value;
+}
+
+bool PredictFilter::parseParameters(const QJsonValue& parameters) {
+    static const QString JSON_HORIZON = QStringLiteral("horizon");
+    if (!parseSingleFloatParameter(parameters, JSON_HORIZON, _horizon)) {
+        return false;
+    }
+    _horizon = glm::clamp(_horizon, 0.0f, MAX_HORIZON);
+    return true;
+}
@@ -0,0 +1,36 @@
+//
+//  Created by Sam Gateau on 10/15/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+#ifndef hifi_Controllers_Filters_Predict_h
+#define hifi_Controllers_Filters_Predict_h
+
+#include "../Filter.h"
+
+namespace controller {
+
+// Extrapolates a pose by its velocities to where it will be horizon seconds from now, to hide the time between the
+// sampling of a controller and the display of the frame using it. Values pass unchanged.
+class PredictFilter : public Filter {
+    REGISTER_FILTER_CLASS(PredictFilter);
+public:
+    PredictFilter() {}
+    PredictFilter(float horizon) : _horizon(horizon) {}
+
+    virtual float apply(float value) const override { return value; }
+    virtual Pose apply(Pose value) const override;
+
+    virtual bool parseParameters(const QJsonValue& parameters) override;
+
+private:
+    float _horizon { 0.0f };
+};
+
+}
+
+#endif
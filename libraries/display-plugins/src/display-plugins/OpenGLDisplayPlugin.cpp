@@ -325,6 +325,15 @@ void OpenGLDisplayPlugin::deactivate() {
     presentThread->setNewDisplayPlugin(nullptr);
     internalDeactivate();
 
+    // The screenshots requested since the last frame won't be presented
+    std::vector<std::pair<float, ScreenshotHandler>> screenshotRequests;
+    withNonPresentThreadLock([&] {
+        std::swap(screenshotRequests, _screenshotRequests);
+    });
+    for (auto& request : screenshotRequests) {
+        request.second(QImage());
+    }
+
     _container->showDisplayPluginsTools(false);
     if (!_container->currentDisplayActions().isEmpty()) {
         auto menu = _container->getPrimaryMenu();
@@ -609,11 +618,15 @@ void OpenGLDisplayPlugin::present() {
         {
             withPresentThreadLock([&] {
                 _renderRate.increment();
-                if (_currentFrame.get() != _lastFrame) {
+                _isRepeatedFrame = (_currentFrame.get() == _lastFrame);
+                if (!_isRepeatedFrame) {
                     _newFrameRate.increment();
                 }
                 _lastFrame = _currentFrame.get();
             });
+        }
+
+        if (!_isRepeatedFrame || !reuseRepeatedFrames()) {
             // Execute the frame rendering commands
             PROFILE_RANGE_EX("execute", 0xff00ff00, (uint64_t)presentCount())
             _gpuContext->executeFrame(_currentFrame);
@@ -625,6 +638,11 @@ void OpenGLDisplayPlugin::present() {
             compositeLayers();
         }
 
+        {
+            PROFILE_RANGE_EX("downloadScreenshots", 0xff00ffff, (uint64_t)presentCount())
+            downloadScreenshots();
+        }
+
         // Take the composite framebuffer and send it to the output device
         {
             PROFILE_RANGE_EX("internalPresent", 0xff00ffff, (uint64_t)presentCount())
@@ -663,7 +681,7 @@ void OpenGLDisplayPlugin::withMainThreadContext(std::function<void()> f) const {
     _container->makeRenderingContextCurrent();
 }
 
-QImage OpenGLDisplayPlugin::getScreenshot(float aspectRatio) const {
+ivec4 OpenGLDisplayPlugin::getScreenshotRegion(float aspectRatio) const {
     auto size = _compositeFramebuffer->getSize();
     if (isHmd()) {
         size.x /= 2;
@@ -679,14 +697,36 @@ QImage OpenGLDisplayPlugin::getScreenshot(float aspectRatio) const {
         corner.x = round((size.x - bestSize.x) / 2.0f);
         corner.y = round((size.y - bestSize.y) / 2.0f);
     }
+    return ivec4(corner, bestSize);
+}
+
+QImage OpenGLDisplayPlugin::getScreenshot(float aspectRatio) const {
+    auto region = getScreenshotRegion(aspectRatio);
     auto glBackend = const_cast<OpenGLDisplayPlugin&>(*this).getGLBackend();
-    QImage screenshot(bestSize.x, bestSize.y, QImage::Format_ARGB32);
+    QImage screenshot(region.z, region.w, QImage::Format_ARGB32);
     withMainThreadContext([&] {
-        glBackend->downloadFramebuffer(_compositeFramebuffer, ivec4(corner, bestSize), screenshot);
+        glBackend->downloadFramebuffer(_compositeFramebuffer, region, screenshot);
     });
     return screenshot.mirrored(false, true);
 }
 
+void OpenGLDisplayPlugin::requestScreenshot(float aspectRatio, const ScreenshotHandler& handler) {
+    withNonPresentThreadLock([&] {
+        _screenshotRequests.push_back({ aspectRatio, handler });
+    });
+}
+
+void OpenGLDisplayPlugin::downloadScreenshots() {
+    std::vector<std::pair<float, ScreenshotHandler>> screenshotRequests;
+    withPresentThreadLock([&] {
+        std::swap(screenshotRequests, _screenshotRequests);
+    });
+    for (auto& request : screenshotRequests) {
+        // the backend calls the handler from recycle() once the GPU is done with the read
+        _gpuContext->downloadFramebufferAsync(_compositeFramebuffer, getScreenshotRegion(request.first), request.second);
+    }
+}
+
 glm::uvec2 OpenGLDisplayPlugin::getSurfacePixels() const {
     uvec2 result;
     auto window = _container->getPrimaryWidget();
@@ -55,6 +55,9 @@ public:
     }
 
     QImage getScreenshot(float aspectRatio = 0.0f) const override;
+    // Read back from the composite framebuffer of the next presented frame, the handler is called on the
+    // presentation thread a frame or two later
+    void requestScreenshot(float aspectRatio, const ScreenshotHandler& handler) override;
 
     float presentRate() const override;
 
@@ -101,11 +104,16 @@ protected:
 
     virtual void updateFrameData();
 
+    // When true, a frame presented again is not executed again, its framebuffer still holds the scene it rendered
+    virtual bool reuseRepeatedFrames() const { return false; }
+
     void withMainThreadContext(std::function<void()> f) const;
 
     void present();
     virtual void swapBuffers();
     ivec4 eyeViewport(Eye eye) const;
+    ivec4 getScreenshotRegion(float aspectRatio) const;
+    void downloadScreenshots();
 
     void render(std::function<void(gpu::Batch& batch)> f);
 
@@ -119,6 +127,7 @@ protected:
 
     gpu::FramePointer _currentFrame;
     gpu::Frame* _lastFrame { nullptr };
+    bool _isRepeatedFrame { false };
     gpu::FramebufferPointer _compositeFramebuffer;
     gpu::PipelinePointer _overlayPipeline;
     gpu::PipelinePointer _simplePipeline;
@@ -135,6 +144,7 @@ protected:
 
     std::map<uint16_t, CursorData> _cursorsData;
     bool _lockCurrentTexture { false };
+    std::vector<std::pair<float, ScreenshotHandler>> _screenshotRequests;
 
     void assertNotPresentThread() const;
     void assertIsPresentThread() const;
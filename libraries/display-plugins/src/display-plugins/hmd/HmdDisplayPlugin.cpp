@@ -34,6 +34,7 @@
 #include "../CompositorHelper.h"
 
 static const QString MONO_PREVIEW = "Mono Preview";
+static const QString REPROJECTION = "Reproject Repeated Frames";
 static const QString DISABLE_PREVIEW = "Disable Preview";
 static const QString FRAMERATE = DisplayPlugin::MENU_PATH() + ">Framerate";
 static const QString DEVELOPER_MENU_PATH = "Developer>" + DisplayPlugin::MENU_PATH();
@@ -55,6 +56,49 @@ static QString readFile(const QString& filename) {
     return result;
 }
 
+// Rotates one eye of the scene from the pose it was rendered with to the present pose
+static const char* HMD_REPROJECTION_FRAG = R"SCRIBE(
+
+uniform sampler2D colorMap;
+
+struct ReprojectionData {
+    mat4 projection;
+    mat4 inverseProjection;
+    mat4 reprojection;
+    vec4 uvOffsetScale;
+};
+
+layout(std140) uniform reprojectionBuffer {
+    ReprojectionData reprojectionData;
+};
+
+in vec2 varTexCoord0;
+
+out vec4 outFragColor;
+
+void main(void) {
+    // the ray through this pixel, in the eye space the scene was rendered in
+    vec4 eyeSpace = reprojectionData.inverseProjection * vec4(varTexCoord0 * 2.0 - 1.0, 0.0, 1.0);
+    eyeSpace /= eyeSpace.w;
+    vec3 ray = mat3(reprojectionData.reprojection) * normalize(eyeSpace.xyz);
+    if (ray.z >= 0.0) {
+        outFragColor = vec4(0.0, 0.0, 0.0, 1.0);
+        return;
+    }
+
+    // project it back on to the eye's image plane
+    ray *= eyeSpace.z / ray.z;
+    vec4 ndcSpace = reprojectionData.projection * vec4(ray, 1.0);
+    vec2 uv = (ndcSpace.xy / ndcSpace.w) * 0.5 + 0.5;
+    if (any(greaterThan(uv, vec2(1.0))) || any(lessThan(uv, vec2(0.0)))) {
+        outFragColor = vec4(0.0, 0.0, 0.0, 1.0);
+    } else {
+        outFragColor = texture(colorMap, reprojectionData.uvOffsetScale.xy + uv * reprojectionData.uvOffsetScale.zw);
+    }
+}
+
+)SCRIBE";
+
 glm::uvec2 HmdDisplayPlugin::getRecommendedUiSize() const {
     return CompositorHelper::VIRTUAL_SCREEN_SIZE;
 }
@@ -89,6 +133,13 @@ bool HmdDisplayPlugin::internalActivate() {
         _container->setBoolSetting("monoPreview", _monoPreview);
     }, true, _monoPreview);
 
+    _reprojectionEnabled = _container->getBoolSetting("hmdReprojection", true);
+    _container->addMenuItem(PluginType::DISPLAY_PLUGIN, MENU_PATH(), REPROJECTION,
+        [this](bool clicked) {
+        _reprojectionEnabled = clicked;
+        _container->setBoolSetting("hmdReprojection", _reprojectionEnabled);
+    }, true, _reprojectionEnabled);
+
 #if defined(Q_OS_MAC)
     _disablePreview = true;
 #else
@@ -130,6 +181,7 @@ void HmdDisplayPlugin::uncustomizeContext() {
         batch.clearColorFramebuffer(gpu::Framebuffer::BUFFER_COLOR0, vec4(0));
     });
     _overlayRenderer = OverlayRenderer();
+    _sceneReprojection = SceneReprojection();
     _previewTexture.reset();
 
     auto geometryCache = DependencyManager::get<GeometryCache>();
@@ -631,6 +683,70 @@ void HmdDisplayPlugin::compositePointer() {
     });
 }
 
+void HmdDisplayPlugin::SceneReprojection::build() {
+    auto vs = gpu::StandardShaderLib::getDrawUnitQuadTexcoordVS();
+    auto ps = gpu::Shader::createPixel(std::string(HMD_REPROJECTION_FRAG));
+    gpu::ShaderPointer program = gpu::Shader::createProgram(vs, ps);
+    gpu::Shader::makeProgram(*program);
+    uniformsLocation = program->getBuffers().findLocation("reprojectionBuffer");
+
+    gpu::StatePointer state = gpu::StatePointer(new gpu::State());
+    state->setDepthTest(gpu::State::DepthTest(false));
+    state->setScissorEnable(true);
+    pipeline = gpu::Pipeline::create(program, state);
+
+    uniformBuffers[0] = std::make_shared<gpu::Buffer>(sizeof(Uniforms), nullptr);
+    uniformBuffers[1] = std::make_shared<gpu::Buffer>(sizeof(Uniforms), nullptr);
+}
+
+void HmdDisplayPlugin::compositeScene() {
+    if (!_isRepeatedFrame || !reuseRepeatedFrames()) {
+        // the frame was just executed, with the camera corrected to the present pose
+        _sceneFramePose = _currentPresentFrameInfo.presentPose;
+        _currentPresentFrameInfo.presentReprojection = mat3();
+        Parent::compositeScene();
+        return;
+    }
+
+    // the frame is shown again, rotate the scene it left from the pose it was executed with to the newest one
+    mat3 reprojection = glm::inverse(mat3(_sceneFramePose)) * mat3(_currentPresentFrameInfo.presentPose);
+    _currentPresentFrameInfo.presentReprojection = reprojection;
+
+    static const float MIN_REPROJECTION_ANGLE_COS = 0.99999f;
+    if (glm::abs(glm::quat_cast(reprojection).w) > MIN_REPROJECTION_ANGLE_COS) {
+        Parent::compositeScene();
+        return;
+    }
+
+    if (!_sceneReprojection.pipeline) {
+        _sceneReprojection.build();
+    }
+
+    for_each_eye([&](Eye eye) {
+        auto& uniforms = _sceneReprojection.uniforms;
+        uniforms.projection = _eyeProjections[eye];
+        uniforms.inverseProjection = _eyeInverseProjections[eye];
+        uniforms.reprojection = mat4(reprojection);
+        uniforms.uvOffsetScale = vec4(eye == Eye::Left ? 0.0f : 0.5f, 0.0f, 0.5f, 1.0f);
+        _sceneReprojection.uniformBuffers[eye]->setSubData(0, uniforms);
+    });
+
+    render([&](gpu::Batch& batch) {
+        batch.enableStereo(false);
+        batch.setFramebuffer(_compositeFramebuffer);
+        batch.setStateScissorRect(ivec4(uvec2(), _compositeFramebuffer->getSize()));
+        batch.resetViewTransform();
+        batch.setProjectionTransform(mat4());
+        batch.setPipeline(_sceneReprojection.pipeline);
+        batch.setResourceTexture(0, _currentFrame->framebuffer->getRenderBuffer(0));
+        for_each_eye([&](Eye eye) {
+            batch.setViewportTransform(eyeViewport(eye));
+            batch.setUniformBuffer(_sceneReprojection.uniformsLocation, _sceneReprojection.uniformBuffers[eye]);
+            batch.draw(gpu::TRIANGLE_STRIP, 4);
+        });
+    });
+}
+
 void HmdDisplayPlugin::compositeOverlay() {
     if (!_currentFrame || !_currentFrame->overlay) {
         return;
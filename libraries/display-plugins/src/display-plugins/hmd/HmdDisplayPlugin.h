@@ -55,6 +55,7 @@ protected:
     bool beginFrameRender(uint32_t frameIndex) override;
     bool internalActivate() override;
     void internalDeactivate() override;
+    void compositeScene() override;
     void compositeOverlay() override;
     void compositePointer() override;
     void internalPresent() override;
@@ -62,6 +63,7 @@ protected:
     void uncustomizeContext() override;
     void updateFrameData() override;
     void compositeExtra() override;
+    bool reuseRepeatedFrames() const override { return _reprojectionEnabled; }
 
     struct HandLaserInfo {
         HandLaserMode mode { HandLaserMode::None };
@@ -117,6 +119,25 @@ private:
     ivec4 getViewportForSourceSize(const uvec2& size) const;
     float getLeftCenterPixel() const;
 
+    // A repeated frame is rotated to the newest present pose instead of executed again
+    bool _reprojectionEnabled { true };
+    mat4 _sceneFramePose; // the present pose the current frame was last executed with
+
+    struct SceneReprojection {
+        gpu::PipelinePointer pipeline;
+        int32_t uniformsLocation { -1 };
+        std::array<gpu::BufferPointer, 2> uniformBuffers;
+
+        struct Uniforms {
+            mat4 projection;
+            mat4 inverseProjection;
+            mat4 reprojection;
+            vec4 uvOffsetScale;
+        } uniforms;
+
+        void build();
+    } _sceneReprojection;
+
     bool _disablePreviewItemAdded { false };
     bool _monoPreview { true };
     bool _clearPreviewFlag { false };
@@ -21,6 +21,7 @@
 const char* HTTPConnection::StatusCode200 = "200 OK";
 const char* HTTPConnection::StatusCode301 = "301 Moved Permanently";
 const char* HTTPConnection::StatusCode302 = "302 Found";
+const char* HTTPConnection::StatusCode304 = "304 Not Modified";
 const char* HTTPConnection::StatusCode400 = "400 Bad Request";
 const char* HTTPConnection::StatusCode401 = "401 Unauthorized";
 const char* HTTPConnection::StatusCode403 = "403 Forbidden";
@@ -42,6 +43,12 @@ HTTPConnection::HTTPConnection (QTcpSocket* socket, HTTPManager* parentManager)
     connect(socket, SIGNAL(readyRead()), SLOT(readRequest()));
     connect(socket, SIGNAL(error(QAbstractSocket::SocketError)), SLOT(deleteLater()));
     connect(socket, SIGNAL(disconnected()), SLOT(deleteLater()));
+
+    const int KEEP_ALIVE_IDLE_TIMEOUT_MSECS = 30 * 1000;
+    _idleTimer = new QTimer(this);
+    _idleTimer->setSingleShot(true);
+    _idleTimer->setInterval(KEEP_ALIVE_IDLE_TIMEOUT_MSECS);
+    connect(_idleTimer, &QTimer::timeout, _socket, &QTcpSocket::disconnectFromHost);
 }
 
 HTTPConnection::~HTTPConnection() {
@@ -108,7 +115,42 @@ QList<FormData> HTTPConnection::parseFormData() const {
     return data;
 }
 
+bool HTTPConnection::shouldKeepAlive() const {
+    QByteArray connection = _requestHeaders.value("Connection").toLower();
+    if (_isHTTP11) {
+        return !connection.contains("close");
+    } else {
+        return connection.contains("keep-alive");
+    }
+}
+
+void HTTPConnection::resetForNextRequest() {
+    _socket->disconnect(SIGNAL(readyRead()), this);
+
+    _requestUrl.clear();
+    _requestHeaders.clear();
+    _lastRequestHeader.clear();
+    _requestContent.clear();
+    _isHTTP11 = false;
+
+    connect(_socket, SIGNAL(readyRead()), SLOT(readRequest()));
+    _idleTimer->start();
+
+    // a pipelined request may already be waiting, read it once this response has returned to the caller
+    if (_socket->canReadLine()) {
+        QMetaObject::invokeMethod(this, "readRequest", Qt::QueuedConnection);
+    }
+}
+
 void HTTPConnection::respond(const char* code, const QByteArray& content, const char* contentType, const Headers& headers) {
+    if (!_isAwaitingResponse) {
+        qCDebug(embeddedwebserver) << "Ignoring a second response to the request for" << _requestUrl << "from" << _address;
+        return;
+    }
+    _isAwaitingResponse = false;
+    // after a malformed request there's no telling where the next one would start
+    bool keepAlive = shouldKeepAlive() && qstrncmp(code, "400", 3) != 0;
+
     _socket->write("HTTP/1.1 ");
     _socket->write(code);
     _socket->write("\r\n");
@@ -130,13 +172,21 @@ void HTTPConnection::respond(const char* code, const QByteArray& content, const
         _socket->write("Content-Type: ");
         _socket->write(contentType);
         _socket->write("\r\n");
+    } else if (keepAlive) {
+        // the client can only tell where the response ends from its length when the connection stays open
+        _socket->write("Content-Length: 0\r\n");
     }
-    _socket->write("Connection: close\r\n\r\n");
+    _socket->write(keepAlive ? "Connection: keep-alive\r\n\r\n" : "Connection: close\r\n\r\n");
 
     if (csize > 0) {
         _socket->write(content);
     }
 
+    if (keepAlive) {
+        resetForNextRequest();
+        return;
+    }
+
     // make sure we receive no further read notifications
     _socket->disconnect(SIGNAL(readyRead()), this);
 
@@ -144,9 +194,11 @@ void HTTPConnection::respond(const char* code, const QByteArray& content, const
 }
 
 void HTTPConnection::readRequest() {
-    if (!_socket->canReadLine()) {
+    if (_isAwaitingResponse || !_socket->canReadLine()) {
         return;
     }
+    _idleTimer->stop();
+    _isAwaitingResponse = true;
     // parse out the method and resource
     QByteArray line = _socket->readLine().trimmed();
     if (line.startsWith("HEAD")) {
@@ -171,6 +223,7 @@ void HTTPConnection::readRequest() {
     }
     int idx = line.indexOf(' ') + 1;
     _requestUrl.setUrl(line.mid(idx, line.lastIndexOf(' ') - idx));
+    _isHTTP11 = line.endsWith("HTTP/1.1");
 
     // switch to reading the header
     _socket->disconnect(this, SLOT(readRequest()));
@@ -24,6 +24,7 @@
 #include <QtNetwork/QNetworkAccessManager>
 #include <QObject>
 #include <QPair>
+#include <QTimer>
 #include <QUrl>
 
 class QTcpSocket;
@@ -45,6 +46,7 @@ public:
     static const char* StatusCode200;
     static const char* StatusCode301;
     static const char* StatusCode302;
+    static const char* StatusCode304;
     static const char* StatusCode400;
     static const char* StatusCode401;
     static const char* StatusCode403;
@@ -79,7 +81,7 @@ public:
     /// Parses the request content as form data, returning a list of header/content pairs.
     QList<FormData> parseFormData () const;
 
-    /// Sends a response and closes the connection.
+    /// Sends a response, and either closes the connection or, if the client keeps it alive, waits for its next request.
     void respond (const char* code, const QByteArray& content = QByteArray(),
         const char* contentType = DefaultContentType,
         const Headers& headers = Headers());
@@ -123,6 +125,19 @@ protected:
 
     /// The content of the request.
     QByteArray _requestContent;
+
+    /// Whether the request was made as HTTP/1.1, which keeps the connection alive unless asked otherwise.
+    bool _isHTTP11 { false };
+
+    /// Whether a request was read that hasn't been responded to yet.
+    bool _isAwaitingResponse { false };
+
+    /// Closes a kept alive connection that stays idle.
+    QTimer* _idleTimer { nullptr };
+
+private:
+    bool shouldKeepAlive () const;
+    void resetForNextRequest ();
 };
 
 #endif // hifi_HTTPConnection_h
@@ -10,6 +10,7 @@
 //
 
 #include <QtCore/QCoreApplication>
+#include <QtCore/QCryptographicHash>
 #include <QtCore/QDebug>
 #include <QtCore/QFile>
 #include <QtCore/QFileInfo>
@@ -80,6 +81,7 @@ bool HTTPManager::handleHTTPRequest(HTTPConnection* connection, const QUrl& url,
             redirectHeader.insert(QByteArray("Location"), redirectLocation.toUtf8());
             
             connection->respond(HTTPConnection::StatusCode301, "", HTTPConnection::DefaultContentType, redirectHeader);
+            return true;
         }
         
         // if the last thing is a trailing slash then we want to look for index file
@@ -95,65 +97,19 @@ bool HTTPManager::handleHTTPRequest(HTTPConnection* connection, const QUrl& url,
         }
         
         if (!filePath.isEmpty()) {
-            // file exists, serve it
-            static QMimeDatabase mimeDatabase;
-            
-            QFile localFile(filePath);
-            localFile.open(QIODevice::ReadOnly);
-            QByteArray localFileData = localFile.readAll();
-            
-            QFileInfo localFileInfo(filePath);
-            
-            if (localFileInfo.completeSuffix() == "shtml") {
-                // this is a file that may have some SSI statements
-                // the only thing we support is the include directive, but check the contents for that
-                
-                // setup our static QRegExp that will catch <!--#include virtual ... --> and <!--#include file .. --> directives
-                const QString includeRegExpString = "<!--\\s*#include\\s+(virtual|file)\\s?=\\s?\"(\\S+)\"\\s*-->";
-                QRegExp includeRegExp(includeRegExpString);
-                
-                int matchPosition = 0;
-                
-                QString localFileString(localFileData);
-                
-                while ((matchPosition = includeRegExp.indexIn(localFileString, matchPosition)) != -1) {
-                    // check if this is a file or vitual include
-                    bool isFileInclude = includeRegExp.cap(1) == "file";
-                    
-                    // setup the correct file path for the included file
-                    QString includeFilePath = isFileInclude
-                    ? localFileInfo.canonicalPath() + "/" + includeRegExp.cap(2)
-                    : _documentRoot + includeRegExp.cap(2);
-                    
-                    QString replacementString;
-                    
-                    if (QFileInfo(includeFilePath).isFile()) {
-                        
-                        QFile includedFile(includeFilePath);
-                        includedFile.open(QIODevice::ReadOnly);
-                        
-                        replacementString = QString(includedFile.readAll());
-                    } else {
-                        qCDebug(embeddedwebserver) << "SSI include directive referenced a missing file:" << includeFilePath;
-                    }
-                    
-                    // replace the match with the contents of the file, or an empty string if the file was not found
-                    localFileString.replace(matchPosition, includeRegExp.matchedLength(), replacementString);
-                    
-                    // push the match position forward so we can check the next match
-                    matchPosition += includeRegExp.matchedLength();
-                }
-                
-                localFileData = localFileString.toLocal8Bit();
-            }
+            // file exists, serve it, or tell the client its copy is still good
+            const StaticFile& staticFile = staticFileForPath(filePath);
 
-            // if this is an shtml file just make the MIME type match HTML so browsers aren't confused
-            // otherwise use the mimeDatabase to look it up
-            auto mimeType = localFileInfo.suffix() == "shtml"
-                ? QString { "text/html" }
-                : mimeDatabase.mimeTypeForFile(filePath).name();
+            Headers headers;
+            headers.insert("ETag", staticFile.etag);
+            headers.insert("Cache-Control", "no-cache");
 
-            connection->respond(HTTPConnection::StatusCode200, localFileData, qPrintable(mimeType));
+            if (connection->requestHeaders().value("If-None-Match") == staticFile.etag) {
+                connection->respond(HTTPConnection::StatusCode304, QByteArray(), HTTPConnection::DefaultContentType, headers);
+            } else {
+                connection->respond(HTTPConnection::StatusCode200, staticFile.content, staticFile.mimeType.constData(),
+                                    headers);
+            }
             
             return true;
         }
@@ -165,6 +121,92 @@ bool HTTPManager::handleHTTPRequest(HTTPConnection* connection, const QUrl& url,
     return true;
 }
 
+const HTTPManager::StaticFile& HTTPManager::staticFileForPath(const QString& filePath) {
+    auto it = _staticFiles.find(filePath);
+    if (it != _staticFiles.end()) {
+        bool isFresh = true;
+        for (auto& source : it->sources) {
+            if (QFileInfo(source.first).lastModified() != source.second) {
+                isFresh = false;
+                break;
+            }
+        }
+        if (isFresh) {
+            return it.value();
+        }
+    } else {
+        it = _staticFiles.insert(filePath, StaticFile());
+    }
+
+    StaticFile& staticFile = it.value();
+    staticFile.sources.clear();
+
+    static QMimeDatabase mimeDatabase;
+    
+    QFile localFile(filePath);
+    localFile.open(QIODevice::ReadOnly);
+    QByteArray localFileData = localFile.readAll();
+    
+    QFileInfo localFileInfo(filePath);
+    staticFile.sources.append({ filePath, localFileInfo.lastModified() });
+    
+    if (localFileInfo.completeSuffix() == "shtml") {
+        // this is a file that may have some SSI statements
+        // the only thing we support is the include directive, but check the contents for that
+        
+        // setup our static QRegExp that will catch <!--#include virtual ... --> and <!--#include file .. --> directives
+        const QString includeRegExpString = "<!--\\s*#include\\s+(virtual|file)\\s?=\\s?\"(\\S+)\"\\s*-->";
+        QRegExp includeRegExp(includeRegExpString);
+        
+        int matchPosition = 0;
+        
+        QString localFileString(localFileData);
+        
+        while ((matchPosition = includeRegExp.indexIn(localFileString, matchPosition)) != -1) {
+            // check if this is a file or vitual include
+            bool isFileInclude = includeRegExp.cap(1) == "file";
+            
+            // setup the correct file path for the included file
+            QString includeFilePath = isFileInclude
+            ? localFileInfo.canonicalPath() + "/" + includeRegExp.cap(2)
+            : _documentRoot + includeRegExp.cap(2);
+            
+            QString replacementString;
+            
+            QFileInfo includeFileInfo(includeFilePath);
+            staticFile.sources.append({ includeFilePath, includeFileInfo.lastModified() });
+            if (includeFileInfo.isFile()) {
+                
+                QFile includedFile(includeFilePath);
+                includedFile.open(QIODevice::ReadOnly);
+                
+                replacementString = QString(includedFile.readAll());
+            } else {
+                qCDebug(embeddedwebserver) << "SSI include directive referenced a missing file:" << includeFilePath;
+            }
+            
+            // replace the match with the contents of the file, or an empty string if the file was not found
+            localFileString.replace(matchPosition, includeRegExp.matchedLength(), replacementString);
+            
+            // push the match position forward so we can check the next match
+            matchPosition += includeRegExp.matchedLength();
+        }
+        
+        localFileData = localFileString.toLocal8Bit();
+    }
+
+    // if this is an shtml file just make the MIME type match HTML so browsers aren't confused
+    // otherwise use the mimeDatabase to look it up
+    auto mimeType = localFileInfo.suffix() == "shtml"
+        ? QString { "text/html" }
+        : mimeDatabase.mimeTypeForFile(filePath).name();
+
+    staticFile.content = localFileData;
+    staticFile.mimeType = mimeType.toUtf8();
+    staticFile.etag = '"' + QCryptographicHash::hash(localFileData, QCryptographicHash::Md5).toHex() + '"';
+    return staticFile;
+}
+
 bool HTTPManager::requestHandledByRequestHandler(HTTPConnection* connection, const QUrl& url) {
     return _requestHandler && _requestHandler->handleHTTPRequest(connection, url);
 }
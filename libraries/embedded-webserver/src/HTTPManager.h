@@ -17,6 +17,9 @@
 #define hifi_HTTPManager_h
 
 #include <QtNetwork/QTcpServer>
+#include <QtCore/QDateTime>
+#include <QtCore/QHash>
+#include <QtCore/QPair>
 #include <QtCore/QTimer>
 
 class HTTPConnection;
@@ -43,6 +46,17 @@ private slots:
     
 private:
     bool bindSocket();
+
+    /// A file from the document root, with its includes expanded, kept until it or one of its includes changes.
+    struct StaticFile {
+        QByteArray content;
+        QByteArray mimeType;
+        QByteArray etag;
+        /// the paths of the file and its includes, with the modification times the content was read at
+        QList<QPair<QString, QDateTime>> sources;
+    };
+    const StaticFile& staticFileForPath(const QString& filePath);
+    QHash<QString, StaticFile> _staticFiles;
     
 protected:
     /// Accepts all pending connections
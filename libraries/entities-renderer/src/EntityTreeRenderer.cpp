@@ -20,6 +20,7 @@
 #include <AbstractViewStateInterface.h>
 #include <Model.h>
 #include <NetworkAccessManager.h>
+#include <NumericalConstants.h>
 #include <PerfStat.h>
 #include <SceneScriptingInterface.h>
 #include <ScriptEngine.h>
@@ -43,11 +44,13 @@
 #include "AddressManager.h"
 #include <Rig.h>
 
+// the time the main thread spends reading the staged entity data into the tree each frame
+static const quint64 STAGED_CHANGES_BUDGET_USECS = 2 * USECS_PER_MSEC;
+
 EntityTreeRenderer::EntityTreeRenderer(bool wantScripts, AbstractViewStateInterface* viewState,
                                             AbstractScriptingServicesInterface* scriptingServices) :
     OctreeRenderer(),
     _wantScripts(wantScripts),
-    _entitiesScriptEngine(NULL),
     _lastPointerEventValid(false),
     _viewState(viewState),
     _scriptingServices(scriptingServices),
@@ -76,8 +79,8 @@ EntityTreeRenderer::EntityTreeRenderer(bool wantScripts, AbstractViewStateInterf
 }
 
 EntityTreeRenderer::~EntityTreeRenderer() {
-    // NOTE: We don't need to delete _entitiesScriptEngine because
-    //       it is registered with ScriptEngines, which will call deleteLater for us.
+    // NOTE: We don't need to delete _entitiesScriptEngines because
+    //       they are registered with ScriptEngines, which will call deleteLater for us.
 }
 
 int EntityTreeRenderer::_entitiesScriptEngineCount = 0;
@@ -99,31 +102,94 @@ void entitiesScriptEngineDeleter(ScriptEngine* engine) {
     QThreadPool::globalInstance()->start(new WaitRunnable(engine));
 }
 
-void EntityTreeRenderer::resetEntitiesScriptEngine() {
-    // Keep a ref to oldEngine until newEngine is ready so EntityScriptingInterface has something to use
-    auto oldEngine = _entitiesScriptEngine;
+void EntityTreeRenderer::resetEntitiesScriptEngines() {
+    int engineCount = glm::clamp(_entitiesScriptEngineCountSetting.get(), 1, MAX_ENTITY_SCRIPT_ENGINE_COUNT);
+    ++_entitiesScriptEngineCount;
+
+    QVector<QSharedPointer<ScriptEngine>> newEngines;
+    for (int i = 0; i < engineCount; i++) {
+        auto newEngine = new ScriptEngine(NO_SCRIPT, QString("Entities %1.%2").arg(_entitiesScriptEngineCount).arg(i + 1));
+        newEngines.push_back(QSharedPointer<ScriptEngine>(newEngine, entitiesScriptEngineDeleter));
+
+        _scriptingServices->registerScriptEngineWithApplicationServices(newEngine);
+        newEngine->runInThread();
+    }
 
-    auto newEngine = new ScriptEngine(NO_SCRIPT, QString("Entities %1").arg(++_entitiesScriptEngineCount));
-    _entitiesScriptEngine = QSharedPointer<ScriptEngine>(newEngine, entitiesScriptEngineDeleter);
+    {
+        std::lock_guard<std::mutex> lock(_entitiesScriptEnginesLock);
+        _entityScriptEngineAssignments.clear();
+    }
+    _entitiesScriptEngines = newEngines;
+
+    // EntityScriptingInterface calls into the entity scripts through us, so that they reach the engine of the entity
+    DependencyManager::get<EntityScriptingInterface>()->setEntitiesScriptEngine(this);
+}
 
-    _scriptingServices->registerScriptEngineWithApplicationServices(_entitiesScriptEngine.data());
-    _entitiesScriptEngine->runInThread();
-    DependencyManager::get<EntityScriptingInterface>()->setEntitiesScriptEngine(_entitiesScriptEngine.data());
+QSharedPointer<ScriptEngine> EntityTreeRenderer::getEntitiesScriptEngine(const EntityItemID& entityID) const {
+    std::lock_guard<std::mutex> lock(_entitiesScriptEnginesLock);
+    return _entityScriptEngineAssignments.value(entityID);
+}
+
+QSharedPointer<ScriptEngine> EntityTreeRenderer::assignEntitiesScriptEngine(const EntityItemID& entityID,
+                                                                             const QString& scriptUrl) {
+    if (_entitiesScriptEngines.isEmpty()) {
+        return QSharedPointer<ScriptEngine>();
+    }
+
+    // the same script always lands in the same engine, so its entities share the cached script and any libraries
+    auto engine = _entitiesScriptEngines[qHash(scriptUrl) % (uint)_entitiesScriptEngines.size()];
+
+    std::lock_guard<std::mutex> lock(_entitiesScriptEnginesLock);
+    _entityScriptEngineAssignments[entityID] = engine;
+    return engine;
+}
+
+QSharedPointer<ScriptEngine> EntityTreeRenderer::unassignEntitiesScriptEngine(const EntityItemID& entityID) {
+    std::lock_guard<std::mutex> lock(_entitiesScriptEnginesLock);
+    return _entityScriptEngineAssignments.take(entityID);
+}
+
+void EntityTreeRenderer::callEntityScriptMethod(const EntityItemID& entityID, const QString& methodName,
+                                                const QStringList& params) {
+    if (auto engine = getEntitiesScriptEngine(entityID)) {
+        engine->callEntityScriptMethod(entityID, methodName, params);
+    }
+}
+
+QHash<QUrl, EntityScriptTime> EntityTreeRenderer::getEntityScriptTimes() const {
+    QHash<QUrl, EntityScriptTime> scriptTimes;
+    foreach(auto engine, _entitiesScriptEngines) {
+        auto engineTimes = engine->getEntityScriptTimes();
+        for (auto it = engineTimes.constBegin(); it != engineTimes.constEnd(); ++it) {
+            EntityScriptTime& time = scriptTimes[it.key()];
+            time.totalUsecs += it.value().totalUsecs;
+            time.maxUsecs = std::max(time.maxUsecs, it.value().maxUsecs);
+            time.calls += it.value().calls;
+            time.overBudgetCalls += it.value().overBudgetCalls;
+        }
+    }
+    return scriptTimes;
 }
 
 void EntityTreeRenderer::clear() {
     leaveAllEntities();
 
-    // unload and stop the engine
-    if (_entitiesScriptEngine) {
+    // unload and stop the engines
+    foreach(auto engine, _entitiesScriptEngines) {
         // do this here (instead of in deleter) to avoid marshalling unload signals back to this thread
-        _entitiesScriptEngine->unloadAllEntityScripts();
-        _entitiesScriptEngine->stop();
+        engine->unloadAllEntityScripts();
+        engine->stop();
     }
 
-    // reset the engine
+    // reset the engines
     if (_wantScripts && !_shuttingDown) {
-        resetEntitiesScriptEngine();
+        resetEntitiesScriptEngines();
+    } else {
+        {
+            std::lock_guard<std::mutex> lock(_entitiesScriptEnginesLock);
+            _entityScriptEngineAssignments.clear();
+        }
+        _entitiesScriptEngines.clear();
     }
 
     // remove all entities from the scene
@@ -139,6 +205,8 @@ void EntityTreeRenderer::clear() {
     }
     _entitiesInScene.clear();
 
+    _enterLeaveIndex.clear();
+
     // reset the zone to the default (while we load the next scene)
     _layeredZones.clear();
     applyZoneAndHasSkybox(nullptr);
@@ -147,10 +215,16 @@ void EntityTreeRenderer::clear() {
 }
 
 void EntityTreeRenderer::reloadEntityScripts() {
-    _entitiesScriptEngine->unloadAllEntityScripts();
+    foreach(auto engine, _entitiesScriptEngines) {
+        engine->unloadAllEntityScripts();
+    }
     foreach(auto entity, _entitiesInScene) {
         if (!entity->getScript().isEmpty()) {
-            ScriptEngine::loadEntityScript(_entitiesScriptEngine, entity->getEntityItemID(), entity->getScript(), true);
+            auto engine = assignEntitiesScriptEngine(entity->getEntityItemID(),
+                                                     ResourceManager::normalizeURL(entity->getScript()));
+            if (engine) {
+                ScriptEngine::loadEntityScript(engine, entity->getEntityItemID(), entity->getScript(), true);
+            }
         }
     }
 }
@@ -161,7 +235,7 @@ void EntityTreeRenderer::init() {
     entityTree->setFBXService(this);
 
     if (_wantScripts) {
-        resetEntitiesScriptEngine();
+        resetEntitiesScriptEngines();
     }
 
     forceRecheckEntities(); // setup our state to force checking our inside/outsideness of entities
@@ -170,15 +244,24 @@ void EntityTreeRenderer::init() {
     connect(entityTree.get(), &EntityTree::addingEntity, this, &EntityTreeRenderer::addingEntity, Qt::QueuedConnection);
     connect(entityTree.get(), &EntityTree::entityScriptChanging,
             this, &EntityTreeRenderer::entitySciptChanging, Qt::QueuedConnection);
+
+    // keep the enter/leave index up to date with the moves and the edits of the entities it holds
+    entityTree->setChangedEntitiesFilter([](const EntityItem& entity) {
+        return EnterLeaveIndex::isIndexed(entity);
+    });
 }
 
 void EntityTreeRenderer::shutdown() {
-    if (_entitiesScriptEngine) {
-        _entitiesScriptEngine->disconnectNonEssentialSignals(); // disconnect all slots/signals from the script engine, except essential
+    foreach(auto engine, _entitiesScriptEngines) {
+        engine->disconnectNonEssentialSignals(); // disconnect all slots/signals from the script engine, except essential
     }
     _shuttingDown = true;
 
     clear(); // always clear() on shutdown
+
+    if (_wantScripts) {
+        DependencyManager::get<EntityScriptingInterface>()->setEntitiesScriptEngine(nullptr);
+    }
 }
 
 void EntityTreeRenderer::setTree(OctreePointer newTree) {
@@ -189,6 +272,8 @@ void EntityTreeRenderer::setTree(OctreePointer newTree) {
 void EntityTreeRenderer::update() {
     PerformanceTimer perfTimer("ETRupdate");
     if (_tree && !_shuttingDown) {
+        applyStagedChanges(STAGED_CHANGES_BUDGET_USECS);
+
         EntityTreePointer tree = std::static_pointer_cast<EntityTree>(_tree);
         tree->update();
 
@@ -208,7 +293,9 @@ void EntityTreeRenderer::update() {
         // and we want to simulate this message here as well as in mouse move
         if (_lastPointerEventValid && !_currentClickingOnEntityID.isInvalidID()) {
             emit holdingClickOnEntity(_currentClickingOnEntityID, _lastPointerEvent);
-            _entitiesScriptEngine->callEntityScriptMethod(_currentClickingOnEntityID, "holdingClickOnEntity", _lastPointerEvent);
+            if (auto engine = getEntitiesScriptEngine(_currentClickingOnEntityID)) {
+                engine->callEntityScriptMethod(_currentClickingOnEntityID, "holdingClickOnEntity", _lastPointerEvent);
+            }
         }
 
     }
@@ -217,15 +304,13 @@ void EntityTreeRenderer::update() {
 
 bool EntityTreeRenderer::findBestZoneAndMaybeContainingEntities(QVector<EntityItemID>* entitiesContainingAvatar) {
     bool didUpdate = false;
-    float radius = 0.01f; // for now, assume 0.01 meter radius, because we actually check the point inside later
     QVector<EntityItemPointer> foundEntities;
 
-    // find the entities near us
-    // don't let someone else change our tree while we search
+    // find the zones and scripted entities of our cell
+    // don't let someone else change our tree while we test them
     _tree->withReadLock([&] {
 
-        // FIXME - if EntityTree had a findEntitiesContainingPoint() this could theoretically be a little faster
-        std::static_pointer_cast<EntityTree>(_tree)->findEntities(_avatarPosition, radius, foundEntities);
+        _enterLeaveIndex.findEntities(_avatarPosition, foundEntities);
 
         LayeredZones oldLayeredZones(std::move(_layeredZones));
         _layeredZones.clear();
@@ -273,12 +358,33 @@ bool EntityTreeRenderer::findBestZoneAndMaybeContainingEntities(QVector<EntityIt
     return didUpdate;
 }
 
+void EntityTreeRenderer::updateEnterLeaveIndex() {
+    EntityTreePointer tree = std::static_pointer_cast<EntityTree>(_tree);
+    QSet<EntityItemID> changedEntityIDs = tree->takeChangedEntities();
+    if (changedEntityIDs.isEmpty()) {
+        return;
+    }
+
+    tree->withReadLock([&] {
+        foreach(const EntityItemID& entityID, changedEntityIDs) {
+            if (auto entity = tree->findEntityByEntityItemID(entityID)) {
+                _enterLeaveIndex.update(entity);
+            } else {
+                _enterLeaveIndex.remove(entityID);
+            }
+        }
+    });
+    forceRecheckEntities(); // the zones or scripted entities around us may have moved
+}
+
 bool EntityTreeRenderer::checkEnterLeaveEntities() {
     PerformanceTimer perfTimer("checkEnterLeaveEntities");
     auto now = usecTimestampNow();
     bool didUpdate = false;
 
     if (_tree && !_shuttingDown) {
+        updateEnterLeaveIndex();
+
         glm::vec3 avatarPosition = _viewState->getAvatarPosition();
 
         // we want to check our enter/leave state if we've moved a significant amount, or
@@ -302,8 +408,8 @@ bool EntityTreeRenderer::checkEnterLeaveEntities() {
             foreach(const EntityItemID& entityID, _currentEntitiesInside) {
                 if (!entitiesContainingAvatar.contains(entityID)) {
                     emit leaveEntity(entityID);
-                    if (_entitiesScriptEngine) {
-                        _entitiesScriptEngine->callEntityScriptMethod(entityID, "leaveEntity");
+                    if (auto engine = getEntitiesScriptEngine(entityID)) {
+                        engine->callEntityScriptMethod(entityID, "leaveEntity");
                     }
                 }
             }
@@ -312,8 +418,8 @@ bool EntityTreeRenderer::checkEnterLeaveEntities() {
             foreach(const EntityItemID& entityID, entitiesContainingAvatar) {
                 if (!_currentEntitiesInside.contains(entityID)) {
                     emit enterEntity(entityID);
-                    if (_entitiesScriptEngine) {
-                        _entitiesScriptEngine->callEntityScriptMethod(entityID, "enterEntity");
+                    if (auto engine = getEntitiesScriptEngine(entityID)) {
+                        engine->callEntityScriptMethod(entityID, "enterEntity");
                     }
                 }
             }
@@ -329,8 +435,8 @@ void EntityTreeRenderer::leaveAllEntities() {
         // for all of our previous containing entities, if they are no longer containing then send them a leave event
         foreach(const EntityItemID& entityID, _currentEntitiesInside) {
             emit leaveEntity(entityID);
-            if (_entitiesScriptEngine) {
-                _entitiesScriptEngine->callEntityScriptMethod(entityID, "leaveEntity");
+            if (auto engine = getEntitiesScriptEngine(entityID)) {
+                engine->callEntityScriptMethod(entityID, "leaveEntity");
             }
         }
         _currentEntitiesInside.clear();
@@ -539,7 +645,18 @@ ModelPointer EntityTreeRenderer::getModelForEntityItem(EntityItemPointer entityI
 }
 
 void EntityTreeRenderer::processEraseMessage(ReceivedMessage& message, const SharedNodePointer& sourceNode) {
-    std::static_pointer_cast<EntityTree>(_tree)->processEraseMessage(message, sourceNode);
+    EntityTreePointer tree = std::static_pointer_cast<EntityTree>(_tree);
+    if (isStagingData()) {
+        // the erase has to come after the data staged before it
+        QSet<EntityItemID> entityItemIDsToDelete = tree->decodeEraseMessage(message, sourceNode);
+        if (!entityItemIDsToDelete.isEmpty()) {
+            stageChange([tree, entityItemIDsToDelete] {
+                tree->deleteEntities(entityItemIDsToDelete, true, true);
+            });
+        }
+    } else {
+        tree->processEraseMessage(message, sourceNode);
+    }
 }
 
 ModelPointer EntityTreeRenderer::allocateModel(const QString& url, float loadingPriority) {
@@ -719,14 +836,14 @@ void EntityTreeRenderer::mousePressEvent(QMouseEvent* event) {
 
         emit mousePressOnEntity(rayPickResult.entityID, pointerEvent);
 
-        if (_entitiesScriptEngine) {
-            _entitiesScriptEngine->callEntityScriptMethod(rayPickResult.entityID, "mousePressOnEntity", pointerEvent);
+        if (auto engine = getEntitiesScriptEngine(rayPickResult.entityID)) {
+            engine->callEntityScriptMethod(rayPickResult.entityID, "mousePressOnEntity", pointerEvent);
         }
 
         _currentClickingOnEntityID = rayPickResult.entityID;
         emit clickDownOnEntity(_currentClickingOnEntityID, pointerEvent);
-        if (_entitiesScriptEngine) {
-            _entitiesScriptEngine->callEntityScriptMethod(_currentClickingOnEntityID, "clickDownOnEntity", pointerEvent);
+        if (auto engine = getEntitiesScriptEngine(_currentClickingOnEntityID)) {
+            engine->callEntityScriptMethod(_currentClickingOnEntityID, "clickDownOnEntity", pointerEvent);
         }
 
         _lastPointerEvent = pointerEvent;
@@ -758,8 +875,8 @@ void EntityTreeRenderer::mouseReleaseEvent(QMouseEvent* event) {
                                   toPointerButton(*event), toPointerButtons(*event));
 
         emit mouseReleaseOnEntity(rayPickResult.entityID, pointerEvent);
-        if (_entitiesScriptEngine) {
-            _entitiesScriptEngine->callEntityScriptMethod(rayPickResult.entityID, "mouseReleaseOnEntity", pointerEvent);
+        if (auto engine = getEntitiesScriptEngine(rayPickResult.entityID)) {
+            engine->callEntityScriptMethod(rayPickResult.entityID, "mouseReleaseOnEntity", pointerEvent);
         }
 
         _lastPointerEvent = pointerEvent;
@@ -778,8 +895,8 @@ void EntityTreeRenderer::mouseReleaseEvent(QMouseEvent* event) {
                                   toPointerButton(*event), toPointerButtons(*event));
 
         emit clickReleaseOnEntity(_currentClickingOnEntityID, pointerEvent);
-        if (_entitiesScriptEngine) {
-            _entitiesScriptEngine->callEntityScriptMethod(rayPickResult.entityID, "clickReleaseOnEntity", pointerEvent);
+        if (auto engine = getEntitiesScriptEngine(rayPickResult.entityID)) {
+            engine->callEntityScriptMethod(rayPickResult.entityID, "clickReleaseOnEntity", pointerEvent);
         }
     }
 
@@ -809,9 +926,9 @@ void EntityTreeRenderer::mouseMoveEvent(QMouseEvent* event) {
 
         emit mouseMoveOnEntity(rayPickResult.entityID, pointerEvent);
 
-        if (_entitiesScriptEngine) {
-            _entitiesScriptEngine->callEntityScriptMethod(rayPickResult.entityID, "mouseMoveEvent", pointerEvent);
-            _entitiesScriptEngine->callEntityScriptMethod(rayPickResult.entityID, "mouseMoveOnEntity", pointerEvent);
+        if (auto engine = getEntitiesScriptEngine(rayPickResult.entityID)) {
+            engine->callEntityScriptMethod(rayPickResult.entityID, "mouseMoveEvent", pointerEvent);
+            engine->callEntityScriptMethod(rayPickResult.entityID, "mouseMoveOnEntity", pointerEvent);
         }
 
         // handle the hover logic...
@@ -828,24 +945,24 @@ void EntityTreeRenderer::mouseMoveEvent(QMouseEvent* event) {
                                       toPointerButton(*event), toPointerButtons(*event));
 
             emit hoverLeaveEntity(_currentHoverOverEntityID, pointerEvent);
-            if (_entitiesScriptEngine) {
-                _entitiesScriptEngine->callEntityScriptMethod(_currentHoverOverEntityID, "hoverLeaveEntity", pointerEvent);
+            if (auto engine = getEntitiesScriptEngine(_currentHoverOverEntityID)) {
+                engine->callEntityScriptMethod(_currentHoverOverEntityID, "hoverLeaveEntity", pointerEvent);
             }
         }
 
         // If the new hover entity does not match the previous hover entity then we are entering the new one
         // this is true if the _currentHoverOverEntityID is known or unknown
         if (rayPickResult.entityID != _currentHoverOverEntityID) {
-            if (_entitiesScriptEngine) {
-                _entitiesScriptEngine->callEntityScriptMethod(rayPickResult.entityID, "hoverEnterEntity", pointerEvent);
+            if (auto engine = getEntitiesScriptEngine(rayPickResult.entityID)) {
+                engine->callEntityScriptMethod(rayPickResult.entityID, "hoverEnterEntity", pointerEvent);
             }
         }
 
         // and finally, no matter what, if we're intersecting an entity then we're definitely hovering over it, and
         // we should send our hover over event
         emit hoverOverEntity(rayPickResult.entityID, pointerEvent);
-        if (_entitiesScriptEngine) {
-            _entitiesScriptEngine->callEntityScriptMethod(rayPickResult.entityID, "hoverOverEntity", pointerEvent);
+        if (auto engine = getEntitiesScriptEngine(rayPickResult.entityID)) {
+            engine->callEntityScriptMethod(rayPickResult.entityID, "hoverOverEntity", pointerEvent);
         }
 
         // remember what we're hovering over
@@ -868,8 +985,8 @@ void EntityTreeRenderer::mouseMoveEvent(QMouseEvent* event) {
                                   toPointerButton(*event), toPointerButtons(*event));
 
             emit hoverLeaveEntity(_currentHoverOverEntityID, pointerEvent);
-            if (_entitiesScriptEngine) {
-                _entitiesScriptEngine->callEntityScriptMethod(_currentHoverOverEntityID, "hoverLeaveEntity", pointerEvent);
+            if (auto engine = getEntitiesScriptEngine(_currentHoverOverEntityID)) {
+                engine->callEntityScriptMethod(_currentHoverOverEntityID, "hoverLeaveEntity", pointerEvent);
             }
             _currentHoverOverEntityID = UNKNOWN_ENTITY_ID; // makes it the unknown ID
         }
@@ -887,17 +1004,19 @@ void EntityTreeRenderer::mouseMoveEvent(QMouseEvent* event) {
                                   toPointerButton(*event), toPointerButtons(*event));
 
         emit holdingClickOnEntity(_currentClickingOnEntityID, pointerEvent);
-        if (_entitiesScriptEngine) {
-            _entitiesScriptEngine->callEntityScriptMethod(_currentClickingOnEntityID, "holdingClickOnEntity", pointerEvent);
+        if (auto engine = getEntitiesScriptEngine(_currentClickingOnEntityID)) {
+            engine->callEntityScriptMethod(_currentClickingOnEntityID, "holdingClickOnEntity", pointerEvent);
         }
     }
 }
 
 void EntityTreeRenderer::deletingEntity(const EntityItemID& entityID) {
-    if (_tree && !_shuttingDown && _entitiesScriptEngine) {
-        _entitiesScriptEngine->unloadEntityScript(entityID);
+    auto engine = unassignEntitiesScriptEngine(entityID);
+    if (_tree && !_shuttingDown && engine) {
+        engine->unloadEntityScript(entityID);
     }
 
+    _enterLeaveIndex.remove(entityID);
     forceRecheckEntities(); // reset our state to force checking our inside/outsideness of entities
 
     // here's where we remove the entity payload from the scene
@@ -919,6 +1038,7 @@ void EntityTreeRenderer::addingEntity(const EntityItemID& entityID) {
     checkAndCallPreload(entityID);
     auto entity = std::static_pointer_cast<EntityTree>(_tree)->findEntityByID(entityID);
     if (entity) {
+        _enterLeaveIndex.update(entity);
         addEntityToScene(entity);
     }
 }
@@ -940,18 +1060,29 @@ void EntityTreeRenderer::addEntityToScene(EntityItemPointer entity) {
 
 void EntityTreeRenderer::entitySciptChanging(const EntityItemID& entityID, const bool reload) {
     if (_tree && !_shuttingDown) {
-        _entitiesScriptEngine->unloadEntityScript(entityID);
+        if (auto engine = unassignEntitiesScriptEngine(entityID)) {
+            engine->unloadEntityScript(entityID);
+        }
         checkAndCallPreload(entityID, reload);
+
+        // the entity may have gained or lost its script, and with it its place in the enter/leave index
+        if (auto entity = getTree()->findEntityByEntityItemID(entityID)) {
+            _enterLeaveIndex.update(entity);
+        } else {
+            _enterLeaveIndex.remove(entityID);
+        }
+        forceRecheckEntities();
     }
 }
 
 void EntityTreeRenderer::checkAndCallPreload(const EntityItemID& entityID, const bool reload) {
     if (_tree && !_shuttingDown) {
         EntityItemPointer entity = getTree()->findEntityByEntityItemID(entityID);
-        if (entity && entity->shouldPreloadScript() && _entitiesScriptEngine) {
+        if (entity && entity->shouldPreloadScript() && !_entitiesScriptEngines.isEmpty()) {
             QString scriptUrl = entity->getScript();
             scriptUrl = ResourceManager::normalizeURL(scriptUrl);
-            ScriptEngine::loadEntityScript(_entitiesScriptEngine, entityID, scriptUrl, reload);
+            auto engine = assignEntitiesScriptEngine(entityID, scriptUrl);
+            ScriptEngine::loadEntityScript(engine, entityID, scriptUrl, reload);
             entity->scriptHasPreloaded();
         }
     }
@@ -1057,15 +1188,15 @@ void EntityTreeRenderer::entityCollisionWithEntity(const EntityItemID& idA, cons
     // And now the entity scripts
     if (isCollisionOwner(myNodeID, entityTree, idA, collision)) {
         emit collisionWithEntity(idA, idB, collision);
-        if (_entitiesScriptEngine) {
-            _entitiesScriptEngine->callEntityScriptMethod(idA, "collisionWithEntity", idB, collision);
+        if (auto engine = getEntitiesScriptEngine(idA)) {
+            engine->callEntityScriptMethod(idA, "collisionWithEntity", idB, collision);
         }
     }
 
     if (isCollisionOwner(myNodeID, entityTree, idA, collision)) {
         emit collisionWithEntity(idB, idA, collision);
-        if (_entitiesScriptEngine) {
-            _entitiesScriptEngine->callEntityScriptMethod(idB, "collisionWithEntity", idA, collision);
+        if (auto engine = getEntitiesScriptEngine(idB)) {
+            engine->callEntityScriptMethod(idB, "collisionWithEntity", idA, collision);
         }
     }
 }
@@ -1211,3 +1342,123 @@ bool EntityTreeRenderer::LayeredZones::contains(const LayeredZones& other) {
     }
     return result;
 }
+
+// the enter/leave candidates are bucketed by cells of this size, and the ones that span more cells than
+// MAX_ENTER_LEAVE_CELLS (the zones covering a whole domain) are kept aside
+static const float ENTER_LEAVE_CELL_SIZE = 16.0f; // meters
+static const int MAX_ENTER_LEAVE_CELLS = 64;
+static const int ENTER_LEAVE_CELL_BITS = 21;
+static const int ENTER_LEAVE_CELL_OFFSET = 1 << (ENTER_LEAVE_CELL_BITS - 1);
+static const quint64 ENTER_LEAVE_CELL_MASK = (1 << ENTER_LEAVE_CELL_BITS) - 1;
+
+bool EntityTreeRenderer::EnterLeaveIndex::isIndexed(const EntityItem& entity) {
+    // FIXME - this could be narrowed down to the scripts that have an enterEntity or leaveEntity method
+    return entity.getType() == EntityTypes::Zone || !entity.getScript().isEmpty();
+}
+
+glm::ivec3 EntityTreeRenderer::EnterLeaveIndex::getCell(const glm::vec3& point) {
+    return glm::ivec3(glm::floor(point / ENTER_LEAVE_CELL_SIZE));
+}
+
+quint64 EntityTreeRenderer::EnterLeaveIndex::getCellKey(const glm::ivec3& cell) {
+    return (((quint64)(cell.x + ENTER_LEAVE_CELL_OFFSET) & ENTER_LEAVE_CELL_MASK) << (2 * ENTER_LEAVE_CELL_BITS)) |
+        (((quint64)(cell.y + ENTER_LEAVE_CELL_OFFSET) & ENTER_LEAVE_CELL_MASK) << ENTER_LEAVE_CELL_BITS) |
+        ((quint64)(cell.z + ENTER_LEAVE_CELL_OFFSET) & ENTER_LEAVE_CELL_MASK);
+}
+
+void EntityTreeRenderer::EnterLeaveIndex::update(const EntityItemPointer& entity) {
+    EntityItemID entityID = entity->getEntityItemID();
+    bool success = false;
+    AABox bounds;
+    if (isIndexed(*entity)) {
+        bounds = entity->getAABox(success);
+    }
+    if (!success) {
+        remove(entityID);
+        return;
+    }
+
+    Entry entry;
+    entry.entity = entity;
+    entry.minCell = getCell(bounds.getMinimumPoint());
+    entry.maxCell = getCell(bounds.getMaximumPoint());
+    glm::ivec3 span = entry.maxCell - entry.minCell + glm::ivec3(1);
+    entry.isLarge = span.x * span.y * span.z > MAX_ENTER_LEAVE_CELLS;
+
+    auto existing = _entries.find(entityID);
+    if (existing != _entries.end()) {
+        if (existing->minCell == entry.minCell && existing->maxCell == entry.maxCell) {
+            existing->entity = entity;
+            return;
+        }
+        removeEntry(entityID, *existing);
+    }
+
+    if (entry.isLarge) {
+        _largeEntities.insert(entityID);
+    } else {
+        for (int x = entry.minCell.x; x <= entry.maxCell.x; x++) {
+            for (int y = entry.minCell.y; y <= entry.maxCell.y; y++) {
+                for (int z = entry.minCell.z; z <= entry.maxCell.z; z++) {
+                    _cells[getCellKey(glm::ivec3(x, y, z))].push_back(entityID);
+                }
+            }
+        }
+    }
+    _entries.insert(entityID, entry);
+}
+
+void EntityTreeRenderer::EnterLeaveIndex::remove(const EntityItemID& entityID) {
+    auto existing = _entries.find(entityID);
+    if (existing != _entries.end()) {
+        removeEntry(entityID, *existing);
+        _entries.erase(existing);
+    }
+}
+
+void EntityTreeRenderer::EnterLeaveIndex::removeEntry(const EntityItemID& entityID, const Entry& entry) {
+    if (entry.isLarge) {
+        _largeEntities.remove(entityID);
+        return;
+    }
+    for (int x = entry.minCell.x; x <= entry.maxCell.x; x++) {
+        for (int y = entry.minCell.y; y <= entry.maxCell.y; y++) {
+            for (int z = entry.minCell.z; z <= entry.maxCell.z; z++) {
+                auto cell = _cells.find(getCellKey(glm::ivec3(x, y, z)));
+                if (cell != _cells.end()) {
+                    cell->removeOne(entityID);
+                    if (cell->isEmpty()) {
+                        _cells.erase(cell);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void EntityTreeRenderer::EnterLeaveIndex::clear() {
+    _entries.clear();
+    _cells.clear();
+    _largeEntities.clear();
+}
+
+void EntityTreeRenderer::EnterLeaveIndex::findEntities(const glm::vec3& point, QVector<EntityItemPointer>& foundEntities) const {
+    auto addEntity = [&](const EntityItemID& entityID) {
+        auto entry = _entries.find(entityID);
+        if (entry != _entries.end()) {
+            if (auto entity = entry->entity.lock()) {
+                foundEntities << entity;
+            }
+        }
+    };
+
+    auto cell = _cells.find(getCellKey(getCell(point)));
+    if (cell != _cells.end()) {
+        for (auto& entityID : *cell) {
+            addEntity(entityID);
+        }
+    }
+    for (auto& entityID : _largeEntities) {
+        addEntity(entityID);
+    }
+}
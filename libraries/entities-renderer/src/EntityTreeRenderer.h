@@ -12,6 +12,8 @@
 #ifndef hifi_EntityTreeRenderer_h
 #define hifi_EntityTreeRenderer_h
 
+#include <mutex>
+
 #include <QSet>
 #include <QStack>
 
@@ -22,11 +24,13 @@
 #include <PointerEvent.h>
 #include <OctreeRenderer.h>
 #include <ScriptCache.h>
+#include <SettingHandle.h>
 #include <TextureCache.h>
 
 class AbstractScriptingServicesInterface;
 class AbstractViewStateInterface;
 class Model;
+class EntityScriptTime;
 class ScriptEngine;
 class ZoneEntityItem;
 class EntityItem;
@@ -37,8 +41,12 @@ using ModelWeakPointer = std::weak_ptr<Model>;
 
 using CalculateEntityLoadingPriority = std::function<float(const EntityItem& item)>;
 
+static const int DEFAULT_ENTITY_SCRIPT_ENGINE_COUNT = 2;
+static const int MAX_ENTITY_SCRIPT_ENGINE_COUNT = 8;
+
 // Generic client side Octree renderer class.
-class EntityTreeRenderer : public OctreeRenderer, public EntityItemFBXService, public Dependency {
+class EntityTreeRenderer : public OctreeRenderer, public EntityItemFBXService, public EntitiesScriptEngineProvider,
+                           public Dependency {
     Q_OBJECT
 public:
     EntityTreeRenderer(bool wantScripts, AbstractViewStateInterface* viewState,
@@ -58,6 +66,13 @@ public:
     float getEntityLoadingPriority(const EntityItem& item) const { return _calculateEntityLoadingPriorityFunc(item); }
     void setEntityLoadingPriorityFunction(CalculateEntityLoadingPriority fn) { this->_calculateEntityLoadingPriorityFunc = fn; }
 
+    // EntitiesScriptEngineProvider, calls the method in whichever engine runs the script of the entity
+    virtual void callEntityScriptMethod(const EntityItemID& entityID, const QString& methodName,
+                                        const QStringList& params = QStringList()) override;
+
+    // time spent in each entity script, summed over all of the entity script engines
+    QHash<QUrl, EntityScriptTime> getEntityScriptTimes() const;
+
     void shutdown();
     void update();
 
@@ -139,7 +154,10 @@ protected:
     }
 
 private:
-    void resetEntitiesScriptEngine();
+    void resetEntitiesScriptEngines();
+    QSharedPointer<ScriptEngine> getEntitiesScriptEngine(const EntityItemID& entityID) const;
+    QSharedPointer<ScriptEngine> assignEntitiesScriptEngine(const EntityItemID& entityID, const QString& scriptUrl);
+    QSharedPointer<ScriptEngine> unassignEntitiesScriptEngine(const EntityItemID& entityID);
 
     void addEntityToScene(EntityItemPointer entity);
     bool findBestZoneAndMaybeContainingEntities(QVector<EntityItemID>* entitiesContainingAvatar = nullptr);
@@ -160,6 +178,7 @@ private:
     EntityItemID _currentClickingOnEntityID;
 
     QScriptValueList createEntityArgs(const EntityItemID& entityID);
+    void updateEnterLeaveIndex();
     bool checkEnterLeaveEntities();
     void leaveAllEntities();
     void forceRecheckEntities();
@@ -168,7 +187,13 @@ private:
     QVector<EntityItemID> _currentEntitiesInside;
 
     bool _wantScripts;
-    QSharedPointer<ScriptEngine> _entitiesScriptEngine;
+
+    // entity scripts are spread over several engines, each running on its own thread, by the hash of their URL - so a
+    // slow script only holds up the scripts that share its engine, and the entities of one script share their engine
+    Setting::Handle<int> _entitiesScriptEngineCountSetting { "entityScriptEngineCount", DEFAULT_ENTITY_SCRIPT_ENGINE_COUNT };
+    QVector<QSharedPointer<ScriptEngine>> _entitiesScriptEngines;
+    mutable std::mutex _entitiesScriptEnginesLock; // guards the assignments, which are also read by script threads
+    QHash<EntityItemID, QSharedPointer<ScriptEngine>> _entityScriptEngineAssignments;
 
     bool isCollisionOwner(const QUuid& myNodeID, EntityTreePointer entityTree,
                           const EntityItemID& id, const Collision& collision);
@@ -231,6 +256,37 @@ private:
     };
 
     LayeredZones _layeredZones;
+
+    // the zones and the entities with scripts - the only ones that enter/leave and the zone layering care about -
+    // by the cells of a uniform grid that their bounds touch, kept up to date from the changes of the tree
+    class EnterLeaveIndex {
+    public:
+        static bool isIndexed(const EntityItem& entity);
+
+        void update(const EntityItemPointer& entity);
+        void remove(const EntityItemID& entityID);
+        void clear();
+
+        void findEntities(const glm::vec3& point, QVector<EntityItemPointer>& foundEntities) const;
+
+    private:
+        struct Entry {
+            EntityItemWeakPointer entity;
+            glm::ivec3 minCell;
+            glm::ivec3 maxCell;
+            bool isLarge;
+        };
+
+        static glm::ivec3 getCell(const glm::vec3& point);
+        static quint64 getCellKey(const glm::ivec3& cell);
+        void removeEntry(const EntityItemID& entityID, const Entry& entry);
+
+        QHash<EntityItemID, Entry> _entries;
+        QHash<quint64, QVector<EntityItemID>> _cells;
+        QSet<EntityItemID> _largeEntities; // span too many cells, so they are tested wherever the avatar is
+    };
+
+    EnterLeaveIndex _enterLeaveIndex;
     QString _zoneUserData;
     NetworkTexturePointer _ambientTexture;
     NetworkTexturePointer _skyboxTexture;
@@ -81,10 +81,9 @@ public:
         render::ScenePointer scene = AbstractViewStateInterface::instance()->getMain3DScene();
 
         if (scene) {
-            pendingChanges.updateItem<RenderableEntityItemProxy>(_myItem, [](RenderableEntityItemProxy& data) {
-            });
+            pendingChanges.updateItem(_myItem);
 
-            scene->enqueuePendingChanges(pendingChanges);
+            scene->enqueuePendingChanges(std::move(pendingChanges));
         } else {
             qCWarning(entitiesrenderer) << "SimpleRenderableEntityItem::notifyChanged(), Unexpected null scene, possibly during application shutdown";
         }
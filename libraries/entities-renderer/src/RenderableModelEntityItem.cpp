@@ -385,6 +385,7 @@ void RenderableModelEntityItem::render(RenderArgs* args) {
                         mapJoints(modelJointNames);
                     }
                 }
+                updateJointNamesCache();
 
                 _jointDataLock.withWriteLock([&] {
                     getAnimationFrame();
@@ -522,7 +523,8 @@ ModelPointer RenderableModelEntityItem::getModel(QSharedPointer<EntityTreeRender
 }
 
 bool RenderableModelEntityItem::needsToCallUpdate() const {
-    return !_dimensionsInitialized || _needsInitialSimulation || ModelEntityItem::needsToCallUpdate();
+    return !_dimensionsInitialized || _needsInitialSimulation || (_model && !_model->isLoadingComplete()) ||
+        ModelEntityItem::needsToCallUpdate();
 }
 
 void RenderableModelEntityItem::update(const quint64& now) {
@@ -547,6 +549,11 @@ void RenderableModelEntityItem::update(const quint64& now) {
         }
     }
 
+    // Rank the model's pending requests by how it shows from the current view
+    if (_model && _myRenderer && !_model->isLoadingComplete() && QThread::currentThread() == _myRenderer->thread()) {
+        _model->setLoadingPriority(_myRenderer->getEntityLoadingPriority(*this));
+    }
+
     // make a copy of the animation properites
     _renderAnimationProperties = _animationProperties;
 
@@ -1218,3 +1225,11 @@ QStringList RenderableModelEntityItem::getJointNames() const {
     }
     return result;
 }
+
+void RenderableModelEntityItem::updateJointNamesCache() {
+    const void* geometryKey = (_model && _model->isActive()) ? &_model->getFBXGeometry() : nullptr;
+    if (geometryKey != _jointNamesGeometryKey) {
+        _jointNamesCache.set(getJointNames());
+        _jointNamesGeometryKey = geometryKey;
+    }
+}
@@ -16,6 +16,7 @@
 #include <QStringList>
 
 #include <ModelEntityItem.h>
+#include <ThreadSafeValueCache.h>
 
 class Model;
 class EntityTreeRenderer;
@@ -92,6 +93,7 @@ public:
 
     virtual int getJointIndex(const QString& name) const override;
     virtual QStringList getJointNames() const override;
+    virtual QStringList getCachedJointNames() const override { return _jointNamesCache.get(); }
 
     // These operate on a copy of the animationProperties, so they can be accessed
     // without having the entityTree lock.
@@ -127,6 +129,10 @@ private:
     bool _needsJointSimulation { false };
     bool _showCollisionGeometry { false };
     const void* _collisionMeshKey { nullptr };
+
+    void updateJointNamesCache();
+    ThreadSafeValueCache<QStringList> _jointNamesCache;
+    const void* _jointNamesGeometryKey { nullptr }; // the geometry _jointNamesCache was taken from
 };
 
 #endif // hifi_RenderableModelEntityItem_h
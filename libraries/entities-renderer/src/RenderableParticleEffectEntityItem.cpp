@@ -8,6 +8,9 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
+#include <limits>
+
 #include <glm/gtx/quaternion.hpp>
 
 #include <DependencyManager.h>
@@ -39,7 +42,8 @@ public:
         InterpolationData<float> radius;
         InterpolationData<glm::vec4> color; // rgba
         float lifespan;
-        glm::vec3 spare;
+        float time; // The simulation clock, for the particles simulated in the shader
+        glm::vec2 spare;
     };
     
     struct ParticlePrimitive {
@@ -47,6 +51,18 @@ public:
         glm::vec3 xyz; // Position
         glm::vec2 uv; // Lifetime + seed
     };
+
+    // The state a particle was emitted with, its slot in the buffer is its emission index modulo the max particles,
+    // so a particle is written once and the shader moves it along
+    struct ParticleEmission {
+        ParticleEmission() {}
+        ParticleEmission(glm::vec3 position, float emitTime, glm::vec3 velocity, float seed, glm::vec3 acceleration) :
+            positionAndEmitTime(position, emitTime), velocityAndSeed(velocity, seed), acceleration(acceleration, 0.0f) {}
+        // Slots without a live particle are emitted in the far future, the shader hides them
+        glm::vec4 positionAndEmitTime { 0.0f, 0.0f, 0.0f, std::numeric_limits<float>::max() };
+        glm::vec4 velocityAndSeed;
+        glm::vec4 acceleration;
+    };
     
     using Payload = render::Payload<ParticlePayloadData>;
     using Pointer = Payload::DataPointer;
@@ -58,6 +74,7 @@ public:
     using Buffer = gpu::Buffer;
     using BufferView = gpu::BufferView;
     using ParticlePrimitives = std::vector<ParticlePrimitive>;
+    using ParticleEmissions = std::vector<ParticleEmission>;
     
     ParticlePayloadData() {
         ParticleUniforms uniforms;
@@ -67,6 +84,13 @@ public:
                                     offsetof(ParticlePrimitive, xyz), gpu::Stream::PER_INSTANCE);
         _vertexFormat->setAttribute(gpu::Stream::COLOR, 0, gpu::Element::VEC2F_UV,
                                     offsetof(ParticlePrimitive, uv), gpu::Stream::PER_INSTANCE);
+
+        _emissionFormat->setAttribute(gpu::Stream::POSITION, 0, gpu::Element::VEC4F_XYZW,
+                                      offsetof(ParticleEmission, positionAndEmitTime), gpu::Stream::PER_INSTANCE);
+        _emissionFormat->setAttribute(gpu::Stream::NORMAL, 0, gpu::Element::VEC4F_XYZW,
+                                      offsetof(ParticleEmission, velocityAndSeed), gpu::Stream::PER_INSTANCE);
+        _emissionFormat->setAttribute(gpu::Stream::TEXCOORD, 0, gpu::Element::VEC4F_XYZW,
+                                      offsetof(ParticleEmission, acceleration), gpu::Stream::PER_INSTANCE);
     }
 
     void setPipeline(PipelinePointer pipeline) { _pipeline = pipeline; }
@@ -89,6 +113,10 @@ public:
 
     bool getVisibleFlag() const { return _visibleFlag; }
     void setVisibleFlag(bool visibleFlag) { _visibleFlag = visibleFlag; }
+
+    // The particle buffer holds ParticleEmissions when simulated, ParticlePrimitives otherwise
+    bool isSimulated() const { return _simulated; }
+    void setSimulated(bool simulated) { _simulated = simulated; }
     
     void render(RenderArgs* args) const {
         assert(_pipeline);
@@ -102,10 +130,11 @@ public:
 
         batch.setModelTransform(_modelTransform);
         batch.setUniformBuffer(0, _uniformBuffer);
-        batch.setInputFormat(_vertexFormat);
-        batch.setInputBuffer(0, _particleBuffer, 0, sizeof(ParticlePrimitive));
+        size_t stride = _simulated ? sizeof(ParticleEmission) : sizeof(ParticlePrimitive);
+        batch.setInputFormat(_simulated ? _emissionFormat : _vertexFormat);
+        batch.setInputBuffer(0, _particleBuffer, 0, stride);
 
-        auto numParticles = _particleBuffer->getSize() / sizeof(ParticlePrimitive);
+        auto numParticles = _particleBuffer->getSize() / stride;
         batch.drawInstanced((gpu::uint32)numParticles, gpu::TRIANGLE_STRIP, (gpu::uint32)VERTEX_PER_PARTICLE);
     }
 
@@ -114,10 +143,12 @@ protected:
     AABox _bound;
     PipelinePointer _pipeline;
     FormatPointer _vertexFormat { std::make_shared<Format>() };
+    FormatPointer _emissionFormat { std::make_shared<Format>() };
     BufferPointer _particleBuffer { std::make_shared<Buffer>() };
     BufferView _uniformBuffer;
     TexturePointer _texture;
     bool _visibleFlag = true;
+    bool _simulated = false;
 };
 
 namespace render {
@@ -172,6 +203,8 @@ bool RenderableParticleEffectEntityItem::addToScene(EntityItemPointer self,
     makeEntityItemStatusGetters(getThisPointer(), statusGetters);
     renderPayload->addStatusGetters(statusGetters);
     pendingChanges.resetItem(_renderItemId, renderPayload);
+    // the new payload has none of the particles
+    _simulatedParticlesValid = false;
     return true;
 }
 
@@ -211,13 +244,15 @@ void RenderableParticleEffectEntityItem::updateRenderItem() {
             payload.setVisibleFlag(false);
         });
         
-        _scene->enqueuePendingChanges(pendingChanges);
+        _scene->enqueuePendingChanges(std::move(pendingChanges));
         return;
     }
     
     using ParticleUniforms = ParticlePayloadData::ParticleUniforms;
     using ParticlePrimitive = ParticlePayloadData::ParticlePrimitive;
     using ParticlePrimitives = ParticlePayloadData::ParticlePrimitives;
+    using ParticleEmission = ParticlePayloadData::ParticleEmission;
+    using ParticleEmissions = ParticlePayloadData::ParticleEmissions;
 
     // Fill in Uniforms structure
     ParticleUniforms particleUniforms;
@@ -230,12 +265,43 @@ void RenderableParticleEffectEntityItem::updateRenderItem() {
     particleUniforms.color.finish = glm::vec4(getColorFinishRGB(), getAlphaFinish());
     particleUniforms.color.spread = glm::vec4(getColorSpreadRGB(), getAlphaSpread());
     particleUniforms.lifespan = getLifespan();
-    
-    // Build particle primitives
+    particleUniforms.time = _simulationTime;
+
+    // The textured particles are moved by their shader, only the newly emitted ones are sent to it.
+    // The untextured ones are moved on the CPU and all sent every frame.
+    bool simulated = _texture && _texture->isLoaded();
+
     auto particlePrimitives = std::make_shared<ParticlePrimitives>();
-    particlePrimitives->reserve(_particles.size()); // Reserve space
-    for (auto& particle : _particles) {
-        particlePrimitives->emplace_back(particle.position, glm::vec2(particle.lifetime, particle.seed));
+    auto particleEmissions = std::make_shared<ParticleEmissions>();
+    auto maxParticles = getMaxParticles();
+    size_t numSlots = (size_t)std::min<quint64>(_emittedParticleCount, maxParticles);
+    quint64 firstEmissionIndex = 0;
+    bool resetEmissions = false;
+    quint64 headParticleIndex = _emittedParticleCount - _particles.size();
+    if (simulated) {
+        resetEmissions = !_simulatedParticlesValid || _simulatedParticlesResetCount != _particlesResetCount;
+        if (resetEmissions) {
+            // every slot, in slot order
+            particleEmissions->resize(numSlots);
+        } else {
+            firstEmissionIndex = std::max(_simulatedParticleCount, headParticleIndex);
+            particleEmissions->reserve((size_t)(_emittedParticleCount - firstEmissionIndex));
+        }
+        for (quint64 index = resetEmissions ? headParticleIndex : firstEmissionIndex; index < _emittedParticleCount; ++index) {
+            const auto& particle = _particles[(size_t)(index - headParticleIndex)];
+            ParticleEmission emission(particle.position, particle.emitTime, particle.velocity, particle.seed,
+                                      particle.acceleration);
+            if (resetEmissions) {
+                (*particleEmissions)[(size_t)(index % maxParticles)] = emission;
+            } else {
+                particleEmissions->push_back(emission);
+            }
+        }
+    } else {
+        particlePrimitives->reserve(_particles.size()); // Reserve space
+        for (auto& particle : _particles) {
+            particlePrimitives->emplace_back(getParticlePosition(particle), glm::vec2(getParticleAge(particle), particle.seed));
+        }
     }
 
     bool successb, successp, successr;
@@ -246,6 +312,9 @@ void RenderableParticleEffectEntityItem::updateRenderItem() {
     if (!success) {
         return;
     }
+    _simulatedParticlesValid = simulated;
+    _simulatedParticleCount = _emittedParticleCount;
+    _simulatedParticlesResetCount = _particlesResetCount;
     Transform transform;
     if (!getEmitterShouldTrail()) {
         transform.setTranslation(position);
@@ -262,18 +331,36 @@ void RenderableParticleEffectEntityItem::updateRenderItem() {
         
         // Update particle buffer
         auto particleBuffer = payload.getParticleBuffer();
-        size_t numBytes = sizeof(ParticlePrimitive) * particlePrimitives->size();
-        particleBuffer->resize(numBytes);
-        if (numBytes == 0) {
-            return;
+        payload.setSimulated(simulated);
+        if (simulated) {
+            size_t numBytes = sizeof(ParticleEmission) * numSlots;
+            particleBuffer->resize(numBytes);
+            if (numBytes == 0) {
+                return;
+            }
+            if (resetEmissions) {
+                particleBuffer->setData(numBytes, (const gpu::Byte*)particleEmissions->data());
+            } else {
+                // only the slots of the particles emitted since the last update change
+                for (size_t i = 0; i < particleEmissions->size(); ++i) {
+                    particleBuffer->setSubData<ParticleEmission>((size_t)((firstEmissionIndex + i) % maxParticles),
+                                                                 (*particleEmissions)[i]);
+                }
+            }
+        } else {
+            size_t numBytes = sizeof(ParticlePrimitive) * particlePrimitives->size();
+            particleBuffer->resize(numBytes);
+            if (numBytes == 0) {
+                return;
+            }
+            particleBuffer->setData(numBytes, (const gpu::Byte*)particlePrimitives->data());
         }
-        particleBuffer->setData(numBytes, (const gpu::Byte*)particlePrimitives->data());
 
         // Update transform and bounds
         payload.setModelTransform(transform);
         payload.setBound(bounds);
 
-        if (_texture && _texture->isLoaded()) {
+        if (simulated) {
             payload.setTexture(_texture->getGPUTexture());
             payload.setPipeline(_texturedPipeline);
         } else {
@@ -282,7 +369,7 @@ void RenderableParticleEffectEntityItem::updateRenderItem() {
         }
     });
 
-    _scene->enqueuePendingChanges(pendingChanges);
+    _scene->enqueuePendingChanges(std::move(pendingChanges));
 }
 
 void RenderableParticleEffectEntityItem::createPipelines() {
@@ -319,8 +406,7 @@ void RenderableParticleEffectEntityItem::notifyBoundChanged() {
         return;
     }
     render::PendingChanges pendingChanges;
-    pendingChanges.updateItem<ParticlePayloadData>(_renderItemId, [](ParticlePayloadData& payload) {
-    });
+    pendingChanges.updateItem(_renderItemId);
 
-    _scene->enqueuePendingChanges(pendingChanges);
+    _scene->enqueuePendingChanges(std::move(pendingChanges));
 }
\ No newline at end of file
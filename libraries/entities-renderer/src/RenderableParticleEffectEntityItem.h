@@ -42,6 +42,11 @@ protected:
     NetworkTexturePointer _texture;
     gpu::PipelinePointer _untexturedPipeline;
     gpu::PipelinePointer _texturedPipeline;
+
+    // What the render item's particle buffer holds of the particles simulated in the shader
+    bool _simulatedParticlesValid { false };
+    quint64 _simulatedParticleCount { 0 };
+    quint32 _simulatedParticlesResetCount { 0 };
 };
 
 
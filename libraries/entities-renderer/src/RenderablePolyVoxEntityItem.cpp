@@ -54,6 +54,8 @@
 
 gpu::PipelinePointer RenderablePolyVoxEntityItem::_pipeline = nullptr;
 const float MARCHING_CUBE_COLLISION_HULL_OFFSET = 0.5;
+// The voxels on a side of the chunks the mesh is extracted in
+const int MESH_CHUNK_SIZE = 16;
 
 
 /*
@@ -81,6 +83,10 @@ const float MARCHING_CUBE_COLLISION_HULL_OFFSET = 0.5;
   When a script changes _volData, compressVolumeDataAndSendEditPacket is called to update _voxelData and to
   send a packet to the entity-server.
 
+  The mesh is extracted in chunks of MESH_CHUNK_SIZE voxels on a side.  setVoxelInternal keeps the bounds of the
+  voxels changed since the last extraction, and getMesh only extracts the chunks around them again.  The collision
+  hulls are kept per chunk as well, so computeShapeInfoWorker only rebuilds those of the re-extracted chunks.
+
   decompressVolumeData, getMesh, computeShapeInfoWorker, and compressVolumeDataAndSendEditPacket are too expensive
   to run on a thread that has other things to do.  These use QtConcurrent::run to spawn a thread.  As each thread
   finishes, it adjusts the dirty flags so that the next call to render() will kick off the next step.
@@ -167,6 +173,7 @@ void RenderablePolyVoxEntityItem::setVoxelSurfaceStyle(PolyVoxSurfaceStyle voxel
         bool wasEdged = isEdged(_voxelSurfaceStyle);
         bool willBeEdged = isEdged(voxelSurfaceStyle);
 
+        _remeshAll = true;
         if (wasEdged != willBeEdged) {
             _volDataDirty = true;
             if (_volData) {
@@ -734,6 +741,7 @@ void RenderablePolyVoxEntityItem::setVoxelVolumeSize(glm::vec3 voxelVolumeSize)
         }
 
         _voxelDataDirty = true;
+        _remeshAll = true;
         _voxelVolumeSize = voxelVolumeSize;
 
         if (_volData) {
@@ -823,8 +831,14 @@ bool RenderablePolyVoxEntityItem::setVoxelInternal(int x, int y, int z, uint8_t
 
     if (isEdged(_voxelSurfaceStyle)) {
         _volData->setVoxelAt(x + 1, y + 1, z + 1, toValue);
+        if (result) {
+            markVoxelDirty(x + 1, y + 1, z + 1);
+        }
     } else {
         _volData->setVoxelAt(x, y, z, toValue);
+        if (result) {
+            markVoxelDirty(x, y, z);
+        }
     }
 
     if (x == 0 || y == 0 || z == 0) {
@@ -837,6 +851,19 @@ bool RenderablePolyVoxEntityItem::setVoxelInternal(int x, int y, int z, uint8_t
 }
 
 
+void RenderablePolyVoxEntityItem::markVoxelDirty(int x, int y, int z) {
+    // x, y, z are in _volData coords.  This assumes that the caller has write-locked the entity.
+    glm::ivec3 voxel(x, y, z);
+    if (_hasDirtyVoxels) {
+        _dirtyVoxelsLow = glm::min(_dirtyVoxelsLow, voxel);
+        _dirtyVoxelsHigh = glm::max(_dirtyVoxelsHigh, voxel);
+    } else {
+        _dirtyVoxelsLow = voxel;
+        _dirtyVoxelsHigh = voxel;
+        _hasDirtyVoxels = true;
+    }
+}
+
 bool RenderablePolyVoxEntityItem::updateOnCount(int x, int y, int z, uint8_t toValue) {
     // keep _onCount up to date
     if (!inUserBounds(_volData, _voxelSurfaceStyle, x, y, z)) {
@@ -1044,8 +1071,11 @@ void RenderablePolyVoxEntityItem::copyUpperEdgesFromNeighbors() {
             for (int y = 0; y < _volData->getHeight(); y++) {
                 for (int z = 0; z < _volData->getDepth(); z++) {
                     uint8_t neighborValue = currentXPNeighbor->getVoxel(0, y, z);
-                    if ((y == 0 || z == 0) && _volData->getVoxelAt(_volData->getWidth() - 1, y, z) != neighborValue) {
-                        bonkNeighbors();
+                    if (_volData->getVoxelAt(_volData->getWidth() - 1, y, z) != neighborValue) {
+                        markVoxelDirty(_volData->getWidth() - 1, y, z);
+                        if (y == 0 || z == 0) {
+                            bonkNeighbors();
+                        }
                     }
                     _volData->setVoxelAt(_volData->getWidth() - 1, y, z, neighborValue);
                 }
@@ -1059,8 +1089,11 @@ void RenderablePolyVoxEntityItem::copyUpperEdgesFromNeighbors() {
             for (int x = 0; x < _volData->getWidth(); x++) {
                 for (int z = 0; z < _volData->getDepth(); z++) {
                     uint8_t neighborValue = currentYPNeighbor->getVoxel(x, 0, z);
-                    if ((x == 0 || z == 0) && _volData->getVoxelAt(x, _volData->getHeight() - 1, z) != neighborValue) {
-                        bonkNeighbors();
+                    if (_volData->getVoxelAt(x, _volData->getHeight() - 1, z) != neighborValue) {
+                        markVoxelDirty(x, _volData->getHeight() - 1, z);
+                        if (x == 0 || z == 0) {
+                            bonkNeighbors();
+                        }
                     }
                     _volData->setVoxelAt(x, _volData->getHeight() - 1, z, neighborValue);
                 }
@@ -1074,6 +1107,9 @@ void RenderablePolyVoxEntityItem::copyUpperEdgesFromNeighbors() {
             for (int x = 0; x < _volData->getWidth(); x++) {
                 for (int y = 0; y < _volData->getHeight(); y++) {
                     uint8_t neighborValue = currentZPNeighbor->getVoxel(x, y, 0);
+                    if (_volData->getVoxelAt(x, y, _volData->getDepth() - 1) != neighborValue) {
+                        markVoxelDirty(x, y, _volData->getDepth() - 1);
+                    }
                     _volData->setVoxelAt(x, y, _volData->getDepth() - 1, neighborValue);
                     if ((x == 0 || y == 0) && _volData->getVoxelAt(x, y, _volData->getDepth() - 1) != neighborValue) {
                         bonkNeighbors();
@@ -1095,54 +1131,131 @@ void RenderablePolyVoxEntityItem::getMesh() {
     cacheNeighbors();
     copyUpperEdgesFromNeighbors();
 
+    // take the voxels changed since the last extraction
+    bool remeshAll;
+    bool hasDirtyVoxels;
+    glm::ivec3 dirtyVoxelsLow;
+    glm::ivec3 dirtyVoxelsHigh;
+    withWriteLock([&] {
+        remeshAll = _remeshAll;
+        hasDirtyVoxels = _hasDirtyVoxels;
+        dirtyVoxelsLow = _dirtyVoxelsLow;
+        dirtyVoxelsHigh = _dirtyVoxelsHigh;
+        _remeshAll = false;
+        _hasDirtyVoxels = false;
+    });
+
     auto entity = std::static_pointer_cast<RenderablePolyVoxEntityItem>(getThisPointer());
 
 
-    QtConcurrent::run([entity, voxelSurfaceStyle] {
+    QtConcurrent::run([entity, voxelSurfaceStyle, remeshAll, hasDirtyVoxels, dirtyVoxelsLow, dirtyVoxelsHigh] {
         model::MeshPointer mesh(new model::Mesh());
 
-        // A mesh object to hold the result of surface extraction
-        PolyVox::SurfaceMesh<PolyVox::PositionMaterialNormal> polyVoxMesh;
+        // the chunks are only touched by one extraction or collision worker at a time
+        std::lock_guard<std::mutex> chunksLock(entity->_meshChunksMutex);
+        std::vector<MeshChunk>& chunks = entity->_meshChunks;
 
         entity->withReadLock([&] {
             PolyVox::SimpleVolume<uint8_t>* volData = entity->getVolData();
-            switch (voxelSurfaceStyle) {
-                case PolyVoxEntityItem::SURFACE_EDGED_MARCHING_CUBES: {
-                    PolyVox::MarchingCubesSurfaceExtractor<PolyVox::SimpleVolume<uint8_t>> surfaceExtractor
-                        (volData, volData->getEnclosingRegion(), &polyVoxMesh);
-                    surfaceExtractor.execute();
-                    break;
-                }
-                case PolyVoxEntityItem::SURFACE_MARCHING_CUBES: {
-                    PolyVox::MarchingCubesSurfaceExtractor<PolyVox::SimpleVolume<uint8_t>> surfaceExtractor
-                        (volData, volData->getEnclosingRegion(), &polyVoxMesh);
-                    surfaceExtractor.execute();
-                    break;
-                }
-                case PolyVoxEntityItem::SURFACE_EDGED_CUBIC: {
-                    PolyVox::CubicSurfaceExtractorWithNormals<PolyVox::SimpleVolume<uint8_t>> surfaceExtractor
-                        (volData, volData->getEnclosingRegion(), &polyVoxMesh);
-                    surfaceExtractor.execute();
-                    break;
+            PolyVox::Vector3DInt32 enclosingUpperCorner = volData->getEnclosingRegion().getUpperCorner();
+            glm::ivec3 upperCorner(enclosingUpperCorner.getX(), enclosingUpperCorner.getY(), enclosingUpperCorner.getZ());
+            glm::ivec3 chunkCounts = glm::max((upperCorner + MESH_CHUNK_SIZE - 1) / MESH_CHUNK_SIZE, glm::ivec3(1));
+
+            glm::ivec3 firstChunk(0);
+            glm::ivec3 lastChunk(chunkCounts - 1);
+            if (remeshAll || chunkCounts != entity->_meshChunkCounts || voxelSurfaceStyle != entity->_meshChunksSurfaceStyle) {
+                // neighboring chunks share the voxels on their common face, like the cells of the extractors do
+                chunks.clear();
+                chunks.resize(chunkCounts.x * chunkCounts.y * chunkCounts.z);
+                for (int z = 0; z < chunkCounts.z; z++) {
+                    for (int y = 0; y < chunkCounts.y; y++) {
+                        for (int x = 0; x < chunkCounts.x; x++) {
+                            MeshChunk& chunk = chunks[(z * chunkCounts.y + y) * chunkCounts.x + x];
+                            chunk.lowCorner = glm::ivec3(x, y, z) * MESH_CHUNK_SIZE;
+                            chunk.highCorner = glm::min(chunk.lowCorner + MESH_CHUNK_SIZE, upperCorner);
+                            // the voxels on a shared face go to the chunk above it, the last chunk takes its upper face
+                            chunk.voxelsEnd = chunk.highCorner +
+                                glm::ivec3(glm::equal(chunk.highCorner, upperCorner));
+                        }
+                    }
                 }
-                case PolyVoxEntityItem::SURFACE_CUBIC: {
-                    PolyVox::CubicSurfaceExtractorWithNormals<PolyVox::SimpleVolume<uint8_t>> surfaceExtractor
-                        (volData, volData->getEnclosingRegion(), &polyVoxMesh);
-                    surfaceExtractor.execute();
-                    break;
+                entity->_meshChunkCounts = chunkCounts;
+                entity->_meshChunksSurfaceStyle = voxelSurfaceStyle;
+            } else if (hasDirtyVoxels) {
+                // a voxel is read when extracting the cells on either side of it
+                glm::ivec3 low = dirtyVoxelsLow - 1;
+                glm::ivec3 high = dirtyVoxelsHigh + 1;
+                firstChunk = glm::max((low + MESH_CHUNK_SIZE - 1) / MESH_CHUNK_SIZE - 1, glm::ivec3(0));
+                lastChunk = glm::min(high / MESH_CHUNK_SIZE, chunkCounts - 1);
+            } else {
+                lastChunk = glm::ivec3(-1);
+            }
+
+            for (int z = firstChunk.z; z <= lastChunk.z; z++) {
+                for (int y = firstChunk.y; y <= lastChunk.y; y++) {
+                    for (int x = firstChunk.x; x <= lastChunk.x; x++) {
+                        MeshChunk& chunk = chunks[(z * chunkCounts.y + y) * chunkCounts.x + x];
+                        PolyVox::Region region(PolyVox::Vector3DInt32(chunk.lowCorner.x, chunk.lowCorner.y, chunk.lowCorner.z),
+                                               PolyVox::Vector3DInt32(chunk.highCorner.x, chunk.highCorner.y, chunk.highCorner.z));
+
+                        // A mesh object to hold the result of surface extraction
+                        PolyVox::SurfaceMesh<PolyVox::PositionMaterialNormal> polyVoxMesh;
+                        switch (voxelSurfaceStyle) {
+                            case PolyVoxEntityItem::SURFACE_EDGED_MARCHING_CUBES:
+                            case PolyVoxEntityItem::SURFACE_MARCHING_CUBES: {
+                                PolyVox::MarchingCubesSurfaceExtractor<PolyVox::SimpleVolume<uint8_t>> surfaceExtractor
+                                    (volData, region, &polyVoxMesh);
+                                surfaceExtractor.execute();
+                                break;
+                            }
+                            case PolyVoxEntityItem::SURFACE_EDGED_CUBIC:
+                            case PolyVoxEntityItem::SURFACE_CUBIC: {
+                                PolyVox::CubicSurfaceExtractorWithNormals<PolyVox::SimpleVolume<uint8_t>> surfaceExtractor
+                                    (volData, region, &polyVoxMesh);
+                                surfaceExtractor.execute();
+                                break;
+                            }
+                        }
+
+                        // the extractors place the vertices relative to the corner of the region they extract
+                        PolyVox::Vector3DFloat offset((float)chunk.lowCorner.x, (float)chunk.lowCorner.y, (float)chunk.lowCorner.z);
+                        chunk.vertices = polyVoxMesh.getVertices();
+                        for (auto& vertex : chunk.vertices) {
+                            vertex.setPosition(vertex.getPosition() + offset);
+                        }
+                        chunk.indices = polyVoxMesh.getIndices();
+                        chunk.hullsValid = false;
+                    }
                 }
             }
         });
 
+        // stitch the chunks into one mesh
+        std::vector<PolyVox::PositionMaterialNormal> vecVertices;
+        std::vector<uint32_t> vecIndices;
+        size_t numVertices = 0;
+        size_t numIndices = 0;
+        for (const auto& chunk : chunks) {
+            numVertices += chunk.vertices.size();
+            numIndices += chunk.indices.size();
+        }
+        vecVertices.reserve(numVertices);
+        vecIndices.reserve(numIndices);
+        for (const auto& chunk : chunks) {
+            uint32_t baseIndex = (uint32_t)vecVertices.size();
+            vecVertices.insert(vecVertices.end(), chunk.vertices.begin(), chunk.vertices.end());
+            for (uint32_t index : chunk.indices) {
+                vecIndices.push_back(baseIndex + index);
+            }
+        }
+
         // convert PolyVox mesh to a Sam mesh
-        const std::vector<uint32_t>& vecIndices = polyVoxMesh.getIndices();
         auto indexBuffer = std::make_shared<gpu::Buffer>(vecIndices.size() * sizeof(uint32_t),
                                                          (gpu::Byte*)vecIndices.data());
         auto indexBufferPtr = gpu::BufferPointer(indexBuffer);
         auto indexBufferView = new gpu::BufferView(indexBufferPtr, gpu::Element(gpu::SCALAR, gpu::UINT32, gpu::RAW));
         mesh->setIndexBuffer(*indexBufferView);
 
-        const std::vector<PolyVox::PositionMaterialNormal>& vecVertices = polyVoxMesh.getVertices();
         auto vertexBuffer = std::make_shared<gpu::Buffer>(vecVertices.size() * sizeof(PolyVox::PositionMaterialNormal),
                                                           (gpu::Byte*)vecVertices.data());
         auto vertexBufferPtr = gpu::BufferPointer(vertexBuffer);
@@ -1182,7 +1295,8 @@ void RenderablePolyVoxEntityItem::setMesh(model::MeshPointer mesh) {
 
 void RenderablePolyVoxEntityItem::computeShapeInfoWorker() {
     // this creates a collision-shape for the physics engine.  The shape comes from
-    // _volData for cubic extractors and from _mesh for marching-cube extractors
+    // _volData for cubic extractors and from _mesh for marching-cube extractors.  The hulls
+    // are kept per mesh chunk, in voxel coords, and only the re-extracted chunks are redone.
     if (!_meshInitialized) {
         return;
     }
@@ -1190,124 +1304,121 @@ void RenderablePolyVoxEntityItem::computeShapeInfoWorker() {
     EntityItemPointer entity = getThisPointer();
 
     PolyVoxSurfaceStyle voxelSurfaceStyle;
-    glm::vec3 voxelVolumeSize;
-    model::MeshPointer mesh;
-
     withReadLock([&] {
         voxelSurfaceStyle = _voxelSurfaceStyle;
-        voxelVolumeSize = _voxelVolumeSize;
-        mesh = _mesh;
     });
 
-    QtConcurrent::run([entity, voxelSurfaceStyle, voxelVolumeSize, mesh] {
+    QtConcurrent::run([entity, voxelSurfaceStyle] {
         auto polyVoxEntity = std::static_pointer_cast<RenderablePolyVoxEntityItem>(entity);
-        QVector<QVector<glm::vec3>> pointCollection;
-        AABox box;
-        glm::mat4 vtoM = std::static_pointer_cast<RenderablePolyVoxEntityItem>(entity)->voxelToLocalMatrix();
+        glm::mat4 vtoM = polyVoxEntity->voxelToLocalMatrix();
+
+        std::lock_guard<std::mutex> chunksLock(polyVoxEntity->_meshChunksMutex);
+        std::vector<MeshChunk>& chunks = polyVoxEntity->_meshChunks;
 
         if (voxelSurfaceStyle == PolyVoxEntityItem::SURFACE_MARCHING_CUBES ||
             voxelSurfaceStyle == PolyVoxEntityItem::SURFACE_EDGED_MARCHING_CUBES) {
             // pull each triangle in the mesh into a polyhedron which can be collided with
-            unsigned int i = 0;
-
-            const gpu::BufferView& vertexBufferView = mesh->getVertexBuffer();
-            const gpu::BufferView& indexBufferView = mesh->getIndexBuffer();
-
-            gpu::BufferView::Iterator<const uint32_t> it = indexBufferView.cbegin<uint32_t>();
-            while (it != indexBufferView.cend<uint32_t>()) {
-                uint32_t p0Index = *(it++);
-                uint32_t p1Index = *(it++);
-                uint32_t p2Index = *(it++);
-
-                const glm::vec3& p0 = vertexBufferView.get<const glm::vec3>(p0Index);
-                const glm::vec3& p1 = vertexBufferView.get<const glm::vec3>(p1Index);
-                const glm::vec3& p2 = vertexBufferView.get<const glm::vec3>(p2Index);
-
-                glm::vec3 av = (p0 + p1 + p2) / 3.0f; // center of the triangular face
-                glm::vec3 normal = glm::normalize(glm::cross(p1 - p0, p2 - p0));
-                glm::vec3 p3 = av - normal * MARCHING_CUBE_COLLISION_HULL_OFFSET;
-
-                glm::vec3 p0Model = glm::vec3(vtoM * glm::vec4(p0, 1.0f));
-                glm::vec3 p1Model = glm::vec3(vtoM * glm::vec4(p1, 1.0f));
-                glm::vec3 p2Model = glm::vec3(vtoM * glm::vec4(p2, 1.0f));
-                glm::vec3 p3Model = glm::vec3(vtoM * glm::vec4(p3, 1.0f));
-
-                box += p0Model;
-                box += p1Model;
-                box += p2Model;
-                box += p3Model;
+            for (auto& chunk : chunks) {
+                if (chunk.hullsValid) {
+                    continue;
+                }
+                chunk.hulls.clear();
+                for (size_t i = 0; i + 2 < chunk.indices.size(); i += 3) {
+                    const PolyVox::Vector3DFloat& v0 = chunk.vertices[chunk.indices[i]].getPosition();
+                    const PolyVox::Vector3DFloat& v1 = chunk.vertices[chunk.indices[i + 1]].getPosition();
+                    const PolyVox::Vector3DFloat& v2 = chunk.vertices[chunk.indices[i + 2]].getPosition();
+                    glm::vec3 p0(v0.getX(), v0.getY(), v0.getZ());
+                    glm::vec3 p1(v1.getX(), v1.getY(), v1.getZ());
+                    glm::vec3 p2(v2.getX(), v2.getY(), v2.getZ());
+
+                    glm::vec3 av = (p0 + p1 + p2) / 3.0f; // center of the triangular face
+                    glm::vec3 normal = glm::normalize(glm::cross(p1 - p0, p2 - p0));
+                    glm::vec3 p3 = av - normal * MARCHING_CUBE_COLLISION_HULL_OFFSET;
 
-                QVector<glm::vec3> pointsInPart;
-                pointsInPart << p0Model;
-                pointsInPart << p1Model;
-                pointsInPart << p2Model;
-                pointsInPart << p3Model;
-                // add next convex hull
-                QVector<glm::vec3> newMeshPoints;
-                pointCollection << newMeshPoints;
-                // add points to the new convex hull
-                pointCollection[i++] << pointsInPart;
+                    QVector<glm::vec3> pointsInPart;
+                    pointsInPart << p0;
+                    pointsInPart << p1;
+                    pointsInPart << p2;
+                    pointsInPart << p3;
+                    // add next convex hull
+                    chunk.hulls << pointsInPart;
+                }
+                chunk.hullsValid = true;
             }
         } else {
-            unsigned int i = 0;
-            polyVoxEntity->forEachVoxelValue(voxelVolumeSize.x, voxelVolumeSize.y, voxelVolumeSize.z,
-                                             [&](int x, int y, int z, uint8_t value) {
-                if (value > 0) {
-                    if ((x > 0 && polyVoxEntity->getVoxelInternal(x - 1, y, z) > 0) &&
-                        (y > 0 && polyVoxEntity->getVoxelInternal(x, y - 1, z) > 0) &&
-                        (z > 0 && polyVoxEntity->getVoxelInternal(x, y, z - 1) > 0) &&
-                        (x < voxelVolumeSize.x - 1 && polyVoxEntity->getVoxelInternal(x + 1, y, z) > 0) &&
-                        (y < voxelVolumeSize.y - 1 && polyVoxEntity->getVoxelInternal(x, y + 1, z) > 0) &&
-                        (z < voxelVolumeSize.z - 1 && polyVoxEntity->getVoxelInternal(x, y, z + 1) > 0)) {
-                        // this voxel has neighbors in every cardinal direction, so there's no need
-                        // to include it in the collision hull.
-                        return;
-                    }
-
-                    QVector<glm::vec3> pointsInPart;
+            float offL = -0.5f;
+            float offH = 0.5f;
+            int edgeOffset = 0;
+            if (voxelSurfaceStyle == PolyVoxEntityItem::SURFACE_EDGED_CUBIC) {
+                offL += 1.0f;
+                offH += 1.0f;
+                edgeOffset = 1;
+            }
 
-                    float offL = -0.5f;
-                    float offH = 0.5f;
-                    if (voxelSurfaceStyle == PolyVoxEntityItem::SURFACE_EDGED_CUBIC) {
-                        offL += 1.0f;
-                        offH += 1.0f;
+            polyVoxEntity->withReadLock([&] {
+                glm::vec3 voxelVolumeSize = polyVoxEntity->_voxelVolumeSize;
+                for (auto& chunk : chunks) {
+                    if (chunk.hullsValid) {
+                        continue;
                     }
-
-                    glm::vec3 p000 = glm::vec3(vtoM * glm::vec4(x + offL, y + offL, z + offL, 1.0f));
-                    glm::vec3 p001 = glm::vec3(vtoM * glm::vec4(x + offL, y + offL, z + offH, 1.0f));
-                    glm::vec3 p010 = glm::vec3(vtoM * glm::vec4(x + offL, y + offH, z + offL, 1.0f));
-                    glm::vec3 p011 = glm::vec3(vtoM * glm::vec4(x + offL, y + offH, z + offH, 1.0f));
-                    glm::vec3 p100 = glm::vec3(vtoM * glm::vec4(x + offH, y + offL, z + offL, 1.0f));
-                    glm::vec3 p101 = glm::vec3(vtoM * glm::vec4(x + offH, y + offL, z + offH, 1.0f));
-                    glm::vec3 p110 = glm::vec3(vtoM * glm::vec4(x + offH, y + offH, z + offL, 1.0f));
-                    glm::vec3 p111 = glm::vec3(vtoM * glm::vec4(x + offH, y + offH, z + offH, 1.0f));
-
-                    box += p000;
-                    box += p001;
-                    box += p010;
-                    box += p011;
-                    box += p100;
-                    box += p101;
-                    box += p110;
-                    box += p111;
-
-                    pointsInPart << p000;
-                    pointsInPart << p001;
-                    pointsInPart << p010;
-                    pointsInPart << p011;
-                    pointsInPart << p100;
-                    pointsInPart << p101;
-                    pointsInPart << p110;
-                    pointsInPart << p111;
-
-                    // add next convex hull
-                    QVector<glm::vec3> newMeshPoints;
-                    pointCollection << newMeshPoints;
-                    // add points to the new convex hull
-                    pointCollection[i++] << pointsInPart;
+                    chunk.hulls.clear();
+
+                    const glm::ivec3& end = chunk.voxelsEnd;
+                    for (int vz = chunk.lowCorner.z; vz < end.z; vz++) {
+                        for (int vy = chunk.lowCorner.y; vy < end.y; vy++) {
+                            for (int vx = chunk.lowCorner.x; vx < end.x; vx++) {
+                                // back to user voxel-coords
+                                int x = vx - edgeOffset;
+                                int y = vy - edgeOffset;
+                                int z = vz - edgeOffset;
+                                if (polyVoxEntity->getVoxelInternal(x, y, z) == 0) {
+                                    continue;
+                                }
+                                if ((x > 0 && polyVoxEntity->getVoxelInternal(x - 1, y, z) > 0) &&
+                                    (y > 0 && polyVoxEntity->getVoxelInternal(x, y - 1, z) > 0) &&
+                                    (z > 0 && polyVoxEntity->getVoxelInternal(x, y, z - 1) > 0) &&
+                                    (x < voxelVolumeSize.x - 1 && polyVoxEntity->getVoxelInternal(x + 1, y, z) > 0) &&
+                                    (y < voxelVolumeSize.y - 1 && polyVoxEntity->getVoxelInternal(x, y + 1, z) > 0) &&
+                                    (z < voxelVolumeSize.z - 1 && polyVoxEntity->getVoxelInternal(x, y, z + 1) > 0)) {
+                                    // this voxel has neighbors in every cardinal direction, so there's no need
+                                    // to include it in the collision hull.
+                                    continue;
+                                }
+
+                                QVector<glm::vec3> pointsInPart;
+                                pointsInPart << glm::vec3(x + offL, y + offL, z + offL);
+                                pointsInPart << glm::vec3(x + offL, y + offL, z + offH);
+                                pointsInPart << glm::vec3(x + offL, y + offH, z + offL);
+                                pointsInPart << glm::vec3(x + offL, y + offH, z + offH);
+                                pointsInPart << glm::vec3(x + offH, y + offL, z + offL);
+                                pointsInPart << glm::vec3(x + offH, y + offL, z + offH);
+                                pointsInPart << glm::vec3(x + offH, y + offH, z + offL);
+                                pointsInPart << glm::vec3(x + offH, y + offH, z + offH);
+                                // add next convex hull
+                                chunk.hulls << pointsInPart;
+                            }
+                        }
+                    }
+                    chunk.hullsValid = true;
                 }
             });
         }
+
+        // gather the hulls of all the chunks into the model frame
+        QVector<QVector<glm::vec3>> pointCollection;
+        AABox box;
+        for (const auto& chunk : chunks) {
+            for (const auto& hull : chunk.hulls) {
+                QVector<glm::vec3> pointsInPart;
+                pointsInPart.reserve(hull.size());
+                for (const auto& point : hull) {
+                    glm::vec3 pointModel = glm::vec3(vtoM * glm::vec4(point, 1.0f));
+                    box += pointModel;
+                    pointsInPart << pointModel;
+                }
+                pointCollection << pointsInPart;
+            }
+        }
         polyVoxEntity->setCollisionPoints(pointCollection, box);
     });
 }
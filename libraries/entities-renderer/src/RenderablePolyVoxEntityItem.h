@@ -14,9 +14,12 @@
 
 #include <QSemaphore>
 #include <atomic>
+#include <mutex>
+#include <vector>
 
 #include <PolyVoxCore/SimpleVolume.h>
 #include <PolyVoxCore/Raycast.h>
+#include <PolyVoxCore/SurfaceMesh.h>
 
 #include <TextureCache.h>
 
@@ -163,6 +166,28 @@ private:
     bool _volDataDirty = false; // does getMesh need to be called?
     int _onCount; // how many non-zero voxels are in _volData
 
+    // the bounds of the voxels changed since the mesh was last extracted, in _volData coords
+    bool _remeshAll { true };
+    bool _hasDirtyVoxels { false };
+    glm::ivec3 _dirtyVoxelsLow;
+    glm::ivec3 _dirtyVoxelsHigh;
+    void markVoxelDirty(int x, int y, int z);
+
+    // The mesh and collision hulls of a MESH_CHUNK_SIZE region of _volData, in voxel coords
+    struct MeshChunk {
+        glm::ivec3 lowCorner;
+        glm::ivec3 highCorner; // inclusive, shared with the next chunk
+        glm::ivec3 voxelsEnd; // exclusive end of the voxels this chunk makes hulls for
+        std::vector<PolyVox::PositionMaterialNormal> vertices;
+        std::vector<uint32_t> indices;
+        bool hullsValid { false };
+        ShapeInfo::PointCollection hulls;
+    };
+    std::mutex _meshChunksMutex;
+    std::vector<MeshChunk> _meshChunks;
+    glm::ivec3 _meshChunkCounts;
+    PolyVoxSurfaceStyle _meshChunksSurfaceStyle { PolyVoxEntityItem::SURFACE_MARCHING_CUBES };
+
     bool _neighborsNeedUpdate { false };
 
     bool updateOnCount(int x, int y, int z, uint8_t toValue);
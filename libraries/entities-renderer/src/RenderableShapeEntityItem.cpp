@@ -65,9 +65,7 @@ EntityItemPointer RenderableShapeEntityItem::sphereFactory(const EntityItemID& e
 void RenderableShapeEntityItem::setUserData(const QString& value) {
     if (value != getUserData()) {
         ShapeEntityItem::setUserData(value);
-        if (_procedural) {
-            _procedural->parse(value);
-        }
+        _proceduralDataDirty = true;
     }
 }
 
@@ -96,7 +94,10 @@ void RenderableShapeEntityItem::render(RenderArgs* args) {
         _procedural->_opaqueState->setBlendFunction(false,
             gpu::State::SRC_ALPHA, gpu::State::BLEND_OP_ADD, gpu::State::INV_SRC_ALPHA,
             gpu::State::FACTOR_ALPHA, gpu::State::BLEND_OP_ADD, gpu::State::ONE);
+    } else if (_proceduralDataDirty) {
+        _procedural->parse(getUserData());
     }
+    _proceduralDataDirty = false;
 
     gpu::Batch& batch = *args->_batch;
     glm::vec4 color(toGlm(getXColor()), getLocalRenderAlpha());
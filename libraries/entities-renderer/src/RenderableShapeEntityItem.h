@@ -30,6 +30,7 @@ public:
 
 private:
     std::unique_ptr<Procedural> _procedural { nullptr };
+    bool _proceduralDataDirty { false }; // the user data is only parsed when the shape is rendered
 
     SIMPLE_RENDERABLE();
 };
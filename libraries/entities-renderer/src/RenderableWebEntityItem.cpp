@@ -30,11 +30,22 @@
 
 const float METERS_TO_INCHES = 39.3701f;
 static uint32_t _currentWebCount { 0 };
-// Don't allow more than 100 concurrent web views
-static const uint32_t MAX_CONCURRENT_WEB_VIEWS = 100;
+// Don't allow more than 20 concurrent web views, the distant ones hibernate so only the nearby ones count
+static const uint32_t MAX_CONCURRENT_WEB_VIEWS = 20;
 // If a web-view hasn't been rendered for 30 seconds, de-allocate the framebuffer
 static uint64_t MAX_NO_RENDER_INTERVAL = 30 * USECS_PER_SECOND;
 
+// The distances below are in multiples of the largest side of the web entity, so they follow its size on screen.
+// Closer than this the web view renders at its full rate, past it the rate falls off with the distance
+static const float FULL_RATE_RELATIVE_DISTANCE = 3.0f;
+static const float MAX_WEB_FPS = 10.0f;
+static const float MIN_WEB_FPS = 1.0f;
+// Past this the web view is destroyed and its last frame is drawn in its place, it is rebuilt when closer
+// than the wake distance
+static const float HIBERNATE_RELATIVE_DISTANCE = 20.0f;
+static const float WAKE_RELATIVE_DISTANCE = 15.0f;
+static const float MIN_RELATIVE_DISTANCE_SIZE = 0.01f;
+
 static int MAX_WINDOW_SIZE = 4096;
 static float OPAQUE_ALPHA_THRESHOLD = 0.99f;
 
@@ -106,9 +117,8 @@ bool RenderableWebEntityItem::buildWebSurface(QSharedPointer<EntityTreeRenderer>
     };
     _webSurface = QSharedPointer<OffscreenQmlSurface>(new OffscreenQmlSurface(), deleter);
 
-    // FIXME, the max FPS could be better managed by being dynamic (based on the number of current surfaces
-    // and the current rendering load)
-    _webSurface->setMaxFps(10);
+    // The max FPS is lowered with the distance at render time
+    _webSurface->setMaxFps((uint8_t)MAX_WEB_FPS);
 
     // The lifetime of the QML surface MUST be managed by the main thread
     // Additionally, we MUST use local variables copied by value, rather than
@@ -190,32 +200,50 @@ void RenderableWebEntityItem::render(RenderArgs* args) {
     }
     #endif
 
-    if (!_webSurface) {
+    glm::vec3 dimensions = getDimensions();
+    float viewDistance = glm::distance(args->getViewFrustum().getPosition(), getPosition());
+    float relativeDistance = viewDistance / glm::max(glm::max(dimensions.x, dimensions.y), MIN_RELATIVE_DISTANCE_SIZE);
+
+    // A hibernating web entity keeps drawing the last frame of its web view, which
+    // the texture holds on to after the surface is gone
+    if (_webSurface && relativeDistance > HIBERNATE_RELATIVE_DISTANCE && !_pressed) {
+        qCDebug(entitiesrenderer) << "Hibernating web entity" << getID();
+        destroyWebSurface();
+    }
+
+    if (!_webSurface && relativeDistance < WAKE_RELATIVE_DISTANCE) {
         auto renderer = qSharedPointerCast<EntityTreeRenderer>(args->_renderer);
-        if (!buildWebSurface(renderer)) {
-            return;
+        if (buildWebSurface(renderer) && !_texture) {
+            _fadeStartTime = usecTimestampNow();
         }
-        _fadeStartTime = usecTimestampNow();
+    }
+
+    if (!_webSurface && !_texture) {
+        return;
     }
 
     _lastRenderTime = usecTimestampNow();
 
-    glm::vec2 windowSize = getWindowSize();
+    if (_webSurface) {
+        glm::vec2 windowSize = getWindowSize();
 
-    // The offscreen surface is idempotent for resizes (bails early
-    // if it's a no-op), so it's safe to just call resize every frame
-    // without worrying about excessive overhead.
-    _webSurface->resize(QSize(windowSize.x, windowSize.y));
+        // The offscreen surface is idempotent for resizes (bails early
+        // if it's a no-op), so it's safe to just call resize every frame
+        // without worrying about excessive overhead.
+        _webSurface->resize(QSize(windowSize.x, windowSize.y));
 
-    if (!_texture) {
-        auto webSurface = _webSurface;
-        _texture = gpu::TexturePointer(gpu::Texture::createExternal2D(OffscreenQmlSurface::getDiscardLambda()));
-        _texture->setSource(__FUNCTION__);
-    }
-    OffscreenQmlSurface::TextureAndFence newTextureAndFence;
-    bool newTextureAvailable = _webSurface->fetchTexture(newTextureAndFence);
-    if (newTextureAvailable) {
-        _texture->setExternalTexture(newTextureAndFence.first, newTextureAndFence.second);
+        float fps = MAX_WEB_FPS * FULL_RATE_RELATIVE_DISTANCE / glm::max(relativeDistance, FULL_RATE_RELATIVE_DISTANCE);
+        _webSurface->setMaxFps((uint8_t)glm::max(fps, MIN_WEB_FPS));
+
+        if (!_texture) {
+            _texture = gpu::TexturePointer(gpu::Texture::createExternal2D(OffscreenQmlSurface::getDiscardLambda()));
+            _texture->setSource(__FUNCTION__);
+        }
+        OffscreenQmlSurface::TextureAndFence newTextureAndFence;
+        bool newTextureAvailable = _webSurface->fetchTexture(newTextureAndFence);
+        if (newTextureAvailable) {
+            _texture->setExternalTexture(newTextureAndFence.first, newTextureAndFence.second);
+        }
     }
 
     PerformanceTimer perfTimer("RenderableWebEntityItem::render");
@@ -363,6 +391,8 @@ void RenderableWebEntityItem::update(const quint64& now) {
     auto interval = now - _lastRenderTime;
     if (interval > MAX_NO_RENDER_INTERVAL) {
         destroyWebSurface();
+        // nobody is looking at the last frame either
+        _texture.reset();
     }
 }
 
@@ -43,7 +43,7 @@ public:
     void handlePointerEvent(const PointerEvent& event);
 
     void update(const quint64& now) override;
-    bool needsToCallUpdate() const override { return _webSurface != nullptr; }
+    bool needsToCallUpdate() const override { return _webSurface != nullptr || _texture != nullptr; }
 
     virtual void emitScriptEvent(const QVariant& message) override;
 
@@ -37,6 +37,8 @@ int EntityItem::_maxActionsDataSize = 800;
 quint64 EntityItem::_rememberDeletedActionTime = 20 * USECS_PER_SECOND;
 std::function<bool()> EntityItem::_entitiesShouldFadeFunction = [](){ return true; };
 
+static const quint64 MAX_MOTION_ONLY_SEND_PERIOD = 10 * USECS_PER_SECOND;
+
 EntityItem::EntityItem(const EntityItemID& entityItemID) :
     SpatiallyNestable(NestableType::Entity, entityItemID),
     _type(EntityTypes::Unknown),
@@ -147,6 +149,38 @@ EntityPropertyFlags EntityItem::getEntityProperties(EncodeBitstreamParams& param
     return requestedProperties;
 }
 
+const EntityPropertyFlags& EntityItem::getMotionProperties() {
+    static const EntityPropertyFlags motionProperties = [] {
+        EntityPropertyFlags properties;
+        properties += PROP_SIMULATION_OWNER;
+        properties += PROP_POSITION;
+        properties += PROP_ROTATION;
+        properties += PROP_VELOCITY;
+        properties += PROP_ANGULAR_VELOCITY;
+        properties += PROP_ACCELERATION;
+        properties += PROP_QUERY_AA_CUBE;
+        return properties;
+    }();
+    return motionProperties;
+}
+
+bool EntityItem::changesMoreThanMotion(const EntityItemProperties& properties) const {
+    EntityPropertyFlags changedProperties = properties.getChangedProperties() - getMotionProperties();
+
+    // the simulation owner repeats these with every update, they only count when they are different
+    if (properties.getClientOnly() == getClientOnly()) {
+        changedProperties -= PROP_CLIENT_ONLY;
+    }
+    if (properties.getOwningAvatarID() == getOwningAvatarID()) {
+        changedProperties -= PROP_OWNING_AVATAR_ID;
+    }
+    if (properties.getLastEditedBy() == getLastEditedBy()) {
+        changedProperties -= PROP_LAST_EDITED_BY;
+    }
+    bool onlyMotionChanged = !changedProperties;
+    return !onlyMotionChanged;
+}
+
 OctreeElement::AppendState EntityItem::appendEntityData(OctreePacketData* packetData, EncodeBitstreamParams& params,
                                             EntityTreeElementExtraEncodeData* entityTreeElementExtraEncodeData) const {
 
@@ -181,17 +215,55 @@ OctreeElement::AppendState EntityItem::appendEntityData(OctreePacketData* packet
     EntityPropertyFlags propertyFlags(PROP_LAST_ITEM);
     EntityPropertyFlags requestedProperties = getEntityProperties(params);
     EntityPropertyFlags propertiesDidntFit = requestedProperties;
+    bool isEncodingAllProperties = true;
+    bool isEncodingMotionOnly = false;
 
     // If we are being called for a subsequent pass at appendEntityData() that failed to completely encode this item,
     // then our entityTreeElementExtraEncodeData should include data about which properties we need to append.
     if (entityTreeElementExtraEncodeData && entityTreeElementExtraEncodeData->entities.contains(getEntityItemID())) {
         requestedProperties = entityTreeElementExtraEncodeData->entities.value(getEntityItemID());
+        isEncodingAllProperties = requestedProperties == propertiesDidntFit;
+    } else {
+        // If the viewer was sent all of our properties since the last edit that changed more than our motion, then it
+        // only needs the motion properties. Lost packets are re-sent when the viewer NACKs them, and every so often
+        // we send everything again anyway, in case a viewer missed one for good.
+        quint64 lastSentAllData = params.getLastSentAllData(getID());
+        if (_nonMotionChangedOnServer < lastSentAllData
+            && usecTimestampNow() - lastSentAllData < MAX_MOTION_ONLY_SEND_PERIOD) {
+            requestedProperties &= getMotionProperties();
+            propertiesDidntFit = requestedProperties;
+            isEncodingAllProperties = false;
+            isEncodingMotionOnly = true;
+        }
     }
 
-    LevelDetails entityLevel = packetData->startLevel();
-
     quint64 lastEdited = getLastEdited();
 
+    // the timestamps are read before we encode, so an edit that lands while we do leaves a stale cache entry behind
+    EncodeCache encodeStamp;
+    encodeStamp.lastEdited = lastEdited;
+    encodeStamp.lastUpdated = getLastUpdated();
+    encodeStamp.lastSimulated = getLastSimulated();
+    encodeStamp.changedOnServer = getLastChangedOnServer();
+
+    if (isEncodingAllProperties || isEncodingMotionOnly) {
+        std::lock_guard<std::mutex> lock(_encodeCacheMutex);
+        const EncodeCache& encodeCache = isEncodingMotionOnly ? _motionEncodeCache : _encodeCache;
+        if (!encodeCache.bytes.isEmpty()
+            && encodeCache.lastEdited == encodeStamp.lastEdited
+            && encodeCache.lastUpdated == encodeStamp.lastUpdated
+            && encodeCache.lastSimulated == encodeStamp.lastSimulated
+            && encodeCache.changedOnServer == encodeStamp.changedOnServer
+            && packetData->appendRawData(encodeCache.bytes)) {
+            // another client already had us encoded and it fit, if it doesn't fit we encode what does below
+            params.trackSend(getID(), lastEdited, isEncodingAllProperties);
+            return appendState;
+        }
+    }
+
+    int entityStartOffset = packetData->getUncompressedByteOffset();
+    LevelDetails entityLevel = packetData->startLevel();
+
     #ifdef WANT_DEBUG
         float editedAgo = getEditedAgo();
         QString agoAsString = formatSecondsElapsed(editedAgo);
@@ -313,6 +385,18 @@ OctreeElement::AppendState EntityItem::appendEntityData(OctreePacketData* packet
             assert(newPropertyFlagsLength == oldPropertyFlagsLength); // should not have grown
         }
 
+        if ((isEncodingAllProperties || isEncodingMotionOnly) && appendState == OctreeElement::COMPLETED) {
+            encodeStamp.bytes = QByteArray((const char*)packetData->getUncompressedData(entityStartOffset),
+                                           packetData->getUncompressedSize() - entityStartOffset);
+
+            std::lock_guard<std::mutex> lock(_encodeCacheMutex);
+            if (isEncodingMotionOnly) {
+                _motionEncodeCache = encodeStamp;
+            } else {
+                _encodeCache = encodeStamp;
+            }
+        }
+
         packetData->endLevel(entityLevel);
     } else {
         packetData->discardLevel(entityLevel);
@@ -327,7 +411,7 @@ OctreeElement::AppendState EntityItem::appendEntityData(OctreePacketData* packet
 
     // if any part of our entity was sent, call trackSend
     if (appendState != OctreeElement::NONE) {
-        params.trackSend(getID(), getLastEdited());
+        params.trackSend(getID(), getLastEdited(), isEncodingAllProperties && appendState == OctreeElement::COMPLETED);
     }
 
     return appendState;
@@ -351,6 +435,30 @@ int EntityItem::expectedBytes() {
 
 
 // clients use this method to unpack FULL updates from entity-server
+// true when the flags only hold the simulation owner and the motion properties, as in the updates of moving entities
+static bool isTerseUpdate(const EntityPropertyFlags& propertyFlags) {
+    if (propertyFlags.lastFlag() < propertyFlags.firstFlag()) {
+        return false;
+    }
+    for (int flag = propertyFlags.firstFlag(); flag <= propertyFlags.lastFlag(); ++flag) {
+        if (!propertyFlags.getHasProperty((EntityPropertyList)flag)) {
+            continue;
+        }
+        switch (flag) {
+            case PROP_SIMULATION_OWNER:
+            case PROP_POSITION:
+            case PROP_ROTATION:
+            case PROP_VELOCITY:
+            case PROP_ANGULAR_VELOCITY:
+            case PROP_ACCELERATION:
+                break;
+            default:
+                return false;
+        }
+    }
+    return true;
+}
+
 int EntityItem::readEntityDataFromBuffer(const unsigned char* data, int bytesLeftToRead, ReadBitstreamToTreeParams& args) {
     if (args.bitstreamVersion < VERSION_ENTITIES_SUPPORT_SPLIT_MTU) {
 
@@ -768,49 +876,52 @@ int EntityItem::readEntityDataFromBuffer(const unsigned char* data, int bytesLef
 
     }
 
-    READ_ENTITY_PROPERTY(PROP_DIMENSIONS, glm::vec3, updateDimensions);
-    READ_ENTITY_PROPERTY(PROP_DENSITY, float, updateDensity);
-    READ_ENTITY_PROPERTY(PROP_GRAVITY, glm::vec3, updateGravity);
-
-    READ_ENTITY_PROPERTY(PROP_DAMPING, float, updateDamping);
-    READ_ENTITY_PROPERTY(PROP_RESTITUTION, float, updateRestitution);
-    READ_ENTITY_PROPERTY(PROP_FRICTION, float, updateFriction);
-    READ_ENTITY_PROPERTY(PROP_LIFETIME, float, updateLifetime);
-    READ_ENTITY_PROPERTY(PROP_SCRIPT, QString, setScript);
-    READ_ENTITY_PROPERTY(PROP_SCRIPT_TIMESTAMP, quint64, setScriptTimestamp);
-    READ_ENTITY_PROPERTY(PROP_REGISTRATION_POINT, glm::vec3, updateRegistrationPoint);
+    // a terse update only moves the entity, so the rest of the properties and the subclass are not even looked at
+    if (!isTerseUpdate(propertyFlags)) {
+        READ_ENTITY_PROPERTY(PROP_DIMENSIONS, glm::vec3, updateDimensions);
+        READ_ENTITY_PROPERTY(PROP_DENSITY, float, updateDensity);
+        READ_ENTITY_PROPERTY(PROP_GRAVITY, glm::vec3, updateGravity);
 
-    READ_ENTITY_PROPERTY(PROP_ANGULAR_DAMPING, float, updateAngularDamping);
-    READ_ENTITY_PROPERTY(PROP_VISIBLE, bool, setVisible);
-    READ_ENTITY_PROPERTY(PROP_COLLISIONLESS, bool, updateCollisionless);
-    READ_ENTITY_PROPERTY(PROP_COLLISION_MASK, uint8_t, updateCollisionMask);
-    READ_ENTITY_PROPERTY(PROP_DYNAMIC, bool, updateDynamic);
-    READ_ENTITY_PROPERTY(PROP_LOCKED, bool, setLocked);
-    READ_ENTITY_PROPERTY(PROP_USER_DATA, QString, setUserData);
+        READ_ENTITY_PROPERTY(PROP_DAMPING, float, updateDamping);
+        READ_ENTITY_PROPERTY(PROP_RESTITUTION, float, updateRestitution);
+        READ_ENTITY_PROPERTY(PROP_FRICTION, float, updateFriction);
+        READ_ENTITY_PROPERTY(PROP_LIFETIME, float, updateLifetime);
+        READ_ENTITY_PROPERTY(PROP_SCRIPT, QString, setScript);
+        READ_ENTITY_PROPERTY(PROP_SCRIPT_TIMESTAMP, quint64, setScriptTimestamp);
+        READ_ENTITY_PROPERTY(PROP_REGISTRATION_POINT, glm::vec3, updateRegistrationPoint);
 
-    if (args.bitstreamVersion >= VERSION_ENTITIES_HAS_MARKETPLACE_ID) {
-        READ_ENTITY_PROPERTY(PROP_MARKETPLACE_ID, QString, setMarketplaceID);
-    }
+        READ_ENTITY_PROPERTY(PROP_ANGULAR_DAMPING, float, updateAngularDamping);
+        READ_ENTITY_PROPERTY(PROP_VISIBLE, bool, setVisible);
+        READ_ENTITY_PROPERTY(PROP_COLLISIONLESS, bool, updateCollisionless);
+        READ_ENTITY_PROPERTY(PROP_COLLISION_MASK, uint8_t, updateCollisionMask);
+        READ_ENTITY_PROPERTY(PROP_DYNAMIC, bool, updateDynamic);
+        READ_ENTITY_PROPERTY(PROP_LOCKED, bool, setLocked);
+        READ_ENTITY_PROPERTY(PROP_USER_DATA, QString, setUserData);
 
-    READ_ENTITY_PROPERTY(PROP_NAME, QString, setName);
-    READ_ENTITY_PROPERTY(PROP_COLLISION_SOUND_URL, QString, setCollisionSoundURL);
-    READ_ENTITY_PROPERTY(PROP_HREF, QString, setHref);
-    READ_ENTITY_PROPERTY(PROP_DESCRIPTION, QString, setDescription);
-    READ_ENTITY_PROPERTY(PROP_ACTION_DATA, QByteArray, setActionData);
+        if (args.bitstreamVersion >= VERSION_ENTITIES_HAS_MARKETPLACE_ID) {
+            READ_ENTITY_PROPERTY(PROP_MARKETPLACE_ID, QString, setMarketplaceID);
+        }
 
-    {   // parentID and parentJointIndex are also protected by simulation ownership
-        bool oldOverwrite = overwriteLocalData;
-        overwriteLocalData = overwriteLocalData && !weOwnSimulation;
-        READ_ENTITY_PROPERTY(PROP_PARENT_ID, QUuid, setParentID);
-        READ_ENTITY_PROPERTY(PROP_PARENT_JOINT_INDEX, quint16, setParentJointIndex);
-        overwriteLocalData = oldOverwrite;
-    }
+        READ_ENTITY_PROPERTY(PROP_NAME, QString, setName);
+        READ_ENTITY_PROPERTY(PROP_COLLISION_SOUND_URL, QString, setCollisionSoundURL);
+        READ_ENTITY_PROPERTY(PROP_HREF, QString, setHref);
+        READ_ENTITY_PROPERTY(PROP_DESCRIPTION, QString, setDescription);
+        READ_ENTITY_PROPERTY(PROP_ACTION_DATA, QByteArray, setActionData);
+
+        {   // parentID and parentJointIndex are also protected by simulation ownership
+            bool oldOverwrite = overwriteLocalData;
+            overwriteLocalData = overwriteLocalData && !weOwnSimulation;
+            READ_ENTITY_PROPERTY(PROP_PARENT_ID, QUuid, setParentID);
+            READ_ENTITY_PROPERTY(PROP_PARENT_JOINT_INDEX, quint16, setParentJointIndex);
+            overwriteLocalData = oldOverwrite;
+        }
 
-    READ_ENTITY_PROPERTY(PROP_QUERY_AA_CUBE, AACube, setQueryAACube);
-    READ_ENTITY_PROPERTY(PROP_LAST_EDITED_BY, QUuid, setLastEditedBy);
+        READ_ENTITY_PROPERTY(PROP_QUERY_AA_CUBE, AACube, setQueryAACube);
+        READ_ENTITY_PROPERTY(PROP_LAST_EDITED_BY, QUuid, setLastEditedBy);
 
-    bytesRead += readEntitySubclassDataFromBuffer(dataAt, (bytesLeftToRead - bytesRead), args,
-                                                  propertyFlags, overwriteLocalData, somethingChanged);
+        bytesRead += readEntitySubclassDataFromBuffer(dataAt, (bytesLeftToRead - bytesRead), args,
+                                                      propertyFlags, overwriteLocalData, somethingChanged);
+    }
 
     ////////////////////////////////////
     // WARNING: Do not add stream content here after the subclass. Always add it before the subclass
@@ -948,6 +1059,11 @@ SharedSoundPointer EntityItem::getCollisionSound() {
 }
 
 void EntityItem::simulate(const quint64& now) {
+    float timeElapsed = beginSimulationStep(now);
+    endSimulationStep(now, stepKinematicMotion(timeElapsed));
+}
+
+float EntityItem::beginSimulationStep(const quint64& now) {
     if (_lastSimulated == 0) {
         _lastSimulated = now;
     }
@@ -993,7 +1109,11 @@ void EntityItem::simulate(const quint64& now) {
         qCDebug(entities) << "     ********** EntityItem::simulate() .... SETTING _lastSimulated=" << _lastSimulated;
     #endif
 
-    if (!stepKinematicMotion(timeElapsed)) {
+    return timeElapsed;
+}
+
+void EntityItem::endSimulationStep(const quint64& now, bool isMoving) {
+    if (!isMoving) {
         // this entity is no longer moving
         // flag it to transition from KINEMATIC to STATIC
         _dirtyFlags |= Simulation::DIRTY_MOTION_TYPE;
@@ -1009,6 +1129,41 @@ bool EntityItem::stepKinematicMotion(float timeElapsed) {
     glm::vec3 angularVelocity;
     getLocalTransformAndVelocities(transform, linearVelocity, angularVelocity);
 
+    glm::vec3 position = transform.getTranslation();
+    glm::quat rotation = transform.getRotation();
+    if (!integrateKinematicMotion(timeElapsed, _damping, _angularDamping, getLocalAcceleration(),
+                                  position, rotation, linearVelocity, angularVelocity)) {
+        return false;
+    }
+
+    transform.setTranslation(position);
+    if (rotation != transform.getRotation()) {
+        transform.setRotation(rotation);
+    }
+    setLocalTransformAndVelocities(transform, linearVelocity, angularVelocity);
+
+    return true;
+}
+
+static const float MIN_KINEMATIC_LINEAR_ACCELERATION_SQUARED = 1.0e-4f; // 0.01 m/sec^2
+
+glm::vec3 EntityItem::getLocalAcceleration() const {
+    if (glm::length2(_acceleration) <= MIN_KINEMATIC_LINEAR_ACCELERATION_SQUARED) {
+        return Vectors::ZERO;
+    }
+    // acceleration is in world-frame but we need it in local-frame
+    glm::vec3 linearAcceleration = _acceleration;
+    bool success;
+    Transform parentTransform = getParentTransform(success);
+    if (success) {
+        linearAcceleration = glm::inverse(parentTransform.getRotation()) * linearAcceleration;
+    }
+    return linearAcceleration;
+}
+
+bool EntityItem::integrateKinematicMotion(float timeElapsed, float damping, float angularDamping,
+                                          const glm::vec3& localAcceleration, glm::vec3& position, glm::quat& rotation,
+                                          glm::vec3& linearVelocity, glm::vec3& angularVelocity) {
     // find out if it is moving
     bool isSpinning = (glm::length2(angularVelocity) > 0.0f);
     float linearSpeedSquared = glm::length2(linearVelocity);
@@ -1032,8 +1187,8 @@ bool EntityItem::stepKinematicMotion(float timeElapsed) {
 
     if (isSpinning) {
         // angular damping
-        if (_angularDamping > 0.0f) {
-            angularVelocity *= powf(1.0f - _angularDamping, timeElapsed);
+        if (angularDamping > 0.0f) {
+            angularVelocity *= powf(1.0f - angularDamping, timeElapsed);
         }
 
         const float MIN_KINEMATIC_ANGULAR_SPEED_SQUARED =
@@ -1043,39 +1198,28 @@ bool EntityItem::stepKinematicMotion(float timeElapsed) {
         } else {
             // for improved agreement with the way Bullet integrates rotations we use an approximation
             // and break the integration into bullet-sized substeps
-            glm::quat rotation = transform.getRotation();
             float dt = timeElapsed;
             while (dt > 0.0f) {
                 glm::quat  dQ = computeBulletRotationStep(angularVelocity, glm::min(dt, PHYSICS_ENGINE_FIXED_SUBSTEP));
                 rotation = glm::normalize(dQ * rotation);
                 dt -= PHYSICS_ENGINE_FIXED_SUBSTEP;
             }
-            transform.setRotation(rotation);
         }
     }
 
-    glm::vec3 position = transform.getTranslation();
     const float MIN_KINEMATIC_LINEAR_SPEED_SQUARED =
         KINEMATIC_LINEAR_SPEED_THRESHOLD * KINEMATIC_LINEAR_SPEED_THRESHOLD;
     if (isTranslating) {
         glm::vec3 deltaVelocity = Vectors::ZERO;
 
         // linear damping
-        if (_damping > 0.0f) {
-            deltaVelocity = (powf(1.0f - _damping, timeElapsed) - 1.0f) * linearVelocity;
+        if (damping > 0.0f) {
+            deltaVelocity = (powf(1.0f - damping, timeElapsed) - 1.0f) * linearVelocity;
         }
 
-        const float MIN_KINEMATIC_LINEAR_ACCELERATION_SQUARED = 1.0e-4f; // 0.01 m/sec^2
-        if (glm::length2(_acceleration) > MIN_KINEMATIC_LINEAR_ACCELERATION_SQUARED) {
+        if (glm::length2(localAcceleration) > MIN_KINEMATIC_LINEAR_ACCELERATION_SQUARED) {
             // yes acceleration
-            // acceleration is in world-frame but we need it in local-frame
-            glm::vec3 linearAcceleration = _acceleration;
-            bool success;
-            Transform parentTransform = getParentTransform(success);
-            if (success) {
-                linearAcceleration = glm::inverse(parentTransform.getRotation()) * linearAcceleration;
-            }
-            deltaVelocity += linearAcceleration * timeElapsed;
+            deltaVelocity += localAcceleration * timeElapsed;
 
             if (linearSpeedSquared < MIN_KINEMATIC_LINEAR_SPEED_SQUARED
                     && glm::length2(deltaVelocity) < MIN_KINEMATIC_LINEAR_SPEED_SQUARED
@@ -1101,9 +1245,6 @@ bool EntityItem::stepKinematicMotion(float timeElapsed) {
         }
     }
 
-    transform.setTranslation(position);
-    setLocalTransformAndVelocities(transform, linearVelocity, angularVelocity);
-
     return true;
 }
 
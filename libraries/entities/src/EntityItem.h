@@ -13,6 +13,7 @@
 #define hifi_EntityItem_h
 
 #include <memory>
+#include <mutex>
 #include <stdint.h>
 
 #include <glm/glm.hpp>
@@ -116,6 +117,12 @@ public:
     void markAsChangedOnServer() { _changedOnServer = usecTimestampNow();  }
     quint64 getLastChangedOnServer() const { return _changedOnServer; }
 
+    // A viewer that already has every other property of the entity is only sent the motion properties, so the server
+    // marks the edits that change anything else.
+    static const EntityPropertyFlags& getMotionProperties();
+    bool changesMoreThanMotion(const EntityItemProperties& properties) const;
+    void markAsNonMotionChangedOnServer() { _nonMotionChangedOnServer = usecTimestampNow(); }
+
     // TODO: eventually only include properties changed since the params.lastViewFrustumSent time
     virtual EntityPropertyFlags getEntityProperties(EncodeBitstreamParams& params) const;
 
@@ -159,6 +166,14 @@ public:
     void simulate(const quint64& now);
     bool stepKinematicMotion(float timeElapsed); // return 'true' if moving
 
+    // simulate() in parts, so that EntitySimulation can integrate many entities at once from packed copies of their state
+    float beginSimulationStep(const quint64& now); // returns the seconds to step
+    void endSimulationStep(const quint64& now, bool isMoving);
+    glm::vec3 getLocalAcceleration() const; // acceleration in the parent frame, zero if it is too small to integrate
+    static bool integrateKinematicMotion(float timeElapsed, float damping, float angularDamping,
+                                         const glm::vec3& localAcceleration, glm::vec3& position, glm::quat& rotation,
+                                         glm::vec3& linearVelocity, glm::vec3& angularVelocity); // return 'true' if moving
+
     virtual bool needsToCallUpdate() const { return false; }
 
     virtual void debugDump() const;
@@ -417,6 +432,8 @@ public:
 
     virtual int getJointIndex(const QString& name) const { return -1; }
     virtual QStringList getJointNames() const { return QStringList(); }
+    // a copy of the joint names that can be read from any thread, empty until the renderer has set one
+    virtual QStringList getCachedJointNames() const { return QStringList(); }
 
     virtual void loader() {} // called indirectly when urls for geometry are updated
 
@@ -585,6 +602,21 @@ protected:
     quint64 _fadeStartTime { usecTimestampNow() };
     static std::function<bool()> _entitiesShouldFadeFunction;
     bool _isFading { _entitiesShouldFadeFunction() };
+
+    // The encoding of all of our properties is the same for every client, so the send threads of the entity server
+    // share it through appendEntityData until one of the timestamps it was encoded at changes.
+    struct EncodeCache {
+        quint64 lastEdited { 0 };
+        quint64 lastUpdated { 0 };
+        quint64 lastSimulated { 0 };
+        quint64 changedOnServer { 0 };
+        QByteArray bytes;
+    };
+    mutable std::mutex _encodeCacheMutex;
+    mutable EncodeCache _encodeCache;
+    mutable EncodeCache _motionEncodeCache;
+
+    quint64 _nonMotionChangedOnServer { 0 };
 };
 
 #endif // hifi_EntityItem_h
@@ -68,6 +68,12 @@ public:
     EntityItemProperties(EntityPropertyFlags desiredProperties = EntityPropertyFlags());
     virtual ~EntityItemProperties() = default;
 
+    // the declared destructor would otherwise turn every move, like the returns and the QVector growth, into a copy
+    EntityItemProperties(const EntityItemProperties& other) = default;
+    EntityItemProperties(EntityItemProperties&& other) = default;
+    EntityItemProperties& operator=(const EntityItemProperties& other) = default;
+    EntityItemProperties& operator=(EntityItemProperties&& other) = default;
+
     void merge(const EntityItemProperties& other);
 
     EntityTypes::EntityType getType() const { return _type; }
@@ -247,6 +253,7 @@ public:
 
     bool localRenderAlphaChanged() const { return _localRenderAlphaChanged; }
 
+    QUuid getID() const { return _id; }
     void clearID() { _id = UNKNOWN_ENTITY_ID; _idSet = false; }
     void markAllChanged();
 
@@ -223,6 +223,11 @@ inline QByteArray QByteArray_convertFromScriptValue(const QScriptValue& v, bool&
 
 inline glmVec3 glmVec3_convertFromScriptValue(const QScriptValue& v, bool& isValid) { 
     isValid = false; /// assume it can't be converted
+    glm::vec3 arrayValue;
+    if (numbersFromScriptArray(v, &arrayValue.x, 3)) {
+        isValid = !glm::isnan(arrayValue.x) && !glm::isnan(arrayValue.y) && !glm::isnan(arrayValue.z);
+        return isValid ? arrayValue : glm::vec3(0);
+    }
     QScriptValue x = v.property("x");
     QScriptValue y = v.property("y");
     QScriptValue z = v.property("z");
@@ -294,6 +299,14 @@ inline glmQuat glmQuat_convertFromScriptValue(const QScriptValue& v, bool& isVal
 inline xColor xColor_convertFromScriptValue(const QScriptValue& v, bool& isValid) { 
     xColor newValue { 255, 255, 255 };
     isValid = false; /// assume it can't be converted
+    float rgb[3];
+    if (numbersFromScriptArray(v, rgb, 3)) {
+        newValue.red = (uint8_t)rgb[0];
+        newValue.green = (uint8_t)rgb[1];
+        newValue.blue = (uint8_t)rgb[2];
+        isValid = true;
+        return newValue;
+    }
     QScriptValue r = v.property("red");
     QScriptValue g = v.property("green");
     QScriptValue b = v.property("blue");
@@ -10,6 +10,8 @@
 //
 #include "EntityScriptingInterface.h"
 
+#include <QtCore/QThreadPool>
+
 #include "EntityItemID.h"
 #include <VariantMapToScriptValue.h>
 #include <SharedUtil.h>
@@ -26,6 +28,24 @@
 #include "SimulationOwner.h"
 #include "ZoneEntityItem.h"
 
+// results of asynchronous picks are queued across threads
+static int rayToEntityIntersectionResultMetaTypeId = qRegisterMetaType<RayToEntityIntersectionResult>();
+
+class RayPickTask : public QRunnable {
+public:
+    RayPickTask(std::function<RayToEntityIntersectionResult()> pick, RayPickCallback* callback) :
+        _pick(pick), _callback(callback) {}
+
+    virtual void run() override {
+        RayToEntityIntersectionResult result = _pick();
+        QMetaObject::invokeMethod(_callback, "deliverResult", Qt::QueuedConnection,
+            Q_ARG(RayToEntityIntersectionResult, result));
+    }
+
+private:
+    std::function<RayToEntityIntersectionResult()> _pick;
+    RayPickCallback* _callback;
+};
 
 EntityScriptingInterface::EntityScriptingInterface(bool bidOnSimulationOwnership) :
     _entityTree(NULL),
@@ -79,92 +99,98 @@ void EntityScriptingInterface::setEntityTree(EntityTreePointer elementTree) {
     }
 }
 
-EntityItemProperties convertLocationToScriptSemantics(const EntityItemProperties& entitySideProperties) {
+// the conversions work in place, so that the script paths don't copy every property of an entity to move a few
+static void convertLocationToScriptSemanticsInPlace(EntityItemProperties& properties) {
     // In EntityTree code, properties.position and properties.rotation are relative to the parent.  In javascript,
     // they are in world-space.  The local versions are put into localPosition and localRotation and position and
     // rotation are converted from local to world space.
-    EntityItemProperties scriptSideProperties = entitySideProperties;
-    scriptSideProperties.setLocalPosition(entitySideProperties.getPosition());
-    scriptSideProperties.setLocalRotation(entitySideProperties.getRotation());
-    scriptSideProperties.setLocalVelocity(entitySideProperties.getLocalVelocity());
-    scriptSideProperties.setLocalAngularVelocity(entitySideProperties.getLocalAngularVelocity());
+    properties.setLocalPosition(properties.getPosition());
+    properties.setLocalRotation(properties.getRotation());
+    properties.setLocalVelocity(properties.getLocalVelocity());
+    properties.setLocalAngularVelocity(properties.getLocalAngularVelocity());
 
     bool success;
-    glm::vec3 worldPosition = SpatiallyNestable::localToWorld(entitySideProperties.getPosition(),
-                                                              entitySideProperties.getParentID(),
-                                                              entitySideProperties.getParentJointIndex(),
+    glm::vec3 worldPosition = SpatiallyNestable::localToWorld(properties.getPosition(),
+                                                              properties.getParentID(),
+                                                              properties.getParentJointIndex(),
                                                               success);
-    glm::quat worldRotation = SpatiallyNestable::localToWorld(entitySideProperties.getRotation(),
-                                                              entitySideProperties.getParentID(),
-                                                              entitySideProperties.getParentJointIndex(),
+    glm::quat worldRotation = SpatiallyNestable::localToWorld(properties.getRotation(),
+                                                              properties.getParentID(),
+                                                              properties.getParentJointIndex(),
                                                               success);
-    glm::vec3 worldVelocity = SpatiallyNestable::localToWorldVelocity(entitySideProperties.getVelocity(),
-                                                                      entitySideProperties.getParentID(),
-                                                                      entitySideProperties.getParentJointIndex(),
+    glm::vec3 worldVelocity = SpatiallyNestable::localToWorldVelocity(properties.getVelocity(),
+                                                                      properties.getParentID(),
+                                                                      properties.getParentJointIndex(),
                                                                       success);
-    glm::vec3 worldAngularVelocity = SpatiallyNestable::localToWorldAngularVelocity(entitySideProperties.getAngularVelocity(),
-                                                                                    entitySideProperties.getParentID(),
-                                                                                    entitySideProperties.getParentJointIndex(),
+    glm::vec3 worldAngularVelocity = SpatiallyNestable::localToWorldAngularVelocity(properties.getAngularVelocity(),
+                                                                                    properties.getParentID(),
+                                                                                    properties.getParentJointIndex(),
                                                                                     success);
 
-    scriptSideProperties.setPosition(worldPosition);
-    scriptSideProperties.setRotation(worldRotation);
-    scriptSideProperties.setVelocity(worldVelocity);
-    scriptSideProperties.setAngularVelocity(worldAngularVelocity);
-
-    return scriptSideProperties;
+    properties.setPosition(worldPosition);
+    properties.setRotation(worldRotation);
+    properties.setVelocity(worldVelocity);
+    properties.setAngularVelocity(worldAngularVelocity);
 }
 
-
-EntityItemProperties convertLocationFromScriptSemantics(const EntityItemProperties& scriptSideProperties) {
+static void convertLocationFromScriptSemanticsInPlace(EntityItemProperties& properties) {
     // convert position and rotation properties from world-space to local, unless localPosition and localRotation
     // are set.  If they are set, they overwrite position and rotation.
-    EntityItemProperties entitySideProperties = scriptSideProperties;
     bool success;
 
     // TODO -- handle velocity and angularVelocity
 
-    if (scriptSideProperties.localPositionChanged()) {
-        entitySideProperties.setPosition(scriptSideProperties.getLocalPosition());
-    } else if (scriptSideProperties.positionChanged()) {
-        glm::vec3 localPosition = SpatiallyNestable::worldToLocal(entitySideProperties.getPosition(),
-                                                                  entitySideProperties.getParentID(),
-                                                                  entitySideProperties.getParentJointIndex(),
+    if (properties.localPositionChanged()) {
+        properties.setPosition(properties.getLocalPosition());
+    } else if (properties.positionChanged()) {
+        glm::vec3 localPosition = SpatiallyNestable::worldToLocal(properties.getPosition(),
+                                                                  properties.getParentID(),
+                                                                  properties.getParentJointIndex(),
                                                                   success);
-        entitySideProperties.setPosition(localPosition);
+        properties.setPosition(localPosition);
     }
 
-    if (scriptSideProperties.localRotationChanged()) {
-        entitySideProperties.setRotation(scriptSideProperties.getLocalRotation());
-    } else if (scriptSideProperties.rotationChanged()) {
-        glm::quat localRotation = SpatiallyNestable::worldToLocal(entitySideProperties.getRotation(),
-                                                                  entitySideProperties.getParentID(),
-                                                                  entitySideProperties.getParentJointIndex(),
+    if (properties.localRotationChanged()) {
+        properties.setRotation(properties.getLocalRotation());
+    } else if (properties.rotationChanged()) {
+        glm::quat localRotation = SpatiallyNestable::worldToLocal(properties.getRotation(),
+                                                                  properties.getParentID(),
+                                                                  properties.getParentJointIndex(),
                                                                   success);
-        entitySideProperties.setRotation(localRotation);
+        properties.setRotation(localRotation);
     }
 
-    if (scriptSideProperties.localVelocityChanged()) {
-        entitySideProperties.setVelocity(scriptSideProperties.getLocalVelocity());
-    } else if (scriptSideProperties.velocityChanged()) {
-        glm::vec3 localVelocity = SpatiallyNestable::worldToLocalVelocity(entitySideProperties.getVelocity(),
-                                                                          entitySideProperties.getParentID(),
-                                                                          entitySideProperties.getParentJointIndex(),
+    if (properties.localVelocityChanged()) {
+        properties.setVelocity(properties.getLocalVelocity());
+    } else if (properties.velocityChanged()) {
+        glm::vec3 localVelocity = SpatiallyNestable::worldToLocalVelocity(properties.getVelocity(),
+                                                                          properties.getParentID(),
+                                                                          properties.getParentJointIndex(),
                                                                           success);
-        entitySideProperties.setVelocity(localVelocity);
+        properties.setVelocity(localVelocity);
     }
 
-    if (scriptSideProperties.localAngularVelocityChanged()) {
-        entitySideProperties.setAngularVelocity(scriptSideProperties.getLocalAngularVelocity());
-    } else if (scriptSideProperties.angularVelocityChanged()) {
+    if (properties.localAngularVelocityChanged()) {
+        properties.setAngularVelocity(properties.getLocalAngularVelocity());
+    } else if (properties.angularVelocityChanged()) {
         glm::vec3 localAngularVelocity =
-            SpatiallyNestable::worldToLocalAngularVelocity(entitySideProperties.getAngularVelocity(),
-                                                           entitySideProperties.getParentID(),
-                                                           entitySideProperties.getParentJointIndex(),
+            SpatiallyNestable::worldToLocalAngularVelocity(properties.getAngularVelocity(),
+                                                           properties.getParentID(),
+                                                           properties.getParentJointIndex(),
                                                            success);
-        entitySideProperties.setAngularVelocity(localAngularVelocity);
+        properties.setAngularVelocity(localAngularVelocity);
     }
+}
+
+EntityItemProperties convertLocationToScriptSemantics(const EntityItemProperties& entitySideProperties) {
+    EntityItemProperties scriptSideProperties = entitySideProperties;
+    convertLocationToScriptSemanticsInPlace(scriptSideProperties);
+    return scriptSideProperties;
+}
 
+EntityItemProperties convertLocationFromScriptSemantics(const EntityItemProperties& scriptSideProperties) {
+    EntityItemProperties entitySideProperties = scriptSideProperties;
+    convertLocationFromScriptSemanticsInPlace(entitySideProperties);
     return entitySideProperties;
 }
 
@@ -271,44 +297,74 @@ EntityItemProperties EntityScriptingInterface::getEntityProperties(QUuid identit
         _entityTree->withReadLock([&] {
             EntityItemPointer entity = _entityTree->findEntityByEntityItemID(EntityItemID(identity));
             if (entity) {
-                if (desiredProperties.getHasProperty(PROP_POSITION) ||
-                    desiredProperties.getHasProperty(PROP_ROTATION) ||
-                    desiredProperties.getHasProperty(PROP_LOCAL_POSITION) ||
-                    desiredProperties.getHasProperty(PROP_LOCAL_ROTATION)) {
-                    // if we are explicitly getting position or rotation, we need parent information to make sense of them.
-                    desiredProperties.setHasProperty(PROP_PARENT_ID);
-                    desiredProperties.setHasProperty(PROP_PARENT_JOINT_INDEX);
-                }
+                results = getEntityPropertiesLocked(entity, desiredProperties);
+            }
+        });
+    }
 
-                if (desiredProperties.isEmpty()) {
-                    // these are left out of EntityItem::getEntityProperties so that localPosition and localRotation
-                    // don't end up in json saves, etc.  We still want them here, though.
-                    EncodeBitstreamParams params; // unknown
-                    desiredProperties = entity->getEntityProperties(params);
-                    desiredProperties.setHasProperty(PROP_LOCAL_POSITION);
-                    desiredProperties.setHasProperty(PROP_LOCAL_ROTATION);
-                 }
-
-                results = entity->getProperties(desiredProperties);
-
-                // TODO: improve sitting points and naturalDimensions in the future,
-                //       for now we've included the old sitting points model behavior for entity types that are models
-                //        we've also added this hack for setting natural dimensions of models
-                if (entity->getType() == EntityTypes::Model) {
-                    const FBXGeometry* geometry = _entityTree->getGeometryForEntity(entity);
-                    if (geometry) {
-                        results.setSittingPoints(geometry->sittingPoints);
-                        Extents meshExtents = geometry->getUnscaledMeshExtents();
-                        results.setNaturalDimensions(meshExtents.maximum - meshExtents.minimum);
-                        results.calculateNaturalPosition(meshExtents.minimum, meshExtents.maximum);
-                    }
-                }
+    convertLocationToScriptSemanticsInPlace(results);
+    return results;
+}
+
+EntityItemProperties EntityScriptingInterface::getEntityPropertiesLocked(EntityItemPointer entity,
+                                                                         EntityPropertyFlags desiredProperties) {
+    if (desiredProperties.getHasProperty(PROP_POSITION) ||
+        desiredProperties.getHasProperty(PROP_ROTATION) ||
+        desiredProperties.getHasProperty(PROP_LOCAL_POSITION) ||
+        desiredProperties.getHasProperty(PROP_LOCAL_ROTATION)) {
+        // if we are explicitly getting position or rotation, we need parent information to make sense of them.
+        desiredProperties.setHasProperty(PROP_PARENT_ID);
+        desiredProperties.setHasProperty(PROP_PARENT_JOINT_INDEX);
+    }
+
+    if (desiredProperties.isEmpty()) {
+        // these are left out of EntityItem::getEntityProperties so that localPosition and localRotation
+        // don't end up in json saves, etc.  We still want them here, though.
+        EncodeBitstreamParams params; // unknown
+        desiredProperties = entity->getEntityProperties(params);
+        desiredProperties.setHasProperty(PROP_LOCAL_POSITION);
+        desiredProperties.setHasProperty(PROP_LOCAL_ROTATION);
+     }
+
+    EntityItemProperties results = entity->getProperties(desiredProperties);
+
+    // TODO: improve sitting points and naturalDimensions in the future,
+    //       for now we've included the old sitting points model behavior for entity types that are models
+    //        we've also added this hack for setting natural dimensions of models
+    if (entity->getType() == EntityTypes::Model) {
+        const FBXGeometry* geometry = _entityTree->getGeometryForEntity(entity);
+        if (geometry) {
+            results.setSittingPoints(geometry->sittingPoints);
+            Extents meshExtents = geometry->getUnscaledMeshExtents();
+            results.setNaturalDimensions(meshExtents.maximum - meshExtents.minimum);
+            results.calculateNaturalPosition(meshExtents.minimum, meshExtents.maximum);
+        }
+    }
+
+    return results;
+}
 
+QVector<EntityItemProperties> EntityScriptingInterface::getMultipleEntityProperties(const QVector<QUuid>& entityIDs,
+                                                                                    EntityPropertyFlags desiredProperties) {
+    QVector<EntityItemProperties> results;
+    results.reserve(entityIDs.size());
+    if (_entityTree) {
+        _entityTree->withReadLock([&] {
+            foreach (const QUuid& identity, entityIDs) {
+                EntityItemPointer entity = _entityTree->findEntityByEntityItemID(EntityItemID(identity));
+                if (entity) {
+                    results << getEntityPropertiesLocked(entity, desiredProperties);
+                } else {
+                    results << EntityItemProperties();
+                }
             }
         });
     }
 
-    return convertLocationToScriptSemantics(results);
+    for (auto& properties : results) {
+        convertLocationToScriptSemanticsInPlace(properties);
+    }
+    return results;
 }
 
 QUuid EntityScriptingInterface::editEntity(QUuid id, const EntityItemProperties& scriptSideProperties) {
@@ -377,7 +433,7 @@ QUuid EntityScriptingInterface::editEntity(QUuid id, const EntityItemProperties&
                 properties.setRotation(entity->getOrientation());
             }
         }
-        properties = convertLocationFromScriptSemantics(properties);
+        convertLocationFromScriptSemanticsInPlace(properties);
         properties.setClientOnly(entity->getClientOnly());
         properties.setOwningAvatarID(entity->getOwningAvatarID());
 
@@ -464,6 +520,35 @@ QUuid EntityScriptingInterface::editEntity(QUuid id, const EntityItemProperties&
     return id;
 }
 
+QVector<QUuid> EntityScriptingInterface::editEntities(const QVector<QUuid>& entityIDs,
+                                                      const QVector<EntityItemProperties>& properties) {
+    QVector<QUuid> results;
+    if (entityIDs.size() != properties.size()) {
+        qCDebug(entities) << "editEntities called with" << entityIDs.size() << "entities but" << properties.size()
+            << "sets of properties";
+        return results;
+    }
+    results.reserve(entityIDs.size());
+
+    auto editAll = [&] {
+        for (int i = 0; i < entityIDs.size(); ++i) {
+            results << editEntity(entityIDs[i], properties[i]);
+        }
+    };
+
+    if (_entityTree) {
+        // the locks that editEntity takes nest in this one (the tree lock is recursive)
+        _entityTree->withWriteLock(editAll);
+    } else {
+        editAll();
+    }
+
+    // the edits were packed together as they were queued, send them now rather than at the next process()
+    getEntityPacketSender()->releaseQueuedMessages();
+
+    return results;
+}
+
 void EntityScriptingInterface::deleteEntity(QUuid id) {
     _activityTracking.deletedEntityCount++;
 
@@ -581,6 +666,50 @@ QVector<QUuid> EntityScriptingInterface::findEntitiesInBox(const glm::vec3& corn
     return result;
 }
 
+QVector<EntityItemProperties> EntityScriptingInterface::findEntitiesWithProperties(const glm::vec3& center, float radius,
+                                                                                   EntityPropertyFlags desiredProperties) {
+    QVector<EntityItemProperties> results;
+    if (_entityTree) {
+        _entityTree->withReadLock([&] {
+            QVector<EntityItemPointer> entities;
+            _entityTree->findEntities(center, radius, entities);
+
+            results.reserve(entities.size());
+            foreach (EntityItemPointer entity, entities) {
+                results << getEntityPropertiesLocked(entity, desiredProperties);
+            }
+        });
+    }
+
+    for (auto& properties : results) {
+        convertLocationToScriptSemanticsInPlace(properties);
+    }
+    return results;
+}
+
+QVector<EntityItemProperties> EntityScriptingInterface::findEntitiesInBoxWithProperties(const glm::vec3& corner,
+                                                                                        const glm::vec3& dimensions,
+                                                                                        EntityPropertyFlags desiredProperties) {
+    QVector<EntityItemProperties> results;
+    if (_entityTree) {
+        _entityTree->withReadLock([&] {
+            QVector<EntityItemPointer> entities;
+            AABox box(corner, dimensions);
+            _entityTree->findEntities(box, entities);
+
+            results.reserve(entities.size());
+            foreach (EntityItemPointer entity, entities) {
+                results << getEntityPropertiesLocked(entity, desiredProperties);
+            }
+        });
+    }
+
+    for (auto& properties : results) {
+        convertLocationToScriptSemanticsInPlace(properties);
+    }
+    return results;
+}
+
 QVector<QUuid> EntityScriptingInterface::findEntitiesInFrustum(QVariantMap frustum) const {
     QVector<QUuid> result;
 
@@ -642,6 +771,28 @@ RayToEntityIntersectionResult EntityScriptingInterface::findRayIntersectionBlock
     return findRayIntersectionWorker(ray, Octree::Lock, precisionPicking, entitiesToInclude, entitiesToDiscard);
 }
 
+void EntityScriptingInterface::findRayIntersectionAsync(const PickRay& ray, const QScriptValue& callback,
+                bool precisionPicking, const QScriptValue& entityIdsToInclude, const QScriptValue& entityIdsToDiscard,
+                bool visibleOnly, bool collidableOnly) {
+
+    if (!callback.isFunction()) {
+        qCDebug(entities) << "Entities.findRayIntersectionAsync() requires a callback function";
+        return;
+    }
+
+    // the script values can only be read on the script's thread
+    QVector<EntityItemID> entitiesToInclude = qVectorEntityItemIDFromScriptValue(entityIdsToInclude);
+    QVector<EntityItemID> entitiesToDiscard = qVectorEntityItemIDFromScriptValue(entityIdsToDiscard);
+
+    // the callback is created here so that it lives on the script's thread, which is where the result is delivered
+    auto rayPickCallback = new RayPickCallback(callback);
+    QThreadPool::globalInstance()->start(new RayPickTask([=] {
+        // the tree lock is a read lock, so picks only wait on edits to the tree and not on each other
+        return findRayIntersectionWorker(ray, Octree::Lock, precisionPicking, entitiesToInclude, entitiesToDiscard,
+            visibleOnly, collidableOnly);
+    }, rayPickCallback));
+}
+
 RayToEntityIntersectionResult EntityScriptingInterface::findRayIntersectionWorker(const PickRay& ray,
         Octree::lockType lockType, bool precisionPicking, const QVector<EntityItemID>& entityIdsToInclude,
         const QVector<EntityItemID>& entityIdsToDiscard, bool visibleOnly, bool collidableOnly) {
@@ -688,6 +839,15 @@ bool EntityScriptingInterface::getDrawZoneBoundaries() const {
     return ZoneEntityItem::getDrawZoneBoundaries();
 }
 
+void RayPickCallback::deliverResult(const RayToEntityIntersectionResult& result) {
+    // the callback is no longer a function if its script engine stopped while the pick ran
+    if (_callback.isFunction()) {
+        QScriptValueList args { RayToEntityIntersectionResultToScriptValue(_callback.engine(), result) };
+        _callback.call(QScriptValue(), args);
+    }
+    deleteLater();
+}
+
 RayToEntityIntersectionResult::RayToEntityIntersectionResult() :
     intersects(false),
     accurate(true), // assume it's accurate
@@ -1281,6 +1441,14 @@ int EntityScriptingInterface::getJointIndex(const QUuid& entityID, const QString
     if (!_entityTree) {
         return -1;
     }
+
+    // the renderer keeps a copy of the joint names of the models it has drawn, which saves waiting on the main thread
+    EntityItemPointer entity = _entityTree->findEntityByEntityItemID(entityID);
+    QStringList cachedJointNames = entity ? entity->getCachedJointNames() : QStringList();
+    if (!cachedJointNames.isEmpty()) {
+        return cachedJointNames.indexOf(name);
+    }
+
     int result;
     QMetaObject::invokeMethod(_entityTree.get(), "getJointIndex", Qt::BlockingQueuedConnection,
                               Q_RETURN_ARG(int, result), Q_ARG(QUuid, entityID), Q_ARG(QString, name));
@@ -1291,6 +1459,13 @@ QStringList EntityScriptingInterface::getJointNames(const QUuid& entityID) {
     if (!_entityTree) {
         return QStringList();
     }
+
+    EntityItemPointer entity = _entityTree->findEntityByEntityItemID(entityID);
+    QStringList cachedJointNames = entity ? entity->getCachedJointNames() : QStringList();
+    if (!cachedJointNames.isEmpty()) {
+        return cachedJointNames;
+    }
+
     QStringList result;
     QMetaObject::invokeMethod(_entityTree.get(), "getJointNames", Qt::BlockingQueuedConnection,
                               Q_RETURN_ARG(QStringList, result), Q_ARG(QUuid, entityID));
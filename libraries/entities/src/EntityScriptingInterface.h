@@ -55,6 +55,20 @@ Q_DECLARE_METATYPE(RayToEntityIntersectionResult)
 QScriptValue RayToEntityIntersectionResultToScriptValue(QScriptEngine* engine, const RayToEntityIntersectionResult& results);
 void RayToEntityIntersectionResultFromScriptValue(const QScriptValue& object, RayToEntityIntersectionResult& results);
 
+/// holds the script callback of an asynchronous ray pick, on the thread of the script that asked for the pick
+class RayPickCallback : public QObject {
+    Q_OBJECT
+public:
+    RayPickCallback(const QScriptValue& callback) : _callback(callback) {}
+
+public slots:
+    /// calls the script back with the result, and deletes itself
+    void deliverResult(const RayToEntityIntersectionResult& result);
+
+private:
+    QScriptValue _callback;
+};
+
 
 /// handles scripting of Entity commands from JS passed to assigned clients
 class EntityScriptingInterface : public OctreeScriptingInterface, public Dependency  {
@@ -106,10 +120,18 @@ public slots:
     Q_INVOKABLE EntityItemProperties getEntityProperties(QUuid entityID);
     Q_INVOKABLE EntityItemProperties getEntityProperties(QUuid identity, EntityPropertyFlags desiredProperties);
 
+    /// gets the properties of several entities with one lock of the tree, unknown entities get empty properties
+    Q_INVOKABLE QVector<EntityItemProperties> getMultipleEntityProperties(const QVector<QUuid>& entityIDs,
+                                                                         EntityPropertyFlags desiredProperties);
+
     /// edits a model updating only the included properties, will return the identified EntityItemID in case of
     /// successful edit, if the input entityID is for an unknown model this function will have no effect
     Q_INVOKABLE QUuid editEntity(QUuid entityID, const EntityItemProperties& properties);
 
+    /// edits several models, properties[i] being the edit of entityIDs[i], with one lock of the tree, and sends the edits
+    /// right away - returns the result of editEntity for each model, or nothing if the lists differ in length
+    Q_INVOKABLE QVector<QUuid> editEntities(const QVector<QUuid>& entityIDs, const QVector<EntityItemProperties>& properties);
+
     /// deletes a model
     Q_INVOKABLE void deleteEntity(QUuid entityID);
 
@@ -131,6 +153,14 @@ public slots:
     /// this function will not find any models in script engine contexts which don't have access to models
     Q_INVOKABLE QVector<QUuid> findEntitiesInBox(const glm::vec3& corner, const glm::vec3& dimensions) const;
 
+    /// same as findEntities and findEntitiesInBox followed by getEntityProperties for each model found, but with one
+    /// lock of the tree for the search and all of the properties
+    Q_INVOKABLE QVector<EntityItemProperties> findEntitiesWithProperties(const glm::vec3& center, float radius,
+                                                                        EntityPropertyFlags desiredProperties);
+    Q_INVOKABLE QVector<EntityItemProperties> findEntitiesInBoxWithProperties(const glm::vec3& corner,
+                                                                             const glm::vec3& dimensions,
+                                                                             EntityPropertyFlags desiredProperties);
+
     /// finds models within the frustum
     /// the frustum must have the following properties:
     /// - position
@@ -151,6 +181,13 @@ public slots:
     /// order to return an accurate result
     Q_INVOKABLE RayToEntityIntersectionResult findRayIntersectionBlocking(const PickRay& ray, bool precisionPicking = false, const QScriptValue& entityIdsToInclude = QScriptValue(), const QScriptValue& entityIdsToDiscard = QScriptValue());
 
+    /// Determines a ray intersection on a worker thread, so that neither the caller nor the main thread wait on the
+    /// tree lock. The result is passed to callback(result) on the caller's thread once the pick is done. Any number of
+    /// these picks can run at the same time.
+    Q_INVOKABLE void findRayIntersectionAsync(const PickRay& ray, const QScriptValue& callback, bool precisionPicking = false,
+        const QScriptValue& entityIdsToInclude = QScriptValue(), const QScriptValue& entityIdsToDiscard = QScriptValue(),
+        bool visibleOnly = false, bool collidableOnly = false);
+
     Q_INVOKABLE void setLightsArePickable(bool value);
     Q_INVOKABLE bool getLightsArePickable() const;
 
@@ -257,6 +294,9 @@ private:
     bool setPoints(QUuid entityID, std::function<bool(LineEntityItem&)> actor);
     void queueEntityMessage(PacketType packetType, EntityItemID entityID, const EntityItemProperties& properties);
 
+    // the caller holds the tree's read lock
+    EntityItemProperties getEntityPropertiesLocked(EntityItemPointer entity, EntityPropertyFlags desiredProperties);
+
     EntityItemPointer checkForTreeEntityAndTypeMatch(const QUuid& entityID,
                                                      EntityTypes::EntityType entityType = EntityTypes::Unknown);
 
@@ -156,6 +156,7 @@ void EntitySimulation::sortEntitiesThatMoved() {
             prepareEntityForDelete(entity);
         } else {
             moveOperator.addEntityToMoveList(entity, newCube);
+            _entityTree->trackChangedEntity(*entity);
             ++itemItr;
         }
     }
@@ -258,6 +259,8 @@ void EntitySimulation::clearEntities() {
 }
 
 void EntitySimulation::moveSimpleKinematics(const quint64& now) {
+    // gather the entities that are still simple kinematic...
+    _kinematicState.clear();
     SetOfEntities::iterator itemItr = _simpleKinematicEntities.begin();
     while (itemItr != _simpleKinematicEntities.end()) {
         EntityItemPointer entity = *itemItr;
@@ -269,14 +272,76 @@ void EntitySimulation::moveSimpleKinematics(const quint64& now) {
         bool hasAvatarAncestor = entity->hasAncestorOfType(NestableType::Avatar);
 
         if (entity->isMovingRelativeToParent() && !entity->getPhysicsInfo() && ancestryIsKnown && !hasAvatarAncestor) {
-            entity->simulate(now);
-            _entitiesToSort.insert(entity);
+            _kinematicState.add(entity, now);
             ++itemItr;
         } else {
             // the entity is no longer non-physical-kinematic
             itemItr = _simpleKinematicEntities.erase(itemItr);
         }
     }
+
+    // ...step them all together...
+    _kinematicState.integrate();
+
+    // ...and hand the results back to them
+    for (size_t i = 0; i < _kinematicState.entities.size(); i++) {
+        const EntityItemPointer& entity = _kinematicState.entities[i];
+        bool isMoving = _kinematicState.isMoving[i] != 0;
+        if (isMoving) {
+            Transform& transform = _kinematicState.transforms[i];
+            transform.setTranslation(_kinematicState.positions[i]);
+            if (_kinematicState.rotations[i] != transform.getRotation()) {
+                transform.setRotation(_kinematicState.rotations[i]);
+            }
+            entity->setLocalTransformAndVelocities(transform, _kinematicState.linearVelocities[i],
+                                                   _kinematicState.angularVelocities[i]);
+        }
+        entity->endSimulationStep(now, isMoving);
+        _entitiesToSort.insert(entity);
+    }
+    _kinematicState.clear();
+}
+
+void EntitySimulation::KinematicState::add(EntityItemPointer entity, const quint64& now) {
+    Transform transform;
+    glm::vec3 linearVelocity;
+    glm::vec3 angularVelocity;
+    entity->getLocalTransformAndVelocities(transform, linearVelocity, angularVelocity);
+
+    entities.push_back(entity);
+    timesElapsed.push_back(entity->beginSimulationStep(now));
+    positions.push_back(transform.getTranslation());
+    rotations.push_back(transform.getRotation());
+    transforms.push_back(transform);
+    linearVelocities.push_back(linearVelocity);
+    angularVelocities.push_back(angularVelocity);
+    accelerations.push_back(entity->getLocalAcceleration());
+    dampings.push_back(entity->getDamping());
+    angularDampings.push_back(entity->getAngularDamping());
+}
+
+void EntitySimulation::KinematicState::integrate() {
+    size_t numEntities = entities.size();
+    isMoving.resize(numEntities);
+    for (size_t i = 0; i < numEntities; i++) {
+        isMoving[i] = EntityItem::integrateKinematicMotion(timesElapsed[i], dampings[i], angularDampings[i],
+            accelerations[i], positions[i], rotations[i], linearVelocities[i], angularVelocities[i]) ? 1 : 0;
+    }
+}
+
+void EntitySimulation::KinematicState::clear() {
+    // clear() keeps the capacity, so after the first few steps none of these allocate
+    entities.clear();
+    transforms.clear();
+    positions.clear();
+    rotations.clear();
+    linearVelocities.clear();
+    angularVelocities.clear();
+    accelerations.clear();
+    dampings.clear();
+    angularDampings.clear();
+    timesElapsed.clear();
+    isMoving.clear();
 }
 
 void EntitySimulation::addAction(EntityActionPointer action) {
@@ -12,6 +12,8 @@
 #ifndef hifi_EntitySimulation_h
 #define hifi_EntitySimulation_h
 
+#include <vector>
+
 #include <QtCore/QObject>
 #include <QSet>
 #include <QVector>
@@ -112,6 +114,27 @@ protected:
 private:
     void moveSimpleKinematics();
 
+    // packed copies of the motion state of the simple kinematic entities, so that moveSimpleKinematics() integrates
+    // them all in one loop that touches neither the entities nor their locks
+    struct KinematicState {
+        std::vector<EntityItemPointer> entities;
+        std::vector<Transform> transforms;
+        std::vector<glm::vec3> positions;
+        std::vector<glm::quat> rotations;
+        std::vector<glm::vec3> linearVelocities;
+        std::vector<glm::vec3> angularVelocities;
+        std::vector<glm::vec3> accelerations; // in the parent frame
+        std::vector<float> dampings;
+        std::vector<float> angularDampings;
+        std::vector<float> timesElapsed;
+        std::vector<uint8_t> isMoving;
+
+        void add(EntityItemPointer entity, const quint64& now);
+        void integrate();
+        void clear();
+    };
+    KinematicState _kinematicState; // kept between steps so that its arrays are not reallocated
+
     // back pointer to EntityTree structure
     EntityTreePointer _entityTree;
 
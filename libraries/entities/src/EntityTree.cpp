@@ -11,6 +11,7 @@
 
 #include <PerfStat.h>
 #include <QDateTime>
+#include <QJsonDocument>
 #include <QtScript/QScriptEngine>
 
 #include "EntityTree.h"
@@ -26,6 +27,34 @@
 #include "LogHandler.h"
 
 static const quint64 DELETED_ENTITIES_EXTRA_USECS_TO_CONSIDER = USECS_PER_MSEC * 50;
+
+// Binary snapshot layout (host byte order):
+//   header: magic, snapshot version, entity data packet version, entity count, offset of the index
+//   blobs: per entity an EntityAdd edit message with all of its properties (the wire encoding), or the JSON the
+//          json persist files use when the properties do not fit in an edit message
+//   index: per entity the offset, created time, size and encoding of its blob
+static const char BINARY_SNAPSHOT_MAGIC[4] = { 'H', 'F', 'E', 'S' };
+static const quint32 BINARY_SNAPSHOT_VERSION = 1;
+
+enum BinarySnapshotEncoding : quint32 {
+    SNAPSHOT_EDIT_MESSAGE = 0,
+    SNAPSHOT_JSON
+};
+
+struct BinarySnapshotHeader {
+    char magic[4];
+    quint32 version;
+    quint32 packetVersion;
+    quint32 numEntities;
+    quint64 indexOffset;
+};
+
+struct BinarySnapshotIndexEntry {
+    quint64 offset;
+    quint64 created;
+    quint32 size;
+    quint32 encoding;
+};
 const float EntityTree::DEFAULT_MAX_TMP_ENTITY_LIFETIME = 60 * 60; // 1 hour
 
 
@@ -96,6 +125,15 @@ void EntityTree::eraseAllOctreeElements(bool createNewRoot) {
 
     resetClientEditStats();
     clearDeletedEntities();
+
+    {
+        QMutexLocker locker(&_journalLock);
+        if (_isJournalEnabled) {
+            _journalChangedIDs.clear();
+            _journalDeletedIDs.clear();
+            _journalCleared = true;
+        }
+    }
 }
 
 bool EntityTree::handlesEditPacketType(PacketType packetType) const {
@@ -189,6 +227,7 @@ bool EntityTree::updateEntityWithElement(EntityItemPointer entity, const EntityI
                 UpdateEntityOperator theOperator(getThisPointer(), containingElement, entity, queryCube);
                 recurseTreeWithOperator(&theOperator);
                 entity->setProperties(tempProperties);
+                entity->markAsNonMotionChangedOnServer();
                 _isDirty = true;
             }
         }
@@ -263,6 +302,9 @@ bool EntityTree::updateEntityWithElement(EntityItemPointer entity, const EntityI
         }
         UpdateEntityOperator theOperator(getThisPointer(), containingElement, entity, newQueryAACube);
         recurseTreeWithOperator(&theOperator);
+        if (getIsServer() && entity->changesMoreThanMotion(properties)) {
+            entity->markAsNonMotionChangedOnServer();
+        }
         entity->setProperties(properties);
 
         // if the entity has children, run UpdateEntityOperator on them.  If the children have children, recurse
@@ -308,6 +350,7 @@ bool EntityTree::updateEntityWithElement(EntityItemPointer entity, const EntityI
 
         uint32_t newFlags = entity->getDirtyFlags() & ~preFlags;
         if (newFlags) {
+            trackChangedEntity(*entity);
             if (_simulation) {
                 if (newFlags & DIRTY_SIMULATION_FLAGS) {
                     _simulation->changeEntity(entity);
@@ -334,6 +377,7 @@ bool EntityTree::updateEntityWithElement(EntityItemPointer entity, const EntityI
         return false;
     }
 
+    journalChange(entity->getEntityItemID());
     return true;
 }
 
@@ -386,6 +430,7 @@ EntityItemPointer EntityTree::addEntity(const EntityItemID& entityID, const Enti
         }
 
         postAddEntity(result);
+        journalChange(entityID);
     }
     return result;
 }
@@ -514,6 +559,8 @@ void EntityTree::processRemovedEntities(const DeleteEntityOperator& theOperator)
             trackDeletedEntity(theEntity->getEntityItemID());
         }
 
+        journalDelete(theEntity->getEntityItemID(), deletedAt);
+
         if (_simulation) {
             _simulation->prepareEntityForDelete(theEntity);
         }
@@ -591,7 +638,8 @@ bool EntityTree::findRayIntersection(const glm::vec3& origin, const glm::vec3& d
 
     bool requireLock = lockType == Octree::Lock;
     bool lockResult = withReadLock([&]{
-        recurseTreeWithOperation(findRayIntersectionOp, &args);
+        // nearest elements first, so that the first hits let the elements behind them be skipped
+        recurseTreeWithOperationDistanceSorted(findRayIntersectionOp, origin, &args);
     }, requireLock);
 
     if (accurateResult) {
@@ -905,6 +953,64 @@ void EntityTree::fixupTerseEditLogging(EntityItemProperties& properties, QList<Q
     }
 }
 
+void EntityTree::decodeEditsAhead(const ReceivedMessage& message, int editsPosition) {
+    if (message.getType() != PacketType::EntityAdd && message.getType() != PacketType::EntityEdit) {
+        return;
+    }
+
+    DecodedEdits decodedEdits;
+    const unsigned char* messageData = reinterpret_cast<const unsigned char*>(message.getRawMessage());
+    int position = editsPosition;
+
+    // the edits follow each other, so each one has to be decoded to know where the next one starts
+    while (position < message.getSize()) {
+        DecodedEdit decodedEdit;
+        decodedEdit.editData = messageData + position;
+        decodedEdit.processedBytes = 0;
+        decodedEdit.isValid = EntityItemProperties::decodeEntityEditPacket(decodedEdit.editData,
+                                                                           message.getSize() - position,
+                                                                           decodedEdit.processedBytes,
+                                                                           decodedEdit.entityItemID,
+                                                                           decodedEdit.properties);
+        if (decodedEdit.processedBytes <= 0) {
+            // processEditPacketData() will stop at this edit too, and decode it again itself
+            break;
+        }
+        position += decodedEdit.processedBytes;
+        decodedEdits.edits.push_back(decodedEdit);
+    }
+
+    if (!decodedEdits.edits.isEmpty()) {
+        QMutexLocker locker(&_decodedEditsLock);
+        _decodedEdits.insert(&message, decodedEdits);
+    }
+}
+
+void EntityTree::releaseEditsDecodedAhead(const ReceivedMessage& message) {
+    QMutexLocker locker(&_decodedEditsLock);
+    _decodedEdits.remove(&message);
+}
+
+bool EntityTree::takeEditDecodedAhead(const ReceivedMessage& message, const unsigned char* editData,
+                                      DecodedEdit& decodedEdit) {
+    QMutexLocker locker(&_decodedEditsLock);
+    auto iter = _decodedEdits.find(&message);
+    if (iter == _decodedEdits.end()) {
+        return false;
+    }
+
+    // the edits are applied in the order they were decoded, so the one we are asked for is almost always the next one
+    DecodedEdits& decodedEdits = iter.value();
+    for (int i = decodedEdits.next; i < decodedEdits.edits.size(); ++i) {
+        if (decodedEdits.edits[i].editData == editData) {
+            decodedEdit = decodedEdits.edits[i];
+            decodedEdits.next = i + 1;
+            return true;
+        }
+    }
+    return false;
+}
+
 int EntityTree::processEditPacketData(ReceivedMessage& message, const unsigned char* editData, int maxLength,
                                      const SharedNodePointer& senderNode) {
 
@@ -937,10 +1043,19 @@ int EntityTree::processEditPacketData(ReceivedMessage& message, const unsigned c
 
             EntityItemID entityItemID;
             EntityItemProperties properties;
+            bool validEditPacket;
             startDecode = usecTimestampNow();
 
-            bool validEditPacket = EntityItemProperties::decodeEntityEditPacket(editData, maxLength, processedBytes,
-                                                                                entityItemID, properties);
+            DecodedEdit decodedEdit;
+            if (takeEditDecodedAhead(message, editData, decodedEdit)) {
+                processedBytes = decodedEdit.processedBytes;
+                validEditPacket = decodedEdit.isValid;
+                entityItemID = decodedEdit.entityItemID;
+                properties = decodedEdit.properties;
+            } else {
+                validEditPacket = EntityItemProperties::decodeEntityEditPacket(editData, maxLength, processedBytes,
+                                                                               entityItemID, properties);
+            }
             endDecode = usecTimestampNow();
 
             if (validEditPacket && !_entityScriptSourceWhitelist.isEmpty() && !properties.getScript().isEmpty()) {
@@ -1114,6 +1229,27 @@ void EntityTree::entityChanged(EntityItemPointer entity) {
     if (_simulation) {
         _simulation->changeEntity(entity);
     }
+    trackChangedEntity(*entity);
+}
+
+void EntityTree::setChangedEntitiesFilter(std::function<bool(const EntityItem&)> filter) {
+    QMutexLocker locker(&_changedEntitiesLock);
+    _changedEntitiesFilter = filter;
+    _changedEntityIDs.clear();
+}
+
+QSet<EntityItemID> EntityTree::takeChangedEntities() {
+    QMutexLocker locker(&_changedEntitiesLock);
+    QSet<EntityItemID> changedEntityIDs;
+    changedEntityIDs.swap(_changedEntityIDs);
+    return changedEntityIDs;
+}
+
+void EntityTree::trackChangedEntity(const EntityItem& entity) {
+    QMutexLocker locker(&_changedEntitiesLock);
+    if (_changedEntitiesFilter && _changedEntitiesFilter(entity)) {
+        _changedEntityIDs.insert(entity.getEntityItemID());
+    }
 }
 
 void EntityTree::fixupMissingParents() {
@@ -1265,42 +1401,47 @@ void EntityTree::forgetEntitiesDeletedBefore(quint64 sinceTime) {
 
 
 // TODO: consider consolidating processEraseMessageDetails() and processEraseMessage()
-int EntityTree::processEraseMessage(ReceivedMessage& message, const SharedNodePointer& sourceNode) {
+QSet<EntityItemID> EntityTree::decodeEraseMessage(ReceivedMessage& message, const SharedNodePointer& sourceNode) {
     #ifdef EXTRA_ERASE_DEBUGGING
-        qDebug() << "EntityTree::processEraseMessage()";
+        qDebug() << "EntityTree::decodeEraseMessage()";
     #endif
-    withWriteLock([&] {
-        message.seek(sizeof(OCTREE_PACKET_FLAGS) + sizeof(OCTREE_PACKET_SEQUENCE) + sizeof(OCTREE_PACKET_SENT_TIME));
+    QSet<EntityItemID> entityItemIDsToDelete;
 
-        uint16_t numberOfIDs = 0; // placeholder for now
-        message.readPrimitive(&numberOfIDs);
+    message.seek(sizeof(OCTREE_PACKET_FLAGS) + sizeof(OCTREE_PACKET_SEQUENCE) + sizeof(OCTREE_PACKET_SENT_TIME));
 
-        if (numberOfIDs > 0) {
-            QSet<EntityItemID> entityItemIDsToDelete;
+    uint16_t numberOfIDs = 0; // placeholder for now
+    message.readPrimitive(&numberOfIDs);
 
-            for (size_t i = 0; i < numberOfIDs; i++) {
+    for (size_t i = 0; i < numberOfIDs; i++) {
 
-                if (NUM_BYTES_RFC4122_UUID > message.getBytesLeftToRead()) {
-                    qCDebug(entities) << "EntityTree::processEraseMessage().... bailing because not enough bytes in buffer";
-                    break; // bail to prevent buffer overflow
-                }
+        if (NUM_BYTES_RFC4122_UUID > message.getBytesLeftToRead()) {
+            qCDebug(entities) << "EntityTree::decodeEraseMessage().... bailing because not enough bytes in buffer";
+            break; // bail to prevent buffer overflow
+        }
 
-                QUuid entityID = QUuid::fromRfc4122(message.readWithoutCopy(NUM_BYTES_RFC4122_UUID));
-                #ifdef EXTRA_ERASE_DEBUGGING
-                    qDebug() << "    ---- EntityTree::processEraseMessage() contained ID:" << entityID;
-                #endif
+        QUuid entityID = QUuid::fromRfc4122(message.readWithoutCopy(NUM_BYTES_RFC4122_UUID));
+        #ifdef EXTRA_ERASE_DEBUGGING
+            qDebug() << "    ---- EntityTree::decodeEraseMessage() contained ID:" << entityID;
+        #endif
 
-                EntityItemID entityItemID(entityID);
-                entityItemIDsToDelete << entityItemID;
+        EntityItemID entityItemID(entityID);
+        entityItemIDsToDelete << entityItemID;
 
-                if (wantEditLogging() || wantTerseEditLogging()) {
-                    qCDebug(entities) << "User [" << sourceNode->getUUID() << "] deleting entity. ID:" << entityItemID;
-                }
+        if (wantEditLogging() || wantTerseEditLogging()) {
+            qCDebug(entities) << "User [" << sourceNode->getUUID() << "] deleting entity. ID:" << entityItemID;
+        }
+    }
+    return entityItemIDsToDelete;
+}
 
-            }
+int EntityTree::processEraseMessage(ReceivedMessage& message, const SharedNodePointer& sourceNode) {
+    // the IDs are read without the lock, which is only held to delete the entities
+    QSet<EntityItemID> entityItemIDsToDelete = decodeEraseMessage(message, sourceNode);
+    if (!entityItemIDsToDelete.isEmpty()) {
+        withWriteLock([&] {
             deleteEntities(entityItemIDsToDelete, true, true);
-        }
-    });
+        });
+    }
     return message.getPosition();
 }
 
@@ -1516,9 +1657,27 @@ bool EntityTree::writeToMap(QVariantMap& entityDescription, OctreeElementPointer
     if (! entityDescription.contains("Entities")) {
         entityDescription["Entities"] = QVariantList();
     }
+
+    // only the copy of the properties holds up edits, the persist thread converts them while the tree keeps changing
+    QVector<EntityItemProperties> entityProperties;
+    withReadLock([&] {
+        RecurseOctreeToMapOperator theOperator(entityProperties, element, skipThoseWithBadParents);
+        recurseTreeWithOperator(&theOperator);
+    });
+
     QScriptEngine scriptEngine;
-    RecurseOctreeToMapOperator theOperator(entityDescription, element, &scriptEngine, skipDefaultValues, skipThoseWithBadParents);
-    recurseTreeWithOperator(&theOperator);
+    QVariantList entitiesQList = entityDescription["Entities"].toList();
+    entitiesQList.reserve(entitiesQList.size() + entityProperties.size());
+    foreach (const EntityItemProperties& properties, entityProperties) {
+        QScriptValue qScriptValues;
+        if (skipDefaultValues) {
+            qScriptValues = EntityItemNonDefaultPropertiesToScriptValue(&scriptEngine, properties);
+        } else {
+            qScriptValues = EntityItemPropertiesToScriptValue(&scriptEngine, properties);
+        }
+        entitiesQList << qScriptValues.toVariant();
+    }
+    entityDescription["Entities"] = entitiesQList;
     return true;
 }
 
@@ -1612,3 +1771,256 @@ QStringList EntityTree::getJointNames(const QUuid& entityID) const {
     }
     return entity->getJointNames();
 }
+
+bool EntityTree::writeToBinarySnapshot(QIODevice& device, OctreeElementPointer element) {
+    BinarySnapshotHeader header;
+    memcpy(header.magic, BINARY_SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = BINARY_SNAPSHOT_VERSION;
+    header.packetVersion = versionForPacketType(expectedDataPacketType());
+    header.numEntities = 0;
+    header.indexOffset = 0;
+
+    // the header is written again once we know where the index is
+    if (device.write(reinterpret_cast<const char*>(&header), sizeof(header)) != sizeof(header)) {
+        return false;
+    }
+
+    // same as writeToMap, only the copy of the properties holds up edits
+    QVector<EntityItemProperties> entityProperties;
+    withReadLock([&] {
+        RecurseOctreeToMapOperator theOperator(entityProperties, element, true);
+        recurseTreeWithOperator(&theOperator);
+    });
+
+    QScriptEngine scriptEngine;
+    QVector<BinarySnapshotIndexEntry> index;
+    index.reserve(entityProperties.size());
+    quint64 offset = sizeof(header);
+
+    for (EntityItemProperties& properties : entityProperties) {
+        BinarySnapshotIndexEntry entry;
+        entry.offset = offset;
+        entry.created = properties.getCreated();
+        entry.encoding = SNAPSHOT_EDIT_MESSAGE;
+
+        QByteArray blob(NLPacket::maxPayloadSize(PacketType::EntityAdd), 0);
+        EntityItemProperties allProperties = properties;
+        allProperties.markAllChanged();
+        if (!EntityItemProperties::encodeEntityEditPacket(PacketType::EntityAdd, properties.getID(), allProperties, blob)) {
+            QScriptValue scriptValue = EntityItemNonDefaultPropertiesToScriptValue(&scriptEngine, properties);
+            blob = QJsonDocument::fromVariant(scriptValue.toVariant()).toJson(QJsonDocument::Compact);
+            entry.encoding = SNAPSHOT_JSON;
+        }
+        entry.size = blob.size();
+
+        if (device.write(blob) != blob.size()) {
+            return false;
+        }
+        offset += blob.size();
+        index << entry;
+    }
+
+    qint64 indexSize = index.size() * sizeof(BinarySnapshotIndexEntry);
+    if (device.write(reinterpret_cast<const char*>(index.constData()), indexSize) != indexSize) {
+        return false;
+    }
+
+    header.numEntities = index.size();
+    header.indexOffset = offset;
+    return device.seek(0) && device.write(reinterpret_cast<const char*>(&header), sizeof(header)) == sizeof(header);
+}
+
+bool EntityTree::readFromBinarySnapshot(const char* data, qint64 size) {
+    BinarySnapshotHeader header;
+    if (size < (qint64)sizeof(header)) {
+        qCDebug(entities) << "Binary snapshot is too short for its header";
+        return false;
+    }
+    memcpy(&header, data, sizeof(header));
+
+    if (memcmp(header.magic, BINARY_SNAPSHOT_MAGIC, sizeof(header.magic)) != 0
+        || header.version != BINARY_SNAPSHOT_VERSION) {
+        qCDebug(entities) << "Not a binary snapshot this server can read, version" << header.version;
+        return false;
+    }
+
+    // the edit messages are only readable by the version of the entity data they were written with
+    PacketVersion expectedVersion = versionForPacketType(expectedDataPacketType());
+    if (header.packetVersion != expectedVersion) {
+        qCDebug(entities) << "Binary snapshot has entity data version" << header.packetVersion
+            << "expected" << (int)expectedVersion << "-- save it as json with a matching server first";
+        return false;
+    }
+
+    quint64 indexSize = (quint64)header.numEntities * sizeof(BinarySnapshotIndexEntry);
+    if (header.indexOffset < sizeof(header) || header.indexOffset + indexSize > (quint64)size) {
+        qCDebug(entities) << "Binary snapshot index is out of bounds";
+        return false;
+    }
+
+    QScriptEngine scriptEngine;
+    bool success = true;
+
+    for (quint32 i = 0; i < header.numEntities; ++i) {
+        BinarySnapshotIndexEntry entry;
+        memcpy(&entry, data + header.indexOffset + i * sizeof(entry), sizeof(entry));
+
+        if (entry.offset + entry.size > header.indexOffset) {
+            qCDebug(entities) << "Binary snapshot entity" << i << "is out of bounds";
+            success = false;
+            continue;
+        }
+        const char* blob = data + entry.offset;
+
+        EntityItemID entityItemID;
+        EntityItemProperties properties;
+        bool validBlob = false;
+
+        if (entry.encoding == SNAPSHOT_EDIT_MESSAGE) {
+            int processedBytes = 0;
+            validBlob = EntityItemProperties::decodeEntityEditPacket(reinterpret_cast<const unsigned char*>(blob),
+                                                                     entry.size, processedBytes, entityItemID, properties);
+        } else if (entry.encoding == SNAPSHOT_JSON) {
+            QVariantMap entityMap = QJsonDocument::fromJson(QByteArray::fromRawData(blob, entry.size)).toVariant().toMap();
+            QScriptValue entityScriptValue = variantMapToScriptValue(entityMap, scriptEngine);
+            EntityItemPropertiesFromScriptValueIgnoreReadOnly(entityScriptValue, properties);
+            entityItemID = EntityItemID(QUuid(entityMap["id"].toString()));
+            validBlob = !entityItemID.isNull();
+        }
+
+        if (!validBlob) {
+            qCDebug(entities) << "Binary snapshot entity" << i << "could not be decoded";
+            success = false;
+            continue;
+        }
+
+        // edit messages intentionally leave out the created time, so the index keeps it
+        properties.setCreated(entry.created);
+
+        EntityItemPointer entity = addEntity(entityItemID, properties);
+        if (!entity) {
+            qCDebug(entities) << "adding Entity failed:" << entityItemID << properties.getType();
+            success = false;
+        }
+    }
+    return success;
+}
+
+void EntityTree::setJournalEnabled(bool enabled) {
+    QMutexLocker locker(&_journalLock);
+    _isJournalEnabled = enabled;
+    _journalCleared = false;
+    _journalChangedIDs.clear();
+    _journalDeletedIDs.clear();
+}
+
+void EntityTree::journalChange(const EntityItemID& entityID) {
+    QMutexLocker locker(&_journalLock);
+    if (_isJournalEnabled) {
+        _journalDeletedIDs.remove(entityID);
+        _journalChangedIDs.insert(entityID);
+    }
+}
+
+void EntityTree::journalDelete(const EntityItemID& entityID, quint64 deletedAt) {
+    QMutexLocker locker(&_journalLock);
+    if (_isJournalEnabled) {
+        _journalChangedIDs.remove(entityID);
+        _journalDeletedIDs.insert(entityID, deletedAt);
+    }
+}
+
+QVariantList EntityTree::takeJournalRecords() {
+    // the caller holds at least a read lock on the tree, so the entities we look up below stay put
+    bool wasCleared;
+    QSet<EntityItemID> changedIDs;
+    QHash<EntityItemID, quint64> deletedIDs;
+    {
+        QMutexLocker locker(&_journalLock);
+        wasCleared = _journalCleared;
+        _journalCleared = false;
+        changedIDs.swap(_journalChangedIDs);
+        deletedIDs.swap(_journalDeletedIDs);
+    }
+
+    QVariantList records;
+
+    if (wasCleared) {
+        QVariantMap record;
+        record["op"] = "clear";
+        records << record;
+    }
+
+    for (auto it = deletedIDs.constBegin(); it != deletedIDs.constEnd(); ++it) {
+        QVariantMap record;
+        record["op"] = "delete";
+        record["id"] = it.key().toString();
+        record["deletedAt"] = QString::number(it.value());
+        records << record;
+    }
+
+    QScriptEngine scriptEngine;
+    foreach (const EntityItemID& entityID, changedIDs) {
+        EntityItemPointer entity = findEntityByEntityItemID(entityID);
+        if (!entity) {
+            // deleted after it was edited and before we got here, the delete is in the next batch
+            continue;
+        }
+
+        // same form as the entities written by writeToMap, so the record can stand in for them in the persist file
+        QVariantMap record;
+        record["op"] = "edit";
+        record["lastEdited"] = QString::number(entity->getLastEdited());
+        record["entity"] = EntityItemNonDefaultPropertiesToScriptValue(&scriptEngine, entity->getProperties()).toVariant();
+        records << record;
+    }
+
+    return records;
+}
+
+void EntityTree::replayJournalOnMap(QVariantMap& entityDescription, const QVariantList& records) const {
+    QHash<QString, QVariant> entitiesByID;
+    QStringList entityOrder;
+
+    foreach (const QVariant& entityVariant, entityDescription["Entities"].toList()) {
+        QString entityID = entityVariant.toMap()["id"].toString();
+        if (!entitiesByID.contains(entityID)) {
+            entityOrder << entityID;
+        }
+        entitiesByID[entityID] = entityVariant;
+    }
+
+    foreach (const QVariant& recordVariant, records) {
+        QVariantMap record = recordVariant.toMap();
+        QString op = record["op"].toString();
+
+        if (op == "clear") {
+            entitiesByID.clear();
+            entityOrder.clear();
+        } else if (op == "delete") {
+            QString entityID = record["id"].toString();
+            if (entitiesByID.remove(entityID) > 0) {
+                entityOrder.removeOne(entityID);
+            }
+        } else if (op == "edit") {
+            QVariant entityVariant = record["entity"];
+            QString entityID = entityVariant.toMap()["id"].toString();
+            if (entityID.isEmpty()) {
+                qCDebug(entities) << "Skipping journal edit without an entity id";
+                continue;
+            }
+            if (!entitiesByID.contains(entityID)) {
+                entityOrder << entityID;
+            }
+            entitiesByID[entityID] = entityVariant;
+        } else {
+            qCDebug(entities) << "Skipping unknown journal record" << op;
+        }
+    }
+
+    QVariantList entitiesQList;
+    foreach (const QString& entityID, entityOrder) {
+        entitiesQList << entitiesByID[entityID];
+    }
+    entityDescription["Entities"] = entitiesQList;
+}
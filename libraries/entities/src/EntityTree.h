@@ -12,6 +12,9 @@
 #ifndef hifi_EntityTree_h
 #define hifi_EntityTree_h
 
+#include <functional>
+
+#include <QMutex>
 #include <QSet>
 #include <QVector>
 
@@ -89,6 +92,9 @@ public:
     void fixupTerseEditLogging(EntityItemProperties& properties, QList<QString>& changedProperties);
     virtual int processEditPacketData(ReceivedMessage& message, const unsigned char* editData, int maxLength,
                                       const SharedNodePointer& senderNode) override;
+    virtual bool canDecodeEditsAhead() const override { return true; }
+    virtual void decodeEditsAhead(const ReceivedMessage& message, int editsPosition) override;
+    virtual void releaseEditsDecodedAhead(const ReceivedMessage& message) override;
 
     virtual bool findRayIntersection(const glm::vec3& origin, const glm::vec3& direction,
         QVector<EntityItemID> entityIdsToInclude, QVector<EntityItemID> entityIdsToDiscard,
@@ -177,6 +183,8 @@ public:
     void forgetEntitiesDeletedBefore(quint64 sinceTime);
 
     int processEraseMessage(ReceivedMessage& message, const SharedNodePointer& sourceNode);
+    /// reads the IDs of an erase message, without taking the tree lock
+    QSet<EntityItemID> decodeEraseMessage(ReceivedMessage& message, const SharedNodePointer& sourceNode);
     int processEraseMessageDetails(const QByteArray& buffer, const SharedNodePointer& sourceNode);
 
     EntityItemFBXService* getFBXService() const { return _fbxService; }
@@ -199,6 +207,12 @@ public:
 
     void entityChanged(EntityItemPointer entity);
 
+    /// keeps the IDs of the changed entities that pass the filter, until they are taken with takeChangedEntities(),
+    /// for the clients that index a few of the entities. A null filter stops the tracking
+    void setChangedEntitiesFilter(std::function<bool(const EntityItem&)> filter);
+    QSet<EntityItemID> takeChangedEntities();
+    void trackChangedEntity(const EntityItem& entity); // for the changes that don't go through entityChanged()
+
     void emitEntityScriptChanging(const EntityItemID& entityItemID, const bool reload);
 
     void setSimulation(EntitySimulationPointer simulation);
@@ -214,6 +228,14 @@ public:
                             bool skipThoseWithBadParents) override;
     virtual bool readFromMap(QVariantMap& entityDescription) override;
 
+    virtual bool writeToBinarySnapshot(QIODevice& device, OctreeElementPointer element) override;
+    virtual bool readFromBinarySnapshot(const char* data, qint64 size) override;
+
+    virtual bool supportsJournal() const override { return true; }
+    virtual void setJournalEnabled(bool enabled) override;
+    virtual QVariantList takeJournalRecords() override;
+    virtual void replayJournalOnMap(QVariantMap& entityDescription, const QVariantList& records) const override;
+
     glm::vec3 getContentsDimensions();
     float getContentsLargestDimension();
 
@@ -345,6 +367,35 @@ protected:
     float _maxTmpEntityLifetime { DEFAULT_MAX_TMP_ENTITY_LIFETIME };
 
     QStringList _entityScriptSourceWhitelist;
+
+    // changes since the last takeJournalRecords(), only tracked while the persist thread keeps a journal
+    void journalChange(const EntityItemID& entityID);
+    void journalDelete(const EntityItemID& entityID, quint64 deletedAt);
+    QMutex _journalLock;
+    bool _isJournalEnabled { false };
+    bool _journalCleared { false };
+    QSet<EntityItemID> _journalChangedIDs;
+    QHash<EntityItemID, quint64> _journalDeletedIDs;
+
+    QMutex _changedEntitiesLock;
+    std::function<bool(const EntityItem&)> _changedEntitiesFilter;
+    QSet<EntityItemID> _changedEntityIDs;
+
+    // add and edit messages decoded by decodeEditsAhead(), until processEditPacketData() applies them
+    struct DecodedEdit {
+        const unsigned char* editData;
+        int processedBytes;
+        bool isValid;
+        EntityItemID entityItemID;
+        EntityItemProperties properties;
+    };
+    struct DecodedEdits {
+        QVector<DecodedEdit> edits;
+        int next { 0 }; // the edits before this one were applied already
+    };
+    bool takeEditDecodedAhead(const ReceivedMessage& message, const unsigned char* editData, DecodedEdit& decodedEdit);
+    QMutex _decodedEditsLock;
+    QHash<const ReceivedMessage*, DecodedEdits> _decodedEdits;
 };
 
 #endif // hifi_EntityTree_h
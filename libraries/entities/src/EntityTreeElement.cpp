@@ -9,11 +9,14 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
+
 #include <glm/gtx/transform.hpp>
 
 #include <FBXReader.h>
 #include <GeometryUtil.h>
 #include <OctreeUtils.h>
+#include <SlabPool.h>
 
 #include "EntitiesLogging.h"
 #include "EntityItemProperties.h"
@@ -29,6 +32,32 @@ EntityTreeElement::~EntityTreeElement() {
     _octreeMemoryUsage -= sizeof(EntityTreeElement);
 }
 
+// enough for the children of 64 elements, so the siblings created while a subtree is read in share the same pages
+static const size_t ELEMENTS_PER_SLAB = 64 * NUMBER_OF_CHILDREN;
+
+static SlabPool& getElementPool() {
+    // never destroyed, as the elements of trees held in statics may outlive it
+    static SlabPool* pool = new SlabPool(sizeof(EntityTreeElement), ELEMENTS_PER_SLAB);
+    return *pool;
+}
+
+void* EntityTreeElement::operator new(size_t size) {
+    SlabPool& pool = getElementPool();
+    if (size > pool.getBlockSize()) {
+        return ::operator new(size);
+    }
+    return pool.allocate();
+}
+
+void EntityTreeElement::operator delete(void* pointer, size_t size) {
+    SlabPool& pool = getElementPool();
+    if (size > pool.getBlockSize()) {
+        ::operator delete(pointer);
+    } else {
+        pool.deallocate(pointer);
+    }
+}
+
 OctreeElementPointer EntityTreeElement::createNewElement(unsigned char* octalCode) {
     auto newChild = EntityTreeElementPointer(new EntityTreeElement(octalCode));
     newChild->setTree(_myTree);
@@ -306,6 +335,8 @@ OctreeElement::AppendState EntityTreeElement::appendElementData(OctreePacketData
                     AACube entityCube = entity->getQueryAACube(success);
                     if (!success || !params.viewFrustum.cubeIntersectsKeyhole(entityCube)) {
                         includeThisEntity = false; // out of view, don't include it
+                    } else if (!params.isInInterest(entityCube) || !params.isTypeOfInterest(entity->getType())) {
+                        includeThisEntity = false; // outside of what the viewer asked for, don't include it
                     } else {
                         // Check the size of the entity, it's possible that a "too small to see" entity is included in a
                         // larger octree cell because of its position (for example if it crosses the boundary of a cell it
@@ -335,6 +366,11 @@ OctreeElement::AppendState EntityTreeElement::appendElementData(OctreePacketData
                                      << "..bounds:" << entityBounds << "\n"
                                      << "....cell:" << getAACube();
                             #endif
+                        } else if (includeThisEntity && !params.forceSendScene && !hadElementExtraData) {
+                            // the server may put off the change, for instance if this is a far entity that keeps moving
+                            float distance = glm::distance(params.viewFrustum.getPosition(), entityBounds.calcCenter());
+                            includeThisEntity = params.shouldSendItem(entity->getID(), entity->getLastChangedOnServer(),
+                                                                      distance, entity->isMoving());
                         }
                     }
                 }
@@ -362,6 +398,7 @@ OctreeElement::AppendState EntityTreeElement::appendElementData(OctreePacketData
         if (successAppendEntityCount) {
             foreach(uint16_t i, indexesOfEntitiesToInclude) {
                 EntityItemPointer entity = _entityItems[i];
+                int entityStartOffset = packetData->getUncompressedByteOffset();
                 LevelDetails entityLevel = packetData->startLevel();
                 OctreeElement::AppendState appendEntityState = entity->appendEntityData(packetData,
                     params, entityTreeElementExtraEncodeData);
@@ -375,6 +412,8 @@ OctreeElement::AppendState EntityTreeElement::appendElementData(OctreePacketData
                     // and include the entity in our final count of entities
                     packetData->endLevel(entityLevel);
                     actualNumberOfEntities++;
+                    params.itemSent(entity->getID(), entity->getLastChangedOnServer(),
+                                    packetData->getUncompressedByteOffset() - entityStartOffset);
                 }
 
                 // If the entity item got completely appended, then we can remove it from the extra encode data
@@ -550,25 +589,28 @@ bool EntityTreeElement::findRayIntersection(const glm::vec3& origin, const glm::
         return false; // we did not intersect
     }
 
+    // if the distance to the element cube is not less than the current best distance, then it's not possible
+    // for any details inside the cube to be closer - nor anything in our children, which are inside the cube too.
+    // the tree is walked nearest element first, so this prunes most of the elements behind the first hit.
+    if (!_cube.contains(origin) && distanceToElementCube >= distance) {
+        keepSearching = false;
+        return false;
+    }
+
     // by default, we only allow intersections with leaves with content
     if (!canRayIntersect()) {
         return false; // we don't intersect with non-leaves, and we keep searching
     }
 
-    // if the distance to the element cube is not less than the current best distance, then it's not possible
-    // for any details inside the cube to be closer so we don't need to consider them.
-    if (_cube.contains(origin) || distanceToElementCube < distance) {
-
-        if (findDetailedRayIntersection(origin, direction, keepSearching, element, distanceToElementDetails,
-                face, localSurfaceNormal, entityIdsToInclude, entityIdsToDiscard, visibleOnly, collidableOnly,
-                intersectedObject, precisionPicking, distanceToElementCube)) {
-
-            if (distanceToElementDetails < distance) {
-                distance = distanceToElementDetails;
-                face = localFace;
-                surfaceNormal = localSurfaceNormal;
-                return true;
-            }
+    if (findDetailedRayIntersection(origin, direction, keepSearching, element, distanceToElementDetails,
+            face, localSurfaceNormal, entityIdsToInclude, entityIdsToDiscard, visibleOnly, collidableOnly,
+            intersectedObject, precisionPicking, distanceToElementCube)) {
+
+        if (distanceToElementDetails < distance) {
+            distance = distanceToElementDetails;
+            face = localFace;
+            surfaceNormal = localSurfaceNormal;
+            return true;
         }
     }
     return false;
@@ -580,8 +622,8 @@ bool EntityTreeElement::findDetailedRayIntersection(const glm::vec3& origin, con
                                     bool visibleOnly, bool collidableOnly, void** intersectedObject, bool precisionPicking, float distanceToElementCube) {
 
     // only called if we do intersect our bounding cube, but find if we actually intersect with entities...
-    int entityNumber = 0;
-    bool somethingIntersected = false;
+    // first gather the entities whose boxes the ray hits before the best hit so far, sorted by where it enters them
+    std::vector<std::pair<float, EntityItemPointer>> candidates;
     forEachEntity([&](EntityItemPointer entity) {
         if ( (visibleOnly && !entity->isVisible()) || (collidableOnly && (entity->getCollisionless() || entity->getShapeType() == SHAPE_TYPE_NONE))
             || (entityIdsToInclude.size() > 0 && !entityIdsToInclude.contains(entity->getID()))
@@ -595,15 +637,41 @@ bool EntityTreeElement::findDetailedRayIntersection(const glm::vec3& origin, con
             return;
         }
 
-        float localDistance;
-        BoxFace localFace;
-        glm::vec3 localSurfaceNormal;
+        float boxDistance;
+        BoxFace boxFace;
+        glm::vec3 boxSurfaceNormal;
 
         // if the ray doesn't intersect with our cube, we can stop searching!
-        if (!entityBox.findRayIntersection(origin, direction, localDistance, localFace, localSurfaceNormal)) {
+        if (!entityBox.findRayIntersection(origin, direction, boxDistance, boxFace, boxSurfaceNormal)) {
             return;
         }
 
+        // from inside the box the ray intersection is where it leaves, but the entity may be right at the origin
+        if (entityBox.contains(origin)) {
+            boxDistance = 0.0f;
+        }
+        if (boxDistance < distance) {
+            candidates.emplace_back(boxDistance, entity);
+        }
+    });
+    std::sort(candidates.begin(), candidates.end(),
+        [](const std::pair<float, EntityItemPointer>& a, const std::pair<float, EntityItemPointer>& b) {
+            return a.first < b.first;
+        });
+
+    int entityNumber = 0;
+    bool somethingIntersected = false;
+    for (const auto& candidate : candidates) {
+        // nothing in the remaining boxes can be nearer than what we have hit
+        if (candidate.first >= distance) {
+            break;
+        }
+        const EntityItemPointer& entity = candidate.second;
+
+        float localDistance;
+        BoxFace localFace;
+        glm::vec3 localSurfaceNormal;
+
         // extents is the entity relative, scaled, centered extents of the entity
         glm::mat4 rotation = glm::mat4_cast(entity->getRotation());
         glm::mat4 translation = glm::translate(entity->getPosition());
@@ -651,7 +719,7 @@ bool EntityTreeElement::findDetailedRayIntersection(const glm::vec3& origin, con
             }
         }
         entityNumber++;
-    });
+    }
     return somethingIntersected;
 }
 
@@ -85,6 +85,10 @@ class EntityTreeElement : public OctreeElement, ReadWriteLockable {
 public:
     virtual ~EntityTreeElement();
 
+    // the elements come from a pool of slabs, so the elements created together are close together in memory
+    static void* operator new(size_t size);
+    static void operator delete(void* pointer, size_t size);
+
     // type safe versions of OctreeElement methods
     EntityTreeElementPointer getChildAtIndex(int index) const {
         return std::static_pointer_cast<EntityTreeElement>(OctreeElement::getChildAtIndex(index));
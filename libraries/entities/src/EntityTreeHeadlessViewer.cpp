@@ -10,6 +10,8 @@
 //
 
 #include "EntityTreeHeadlessViewer.h"
+
+#include "EntitiesLogging.h"
 #include "SimpleEntitySimulation.h"
 
 EntityTreeHeadlessViewer::EntityTreeHeadlessViewer()
@@ -39,6 +41,53 @@ void EntityTreeHeadlessViewer::update() {
     }
 }
 
+void EntityTreeHeadlessViewer::setInterestTypes(const QStringList& typeNames) {
+    quint32 interestTypes = ALL_INTEREST_TYPES;
+    if (!typeNames.isEmpty()) {
+        interestTypes = 0;
+        foreach (const QString& typeName, typeNames) {
+            EntityTypes::EntityType type = EntityTypes::getEntityTypeFromName(typeName);
+            if (type == EntityTypes::Unknown) {
+                qCWarning(entities) << "EntityTreeHeadlessViewer::setInterestTypes() unknown entity type" << typeName;
+                continue;
+            }
+            interestTypes |= (1U << type);
+        }
+    }
+    _octreeQuery.setInterestTypes(interestTypes);
+    interestChanged();
+}
+
+void EntityTreeHeadlessViewer::interestChanged() {
+    if (!_tree) {
+        return;
+    }
+
+    EntityTreePointer tree = std::static_pointer_cast<EntityTree>(_tree);
+    bool hasInterestBox = _octreeQuery.hasInterestBox();
+    const AABox& interestBox = _octreeQuery.getInterestBox();
+    quint32 interestTypes = _octreeQuery.getInterestTypes();
+
+    tree->withWriteLock([&] {
+        QVector<EntityItemPointer> entities;
+        tree->findEntities(AACube(glm::vec3(-HALF_TREE_SCALE), TREE_SCALE), entities);
+
+        QSet<EntityItemID> entitiesToDelete;
+        foreach (const EntityItemPointer& entity, entities) {
+            bool success;
+            AACube entityCube = entity->getQueryAACube(success);
+            bool inBox = !hasInterestBox || (success && interestBox.touches(entityCube));
+            bool ofInterestType = (interestTypes & (1U << entity->getType())) != 0;
+            if (!inBox || !ofInterestType) {
+                entitiesToDelete << entity->getEntityItemID();
+            }
+        }
+        if (!entitiesToDelete.isEmpty()) {
+            tree->deleteEntities(entitiesToDelete, true);
+        }
+    });
+}
+
 void EntityTreeHeadlessViewer::processEraseMessage(ReceivedMessage& message, const SharedNodePointer& sourceNode) {
     std::static_pointer_cast<EntityTree>(_tree)->processEraseMessage(message, sourceNode);
 }
@@ -42,7 +42,14 @@ public:
 
     virtual void init() override;
 
+public slots:
+    // the entity types (by name, like "Model") the entity server should send, all of them when empty
+    void setInterestTypes(const QStringList& typeNames);
+
 protected:
+    // drops the entities we have that are no longer of interest, the server won't send anything more about them
+    virtual void interestChanged() override;
+
     virtual OctreePointer createTree() override {
         EntityTreePointer newTree = EntityTreePointer(new EntityTree(true));
         newTree->createRootElement();
@@ -76,6 +76,11 @@ void MovingEntitiesOperator::addEntityToMoveList(EntityItemPointer entity, const
     // If the original containing element is the best fit for the requested newCube locations then
     // we don't actually need to add the entity for moving and we can short circuit all this work
     if (!oldContainingElement->bestFitBounds(newCubeClamped)) {
+        if (_entityIDsToMove.contains(entity->getEntityItemID())) {
+            return; // already on the list
+        }
+        _entityIDsToMove.insert(entity->getEntityItemID());
+
         // check our tree, to determine if this entity is known
         EntityToMoveDetails details;
         details.oldContainingElement = oldContainingElement;
@@ -108,8 +113,9 @@ void MovingEntitiesOperator::addEntityToMoveList(EntityItemPointer entity, const
     }
 }
 
-// does this entity tree element contain the old entity
-bool MovingEntitiesOperator::shouldRecurseSubTree(OctreeElementPointer element) {
+// does this entity tree element contain the old entity, if onlyUnfinished then entities that are already in their
+// new element are not considered
+bool MovingEntitiesOperator::shouldRecurseSubTree(OctreeElementPointer element, bool onlyUnfinished) {
     bool containsEntity = false;
 
     // If we don't have an old entity, then we don't contain the entity, otherwise
@@ -118,6 +124,10 @@ bool MovingEntitiesOperator::shouldRecurseSubTree(OctreeElementPointer element)
         const AACube& elementCube = element->getAACube();
         int detailIndex = 0;
         foreach(const EntityToMoveDetails& details, _entitiesToMove) {
+            if (onlyUnfinished && details.oldFound && details.newFound) {
+                detailIndex++;
+                continue;
+            }
 
             if (_wantDebug) {
                 qCDebug(entities) << "MovingEntitiesOperator::shouldRecurseSubTree() details["<< detailIndex <<"]-----------------------------";
@@ -157,11 +167,14 @@ bool MovingEntitiesOperator::preRecursion(OctreeElementPointer element) {
 
     // If we haven't yet found all the entities, and this sub tree contains at least one of our
     // entities, then we need to keep searching.
-    if (keepSearching && shouldRecurseSubTree(element)) {
+    if (keepSearching && shouldRecurseSubTree(element, true)) {
 
         // check against each of our search entities
-        int detailIndex = 0;
-        foreach(const EntityToMoveDetails& details, _entitiesToMove) {
+        for (int detailIndex = 0; detailIndex < _entitiesToMove.size(); detailIndex++) {
+            EntityToMoveDetails& details = _entitiesToMove[detailIndex];
+            if (details.oldFound && details.newFound) {
+                continue;
+            }
         
             if (_wantDebug) {
                 qCDebug(entities) << "MovingEntitiesOperator::preRecursion() details["<< detailIndex <<"]-----------------------------";
@@ -182,7 +195,7 @@ bool MovingEntitiesOperator::preRecursion(OctreeElementPointer element) {
             if (!details.oldFound && entityTreeElement == details.oldContainingElement) {
                 // DO NOT remove the entity here.  It will be removed when added to the destination element.
                 _foundOldCount++;
-                //details.oldFound = true; // TODO: would be nice to add this optimization
+                details.oldFound = true;
                 if (_wantDebug) {
                     qCDebug(entities) << "MovingEntitiesOperator::preRecursion() -----------------------------";
                     qCDebug(entities) << "    FOUND OLD - REMOVING";
@@ -204,7 +217,7 @@ bool MovingEntitiesOperator::preRecursion(OctreeElementPointer element) {
                     _tree->setContainingElement(entityItemID, entityTreeElement);
                 }
                 _foundNewCount++;
-                //details.newFound = true; // TODO: would be nice to add this optimization
+                details.newFound = true;
                 if (_wantDebug) {
                     qCDebug(entities) << "MovingEntitiesOperator::preRecursion() -----------------------------";
                     qCDebug(entities) << "    FOUND NEW - ADDING";
@@ -212,7 +225,6 @@ bool MovingEntitiesOperator::preRecursion(OctreeElementPointer element) {
                     qCDebug(entities) << "--------------------------------------------------------------------------";
                 }
             }
-            detailIndex++;
         }
         // if we haven't found all of our search for entities, then keep looking
         keepSearching = (_foundOldCount < _lookingCount) || (_foundNewCount < _lookingCount);
@@ -229,12 +241,7 @@ bool MovingEntitiesOperator::postRecursion(OctreeElementPointer element) {
 
     // As we unwind, if we're in either of these two paths, we mark our element
     // as dirty.
-    if ((shouldRecurseSubTree(element))) {
-        element->markWithChangedTime();
-    }
-    
-
-
+    //
     // It's not OK to prune if we have the potential of deleting the original containing element
     // because if we prune the containing element then new might end up reallocating the same memory later 
     // and that will confuse our logic.
@@ -242,17 +249,32 @@ bool MovingEntitiesOperator::postRecursion(OctreeElementPointer element) {
     // it's ok to prune if:
     // 2) this subtree doesn't contain any old elements
     // 3) this subtree contains an old element, but this element isn't a direct parent of any old containing element
-
+    //
+    // all of these are found in one pass over the moving entities, which stops once they are all known
+    const AACube& elementCube = element->getAACube();
+    bool elementIsOnAPath = false;
     bool elementSubTreeContainsOldElements = false;
     bool elementIsDirectParentOfOldElment = false;
     foreach(const EntityToMoveDetails& details, _entitiesToMove) {
-        if (element->getAACube().contains(details.oldContainingElementCube)) {
+        bool containsOldElement = elementCube.contains(details.oldContainingElementCube);
+        if (containsOldElement) {
             elementSubTreeContainsOldElements = true;
+            elementIsOnAPath = true;
+            if (!elementIsDirectParentOfOldElment && element->isParentOf(details.oldContainingElement)) {
+                elementIsDirectParentOfOldElment = true;
+            }
+        } else if (!elementIsOnAPath && elementCube.contains(details.newCubeClamped)) {
+            elementIsOnAPath = true;
         }
-        if (element->isParentOf(details.oldContainingElement)) {
-            elementIsDirectParentOfOldElment = true;
+        if (elementIsOnAPath && elementIsDirectParentOfOldElment) {
+            break;
         }
     }
+
+    if (elementIsOnAPath) {
+        element->markWithChangedTime();
+    }
+
     if (!elementSubTreeContainsOldElements || !elementIsDirectParentOfOldElment) {
         EntityTreeElementPointer entityTreeElement = std::static_pointer_cast<EntityTreeElement>(element);
         entityTreeElement->pruneChildren(); // take this opportunity to prune any empty leaves
@@ -44,12 +44,13 @@ public:
     bool hasMovingEntities() const { return _entitiesToMove.size() > 0; }
 private:
     EntityTreePointer _tree;
-    QSet<EntityToMoveDetails> _entitiesToMove;
+    QVector<EntityToMoveDetails> _entitiesToMove; // only the entities that leave their containing element
+    QSet<EntityItemID> _entityIDsToMove;
     quint64 _changeTime;
     int _foundOldCount;
     int _foundNewCount;
     int _lookingCount;
-    bool shouldRecurseSubTree(OctreeElementPointer element);
+    bool shouldRecurseSubTree(OctreeElementPointer element, bool onlyUnfinished = false);
     
     bool _wantDebug;
 };
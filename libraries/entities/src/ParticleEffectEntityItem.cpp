@@ -41,6 +41,8 @@
 #include "ParticleEffectEntityItem.h"
 
 const float SCRIPT_MAXIMUM_PI = 3.1416f;  // Round up so that reasonable property values work
+// Past this the particle simulation clock is moved back to zero, before its precision drops under a tenth of a millisecond
+const float SIMULATION_TIME_REBASE = 1024.0f;
 
 const xColor ParticleEffectEntityItem::DEFAULT_COLOR = { 255, 255, 255 };
 const xColor ParticleEffectEntityItem::DEFAULT_COLOR_SPREAD = { 0, 0, 0 };
@@ -137,8 +139,9 @@ void ParticleEffectEntityItem::setAlphaSpread(float alphaSpread) {
 }
 
 void ParticleEffectEntityItem::setLifespan(float lifespan) {
-    if (MINIMUM_LIFESPAN <= lifespan && lifespan <= MAXIMUM_LIFESPAN) {
+    if (_lifespan != lifespan && MINIMUM_LIFESPAN <= lifespan && lifespan <= MAXIMUM_LIFESPAN) {
         _lifespan = lifespan;
+        ++_particlesResetCount;
     }
 }
 
@@ -591,29 +594,22 @@ void ParticleEffectEntityItem::setShapeType(ShapeType type) {
     }
 }
 
-void ParticleEffectEntityItem::integrateParticle(Particle& particle, float deltaTime) {
-    glm::vec3 atSquared = (0.5f * deltaTime * deltaTime) * particle.acceleration;
-    glm::vec3 at = particle.acceleration * deltaTime;
-    particle.position += particle.velocity * deltaTime + atSquared;
-    particle.velocity += at;
+float ParticleEffectEntityItem::getParticleAge(const Particle& particle) const {
+    return _simulationTime - particle.emitTime;
+}
+
+glm::vec3 ParticleEffectEntityItem::getParticlePosition(const Particle& particle) const {
+    float age = getParticleAge(particle);
+    return particle.position + particle.velocity * age + (0.5f * age * age) * particle.acceleration;
 }
 
 void ParticleEffectEntityItem::stepSimulation(float deltaTime) {
-    // update particles between head and tail
-    int popCount = 0;
-    for (Particle& particle : _particles) {
-        particle.lifetime += deltaTime;
-
-        // if particle has died.
-        if (particle.lifetime >= _lifespan) {
-            // move head forward
-            popCount++;
-        } else {
-            // Otherwise update it
-            integrateParticle(particle, deltaTime);
-        }
+    _simulationTime += deltaTime;
+
+    // the particles share the lifespan and are in emission order, so the dead ones are at the head
+    while (!_particles.empty() && getParticleAge(_particles.front()) >= _lifespan) {
+        _particles.pop_front();
     }
-    _particles.erase(_particles.begin(), _particles.begin() + popCount);
 
     // emit new particles, but only if we are emmitting
     if (getIsEmitting() && _emitRate > 0.0f && _lifespan > 0.0f && _polarStart <= _polarFinish) {
@@ -630,11 +626,8 @@ void ParticleEffectEntityItem::stepSimulation(float deltaTime) {
             // emit a new particle at tail index.
             _particles.push_back(createParticle(glm::mix(_previousPosition, getPosition(),
                 (deltaTime - timeLeftInFrame) / deltaTime)));
-            auto particle = _particles.back();
-            particle.lifetime += timeLeftInFrame;
-            
-            // Initialize it
-            integrateParticle(particle, deltaTime);
+            _particles.back().emitTime = _simulationTime - (timeLeftInFrame - _timeUntilNextEmit);
+            ++_emittedParticleCount;
             
             // Advance in frame
             timeLeftInFrame -= _timeUntilNextEmit;
@@ -644,6 +637,14 @@ void ParticleEffectEntityItem::stepSimulation(float deltaTime) {
         _timeUntilNextEmit -= timeLeftInFrame;
     }
     _previousPosition = getPosition();
+
+    if (_simulationTime > SIMULATION_TIME_REBASE) {
+        for (Particle& particle : _particles) {
+            particle.emitTime -= _simulationTime;
+        }
+        _simulationTime = 0.0f;
+        ++_particlesResetCount;
+    }
 }
 
 ParticleEffectEntityItem::Particle ParticleEffectEntityItem::createParticle(const glm::vec3& position) {
@@ -728,6 +729,7 @@ void ParticleEffectEntityItem::setMaxParticles(quint32 maxParticles) {
         while (_particles.size() > _maxParticles) {
             _particles.pop_front();
         }
+        ++_particlesResetCount;
 
         // effectively clear all particles and start emitting new ones from scratch.
         _timeUntilNextEmit = 0.0f;
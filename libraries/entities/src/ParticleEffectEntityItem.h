@@ -229,18 +229,28 @@ protected:
     
     Particle createParticle(const glm::vec3& position);
     void stepSimulation(float deltaTime);
-    void integrateParticle(Particle& particle, float deltaTime);
+    float getParticleAge(const Particle& particle) const;
+    glm::vec3 getParticlePosition(const Particle& particle) const;
     
+    // A particle keeps the state it was emitted with, its motion under a constant acceleration
+    // is evaluated from its age, on the CPU or in the particle shader
     struct Particle {
         float seed { 0.0f };
-        float lifetime { 0.0f };
+        float emitTime { 0.0f }; // on the simulation clock
         glm::vec3 position { Vectors::ZERO };
         glm::vec3 velocity { Vectors::ZERO };
         glm::vec3 acceleration { Vectors::ZERO };
     };
     
-    // Particles container
+    // Particles container, in emission order
     Particles _particles;
+    // The seconds simulated, rebased now and then to keep its precision
+    float _simulationTime { 0.0f };
+    // The particles ever emitted, the particle at index i in the container was emitted
+    // (_emittedParticleCount - _particles.size() + i)th
+    quint64 _emittedParticleCount { 0 };
+    // Changes when the particles can't be updated incrementally from their emission anymore
+    quint32 _particlesResetCount { 0 };
     
     // Particles properties
     rgbColor _color;
@@ -11,17 +11,17 @@
 
 #include "EntityTree.h"
 
+// Collects the properties of the entities to save. The copies share their strings and buffers with the entities, so
+// this is cheap enough to do while the tree is locked, and the conversion to a map can happen after it is unlocked.
 class RecurseOctreeToMapOperator : public RecurseOctreeOperator {
 public:
-    RecurseOctreeToMapOperator(QVariantMap& map, OctreeElementPointer top, QScriptEngine* engine, bool skipDefaultValues,
+    RecurseOctreeToMapOperator(QVector<EntityItemProperties>& entityProperties, OctreeElementPointer top,
                                bool skipThoseWithBadParents);
     bool preRecursion(OctreeElementPointer element) override;
     bool postRecursion(OctreeElementPointer element) override;
  private:
-    QVariantMap& _map;
+    QVector<EntityItemProperties>& _entityProperties;
     OctreeElementPointer _top;
-    QScriptEngine* _engine;
     bool _withinTop;
-    bool _skipDefaultValues;
     bool _skipThoseWithBadParents;
 };
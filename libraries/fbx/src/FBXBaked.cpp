@@ -0,0 +1,485 @@
+//
+//  FBXBaked.cpp
+//  libraries/fbx/src
+//
+//  Created by Sam Gateau on 10/15/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "FBXBaked.h"
+
+#include <QtCore/QDataStream>
+
+#include <shared/NsightHelpers.h>
+
+#include "ModelFormatLogging.h"
+
+using namespace fbxbaked;
+
+static const QByteArray MAGIC = "HIFI BAKED FBX\n";
+static const quint32 VERSION = 1;
+
+// The values and arrays are written as they are in memory, the baked files are made for little endian clients
+class BakedWriter {
+public:
+    BakedWriter(QByteArray* data) : _out(data, QIODevice::WriteOnly) {
+        _out.setByteOrder(QDataStream::LittleEndian);
+    }
+
+    void write(const QByteArray& data) {
+        _out.writeRawData(data.constData(), data.size());
+    }
+
+    template<class T> void value(const T& value) {
+        _out.writeRawData(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template<class T> void vector(const QVector<T>& values) {
+        _out << (quint32)values.size();
+        _out.writeRawData(reinterpret_cast<const char*>(values.constData()), values.size() * sizeof(T));
+    }
+
+    template<class T> void object(const T& object) {
+        _out << object;
+    }
+
+private:
+    QDataStream _out;
+};
+
+class BakedReader {
+public:
+    BakedReader(const QByteArray& data) : _in(data), _size(data.size()) {
+        _in.setByteOrder(QDataStream::LittleEndian);
+    }
+
+    void read(char* destination, qint64 length) {
+        if (length > _size - _in.device()->pos() || _in.readRawData(destination, length) != length) {
+            throw QString("truncated baked geometry");
+        }
+    }
+
+    template<class T> T value() {
+        T value;
+        read(reinterpret_cast<char*>(&value), sizeof(T));
+        return value;
+    }
+
+    template<class T> QVector<T> vector() {
+        quint32 size = value<quint32>();
+        if ((qint64)size * (qint64)sizeof(T) > _size - _in.device()->pos()) {
+            throw QString("truncated baked geometry");
+        }
+        QVector<T> values(size);
+        read(reinterpret_cast<char*>(values.data()), size * sizeof(T));
+        return values;
+    }
+
+    template<class T> T object() {
+        T object;
+        _in >> object;
+        if (_in.status() != QDataStream::Ok) {
+            throw QString("truncated baked geometry");
+        }
+        return object;
+    }
+
+private:
+    QDataStream _in;
+    qint64 _size;
+};
+
+static void writeTexture(BakedWriter& writer, const FBXTexture& texture) {
+    writer.object(texture.name);
+    writer.object(texture.filename);
+    writer.object(texture.content);
+    writer.value(texture.transform.getTranslation());
+    writer.value(texture.transform.getRotation());
+    writer.value(texture.transform.getScale());
+    writer.value(texture.texcoordSet);
+    writer.object(texture.texcoordSetName);
+    writer.value(texture.isBumpmap);
+}
+
+static FBXTexture readTexture(BakedReader& reader) {
+    FBXTexture texture;
+    texture.name = reader.object<QString>();
+    texture.filename = reader.object<QByteArray>();
+    texture.content = reader.object<QByteArray>();
+    texture.transform.setTranslation(reader.value<glm::vec3>());
+    texture.transform.setRotation(reader.value<glm::quat>());
+    texture.transform.setScale(reader.value<glm::vec3>());
+    texture.texcoordSet = reader.value<int>();
+    texture.texcoordSetName = reader.object<QString>();
+    texture.isBumpmap = reader.value<bool>();
+    return texture;
+}
+
+static void writeMaterial(BakedWriter& writer, const FBXMaterial& material) {
+    writer.value(material.diffuseColor);
+    writer.value(material.diffuseFactor);
+    writer.value(material.specularColor);
+    writer.value(material.specularFactor);
+    writer.value(material.emissiveColor);
+    writer.value(material.emissiveFactor);
+    writer.value(material.shininess);
+    writer.value(material.opacity);
+    writer.value(material.metallic);
+    writer.value(material.roughness);
+    writer.value(material.emissiveIntensity);
+    writer.value(material.ambientFactor);
+    writer.object(material.materialID);
+    writer.object(material.name);
+    writer.object(material.shadingModel);
+
+    for (auto texture : { &material.normalTexture, &material.albedoTexture, &material.opacityTexture,
+            &material.glossTexture, &material.roughnessTexture, &material.specularTexture, &material.metallicTexture,
+            &material.emissiveTexture, &material.occlusionTexture, &material.scatteringTexture, &material.lightmapTexture }) {
+        writeTexture(writer, *texture);
+    }
+    writer.value(material.lightmapParams);
+
+    writer.value(material.isPBSMaterial);
+    writer.value(material.useNormalMap);
+    writer.value(material.useAlbedoMap);
+    writer.value(material.useOpacityMap);
+    writer.value(material.useRoughnessMap);
+    writer.value(material.useSpecularMap);
+    writer.value(material.useMetallicMap);
+    writer.value(material.useEmissiveMap);
+    writer.value(material.useOcclusionMap);
+
+    // The resolved model material, in linear space
+    static const model::Material DEFAULT_MATERIAL;
+    const model::Material& resolved = material._material ? *material._material : DEFAULT_MATERIAL;
+    writer.value(resolved.getEmissive(false));
+    writer.value(resolved.getAlbedo(false));
+    writer.value(resolved.getRoughness());
+    writer.value(resolved.getMetallic());
+    writer.value(resolved.getScattering());
+    writer.value(resolved.getOpacity());
+    writer.value(resolved.isUnlit());
+}
+
+static FBXMaterial readMaterial(BakedReader& reader) {
+    FBXMaterial material;
+    material.diffuseColor = reader.value<glm::vec3>();
+    material.diffuseFactor = reader.value<float>();
+    material.specularColor = reader.value<glm::vec3>();
+    material.specularFactor = reader.value<float>();
+    material.emissiveColor = reader.value<glm::vec3>();
+    material.emissiveFactor = reader.value<float>();
+    material.shininess = reader.value<float>();
+    material.opacity = reader.value<float>();
+    material.metallic = reader.value<float>();
+    material.roughness = reader.value<float>();
+    material.emissiveIntensity = reader.value<float>();
+    material.ambientFactor = reader.value<float>();
+    material.materialID = reader.object<QString>();
+    material.name = reader.object<QString>();
+    material.shadingModel = reader.object<QString>();
+
+    for (auto texture : { &material.normalTexture, &material.albedoTexture, &material.opacityTexture,
+            &material.glossTexture, &material.roughnessTexture, &material.specularTexture, &material.metallicTexture,
+            &material.emissiveTexture, &material.occlusionTexture, &material.scatteringTexture, &material.lightmapTexture }) {
+        *texture = readTexture(reader);
+    }
+    material.lightmapParams = reader.value<glm::vec2>();
+
+    material.isPBSMaterial = reader.value<bool>();
+    material.useNormalMap = reader.value<bool>();
+    material.useAlbedoMap = reader.value<bool>();
+    material.useOpacityMap = reader.value<bool>();
+    material.useRoughnessMap = reader.value<bool>();
+    material.useSpecularMap = reader.value<bool>();
+    material.useMetallicMap = reader.value<bool>();
+    material.useEmissiveMap = reader.value<bool>();
+    material.useOcclusionMap = reader.value<bool>();
+
+    material._material = std::make_shared<model::Material>();
+    material._material->setEmissive(reader.value<glm::vec3>(), false);
+    material._material->setAlbedo(reader.value<glm::vec3>(), false);
+    material._material->setRoughness(reader.value<float>());
+    material._material->setMetallic(reader.value<float>());
+    material._material->setScattering(reader.value<float>());
+    material._material->setOpacity(reader.value<float>());
+    material._material->setUnlit(reader.value<bool>());
+    return material;
+}
+
+static void writeMesh(BakedWriter& writer, const FBXMesh& mesh) {
+    writer.value((quint32)mesh.parts.size());
+    for (const FBXMeshPart& part : mesh.parts) {
+        writer.vector(part.quadIndices);
+        writer.vector(part.quadTrianglesIndices);
+        writer.vector(part.triangleIndices);
+        writer.object(part.materialID);
+    }
+
+    writer.vector(mesh.vertices);
+    writer.vector(mesh.normals);
+    writer.vector(mesh.tangents);
+    writer.vector(mesh.colors);
+    writer.vector(mesh.texCoords);
+    writer.vector(mesh.texCoords1);
+    writer.vector(mesh.clusterIndices);
+    writer.vector(mesh.clusterWeights);
+    writer.vector(mesh.clusters);
+
+    writer.value(mesh.meshExtents);
+    writer.value(mesh.modelTransform);
+    writer.value(mesh.isEye);
+
+    writer.value((quint32)mesh.blendshapes.size());
+    for (const FBXBlendshape& blendshape : mesh.blendshapes) {
+        writer.vector(blendshape.indices);
+        writer.vector(blendshape.vertices);
+        writer.vector(blendshape.normals);
+    }
+
+    writer.value(mesh.meshIndex);
+}
+
+static FBXMesh readMesh(BakedReader& reader) {
+    FBXMesh mesh;
+    quint32 numParts = reader.value<quint32>();
+    for (quint32 i = 0; i < numParts; i++) {
+        FBXMeshPart part;
+        part.quadIndices = reader.vector<int>();
+        part.quadTrianglesIndices = reader.vector<int>();
+        part.triangleIndices = reader.vector<int>();
+        part.materialID = reader.object<QString>();
+        mesh.parts.append(part);
+    }
+
+    mesh.vertices = reader.vector<glm::vec3>();
+    mesh.normals = reader.vector<glm::vec3>();
+    mesh.tangents = reader.vector<glm::vec3>();
+    mesh.colors = reader.vector<glm::vec3>();
+    mesh.texCoords = reader.vector<glm::vec2>();
+    mesh.texCoords1 = reader.vector<glm::vec2>();
+    mesh.clusterIndices = reader.vector<glm::vec4>();
+    mesh.clusterWeights = reader.vector<glm::vec4>();
+    mesh.clusters = reader.vector<FBXCluster>();
+
+    mesh.meshExtents = reader.value<Extents>();
+    mesh.modelTransform = reader.value<glm::mat4>();
+    mesh.isEye = reader.value<bool>();
+
+    quint32 numBlendshapes = reader.value<quint32>();
+    for (quint32 i = 0; i < numBlendshapes; i++) {
+        FBXBlendshape blendshape;
+        blendshape.indices = reader.vector<int>();
+        blendshape.vertices = reader.vector<glm::vec3>();
+        blendshape.normals = reader.vector<glm::vec3>();
+        mesh.blendshapes.append(blendshape);
+    }
+
+    mesh.meshIndex = reader.value<unsigned int>();
+    return mesh;
+}
+
+static void writeJoint(BakedWriter& writer, const FBXJoint& joint) {
+    writer.vector(joint.shapeInfo.points);
+    writer.vector(joint.freeLineage);
+    writer.value(joint.isFree);
+    writer.value(joint.parentIndex);
+    writer.value(joint.distanceToParent);
+    writer.value(joint.translation);
+    writer.value(joint.preTransform);
+    writer.value(joint.preRotation);
+    writer.value(joint.rotation);
+    writer.value(joint.postRotation);
+    writer.value(joint.postTransform);
+    writer.value(joint.transform);
+    writer.value(joint.rotationMin);
+    writer.value(joint.rotationMax);
+    writer.value(joint.inverseDefaultRotation);
+    writer.value(joint.inverseBindRotation);
+    writer.value(joint.bindTransform);
+    writer.object(joint.name);
+    writer.value(joint.isSkeletonJoint);
+    writer.value(joint.bindTransformFoundInCluster);
+}
+
+static FBXJoint readJoint(BakedReader& reader) {
+    FBXJoint joint;
+    joint.shapeInfo.points = reader.vector<glm::vec3>();
+    joint.freeLineage = reader.vector<int>();
+    joint.isFree = reader.value<bool>();
+    joint.parentIndex = reader.value<int>();
+    joint.distanceToParent = reader.value<float>();
+    joint.translation = reader.value<glm::vec3>();
+    joint.preTransform = reader.value<glm::mat4>();
+    joint.preRotation = reader.value<glm::quat>();
+    joint.rotation = reader.value<glm::quat>();
+    joint.postRotation = reader.value<glm::quat>();
+    joint.postTransform = reader.value<glm::mat4>();
+    joint.transform = reader.value<glm::mat4>();
+    joint.rotationMin = reader.value<glm::vec3>();
+    joint.rotationMax = reader.value<glm::vec3>();
+    joint.inverseDefaultRotation = reader.value<glm::quat>();
+    joint.inverseBindRotation = reader.value<glm::quat>();
+    joint.bindTransform = reader.value<glm::mat4>();
+    joint.name = reader.object<QString>();
+    joint.isSkeletonJoint = reader.value<bool>();
+    joint.bindTransformFoundInCluster = reader.value<bool>();
+    return joint;
+}
+
+bool fbxbaked::isBakedGeometry(const QByteArray& data) {
+    return data.startsWith(MAGIC);
+}
+
+FBXGeometry* fbxbaked::read(const QByteArray& data, const QString& url) {
+    PROFILE_RANGE(__FUNCTION__);
+    if (!isBakedGeometry(data)) {
+        throw QString("not a baked geometry");
+    }
+    BakedReader reader(data);
+    QByteArray magic(MAGIC.size(), 0);
+    reader.read(magic.data(), magic.size());
+    quint32 version = reader.value<quint32>();
+    if (version != VERSION) {
+        throw QString("unsupported baked geometry version ") + QString::number(version);
+    }
+
+    std::unique_ptr<FBXGeometry> geometryPtr(new FBXGeometry());
+    FBXGeometry& geometry = *geometryPtr;
+
+    geometry.author = reader.object<QString>();
+    geometry.applicationName = reader.object<QString>();
+
+    quint32 numJoints = reader.value<quint32>();
+    for (quint32 i = 0; i < numJoints; i++) {
+        geometry.joints.append(readJoint(reader));
+    }
+    geometry.jointIndices = reader.object<QHash<QString, int>>();
+    geometry.hasSkeletonJoints = reader.value<bool>();
+
+    // The mesh buffers are built from the baked arrays, nothing else is computed
+    quint32 numMeshes = reader.value<quint32>();
+    for (quint32 i = 0; i < numMeshes; i++) {
+        FBXMesh mesh = readMesh(reader);
+        FBXReader::buildModelMesh(mesh, url);
+        geometry.meshes.append(mesh);
+    }
+
+    quint32 numMaterials = reader.value<quint32>();
+    for (quint32 i = 0; i < numMaterials; i++) {
+        QString key = reader.object<QString>();
+        geometry.materials.insert(key, readMaterial(reader));
+    }
+
+    geometry.offset = reader.value<glm::mat4>();
+    geometry.leftEyeJointIndex = reader.value<int>();
+    geometry.rightEyeJointIndex = reader.value<int>();
+    geometry.neckJointIndex = reader.value<int>();
+    geometry.rootJointIndex = reader.value<int>();
+    geometry.leanJointIndex = reader.value<int>();
+    geometry.headJointIndex = reader.value<int>();
+    geometry.leftHandJointIndex = reader.value<int>();
+    geometry.rightHandJointIndex = reader.value<int>();
+    geometry.leftToeJointIndex = reader.value<int>();
+    geometry.rightToeJointIndex = reader.value<int>();
+    geometry.leftEyeSize = reader.value<float>();
+    geometry.rightEyeSize = reader.value<float>();
+    geometry.humanIKJointIndices = reader.vector<int>();
+    geometry.palmDirection = reader.value<glm::vec3>();
+
+    quint32 numSittingPoints = reader.value<quint32>();
+    for (quint32 i = 0; i < numSittingPoints; i++) {
+        SittingPoint sittingPoint;
+        sittingPoint.name = reader.object<QString>();
+        sittingPoint.position = reader.value<glm::vec3>();
+        sittingPoint.rotation = reader.value<glm::quat>();
+        geometry.sittingPoints.append(sittingPoint);
+    }
+
+    geometry.neckPivot = reader.value<glm::vec3>();
+    geometry.bindExtents = reader.value<Extents>();
+    geometry.meshExtents = reader.value<Extents>();
+
+    quint32 numFrames = reader.value<quint32>();
+    for (quint32 i = 0; i < numFrames; i++) {
+        FBXAnimationFrame frame;
+        frame.rotations = reader.vector<glm::quat>();
+        frame.translations = reader.vector<glm::vec3>();
+        geometry.animationFrames.append(frame);
+    }
+
+    geometry.meshIndicesToModelNames = reader.object<QHash<int, QString>>();
+    geometry.blendshapeChannelNames = reader.object<QList<QString>>();
+
+    qCDebug(modelformat) << "Read baked geometry" << url << geometry.meshes.size() << "meshes," << geometry.joints.size() << "joints";
+    return geometryPtr.release();
+}
+
+QByteArray fbxbaked::write(const FBXGeometry& geometry) {
+    QByteArray data;
+    BakedWriter writer(&data);
+    writer.write(MAGIC);
+    writer.value(VERSION);
+
+    writer.object(geometry.author);
+    writer.object(geometry.applicationName);
+
+    writer.value((quint32)geometry.joints.size());
+    for (const FBXJoint& joint : geometry.joints) {
+        writeJoint(writer, joint);
+    }
+    writer.object(geometry.jointIndices);
+    writer.value(geometry.hasSkeletonJoints);
+
+    writer.value((quint32)geometry.meshes.size());
+    for (const FBXMesh& mesh : geometry.meshes) {
+        writeMesh(writer, mesh);
+    }
+
+    writer.value((quint32)geometry.materials.size());
+    for (auto it = geometry.materials.constBegin(); it != geometry.materials.constEnd(); it++) {
+        writer.object(it.key());
+        writeMaterial(writer, it.value());
+    }
+
+    writer.value(geometry.offset);
+    writer.value(geometry.leftEyeJointIndex);
+    writer.value(geometry.rightEyeJointIndex);
+    writer.value(geometry.neckJointIndex);
+    writer.value(geometry.rootJointIndex);
+    writer.value(geometry.leanJointIndex);
+    writer.value(geometry.headJointIndex);
+    writer.value(geometry.leftHandJointIndex);
+    writer.value(geometry.rightHandJointIndex);
+    writer.value(geometry.leftToeJointIndex);
+    writer.value(geometry.rightToeJointIndex);
+    writer.value(geometry.leftEyeSize);
+    writer.value(geometry.rightEyeSize);
+    writer.vector(geometry.humanIKJointIndices);
+    writer.value(geometry.palmDirection);
+
+    writer.value((quint32)geometry.sittingPoints.size());
+    for (const SittingPoint& sittingPoint : geometry.sittingPoints) {
+        writer.object(sittingPoint.name);
+        writer.value(sittingPoint.position);
+        writer.value(sittingPoint.rotation);
+    }
+
+    writer.value(geometry.neckPivot);
+    writer.value(geometry.bindExtents);
+    writer.value(geometry.meshExtents);
+
+    writer.value((quint32)geometry.animationFrames.size());
+    for (const FBXAnimationFrame& frame : geometry.animationFrames) {
+        writer.vector(frame.rotations);
+        writer.vector(frame.translations);
+    }
+
+    writer.object(geometry.meshIndicesToModelNames);
+    writer.object(geometry.blendshapeChannelNames);
+
+    return data;
+}
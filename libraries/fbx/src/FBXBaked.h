@@ -0,0 +1,34 @@
+//
+//  FBXBaked.h
+//  libraries/fbx/src
+//
+//  Created by Sam Gateau on 10/15/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_FBXBaked_h
+#define hifi_FBXBaked_h
+
+#include "FBXReader.h"
+
+// A baked geometry is an FBXGeometry as readFBX extracts it, with the mapping applied and the normals,
+// tangents, extents and clusters already computed, written in its raw vertex and index arrays.
+// The client reads it back and builds the mesh buffers straight from these arrays instead of parsing the FBX.
+namespace fbxbaked {
+
+    const char* const FILE_EXTENSION = "hfb";
+
+    bool isBakedGeometry(const QByteArray& data);
+
+    /// Reads the geometry baked in the data, its url is only used for the logs.
+    /// \exception QString if the data is not a valid baked geometry
+    FBXGeometry* read(const QByteArray& data, const QString& url = "");
+
+    QByteArray write(const FBXGeometry& geometry);
+
+}
+
+#endif // hifi_FBXBaked_h
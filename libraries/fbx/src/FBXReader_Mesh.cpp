@@ -20,6 +20,7 @@
 #include <QFileInfo>
 #include <QHash>
 #include <LogHandler.h>
+#include <model/MeshSimplifier.h>
 #include "ModelFormatLogging.h"
 
 #include "FBXReader.h"
@@ -495,33 +496,23 @@ void FBXReader::buildModelMesh(FBXMesh& extractedMesh, const QString& url) {
         return;
     }
 
-    auto indexBuffer = std::make_shared<gpu::Buffer>();
-    indexBuffer->resize(totalIndices * sizeof(int));
+    std::vector<uint32_t> indices;
+    indices.reserve(totalIndices);
 
     int indexNum = 0;
-    int offset = 0;
 
     std::vector< model::Mesh::Part > parts;
-    if (extractedMesh.parts.size() > 1) {
-        indexNum = 0;
-    }
     foreach(const FBXMeshPart& part, extractedMesh.parts) {
         model::Mesh::Part modelPart(indexNum, 0, 0, model::Mesh::TRIANGLES);
         
         if (part.quadTrianglesIndices.size()) {
-            indexBuffer->setSubData(offset,
-                            part.quadTrianglesIndices.size() * sizeof(int),
-                            (gpu::Byte*) part.quadTrianglesIndices.constData());
-            offset += part.quadTrianglesIndices.size() * sizeof(int);
+            indices.insert(indices.end(), part.quadTrianglesIndices.constBegin(), part.quadTrianglesIndices.constEnd());
             indexNum += part.quadTrianglesIndices.size();
             modelPart._numIndices += part.quadTrianglesIndices.size();
         }
 
         if (part.triangleIndices.size()) {
-            indexBuffer->setSubData(offset,
-                            part.triangleIndices.size() * sizeof(int),
-                            (gpu::Byte*) part.triangleIndices.constData());
-            offset += part.triangleIndices.size() * sizeof(int);
+            indices.insert(indices.end(), part.triangleIndices.constBegin(), part.triangleIndices.constEnd());
             indexNum += part.triangleIndices.size();
             modelPart._numIndices += part.triangleIndices.size();
         }
@@ -529,17 +520,65 @@ void FBXReader::buildModelMesh(FBXMesh& extractedMesh, const QString& url) {
         parts.push_back(modelPart);
     }
 
+    if (!parts.size()) {
+        qCDebug(modelformat) << "buildModelMesh failed -- no parts, url = " << url;
+        return;
+    }
+
+    // The large parts get simplified levels of detail, each one simplified from the previous one.
+    // Their indices come after the full detail ones and index the same vertices
+    const int MIN_TRIANGLES_TO_SIMPLIFY = 1000;
+    const int NUM_LODS = 2;
+    const float LOD_INDEX_RATIOS[NUM_LODS] = { 0.25f, 0.0625f };
+    const float LOD_MAX_ERRORS[NUM_LODS] = { 0.01f, 0.04f }; // relative to the size of the mesh
+    const float MIN_LOD_REDUCTION = 0.75f;
+
+    Extents extents;
+    foreach(const glm::vec3& vertex, extractedMesh.vertices) {
+        extents.addPoint(vertex);
+    }
+    float meshSize = glm::length(extents.size());
+
+    std::vector< model::Mesh::Part > lodParts;
+    std::vector< model::Mesh::Part > previousLOD = parts;
+    for (int lod = 0; lod < NUM_LODS; lod++) {
+        std::vector< model::Mesh::Part > lodLevel;
+        bool isSimplified = false;
+        for (size_t i = 0; i < parts.size(); i++) {
+            model::Mesh::Part lodPart = previousLOD[i];
+            if (parts[i]._numIndices >= MIN_TRIANGLES_TO_SIMPLIFY * 3) {
+                auto simplified = model::MeshSimplifier::simplify(extractedMesh.vertices.constData(), extractedMesh.vertices.size(),
+                    indices.data() + lodPart._startIndex, lodPart._numIndices,
+                    (size_t)(parts[i]._numIndices * LOD_INDEX_RATIOS[lod]), LOD_MAX_ERRORS[lod] * meshSize);
+                if (simplified.size() <= lodPart._numIndices * MIN_LOD_REDUCTION) {
+                    lodPart = model::Mesh::Part((model::Index)indices.size(), (model::Index)simplified.size(), 0, model::Mesh::TRIANGLES);
+                    indices.insert(indices.end(), simplified.begin(), simplified.end());
+                    isSimplified = true;
+                }
+            }
+            lodLevel.push_back(lodPart);
+        }
+        if (!isSimplified) {
+            break;
+        }
+        lodParts.insert(lodParts.end(), lodLevel.begin(), lodLevel.end());
+        previousLOD = lodLevel;
+    }
+
+    auto indexBuffer = std::make_shared<gpu::Buffer>();
+    indexBuffer->setData(indices.size() * sizeof(uint32_t), (const gpu::Byte*) indices.data());
     gpu::BufferView indexBufferView(indexBuffer, gpu::Element(gpu::SCALAR, gpu::UINT32, gpu::XYZ));
     mesh->setIndexBuffer(indexBufferView);
 
-    if (parts.size()) {
-        auto pb = std::make_shared<gpu::Buffer>();
-        pb->setData(parts.size() * sizeof(model::Mesh::Part), (const gpu::Byte*) parts.data());
-        gpu::BufferView pbv(pb, gpu::Element(gpu::VEC4, gpu::UINT32, gpu::XYZW));
-        mesh->setPartBuffer(pbv);
-    } else {
-        qCDebug(modelformat) << "buildModelMesh failed -- no parts, url = " << url;
-        return;
+    auto pb = std::make_shared<gpu::Buffer>();
+    pb->setData(parts.size() * sizeof(model::Mesh::Part), (const gpu::Byte*) parts.data());
+    gpu::BufferView pbv(pb, gpu::Element(gpu::VEC4, gpu::UINT32, gpu::XYZW));
+    mesh->setPartBuffer(pbv);
+
+    if (lodParts.size()) {
+        auto lodBuffer = std::make_shared<gpu::Buffer>();
+        lodBuffer->setData(lodParts.size() * sizeof(model::Mesh::Part), (const gpu::Byte*) lodParts.data());
+        mesh->setPartLODBuffer(gpu::BufferView(lodBuffer, gpu::Element(gpu::VEC4, gpu::UINT32, gpu::XYZW)));
     }
 
     // model::Box box =
@@ -11,9 +11,13 @@
 
 #include "FBXReader.h"
 
+#include <algorithm>
 #include <iostream>
+
+#include <zlib.h>
+
 #include <QtCore/QBuffer>
-#include <QtCore/QDataStream>
+#include <QtCore/QFile>
 #include <QtCore/QIODevice>
 #include <QtCore/QStringList>
 #include <QtCore/QTextStream>
@@ -21,155 +25,154 @@
 #include <QtCore/QtEndian>
 #include <QtCore/QFileInfo>
 
+#include <Finally.h>
 #include <shared/NsightHelpers.h>
 #include "ModelFormatLogging.h"
 
-template<class T> int streamSize() {
-    return sizeof(T);
-}
+// The binary files are parsed in place, out of the buffer holding the downloaded model or a mapping of the file,
+// instead of through a QDataStream one value at a time
+class BinaryFBXCursor {
+public:
+    BinaryFBXCursor(const char* data, qint64 size) : _data(data), _size(size) { }
 
-template<bool> int streamSize() {
-    return 1;
-}
+    qint64 position() const { return _position; }
+    bool atEnd() const { return _position >= _size; }
+
+    const char* read(qint64 length) {
+        if (length < 0 || length > _size - _position) {
+            throw QString("corrupt fbx file");
+        }
+        const char* result = _data + _position;
+        _position += length;
+        return result;
+    }
 
-template<class T> QVariant readBinaryArray(QDataStream& in, int& position) {
-    quint32 arrayLength;
-    quint32 encoding;
-    quint32 compressedLength;
+    template<class T> T readValue() {
+        T value;
+        memcpy(&value, read(sizeof(T)), sizeof(T));
+        fromLittleEndian(&value, 1);
+        return value;
+    }
 
-    in >> arrayLength;
-    in >> encoding;
-    in >> compressedLength;
-    position += sizeof(quint32) * 3;
+    template<class T> static void fromLittleEndian(T* values, qint64 count) {
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+        for (qint64 i = 0; i < count; i++) {
+            char* bytes = reinterpret_cast<char*>(values + i);
+            std::reverse(bytes, bytes + sizeof(T));
+        }
+#else
+        Q_UNUSED(values);
+        Q_UNUSED(count);
+#endif
+    }
+
+private:
+    const char* _data;
+    qint64 _size;
+    qint64 _position { 0 };
+};
+
+// Copies or inflates the array straight into the storage of its vector
+void readBinaryArrayData(BinaryFBXCursor& cursor, quint32 arrayLength, size_t valueSize, void* destination) {
+    quint32 encoding = cursor.readValue<quint32>();
+    quint32 compressedLength = cursor.readValue<quint32>();
+    uLongf length = (uLongf)arrayLength * valueSize;
 
-    QVector<T> values;
     const unsigned int DEFLATE_ENCODING = 1;
     if (encoding == DEFLATE_ENCODING) {
-        // preface encoded data with uncompressed length
-        QByteArray compressed(sizeof(quint32) + compressedLength, 0);
-        *((quint32*)compressed.data()) = qToBigEndian<quint32>(arrayLength * sizeof(T));
-        in.readRawData(compressed.data() + sizeof(quint32), compressedLength);
-        position += compressedLength;
-        QByteArray uncompressed = qUncompress(compressed);
-        if (uncompressed.isEmpty()) { // answers empty byte array if corrupt
+        const char* compressed = cursor.read(compressedLength);
+        uLongf uncompressedLength = length;
+        if (uncompress((Bytef*)destination, &uncompressedLength, (const Bytef*)compressed, compressedLength) != Z_OK ||
+                uncompressedLength != length) {
             throw QString("corrupt fbx file");
         }
-        QDataStream uncompressedIn(uncompressed);
-        uncompressedIn.setByteOrder(QDataStream::LittleEndian);
-        uncompressedIn.setVersion(QDataStream::Qt_4_5); // for single/double precision switch
-        for (quint32 i = 0; i < arrayLength; i++) {
-            T value;
-            uncompressedIn >> value;
-            values.append(value);
-        }
     } else {
-        for (quint32 i = 0; i < arrayLength; i++) {
-            T value;
-            in >> value;
-            position += streamSize<T>();
-            values.append(value);
-        }
+        memcpy(destination, cursor.read(length), length);
     }
+}
+
+template<class T> QVariant readBinaryArray(BinaryFBXCursor& cursor) {
+    quint32 arrayLength = cursor.readValue<quint32>();
+    QVector<T> values(arrayLength);
+    readBinaryArrayData(cursor, arrayLength, sizeof(T), values.data());
+    BinaryFBXCursor::fromLittleEndian(values.data(), arrayLength);
     return QVariant::fromValue(values);
 }
 
-QVariant parseBinaryFBXProperty(QDataStream& in, int& position) {
-    char ch;
-    in.device()->getChar(&ch);
-    position++;
+template<> QVariant readBinaryArray<bool>(BinaryFBXCursor& cursor) {
+    quint32 arrayLength = cursor.readValue<quint32>();
+    QVector<quint8> bytes(arrayLength);
+    readBinaryArrayData(cursor, arrayLength, sizeof(quint8), bytes.data());
+    QVector<bool> values(arrayLength);
+    std::transform(bytes.constBegin(), bytes.constEnd(), values.begin(), [](quint8 byte) { return byte != 0; });
+    return QVariant::fromValue(values);
+}
+
+QVariant parseBinaryFBXProperty(BinaryFBXCursor& cursor) {
+    char ch = cursor.readValue<char>();
     switch (ch) {
         case 'Y': {
-            qint16 value;
-            in >> value;
-            position += sizeof(qint16);
-            return QVariant::fromValue(value);
+            return QVariant::fromValue(cursor.readValue<qint16>());
         }
         case 'C': {
-            bool value;
-            in >> value;
-            position++;
-            return QVariant::fromValue(value);
+            return QVariant::fromValue(cursor.readValue<quint8>() != 0);
         }
         case 'I': {
-            qint32 value;
-            in >> value;
-            position += sizeof(qint32);
-            return QVariant::fromValue(value);
+            return QVariant::fromValue(cursor.readValue<qint32>());
         }
         case 'F': {
-            float value;
-            in >> value;
-            position += sizeof(float);
-            return QVariant::fromValue(value);
+            return QVariant::fromValue(cursor.readValue<float>());
         }
         case 'D': {
-            double value;
-            in >> value;
-            position += sizeof(double);
-            return QVariant::fromValue(value);
+            return QVariant::fromValue(cursor.readValue<double>());
         }
         case 'L': {
-            qint64 value;
-            in >> value;
-            position += sizeof(qint64);
-            return QVariant::fromValue(value);
+            return QVariant::fromValue(cursor.readValue<qint64>());
         }
         case 'f': {
-            return readBinaryArray<float>(in, position);
+            return readBinaryArray<float>(cursor);
         }
         case 'd': {
-            return readBinaryArray<double>(in, position);
+            return readBinaryArray<double>(cursor);
         }
         case 'l': {
-            return readBinaryArray<qint64>(in, position);
+            return readBinaryArray<qint64>(cursor);
         }
         case 'i': {
-            return readBinaryArray<qint32>(in, position);
+            return readBinaryArray<qint32>(cursor);
         }
         case 'b': {
-            return readBinaryArray<bool>(in, position);
+            return readBinaryArray<bool>(cursor);
         }
         case 'S':
         case 'R': {
-            quint32 length;
-            in >> length;
-            position += sizeof(quint32) + length;
-            return QVariant::fromValue(in.device()->read(length));
+            quint32 length = cursor.readValue<quint32>();
+            return QVariant::fromValue(QByteArray(cursor.read(length), length));
         }
         default:
             throw QString("Unknown property type: ") + ch;
     }
 }
 
-FBXNode parseBinaryFBXNode(QDataStream& in, int& position, bool has64BitPositions = false) {
+FBXNode parseBinaryFBXNode(BinaryFBXCursor& cursor, bool has64BitPositions = false) {
     qint64 endOffset;
     quint64 propertyCount;
     quint64 propertyListLength;
-    quint8 nameLength;
 
     // FBX 2016 and beyond uses 64bit positions in the node headers, pre-2016 used 32bit values
     // our code generally doesn't care about the size that much, so we will use 64bit values
-    // from here on out, but if the file is an older format we read the stream into temp 32bit 
-    // values and then assign to our actual 64bit values.
+    // from here on out, but if the file is an older format we read the 32bit values and widen them.
     if (has64BitPositions) {
-        in >> endOffset;
-        in >> propertyCount;
-        in >> propertyListLength;
-        position += sizeof(quint64) * 3;
+        endOffset = cursor.readValue<qint64>();
+        propertyCount = cursor.readValue<quint64>();
+        propertyListLength = cursor.readValue<quint64>();
     } else {
-        qint32 tempEndOffset;
-        quint32 tempPropertyCount;
-        quint32 tempPropertyListLength;
-        in >> tempEndOffset;
-        in >> tempPropertyCount;
-        in >> tempPropertyListLength;
-        position += sizeof(quint32) * 3;
-        endOffset = tempEndOffset;
-        propertyCount = tempPropertyCount;
-        propertyListLength = tempPropertyListLength;
-    }
-    in >> nameLength;
-    position += sizeof(quint8);
+        endOffset = cursor.readValue<qint32>();
+        propertyCount = cursor.readValue<quint32>();
+        propertyListLength = cursor.readValue<quint32>();
+    }
+    Q_UNUSED(propertyListLength);
+    quint8 nameLength = cursor.readValue<quint8>();
 
     FBXNode node;
     const int MIN_VALID_OFFSET = 40;
@@ -177,15 +180,14 @@ FBXNode parseBinaryFBXNode(QDataStream& in, int& position, bool has64BitPosition
         // use a null name to indicate a null node
         return node;
     }
-    node.name = in.device()->read(nameLength);
-    position += nameLength;
+    node.name = QByteArray(cursor.read(nameLength), nameLength);
 
-    for (quint32 i = 0; i < propertyCount; i++) {
-        node.properties.append(parseBinaryFBXProperty(in, position));
+    for (quint64 i = 0; i < propertyCount; i++) {
+        node.properties.append(parseBinaryFBXProperty(cursor));
     }
 
-    while (endOffset > position) {
-        FBXNode child = parseBinaryFBXNode(in, position, has64BitPositions);
+    while (endOffset > cursor.position()) {
+        FBXNode child = parseBinaryFBXNode(cursor, has64BitPositions);
         if (child.name.isNull()) {
             return node;
 
@@ -197,6 +199,38 @@ FBXNode parseBinaryFBXNode(QDataStream& in, int& position, bool has64BitPosition
     return node;
 }
 
+FBXNode parseBinaryFBX(const char* data, qint64 size) {
+    BinaryFBXCursor cursor(data, size);
+
+    // see http://code.blender.org/index.php/2013/08/fbx-binary-file-format-specification/ for an explanation
+    // of the FBX binary format
+
+    // The first 27 bytes contain the header.
+    //   Bytes 0 - 20: Kaydara FBX Binary  \x00(file - magic, with 2 spaces at the end, then a NULL terminator).
+    //   Bytes 21 - 22: [0x1A, 0x00](unknown but all observed files show these bytes).
+    //   Bytes 23 - 26 : unsigned int, the version number. 7300 for version 7.3 for example.
+    const int HEADER_BEFORE_VERSION = 23;
+    const quint32 VERSION_FBX2016 = 7500;
+    cursor.read(HEADER_BEFORE_VERSION);
+    quint32 fileVersion = cursor.readValue<quint32>();
+    qCDebug(modelformat) << "fileVersion:" << fileVersion;
+    bool has64BitPositions = (fileVersion >= VERSION_FBX2016);
+
+    // parse the top-level node
+    FBXNode top;
+    while (!cursor.atEnd()) {
+        FBXNode next = parseBinaryFBXNode(cursor, has64BitPositions);
+        if (next.name.isNull()) {
+            return top;
+
+        } else {
+            top.children.append(next);
+        }
+    }
+
+    return top;
+}
+
 class Tokenizer {
 public:
 
@@ -339,43 +373,29 @@ FBXNode FBXReader::parseFBX(QIODevice* device) {
         }
         return top;
     }
-    QDataStream in(device);
-    in.setByteOrder(QDataStream::LittleEndian);
-    in.setVersion(QDataStream::Qt_4_5); // for single/double precision switch
-
-    // see http://code.blender.org/index.php/2013/08/fbx-binary-file-format-specification/ for an explanation
-    // of the FBX binary format
 
-    // The first 27 bytes contain the header.
-    //   Bytes 0 - 20: Kaydara FBX Binary  \x00(file - magic, with 2 spaces at the end, then a NULL terminator).
-    //   Bytes 21 - 22: [0x1A, 0x00](unknown but all observed files show these bytes).
-    //   Bytes 23 - 26 : unsigned int, the version number. 7300 for version 7.3 for example.
-    const int HEADER_BEFORE_VERSION = 23;
-    const quint32 VERSION_FBX2016 = 7500;
-    in.skipRawData(HEADER_BEFORE_VERSION);
-    int position = HEADER_BEFORE_VERSION;
-    quint32 fileVersion;
-    in >> fileVersion;
-    position += sizeof(fileVersion);
-    qCDebug(modelformat) << "fileVersion:" << fileVersion;
-    bool has64BitPositions = (fileVersion >= VERSION_FBX2016);
-
-    // parse the top-level node
-    FBXNode top;
-    while (device->bytesAvailable()) {
-        FBXNode next = parseBinaryFBXNode(in, position, has64BitPositions);
-        if (next.name.isNull()) {
-            return top;
+    // Parse in place when the contents are already in memory, otherwise map the file or read it all
+    QBuffer* buffer = qobject_cast<QBuffer*>(device);
+    if (buffer) {
+        return parseBinaryFBX(buffer->data().constData() + buffer->pos(), buffer->size() - buffer->pos());
+    }
 
-        } else {
-            top.children.append(next);
+    QFile* file = qobject_cast<QFile*>(device);
+    if (file) {
+        qint64 size = file->size() - file->pos();
+        uchar* mapped = file->map(file->pos(), size);
+        if (mapped) {
+            Finally unmap([&] {
+                file->unmap(mapped);
+            });
+            return parseBinaryFBX((const char*)mapped, size);
         }
     }
 
-    return top;
+    QByteArray contents = device->readAll();
+    return parseBinaryFBX(contents.constData(), contents.size());
 }
 
-
 glm::vec3 FBXReader::getVec3(const QVariantList& properties, int index) {
     return glm::vec3(properties.at(index).value<double>(), properties.at(index + 1).value<double>(),
         properties.at(index + 2).value<double>());
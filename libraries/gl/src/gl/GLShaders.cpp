@@ -1,5 +1,15 @@
 #include "GLShaders.h"
 
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QStandardPaths>
+
 #include "GLLogging.h"
 
 namespace gl {
@@ -138,7 +148,9 @@ GLuint compileProgram(const std::vector<GLuint>& glshaders) {
         return 0;
     }
 
-    // glProgramParameteri(glprogram, GL_PROGRAM_, GL_TRUE);
+    // Keep the binary of the linked program for the program cache
+    glProgramParameteri(glprogram, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
     // Create the program from the sub shaders
     for (auto so : glshaders) {
         glAttachShader(glprogram, so);
@@ -186,4 +198,131 @@ GLuint compileProgram(const std::vector<GLuint>& glshaders) {
     return glprogram;
 }
 
+struct ProgramBinary {
+    GLenum format { 0 };
+    std::vector<char> data;
+};
+
+static std::mutex programCacheMutex;
+static std::unordered_map<std::string, ProgramBinary> programCache;
+
+static const QString PROGRAM_BINARY_EXTENSION { ".bin" };
+
+static const QString& getProgramCachePath() {
+    static const QString path = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/shaders/";
+    return path;
+}
+
+static bool isProgramBinarySupported() {
+    static const bool supported = [] {
+        GLint numFormats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+        return numFormats > 0;
+    }();
+    return supported;
+}
+
+// The file holds the binary format followed by the binary
+static bool readProgramBinary(const QString& filePath, ProgramBinary& binary) {
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QByteArray bytes = file.readAll();
+    if (bytes.size() <= (int)sizeof(GLenum)) {
+        return false;
+    }
+    memcpy(&binary.format, bytes.data(), sizeof(GLenum));
+    binary.data.assign(bytes.begin() + sizeof(GLenum), bytes.end());
+    return true;
+}
+
+std::string evalProgramKey(const std::vector<std::string>& sources) {
+    // A binary is only valid for the driver which produced it
+    static const QByteArray driver = QByteArray((const char*)glGetString(GL_VENDOR)) +
+        (const char*)glGetString(GL_RENDERER) + (const char*)glGetString(GL_VERSION);
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(driver);
+    for (const auto& source : sources) {
+        // Including the terminators keeps the sources apart
+        hash.addData(source.c_str(), (int)source.size() + 1);
+    }
+    return hash.result().toHex().toStdString();
+}
+
+GLuint loadCachedProgram(const std::string& programKey) {
+    if (!isProgramBinarySupported()) {
+        return 0;
+    }
+
+    ProgramBinary binary;
+    {
+        std::lock_guard<std::mutex> lock(programCacheMutex);
+        auto cached = programCache.find(programKey);
+        if (cached != programCache.end()) {
+            binary = std::move(cached->second);
+            programCache.erase(cached);
+        }
+    }
+    // The warming may not have reached this one yet
+    if (binary.data.empty() && !readProgramBinary(getProgramCachePath() + QString::fromStdString(programKey) + PROGRAM_BINARY_EXTENSION, binary)) {
+        return 0;
+    }
+
+    GLuint glprogram = glCreateProgram();
+    if (!glprogram) {
+        return 0;
+    }
+    glProgramBinary(glprogram, binary.format, binary.data.data(), (GLsizei)binary.data.size());
+
+    GLint linked = 0;
+    glGetProgramiv(glprogram, GL_LINK_STATUS, &linked);
+    if (!linked) {
+        // The driver can reject the binaries of a previous version of itself, the program is compiled again instead
+        qCDebug(glLogging) << "GLShader::loadCachedProgram - the cached binary was rejected, compiling the program";
+        glDeleteProgram(glprogram);
+        return 0;
+    }
+    return glprogram;
+}
+
+void cacheProgram(const std::string& programKey, GLuint glprogram) {
+    if (!isProgramBinarySupported()) {
+        return;
+    }
+
+    GLint length = 0;
+    glGetProgramiv(glprogram, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) {
+        return;
+    }
+    ProgramBinary binary;
+    binary.data.resize(length);
+    glGetProgramBinary(glprogram, length, nullptr, &binary.format, binary.data.data());
+
+    const QString& path = getProgramCachePath();
+    QDir().mkpath(path);
+    QFile file(path + QString::fromStdString(programKey) + PROGRAM_BINARY_EXTENSION);
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write((const char*)&binary.format, sizeof(GLenum));
+        file.write(binary.data.data(), binary.data.size());
+    } else {
+        qCDebug(glLogging) << "GLShader::cacheProgram - failed to write" << file.fileName();
+    }
+}
+
+void warmProgramCache() {
+    std::thread([] {
+        QDir dir(getProgramCachePath());
+        for (const auto& fileName : dir.entryList({ "*" + PROGRAM_BINARY_EXTENSION }, QDir::Files)) {
+            ProgramBinary binary;
+            if (readProgramBinary(dir.filePath(fileName), binary)) {
+                std::lock_guard<std::mutex> lock(programCacheMutex);
+                programCache.emplace(QFileInfo(fileName).completeBaseName().toStdString(), std::move(binary));
+            }
+        }
+    }).detach();
+}
+
 }
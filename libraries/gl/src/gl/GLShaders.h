@@ -24,6 +24,15 @@ namespace gl {
 
     GLuint compileProgram(const std::vector<GLuint>& glshaders);
 
+    // The linked programs are cached on disk as driver binaries, keyed by the hash of their sources and of the driver,
+    // so the programs met in a previous run load without compiling
+    std::string evalProgramKey(const std::vector<std::string>& sources);
+    // \return the program loaded from its cached binary, or 0 if there is none or the driver rejects it
+    GLuint loadCachedProgram(const std::string& programKey);
+    void cacheProgram(const std::string& programKey, GLuint glprogram);
+    // Reads the cached binaries from disk on a worker thread, ahead of the programs needing them
+    void warmProgramCache();
+
 }
 
 #endif
@@ -210,6 +210,11 @@ public:
 // This has the effect of capping the framerate at 200
 static const int MIN_TIMER_MS = 5;
 
+// A surface whose root item is hidden shows nothing that changes, but its animations
+// and timers still dirty the scene, so it is only rendered often enough to notice
+// being shown again.
+static const uint8_t HIDDEN_MAX_FPS = 2;
+
 class QMyQuickRenderControl : public QQuickRenderControl {
 protected:
     QWindow* renderWindow(QPoint* offset) Q_DECL_OVERRIDE{
@@ -278,7 +283,11 @@ void OffscreenQmlSurface::render() {
 
     _canvas->makeCurrent();
 
-    _renderControl->sync();
+    // renderRequested alone means the scene graph is unchanged and only needs to be drawn again
+    if (_sync) {
+        _renderControl->sync();
+        _sync = false;
+    }
     _quickWindow->setRenderTarget(_fbo, QSize(_size.x, _size.y));
 
     GLuint texture = offscreenTextures.getNextTexture(_size);
@@ -328,6 +337,10 @@ std::function<void(uint32_t, void*)> OffscreenQmlSurface::getDiscardLambda() {
     };
 }
 
+bool OffscreenQmlSurface::isRootVisible() const {
+    return _rootItem && _rootItem->isVisible() && _rootItem->opacity() > 0.0;
+}
+
 bool OffscreenQmlSurface::allowNewFrame(uint8_t fps) {
     // If we already have a pending texture, don't render another one 
     // i.e. don't render faster than the consumer context, since it wastes 
@@ -408,7 +421,7 @@ void OffscreenQmlSurface::create(QOpenGLContext* shareContext) {
 
 
     connect(_renderControl, &QQuickRenderControl::renderRequested, this, [this] { _render = true; });
-    connect(_renderControl, &QQuickRenderControl::sceneChanged, this, [this] { _render = _polish = true; });
+    connect(_renderControl, &QQuickRenderControl::sceneChanged, this, [this] { _render = _polish = _sync = true; });
 
     if (!_canvas->makeCurrent()) {
         qWarning("Failed to make context current for QML Renderer");
@@ -500,6 +513,9 @@ void OffscreenQmlSurface::resize(const QSize& newSize_, bool forceResize) {
         glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
     }
 
+    // the textures of the old size are gone, the scene has to be synced and drawn at the new size
+    _render = _sync = true;
+
     _canvas->doneCurrent();
 }
 
@@ -611,7 +627,7 @@ void OffscreenQmlSurface::updateQuick() {
     //   b) already rendering a frame
     //   c) rendering too fast
     // then skip this
-    if (!allowNewFrame(_maxFps)) {
+    if (!allowNewFrame(isRootVisible() ? _maxFps : HIDDEN_MAX_FPS)) {
         return;
     }
 
@@ -740,7 +756,7 @@ void OffscreenQmlSurface::pause() {
 
 void OffscreenQmlSurface::resume() {
     _paused = false;
-    _render = true;
+    _render = _sync = true;
 
     getRootItem()->setProperty("eventBridge", QVariant::fromValue(this));
     getRootContext()->setContextProperty("webEntity", this);
@@ -116,6 +116,7 @@ private:
     QObject* finishQmlLoad(std::function<void(QQmlContext*, QObject*)> f);
     QPointF mapWindowToUi(const QPointF& sourcePosition, QObject* sourceObject);
     void setupFbo();
+    bool isRootVisible() const;
     bool allowNewFrame(uint8_t fps);
     void render();
     void cleanup();
@@ -145,6 +146,7 @@ private:
 
     bool _render { false };
     bool _polish { true };
+    bool _sync { true };
     bool _paused { true };
     bool _focusText { false };
     uint8_t _maxFps { 60 };
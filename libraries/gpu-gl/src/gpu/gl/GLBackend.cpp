@@ -25,6 +25,7 @@
 
 #include <GPUIdent.h>
 #include <gl/QOpenGLContextWrapper.h>
+#include <gl/GLShaders.h>
 #include <QtCore/QProcessEnvironment>
 
 #include "GLTexture.h"
@@ -63,6 +64,7 @@ BackendPointer GLBackend::createBackend() {
     qApp->setProperty(GL_BACKEND_PROPERTY_NAME, QVariant::fromValue(voidInstance));
 
     gl::GLTexture::initTextureTransferHelper();
+    gl::GLShader::initShaderCompileHelper();
     return result;
 }
 
@@ -162,6 +164,9 @@ void GLBackend::init() {
         }
         qCDebug(gpugllogging, "Status: Using GLEW %s\n", glewGetString(GLEW_VERSION));
 
+        // Read the program binaries cached by the previous runs while the startup goes on
+        ::gl::warmProgramCache();
+
 #if defined(Q_OS_WIN)
         if (wglewGetExtension("WGL_EXT_swap_control")) {
             int swapInterval = wglGetSwapIntervalEXT();
@@ -190,6 +195,7 @@ GLBackend::~GLBackend() {
 
     killInput();
     killTransform();
+    killFramebufferDownloads();
 }
 
 void GLBackend::renderPassTransfer(const Batch& batch) {
@@ -198,14 +204,9 @@ void GLBackend::renderPassTransfer(const Batch& batch) {
     const Batch::CommandOffsets::value_type* offset = batch.getCommandOffsets().data();
 
     _inRenderTransferPass = true;
-    { // Sync all the buffers
+    { // Sync all the buffers and textures
         PROFILE_RANGE("syncGPUBuffer");
-
-        for (auto& cached : batch._buffers._items) {
-            if (cached._data) {
-                syncGPUObject(*cached._data);
-            }
-        }
+        resolveBatchObjects(batch);
     }
 
     { // Sync all the buffers
@@ -248,6 +249,41 @@ void GLBackend::renderPassTransfer(const Batch& batch) {
     _inRenderTransferPass = false;
 }
 
+void GLBackend::resolveBatchObjects(const Batch& batch) {
+    _resolved._buffers.clear();
+    _resolved._buffers.reserve(batch._buffers._items.size());
+    for (auto& cached : batch._buffers._items) {
+        _resolved._buffers.push_back(cached._data ? syncGPUObject(*cached._data) : nullptr);
+    }
+
+    _resolved._textures.clear();
+    _resolved._textures.reserve(batch._textures._items.size());
+    for (auto& cached : batch._textures._items) {
+        _resolved._textures.push_back(cached._data ? syncGPUObject(cached._data) : nullptr);
+    }
+}
+
+GLBuffer* GLBackend::getResolvedBuffer(uint32 index, const Buffer& buffer) {
+    // A lambda or a framebuffer resize in the batch may have re-created the object since it was resolved
+    if (index < _resolved._buffers.size()) {
+        GLBuffer* object = _resolved._buffers[index];
+        if (object && object == Backend::getGPUObject<GLBuffer>(buffer)) {
+            return object;
+        }
+    }
+    return syncGPUObject(buffer);
+}
+
+GLTexture* GLBackend::getResolvedTexture(uint32 index, const TexturePointer& texture) {
+    if (index < _resolved._textures.size()) {
+        GLTexture* object = _resolved._textures[index];
+        if (object && object == Backend::getGPUObject<GLTexture>(*texture)) {
+            return object;
+        }
+    }
+    return syncGPUObject(texture);
+}
+
 void GLBackend::renderPassDraw(const Batch& batch) {
     _currentDraw = -1;
     _transform._camerasItr = _transform._cameraOffsets.begin();
@@ -273,6 +309,10 @@ void GLBackend::renderPassDraw(const Batch& batch) {
             case Batch::COMMAND_multiDrawIndexedIndirect: {
                 // updates for draw calls
                 ++_currentDraw;
+                if (_pipeline._pendingProgram) {
+                    // The program of the pipeline is still compiling, skip its draws rather than stall the frame
+                    break;
+                }
                 updateInput();
                 updateTransform(batch);
                 updatePipeline();
@@ -307,11 +347,22 @@ void GLBackend::render(const Batch& batch) {
         renderPassTransfer(batch);
     }
 
+    // The stereo programs draw each eye as every other instance, clipped to its half of the viewport
+    if (_stereo._enable) {
+        glEnable(GL_CLIP_DISTANCE0);
+    }
+
     {
         PROFILE_RANGE(_stereo._enable ? "Render Stereo" : "Render");
         renderPassDraw(batch);
     }
 
+    if (_stereo._enable) {
+        glDisable(GL_CLIP_DISTANCE0);
+    }
+    _resolved._buffers.clear();
+    _resolved._textures.clear();
+
     // Restore the saved stereo state for the next batch
     _stereo._enable = savedStereo;
 }
@@ -326,14 +377,6 @@ void GLBackend::syncCache() {
     glEnable(GL_LINE_SMOOTH);
 }
 
-void GLBackend::setupStereoSide(int side) {
-    ivec4 vp = _transform._viewport;
-    vp.z /= 2;
-    glViewport(vp.x + side * vp.z, vp.y, vp.z, vp.w);
-
-    _transform.bindCurrentCamera(side);
-}
-
 void GLBackend::do_resetStages(const Batch& batch, size_t paramOffset) {
     resetStages();
 }
@@ -384,9 +427,8 @@ void GLBackend::do_popProfileRange(const Batch& batch, size_t paramOffset) {
 // code, we need to be able to record and batch these calls. THe long 
 // term strategy is to get rid of any GL calls in favor of the HIFI GPU API
 
-// As long as we don;t use several versions of shaders we can avoid this more complex code path
-// #define GET_UNIFORM_LOCATION(shaderUniformLoc) _pipeline._programShader->getUniformLocation(shaderUniformLoc, isStereo());
-#define GET_UNIFORM_LOCATION(shaderUniformLoc) shaderUniformLoc
+// The uniform locations recorded in the batch are the ones of the mono version of the program
+#define GET_UNIFORM_LOCATION(shaderUniformLoc) _pipeline._programShader->getUniformLocation(shaderUniformLoc, (GLShader::Version)_pipeline._programVersion)
 
 void GLBackend::do_glUniform1i(const Batch& batch, size_t paramOffset) {
     if (_pipeline._program == 0) {
@@ -718,6 +760,8 @@ void GLBackend::recycle() const {
         }
     }
 
+    processFramebufferDownloads();
+
 #ifndef THREADED_TEXTURE_TRANSFER
     gl::GLTexture::_textureTransferHelper->process();
 #endif
@@ -59,6 +59,11 @@ public:
     virtual void downloadFramebuffer(const FramebufferPointer& srcFramebuffer,
                                      const Vec4i& region, QImage& destImage) final override;
 
+    // The pixels are read into a pixel buffer behind a fence, and copied out of it by recycle() once the fence is
+    // signaled, so neither the read nor the copy waits on the GPU
+    virtual void downloadFramebufferAsync(const FramebufferPointer& srcFramebuffer, const Vec4i& region,
+                                          const FramebufferDownloadHandler& handler) final override;
+
 
     static const int MAX_NUM_ATTRIBUTES = Stream::NUM_INPUT_SLOTS;
     static const int MAX_NUM_INPUT_BUFFERS = 16;
@@ -202,9 +207,21 @@ protected:
     mutable std::list<GLuint> _queriesTrash;
     mutable std::list<std::function<void()>> _lambdaQueue;
 
+    struct FramebufferDownload {
+        GLuint pixelBuffer;
+        GLsync fence;
+        glm::ivec2 size;
+        FramebufferDownloadHandler handler;
+    };
+    // In the order they were fenced, which is the order they complete in
+    mutable std::list<FramebufferDownload> _framebufferDownloads;
+    mutable std::vector<GLuint> _freePixelBuffers;
+
+    void processFramebufferDownloads() const;
+    void killFramebufferDownloads();
+
     void renderPassTransfer(const Batch& batch);
     void renderPassDraw(const Batch& batch);
-    void setupStereoSide(int side);
 
     virtual void initInput() final;
     virtual void killInput() final;
@@ -212,9 +229,16 @@ protected:
     virtual void resetInputStage() final;
     virtual void updateInput();
 
+    // The stereo draws need twice the instances of the indirect commands, they draw a copy of the commands
+    // with the instance counts doubled instead, bound in place of the indirect buffer until restored
+    GLvoid* bindStereoIndirectCommands(uint32 commandCount, size_t commandSize);
+    void restoreIndirectBuffer();
+
     struct InputStageState {
         bool _invalidFormat { true };
         Stream::FormatPointer _format;
+        // The divisors of the instanced attributes are doubled in stereo, where each instance is drawn once per eye
+        bool _stereoDivisors { false };
 
         typedef std::bitset<MAX_NUM_ATTRIBUTES> ActivationCache;
         ActivationCache _attributeActivation { 0 };
@@ -236,6 +260,8 @@ protected:
         BufferPointer _indirectBuffer;
         Offset _indirectBufferOffset{ 0 };
         Offset _indirectBufferStride{ 0 };
+        GLuint _stereoIndirectBuffer { 0 };
+        std::vector<Byte> _stereoIndirectCommands;
 
         GLuint _defaultVAO { 0 };
 
@@ -262,7 +288,15 @@ protected:
     };
 
     struct TransformStageState {
-        using CameraBufferElement = TransformCamera;
+        // Both eye cameras are bound together and the stereo shaders pick the eye from the draw instance,
+        // in mono the element only holds the one camera
+        struct CameraBufferElement {
+            TransformCamera _cams[2];
+
+            CameraBufferElement() {}
+            CameraBufferElement(const TransformCamera& camera) : _cams{ camera, camera } {}
+            CameraBufferElement(const TransformCamera& cameraL, const TransformCamera& cameraR) : _cams{ cameraL, cameraR } {}
+        };
         using TransformCameras = std::vector<CameraBufferElement>;
 
         TransformCamera _camera;
@@ -270,9 +304,11 @@ protected:
 
         mutable std::map<std::string, GLvoid*> _drawCallInfoOffsets;
 
-        GLuint _objectBuffer { 0 };
-        GLuint _cameraBuffer { 0 };
-        GLuint _drawCallInfoBuffer { 0 };
+        // The backends streaming the transforms through ring buffers change the buffers and offsets on each transfer
+        mutable GLuint _objectBuffer { 0 };
+        mutable GLuint _cameraBuffer { 0 };
+        mutable GLuint _drawCallInfoBuffer { 0 };
+        mutable size_t _cameraBufferOffset { 0 };
         GLuint _objectBufferTexture { 0 };
         size_t _cameraUboSize { 0 };
         bool _viewIsCamera{ false };
@@ -295,7 +331,7 @@ protected:
 
         void preUpdate(size_t commandIndex, const StereoState& stereo);
         void update(size_t commandIndex, const StereoState& stereo) const;
-        void bindCurrentCamera(int stereoSide) const;
+        void bindCurrentCamera() const;
     } _transform;
 
     virtual void transferTransformState(const Batch& batch) const = 0;
@@ -319,6 +355,17 @@ protected:
         int findEmptyTextureSlot() const;
     } _resource;
 
+    // The GL objects of the buffers and textures of the batch being rendered, indexed like its caches.
+    // They are synced once in the transfer pass, so replaying the commands only needs a lookup
+    struct ResolvedObjects {
+        std::vector<GLBuffer*> _buffers;
+        std::vector<GLTexture*> _textures;
+    } _resolved;
+
+    void resolveBatchObjects(const Batch& batch);
+    GLBuffer* getResolvedBuffer(uint32 index, const Buffer& buffer);
+    GLTexture* getResolvedTexture(uint32 index, const TexturePointer& texture);
+
     size_t _commandIndex{ 0 };
 
     // Standard update pipeline check that the current Program and current State or good to go for a
@@ -335,7 +382,9 @@ protected:
         GLuint _program { 0 };
         GLint _cameraCorrectionLocation { -1 };
         GLShader* _programShader { nullptr };
+        int _programVersion { 0 }; // the GLShader::Version of the program, the stereo one in the stereo batches
         bool _invalidProgram { false };
+        bool _pendingProgram { false }; // the program of the pipeline is compiling on the compile thread
 
         BufferView _cameraCorrectionBuffer { gpu::BufferView(std::make_shared<gpu::Buffer>(sizeof(CameraCorrection), nullptr )) };
 
@@ -375,6 +424,7 @@ protected:
     static CommandCall _commandCalls[Batch::NUM_COMMANDS];
     friend class GLState;
     friend class GLTexture;
+    friend class GLBuffer;
 };
 
 } }
@@ -26,7 +26,7 @@ void GLBackend::do_setInputFormat(const Batch& batch, size_t paramOffset) {
 void GLBackend::do_setInputBuffer(const Batch& batch, size_t paramOffset) {
     Offset stride = batch._params[paramOffset + 0]._uint;
     Offset offset = batch._params[paramOffset + 1]._uint;
-    BufferPointer buffer = batch._buffers.get(batch._params[paramOffset + 2]._uint);
+    const BufferPointer& buffer = batch._buffers.get(batch._params[paramOffset + 2]._uint);
     uint32 channel = batch._params[paramOffset + 3]._uint;
 
     if (channel < getNumInputBuffers()) {
@@ -72,6 +72,9 @@ void GLBackend::killInput() {
     if(_input._defaultVAO) {
         glDeleteVertexArrays(1, &_input._defaultVAO);
     }
+    if (_input._stereoIndirectBuffer) {
+        glDeleteBuffers(1, &_input._stereoIndirectBuffer);
+    }
     (void) CHECK_GL_ERROR();
 }
 
@@ -120,7 +123,7 @@ void GLBackend::do_setIndexBuffer(const Batch& batch, size_t paramOffset) {
     _input._indexBufferType = (Type)batch._params[paramOffset + 2]._uint;
     _input._indexBufferOffset = batch._params[paramOffset + 0]._uint;
 
-    BufferPointer indexBuffer = batch._buffers.get(batch._params[paramOffset + 1]._uint);
+    const BufferPointer& indexBuffer = batch._buffers.get(batch._params[paramOffset + 1]._uint);
     if (indexBuffer != _input._indexBuffer) {
         _input._indexBuffer = indexBuffer;
         if (indexBuffer) {
@@ -137,7 +140,7 @@ void GLBackend::do_setIndirectBuffer(const Batch& batch, size_t paramOffset) {
     _input._indirectBufferOffset = batch._params[paramOffset + 1]._uint;
     _input._indirectBufferStride = batch._params[paramOffset + 2]._uint;
 
-    BufferPointer buffer = batch._buffers.get(batch._params[paramOffset]._uint);
+    const BufferPointer& buffer = batch._buffers.get(batch._params[paramOffset]._uint);
     if (buffer != _input._indirectBuffer) {
         _input._indirectBuffer = buffer;
         if (buffer) {
@@ -151,6 +154,29 @@ void GLBackend::do_setIndirectBuffer(const Batch& batch, size_t paramOffset) {
     (void)CHECK_GL_ERROR();
 }
 
+GLvoid* GLBackend::bindStereoIndirectCommands(uint32 commandCount, size_t commandSize) {
+    size_t stride = _input._indirectBufferStride ? _input._indirectBufferStride : commandSize;
+    auto& commands = _input._stereoIndirectCommands;
+    commands.resize(commandCount * stride);
+    memcpy(commands.data(), _input._indirectBuffer->getData() + _input._indirectBufferOffset, commands.size());
+    for (uint32 i = 0; i < commandCount; i++) {
+        // The instance count is the second field of both the indirect command layouts
+        reinterpret_cast<uint32*>(commands.data() + i * stride)[1] *= 2;
+    }
+
+    if (!_input._stereoIndirectBuffer) {
+        glGenBuffers(1, &_input._stereoIndirectBuffer);
+    }
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, _input._stereoIndirectBuffer);
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, commands.size(), commands.data(), GL_STREAM_DRAW);
+    (void)CHECK_GL_ERROR();
+    return nullptr;
+}
+
+void GLBackend::restoreIndirectBuffer() {
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, _input._indirectBuffer ? getBufferID(*_input._indirectBuffer) : 0);
+    (void)CHECK_GL_ERROR();
+}
 
 // Core 41 doesn't expose the features to really separate the vertex format from the vertex buffers binding
 // Core 43 does :)
@@ -163,6 +189,12 @@ void GLBackend::do_setIndirectBuffer(const Batch& batch, size_t paramOffset) {
 #endif
 
 void GLBackend::updateInput() {
+    if (_input._stereoDivisors != isStereo()) {
+        _input._stereoDivisors = isStereo();
+        _input._invalidFormat = true;
+    }
+    GLuint divisorScale = _input._stereoDivisors ? 2 : 1;
+
 #if defined(SUPPORT_VERTEX_ATTRIB_FORMAT)
     if (_input._invalidFormat) {
 
@@ -187,7 +219,7 @@ void GLBackend::updateInput() {
                     glVertexAttribFormat(slot + locNum, count, type, isNormalized, offset + locNum * perLocationSize);
                     glVertexAttribBinding(slot + locNum, attrib._channel);
                 }
-                glVertexBindingDivisor(attrib._channel, attrib._frequency);
+                glVertexBindingDivisor(attrib._channel, attrib._frequency * divisorScale);
             }
             (void)CHECK_GL_ERROR();
         }
@@ -306,7 +338,7 @@ void GLBackend::updateInput() {
                             for (size_t locNum = 0; locNum < locationCount; ++locNum) {
                                 glVertexAttribPointer(slot + (GLuint)locNum, count, type, isNormalized, stride,
                                     reinterpret_cast<GLvoid*>(pointer + perLocationStride * (GLuint)locNum));
-                                glVertexAttribDivisor(slot + (GLuint)locNum, attrib._frequency);
+                                glVertexAttribDivisor(slot + (GLuint)locNum, attrib._frequency * divisorScale);
                             }
 
                             // TODO: Support properly the IAttrib version
@@ -163,3 +163,95 @@ void GLBackend::downloadFramebuffer(const FramebufferPointer& srcFramebuffer, co
 
     (void) CHECK_GL_ERROR();
 }
+
+void GLBackend::downloadFramebufferAsync(const FramebufferPointer& srcFramebuffer, const Vec4i& region,
+                                         const FramebufferDownloadHandler& handler) {
+    auto readFBO = getFramebufferID(srcFramebuffer);
+    if (srcFramebuffer && readFBO) {
+        if ((srcFramebuffer->getWidth() < (region.x + region.z)) || (srcFramebuffer->getHeight() < (region.y + region.w))) {
+          qCDebug(gpugllogging) << "GLBackend::downloadFramebufferAsync : srcFramebuffer is too small to provide the region queried";
+          return;
+        }
+    }
+
+    GLuint pixelBuffer;
+    if (_freePixelBuffers.empty()) {
+        glGenBuffers(1, &pixelBuffer);
+    } else {
+        pixelBuffer = _freePixelBuffers.back();
+        _freePixelBuffers.pop_back();
+    }
+
+    // BGRA bytes are the ARGB32 pixels of QImage
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, pixelBuffer);
+    glBufferData(GL_PIXEL_PACK_BUFFER, region.z * region.w * 4, nullptr, GL_STREAM_READ);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, readFBO);
+    glReadPixels(region.x, region.y, region.z, region.w, GL_BGRA, GL_UNSIGNED_BYTE, nullptr);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    _framebufferDownloads.push_back({ pixelBuffer, fence, glm::ivec2(region.z, region.w), handler });
+
+    (void) CHECK_GL_ERROR();
+}
+
+void GLBackend::processFramebufferDownloads() const {
+    // Keep enough pixel buffers around for a capture every frame
+    static const size_t MAX_FREE_PIXEL_BUFFERS = 3;
+
+    while (!_framebufferDownloads.empty()) {
+        auto& download = _framebufferDownloads.front();
+        GLenum result = glClientWaitSync(download.fence, 0, 0);
+        if (result == GL_TIMEOUT_EXPIRED) {
+            // the later ones can't be done either
+            break;
+        }
+        glDeleteSync(download.fence);
+
+        QImage image;
+        if (result != GL_WAIT_FAILED) {
+            image = QImage(download.size.x, download.size.y, QImage::Format_ARGB32);
+            size_t rowSize = download.size.x * 4;
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, download.pixelBuffer);
+            auto pixels = (const uint8_t*)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, rowSize * download.size.y, GL_MAP_READ_BIT);
+            if (pixels) {
+                // GL rows go bottom up, flip them while copying them out instead of mirroring the image after
+                for (int y = 0; y < download.size.y; ++y) {
+                    memcpy(image.scanLine(download.size.y - 1 - y), pixels + y * rowSize, rowSize);
+                }
+                glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+            } else {
+                image = QImage();
+            }
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        }
+        if (image.isNull()) {
+            qCDebug(gpugllogging) << "GLBackend::processFramebufferDownloads : failed to read back the framebuffer";
+        }
+
+        if (_freePixelBuffers.size() < MAX_FREE_PIXEL_BUFFERS) {
+            _freePixelBuffers.push_back(download.pixelBuffer);
+        } else {
+            glDeleteBuffers(1, &download.pixelBuffer);
+        }
+        auto handler = download.handler;
+        _framebufferDownloads.pop_front();
+
+        handler(image);
+    }
+
+    (void) CHECK_GL_ERROR();
+}
+
+void GLBackend::killFramebufferDownloads() {
+    for (auto& download : _framebufferDownloads) {
+        glDeleteSync(download.fence);
+        glDeleteBuffers(1, &download.pixelBuffer);
+    }
+    _framebufferDownloads.clear();
+    if (!_freePixelBuffers.empty()) {
+        glDeleteBuffers((GLsizei)_freePixelBuffers.size(), _freePixelBuffers.data());
+        _freePixelBuffers.clear();
+    }
+}
@@ -20,7 +20,7 @@ using namespace gpu;
 using namespace gpu::gl;
 
 void GLBackend::do_setPipeline(const Batch& batch, size_t paramOffset) {
-    PipelinePointer pipeline = batch._pipelines.get(batch._params[paramOffset + 0]._uint);
+    const PipelinePointer& pipeline = batch._pipelines.get(batch._params[paramOffset + 0]._uint);
 
     if (_pipeline._pipeline == pipeline) {
         return;
@@ -40,6 +40,16 @@ void GLBackend::do_setPipeline(const Batch& batch, size_t paramOffset) {
 
         _pipeline._state = nullptr;
         _pipeline._invalidState = true;
+        _pipeline._pendingProgram = false;
+    } else if (!Backend::getGPUObject<GLPipeline>(*pipeline) && !GLShader::isProgramReady(*this, pipeline->getProgram())) {
+        // First use of the program, it compiles on the compile thread and the pipeline is set again once it's ready
+        _pipeline._pipeline.reset();
+
+        _pipeline._program = 0;
+        _pipeline._cameraCorrectionLocation = -1;
+        _pipeline._programShader = nullptr;
+        _pipeline._invalidProgram = true;
+        _pipeline._pendingProgram = true;
     } else {
         auto pipelineObject = GLPipeline::sync(*this, *pipeline);
         if (!pipelineObject) {
@@ -47,11 +57,13 @@ void GLBackend::do_setPipeline(const Batch& batch, size_t paramOffset) {
         }
 
         // check the program cache
-        // pick the program version 
-        GLuint glprogram = pipelineObject->_program->getProgram();
+        // pick the program version, the stereo batches draw both eyes in one instanced draw
+        GLShader::Version version = isStereo() ? GLShader::Stereo : GLShader::Mono;
+        GLuint glprogram = pipelineObject->_program->getProgram(version);
 
         if (_pipeline._program != glprogram) {
             _pipeline._program = glprogram;
+            _pipeline._programVersion = version;
             _pipeline._programShader = pipelineObject->_program;
             _pipeline._invalidProgram = true;
             _pipeline._cameraCorrectionLocation = pipelineObject->_cameraCorrection;
@@ -65,6 +77,7 @@ void GLBackend::do_setPipeline(const Batch& batch, size_t paramOffset) {
 
         // Remember the new pipeline
         _pipeline._pipeline = pipeline;
+        _pipeline._pendingProgram = false;
     }
 
     // THis should be done on Pipeline::update...
@@ -80,6 +93,16 @@ void GLBackend::do_setPipeline(const Batch& batch, size_t paramOffset) {
 }
 
 void GLBackend::updatePipeline() {
+    // A pipeline set by a batch of the other stereo mode needs the program version of this one
+    if (_pipeline._programShader) {
+        GLShader::Version version = isStereo() ? GLShader::Stereo : GLShader::Mono;
+        if (_pipeline._programVersion != version) {
+            _pipeline._program = _pipeline._programShader->getProgram(version);
+            _pipeline._programVersion = version;
+            _pipeline._invalidProgram = true;
+        }
+    }
+
     if (_pipeline._invalidProgram) {
         // doing it here is aproblem for calls to glUniform.... so will do it on assing...
         glUseProgram(_pipeline._program);
@@ -119,6 +142,7 @@ void GLBackend::resetPipelineStage() {
     _pipeline._invalidProgram = false;
     _pipeline._program = 0;
     _pipeline._programShader = nullptr;
+    _pipeline._pendingProgram = false;
     _pipeline._pipeline.reset();
     glUseProgram(0);
 }
@@ -143,7 +167,8 @@ void GLBackend::resetUniformStage() {
 
 void GLBackend::do_setUniformBuffer(const Batch& batch, size_t paramOffset) {
     GLuint slot = batch._params[paramOffset + 3]._uint;
-    BufferPointer uniformBuffer = batch._buffers.get(batch._params[paramOffset + 2]._uint);
+    uint32 bufferIndex = batch._params[paramOffset + 2]._uint;
+    const BufferPointer& uniformBuffer = batch._buffers.get(bufferIndex);
     GLintptr rangeStart = batch._params[paramOffset + 1]._uint;
     GLsizeiptr rangeSize = batch._params[paramOffset + 0]._uint;
 
@@ -158,11 +183,12 @@ void GLBackend::do_setUniformBuffer(const Batch& batch, size_t paramOffset) {
     }
 
     // Sync BufferObject
-    auto* object = syncGPUObject(*uniformBuffer);
+    auto* object = getResolvedBuffer(bufferIndex, *uniformBuffer);
     if (object) {
         glBindBufferRange(GL_UNIFORM_BUFFER, slot, object->_buffer, rangeStart, rangeSize);
 
         _uniform._buffers[slot] = uniformBuffer;
+        _stats._RSNumUniformBufferBounded++;
         (void) CHECK_GL_ERROR();
     } else {
         releaseUniformBuffer(slot);
@@ -197,7 +223,8 @@ void GLBackend::do_setResourceTexture(const Batch& batch, size_t paramOffset) {
         return;
     }
 
-    TexturePointer resourceTexture = batch._textures.get(batch._params[paramOffset + 0]._uint);
+    uint32 textureIndex = batch._params[paramOffset + 0]._uint;
+    const TexturePointer& resourceTexture = batch._textures.get(textureIndex);
 
     if (!resourceTexture) {
         releaseResourceTexture(slot);
@@ -212,7 +239,7 @@ void GLBackend::do_setResourceTexture(const Batch& batch, size_t paramOffset) {
     _stats._RSNumTextureBounded++;
 
     // Always make sure the GLObject is in sync
-    GLTexture* object = syncGPUObject(resourceTexture);
+    GLTexture* object = getResolvedTexture(textureIndex, resourceTexture);
     if (object) {
         GLuint to = object->_texture;
         GLuint target = object->_target;
@@ -222,6 +249,7 @@ void GLBackend::do_setResourceTexture(const Batch& batch, size_t paramOffset) {
         (void) CHECK_GL_ERROR();
 
         _resource._textures[slot] = resourceTexture;
+        object->_boundSincePriorityUpdate = true;
 
         _stats._RSAmountTextureMemoryBounded += object->size();
 
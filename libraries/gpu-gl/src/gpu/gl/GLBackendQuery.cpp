@@ -25,6 +25,11 @@ void GLBackend::do_beginQuery(const Batch& batch, size_t paramOffset) {
     auto query = batch._queries.get(batch._params[paramOffset]._uint);
     GLQuery* glquery = syncGPUObject(*query);
     if (glquery) {
+        if (query->getType() == Query::ANY_SAMPLES_PASSED) {
+            glBeginQuery(GL_ANY_SAMPLES_PASSED, glquery->_endqo);
+            (void)CHECK_GL_ERROR();
+            return;
+        }
         glGetInteger64v(GL_TIMESTAMP, (GLint64*)&glquery->_batchElapsedTime);
         if (timeElapsed) {
             glBeginQuery(GL_TIME_ELAPSED, glquery->_endqo);
@@ -39,6 +44,11 @@ void GLBackend::do_endQuery(const Batch& batch, size_t paramOffset) {
     auto query = batch._queries.get(batch._params[paramOffset]._uint);
     GLQuery* glquery = syncGPUObject(*query);
     if (glquery) {
+        if (query->getType() == Query::ANY_SAMPLES_PASSED) {
+            glEndQuery(GL_ANY_SAMPLES_PASSED);
+            (void)CHECK_GL_ERROR();
+            return;
+        }
         if (timeElapsed) {
             glEndQuery(GL_TIME_ELAPSED);
         } else {
@@ -58,7 +68,9 @@ void GLBackend::do_getQuery(const Batch& batch, size_t paramOffset) {
     if (glquery) { 
         glGetQueryObjectui64v(glquery->_endqo, GL_QUERY_RESULT_AVAILABLE, &glquery->_result);
         if (glquery->_result == GL_TRUE) {
-            if (timeElapsed) {
+            if (query->getType() == Query::ANY_SAMPLES_PASSED) {
+                glGetQueryObjectui64v(glquery->_endqo, GL_QUERY_RESULT, &glquery->_result);
+            } else if (timeElapsed) {
                 glGetQueryObjectui64v(glquery->_endqo, GL_QUERY_RESULT, &glquery->_result);
             } else {
                 GLuint64 start, end;
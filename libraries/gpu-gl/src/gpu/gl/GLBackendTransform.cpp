@@ -31,7 +31,8 @@ void GLBackend::do_setProjectionTransform(const Batch& batch, size_t paramOffset
 void GLBackend::do_setViewportTransform(const Batch& batch, size_t paramOffset) {
     memcpy(&_transform._viewport, batch.readData(batch._params[paramOffset]._uint), sizeof(Vec4i));
 
-    if (!_inRenderTransferPass && !isStereo()) {
+    // In stereo the eyes are drawn side by side in the one viewport, each instance clipping its half
+    if (!_inRenderTransferPass) {
         ivec4& vp = _transform._viewport;
         glViewport(vp.x, vp.y, vp.z, vp.w);
     }
@@ -101,10 +102,9 @@ void GLBackend::TransformStageState::preUpdate(size_t commandIndex, const Stereo
         size_t offset = _cameraUboSize * _cameras.size();
         _cameraOffsets.push_back(TransformStageState::Pair(commandIndex, offset));
         if (stereo._enable) {
-            _cameras.push_back((_camera.getEyeCamera(0, stereo, _view)));
-            _cameras.push_back((_camera.getEyeCamera(1, stereo, _view)));
+            _cameras.push_back(CameraBufferElement(_camera.getEyeCamera(0, stereo, _view), _camera.getEyeCamera(1, stereo, _view)));
         } else {
-            _cameras.push_back((_camera.recomputeDerived(_view)));
+            _cameras.push_back(CameraBufferElement(_camera.recomputeDerived(_view)));
         }
 
     }
@@ -122,16 +122,14 @@ void GLBackend::TransformStageState::update(size_t commandIndex, const StereoSta
     }
 
     if (offset != INVALID_OFFSET) {
-        if (!stereo._enable) {
-            bindCurrentCamera(0);
-        }
+        bindCurrentCamera();
     }
     (void)CHECK_GL_ERROR();
 }
 
-void GLBackend::TransformStageState::bindCurrentCamera(int eye) const {
+void GLBackend::TransformStageState::bindCurrentCamera() const {
     if (_currentCameraOffset != INVALID_OFFSET) {
-        glBindBufferRange(GL_UNIFORM_BUFFER, TRANSFORM_CAMERA_SLOT, _cameraBuffer, _currentCameraOffset + eye * _cameraUboSize, sizeof(CameraBufferElement));
+        glBindBufferRange(GL_UNIFORM_BUFFER, TRANSFORM_CAMERA_SLOT, _cameraBuffer, _cameraBufferOffset + _currentCameraOffset, sizeof(CameraBufferElement));
     }
 }
 
@@ -148,7 +146,8 @@ void GLBackend::updateTransform(const Batch& batch) {
         glBindBuffer(GL_ARRAY_BUFFER, _transform._drawCallInfoBuffer);
         glVertexAttribIPointer(gpu::Stream::DRAW_CALL_INFO, 2, GL_UNSIGNED_SHORT, 0,
                                _transform._drawCallInfoOffsets[batch._currentNamedCall]);
-        glVertexAttribDivisor(gpu::Stream::DRAW_CALL_INFO, 1);
+        // Both eye instances of a draw read the same draw call info
+        glVertexAttribDivisor(gpu::Stream::DRAW_CALL_INFO, isStereo() ? 2 : 1);
     }
     
     (void)CHECK_GL_ERROR();
@@ -33,7 +33,7 @@ public:
         }
 
         if (0 != (buffer._renderPages._flags & PageManager::DIRTY)) {
-            object->transfer();
+            object->transfer(backend._stats);
         }
 
         return object;
@@ -55,7 +55,11 @@ public:
 
     ~GLBuffer();
 
-    virtual void transfer() = 0;
+    // Upload the dirty pages of the render sysmem, counting the calls and the bytes in the stats
+    virtual void transfer(ContextStats& stats) = 0;
+
+    // Dirty runs separated by this many clean pages or less are uploaded in a single call
+    static const Size MAX_TRANSFER_GAP_PAGES { 4 };
 
 protected:
     GLBuffer(const std::weak_ptr<GLBackend>& backend, const Buffer& buffer, GLuint id);
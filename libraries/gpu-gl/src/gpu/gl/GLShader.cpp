@@ -6,6 +6,9 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 #include "GLShader.h"
+
+#include <mutex>
+
 #include <gl/GLShaders.h>
 
 #include "GLBackend.h"
@@ -13,6 +16,11 @@
 using namespace gpu;
 using namespace gpu::gl;
 
+std::shared_ptr<GLShaderCompileHelper> GLShader::_shaderCompileHelper;
+
+// The render and compile threads both sync shaders, and the programs share their domain shaders
+static std::recursive_mutex shaderSyncMutex;
+
 GLShader::GLShader(const std::weak_ptr<GLBackend>& backend) : _backend(backend) {
 }
 
@@ -56,9 +64,14 @@ static const std::array<std::string, NUM_SHADER_DOMAINS> DOMAIN_DEFINES { {
 
 // Versions specific of the shader
 static const std::array<std::string, GLShader::NumVersions> VERSION_DEFINES { {
-    ""
+    "",
+    "#define GPU_TRANSFORM_IS_STEREO"
 } };
 
+static std::string getShaderDefines(Shader::Type type, int version) {
+    return glslVersion + "\n" + DOMAIN_DEFINES[type] + "\n" + VERSION_DEFINES[version];
+}
+
 GLShader* compileBackendShader(GLBackend& backend, const Shader& shader) {
     // Any GLSLprogram ? normally yes...
     const std::string& shaderSource = shader.getSource().getCode();
@@ -68,7 +81,7 @@ GLShader* compileBackendShader(GLBackend& backend, const Shader& shader) {
     for (int version = 0; version < GLShader::NumVersions; version++) {
         auto& shaderObject = shaderObjects[version];
 
-        std::string shaderDefines = glslVersion + "\n" + DOMAIN_DEFINES[shader.getType()] + "\n" + VERSION_DEFINES[version];
+        std::string shaderDefines = getShaderDefines(shader.getType(), version);
 
 #ifdef SEPARATE_PROGRAM
         bool result = ::gl::compileShader(shaderDomain, shaderSource, shaderDefines, shaderObject.glshader, shaderObject.glprogram);
@@ -97,6 +110,22 @@ GLShader* compileBackendProgram(GLBackend& backend, const Shader& program) {
     for (int version = 0; version < GLShader::NumVersions; version++) {
         auto& programObject = programObjects[version];
 
+        // A program linked in a previous run loads from its cached binary, without compiling its shaders
+        std::vector<std::string> programSources;
+        for (auto subShader : program.getShaders()) {
+            programSources.push_back(getShaderDefines(subShader->getType(), version));
+            programSources.push_back(subShader->getSource().getCode());
+        }
+        std::string programKey = ::gl::evalProgramKey(programSources);
+        GLuint cachedProgram = ::gl::loadCachedProgram(programKey);
+        if (cachedProgram) {
+            programObject.glprogram = cachedProgram;
+
+            // The attribute locations are already linked in the binary
+            makeProgramBlockBindings(programObject);
+            continue;
+        }
+
         // Let's go through every shaders and make sure they are ready to go
         std::vector< GLuint > shaderGLObjects;
         for (auto subShader : program.getShaders()) {
@@ -117,6 +146,8 @@ GLShader* compileBackendProgram(GLBackend& backend, const Shader& program) {
         programObject.glprogram = glprogram;
 
         makeProgramBindings(programObject);
+
+        ::gl::cacheProgram(programKey, glprogram);
     }
 
     // So far so good, the program versions have all been created successfully
@@ -127,6 +158,7 @@ GLShader* compileBackendProgram(GLBackend& backend, const Shader& program) {
 }
 
 GLShader* GLShader::sync(GLBackend& backend, const Shader& shader) {
+    std::lock_guard<std::recursive_mutex> lock(shaderSyncMutex);
     GLShader* object = Backend::getGPUObject<GLShader>(shader);
 
     // If GPU object already created then good
@@ -152,6 +184,14 @@ GLShader* GLShader::sync(GLBackend& backend, const Shader& shader) {
     return object;
 }
 
+void GLShader::initShaderCompileHelper() {
+    _shaderCompileHelper = std::make_shared<GLShaderCompileHelper>();
+}
+
+bool GLShader::isProgramReady(GLBackend& backend, const ShaderPointer& program) {
+    return !_shaderCompileHelper || _shaderCompileHelper->isProgramReady(backend, program);
+}
+
 bool GLShader::makeProgram(GLBackend& backend, Shader& shader, const Shader::BindingSet& slotBindings) {
 
     // First make sure the Shader has been compiled
@@ -9,6 +9,7 @@
 #define hifi_gpu_gl_GLShader_h
 
 #include "GLShared.h"
+#include "GLShaderCompile.h"
 
 namespace gpu { namespace gl {
 
@@ -17,8 +18,15 @@ public:
     static GLShader* sync(GLBackend& backend, const Shader& shader);
     static bool makeProgram(GLBackend& backend, Shader& shader, const Shader::BindingSet& slotBindings);
 
+    // The programs first used by a pipeline compile on the compile thread, see GLShaderCompileHelper
+    static void initShaderCompileHelper();
+    static bool isProgramReady(GLBackend& backend, const ShaderPointer& program);
+    static std::shared_ptr<GLShaderCompileHelper> _shaderCompileHelper;
+
+    // The stereo version draws both eyes in one instanced draw, see GPU_TRANSFORM_IS_STEREO in Transform.slh
     enum Version {
         Mono = 0,
+        Stereo,
         NumVersions
     };
 
@@ -39,9 +47,13 @@ public:
     }
 
     GLint getUniformLocation(GLint srcLoc, Version version = Mono) {
-        // THIS will be used in the future PR as we grow the number of versions
-        // return _uniformMappings[version][srcLoc];
-        return srcLoc;
+        // The public locations are the ones of the mono version, the other versions map them to their own
+        if (version == Mono || (size_t)version > _uniformMappings.size()) {
+            return srcLoc;
+        }
+        const auto& mapping = _uniformMappings[version - 1];
+        auto location = mapping.find(srcLoc);
+        return (location != mapping.end()) ? location->second : srcLoc;
     }
 
     const std::weak_ptr<GLBackend> _backend;
@@ -0,0 +1,99 @@
+//
+//  Created by Sam Gateau on 10/15/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+#include "GLShaderCompile.h"
+
+#include <QtCore/QCoreApplication>
+
+#include "GLBackend.h"
+#include "GLShader.h"
+
+using namespace gpu;
+using namespace gpu::gl;
+
+GLShaderCompileHelper::GLShaderCompileHelper() {
+#ifdef THREADED_SHADER_COMPILE
+    setObjectName("ShaderCompileThread");
+    _context.create();
+    initialize(true, QThread::LowPriority);
+    // Clean shutdown on UNIX, otherwise _canvas is freed early
+    connect(qApp, &QCoreApplication::aboutToQuit, [&] { terminate(); });
+#else
+    initialize(false, QThread::LowPriority);
+#endif
+}
+
+GLShaderCompileHelper::~GLShaderCompileHelper() {
+#ifdef THREADED_SHADER_COMPILE
+    if (isStillRunning()) {
+        terminate();
+    }
+#else
+    terminate();
+#endif
+}
+
+bool GLShaderCompileHelper::isProgramReady(GLBackend& backend, const ShaderPointer& program) {
+    if (!isThreaded()) {
+        return true;
+    }
+
+    Lock lock(_mutex);
+    if (_compilingPrograms.find(program.get()) != _compilingPrograms.end()) {
+        return false;
+    }
+    // Once out of the compiling set the compile thread is done with the program
+    if (program->compilationHasFailed() || Backend::getGPUObject<GLShader>(*program)) {
+        return true;
+    }
+
+    _compilingPrograms.insert(program.get());
+    _pendingPrograms.emplace_back(program, backend.shared_from_this());
+    return false;
+}
+
+void GLShaderCompileHelper::setup() {
+#ifdef THREADED_SHADER_COMPILE
+    _context.makeCurrent();
+#endif
+}
+
+void GLShaderCompileHelper::shutdown() {
+#ifdef THREADED_SHADER_COMPILE
+    _context.makeCurrent();
+#endif
+}
+
+bool GLShaderCompileHelper::process() {
+    PendingPrograms pendingPrograms;
+    {
+        Lock lock(_mutex);
+        pendingPrograms.swap(_pendingPrograms);
+    }
+
+    if (pendingPrograms.empty()) {
+#ifdef THREADED_SHADER_COMPILE
+        // Don't saturate the CPU
+        QThread::msleep(1);
+#endif
+        return true;
+    }
+
+    for (auto& pendingProgram : pendingPrograms) {
+        const auto& program = pendingProgram.first;
+        auto backend = pendingProgram.second.lock();
+        // GLShader::sync finishes the program before returning, so it is complete for the render context
+        if (backend && !GLShader::sync(*backend, *program)) {
+            program->setCompilationHasFailed(true);
+        }
+
+        Lock lock(_mutex);
+        _compilingPrograms.erase(program.get());
+    }
+
+    return true;
+}
@@ -0,0 +1,62 @@
+//
+//  Created by Sam Gateau on 10/15/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+#ifndef hifi_gpu_gl_GLShaderCompile_h
+#define hifi_gpu_gl_GLShaderCompile_h
+
+#include <list>
+#include <unordered_set>
+
+#include <QtGlobal>
+
+#include <GenericThread.h>
+
+#include <gl/Context.h>
+
+#include "GLShared.h"
+
+// Same platforms as the texture transfer thread, the shared offscreen contexts are reliable there
+#ifdef Q_OS_WIN
+#define THREADED_SHADER_COMPILE
+#endif
+
+namespace gpu { namespace gl {
+
+// Compiles the programs of the pipelines on their first use on a shared context, so the frame using them
+// doesn't stall on the compilation and link. Without the thread the programs compile inline as before.
+class GLShaderCompileHelper : public GenericThread {
+public:
+    using Pointer = std::shared_ptr<GLShaderCompileHelper>;
+    GLShaderCompileHelper();
+    ~GLShaderCompileHelper();
+
+    // True once the program is compiled, or failed to, otherwise queues its compilation and returns false
+    bool isProgramReady(GLBackend& backend, const ShaderPointer& program);
+
+    void setup() override;
+    void shutdown() override;
+    bool process() override;
+
+private:
+    using PendingProgram = std::pair<ShaderPointer, std::weak_ptr<GLBackend>>;
+    using PendingPrograms = std::list<PendingProgram>;
+
+#ifdef THREADED_SHADER_COMPILE
+    ::gl::OffscreenContext _context;
+#endif
+
+    // A mutex for protecting items access on the render and compile threads
+    Mutex _mutex;
+    // Programs submitted for compilation
+    PendingPrograms _pendingPrograms;
+    // Programs submitted or compiling, their GLShader is not safe to look at from the render thread yet
+    std::unordered_set<const Shader*> _compilingPrograms;
+};
+
+} }
+
+#endif
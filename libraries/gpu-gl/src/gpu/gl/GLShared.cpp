@@ -755,6 +755,15 @@ void makeProgramBindings(ShaderObject& shaderObject) {
     }
 
     // now assign the ubo binding, then DON't relink!
+    makeProgramBlockBindings(shaderObject);
+}
+
+void makeProgramBlockBindings(ShaderObject& shaderObject) {
+    if (!shaderObject.glprogram) {
+        return;
+    }
+    GLuint glprogram = shaderObject.glprogram;
+    GLint loc = -1;
 
     //Check for gpu specific uniform slotBindings
 #ifdef GPU_SSBO_DRAW_CALL_INFO
@@ -45,6 +45,8 @@ int makeUniformBlockSlots(GLuint glprogram, const Shader::BindingSet& slotBindin
 int makeInputSlots(GLuint glprogram, const Shader::BindingSet& slotBindings, Shader::SlotSet& inputs);
 int makeOutputSlots(GLuint glprogram, const Shader::BindingSet& slotBindings, Shader::SlotSet& outputs);
 void makeProgramBindings(ShaderObject& shaderObject);
+// The bindings which don't need a relink, for the programs loaded linked already
+void makeProgramBlockBindings(ShaderObject& shaderObject);
 
 enum GLSyncState {
     // The object is currently undergoing no processing, although it's content
@@ -76,6 +76,7 @@ GLenum GLTexelFormat::evalGLTexelFormatInternal(const gpu::Element& dstFormat) {
                     break;
 
                 case gpu::COMPRESSED_R:
+                case gpu::COMPRESSED_BC4_RED:
                     result = GL_COMPRESSED_RED_RGTC1;
                     break;
 
@@ -131,6 +132,9 @@ GLenum GLTexelFormat::evalGLTexelFormatInternal(const gpu::Element& dstFormat) {
                 case gpu::RGBA:
                     result = GL_RG8;
                     break;
+                case gpu::COMPRESSED_BC5_XY:
+                    result = GL_COMPRESSED_RG_RGTC2;
+                    break;
                 default:
                     qCDebug(gpugllogging) << "Unknown combination of texel format";
             }
@@ -154,6 +158,9 @@ GLenum GLTexelFormat::evalGLTexelFormatInternal(const gpu::Element& dstFormat) {
                 case gpu::COMPRESSED_SRGB:
                     result = GL_COMPRESSED_SRGB;
                     break;
+                case gpu::COMPRESSED_BC1_SRGB:
+                    result = GL_COMPRESSED_SRGB_S3TC_DXT1_EXT;
+                    break;
                 default:
                     qCDebug(gpugllogging) << "Unknown combination of texel format";
             }
@@ -222,23 +229,15 @@ GLenum GLTexelFormat::evalGLTexelFormatInternal(const gpu::Element& dstFormat) {
                 case gpu::COMPRESSED_SRGBA:
                     result = GL_COMPRESSED_SRGB_ALPHA;
                     break;
-
-                    // FIXME: WE will want to support this later
-                    /*
-                    case gpu::COMPRESSED_BC3_RGBA:
-                    result = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+                case gpu::COMPRESSED_BC1_SRGBA:
+                    result = GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT;
                     break;
-                    case gpu::COMPRESSED_BC3_SRGBA:
+                case gpu::COMPRESSED_BC3_SRGBA:
                     result = GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT;
                     break;
-
-                    case gpu::COMPRESSED_BC7_RGBA:
-                    result = GL_COMPRESSED_RGBA_BPTC_UNORM_ARB;
-                    break;
-                    case gpu::COMPRESSED_BC7_SRGBA:
+                case gpu::COMPRESSED_BC7_SRGBA:
                     result = GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM;
                     break;
-                    */
 
                 default:
                     qCDebug(gpugllogging) << "Unknown combination of texel format";
@@ -268,6 +267,7 @@ GLTexelFormat GLTexelFormat::evalGLTexelFormat(const Element& dstFormat, const E
                 break;
 
             case gpu::COMPRESSED_R:
+            case gpu::COMPRESSED_BC4_RED:
                 texel.internalFormat = GL_COMPRESSED_RED_RGTC1;
                 break;
 
@@ -294,6 +294,9 @@ GLTexelFormat GLTexelFormat::evalGLTexelFormat(const Element& dstFormat, const E
             case gpu::RGBA:
                 texel.internalFormat = GL_RG8;
                 break;
+            case gpu::COMPRESSED_BC5_XY:
+                texel.internalFormat = GL_COMPRESSED_RG_RGTC2;
+                break;
             default:
                 qCDebug(gpugllogging) << "Unknown combination of texel format";
             }
@@ -317,6 +320,9 @@ GLTexelFormat GLTexelFormat::evalGLTexelFormat(const Element& dstFormat, const E
             case gpu::COMPRESSED_SRGB:
                 texel.internalFormat = GL_COMPRESSED_SRGB;
                 break;
+            case gpu::COMPRESSED_BC1_SRGB:
+                texel.internalFormat = GL_COMPRESSED_SRGB_S3TC_DXT1_EXT;
+                break;
             default:
                 qCDebug(gpugllogging) << "Unknown combination of texel format";
             }
@@ -360,25 +366,16 @@ GLTexelFormat GLTexelFormat::evalGLTexelFormat(const Element& dstFormat, const E
                 break;
             case gpu::COMPRESSED_SRGBA:
                 texel.internalFormat = GL_COMPRESSED_SRGB_ALPHA;
-
                 break;
-
-                // FIXME: WE will want to support this later
-                /*
-                case gpu::COMPRESSED_BC3_RGBA:
-                texel.internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+            case gpu::COMPRESSED_BC1_SRGBA:
+                texel.internalFormat = GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT;
                 break;
-                case gpu::COMPRESSED_BC3_SRGBA:
+            case gpu::COMPRESSED_BC3_SRGBA:
                 texel.internalFormat = GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT;
                 break;
-
-                case gpu::COMPRESSED_BC7_RGBA:
-                texel.internalFormat = GL_COMPRESSED_RGBA_BPTC_UNORM_ARB;
-                break;
-                case gpu::COMPRESSED_BC7_SRGBA:
+            case gpu::COMPRESSED_BC7_SRGBA:
                 texel.internalFormat = GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM;
                 break;
-                */
 
             default:
                 qCDebug(gpugllogging) << "Unknown combination of texel format";
@@ -399,7 +396,8 @@ GLTexelFormat GLTexelFormat::evalGLTexelFormat(const Element& dstFormat, const E
             texel.type = ELEMENT_TYPE_TO_GL[dstFormat.getType()];
 
             switch (dstFormat.getSemantic()) {
-            case gpu::COMPRESSED_R: {
+            case gpu::COMPRESSED_R:
+            case gpu::COMPRESSED_BC4_RED: {
                 texel.internalFormat = GL_COMPRESSED_RED_RGTC1;
                 break;
             }
@@ -538,6 +536,9 @@ GLTexelFormat GLTexelFormat::evalGLTexelFormat(const Element& dstFormat, const E
             case gpu::RGBA:
                 texel.internalFormat = GL_RG8;
                 break;
+            case gpu::COMPRESSED_BC5_XY:
+                texel.internalFormat = GL_COMPRESSED_RG_RGTC2;
+                break;
             default:
                 qCDebug(gpugllogging) << "Unknown combination of texel format";
             }
@@ -565,6 +566,9 @@ GLTexelFormat GLTexelFormat::evalGLTexelFormat(const Element& dstFormat, const E
             case gpu::COMPRESSED_SRGB:
                 texel.internalFormat = GL_COMPRESSED_SRGB;
                 break;
+            case gpu::COMPRESSED_BC1_SRGB:
+                texel.internalFormat = GL_COMPRESSED_SRGB_S3TC_DXT1_EXT;
+                break;
             default:
                 qCDebug(gpugllogging) << "Unknown combination of texel format";
             }
@@ -647,6 +651,15 @@ GLTexelFormat GLTexelFormat::evalGLTexelFormat(const Element& dstFormat, const E
             case gpu::COMPRESSED_SRGBA:
                 texel.internalFormat = GL_COMPRESSED_SRGB_ALPHA;
                 break;
+            case gpu::COMPRESSED_BC1_SRGBA:
+                texel.internalFormat = GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT;
+                break;
+            case gpu::COMPRESSED_BC3_SRGBA:
+                texel.internalFormat = GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT;
+                break;
+            case gpu::COMPRESSED_BC7_SRGBA:
+                texel.internalFormat = GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM;
+                break;
             default:
                 qCDebug(gpugllogging) << "Unknown combination of texel format";
             }
@@ -255,6 +255,9 @@ bool GLTexture::isReady() const {
     return true;
 }
 
+bool GLTexture::isPopulated() const {
+    return GLSyncState::Pending == _syncState && INVALID_MIP != _populatedMip;
+}
 
 // Do any post-transfer operations that might be required on the main context / rendering thread
 void GLTexture::postTransfer() {
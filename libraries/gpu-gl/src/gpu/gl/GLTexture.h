@@ -106,7 +106,8 @@ public:
             return nullptr;
         }
 
-        if (!object->isReady()) {
+        // Textures streaming their mips in are sampled from the mips uploaded so far
+        if (!object->isReady() && !object->isPopulated()) {
             return nullptr;
         }
 
@@ -160,6 +161,12 @@ public:
     Stamp _contentStamp { 0 };
     const bool _transferrable;
     Size _transferCount { 0 };
+    // Lowest mip level uploaded by the transfer in progress, when it goes from the smallest mips to the largest
+    std::atomic<uint16> _populatedMip { INVALID_MIP };
+    // How visible the texture has been lately, the transfers and the derez go by it
+    std::atomic<float> _priority { 0.0f };
+    // Set when a batch binds the texture, and cleared by the priority update. Only touched on the render thread
+    bool _boundSincePriorityUpdate { false };
     GLuint size() const { return _size; }
     GLSyncState getSyncState() const { return _syncState; }
 
@@ -172,6 +179,9 @@ public:
     // Is the texture in a state where it can be rendered with no work?
     bool isReady() const;
 
+    // Is the texture still in transfer, but with enough mips uploaded to be rendered from its populated mip?
+    bool isPopulated() const;
+
     // Execute any post-move operations that must occur only on the main thread
     virtual void postTransfer();
 
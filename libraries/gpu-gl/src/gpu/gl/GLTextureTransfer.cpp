@@ -7,6 +7,8 @@
 //
 #include "GLTextureTransfer.h"
 
+#include <algorithm>
+
 #include <gl/GLHelpers.h>
 #include <gl/Context.h>
 
@@ -53,6 +55,7 @@ void GLTextureTransferHelper::transferTexture(const gpu::TexturePointer& texture
     GLTexture* object = Backend::getGPUObject<GLTexture>(*texturePointer);
 
     Backend::incrementTextureGPUTransferCount();
+    object->_populatedMip = GLTexture::INVALID_MIP;
     object->setSyncState(GLSyncState::Pending);
     Lock lock(_mutex);
     _pendingTextures.push_back(texturePointer);
@@ -137,9 +140,36 @@ bool GLTextureTransferHelper::process() {
             _transferringTextures.push_back(texturePointer);
             _textureIterator = _transferringTextures.begin();
         }
-        _transferringTextures.sort([](const gpu::TexturePointer& a, const gpu::TexturePointer& b)->bool {
-            return a->getSize() < b->getSize();
+    }
+
+    // The textures that can't be rendered yet go first, then the most visible ones and the smallest ones.
+    // The priorities move while the textures transfer, so they are sorted on a snapshot
+    if (_transferringTextures.size() > 1) {
+        struct TransferOrder {
+            bool populated;
+            float priority;
+            Size size;
+            TexturePointer texture;
+        };
+        std::vector<TransferOrder> transferOrders;
+        transferOrders.reserve(_transferringTextures.size());
+        for (auto& texturePointer : _transferringTextures) {
+            GLTexture* object = Backend::getGPUObject<GLTexture>(*texturePointer);
+            transferOrders.push_back({ object->isPopulated(), object->_priority, texturePointer->getSize(), texturePointer });
+        }
+        std::stable_sort(transferOrders.begin(), transferOrders.end(), [](const TransferOrder& a, const TransferOrder& b) {
+            if (a.populated != b.populated) {
+                return !a.populated;
+            }
+            if (a.priority != b.priority) {
+                return a.priority > b.priority;
+            }
+            return a.size < b.size;
         });
+        _transferringTextures.clear();
+        for (auto& transferOrder : transferOrders) {
+            _transferringTextures.push_back(transferOrder.texture);
+        }
     }
 
     // No transfers in progress, sleep
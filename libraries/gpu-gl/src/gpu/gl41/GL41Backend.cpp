@@ -25,10 +25,8 @@ void GL41Backend::do_draw(const Batch& batch, size_t paramOffset) {
     uint32 startVertex = batch._params[paramOffset + 0]._uint;
 
     if (isStereo()) {
-        setupStereoSide(0);
-        glDrawArrays(mode, startVertex, numVertices);
-        setupStereoSide(1);
-        glDrawArrays(mode, startVertex, numVertices);
+        // One instance per eye
+        glDrawArraysInstancedARB(mode, startVertex, numVertices, 2);
 
         _stats._DSNumTriangles += 2 * numVertices / 3;
         _stats._DSNumDrawcalls += 2;
@@ -55,10 +53,8 @@ void GL41Backend::do_drawIndexed(const Batch& batch, size_t paramOffset) {
     GLvoid* indexBufferByteOffset = reinterpret_cast<GLvoid*>(startIndex * typeByteSize + _input._indexBufferOffset);
 
     if (isStereo()) {
-        setupStereoSide(0);
-        glDrawElements(mode, numIndices, glType, indexBufferByteOffset);
-        setupStereoSide(1);
-        glDrawElements(mode, numIndices, glType, indexBufferByteOffset);
+        // One instance per eye
+        glDrawElementsInstanced(mode, numIndices, glType, indexBufferByteOffset, 2);
 
         _stats._DSNumTriangles += 2 * numIndices / 3;
         _stats._DSNumDrawcalls += 2;
@@ -83,10 +79,7 @@ void GL41Backend::do_drawInstanced(const Batch& batch, size_t paramOffset) {
     if (isStereo()) {
         GLint trueNumInstances = 2 * numInstances;
 
-        setupStereoSide(0);
-        glDrawArraysInstancedARB(mode, startVertex, numVertices, numInstances);
-        setupStereoSide(1);
-        glDrawArraysInstancedARB(mode, startVertex, numVertices, numInstances);
+        glDrawArraysInstancedARB(mode, startVertex, numVertices, trueNumInstances);
 
         _stats._DSNumTriangles += (trueNumInstances * numVertices) / 3;
         _stats._DSNumDrawcalls += trueNumInstances;
@@ -124,10 +117,7 @@ void GL41Backend::do_drawIndexedInstanced(const Batch& batch, size_t paramOffset
     if (isStereo()) {
         GLint trueNumInstances = 2 * numInstances;
 
-        setupStereoSide(0);
-        glbackend_glDrawElementsInstancedBaseVertexBaseInstance(mode, numIndices, glType, indexBufferByteOffset, numInstances, 0, startInstance);
-        setupStereoSide(1);
-        glbackend_glDrawElementsInstancedBaseVertexBaseInstance(mode, numIndices, glType, indexBufferByteOffset, numInstances, 0, startInstance);
+        glbackend_glDrawElementsInstancedBaseVertexBaseInstance(mode, numIndices, glType, indexBufferByteOffset, trueNumInstances, 0, startInstance);
 
         _stats._DSNumTriangles += (trueNumInstances * numIndices) / 3;
         _stats._DSNumDrawcalls += trueNumInstances;
@@ -148,8 +138,15 @@ void GL41Backend::do_multiDrawIndirect(const Batch& batch, size_t paramOffset) {
     uint commandCount = batch._params[paramOffset + 0]._uint;
     GLenum mode = gl::PRIMITIVE_TO_GL[(Primitive)batch._params[paramOffset + 1]._uint];
 
-    glMultiDrawArraysIndirect(mode, reinterpret_cast<GLvoid*>(_input._indirectBufferOffset), commandCount, (GLsizei)_input._indirectBufferStride);
-    _stats._DSNumDrawcalls += commandCount;
+    if (isStereo()) {
+        GLvoid* indirectBufferOffset = bindStereoIndirectCommands(commandCount, sizeof(Batch::DrawIndirectCommand));
+        glMultiDrawArraysIndirect(mode, indirectBufferOffset, commandCount, (GLsizei)_input._indirectBufferStride);
+        restoreIndirectBuffer();
+        _stats._DSNumDrawcalls += 2 * commandCount;
+    } else {
+        glMultiDrawArraysIndirect(mode, reinterpret_cast<GLvoid*>(_input._indirectBufferOffset), commandCount, (GLsizei)_input._indirectBufferStride);
+        _stats._DSNumDrawcalls += commandCount;
+    }
     _stats._DSNumAPIDrawcalls++;
 
 #else
@@ -165,11 +162,50 @@ void GL41Backend::do_multiDrawIndexedIndirect(const Batch& batch, size_t paramOf
     GLenum mode = gl::PRIMITIVE_TO_GL[(Primitive)batch._params[paramOffset + 1]._uint];
     GLenum indexType = gl::ELEMENT_TYPE_TO_GL[_input._indexBufferType];
   
-    glMultiDrawElementsIndirect(mode, indexType, reinterpret_cast<GLvoid*>(_input._indirectBufferOffset), commandCount, (GLsizei)_input._indirectBufferStride);
-    _stats._DSNumDrawcalls += commandCount;
+    if (isStereo()) {
+        GLvoid* indirectBufferOffset = bindStereoIndirectCommands(commandCount, sizeof(Batch::DrawIndexedIndirectCommand));
+        glMultiDrawElementsIndirect(mode, indexType, indirectBufferOffset, commandCount, (GLsizei)_input._indirectBufferStride);
+        restoreIndirectBuffer();
+        _stats._DSNumDrawcalls += 2 * commandCount;
+    } else {
+        glMultiDrawElementsIndirect(mode, indexType, reinterpret_cast<GLvoid*>(_input._indirectBufferOffset), commandCount, (GLsizei)_input._indirectBufferStride);
+        _stats._DSNumDrawcalls += commandCount;
+    }
     _stats._DSNumAPIDrawcalls++;
 #else
-    // FIXME implement the slow path
+    // The slow path reads the commands back and draws them one by one.
+    // GL 4.1 has no base instance, so in a named call the draw call infos are offset by hand instead
+    uint commandCount = batch._params[paramOffset + 0]._uint;
+    GLenum mode = gl::PRIMITIVE_TO_GL[(Primitive)batch._params[paramOffset + 1]._uint];
+    GLenum glType = gl::ELEMENT_TYPE_TO_GL[_input._indexBufferType];
+    auto typeByteSize = TYPE_SIZE[_input._indexBufferType];
+
+    size_t stride = _input._indirectBufferStride ? _input._indirectBufferStride : sizeof(Batch::DrawIndexedIndirectCommand);
+    std::vector<Byte> commands(commandCount * stride);
+    glGetBufferSubData(GL_DRAW_INDIRECT_BUFFER, _input._indirectBufferOffset, commands.size(), commands.data());
+
+    bool isNamedCall = !batch._currentNamedCall.empty();
+    uintptr_t drawCallInfoOffset = 0;
+    if (isNamedCall) {
+        drawCallInfoOffset = reinterpret_cast<uintptr_t>(_transform._drawCallInfoOffsets[batch._currentNamedCall]);
+        glBindBuffer(GL_ARRAY_BUFFER, _transform._drawCallInfoBuffer);
+    }
+
+    // In stereo each instance is drawn once per eye
+    GLsizei instanceScale = isStereo() ? 2 : 1;
+    for (uint i = 0; i < commandCount; i++) {
+        const auto& command = *reinterpret_cast<const Batch::DrawIndexedIndirectCommand*>(commands.data() + i * stride);
+        if (isNamedCall) {
+            GLvoid* commandDrawCallInfos = reinterpret_cast<GLvoid*>(drawCallInfoOffset + command._baseInstance * sizeof(Batch::DrawCallInfo));
+            glVertexAttribIPointer(gpu::Stream::DRAW_CALL_INFO, 2, GL_UNSIGNED_SHORT, 0, commandDrawCallInfos);
+        }
+        GLsizei numInstances = instanceScale * (GLsizei)command._instanceCount;
+        GLvoid* indexBufferByteOffset = reinterpret_cast<GLvoid*>(command._firstIndex * typeByteSize + _input._indexBufferOffset);
+        glDrawElementsInstancedBaseVertex(mode, command._count, glType, indexBufferByteOffset, numInstances, (GLint)command._baseVertex);
+        _stats._DSNumTriangles += (numInstances * command._count) / 3;
+        _stats._DSNumDrawcalls += numInstances;
+        _stats._DSNumAPIDrawcalls++;
+    }
 #endif
     (void)CHECK_GL_ERROR();
 }
@@ -35,16 +35,18 @@ namespace gpu {
                 Backend::setGPUObject(buffer, this);
             }
 
-            void transfer() override {
+            void transfer(ContextStats& stats) override {
                 glBindBuffer(GL_ARRAY_BUFFER, _buffer);
                 (void)CHECK_GL_ERROR();
                 Size offset;
                 Size size;
                 Size currentPage { 0 };
                 auto data = _gpuObject._renderSysmem.readData();
-                while (_gpuObject._renderPages.getNextTransferBlock(offset, size, currentPage)) {
+                while (_gpuObject._renderPages.getNextTransferBlock(offset, size, currentPage, MAX_TRANSFER_GAP_PAGES)) {
                     glBufferSubData(GL_ARRAY_BUFFER, offset, size, data + offset);
                     (void)CHECK_GL_ERROR();
+                    stats._RSNumBufferTransfers++;
+                    stats._RSAmountBufferTransferred += (int)size;
                 }
                 glBindBuffer(GL_ARRAY_BUFFER, 0);
                 (void)CHECK_GL_ERROR();
@@ -59,7 +59,8 @@ void GL41Texture::allocateStorage() const {
     (void)CHECK_GL_ERROR();
     glTexParameteri(_target, GL_TEXTURE_MAX_LEVEL, _maxMip - _minMip);
     (void)CHECK_GL_ERROR();
-    if (GLEW_VERSION_4_2 && !_gpuObject.getTexelFormat().isCompressed()) {
+    const auto& format = _gpuObject.getTexelFormat();
+    if (GLEW_VERSION_4_2 && (!format.isCompressed() || format.isBlockCompressed())) {
         // Get the dimensions, accounting for the downgrade level
         Vec3u dimensions = _gpuObject.evalMipDimensions(_minMip);
         glTexStorage2D(_target, usedMipLevels(), texelFormat.internalFormat, dimensions.x, dimensions.y);
@@ -69,7 +70,12 @@ void GL41Texture::allocateStorage() const {
             // Get the mip level dimensions, accounting for the downgrade level
             Vec3u dimensions = _gpuObject.evalMipDimensions(l);
             for (GLenum target : getFaceTargets(_target)) {
-                glTexImage2D(target, l - _minMip, texelFormat.internalFormat, dimensions.x, dimensions.y, 0, texelFormat.format, texelFormat.type, NULL);
+                if (format.isBlockCompressed()) {
+                    GLsizei faceSize = (GLsizei)Texture::evalFaceSize(format, dimensions.x, dimensions.y, 1);
+                    glCompressedTexImage2D(target, l - _minMip, texelFormat.internalFormat, dimensions.x, dimensions.y, 0, faceSize, NULL);
+                } else {
+                    glTexImage2D(target, l - _minMip, texelFormat.internalFormat, dimensions.x, dimensions.y, 0, texelFormat.format, texelFormat.type, NULL);
+                }
                 (void)CHECK_GL_ERROR();
             }
         }
@@ -118,7 +124,12 @@ void GL41Texture::transferMip(uint16_t mipLevel, uint8_t face) const {
     //GLenum target = getFaceTargets()[face];
     GLenum target = _target == GL_TEXTURE_2D ? GL_TEXTURE_2D : CUBE_FACE_LAYOUT[face];
     auto size = _gpuObject.evalMipDimensions(mipLevel);
-    glTexSubImage2D(target, mipLevel, 0, 0, size.x, size.y, texelFormat.format, texelFormat.type, mip->readData());
+    if (mip->getFormat().isBlockCompressed()) {
+        // The baked mips are uploaded as they are stored
+        glCompressedTexSubImage2D(target, mipLevel, 0, 0, size.x, size.y, texelFormat.internalFormat, (GLsizei)mip->getSize(), mip->readData());
+    } else {
+        glTexSubImage2D(target, mipLevel, 0, 0, size.x, size.y, texelFormat.format, texelFormat.type, mip->readData());
+    }
     (void)CHECK_GL_ERROR();
 }
 
@@ -25,10 +25,8 @@ void GL45Backend::do_draw(const Batch& batch, size_t paramOffset) {
     uint32 startVertex = batch._params[paramOffset + 0]._uint;
 
     if (isStereo()) {
-        setupStereoSide(0);
-        glDrawArrays(mode, startVertex, numVertices);
-        setupStereoSide(1);
-        glDrawArrays(mode, startVertex, numVertices);
+        // One instance per eye
+        glDrawArraysInstanced(mode, startVertex, numVertices, 2);
 
         _stats._DSNumTriangles += 2 * numVertices / 3;
         _stats._DSNumDrawcalls += 2;
@@ -55,10 +53,8 @@ void GL45Backend::do_drawIndexed(const Batch& batch, size_t paramOffset) {
     GLvoid* indexBufferByteOffset = reinterpret_cast<GLvoid*>(startIndex * typeByteSize + _input._indexBufferOffset);
 
     if (isStereo()) {
-        setupStereoSide(0);
-        glDrawElements(mode, numIndices, glType, indexBufferByteOffset);
-        setupStereoSide(1);
-        glDrawElements(mode, numIndices, glType, indexBufferByteOffset);
+        // One instance per eye
+        glDrawElementsInstanced(mode, numIndices, glType, indexBufferByteOffset, 2);
 
         _stats._DSNumTriangles += 2 * numIndices / 3;
         _stats._DSNumDrawcalls += 2;
@@ -83,10 +79,7 @@ void GL45Backend::do_drawInstanced(const Batch& batch, size_t paramOffset) {
     if (isStereo()) {
         GLint trueNumInstances = 2 * numInstances;
 
-        setupStereoSide(0);
-        glDrawArraysInstanced(mode, startVertex, numVertices, numInstances);
-        setupStereoSide(1);
-        glDrawArraysInstanced(mode, startVertex, numVertices, numInstances);
+        glDrawArraysInstanced(mode, startVertex, numVertices, trueNumInstances);
 
         _stats._DSNumTriangles += (trueNumInstances * numVertices) / 3;
         _stats._DSNumDrawcalls += trueNumInstances;
@@ -112,10 +105,7 @@ void GL45Backend::do_drawIndexedInstanced(const Batch& batch, size_t paramOffset
  
     if (isStereo()) {
         GLint trueNumInstances = 2 * numInstances;
-        setupStereoSide(0);
-        glDrawElementsInstancedBaseVertexBaseInstance(mode, numIndices, glType, indexBufferByteOffset, numInstances, 0, startInstance);
-        setupStereoSide(1);
-        glDrawElementsInstancedBaseVertexBaseInstance(mode, numIndices, glType, indexBufferByteOffset, numInstances, 0, startInstance);
+        glDrawElementsInstancedBaseVertexBaseInstance(mode, numIndices, glType, indexBufferByteOffset, trueNumInstances, 0, startInstance);
         _stats._DSNumTriangles += (trueNumInstances * numIndices) / 3;
         _stats._DSNumDrawcalls += trueNumInstances;
     } else {
@@ -132,8 +122,15 @@ void GL45Backend::do_drawIndexedInstanced(const Batch& batch, size_t paramOffset
 void GL45Backend::do_multiDrawIndirect(const Batch& batch, size_t paramOffset) {
     uint commandCount = batch._params[paramOffset + 0]._uint;
     GLenum mode = gl::PRIMITIVE_TO_GL[(Primitive)batch._params[paramOffset + 1]._uint];
-    glMultiDrawArraysIndirect(mode, reinterpret_cast<GLvoid*>(_input._indirectBufferOffset), commandCount, (GLsizei)_input._indirectBufferStride);
-    _stats._DSNumDrawcalls += commandCount;
+    if (isStereo()) {
+        GLvoid* indirectBufferOffset = bindStereoIndirectCommands(commandCount, sizeof(Batch::DrawIndirectCommand));
+        glMultiDrawArraysIndirect(mode, indirectBufferOffset, commandCount, (GLsizei)_input._indirectBufferStride);
+        restoreIndirectBuffer();
+        _stats._DSNumDrawcalls += 2 * commandCount;
+    } else {
+        glMultiDrawArraysIndirect(mode, reinterpret_cast<GLvoid*>(_input._indirectBufferOffset), commandCount, (GLsizei)_input._indirectBufferStride);
+        _stats._DSNumDrawcalls += commandCount;
+    }
     _stats._DSNumAPIDrawcalls++;
     (void)CHECK_GL_ERROR();
 }
@@ -142,13 +139,22 @@ void GL45Backend::do_multiDrawIndexedIndirect(const Batch& batch, size_t paramOf
     uint commandCount = batch._params[paramOffset + 0]._uint;
     GLenum mode = gl::PRIMITIVE_TO_GL[(Primitive)batch._params[paramOffset + 1]._uint];
     GLenum indexType = gl::ELEMENT_TYPE_TO_GL[_input._indexBufferType];
-    glMultiDrawElementsIndirect(mode, indexType, reinterpret_cast<GLvoid*>(_input._indirectBufferOffset), commandCount, (GLsizei)_input._indirectBufferStride);
-    _stats._DSNumDrawcalls += commandCount;
+    if (isStereo()) {
+        GLvoid* indirectBufferOffset = bindStereoIndirectCommands(commandCount, sizeof(Batch::DrawIndexedIndirectCommand));
+        glMultiDrawElementsIndirect(mode, indexType, indirectBufferOffset, commandCount, (GLsizei)_input._indirectBufferStride);
+        restoreIndirectBuffer();
+        _stats._DSNumDrawcalls += 2 * commandCount;
+    } else {
+        GLvoid* indirectBufferOffset = reinterpret_cast<GLvoid*>(_input._indirectBufferOffset);
+        glMultiDrawElementsIndirect(mode, indexType, indirectBufferOffset, commandCount, (GLsizei)_input._indirectBufferStride);
+        _stats._DSNumDrawcalls += commandCount;
+    }
     _stats._DSNumAPIDrawcalls++;
     (void)CHECK_GL_ERROR();
 }
 
 void GL45Backend::recycle() const {
     Parent::recycle();
+    updateTexturePriorities();
     derezTextures();
 }
@@ -88,25 +88,57 @@ public:
         bool continueTransfer() override;
         void finishTransfer() override;
         void incrementalTransfer(const uvec3& size, const gpu::Texture::PixelsPointer& mip, std::function<void(const ivec3& offset, const uvec3& size)> f) const;
-        void transferMip(uint16_t mipLevel, uint8_t face = 0) const;
+        void transferMip(uint16_t mipLevel, uint8_t face = 0);
         void allocateMip(uint16_t mipLevel, uint8_t face = 0) const;
         void allocateStorage() const override;
         void updateSize() const override;
         void syncSampler() const override;
         void generateMips() const override;
         void withPreservedTexture(std::function<void()> f) const override;
+        bool canDerez() const;
         void derez();
 
         SparseInfo _sparseInfo;
         uint32_t _allocatedPages { 0 };
         uint32_t _lastMipAllocatedPages { 0 };
         uint16_t _mipOffset { 0 };
+        // Number of mips uploaded by the transfer in progress, from the smallest one
+        uint16_t _transferredMips { 0 };
+        // Base level set for sampling the populated mips while they stream in
+        uint16_t _sampledMip { INVALID_MIP };
         friend class GL45Backend;
     };
 
 
+    // A buffer persistently and coherently mapped (ARB_buffer_storage), written as a ring of NUM_REGIONS regions.
+    // Leaving a region fences it, and a region is only written again once the GPU is past its fence, so streaming
+    // data into it never makes the driver sync the way glBufferData and glBufferSubData can
+    class GL45RingBuffer {
+    public:
+        static const int NUM_REGIONS = 3;
+
+        ~GL45RingBuffer();
+
+        // Reserves size bytes aligned on alignment, possibly in a new buffer, and returns their offset in the buffer
+        GLintptr reserve(GLsizeiptr size, GLsizeiptr alignment);
+        uint8_t* getMapped(GLintptr offset) const { return _mapped + offset; }
+        GLuint getBuffer() const { return _buffer; }
+
+    private:
+        void allocate(GLsizeiptr regionSize);
+        void nextRegion();
+
+        GLuint _buffer { 0 };
+        uint8_t* _mapped { nullptr };
+        GLsizeiptr _regionSize { 0 };
+        int _region { 0 };
+        GLsizeiptr _regionOffset { 0 };
+        std::array<GLsync, NUM_REGIONS> _fences {{ nullptr, nullptr, nullptr }};
+    };
+
 protected:
     void recycle() const override;
+    void updateTexturePriorities() const;
     void derezTextures() const;
 
     GLuint getFramebufferID(const FramebufferPointer& framebuffer) override;
@@ -138,6 +170,11 @@ protected:
     void updateTransform(const Batch& batch);
     void resetTransformStage();
 
+    mutable GL45RingBuffer _objectRing;
+    mutable GL45RingBuffer _cameraRing;
+    mutable GL45RingBuffer _drawCallInfoRing;
+    GLint _textureBufferAlignment { 1 };
+
     // Output stage
     void do_blit(const Batch& batch, size_t paramOffset) override;
 
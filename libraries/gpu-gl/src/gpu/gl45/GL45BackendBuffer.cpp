@@ -28,13 +28,15 @@ namespace gpu { namespace gl45 {
             Backend::setGPUObject(buffer, this);
         }
 
-        void transfer() override {
+        void transfer(ContextStats& stats) override {
             Size offset;
             Size size;
             Size currentPage { 0 };
             auto data = _gpuObject._renderSysmem.readData();
-            while (_gpuObject._renderPages.getNextTransferBlock(offset, size, currentPage)) {
+            while (_gpuObject._renderPages.getNextTransferBlock(offset, size, currentPage, MAX_TRANSFER_GAP_PAGES)) {
                 glNamedBufferSubData(_buffer, (GLintptr)offset, (GLsizeiptr)size, data + offset);
+                stats._RSNumBufferTransfers++;
+                stats._RSAmountBufferTransferred += (int)size;
             }
             (void)CHECK_GL_ERROR();
             _gpuObject._renderPages._flags &= ~PageManager::DIRTY;
@@ -17,14 +17,18 @@ namespace gpu { namespace gl45 {
 class GL45Query : public gpu::gl::GLQuery {
     using Parent = gpu::gl::GLQuery;
 public:
-    static GLuint allocateQuery() {
+    static GLuint allocateQuery(GLenum target) {
         GLuint result;
-        glCreateQueries(GL_TIMESTAMP, 1, &result);
+        glCreateQueries(target, 1, &result);
         return result;
     }
 
+    static GLenum getTarget(const Query& query) {
+        return (query.getType() == Query::ANY_SAMPLES_PASSED) ? GL_ANY_SAMPLES_PASSED : GL_TIMESTAMP;
+    }
+
     GL45Query(const std::weak_ptr<gl::GLBackend>& backend, const Query& query)
-        : Parent(backend, query, allocateQuery(), allocateQuery()) {
+        : Parent(backend, query, allocateQuery(getTarget(query)), allocateQuery(getTarget(query))) {
     }
 };
 
@@ -19,6 +19,9 @@
 #include <QtCore/QDebug>
 #include <QtCore/QThread>
 
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
 #include "../gl/GLTexelFormat.h"
 
 using namespace gpu;
@@ -28,11 +31,25 @@ using namespace gpu::gl45;
 // Allocate 1 MB of buffer space for paged transfers
 #define DEFAULT_PAGE_BUFFER_SIZE (1024*1024)
 #define DEFAULT_GL_PIXEL_ALIGNMENT 4
+// Upload at least 1 MB of mips per step of a progressive transfer before publishing them
+#define PROGRESSIVE_TRANSFER_SIZE (1024*1024)
+// Fold the visible sizes reported by the renderer into the texture priorities 10 times per second,
+// a texture that isn't seen anymore loses half its priority each time
+#define TEXTURE_PRIORITY_UPDATE_PERIOD (USECS_PER_SECOND / 10)
+#define TEXTURE_PRIORITY_DECAY 0.5f
+// A texture bound by a batch since the last update keeps at least this priority, so the textures in use that no item
+// reports a visible size for (skyboxes, particles, overlays...) lose their mips after the ones that aren't used at all
+#define TEXTURE_BOUND_PRIORITY 0.001f
+// Start derezzing when the texture memory gets within 10% of the allowed amount, to keep room for the transfers
+#define TEXTURE_MEMORY_PRESSURE_TARGET 0.9f
+// Derez at most that many mips per frame, so that getting back under the budget doesn't stall a frame
+#define MAX_DEREZ_PER_FRAME 8
 
 using GL45Texture = GL45Backend::GL45Texture;
 
-static std::map<uint16_t, std::unordered_set<GL45Texture*>> texturesByMipCounts;
-static Mutex texturesByMipCountsMutex;
+// Every transferrable texture, for updating their priorities and picking the ones to derez
+static std::unordered_set<GL45Texture*> transferrableTextures;
+static Mutex transferrableTexturesMutex;
 using TextureTypeFormat = std::pair<GLenum, GLenum>;
 std::map<TextureTypeFormat, std::vector<uvec3>> sparsePageDimensionsByFormat;
 Mutex sparsePageDimensionsByFormatMutex;
@@ -282,6 +299,11 @@ GL45Texture::GL45Texture(const std::weak_ptr<GLBackend>& backend, const Texture&
             Backend::incrementTextureGPUSparseCount();
         }
     }
+
+    if (_transferrable) {
+        Lock lock(transferrableTexturesMutex);
+        transferrableTextures.insert(this);
+    }
 }
 
 GL45Texture::~GL45Texture() {
@@ -292,15 +314,8 @@ GL45Texture::~GL45Texture() {
 
     // Remove this texture from the candidate list of derezzable textures
     if (_transferrable) {
-        auto mipLevels = usedMipLevels();
-        Lock lock(texturesByMipCountsMutex);
-        if (texturesByMipCounts.count(mipLevels)) {
-            auto& textures = texturesByMipCounts[mipLevels];
-            textures.erase(this);
-            if (textures.empty()) {
-                texturesByMipCounts.erase(mipLevels);
-            }
-        }
+        Lock lock(transferrableTexturesMutex);
+        transferrableTextures.erase(this);
     }
 
     if (_sparseInfo.sparse) {
@@ -358,7 +373,8 @@ void GL45Texture::generateMips() const {
 }
 
 void GL45Texture::allocateStorage() const {
-    if (_gpuObject.getTexelFormat().isCompressed()) {
+    // Only the block compressed formats have their mips stored compressed
+    if (_gpuObject.getTexelFormat().isCompressed() && !_gpuObject.getTexelFormat().isBlockCompressed()) {
         qFatal("Compressed textures not yet supported");
     }
     glTextureParameteri(_id, GL_TEXTURE_BASE_LEVEL, 0);
@@ -370,7 +386,8 @@ void GL45Texture::allocateStorage() const {
 }
 
 void GL45Texture::updateSize() const {
-    if (_gpuObject.getTexelFormat().isCompressed()) {
+    // Only the block compressed formats have their mips stored compressed
+    if (_gpuObject.getTexelFormat().isCompressed() && !_gpuObject.getTexelFormat().isBlockCompressed()) {
         qFatal("Compressed textures not yet supported");
     }
 
@@ -386,39 +403,80 @@ void GL45Texture::updateSize() const {
 void GL45Texture::startTransfer() {
     Parent::startTransfer();
     _sparseInfo.update();
+    _transferredMips = 0;
 #if INCREMENTAL_TRANSFER
     _transferState.updateMip();
 #endif
 }
 
+void GL45Texture::transferMip(uint16_t mipLevel, uint8_t face) {
+    auto size = _gpuObject.evalMipDimensions(mipLevel);
+    if (_sparseInfo.sparse && mipLevel <= _sparseInfo.maxSparseLevel) {
+        glTexturePageCommitmentEXT(_id, mipLevel, 0, 0, face, size.x, size.y, 1, GL_TRUE);
+        _allocatedPages += _sparseInfo.getPageCount(size);
+    }
+    if (!_gpuObject.isStoredMipFaceAvailable(mipLevel, face)) {
+        return;
+    }
+
+    auto mip = _gpuObject.accessStoredMipFace(mipLevel, face);
+    if (mip->getFormat().isBlockCompressed()) {
+        // The baked mips are uploaded as they are stored
+        GLsizei mipSize = (GLsizei)mip->getSize();
+        if (GL_TEXTURE_2D == _target) {
+            glCompressedTextureSubImage2D(_id, mipLevel, 0, 0, size.x, size.y, _internalFormat, mipSize, mip->readData());
+        } else if (GL_TEXTURE_CUBE_MAP == _target) {
+            auto target = CUBE_FACE_LAYOUT[face];
+            glCompressedTextureSubImage2DEXT(_id, target, mipLevel, 0, 0, size.x, size.y, _internalFormat, mipSize, mip->readData());
+        } else {
+            Q_ASSERT(false);
+        }
+        (void)CHECK_GL_ERROR();
+        return;
+    }
+
+    GLTexelFormat texelFormat = GLTexelFormat::evalGLTexelFormat(_gpuObject.getTexelFormat(), mip->getFormat());
+    if (GL_TEXTURE_2D == _target) {
+        glTextureSubImage2D(_id, mipLevel, 0, 0, size.x, size.y, texelFormat.format, texelFormat.type, mip->readData());
+    } else if (GL_TEXTURE_CUBE_MAP == _target) {
+        // DSA ARB does not work on AMD, so use EXT
+        // glTextureSubImage3D(_id, mipLevel, 0, 0, face, size.x, size.y, 1, texelFormat.format, texelFormat.type, mip->readData());
+        auto target = CUBE_FACE_LAYOUT[face];
+        glTextureSubImage2DEXT(_id, target, mipLevel, 0, 0, size.x, size.y, texelFormat.format, texelFormat.type, mip->readData());
+    } else {
+        Q_ASSERT(false);
+    }
+    (void)CHECK_GL_ERROR();
+}
+
 bool GL45Texture::continueTransfer() {
 #if !INCREMENTAL_TRANSFER
+    // The mips go from the smallest to the largest. When they are all stored, they go a step at a time and each step
+    // is published for rendering, so the texture shows up blurry right away and sharpens while the next ones stream
+    bool progressive = !_gpuObject.isAutogenerateMips();
     size_t maxFace = GL_TEXTURE_CUBE_MAP == _target ? CUBE_NUM_FACES : 1;
-    for (uint8_t face = 0; face < maxFace; ++face) {
-        for (uint16_t mipLevel = _minMip; mipLevel <= _maxMip; ++mipLevel) {
-            auto size = _gpuObject.evalMipDimensions(mipLevel);
-            if (_sparseInfo.sparse && mipLevel <= _sparseInfo.maxSparseLevel) {
-                glTexturePageCommitmentEXT(_id, mipLevel, 0, 0, face, size.x, size.y, 1, GL_TRUE);
-                _allocatedPages += _sparseInfo.getPageCount(size);
-            }
-            if (_gpuObject.isStoredMipFaceAvailable(mipLevel, face)) {
-                auto mip = _gpuObject.accessStoredMipFace(mipLevel, face);
-                GLTexelFormat texelFormat = GLTexelFormat::evalGLTexelFormat(_gpuObject.getTexelFormat(), mip->getFormat());
-                if (GL_TEXTURE_2D == _target) {
-                    glTextureSubImage2D(_id, mipLevel, 0, 0, size.x, size.y, texelFormat.format, texelFormat.type, mip->readData());
-                } else if (GL_TEXTURE_CUBE_MAP == _target) {
-                    // DSA ARB does not work on AMD, so use EXT
-                    // glTextureSubImage3D(_id, mipLevel, 0, 0, face, size.x, size.y, 1, texelFormat.format, texelFormat.type, mip->readData());
-                    auto target = CUBE_FACE_LAYOUT[face];
-                    glTextureSubImage2DEXT(_id, target, mipLevel, 0, 0, size.x, size.y, texelFormat.format, texelFormat.type, mip->readData());
-                } else {
-                    Q_ASSERT(false);
-                }
-                (void)CHECK_GL_ERROR();
-            }
+    uint16_t mipLevels = usedMipLevels();
+    Size transferredSize = 0;
+    while (_transferredMips < mipLevels) {
+        uint16_t mipLevel = _maxMip - _transferredMips;
+        for (uint8_t face = 0; face < maxFace; ++face) {
+            transferMip(mipLevel, face);
+        }
+        ++_transferredMips;
+        transferredSize += _gpuObject.evalMipSize(mipLevel);
+        if (progressive && transferredSize >= PROGRESSIVE_TRANSFER_SIZE) {
+            break;
         }
     }
-    return false;
+
+    if (progressive) {
+#ifdef THREADED_TEXTURE_TRANSFER
+        // The render thread samples the mips as soon as they are published
+        clientWait();
+#endif
+        _populatedMip = (uint16_t)(_maxMip + 1 - _transferredMips);
+    }
+    return _transferredMips < mipLevels;
 #else
     static std::vector<uint8_t> buffer;
     if (buffer.empty()) {
@@ -505,10 +563,10 @@ void GL45Texture::syncSampler() const {
 
 void GL45Texture::postTransfer() {
     Parent::postTransfer();
-    auto mipLevels = usedMipLevels();
-    if (_transferrable && mipLevels > 1 && _minMip < _sparseInfo.maxSparseLevel) {
-        Lock lock(texturesByMipCountsMutex);
-        texturesByMipCounts[mipLevels].insert(this);
+    // Every mip is in, go back to the base level of the sampler
+    if (INVALID_MIP != _sampledMip) {
+        _sampledMip = INVALID_MIP;
+        syncSampler();
     }
 }
 
@@ -523,19 +581,9 @@ void GL45Texture::stripToMip(uint16_t newMinMip) {
         return;
     }
 
-    auto mipLevels = usedMipLevels();
-    {
-        Lock lock(texturesByMipCountsMutex);
-        assert(0 != texturesByMipCounts.count(mipLevels));
-        assert(0 != texturesByMipCounts[mipLevels].count(this));
-        texturesByMipCounts[mipLevels].erase(this);
-        if (texturesByMipCounts[mipLevels].empty()) {
-            texturesByMipCounts.erase(mipLevels);
-        }
-    }
-
     // If we weren't generating mips before, we need to now that we're stripping down mip levels.
-    if (!_gpuObject.isAutogenerateMips()) {
+    // The block compressed mips can't be generated, but they all come baked
+    if (!_gpuObject.isAutogenerateMips() && !_gpuObject.getTexelFormat().isBlockCompressed()) {
         qCDebug(gpugl45logging) << "Force mip generation for texture";
         glGenerateTextureMipmap(_id);
     }
@@ -570,39 +618,35 @@ void GL45Texture::stripToMip(uint16_t newMinMip) {
         Vec3u newDimensions = _gpuObject.evalMipDimensions(_mipOffset);
         glTextureStorage2D(_id, newLevels, _internalFormat, newDimensions.x, newDimensions.y);
 
-        // Copy the contents of the old texture to the new
-        GLuint fbo { 0 };
-        glCreateFramebuffers(1, &fbo);
-        glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+        // Copy the contents of the old texture to the new, the faces of a cube map are its layers.
+        // Unlike a framebuffer copy, this also works with the block compressed formats
+        GLsizei faceCount = (GLsizei)getFaceTargets(_target).size();
         for (uint16 targetMip = _minMip; targetMip <= _maxMip; ++targetMip) {
             uint16 sourceMip = targetMip + mipDelta;
             Vec3u mipDimensions = _gpuObject.evalMipDimensions(targetMip + _mipOffset);
-            for (GLenum target : getFaceTargets(_target)) {
-                glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, target, oldId, sourceMip);
-                (void)CHECK_GL_ERROR();
-                glCopyTextureSubImage2D(_id, targetMip, 0, 0, 0, 0, mipDimensions.x, mipDimensions.y);
-                (void)CHECK_GL_ERROR();
-            }
+            glCopyImageSubData(oldId, _target, sourceMip, 0, 0, 0, _id, _target, targetMip, 0, 0, 0,
+                mipDimensions.x, mipDimensions.y, faceCount);
+            (void)CHECK_GL_ERROR();
         }
-        glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
-        glDeleteFramebuffers(1, &fbo);
         glDeleteTextures(1, &oldId);
     }
 
     // Re-sync the sampler to force access to the new mip level
     syncSampler();
     updateSize();
-
-
-    // Re-insert into the texture-by-mips map if appropriate
-    mipLevels = usedMipLevels();
-    if (mipLevels > 1 && (!_sparseInfo.sparse || _minMip < _sparseInfo.maxSparseLevel)) {
-        Lock lock(texturesByMipCountsMutex);
-        texturesByMipCounts[mipLevels].insert(this);
-    }
 }
 
 void GL45Texture::updateMips() {
+    if (isPopulated()) {
+        // Render from the mips the transfer in progress has uploaded so far
+        uint16_t populatedMip = _populatedMip;
+        if (populatedMip != _sampledMip) {
+            _sampledMip = populatedMip;
+            glTextureParameteri(_id, GL_TEXTURE_BASE_LEVEL, populatedMip - _mipOffset);
+        }
+        return;
+    }
+
     if (!_sparseInfo.sparse) {
         return;
     }
@@ -612,6 +656,13 @@ void GL45Texture::updateMips() {
     }
 }
 
+bool GL45Texture::canDerez() const {
+    if (!_transferCount || GLSyncState::Idle != _syncState || usedMipLevels() <= 1) {
+        return false;
+    }
+    return !_sparseInfo.sparse || _minMip < _sparseInfo.maxSparseLevel;
+}
+
 void GL45Texture::derez() {
     if (_sparseInfo.sparse) {
         assert(_minMip < _sparseInfo.maxSparseLevel);
@@ -621,33 +672,59 @@ void GL45Texture::derez() {
     stripToMip(_minMip + 1);
 }
 
-void GL45Backend::derezTextures() const {
-    if (GLTexture::getMemoryPressure() < 1.0f) {
+void GL45Backend::updateTexturePriorities() const {
+    static auto lastUpdate = usecTimestampNow();
+    auto now = usecTimestampNow();
+    if (now - lastUpdate < TEXTURE_PRIORITY_UPDATE_PERIOD) {
         return;
     }
+    lastUpdate = now;
 
-    Lock lock(texturesByMipCountsMutex);
-    if (texturesByMipCounts.empty()) {
-        qCDebug(gpugl45logging) << "No available textures to derez";
-        return;
+    Lock lock(transferrableTexturesMutex);
+    for (auto texture : transferrableTextures) {
+        float visibleSize = texture->_gpuObject.takeVisibleSize();
+        if (texture->_boundSincePriorityUpdate) {
+            texture->_boundSincePriorityUpdate = false;
+            visibleSize = std::max(visibleSize, TEXTURE_BOUND_PRIORITY);
+        }
+        texture->_priority = std::max(visibleSize, texture->_priority * TEXTURE_PRIORITY_DECAY);
     }
+}
 
-    auto mipLevel = texturesByMipCounts.rbegin()->first;
-    if (mipLevel <= 1) {
-        qCDebug(gpugl45logging) << "Max mip levels " << mipLevel;
+void GL45Backend::derezTextures() const {
+    if (GLTexture::getMemoryPressure() < TEXTURE_MEMORY_PRESSURE_TARGET) {
         return;
     }
 
     qCDebug(gpugl45logging) << "Allowed texture memory " << Texture::getAllowedGPUMemoryUsage();
     qCDebug(gpugl45logging) << "Used texture memory " << (Context::getTextureGPUMemoryUsage() - Context::getTextureGPUFramebufferMemoryUsage());
 
-    GL45Texture* targetTexture = nullptr;
-    {
-        auto& textures = texturesByMipCounts[mipLevel];
-        assert(!textures.empty());
-        targetTexture = *textures.begin();
+    // The least visible texture gives up its largest mip first, so the far away textures lose their details
+    // before the close ones. Between equally visible textures, the one with the most mips goes first
+    int derezCount = 0;
+    while (derezCount < MAX_DEREZ_PER_FRAME && GLTexture::getMemoryPressure() >= TEXTURE_MEMORY_PRESSURE_TARGET) {
+        GL45Texture* targetTexture = nullptr;
+        {
+            Lock lock(transferrableTexturesMutex);
+            for (auto texture : transferrableTextures) {
+                if (!texture->canDerez()) {
+                    continue;
+                }
+                if (!targetTexture || texture->_priority < targetTexture->_priority ||
+                    (texture->_priority == targetTexture->_priority && texture->usedMipLevels() > targetTexture->usedMipLevels())) {
+                    targetTexture = texture;
+                }
+            }
+        }
+
+        if (!targetTexture) {
+            qCDebug(gpugl45logging) << "No available textures to derez";
+            break;
+        }
+
+        targetTexture->derez();
+        ++derezCount;
     }
-    lock.unlock();
-    targetTexture->derez();
+
     qCDebug(gpugl45logging) << "New Used texture memory " << (Context::getTextureGPUMemoryUsage() - Context::getTextureGPUFramebufferMemoryUsage());
 }
@@ -13,13 +13,77 @@
 using namespace gpu;
 using namespace gpu::gl45;
 
+// the regions start on this boundary, above the alignment of the uniform and texture buffer offsets
+static const GLsizeiptr REGION_ALIGNMENT = 4096;
+static const GLsizeiptr MIN_REGION_SIZE = 256 * 1024;
+static const GLuint64 FENCE_WAIT_NSECS = 1000000;
+
+GL45Backend::GL45RingBuffer::~GL45RingBuffer() {
+    // The last buffer is deleted with the other transform buffers in killTransform
+    for (auto& fence : _fences) {
+        if (fence) {
+            glDeleteSync(fence);
+        }
+    }
+}
+
+void GL45Backend::GL45RingBuffer::allocate(GLsizeiptr regionSize) {
+    // The previous buffer is deleted at once, GL keeps it until the commands using it are done
+    if (_buffer) {
+        glUnmapNamedBuffer(_buffer);
+        glDeleteBuffers(1, &_buffer);
+    }
+    for (auto& fence : _fences) {
+        if (fence) {
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+
+    _regionSize = ((regionSize + REGION_ALIGNMENT - 1) / REGION_ALIGNMENT) * REGION_ALIGNMENT;
+    GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glCreateBuffers(1, &_buffer);
+    glNamedBufferStorage(_buffer, _regionSize * NUM_REGIONS, nullptr, flags);
+    _mapped = static_cast<uint8_t*>(glMapNamedBufferRange(_buffer, 0, _regionSize * NUM_REGIONS, flags));
+    _region = 0;
+    _regionOffset = 0;
+    (void)CHECK_GL_ERROR();
+}
+
+void GL45Backend::GL45RingBuffer::nextRegion() {
+    _fences[_region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    _region = (_region + 1) % NUM_REGIONS;
+    _regionOffset = 0;
+
+    auto& fence = _fences[_region];
+    if (fence) {
+        // Only waits if the GPU is still using the region the ring left NUM_REGIONS - 1 regions ago
+        GLenum result;
+        do {
+            result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, FENCE_WAIT_NSECS);
+        } while (result == GL_TIMEOUT_EXPIRED);
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+}
+
+GLintptr GL45Backend::GL45RingBuffer::reserve(GLsizeiptr size, GLsizeiptr alignment) {
+    if (size + alignment > _regionSize) {
+        allocate(std::max(std::max(size + alignment, 2 * _regionSize), MIN_REGION_SIZE));
+    }
+
+    GLsizeiptr offset = ((_regionOffset + alignment - 1) / alignment) * alignment;
+    if (offset + size > _regionSize) {
+        nextRegion();
+        offset = 0;
+    }
+    _regionOffset = offset + size;
+    return _region * _regionSize + offset;
+}
+
 void GL45Backend::initTransform() {
-    GLuint transformBuffers[3];
-    glCreateBuffers(3, transformBuffers);
-    _transform._objectBuffer = transformBuffers[0];
-    _transform._cameraBuffer = transformBuffers[1];
-    _transform._drawCallInfoBuffer = transformBuffers[2];
     glCreateTextures(GL_TEXTURE_BUFFER, 1, &_transform._objectBufferTexture);
+    glGetIntegerv(GL_TEXTURE_BUFFER_OFFSET_ALIGNMENT, &_textureBufferAlignment);
     size_t cameraSize = sizeof(TransformStageState::CameraBufferElement);
     while (_transform._cameraUboSize < cameraSize) {
         _transform._cameraUboSize += _uboAlignment;
@@ -27,38 +91,49 @@ void GL45Backend::initTransform() {
 }
 
 void GL45Backend::transferTransformState(const Batch& batch) const {
-    // FIXME not thread safe
-    static std::vector<uint8_t> bufferData;
+    // The transforms of the batch are written straight into the persistently mapped rings
     if (!_transform._cameras.empty()) {
-        bufferData.resize(_transform._cameraUboSize * _transform._cameras.size());
+        GLsizeiptr size = _transform._cameraUboSize * _transform._cameras.size();
+        GLintptr offset = _cameraRing.reserve(size, _uboAlignment);
+        uint8_t* cameraData = _cameraRing.getMapped(offset);
         for (size_t i = 0; i < _transform._cameras.size(); ++i) {
-            memcpy(bufferData.data() + (_transform._cameraUboSize * i), &_transform._cameras[i], sizeof(TransformStageState::CameraBufferElement));
+            memcpy(cameraData + (_transform._cameraUboSize * i), &_transform._cameras[i], sizeof(TransformStageState::CameraBufferElement));
         }
-        glNamedBufferData(_transform._cameraBuffer, bufferData.size(), bufferData.data(), GL_STREAM_DRAW);
+        _transform._cameraBuffer = _cameraRing.getBuffer();
+        _transform._cameraBufferOffset = offset;
     }
 
     if (!batch._objects.empty()) {
-        glNamedBufferData(_transform._objectBuffer, batch._objects.size() * sizeof(Batch::TransformObject), batch._objects.data(), GL_STREAM_DRAW);
+        GLsizeiptr size = batch._objects.size() * sizeof(Batch::TransformObject);
+        GLintptr offset = _objectRing.reserve(size, _textureBufferAlignment);
+        memcpy(_objectRing.getMapped(offset), batch._objects.data(), size);
+        _transform._objectBuffer = _objectRing.getBuffer();
+
+#ifdef GPU_SSBO_DRAW_CALL_INFO
+        glBindBufferRange(GL_SHADER_STORAGE_BUFFER, TRANSFORM_OBJECT_SLOT, _transform._objectBuffer, offset, size);
+#else
+        glTextureBufferRange(_transform._objectBufferTexture, GL_RGBA32F, _transform._objectBuffer, offset, size);
+#endif
     }
 
     if (!batch._namedData.empty()) {
-        bufferData.clear();
+        GLsizeiptr size = 0;
+        for (auto& data : batch._namedData) {
+            size += data.second.drawCallInfos.size() * sizeof(Batch::DrawCallInfo);
+        }
+        GLintptr offset = _drawCallInfoRing.reserve(std::max(size, (GLsizeiptr)sizeof(Batch::DrawCallInfo)), sizeof(Batch::DrawCallInfo));
         for (auto& data : batch._namedData) {
-            auto currentSize = bufferData.size();
             auto bytesToCopy = data.second.drawCallInfos.size() * sizeof(Batch::DrawCallInfo);
-            bufferData.resize(currentSize + bytesToCopy);
-            memcpy(bufferData.data() + currentSize, data.second.drawCallInfos.data(), bytesToCopy);
-            _transform._drawCallInfoOffsets[data.first] = (GLvoid*)currentSize;
+            memcpy(_drawCallInfoRing.getMapped(offset), data.second.drawCallInfos.data(), bytesToCopy);
+            _transform._drawCallInfoOffsets[data.first] = (GLvoid*)offset;
+            offset += bytesToCopy;
         }
-        glNamedBufferData(_transform._drawCallInfoBuffer, bufferData.size(), bufferData.data(), GL_STREAM_DRAW);
+        _transform._drawCallInfoBuffer = _drawCallInfoRing.getBuffer();
     }
 
-#ifdef GPU_SSBO_DRAW_CALL_INFO
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, TRANSFORM_OBJECT_SLOT, _transform._objectBuffer);
-#else
+#ifndef GPU_SSBO_DRAW_CALL_INFO
     glActiveTexture(GL_TEXTURE0 + TRANSFORM_OBJECT_SLOT);
     glBindTexture(GL_TEXTURE_BUFFER, _transform._objectBufferTexture);
-    glTextureBuffer(_transform._objectBufferTexture, GL_RGBA32F, _transform._objectBuffer);
 #endif
 
     CHECK_GL_ERROR();
@@ -388,9 +388,11 @@ public:
                 return offset;
             }
 
-            Data get(uint32 offset) const {
+            // Returned by reference so the backend can replay the commands without copying the pointers
+            const Data& get(uint32 offset) const {
                 if (offset >= _items.size()) {
-                    return Data();
+                    static const Data EMPTY_DATA {};
+                    return EMPTY_DATA;
                 }
                 return (_items.data() + offset)->_data;
             }
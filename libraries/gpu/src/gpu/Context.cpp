@@ -9,6 +9,9 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 #include "Context.h"
+
+#include <QtGui/QImage>
+
 #include "Frame.h"
 #include "GPULogging.h"
 using namespace gpu;
@@ -135,6 +138,11 @@ void Context::downloadFramebuffer(const FramebufferPointer& srcFramebuffer, cons
     _backend->downloadFramebuffer(srcFramebuffer, region, destImage);
 }
 
+void Context::downloadFramebufferAsync(const FramebufferPointer& srcFramebuffer, const Vec4i& region,
+                                       const Backend::FramebufferDownloadHandler& handler) {
+    _backend->downloadFramebufferAsync(srcFramebuffer, region, handler);
+}
+
 void Context::getStats(ContextStats& stats) const {
     _backend->getStats(stats);
 }
@@ -364,6 +372,13 @@ uint32_t Context::getTextureGPUTransferCount() {
     return _textureGPUTransferCount.load();
 }
 
+void Backend::downloadFramebufferAsync(const FramebufferPointer& srcFramebuffer, const Vec4i& region,
+                                       const FramebufferDownloadHandler& handler) {
+    QImage image(region.z, region.w, QImage::Format_ARGB32);
+    downloadFramebuffer(srcFramebuffer, region, image);
+    handler(image.mirrored(false, true));
+}
+
 void Backend::setFreeGPUMemory(Size size) { Context::setFreeGPUMemory(size); }
 Resource::Size Backend::getFreeGPUMemory() { return Context::getFreeGPUMemory(); }
 void Backend::incrementBufferGPUCount() { Context::incrementBufferGPUCount(); }
@@ -12,6 +12,7 @@
 #define hifi_gpu_Context_h
 
 #include <assert.h>
+#include <functional>
 #include <mutex>
 
 #include <GLMHelpers.h>
@@ -36,6 +37,9 @@ public:
 
     int _RSNumTextureBounded = 0;
     int _RSAmountTextureMemoryBounded = 0;
+    int _RSNumUniformBufferBounded = 0;
+    int _RSNumBufferTransfers = 0;
+    int _RSAmountBufferTransferred = 0;
 
     int _DSNumAPIDrawcalls = 0;
     int _DSNumDrawcalls = 0;
@@ -58,6 +62,12 @@ public:
     virtual void recycle() const = 0;
     virtual void downloadFramebuffer(const FramebufferPointer& srcFramebuffer, const Vec4i& region, QImage& destImage) = 0;
 
+    // Called with the downloaded region, top row first, or with a null image if it couldn't be read
+    using FramebufferDownloadHandler = std::function<void(QImage)>;
+    // Backends that can't download without waiting download synchronously and call the handler right away
+    virtual void downloadFramebufferAsync(const FramebufferPointer& srcFramebuffer, const Vec4i& region,
+                                          const FramebufferDownloadHandler& handler);
+
     // UBO class... layout MUST match the layout in Transform.slh
     class TransformCamera {
     public:
@@ -200,6 +210,13 @@ public:
     // It s here for convenience to easily capture a snapshot
     void downloadFramebuffer(const FramebufferPointer& srcFramebuffer, const Vec4i& region, QImage& destImage);
 
+    // MUST only be called on the rendering thread
+    //
+    // Starts the download of the Framebuffer without waiting for the GPU, the handler is called on the rendering
+    // thread from recycle() once the pixels reached the system memory, usually a frame or two later
+    void downloadFramebufferAsync(const FramebufferPointer& srcFramebuffer, const Vec4i& region,
+                                  const Backend::FramebufferDownloadHandler& handler);
+
      // Repporting stats of the context
     void getStats(ContextStats& stats) const;
 
@@ -20,4 +20,10 @@ const Element Element::VEC3F_XYZ{ VEC3, FLOAT, XYZ };
 const Element Element::VEC4F_XYZW{ VEC4, FLOAT, XYZW };
 const Element Element::INDEX_UINT16{ SCALAR, UINT16, INDEX };
 const Element Element::PART_DRAWCALL{ VEC4, UINT32, PART };
+const Element Element::COLOR_COMPRESSED_BC1_SRGB{ VEC3, NUINT8, COMPRESSED_BC1_SRGB };
+const Element Element::COLOR_COMPRESSED_BC1_SRGBA{ VEC4, NUINT8, COMPRESSED_BC1_SRGBA };
+const Element Element::COLOR_COMPRESSED_BC3_SRGBA{ VEC4, NUINT8, COMPRESSED_BC3_SRGBA };
+const Element Element::COLOR_COMPRESSED_BC4_RED{ SCALAR, NUINT8, COMPRESSED_BC4_RED };
+const Element Element::VEC2_COMPRESSED_BC5_XY{ VEC2, NUINT8, COMPRESSED_BC5_XY };
+const Element Element::COLOR_COMPRESSED_BC7_SRGBA{ VEC4, NUINT8, COMPRESSED_BC7_SRGBA };
 
@@ -163,12 +163,15 @@ enum Semantic {
     COMPRESSED_SRGB,
     COMPRESSED_SRGBA,
 
-    // FIXME: Will have to be supported later:
-    /*COMPRESSED_BC3_RGBA,  // RGBA_S3TC_DXT5_EXT,
+    // Block compressed formats, the stored mips are already compressed and uploaded as is
+    _FIRST_BLOCK_COMPRESSED,
+    COMPRESSED_BC1_SRGB = _FIRST_BLOCK_COMPRESSED, // SRGB_S3TC_DXT1_EXT
+    COMPRESSED_BC1_SRGBA, // SRGB_ALPHA_S3TC_DXT1_EXT
     COMPRESSED_BC3_SRGBA, // SRGB_ALPHA_S3TC_DXT5_EXT
-
-    COMPRESSED_BC7_RGBA,
-    COMPRESSED_BC7_SRGBA, */
+    COMPRESSED_BC4_RED, // RED_RGTC1
+    COMPRESSED_BC5_XY, // RG_RGTC2
+    COMPRESSED_BC7_SRGBA, // SRGB_ALPHA_BPTC_UNORM
+    _LAST_BLOCK_COMPRESSED = COMPRESSED_BC7_SRGBA,
 
     _LAST_COMPRESSED,
 
@@ -205,6 +208,24 @@ public:
     Dimension getDimension() const { return (Dimension)_dimension; }
     
     bool isCompressed() const { return uint8(getSemantic() - _FIRST_COMPRESSED) <= uint8(_LAST_COMPRESSED - _FIRST_COMPRESSED); }
+    bool isBlockCompressed() const { return uint8(getSemantic() - _FIRST_BLOCK_COMPRESSED) <= uint8(_LAST_BLOCK_COMPRESSED - _FIRST_BLOCK_COMPRESSED); }
+
+    // Block compressed formats store 4x4 texels in 8 or 16 bytes, 0 for the others
+    static const uint32 COMPRESSED_BLOCK_DIM = 4;
+    uint32 getCompressedBlockSize() const {
+        switch (getSemantic()) {
+            case COMPRESSED_BC1_SRGB:
+            case COMPRESSED_BC1_SRGBA:
+            case COMPRESSED_BC4_RED:
+                return 8;
+            case COMPRESSED_BC3_SRGBA:
+            case COMPRESSED_BC5_XY:
+            case COMPRESSED_BC7_SRGBA:
+                return 16;
+            default:
+                return 0;
+        }
+    }
 
     Type getType() const { return (Type)_type; }
     bool isNormalized() const { return (getType() >= NORMALIZED_START); }
@@ -237,6 +258,12 @@ public:
     static const Element VEC4F_XYZW;
     static const Element INDEX_UINT16;
     static const Element PART_DRAWCALL;
+    static const Element COLOR_COMPRESSED_BC1_SRGB;
+    static const Element COLOR_COMPRESSED_BC1_SRGBA;
+    static const Element COLOR_COMPRESSED_BC3_SRGBA;
+    static const Element COLOR_COMPRESSED_BC4_RED;
+    static const Element VEC2_COMPRESSED_BC5_XY;
+    static const Element COLOR_COMPRESSED_BC7_SRGBA;
     
  protected:
     uint8 _semantic;
@@ -0,0 +1,328 @@
+//
+//  KTX.cpp
+//  libraries/gpu/src/gpu
+//
+//  Created by Sam Gateau on 10/15/2016.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+#include "KTX.h"
+
+#include <cstring>
+
+#include "GPULogging.h"
+
+using namespace gpu;
+
+static const Byte KTX_IDENTIFIER[12] = { 0xAB, 0x4B, 0x54, 0x58, 0x20, 0x31, 0x31, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A };
+static const uint32 KTX_ENDIANNESS = 0x04030201;
+
+// The GL enums of the supported formats, the gpu library doesn't include GL
+static const uint32 KTX_GL_UNSIGNED_BYTE = 0x1401;
+static const uint32 KTX_GL_RED = 0x1903;
+static const uint32 KTX_GL_RG = 0x8227;
+static const uint32 KTX_GL_RGB = 0x1907;
+static const uint32 KTX_GL_RGBA = 0x1908;
+static const uint32 KTX_GL_RGBA8 = 0x8058;
+static const uint32 KTX_GL_SRGB8_ALPHA8 = 0x8C43;
+static const uint32 KTX_GL_COMPRESSED_SRGB_S3TC_DXT1_EXT = 0x8C4C;
+static const uint32 KTX_GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT = 0x8C4D;
+static const uint32 KTX_GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT = 0x8C4F;
+static const uint32 KTX_GL_COMPRESSED_RED_RGTC1 = 0x8DBB;
+static const uint32 KTX_GL_COMPRESSED_RG_RGTC2 = 0x8DBD;
+static const uint32 KTX_GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM = 0x8E8D;
+
+// The texture usage flags are kept in this key
+static const char* KTX_USAGE_KEY = "hifi.usage";
+// the 9 rgb coefficients of the irradiance of a cube map, so it isn't projected again on every load
+static const char* KTX_IRRADIANCE_KEY = "hifi.irradiance";
+static const size_t KTX_IRRADIANCE_VALUE_SIZE = SphericalHarmonics::NUM_COEFFICIENTS * sizeof(glm::vec3);
+
+static glm::vec3 SphericalHarmonics::* const IRRADIANCE_COEFFICIENTS[SphericalHarmonics::NUM_COEFFICIENTS] = {
+    &SphericalHarmonics::L00, &SphericalHarmonics::L1m1, &SphericalHarmonics::L10, &SphericalHarmonics::L11,
+    &SphericalHarmonics::L2m2, &SphericalHarmonics::L2m1, &SphericalHarmonics::L20, &SphericalHarmonics::L21,
+    &SphericalHarmonics::L22
+};
+
+struct KTXHeader {
+    Byte identifier[12];
+    uint32 endianness;
+    uint32 glType;
+    uint32 glTypeSize;
+    uint32 glFormat;
+    uint32 glInternalFormat;
+    uint32 glBaseInternalFormat;
+    uint32 pixelWidth;
+    uint32 pixelHeight;
+    uint32 pixelDepth;
+    uint32 numberOfArrayElements;
+    uint32 numberOfFaces;
+    uint32 numberOfMipmapLevels;
+    uint32 bytesOfKeyValueData;
+};
+static_assert(sizeof(KTXHeader) == 64, "KTX header is 64 bytes");
+
+static size_t padTo4(size_t size) {
+    return (size + 3) & ~((size_t)3);
+}
+
+static bool evalElement(const KTXHeader& header, Element& element) {
+    switch (header.glInternalFormat) {
+        case KTX_GL_COMPRESSED_SRGB_S3TC_DXT1_EXT:
+            element = Element::COLOR_COMPRESSED_BC1_SRGB;
+            return true;
+        case KTX_GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT:
+            element = Element::COLOR_COMPRESSED_BC1_SRGBA;
+            return true;
+        case KTX_GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT:
+            element = Element::COLOR_COMPRESSED_BC3_SRGBA;
+            return true;
+        case KTX_GL_COMPRESSED_RED_RGTC1:
+            element = Element::COLOR_COMPRESSED_BC4_RED;
+            return true;
+        case KTX_GL_COMPRESSED_RG_RGTC2:
+            element = Element::VEC2_COMPRESSED_BC5_XY;
+            return true;
+        case KTX_GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM:
+            element = Element::COLOR_COMPRESSED_BC7_SRGBA;
+            return true;
+        case KTX_GL_RGBA8:
+        case KTX_GL_SRGB8_ALPHA8:
+            if (header.glType != KTX_GL_UNSIGNED_BYTE || header.glFormat != KTX_GL_RGBA) {
+                return false;
+            }
+            element = (header.glInternalFormat == KTX_GL_RGBA8) ? Element::COLOR_RGBA_32 : Element::COLOR_SRGBA_32;
+            return true;
+        default:
+            return false;
+    }
+}
+
+static bool evalHeaderFormat(const Element& element, KTXHeader& header) {
+    header.glType = 0;
+    header.glTypeSize = 1;
+    header.glFormat = 0;
+    switch (element.getSemantic()) {
+        case COMPRESSED_BC1_SRGB:
+            header.glInternalFormat = KTX_GL_COMPRESSED_SRGB_S3TC_DXT1_EXT;
+            header.glBaseInternalFormat = KTX_GL_RGB;
+            return true;
+        case COMPRESSED_BC1_SRGBA:
+            header.glInternalFormat = KTX_GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT;
+            header.glBaseInternalFormat = KTX_GL_RGBA;
+            return true;
+        case COMPRESSED_BC3_SRGBA:
+            header.glInternalFormat = KTX_GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT;
+            header.glBaseInternalFormat = KTX_GL_RGBA;
+            return true;
+        case COMPRESSED_BC4_RED:
+            header.glInternalFormat = KTX_GL_COMPRESSED_RED_RGTC1;
+            header.glBaseInternalFormat = KTX_GL_RED;
+            return true;
+        case COMPRESSED_BC5_XY:
+            header.glInternalFormat = KTX_GL_COMPRESSED_RG_RGTC2;
+            header.glBaseInternalFormat = KTX_GL_RG;
+            return true;
+        case COMPRESSED_BC7_SRGBA:
+            header.glInternalFormat = KTX_GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM;
+            header.glBaseInternalFormat = KTX_GL_RGBA;
+            return true;
+        case RGBA:
+        case SRGBA:
+            if (element != Element::COLOR_RGBA_32 && element != Element::COLOR_SRGBA_32) {
+                return false;
+            }
+            header.glType = KTX_GL_UNSIGNED_BYTE;
+            header.glFormat = KTX_GL_RGBA;
+            header.glInternalFormat = (element == Element::COLOR_RGBA_32) ? KTX_GL_RGBA8 : KTX_GL_SRGB8_ALPHA8;
+            header.glBaseInternalFormat = KTX_GL_RGBA;
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool ktx::isKTX(const Byte* data, size_t size) {
+    return (size >= sizeof(KTXHeader)) && (memcmp(data, KTX_IDENTIFIER, sizeof(KTX_IDENTIFIER)) == 0);
+}
+
+Texture* ktx::read(const Byte* data, size_t size, const std::string& source) {
+    if (!isKTX(data, size)) {
+        return nullptr;
+    }
+
+    KTXHeader header;
+    memcpy(&header, data, sizeof(KTXHeader));
+    if (header.endianness != KTX_ENDIANNESS) {
+        qCWarning(gpulogging) << "KTX texture" << source.c_str() << "has a different endianness";
+        return nullptr;
+    }
+
+    Element format;
+    if (!evalElement(header, format)) {
+        qCWarning(gpulogging) << "KTX texture" << source.c_str() << "has an unsupported format" << header.glInternalFormat;
+        return nullptr;
+    }
+
+    bool isCube = (header.numberOfFaces == 6);
+    if ((header.numberOfFaces != 1 && !isCube) || header.pixelDepth > 1 || header.numberOfArrayElements > 0 ||
+        header.pixelWidth == 0 || header.pixelWidth > 0xFFFF || header.pixelHeight > 0xFFFF) {
+        qCWarning(gpulogging) << "KTX texture" << source.c_str() << "is not a 2D texture or a cube map";
+        return nullptr;
+    }
+
+    size_t offset = sizeof(KTXHeader);
+    Texture::Usage usage;
+    SHPointer irradiance;
+    {
+        // Find the usage and the irradiance among the key values
+        size_t end = offset + header.bytesOfKeyValueData;
+        if (end > size) {
+            return nullptr;
+        }
+        while (offset + sizeof(uint32) <= end) {
+            uint32 keyAndValueSize;
+            memcpy(&keyAndValueSize, data + offset, sizeof(uint32));
+            offset += sizeof(uint32);
+            if (offset + keyAndValueSize > end) {
+                return nullptr;
+            }
+            const char* key = (const char*)(data + offset);
+            size_t keySize = strlen(KTX_USAGE_KEY) + 1;
+            if (keyAndValueSize == keySize + sizeof(uint32) && memcmp(key, KTX_USAGE_KEY, keySize) == 0) {
+                uint32 flags;
+                memcpy(&flags, data + offset + keySize, sizeof(uint32));
+                usage = Texture::Usage(Texture::Usage::Flags(flags));
+            }
+            size_t irradianceKeySize = strlen(KTX_IRRADIANCE_KEY) + 1;
+            if (keyAndValueSize == irradianceKeySize + KTX_IRRADIANCE_VALUE_SIZE &&
+                    memcmp(key, KTX_IRRADIANCE_KEY, irradianceKeySize) == 0) {
+                irradiance = std::make_shared<SphericalHarmonics>();
+                const Byte* value = data + offset + irradianceKeySize;
+                for (int i = 0; i < SphericalHarmonics::NUM_COEFFICIENTS; ++i) {
+                    memcpy(&((*irradiance).*IRRADIANCE_COEFFICIENTS[i]), value + i * sizeof(glm::vec3), sizeof(glm::vec3));
+                }
+            }
+            offset += padTo4(keyAndValueSize);
+        }
+        offset = end;
+    }
+
+    uint16 width = (uint16)header.pixelWidth;
+    uint16 height = (uint16)std::max(header.pixelHeight, (uint32)1);
+    Sampler sampler((header.numberOfMipmapLevels > 1) ? Sampler::FILTER_MIN_MAG_MIP_LINEAR : Sampler::FILTER_MIN_MAG_LINEAR);
+    Texture* texture = isCube ? Texture::createCube(format, width, sampler) : Texture::create2D(format, width, height, sampler);
+    texture->setSource(source);
+    texture->setUsage(usage);
+    if (isCube && irradiance) {
+        texture->overrideIrradiance(irradiance);
+    }
+
+    uint32 numMips = std::max(header.numberOfMipmapLevels, (uint32)1);
+    for (uint16 level = 0; level < numMips; ++level) {
+        if (offset + sizeof(uint32) > size) {
+            break;
+        }
+        // For a cube map the image size is the size of one face
+        uint32 imageSize;
+        memcpy(&imageSize, data + offset, sizeof(uint32));
+        offset += sizeof(uint32);
+
+        if (imageSize < texture->evalStoredMipFaceSize(level, format) || offset + header.numberOfFaces * padTo4(imageSize) > size) {
+            qCWarning(gpulogging) << "KTX texture" << source.c_str() << "is truncated at mip" << level;
+            break;
+        }
+
+        if (isCube) {
+            for (uint8 face = 0; face < 6; ++face) {
+                texture->assignStoredMipFace(level, format, imageSize, data + offset, face);
+                offset += padTo4(imageSize);
+            }
+        } else {
+            texture->assignStoredMip(level, format, imageSize, data + offset);
+            offset += padTo4(imageSize);
+        }
+    }
+
+    if (!texture->isStoredMipFaceAvailable(0)) {
+        delete texture;
+        return nullptr;
+    }
+    return texture;
+}
+
+std::vector<Byte> ktx::write(const Texture& texture) {
+    std::vector<Byte> result;
+
+    KTXHeader header;
+    memcpy(header.identifier, KTX_IDENTIFIER, sizeof(KTX_IDENTIFIER));
+    header.endianness = KTX_ENDIANNESS;
+    if (!evalHeaderFormat(texture.getTexelFormat(), header)) {
+        return result;
+    }
+    bool isCube = (texture.getType() == Texture::TEX_CUBE);
+    header.pixelWidth = texture.getWidth();
+    header.pixelHeight = texture.getHeight();
+    header.pixelDepth = 0;
+    header.numberOfArrayElements = 0;
+    header.numberOfFaces = isCube ? 6 : 1;
+    header.numberOfMipmapLevels = texture.maxMip() + 1;
+
+    // The usage, and the irradiance of the cube maps that have one
+    size_t keySize = strlen(KTX_USAGE_KEY) + 1;
+    uint32 keyAndValueSize = (uint32)(keySize + sizeof(uint32));
+    header.bytesOfKeyValueData = (uint32)(sizeof(uint32) + padTo4(keyAndValueSize));
+
+    const SHPointer& irradiance = texture.getIrradiance();
+    bool hasIrradiance = isCube && irradiance;
+    size_t irradianceKeySize = strlen(KTX_IRRADIANCE_KEY) + 1;
+    uint32 irradianceKeyAndValueSize = (uint32)(irradianceKeySize + KTX_IRRADIANCE_VALUE_SIZE);
+    if (hasIrradiance) {
+        header.bytesOfKeyValueData += (uint32)(sizeof(uint32) + padTo4(irradianceKeyAndValueSize));
+    }
+
+    size_t totalSize = sizeof(KTXHeader) + header.bytesOfKeyValueData;
+    for (uint16 level = 0; level < header.numberOfMipmapLevels; ++level) {
+        totalSize += sizeof(uint32) + header.numberOfFaces * padTo4(texture.evalMipFaceSize(level));
+    }
+    result.resize(totalSize, 0);
+
+    Byte* dest = result.data();
+    memcpy(dest, &header, sizeof(KTXHeader));
+    dest += sizeof(KTXHeader);
+    memcpy(dest, &keyAndValueSize, sizeof(uint32));
+    dest += sizeof(uint32);
+    memcpy(dest, KTX_USAGE_KEY, keySize);
+    uint32 flags = (uint32)texture.getUsage()._flags.to_ulong();
+    memcpy(dest + keySize, &flags, sizeof(uint32));
+    dest += padTo4(keyAndValueSize);
+
+    if (hasIrradiance) {
+        memcpy(dest, &irradianceKeyAndValueSize, sizeof(uint32));
+        dest += sizeof(uint32);
+        memcpy(dest, KTX_IRRADIANCE_KEY, irradianceKeySize);
+        for (int i = 0; i < SphericalHarmonics::NUM_COEFFICIENTS; ++i) {
+            memcpy(dest + irradianceKeySize + i * sizeof(glm::vec3), &((*irradiance).*IRRADIANCE_COEFFICIENTS[i]),
+                sizeof(glm::vec3));
+        }
+        dest += padTo4(irradianceKeyAndValueSize);
+    }
+
+    for (uint16 level = 0; level < header.numberOfMipmapLevels; ++level) {
+        uint32 imageSize = texture.evalMipFaceSize(level);
+        memcpy(dest, &imageSize, sizeof(uint32));
+        dest += sizeof(uint32);
+        for (uint8 face = 0; face < header.numberOfFaces; ++face) {
+            auto mip = texture.accessStoredMipFace(level, face);
+            if (!mip || mip->getFormat() != texture.getTexelFormat() || mip->getSize() < imageSize) {
+                qCWarning(gpulogging) << "KTX can't write texture" << texture.source().c_str() << "without its mip" << level;
+                return std::vector<Byte>();
+            }
+            memcpy(dest, mip->readData(), imageSize);
+            dest += padTo4(imageSize);
+        }
+    }
+    return result;
+}
@@ -0,0 +1,39 @@
+//
+//  KTX.h
+//  libraries/gpu/src/gpu
+//
+//  Created by Sam Gateau on 10/15/2016.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+#ifndef hifi_gpu_KTX_h
+#define hifi_gpu_KTX_h
+
+#include <vector>
+
+#include "Texture.h"
+
+namespace gpu {
+
+// The baked textures are stored in KTX 1.1 containers (https://www.khronos.org/opengles/sdk/tools/KTX/file_format_spec/)
+// holding every mip, block compressed in BC1, BC3, BC4, BC5 or BC7 or plain RGBA8,
+// so the client uploads them as they are instead of decoding, converting and mipmapping an image.
+namespace ktx {
+
+    const char* const FILE_EXTENSION = "ktx";
+
+    bool isKTX(const Byte* data, size_t size);
+
+    // Returns nullptr if the container is invalid or its format isn't supported
+    Texture* read(const Byte* data, size_t size, const std::string& source);
+
+    // The texture must have all its mips stored in its texel format
+    std::vector<Byte> write(const Texture& texture);
+
+}
+
+}
+
+#endif
@@ -116,7 +116,7 @@ PageManager::Pages PageManager::getMarkedPages(uint8_t desiredFlags, bool clear)
     return result;
 }
 
-bool PageManager::getNextTransferBlock(Size& outOffset, Size& outSize, Size& currentPage) {
+bool PageManager::getNextTransferBlock(Size& outOffset, Size& outSize, Size& currentPage, Size maxGapPages) {
     Size pageCount = _pages.size();
     // Advance to the first dirty page
     while (currentPage < pageCount && (0 == (DIRTY & _pages[currentPage]))) {
@@ -133,6 +133,18 @@ bool PageManager::getNextTransferBlock(Size& outOffset, Size& outSize, Size& cur
     while (currentPage < pageCount && (0 != (DIRTY & _pages[currentPage]))) {
         _pages[currentPage] &= ~DIRTY;
         ++currentPage;
+
+        // Bridge a short gap of clean pages if more dirty pages follow it
+        if (maxGapPages && currentPage < pageCount && (0 == (DIRTY & _pages[currentPage]))) {
+            Size nextDirtyPage = currentPage + 1;
+            while (nextDirtyPage < pageCount && nextDirtyPage - currentPage <= maxGapPages &&
+                   (0 == (DIRTY & _pages[nextDirtyPage]))) {
+                ++nextDirtyPage;
+            }
+            if (nextDirtyPage < pageCount && nextDirtyPage - currentPage <= maxGapPages) {
+                currentPage = nextDirtyPage;
+            }
+        }
     }
     outSize = static_cast<Size>((currentPage * _pageSize) - outOffset);
     return true;
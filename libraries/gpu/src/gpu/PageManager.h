@@ -49,7 +49,9 @@ struct PageManager {
     Size accommodate(Size size);
     // Get pages with the specified flags, optionally clearing the flags as we go
     Pages getMarkedPages(uint8_t desiredFlags = DIRTY, bool clear = true);
-    bool getNextTransferBlock(Size& outOffset, Size& outSize, Size& currentPage);
+    // Get the next run of dirty pages to upload, clearing their flag. Runs separated by at most maxGapPages clean pages
+    // are merged into one block, trading a few redundant bytes for fewer transfer calls
+    bool getNextTransferBlock(Size& outOffset, Size& outSize, Size& currentPage, Size maxGapPages = 0);
 };
 
 };
@@ -15,8 +15,9 @@
 
 using namespace gpu;
 
-Query::Query(const Handler& returnHandler) :
-    _returnHandler(returnHandler)
+Query::Query(const Handler& returnHandler, Type type) :
+    _returnHandler(returnHandler),
+    _type(type)
 {
 }
 
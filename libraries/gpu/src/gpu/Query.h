@@ -27,17 +27,26 @@ namespace gpu {
     public:
         using Handler = std::function<void(const Query&)>;
 
-        Query(const Handler& returnHandler);
+        enum Type {
+            TIME_ELAPSED = 0,
+            ANY_SAMPLES_PASSED, // occlusion query, true if any sample drawn between begin and end passed the depth test
+        };
+
+        Query(const Handler& returnHandler, Type type = TIME_ELAPSED);
         ~Query();
 
+        Type getType() const { return _type; }
+
         double getGPUElapsedTime() const;
         double getBatchElapsedTime() const;
+        bool anySamplesPassed() const { return _queryResult != 0; }
 
         // Only for gpu::Context
         const GPUObjectPointer gpuObject {};
         void triggerReturnHandler(uint64_t queryResult, uint64_t batchElapsedTime);
     protected:
         Handler _returnHandler;
+        Type _type { TIME_ELAPSED };
 
         uint64_t _queryResult { 0 };
         uint64_t _usecBatchElapsedTime { 0 };
@@ -15,6 +15,8 @@
 #include <glm/gtc/constants.hpp>
 #include <glm/gtx/component_wise.hpp>
 
+#include <thread>
+
 #include <QtCore/QDebug>
 #include <QtCore/QThread>
 
@@ -356,7 +358,7 @@ Texture::Size Texture::resize(Type type, const Element& texelFormat, uint16 widt
         }
         
         // Evaluate the new size with the new format
-        uint32_t size = NUM_FACES_PER_TYPE[_type] *_width * _height * _depth * _numSamples * texelFormat.getSize();
+        uint32_t size = NUM_FACES_PER_TYPE[_type] * _numSamples * evalFaceSize(texelFormat, _width, _height, _depth);
 
         // If size change then we need to reset 
         if (changed || (size != getSize())) {
@@ -473,6 +475,7 @@ bool Texture::assignStoredMipFace(uint16 level, const Element& format, Size size
     Size expectedSize = evalStoredMipFaceSize(level, format);
     if (size == expectedSize) {
         _storage->assignMipFaceData(level, format, size, bytes, face);
+        _maxMip = std::max(_maxMip, level);
         _stamp++;
         return true;
     } else if (size > expectedSize) {
@@ -481,6 +484,7 @@ bool Texture::assignStoredMipFace(uint16 level, const Element& format, Size size
         // We should probably consider something a bit more smart to get the correct result but for now (UI elements)
         // it seems to work...
         _storage->assignMipFaceData(level, format, size, bytes, face);
+        _maxMip = std::max(_maxMip, level);
         _stamp++;
         return true;
     }
@@ -543,7 +547,7 @@ uint32 Texture::getStoredMipNumTexels(uint16 level) const {
 uint32 Texture::getStoredMipSize(uint16 level) const {
     PixelsPointer mipFace = accessStoredMipFace(level);
     if (mipFace && mipFace->getSize()) {
-        return evalMipWidth(level) * evalMipHeight(level) * evalMipDepth(level) * getTexelFormat().getSize();
+        return evalMipFaceSize(level);
     }
     return 0;
 }
@@ -759,23 +763,6 @@ bool sphericalHarmonicsFromTexture(const gpu::Texture& cubeTexture, std::vector<
     }
     const uint sqOrder = order*order;
 
-    // allocate memory for calculations
-    output.resize(sqOrder);
-    std::vector<float> resultR(sqOrder);
-    std::vector<float> resultG(sqOrder);
-    std::vector<float> resultB(sqOrder);
-
-    // initialize values
-    float fWt = 0.0f;
-    for(uint i=0; i < sqOrder; i++) {
-        output[i] = glm::vec3(0.0f);
-        resultR[i] = 0.0f;
-        resultG[i] = 0;
-        resultB[i] = 0;
-    }
-    std::vector<float> shBuff(sqOrder);
-    std::vector<float> shBuffB(sqOrder);
-
     // We trade accuracy for speed by breaking the image into 32x32 parts
     // and approximating the distance for all the pixels in each part to be
     // the distance to the part's center.
@@ -786,15 +773,34 @@ bool sphericalHarmonicsFromTexture(const gpu::Texture& cubeTexture, std::vector<
     int stride = width / numDivisionsPerSide;
     int halfStride = stride / 2;
 
-    // for each face of cube texture
-    for(int face=0; face < gpu::Texture::NUM_CUBE_FACES; face++) {
+    // the faces are projected in parallel, each into its own sums which are added up in order after
+    struct FaceProjection {
+        std::vector<float> resultR;
+        std::vector<float> resultG;
+        std::vector<float> resultB;
+        float fWt { 0.0f };
+        bool isValid { true };
+    };
+    std::vector<FaceProjection> projections(gpu::Texture::NUM_CUBE_FACES);
+
+    auto projectFace = [&](int face) {
+        FaceProjection& projection = projections[face];
+        std::vector<float>& resultR = projection.resultR;
+        std::vector<float>& resultG = projection.resultG;
+        std::vector<float>& resultB = projection.resultB;
+        float& fWt = projection.fWt;
+        resultR.assign(sqOrder, 0.0f);
+        resultG.assign(sqOrder, 0.0f);
+        resultB.assign(sqOrder, 0.0f);
+
+        std::vector<float> shBuff(sqOrder);
+        std::vector<float> shBuffB(sqOrder);
 
         auto numComponents = cubeTexture.accessStoredMipFace(0,face)->getFormat().getScalarCount();
         auto data = cubeTexture.accessStoredMipFace(0,face)->readData();
         if (data == nullptr) {
-            continue;
+            return;
         }
-
         // step between two texels for range [0, 1]
         float invWidth = 1.0f / float(width);
         // initial negative bound for range [-1, 1]
@@ -854,7 +860,8 @@ bool sphericalHarmonicsFromTexture(const gpu::Texture& cubeTexture, std::vector<
                     break;
                 }
                 default:
-                    return false;
+                    projection.isValid = false;
+                    return;
                 }
 
                 // normalize direction
@@ -896,6 +903,31 @@ bool sphericalHarmonicsFromTexture(const gpu::Texture& cubeTexture, std::vector<
                 sphericalHarmonicsAdd(resultB.data(), order, resultB.data(), shBuffB.data());
             }
         }
+    };
+
+    std::vector<std::thread> threads;
+    for (int face = 1; face < gpu::Texture::NUM_CUBE_FACES; face++) {
+        threads.emplace_back(projectFace, face);
+    }
+    projectFace(0);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // allocate memory for calculations
+    output.resize(sqOrder);
+    std::vector<float> resultR(sqOrder, 0.0f);
+    std::vector<float> resultG(sqOrder, 0.0f);
+    std::vector<float> resultB(sqOrder, 0.0f);
+    float fWt = 0.0f;
+    for (auto& projection : projections) {
+        if (!projection.isValid) {
+            return false;
+        }
+        sphericalHarmonicsAdd(resultR.data(), order, resultR.data(), projection.resultR.data());
+        sphericalHarmonicsAdd(resultG.data(), order, resultG.data(), projection.resultG.data());
+        sphericalHarmonicsAdd(resultB.data(), order, resultB.data(), projection.resultB.data());
+        fWt += projection.fWt;
     }
 
     // final scale for coefficients
@@ -917,7 +949,9 @@ bool sphericalHarmonicsFromTexture(const gpu::Texture& cubeTexture, std::vector<
 void SphericalHarmonics::evalFromTexture(const Texture& texture) {
     if (texture.isDefined()) {
         std::vector< glm::vec3 > coefs;
-        sphericalHarmonicsFromTexture(texture, coefs, 3);
+        if (!sphericalHarmonicsFromTexture(texture, coefs, 3)) {
+            return;
+        }
 
         L00 = coefs[0];
         L1m1 = coefs[1];
@@ -995,4 +1029,11 @@ Texture::ExternalUpdates Texture::getUpdates() const {
         _externalUpdates.swap(result);
     }
     return result;
+}
+
+void Texture::reportVisibleSize(float visibleSize) const {
+    // The items of a frame may be recorded on several threads
+    float reportedSize = _visibleSize.load();
+    while (visibleSize > reportedSize && !_visibleSize.compare_exchange_weak(reportedSize, visibleSize)) {
+    }
 }
\ No newline at end of file
@@ -375,16 +375,26 @@ public:
     uint16 evalMipHeight(uint16 level) const { return std::max(_height >> level, 1); }
     uint16 evalMipDepth(uint16 level) const { return std::max(_depth >> level, 1); }
 
+    // Size of a face of the given dimensions in the format, block compressed formats are stored in whole blocks
+    static uint32 evalFaceSize(const Element& format, uint32 width, uint32 height, uint32 depth) {
+        auto blockSize = format.getCompressedBlockSize();
+        if (blockSize) {
+            const auto BLOCK_DIM = Element::COMPRESSED_BLOCK_DIM;
+            return ((width + BLOCK_DIM - 1) / BLOCK_DIM) * ((height + BLOCK_DIM - 1) / BLOCK_DIM) * depth * blockSize;
+        }
+        return width * height * depth * format.getSize();
+    }
+
     // Size for each face of a mip at a particular level
     uint32 evalMipFaceNumTexels(uint16 level) const { return evalMipWidth(level) * evalMipHeight(level) * evalMipDepth(level); }
-    uint32 evalMipFaceSize(uint16 level) const { return evalMipFaceNumTexels(level) * getTexelFormat().getSize(); }
+    uint32 evalMipFaceSize(uint16 level) const { return evalStoredMipFaceSize(level, getTexelFormat()); }
     
     // Total size for the mip
     uint32 evalMipNumTexels(uint16 level) const { return evalMipFaceNumTexels(level) * getNumFaces(); }
-    uint32 evalMipSize(uint16 level) const { return evalMipNumTexels(level) * getTexelFormat().getSize(); }
+    uint32 evalMipSize(uint16 level) const { return evalStoredMipSize(level, getTexelFormat()); }
 
-    uint32 evalStoredMipFaceSize(uint16 level, const Element& format) const { return evalMipFaceNumTexels(level) * format.getSize(); }
-    uint32 evalStoredMipSize(uint16 level, const Element& format) const { return evalMipNumTexels(level) * format.getSize(); }
+    uint32 evalStoredMipFaceSize(uint16 level, const Element& format) const { return evalFaceSize(format, evalMipWidth(level), evalMipHeight(level), evalMipDepth(level)); }
+    uint32 evalStoredMipSize(uint16 level, const Element& format) const { return evalStoredMipFaceSize(level, format) * getNumFaces(); }
 
     uint32 evalTotalSize(uint16 startingMip = 0) const {
         uint32 size = 0;
@@ -457,6 +467,8 @@ public:
     // For Cube Texture, it's possible to generate the irradiance spherical harmonics and make them availalbe with the texture
     bool generateIrradiance();
     const SHPointer& getIrradiance(uint16 slice = 0) const { return _irradiance; }
+    // the irradiance computed once and stored with the texture, e.g. in a baked KTX
+    void overrideIrradiance(const SHPointer& irradiance) { _irradiance = irradiance; }
     bool isIrradianceValid() const { return _isIrradianceValid; }
 
     // Own sampler
@@ -475,12 +487,20 @@ public:
 
     ExternalUpdates getUpdates() const;
 
+    // The renderer reports how large the items sampling the texture appear, as their bound size over their distance
+    // to the eye, and the largest one counts. The backend streams the mips in and evicts them by that order
+    void reportVisibleSize(float visibleSize) const;
+    // Only callable by the Backend, returns the largest size reported since the previous call
+    float takeVisibleSize() const { return _visibleSize.exchange(0.0f); }
+
 protected:
     // Should only be accessed internally or by the backend sync function
     mutable Mutex _externalMutex;
     mutable std::list<ExternalIdAndFence> _externalUpdates;
     ExternalRecycler _externalRecycler;
 
+    mutable std::atomic<float> _visibleSize { 0.0f };
+
 
     // Not strictly necessary, but incredibly useful for debugging
     std::string _source;
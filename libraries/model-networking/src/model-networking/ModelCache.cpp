@@ -13,11 +13,19 @@
 #include <Finally.h>
 #include <FSTReader.h>
 #include "FBXReader.h"
+#include "FBXBaked.h"
 #include "OBJReader.h"
 
 #include <gpu/Batch.h>
 #include <gpu/Stream.h>
 
+#include <AssetClient.h>
+#include <AssetUtils.h>
+
+#include <QCryptographicHash>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QThreadPool>
 
 #include "ModelNetworkingLogging.h"
@@ -41,6 +49,10 @@ public:
 
     virtual void downloadFinished(const QByteArray& data) override;
 
+    // The mapping only points at the geometry, which loads with the priorities given to the mapping
+    virtual void setLoadPriority(const QPointer<QObject>& owner, float priority) override;
+    virtual void clearLoadPriority(const QPointer<QObject>& owner) override;
+
 private slots:
     void onGeometryMappingLoaded(bool success);
 
@@ -86,6 +98,7 @@ void GeometryMappingResource::downloadFinished(const QByteArray& data) {
         _geometryResource = modelCache->getResource(url, QUrl(), &extra).staticCast<GeometryResource>();
         // Avoid caching nested resources - their references will be held by the parent
         _geometryResource->_isCacheable = false;
+        _geometryResource->setLoadPriorities(_loadPriorities);
 
         if (_geometryResource->isLoaded()) {
             onGeometryMappingLoaded(!_geometryResource->getURL().isEmpty());
@@ -100,11 +113,26 @@ void GeometryMappingResource::downloadFinished(const QByteArray& data) {
     }
 }
 
+void GeometryMappingResource::setLoadPriority(const QPointer<QObject>& owner, float priority) {
+    GeometryResource::setLoadPriority(owner, priority);
+    if (_geometryResource) {
+        _geometryResource->setLoadPriority(owner, priority);
+    }
+}
+
+void GeometryMappingResource::clearLoadPriority(const QPointer<QObject>& owner) {
+    GeometryResource::clearLoadPriority(owner);
+    if (_geometryResource) {
+        _geometryResource->clearLoadPriority(owner);
+    }
+}
+
 void GeometryMappingResource::onGeometryMappingLoaded(bool success) {
     if (success && _geometryResource) {
         _fbxGeometry = _geometryResource->_fbxGeometry;
         _meshParts = _geometryResource->_meshParts;
         _meshes = _geometryResource->_meshes;
+        _meshBVHs = _geometryResource->_meshBVHs;
         _materials = _geometryResource->_materials;
 
         // Avoid holding onto extra references
@@ -132,6 +160,20 @@ private:
     QByteArray _data;
 };
 
+// The geometries parsed from an fbx or obj file are kept baked in the disk cache, so the next time the same model
+// is loaded with the same mapping it is read back without parsing, from whatever url served it
+static QUrl getBakedGeometryCacheUrl(const QUrl& url, const QByteArray& data, const QVariantHash& mapping) {
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    hash.addData(data);
+    hash.addData(QJsonDocument(QJsonObject::fromVariantHash(mapping)).toJson(QJsonDocument::Compact));
+
+    // The obj reader fetches its materials next to the url, and the fbx reader looks for the textures next to the local files
+    auto suffix = QFileInfo(url.path()).suffix().toLower();
+    hash.addData((suffix == "obj" || url.isLocalFile()) ? url.toEncoded() : suffix.toUtf8());
+
+    return getDerivedCacheUrl(hash.result(), fbxbaked::FILE_EXTENSION);
+}
+
 void GeometryReader::run() {
     auto originalPriority = QThread::currentThread()->priority();
     if (originalPriority == QThread::InheritPriority) {
@@ -153,11 +195,35 @@ void GeometryReader::run() {
         }
 
         QString urlname = _url.path().toLower();
-        if (!urlname.isEmpty() && !_url.path().isEmpty() &&
-            (_url.path().toLower().endsWith(".fbx") || _url.path().toLower().endsWith(".obj"))) {
+        bool isBaked = fbxbaked::isBakedGeometry(_data);
+        if (isBaked || (!urlname.isEmpty() && !_url.path().isEmpty() &&
+            (_url.path().toLower().endsWith(".fbx") || _url.path().toLower().endsWith(".obj")))) {
             FBXGeometry::Pointer fbxGeometry;
 
-            if (_url.path().toLower().endsWith(".fbx")) {
+            QSharedPointer<AssetClient> assetClient;
+            QUrl bakedCacheUrl;
+            bool isBakedInCache = false;
+            if (!isBaked && DependencyManager::isSet<AssetClient>()) {
+                assetClient = DependencyManager::get<AssetClient>();
+                bakedCacheUrl = getBakedGeometryCacheUrl(_url, _data, _mapping);
+                QByteArray bakedData = assetClient->loadFromDiskCache(bakedCacheUrl);
+                if (fbxbaked::isBakedGeometry(bakedData)) {
+                    try {
+                        fbxGeometry.reset(fbxbaked::read(bakedData, _url.path()));
+                        isBakedInCache = true;
+                    } catch (const QString& error) {
+                        // Baked by an older version, parse it again
+                        qCDebug(modelnetworking) << "Ignoring the cached baked geometry of" << _url << ":" << error;
+                    }
+                }
+            }
+
+            if (isBakedInCache) {
+                // Already read back from the disk cache
+            } else if (isBaked) {
+                // The baked geometry comes with its meshes extracted, it only needs its buffers
+                fbxGeometry.reset(fbxbaked::read(_data, _url.path()));
+            } else if (_url.path().toLower().endsWith(".fbx")) {
                 fbxGeometry.reset(readFBX(_data, _mapping, _url.path()));
                 if (fbxGeometry->meshes.size() == 0 && fbxGeometry->joints.size() == 0) {
                     throw QString("empty geometry, possibly due to an unsupported FBX version");
@@ -168,6 +234,10 @@ void GeometryReader::run() {
                 throw QString("unsupported format");
             }
 
+            if (assetClient && !isBakedInCache && fbxGeometry->meshes.size() > 0) {
+                assetClient->saveToDiskCache(bakedCacheUrl, fbxbaked::write(*fbxGeometry));
+            }
+
             // Ensure the resource has not been deleted
             auto resource = _resource.toStrongRef();
             if (!resource) {
@@ -237,6 +307,7 @@ void GeometryDefinitionResource::setGeometryDefinition(FBXGeometry::Pointer fbxG
     }
     _meshes = meshes;
     _meshParts = parts;
+    _meshBVHs = std::make_shared<MeshBVHs>();
 
     finishedLoading(true);
 }
@@ -291,6 +362,7 @@ Geometry::Geometry(const Geometry& geometry) {
     _fbxGeometry = geometry._fbxGeometry;
     _meshes = geometry._meshes;
     _meshParts = geometry._meshParts;
+    _meshBVHs = geometry._meshBVHs;
 
     _materials.reserve(geometry._materials.size());
     for (const auto& material : geometry._materials) {
@@ -326,6 +398,16 @@ void Geometry::setTextures(const QVariantMap& textureMap) {
     }
 }
 
+void Geometry::setTexturesLoadPriority(const QPointer<QObject>& owner, float priority) {
+    for (auto& material : _materials) {
+        for (auto& texture : material->_textures) {
+            if (texture.texture) {
+                texture.texture->setLoadPriority(owner, priority);
+            }
+        }
+    }
+}
+
 bool Geometry::areTexturesLoaded() const {
     if (!_areTexturesLoaded) {
         for (auto& material : _materials) {
@@ -371,6 +453,52 @@ const std::shared_ptr<const NetworkMaterial> Geometry::getShapeMaterial(int part
     return nullptr;
 }
 
+static QVector<Triangle> getMeshTriangles(const FBXMesh& mesh) {
+    QVector<Triangle> triangles;
+    const int INDICES_PER_TRIANGLE = 3;
+    const int INDICES_PER_QUAD = 4;
+    auto modelVertex = [&](int index) {
+        return glm::vec3(mesh.modelTransform * glm::vec4(mesh.vertices[index], 1.0f));
+    };
+
+    for (const FBXMeshPart& part : mesh.parts) {
+        // quads are sliced the same way as Model::recalculateMeshBoxes
+        for (int q = 0; q + INDICES_PER_QUAD <= part.quadIndices.size(); q += INDICES_PER_QUAD) {
+            glm::vec3 v0 = modelVertex(part.quadIndices[q]);
+            glm::vec3 v1 = modelVertex(part.quadIndices[q + 1]);
+            glm::vec3 v2 = modelVertex(part.quadIndices[q + 2]);
+            glm::vec3 v3 = modelVertex(part.quadIndices[q + 3]);
+            triangles.push_back({ v0, v1, v3 });
+            triangles.push_back({ v1, v2, v3 });
+        }
+        for (int t = 0; t + INDICES_PER_TRIANGLE <= part.triangleIndices.size(); t += INDICES_PER_TRIANGLE) {
+            triangles.push_back({ modelVertex(part.triangleIndices[t]), modelVertex(part.triangleIndices[t + 1]),
+                modelVertex(part.triangleIndices[t + 2]) });
+        }
+    }
+    return triangles;
+}
+
+const TriangleBVH& Geometry::getMeshBVH(int meshIndex) const {
+    static const TriangleBVH EMPTY_BVH;
+    if (!_meshBVHs || !_fbxGeometry) {
+        return EMPTY_BVH;
+    }
+
+    // the hierarchies are shared by every copy of this geometry, so the first pick of any model builds them
+    std::call_once(_meshBVHs->built, [&] {
+        _meshBVHs->meshes.reserve(_fbxGeometry->meshes.size());
+        for (const FBXMesh& mesh : _fbxGeometry->meshes) {
+            _meshBVHs->meshes.emplace_back(getMeshTriangles(mesh));
+        }
+    });
+
+    if (meshIndex < 0 || meshIndex >= (int)_meshBVHs->meshes.size()) {
+        return EMPTY_BVH;
+    }
+    return _meshBVHs->meshes[meshIndex];
+}
+
 void GeometryResource::deleter() {
     resetTextures();
     Resource::deleter();
@@ -415,6 +543,12 @@ void GeometryResourceWatcher::setResource(GeometryResource::Pointer resource) {
     }
 }
 
+void GeometryResourceWatcher::setLoadPriority(const QPointer<QObject>& owner, float priority) {
+    if (_resource) {
+        _resource->setLoadPriority(owner, priority);
+    }
+}
+
 void GeometryResourceWatcher::resourceFinished(bool success) {
     if (success) {
         _geometryRef = std::make_shared<Geometry>(*_resource);
@@ -12,8 +12,11 @@
 #ifndef hifi_ModelCache_h
 #define hifi_ModelCache_h
 
+#include <mutex>
+
 #include <DependencyManager.h>
 #include <ResourceCache.h>
+#include <TriangleBVH.h>
 
 #include <model/Material.h>
 #include <model/Asset.h>
@@ -45,13 +48,19 @@ public:
     using NetworkMaterials = std::vector<std::shared_ptr<NetworkMaterial>>;
 
     const FBXGeometry& getFBXGeometry() const { return *_fbxGeometry; }
+    const std::shared_ptr<const FBXGeometry>& getFBXGeometryPointer() const { return _fbxGeometry; }
     const GeometryMeshes& getMeshes() const { return *_meshes; }
     const std::shared_ptr<const NetworkMaterial> getShapeMaterial(int shapeID) const;
 
+    // Triangles of a mesh in model space (before the geometry offset), for ray picks - built on first use
+    const TriangleBVH& getMeshBVH(int meshIndex) const;
+
     const QVariantMap getTextures() const;
     void setTextures(const QVariantMap& textureMap);
 
     virtual bool areTexturesLoaded() const;
+    // Sets the load priority of the textures still loading for one owner
+    void setTexturesLoadPriority(const QPointer<QObject>& owner, float priority);
     const QUrl& getAnimGraphOverrideUrl() const { return _animGraphOverrideUrl; }
 
 protected:
@@ -62,6 +71,12 @@ protected:
     std::shared_ptr<const GeometryMeshes> _meshes;
     std::shared_ptr<const GeometryMeshParts> _meshParts;
 
+    struct MeshBVHs {
+        std::once_flag built;
+        std::vector<TriangleBVH> meshes;
+    };
+    std::shared_ptr<MeshBVHs> _meshBVHs;
+
     // Copied to each geometry, mutable throughout lifetime via setTextures
     NetworkMaterials _materials;
 
@@ -110,6 +125,7 @@ public:
     void setResource(GeometryResource::Pointer resource);
 
     QUrl getURL() const { return (bool)_resource ? _resource->getURL() : QUrl(); }
+    void setLoadPriority(const QPointer<QObject>& owner, float priority);
 
 private:
     void startWatching();
@@ -13,9 +13,11 @@
 
 #include <mutex>
 
+#include <QBuffer>
 #include <QNetworkReply>
 #include <QPainter>
 #include <QRunnable>
+#include <QThread>
 #include <QThreadPool>
 #include <QImageReader>
 #include <QtCore/QFile>
@@ -25,11 +27,11 @@
 #include <glm/gtc/random.hpp>
 
 #include <gpu/Batch.h>
+#include <gpu/KTX.h>
 
 #include <NumericalConstants.h>
 #include <shared/NsightHelpers.h>
 
-#include <Finally.h>
 #include <PathUtils.h>
 
 #include "ModelNetworkingLogging.h"
@@ -47,9 +49,16 @@ TextureCache::TextureCache() {
     for (int i = 0; i < metaEnum.keyCount(); ++i) {
         type->setProperty(metaEnum.key(i), metaEnum.value(i));
     }
+
+    // The decode takes most of the load time, it gets half of the cores and the processing a quarter
+    int idealThreadCount = QThread::idealThreadCount();
+    _decodeThreadPool.setMaxThreadCount(std::max(1, idealThreadCount / 2));
+    _processThreadPool.setMaxThreadCount(std::max(1, idealThreadCount / 4));
 }
 
 TextureCache::~TextureCache() {
+    _decodeThreadPool.clear();
+    _processThreadPool.clear();
 }
 
 // use fixed table of permutations. Could also make ordered list programmatically
@@ -283,10 +292,12 @@ NetworkTexture::TextureLoaderFunc NetworkTexture::getTextureLoader() const {
 }
 
 
+// Decodes the content of a texture, then hands the image over to an ImageProcessor
 class ImageReader : public QRunnable {
 public:
 
-    ImageReader(const QWeakPointer<Resource>& resource, const QByteArray& data, const QUrl& url = QUrl());
+    ImageReader(const QWeakPointer<Resource>& resource, const QByteArray& data, const QUrl& url,
+        QThreadPool* processThreadPool, int priority);
 
     virtual void run() override;
 
@@ -296,22 +307,57 @@ private:
     QWeakPointer<Resource> _resource;
     QUrl _url;
     QByteArray _content;
+    QThreadPool* _processThreadPool;
+    int _priority;
+};
+
+// Turns a decoded image into a gpu texture with the loader of the texture type
+class ImageProcessor : public QRunnable {
+public:
+
+    ImageProcessor(const QWeakPointer<Resource>& resource, const QImage& image, const QUrl& url,
+        int originalWidth, int originalHeight);
+
+    virtual void run() override;
+
+private:
+    QWeakPointer<Resource> _resource;
+    QUrl _url;
+    QImage _image;
+    int _originalWidth;
+    int _originalHeight;
 };
 
+// QThreadPool takes integer priorities and the load priorities are angular sizes.
+// The textures nobody set a load priority for come last
+static const float IMAGE_READER_PRIORITY_SCALE = 1000.0f;
+static const float MAX_IMAGE_READER_PRIORITY = 1.0e6f;
+
 void NetworkTexture::downloadFinished(const QByteArray& data) {
-    // send the reader off to the thread pool
-    QThreadPool::globalInstance()->start(new ImageReader(_self, data, _url));
+    startImageReader(data);
 }
 
 void NetworkTexture::loadContent(const QByteArray& content) {
-    QThreadPool::globalInstance()->start(new ImageReader(_self, content, _url));
+    startImageReader(content);
 }
 
-ImageReader::ImageReader(const QWeakPointer<Resource>& resource, const QByteArray& data,
-        const QUrl& url) :
+void NetworkTexture::startImageReader(const QByteArray& content) {
+    float loadPriority = glm::clamp(getLoadPriority() * IMAGE_READER_PRIORITY_SCALE, -MAX_IMAGE_READER_PRIORITY, MAX_IMAGE_READER_PRIORITY);
+    int priority = (int)loadPriority;
+
+    // send the reader off to the texture thread pools
+    auto textureCache = DependencyManager::get<TextureCache>();
+    textureCache->getDecodeThreadPool().start(new ImageReader(_self, content, _url,
+        &textureCache->getProcessThreadPool(), priority), priority);
+}
+
+ImageReader::ImageReader(const QWeakPointer<Resource>& resource, const QByteArray& data, const QUrl& url,
+        QThreadPool* processThreadPool, int priority) :
     _resource(resource),
     _url(url),
-    _content(data)
+    _content(data),
+    _processThreadPool(processThreadPool),
+    _priority(priority)
 {
 #if DEBUG_DUMP_TEXTURE_LOADS
     static auto start = usecTimestampNow() / USECS_PER_MSEC;
@@ -343,34 +389,57 @@ void ImageReader::listSupportedImageFormats() {
 
 void ImageReader::run() {
     PROFILE_RANGE_EX(__FUNCTION__, 0xffff0000, nullptr);
-    auto originalPriority = QThread::currentThread()->priority();
-    if (originalPriority == QThread::InheritPriority) {
-        originalPriority = QThread::NormalPriority;
-    }
+    // The texture thread pools only run texture loads, their threads can stay at a low priority
     QThread::currentThread()->setPriority(QThread::LowPriority);
-    Finally restorePriority([originalPriority]{
-        QThread::currentThread()->setPriority(originalPriority);
-    });
 
     if (!_resource.data()) {
         qCWarning(modelnetworking) << "Abandoning load of" << _url << "; could not get strong ref";
         return;
     }
 
+    // The baked textures carry their compressed mips, they are used as they are
+    auto contentData = reinterpret_cast<const gpu::Byte*>(_content.constData());
+    if (gpu::ktx::isKTX(contentData, _content.size())) {
+        gpu::TexturePointer texture(gpu::ktx::read(contentData, _content.size(), _url.toString().toStdString()));
+        if (!texture) {
+            qCDebug(modelnetworking) << "Failed to read the KTX texture" << _url;
+            return;
+        }
+        auto resource = _resource.toStrongRef();
+        if (!resource) {
+            qCWarning(modelnetworking) << "Abandoning load of" << _url << "; could not get strong ref";
+        } else {
+            QMetaObject::invokeMethod(resource.data(), "setImage",
+                Q_ARG(gpu::TexturePointer, texture),
+                Q_ARG(int, texture->getWidth()), Q_ARG(int, texture->getHeight()));
+        }
+        return;
+    }
+
     listSupportedImageFormats();
 
     // Help the QImage loader by extracting the image file format from the url filename ext.
     // Some tga are not created properly without it.
     auto filename = _url.fileName().toStdString();
     auto filenameExtension = filename.substr(filename.find_last_of('.') + 1);
-    QImage image = QImage::fromData(_content, filenameExtension.c_str());
+    QBuffer buffer(&_content);
+    buffer.open(QIODevice::ReadOnly);
+    QImageReader imageReader(&buffer, filenameExtension.c_str());
+
+    // The images larger than the max texture size get decimated by the loaders. The decoders able to scale
+    // while decoding, like the JPEG one, go straight to the decimated size and skip most of the work
+    QSize originalSize = imageReader.size();
+    if (originalSize.isValid() && imageReader.supportsOption(QImageIOHandler::ScaledSize)) {
+        QSize decimatedSize = model::TextureUsage::evalDecimatedSize(originalSize);
+        if (decimatedSize != originalSize) {
+            imageReader.setScaledSize(decimatedSize);
+        }
+    }
+    QImage image = imageReader.read();
 
     // Note that QImage.format is the pixel format which is different from the "format" of the image file...
     auto imageFormat = image.format();
-    int originalWidth = image.width();
-    int originalHeight = image.height();
-
-    if (originalWidth == 0 || originalHeight == 0 || imageFormat == QImage::Format_Invalid) {
+    if (image.width() == 0 || image.height() == 0 || imageFormat == QImage::Format_Invalid) {
         if (filenameExtension.empty()) {
             qCDebug(modelnetworking) << "QImage failed to create from content, no file extension:" << _url;
         } else {
@@ -378,6 +447,26 @@ void ImageReader::run() {
         }
         return;
     }
+    if (!originalSize.isValid()) {
+        originalSize = image.size();
+    }
+
+    _processThreadPool->start(new ImageProcessor(_resource, image, _url, originalSize.width(), originalSize.height()), _priority);
+}
+
+ImageProcessor::ImageProcessor(const QWeakPointer<Resource>& resource, const QImage& image, const QUrl& url,
+        int originalWidth, int originalHeight) :
+    _resource(resource),
+    _url(url),
+    _image(image),
+    _originalWidth(originalWidth),
+    _originalHeight(originalHeight)
+{
+}
+
+void ImageProcessor::run() {
+    PROFILE_RANGE_EX(__FUNCTION__, 0xffff0000, nullptr);
+    QThread::currentThread()->setPriority(QThread::LowPriority);
 
     gpu::TexturePointer texture = nullptr;
     {
@@ -391,7 +480,7 @@ void ImageReader::run() {
         auto url = _url.toString().toStdString();
 
         PROFILE_RANGE_EX(__FUNCTION__"::textureLoader", 0xffffff00, nullptr);
-        texture.reset(resource.dynamicCast<NetworkTexture>()->getTextureLoader()(image, url));
+        texture.reset(resource.dynamicCast<NetworkTexture>()->getTextureLoader()(_image, url));
     }
 
     // Ensure the resource has not been deleted
@@ -401,7 +490,7 @@ void ImageReader::run() {
     } else {
         QMetaObject::invokeMethod(resource.data(), "setImage",
             Q_ARG(gpu::TexturePointer, texture),
-            Q_ARG(int, originalWidth), Q_ARG(int, originalHeight));
+            Q_ARG(int, _originalWidth), Q_ARG(int, _originalHeight));
     }
 }
 
@@ -18,6 +18,7 @@
 #include <QMap>
 #include <QColor>
 #include <QMetaEnum>
+#include <QThreadPool>
 
 #include <DependencyManager.h>
 #include <ResourceCache.h>
@@ -83,6 +84,8 @@ protected:
     Q_INVOKABLE void setImage(gpu::TexturePointer texture, int originalWidth, int originalHeight);
 
 private:
+    void startImageReader(const QByteArray& content);
+
     Type _type;
     TextureLoaderFunc _textureLoader { [](const QImage&, const std::string&){ return nullptr; } };
     int _originalWidth { 0 };
@@ -128,6 +131,11 @@ public:
     NetworkTexturePointer getTexture(const QUrl& url, Type type = Type::DEFAULT_TEXTURE,
         const QByteArray& content = QByteArray());
 
+    /// The texture images are decoded, then processed into gpu textures, on thread pools of their own with separate
+    /// thread budgets, so a burst of textures doesn't hold back the other loads running on the global thread pool
+    QThreadPool& getDecodeThreadPool() { return _decodeThreadPool; }
+    QThreadPool& getProcessThreadPool() { return _processThreadPool; }
+
 protected:
     // Overload ResourceCache::prefetch to allow specifying texture type for loads
     Q_INVOKABLE ScriptableResource* prefetch(const QUrl& url, int type);
@@ -146,6 +154,10 @@ private:
     gpu::TexturePointer _blueTexture;
     gpu::TexturePointer _blackTexture;
     gpu::TexturePointer _normalFittingTexture;
+
+    // The decode threads feed the process threads, they go away first
+    QThreadPool _processThreadPool;
+    QThreadPool _decodeThreadPool;
 };
 
 #endif // hifi_TextureCache_h
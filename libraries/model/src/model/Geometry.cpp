@@ -18,7 +18,8 @@ using namespace model;
 Mesh::Mesh() :
     _vertexBuffer(gpu::Element(gpu::VEC3, gpu::FLOAT, gpu::XYZ)),
     _indexBuffer(gpu::Element(gpu::SCALAR, gpu::UINT32, gpu::INDEX)),
-    _partBuffer(gpu::Element(gpu::VEC4, gpu::UINT32, gpu::PART)) {
+    _partBuffer(gpu::Element(gpu::VEC4, gpu::UINT32, gpu::PART)),
+    _partLODBuffer(gpu::Element(gpu::VEC4, gpu::UINT32, gpu::PART)) {
 }
 
 Mesh::Mesh(const Mesh& mesh) :
@@ -26,7 +27,8 @@ Mesh::Mesh(const Mesh& mesh) :
     _vertexBuffer(mesh._vertexBuffer),
     _attributeBuffers(mesh._attributeBuffers),
     _indexBuffer(mesh._indexBuffer),
-    _partBuffer(mesh._partBuffer) {
+    _partBuffer(mesh._partBuffer),
+    _partLODBuffer(mesh._partLODBuffer) {
 }
 
 Mesh::~Mesh() {
@@ -92,6 +94,25 @@ void Mesh::setPartBuffer(const BufferView& buffer) {
     _partBuffer = buffer;
 }
 
+void Mesh::setPartLODBuffer(const BufferView& buffer) {
+    _partLODBuffer = buffer;
+}
+
+int Mesh::getNumPartLODs() const {
+    size_t numParts = getNumParts();
+    if (numParts == 0) {
+        return 0;
+    }
+    return 1 + (int)(_partLODBuffer.getNumElements() / numParts);
+}
+
+const Mesh::Part& Mesh::getPartLOD(int partNum, int lod) const {
+    if (lod <= 0) {
+        return _partBuffer.get<Part>(partNum);
+    }
+    return _partLODBuffer.get<Part>((lod - 1) * getNumParts() + partNum);
+}
+
 Box Mesh::evalPartBound(int partNum) const {
     Box box;
     if (partNum < _partBuffer.getNum<Part>()) {
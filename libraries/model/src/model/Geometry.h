@@ -106,6 +106,14 @@ public:
     const BufferView& getPartBuffer() const { return _partBuffer; }
     size_t getNumParts() const { return _partBuffer.getNumElements(); }
 
+    // Simplified levels of detail of the parts, the lod 0 being the parts themselves.
+    // The part lod buffer holds the parts of each coarser lod one lod after the other,
+    // their indices come after the full detail ones in the index buffer and index the same vertices
+    void setPartLODBuffer(const BufferView& buffer);
+    const BufferView& getPartLODBuffer() const { return _partLODBuffer; }
+    int getNumPartLODs() const;
+    const Part& getPartLOD(int partNum, int lod) const;
+
     // evaluate the bounding box of A part
     Box evalPartBound(int partNum) const;
     // evaluate the bounding boxes of the parts in the range [start, end]
@@ -125,6 +133,7 @@ protected:
     BufferView _indexBuffer;
 
     BufferView _partBuffer;
+    BufferView _partLODBuffer;
 
     void evalVertexFormat();
     void evalVertexStream();
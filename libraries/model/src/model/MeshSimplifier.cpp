@@ -0,0 +1,221 @@
+//
+//  MeshSimplifier.cpp
+//  libraries/model/src/model
+//
+//  Created by Sam Gateau on 10/15/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+#include "MeshSimplifier.h"
+
+#include <algorithm>
+#include <queue>
+#include <unordered_map>
+
+using namespace model;
+
+namespace {
+
+// The symmetric 4x4 matrix summing the squared distances to a set of planes (Garland & Heckbert)
+class Quadric {
+public:
+    Quadric() {}
+    Quadric(const glm::dvec3& normal, double d) :
+        a2(normal.x * normal.x), ab(normal.x * normal.y), ac(normal.x * normal.z), ad(normal.x * d),
+        b2(normal.y * normal.y), bc(normal.y * normal.z), bd(normal.y * d),
+        c2(normal.z * normal.z), cd(normal.z * d),
+        d2(d * d) {}
+
+    Quadric& operator+=(const Quadric& other) {
+        a2 += other.a2; ab += other.ab; ac += other.ac; ad += other.ad;
+        b2 += other.b2; bc += other.bc; bd += other.bd;
+        c2 += other.c2; cd += other.cd;
+        d2 += other.d2;
+        return *this;
+    }
+
+    double eval(const glm::vec3& p) const {
+        double x = p.x, y = p.y, z = p.z;
+        return a2 * x * x + 2.0 * ab * x * y + 2.0 * ac * x * z + 2.0 * ad * x +
+            b2 * y * y + 2.0 * bc * y * z + 2.0 * bd * y +
+            c2 * z * z + 2.0 * cd * z +
+            d2;
+    }
+
+private:
+    double a2 { 0.0 }, ab { 0.0 }, ac { 0.0 }, ad { 0.0 };
+    double b2 { 0.0 }, bc { 0.0 }, bd { 0.0 };
+    double c2 { 0.0 }, cd { 0.0 };
+    double d2 { 0.0 };
+};
+
+// Collapsing the vertex from onto the vertex to, the versions tell if either changed since the cost was evaluated
+struct Collapse {
+    float cost;
+    uint32_t from;
+    uint32_t to;
+    uint32_t fromVersion;
+    uint32_t toVersion;
+
+    bool operator>(const Collapse& other) const { return cost > other.cost; }
+};
+
+}
+
+std::vector<uint32_t> MeshSimplifier::simplify(const glm::vec3* positions, size_t numVertices,
+        const uint32_t* indices, size_t numIndices, size_t targetNumIndices, float maxError) {
+    const int VERTICES_PER_TRIANGLE = 3;
+
+    // Gather the valid triangles
+    std::vector<uint32_t> triangles;
+    triangles.reserve(numIndices);
+    for (size_t i = 0; i + VERTICES_PER_TRIANGLE <= numIndices; i += VERTICES_PER_TRIANGLE) {
+        uint32_t a = indices[i], b = indices[i + 1], c = indices[i + 2];
+        if (a < numVertices && b < numVertices && c < numVertices && a != b && b != c && c != a) {
+            triangles.insert(triangles.end(), { a, b, c });
+        }
+    }
+    size_t numTriangles = triangles.size() / VERTICES_PER_TRIANGLE;
+    if (triangles.size() <= targetNumIndices) {
+        return triangles;
+    }
+
+    std::vector<bool> triangleAlive(numTriangles, true);
+    std::vector<std::vector<uint32_t>> vertexTriangles(numVertices);
+    std::vector<Quadric> quadrics(numVertices);
+    std::unordered_map<uint64_t, int> edgeUses;
+    auto edgeKey = [](uint32_t a, uint32_t b) {
+        return ((uint64_t)std::min(a, b) << 32) | std::max(a, b);
+    };
+
+    for (uint32_t t = 0; t < numTriangles; t++) {
+        const uint32_t* triangle = &triangles[t * VERTICES_PER_TRIANGLE];
+        glm::dvec3 p0 = positions[triangle[0]];
+        glm::dvec3 normal = glm::cross(glm::dvec3(positions[triangle[1]]) - p0, glm::dvec3(positions[triangle[2]]) - p0);
+        double length = glm::length(normal);
+        if (length > 0.0) {
+            normal /= length;
+        }
+        Quadric quadric(normal, -glm::dot(normal, p0));
+        for (int i = 0; i < VERTICES_PER_TRIANGLE; i++) {
+            quadrics[triangle[i]] += quadric;
+            vertexTriangles[triangle[i]].push_back(t);
+            edgeUses[edgeKey(triangle[i], triangle[(i + 1) % VERTICES_PER_TRIANGLE])]++;
+        }
+    }
+
+    // The vertices on an edge that isn't shared by exactly two triangles stay where they are
+    std::vector<bool> locked(numVertices, false);
+    for (const auto& edge : edgeUses) {
+        if (edge.second != 2) {
+            locked[(uint32_t)(edge.first >> 32)] = true;
+            locked[(uint32_t)(edge.first & 0xFFFFFFFF)] = true;
+        }
+    }
+
+    std::vector<bool> removed(numVertices, false);
+    std::vector<uint32_t> versions(numVertices, 0);
+    std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> collapses;
+    auto pushCollapse = [&](uint32_t from, uint32_t to) {
+        if (!locked[from]) {
+            Quadric quadric = quadrics[from];
+            quadric += quadrics[to];
+            collapses.push({ (float)quadric.eval(positions[to]), from, to, versions[from], versions[to] });
+        }
+    };
+    for (uint32_t t = 0; t < numTriangles; t++) {
+        const uint32_t* triangle = &triangles[t * VERTICES_PER_TRIANGLE];
+        for (int i = 0; i < VERTICES_PER_TRIANGLE; i++) {
+            pushCollapse(triangle[i], triangle[(i + 1) % VERTICES_PER_TRIANGLE]);
+            pushCollapse(triangle[(i + 1) % VERTICES_PER_TRIANGLE], triangle[i]);
+        }
+    }
+
+    // Reject the collapses flipping or squashing the triangles moving with the collapsed vertex
+    const float MIN_NORMAL_COSINE = 0.2f;
+    auto isValidCollapse = [&](uint32_t from, uint32_t to) {
+        for (uint32_t t : vertexTriangles[from]) {
+            const uint32_t* triangle = &triangles[t * VERTICES_PER_TRIANGLE];
+            if (!triangleAlive[t] || triangle[0] == to || triangle[1] == to || triangle[2] == to) {
+                continue;
+            }
+            glm::vec3 p[VERTICES_PER_TRIANGLE];
+            for (int i = 0; i < VERTICES_PER_TRIANGLE; i++) {
+                p[i] = positions[triangle[i]];
+            }
+            glm::vec3 oldNormal = glm::cross(p[1] - p[0], p[2] - p[0]);
+            for (int i = 0; i < VERTICES_PER_TRIANGLE; i++) {
+                if (triangle[i] == from) {
+                    p[i] = positions[to];
+                }
+            }
+            glm::vec3 newNormal = glm::cross(p[1] - p[0], p[2] - p[0]);
+            if (glm::dot(oldNormal, newNormal) <= MIN_NORMAL_COSINE * glm::length(oldNormal) * glm::length(newNormal)) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    const float maxCost = maxError * maxError;
+    size_t numAliveIndices = triangles.size();
+    while (numAliveIndices > targetNumIndices && !collapses.empty()) {
+        Collapse collapse = collapses.top();
+        collapses.pop();
+        if (collapse.cost > maxCost) {
+            break;
+        }
+        uint32_t from = collapse.from;
+        uint32_t to = collapse.to;
+        if (removed[from] || removed[to] || versions[from] != collapse.fromVersion || versions[to] != collapse.toVersion) {
+            continue;
+        }
+        if (!isValidCollapse(from, to)) {
+            continue;
+        }
+
+        // The triangles on the edge disappear, the others move from the collapsed vertex to the kept one
+        auto& toTriangles = vertexTriangles[to];
+        for (uint32_t t : vertexTriangles[from]) {
+            if (!triangleAlive[t]) {
+                continue;
+            }
+            uint32_t* triangle = &triangles[t * VERTICES_PER_TRIANGLE];
+            if (triangle[0] == to || triangle[1] == to || triangle[2] == to) {
+                triangleAlive[t] = false;
+                numAliveIndices -= VERTICES_PER_TRIANGLE;
+            } else {
+                std::replace(triangle, triangle + VERTICES_PER_TRIANGLE, from, to);
+                toTriangles.push_back(t);
+            }
+        }
+        toTriangles.erase(std::remove_if(toTriangles.begin(), toTriangles.end(), [&](uint32_t t) {
+            return !triangleAlive[t];
+        }), toTriangles.end());
+        vertexTriangles[from].clear();
+        removed[from] = true;
+        quadrics[to] += quadrics[from];
+        versions[to]++;
+
+        for (uint32_t t : toTriangles) {
+            const uint32_t* triangle = &triangles[t * VERTICES_PER_TRIANGLE];
+            for (int i = 0; i < VERTICES_PER_TRIANGLE; i++) {
+                if (triangle[i] != to) {
+                    pushCollapse(to, triangle[i]);
+                    pushCollapse(triangle[i], to);
+                }
+            }
+        }
+    }
+
+    std::vector<uint32_t> result;
+    result.reserve(numAliveIndices);
+    for (uint32_t t = 0; t < numTriangles; t++) {
+        if (triangleAlive[t]) {
+            result.insert(result.end(), triangles.begin() + t * VERTICES_PER_TRIANGLE, triangles.begin() + (t + 1) * VERTICES_PER_TRIANGLE);
+        }
+    }
+    return result;
+}
@@ -0,0 +1,35 @@
+//
+//  MeshSimplifier.h
+//  libraries/model/src/model
+//
+//  Created by Sam Gateau on 10/15/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+#ifndef hifi_model_MeshSimplifier_h
+#define hifi_model_MeshSimplifier_h
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace model {
+
+// Simplifies a triangle list by collapsing the edges of least quadric error, each edge onto one of its vertices,
+// so the simplified triangles still index the original vertices and share their buffers.
+// The vertices on the borders of the triangles, or sharing their position with another vertex (uv or normal seams),
+// are never moved so the simplified surface keeps its outline and doesn't open cracks.
+class MeshSimplifier {
+public:
+    // Collapses edges until the triangles fit in targetNumIndices or the next collapse would move the surface
+    // further than maxError, and returns the remaining triangles
+    static std::vector<uint32_t> simplify(const glm::vec3* positions, size_t numVertices,
+        const uint32_t* indices, size_t numIndices, size_t targetNumIndices, float maxError);
+};
+
+}
+
+#endif
@@ -10,6 +10,8 @@
 //
 #include "TextureMap.h"
 
+#include <algorithm>
+
 #include <QImage>
 #include <QPainter>
 #include <QDebug>
@@ -49,13 +51,17 @@ uvec2 rectifyToSparseSize(const uvec2& size) {
 std::atomic<size_t> DECIMATED_TEXTURE_COUNT { 0 };
 std::atomic<size_t> RECTIFIED_TEXTURE_COUNT { 0 };
 
-QImage processSourceImage(const QImage& srcImage, bool cubemap) {
-    const uvec2 srcImageSize = toGlm(srcImage.size());
-    uvec2 targetSize = srcImageSize;
-
+QSize TextureUsage::evalDecimatedSize(const QSize& srcSize) {
+    uvec2 targetSize = toGlm(srcSize);
     while (glm::any(glm::greaterThan(targetSize, MAX_TEXTURE_SIZE))) {
         targetSize /= 2;
     }
+    return fromGlm(targetSize);
+}
+
+QImage processSourceImage(const QImage& srcImage, bool cubemap) {
+    const uvec2 srcImageSize = toGlm(srcImage.size());
+    uvec2 targetSize = toGlm(TextureUsage::evalDecimatedSize(srcImage.size()));
     if (targetSize != srcImageSize) {
         ++DECIMATED_TEXTURE_COUNT;
     }
@@ -296,85 +302,66 @@ gpu::Texture* TextureUsage::createNormalTextureFromNormalImage(const QImage& src
     return theTexture;
 }
 
-int clampPixelCoordinate(int coordinate, int maxCoordinate) {
-    return coordinate - ((int)(coordinate < 0) * coordinate) + ((int)(coordinate > maxCoordinate) * (maxCoordinate - coordinate));
-}
-
 const int RGBA_MAX = 255;
 
 // transform -1 - 1 to 0 - 255 (from sobel value to rgb)
-double mapComponent(double sobelValue) {
-    const double factor = RGBA_MAX / 2.0;
-    return (sobelValue + 1.0) * factor;
+uchar mapComponent(float sobelValue) {
+    const float factor = RGBA_MAX / 2.0f;
+    return (uchar)((sobelValue + 1.0f) * factor);
 }
 
 gpu::Texture* TextureUsage::createNormalTextureFromBumpImage(const QImage& srcImage, const std::string& srcImageName) {
     QImage image = processSourceImage(srcImage, false);
 
-    if (image.format() != QImage::Format_RGB888) {
-        image = image.convertToFormat(QImage::Format_RGB888);
+    // The bump map is a height map, one gray byte per pixel
+    if (image.format() != QImage::Format_Grayscale8) {
+        image = image.convertToFormat(QImage::Format_Grayscale8);
     }
 
     // PR 5540 by AlessandroSigna integrated here as a specialized TextureLoader for bumpmaps
-    // The conversion is done using the Sobel Filter to calculate the derivatives from the grayscale image
-    const double pStrength = 2.0;
+    // The conversion is done using the Sobel Filter to calculate the derivatives from the grayscale image.
+    // It goes through the scan lines, the edges repeat the border pixels
+    const float pStrength = 2.0f;
+    const float dZ = RGBA_MAX / pStrength;
     int width = image.width();
     int height = image.height();
     QImage result(width, height, QImage::Format_RGB888);
-    
-    for (int i = 0; i < width; i++) {
-        const int iNextClamped = clampPixelCoordinate(i + 1, width - 1);
-        const int iPrevClamped = clampPixelCoordinate(i - 1, width - 1);
-    
-        for (int j = 0; j < height; j++) {
-            const int jNextClamped = clampPixelCoordinate(j + 1, height - 1);
-            const int jPrevClamped = clampPixelCoordinate(j - 1, height - 1);
-    
-            // surrounding pixels
-            const QRgb topLeft = image.pixel(iPrevClamped, jPrevClamped);
-            const QRgb top = image.pixel(iPrevClamped, j);
-            const QRgb topRight = image.pixel(iPrevClamped, jNextClamped);
-            const QRgb right = image.pixel(i, jNextClamped);
-            const QRgb bottomRight = image.pixel(iNextClamped, jNextClamped);
-            const QRgb bottom = image.pixel(iNextClamped, j);
-            const QRgb bottomLeft = image.pixel(iNextClamped, jPrevClamped);
-            const QRgb left = image.pixel(i, jPrevClamped);
-    
-            // take their gray intensities
-            // since it's a grayscale image, the value of each component RGB is the same
-            const double tl = qRed(topLeft);
-            const double t = qRed(top);
-            const double tr = qRed(topRight);
-            const double r = qRed(right);
-            const double br = qRed(bottomRight);
-            const double b = qRed(bottom);
-            const double bl = qRed(bottomLeft);
-            const double l = qRed(left);
-    
-            // apply the sobel filter
-            const double dX = (tr + pStrength * r + br) - (tl + pStrength * l + bl);
-            const double dY = (bl + pStrength * b + br) - (tl + pStrength * t + tr);
-            const double dZ = RGBA_MAX / pStrength;
-    
-            glm::vec3 v(dX, dY, dZ);
-            glm::normalize(v);
-    
+
+    for (int y = 0; y < height; y++) {
+        const uchar* above = image.constScanLine(std::max(y - 1, 0));
+        const uchar* line = image.constScanLine(y);
+        const uchar* below = image.constScanLine(std::min(y + 1, height - 1));
+        uchar* resultLine = result.scanLine(y);
+
+        for (int x = 0; x < width; x++) {
+            const int xPrev = std::max(x - 1, 0);
+            const int xNext = std::min(x + 1, width - 1);
+
+            // apply the sobel filter, the rows of the image go down and the normal y goes up
+            const float dX = (float)(above[xNext] + pStrength * line[xNext] + below[xNext]) -
+                (above[xPrev] + pStrength * line[xPrev] + below[xPrev]);
+            const float dY = (float)(below[xPrev] + pStrength * below[x] + below[xNext]) -
+                (above[xPrev] + pStrength * above[x] + above[xNext]);
+
+            glm::vec3 v = glm::normalize(glm::vec3(-dX, dY, dZ));
+
             // convert to rgb from the value obtained computing the filter
-            QRgb qRgbValue = qRgb(mapComponent(v.x), mapComponent(v.y), mapComponent(v.z));
-            result.setPixel(i, j, qRgbValue);
+            resultLine[3 * x] = mapComponent(v.x);
+            resultLine[3 * x + 1] = mapComponent(v.y);
+            resultLine[3 * x + 2] = mapComponent(v.z);
         }
     }
 
     gpu::Texture* theTexture = nullptr;
-    if ((image.width() > 0) && (image.height() > 0)) {
+    if ((result.width() > 0) && (result.height() > 0)) {
 
         gpu::Element formatGPU = gpu::Element(gpu::VEC3, gpu::NUINT8, gpu::RGB);
         gpu::Element formatMip = gpu::Element(gpu::VEC3, gpu::NUINT8, gpu::RGB);
 
-        theTexture = (gpu::Texture::create2D(formatGPU, image.width(), image.height(), gpu::Sampler(gpu::Sampler::FILTER_MIN_MAG_MIP_LINEAR)));
+        theTexture = (gpu::Texture::create2D(formatGPU, result.width(), result.height(), gpu::Sampler(gpu::Sampler::FILTER_MIN_MAG_MIP_LINEAR)));
         theTexture->setSource(srcImageName);
-        theTexture->assignStoredMip(0, formatMip, image.byteCount(), image.constBits());
-        generateMips(theTexture, image, formatMip);
+        theTexture->assignStoredMip(0, formatMip, result.byteCount(), result.constBits());
+        generateMips(theTexture, result, formatMip);
     }
 
     return theTexture;
@@ -426,10 +413,9 @@ gpu::Texture* TextureUsage::createRoughnessTextureFromGlossImage(const QImage& s
         }
     }
 
-    // Gloss turned into Rough
-    image.invertPixels(QImage::InvertRgba);
-    
+    // Gloss turned into Rough, on the gray bytes rather than on the 4 channels
     image = image.convertToFormat(QImage::Format_Grayscale8);
+    image.invertPixels();
     
     gpu::Texture* theTexture = nullptr;
     if ((image.width() > 0) && (image.height() > 0)) {
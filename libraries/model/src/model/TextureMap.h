@@ -19,6 +19,7 @@
 #include <qurl.h>
 
 class QImage;
+class QSize;
 
 namespace model {
 
@@ -44,6 +45,10 @@ public:
     static gpu::Texture* createLightmapTextureFromImage(const QImage& image, const std::string& srcImageName);
 
 
+    // The loaders first bring the images larger than the max texture size down to this size,
+    // so they can be decoded at this size right away
+    static QSize evalDecimatedSize(const QSize& srcSize);
+
     static const QImage process2DImageColor(const QImage& srcImage, bool& validAlpha, bool& alphaAsMask);
     static void defineColorTexelFormats(gpu::Element& formatGPU, gpu::Element& formatMip,
         const QImage& srcImage, bool isLinear, bool doCompress);
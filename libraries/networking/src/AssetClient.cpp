@@ -86,6 +86,27 @@ void AssetClient::cacheInfoRequest(QObject* reciever, QString slot) {
     }
 }
 
+QByteArray AssetClient::loadFromDiskCache(const QUrl& url) {
+    if (QThread::currentThread() != thread()) {
+        QByteArray result;
+        QMetaObject::invokeMethod(this, "loadFromDiskCache", Qt::BlockingQueuedConnection,
+                                  Q_RETURN_ARG(QByteArray, result), Q_ARG(QUrl, url));
+        return result;
+    }
+
+    return loadFromCache(url);
+}
+
+void AssetClient::saveToDiskCache(const QUrl& url, const QByteArray& data) {
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, "saveToDiskCache", Qt::QueuedConnection,
+                                  Q_ARG(QUrl, url), Q_ARG(QByteArray, data));
+        return;
+    }
+
+    saveToCache(url, data);
+}
+
 void AssetClient::clearCache() {
     if (QThread::currentThread() != thread()) {
         QMetaObject::invokeMethod(this, "clearCache", Qt::QueuedConnection);
@@ -150,8 +171,8 @@ GetMappingRequest* AssetClient::createGetMappingRequest(const AssetPath& path) {
     return request;
 }
 
-GetAllMappingsRequest* AssetClient::createGetAllMappingsRequest() {
-    auto request = new GetAllMappingsRequest();
+GetAllMappingsRequest* AssetClient::createGetAllMappingsRequest(const AssetPath& prefix, const AssetPath& startAfter, int limit) {
+    auto request = new GetAllMappingsRequest(prefix, startAfter, limit);
 
     request->moveToThread(thread());
 
@@ -174,6 +195,14 @@ SetMappingRequest* AssetClient::createSetMappingRequest(const AssetPath& path, c
     return request;
 }
 
+SetMappingRequest* AssetClient::createSetMappingsRequest(const AssetMapping& mappings) {
+    auto request = new SetMappingRequest(mappings);
+
+    request->moveToThread(thread());
+
+    return request;
+}
+
 RenameMappingRequest* AssetClient::createRenameMappingRequest(const AssetPath& oldPath, const AssetPath& newPath) {
     auto request = new RenameMappingRequest(oldPath, newPath);
 
@@ -286,6 +315,11 @@ void AssetClient::handleAssetGetInfoReply(QSharedPointer<ReceivedMessage> messag
 
     if (error == AssetServerError::NoError) {
         message->readPrimitive(&info.size);
+
+        // older asset servers don't send a mirror url
+        if (message->getBytesLeftToRead() >= qint64(sizeof(uint32_t))) {
+            info.mirrorURL = QUrl(message->readString());
+        }
     }
 
     // Check if we have any pending requests for this node
@@ -353,6 +387,11 @@ void AssetClient::handleAssetGetReply(QSharedPointer<ReceivedMessage> message, S
         callbacks.completeCallback(true, error, message->readAll());
         messageCallbackMap.erase(requestIt);
     } else {
+        // the rest of the asset is still coming, make room for it all at once
+        if (!error) {
+            message->reserve(message->getPosition() + length);
+        }
+
         auto weakNode = senderNode.toWeakRef();
 
         connect(message.data(), &ReceivedMessage::progress, this, [this, weakNode, messageID, length](qint64 size) {
@@ -466,7 +505,8 @@ MessageID AssetClient::getAssetMapping(const AssetPath& path, MappingOperationCa
     return INVALID_MESSAGE_ID;
 }
 
-MessageID AssetClient::getAllAssetMappings(MappingOperationCallback callback) {
+MessageID AssetClient::getAllAssetMappings(const AssetPath& prefix, const AssetPath& startAfter, int limit,
+                                           MappingOperationCallback callback) {
     Q_ASSERT(QThread::currentThread() == thread());
 
     auto nodeList = DependencyManager::get<NodeList>();
@@ -480,6 +520,10 @@ MessageID AssetClient::getAllAssetMappings(MappingOperationCallback callback) {
 
         packetList->writePrimitive(AssetMappingOperationType::GetAll);
 
+        packetList->writeString(prefix);
+        packetList->writeString(startAfter);
+        packetList->writePrimitive(limit);
+
         if (nodeList->sendPacketList(std::move(packetList), *assetServer) != -1) {
             _pendingMappingRequests[assetServer][messageID] = callback;
 
@@ -520,7 +564,7 @@ MessageID AssetClient::deleteAssetMappings(const AssetPathList& paths, MappingOp
     return INVALID_MESSAGE_ID;
 }
 
-MessageID AssetClient::setAssetMapping(const QString& path, const AssetHash& hash, MappingOperationCallback callback) {
+MessageID AssetClient::setAssetMappings(const AssetMapping& mappings, MappingOperationCallback callback) {
     Q_ASSERT(QThread::currentThread() == thread());
 
     auto nodeList = DependencyManager::get<NodeList>();
@@ -534,8 +578,12 @@ MessageID AssetClient::setAssetMapping(const QString& path, const AssetHash& has
 
         packetList->writePrimitive(AssetMappingOperationType::Set);
 
-        packetList->writeString(path);
-        packetList->write(QByteArray::fromHex(hash.toUtf8()));
+        packetList->writePrimitive(int(mappings.size()));
+
+        for (auto& mapping : mappings) {
+            packetList->writeString(mapping.first);
+            packetList->write(QByteArray::fromHex(mapping.second.toUtf8()));
+        }
 
         if (nodeList->sendPacketList(std::move(packetList), *assetServer) != -1) {
             _pendingMappingRequests[assetServer][messageID] = callback;
@@ -38,6 +38,7 @@ class AssetUpload;
 struct AssetInfo {
     QString hash;
     int64_t size;
+    QUrl mirrorURL; // set when the asset server has its files mirrored on an http server, to download them from there
 };
 
 using MappingOperationCallback = std::function<void(bool responseReceived, AssetServerError serverError, QSharedPointer<ReceivedMessage> message)>;
@@ -52,14 +53,22 @@ public:
     AssetClient();
 
     Q_INVOKABLE GetMappingRequest* createGetMappingRequest(const AssetPath& path);
-    Q_INVOKABLE GetAllMappingsRequest* createGetAllMappingsRequest();
+    /// Requests the mappings starting with prefix, the limit mappings after startAfter if limit is not 0
+    Q_INVOKABLE GetAllMappingsRequest* createGetAllMappingsRequest(const AssetPath& prefix = AssetPath(),
+        const AssetPath& startAfter = AssetPath(), int limit = 0);
     Q_INVOKABLE DeleteMappingsRequest* createDeleteMappingsRequest(const AssetPathList& paths);
     Q_INVOKABLE SetMappingRequest* createSetMappingRequest(const AssetPath& path, const AssetHash& hash);
+    SetMappingRequest* createSetMappingsRequest(const AssetMapping& mappings);
     Q_INVOKABLE RenameMappingRequest* createRenameMappingRequest(const AssetPath& oldPath, const AssetPath& newPath);
     Q_INVOKABLE AssetRequest* createRequest(const AssetHash& hash);
     Q_INVOKABLE AssetUpload* createUpload(const QString& filename);
     Q_INVOKABLE AssetUpload* createUpload(const QByteArray& data);
 
+    // The disk cache belongs to the client's thread, these let the other threads reach it,
+    // loading blocks until the client's thread has read the entry
+    Q_INVOKABLE QByteArray loadFromDiskCache(const QUrl& url);
+    Q_INVOKABLE void saveToDiskCache(const QUrl& url, const QByteArray& data);
+
     static const MessageID INVALID_MESSAGE_ID = 0;
 
 public slots:
@@ -79,8 +88,9 @@ private slots:
 
 private:
     MessageID getAssetMapping(const AssetHash& hash, MappingOperationCallback callback);
-    MessageID getAllAssetMappings(MappingOperationCallback callback);
-    MessageID setAssetMapping(const QString& path, const AssetHash& hash, MappingOperationCallback callback);
+    MessageID getAllAssetMappings(const AssetPath& prefix, const AssetPath& startAfter, int limit,
+                                  MappingOperationCallback callback);
+    MessageID setAssetMappings(const AssetMapping& mappings, MappingOperationCallback callback);
     MessageID deleteAssetMappings(const AssetPathList& paths, MappingOperationCallback callback);
     MessageID renameAssetMapping(const AssetPath& oldPath, const AssetPath& newPath, MappingOperationCallback callback);
 
@@ -19,17 +19,19 @@
 #include "NetworkLogging.h"
 #include "NodeList.h"
 #include "ResourceCache.h"
+#include "ResourceManager.h"
 
 AssetRequest::AssetRequest(const QString& hash) :
     _hash(hash)
 {
 }
 
+static const int64_t MIN_CHUNK_SIZE = 2 * 1024 * 1024;
+static const int64_t MAX_CONCURRENT_CHUNKS = 4;
+
 AssetRequest::~AssetRequest() {
     auto assetClient = DependencyManager::get<AssetClient>();
-    if (_assetRequestID) {
-        assetClient->cancelGetAssetRequest(_assetRequestID);
-    }
+    cancelChunkRequests();
     if (_assetInfoRequestID) {
         assetClient->cancelGetAssetInfoRequest(_assetInfoRequestID);
     }
@@ -102,64 +104,144 @@ void AssetRequest::start() {
         _data.resize(info.size);
         
         qCDebug(asset_client) << "Got size of " << _hash << " : " << info.size << " bytes";
-        
-        int start = 0, end = _info.size;
-        
-        auto assetClient = DependencyManager::get<AssetClient>();
-        auto that = QPointer<AssetRequest>(this); // Used to track the request's lifetime
-        auto hash = _hash;
-        _assetRequestID = assetClient->getAsset(_hash, start, end,
-                [this, that, hash, start, end](bool responseReceived, AssetServerError serverError, const QByteArray& data) {
-            if (!that) {
-                qCWarning(asset_client) << "Got reply for dead asset request " << hash << "- error code" << _error;
-                // If the request is dead, return
-                return;
+
+        if (!_info.mirrorURL.isEmpty() && _info.mirrorURL.isValid()) {
+            requestFromMirror();
+        } else {
+            requestChunks();
+        }
+    });
+}
+
+void AssetRequest::requestFromMirror() {
+    // the mirror only takes the bulk transfer off the asset server, which stays the fallback
+    auto request = ResourceManager::createResourceRequest(this, _info.mirrorURL);
+    if (!request) {
+        requestChunks();
+        return;
+    }
+
+    connect(request, &ResourceRequest::progress, this, [this](qint64 bytesReceived, qint64 bytesTotal) {
+        _totalReceived = bytesReceived;
+        emit progress(bytesReceived, _info.size);
+    });
+    connect(request, &ResourceRequest::finished, this, [this, request]() {
+        request->deleteLater();
+
+        auto data = request->getData();
+        if (request->getResult() == ResourceRequest::Success && hashData(data).toHex() == _hash) {
+            _data = data;
+            _totalReceived = _data.size();
+            saveToCache(getUrl(), _data);
+
+            _state = Finished;
+            emit finished(this);
+        } else {
+            qCWarning(asset_client) << "Failed to download" << _hash << "from mirror, falling back to the asset server";
+            _totalReceived = 0;
+            requestChunks();
+        }
+    });
+
+    request->send();
+}
+
+void AssetRequest::requestChunks() {
+    // Large assets are split in ranges requested all at once, so the server reads and sends them in parallel
+    int64_t numChunks = std::max((int64_t)1, std::min(MAX_CONCURRENT_CHUNKS,
+        (_info.size + MIN_CHUNK_SIZE - 1) / MIN_CHUNK_SIZE));
+    int64_t chunkSize = (_info.size + numChunks - 1) / numChunks;
+    _assetRequestIDs.assign(numChunks, AssetClient::INVALID_MESSAGE_ID);
+    _chunksReceived.assign(numChunks, 0);
+    for (int64_t i = 0; i < numChunks && _state != Finished; i++) {
+        requestChunk(i, i * chunkSize, std::min(_info.size, (i + 1) * chunkSize));
+    }
+}
+
+void AssetRequest::requestChunk(size_t index, DataOffset start, DataOffset end) {
+    auto assetClient = DependencyManager::get<AssetClient>();
+    auto that = QPointer<AssetRequest>(this); // Used to track the request's lifetime
+    auto hash = _hash;
+    _assetRequestIDs[index] = assetClient->getAsset(_hash, start, end,
+            [this, that, hash, index, start, end](bool responseReceived, AssetServerError serverError, const QByteArray& data) {
+        if (!that) {
+            qCWarning(asset_client) << "Got reply for dead asset request " << hash << "- error code" << _error;
+            // If the request is dead, return
+            return;
+        }
+        _assetRequestIDs[index] = AssetClient::INVALID_MESSAGE_ID;
+
+        if (_state == Finished) {
+            // Another range already failed the request
+            return;
+        }
+
+        if (!responseReceived) {
+            _error = NetworkError;
+        } else if (serverError != AssetServerError::NoError) {
+            switch (serverError) {
+                case AssetServerError::AssetNotFound:
+                    _error = NotFound;
+                    break;
+                case AssetServerError::InvalidByteRange:
+                    _error = InvalidByteRange;
+                    break;
+                default:
+                    _error = UnknownError;
+                    break;
             }
-            _assetRequestID = AssetClient::INVALID_MESSAGE_ID;
-
-            if (!responseReceived) {
-                _error = NetworkError;
-            } else if (serverError != AssetServerError::NoError) {
-                switch (serverError) {
-                    case AssetServerError::AssetNotFound:
-                        _error = NotFound;
-                        break;
-                    case AssetServerError::InvalidByteRange:
-                        _error = InvalidByteRange;
-                        break;
-                    default:
-                        _error = UnknownError;
-                        break;
-                }
+        } else if (data.size() != (end - start)) {
+            _error = InvalidByteRange;
+        } else {
+            memcpy(_data.data() + start, data.constData(), data.size());
+            updateProgress(index, data.size());
+        }
+
+        if (_error != NoError) {
+            qCWarning(asset_client) << "Got error retrieving asset" << _hash << "- error code" << _error;
+            cancelChunkRequests();
+            _state = Finished;
+            emit finished(this);
+            return;
+        }
+
+        bool isComplete = std::all_of(_assetRequestIDs.cbegin(), _assetRequestIDs.cend(), [](MessageID id) {
+            return id == AssetClient::INVALID_MESSAGE_ID;
+        });
+        if (isComplete) {
+            // we need to check the hash of the received data to make sure it matches what we expect
+            if (hashData(_data).toHex() == _hash) {
+                saveToCache(getUrl(), _data);
             } else {
-                Q_ASSERT(data.size() == (end - start));
-                
-                // we need to check the hash of the received data to make sure it matches what we expect
-                if (hashData(data).toHex() == _hash) {
-                    memcpy(_data.data() + start, data.constData(), data.size());
-                    _totalReceived += data.size();
-                    emit progress(_totalReceived, _info.size);
-                    
-                    saveToCache(getUrl(), data);
-                } else {
-                    // hash doesn't match - we have an error
-                    _error = HashVerificationFailed;
-                }
-                
-            }
-            
-            if (_error != NoError) {
+                // hash doesn't match - we have an error
+                _error = HashVerificationFailed;
                 qCWarning(asset_client) << "Got error retrieving asset" << _hash << "- error code" << _error;
             }
-            
+
             _state = Finished;
             emit finished(this);
-        }, [this, that](qint64 totalReceived, qint64 total) {
-            if (!that) {
-                // If the request is dead, return
-                return;
-            }
-            emit progress(totalReceived, total);
-        });
+        }
+    }, [this, that, index](qint64 totalReceived, qint64 total) {
+        if (!that) {
+            // If the request is dead, return
+            return;
+        }
+        updateProgress(index, totalReceived);
     });
 }
+
+void AssetRequest::updateProgress(size_t index, qint64 chunkReceived) {
+    _totalReceived += chunkReceived - _chunksReceived[index];
+    _chunksReceived[index] = chunkReceived;
+    emit progress(_totalReceived, _info.size);
+}
+
+void AssetRequest::cancelChunkRequests() {
+    auto assetClient = DependencyManager::get<AssetClient>();
+    for (auto& requestID : _assetRequestIDs) {
+        if (requestID != AssetClient::INVALID_MESSAGE_ID) {
+            assetClient->cancelGetAssetRequest(requestID);
+            requestID = AssetClient::INVALID_MESSAGE_ID;
+        }
+    }
+}
@@ -12,6 +12,8 @@
 #ifndef hifi_AssetRequest_h
 #define hifi_AssetRequest_h
 
+#include <vector>
+
 #include <QByteArray>
 #include <QObject>
 #include <QString>
@@ -56,14 +58,20 @@ signals:
     void progress(qint64 totalReceived, qint64 total);
 
 private:
+    void requestFromMirror();
+    void requestChunks();
+    void requestChunk(size_t index, DataOffset start, DataOffset end);
+    void updateProgress(size_t index, qint64 chunkReceived);
+    void cancelChunkRequests();
+
     State _state = NotStarted;
     Error _error = NoError;
     AssetInfo _info;
-    uint64_t _totalReceived { 0 };
+    int64_t _totalReceived { 0 };
     QString _hash;
     QByteArray _data;
-    int _numPendingRequests { 0 };
-    MessageID _assetRequestID { AssetClient::INVALID_MESSAGE_ID };
+    std::vector<MessageID> _assetRequestIDs;
+    std::vector<int64_t> _chunksReceived;
     MessageID _assetInfoRequestID { AssetClient::INVALID_MESSAGE_ID };
 };
 
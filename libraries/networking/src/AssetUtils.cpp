@@ -70,6 +70,11 @@ bool saveToCache(const QUrl& url, const QByteArray& file) {
     return false;
 }
 
+QUrl getDerivedCacheUrl(const QByteArray& hash, const QString& derivation) {
+    static const QString URL_SCHEME_DERIVED = "derived";
+    return QUrl(QString("%1:%2.%3").arg(URL_SCHEME_DERIVED, QString(hash.toHex()), derivation));
+}
+
 bool isValidFilePath(const AssetPath& filePath) {
     QRegExp filePathRegex { ASSET_FILE_PATH_REGEX_STRING };
     return filePathRegex.exactMatch(filePath);
@@ -60,6 +60,10 @@ QByteArray hashData(const QByteArray& data);
 QByteArray loadFromCache(const QUrl& url);
 bool saveToCache(const QUrl& url, const QByteArray& file);
 
+// The disk cache url of a form derived from some content (baked, decoded...), keyed by the hash of
+// the content and of whatever else went into the derivation, so every url serving the same bytes shares it
+QUrl getDerivedCacheUrl(const QByteArray& hash, const QString& derivation);
+
 bool isValidFilePath(const AssetPath& path);
 bool isValidPath(const AssetPath& path);
 bool isValidHash(const QString& hashString);
@@ -11,6 +11,7 @@
 
 #include "LimitedNodeList.h"
 
+#include <algorithm>
 #include <cstring>
 #include <cstdlib>
 #include <cstdio>
@@ -18,6 +19,7 @@
 #include <QtCore/QDataStream>
 #include <QtCore/QDebug>
 #include <QtCore/QJsonDocument>
+#include <QtCore/QMutex>
 #include <QtCore/QThread>
 #include <QtCore/QUrl>
 #include <QtNetwork/QHostInfo>
@@ -37,6 +39,7 @@
 #include "HifiSockAddr.h"
 #include "NetworkLogging.h"
 #include "udt/Packet.h"
+#include "udt/PacketBufferPool.h"
 
 static Setting::Handle<quint16> LIMITED_NODELIST_LOCAL_PORT("LimitedNodeList.LocalPort", 0);
 
@@ -48,8 +51,6 @@ const std::set<NodeType_t> SOLO_NODE_TYPES = {
 
 LimitedNodeList::LimitedNodeList(int socketListenPort, int dtlsListenPort) :
     _sessionUUID(),
-    _nodeHash(),
-    _nodeMutex(QReadWriteLock::Recursive),
     _nodeSocket(this),
     _dtlsSocket(NULL),
     _localSockAddr(),
@@ -91,6 +92,10 @@ LimitedNodeList::LimitedNodeList(int socketListenPort, int dtlsListenPort) :
     connect(silentNodeTimer, &QTimer::timeout, this, &LimitedNodeList::removeSilentNodes);
     silentNodeTimer->start(NODE_SILENCE_THRESHOLD_MSECS);
 
+    // started once packet types are opted in to coalescing
+    _coalescedPacketsTimer = new QTimer(this);
+    connect(_coalescedPacketsTimer, &QTimer::timeout, this, &LimitedNodeList::flushCoalescedPackets);
+
     // check the local socket right now
     updateLocalSocket();
 
@@ -216,6 +221,10 @@ bool LimitedNodeList::packetVersionMatch(const udt::Packet& packet) {
         static QMultiHash<QUuid, PacketType> sourcedVersionDebugSuppressMap;
         static QMultiHash<HifiSockAddr, PacketType> versionDebugSuppressMap;
 
+        // packets can be verified from the socket receive threads as well
+        static QMutex versionDebugSuppressMutex;
+        QMutexLocker versionDebugSuppressLocker(&versionDebugSuppressMutex);
+
         bool hasBeenOutput = false;
         QString senderString;
         const HifiSockAddr& senderSockAddr = packet.getSenderSockAddr();
@@ -275,6 +284,8 @@ bool LimitedNodeList::packetSourceAndHashMatchAndTrackBandwidth(const udt::Packe
                 // check if the md5 hash in the header matches the hash we would expect
                 if (packetHeaderHash != expectedHash) {
                     static QMultiMap<QUuid, PacketType> hashDebugSuppressMap;
+                    static QMutex hashDebugSuppressMutex;
+                    QMutexLocker hashDebugSuppressLocker(&hashDebugSuppressMutex);
 
                     if (!hashDebugSuppressMap.contains(sourceID, headerType)) {
                         qCDebug(networking) << "Packet hash mismatch on" << headerType << "- Sender" << sourceID;
@@ -349,9 +360,81 @@ qint64 LimitedNodeList::sendUnreliablePacket(const NLPacket& packet, const HifiS
     collectPacketStats(packet);
     fillPacketHeader(packet, connectionSecret);
 
+    if (coalescePacket(packet, sockAddr)) {
+        return packet.getDataSize();
+    }
+
     return _nodeSocket.writePacket(packet, sockAddr);
 }
 
+// packets past this size gain little from sharing a datagram
+static const qint64 MAX_COALESCED_PACKET_SIZE = 256;
+
+bool LimitedNodeList::coalescePacket(const NLPacket& packet, const HifiSockAddr& sockAddr) {
+    if (!_hasCoalescedPacketTypes) {
+        return false;
+    }
+
+    // the udt header of a packed packet is left out, PacketReceiver puts an unreliable one back
+    qint64 packedSize = packet.getDataSize() - udt::Packet::totalHeaderSize();
+    if (packedSize > MAX_COALESCED_PACKET_SIZE) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(_coalescedPacketsMutex);
+
+    if (!_coalescedPacketTypes.contains(packet.getType())) {
+        return false;
+    }
+
+    auto& container = _coalescedPackets[sockAddr];
+
+    if (container && container->bytesAvailableForWrite() < (qint64)sizeof(quint16) + packedSize) {
+        _nodeSocket.writePacket(*container, sockAddr);
+        container.reset();
+    }
+
+    if (!container) {
+        container = NLPacket::create(PacketType::CoalescedPackets);
+    }
+
+    container->writePrimitive((quint16)packedSize);
+    container->write(packet.getData() + udt::Packet::totalHeaderSize(), packedSize);
+
+    return true;
+}
+
+void LimitedNodeList::flushCoalescedPackets() {
+    std::lock_guard<std::mutex> lock(_coalescedPacketsMutex);
+
+    for (auto& entry : _coalescedPackets) {
+        if (entry.second) {
+            _nodeSocket.writePacket(*entry.second, entry.first);
+        }
+    }
+
+    // destinations that went quiet are dropped here, active ones get a new container with their next packet
+    _coalescedPackets.clear();
+}
+
+void LimitedNodeList::setCoalescedPacketTypes(const QSet<PacketType>& packetTypes) {
+    {
+        std::lock_guard<std::mutex> lock(_coalescedPacketsMutex);
+        _coalescedPacketTypes = packetTypes;
+        _hasCoalescedPacketTypes = !packetTypes.isEmpty();
+    }
+
+    // send what is already packed, so nothing waits on a timer we might be about to stop
+    flushCoalescedPackets();
+
+    // this can be called from any thread, the timer lives on ours
+    if (packetTypes.isEmpty()) {
+        QMetaObject::invokeMethod(_coalescedPacketsTimer, "stop");
+    } else {
+        QMetaObject::invokeMethod(_coalescedPacketsTimer, "start", Q_ARG(int, COALESCED_PACKETS_FLUSH_INTERVAL_MSECS));
+    }
+}
+
 qint64 LimitedNodeList::sendPacket(std::unique_ptr<NLPacket> packet, const Node& destinationNode) {
     Q_ASSERT(!packet->isPartOfMessage());
     auto activeSocket = destinationNode.getActiveSocket();
@@ -489,34 +572,43 @@ NodeData* LimitedNodeList::getOrCreateLinkedData(SharedNodePointer node) {
     return node->getLinkedData();
 }
 
-SharedNodePointer LimitedNodeList::nodeWithUUID(const QUuid& nodeUUID) {
-    QReadLocker readLocker(&_nodeMutex);
+// returns where the node with this UUID is, or would be inserted, in a version of the node list
+static NodeVector::const_iterator lowerBoundForUUID(const NodeVector& nodes, const QUuid& nodeUUID) {
+    return std::lower_bound(nodes.cbegin(), nodes.cend(), nodeUUID,
+                            [](const SharedNodePointer& node, const QUuid& uuid) {
+        return node->getUUID() < uuid;
+    });
+}
+
+static SharedNodePointer findNodeWithUUID(const NodeVector& nodes, const QUuid& nodeUUID) {
+    auto it = lowerBoundForUUID(nodes, nodeUUID);
+    return (it != nodes.cend() && (*it)->getUUID() == nodeUUID) ? *it : SharedNodePointer();
+}
+
+void LimitedNodeList::setNodes(NodeVector nodes) {
+    std::atomic_store(&_nodes, ConstNodeVectorPointer(std::make_shared<NodeVector>(std::move(nodes))));
+}
 
-    NodeHash::const_iterator it = _nodeHash.find(nodeUUID);
-    return it == _nodeHash.cend() ? SharedNodePointer() : it->second;
- }
+SharedNodePointer LimitedNodeList::nodeWithUUID(const QUuid& nodeUUID) {
+    return findNodeWithUUID(*getNodes(), nodeUUID);
+}
 
 void LimitedNodeList::eraseAllNodes() {
-    QSet<SharedNodePointer> killedNodes;
+    ConstNodeVectorPointer killedNodes;
 
     {
-        // iterate the current nodes - grab them so we can emit that they are dying
-        // and then remove them from the hash
-        QWriteLocker writeLocker(&_nodeMutex);
+        // grab the current nodes so we can emit that they are dying, and publish an empty node list
+        QMutexLocker locker(&_nodeMutex);
 
-        if (_nodeHash.size() > 0) {
-            qCDebug(networking) << "LimitedNodeList::eraseAllNodes() removing all nodes from NodeList.";
-
-            auto it = _nodeHash.begin();
+        killedNodes = getNodes();
 
-            while (it != _nodeHash.end())  {
-                killedNodes.insert(it->second);
-                it = _nodeHash.unsafe_erase(it);
-            }
+        if (killedNodes->size() > 0) {
+            qCDebug(networking) << "LimitedNodeList::eraseAllNodes() removing all nodes from NodeList.";
+            setNodes(NodeVector());
         }
     }
 
-    foreach(const SharedNodePointer& killedNode, killedNodes) {
+    for (const auto& killedNode : *killedNodes) {
         handleNodeKill(killedNode);
     }
 }
@@ -529,24 +621,25 @@ void LimitedNodeList::reset() {
 }
 
 bool LimitedNodeList::killNodeWithUUID(const QUuid& nodeUUID) {
-    QReadLocker readLocker(&_nodeMutex);
+    SharedNodePointer matchingNode;
 
-    NodeHash::iterator it = _nodeHash.find(nodeUUID);
-    if (it != _nodeHash.end()) {
-        SharedNodePointer matchingNode = it->second;
+    {
+        QMutexLocker locker(&_nodeMutex);
 
-        readLocker.unlock();
+        NodeVector nodes = *getNodes();
+        auto it = lowerBoundForUUID(nodes, nodeUUID);
 
-        {
-            QWriteLocker writeLocker(&_nodeMutex);
-            _nodeHash.unsafe_erase(it);
+        if (it == nodes.cend() || (*it)->getUUID() != nodeUUID) {
+            return false;
         }
 
-        handleNodeKill(matchingNode);
-        return true;
+        matchingNode = *it;
+        nodes.erase(it);
+        setNodes(std::move(nodes));
     }
 
-    return false;
+    handleNodeKill(matchingNode);
+    return true;
 }
 
 void LimitedNodeList::processKillNode(ReceivedMessage& message) {
@@ -571,57 +664,69 @@ SharedNodePointer LimitedNodeList::addOrUpdateNode(const QUuid& uuid, NodeType_t
                                                    const HifiSockAddr& publicSocket, const HifiSockAddr& localSocket,
                                                    const NodePermissions& permissions,
                                                    const QUuid& connectionSecret) {
-    QReadLocker readLocker(&_nodeMutex);
-    NodeHash::const_iterator it = _nodeHash.find(uuid);
-
-    if (it != _nodeHash.end()) {
-        SharedNodePointer& matchingNode = it->second;
-        
+    auto updateMatchingNode = [&](const SharedNodePointer& matchingNode) {
         matchingNode->setPublicSocket(publicSocket);
         matchingNode->setLocalSocket(localSocket);
         matchingNode->setPermissions(permissions);
         matchingNode->setConnectionSecret(connectionSecret);
 
         return matchingNode;
+    };
+
+    SharedNodePointer matchingNode = nodeWithUUID(uuid);
+
+    if (matchingNode) {
+        return updateMatchingNode(matchingNode);
     } else {
-        // we didn't have this node, so add them
-        Node* newNode = new Node(uuid, nodeType, publicSocket, localSocket, permissions, connectionSecret, this);
+        SharedNodePointer newNodePointer;
+        SharedNodePointer oldSoloNode;
 
-        if (nodeType == NodeType::AudioMixer) {
-            LimitedNodeList::flagTimeForConnectionStep(LimitedNodeList::AddedAudioMixer);
-        }
+        {
+            QMutexLocker locker(&_nodeMutex);
 
-        SharedNodePointer newNodePointer(newNode, &QObject::deleteLater);
+            NodeVector nodes = *getNodes();
 
-        // if this is a solo node type, we assume that the DS has replaced its assignment and we should kill the previous node
-        if (SOLO_NODE_TYPES.count(newNode->getType())) {
-            // while we still have the read lock, see if there is a previous solo node we'll need to remove
-            auto previousSoloIt = std::find_if(_nodeHash.cbegin(), _nodeHash.cend(), [newNode](const UUIDNodePair& nodePair){
-                return nodePair.second->getType() == newNode->getType();
-            });
+            // someone else may have added this node since we looked without the lock
+            auto it = lowerBoundForUUID(nodes, uuid);
+            if (it != nodes.cend() && (*it)->getUUID() == uuid) {
+                matchingNode = *it;
+                locker.unlock();
 
-            if (previousSoloIt != _nodeHash.cend()) {
-                // we have a previous solo node, switch to a write lock so we can remove it
-                readLocker.unlock();
+                return updateMatchingNode(matchingNode);
+            }
 
-                QWriteLocker writeLocker(&_nodeMutex);
+            // we didn't have this node, so add them
+            Node* newNode = new Node(uuid, nodeType, publicSocket, localSocket, permissions, connectionSecret, this);
+            newNodePointer = SharedNodePointer(newNode, &QObject::deleteLater);
 
-                auto oldSoloNode = previousSoloIt->second;
+            // keep the new version sorted by UUID
+            nodes.insert(it, newNodePointer);
 
-                _nodeHash.unsafe_erase(previousSoloIt);
-                handleNodeKill(oldSoloNode);
+            // if this is a solo node type, we assume that the DS has replaced its assignment
+            // and we should kill the previous node
+            if (SOLO_NODE_TYPES.count(nodeType)) {
+                auto previousSoloIt = std::find_if(nodes.begin(), nodes.end(), [&](const SharedNodePointer& node) {
+                    return node->getType() == nodeType && node != newNodePointer;
+                });
 
-                // convert the current lock back to a read lock for insertion of new node
-                writeLocker.unlock();
-                readLocker.relock();
+                if (previousSoloIt != nodes.end()) {
+                    oldSoloNode = *previousSoloIt;
+                    nodes.erase(previousSoloIt);
+                }
             }
+
+            setNodes(std::move(nodes));
+        }
+
+        if (oldSoloNode) {
+            handleNodeKill(oldSoloNode);
         }
 
-        // insert the new node and release our read lock
-        _nodeHash.insert(UUIDNodePair(newNode->getUUID(), newNodePointer));
-        readLocker.unlock();
+        if (nodeType == NodeType::AudioMixer) {
+            LimitedNodeList::flagTimeForConnectionStep(LimitedNodeList::AddedAudioMixer);
+        }
 
-        qCDebug(networking) << "Added" << *newNode;
+        qCDebug(networking) << "Added" << *newNodePointer;
 
         emit nodeAdded(newNodePointer);
         if (newNodePointer->getActiveSocket()) {
@@ -721,34 +826,62 @@ void LimitedNodeList::getPacketStats(float& packetsPerSecond, float& bytesPerSec
     bytesPerSecond = (float) _numCollectedBytes / ((float) _packetStatTimer.elapsed() / 1000.0f);
 }
 
+void LimitedNodeList::getPacketPoolStats(quint64& poolHits, quint64& poolMisses) {
+    // the pool is shared by the whole process, report what happened to it since the last reset
+    poolHits = udt::PacketBufferPool::getNumHits() - _packetPoolHitsAtReset;
+    poolMisses = udt::PacketBufferPool::getNumMisses() - _packetPoolMissesAtReset;
+}
+
+void LimitedNodeList::setForwardErrorCorrectionPacketTypes(const QSet<PacketType>& packetTypes,
+                                                           int minGroupSize, int maxGroupSize) {
+    if (packetTypes.isEmpty()) {
+        _nodeSocket.setForwardErrorCorrectionFilter(udt::PacketFilterOperator());
+        return;
+    }
+
+    _nodeSocket.setForwardErrorCorrectionFilter([packetTypes](const udt::Packet& packet) {
+        return packetTypes.contains(NLPacket::typeInHeader(packet));
+    }, minGroupSize, maxGroupSize);
+}
+
 void LimitedNodeList::resetPacketStats() {
     _numCollectedPackets = 0;
     _numCollectedBytes = 0;
+    _packetPoolHitsAtReset = udt::PacketBufferPool::getNumHits();
+    _packetPoolMissesAtReset = udt::PacketBufferPool::getNumMisses();
     _packetStatTimer.restart();
 }
 
 void LimitedNodeList::removeSilentNodes() {
 
-    QSet<SharedNodePointer> killedNodes;
+    NodeVector killedNodes;
 
-    eachNodeHashIterator([&](NodeHash::iterator& it){
-        SharedNodePointer node = it->second;
-        node->getMutex().lock();
+    {
+        QMutexLocker locker(&_nodeMutex);
 
-        if ((usecTimestampNow() - node->getLastHeardMicrostamp()) > (NODE_SILENCE_THRESHOLD_MSECS * USECS_PER_MSEC)) {
-            // call the NodeHash erase to get rid of this node
-            it = _nodeHash.unsafe_erase(it);
+        auto currentNodes = getNodes();
+        NodeVector nodes;
+        nodes.reserve(currentNodes->size());
 
-            killedNodes.insert(node);
-        } else {
-            // we didn't erase this node, push the iterator forwards
-            ++it;
+        for (const auto& node : *currentNodes) {
+            node->getMutex().lock();
+
+            if ((usecTimestampNow() - node->getLastHeardMicrostamp()) > (NODE_SILENCE_THRESHOLD_MSECS * USECS_PER_MSEC)) {
+                // leave this node out of the next version of the node list
+                killedNodes.push_back(node);
+            } else {
+                nodes.push_back(node);
+            }
+
+            node->getMutex().unlock();
         }
 
-        node->getMutex().unlock();
-    });
+        if (!killedNodes.empty()) {
+            setNodes(std::move(nodes));
+        }
+    }
 
-    foreach(const SharedNodePointer& killedNode, killedNodes) {
+    for (const auto& killedNode : killedNodes) {
         handleNodeKill(killedNode);
     }
 }
@@ -1053,11 +1186,9 @@ void LimitedNodeList::sendPeerQueryToIceServer(const HifiSockAddr& iceServerSock
 }
 
 SharedNodePointer LimitedNodeList::findNodeWithAddr(const HifiSockAddr& addr) {
-    QReadLocker locker(&_nodeMutex);
-    auto it = std::find_if(std::begin(_nodeHash), std::end(_nodeHash), [&](const UUIDNodePair& pair) {
-        return pair.second->getActiveSocket() ? (*pair.second->getActiveSocket() == addr) : false;
+    return nodeMatchingPredicate([&](const SharedNodePointer& node) {
+        return node->getActiveSocket() ? (*node->getActiveSocket() == addr) : false;
     });
-    return (it != std::end(_nodeHash)) ? it->second : SharedNodePointer();
 }
 
 void LimitedNodeList::sendPacketToIceServer(PacketType packetType, const HifiSockAddr& iceServerSockAddr,
@@ -16,14 +16,17 @@
 #include <stdint.h>
 #include <iterator>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <unordered_map>
+#include <vector>
 
 #ifndef _WIN32
 #include <unistd.h> // not on windows, not needed for mac or windows
 #endif
 
 #include <QtCore/QElapsedTimer>
+#include <QtCore/QMutex>
 #include <QtCore/QPointer>
 #include <QtCore/QReadWriteLock>
 #include <QtCore/QSet>
@@ -31,8 +34,6 @@
 #include <QtNetwork/QUdpSocket>
 #include <QtNetwork/QHostAddress>
 
-#include <tbb/concurrent_unordered_map.h>
-
 #include <DependencyManager.h>
 
 #include "DomainHandler.h"
@@ -50,6 +51,8 @@ const int INVALID_PORT = -1;
 
 const quint64 NODE_SILENCE_THRESHOLD_MSECS = 5 * 1000;
 
+const int COALESCED_PACKETS_FLUSH_INTERVAL_MSECS = 10;
+
 extern const std::set<NodeType_t> SOLO_NODE_TYPES;
 
 const char DEFAULT_ASSIGNMENT_SERVER_HOSTNAME[] = "localhost";
@@ -64,10 +67,16 @@ const QString DOMAIN_SERVER_LOCAL_HTTPS_PORT_SMEM_KEY = "domain-server.local-htt
 const QHostAddress DEFAULT_ASSIGNMENT_CLIENT_MONITOR_HOSTNAME = QHostAddress::LocalHost;
 
 const QString USERNAME_UUID_REPLACEMENT_STATS_KEY = "$username";
+// the Histogram snapshots of the hot paths of a node, exported by the domain-server as summaries in its metrics
+const QString STATS_METRICS_KEY = "metrics";
+// the number of entities in each child octant of an entity server's jurisdiction, exported as gauges
+const QString STATS_JURISDICTION_LOAD_KEY = "jurisdiction_load";
 
 using namespace tbb;
-typedef std::pair<QUuid, SharedNodePointer> UUIDNodePair;
-typedef concurrent_unordered_map<QUuid, SharedNodePointer, UUIDHasher> NodeHash;
+
+// one published version of the node list, sorted by node UUID so that it always iterates in the same order
+typedef std::vector<SharedNodePointer> NodeVector;
+typedef std::shared_ptr<const NodeVector> ConstNodeVectorPointer;
 
 typedef quint8 PingType_t;
 namespace PingType {
@@ -138,7 +147,11 @@ public:
 
     std::function<void(Node*)> linkedDataCreateCallback;
 
-    size_t size() const { QReadLocker readLock(&_nodeMutex); return _nodeHash.size(); }
+    size_t size() const { return getNodes()->size(); }
+
+    // Returns the current version of the node list. It isn't changed by later node adds or kills, so a caller
+    // can hold on to it for a consistent view, or split it by index between threads.
+    ConstNodeVectorPointer getNodes() const { return std::atomic_load(&_nodes); }
 
     SharedNodePointer nodeWithUUID(const QUuid& nodeUUID);
 
@@ -163,6 +176,7 @@ public:
     SharedNodePointer soloNodeOfType(NodeType_t nodeType);
 
     void getPacketStats(float &packetsPerSecond, float &bytesPerSecond);
+    void getPacketPoolStats(quint64& poolHits, quint64& poolMisses);
     void resetPacketStats();
 
     std::unique_ptr<NLPacket> constructPingPacket(PingType_t pingType = PingType::Agnostic);
@@ -177,30 +191,30 @@ public:
     
     template<typename NodeLambda>
     void eachNode(NodeLambda functor) {
-        QReadLocker readLock(&_nodeMutex);
+        auto nodes = getNodes();
 
-        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
-            functor(it->second);
+        for (const auto& node : *nodes) {
+            functor(node);
         }
     }
 
     template<typename PredLambda, typename NodeLambda>
     void eachMatchingNode(PredLambda predicate, NodeLambda functor) {
-        QReadLocker readLock(&_nodeMutex);
+        auto nodes = getNodes();
 
-        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
-            if (predicate(it->second)) {
-                functor(it->second);
+        for (const auto& node : *nodes) {
+            if (predicate(node)) {
+                functor(node);
             }
         }
     }
 
     template<typename BreakableNodeLambda>
     void eachNodeBreakable(BreakableNodeLambda functor) {
-        QReadLocker readLock(&_nodeMutex);
+        auto nodes = getNodes();
 
-        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
-            if (!functor(it->second)) {
+        for (const auto& node : *nodes) {
+            if (!functor(node)) {
                 break;
             }
         }
@@ -208,11 +222,11 @@ public:
 
     template<typename PredLambda>
     SharedNodePointer nodeMatchingPredicate(const PredLambda predicate) {
-        QReadLocker readLock(&_nodeMutex);
+        auto nodes = getNodes();
 
-        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
-            if (predicate(it->second)) {
-                return it->second;
+        for (const auto& node : *nodes) {
+            if (predicate(node)) {
+                return node;
             }
         }
 
@@ -229,6 +243,20 @@ public:
     udt::Socket::StatsVector sampleStatsForAllConnections() { return _nodeSocket.sampleStatsForAllConnections(); }
 
     void setConnectionMaxBandwidth(int maxBandwidth) { _nodeSocket.setConnectionMaxBandwidth(maxBandwidth); }
+    void setNumReceiveThreads(int numThreads) { _nodeSocket.setNumReceiveThreads(numThreads); }
+    void setCongestionControlFactory(std::unique_ptr<udt::CongestionControlVirtualFactory> ccFactory)
+        { _nodeSocket.setCongestionControlFactory(std::move(ccFactory)); }
+
+    // opt-in forward error correction for the unreliable packets of these types, see udt/ForwardErrorCorrection.h
+    void setForwardErrorCorrectionPacketTypes(const QSet<PacketType>& packetTypes,
+                                              int minGroupSize = udt::FECEncoder::MIN_GROUP_SIZE,
+                                              int maxGroupSize = udt::FECEncoder::MAX_GROUP_SIZE);
+
+    // opt-in packing of the small unreliable packets of these types that go to the same socket into one datagram
+    // (PacketType::CoalescedPackets). Packed packets wait at most COALESCED_PACKETS_FLUSH_INTERVAL_MSECS, callers that
+    // send a burst of them can call flushCoalescedPackets once they are done.
+    void setCoalescedPacketTypes(const QSet<PacketType>& packetTypes);
+    void flushCoalescedPackets();
 
     void setPacketFilterOperator(udt::PacketFilterOperator filterOperator) { _nodeSocket.setPacketFilterOperator(filterOperator); }
     bool packetVersionMatch(const udt::Packet& packet);
@@ -294,6 +322,7 @@ protected:
                        const QUuid& connectionSecret = QUuid());
     void collectPacketStats(const NLPacket& packet);
     void fillPacketHeader(const NLPacket& packet, const QUuid& connectionSecret = QUuid());
+    bool coalescePacket(const NLPacket& packet, const HifiSockAddr& sockAddr);
 
     void setLocalSocket(const HifiSockAddr& sockAddr);
 
@@ -309,9 +338,15 @@ protected:
 
     bool sockAddrBelongsToNode(const HifiSockAddr& sockAddr) { return findNodeWithAddr(sockAddr) != SharedNodePointer(); }
 
+    // publishes a new version of the node list, the caller must hold _nodeMutex
+    void setNodes(NodeVector nodes);
+
     QUuid _sessionUUID;
-    NodeHash _nodeHash;
-    mutable QReadWriteLock _nodeMutex;
+
+    // readers never lock, they load the current version with getNodes. Adding or killing a node takes _nodeMutex,
+    // builds a new sorted vector and swaps it in.
+    ConstNodeVectorPointer _nodes { std::make_shared<NodeVector>() };
+    QMutex _nodeMutex;
     udt::Socket _nodeSocket;
     QUdpSocket* _dtlsSocket;
     HifiSockAddr _localSockAddr;
@@ -323,12 +358,20 @@ protected:
 
     std::atomic<int> _numCollectedPackets;
     std::atomic<int> _numCollectedBytes;
+    quint64 _packetPoolHitsAtReset { 0 };
+    quint64 _packetPoolMissesAtReset { 0 };
 
     QElapsedTimer _packetStatTimer;
     NodePermissions _permissions;
 
     QPointer<QTimer> _initialSTUNTimer;
 
+    std::mutex _coalescedPacketsMutex;
+    QSet<PacketType> _coalescedPacketTypes;
+    std::atomic<bool> _hasCoalescedPacketTypes { false };
+    QTimer* _coalescedPacketsTimer { nullptr };
+    std::unordered_map<HifiSockAddr, std::unique_ptr<NLPacket>> _coalescedPackets;
+
     int _numInitialSTUNRequests = 0;
     bool _hasCompletedInitialSTUN = false;
     quint64 _firstSTUNTime = 0;
@@ -338,16 +381,6 @@ protected:
     QMap<quint64, ConnectionStep> _lastConnectionTimes;
     bool _areConnectionTimesComplete = false;
 
-    template<typename IteratorLambda>
-    void eachNodeHashIterator(IteratorLambda functor) {
-        QWriteLocker writeLock(&_nodeMutex);
-        NodeHash::iterator it = _nodeHash.begin();
-
-        while (it != _nodeHash.end()) {
-            functor(it);
-        }
-    }
-    
 private slots:
     void flagTimeForConnectionStep(ConnectionStep connectionStep, quint64 timestamp);
     void possiblyTimeoutSTUNAddressLookup();
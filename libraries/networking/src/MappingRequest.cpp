@@ -92,12 +92,16 @@ void GetMappingRequest::doStart() {
     });
 };
 
-GetAllMappingsRequest::GetAllMappingsRequest() {
+GetAllMappingsRequest::GetAllMappingsRequest(const AssetPath& prefix, const AssetPath& startAfter, int limit) :
+    _prefix(prefix),
+    _startAfter(startAfter),
+    _limit(limit)
+{
 };
 
 void GetAllMappingsRequest::doStart() {
     auto assetClient = DependencyManager::get<AssetClient>();
-    _mappingRequestID = assetClient->getAllAssetMappings(
+    _mappingRequestID = assetClient->getAllAssetMappings(_prefix, _startAfter, _limit,
             [this, assetClient](bool responseReceived, AssetServerError error, QSharedPointer<ReceivedMessage> message) {
 
         _mappingRequestID = AssetClient::INVALID_MESSAGE_ID;
@@ -124,6 +128,10 @@ void GetAllMappingsRequest::doStart() {
                 auto hash = message->read(SHA256_HASH_LENGTH).toHex();
                 _mappings[path] = hash;
             }
+
+            uint8_t hasMore { 0 };
+            message->readPrimitive(&hasMore);
+            _hasMore = hasMore != 0;
         }
         emit finished(this);
     });
@@ -133,23 +141,36 @@ SetMappingRequest::SetMappingRequest(const AssetPath& path, const AssetHash& has
     _path(path.trimmed()),
     _hash(hash)
 {
+    _mappings[_path] = _hash;
+};
 
+SetMappingRequest::SetMappingRequest(const AssetMapping& mappings) {
+    for (auto& mapping : mappings) {
+        _mappings[mapping.first.trimmed()] = mapping.second;
+    }
+
+    if (!_mappings.empty()) {
+        _path = _mappings.begin()->first;
+        _hash = _mappings.begin()->second;
+    }
 };
 
 void SetMappingRequest::doStart() {
 
-    // short circuit the request if the hash or path are invalid
-    auto validPath = isValidFilePath(_path);
-    auto validHash = isValidHash(_hash);
-    if (!validPath || !validHash) {
-        _error = !validPath ? MappingRequest::InvalidPath : MappingRequest::InvalidHash;
-        emit finished(this);
-        return;
+    // short circuit the request if any hash or path is invalid
+    for (auto& mapping : _mappings) {
+        auto validPath = isValidFilePath(mapping.first);
+        auto validHash = isValidHash(mapping.second);
+        if (!validPath || !validHash) {
+            _error = !validPath ? MappingRequest::InvalidPath : MappingRequest::InvalidHash;
+            emit finished(this);
+            return;
+        }
     }
 
     auto assetClient = DependencyManager::get<AssetClient>();
 
-    _mappingRequestID = assetClient->setAssetMapping(_path, _hash,
+    _mappingRequestID = assetClient->setAssetMappings(_mappings,
             [this, assetClient](bool responseReceived, AssetServerError error, QSharedPointer<ReceivedMessage> message) {
 
         _mappingRequestID = AssetClient::INVALID_MESSAGE_ID;
@@ -68,7 +68,9 @@ class SetMappingRequest : public MappingRequest {
     Q_OBJECT
 public:
     SetMappingRequest(const AssetPath& path, const AssetHash& hash);
+    SetMappingRequest(const AssetMapping& mappings);
 
+    // The first of the mappings set by this request
     AssetPath getPath() const { return _path;  }
     AssetHash getHash() const { return _hash;  }
 
@@ -80,6 +82,7 @@ private:
 
     AssetPath _path;
     AssetHash _hash;
+    AssetMapping _mappings;
 };
 
 class DeleteMappingsRequest : public MappingRequest {
@@ -114,17 +117,25 @@ private:
 class GetAllMappingsRequest : public MappingRequest {
     Q_OBJECT
 public:
-    GetAllMappingsRequest();
+    GetAllMappingsRequest(const AssetPath& prefix = AssetPath(), const AssetPath& startAfter = AssetPath(), int limit = 0);
 
     AssetMapping getMappings() const { return _mappings;  }
 
+    // True if the limit cut the mappings short, the next page starts after the last of these mappings
+    bool hasMore() const { return _hasMore; }
+
 signals:
     void finished(GetAllMappingsRequest* thisRequest);
 
 private:
     virtual void doStart() override;
-    
+
+    AssetPath _prefix;
+    AssetPath _startAfter;
+    int _limit { 0 };
+
     std::map<AssetPath, AssetHash> _mappings;
+    bool _hasMore { false };
 };
 
 
@@ -234,6 +234,9 @@ void NodeList::reset() {
 
     _numNoReplyDomainCheckIns = 0;
 
+    // ask the next domain-server for its full list
+    _domainListVersion = 0;
+
     // lock and clear our set of ignored IDs
     _ignoredSetLock.lockForWrite();
     _ignoredNodeIDs.clear();
@@ -362,6 +365,9 @@ void NodeList::sendDomainServerCheckIn() {
                 const QByteArray& usernameSignature = accountManager->getAccountInfo().getUsernameSignature(connectionToken);
                 packetStream << usernameSignature;
             }
+        } else {
+            // tell the domain-server which version of the list we have, so it only sends what changed since
+            packetStream << _domainListVersion;
         }
 
         flagTimeForConnectionStep(LimitedNodeList::ConnectionStep::SendDSCheckIn);
@@ -582,9 +588,21 @@ void NodeList::processDomainServerList(QSharedPointer<ReceivedMessage> message)
     packetStream >> newPermissions;
     setPermissions(newPermissions);
 
+    // a delta only holds the nodes that were added, updated or removed since the version we checked in with
+    packetStream >> _domainListVersion;
+
     // pull each node in the packet
     while (packetStream.device()->pos() < message->getSize()) {
-        parseNodeFromPacketStream(packetStream);
+        bool isRemoved;
+        packetStream >> isRemoved;
+
+        if (isRemoved) {
+            QUuid nodeUUID;
+            packetStream >> nodeUUID;
+            killNodeWithUUID(nodeUUID);
+        } else {
+            parseNodeFromPacketStream(packetStream);
+        }
     }
 }
 
@@ -12,6 +12,8 @@
 
 #include "PacketReceiver.h"
 
+#include <cstring>
+
 #include <QMutexLocker>
 
 #include "DependencyManager.h"
@@ -23,6 +25,9 @@ PacketReceiver::PacketReceiver(QObject* parent) : QObject(parent) {
     qRegisterMetaType<QSharedPointer<NLPacket>>();
     qRegisterMetaType<QSharedPointer<NLPacketList>>();
     qRegisterMetaType<QSharedPointer<ReceivedMessage>>();
+
+    _listenerTables.emplace_back(new ListenerTable((size_t) PacketType::LAST_PACKET_TYPE + 1));
+    _listenerTable = _listenerTables.back().get();
 }
 
 bool PacketReceiver::registerListenerForTypes(PacketTypeList types, QObject* listener, const char* slot) {
@@ -72,10 +77,8 @@ void PacketReceiver::registerDirectListener(PacketType type, QObject* listener,
     
     bool success = registerListener(type, listener, slot);
     if (success) {
-        QMutexLocker locker(&_directConnectSetMutex);
-        
-        // if we successfully registered, add this object to the set of objects that are directly connected
-        _directlyConnectedObjects.insert(listener);
+        // if we successfully registered, mark the registrations of this object as directly connected
+        markDirectListener(listener);
     }
 }
 
@@ -87,13 +90,54 @@ void PacketReceiver::registerDirectListenerForTypes(PacketTypeList types,
     // just call register listener for types to start
     bool success = registerListenerForTypes(std::move(types), listener, slot);
     if (success) {
-        QMutexLocker locker(&_directConnectSetMutex);
-        
-        // if we successfully registered, add this object to the set of objects that are directly connected
-        _directlyConnectedObjects.insert(listener);
+        // if we successfully registered, mark the registrations of this object as directly connected
+        markDirectListener(listener);
     }
 }
 
+void PacketReceiver::markDirectListener(QObject* listener) {
+    updateListenerTable([listener](ListenerTable& table) {
+        for (auto& entry : table) {
+            if (entry.object == listener) {
+                entry.isDirect = true;
+            }
+        }
+    });
+}
+
+bool PacketReceiver::registerDirectHandler(PacketType type, QObject* owner, ListenerHandler handler,
+                                           bool deliverPending) {
+    Q_ASSERT_X(owner, "PacketReceiver::registerDirectHandler", "No owner to register");
+    Q_ASSERT_X(handler, "PacketReceiver::registerDirectHandler", "No handler to register");
+
+    if (!owner || !handler) {
+        qCWarning(networking) << "FAILED to Register a direct packet handler for packet type" << type;
+        return false;
+    }
+
+    qCDebug(networking) << "Registering a direct packet handler for packet type" << type;
+
+    Listener listener;
+    listener.object = owner;
+    listener.handler = std::move(handler);
+    listener.deliverPending = deliverPending;
+    listener.isDirect = true;
+    registerVerifiedListener(type, std::move(listener));
+    return true;
+}
+
+bool PacketReceiver::registerDirectHandlerForTypes(const PacketTypeList& types, QObject* owner,
+                                                   ListenerHandler handler) {
+    Q_ASSERT_X(!types.empty(), "PacketReceiver::registerDirectHandlerForTypes", "No types to register");
+
+    for (auto type : types) {
+        if (!registerDirectHandler(type, owner, handler)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 bool PacketReceiver::registerListener(PacketType type, QObject* listener, const char* slot,
                                              bool deliverPending) {
     Q_ASSERT_X(listener, "PacketReceiver::registerListener", "No object to register");
@@ -167,37 +211,51 @@ QMetaMethod PacketReceiver::matchingMethodForListener(PacketType type, QObject*
 
 void PacketReceiver::registerVerifiedListener(PacketType type, QObject* object, const QMetaMethod& slot, bool deliverPending) {
     Q_ASSERT_X(object, "PacketReceiver::registerVerifiedListener", "No object to register");
-    QMutexLocker locker(&_packetListenerLock);
 
-    if (_messageListenerMap.contains(type)) {
-        qCWarning(networking) << "Registering a packet listener for packet type" << type
-            << "that will remove a previously registered listener";
-    }
-    
-    // add the mapping
-    _messageListenerMap[type] = { QPointer<QObject>(object), slot, deliverPending };
+    Listener listener;
+    listener.object = object;
+    listener.method = slot;
+    listener.deliverPending = deliverPending;
+    registerVerifiedListener(type, std::move(listener));
+}
+
+void PacketReceiver::registerVerifiedListener(PacketType type, Listener listener) {
+    listener.isRegistered = true;
+
+    updateListenerTable([type, &listener](ListenerTable& table) {
+        Listener& entry = table[(size_t) type];
+
+        if (entry.isRegistered && (entry.method.isValid() || entry.handler)) {
+            qCWarning(networking) << "Registering a packet listener for packet type" << type
+                << "that will remove a previously registered listener";
+        }
+
+        // add the mapping
+        entry = std::move(listener);
+    });
+}
+
+void PacketReceiver::updateListenerTable(std::function<void(ListenerTable&)> update) {
+    QMutexLocker locker(&_listenerTableLock);
+
+    std::unique_ptr<ListenerTable> table { new ListenerTable(*_listenerTable.load()) };
+    update(*table);
+
+    _listenerTable.store(table.get(), std::memory_order_release);
+    _listenerTables.push_back(std::move(table));
 }
 
 void PacketReceiver::unregisterListener(QObject* listener) {
     Q_ASSERT_X(listener, "PacketReceiver::unregisterListener", "No listener to unregister");
     
-    {
-        QMutexLocker packetListenerLocker(&_packetListenerLock);
-        
-        // clear any registrations for this listener in _messageListenerMap
-        auto it = _messageListenerMap.begin();
-        
-        while (it != _messageListenerMap.end()) {
-            if (it.value().object == listener) {
-                it = _messageListenerMap.erase(it);
-            } else {
-                ++it;
+    // clear any registrations for this listener in the listener table
+    updateListenerTable([listener](ListenerTable& table) {
+        for (auto& entry : table) {
+            if (entry.object == listener) {
+                entry = Listener();
             }
         }
-    }
-    
-    QMutexLocker directConnectSetLocker(&_directConnectSetMutex);
-    _directlyConnectedObjects.remove(listener);
+    });
 }
 
 void PacketReceiver::handleVerifiedPacket(std::unique_ptr<udt::Packet> packet) {
@@ -210,14 +268,57 @@ void PacketReceiver::handleVerifiedPacket(std::unique_ptr<udt::Packet> packet) {
     
     // setup an NLPacket from the packet we were passed
     auto nlPacket = NLPacket::fromBase(std::move(packet));
-    auto receivedMessage = QSharedPointer<ReceivedMessage>::create(*nlPacket);
+
+    if (nlPacket->getType() == PacketType::CoalescedPackets) {
+        // the packets inside are counted as they come back through here
+        handleCoalescedPacket(*nlPacket);
+        return;
+    }
 
     _inPacketCount += 1;
     _inByteCount += nlPacket->size();
 
+    auto receivedMessage = QSharedPointer<ReceivedMessage>::create(*nlPacket);
     handleVerifiedMessage(receivedMessage, true);
 }
 
+void PacketReceiver::handleCoalescedPacket(const NLPacket& packet) {
+    // see LimitedNodeList::coalescePacket - the payload is a run of [size (2 bytes)][packet without its udt header]
+    auto nodeList = DependencyManager::get<LimitedNodeList>();
+    const int udtHeaderSize = udt::Packet::totalHeaderSize();
+
+    const char* data = packet.getPayload();
+    const char* end = data + packet.getPayloadSize();
+
+    while (end - data >= (qint64)sizeof(quint16)) {
+        quint16 packedSize;
+        memcpy(&packedSize, data, sizeof(packedSize));
+        data += sizeof(packedSize);
+
+        if (packedSize > end - data) {
+            qCDebug(networking) << "Dropping the rest of a truncated" << PacketType::CoalescedPackets << "packet from"
+                << packet.getSenderSockAddr();
+            return;
+        }
+
+        // an all-zero udt header reads as an unreliable packet that is not part of a message
+        int size = udtHeaderSize + packedSize;
+        std::unique_ptr<char[]> buffer(new char[size]);
+        memset(buffer.get(), 0, udtHeaderSize);
+        memcpy(buffer.get() + udtHeaderSize, data, packedSize);
+        data += packedSize;
+
+        auto innerPacket = udt::Packet::fromReceivedPacket(std::move(buffer), size, packet.getSenderSockAddr());
+        innerPacket->setReceiveTime(packet.getReceiveTime());
+
+        // every packed packet carries its own source and hash, and containers are not nested
+        if (NLPacket::typeInHeader(*innerPacket) != PacketType::CoalescedPackets
+            && nodeList->isPacketVerified(*innerPacket)) {
+            handleVerifiedPacket(std::move(innerPacket));
+        }
+    }
+}
+
 void PacketReceiver::handleVerifiedMessagePacket(std::unique_ptr<udt::Packet> packet) {
     auto nlPacket = NLPacket::fromBase(std::move(packet));
 
@@ -265,101 +366,112 @@ void PacketReceiver::handleVerifiedMessage(QSharedPointer<ReceivedMessage> recei
         matchingNode = nodeList->nodeWithUUID(receivedMessage->getSourceID());
     }
     
-    QMutexLocker packetListenerLocker(&_packetListenerLock);
+    PacketType packetType = receivedMessage->getType();
+    const ListenerTable& table = *_listenerTable.load(std::memory_order_acquire);
+    
+    if ((size_t) packetType >= table.size() || !table[(size_t) packetType].isRegistered) {
+        qCWarning(networking) << "No listener found for packet type" << packetType;
+        
+        // insert a dummy listener so we don't print this again
+        if ((size_t) packetType < table.size()) {
+            updateListenerTable([packetType](ListenerTable& table) {
+                table[(size_t) packetType].isRegistered = true;
+            });
+        }
+        return;
+    }
+    
+    const Listener& listener = table[(size_t) packetType];
+    
+    if (!listener.method.isValid() && !listener.handler) {
+        // this is the dummy listener for a type nothing listens to
+        return;
+    }
+    
+    if ((listener.deliverPending && !justReceived) || (!listener.deliverPending && !receivedMessage->isComplete())) {
+        return;
+    }
     
     bool listenerIsDead = false;
     
-    auto it = _messageListenerMap.find(receivedMessage->getType());
-            
-    if (it != _messageListenerMap.end() && it->method.isValid()) {
-         
-        auto listener = it.value();
-
-        if ((listener.deliverPending && !justReceived) || (!listener.deliverPending && !receivedMessage->isComplete())) {
-            return;
+    if (listener.object) {
+        
+        bool success = false;
+        
+        if (matchingNode) {
+            matchingNode->recordBytesReceived(receivedMessage->getSize());
         }
-    
-        if (listener.object) {
-            
-            bool success = false;
-
-            Qt::ConnectionType connectionType;
-            // check if this is a directly connected listener
-            {
-                QMutexLocker directConnectLocker(&_directConnectSetMutex);
- 
-                connectionType = _directlyConnectedObjects.contains(listener.object) ? Qt::DirectConnection : Qt::AutoConnection;
+        
+        if (listener.handler) {
+            // direct handlers skip the meta-object system entirely, and always expect the node of a sourced packet
+            if (matchingNode || NON_SOURCED_PACKETS.contains(packetType)) {
+                listener.handler(receivedMessage, matchingNode);
             }
+            return;
+        }
+        
+        // check if this is a directly connected listener
+        Qt::ConnectionType connectionType = listener.isDirect ? Qt::DirectConnection : Qt::AutoConnection;
+        
+        if (matchingNode) {
+            QMetaMethod metaMethod = listener.method;
             
-            PacketType packetType = receivedMessage->getType();
+            static const QByteArray QSHAREDPOINTER_NODE_NORMALIZED = QMetaObject::normalizedType("QSharedPointer<Node>");
+            static const QByteArray SHARED_NODE_NORMALIZED = QMetaObject::normalizedType("SharedNodePointer");
             
-            if (matchingNode) {
-                matchingNode->recordBytesReceived(receivedMessage->getSize());
-
-                QMetaMethod metaMethod = listener.method;
-                
-                static const QByteArray QSHAREDPOINTER_NODE_NORMALIZED = QMetaObject::normalizedType("QSharedPointer<Node>");
-                static const QByteArray SHARED_NODE_NORMALIZED = QMetaObject::normalizedType("SharedNodePointer");
-                
-                // one final check on the QPointer before we go to invoke
-                if (listener.object) {
-                    if (metaMethod.parameterTypes().contains(SHARED_NODE_NORMALIZED)) {
-                        success = metaMethod.invoke(listener.object,
-                                                    connectionType,
-                                                    Q_ARG(QSharedPointer<ReceivedMessage>, receivedMessage),
-                                                    Q_ARG(SharedNodePointer, matchingNode));
-                        
-                    } else if (metaMethod.parameterTypes().contains(QSHAREDPOINTER_NODE_NORMALIZED)) {
-                        success = metaMethod.invoke(listener.object,
-                                                    connectionType,
-                                                    Q_ARG(QSharedPointer<ReceivedMessage>, receivedMessage),
-                                                    Q_ARG(QSharedPointer<Node>, matchingNode));
-                        
-                    } else {
-                        success = metaMethod.invoke(listener.object,
-                                                    connectionType,
-                                                    Q_ARG(QSharedPointer<ReceivedMessage>, receivedMessage));
-                    }
+            // one final check on the QPointer before we go to invoke
+            if (listener.object) {
+                if (metaMethod.parameterTypes().contains(SHARED_NODE_NORMALIZED)) {
+                    success = metaMethod.invoke(listener.object,
+                                                connectionType,
+                                                Q_ARG(QSharedPointer<ReceivedMessage>, receivedMessage),
+                                                Q_ARG(SharedNodePointer, matchingNode));
+                    
+                } else if (metaMethod.parameterTypes().contains(QSHAREDPOINTER_NODE_NORMALIZED)) {
+                    success = metaMethod.invoke(listener.object,
+                                                connectionType,
+                                                Q_ARG(QSharedPointer<ReceivedMessage>, receivedMessage),
+                                                Q_ARG(QSharedPointer<Node>, matchingNode));
+                    
                 } else {
-                    listenerIsDead = true;
+                    success = metaMethod.invoke(listener.object,
+                                                connectionType,
+                                                Q_ARG(QSharedPointer<ReceivedMessage>, receivedMessage));
                 }
             } else {
-                // qDebug() << "Got verified unsourced packet list: " << QString(nlPacketList->getMessage());
-                
-                // one final check on the QPointer before we invoke
-                if (listener.object) {
-                    success = listener.method.invoke(listener.object,
-                                                     Q_ARG(QSharedPointer<ReceivedMessage>, receivedMessage));
-                } else {
-                    listenerIsDead = true;
-                }
-                
+                listenerIsDead = true;
             }
+        } else {
+            // qDebug() << "Got verified unsourced packet list: " << QString(nlPacketList->getMessage());
             
-            if (!success) {
-                qCDebug(networking).nospace() << "Error delivering packet " << packetType << " to listener "
-                    << listener.object << "::" << qPrintable(listener.method.methodSignature());
+            // one final check on the QPointer before we invoke
+            if (listener.object) {
+                success = listener.method.invoke(listener.object,
+                                                 Q_ARG(QSharedPointer<ReceivedMessage>, receivedMessage));
+            } else {
+                listenerIsDead = true;
             }
             
-        } else {
-            listenerIsDead = true;
         }
         
-        if (listenerIsDead) {
-            qCDebug(networking).nospace() << "Listener for packet " << receivedMessage->getType()
-                << " has been destroyed. Removing from listener map.";
-            it = _messageListenerMap.erase(it);
-            
-            // if it exists, remove the listener from _directlyConnectedObjects
-            {
-                QMutexLocker directConnectLocker(&_directConnectSetMutex);
-                _directlyConnectedObjects.remove(listener.object);
-            }
+        if (!success) {
+            qCDebug(networking).nospace() << "Error delivering packet " << packetType << " to listener "
+                << listener.object << "::" << qPrintable(listener.method.methodSignature());
         }
-    } else if (it == _messageListenerMap.end()) {
-        qCWarning(networking) << "No listener found for packet type" << receivedMessage->getType();
         
-        // insert a dummy listener so we don't print this again
-        _messageListenerMap.insert(receivedMessage->getType(), { nullptr, QMetaMethod(), false });
+    } else {
+        listenerIsDead = true;
+    }
+    
+    if (listenerIsDead) {
+        qCDebug(networking).nospace() << "Listener for packet " << packetType
+            << " has been destroyed. Removing from listener table.";
+        
+        updateListenerTable([packetType](ListenerTable& table) {
+            // another packet may have beaten us to it, only remove a registration whose object is still gone
+            if (!table[(size_t) packetType].object) {
+                table[(size_t) packetType] = Listener();
+            }
+        });
     }
 }
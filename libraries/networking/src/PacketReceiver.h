@@ -13,6 +13,9 @@
 #ifndef hifi_PacketReceiver_h
 #define hifi_PacketReceiver_h
 
+#include <atomic>
+#include <functional>
+#include <memory>
 #include <vector>
 #include <unordered_map>
 
@@ -25,6 +28,7 @@
 
 #include "NLPacket.h"
 #include "NLPacketList.h"
+#include "Node.h"
 #include "ReceivedMessage.h"
 #include "udt/PacketHeaders.h"
 
@@ -44,6 +48,7 @@ class PacketReceiver : public QObject {
     Q_OBJECT
 public:
     using PacketTypeList = std::vector<PacketType>;
+    using ListenerHandler = std::function<void(QSharedPointer<ReceivedMessage>, SharedNodePointer)>;
     
     PacketReceiver(QObject* parent = 0);
     PacketReceiver(const PacketReceiver&) = delete;
@@ -63,6 +68,23 @@ public:
     bool registerListener(PacketType type, QObject* listener, const char* slot, bool deliverPending = false);
     bool registerListenerForTypes(PacketTypeList types, QObject* listener, const char* slot);
     void unregisterListener(QObject* listener);
+
+    // Registers a handler that is called straight from the thread that verified the packet, skipping the Qt
+    // meta-object system. The handler must be safe to call from that thread. It is dropped once owner is destroyed,
+    // or when owner is passed to unregisterListener. The node is null for non-sourced packet types, sourced packets
+    // from a node we don't know are not delivered.
+    bool registerDirectHandler(PacketType type, QObject* owner, ListenerHandler handler, bool deliverPending = false);
+    bool registerDirectHandlerForTypes(const PacketTypeList& types, QObject* owner, ListenerHandler handler);
+
+    template<typename T>
+    bool registerDirectHandler(PacketType type, T* owner,
+                               void (T::*method)(QSharedPointer<ReceivedMessage>, SharedNodePointer),
+                               bool deliverPending = false) {
+        return registerDirectHandler(type, owner, [owner, method](QSharedPointer<ReceivedMessage> message,
+                                                                  SharedNodePointer node) {
+            (owner->*method)(message, node);
+        }, deliverPending);
+    }
     
     void handleVerifiedPacket(std::unique_ptr<udt::Packet> packet);
     void handleVerifiedMessagePacket(std::unique_ptr<udt::Packet> message);
@@ -72,10 +94,17 @@ private:
     struct Listener {
         QPointer<QObject> object;
         QMetaMethod method;
-        bool deliverPending;
+        ListenerHandler handler;
+        bool deliverPending { false };
+        bool isDirect { false };
+        bool isRegistered { false }; // false for types nothing was ever registered for
     };
 
+    // indexed by packet type, and never modified once it has been published to _listenerTable
+    using ListenerTable = std::vector<Listener>;
+
     void handleVerifiedMessage(QSharedPointer<ReceivedMessage> message, bool justReceived);
+    void handleCoalescedPacket(const NLPacket& packet);
 
     // these are brutal hacks for now - ideally GenericThread / ReceivedPacketProcessor
     // should be changed to have a true event loop and be able to handle our QMetaMethod::invoke
@@ -84,14 +113,21 @@ private:
 
     QMetaMethod matchingMethodForListener(PacketType type, QObject* object, const char* slot) const;
     void registerVerifiedListener(PacketType type, QObject* listener, const QMetaMethod& slot, bool deliverPending = false);
-
-    QMutex _packetListenerLock;
-    QHash<PacketType, Listener> _messageListenerMap;
-    int _inPacketCount = 0;
-    int _inByteCount = 0;
+    void registerVerifiedListener(PacketType type, Listener listener);
+    void markDirectListener(QObject* listener);
+    void updateListenerTable(std::function<void(ListenerTable&)> update);
+
+    // handleVerifiedMessage reads the current table without locking. Registration is rare, so it copies the table,
+    // changes the copy and swaps it in. Replaced tables stay alive with the receiver, since a packet might still be
+    // dispatching from one of them.
+    std::atomic<const ListenerTable*> _listenerTable { nullptr };
+    QMutex _listenerTableLock;
+    std::vector<std::unique_ptr<ListenerTable>> _listenerTables;
+
+    // counted from every thread that hands us packets
+    std::atomic<int> _inPacketCount { 0 };
+    std::atomic<int> _inByteCount { 0 };
     bool _shouldDropPackets = false;
-    QMutex _directConnectSetMutex;
-    QSet<QObject*> _directlyConnectedObjects;
 
     std::unordered_map<std::pair<HifiSockAddr, udt::Packet::MessageNumber>, QSharedPointer<ReceivedMessage>> _pendingMessages;
     
@@ -22,6 +22,7 @@ static const int HEAD_DATA_SIZE = 512;
 ReceivedMessage::ReceivedMessage(const NLPacketList& packetList)
     : _data(packetList.getMessage()),
       _headData(_data.mid(0, HEAD_DATA_SIZE)),
+      _receivedSize(_data.size()),
       _numPackets(packetList.getNumPackets()),
       _sourceID(packetList.getSourceID()),
       _packetType(packetList.getType()),
@@ -34,6 +35,7 @@ ReceivedMessage::ReceivedMessage(const NLPacketList& packetList)
 ReceivedMessage::ReceivedMessage(NLPacket& packet)
     : _data(packet.readAll()),
       _headData(_data.mid(0, HEAD_DATA_SIZE)),
+      _receivedSize(_data.size()),
       _numPackets(1),
       _sourceID(packet.getSourceID()),
       _packetType(packet.getType()),
@@ -58,10 +60,18 @@ void ReceivedMessage::appendPacket(NLPacket& packet) {
 
     ++_numPackets;
 
-    _data.append(packet.getPayload(), packet.getPayloadSize());
+    {
+        std::lock_guard<std::mutex> lock(_appendMutex);
+        if (_sink) {
+            _sink(packet.getPayload(), packet.getPayloadSize());
+        } else {
+            _data.append(packet.getPayload(), packet.getPayloadSize());
+        }
+        _receivedSize += packet.getPayloadSize();
+    }
 
     if (_numPackets % EMIT_PROGRESS_EVERY_X_PACKETS == 0) {
-        emit progress(getSize());
+        emit progress(getReceivedSize());
     }
 
     if (packet.getPacketPosition() == NLPacket::PacketPosition::LAST) {
@@ -70,6 +80,28 @@ void ReceivedMessage::appendPacket(NLPacket& packet) {
     }
 }
 
+void ReceivedMessage::reserve(qint64 size) {
+    // the size comes from the sender, so don't trust it with more than this up front
+    const qint64 MAX_RESERVED_SIZE = 256 * 1024 * 1024;
+    size = std::min(size, MAX_RESERVED_SIZE);
+
+    std::lock_guard<std::mutex> lock(_appendMutex);
+    if (!_sink && size > _data.size()) {
+        _data.reserve((int)size);
+    }
+}
+
+void ReceivedMessage::setSink(Sink sink) {
+    std::lock_guard<std::mutex> lock(_appendMutex);
+    _sink = sink;
+    if (_sink) {
+        if (_data.size() > _position) {
+            _sink(_data.constData() + _position, _data.size() - _position);
+        }
+        _data = QByteArray();
+    }
+}
+
 qint64 ReceivedMessage::peek(char* data, qint64 size) {
     memcpy(data, _data.constData() + _position, size);
     return size;
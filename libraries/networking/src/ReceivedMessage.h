@@ -15,7 +15,10 @@
 #include <QByteArray>
 #include <QObject>
 
+#include <algorithm>
 #include <atomic>
+#include <functional>
+#include <mutex>
 
 #include "NLPacketList.h"
 
@@ -35,6 +38,15 @@ public:
 
     void appendPacket(NLPacket& packet);
 
+    // Makes room for the whole message when its size is known ahead, so the packets still to come don't grow it
+    void reserve(qint64 size);
+
+    // Hands the payload of the packets still to come to sink, on the thread receiving them, instead of keeping it.
+    // What was received past the current position is handed over first. For messages too large to hold, such as
+    // ones written to a file as they come. Only the head of the message can be read afterwards.
+    using Sink = std::function<void(const char* data, qint64 size)>;
+    void setSink(Sink sink);
+
     bool failed() const { return _failed; }
     bool isComplete() const { return _isComplete; }
 
@@ -48,7 +60,10 @@ public:
 
     qint64 getSize() const { return _data.size(); }
 
-    qint64 getBytesLeftToRead() const { return _data.size() -  _position; }
+    // The bytes received so far, including those handed to a sink
+    qint64 getReceivedSize() const { return _receivedSize; }
+
+    qint64 getBytesLeftToRead() const { return std::max<qint64>(_data.size() - _position, 0); }
 
     void seek(qint64 position) { _position = position; }
 
@@ -88,6 +103,10 @@ private:
     QByteArray _data;
     QByteArray _headData;
 
+    std::mutex _appendMutex; // between the packets appended and the reserve() or setSink() of another thread
+    Sink _sink;
+    std::atomic<qint64> _receivedSize { 0 };
+
     std::atomic<qint64> _position { 0 };
     std::atomic<qint64> _numPackets { 0 };
 
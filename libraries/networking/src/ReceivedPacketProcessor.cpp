@@ -70,6 +70,8 @@ bool ReceivedPacketProcessor::process() {
     currentPackets.swap(_packets);
     unlock();
 
+    preProcessPackets(currentPackets);
+
     for(auto& packetPair : currentPackets) {
         processPacket(packetPair.second, packetPair.first);
         _lastWindowProcessedPackets++;
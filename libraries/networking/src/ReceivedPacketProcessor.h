@@ -69,6 +69,9 @@ protected:
     /// Override to do work before the packets processing loop. Default does nothing.
     virtual void preProcess() { }
 
+    /// Override to do work on all of the packets of a processing loop before any of them is processed. Default does nothing.
+    virtual void preProcessPackets(const std::list<NodeSharedReceivedMessagePair>& packets) { }
+
     /// Override to do work inside the packet processing loop after a packet is processed. Default does nothing.
     virtual void midProcess() { }
 
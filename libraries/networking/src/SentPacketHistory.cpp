@@ -25,6 +25,10 @@ SentPacketHistory::SentPacketHistory(int size)
 }
 
 void SentPacketHistory::packetSent(uint16_t sequenceNumber, const NLPacket& packet) {
+    packetSent(sequenceNumber, NLPacket::createCopy(packet));
+}
+
+std::unique_ptr<NLPacket> SentPacketHistory::packetSent(uint16_t sequenceNumber, std::unique_ptr<NLPacket> packet) {
 
     // check if given seq number has the expected value.  if not, something's wrong with
     // the code calling this function
@@ -36,7 +40,8 @@ void SentPacketHistory::packetSent(uint16_t sequenceNumber, const NLPacket& pack
     _newestSequenceNumber = sequenceNumber;
 
     QWriteLocker locker(&_packetsLock);
-    _sentPackets.insert(NLPacket::createCopy(packet));
+    _sentPackets.swapInsert(packet);
+    return packet;
 }
 
 const NLPacket* SentPacketHistory::getPacket(uint16_t sequenceNumber) const {
@@ -28,6 +28,11 @@ public:
     SentPacketHistory(int size = MAX_REASONABLE_SEQUENCE_GAP);
 
     void packetSent(uint16_t sequenceNumber, const NLPacket& packet);
+
+    // keeps the sent packet itself rather than a copy, and returns the packet that fell out of the history (or nullptr)
+    // so that the sender can write its next packet in it
+    std::unique_ptr<NLPacket> packetSent(uint16_t sequenceNumber, std::unique_ptr<NLPacket> packet);
+
     const NLPacket* getPacket(uint16_t sequenceNumber) const;
 
 private:
@@ -18,6 +18,8 @@
 
 #include "ThreadedAssignment.h"
 
+#include "udt/SendQueue.h"
+
 ThreadedAssignment::ThreadedAssignment(ReceivedMessage& message) :
     Assignment(message),
     _isFinished(false),
@@ -92,10 +94,21 @@ void ThreadedAssignment::addPacketStatsAndSendStatsPacket(QJsonObject statsObjec
 
     float packetsPerSecond, bytesPerSecond;
     nodeList->getPacketStats(packetsPerSecond, bytesPerSecond);
+
+    quint64 packetPoolHits, packetPoolMisses;
+    nodeList->getPacketPoolStats(packetPoolHits, packetPoolMisses);
+
     nodeList->resetPacketStats();
 
     statsObject["packets_per_second"] = packetsPerSecond;
     statsObject["bytes_per_second"] = bytesPerSecond;
+    statsObject["packet_pool_hits"] = (double) packetPoolHits;
+    statsObject["packet_pool_misses"] = (double) packetPoolMisses;
+
+    // the distributions of the hot paths since the last stats, the ones of the assignment come in with the object
+    QJsonObject metrics = statsObject[STATS_METRICS_KEY].toObject();
+    metrics["send_queue_depth"] = udt::SendQueue::getQueueDepths().takeSnapshot().toJson();
+    statsObject[STATS_METRICS_KEY] = metrics;
 
     nodeList->sendStatsToDomainServer(statsObject);
 }
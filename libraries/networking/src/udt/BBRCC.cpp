@@ -0,0 +1,247 @@
+//
+//  BBRCC.cpp
+//  libraries/networking/src/udt
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "BBRCC.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <random>
+
+#include <NumericalConstants.h>
+
+#include "ConnectionStats.h"
+
+using namespace udt;
+using namespace std::chrono;
+
+// 2 / ln(2), the smallest gain that lets the sending rate double every round trip during startup
+static const double HIGH_GAIN = 2.885;
+static const double DRAIN_GAIN = 1.0 / HIGH_GAIN;
+static const double PROBE_BANDWIDTH_WINDOW_GAIN = 2.0;
+
+// probe for more bandwidth for one min RTT, drain what that queued for one, then cruise for the rest of the cycle
+static const double PROBE_BANDWIDTH_PACING_GAINS[] = { 1.25, 0.75, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0 };
+static const int PROBE_BANDWIDTH_CYCLE_LENGTH =
+    sizeof(PROBE_BANDWIDTH_PACING_GAINS) / sizeof(PROBE_BANDWIDTH_PACING_GAINS[0]);
+
+// the pipe is considered full once the bandwidth grew less than 25% in three rounds
+static const double FULL_BANDWIDTH_GROWTH = 1.25;
+static const int FULL_BANDWIDTH_ROUNDS = 3;
+
+static const microseconds MIN_RTT_WINDOW = seconds(10);
+static const microseconds PROBE_RTT_DURATION = milliseconds(200);
+
+static const int MIN_WINDOW_PACKETS = 4;
+static const int INITIAL_WINDOW_PACKETS = 10;
+
+BBRCC::BBRCC() :
+    _pacingGain(HIGH_GAIN),
+    _windowGain(HIGH_GAIN)
+{
+    _mss = udt::MAX_PACKET_SIZE_WITH_UDP_HEADER;
+
+    // don't pace until the first ACK gives us a delivery rate
+    _packetSendPeriod = 0.0;
+    _congestionWindowSize = INITIAL_WINDOW_PACKETS;
+
+    // the delivery rate and RTT are sampled on every ACK, so ask for one per packet
+    setAckInterval(1);
+
+    _roundMaxBandwidths.fill(0.0);
+
+    // we can't do this as a member initializer until our VS has support for constexpr
+    _minRTT = std::numeric_limits<int>::max();
+}
+
+bool BBRCC::onACK(SequenceNumber ack, p_high_resolution_clock::time_point receiveTime) {
+    // this ACK is cumulative, every packet up to and including ack has been delivered
+    auto end = _sentPackets.upper_bound(ack);
+    int numDelivered = (int) std::distance(_sentPackets.begin(), end);
+
+    if (numDelivered == 0) {
+        return false;
+    }
+
+    // the packet this ACK was sent for, or the most recent one it covers if ack was never sent by us
+    auto it = _sentPackets.find(ack);
+    SentPacket ackedPacket = (it != _sentPackets.end()) ? it->second : std::prev(end)->second;
+
+    _sentPackets.erase(_sentPackets.begin(), end);
+    _lastACK = ack;
+
+    _delivered += numDelivered;
+    _deliveredTime = receiveTime;
+
+    updateModel(ackedPacket, receiveTime);
+    updateMode(receiveTime);
+    updatePacingAndWindow();
+
+    // loss is repaired with NAKs, BBR never asks for a fast re-transmit
+    return false;
+}
+
+void BBRCC::onTimeout() {
+    // we have heard nothing for a full timeout, only keep a minimal window in flight until the next ACK
+    _congestionWindowSize = MIN_WINDOW_PACKETS;
+}
+
+void BBRCC::onPacketSent(int wireSize, SequenceNumber seqNum, p_high_resolution_clock::time_point timePoint) {
+    if (_sentPackets.empty()) {
+        // nothing was in flight, don't let the idle time count against the next delivery rate sample
+        _deliveredTime = timePoint;
+    }
+
+    // re-transmissions keep the original send time, like TCPVegasCC
+    if (_sentPackets.find(seqNum) == _sentPackets.end()) {
+        _sentPackets[seqNum] = { timePoint, _delivered, _deliveredTime };
+    }
+}
+
+void BBRCC::updateModel(const SentPacket& packet, p_high_resolution_clock::time_point receiveTime) {
+    // update the min RTT filter, taking a fresh sample once the current one is too old
+    int rtt = std::max(1, (int) duration_cast<microseconds>(receiveTime - packet.sendTime).count());
+
+    _isMinRTTExpired = (receiveTime - _minRTTTime) > MIN_RTT_WINDOW;
+
+    if (rtt <= _minRTT || _isMinRTTExpired) {
+        _minRTT = rtt;
+        _minRTTTime = receiveTime;
+    }
+
+    // a new round starts with the first ACK for a packet sent after the last round started
+    _isRoundStart = packet.delivered >= _nextRoundDelivered;
+
+    if (_isRoundStart) {
+        _nextRoundDelivered = _delivered;
+
+        _roundIndex = (_roundIndex + 1) % BANDWIDTH_FILTER_ROUNDS;
+        _roundMaxBandwidths[_roundIndex] = 0.0;
+    }
+
+    // the delivery rate is how many packets were ACKed between this packet being sent and being ACKed
+    auto interval = duration_cast<microseconds>(receiveTime - packet.deliveredTime).count();
+
+    if (interval > 0) {
+        double deliveryRate = (double) (_delivered - packet.delivered) * USECS_PER_SECOND / interval;
+        _roundMaxBandwidths[_roundIndex] = std::max(_roundMaxBandwidths[_roundIndex], deliveryRate);
+    }
+
+    _bottleneckBandwidth = *std::max_element(_roundMaxBandwidths.begin(), _roundMaxBandwidths.end());
+}
+
+void BBRCC::updateMode(p_high_resolution_clock::time_point now) {
+    if (_mode == Startup && _isRoundStart) {
+        if (_bottleneckBandwidth >= _fullBandwidth * FULL_BANDWIDTH_GROWTH) {
+            // still growing, check again in a few rounds
+            _fullBandwidth = _bottleneckBandwidth;
+            _fullBandwidthRounds = 0;
+        } else if (++_fullBandwidthRounds >= FULL_BANDWIDTH_ROUNDS) {
+            _isPipeFull = true;
+
+            // drain the queue startup built up
+            _mode = Drain;
+            _pacingGain = DRAIN_GAIN;
+            _windowGain = HIGH_GAIN;
+        }
+    }
+
+    if (_mode == Drain && _sentPackets.size() <= bandwidthDelayProduct()) {
+        enterProbeBandwidth(now);
+    }
+
+    if (_mode == ProbeBandwidth && (now - _cycleStartTime) > microseconds(_minRTT)) {
+        _cycleIndex = (_cycleIndex + 1) % PROBE_BANDWIDTH_CYCLE_LENGTH;
+        _pacingGain = PROBE_BANDWIDTH_PACING_GAINS[_cycleIndex];
+        _cycleStartTime = now;
+    }
+
+    if (_mode != ProbeRTT && _isMinRTTExpired) {
+        // we haven't seen a lower RTT in a while, drop to a minimal window so the queue empties and we can measure it
+        _mode = ProbeRTT;
+        _pacingGain = 1.0;
+        _windowGain = 1.0;
+        _isProbeRTTTimed = false;
+    }
+
+    if (_mode == ProbeRTT) {
+        if (!_isProbeRTTTimed && (int) _sentPackets.size() <= MIN_WINDOW_PACKETS) {
+            _probeRTTDoneTime = now + PROBE_RTT_DURATION;
+            _isProbeRTTTimed = true;
+        } else if (_isProbeRTTTimed && now >= _probeRTTDoneTime) {
+            _minRTTTime = now;
+
+            if (_isPipeFull) {
+                enterProbeBandwidth(now);
+            } else {
+                _mode = Startup;
+                _pacingGain = HIGH_GAIN;
+                _windowGain = HIGH_GAIN;
+            }
+        }
+    }
+}
+
+void BBRCC::enterProbeBandwidth(p_high_resolution_clock::time_point now) {
+    _mode = ProbeBandwidth;
+    _windowGain = PROBE_BANDWIDTH_WINDOW_GAIN;
+
+    // start in a random phase other than the drain one, so that connections sharing a link don't probe in lock step
+    std::random_device rd;
+    std::mt19937 generator(rd());
+    std::uniform_int_distribution<> distribution(2, PROBE_BANDWIDTH_CYCLE_LENGTH);
+
+    _cycleIndex = distribution(generator) % PROBE_BANDWIDTH_CYCLE_LENGTH;
+    _pacingGain = PROBE_BANDWIDTH_PACING_GAINS[_cycleIndex];
+    _cycleStartTime = now;
+}
+
+double BBRCC::currentBandwidth() const {
+    if (_bottleneckBandwidth > 0.0) {
+        return _bottleneckBandwidth;
+    } else if (_bandwidth > 0) {
+        // until we have our own sample, use the bandwidth the receiver measured with probe packet pairs
+        return _bandwidth;
+    } else if (_rtt > 0) {
+        return (double) INITIAL_WINDOW_PACKETS * USECS_PER_SECOND / _rtt;
+    } else {
+        return 0.0;
+    }
+}
+
+double BBRCC::bandwidthDelayProduct() const {
+    int rtt = (_minRTT != std::numeric_limits<int>::max()) ? _minRTT : _rtt;
+    return currentBandwidth() * rtt / USECS_PER_SECOND;
+}
+
+void BBRCC::updatePacingAndWindow() {
+    double bandwidth = currentBandwidth();
+
+    if (bandwidth > 0.0) {
+        setPacketSendPeriod(USECS_PER_SECOND / (_pacingGain * bandwidth));
+    }
+
+    int window = _congestionWindowSize;
+
+    if (_mode == ProbeRTT) {
+        window = MIN_WINDOW_PACKETS;
+    } else if (bandwidth > 0.0) {
+        window = (int) std::ceil(_windowGain * bandwidthDelayProduct());
+    }
+
+    _congestionWindowSize = std::max(MIN_WINDOW_PACKETS, std::min(window, udt::MAX_PACKETS_IN_FLIGHT));
+}
+
+void BBRCC::recordStats(ConnectionStats& stats) const {
+    stats.recordCongestionControlMode(_mode);
+    stats.recordBottleneckBandwidth((int) _bottleneckBandwidth);
+    stats.recordMinRTT((_minRTT != std::numeric_limits<int>::max()) ? _minRTT : 0);
+}
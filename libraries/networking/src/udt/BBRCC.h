@@ -0,0 +1,104 @@
+//
+//  BBRCC.h
+//  libraries/networking/src/udt
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_BBRCC_h
+#define hifi_BBRCC_h
+
+#include <array>
+#include <map>
+
+#include "CongestionControl.h"
+#include "Constants.h"
+
+namespace udt {
+
+// A congestion control modeled on BBR (https://queue.acm.org/detail.cfm?id=3022184).
+// Rather than backing off on loss, it keeps a model of the path - the bottleneck bandwidth, as the max delivery rate
+// over the last few round trips, and the min RTT over the last few seconds - and paces at that bandwidth with a window
+// of about one bandwidth-delay product. Random loss on wireless links therefore does not slow it down.
+class BBRCC : public CongestionControl {
+public:
+    enum Mode {
+        Startup,
+        Drain,
+        ProbeBandwidth,
+        ProbeRTT
+    };
+
+    BBRCC();
+
+    virtual bool onACK(SequenceNumber ackNum, p_high_resolution_clock::time_point receiveTime) override;
+    virtual void onLoss(SequenceNumber rangeStart, SequenceNumber rangeEnd) override {}
+    virtual void onTimeout() override;
+
+    virtual void onPacketSent(int wireSize, SequenceNumber seqNum, p_high_resolution_clock::time_point timePoint) override;
+
+    virtual void recordStats(ConnectionStats& stats) const override;
+
+protected:
+    virtual void setInitialSendSequenceNumber(SequenceNumber seqNum) override { _lastACK = seqNum - 1; }
+
+private:
+    struct SentPacket {
+        p_high_resolution_clock::time_point sendTime;
+        int delivered; // value of _delivered when the packet was sent
+        p_high_resolution_clock::time_point deliveredTime; // value of _deliveredTime when the packet was sent
+    };
+
+    void updateModel(const SentPacket& packet, p_high_resolution_clock::time_point receiveTime);
+    void updateMode(p_high_resolution_clock::time_point now);
+    void updatePacingAndWindow();
+
+    void enterProbeBandwidth(p_high_resolution_clock::time_point now);
+    double bandwidthDelayProduct() const; // in packets
+    double currentBandwidth() const; // in packets per second
+
+    using SentPacketMap = std::map<SequenceNumber, SentPacket>;
+    SentPacketMap _sentPackets; // packets sent and not ACKed yet, by sequence number
+
+    SequenceNumber _lastACK; // Sequence number of last packet that was ACKed
+
+    Mode _mode { Startup };
+    double _pacingGain; // multiplier on the bottleneck bandwidth to get the pacing rate
+    double _windowGain; // multiplier on the bandwidth-delay product to get the congestion window
+
+    int _delivered { 0 }; // number of packets ACKed during the connection
+    p_high_resolution_clock::time_point _deliveredTime { p_high_resolution_clock::now() }; // time of the last ACK
+
+    // a round trip ends when a packet sent after the previous round ended is ACKed
+    int _nextRoundDelivered { 0 };
+    bool _isRoundStart { false };
+
+    static const int BANDWIDTH_FILTER_ROUNDS = 10;
+    std::array<double, BANDWIDTH_FILTER_ROUNDS> _roundMaxBandwidths; // max delivery rate per round, packets per second
+    int _roundIndex { 0 };
+    double _bottleneckBandwidth { 0.0 }; // max of _roundMaxBandwidths, packets per second
+
+    int _minRTT; // in microseconds
+    p_high_resolution_clock::time_point _minRTTTime { p_high_resolution_clock::now() }; // when _minRTT was sampled
+    bool _isMinRTTExpired { false };
+
+    // startup ends once the bandwidth stops growing for a few rounds
+    double _fullBandwidth { 0.0 };
+    int _fullBandwidthRounds { 0 };
+    bool _isPipeFull { false };
+
+    int _cycleIndex { 0 }; // index of the current pacing gain in the probe bandwidth cycle
+    p_high_resolution_clock::time_point _cycleStartTime;
+
+    p_high_resolution_clock::time_point _probeRTTDoneTime;
+    bool _isProbeRTTTimed { false }; // set once the window has drained in probe RTT and its timer is running
+};
+
+}
+
+#endif // hifi_BBRCC_h
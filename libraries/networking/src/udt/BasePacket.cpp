@@ -11,6 +11,8 @@
 
 #include "BasePacket.h"
 
+#include "PacketBufferPool.h"
+
 using namespace udt;
 
 const qint64 BasePacket::PACKET_WRITE_ERROR = -1;
@@ -58,7 +60,15 @@ BasePacket::BasePacket(qint64 size) {
     Q_ASSERT(size >= 0 || size < maxPayload);
     
     _packetSize = size;
-    _packet.reset(new char[_packetSize]());
+    
+    if (_packetSize <= MAX_PACKET_SIZE) {
+        _packet = PacketBufferPool::acquire();
+        _isBufferPooled = true;
+        memset(_packet.get(), 0, _packetSize);
+    } else {
+        _packet.reset(new char[_packetSize]());
+    }
+    
     _payloadCapacity = _packetSize;
     _payloadSize = 0;
     _payloadStart = _packet.get();
@@ -75,6 +85,19 @@ BasePacket::BasePacket(std::unique_ptr<char[]> data, qint64 size, const HifiSock
     
 }
 
+BasePacket::~BasePacket() {
+    releaseBuffer();
+}
+
+void BasePacket::releaseBuffer() {
+    if (_isBufferPooled) {
+        PacketBufferPool::release(std::move(_packet));
+        _isBufferPooled = false;
+    }
+    
+    _packet.reset();
+}
+
 BasePacket::BasePacket(const BasePacket& other) :
     QIODevice()
 {
@@ -82,8 +105,17 @@ BasePacket::BasePacket(const BasePacket& other) :
 }
 
 BasePacket& BasePacket::operator=(const BasePacket& other) {
+    releaseBuffer();
+    
     _packetSize = other._packetSize;
-    _packet = std::unique_ptr<char[]>(new char[_packetSize]);
+    
+    if (_packetSize <= MAX_PACKET_SIZE) {
+        _packet = PacketBufferPool::acquire();
+        _isBufferPooled = true;
+    } else {
+        _packet = std::unique_ptr<char[]>(new char[_packetSize]);
+    }
+    
     memcpy(_packet.get(), other._packet.get(), _packetSize);
     
     _payloadStart = _packet.get() + (other._payloadStart - other._packet.get());
@@ -107,8 +139,12 @@ BasePacket::BasePacket(BasePacket&& other) {
 }
 
 BasePacket& BasePacket::operator=(BasePacket&& other) {
+    releaseBuffer();
+    
     _packetSize = other._packetSize;
     _packet = std::move(other._packet);
+    _isBufferPooled = other._isBufferPooled;
+    other._isBufferPooled = false;
     
     _payloadStart = other._payloadStart;
     _payloadCapacity = other._payloadCapacity;
@@ -34,6 +34,8 @@ public:
     static std::unique_ptr<BasePacket> fromReceivedPacket(std::unique_ptr<char[]> data, qint64 size,
                                                           const HifiSockAddr& senderSockAddr);
     
+    virtual ~BasePacket();
+    
     // Current level's header size
     static int localHeaderSize();
     // Cumulated size of all the headers
@@ -70,6 +72,9 @@ public:
     HifiSockAddr& getSenderSockAddr() { return _senderSockAddr; }
     const HifiSockAddr& getSenderSockAddr() const { return _senderSockAddr; }
     
+    // Flags a buffer handed to fromReceivedPacket as one from PacketBufferPool, so it is recycled with the packet
+    void setBufferIsPooled() { _isBufferPooled = true; }
+    
     // QIODevice virtual functions
     // WARNING: Those methods all refer to the payload ONLY and NOT the entire packet
     virtual bool isSequential() const override { return false; }
@@ -104,8 +109,12 @@ protected:
     
     void adjustPayloadStartAndCapacity(qint64 headerSize, bool shouldDecreasePayloadSize = false);
     
+    // Returns a pooled buffer to PacketBufferPool, or frees the buffer otherwise
+    void releaseBuffer();
+    
     qint64 _packetSize = 0;        // Total size of the allocated memory
     std::unique_ptr<char[]> _packet; // Allocated memory
+    bool _isBufferPooled = false;  // Allocated memory came from PacketBufferPool and goes back to it
     
     char* _payloadStart = nullptr; // Start of the payload
     qint64 _payloadCapacity = 0;          // Total capacity of the payload
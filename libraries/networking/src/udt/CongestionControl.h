@@ -26,6 +26,7 @@ namespace udt {
 static const int32_t DEFAULT_SYN_INTERVAL = 10000; // 10 ms
 
 class Connection;
+class ConnectionStats;
 class Packet;
 
 class CongestionControl {
@@ -52,6 +53,9 @@ public:
     virtual bool shouldProbe() { return true; }
 
     virtual void onPacketSent(int wireSize, SequenceNumber seqNum, p_high_resolution_clock::time_point timePoint) {}
+
+    // lets a congestion control add the state of its own model to the connection stats
+    virtual void recordStats(ConnectionStats& stats) const {}
 protected:
     void setAckInterval(int ackInterval) { _ackInterval = ackInterval; }
     void setRTO(int rto) { _userDefinedRTO = true; _rto = rto; }
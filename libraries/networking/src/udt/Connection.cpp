@@ -11,8 +11,6 @@
 
 #include "Connection.h"
 
-#include <QtCore/QThread>
-
 #include <NumericalConstants.h>
 
 #include "../HifiSockAddr.h"
@@ -71,21 +69,12 @@ Connection::~Connection() {
 }
 
 void Connection::stopSendQueue() {
-    if (auto sendQueue = _sendQueue.release()) {
-        // grab the send queue thread so we can wait on it
-        QThread* sendQueueThread = sendQueue->thread();
-        
-        // tell the send queue to stop and be deleted
-        
+    if (auto sendQueue = std::move(_sendQueue)) {
+        // tell the send queue to stop, deleting it below waits for a step in progress on its send worker
         sendQueue->stop();
-        sendQueue->deleteLater();
         
         // since we're stopping the send queue we should consider our handshake ACK not receieved
         _hasReceivedHandshakeACK = false;
-        
-        // wait on the send queue thread so we know the send queue is gone
-        sendQueueThread->quit();
-        sendQueueThread->wait();
     }
 }
 
@@ -278,7 +267,6 @@ void Connection::recordRetransmission(int wireSize, SequenceNumber seqNum, p_hig
 }
 
 void Connection::sendACK(bool wasCausedBySyncTimeout) {
-    static p_high_resolution_clock::time_point lastACKSendTime;
     auto currentTime = p_high_resolution_clock::now();
     
     SequenceNumber nextACKNumber = nextACK();
@@ -292,7 +280,7 @@ void Connection::sendACK(bool wasCausedBySyncTimeout) {
         }
         
         // We will re-send if it has been more than the estimated timeout since the last ACK
-        microseconds sinceLastACK = duration_cast<microseconds>(currentTime - lastACKSendTime);
+        microseconds sinceLastACK = duration_cast<microseconds>(currentTime - _lastACKSendTime);
         
         if (sinceLastACK.count() < estimatedTimeout()) {
             return;
@@ -334,16 +322,17 @@ void Connection::sendACK(bool wasCausedBySyncTimeout) {
     }
     
     // record this as the last ACK send time
-    lastACKSendTime = p_high_resolution_clock::now();
+    _lastACKSendTime = currentTime;
     
     // have the socket send off our packet
     _parentSocket->writeBasePacket(*_ackPacket, _destination);
     
-    Q_ASSERT_X(_sentACKs.empty() || _sentACKs.back().first + 1 == _currentACKSubSequenceNumber,
-               "Connection::sendACK", "Adding an invalid ACK to _sentACKs");
-    
-    // write this ACK to the map of sent ACKs
-    _sentACKs.push_back({ _currentACKSubSequenceNumber, { nextACKNumber, p_high_resolution_clock::now() }});
+    // write this ACK to the ring of sent ACKs, over the one NUM_SENT_ACKS sub-sequence numbers before it
+    SentACK& sentACK = _sentACKs[(uint32_t) _currentACKSubSequenceNumber % NUM_SENT_ACKS];
+    sentACK.subSequenceNumber = _currentACKSubSequenceNumber;
+    sentACK.ackNumber = nextACKNumber;
+    sentACK.sendTime = currentTime;
+    sentACK.isValid = true;
     
     // reset the number of data packets received since last ACK
     _packetsSinceACK = 0;
@@ -408,14 +397,15 @@ void Connection::sendNAK(SequenceNumber sequenceNumberRecieved) {
 void Connection::sendTimeoutNAK() {
     if (_lossList.getLength() > 0) {
         
-        int timeoutPayloadSize = std::min((int) (_lossList.getLength() * 2 * sizeof(SequenceNumber)),
+        // ranges take at most two sequence numbers each, single losses only take one
+        int timeoutPayloadSize = std::min((int) (_lossList.getNumRanges() * 2 * sizeof(SequenceNumber)),
                                           ControlPacket::maxPayloadSize());
         
-        // construct a NAK packet that will hold all of the lost sequence numbers
+        // construct a NAK packet that will hold as many of the lost sequence numbers as fit
         auto lossListPacket = ControlPacket::create(ControlPacket::TimeoutNAK, timeoutPayloadSize);
         
         // Pack in the lost sequence numbers
-        _lossList.write(*lossListPacket, timeoutPayloadSize / (2 * sizeof(SequenceNumber)));
+        _lossList.write(*lossListPacket);
         
         // have our parent socket send off this control packet
         _parentSocket->writeBasePacket(*lossListPacket, _destination);
@@ -442,7 +432,8 @@ void Connection::sendHandshakeRequest() {
     _didRequestHandshake = true;
 }
 
-bool Connection::processReceivedSequenceNumber(SequenceNumber sequenceNumber, int packetSize, int payloadSize) {
+bool Connection::processReceivedSequenceNumber(SequenceNumber sequenceNumber, int packetSize, int payloadSize,
+                                               p_high_resolution_clock::time_point receiveTime) {
     
     if (!_hasReceivedHandshake) {
         // Refuse to process any packets until we've received the handshake
@@ -459,23 +450,23 @@ bool Connection::processReceivedSequenceNumber(SequenceNumber sequenceNumber, in
     
     _isReceivingData = true;
     
-    // mark our last receive time as now (to push the potential expiry farther)
-    _lastReceiveTime = p_high_resolution_clock::now();
+    // mark our last receive time as the packet's, read off the clock once for its batch (to push the potential expiry farther)
+    _lastReceiveTime = receiveTime;
     
     // check if this is a packet pair we should estimate bandwidth from, or just a regular packet
     if (((uint32_t) sequenceNumber & 0xF) == 0) {
-        _receiveWindow.onProbePair1Arrival();
+        _receiveWindow.onProbePair1Arrival(receiveTime);
     } else if (((uint32_t) sequenceNumber & 0xF) == 1) {
         // only use this packet for bandwidth estimation if we didn't just receive a control packet in its place
         if (!_receivedControlProbeTail) {
-            _receiveWindow.onProbePair2Arrival();
+            _receiveWindow.onProbePair2Arrival(receiveTime);
         } else {
             // reset our control probe tail marker so the next probe that comes with data can be used
             _receivedControlProbeTail = false;
         }
         
     }
-    _receiveWindow.onPacketArrival();
+    _receiveWindow.onPacketArrival(receiveTime);
     
     // If this is not the next sequence number, report loss
     if (sequenceNumber > _lastReceivedSequenceNumber + 1) {
@@ -594,6 +585,10 @@ void Connection::processControl(ControlPacketPointer controlPacket) {
                 stopSendQueue();
             }
             break;
+        case ControlPacket::FECParity:
+        case ControlPacket::FECReport:
+            // forward error correction is handled by the Socket, for unreliable packets
+            break;
     }
 }
 
@@ -605,18 +600,16 @@ void Connection::processACK(ControlPacketPointer controlPacket) {
     // Check if we need send an ACK2 for this ACK
     // This will be the case if it has been longer than the sync interval OR
     // it looks like they haven't received our ACK2 for this ACK
-    auto currentTime = p_high_resolution_clock::now();
-    static p_high_resolution_clock::time_point lastACK2SendTime =
-        p_high_resolution_clock::now() - std::chrono::microseconds(_synInterval);
+    auto currentTime = controlPacket->getReceiveTime();
     
-    microseconds sinceLastACK2 = duration_cast<microseconds>(currentTime - lastACK2SendTime);
+    microseconds sinceLastACK2 = duration_cast<microseconds>(currentTime - _lastACK2SendTime);
     
     if (_congestionControl->shouldACK2()
         && (sinceLastACK2.count() >= _synInterval || currentACKSubSequenceNumber == _lastSentACK2)) {
         // Send ACK2 packet
         sendACK2(currentACKSubSequenceNumber);
         
-        lastACK2SendTime = p_high_resolution_clock::now();
+        _lastACK2SendTime = currentTime;
     }
     
     // read the ACKed sequence number
@@ -731,38 +724,31 @@ void Connection::processACK2(ControlPacketPointer controlPacket) {
     SequenceNumber subSequenceNumber;
     controlPacket->readPrimitive(&subSequenceNumber);
 
-    // check if we had that subsequence number in our map
-    auto it = std::find_if_not(_sentACKs.begin(), _sentACKs.end(), [&subSequenceNumber](const ACKListPair& pair){
-        return pair.first < subSequenceNumber;
-    });
+    // check if we still have that subsequence number in our ring
+    const SentACK& sentACK = _sentACKs[(uint32_t) subSequenceNumber % NUM_SENT_ACKS];
     
-    if (it != _sentACKs.end()) {
-        if (it->first == subSequenceNumber){
-            // update the RTT using the ACK window
-            
-            // calculate the RTT (time now - time ACK sent)
-            auto now = p_high_resolution_clock::now();
-            int rtt = duration_cast<microseconds>(now - it->second.second).count();
-            
-            updateRTT(rtt);
-            // write this RTT to stats
-            _stats.recordRTT(rtt);
-            
-            // set the RTT for congestion control
-            _congestionControl->setRTT(_rtt);
-            
-            // update the last ACKed ACK
-            if (it->second.first > _lastReceivedAcknowledgedACK) {
-                _lastReceivedAcknowledgedACK = it->second.first;
-            }
-        } else if (it->first < subSequenceNumber) {
-            Q_UNREACHABLE();
+    if (sentACK.isValid && sentACK.subSequenceNumber == subSequenceNumber && !(subSequenceNumber < _oldestSentACK)) {
+        // update the RTT using the ACK window
+        
+        // calculate the RTT (time the ACK2 was received - time ACK sent)
+        int rtt = duration_cast<microseconds>(controlPacket->getReceiveTime() - sentACK.sendTime).count();
+        
+        updateRTT(rtt);
+        // write this RTT to stats
+        _stats.recordRTT(rtt);
+        
+        // set the RTT for congestion control
+        _congestionControl->setRTT(_rtt);
+        
+        // update the last ACKed ACK
+        if (sentACK.ackNumber > _lastReceivedAcknowledgedACK) {
+            _lastReceivedAcknowledgedACK = sentACK.ackNumber;
         }
+        
+        // anything below this sub-sequence number is done with now that we've gotten our timing information
+        _oldestSentACK = subSequenceNumber;
     }
     
-    // erase this sub-sequence number and anything below it now that we've gotten our timing information
-    _sentACKs.erase(_sentACKs.begin(), it);
-    
     _stats.record(ConnectionStats::Stats::ReceivedACK2);
 }
 
@@ -853,7 +839,7 @@ void Connection::processProbeTail(ControlPacketPointer controlPacket) {
         qCDebug(networking) << "Processing second packet of probe from control packet instead of data packet";
 #endif
         
-        _receiveWindow.onProbePair2Arrival();
+        _receiveWindow.onProbePair2Arrival(controlPacket->getReceiveTime());
         
         // mark that we processed a control packet for the second in the pair and we should not mark
         // the next data packet received
@@ -874,7 +860,8 @@ void Connection::resetReceiveState() {
     _lastSentACK = defaultSequenceNumber;
     
     // clear the sent ACKs
-    _sentACKs.clear();
+    _sentACKs.fill(SentACK());
+    _oldestSentACK = defaultSequenceNumber;
     
     // clear the loss list and _lastNAKTime
     _lossList.clear();
@@ -945,6 +932,7 @@ void Connection::updateCongestionControlAndSendQueue(std::function<void ()> cong
     // record connection stats
     _stats.recordPacketSendPeriod(_congestionControl->_packetSendPeriod);
     _stats.recordCongestionWindowSize(_congestionControl->_congestionWindowSize);
+    _congestionControl->recordStats(_stats);
 }
 
 void PendingReceivedMessage::enqueuePacket(std::unique_ptr<Packet> packet) {
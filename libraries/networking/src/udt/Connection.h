@@ -12,6 +12,7 @@
 #ifndef hifi_Connection_h
 #define hifi_Connection_h
 
+#include <array>
 #include <list>
 #include <memory>
 
@@ -52,9 +53,6 @@ private:
 class Connection : public QObject {
     Q_OBJECT
 public:
-    using SequenceNumberTimePair = std::pair<SequenceNumber, p_high_resolution_clock::time_point>;
-    using ACKListPair = std::pair<SequenceNumber, SequenceNumberTimePair>;
-    using SentACKList = std::list<ACKListPair>;
     using ControlPacketPointer = std::unique_ptr<ControlPacket>;
     
     Connection(Socket* parentSocket, HifiSockAddr destination, std::unique_ptr<CongestionControl> congestionControl);
@@ -66,7 +64,8 @@ public:
     void sync(); // rate control method, fired by Socket for all connections on SYN interval
 
     // return indicates if this packet should be processed
-    bool processReceivedSequenceNumber(SequenceNumber sequenceNumber, int packetSize, int payloadSize);
+    bool processReceivedSequenceNumber(SequenceNumber sequenceNumber, int packetSize, int payloadSize,
+                                       p_high_resolution_clock::time_point receiveTime);
     void processControl(ControlPacketPointer controlPacket);
 
     void queueReceivedMessagePacket(std::unique_ptr<Packet> packet);
@@ -161,7 +160,19 @@ private:
     int _bandwidth { 1 }; // Exponential moving average for estimated bandwidth, in packets per second
     int _deliveryRate { 16 }; // Exponential moving average for receiver's receive rate, in packets per second
     
-    SentACKList _sentACKs; // Map of ACK sub-sequence numbers to ACKed sequence number and sent time
+    // the ACKs waiting for their ACK2, in a ring indexed by their consecutive sub-sequence numbers
+    struct SentACK {
+        SequenceNumber subSequenceNumber;
+        SequenceNumber ackNumber;
+        p_high_resolution_clock::time_point sendTime;
+        bool isValid { false };
+    };
+    static const int NUM_SENT_ACKS = 1024; // a power of two, so the ring index follows sequence numbers wrapping
+    std::array<SentACK, NUM_SENT_ACKS> _sentACKs;
+    SequenceNumber _oldestSentACK; // the ACK2s for sub-sequence numbers below this one came too late
+
+    p_high_resolution_clock::time_point _lastACKSendTime;
+    p_high_resolution_clock::time_point _lastACK2SendTime;
     
     Socket* _parentSocket { nullptr };
     HifiSockAddr _destination;
@@ -112,3 +112,18 @@ void ConnectionStats::recordPacketSendPeriod(int sample) {
     _currentSample.packetSendPeriod = sample;
     _total.packetSendPeriod = (int)((_total.packetSendPeriod * EWMA_PREVIOUS_SAMPLES_WEIGHT) + (sample * EWMA_CURRENT_SAMPLE_WEIGHT));
 }
+
+void ConnectionStats::recordCongestionControlMode(int mode) {
+    _currentSample.congestionControlMode = mode;
+    _total.congestionControlMode = mode;
+}
+
+void ConnectionStats::recordBottleneckBandwidth(int sample) {
+    _currentSample.bottleneckBandwidth = sample;
+    _total.bottleneckBandwidth = sample;
+}
+
+void ConnectionStats::recordMinRTT(int sample) {
+    _currentSample.minRTT = sample;
+    _total.minRTT = sample;
+}
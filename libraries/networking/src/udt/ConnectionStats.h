@@ -69,6 +69,16 @@ public:
         int rtt { 0 };
         int congestionWindowSize { 0 };
         int packetSendPeriod { 0 };
+
+        // the state of congestion controls that model the path, like BBRCC - these are the latest values
+        int congestionControlMode { 0 };
+        int bottleneckBandwidth { 0 }; // packets per second
+        int minRTT { 0 }; // microseconds
+
+        // forward error correction of unreliable packets, see ForwardErrorCorrection.h - these are the latest values
+        int fecGroupSize { 0 };
+        int fecReportedLoss { 0 }; // parts per million, as reported by the receiver
+        int fecRecoveredPackets { 0 };
         
         // TODO: Remove once Win build supports brace initialization: `Events events {{ 0 }};`
         Stats() { events.fill(0); }
@@ -93,6 +103,10 @@ public:
     void recordRTT(int sample);
     void recordCongestionWindowSize(int sample);
     void recordPacketSendPeriod(int sample);
+
+    void recordCongestionControlMode(int mode);
+    void recordBottleneckBandwidth(int sample);
+    void recordMinRTT(int sample);
     
 private:
     Stats _currentSample;
@@ -35,7 +35,9 @@ public:
         Handshake,
         HandshakeACK,
         ProbeTail,
-        HandshakeRequest
+        HandshakeRequest,
+        FECParity,
+        FECReport
     };
     
     static std::unique_ptr<ControlPacket> create(Type type, qint64 size = -1);
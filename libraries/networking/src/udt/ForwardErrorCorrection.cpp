@@ -0,0 +1,215 @@
+//
+//  ForwardErrorCorrection.cpp
+//  libraries/networking/src/udt
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ForwardErrorCorrection.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "ControlPacket.h"
+#include "Packet.h"
+
+using namespace udt;
+
+static const int FEC_HEADER_BYTES = sizeof(SequenceNumber::UType) + sizeof(uint32_t) + sizeof(uint16_t);
+static const int MAX_GROUP_SPAN = 32; // one bit of the group mask per sequence number
+
+// we aim for a quarter of a loss per group, so that most groups that do lose a datagram lose only the one
+static const float TARGET_LOSSES_PER_GROUP = 0.25f;
+
+int FECEncoder::maxProtectedDatagramSize() {
+    return ControlPacket::maxPayloadSize() - FEC_HEADER_BYTES;
+}
+
+FECEncoder::FECEncoder(int minGroupSize, int maxGroupSize) :
+    _minGroupSize(std::max(minGroupSize, MIN_GROUP_SIZE)),
+    _maxGroupSize(std::min(std::max(maxGroupSize, _minGroupSize), MAX_GROUP_SPAN)),
+    _groupSize(_maxGroupSize), // until the receiver reports loss we keep the overhead low
+    _parity(maxProtectedDatagramSize(), 0)
+{
+
+}
+
+std::unique_ptr<ControlPacket> FECEncoder::addDatagram(SequenceNumber sequenceNumber, const char* data, int size) {
+    Q_ASSERT(size <= maxProtectedDatagramSize());
+
+    _wasActive = true;
+
+    std::unique_ptr<ControlPacket> parityPacket;
+
+    if (_numInGroup > 0 && seqoff(_firstSequenceNumber, sequenceNumber) < 0) {
+        // another thread wrote this one ahead of the group we are building, leave it unprotected
+        return parityPacket;
+    }
+
+    // unprotected packets share the sequence numbers, so a group is also closed once it spans all of its mask
+    if (_numInGroup > 0 && seqoff(_firstSequenceNumber, sequenceNumber) >= MAX_GROUP_SPAN) {
+        parityPacket = createParityPacket();
+    }
+
+    if (_numInGroup == 0) {
+        _firstSequenceNumber = sequenceNumber;
+    }
+
+    _groupMask |= 1u << seqoff(_firstSequenceNumber, sequenceNumber);
+    _sizeParity ^= (uint16_t)size;
+    for (int i = 0; i < size; ++i) {
+        _parity[i] ^= data[i];
+    }
+    _parityLength = std::max(_parityLength, size);
+
+    if (++_numInGroup >= _groupSize) {
+        // groups have at least two datagrams, so this can not also follow a group closed above
+        parityPacket = createParityPacket();
+    }
+
+    return parityPacket;
+}
+
+std::unique_ptr<ControlPacket> FECEncoder::createParityPacket() {
+    auto parityPacket = ControlPacket::create(ControlPacket::FECParity, FEC_HEADER_BYTES + _parityLength);
+
+    parityPacket->writePrimitive((SequenceNumber::UType)_firstSequenceNumber);
+    parityPacket->writePrimitive(_groupMask);
+    parityPacket->writePrimitive(_sizeParity);
+    parityPacket->write(_parity.data(), _parityLength);
+
+    // reset for the next group
+    std::fill(_parity.begin(), _parity.begin() + _parityLength, 0);
+    _parityLength = 0;
+    _sizeParity = 0;
+    _groupMask = 0;
+    _numInGroup = 0;
+
+    return parityPacket;
+}
+
+void FECEncoder::setReportedLoss(float lossRate) {
+    _reportedLoss = lossRate;
+
+    if (lossRate <= 0.0f) {
+        _groupSize = _maxGroupSize;
+    } else {
+        int groupSize = (int)std::lround(TARGET_LOSSES_PER_GROUP / lossRate);
+        _groupSize = std::min(std::max(groupSize, _minGroupSize), _maxGroupSize);
+    }
+}
+
+bool FECEncoder::checkAndClearActivity() {
+    bool wasActive = _wasActive;
+    _wasActive = false;
+    return wasActive;
+}
+
+bool FECDecoder::addReceivedDatagram(SequenceNumber sequenceNumber, const char* data, int size) {
+    auto& entry = _window[(SequenceNumber::UType)sequenceNumber % WINDOW_SIZE];
+
+    if (entry.isValid && entry.sequenceNumber == sequenceNumber) {
+        // we have this one already - most likely we rebuilt it and the original was only late
+        return false;
+    }
+
+    entry.sequenceNumber = sequenceNumber;
+    entry.isValid = size <= FECEncoder::maxProtectedDatagramSize();
+    if (entry.isValid) {
+        // resize keeps the capacity of the array, so after a while this does not allocate
+        entry.data.resize(size);
+        memcpy(entry.data.data(), data, size);
+    }
+
+    return true;
+}
+
+QByteArray FECDecoder::processParity(ControlPacket& parityPacket) {
+    _wasActive = true;
+
+    if (parityPacket.getPayloadSize() < FEC_HEADER_BYTES) {
+        return QByteArray();
+    }
+
+    SequenceNumber::UType firstSequenceNumberValue;
+    uint32_t groupMask;
+    uint16_t sizeParity;
+    parityPacket.readPrimitive(&firstSequenceNumberValue);
+    parityPacket.readPrimitive(&groupMask);
+    parityPacket.readPrimitive(&sizeParity);
+
+    SequenceNumber firstSequenceNumber { firstSequenceNumberValue };
+    const char* parity = parityPacket.getPayload() + FEC_HEADER_BYTES;
+    int parityLength = (int)parityPacket.getPayloadSize() - FEC_HEADER_BYTES;
+
+    SequenceNumber missingSequenceNumber;
+    int numMissing = 0;
+
+    for (int i = 0; i < MAX_GROUP_SPAN; ++i) {
+        if (groupMask & (1u << i)) {
+            SequenceNumber sequenceNumber = firstSequenceNumber + i;
+            const auto& entry = _window[(SequenceNumber::UType)sequenceNumber % WINDOW_SIZE];
+
+            ++_numExpected;
+            if (!entry.isValid || entry.sequenceNumber != sequenceNumber) {
+                ++_numLost;
+                ++numMissing;
+                missingSequenceNumber = sequenceNumber;
+            }
+        }
+    }
+
+    if (numMissing != 1) {
+        // XOR parity can only rebuild a single datagram
+        return QByteArray();
+    }
+
+    QByteArray recovered(parity, parityLength);
+    char* recoveredData = recovered.data();
+
+    for (int i = 0; i < MAX_GROUP_SPAN; ++i) {
+        if (groupMask & (1u << i)) {
+            SequenceNumber sequenceNumber = firstSequenceNumber + i;
+            if (sequenceNumber == missingSequenceNumber) {
+                continue;
+            }
+
+            const auto& entry = _window[(SequenceNumber::UType)sequenceNumber % WINDOW_SIZE];
+            int size = std::min(entry.data.size(), parityLength);
+            const char* data = entry.data.constData();
+
+            sizeParity ^= (uint16_t)entry.data.size();
+            for (int j = 0; j < size; ++j) {
+                recoveredData[j] ^= data[j];
+            }
+        }
+    }
+
+    // guard against a parity that does not match what we received, the packet filter verifies the rest
+    if (sizeParity > parityLength || sizeParity < Packet::totalHeaderSize()
+        || SequenceNumber(recoveredData) != missingSequenceNumber) {
+        return QByteArray();
+    }
+
+    recovered.resize(sizeParity);
+    ++_numRecovered;
+
+    return recovered;
+}
+
+float FECDecoder::sampleLoss() {
+    float loss = (_numExpected > 0) ? (float)_numLost / _numExpected : 0.0f;
+    _numExpected = 0;
+    _numLost = 0;
+    return loss;
+}
+
+bool FECDecoder::checkAndClearActivity() {
+    bool wasActive = _wasActive;
+    _wasActive = false;
+    return wasActive;
+}
@@ -0,0 +1,109 @@
+//
+//  ForwardErrorCorrection.h
+//  libraries/networking/src/udt
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_ForwardErrorCorrection_h
+#define hifi_ForwardErrorCorrection_h
+
+#include <array>
+#include <memory>
+#include <vector>
+
+#include <QtCore/QByteArray>
+
+#include "SequenceNumber.h"
+
+namespace udt {
+
+class ControlPacket;
+
+// Forward error correction for unreliable datagrams. The sender XORs a group of datagrams to one destination together
+// and follows the group with a ControlPacket::FECParity, from which the receiver can rebuild any one datagram of the
+// group that was lost. The receiver reports the loss it sees in the groups with a ControlPacket::FECReport, and the
+// sender makes its groups smaller (more redundant) as that loss goes up.
+//
+// Parity payload: first sequence number of the group (4 bytes), mask of the sequence numbers in the group counted from
+// the first (4 bytes), XOR of the datagram sizes (2 bytes), XOR of the datagrams padded to the largest one.
+
+class FECEncoder {
+public:
+    static const int MIN_GROUP_SIZE = 2;
+    static const int MAX_GROUP_SIZE = 16;
+
+    // datagrams past this size are not protected, since their parity would not fit in a packet
+    static int maxProtectedDatagramSize();
+
+    FECEncoder(int minGroupSize = MIN_GROUP_SIZE, int maxGroupSize = MAX_GROUP_SIZE);
+
+    // adds a written datagram to the current group, returns the parity of a group that it completed (or closed)
+    std::unique_ptr<ControlPacket> addDatagram(SequenceNumber sequenceNumber, const char* data, int size);
+
+    // picks the group size for the fraction of protected datagrams the receiver reported as lost
+    void setReportedLoss(float lossRate);
+    float getReportedLoss() const { return _reportedLoss; }
+    int getGroupSize() const { return _groupSize; }
+
+    // returns true if a datagram was added since the last call
+    bool checkAndClearActivity();
+
+private:
+    std::unique_ptr<ControlPacket> createParityPacket();
+
+    int _minGroupSize;
+    int _maxGroupSize;
+    int _groupSize;
+    float _reportedLoss { 0.0f };
+    bool _wasActive { false };
+
+    SequenceNumber _firstSequenceNumber;
+    uint32_t _groupMask { 0 };
+    int _numInGroup { 0 };
+    uint16_t _sizeParity { 0 };
+    int _parityLength { 0 };
+    std::vector<char> _parity;
+};
+
+class FECDecoder {
+public:
+    // keeps a copy of a received unreliable datagram, returns false if it is one that was already received
+    bool addReceivedDatagram(SequenceNumber sequenceNumber, const char* data, int size);
+
+    // returns the datagram rebuilt from the parity, or an empty array if no datagram (or more than one) was lost
+    QByteArray processParity(ControlPacket& parityPacket);
+
+    // fraction of the protected datagrams that were lost since the last call, before any recovery
+    float sampleLoss();
+    int getNumRecovered() const { return _numRecovered; }
+
+    // returns true if a parity packet was received since the last call
+    bool checkAndClearActivity();
+
+private:
+    // a group covers at most 32 sequence numbers, this leaves room for the parity to arrive late
+    static const int WINDOW_SIZE = 64;
+
+    struct ReceivedDatagram {
+        SequenceNumber sequenceNumber;
+        bool isValid { false };
+        QByteArray data;
+    };
+
+    std::array<ReceivedDatagram, WINDOW_SIZE> _window;
+
+    int _numExpected { 0 };
+    int _numLost { 0 };
+    int _numRecovered { 0 };
+    bool _wasActive { false };
+};
+
+}
+
+#endif // hifi_ForwardErrorCorrection_h
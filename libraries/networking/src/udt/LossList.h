@@ -12,14 +12,16 @@
 #ifndef hifi_LossList_h
 #define hifi_LossList_h
 
-#include <list>
+#include <map>
 
 #include "SequenceNumber.h"
 
 namespace udt {
 
 class ControlPacket;
-    
+
+// The ranges of lost sequence numbers, kept in a map by the start of each range so that finding the range of a sequence
+// number is logarithmic in the number of ranges - long, fat links can have thousands of them outstanding.
 class LossList {
 public:
     LossList() {}
@@ -30,21 +32,28 @@ public:
     void append(SequenceNumber seq);
     void append(SequenceNumber start, SequenceNumber end);
     
-    // inserts anywhere - MUCH slower
+    // inserts anywhere - slower
     void insert(SequenceNumber start, SequenceNumber end);
     
     bool remove(SequenceNumber seq);
     void remove(SequenceNumber start, SequenceNumber end);
     
     int getLength() const { return _length; }
+    int getNumRanges() const { return (int)_lossList.size(); }
     bool isEmpty() const { return _length == 0; }
     SequenceNumber getFirstSequenceNumber() const;
     SequenceNumber popFirstSequenceNumber();
     
-    void write(ControlPacket& packet, int maxPairs = -1);
+    // writes as many ranges as fit in the packet - a range of one sequence number takes a single word, a longer
+    // range is written as its start with the RANGE_BIT set followed by its end
+    void write(ControlPacket& packet) const;
+    // replaces the content of this list with the ranges in a packet written by write
+    void read(ControlPacket& packet);
+
+    static const SequenceNumber::UType RANGE_BIT = 0x80000000;
     
 private:
-    std::list<std::pair<SequenceNumber, SequenceNumber>> _lossList;
+    std::map<SequenceNumber, SequenceNumber> _lossList; // range start to range end
     int _length { 0 };
 };
     
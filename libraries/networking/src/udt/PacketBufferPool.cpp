@@ -0,0 +1,114 @@
+//
+//  PacketBufferPool.cpp
+//  libraries/networking/src/udt
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PacketBufferPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include "Constants.h"
+
+using namespace udt;
+
+using Buffers = std::vector<std::unique_ptr<char[]>>;
+
+static const size_t MAX_THREAD_BUFFERS = 64;
+static const size_t BUFFER_TRANSFER_BATCH_SIZE = MAX_THREAD_BUFFERS / 2;
+static const size_t MAX_SHARED_BUFFERS = 4096;
+
+static std::atomic<quint64> numHits { 0 };
+static std::atomic<quint64> numMisses { 0 };
+
+struct SharedBuffers {
+    std::mutex mutex;
+    Buffers buffers;
+};
+
+static SharedBuffers& sharedBuffers() {
+    // intentionally leaked so that packets destroyed during static destruction can still release their buffers
+    static SharedBuffers* shared = new SharedBuffers;
+    return *shared;
+}
+
+// moves up to count buffers from the back of source to the back of destination
+static void transferBuffers(Buffers& source, Buffers& destination, size_t count) {
+    count = std::min(count, source.size());
+    for (auto it = source.end() - count; it != source.end(); ++it) {
+        destination.push_back(std::move(*it));
+    }
+    source.resize(source.size() - count);
+}
+
+struct ThreadBuffers {
+    Buffers buffers;
+
+    ~ThreadBuffers() {
+        // give what this thread had cached back to the other threads before it goes away
+        auto& shared = sharedBuffers();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        auto spaceInShared = MAX_SHARED_BUFFERS - std::min(MAX_SHARED_BUFFERS, shared.buffers.size());
+        transferBuffers(buffers, shared.buffers, spaceInShared);
+    }
+};
+
+static thread_local ThreadBuffers threadBuffers;
+
+std::unique_ptr<char[]> PacketBufferPool::acquire() {
+    auto& buffers = threadBuffers.buffers;
+
+    if (buffers.empty()) {
+        auto& shared = sharedBuffers();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        transferBuffers(shared.buffers, buffers, BUFFER_TRANSFER_BATCH_SIZE);
+    }
+
+    if (buffers.empty()) {
+        ++numMisses;
+        return std::unique_ptr<char[]>(new char[MAX_PACKET_SIZE]);
+    }
+
+    ++numHits;
+    auto buffer = std::move(buffers.back());
+    buffers.pop_back();
+    return buffer;
+}
+
+void PacketBufferPool::release(std::unique_ptr<char[]> buffer) {
+    if (!buffer) {
+        return;
+    }
+
+    auto& buffers = threadBuffers.buffers;
+    buffers.push_back(std::move(buffer));
+
+    if (buffers.size() > MAX_THREAD_BUFFERS) {
+        // this thread frees more packets than it allocates, spill half of its freelist to the shared one
+        auto& shared = sharedBuffers();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+
+        auto spaceInShared = MAX_SHARED_BUFFERS - std::min(MAX_SHARED_BUFFERS, shared.buffers.size());
+        transferBuffers(buffers, shared.buffers, std::min(BUFFER_TRANSFER_BATCH_SIZE, spaceInShared));
+
+        // if the shared freelist is full too the remaining extra buffers are simply freed
+        if (buffers.size() > MAX_THREAD_BUFFERS) {
+            buffers.resize(MAX_THREAD_BUFFERS);
+        }
+    }
+}
+
+quint64 PacketBufferPool::getNumHits() {
+    return numHits;
+}
+
+quint64 PacketBufferPool::getNumMisses() {
+    return numMisses;
+}
@@ -0,0 +1,41 @@
+//
+//  PacketBufferPool.h
+//  libraries/networking/src/udt
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_PacketBufferPool_h
+#define hifi_PacketBufferPool_h
+
+#include <memory>
+
+#include <QtCore/QtGlobal>
+
+namespace udt {
+
+// Recycles MAX_PACKET_SIZE packet buffers so that the send and receive paths do not hit the allocator for every packet.
+// Each thread keeps a small freelist of its own, and spills to (or refills from) a shared freelist when that gets
+// too long (or runs out). Packets are routinely created on one thread and destroyed on another, so the shared freelist
+// is what lets buffers flow back to the threads that allocate them.
+class PacketBufferPool {
+public:
+    // returns a MAX_PACKET_SIZE buffer, from a freelist if possible - the contents are not initialized
+    static std::unique_ptr<char[]> acquire();
+
+    // hands a MAX_PACKET_SIZE buffer that came from acquire back to the pool
+    static void release(std::unique_ptr<char[]> buffer);
+
+    // running totals of acquire calls that were served by a freelist or needed a new allocation
+    static quint64 getNumHits();
+    static quint64 getNumMisses();
+};
+
+}
+
+#endif // hifi_PacketBufferPool_h
@@ -39,12 +39,14 @@ const QSet<PacketType> NON_SOURCED_PACKETS = QSet<PacketType>()
     << PacketType::ICEServerPeerInformation << PacketType::ICEServerQuery << PacketType::ICEServerHeartbeat
     << PacketType::ICEServerHeartbeatACK << PacketType::ICEPing << PacketType::ICEPingReply
     << PacketType::ICEServerHeartbeatDenied << PacketType::AssignmentClientStatus << PacketType::StopNode
-    << PacketType::DomainServerRemovedNode;
+    << PacketType::DomainServerRemovedNode << PacketType::CoalescedPackets << PacketType::ICEServerRelay;
 
 PacketVersion versionForPacketType(PacketType packetType) {
     switch (packetType) {
         case PacketType::DomainList:
-            return static_cast<PacketVersion>(DomainListVersion::PermissionsGrid);
+            return static_cast<PacketVersion>(DomainListVersion::VersionedDeltas);
+        case PacketType::DomainListRequest:
+            return static_cast<PacketVersion>(DomainListRequestVersion::KnownListVersion);
         case PacketType::EntityAdd:
         case PacketType::EntityEdit:
         case PacketType::EntityData:
@@ -52,14 +54,20 @@ PacketVersion versionForPacketType(PacketType packetType) {
         case PacketType::AvatarIdentity:
         case PacketType::AvatarData:
         case PacketType::BulkAvatarData:
+        case PacketType::ReplicatedBulkAvatarData:
         case PacketType::KillAvatar:
-            return static_cast<PacketVersion>(AvatarMixerPacketVersion::HandControllerJoints);
+        case PacketType::AvatarEntityDataRequest:
+        case PacketType::AvatarEntityData:
+            return static_cast<PacketVersion>(AvatarMixerPacketVersion::AvatarEntityVersions);
         case PacketType::ICEServerHeartbeat:
             return 18; // ICE Server Heartbeat signing
         case PacketType::AssetGetInfo:
         case PacketType::AssetGet:
         case PacketType::AssetUpload:
             return static_cast<PacketVersion>(AssetServerPacketVersion::VegasCongestionControl);
+        case PacketType::AssetMappingOperation:
+        case PacketType::AssetMappingOperationReply:
+            return static_cast<PacketVersion>(AssetServerPacketVersion::BatchedMappings);
         case PacketType::NodeIgnoreRequest:
             return 18; // Introduction of node ignore request (which replaced an unused packet tpye)
 
@@ -74,11 +82,12 @@ PacketVersion versionForPacketType(PacketType packetType) {
 
         case PacketType::MixedAudio:
         case PacketType::SilentAudioFrame:
+        case PacketType::SilentAudioRun:
         case PacketType::InjectAudio:
         case PacketType::MicrophoneAudioNoEcho:
         case PacketType::MicrophoneAudioWithEcho:
         case PacketType::AudioStreamStats:
-            return static_cast<PacketVersion>(AudioVersion::TerminatingStreamStats);
+            return static_cast<PacketVersion>(AudioVersion::SilentAudioRuns);
 
         default:
             return 17;
@@ -100,7 +100,13 @@ public:
         MoreEntityShapes,
         NodeKickRequest,
         NodeMuteRequest,
-        LAST_PACKET_TYPE = NodeMuteRequest
+        SilentAudioRun,
+        ReplicatedBulkAvatarData,
+        CoalescedPackets,
+        ICEServerRelay,
+        AvatarEntityDataRequest,
+        AvatarEntityData,
+        LAST_PACKET_TYPE = AvatarEntityData
     };
 };
 
@@ -192,7 +198,8 @@ const PacketVersion VERSION_ENTITIES_ARROW_ACTION = 64;
 const PacketVersion VERSION_ENTITIES_LAST_EDITED_BY = 65;
 
 enum class AssetServerPacketVersion: PacketVersion {
-    VegasCongestionControl = 19
+    VegasCongestionControl = 19,
+    BatchedMappings
 };
 
 enum class AvatarMixerPacketVersion : PacketVersion {
@@ -201,7 +208,9 @@ enum class AvatarMixerPacketVersion : PacketVersion {
     AvatarEntities,
     AbsoluteSixByteRotations,
     SensorToWorldMat,
-    HandControllerJoints
+    HandControllerJoints,
+    CoarseJointRotations,
+    AvatarEntityVersions
 };
 
 enum class DomainConnectRequestVersion : PacketVersion {
@@ -223,7 +232,12 @@ enum class DomainServerAddedNodeVersion : PacketVersion {
 
 enum class DomainListVersion : PacketVersion {
     PrePermissionsGrid = 18,
-    PermissionsGrid
+    PermissionsGrid,
+    VersionedDeltas
+};
+
+enum class DomainListRequestVersion : PacketVersion {
+    KnownListVersion = 18
 };
 
 enum class AudioVersion : PacketVersion {
@@ -231,6 +245,7 @@ enum class AudioVersion : PacketVersion {
     CodecNameInAudioPackets,
     Exactly10msAudioPackets,
     TerminatingStreamStats,
+    SilentAudioRuns,
 };
 
 #endif // hifi_PacketHeaders_h
@@ -43,6 +43,7 @@ PacketQueue::PacketPointer PacketQueue::takePacket() {
     // Take front packet
     auto packet = std::move(channel.front());
     channel.pop_front();
+    --_numPackets;
 
     // Remove now empty channel (Don't remove the main channel)
     if (channel.empty() && _currentIndex != 0) {
@@ -59,16 +60,19 @@ unsigned int PacketQueue::nextIndex() {
     return _currentIndex;
 }
 
-void PacketQueue::queuePacket(PacketPointer packet) {
+size_t PacketQueue::queuePacket(PacketPointer packet) {
     LockGuard locker(_packetsLock);
     _channels.front().push_back(std::move(packet));
+    return ++_numPackets;
 }
 
-void PacketQueue::queuePacketList(PacketListPointer packetList) {
+size_t PacketQueue::queuePacketList(PacketListPointer packetList) {
     if (packetList->isOrdered()) {
         packetList->preparePackets(getNextMessageNumber());
     }
 
     LockGuard locker(_packetsLock);
+    _numPackets += packetList->_packets.size();
     _channels.push_back(std::move(packetList->_packets));
+    return _numPackets;
 }
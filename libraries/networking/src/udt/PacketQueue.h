@@ -34,8 +34,9 @@ class PacketQueue {
     using Channels = std::vector<Channel>;
     
 public:
-    void queuePacket(PacketPointer packet);
-    void queuePacketList(PacketListPointer packetList);
+    // both return the number of packets queued, this one included
+    size_t queuePacket(PacketPointer packet);
+    size_t queuePacketList(PacketListPointer packetList);
     
     bool isEmpty() const;
     PacketPointer takePacket();
@@ -51,6 +52,7 @@ private:
     mutable Mutex _packetsLock; // Protects the packets to be sent.
     Channels _channels = Channels(1); // One channel per packet list + Main channel
     unsigned int _currentIndex { 0 };
+    size_t _numPackets { 0 };
 };
 
 }
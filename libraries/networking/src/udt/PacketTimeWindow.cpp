@@ -11,7 +11,6 @@
 
 #include "PacketTimeWindow.h"
 
-#include <numeric>
 #include <cmath>
 
 #include <NumericalConstants.h>
@@ -22,104 +21,102 @@ using namespace std::chrono;
 static const int DEFAULT_PACKET_INTERVAL_MICROSECONDS = 1000000; // 1s
 static const int DEFAULT_PROBE_INTERVAL_MICROSECONDS = 1000; // 1ms
 
-PacketTimeWindow::PacketTimeWindow(int numPacketIntervals, int numProbeIntervals) :
-    _numPacketIntervals(numPacketIntervals),
-    _numProbeIntervals(numProbeIntervals),
-    _packetIntervals(_numPacketIntervals, DEFAULT_PACKET_INTERVAL_MICROSECONDS),
-    _probeIntervals(_numProbeIntervals, DEFAULT_PROBE_INTERVAL_MICROSECONDS)
+// the intervals more than this many times longer or shorter than the median are left out of the mean
+static const double MEDIAN_FILTERING_BOUND_MULTIPLIER = 8.0;
+
+PacketTimeWindow::IntervalEstimator::IntervalEstimator(int numIntervals, double defaultInterval) :
+    _weight(1.0 / numIntervals),
+    _defaultInterval(defaultInterval),
+    _medianInterval(defaultInterval),
+    _meanInterval(defaultInterval)
 {
-    
-}
 
-void PacketTimeWindow::reset() {
-    _packetIntervals.assign(_numPacketIntervals, DEFAULT_PACKET_INTERVAL_MICROSECONDS);
-    _probeIntervals.assign(_numProbeIntervals, DEFAULT_PROBE_INTERVAL_MICROSECONDS);
 }
 
-template <typename Iterator>
-int median(Iterator begin, Iterator end) {
-    // use std::nth_element to grab the middle - for an even number of elements this is the upper middle
-    Iterator middle = begin + (end - begin) / 2;
-    std::nth_element(begin, middle, end);
-    
-    if ((end - begin) % 2 != 0) {
-        // odd number of elements, just return the middle
-        return *middle;
-    } else {
-        // even number of elements, return the mean of the upper middle and the lower middle
-        Iterator lowerMiddle = std::max_element(begin, middle);
-        return (*middle + *lowerMiddle) / 2;
-    }
+void PacketTimeWindow::IntervalEstimator::reset() {
+    _medianInterval = _defaultInterval;
+    _meanInterval = _defaultInterval;
+    _acceptedRatio = 1.0;
 }
 
-int32_t meanOfMedianFilteredValues(std::vector<int> intervals, int numValues, int valuesRequired = 0) {
-    // grab the median value of the intervals vector
-    int intervalsMedian = median(intervals.begin(), intervals.end());
-    
-    // figure out our bounds for median filtering
-    static const int MEDIAN_FILTERING_BOUND_MULTIPLIER = 8;
-    int upperBound = intervalsMedian * MEDIAN_FILTERING_BOUND_MULTIPLIER;
-    int lowerBound = intervalsMedian / MEDIAN_FILTERING_BOUND_MULTIPLIER;
-    
-    int sum = 0;
-    int count = 0;
-    
-    // sum the values that are inside the median filtered bounds
-    for (auto& interval : intervals) {
-        if ((interval < upperBound) && (interval > lowerBound)) {
-            ++count;
-            sum += interval;
+void PacketTimeWindow::IntervalEstimator::addInterval(double interval) {
+    // a step relative to the median reaches intervals orders of magnitude away from it in a few windows
+    _medianInterval *= (interval > _medianInterval) ? (1.0 + _weight) : (1.0 - _weight);
+
+    double upperBound = _medianInterval * MEDIAN_FILTERING_BOUND_MULTIPLIER;
+    double lowerBound = _medianInterval / MEDIAN_FILTERING_BOUND_MULTIPLIER;
+    bool isAccepted = interval < upperBound && interval > lowerBound;
+
+    if (isAccepted) {
+        if (_meanInterval < upperBound && _meanInterval > lowerBound) {
+            _meanInterval += _weight * (interval - _meanInterval);
+        } else {
+            // the mean was left behind by the median, start it over from here
+            _meanInterval = interval;
         }
     }
+    _acceptedRatio += _weight * ((isAccepted ? 1.0 : 0.0) - _acceptedRatio);
+}
+
+PacketTimeWindow::PacketTimeWindow(int numPacketIntervals, int numProbeIntervals) :
+    _packetIntervals(numPacketIntervals, DEFAULT_PACKET_INTERVAL_MICROSECONDS),
+    _probeIntervals(numProbeIntervals, DEFAULT_PROBE_INTERVAL_MICROSECONDS)
+{
     
-    // make sure we hit our threshold of values required
-    if (count >= valuesRequired) {
-        // return the frequency (per second) for the mean interval
-        static const double USECS_PER_SEC = 1000000.0;
-        return (int32_t) ceil(USECS_PER_SEC / (((double) sum) / ((double) count)));
-    } else {
-        return 0;
-    }
+}
+
+void PacketTimeWindow::reset() {
+    _packetIntervals.reset();
+    _probeIntervals.reset();
+}
+
+static int32_t frequencyForInterval(double interval) {
+    // return the frequency (per second) for the mean interval
+    static const double USECS_PER_SEC = 1000000.0;
+    return (int32_t) ceil(USECS_PER_SEC / interval);
 }
 
 int32_t PacketTimeWindow::getPacketReceiveSpeed() const {
-    // return the mean value of median filtered values (per second) - or zero if there are too few filtered values
-    return meanOfMedianFilteredValues(_packetIntervals, _numPacketIntervals, _numPacketIntervals / 2);
+    // the frequency of the mean interval - or zero if too few of the recent intervals were close to the median
+    static const double MIN_ACCEPTED_RATIO = 0.5;
+    if (_packetIntervals.getAcceptedRatio() < MIN_ACCEPTED_RATIO) {
+        return 0;
+    }
+    return frequencyForInterval(_packetIntervals.getMeanInterval());
 }
 
 int32_t PacketTimeWindow::getEstimatedBandwidth() const {
-    // return mean value of median filtered values (per second)
-    return meanOfMedianFilteredValues(_probeIntervals, _numProbeIntervals);
+    return frequencyForInterval(_probeIntervals.getMeanInterval());
 }
 
-void PacketTimeWindow::onPacketArrival() {
-    
-    // take the current time
-    auto now = p_high_resolution_clock::now();
-    
-    if (_packetIntervals.size() > 0) {
-        // record the interval between this packet and the last one
-        _packetIntervals[_currentPacketInterval++] = duration_cast<microseconds>(now - _lastPacketTime).count();
-        
-        // reset the currentPacketInterval index when it wraps
-        _currentPacketInterval %= _numPacketIntervals;
+void PacketTimeWindow::onPacketArrival(p_high_resolution_clock::time_point arrivalTime) {
+    if (arrivalTime <= _lastPacketTime) {
+        // read in the same batch as the last one, or by another receive thread just before it
+        ++_numPacketsAtLastPacketTime;
+        return;
     }
-    
+
+    // the interval since the last batch is spread over the packets of that batch
+    auto interval = duration_cast<microseconds>(arrivalTime - _lastPacketTime).count();
+    double intervalPerPacket = (double) interval / _numPacketsAtLastPacketTime;
+    for (int i = 0; i < _numPacketsAtLastPacketTime; ++i) {
+        _packetIntervals.addInterval(intervalPerPacket);
+    }
+
     // remember this as the last packet arrival time
-    _lastPacketTime = now;
+    _lastPacketTime = arrivalTime;
+    _numPacketsAtLastPacketTime = 1;
 }
 
-void PacketTimeWindow::onProbePair1Arrival() {
-    // take the current time as the first probe time
-    _firstProbeTime = p_high_resolution_clock::now();
+void PacketTimeWindow::onProbePair1Arrival(p_high_resolution_clock::time_point arrivalTime) {
+    // take the arrival time as the first probe time
+    _firstProbeTime = arrivalTime;
 }
 
-void PacketTimeWindow::onProbePair2Arrival() {
-    // store the interval between the two probes
-    auto now = p_high_resolution_clock::now();
-    
-    _probeIntervals[_currentProbeInterval++] = duration_cast<microseconds>(now - _firstProbeTime).count();
-    
-    // reset the currentProbeInterval index when it wraps
-    _currentProbeInterval %= _numProbeIntervals;
+void PacketTimeWindow::onProbePair2Arrival(p_high_resolution_clock::time_point arrivalTime) {
+    // a pair read in the same batch says nothing of the bandwidth
+    auto interval = duration_cast<microseconds>(arrivalTime - _firstProbeTime).count();
+    if (interval > 0) {
+        _probeIntervals.addInterval((double) interval);
+    }
 }
@@ -20,29 +20,48 @@
 
 namespace udt {
     
+// Estimates the rate packets arrive at and the bandwidth from the intervals between the probe pairs. The intervals go
+// through running estimators instead of being kept in windows, so that neither an arrival nor a query has to go over them.
 class PacketTimeWindow {
 public:
     PacketTimeWindow(int numPacketIntervals = 16, int numProbeIntervals = 16);
     
-    void onPacketArrival();
-    void onProbePair1Arrival();
-    void onProbePair2Arrival();
+    // the packets read from the socket together share their arrival time
+    void onPacketArrival(p_high_resolution_clock::time_point arrivalTime);
+    void onProbePair1Arrival(p_high_resolution_clock::time_point arrivalTime);
+    void onProbePair2Arrival(p_high_resolution_clock::time_point arrivalTime);
     
     int32_t getPacketReceiveSpeed() const;
     int32_t getEstimatedBandwidth() const;
     
     void reset();
-private:    
-    int _numPacketIntervals { 0 }; // the number of packet intervals to store
-    int _numProbeIntervals { 0 }; // the number of probe intervals to store
-    
-    int _currentPacketInterval { 0 }; // index for the current packet interval
-    int _currentProbeInterval { 0 }; // index for the current probe interval
-    
-    std::vector<int> _packetIntervals; // vector of microsecond intervals between packet arrivals
-    std::vector<int> _probeIntervals; // vector of microsecond intervals between probe pair arrivals
+private:
+    // the incremental counterpart of taking the mean of the intervals of a window that are close to its median: the
+    // median estimate moves a step towards each interval, and only the intervals close to it update the mean
+    class IntervalEstimator {
+    public:
+        IntervalEstimator(int numIntervals, double defaultInterval);
+
+        void addInterval(double interval);
+        void reset();
+
+        double getMeanInterval() const { return _meanInterval; }
+        double getAcceptedRatio() const { return _acceptedRatio; } // running ratio of the intervals close to the median
+
+    private:
+        double _weight;
+        double _defaultInterval;
+
+        double _medianInterval;
+        double _meanInterval;
+        double _acceptedRatio { 1.0 };
+    };
+
+    IntervalEstimator _packetIntervals; // of the microsecond intervals between packet arrivals
+    IntervalEstimator _probeIntervals; // of the microsecond intervals between probe pair arrivals
     
     p_high_resolution_clock::time_point _lastPacketTime = p_high_resolution_clock::now(); // the time_point when last packet arrived
+    int _numPacketsAtLastPacketTime { 1 }; // the packets that arrived at _lastPacketTime
     p_high_resolution_clock::time_point _firstProbeTime = p_high_resolution_clock::now(); // the time_point when first probe in pair arrived
 };
     
@@ -13,12 +13,10 @@
 
 #include <algorithm>
 #include <random>
-#include <thread>
 
 #include <QtCore/QCoreApplication>
 #include <QtCore/QDateTime>
 #include <QtCore/QJsonObject>
-#include <QtCore/QThread>
 
 #include <LogHandler.h>
 #include <NumericalConstants.h>
@@ -29,6 +27,7 @@
 #include "Packet.h"
 #include "PacketList.h"
 #include "../UserActivityLogger.h"
+#include "SendQueueWorkerPool.h"
 #include "Socket.h"
 
 using namespace udt;
@@ -63,19 +62,8 @@ std::unique_ptr<SendQueue> SendQueue::create(Socket* socket, HifiSockAddr destin
     
     auto queue = std::unique_ptr<SendQueue>(new SendQueue(socket, destination));
 
-    // Setup queue private thread
-    QThread* thread = new QThread;
-    thread->setObjectName("Networking: SendQueue " + destination.objectName()); // Name thread for easier debug
-    
-    connect(thread, &QThread::started, queue.get(), &SendQueue::run);
-    
-    connect(queue.get(), &QObject::destroyed, thread, &QThread::quit); // Thread auto cleanup
-    connect(thread, &QThread::finished, thread, &QThread::deleteLater); // Thread auto cleanup
-    
-    // Move queue to private thread and start it
-    queue->moveToThread(thread);
-    
-    thread->start();
+    // from here on a send worker steps the queue, starting with the handshake
+    SendQueueWorkerPool::getInstance().add(queue.get());
     
     return queue;
 }
@@ -102,35 +90,41 @@ SendQueue::SendQueue(Socket* socket, HifiSockAddr dest) :
     _lastReceiverResponse = QDateTime::currentMSecsSinceEpoch();
 }
 
+SendQueue::~SendQueue() {
+    // waits for a step that is in progress on the worker
+    SendQueueWorkerPool::getInstance().remove(this);
+}
+
+Histogram& SendQueue::getQueueDepths() {
+    static Histogram queueDepths;
+    return queueDepths;
+}
+
 void SendQueue::queuePacket(std::unique_ptr<Packet> packet) {
-    _packets.queuePacket(std::move(packet));
-    
-    // call notify_one on the condition_variable_any in case the send thread is sleeping waiting for packets
-    _emptyCondition.notify_one();
+    getQueueDepths().record(_packets.queuePacket(std::move(packet)));
     
-    if (!this->thread()->isRunning() && _state == State::NotStarted) {
-        this->thread()->start();
-    }
+    // wake the queue in case it is waiting for packets
+    wake();
 }
 
 void SendQueue::queuePacketList(std::unique_ptr<PacketList> packetList) {
-    _packets.queuePacketList(std::move(packetList));
-    
-    // call notify_one on the condition_variable_any in case the send thread is sleeping waiting for packets
-    _emptyCondition.notify_one();
+    getQueueDepths().record(_packets.queuePacketList(std::move(packetList)));
     
-    if (!this->thread()->isRunning() && _state == State::NotStarted) {
-        this->thread()->start();
-    }
+    // wake the queue in case it is waiting for packets
+    wake();
 }
 
 void SendQueue::stop() {
     
     _state = State::Stopped;
     
-    // Notify all conditions in case we're waiting somewhere
-    _handshakeACKCondition.notify_one();
-    _emptyCondition.notify_one();
+    // wake the queue in case it is waiting, so that it stops now
+    wake();
+}
+
+void SendQueue::wake() {
+    _wasWoken = true;
+    SendQueueWorkerPool::getInstance().wake(this);
 }
     
 int SendQueue::sendPacket(const Packet& packet) {
@@ -163,8 +157,8 @@ void SendQueue::ack(SequenceNumber ack) {
     
     _lastACKSequenceNumber = (uint32_t) ack;
 
-    // call notify_one on the condition_variable_any in case the send thread is sleeping with a full congestion window
-    _emptyCondition.notify_one();
+    // wake the queue in case it is waiting with a full congestion window
+    wake();
 }
 
 void SendQueue::nak(SequenceNumber start, SequenceNumber end) {
@@ -176,8 +170,8 @@ void SendQueue::nak(SequenceNumber start, SequenceNumber end) {
         _naks.insert(start, end);
     }
     
-    // call notify_one on the condition_variable_any in case the send thread is sleeping waiting for losses to re-send
-    _emptyCondition.notify_one();
+    // wake the queue in case it is waiting for losses to re-send
+    wake();
 }
 
 void SendQueue::fastRetransmit(udt::SequenceNumber ack) {
@@ -186,8 +180,8 @@ void SendQueue::fastRetransmit(udt::SequenceNumber ack) {
         _naks.insert(ack, ack);
     }
 
-    // call notify_one on the condition_variable_any in case the send thread is sleeping waiting for losses to re-send
-    _emptyCondition.notify_one();
+    // wake the queue in case it is waiting for losses to re-send
+    wake();
 }
 
 void SendQueue::overrideNAKListFromPacket(ControlPacket& packet) {
@@ -196,49 +190,27 @@ void SendQueue::overrideNAKListFromPacket(ControlPacket& packet) {
 
     {
         std::lock_guard<std::mutex> nakLocker(_naksLock);
-        _naks.clear();
-        
-        SequenceNumber first, second;
-        while (packet.bytesLeftToRead() >= (qint64)(2 * sizeof(SequenceNumber))) {
-            packet.readPrimitive(&first);
-            packet.readPrimitive(&second);
-            
-            if (first == second) {
-                _naks.append(first);
-            } else {
-                _naks.append(first, second);
-            }
-        }
+        _naks.read(packet);
     }
     
-    // call notify_one on the condition_variable_any in case the send thread is sleeping waiting for losses to re-send
-    _emptyCondition.notify_one();
+    // wake the queue in case it is waiting for losses to re-send
+    wake();
 }
 
 void SendQueue::sendHandshake() {
-    std::unique_lock<std::mutex> handshakeLock { _handshakeMutex };
-    if (!_hasReceivedHandshakeACK) {
-        // we haven't received a handshake ACK from the client, send another now
-        auto handshakePacket = ControlPacket::create(ControlPacket::Handshake, sizeof(SequenceNumber));
+    // we haven't received a handshake ACK from the client, send another now
+    auto handshakePacket = ControlPacket::create(ControlPacket::Handshake, sizeof(SequenceNumber));
 
-        handshakePacket->writePrimitive(_initialSequenceNumber);
-        _socket->writeBasePacket(*handshakePacket, _destination);
-        
-        // we wait for the ACK or the re-send interval to expire
-        static const auto HANDSHAKE_RESEND_INTERVAL = std::chrono::milliseconds(100);
-        _handshakeACKCondition.wait_for(handshakeLock, HANDSHAKE_RESEND_INTERVAL);
-    }
+    handshakePacket->writePrimitive(_initialSequenceNumber);
+    _socket->writeBasePacket(*handshakePacket, _destination);
 }
 
 void SendQueue::handshakeACK(SequenceNumber initialSequenceNumber) {
     if (initialSequenceNumber == _initialSequenceNumber) {
-        {
-            std::lock_guard<std::mutex> locker { _handshakeMutex };
-            _hasReceivedHandshakeACK = true;
-        }
+        _hasReceivedHandshakeACK = true;
 
-        // Notify on the handshake ACK condition
-        _handshakeACKCondition.notify_one();
+        // wake the queue so it starts sending right away
+        wake();
     }
 }
 
@@ -285,38 +257,53 @@ bool SendQueue::sendNewPacketAndAddToSentList(std::unique_ptr<Packet> newPacket,
     }
 }
 
-void SendQueue::run() {
-    if (_state == State::Stopped) {
-        // we've already been asked to stop before we even got a chance to start
-        // don't start now
-#ifdef UDT_CONNECTION_DEBUG
-        qDebug() << "SendQueue asked to run after being told to stop. Will not run.";
-#endif
-        return;
-    } else if (_state == State::Running) {
-#ifdef UDT_CONNECTION_DEBUG
-        qDebug() << "SendQueue asked to run but is already running (according to state). Will not re-run.";
-#endif
-        return;
+bool SendQueue::step(p_high_resolution_clock::time_point& nextStepTime) {
+    auto notStarted = State::NotStarted;
+    if (!_state.compare_exchange_strong(notStarted, State::Running) && _state != State::Running) {
+        // we've been asked to stop
+        return false;
     }
-    
-    _state = State::Running;
-    
-    // Wait for handshake to be complete
-    while (_state == State::Running && !_hasReceivedHandshakeACK) {
-        sendHandshake();
 
-        // Keep processing events
-        QCoreApplication::sendPostedEvents(this);
-        
-        // Once we're here we've either received the handshake ACK or it's going to be time to re-send a handshake.
-        // Either way let's continue processing - no packets will be sent if no handshake ACK has been received.
+    auto now = p_high_resolution_clock::now();
+
+    if (_wasWoken.exchange(false)) {
+        // whatever we were waiting for may have changed, so any wait starts over
+        _waitStartTime = p_high_resolution_clock::time_point();
     }
 
-    // Keep an HRC to know when the next packet should have been
-    auto nextPacketTimestamp = p_high_resolution_clock::now();
+    if (!_hasReceivedHandshakeACK) {
+        // wait for handshake to be complete, re-sending the handshake until it is
+        static const auto HANDSHAKE_RESEND_INTERVAL = std::chrono::milliseconds(100);
+
+        if (now >= _nextHandshakeTime) {
+            sendHandshake();
+            _nextHandshakeTime = now + HANDSHAKE_RESEND_INTERVAL;
+        }
+
+        nextStepTime = _nextHandshakeTime;
+        return true;
+    }
+
+    if (!_hasStartedSending) {
+        // keep an HRC to know when the next packet should have been
+        _nextPacketTimestamp = now;
+        _hasStartedSending = true;
+    }
+
+    if (hasReceiverTimedOut()) {
+        return false;
+    }
+
+    // a step sends at most this many packets, so that the other queues of the worker get their turn
+    static const int MAX_PACKETS_PER_STEP = 32;
+
+    for (int i = 0; i < MAX_PACKETS_PER_STEP; ++i) {
+        if (_packetSendPeriod > 0 && now < _nextPacketTimestamp) {
+            // not yet time for the next packet
+            nextStepTime = _nextPacketTimestamp;
+            return true;
+        }
 
-    while (_state == State::Running) {
         bool attemptedToSendPacket = maybeResendPacket();
         
         // if we didn't find a packet to re-send AND we think we can fit a new packet on the wire
@@ -327,71 +314,68 @@ void SendQueue::run() {
             attemptedToSendPacket = (newPacketCount > 0);
         }
         
-        // since we're a while loop, give the thread a chance to process events
-        QCoreApplication::sendPostedEvents(this);
-        
-        // we just processed events so check now if we were just told to stop
-        // If the send queue has been innactive, skip the sleep for
-        // Either _isRunning will have been set to false and we'll break
-        // Or something happened and we'll keep going
-        if (_state != State::Running || isInactive(attemptedToSendPacket)) {
-            return;
+        // check now if we were just told to stop
+        if (_state != State::Running) {
+            return false;
+        }
+
+        if (!attemptedToSendPacket) {
+            // nothing to send, wait for something to change
+            return waitForActivity(now, nextStepTime);
         }
 
+        _waitStartTime = p_high_resolution_clock::time_point();
+
         if (_packetSendPeriod > 0) {
             // push the next packet timestamp forwards by the current packet send period
             auto nextPacketDelta = (newPacketCount == 2 ? 2 : 1) * _packetSendPeriod;
-            nextPacketTimestamp += std::chrono::microseconds(nextPacketDelta);
+            _nextPacketTimestamp += std::chrono::microseconds(nextPacketDelta);
 
-            // sleep as long as we need for next packet send, if we can
-            auto now = p_high_resolution_clock::now();
+            now = p_high_resolution_clock::now();
 
-            auto timeToSleep = duration_cast<microseconds>(nextPacketTimestamp - now);
-
-            // we use nextPacketTimestamp so that we don't fall behind, not to force long sleeps
-            // we'll never allow nextPacketTimestamp to force us to sleep for more than nextPacketDelta
+            // we use nextPacketTimestamp so that we don't fall behind, not to force long waits
+            // we'll never allow nextPacketTimestamp to force us to wait for more than nextPacketDelta
             // so cap it to that value
-            if (timeToSleep > std::chrono::microseconds(nextPacketDelta)) {
-                // reset the nextPacketTimestamp so that it is correct next time we come around
-                nextPacketTimestamp = now + std::chrono::microseconds(nextPacketDelta);
-
-                timeToSleep = std::chrono::microseconds(nextPacketDelta);
+            if (_nextPacketTimestamp - now > std::chrono::microseconds(nextPacketDelta)) {
+                _nextPacketTimestamp = now + std::chrono::microseconds(nextPacketDelta);
             }
 
-            // we're seeing SendQueues sleep for a long period of time here,
-            // which can lock the NodeList if it's attempting to clear connections
-            // for now we guard this by capping the time this thread and sleep for
-
-            const microseconds MAX_SEND_QUEUE_SLEEP_USECS { 2000000 };
-            if (timeToSleep > MAX_SEND_QUEUE_SLEEP_USECS) {
-                qWarning() << "udt::SendQueue wanted to sleep for" << timeToSleep.count() << "microseconds";
-                qWarning() << "Capping sleep to" << MAX_SEND_QUEUE_SLEEP_USECS.count();
+            // we've seen SendQueues wait for a long period of time here, guard against it while we find out why
+            const microseconds MAX_SEND_QUEUE_WAIT_USECS { 2000000 };
+            auto timeToWait = duration_cast<microseconds>(_nextPacketTimestamp - now);
+            if (timeToWait > MAX_SEND_QUEUE_WAIT_USECS) {
+                qWarning() << "udt::SendQueue wanted to wait for" << timeToWait.count() << "microseconds";
+                qWarning() << "Capping wait to" << MAX_SEND_QUEUE_WAIT_USECS.count();
                 qWarning() << "PSP:" << _packetSendPeriod << "NPD:" << nextPacketDelta
-                << "NPT:" << nextPacketTimestamp.time_since_epoch().count()
+                << "NPT:" << _nextPacketTimestamp.time_since_epoch().count()
                 << "NOW:" << now.time_since_epoch().count();
 
                 // alright, we're in a weird state
                 // we want to know why this is happening so we can implement a better fix than this guard
-                // send some details up to the API (if the user allows us) that indicate how we could such a large timeToSleep
+                // send some details up to the API (if the user allows us) that indicate how we could such a long wait
                 static const QString SEND_QUEUE_LONG_SLEEP_ACTION = "sendqueue-sleep";
 
                 // setup a json object with the details we want
                 QJsonObject longSleepObject;
-                longSleepObject["timeToSleep"] = qint64(timeToSleep.count());
+                longSleepObject["timeToSleep"] = qint64(timeToWait.count());
                 longSleepObject["packetSendPeriod"] = _packetSendPeriod.load();
                 longSleepObject["nextPacketDelta"] = nextPacketDelta;
-                longSleepObject["nextPacketTimestamp"] = qint64(nextPacketTimestamp.time_since_epoch().count());
+                longSleepObject["nextPacketTimestamp"] = qint64(_nextPacketTimestamp.time_since_epoch().count());
                 longSleepObject["then"] = qint64(now.time_since_epoch().count());
 
                 // hopefully send this event using the user activity logger
                 UserActivityLogger::getInstance().logAction(SEND_QUEUE_LONG_SLEEP_ACTION, longSleepObject);
-                
-                timeToSleep = MAX_SEND_QUEUE_SLEEP_USECS;
+
+                _nextPacketTimestamp = now + MAX_SEND_QUEUE_WAIT_USECS;
             }
-            
-            std::this_thread::sleep_for(timeToSleep);
+        } else {
+            now = p_high_resolution_clock::now();
         }
     }
+
+    // we have more to send, but let the other queues go first
+    nextStepTime = now;
+    return true;
 }
 
 void SendQueue::setProbePacketEnabled(bool enabled) {
@@ -527,8 +511,8 @@ bool SendQueue::maybeResendPacket() {
     return false;
 }
 
-bool SendQueue::isInactive(bool attemptedToSendPacket) {
-    // check for connection timeout first
+bool SendQueue::hasReceiverTimedOut() {
+    // check for connection timeout
 
     // that will be the case if we have had 16 timeouts since hearing back from the client, and it has been
     // at least 5 seconds
@@ -552,69 +536,77 @@ bool SendQueue::isInactive(bool attemptedToSendPacket) {
         return true;
     }
 
-    if (!attemptedToSendPacket) {
-        // During our processing above we didn't send any packets
-        
-        // If that is still the case we should use a condition_variable_any to sleep until we have data to handle.
-        // To confirm that the queue of packets and the NAKs list are still both empty we'll need to use the DoubleLock
-        using DoubleLock = DoubleLock<std::recursive_mutex, std::mutex>;
-        DoubleLock doubleLock(_packets.getLock(), _naksLock);
-        DoubleLock::Lock locker(doubleLock, std::try_to_lock);
-        
-        if (locker.owns_lock() && (_packets.isEmpty() || isFlowWindowFull()) && _naks.isEmpty()) {
-            // The packets queue and loss list mutexes are now both locked and they're both empty
-            
-            if (uint32_t(_lastACKSequenceNumber) == uint32_t(_currentSequenceNumber)) {
-                // we've sent the client as much data as we have (and they've ACKed it)
-                // either wait for new data to send or 5 seconds before cleaning up the queue
-                static const auto EMPTY_QUEUES_INACTIVE_TIMEOUT = std::chrono::seconds(5);
-                
-                // use our condition_variable_any to wait
-                auto cvStatus = _emptyCondition.wait_for(locker, EMPTY_QUEUES_INACTIVE_TIMEOUT);
-                
-                if (cvStatus == std::cv_status::timeout && (_packets.isEmpty() || isFlowWindowFull()) && _naks.isEmpty()) {
+    return false;
+}
+
+bool SendQueue::waitForActivity(p_high_resolution_clock::time_point now,
+                                p_high_resolution_clock::time_point& nextStepTime) {
+    // During our processing we didn't send any packets, so unless that changes we wait to be woken.
+    // To confirm that the queue of packets and the NAKs list are still both empty we'll need to use the DoubleLock
+    using DoubleLock = DoubleLock<std::recursive_mutex, std::mutex>;
+    DoubleLock doubleLock(_packets.getLock(), _naksLock);
+    DoubleLock::Lock locker(doubleLock, std::try_to_lock);
+
+    if (!locker.owns_lock() || !((_packets.isEmpty() || isFlowWindowFull()) && _naks.isEmpty())) {
+        // something is being added, look again after the send period
+        nextStepTime = now + std::chrono::microseconds(_packetSendPeriod);
+        return true;
+    }
+
+    // The packets queue and loss list mutexes are now both locked and they're both empty
+    if (_waitStartTime == p_high_resolution_clock::time_point()) {
+        _waitStartTime = now;
+    }
+
+    if (uint32_t(_lastACKSequenceNumber) == uint32_t(_currentSequenceNumber)) {
+        // we've sent the client as much data as we have (and they've ACKed it)
+        // either wait for new data to send or 5 seconds before cleaning up the queue
+        static const auto EMPTY_QUEUES_INACTIVE_TIMEOUT = std::chrono::seconds(5);
+
+        if (now - _waitStartTime >= EMPTY_QUEUES_INACTIVE_TIMEOUT) {
 #ifdef UDT_CONNECTION_DEBUG
-                    qCDebug(networking) << "SendQueue to" << _destination << "has been empty for"
-                        << EMPTY_QUEUES_INACTIVE_TIMEOUT.count()
-                        << "seconds and receiver has ACKed all packets."
-                        << "The queue is now inactive and will be stopped.";
+            qCDebug(networking) << "SendQueue to" << _destination << "has been empty for"
+                << EMPTY_QUEUES_INACTIVE_TIMEOUT.count()
+                << "seconds and receiver has ACKed all packets."
+                << "The queue is now inactive and will be stopped.";
 #endif
 
-                    // we have the lock again - Make sure to unlock it
-                    locker.unlock();
-                    
-                    // Deactivate queue
-                    deactivate();
-                    return true;
-                }
+            // Make sure to unlock before we deactivate the queue
+            locker.unlock();
+            
+            deactivate();
+            return false;
+        }
 
-            } else {
-                // We think the client is still waiting for data (based on the sequence number gap)
-                // Let's wait either for a response from the client or until the estimated timeout
-                // (plus the sync interval to allow the client to respond) has elapsed
-                auto waitDuration = std::chrono::microseconds(_estimatedTimeout + _syncInterval);
-                
-                // use our condition_variable_any to wait
-                auto cvStatus = _emptyCondition.wait_for(locker, waitDuration);
-                
-                if (cvStatus == std::cv_status::timeout && (_packets.isEmpty() || isFlowWindowFull()) && _naks.isEmpty()
-                    && SequenceNumber(_lastACKSequenceNumber) < _currentSequenceNumber) {
-                    // after a timeout if we still have sent packets that the client hasn't ACKed we
-                    // add them to the loss list
-                    
-                    // Note that thanks to the DoubleLock we have the _naksLock right now
-                    _naks.append(SequenceNumber(_lastACKSequenceNumber) + 1, _currentSequenceNumber);
-
-                    // we have the lock again - time to unlock it
-                    locker.unlock();
-                    
-                    emit timeout();
-                }
-            }
+        nextStepTime = _waitStartTime + EMPTY_QUEUES_INACTIVE_TIMEOUT;
+    } else {
+        // We think the client is still waiting for data (based on the sequence number gap)
+        // Let's wait either for a response from the client or until the estimated timeout
+        // (plus the sync interval to allow the client to respond) has elapsed
+        auto waitDuration = std::chrono::microseconds(_estimatedTimeout + _syncInterval);
+
+        if (now - _waitStartTime >= waitDuration
+            && SequenceNumber(_lastACKSequenceNumber) < _currentSequenceNumber) {
+            // after a timeout if we still have sent packets that the client hasn't ACKed we
+            // add them to the loss list
+            
+            // Note that thanks to the DoubleLock we have the _naksLock right now
+            _naks.append(SequenceNumber(_lastACKSequenceNumber) + 1, _currentSequenceNumber);
+
+            // time to unlock
+            locker.unlock();
+
+            // re-send those right away
+            _waitStartTime = p_high_resolution_clock::time_point();
+            nextStepTime = now;
+            
+            emit timeout();
+        } else {
+            nextStepTime = _waitStartTime + waitDuration;
         }
     }
-    
-    return false;
+
+    return true;
 }
 
 void SendQueue::deactivate() {
@@ -13,7 +13,6 @@
 #define hifi_SendQueue_h
 
 #include <atomic>
-#include <condition_variable>
 #include <cstdint>
 #include <list>
 #include <memory>
@@ -23,6 +22,7 @@
 #include <QtCore/QObject>
 #include <QtCore/QReadWriteLock>
 
+#include <Histogram.h>
 #include <PortableHighResolutionClock.h>
 
 #include "../HifiSockAddr.h"
@@ -39,7 +39,9 @@ class ControlPacket;
 class Packet;
 class PacketList;
 class Socket;
+class SendQueueWorkerPool;
     
+// the packets of a reliable Connection waiting to be sent or ACKed - queues are stepped by the SendQueueWorkerPool
 class SendQueue : public QObject {
     Q_OBJECT
     
@@ -51,10 +53,14 @@ public:
     };
     
     static std::unique_ptr<SendQueue> create(Socket* socket, HifiSockAddr destination);
+    ~SendQueue();
     
     void queuePacket(std::unique_ptr<Packet> packet);
     void queuePacketList(std::unique_ptr<PacketList> packetList);
 
+    // the number of packets waiting in the queue of their connection as they are queued, for all the connections
+    static Histogram& getQueueDepths();
+
     SequenceNumber getCurrentSequenceNumber() const { return SequenceNumber(_atomicCurrentSequenceNumber); }
     
     void setFlowWindowSize(int flowWindowSize) { _flowWindowSize = flowWindowSize; }
@@ -85,14 +91,17 @@ signals:
     void shortCircuitLoss(quint32 sequenceNumber);
     void timeout();
     
-private slots:
-    void run();
-    
 private:
+    friend class SendQueueWorkerPool;
+
     SendQueue(Socket* socket, HifiSockAddr dest);
     SendQueue(SendQueue& other) = delete;
     SendQueue(SendQueue&& other) = delete;
     
+    // sends what is due and returns false once the queue stopped, or sets when it should be stepped again
+    bool step(p_high_resolution_clock::time_point& nextStepTime);
+    void wake(); // has the queue stepped right away, because something it may be waiting for changed
+
     void sendHandshake();
     
     int sendPacket(const Packet& packet);
@@ -101,7 +110,8 @@ private:
     int maybeSendNewPacket(); // Figures out what packet to send next
     bool maybeResendPacket(); // Determines whether to resend a packet and which one
     
-    bool isInactive(bool attemptedToSendPacket);
+    bool hasReceiverTimedOut();
+    bool waitForActivity(p_high_resolution_clock::time_point now, p_high_resolution_clock::time_point& nextStepTime);
     void deactivate(); // makes the queue inactive and cleans it up
 
     bool isFlowWindowFull() const;
@@ -137,14 +147,18 @@ private:
     using PacketResendPair = std::pair<uint8_t, std::unique_ptr<Packet>>; // Number of resend + packet ptr
     std::unordered_map<SequenceNumber, PacketResendPair> _sentPackets; // Packets waiting for ACK.
     
-    std::mutex _handshakeMutex; // Protects the handshake ACK condition_variable
     std::atomic<bool> _hasReceivedHandshakeACK { false }; // flag for receipt of handshake ACK from client
-    std::condition_variable _handshakeACKCondition;
-    
-    std::condition_variable_any _emptyCondition;
-
 
     std::atomic<bool> _shouldSendProbes { true };
+
+    // the following are only used by the worker stepping the queue, see SendQueueWorkerPool
+    std::mutex _stepMutex; // held while the queue steps
+    int _workerIndex { -1 };
+    std::atomic<bool> _wasWoken { false };
+    bool _hasStartedSending { false };
+    p_high_resolution_clock::time_point _nextHandshakeTime; // when to re-send the handshake
+    p_high_resolution_clock::time_point _nextPacketTimestamp; // when the next packet should be sent
+    p_high_resolution_clock::time_point _waitStartTime; // since when there has been nothing to send, if there hasn't
 };
     
 }
@@ -0,0 +1,217 @@
+//
+//  SendQueueWorkerPool.cpp
+//  libraries/networking/src/udt
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SendQueueWorkerPool.h"
+
+#include <algorithm>
+#include <cstdint>
+
+#include "SendQueue.h"
+
+using namespace udt;
+using namespace std::chrono;
+
+static const microseconds TICK { SendQueueWorkerPool::TICK_USECS };
+
+SendQueueWorkerPool& SendQueueWorkerPool::getInstance() {
+    // queues can still be deleted as the process exits, so the pool and its threads are intentionally never destroyed
+    static SendQueueWorkerPool* instance = [] {
+        int numWorkers = std::max((int)std::thread::hardware_concurrency() / 2, 1);
+        return new SendQueueWorkerPool(numWorkers < MAX_NUM_WORKERS ? numWorkers : MAX_NUM_WORKERS);
+    }();
+    return *instance;
+}
+
+SendQueueWorkerPool::SendQueueWorkerPool(int numWorkers) {
+    for (int i = 0; i < numWorkers; ++i) {
+        auto worker = new Worker;
+        worker->wheel.resize(NUM_WHEEL_SLOTS);
+        worker->currentSlotTime = p_high_resolution_clock::now();
+        _workers.emplace_back(worker);
+
+        worker->thread = std::thread([this, worker] { run(*worker); });
+        worker->thread.detach();
+    }
+}
+
+void SendQueueWorkerPool::add(SendQueue* queue) {
+    // pick the worker with the fewest queues
+    int workerIndex = 0;
+    size_t fewestQueues = SIZE_MAX;
+    for (size_t i = 0; i < _workers.size(); ++i) {
+        std::lock_guard<std::mutex> lock(_workers[i]->mutex);
+        if (_workers[i]->queues.size() < fewestQueues) {
+            fewestQueues = _workers[i]->queues.size();
+            workerIndex = (int)i;
+        }
+    }
+
+    auto& worker = *_workers[workerIndex];
+    queue->_workerIndex = workerIndex;
+
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    auto& scheduledQueue = worker.queues[queue];
+    scheduledQueue.isReady = true;
+    worker.readyQueues.push_back(queue);
+    worker.condition.notify_one();
+}
+
+void SendQueueWorkerPool::remove(SendQueue* queue) {
+    if (queue->_workerIndex < 0) {
+        return;
+    }
+
+    auto& worker = *_workers[queue->_workerIndex];
+    {
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.queues.erase(queue);
+
+        // the timers of the queue are left in the wheel, they are dropped as they come due
+        worker.readyQueues.erase(std::remove(worker.readyQueues.begin(), worker.readyQueues.end(), queue),
+                                 worker.readyQueues.end());
+    }
+
+    // once we have the step lock the worker is done with this queue
+    std::lock_guard<std::mutex> stepLock(queue->_stepMutex);
+    queue->_workerIndex = -1;
+}
+
+void SendQueueWorkerPool::wake(SendQueue* queue) {
+    if (queue->_workerIndex < 0) {
+        return;
+    }
+
+    auto& worker = *_workers[queue->_workerIndex];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+
+    auto it = worker.queues.find(queue);
+    if (it != worker.queues.end() && !it->second.isReady) {
+        it->second.isReady = true;
+        worker.readyQueues.push_back(queue);
+        worker.condition.notify_one();
+    }
+}
+
+void SendQueueWorkerPool::run(Worker& worker) {
+    std::vector<SendQueue*> dueQueues;
+
+    std::unique_lock<std::mutex> lock(worker.mutex);
+    while (true) {
+        dueQueues.swap(worker.readyQueues);
+        for (auto queue : dueQueues) {
+            // a queue that is woken while it steps gets stepped again
+            auto it = worker.queues.find(queue);
+            if (it != worker.queues.end()) {
+                it->second.isReady = false;
+            }
+        }
+
+        collectDueTimers(worker, p_high_resolution_clock::now(), dueQueues);
+
+        for (auto queue : dueQueues) {
+            stepQueue(worker, lock, queue);
+        }
+        dueQueues.clear();
+
+        if (!worker.readyQueues.empty()) {
+            continue;
+        }
+
+        auto nextTime = nextTimerTime(worker);
+        if (nextTime == TimePoint::max()) {
+            worker.condition.wait(lock);
+        } else {
+            worker.condition.wait_until(lock, nextTime);
+        }
+    }
+}
+
+void SendQueueWorkerPool::stepQueue(Worker& worker, std::unique_lock<std::mutex>& lock, SendQueue* queue) {
+    if (worker.queues.find(queue) == worker.queues.end()) {
+        // removed by an earlier step of this pass letting go of the lock
+        return;
+    }
+
+    // the step lock is taken before the worker lock is released, so remove can wait on it
+    std::unique_lock<std::mutex> stepLock(queue->_stepMutex);
+    lock.unlock();
+
+    TimePoint nextStepTime;
+    bool shouldStepAgain = queue->step(nextStepTime);
+
+    stepLock.unlock();
+    lock.lock();
+
+    if (shouldStepAgain) {
+        schedule(worker, queue, nextStepTime);
+    }
+}
+
+void SendQueueWorkerPool::schedule(Worker& worker, SendQueue* queue, TimePoint stepTime) {
+    auto it = worker.queues.find(queue);
+    if (it == worker.queues.end()) {
+        return;
+    }
+    it->second.stepTime = stepTime;
+
+    // a timer goes in the slot of the tick it is due in, one that is more than a turn away is checked on every turn
+    int64_t ticks = std::max((int64_t)duration_cast<microseconds>(stepTime - worker.currentSlotTime).count(),
+                             (int64_t)0) / TICK_USECS;
+    int slot = (int)((worker.currentSlot + ticks) % NUM_WHEEL_SLOTS);
+
+    worker.wheel[slot].push_back({ queue, stepTime });
+    ++worker.numTimers;
+}
+
+void SendQueueWorkerPool::collectDueTimers(Worker& worker, TimePoint now, std::vector<SendQueue*>& dueQueues) {
+    int numSlots = 0;
+
+    while (worker.currentSlotTime + TICK <= now && numSlots < NUM_WHEEL_SLOTS) {
+        auto& timers = worker.wheel[worker.currentSlot];
+
+        auto keepEnd = std::remove_if(timers.begin(), timers.end(), [&](const Timer& timer) {
+            if (timer.stepTime > now) {
+                return false;
+            }
+
+            auto it = worker.queues.find(timer.queue);
+            if (it != worker.queues.end() && it->second.stepTime == timer.stepTime) {
+                dueQueues.push_back(timer.queue);
+            }
+            return true;
+        });
+        worker.numTimers -= (int)(timers.end() - keepEnd);
+        timers.erase(keepEnd, timers.end());
+
+        worker.currentSlot = (worker.currentSlot + 1) % NUM_WHEEL_SLOTS;
+        worker.currentSlotTime += TICK;
+        ++numSlots;
+    }
+
+    if (worker.currentSlotTime + TICK <= now) {
+        // we fell more than a turn behind and went through every slot, the wheel carries on from now
+        worker.currentSlotTime = now;
+    }
+}
+
+SendQueueWorkerPool::TimePoint SendQueueWorkerPool::nextTimerTime(Worker& worker) const {
+    if (worker.numTimers == 0) {
+        return TimePoint::max();
+    }
+
+    for (int i = 0; i < NUM_WHEEL_SLOTS; ++i) {
+        if (!worker.wheel[(worker.currentSlot + i) % NUM_WHEEL_SLOTS].empty()) {
+            // the slot is handled once its tick has passed
+            return worker.currentSlotTime + (i + 1) * TICK;
+        }
+    }
+
+    return TimePoint::max();
+}
@@ -0,0 +1,90 @@
+//
+//  SendQueueWorkerPool.h
+//  libraries/networking/src/udt
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_SendQueueWorkerPool_h
+#define hifi_SendQueueWorkerPool_h
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <PortableHighResolutionClock.h>
+
+namespace udt {
+
+class SendQueue;
+
+// A fixed set of threads that step every SendQueue of the process, instead of a thread per SendQueue.
+// A queue stays on the worker it was added to. Each worker keeps the time of the next step of its queues in a timer
+// wheel of TICK_USECS slots, and a queue that is woken (new packets, an ACK or NAK) is stepped right away.
+class SendQueueWorkerPool {
+public:
+    static const int MAX_NUM_WORKERS = 4;
+    static const int TICK_USECS = 100;
+    static const int NUM_WHEEL_SLOTS = 512;
+
+    static SendQueueWorkerPool& getInstance();
+
+    // starts stepping the queue, on the worker with the fewest queues
+    void add(SendQueue* queue);
+
+    // stops stepping the queue and waits for a step in progress - the queue can be deleted once this returns
+    void remove(SendQueue* queue);
+
+    // steps the queue as soon as its worker can
+    void wake(SendQueue* queue);
+
+private:
+    using TimePoint = p_high_resolution_clock::time_point;
+
+    struct Timer {
+        SendQueue* queue;
+        TimePoint stepTime;
+    };
+
+    struct ScheduledQueue {
+        TimePoint stepTime; // the step time of the live timer, other timers of the queue are stale
+        bool isReady { false };
+    };
+
+    struct Worker {
+        std::thread thread;
+        std::mutex mutex;
+        std::condition_variable condition;
+
+        std::unordered_map<SendQueue*, ScheduledQueue> queues;
+        std::vector<SendQueue*> readyQueues;
+
+        std::vector<std::vector<Timer>> wheel;
+        int currentSlot { 0 };
+        TimePoint currentSlotTime;
+        int numTimers { 0 };
+    };
+
+    SendQueueWorkerPool(int numWorkers);
+
+    void run(Worker& worker);
+    void stepQueue(Worker& worker, std::unique_lock<std::mutex>& lock, SendQueue* queue);
+    void schedule(Worker& worker, SendQueue* queue, TimePoint stepTime);
+    void collectDueTimers(Worker& worker, TimePoint now, std::vector<SendQueue*>& dueQueues);
+    TimePoint nextTimerTime(Worker& worker) const;
+
+    std::vector<std::unique_ptr<Worker>> _workers;
+};
+
+}
+
+#endif // hifi_SendQueueWorkerPool_h
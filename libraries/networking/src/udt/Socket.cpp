@@ -15,6 +15,20 @@
 #include <sys/socket.h>
 #endif
 
+// Linux can move a batch of datagrams through the socket in one system call with recvmmsg/sendmmsg
+#if defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID)
+#define UDT_BATCHED_DATAGRAMS
+#include <algorithm>
+#include <cstring>
+#include <errno.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include <cstring>
+
 #include <QtCore/QThread>
 
 #include <LogHandler.h>
@@ -23,12 +37,15 @@
 #include "Connection.h"
 #include "ControlPacket.h"
 #include "Packet.h"
+#include "PacketBufferPool.h"
 #include "../NLPacket.h"
 #include "../NLPacketList.h"
 #include "PacketList.h"
 
 using namespace udt;
 
+static const float FEC_LOSS_SCALE = 1000000.0f; // loss goes in FECReport packets as parts per million
+
 Socket::Socket(QObject* parent, bool shouldChangeSocketOptions) :
     QObject(parent),
     _synTimer(new QTimer(this)),
@@ -54,7 +71,39 @@ Socket::Socket(QObject* parent, bool shouldChangeSocketOptions) :
     _readyReadBackupTimer->start(READY_READ_BACKUP_CHECK_MSECS);
 }
 
+Socket::~Socket() {
+#ifdef UDT_BATCHED_DATAGRAMS
+    stopReceiveThreads();
+#endif
+}
+
+void Socket::setNumReceiveThreads(int numThreads) {
+    numThreads = std::max(numThreads, 1);
+    if (numThreads == _numReceiveThreads) {
+        return;
+    }
+
+#ifdef UDT_BATCHED_DATAGRAMS
+    _numReceiveThreads = numThreads;
+
+    // re-bind on the same port so that the new number of sockets takes effect
+    if (_udpSocket.state() == QAbstractSocket::BoundState) {
+        rebind();
+    }
+#else
+    qCDebug(networking) << "Socket receive threads are only available on Linux, staying with one.";
+#endif
+}
+
 void Socket::bind(const QHostAddress& address, quint16 port) {
+#ifdef UDT_BATCHED_DATAGRAMS
+    if (_numReceiveThreads > 1 && address.protocol() == QAbstractSocket::IPv4Protocol
+        && bindWithReceiveThreads(address, port)) {
+        // the sockets of the group already have their options
+        return;
+    }
+#endif
+
     _udpSocket.bind(address, port);
 
     if (_shouldChangeSocketOptions) {
@@ -77,6 +126,10 @@ void Socket::rebind() {
 }
 
 void Socket::rebind(quint16 localPort) {
+#ifdef UDT_BATCHED_DATAGRAMS
+    stopReceiveThreads();
+#endif
+
     _udpSocket.close();
     bind(QHostAddress::AnyIPv4, localPort);
 }
@@ -137,7 +190,16 @@ qint64 Socket::writePacket(const Packet& packet, const HifiSockAddr& sockAddr) {
     // write the correct sequence number to the Packet here
     packet.writeSequenceNumber(sequenceNumber);
 
-    return writeDatagram(packet.getData(), packet.getDataSize(), sockAddr);
+    qint64 bytesWritten = writeDatagram(packet.getData(), packet.getDataSize(), sockAddr);
+
+    if (_fecFilterOperator) {
+        auto parityPacket = addToFECGroup(packet, sockAddr);
+        if (parityPacket) {
+            writeBasePacket(*parityPacket, sockAddr);
+        }
+    }
+
+    return bytesWritten;
 }
 
 qint64 Socket::writePacket(std::unique_ptr<Packet> packet, const HifiSockAddr& sockAddr) {
@@ -183,12 +245,34 @@ qint64 Socket::writePacketList(std::unique_ptr<PacketList> packetList, const Hif
         return 0;
     }
 
-    // Unerliable and Unordered
-    qint64 totalBytesSent = 0;
-    while (!packetList->_packets.empty()) {
-        totalBytesSent += writePacket(packetList->takeFront<Packet>(), sockAddr);
+    // Unerliable and Unordered, every packet goes to the same address so they are written as one batch
+    std::vector<QByteArray> datagrams;
+    datagrams.reserve(packetList->_packets.size());
+    {
+        Lock lock(_unreliableSequenceNumbersMutex);
+        auto& sequenceNumber = _unreliableSequenceNumbers[sockAddr];
+        for (auto& packet : packetList->_packets) {
+            packet->writeSequenceNumber(++sequenceNumber);
+            datagrams.push_back(QByteArray::fromRawData(packet->getData(), packet->getDataSize()));
+        }
+    }
+
+    // the parity of any group the list completes goes out in the same batch
+    std::vector<std::unique_ptr<ControlPacket>> parityPackets;
+    if (_fecFilterOperator) {
+        for (auto& packet : packetList->_packets) {
+            auto parityPacket = addToFECGroup(*packet, sockAddr);
+            if (parityPacket) {
+                datagrams.push_back(QByteArray::fromRawData(parityPacket->getData(), parityPacket->getDataSize()));
+                parityPackets.push_back(std::move(parityPacket));
+            }
+        }
     }
 
+    // the packets own the data of the datagrams, so they are only released once written
+    qint64 totalBytesSent = writeDatagrams(datagrams, sockAddr);
+    packetList->_packets.clear();
+
     return totalBytesSent;
 }
 
@@ -237,6 +321,340 @@ qint64 Socket::writeDatagram(const QByteArray& datagram, const HifiSockAddr& soc
     return bytesWritten;
 }
 
+qint64 Socket::writeDatagrams(const std::vector<QByteArray>& datagrams, const HifiSockAddr& sockAddr) {
+    size_t datagramIndex = 0;
+    qint64 totalBytesWritten = 0;
+
+#ifdef UDT_BATCHED_DATAGRAMS
+    // we only batch on our bound IPv4 socket, anything else goes through QUdpSocket
+    if (_canBatchDatagrams && datagrams.size() > 1 && _udpSocket.socketDescriptor() != -1
+        && sockAddr.getAddress().protocol() == QAbstractSocket::IPv4Protocol) {
+        totalBytesWritten = writeDatagramsBatched(datagrams, sockAddr, datagramIndex);
+    }
+#endif
+
+    // write whatever the batched path could not, one datagram at a time
+    for (; datagramIndex < datagrams.size(); ++datagramIndex) {
+        const QByteArray& datagram = datagrams[datagramIndex];
+        qint64 bytesWritten = writeDatagram(datagram, sockAddr);
+        if (bytesWritten > 0) {
+            totalBytesWritten += bytesWritten;
+        }
+    }
+    return totalBytesWritten;
+}
+
+#ifdef UDT_BATCHED_DATAGRAMS
+
+// the most datagrams moved by one recvmmsg or sendmmsg call
+static const int DATAGRAM_BATCH_SIZE = 32;
+
+qint64 Socket::writeDatagramsBatched(const std::vector<QByteArray>& datagrams, const HifiSockAddr& sockAddr,
+                                     size_t& datagramIndex) {
+    int descriptor = _udpSocket.socketDescriptor();
+
+    sockaddr_in destination;
+    memset(&destination, 0, sizeof(destination));
+    destination.sin_family = AF_INET;
+    destination.sin_addr.s_addr = htonl(sockAddr.getAddress().toIPv4Address());
+    destination.sin_port = htons(sockAddr.getPort());
+
+    mmsghdr messages[DATAGRAM_BATCH_SIZE];
+    iovec iovecs[DATAGRAM_BATCH_SIZE];
+
+    qint64 totalBytesWritten = 0;
+
+    while (datagramIndex < datagrams.size()) {
+        int batchSize = (int)std::min(datagrams.size() - datagramIndex, (size_t)DATAGRAM_BATCH_SIZE);
+
+        memset(messages, 0, sizeof(mmsghdr) * batchSize);
+        for (int i = 0; i < batchSize; ++i) {
+            const QByteArray& datagram = datagrams[datagramIndex + i];
+            iovecs[i].iov_base = const_cast<char*>(datagram.constData());
+            iovecs[i].iov_len = datagram.size();
+            messages[i].msg_hdr.msg_name = &destination;
+            messages[i].msg_hdr.msg_namelen = sizeof(destination);
+            messages[i].msg_hdr.msg_iov = &iovecs[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        int numSent = ::sendmmsg(descriptor, messages, batchSize, 0);
+
+        if (numSent < 0) {
+            if (errno == ENOSYS) {
+                // this kernel has no sendmmsg, stop trying and let the caller write the rest one datagram at a time
+                _canBatchDatagrams = false;
+                return totalBytesWritten;
+            }
+
+            if (errno == EINTR) {
+                continue;
+            }
+
+            // when saturating a link this isn't an uncommon message - suppress it so it doesn't bomb the debug
+            static const QString WRITE_ERROR_REGEX = "Socket::writeDatagramsBatched sendmmsg failed - .*";
+            static QString repeatedMessage
+                = LogHandler::getInstance().addRepeatedMessageRegex(WRITE_ERROR_REGEX);
+
+            qCDebug(networking) << "Socket::writeDatagramsBatched sendmmsg failed -" << strerror(errno);
+
+            // skip the datagram that failed, like a failed writeDatagram would
+            ++datagramIndex;
+            continue;
+        }
+
+        for (int i = 0; i < numSent; ++i) {
+            totalBytesWritten += messages[i].msg_len;
+        }
+
+        // after a partial batch the next call picks up with the datagram that could not go out
+        datagramIndex += numSent;
+    }
+
+    return totalBytesWritten;
+}
+
+// the buffers for one recvmmsg call, a buffer handed off to a packet is replaced on the next call
+class DatagramBatch {
+public:
+    ~DatagramBatch() {
+        for (auto& buffer : _buffers) {
+            PacketBufferPool::release(std::move(buffer));
+        }
+    }
+
+    // returns the number of datagrams received, or -1 with errno set
+    int receive(int descriptor) {
+        memset(_messages, 0, sizeof(_messages));
+        for (int i = 0; i < DATAGRAM_BATCH_SIZE; ++i) {
+            if (!_buffers[i]) {
+                _buffers[i] = PacketBufferPool::acquire();
+            }
+            _iovecs[i].iov_base = _buffers[i].get();
+            _iovecs[i].iov_len = MAX_PACKET_SIZE;
+            _messages[i].msg_hdr.msg_name = &_senderAddresses[i];
+            _messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+            _messages[i].msg_hdr.msg_iov = &_iovecs[i];
+            _messages[i].msg_hdr.msg_iovlen = 1;
+        }
+        return ::recvmmsg(descriptor, _messages, DATAGRAM_BATCH_SIZE, MSG_DONTWAIT, nullptr);
+    }
+
+    HifiSockAddr senderSockAddr(int i) const {
+        return HifiSockAddr(QHostAddress(ntohl(_senderAddresses[i].sin_addr.s_addr)), ntohs(_senderAddresses[i].sin_port));
+    }
+    int size(int i) const { return _messages[i].msg_len; }
+
+    // nothing we sent, our packets always fit in MAX_PACKET_SIZE
+    bool isTruncated(int i) const { return _messages[i].msg_hdr.msg_flags & MSG_TRUNC; }
+
+    std::unique_ptr<char[]> takeBuffer(int i) { return std::move(_buffers[i]); }
+
+private:
+    std::unique_ptr<char[]> _buffers[DATAGRAM_BATCH_SIZE];
+    mmsghdr _messages[DATAGRAM_BATCH_SIZE];
+    iovec _iovecs[DATAGRAM_BATCH_SIZE];
+    sockaddr_in _senderAddresses[DATAGRAM_BATCH_SIZE];
+};
+
+bool Socket::readPendingDatagramsBatched() {
+    int descriptor = _udpSocket.socketDescriptor();
+    if (descriptor == -1) {
+        return false;
+    }
+
+    DatagramBatch batch;
+
+    while (true) {
+        int numReceived = batch.receive(descriptor);
+
+        if (numReceived < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            if (errno == ENOSYS) {
+                _canBatchDatagrams = false;
+                return false;
+            }
+
+            // EAGAIN means the socket is drained, anything else is left for QUdpSocket to report
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+
+        if (numReceived > 0) {
+            // we're reading packets so re-start the readyRead backup timer
+            _readyReadBackupTimer->start();
+        }
+
+        // grab a time point we can mark as the receive time of these packets
+        auto receiveTime = p_high_resolution_clock::now();
+
+        for (int i = 0; i < numReceived; ++i) {
+            HifiSockAddr senderSockAddr = batch.senderSockAddr(i);
+            int sizeRead = batch.size(i);
+
+            // save information for this packet, in case it is the one that sticks readyRead
+            _lastPacketSizeRead = sizeRead;
+            _lastPacketSockAddr = senderSockAddr;
+
+            if (sizeRead <= 0 || batch.isTruncated(i)) {
+                continue;
+            }
+
+            processDatagram(batch.takeBuffer(i), sizeRead, senderSockAddr, receiveTime, true);
+        }
+
+        if (numReceived < DATAGRAM_BATCH_SIZE) {
+            return true;
+        }
+    }
+}
+
+int Socket::createReusePortSocket(const QHostAddress& address, quint16 port) {
+    int descriptor = ::socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (descriptor == -1) {
+        return -1;
+    }
+
+    int enable = 1;
+    sockaddr_in bindAddress;
+    memset(&bindAddress, 0, sizeof(bindAddress));
+    bindAddress.sin_family = AF_INET;
+    bindAddress.sin_addr.s_addr = htonl(address.toIPv4Address());
+    bindAddress.sin_port = htons(port);
+
+    if (::setsockopt(descriptor, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable)) == -1
+        || ::bind(descriptor, reinterpret_cast<sockaddr*>(&bindAddress), sizeof(bindAddress)) == -1) {
+        qCDebug(networking) << "Socket::createReusePortSocket could not bind a shared socket to port" << port
+            << "-" << strerror(errno);
+        ::close(descriptor);
+        return -1;
+    }
+
+    if (_shouldChangeSocketOptions) {
+        int sendBufferSize = udt::UDP_SEND_BUFFER_SIZE_BYTES;
+        int receiveBufferSize = udt::UDP_RECEIVE_BUFFER_SIZE_BYTES;
+        int pmtuDiscovery = IP_PMTUDISC_DONT;
+        ::setsockopt(descriptor, SOL_SOCKET, SO_SNDBUF, &sendBufferSize, sizeof(sendBufferSize));
+        ::setsockopt(descriptor, SOL_SOCKET, SO_RCVBUF, &receiveBufferSize, sizeof(receiveBufferSize));
+        ::setsockopt(descriptor, IPPROTO_IP, IP_MTU_DISCOVER, &pmtuDiscovery, sizeof(pmtuDiscovery));
+    }
+
+    return descriptor;
+}
+
+bool Socket::bindWithReceiveThreads(const QHostAddress& address, quint16 port) {
+    // the QUdpSocket takes the first socket of the group, the kernel needs SO_REUSEPORT on it before it is bound
+    int primaryDescriptor = createReusePortSocket(address, port);
+    if (primaryDescriptor == -1) {
+        return false;
+    }
+
+    if (port == 0) {
+        // the other sockets of the group must share the port the kernel picked
+        sockaddr_in boundAddress;
+        socklen_t boundAddressLength = sizeof(boundAddress);
+        ::getsockname(primaryDescriptor, reinterpret_cast<sockaddr*>(&boundAddress), &boundAddressLength);
+        port = ntohs(boundAddress.sin_port);
+    }
+
+    if (!_udpSocket.setSocketDescriptor(primaryDescriptor, QAbstractSocket::BoundState)) {
+        ::close(primaryDescriptor);
+        return false;
+    }
+
+    _shouldStopReceiveThreads = false;
+    for (int i = 1; i < _numReceiveThreads; ++i) {
+        int descriptor = createReusePortSocket(address, port);
+        if (descriptor == -1) {
+            break;
+        }
+        _receiveThreads.emplace_back(&Socket::runReceiveThread, this, descriptor);
+    }
+
+    qCDebug(networking) << "Socket bound to port" << port << "with" << _receiveThreads.size() + 1 << "receive threads";
+    return true;
+}
+
+void Socket::stopReceiveThreads() {
+    _shouldStopReceiveThreads = true;
+    for (auto& thread : _receiveThreads) {
+        thread.join();
+    }
+    _receiveThreads.clear();
+}
+
+void Socket::runReceiveThread(int descriptor) {
+    // how long a receive thread waits on its socket before checking if it should stop
+    const int RECEIVE_THREAD_POLL_TIMEOUT_MSECS = 100;
+
+    DatagramBatch batch;
+    pollfd pollDescriptor { descriptor, POLLIN, 0 };
+
+    while (!_shouldStopReceiveThreads) {
+        if (::poll(&pollDescriptor, 1, RECEIVE_THREAD_POLL_TIMEOUT_MSECS) <= 0) {
+            continue;
+        }
+
+        int numReceived;
+        while ((numReceived = batch.receive(descriptor)) > 0) {
+            auto receiveTime = p_high_resolution_clock::now();
+
+            for (int i = 0; i < numReceived; ++i) {
+                if (batch.size(i) > 0 && !batch.isTruncated(i)) {
+                    processDatagramOnReceiveThread(batch.takeBuffer(i), batch.size(i), batch.senderSockAddr(i),
+                                                   receiveTime);
+                }
+            }
+
+            if (numReceived < DATAGRAM_BATCH_SIZE) {
+                break;
+            }
+        }
+    }
+
+    ::close(descriptor);
+}
+
+void Socket::processDatagramOnReceiveThread(std::unique_ptr<char[]> buffer, int size, const HifiSockAddr& senderSockAddr,
+                                            p_high_resolution_clock::time_point receiveTime) {
+    // the kernel hashes a source to the same socket of the group, so a sender is always handled by one thread.
+    // Unreliable packets go through the filter and handler right here, anything that touches the unfiltered
+    // handlers or the state of a Connection is handed to the Socket thread.
+    uint32_t bitField = *reinterpret_cast<uint32_t*>(buffer.get());
+    bool needsSocketThread = _hasUnfilteredHandlers
+        || (bitField & (CONTROL_BIT_MASK | RELIABILITY_BIT_MASK | MESSAGE_BIT_MASK));
+
+    if (!needsSocketThread) {
+        auto packet = Packet::fromReceivedPacket(std::move(buffer), size, senderSockAddr);
+        packet->setBufferIsPooled();
+        packet->setReceiveTime(receiveTime);
+
+        if ((!_packetFilterOperator || _packetFilterOperator(*packet)) && _packetHandler) {
+            if (_hasFECDecoders && !recordReceivedForFEC(*packet)) {
+                return;
+            }
+            _packetHandler(std::move(packet));
+        }
+        return;
+    }
+
+    bool wasEmpty;
+    {
+        Lock lock(_forwardedDatagramsMutex);
+        wasEmpty = _forwardedDatagrams.empty();
+        _forwardedDatagrams.push_back({ std::move(buffer), size, senderSockAddr, receiveTime });
+    }
+
+    // one queued call picks up everything forwarded until it runs
+    if (wasEmpty) {
+        QMetaObject::invokeMethod(this, "processForwardedDatagrams", Qt::QueuedConnection);
+    }
+}
+
+#endif
+
 Connection* Socket::findOrCreateConnection(const HifiSockAddr& sockAddr) {
     auto it = _connectionsHash.find(sockAddr);
 
@@ -327,6 +745,12 @@ void Socket::checkForReadyReadBackup() {
 }
 
 void Socket::readPendingDatagrams() {
+#ifdef UDT_BATCHED_DATAGRAMS
+    if (_canBatchDatagrams && readPendingDatagramsBatched()) {
+        return;
+    }
+#endif
+
     int packetSizeWithHeader = -1;
 
     while ((packetSizeWithHeader = _udpSocket.pendingDatagramSize()) != -1) {
@@ -340,8 +764,10 @@ void Socket::readPendingDatagrams() {
         // setup a HifiSockAddr to read into
         HifiSockAddr senderSockAddr;
 
-        // setup a buffer to read the packet into
-        auto buffer = std::unique_ptr<char[]>(new char[packetSizeWithHeader]);
+        // setup a buffer to read the packet into, anything we would send fits in one from the pool
+        bool isBufferPooled = packetSizeWithHeader <= MAX_PACKET_SIZE;
+        auto buffer = isBufferPooled ? PacketBufferPool::acquire()
+                                     : std::unique_ptr<char[]>(new char[packetSizeWithHeader]);
 
         // pull the datagram
         auto sizeRead = _udpSocket.readDatagram(buffer.get(), packetSizeWithHeader,
@@ -354,73 +780,243 @@ void Socket::readPendingDatagrams() {
         if (sizeRead <= 0) {
             // we either didn't pull anything for this packet or there was an error reading (this seems to trigger
             // on windows even if there's not a packet available)
+            if (isBufferPooled) {
+                PacketBufferPool::release(std::move(buffer));
+            }
             continue;
         }
 
-        auto it = _unfilteredHandlers.find(senderSockAddr);
+        processDatagram(std::move(buffer), packetSizeWithHeader, senderSockAddr, receiveTime, isBufferPooled);
+    }
+}
 
-        if (it != _unfilteredHandlers.end()) {
-            // we have a registered unfiltered handler for this HifiSockAddr - call that and return
-            if (it->second) {
-                auto basePacket = BasePacket::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
-                basePacket->setReceiveTime(receiveTime);
-                it->second(std::move(basePacket));
+void Socket::processForwardedDatagrams() {
+    std::vector<ForwardedDatagram> datagrams;
+    {
+        Lock lock(_forwardedDatagramsMutex);
+        datagrams.swap(_forwardedDatagrams);
+    }
+
+    for (auto& datagram : datagrams) {
+        // forwarded datagrams were all read into pooled buffers by a receive thread
+        processDatagram(std::move(datagram.buffer), datagram.size, datagram.senderSockAddr, datagram.receiveTime, true);
+    }
+}
+
+void Socket::processDatagram(std::unique_ptr<char[]> buffer, int packetSizeWithHeader, const HifiSockAddr& senderSockAddr,
+                             p_high_resolution_clock::time_point receiveTime, bool isBufferPooled) {
+    auto it = _unfilteredHandlers.find(senderSockAddr);
+
+    if (it != _unfilteredHandlers.end()) {
+        // we have a registered unfiltered handler for this HifiSockAddr - call that and return
+        if (it->second) {
+            auto basePacket = BasePacket::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
+            if (isBufferPooled) {
+                basePacket->setBufferIsPooled();
             }
+            basePacket->setReceiveTime(receiveTime);
+            it->second(std::move(basePacket));
+        }
 
-            continue;
+        return;
+    }
+
+    // check if this was a control packet or a data packet
+    bool isControlPacket = *reinterpret_cast<uint32_t*>(buffer.get()) & CONTROL_BIT_MASK;
+
+    if (isControlPacket) {
+        // setup a control packet from the data we just read
+        auto controlPacket = ControlPacket::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
+        if (isBufferPooled) {
+            controlPacket->setBufferIsPooled();
         }
+        controlPacket->setReceiveTime(receiveTime);
 
-        // check if this was a control packet or a data packet
-        bool isControlPacket = *reinterpret_cast<uint32_t*>(buffer.get()) & CONTROL_BIT_MASK;
+        auto type = controlPacket->getType();
+        if (type == ControlPacket::FECParity || type == ControlPacket::FECReport) {
+            // forward error correction is for unreliable packets, it does not go through a connection
+            processFECControlPacket(std::move(controlPacket));
+            return;
+        }
 
-        if (isControlPacket) {
-            // setup a control packet from the data we just read
-            auto controlPacket = ControlPacket::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
-            controlPacket->setReceiveTime(receiveTime);
+        // move this control packet to the matching connection, if there is one
+        auto connection = findOrCreateConnection(senderSockAddr);
 
-            // move this control packet to the matching connection, if there is one
-            auto connection = findOrCreateConnection(senderSockAddr);
+        if (connection) {
+            connection->processControl(move(controlPacket));
+        }
 
-            if (connection) {
-                connection->processControl(move(controlPacket));
+    } else {
+        // setup a Packet from the data we just read
+        auto packet = Packet::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
+        if (isBufferPooled) {
+            packet->setBufferIsPooled();
+        }
+        packet->setReceiveTime(receiveTime);
+
+        // save the sequence number in case this is the packet that sticks readyRead
+        _lastReceivedSequenceNumber = packet->getSequenceNumber();
+
+        // call our verification operator to see if this packet is verified
+        if (!_packetFilterOperator || _packetFilterOperator(*packet)) {
+            if (packet->isReliable()) {
+                // if this was a reliable packet then signal the matching connection with the sequence number
+                auto connection = findOrCreateConnection(senderSockAddr);
+
+                if (!connection || !connection->processReceivedSequenceNumber(packet->getSequenceNumber(),
+                                                                              packet->getDataSize(),
+                                                                              packet->getPayloadSize(),
+                                                                              receiveTime)) {
+                    // the connection could not be created or indicated that we should not continue processing this packet
+                    return;
+                }
             }
 
-        } else {
-            // setup a Packet from the data we just read
-            auto packet = Packet::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
-            packet->setReceiveTime(receiveTime);
-
-            // save the sequence number in case this is the packet that sticks readyRead
-            _lastReceivedSequenceNumber = packet->getSequenceNumber();
-
-            // call our verification operator to see if this packet is verified
-            if (!_packetFilterOperator || _packetFilterOperator(*packet)) {
-                if (packet->isReliable()) {
-                    // if this was a reliable packet then signal the matching connection with the sequence number
-                    auto connection = findOrCreateConnection(senderSockAddr);
-
-                    if (!connection || !connection->processReceivedSequenceNumber(packet->getSequenceNumber(),
-                                                                                  packet->getDataSize(),
-                                                                                  packet->getPayloadSize())) {
-                        // the connection could not be created or indicated that we should not continue processing this packet
-                        continue;
-                    }
+            if (packet->isPartOfMessage()) {
+                auto connection = findOrCreateConnection(senderSockAddr);
+                if (connection) {
+                    connection->queueReceivedMessagePacket(std::move(packet));
                 }
-
-                if (packet->isPartOfMessage()) {
-                    auto connection = findOrCreateConnection(senderSockAddr);
-                    if (connection) {
-                        connection->queueReceivedMessagePacket(std::move(packet));
-                    }
-                } else if (_packetHandler) {
-                    // call the verified packet callback to let it handle this packet
-                    _packetHandler(std::move(packet));
+            } else if (_packetHandler) {
+                if (_hasFECDecoders && !packet->isReliable() && !recordReceivedForFEC(*packet)) {
+                    // we already handed this one off, rebuilt from the parity of its group
+                    return;
                 }
+
+                // call the verified packet callback to let it handle this packet
+                _packetHandler(std::move(packet));
             }
         }
     }
 }
 
+void Socket::setForwardErrorCorrectionFilter(PacketFilterOperator filterOperator, int minGroupSize, int maxGroupSize) {
+    Lock lock(_fecMutex);
+    _fecFilterOperator = filterOperator;
+    _fecMinGroupSize = minGroupSize;
+    _fecMaxGroupSize = maxGroupSize;
+    _fecEncoders.clear();
+}
+
+std::unique_ptr<ControlPacket> Socket::addToFECGroup(const Packet& packet, const HifiSockAddr& sockAddr) {
+    if (packet.isPartOfMessage() || packet.getDataSize() > FECEncoder::maxProtectedDatagramSize()
+        || !_fecFilterOperator(packet)) {
+        return std::unique_ptr<ControlPacket>();
+    }
+
+    Lock lock(_fecMutex);
+    auto it = _fecEncoders.find(sockAddr);
+    if (it == _fecEncoders.end()) {
+        it = _fecEncoders.emplace(sockAddr, FECEncoder(_fecMinGroupSize, _fecMaxGroupSize)).first;
+    }
+
+    return it->second.addDatagram(packet.getSequenceNumber(), packet.getData(), (int)packet.getDataSize());
+}
+
+bool Socket::recordReceivedForFEC(const Packet& packet) {
+    if (packet.isPartOfMessage()) {
+        return true;
+    }
+
+    Lock lock(_fecMutex);
+    auto it = _fecDecoders.find(packet.getSenderSockAddr());
+    if (it == _fecDecoders.end()) {
+        return true;
+    }
+
+    return it->second.addReceivedDatagram(packet.getSequenceNumber(), packet.getData(), (int)packet.getDataSize());
+}
+
+void Socket::processFECControlPacket(std::unique_ptr<ControlPacket> controlPacket) {
+    const HifiSockAddr& senderSockAddr = controlPacket->getSenderSockAddr();
+
+    if (controlPacket->getType() == ControlPacket::FECReport) {
+        quint32 lossPerMillion;
+        if (controlPacket->getPayloadSize() < (qint64)sizeof(lossPerMillion)) {
+            return;
+        }
+        controlPacket->readPrimitive(&lossPerMillion);
+
+        Lock lock(_fecMutex);
+        auto it = _fecEncoders.find(senderSockAddr);
+        if (it != _fecEncoders.end()) {
+            it->second.setReportedLoss(lossPerMillion / FEC_LOSS_SCALE);
+        }
+        return;
+    }
+
+    QByteArray recovered;
+    {
+        Lock lock(_fecMutex);
+        // the first parity from a sender starts keeping copies of what it sends us
+        recovered = _fecDecoders[senderSockAddr].processParity(*controlPacket);
+        _hasFECDecoders = true;
+    }
+
+    if (!recovered.isEmpty()) {
+        auto buffer = std::unique_ptr<char[]>(new char[recovered.size()]);
+        memcpy(buffer.get(), recovered.constData(), recovered.size());
+
+        // this goes through the packet filter like anything we receive, so it is verified before it is handled
+        processDatagram(std::move(buffer), recovered.size(), senderSockAddr, controlPacket->getReceiveTime(), false);
+    }
+}
+
+void Socket::sendFECReports() {
+    static const auto FEC_REPORT_INTERVAL = std::chrono::seconds(1);
+
+    auto now = p_high_resolution_clock::now();
+    if (now - _lastFECReportTime < FEC_REPORT_INTERVAL) {
+        return;
+    }
+    _lastFECReportTime = now;
+
+    std::vector<std::pair<HifiSockAddr, quint32>> reports;
+    {
+        Lock lock(_fecMutex);
+
+        // anything that did not see any traffic since the last report is dropped
+        for (auto it = _fecEncoders.begin(); it != _fecEncoders.end();) {
+            it = it->second.checkAndClearActivity() ? std::next(it) : _fecEncoders.erase(it);
+        }
+
+        for (auto it = _fecDecoders.begin(); it != _fecDecoders.end();) {
+            if (it->second.checkAndClearActivity()) {
+                reports.emplace_back(it->first, (quint32)(it->second.sampleLoss() * FEC_LOSS_SCALE));
+                ++it;
+            } else {
+                it = _fecDecoders.erase(it);
+            }
+        }
+
+        _hasFECDecoders = !_fecDecoders.empty();
+    }
+
+    if (!reports.empty()) {
+        auto reportPacket = ControlPacket::create(ControlPacket::FECReport, sizeof(quint32));
+        for (auto& report : reports) {
+            reportPacket->reset();
+            reportPacket->writePrimitive(report.second);
+            writeBasePacket(*reportPacket, report.first);
+        }
+    }
+}
+
+void Socket::recordFECStats(const HifiSockAddr& sockAddr, ConnectionStats::Stats& stats) {
+    Lock lock(_fecMutex);
+
+    auto encoderIt = _fecEncoders.find(sockAddr);
+    if (encoderIt != _fecEncoders.end()) {
+        stats.fecGroupSize = encoderIt->second.getGroupSize();
+        stats.fecReportedLoss = (int)(encoderIt->second.getReportedLoss() * FEC_LOSS_SCALE);
+    }
+
+    auto decoderIt = _fecDecoders.find(sockAddr);
+    if (decoderIt != _fecDecoders.end()) {
+        stats.fecRecoveredPackets = decoderIt->second.getNumRecovered();
+    }
+}
+
 void Socket::connectToSendSignal(const HifiSockAddr& destinationAddr, QObject* receiver, const char* slot) {
     auto it = _connectionsHash.find(destinationAddr);
     if (it != _connectionsHash.end()) {
@@ -458,6 +1054,8 @@ void Socket::rateControlSync() {
         }
     }
 
+    sendFECReports();
+
     if (_synTimer->interval() != _synInterval) {
         // if the _synTimer interval doesn't match the current _synInterval (changes when the CC factory is changed)
         // then restart it now with the right interval
@@ -486,11 +1084,12 @@ void Socket::setConnectionMaxBandwidth(int maxBandwidth) {
 
 ConnectionStats::Stats Socket::sampleStatsForConnection(const HifiSockAddr& destination) {
     auto it = _connectionsHash.find(destination);
+    ConnectionStats::Stats stats;
     if (it != _connectionsHash.end()) {
-        return it->second->sampleStats();
-    } else {
-        return ConnectionStats::Stats();
+        stats = it->second->sampleStats();
     }
+    recordFECStats(destination, stats);
+    return stats;
 }
 
 Socket::StatsVector Socket::sampleStatsForAllConnections() {
@@ -498,6 +1097,7 @@ Socket::StatsVector Socket::sampleStatsForAllConnections() {
     result.reserve(_connectionsHash.size());
     for (const auto& connectionPair : _connectionsHash) {
         result.emplace_back(connectionPair.first, connectionPair.second->sampleStats());
+        recordFECStats(connectionPair.first, result.back().second);
     }
     return result;
 }
@@ -14,17 +14,23 @@
 #ifndef hifi_Socket_h
 #define hifi_Socket_h
 
+#include <atomic>
 #include <functional>
 #include <unordered_map>
 #include <mutex>
+#include <thread>
+#include <vector>
 
 #include <QtCore/QObject>
 #include <QtCore/QTimer>
 #include <QtNetwork/QUdpSocket>
 
+#include <PortableHighResolutionClock.h>
+
 #include "../HifiSockAddr.h"
 #include "TCPVegasCC.h"
 #include "Connection.h"
+#include "ForwardErrorCorrection.h"
 
 //#define UDT_CONNECTION_DEBUG
 
@@ -33,6 +39,7 @@ class UDTTest;
 namespace udt {
 
 class BasePacket;
+class ControlPacket;
 class Packet;
 class PacketList;
 class SequenceNumber;
@@ -55,6 +62,7 @@ public:
     using StatsVector = std::vector<std::pair<HifiSockAddr, ConnectionStats::Stats>>;
     
     Socket(QObject* object = 0, bool shouldChangeSocketOptions = true);
+    ~Socket();
     
     quint16 localPort() const { return _udpSocket.localPort(); }
     
@@ -65,7 +73,15 @@ public:
     qint64 writePacketList(std::unique_ptr<PacketList> packetList, const HifiSockAddr& sockAddr);
     qint64 writeDatagram(const char* data, qint64 size, const HifiSockAddr& sockAddr);
     qint64 writeDatagram(const QByteArray& datagram, const HifiSockAddr& sockAddr);
+
+    // writes several datagrams to the same address, in a single system call where the platform allows it
+    qint64 writeDatagrams(const std::vector<QByteArray>& datagrams, const HifiSockAddr& sockAddr);
     
+    // opt-in, Linux only: binds this many sockets to the port with SO_REUSEPORT and reads every socket past the
+    // first on its own thread. Unreliable packets are then handed to the packet handler from those threads.
+    void setNumReceiveThreads(int numThreads);
+    int getNumReceiveThreads() const { return _numReceiveThreads; }
+
     void bind(const QHostAddress& address, quint16 port = 0);
     void rebind(quint16 port);
     void rebind();
@@ -77,8 +93,14 @@ public:
     void setConnectionCreationFilterOperator(ConnectionCreationFilterOperator filterOperator)
         { _connectionCreationFilterOperator = filterOperator; }
     
+    // opt-in: unreliable packets that pass the filter are followed by XOR parity, see ForwardErrorCorrection.h.
+    // A parity packet covers maxGroupSize packets, and as few as minGroupSize when the receiver reports loss.
+    void setForwardErrorCorrectionFilter(PacketFilterOperator filterOperator,
+                                         int minGroupSize = FECEncoder::MIN_GROUP_SIZE,
+                                         int maxGroupSize = FECEncoder::MAX_GROUP_SIZE);
+
     void addUnfilteredHandler(const HifiSockAddr& senderSockAddr, BasePacketHandler handler)
-        { _unfilteredHandlers[senderSockAddr] = handler; }
+        { _unfilteredHandlers[senderSockAddr] = handler; _hasUnfilteredHandlers = true; }
     
     void setCongestionControlFactory(std::unique_ptr<CongestionControlVirtualFactory> ccFactory);
     void setConnectionMaxBandwidth(int maxBandwidth);
@@ -101,6 +123,7 @@ public slots:
     
 private slots:
     void readPendingDatagrams();
+    void processForwardedDatagrams();
     void checkForReadyReadBackup();
     void rateControlSync();
 
@@ -109,7 +132,25 @@ private slots:
 
 private:
     void setSystemBufferSizes();
+    void processDatagram(std::unique_ptr<char[]> buffer, int size, const HifiSockAddr& senderSockAddr,
+                         p_high_resolution_clock::time_point receiveTime, bool isBufferPooled);
+    bool readPendingDatagramsBatched();
+    qint64 writeDatagramsBatched(const std::vector<QByteArray>& datagrams, const HifiSockAddr& sockAddr,
+                                 size_t& datagramIndex);
+
+    int createReusePortSocket(const QHostAddress& address, quint16 port);
+    bool bindWithReceiveThreads(const QHostAddress& address, quint16 port);
+    void stopReceiveThreads();
+    void runReceiveThread(int descriptor);
+    void processDatagramOnReceiveThread(std::unique_ptr<char[]> buffer, int size, const HifiSockAddr& senderSockAddr,
+                                        p_high_resolution_clock::time_point receiveTime);
     Connection* findOrCreateConnection(const HifiSockAddr& sockAddr);
+
+    std::unique_ptr<ControlPacket> addToFECGroup(const Packet& packet, const HifiSockAddr& sockAddr);
+    bool recordReceivedForFEC(const Packet& packet);
+    void processFECControlPacket(std::unique_ptr<ControlPacket> controlPacket);
+    void sendFECReports();
+    void recordFECStats(const HifiSockAddr& sockAddr, ConnectionStats::Stats& stats);
     bool socketMatchesNodeOrDomain(const HifiSockAddr& sockAddr);
    
     // privatized methods used by UDTTest - they are private since they must be called on the Socket thread
@@ -144,6 +185,32 @@ private:
     std::unique_ptr<CongestionControlVirtualFactory> _ccFactory { new CongestionControlFactory<TCPVegasCC>() };
 
     bool _shouldChangeSocketOptions { true };
+    std::atomic<bool> _canBatchDatagrams { true }; // cleared if the native batched datagram calls turn out to be unavailable
+
+    // the extra SO_REUSEPORT sockets and their threads, see setNumReceiveThreads
+    struct ForwardedDatagram {
+        std::unique_ptr<char[]> buffer;
+        int size;
+        HifiSockAddr senderSockAddr;
+        p_high_resolution_clock::time_point receiveTime;
+    };
+
+    int _numReceiveThreads { 1 };
+    std::vector<std::thread> _receiveThreads;
+    std::atomic<bool> _shouldStopReceiveThreads { false };
+    std::atomic<bool> _hasUnfilteredHandlers { false };
+    Mutex _forwardedDatagramsMutex;
+    std::vector<ForwardedDatagram> _forwardedDatagrams; // packets the receive threads leave to the Socket thread
+
+    // forward error correction state, see setForwardErrorCorrectionFilter
+    PacketFilterOperator _fecFilterOperator;
+    int _fecMinGroupSize { FECEncoder::MIN_GROUP_SIZE };
+    int _fecMaxGroupSize { FECEncoder::MAX_GROUP_SIZE };
+    Mutex _fecMutex;
+    std::unordered_map<HifiSockAddr, FECEncoder> _fecEncoders;
+    std::unordered_map<HifiSockAddr, FECDecoder> _fecDecoders; // only for senders that send us parity
+    std::atomic<bool> _hasFECDecoders { false };
+    p_high_resolution_clock::time_point _lastFECReportTime;
 
     int _lastPacketSizeRead { 0 };
     SequenceNumber _lastReceivedSequenceNumber;
@@ -50,7 +50,7 @@
 #include "OctreeLogging.h"
 
 
-QVector<QString> PERSIST_EXTENSIONS = {"svo", "json", "json.gz"};
+QVector<QString> PERSIST_EXTENSIONS = {"svo", "json", "json.gz", "bin"};
 
 Octree::Octree(bool shouldReaverage) :
     _rootElement(NULL),
@@ -899,7 +899,8 @@ int Octree::encodeTreeBitstream(OctreeElementPointer element,
     }
 
     // If we're at a element that is out of view, then we can return, because no nodes below us will be in view!
-    if (!params.recurseEverything && !element->isInView(params.viewFrustum)) {
+    if (!params.recurseEverything &&
+            (!element->isInView(params.viewFrustum) || !params.isInInterest(element->getAACube()))) {
         params.stopReason = EncodeBitstreamParams::OUT_OF_VIEW;
         return bytesWritten;
     }
@@ -1180,7 +1181,7 @@ int Octree::encodeTreeBitstreamRecursion(OctreeElementPointer element,
                  (nodeLocationThisView == ViewFrustum::INSIDE) || // parent was fully in view, we can assume ALL children are
                   (nodeLocationThisView == ViewFrustum::INTERSECT &&
                         childElement->isInView(params.viewFrustum)) // the parent intersects and the child is in view
-                ));
+                ) && (params.recurseEverything || params.isInInterest(childElement->getAACube())));
 
         if (!childIsInView) {
             // must check childElement here, because it could be we got here because there was no childElement
@@ -1627,6 +1628,10 @@ bool Octree::readFromFile(const char* fileName) {
         return readJSONFromGzippedFile(qFileName);
     }
 
+    if (qFileName.endsWith(".bin")) {
+        return readFromBinaryFile(qFileName);
+    }
+
     QFile file(qFileName);
 
     if (!file.open(QIODevice::ReadOnly)) {
@@ -1669,6 +1674,27 @@ bool Octree::readJSONFromGzippedFile(QString qFileName) {
     return readJSONFromStream(-1, jsonStream);
 }
 
+bool Octree::readFromBinaryFile(QString qFileName) {
+    QFile file(qFileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCritical() << "Cannot open binary snapshot file for reading: " << qFileName;
+        return false;
+    }
+
+    qint64 fileSize = file.size();
+    uchar* data = file.map(0, fileSize);
+    if (!data) {
+        qCritical() << "Cannot map binary snapshot file: " << qFileName;
+        return false;
+    }
+
+    qCDebug(octree) << "Loading binary snapshot" << qFileName << "...";
+    bool success = readFromBinarySnapshot(reinterpret_cast<const char*>(data), fileSize);
+
+    file.unmap(data);
+    return success;
+}
+
 bool Octree::readFromURL(const QString& urlString) {
     auto request = std::unique_ptr<ResourceRequest>(ResourceManager::createResourceRequest(this, urlString));
 
@@ -1881,6 +1907,8 @@ bool Octree::writeToFile(const char* fileName, OctreeElementPointer element, QSt
         success = writeToJSONFile(cFileName, element);
     } else if (persistAsFileType == "json.gz") {
         success = writeToJSONFile(cFileName, element, true);
+    } else if (persistAsFileType == "bin") {
+        success = writeToBinaryFile(cFileName, element);
     } else {
         qCDebug(octree) << "unable to write octree to file of type" << persistAsFileType;
     }
@@ -1935,6 +1963,29 @@ bool Octree::writeToJSONFile(const char* fileName, OctreeElementPointer element,
     return success;
 }
 
+bool Octree::writeToBinaryFile(const char* fileName, OctreeElementPointer element) {
+    qCDebug(octree, "Saving binary snapshot to file %s...", fileName);
+
+    OctreeElementPointer top;
+    if (element) {
+        top = element;
+    } else {
+        top = _rootElement;
+    }
+
+    QFile persistFile(fileName);
+    if (!persistFile.open(QIODevice::WriteOnly)) {
+        qCritical("Could not write binary snapshot of entities.");
+        return false;
+    }
+
+    bool success = writeToBinarySnapshot(persistFile, top);
+    if (!success) {
+        qCritical("Failed to write binary snapshot.");
+    }
+    return success;
+}
+
 bool Octree::writeToSVOFile(const char* fileName, OctreeElementPointer element) {
     qWarning() << "SVO file format deprecated. Support for reading SVO files is no longer support and will be removed soon.";
     bool success = false;
@@ -16,8 +16,10 @@
 #include <set>
 
 #include <QHash>
+#include <QIODevice>
 #include <QObject>
 
+#include <AABox.h>
 #include <shared/ReadWriteLockable.h>
 #include <SimpleMovingAverage.h>
 #include <ViewFrustum.h>
@@ -82,6 +84,14 @@ public:
     JurisdictionMap* jurisdictionMap;
     OctreeElementExtraEncodeData* extraEncodeData;
 
+    // the region of interest and item types of the viewer, see OctreeQuery
+    bool hasInterestBox { false };
+    AABox interestBox;
+    quint32 interestTypes { ALL_INTEREST_TYPES };
+
+    bool isInInterest(const AACube& cube) const { return !hasInterestBox || interestBox.touches(cube); }
+    bool isTypeOfInterest(int type) const { return type < 32 && (interestTypes & (1U << type)); }
+
     // output hints from the encode process
     typedef enum {
         UNKNOWN,
@@ -161,7 +171,17 @@ public:
         }
     }
 
-    std::function<void(const QUuid& dataID, quint64 itemLastEdited)> trackSend { [](const QUuid&, quint64){} };
+    std::function<void(const QUuid& dataID, quint64 itemLastEdited, bool sentAllData)> trackSend
+        { [](const QUuid&, quint64, bool){} };
+
+    // the server time at which the viewer was last sent all of the data of an item, 0 if it never was
+    std::function<quint64(const QUuid& dataID)> getLastSentAllData { [](const QUuid&) -> quint64 { return 0; } };
+
+    // lets the server put off sending the change of an item to the viewer, see OctreeQueryNode::shouldSendItem()
+    std::function<bool(const QUuid& dataID, quint64 itemLastChanged, float distance, bool isMoving)> shouldSendItem
+        { [](const QUuid&, quint64, float, bool) { return true; } };
+    std::function<void(const QUuid& dataID, quint64 itemLastChanged, int bytes)> itemSent
+        { [](const QUuid&, quint64, int) { } };
 };
 
 class ReadElementBufferToTreeArgs {
@@ -218,6 +238,13 @@ public:
     virtual bool handlesEditPacketType(PacketType packetType) const { return false; }
     virtual int processEditPacketData(ReceivedMessage& message, const unsigned char* editData, int maxLength,
                                       const SharedNodePointer& sourceNode) { return 0; }
+
+    // Trees that can decode the edits of a message before processEditPacketData() is called for them - on any thread,
+    // and without the tree lock - implement these so that the server can decode many edit messages in parallel.
+    // editsPosition is where the first edit starts in the message data
+    virtual bool canDecodeEditsAhead() const { return false; }
+    virtual void decodeEditsAhead(const ReceivedMessage& message, int editsPosition) { }
+    virtual void releaseEditsDecodedAhead(const ReceivedMessage& message) { }
                     
     virtual bool recurseChildrenWithData() const { return true; }
     virtual bool rootElementHasData() const { return false; }
@@ -302,9 +329,15 @@ public:
     bool writeToFile(const char* filename, OctreeElementPointer element = NULL, QString persistAsFileType = "svo");
     bool writeToJSONFile(const char* filename, OctreeElementPointer element = NULL, bool doGzip = false);
     bool writeToSVOFile(const char* filename, OctreeElementPointer element = NULL);
+    bool writeToBinaryFile(const char* filename, OctreeElementPointer element = NULL);
     virtual bool writeToMap(QVariantMap& entityDescription, OctreeElementPointer element, bool skipDefaultValues,
                             bool skipThoseWithBadParents) = 0;
 
+    // Binary snapshot ("bin" persist file type), for trees that support it. The file is memory mapped when read, so
+    // a tree can build itself straight from the data without going through a QVariantMap.
+    virtual bool writeToBinarySnapshot(QIODevice& device, OctreeElementPointer element) { return false; }
+    virtual bool readFromBinarySnapshot(const char* data, qint64 size) { return false; }
+
     // Octree importers
     bool readFromFile(const char* filename);
     bool readFromURL(const QString& url); // will support file urls as well...
@@ -312,8 +345,17 @@ public:
     bool readSVOFromStream(unsigned long streamLength, QDataStream& inputStream);
     bool readJSONFromStream(unsigned long streamLength, QDataStream& inputStream);
     bool readJSONFromGzippedFile(QString qFileName);
+    bool readFromBinaryFile(QString qFileName);
     virtual bool readFromMap(QVariantMap& entityDescription) = 0;
 
+    // Incremental persistence, see OctreePersistThread. While the journal is enabled a tree that supports it keeps
+    // track of what was added, edited or deleted, and takeJournalRecords returns those changes since the last call.
+    // replayJournalOnMap applies records, in order, to a map read from the persist file (before readFromMap).
+    virtual bool supportsJournal() const { return false; }
+    virtual void setJournalEnabled(bool enabled) { }
+    virtual QVariantList takeJournalRecords() { return QVariantList(); }
+    virtual void replayJournalOnMap(QVariantMap& entityDescription, const QVariantList& records) const { }
+
     unsigned long getOctreeElementsCount();
 
     bool getShouldReaverage() const { return _shouldReaverage; }
@@ -47,4 +47,7 @@ const float SMALLEST_REASONABLE_OCTREE_ELEMENT_SCALE = SCALE_AT_UNREASONABLY_DEE
 
 const int DEFAULT_MAX_OCTREE_PPS = 600; // the default maximum PPS we think any octree based server should send to a client
 
+// a bit mask of the item types (entity types for the entity server) a viewer wants sent, by default it wants all of them
+const quint32 ALL_INTEREST_TYPES = 0xFFFFFFFF;
+
 #endif // hifi_OctreeConstants_h
@@ -13,7 +13,8 @@
 #include <OctalCode.h>
 
 void OctreeElementBag::deleteAll() {
-    _bagElements = Bag();
+    _bagElements.clear();
+    _bagIndices.clear();
 }
 
 /// does the bag contain elements?
@@ -24,17 +25,23 @@ bool OctreeElementBag::isEmpty() {
 }
 
 void OctreeElementBag::insert(OctreeElementPointer element) {
-    _bagElements[element.get()] = element;
+    auto inserted = _bagIndices.emplace(element.get(), _bagElements.size());
+    if (inserted.second) {
+        _bagElements.emplace_back(element.get(), element);
+    } else {
+        // the element may be a new one at the address of an expired one
+        _bagElements[inserted.first->second].second = element;
+    }
 }
 
 OctreeElementPointer OctreeElementBag::extract() {
     OctreeElementPointer result;
 
-    // Find the first element still alive
-    Bag::iterator it = _bagElements.begin();
-    while (it != _bagElements.end() && !result) {
-        result = it->second.lock();
-        it = _bagElements.erase(it);
+    // Find the last element still alive, the most recently inserted is the most likely to still be in the cache
+    while (!_bagElements.empty() && !result) {
+        result = _bagElements.back().second.lock();
+        _bagIndices.erase(_bagElements.back().first);
+        _bagElements.pop_back();
     }
     return result;
 }
@@ -17,27 +17,31 @@
 #define hifi_OctreeElementBag_h
 
 #include <unordered_map>
+#include <vector>
 
 #include "OctreeElement.h"
 
+// The elements are kept in a vector and extracted from its back, so the index of an element stays valid while it is in
+// the bag. They are de-duped with a map from the raw pointers to those indices.
 class OctreeElementBag {
-    using Bag = std::unordered_map<OctreeElement*, OctreeElementWeakPointer>;
-    
+    using Bag = std::vector<std::pair<OctreeElement*, OctreeElementWeakPointer>>;
+
 public:
     void insert(OctreeElementPointer element); // put a element into the bag
 
     OctreeElementPointer extract(); /// pull a element out of the bag (could come in any order) and if all of the
                                     /// elements have expired, a single null pointer will be returned
 
-    bool isEmpty(); /// does the bag contain elements, 
+    bool isEmpty(); /// does the bag contain elements,
                     /// if all of the contained elements are expired, they will not report as empty, and
                     /// a single last item will be returned by extract as a null pointer
-    
+
     void deleteAll();
     size_t size() const { return _bagElements.size(); }
 
 private:
     Bag _bagElements;
+    std::unordered_map<OctreeElement*, size_t> _bagIndices;
 };
 
 using OctreeElementExtraEncodeData = QMap<const OctreeElement*, void*>;
@@ -22,6 +22,21 @@ void OctreeHeadlessViewer::init() {
     OctreeRenderer::init();
 }
 
+void OctreeHeadlessViewer::setInterestBox(const glm::vec3& corner, const glm::vec3& dimensions) {
+    _octreeQuery.setInterestBox(AABox(corner, dimensions));
+    interestChanged();
+}
+
+void OctreeHeadlessViewer::setInterestRadius(const glm::vec3& center, float radius) {
+    _octreeQuery.setInterestBox(AABox(center - glm::vec3(radius), glm::vec3(2.0f * radius)));
+    interestChanged();
+}
+
+void OctreeHeadlessViewer::clearInterestBox() {
+    _octreeQuery.clearInterestBox();
+    interestChanged();
+}
+
 void OctreeHeadlessViewer::queryOctree() {
     char serverType = getMyNodeType();
     PacketType packetType = getMyQueryMessageType();
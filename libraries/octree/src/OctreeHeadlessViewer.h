@@ -54,6 +54,11 @@ public slots:
     void setBoundaryLevelAdjust(int boundaryLevelAdjust) { _boundaryLevelAdjust = boundaryLevelAdjust; }
     void setMaxPacketsPerSecond(int maxPacketsPerSecond) { _maxPacketsPerSecond = maxPacketsPerSecond; }
 
+    // setters for the region of interest, when there is one the servers only send what touches it (and is in view)
+    void setInterestBox(const glm::vec3& corner, const glm::vec3& dimensions);
+    void setInterestRadius(const glm::vec3& center, float radius); // the box bounding the sphere
+    void clearInterestBox();
+
     // getters for camera attributes
     const glm::vec3& getPosition() const { return _viewFrustum.getPosition(); }
     const glm::quat& getOrientation() const { return _viewFrustum.getOrientation(); }
@@ -65,9 +70,14 @@ public slots:
 
     unsigned getOctreeElementsCount() const { return _tree->getOctreeElementsCount(); }
 
+protected:
+    // called when the region of interest or the types of interest change, with the query already updated
+    virtual void interestChanged() { }
+
+    OctreeQuery _octreeQuery;
+
 private:
     JurisdictionListener* _jurisdictionListener = nullptr;
-    OctreeQuery _octreeQuery;
 
     float _voxelSizeScale { DEFAULT_OCTREE_SIZE_SCALE };
     int _boundaryLevelAdjust { 0 };
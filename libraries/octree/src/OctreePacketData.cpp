@@ -9,6 +9,11 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
+#include <cstring>
+
+#include <zlib.h>
+
 #include <GLMHelpers.h>
 #include <PerfStat.h>
 
@@ -33,8 +38,9 @@ OctreePacketData::OctreePacketData(bool enableCompression, int targetSize) {
     changeSettings(enableCompression, targetSize); // does reset...
 }
 
-void OctreePacketData::changeSettings(bool enableCompression, unsigned int targetSize) {
+void OctreePacketData::changeSettings(bool enableCompression, unsigned int targetSize, int compressionLevel) {
     _enableCompression = enableCompression;
+    _compressionLevel = compressionLevel;
     _targetSize = std::min(MAX_OCTREE_UNCOMRESSED_PACKET_SIZE, targetSize);
     reset();
 }
@@ -558,6 +564,17 @@ bool OctreePacketData::appendRawData(QByteArray data) {
 }
 
 
+int OctreePacketData::compressionLevelForPacketType(PacketType type) {
+    switch (type) {
+        case PacketType::EntityData:
+            // compressed on the server's send threads, for every client of every scene, so it favours speed - the
+            // bigger sections it makes only cost a little more packing
+            return FAST_PACKET_COMPRESSION_LEVEL;
+        default:
+            return MAX_PACKET_COMPRESSION_LEVEL;
+    }
+}
+
 AtomicUIntStat OctreePacketData::_compressContentTime { 0 };
 AtomicUIntStat OctreePacketData::_compressContentCalls { 0 };
 
@@ -572,19 +589,23 @@ bool OctreePacketData::compressContent() {
     _bytesInUseLastCheck = _bytesInUse;
 
     bool success = false;
-    const int MAX_COMPRESSION = 9;
 
     // we only want to compress the data payload, not the message header
     const uchar* uncompressedData = &_uncompressed[0];
     int uncompressedSize = _bytesInUse;
 
-    QByteArray compressedData = qCompress(uncompressedData, uncompressedSize, MAX_COMPRESSION);
-
-    if (compressedData.size() < (int)MAX_OCTREE_PACKET_DATA_SIZE) {
-        _compressedBytes = compressedData.size();
-        for (int i = 0; i < _compressedBytes; i++) {
-            _compressed[i] = compressedData[i];
-        }
+    // this is the layout qCompress makes, the big endian uncompressed size then the zlib stream, so qUncompress still
+    // reads it, but it is deflated straight into _compressed rather than into a new QByteArray that is then copied
+    const int UNCOMPRESSED_SIZE_BYTES = sizeof(quint32);
+    uLongf compressedSize = MAX_OCTREE_PACKET_DATA_SIZE - 1 - UNCOMPRESSED_SIZE_BYTES;
+
+    if (compress2(_compressed + UNCOMPRESSED_SIZE_BYTES, &compressedSize, uncompressedData, uncompressedSize,
+                  _compressionLevel) == Z_OK) {
+        _compressed[0] = (uncompressedSize >> 24) & 0xff;
+        _compressed[1] = (uncompressedSize >> 16) & 0xff;
+        _compressed[2] = (uncompressedSize >> 8) & 0xff;
+        _compressed[3] = uncompressedSize & 0xff;
+        _compressedBytes = UNCOMPRESSED_SIZE_BYTES + (int)compressedSize;
         _dirty = false;
         success = true;
     }
@@ -598,25 +619,21 @@ void OctreePacketData::loadFinalizedContent(const unsigned char* data, int lengt
     if (data && length > 0) {
 
         if (_enableCompression) {
-            QByteArray compressedData;
-            for (int i = 0; i < length; i++) {
-                compressedData[i] = data[i];
-                _compressed[i] = compressedData[i];
-            }
+            length = std::min(length, (int)MAX_OCTREE_UNCOMRESSED_PACKET_SIZE);
+            memcpy(_compressed, data, length);
             _compressedBytes = length;
-            QByteArray uncompressedData = qUncompress(compressedData);
+
+            // qUncompress with the raw bytes saves copying the section into a QByteArray first
+            QByteArray uncompressedData = qUncompress(reinterpret_cast<const uchar*>(data), length);
             if (uncompressedData.size() <= _bytesAvailable) {
                 _bytesInUse = uncompressedData.size();
                 _bytesAvailable -= uncompressedData.size();
-
-                for (int i = 0; i < _bytesInUse; i++) {
-                    _uncompressed[i] = uncompressedData[i];
-                }
+                memcpy(_uncompressed, uncompressedData.constData(), _bytesInUse);
             }
         } else {
-            for (int i = 0; i < length; i++) {
-                _uncompressed[i] = _compressed[i] = data[i];
-            }
+            length = std::min(length, (int)MAX_OCTREE_UNCOMRESSED_PACKET_SIZE);
+            memcpy(_uncompressed, data, length);
+            memcpy(_compressed, data, length);
             _bytesInUse = _compressedBytes = length;
         }
     } else {
@@ -60,6 +60,11 @@ const int REASONABLE_NUMBER_OF_PACKING_ATTEMPTS = 5;
 const int PACKET_IS_COLOR_BIT = 0;
 const int PACKET_IS_COMPRESSED_BIT = 1;
 
+// zlib levels for compressed sections. qUncompress reads any level, so a sender can change the level per packet type
+// without the receivers having to know about it.
+const int FAST_PACKET_COMPRESSION_LEVEL = 1;
+const int MAX_PACKET_COMPRESSION_LEVEL = 9;
+
 /// An opaque key used when starting, ending, and discarding encoding/packing levels of OctreePacketData
 class LevelDetails {
     LevelDetails(int startIndex, int bytesOfOctalCodes, int bytesOfBitmasks, int bytesOfColor, int bytesReservedAtStart) :
@@ -87,7 +92,11 @@ public:
     ~OctreePacketData();
 
     /// change compression and target size settings
-    void changeSettings(bool enableCompression = false, unsigned int targetSize = MAX_OCTREE_PACKET_DATA_SIZE);
+    void changeSettings(bool enableCompression = false, unsigned int targetSize = MAX_OCTREE_PACKET_DATA_SIZE,
+                        int compressionLevel = MAX_PACKET_COMPRESSION_LEVEL);
+
+    /// the compression level to use for the sections of packets of this type
+    static int compressionLevelForPacketType(PacketType type);
 
     /// reset completely, all data is discarded
     void reset();
@@ -277,6 +286,7 @@ private:
 
     unsigned int _targetSize;
     bool _enableCompression;
+    int _compressionLevel { MAX_PACKET_COMPRESSION_LEVEL };
     
     unsigned char _uncompressed[MAX_OCTREE_UNCOMRESSED_PACKET_SIZE];
     int _bytesInUse;
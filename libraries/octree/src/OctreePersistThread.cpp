@@ -9,6 +9,7 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
 #include <chrono>
 #include <thread>
 
@@ -21,10 +22,12 @@
 #include <QDir>
 #include <QDirIterator>
 #include <QFile>
+#include <QFileInfo>
 #include <QJsonArray>
 #include <QJsonObject>
 #include <QJsonDocument>
 
+#include <Gzip.h>
 #include <NumericalConstants.h>
 #include <PerfStat.h>
 #include <PathUtils.h>
@@ -33,6 +36,10 @@
 #include "OctreePersistThread.h"
 
 const int OctreePersistThread::DEFAULT_PERSIST_INTERVAL = 1000 * 30; // every 30 seconds
+const int OctreePersistThread::DEFAULT_PERSIST_COMPACTION_INTERVAL = 60 * 60; // every hour
+
+// a journal that grows past the persist file (or this) is folded into the persist file at the next save
+static const qint64 MIN_COMPACTION_JOURNAL_SIZE = 1024 * 1024;
 
 OctreePersistThread::OctreePersistThread(OctreePointer tree, const QString& filename, const QString& backupDirectory, int persistInterval,
                                          bool wantBackup, const QJsonObject& settings, bool debugTimestampNow,
@@ -47,7 +54,8 @@ OctreePersistThread::OctreePersistThread(OctreePointer tree, const QString& file
     _wantBackup(wantBackup),
     _debugTimestampNow(debugTimestampNow),
     _lastTimeDebug(0),
-    _persistAsFileType(persistAsFileType)
+    _persistAsFileType(persistAsFileType),
+    _persistCompactionInterval(DEFAULT_PERSIST_COMPACTION_INTERVAL)
 {
     parseSettings(settings);
 
@@ -61,11 +69,21 @@ QString OctreePersistThread::getPersistFileMimeType() const {
         return "application/json";
     } if (_persistAsFileType == "json.gz") {
         return "application/zip";
+    } if (_persistAsFileType == "bin") {
+        return "application/octet-stream";
     }
     return "";
 }
 
 void OctreePersistThread::parseSettings(const QJsonObject& settings) {
+    QJsonValue compactionIntervalVal = settings["persistCompactionInterval"];
+    if (compactionIntervalVal.isString()) {
+        _persistCompactionInterval = compactionIntervalVal.toString().toInt();
+    } else if (compactionIntervalVal.isDouble()) {
+        _persistCompactionInterval = compactionIntervalVal.toInt();
+    }
+    qCDebug(octree) << "persistCompactionInterval:" << _persistCompactionInterval;
+
     if (settings["backups"].isArray()) {
         const QJsonArray& backupRules = settings["backups"].toArray();
         qCDebug(octree) << "BACKUP RULES:";
@@ -139,6 +157,8 @@ bool OctreePersistThread::process() {
         qCDebug(octree) << "loading Octrees from file: " << _filename << "...";
 
         bool persistantFileRead;
+        bool wantJournal = _tree->supportsJournal() && _persistCompactionInterval > 0
+            && _persistAsFileType.startsWith("json");
 
         _tree->withWriteLock([&] {
             PerformanceWarning warn(true, "Loading Octree File", true);
@@ -146,6 +166,7 @@ bool OctreePersistThread::process() {
             // First check to make sure "lock" file doesn't exist. If it does exist, then
             // our last save crashed during the save, and we want to load our most recent backup.
             QString lockFileName = _filename + ".lock";
+            QVariantList journalRecords;
             std::ifstream lockFile(qPrintable(lockFileName), std::ios::in | std::ios::binary | std::ios::ate);
             if (lockFile.is_open()) {
                 qCDebug(octree) << "WARNING: Octree lock file detected at startup:" << lockFileName
@@ -159,9 +180,27 @@ bool OctreePersistThread::process() {
                 qCDebug(octree) << "Loading Octree... lock file closed:" << lockFileName;
                 remove(qPrintable(lockFileName));
                 qCDebug(octree) << "Loading Octree... lock file removed:" << lockFileName;
+
+                // the changes journaled since the backup are in the journal the crashed save rotated out, and after it
+                readJournal(getOldJournalFilename(), journalRecords);
+            } else if (QFile::exists(getOldJournalFilename())) {
+                // the last save completed, so the persist file already has these changes
+                qCDebug(octree) << "Loading Octree... removing journal of a completed save:" << getOldJournalFilename();
+                QFile::remove(getOldJournalFilename());
             }
+            readJournal(getJournalFilename(), journalRecords);
+
+            QVariantMap entityDescription;
+            if (!journalRecords.isEmpty() && readPersistFileToMap(entityDescription)) {
+                qCDebug(octree) << "Loading Octree... replaying" << journalRecords.size() << "journal records";
+                _tree->replayJournalOnMap(entityDescription, journalRecords);
+                persistantFileRead = _tree->readFromMap(entityDescription);
 
-            persistantFileRead = _tree->readFromFile(qPrintable(_filename.toLocal8Bit()));
+                // fold the journal into the persist file at the first save
+                _forceCompaction = true;
+            } else {
+                persistantFileRead = _tree->readFromFile(qPrintable(_filename.toLocal8Bit()));
+            }
             _tree->pruneTree();
         });
 
@@ -169,6 +208,15 @@ bool OctreePersistThread::process() {
         _loadTimeUSecs = loadDone - loadStarted;
 
         _tree->clearDirtyBit(); // the tree is clean since we just loaded it
+        if (_forceCompaction) {
+            _tree->setDirtyBit(); // but not the persist file, it is missing the journal we replayed
+        }
+
+        // only record changes from here on, the load itself is in the persist file (and journal)
+        if (wantJournal) {
+            _tree->setJournalEnabled(true);
+            _isJournalEnabled = true;
+        }
         qCDebug(octree, "DONE loading Octrees from file... fileRead=%s", debug::valueOf(persistantFileRead));
 
         unsigned long nodeCount = OctreeElement::getNodeCount();
@@ -198,6 +246,7 @@ bool OctreePersistThread::process() {
         // used in formatting the backup filename in cases of non-rolling backup names. However, we don't
         // want an uninitialized value for this, so we set it to the current time (startup of the server)
         time(&_lastPersistTime);
+        _lastCompaction = usecTimestampNow();
 
         emit loadCompleted();
     }
@@ -237,6 +286,7 @@ bool OctreePersistThread::process() {
 
 void OctreePersistThread::aboutToFinish() {
     qCDebug(octree) << "Persist thread about to finish...";
+    _isFinishing = true;
     persist();
     qCDebug(octree) << "Persist thread done with about to finish...";
     _stopThread = true;
@@ -254,6 +304,20 @@ QByteArray OctreePersistThread::getPersistFileContents() const {
 void OctreePersistThread::persist() {
     if (_tree->isDirty() && _initialLoadComplete) {
 
+        if (_isJournalEnabled && !isCompactionDue()) {
+            QVariantList records;
+            _tree->withReadLock([&] {
+                // edits need the write lock, so the dirty bit and the records agree
+                _tree->clearDirtyBit();
+                records = _tree->takeJournalRecords();
+            });
+
+            if (appendToJournal(records)) {
+                return;
+            }
+            qCDebug(octree) << "ERROR appending to journal" << getJournalFilename() << "-- saving the full Octree instead";
+        }
+
         _tree->withWriteLock([&] {
             qCDebug(octree) << "pruning Octree before saving...";
             _tree->pruneTree();
@@ -271,6 +335,14 @@ void OctreePersistThread::persist() {
         if(lockFile.is_open()) {
             qCDebug(octree) << "saving Octree lock file created at:" << lockFileName;
 
+            if (_isJournalEnabled) {
+                // the persist file we write has everything journaled so far
+                _tree->withReadLock([&] {
+                    _tree->takeJournalRecords();
+                });
+                rotateJournal();
+            }
+
             _tree->writeToFile(qPrintable(_filename), NULL, _persistAsFileType);
             time(&_lastPersistTime);
             _tree->clearDirtyBit(); // tree is clean after saving
@@ -280,10 +352,149 @@ void OctreePersistThread::persist() {
             qCDebug(octree) << "saving Octree lock file closed:" << lockFileName;
             remove(qPrintable(lockFileName));
             qCDebug(octree) << "saving Octree lock file removed:" << lockFileName;
+
+            if (_isJournalEnabled) {
+                QFile::remove(getOldJournalFilename());
+                _lastCompaction = usecTimestampNow();
+                _forceCompaction = false;
+            }
         }
     }
 }
 
+bool OctreePersistThread::isCompactionDue() {
+    quint64 now = usecTimestampNow();
+
+    if (_forceCompaction || _isFinishing
+        || now - _lastCompaction > (quint64)_persistCompactionInterval * USECS_PER_SECOND) {
+        return true;
+    }
+
+    // backups copy the persist file, so it has to be complete when one is due
+    if (_wantBackup) {
+        foreach(const BackupRule& rule, _backupRules) {
+            if (now - rule.lastBackup > (quint64)rule.interval * USECS_PER_SECOND) {
+                return true;
+            }
+        }
+    }
+
+    qint64 journalSize = QFileInfo(getJournalFilename()).size();
+    qint64 persistFileSize = QFileInfo(_filename).size();
+    return journalSize >= std::max(MIN_COMPACTION_JOURNAL_SIZE, persistFileSize);
+}
+
+void OctreePersistThread::readJournal(const QString& journalFilename, QVariantList& records) {
+    QFile journalFile(journalFilename);
+    if (!journalFile.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    int numRecords = 0;
+    while (!journalFile.atEnd()) {
+        QByteArray line = journalFile.readLine().trimmed();
+        if (line.isEmpty()) {
+            continue;
+        }
+
+        QJsonParseError error;
+        QJsonDocument record = QJsonDocument::fromJson(line, &error);
+        if (error.error != QJsonParseError::NoError || !record.isObject()) {
+            // the tail of a journal that was being appended to when we went down
+            qCDebug(octree) << "WARNING: ignoring the rest of journal" << journalFilename << "after" << numRecords << "records";
+            break;
+        }
+        records << record.toVariant();
+        ++numRecords;
+    }
+    qCDebug(octree) << "Read" << numRecords << "records from journal" << journalFilename;
+}
+
+bool OctreePersistThread::readPersistFileToMap(QVariantMap& entityDescription) {
+    QString persistFilename = findMostRecentFileExtension(_filename, PERSIST_EXTENSIONS);
+    QFile persistFile(persistFilename);
+
+    if (!persistFile.exists()) {
+        // everything is in the journal
+        entityDescription["Entities"] = QVariantList();
+        return true;
+    }
+
+    if (!persistFilename.endsWith(".json") && !persistFilename.endsWith(".json.gz")) {
+        qCDebug(octree) << "WARNING: can not replay the journal on" << persistFilename;
+        return false;
+    }
+
+    if (!persistFile.open(QIODevice::ReadOnly)) {
+        qCDebug(octree) << "ERROR opening" << persistFilename << "to replay the journal";
+        return false;
+    }
+
+    QByteArray jsonData = persistFile.readAll();
+    if (persistFilename.endsWith(".json.gz")) {
+        QByteArray compressedJsonData = jsonData;
+        if (!gunzip(compressedJsonData, jsonData)) {
+            qCDebug(octree) << "ERROR:" << persistFilename << "is not in gzip format";
+            return false;
+        }
+    }
+
+    QJsonDocument asDocument = QJsonDocument::fromJson(jsonData);
+    if (!asDocument.isObject()) {
+        qCDebug(octree) << "ERROR parsing" << persistFilename << "to replay the journal";
+        return false;
+    }
+    entityDescription = asDocument.toVariant().toMap();
+    return true;
+}
+
+bool OctreePersistThread::appendToJournal(const QVariantList& records) {
+    if (records.isEmpty()) {
+        return true;
+    }
+
+    QByteArray lines;
+    foreach(const QVariant& record, records) {
+        lines += QJsonDocument::fromVariant(record).toJson(QJsonDocument::Compact);
+        lines += '\n';
+    }
+
+    QFile journalFile(getJournalFilename());
+    if (!journalFile.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        return false;
+    }
+    bool success = journalFile.write(lines) == lines.size() && journalFile.flush();
+    journalFile.close();
+
+    qCDebug(octree) << "Appended" << records.size() << "records to journal" << getJournalFilename();
+    return success;
+}
+
+void OctreePersistThread::rotateJournal() {
+    QFile journalFile(getJournalFilename());
+    if (!journalFile.exists()) {
+        return;
+    }
+
+    QFile oldJournalFile(getOldJournalFilename());
+    if (!oldJournalFile.exists()) {
+        if (!journalFile.rename(getOldJournalFilename())) {
+            qCDebug(octree) << "ERROR rotating journal" << getJournalFilename();
+        }
+        return;
+    }
+
+    // an earlier save did not complete, its journal still has to be replayed ahead of this one
+    if (journalFile.open(QIODevice::ReadOnly) && oldJournalFile.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        oldJournalFile.write(journalFile.readAll());
+        oldJournalFile.close();
+        journalFile.close();
+        journalFile.remove();
+    } else {
+        qCDebug(octree) << "ERROR rotating journal" << getJournalFilename() << "onto" << getOldJournalFilename();
+    }
+}
+
 void OctreePersistThread::restoreFromMostRecentBackup() {
     qCDebug(octree) << "Restoring from most recent backup...";
     
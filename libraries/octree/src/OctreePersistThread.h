@@ -32,6 +32,7 @@ public:
     };
 
     static const int DEFAULT_PERSIST_INTERVAL;
+    static const int DEFAULT_PERSIST_COMPACTION_INTERVAL;
 
     OctreePersistThread(OctreePointer tree, const QString& filename, const QString& backupDirectory,
                         int persistInterval = DEFAULT_PERSIST_INTERVAL, bool wantBackup = false,
@@ -61,6 +62,15 @@ protected:
     quint64 getMostRecentBackupTimeInUsecs(const QString& format);
     void parseSettings(const QJsonObject& settings);
 
+    // journal of the changes since the last full save, see Octree::takeJournalRecords()
+    QString getJournalFilename() const { return _filename + ".journal"; }
+    QString getOldJournalFilename() const { return _filename + ".journal.old"; }
+    void readJournal(const QString& journalFilename, QVariantList& records);
+    bool readPersistFileToMap(QVariantMap& entityDescription);
+    bool appendToJournal(const QVariantList& records);
+    void rotateJournal();
+    bool isCompactionDue();
+
 private:
     OctreePointer _tree;
     QString _filename;
@@ -79,6 +89,12 @@ private:
     quint64 _lastTimeDebug;
 
     QString _persistAsFileType;
+
+    int _persistCompactionInterval; // seconds, 0 to always write the full persist file
+    bool _isJournalEnabled { false };
+    bool _forceCompaction { false };
+    bool _isFinishing { false };
+    quint64 _lastCompaction { 0 };
 };
 
 #endif // hifi_OctreePersistThread_h
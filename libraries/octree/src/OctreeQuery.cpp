@@ -66,7 +66,22 @@ int OctreeQuery::getBroadcastData(unsigned char* destinationBuffer) {
 
     memcpy(destinationBuffer, &_cameraCenterRadius, sizeof(_cameraCenterRadius));
     destinationBuffer += sizeof(_cameraCenterRadius);
-    
+
+    // the region of interest is only written by viewers that have one, so that the query of others doesn't change
+    if (_hasInterestBox || _interestTypes != ALL_INTEREST_TYPES) {
+        *destinationBuffer++ = _hasInterestBox ? 1 : 0;
+
+        const glm::vec3& corner = _interestBox.getCorner();
+        memcpy(destinationBuffer, &corner, sizeof(corner));
+        destinationBuffer += sizeof(corner);
+        const glm::vec3& dimensions = _interestBox.getDimensions();
+        memcpy(destinationBuffer, &dimensions, sizeof(dimensions));
+        destinationBuffer += sizeof(dimensions);
+
+        memcpy(destinationBuffer, &_interestTypes, sizeof(_interestTypes));
+        destinationBuffer += sizeof(_interestTypes);
+    }
+
     return destinationBuffer - bufferStart;
 }
 
@@ -113,6 +128,27 @@ int OctreeQuery::parseData(ReceivedMessage& message) {
         memcpy(&_cameraCenterRadius, sourceBuffer, sizeof(_cameraCenterRadius));
         sourceBuffer += sizeof(_cameraCenterRadius);
     }
+
+    const int INTEREST_BYTES = sizeof(unsigned char) + 2 * sizeof(glm::vec3) + sizeof(_interestTypes);
+    bytesRead = sourceBuffer - startPosition;
+    bytesLeft = message.getSize() - bytesRead;
+    if (bytesLeft >= INTEREST_BYTES) {
+        _hasInterestBox = (*sourceBuffer++ != 0);
+
+        glm::vec3 corner;
+        memcpy(&corner, sourceBuffer, sizeof(corner));
+        sourceBuffer += sizeof(corner);
+        glm::vec3 dimensions;
+        memcpy(&dimensions, sourceBuffer, sizeof(dimensions));
+        sourceBuffer += sizeof(dimensions);
+        _interestBox.setBox(corner, dimensions);
+
+        memcpy(&_interestTypes, sourceBuffer, sizeof(_interestTypes));
+        sourceBuffer += sizeof(_interestTypes);
+    } else {
+        _hasInterestBox = false;
+        _interestTypes = ALL_INTEREST_TYPES;
+    }
     return sourceBuffer - startPosition;
 }
 
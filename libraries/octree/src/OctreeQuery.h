@@ -31,8 +31,11 @@ typedef unsigned long long quint64;
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
 
+#include <AABox.h>
 #include <NodeData.h>
 
+#include "OctreeConstants.h"
+
 // First bitset
 const int WANT_LOW_RES_MOVING_BIT = 0;
 const int WANT_COLOR_AT_BIT = 1;
@@ -77,6 +80,15 @@ public:
     float getOctreeSizeScale() const { return _octreeElementSizeScale; }
     int getBoundaryLevelAdjust() const { return _boundaryLevelAdjust; }
 
+    // an optional region of interest, a viewer that has one is only sent the items that touch it (and that it can see)
+    bool hasInterestBox() const { return _hasInterestBox; }
+    const AABox& getInterestBox() const { return _interestBox; }
+    quint32 getInterestTypes() const { return _interestTypes; }
+
+    void setInterestBox(const AABox& box) { _interestBox = box; _hasInterestBox = true; }
+    void clearInterestBox() { _hasInterestBox = false; }
+    void setInterestTypes(quint32 interestTypes) { _interestTypes = interestTypes; }
+
 public slots:
     void setMaxQueryPacketsPerSecond(int maxQueryPPS) { _maxQueryPPS = maxQueryPPS; }
     void setOctreeSizeScale(float octreeSizeScale) { _octreeElementSizeScale = octreeSizeScale; }
@@ -98,6 +110,10 @@ protected:
     float _octreeElementSizeScale = DEFAULT_OCTREE_SIZE_SCALE; /// used for LOD calculations
     int _boundaryLevelAdjust = 0; /// used for LOD calculations
 
+    bool _hasInterestBox { false };
+    AABox _interestBox;
+    quint32 _interestTypes { ALL_INTEREST_TYPES };
+
 private:
     // privatize the copy constructor and assignment operator so they cannot be called
     OctreeQuery(const OctreeQuery&);
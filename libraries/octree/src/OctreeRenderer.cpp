@@ -20,6 +20,9 @@
 #include "OctreeLogging.h"
 #include "OctreeRenderer.h"
 
+// past this age, staged changes are applied even when the frame budget is spent, so a busy scene can't starve them
+static const quint64 MAX_STAGED_CHANGE_AGE_USECS = 500 * USECS_PER_MSEC;
+
 OctreeRenderer::OctreeRenderer() :
     _tree(NULL),
     _managedTree(false)
@@ -89,19 +92,16 @@ void OctreeRenderer::processDatagram(ReceivedMessage& message, SharedNodePointer
         }
         
         _packetsInLastWindow++;
-        
-        int elementsPerPacket = 0;
-        int entitiesPerPacket = 0;
-        
-        quint64 totalWaitingForLock = 0;
-        quint64 totalUncompress = 0;
-        quint64 totalReadBitsteam = 0;
 
         const QUuid& sourceUUID = message.getSourceID();
         
         int subsection = 1;
         
         bool error = false;
+
+        // decompress all the sections up front, so that the tree lock is only held to read them into the tree
+        std::vector<QByteArray> sections;
+        quint64 startUncompress = usecTimestampNow();
         
         while (message.getBytesLeftToRead() > 0 && !error) {
             if (packetIsCompressed) {
@@ -116,65 +116,46 @@ void OctreeRenderer::processDatagram(ReceivedMessage& message, SharedNodePointer
             }
             
             if (sectionLength) {
-                // ask the VoxelTree to read the bitstream into the tree
-                ReadBitstreamToTreeParams args(WANT_EXISTS_BITS, NULL,
-                                                sourceUUID, sourceNode, false, message.getVersion());
-                quint64 startUncompress, startLock = usecTimestampNow();
-                quint64 startReadBitsteam, endReadBitsteam;
-                // FIXME STUTTER - there may be an opportunity to bump this lock outside of the
-                // loop to reduce the amount of locking/unlocking we're doing
-                _tree->withWriteLock([&] {
-                    startUncompress = usecTimestampNow();
-
-                    OctreePacketData packetData(packetIsCompressed);
-                    packetData.loadFinalizedContent(reinterpret_cast<const unsigned char*>(message.getRawMessage() + message.getPosition()),
-                        sectionLength);
-                    if (extraDebugging) {
-                        qCDebug(octree) << "OctreeRenderer::processDatagram() ... "
-                            "Got Packet Section color:" << packetIsColored <<
-                            "compressed:" << packetIsCompressed <<
-                            "sequence: " << sequence <<
-                            "flight: " << flightTime << " usec" <<
-                            "size:" << message.getSize() <<
-                            "data:" << message.getBytesLeftToRead() <<
-                            "subsection:" << subsection <<
-                            "sectionLength:" << sectionLength <<
-                            "uncompressed:" << packetData.getUncompressedSize();
-                    }
-
-                    if (extraDebugging) {
-                        qCDebug(octree) << "OctreeRenderer::processDatagram() ******* START _tree->readBitstreamToTree()...";
-                    }
-                    startReadBitsteam = usecTimestampNow();
-                    _tree->readBitstreamToTree(packetData.getUncompressedData(), packetData.getUncompressedSize(), args);
-                    endReadBitsteam = usecTimestampNow();
-                    if (extraDebugging) {
-                        qCDebug(octree) << "OctreeRenderer::processDatagram() ******* END _tree->readBitstreamToTree()...";
-                    }
-                });
+                OctreePacketData packetData(packetIsCompressed);
+                packetData.loadFinalizedContent(reinterpret_cast<const unsigned char*>(message.getRawMessage() + message.getPosition()),
+                    sectionLength);
+                if (extraDebugging) {
+                    qCDebug(octree) << "OctreeRenderer::processDatagram() ... "
+                        "Got Packet Section color:" << packetIsColored <<
+                        "compressed:" << packetIsCompressed <<
+                        "sequence: " << sequence <<
+                        "flight: " << flightTime << " usec" <<
+                        "size:" << message.getSize() <<
+                        "data:" << message.getBytesLeftToRead() <<
+                        "subsection:" << subsection <<
+                        "sectionLength:" << sectionLength <<
+                        "uncompressed:" << packetData.getUncompressedSize();
+                }
+                sections.emplace_back(reinterpret_cast<const char*>(packetData.getUncompressedData()),
+                    packetData.getUncompressedSize());
                 
                 // seek forwards in packet
                 message.seek(message.getPosition() + sectionLength);
-
-                elementsPerPacket += args.elementsPerPacket;
-                entitiesPerPacket += args.entitiesPerPacket;
-
-                _elementsInLastWindow += args.elementsPerPacket;
-                _entitiesInLastWindow += args.entitiesPerPacket;
-
-                totalWaitingForLock += (startUncompress - startLock);
-                totalUncompress += (startReadBitsteam - startUncompress);
-                totalReadBitsteam += (endReadBitsteam - startReadBitsteam);
-
             }
             subsection++;
         }
-        _elementsPerPacket.updateAverage(elementsPerPacket);
-        _entitiesPerPacket.updateAverage(entitiesPerPacket);
+        _uncompressPerPacket.updateAverage(usecTimestampNow() - startUncompress);
 
-        _waitLockPerPacket.updateAverage(totalWaitingForLock);
-        _uncompressPerPacket.updateAverage(totalUncompress);
-        _readBitstreamPerPacket.updateAverage(totalReadBitsteam);
+        if (!sections.empty()) {
+            PacketVersion version = message.getVersion();
+            if (_stagingData) {
+                QUuid stagedSourceUUID = sourceUUID;
+                stageChange([this, sections, stagedSourceUUID, sourceNode, version] {
+                    readSectionsToTree(sections, stagedSourceUUID, sourceNode, version);
+                });
+            } else {
+                quint64 startLock = usecTimestampNow();
+                _tree->withWriteLock([&] {
+                    _waitLockPerPacket.updateAverage(usecTimestampNow() - startLock);
+                    readSectionsToTree(sections, sourceUUID, sourceNode, version);
+                });
+            }
+        }
         
         quint64 now = usecTimestampNow();
         if (_lastWindowAt == 0) {
@@ -198,6 +179,72 @@ void OctreeRenderer::processDatagram(ReceivedMessage& message, SharedNodePointer
     }
 }
 
+void OctreeRenderer::readSectionsToTree(const std::vector<QByteArray>& sections, const QUuid& sourceUUID,
+                                        const SharedNodePointer& sourceNode, PacketVersion version) {
+    int elementsPerPacket = 0;
+    int entitiesPerPacket = 0;
+
+    quint64 startReadBitstream = usecTimestampNow();
+    for (auto& section : sections) {
+        // ask the tree to read the bitstream
+        ReadBitstreamToTreeParams args(WANT_EXISTS_BITS, NULL, sourceUUID, sourceNode, false, version);
+        _tree->readBitstreamToTree(reinterpret_cast<const unsigned char*>(section.constData()), section.size(), args);
+
+        elementsPerPacket += args.elementsPerPacket;
+        entitiesPerPacket += args.entitiesPerPacket;
+    }
+    _readBitstreamPerPacket.updateAverage(usecTimestampNow() - startReadBitstream);
+
+    _elementsPerPacket.updateAverage(elementsPerPacket);
+    _entitiesPerPacket.updateAverage(entitiesPerPacket);
+
+    _elementsInLastWindow += elementsPerPacket;
+    _entitiesInLastWindow += entitiesPerPacket;
+}
+
+void OctreeRenderer::stageChange(std::function<void()> change) {
+    std::lock_guard<std::mutex> lock(_stagedChangesMutex);
+    _stagedChanges.push_back({ std::move(change), usecTimestampNow() });
+}
+
+size_t OctreeRenderer::getNumStagedChanges() const {
+    std::lock_guard<std::mutex> lock(_stagedChangesMutex);
+    return _stagedChanges.size();
+}
+
+void OctreeRenderer::applyStagedChanges(quint64 budgetUsecs) {
+    if (!_tree || getNumStagedChanges() == 0) {
+        return;
+    }
+
+    quint64 startLock = usecTimestampNow();
+    _tree->withWriteLock([&] {
+        quint64 startApply = usecTimestampNow();
+        _waitLockPerPacket.updateAverage(startApply - startLock);
+
+        quint64 applyUntil = startApply + budgetUsecs;
+        bool appliedAny = false;
+        while (true) {
+            StagedChange change;
+            {
+                std::lock_guard<std::mutex> lock(_stagedChangesMutex);
+                if (_stagedChanges.empty()) {
+                    break;
+                }
+                quint64 now = usecTimestampNow();
+                bool overdue = now - _stagedChanges.front().stagedAt > MAX_STAGED_CHANGE_AGE_USECS;
+                if (appliedAny && now > applyUntil && !overdue) {
+                    break;
+                }
+                change = std::move(_stagedChanges.front());
+                _stagedChanges.pop_front();
+            }
+            change.apply();
+            appliedAny = true;
+        }
+    });
+}
+
 bool OctreeRenderer::renderOperation(OctreeElementPointer element, void* extraData) {
     RenderArgs* args = static_cast<RenderArgs*>(extraData);
     if (element->isInView(args->getViewFrustum())) {
@@ -224,6 +271,10 @@ void OctreeRenderer::render(RenderArgs* renderArgs) {
 }
 
 void OctreeRenderer::clear() {
+    {
+        std::lock_guard<std::mutex> lock(_stagedChangesMutex);
+        _stagedChanges.clear();
+    }
     if (_tree) {
         _tree->withWriteLock([&] {
             _tree->eraseAllOctreeElements();
@@ -12,6 +12,11 @@
 #ifndef hifi_OctreeRenderer_h
 #define hifi_OctreeRenderer_h
 
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <mutex>
+
 #include <glm/glm.hpp>
 #include <stdint.h>
 
@@ -45,6 +50,16 @@ public:
     /// process incoming data
     virtual void processDatagram(ReceivedMessage& message, SharedNodePointer sourceNode);
 
+    /// when staging, processDatagram only decompresses the incoming data, off the tree lock, and leaves it
+    /// to applyStagedChanges to read it into the tree
+    void setStagingData(bool stagingData) { _stagingData = stagingData; }
+    bool isStagingData() const { return _stagingData; }
+
+    /// reads the staged data into the tree under a single write lock, for about budgetUsecs. At least one change is
+    /// applied per call, and changes staged for longer than MAX_STAGED_CHANGE_AGE_USECS are applied past the budget
+    void applyStagedChanges(quint64 budgetUsecs);
+    size_t getNumStagedChanges() const;
+
     /// initialize and GPU/rendering related resources
     virtual void init();
 
@@ -73,6 +88,9 @@ public:
 protected:
     virtual OctreePointer createTree() = 0;
 
+    /// queues a change to apply with the tree write lock held, in order with the staged data
+    void stageChange(std::function<void()> change);
+
     OctreePointer _tree;
     bool _managedTree;
     ViewFrustum _viewFrustum;
@@ -90,9 +108,21 @@ protected:
 
     quint64 _lastWindowAt = 0;
     int _packetsInLastWindow = 0;
-    int _elementsInLastWindow = 0;
-    int _entitiesInLastWindow = 0;
+    std::atomic<int> _elementsInLastWindow { 0 };
+    std::atomic<int> _entitiesInLastWindow { 0 };
+
+private:
+    struct StagedChange {
+        std::function<void()> apply;
+        quint64 stagedAt;
+    };
+
+    void readSectionsToTree(const std::vector<QByteArray>& sections, const QUuid& sourceUUID,
+                            const SharedNodePointer& sourceNode, PacketVersion version);
 
+    bool _stagingData { false };
+    mutable std::mutex _stagedChangesMutex;
+    std::deque<StagedChange> _stagedChanges;
 };
 
 #endif // hifi_OctreeRenderer_h
@@ -12,6 +12,7 @@
 #include "CollisionRenderMeshCache.h"
 
 #include <cassert>
+#include <cmath>
 
 #include <btBulletDynamicsCommon.h>
 #include <BulletCollision/CollisionShapes/btShapeHull.h>
@@ -22,10 +23,28 @@ const int32_t MAX_HULL_INDICES = 6 * MAX_HULL_POINTS;
 const int32_t MAX_HULL_NORMALS = MAX_HULL_INDICES;
 float tempVertices[MAX_HULL_NORMALS];
 model::Index tempIndexBuffer[MAX_HULL_INDICES];
+uint32_t tempColors[MAX_HULL_POINTS];
+
+// a bright color per hull, the golden ratio strides through the hues so that neighboring hulls stand apart
+uint32_t colorForHull(int32_t hullIndex) {
+    const float GOLDEN_RATIO_CONJUGATE = 0.618034f;
+    float hue = 6.0f * fmodf((float)hullIndex * GOLDEN_RATIO_CONJUGATE, 1.0f);
+    float x = 1.0f - fabsf(fmodf(hue, 2.0f) - 1.0f);
+    float red = 0.0f, green = 0.0f, blue = 0.0f;
+    switch ((int)hue) {
+        case 0: red = 1.0f; green = x; break;
+        case 1: red = x; green = 1.0f; break;
+        case 2: green = 1.0f; blue = x; break;
+        case 3: green = x; blue = 1.0f; break;
+        case 4: red = x; blue = 1.0f; break;
+        default: red = 1.0f; blue = x; break;
+    }
+    // RGBA bytes, as read by gpu::Element(gpu::VEC4, gpu::NUINT8, gpu::RGBA)
+    return (uint32_t)(red * 255.0f) | ((uint32_t)(green * 255.0f) << 8) | ((uint32_t)(blue * 255.0f) << 16) | (0xffu << 24);
+}
 
-bool copyShapeToMesh(const btTransform& transform, const btConvexShape* shape,
-        gpu::BufferView& vertices, gpu::BufferView& indices, gpu::BufferView& parts,
-        gpu::BufferView& normals) {
+bool copyShapeToMesh(const btTransform& transform, const btConvexShape* shape, int32_t hullIndex,
+        gpu::BufferView& vertices, gpu::BufferView& indices, gpu::BufferView& normals, gpu::BufferView& colors) {
     assert(shape);
 
     btShapeHull hull(shape);
@@ -39,20 +58,6 @@ bool copyShapeToMesh(const btTransform& transform, const btConvexShape* shape,
     int32_t numHullVertices = hull.numVertices();
     assert(numHullVertices <= MAX_HULL_POINTS);
 
-    { // new part
-        model::Mesh::Part part;
-        part._startIndex = (model::Index)indices.getNumElements();
-        part._numIndices = (model::Index)numHullIndices;
-        // FIXME: the render code cannot handle the case where part._baseVertex != 0
-        //part._baseVertex = vertices.getNumElements(); // DOES NOT WORK
-        part._baseVertex = 0;
-
-        gpu::BufferView::Size numBytes = sizeof(model::Mesh::Part);
-        const gpu::Byte* data = reinterpret_cast<const gpu::Byte*>(&part);
-        parts._buffer->append(numBytes, data);
-        parts._size = parts._buffer->getSize();
-    }
-
     const int32_t SIZE_OF_VEC3 = 3 * sizeof(float);
     model::Index indexOffset = (model::Index)vertices.getNumElements();
 
@@ -100,7 +105,16 @@ bool copyShapeToMesh(const btTransform& transform, const btConvexShape* shape,
         gpu::BufferView::Size numBytes = sizeof(float) * (3 * numHullVertices);
         const gpu::Byte* data = reinterpret_cast<const gpu::Byte*>(tempVertices);
         normals._buffer->append(numBytes, data);
-        normals._size = vertices._buffer->getSize();
+        normals._size = normals._buffer->getSize();
+    }
+    { // new colors, one per hull rather than one part and material each, so the whole shape draws at once
+        uint32_t hullColor = colorForHull(hullIndex);
+        for (int32_t i = 0; i < numHullVertices; ++i) {
+            tempColors[i] = hullColor;
+        }
+        gpu::BufferView::Size numBytes = sizeof(uint32_t) * numHullVertices;
+        colors._buffer->append(numBytes, reinterpret_cast<const gpu::Byte*>(tempColors));
+        colors._size = colors._buffer->getSize();
     }
     return true;
 }
@@ -123,6 +137,7 @@ model::MeshPointer createMeshFromShape(const void* pointer) {
         gpu::BufferView indices(new gpu::Buffer(), gpu::Element(gpu::SCALAR, gpu::UINT32, gpu::INDEX));
         gpu::BufferView parts(new gpu::Buffer(), gpu::Element(gpu::VEC4, gpu::UINT32, gpu::PART));
         gpu::BufferView normals(new gpu::Buffer(), gpu::Element(gpu::VEC3, gpu::FLOAT, gpu::XYZ));
+        gpu::BufferView colors(new gpu::Buffer(), gpu::Element(gpu::VEC4, gpu::NUINT8, gpu::RGBA));
 
         int32_t numSuccesses = 0;
         if (shapeType == (int32_t)COMPOUND_SHAPE_PROXYTYPE) {
@@ -132,7 +147,8 @@ model::MeshPointer createMeshFromShape(const void* pointer) {
                 const btCollisionShape* childShape = compoundShape->getChildShape(i);
                 if (childShape->isConvex()) {
                     const btConvexShape* convexShape = static_cast<const btConvexShape*>(childShape);
-                    if (copyShapeToMesh(compoundShape->getChildTransform(i), convexShape, vertices, indices, parts, normals)) {
+                    if (copyShapeToMesh(compoundShape->getChildTransform(i), convexShape, numSuccesses,
+                            vertices, indices, normals, colors)) {
                         numSuccesses++;
                     }
                 }
@@ -142,16 +158,26 @@ model::MeshPointer createMeshFromShape(const void* pointer) {
             const btConvexShape* convexShape = static_cast<const btConvexShape*>(shape);
             btTransform transform;
             transform.setIdentity();
-            if (copyShapeToMesh(transform, convexShape, vertices, indices, parts, normals)) {
+            if (copyShapeToMesh(transform, convexShape, numSuccesses, vertices, indices, normals, colors)) {
                 numSuccesses++;
             }
         }
         if (numSuccesses > 0) {
+            // all the hulls in one part
+            model::Mesh::Part part;
+            part._startIndex = 0;
+            part._numIndices = (model::Index)indices.getNumElements();
+            // FIXME: the render code cannot handle the case where part._baseVertex != 0
+            part._baseVertex = 0;
+            parts._buffer->append(sizeof(model::Mesh::Part), reinterpret_cast<const gpu::Byte*>(&part));
+            parts._size = parts._buffer->getSize();
+
             mesh = std::make_shared<model::Mesh>();
             mesh->setVertexBuffer(vertices);
             mesh->setIndexBuffer(indices);
             mesh->setPartBuffer(parts);
             mesh->addAttribute(gpu::Stream::NORMAL, normals);
+            mesh->addAttribute(gpu::Stream::COLOR, colors);
         } else {
             // TODO: log failure message here
         }
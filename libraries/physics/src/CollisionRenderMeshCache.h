@@ -19,6 +19,9 @@
 #include <model/Geometry.h>
 
 
+// The render meshes of the collision shapes, for the collision debug rendering. The ShapeManager shares a shape between
+// all the instances with the same ShapeInfo, so keyed by shape the meshes are shared the same way.
+// All the hulls of a shape are in one mesh part, colored per hull through a vertex color, so an instance draws at once.
 class CollisionRenderMeshCache {
 public:
 	using Key = const void*; // must actually be a const btCollisionShape*
@@ -37,7 +40,7 @@ public:
 
     // validation methods
     uint32_t getNumMeshes() const { return (uint32_t)_meshMap.size(); }
-    bool hasMesh(Key key) const { return _meshMap.find(key) == _meshMap.end(); }
+    bool hasMesh(Key key) const { return _meshMap.find(key) != _meshMap.end(); }
 
 private:
     using CollisionMeshMap = std::unordered_map<Key, model::MeshPointer>;
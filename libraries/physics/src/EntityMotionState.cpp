@@ -300,6 +300,7 @@ bool EntityMotionState::isCandidateForOwnership() const {
 bool EntityMotionState::remoteSimulationOutOfSync(uint32_t simulationStep) {
     // NOTE: we only get here if we think we own the simulation
     assert(_body);
+    _outOfSyncError = 0.0f;
 
     bool parentTransformSuccess;
     Transform localToWorld = _entity->getParentTransform(parentTransformSuccess);
@@ -402,6 +403,7 @@ bool EntityMotionState::remoteSimulationOutOfSync(uint32_t simulationStep) {
         const float MIN_ERROR_RATIO_SQUARED = 0.0025f; // corresponds to 5% error in 1 second
         const float MIN_SPEED_SQUARED = 1.0e-6f; // corresponds to 1mm/sec
         if (speed2 < MIN_SPEED_SQUARED || dx2 / speed2 > MIN_ERROR_RATIO_SQUARED) {
+            _outOfSyncError = sqrtf(dx2 / MAX_POSITION_ERROR_SQUARED);
             #ifdef WANT_DEBUG
                 qCDebug(physics) << ".... (dx2 > MAX_POSITION_ERROR_SQUARED) ....";
                 qCDebug(physics) << "wasPosition:" << wasPosition;
@@ -444,7 +446,12 @@ bool EntityMotionState::remoteSimulationOutOfSync(uint32_t simulationStep) {
         }
     #endif
 
-    return (fabsf(glm::dot(actualRotation, _serverRotation)) < MIN_ROTATION_DOT);
+    float rotationDot = fabsf(glm::dot(actualRotation, _serverRotation));
+    if (rotationDot < MIN_ROTATION_DOT) {
+        _outOfSyncError = (1.0f - rotationDot) / (1.0f - MIN_ROTATION_DOT);
+        return true;
+    }
+    return false;
 }
 
 bool EntityMotionState::shouldSendUpdate(uint32_t simulationStep) {
@@ -464,6 +471,7 @@ bool EntityMotionState::shouldSendUpdate(uint32_t simulationStep) {
     }
 
     if (_entity->queryAABoxNeedsUpdate()) {
+        _outOfSyncError = 1.0f;
         return true;
     }
 
@@ -487,9 +495,15 @@ bool EntityMotionState::shouldSendUpdate(uint32_t simulationStep) {
     return remoteSimulationOutOfSync(simulationStep);
 }
 
+bool EntityMotionState::isUrgentUpdate() const {
+    return !_body->isActive() || _numInactiveUpdates > 0 || _entity->actionDataNeedsTransmit() ||
+        _entity->getSimulatorID() != Physics::getSessionUUID() || _outgoingPriority != _entity->getSimulationPriority();
+}
+
 void EntityMotionState::sendUpdate(OctreeEditPacketSender* packetSender, uint32_t step) {
     assert(_entity);
     assert(entityTreeIsLocked());
+    _numHeldBackUpdates = 0;
 
     if (!_body->isActive()) {
         // make sure all derivatives are zero
@@ -48,6 +48,13 @@ public:
     bool shouldSendUpdate(uint32_t simulationStep);
     void sendUpdate(OctreeEditPacketSender* packetSender, uint32_t step);
 
+    // how far past the thresholds of remoteSimulationOutOfSync() the last check found the body, 1.0 at a threshold
+    float getOutOfSyncError() const { return _outOfSyncError; }
+
+    // whether the update shouldSendUpdate() asked for can't be put off: it stops the body, bids for or changes
+    // the ownership of the simulation, or carries action data
+    bool isUrgentUpdate() const;
+
     virtual uint32_t getIncomingDirtyFlags() override;
     virtual void clearIncomingDirtyFlags() override;
 
@@ -123,6 +130,9 @@ protected:
     mutable uint8_t _accelerationNearlyGravityCount;
     uint8_t _numInactiveUpdates { 1 };
     uint8_t _outgoingPriority { 0 };
+
+    float _outOfSyncError { 0.0f };
+    uint8_t _numHeldBackUpdates { 0 }; // updates put off by the budget of PhysicalEntitySimulation since the last sent
 };
 
 #endif // hifi_EntityMotionState_h
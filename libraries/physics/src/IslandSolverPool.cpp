@@ -0,0 +1,83 @@
+//
+//  IslandSolverPool.cpp
+//  libraries/physics/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "IslandSolverPool.h"
+
+IslandSolverPool::IslandSolverPool(int numThreads) {
+    for (int i = 0; i <= numThreads; i++) {
+        _solvers.push_back(std::unique_ptr<btSequentialImpulseConstraintSolver>(new btSequentialImpulseConstraintSolver()));
+    }
+    for (int i = 0; i < numThreads; i++) {
+        btConstraintSolver* solver = _solvers[i].get();
+        _threads.push_back(std::thread([this, solver] { run(solver); }));
+    }
+}
+
+IslandSolverPool::~IslandSolverPool() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _isStopping = true;
+    }
+    _workCondition.notify_all();
+    for (auto& thread : _threads) {
+        thread.join();
+    }
+}
+
+void IslandSolverPool::solveIslands(std::vector<Island>& islands, const btContactSolverInfo& solverInfo,
+                                    btDispatcher* dispatcher) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _islands = &islands;
+        _solverInfo = &solverInfo;
+        _dispatcher = dispatcher;
+        _nextIsland = 0;
+        _numBusyThreads = (int)_threads.size();
+        ++_generation;
+    }
+    _workCondition.notify_all();
+
+    solveNextIslands(_solvers.back().get());
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    _doneCondition.wait(lock, [this] { return _numBusyThreads == 0; });
+    _islands = nullptr;
+}
+
+void IslandSolverPool::run(btConstraintSolver* solver) {
+    int generation = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _workCondition.wait(lock, [&] { return _isStopping || _generation != generation; });
+            if (_isStopping) {
+                return;
+            }
+            generation = _generation;
+        }
+
+        solveNextIslands(solver);
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            --_numBusyThreads;
+        }
+        _doneCondition.notify_one();
+    }
+}
+
+void IslandSolverPool::solveNextIslands(btConstraintSolver* solver) {
+    int numIslands = (int)_islands->size();
+    for (int i = _nextIsland++; i < numIslands; i = _nextIsland++) {
+        Island& island = (*_islands)[i];
+        solver->solveGroup(island.bodies.data(), (int)island.bodies.size(), island.manifolds, island.numManifolds,
+                           island.constraints, island.numConstraints, *_solverInfo, nullptr, _dispatcher);
+    }
+}
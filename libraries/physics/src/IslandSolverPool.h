@@ -0,0 +1,68 @@
+//
+//  IslandSolverPool.h
+//  libraries/physics/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_IslandSolverPool_h
+#define hifi_IslandSolverPool_h
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <btBulletDynamicsCommon.h>
+
+// Solves the constraints of simulation islands on a few worker threads, each with its own solver.
+// Two islands never share a dynamic body, so they can be solved at the same time, but a kinematic body can be in
+// contact with several islands and the solver writes to it, so the islands touching one must be solved on one thread.
+class IslandSolverPool {
+public:
+    static const int MAX_NUM_THREADS = 3;
+
+    struct Island {
+        std::vector<btCollisionObject*> bodies;
+        btPersistentManifold** manifolds;
+        int numManifolds;
+        btTypedConstraint** constraints;
+        int numConstraints;
+    };
+
+    IslandSolverPool(int numThreads);
+    ~IslandSolverPool();
+
+    int getNumThreads() const { return (int)_threads.size(); }
+
+    // solves all of the islands before it returns, the calling thread takes part
+    void solveIslands(std::vector<Island>& islands, const btContactSolverInfo& solverInfo, btDispatcher* dispatcher);
+
+private:
+    void run(btConstraintSolver* solver);
+    void solveNextIslands(btConstraintSolver* solver);
+
+    std::vector<std::thread> _threads;
+    std::vector<std::unique_ptr<btSequentialImpulseConstraintSolver>> _solvers; // one per thread, and one for the caller
+
+    std::mutex _mutex;
+    std::condition_variable _workCondition;
+    std::condition_variable _doneCondition;
+    int _generation { 0 };
+    int _numBusyThreads { 0 };
+    bool _isStopping { false };
+
+    std::vector<Island>* _islands { nullptr };
+    const btContactSolverInfo* _solverInfo { nullptr };
+    btDispatcher* _dispatcher { nullptr };
+    std::atomic<int> _nextIsland { 0 };
+};
+
+#endif // hifi_IslandSolverPool_h
@@ -11,6 +11,10 @@
 
 
 
+#include <algorithm>
+
+#include <SharedUtil.h>
+
 #include "PhysicsHelpers.h"
 #include "PhysicsLogging.h"
 #include "ShapeManager.h"
@@ -286,20 +290,83 @@ void PhysicalEntitySimulation::handleOutgoingChanges(const VectorOfMotionStates&
             return;
         }
 
-        // look for entities to prune or update
-        QSet<EntityMotionState*>::iterator stateItr = _outgoingChanges.begin();
-        while (stateItr != _outgoingChanges.end()) {
-            EntityMotionState* state = *stateItr;
-            if (!state->isCandidateForOwnership()) {
-                // prune
-                stateItr = _outgoingChanges.erase(stateItr);
-            } else if (state->shouldSendUpdate(numSubsteps)) {
-                // update
+        sendOutgoingUpdates(numSubsteps);
+    }
+}
+
+// a rough size of the edit message of one update, the budget only has to be right on average
+static const float ESTIMATED_UPDATE_BYTES = 120.0f;
+// the budget never saves up more than this much time, so that an idle period can't be followed by a flood
+static const float MAX_BUDGET_SECONDS = 0.25f;
+// the weight given to the simulation priority of an entity, and to each step its update has been put off
+static const float PRIORITY_SCORE_SCALE = 1.0f / 64.0f;
+static const uint8_t MAX_HELD_BACK_UPDATES = 255;
+
+void PhysicalEntitySimulation::sendOutgoingUpdates(uint32_t numSubsteps) {
+    quint64 now = usecTimestampNow();
+    if (_lastBudgetRefill > 0) {
+        float maxBudget = MAX_BUDGET_SECONDS * (float)_outgoingBytesPerSecond;
+        float seconds = (float)(now - _lastBudgetRefill) / (float)USECS_PER_SECOND;
+        _outgoingBytesBudget = glm::min(_outgoingBytesBudget + seconds * (float)_outgoingBytesPerSecond, maxBudget);
+    }
+    _lastBudgetRefill = now;
+
+    // look for entities to prune or update
+    _deferrableUpdates.clear();
+    QSet<EntityMotionState*>::iterator stateItr = _outgoingChanges.begin();
+    while (stateItr != _outgoingChanges.end()) {
+        EntityMotionState* state = *stateItr;
+        if (!state->isCandidateForOwnership()) {
+            // prune
+            stateItr = _outgoingChanges.erase(stateItr);
+        } else if (state->shouldSendUpdate(numSubsteps)) {
+            // changes of ownership and bodies coming to rest are always sent, the others compete for the budget
+            if (state->isUrgentUpdate()) {
                 state->sendUpdate(_entityPacketSender, numSubsteps);
-                ++stateItr;
+                _outgoingBytesBudget -= ESTIMATED_UPDATE_BYTES;
             } else {
-                ++stateItr;
+                _deferrableUpdates.push_back(state);
             }
+            ++stateItr;
+        } else {
+            ++stateItr;
+        }
+    }
+
+    if (_deferrableUpdates.empty()) {
+        return;
+    }
+
+    size_t numAffordable = _outgoingBytesBudget > 0.0f ? (size_t)(_outgoingBytesBudget / ESTIMATED_UPDATE_BYTES) + 1 : 0;
+    if (numAffordable < _deferrableUpdates.size()) {
+        // the largest errors of the nearest, highest priority bodies go first, and those put off gain on the others
+        auto score = [&](EntityMotionState* state) {
+            float distance = glm::distance(state->getEntity()->getPosition(), _viewPosition);
+            return state->getOutOfSyncError() * (1.0f + PRIORITY_SCORE_SCALE * (float)state->_outgoingPriority) *
+                (1.0f + (float)state->_numHeldBackUpdates) / (1.0f + distance);
+        };
+        std::vector<std::pair<float, EntityMotionState*>> scored;
+        scored.reserve(_deferrableUpdates.size());
+        for (auto state : _deferrableUpdates) {
+            scored.push_back({ score(state), state });
+        }
+        std::sort(scored.begin(), scored.end(), [](const std::pair<float, EntityMotionState*>& a,
+                                                   const std::pair<float, EntityMotionState*>& b) {
+            return a.first > b.first;
+        });
+        for (size_t i = 0; i < scored.size(); i++) {
+            _deferrableUpdates[i] = scored[i].second;
+        }
+    }
+
+    for (size_t i = 0; i < _deferrableUpdates.size(); i++) {
+        EntityMotionState* state = _deferrableUpdates[i];
+        if (i < numAffordable) {
+            state->sendUpdate(_entityPacketSender, numSubsteps);
+            _outgoingBytesBudget -= ESTIMATED_UPDATE_BYTES;
+        } else if (state->_numHeldBackUpdates < MAX_HELD_BACK_UPDATES) {
+            // the state stays in _outgoingChanges so shouldSendUpdate() is asked again next step
+            state->_numHeldBackUpdates++;
         }
     }
 }
@@ -29,6 +29,8 @@ using SetOfEntityMotionStates = QSet<EntityMotionState*>;
 
 class PhysicalEntitySimulation :public EntitySimulation {
 public:
+    static const int DEFAULT_OUTGOING_BYTES_PER_SECOND = 64 * 1024;
+
     PhysicalEntitySimulation();
     ~PhysicalEntitySimulation();
 
@@ -61,7 +63,12 @@ public:
 
     EntityEditPacketSender* getPacketSender() { return _entityPacketSender; }
 
+    // the updates of the bodies nearest this position are the first sent when they have to be put off
+    void setViewPosition(const glm::vec3& position) { _viewPosition = position; }
+
 private:
+    void sendOutgoingUpdates(uint32_t numSubsteps);
+
     SetOfEntities _entitiesToRemoveFromPhysics;
     SetOfEntities _entitiesToRelease;
     SetOfEntities _entitiesToAddToPhysics;
@@ -75,6 +82,13 @@ private:
     EntityEditPacketSender* _entityPacketSender = nullptr;
 
     uint32_t _lastStepSendPackets { 0 };
+
+    // the outgoing updates that can be put off are sent within a budget of bytes, refilled at _outgoingBytesPerSecond
+    std::vector<EntityMotionState*> _deferrableUpdates;
+    glm::vec3 _viewPosition;
+    int _outgoingBytesPerSecond { DEFAULT_OUTGOING_BYTES_PER_SECOND };
+    float _outgoingBytesBudget { 0.0f };
+    quint64 _lastBudgetRefill { 0 };
 };
 
 
@@ -12,7 +12,9 @@
 #include <PhysicsCollisionGroups.h>
 
 #include <PerfStat.h>
+#include <SharedUtil.h>
 
+#include "BulletUtil.h"
 #include "CharacterController.h"
 #include "ObjectMotionState.h"
 #include "PhysicsEngine.h"
@@ -235,6 +237,44 @@ void PhysicsEngine::removeContacts(ObjectMotionState* motionState) {
     }
 }
 
+void PhysicsEngine::updatePhysicsLOD() {
+    quint64 now = usecTimestampNow();
+    if (now - _lastLODUpdate < PHYSICS_LOD_UPDATE_PERIOD) {
+        return;
+    }
+    _lastLODUpdate = now;
+    BT_PROFILE("updatePhysicsLOD");
+
+    // distant bodies are left in the world, so they still collide with what comes near them, but Bullet skips
+    // integrating them and solving their contacts while they are DISABLE_SIMULATION
+    const float FREEZE_RADIUS_SQUARED = PHYSICS_LOD_FREEZE_RADIUS * PHYSICS_LOD_FREEZE_RADIUS;
+    const float THAW_RADIUS_SQUARED = PHYSICS_LOD_THAW_RADIUS * PHYSICS_LOD_THAW_RADIUS;
+    btVector3 center = glmToBullet(_lodCenter - _originOffset);
+    btCollisionObjectArray& objects = _dynamicsWorld->getCollisionObjectArray();
+    for (int i = 0; i < objects.size(); i++) {
+        btRigidBody* body = btRigidBody::upcast(objects[i]);
+        if (!body || body->isStaticOrKinematicObject()) {
+            continue;
+        }
+        ObjectMotionState* motionState = static_cast<ObjectMotionState*>(body->getUserPointer());
+        if (!motionState || motionState->getType() != MOTIONSTATE_TYPE_ENTITY) {
+            continue;
+        }
+
+        float distanceSquared = (body->getWorldTransform().getOrigin() - center).length2();
+        if (body->getActivationState() == DISABLE_SIMULATION) {
+            if (distanceSquared < THAW_RADIUS_SQUARED) {
+                body->forceActivationState(ACTIVE_TAG);
+                body->setDeactivationTime(0.0f);
+            }
+        } else if (distanceSquared > FREEZE_RADIUS_SQUARED &&
+                   motionState->getSimulatorID() != Physics::getSessionUUID()) {
+            // the bodies we simulate keep going however far they are, the other observers rely on our updates
+            body->forceActivationState(DISABLE_SIMULATION);
+        }
+    }
+}
+
 void PhysicsEngine::stepSimulation() {
     CProfileManager::Reset();
     BT_PROFILE("stepSimulation");
@@ -244,10 +284,15 @@ void PhysicsEngine::stepSimulation() {
     // (3) synchronize outgoing motion states
     // (4) send outgoing packets
 
-    const float MAX_TIMESTEP = (float)PHYSICS_ENGINE_MAX_NUM_SUBSTEPS * PHYSICS_ENGINE_FIXED_SUBSTEP;
+    int maxSubsteps = PHYSICS_ENGINE_MAX_NUM_SUBSTEPS;
+    if (_averageSubstepUsecs > 0.0f) {
+        int budgetedSubsteps = (int)((float)PHYSICS_ENGINE_STEP_BUDGET_USECS / _averageSubstepUsecs);
+        maxSubsteps = glm::clamp(budgetedSubsteps, PHYSICS_ENGINE_MIN_NUM_BUDGETED_SUBSTEPS, PHYSICS_ENGINE_MAX_NUM_SUBSTEPS);
+    }
+    const float maxTimeStep = (float)maxSubsteps * PHYSICS_ENGINE_FIXED_SUBSTEP;
     float dt = 1.0e-6f * (float)(_clock.getTimeMicroseconds());
     _clock.reset();
-    float timeStep = btMin(dt, MAX_TIMESTEP);
+    float timeStep = btMin(dt, maxTimeStep);
 
     if (_myAvatarController) {
         BT_PROFILE("avatarController");
@@ -269,13 +314,21 @@ void PhysicsEngine::stepSimulation() {
         _myAvatarController->preSimulation();
     }
 
+    updatePhysicsLOD();
+
     auto onSubStep = [this]() {
         updateContactMap();
     };
 
-    int numSubsteps = _dynamicsWorld->stepSimulationWithSubstepCallback(timeStep, PHYSICS_ENGINE_MAX_NUM_SUBSTEPS,
+    quint64 stepStart = usecTimestampNow();
+    int numSubsteps = _dynamicsWorld->stepSimulationWithSubstepCallback(timeStep, maxSubsteps,
                                                                         PHYSICS_ENGINE_FIXED_SUBSTEP, onSubStep);
     if (numSubsteps > 0) {
+        const float SUBSTEP_COST_TIMESCALE = 0.1f;
+        float substepUsecs = (float)(usecTimestampNow() - stepStart) / (float)numSubsteps;
+        _averageSubstepUsecs = (_averageSubstepUsecs > 0.0f) ?
+            glm::mix(_averageSubstepUsecs, substepUsecs, SUBSTEP_COST_TIMESCALE) : substepUsecs;
+
         BT_PROFILE("postSimulation");
         _numSubsteps += (uint32_t)numSubsteps;
         ObjectMotionState::setWorldSimulationStep(_numSubsteps);
@@ -81,6 +81,9 @@ public:
 
     void setCharacterController(CharacterController* character);
 
+    /// \param position in domain-frame around which dynamic bodies are simulated, see PHYSICS_LOD_FREEZE_RADIUS
+    void setLODCenter(const glm::vec3& position) { _lodCenter = position; }
+
     void dumpNextStats() { _dumpNextStats = true; }
 
     EntityActionPointer getActionByID(const QUuid& actionID) const;
@@ -99,6 +102,8 @@ private:
 
     void doOwnershipInfection(const btCollisionObject* objectA, const btCollisionObject* objectB);
 
+    void updatePhysicsLOD();
+
     btClock _clock;
     btDefaultCollisionConfiguration* _collisionConfig = NULL;
     btCollisionDispatcher* _collisionDispatcher = NULL;
@@ -113,11 +118,14 @@ private:
     std::vector<btRigidBody*> _activeStaticBodies;
 
     glm::vec3 _originOffset;
+    glm::vec3 _lodCenter;
+    quint64 _lastLODUpdate { 0 };
 
     CharacterController* _myAvatarController;
 
     uint32_t _numContactFrames = 0;
     uint32_t _numSubsteps;
+    float _averageSubstepUsecs { 0.0f };
 
     bool _dumpNextStats = false;
     bool _hasOutgoingChanges = false;
@@ -0,0 +1,193 @@
+//
+//  ShapeDiskCache.cpp
+//  libraries/physics/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ShapeDiskCache.h"
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDataStream>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QRunnable>
+#include <QtCore/QSaveFile>
+#include <QtCore/QThreadPool>
+
+#include "PhysicsLogging.h"
+
+// bump this when the serialized shape, or the way the ShapeFactory builds hulls, changes
+static const quint32 SHAPE_CACHE_VERSION = 1;
+static const QString SHAPE_FILE_EXTENSION = ".shape";
+
+// the directory is only trimmed back to MAX_NUM_FILES every so many saves
+static const int SAVES_PER_TRIM = 64;
+
+static void writeHull(QDataStream& stream, const btConvexHullShape* hull) {
+    stream << (float)hull->getMargin() << (qint32)hull->getNumPoints();
+    const btVector3* points = hull->getUnscaledPoints();
+    for (int i = 0; i < hull->getNumPoints(); i++) {
+        stream << (float)points[i].getX() << (float)points[i].getY() << (float)points[i].getZ();
+    }
+}
+
+static btConvexHullShape* readHull(QDataStream& stream) {
+    float margin;
+    qint32 numPoints;
+    stream >> margin >> numPoints;
+    if (stream.status() != QDataStream::Ok || numPoints <= 0 || numPoints > MAX_HULL_POINTS) {
+        return nullptr;
+    }
+
+    btConvexHullShape* hull = new btConvexHullShape();
+    hull->setMargin(margin);
+    for (int i = 0; i < numPoints; i++) {
+        float x, y, z;
+        stream >> x >> y >> z;
+        hull->addPoint(btVector3(x, y, z), false);
+    }
+    if (stream.status() != QDataStream::Ok) {
+        delete hull;
+        return nullptr;
+    }
+    hull->recalcLocalAabb();
+    return hull;
+}
+
+class ShapeFileWriter : public QRunnable {
+public:
+    ShapeFileWriter(const QString& directory, const QString& filePath, const QByteArray& data, bool shouldTrim) :
+        _directory(directory), _filePath(filePath), _data(data), _shouldTrim(shouldTrim) { }
+
+    virtual void run() override {
+        QDir().mkpath(_directory);
+
+        QSaveFile file(_filePath);
+        if (!file.open(QIODevice::WriteOnly) || file.write(_data) != _data.size() || !file.commit()) {
+            qCDebug(physics) << "ShapeDiskCache could not write" << _filePath;
+            return;
+        }
+
+        if (_shouldTrim) {
+            QDir directory(_directory);
+            QFileInfoList files = directory.entryInfoList(QStringList("*" + SHAPE_FILE_EXTENSION), QDir::Files, QDir::Time);
+            for (int i = ShapeDiskCache::MAX_NUM_FILES; i < files.size(); i++) {
+                QFile::remove(files[i].absoluteFilePath());
+            }
+        }
+    }
+
+private:
+    QString _directory;
+    QString _filePath;
+    QByteArray _data;
+    bool _shouldTrim;
+};
+
+ShapeDiskCache::ShapeDiskCache(const QString& directory) :
+    _directory(directory)
+{
+
+}
+
+bool ShapeDiskCache::canCache(const ShapeInfo& info) {
+    int type = info.getType();
+    return type == SHAPE_TYPE_COMPOUND || type == SHAPE_TYPE_SIMPLE_HULL || type == SHAPE_TYPE_SIMPLE_COMPOUND;
+}
+
+QByteArray ShapeDiskCache::computeKey(const ShapeInfo& info) {
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    quint32 header[] = { SHAPE_CACHE_VERSION, (quint32)info.getType() };
+    hash.addData(reinterpret_cast<const char*>(header), sizeof(header));
+    hash.addData(reinterpret_cast<const char*>(&info.getHalfExtents()), sizeof(glm::vec3));
+    hash.addData(reinterpret_cast<const char*>(&info.getOffset()), sizeof(glm::vec3));
+    for (const auto& points : info.getPointCollection()) {
+        qint32 numPoints = points.size();
+        hash.addData(reinterpret_cast<const char*>(&numPoints), sizeof(numPoints));
+        hash.addData(reinterpret_cast<const char*>(points.constData()), numPoints * sizeof(glm::vec3));
+    }
+    const ShapeInfo::TriangleIndices& indices = info.getTriangleIndices();
+    hash.addData(reinterpret_cast<const char*>(indices.constData()), indices.size() * sizeof(int32_t));
+    return hash.result().toHex();
+}
+
+QString ShapeDiskCache::getFilePath(const QByteArray& key) const {
+    return _directory + "/" + QString::fromLatin1(key) + SHAPE_FILE_EXTENSION;
+}
+
+btCollisionShape* ShapeDiskCache::load(const QByteArray& key) const {
+    QFile file(getFilePath(key));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return nullptr;
+    }
+
+    QDataStream stream(&file);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+    quint32 version;
+    qint32 numChildren;
+    stream >> version >> numChildren;
+    if (stream.status() != QDataStream::Ok || version != SHAPE_CACHE_VERSION) {
+        return nullptr;
+    }
+
+    if (numChildren == 0) {
+        return readHull(stream);
+    }
+
+    btCompoundShape* compound = new btCompoundShape();
+    for (int i = 0; i < numChildren; i++) {
+        float x, y, z, rotationX, rotationY, rotationZ, rotationW;
+        stream >> x >> y >> z >> rotationX >> rotationY >> rotationZ >> rotationW;
+        btConvexHullShape* hull = readHull(stream);
+        if (!hull) {
+            // a truncated or corrupt file, the shape will be built again and saved over it
+            qCDebug(physics) << "ShapeDiskCache could not read" << file.fileName();
+            for (int j = 0; j < compound->getNumChildShapes(); j++) {
+                delete compound->getChildShape(j);
+            }
+            delete compound;
+            return nullptr;
+        }
+        btTransform transform(btQuaternion(rotationX, rotationY, rotationZ, rotationW), btVector3(x, y, z));
+        compound->addChildShape(transform, hull);
+    }
+    compound->recalculateLocalAabb();
+    return compound;
+}
+
+void ShapeDiskCache::save(const QByteArray& key, const btCollisionShape* shape) {
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    stream << SHAPE_CACHE_VERSION;
+
+    if (shape->getShapeType() == (int)CONVEX_HULL_SHAPE_PROXYTYPE) {
+        stream << (qint32)0;
+        writeHull(stream, static_cast<const btConvexHullShape*>(shape));
+    } else if (shape->getShapeType() == (int)COMPOUND_SHAPE_PROXYTYPE) {
+        const btCompoundShape* compound = static_cast<const btCompoundShape*>(shape);
+        stream << (qint32)compound->getNumChildShapes();
+        for (int i = 0; i < compound->getNumChildShapes(); i++) {
+            const btCollisionShape* child = compound->getChildShape(i);
+            if (child->getShapeType() != (int)CONVEX_HULL_SHAPE_PROXYTYPE) {
+                return;
+            }
+            const btTransform& transform = compound->getChildTransform(i);
+            btQuaternion rotation = transform.getRotation();
+            stream << (float)transform.getOrigin().getX() << (float)transform.getOrigin().getY()
+                << (float)transform.getOrigin().getZ() << (float)rotation.getX() << (float)rotation.getY()
+                << (float)rotation.getZ() << (float)rotation.getW();
+            writeHull(stream, static_cast<const btConvexHullShape*>(child));
+        }
+    } else {
+        return;
+    }
+
+    bool shouldTrim = (++_numSaves % SAVES_PER_TRIM) == 0;
+    QThreadPool::globalInstance()->start(new ShapeFileWriter(_directory, getFilePath(key), data, shouldTrim));
+}
@@ -0,0 +1,49 @@
+//
+//  ShapeDiskCache.h
+//  libraries/physics/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_ShapeDiskCache_h
+#define hifi_ShapeDiskCache_h
+
+#include <QtCore/QByteArray>
+#include <QtCore/QString>
+
+#include <btBulletDynamicsCommon.h>
+
+#include <ShapeInfo.h>
+
+// Keeps the convex hulls built by the ShapeFactory on disk, so that the shape of a model seen in an earlier session is
+// read back rather than built again. The key is a hash of all of the data of the ShapeInfo, points included, because
+// the hash the ShapeManager uses only covers the url, type and extents and the model at a url can change.
+class ShapeDiskCache {
+public:
+    static const int MAX_NUM_FILES = 4096;
+
+    ShapeDiskCache(const QString& directory);
+
+    // only the shapes made of convex hulls are worth caching, the others are quick to build
+    static bool canCache(const ShapeInfo& info);
+    static QByteArray computeKey(const ShapeInfo& info);
+
+    // \return a new shape read from the cache, or nullptr if it has none for the key
+    btCollisionShape* load(const QByteArray& key) const;
+
+    // the shape is serialized before this returns and written on a background thread
+    void save(const QByteArray& key, const btCollisionShape* shape);
+
+private:
+    QString getFilePath(const QByteArray& key) const;
+
+    QString _directory;
+    int _numSaves { 0 };
+};
+
+#endif // hifi_ShapeDiskCache_h
@@ -28,6 +28,10 @@ ShapeManager::~ShapeManager() {
     _shapeMap.clear();
 }
 
+void ShapeManager::enableDiskCache(const QString& directory) {
+    _diskCache.reset(new ShapeDiskCache(directory));
+}
+
 const btCollisionShape* ShapeManager::getShape(const ShapeInfo& info) {
     if (info.getType() == SHAPE_TYPE_NONE) {
         return nullptr;
@@ -45,7 +49,18 @@ const btCollisionShape* ShapeManager::getShape(const ShapeInfo& info) {
         shapeRef->refCount++;
         return shapeRef->shape;
     }
-    const btCollisionShape* shape = ShapeFactory::createShapeFromInfo(info);
+    const btCollisionShape* shape = nullptr;
+    QByteArray diskKey;
+    if (_diskCache && ShapeDiskCache::canCache(info)) {
+        diskKey = ShapeDiskCache::computeKey(info);
+        shape = _diskCache->load(diskKey);
+    }
+    if (!shape) {
+        shape = ShapeFactory::createShapeFromInfo(info);
+        if (shape && !diskKey.isEmpty()) {
+            _diskCache->save(diskKey, shape);
+        }
+    }
     if (shape) {
         ShapeReference newRef;
         newRef.refCount = 1;
@@ -12,12 +12,15 @@
 #ifndef hifi_ShapeManager_h
 #define hifi_ShapeManager_h
 
+#include <memory>
+
 #include <btBulletDynamicsCommon.h>
 #include <LinearMath/btHashMap.h>
 
 #include <ShapeInfo.h>
 
 #include "DoubleHashKey.h"
+#include "ShapeDiskCache.h"
 
 class ShapeManager {
 public:
@@ -25,6 +28,9 @@ public:
     ShapeManager();
     ~ShapeManager();
 
+    /// keep the hull shapes in the given directory, so that later sessions can read them back instead of building them
+    void enableDiskCache(const QString& directory);
+
     /// \return pointer to shape
     const btCollisionShape* getShape(const ShapeInfo& info);
 
@@ -53,6 +59,7 @@ private:
 
     btHashMap<DoubleHashKey, ShapeReference> _shapeMap;
     btAlignedObjectArray<DoubleHashKey> _pendingGarbage;
+    std::unique_ptr<ShapeDiskCache> _diskCache;
 };
 
 #endif // hifi_ShapeManager_h
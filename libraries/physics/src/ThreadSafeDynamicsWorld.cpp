@@ -15,16 +15,145 @@
  * Copied and modified from btDiscreteDynamicsWorld.cpp by AndrewMeadows on 2014.11.12.
  * */
 
+#include <algorithm>
+#include <iterator>
+
 #include <LinearMath/btQuickprof.h>
 
 #include "ThreadSafeDynamicsWorld.h"
 
+// Before 2.86 the Bullet profiler keeps the current node of its single tree in a global with no guard, and the solver
+// profiles itself, so running it on several threads would corrupt the profile of the whole step.
+#if BT_BULLET_VERSION >= 286
+static const bool CAN_SOLVE_ISLANDS_IN_PARALLEL = true;
+#else
+static const bool CAN_SOLVE_ISLANDS_IN_PARALLEL = false;
+#endif
+
+// below this many islands (that touch no kinematic body) waking up the workers costs more than it saves
+static const int MIN_NUM_PARALLEL_ISLANDS = 4;
+
+static int getConstraintIslandId(const btTypedConstraint* constraint) {
+    const btCollisionObject& bodyA = constraint->getRigidBodyA();
+    const btCollisionObject& bodyB = constraint->getRigidBodyB();
+    return (bodyA.getIslandTag() >= 0) ? bodyA.getIslandTag() : bodyB.getIslandTag();
+}
+
+// collects the islands instead of solving them, sorting out those that touch a kinematic body
+class CollectIslandsCallback : public btSimulationIslandManager::IslandCallback {
+public:
+    CollectIslandsCallback(std::vector<btTypedConstraint*>& sortedConstraints,
+                           std::vector<IslandSolverPool::Island>& parallelIslands,
+                           std::vector<IslandSolverPool::Island>& serialIslands) :
+        _sortedConstraints(sortedConstraints),
+        _parallelIslands(parallelIslands),
+        _serialIslands(serialIslands) { }
+
+    virtual void processIsland(btCollisionObject** bodies, int numBodies, btPersistentManifold** manifolds,
+                               int numManifolds, int islandId) override {
+        IslandSolverPool::Island island;
+        island.bodies.assign(bodies, bodies + numBodies); // the island manager reuses its array of bodies
+        island.manifolds = manifolds;
+        island.numManifolds = numManifolds;
+
+        auto range = std::equal_range(_sortedConstraints.begin(), _sortedConstraints.end(), islandId,
+            IslandIdLess());
+        island.constraints = (range.first != range.second) ? &(*range.first) : nullptr;
+        island.numConstraints = (int)(range.second - range.first);
+
+        bool touchesKinematic = (islandId < 0);
+        for (int i = 0; i < numManifolds && !touchesKinematic; i++) {
+            touchesKinematic = manifolds[i]->getBody0()->isKinematicObject() ||
+                               manifolds[i]->getBody1()->isKinematicObject();
+        }
+        for (int i = 0; i < island.numConstraints && !touchesKinematic; i++) {
+            touchesKinematic = island.constraints[i]->getRigidBodyA().isKinematicObject() ||
+                               island.constraints[i]->getRigidBodyB().isKinematicObject();
+        }
+
+        if (touchesKinematic) {
+            _serialIslands.push_back(std::move(island));
+        } else {
+            _parallelIslands.push_back(std::move(island));
+        }
+    }
+
+    struct IslandIdLess {
+        bool operator()(const btTypedConstraint* constraint, int islandId) const {
+            return getConstraintIslandId(constraint) < islandId;
+        }
+        bool operator()(int islandId, const btTypedConstraint* constraint) const {
+            return islandId < getConstraintIslandId(constraint);
+        }
+    };
+
+private:
+    std::vector<btTypedConstraint*>& _sortedConstraints;
+    std::vector<IslandSolverPool::Island>& _parallelIslands;
+    std::vector<IslandSolverPool::Island>& _serialIslands;
+};
+
 ThreadSafeDynamicsWorld::ThreadSafeDynamicsWorld(
         btDispatcher* dispatcher,
         btBroadphaseInterface* pairCache,
         btConstraintSolver* constraintSolver,
         btCollisionConfiguration* collisionConfiguration)
     :   btDiscreteDynamicsWorld(dispatcher, pairCache, constraintSolver, collisionConfiguration) {
+    // leave a core for the main and the render threads
+    int numThreads = std::min((int)std::thread::hardware_concurrency() - 2, IslandSolverPool::MAX_NUM_THREADS);
+    if (CAN_SOLVE_ISLANDS_IN_PARALLEL && numThreads > 0) {
+        _islandSolverPool.reset(new IslandSolverPool(numThreads));
+    }
+}
+
+ThreadSafeDynamicsWorld::~ThreadSafeDynamicsWorld() {
+}
+
+void ThreadSafeDynamicsWorld::solveConstraints(btContactSolverInfo& solverInfo) {
+    if (!_islandSolverPool || !m_islandManager->getSplitIslands()) {
+        btDiscreteDynamicsWorld::solveConstraints(solverInfo);
+        return;
+    }
+
+    BT_PROFILE("solveConstraints");
+    _islandConstraints.resize(m_constraints.size());
+    for (int i = 0; i < m_constraints.size(); i++) {
+        _islandConstraints[i] = m_constraints[i];
+    }
+    std::sort(_islandConstraints.begin(), _islandConstraints.end(),
+              [](const btTypedConstraint* a, const btTypedConstraint* b) {
+        return getConstraintIslandId(a) < getConstraintIslandId(b);
+    });
+
+    _parallelIslands.clear();
+    _serialIslands.clear();
+    m_constraintSolver->prepareSolve(getNumCollisionObjects(), getDispatcher()->getNumManifolds());
+    CollectIslandsCallback callback(_islandConstraints, _parallelIslands, _serialIslands);
+    m_islandManager->buildAndProcessIslands(getDispatcher(), this, &callback);
+
+    if ((int)_parallelIslands.size() < MIN_NUM_PARALLEL_ISLANDS) {
+        _serialIslands.insert(_serialIslands.end(), std::make_move_iterator(_parallelIslands.begin()),
+                              std::make_move_iterator(_parallelIslands.end()));
+        _parallelIslands.clear();
+    }
+
+    for (auto& island : _serialIslands) {
+        m_constraintSolver->solveGroup(island.bodies.data(), (int)island.bodies.size(), island.manifolds,
+                                       island.numManifolds, island.constraints, island.numConstraints,
+                                       solverInfo, m_debugDrawer, getDispatcher());
+    }
+
+    if (!_parallelIslands.empty()) {
+        BT_PROFILE("solveIslandsInParallel");
+        // the biggest islands first, so that a big one started last doesn't keep the others waiting
+        std::sort(_parallelIslands.begin(), _parallelIslands.end(),
+                  [](const IslandSolverPool::Island& a, const IslandSolverPool::Island& b) {
+            return a.numManifolds + a.numConstraints > b.numManifolds + b.numConstraints;
+        });
+        _islandSolverPool->solveIslands(_parallelIslands, solverInfo, getDispatcher());
+    }
+
+    m_constraintSolver->allSolved(solverInfo, m_debugDrawer);
 }
 
 int ThreadSafeDynamicsWorld::stepSimulationWithSubstepCallback(btScalar timeStep, int maxSubSteps,
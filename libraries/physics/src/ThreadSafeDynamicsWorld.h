@@ -21,9 +21,11 @@
 #include <BulletDynamics/Dynamics/btRigidBody.h>
 #include <BulletDynamics/Dynamics/btDiscreteDynamicsWorld.h>
 
+#include "IslandSolverPool.h"
 #include "ObjectMotionState.h"
 
 #include <functional>
+#include <memory>
 
 using SubStepCallback = std::function<void()>;
 
@@ -36,6 +38,7 @@ public:
             btBroadphaseInterface* pairCache,
             btConstraintSolver* constraintSolver,
             btCollisionConfiguration* collisionConfiguration);
+    virtual ~ThreadSafeDynamicsWorld();
 
     int stepSimulationWithSubstepCallback(btScalar timeStep, int maxSubSteps = 1,
                                           btScalar fixedTimeStep = btScalar(1.)/btScalar(60.),
@@ -50,11 +53,20 @@ public:
 
     const VectorOfMotionStates& getChangedMotionStates() const { return _changedMotionStates; }
 
+protected:
+    // solves the islands on the worker threads when there are enough of them, but still on the calling thread
+    virtual void solveConstraints(btContactSolverInfo& solverInfo) override;
+
 private:
     // call this instead of non-virtual btDiscreteDynamicsWorld::synchronizeSingleMotionState()
     void synchronizeMotionState(btRigidBody* body);
 
     VectorOfMotionStates _changedMotionStates;
+
+    std::unique_ptr<IslandSolverPool> _islandSolverPool; // null when the islands are solved on the calling thread only
+    std::vector<IslandSolverPool::Island> _parallelIslands;
+    std::vector<IslandSolverPool::Island> _serialIslands;
+    std::vector<btTypedConstraint*> _islandConstraints;
 };
 
 #endif // hifi_ThreadSafeDynamicsWorld_h
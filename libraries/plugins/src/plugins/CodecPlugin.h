@@ -10,12 +10,22 @@
 //
 #pragma once
 
+#include <algorithm>
+#include <cstring>
+
 #include "Plugin.h"
 
 class Encoder {
 public:
     virtual ~Encoder() { }
     virtual void encode(const QByteArray& decodedBuffer, QByteArray& encodedBuffer) = 0;
+
+    // true when the encoding of a buffer does not depend on what was encoded before it
+    virtual bool isStateless() const { return false; }
+
+    // called about once a second with the packet loss rate (0 to 1) the receiver sees on the encoded stream and the
+    // round trip time to it, codecs that can trade bitrate for robustness should adapt their encoding here
+    virtual void setNetworkConditions(float lossRate, int rttMsecs) { }
 };
 
 class Decoder {
@@ -23,8 +33,22 @@ public:
     virtual ~Decoder() { }
     virtual void decode(const QByteArray& encodedBuffer, QByteArray& decodedBuffer) = 0;
 
+    // decodes into memory owned by the caller, such as a slot of a ring buffer, returns the number of decoded samples
+    // codecs that can decode in place should override this, the default decodes through a QByteArray and copies
+    virtual int decodeInPlace(const QByteArray& encodedBuffer, int16_t* decodedSamples, int maxSamples) {
+        QByteArray decodedBuffer;
+        decode(encodedBuffer, decodedBuffer);
+        int numSamples = std::min(decodedBuffer.size() / (int)sizeof(int16_t), maxSamples);
+        memcpy(decodedSamples, decodedBuffer.constData(), numSamples * sizeof(int16_t));
+        return numSamples;
+    }
+
     // numFrames - number of samples (mono) or sample-pairs (stereo)
     virtual void trackLostFrames(int numFrames) = 0;
+
+    // fills in one network frame lost in transit from the state of the decoder, and advances that state past it,
+    // returns the number of samples written, or 0 when the codec can't conceal and the lost frame is repeated instead
+    virtual int concealLostFrame(int16_t* decodedSamples, int maxSamples) { return 0; }
 };
 
 class CodecPlugin : public Plugin {
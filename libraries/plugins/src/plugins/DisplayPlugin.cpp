@@ -1,7 +1,13 @@
 #include "DisplayPlugin.h"
 
+#include <QtGui/QImage>
+
 #include <NumericalConstants.h>
 
+void DisplayPlugin::requestScreenshot(float aspectRatio, const ScreenshotHandler& handler) {
+    handler(getScreenshot(aspectRatio));
+}
+
 int64_t DisplayPlugin::getPaintDelayUsecs() const {
     std::lock_guard<std::mutex> lock(_paintDelayMutex);
     return _paintDelayTimer.isValid() ? _paintDelayTimer.nsecsElapsed() / NSECS_PER_USEC : 0;
@@ -180,6 +180,10 @@ public:
     // Fetch the most recently displayed image as a QImage
     virtual QImage getScreenshot(float aspectRatio = 0.0f) const = 0;
 
+    // Fetch the next displayed image without waiting on the display for it, the handler may be called on any thread
+    using ScreenshotHandler = std::function<void(QImage)>;
+    virtual void requestScreenshot(float aspectRatio, const ScreenshotHandler& handler);
+
     // will query the underlying hmd api to compute the most recent head pose
     virtual bool beginFrameRender(uint32_t frameIndex) { return true; }
 
@@ -8,6 +8,9 @@
 
 #include "Procedural.h"
 
+#include <mutex>
+#include <unordered_map>
+
 #include <QtCore/QFile>
 #include <QtCore/QFileInfo>
 #include <QtCore/QJsonArray>
@@ -43,6 +46,44 @@ static const std::string STANDARD_UNIFORM_NAMES[Procedural::NUM_STANDARD_UNIFORM
     "iChannelResolution"
 };
 
+// The programs are shared by the procedurals with the same shader sources, so a shader used by many entities is only
+// compiled once. A program stays in here as long as a procedural uses it.
+static gpu::ShaderPointer getProgram(const std::string& vertexSource, const std::string& fragmentSource) {
+    static std::mutex programsMutex;
+    static std::unordered_map<std::string, std::weak_ptr<gpu::Shader>> programs;
+
+    std::string key = vertexSource;
+    key.push_back('\0');
+    key += fragmentSource;
+
+    std::lock_guard<std::mutex> lock(programsMutex);
+    auto& cachedProgram = programs[key];
+    gpu::ShaderPointer program = cachedProgram.lock();
+    if (!program) {
+        auto vertexShader = gpu::Shader::createVertex(vertexSource);
+        auto fragmentShader = gpu::Shader::createPixel(fragmentSource);
+        program = gpu::Shader::createProgram(vertexShader, fragmentShader);
+
+        gpu::Shader::BindingSet slotBindings;
+        slotBindings.insert(gpu::Shader::Binding(std::string("iChannel0"), 0));
+        slotBindings.insert(gpu::Shader::Binding(std::string("iChannel1"), 1));
+        slotBindings.insert(gpu::Shader::Binding(std::string("iChannel2"), 2));
+        slotBindings.insert(gpu::Shader::Binding(std::string("iChannel3"), 3));
+        gpu::Shader::makeProgram(*program, slotBindings);
+        cachedProgram = program;
+
+        // forget the programs no procedural uses anymore, such as the previous versions of an edited shader
+        for (auto it = programs.begin(); it != programs.end();) {
+            if (it->second.expired()) {
+                it = programs.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    return program;
+}
+
 // Example
 //{
 //    "ProceduralEntity": {
@@ -246,10 +287,6 @@ void Procedural::prepare(gpu::Batch& batch, const glm::vec3& position, const glm
     }
 
     if (!_opaquePipeline || !_transparentPipeline || _shaderDirty) {
-        if (!_vertexShader) {
-            _vertexShader = gpu::Shader::createVertex(_vertexSource);
-        }
-
         // Build the fragment shader
         std::string fragmentShaderSource = _fragmentSource;
         size_t replaceIndex = fragmentShaderSource.find(PROCEDURAL_COMMON_BLOCK);
@@ -273,15 +310,7 @@ void Procedural::prepare(gpu::Batch& batch, const glm::vec3& position, const glm
         // Leave this here for debugging
         // qDebug() << "FragmentShader:\n" << fragmentShaderSource.c_str();
 
-        _fragmentShader = gpu::Shader::createPixel(fragmentShaderSource);
-        _shader = gpu::Shader::createProgram(_vertexShader, _fragmentShader);
-
-        gpu::Shader::BindingSet slotBindings;
-        slotBindings.insert(gpu::Shader::Binding(std::string("iChannel0"), 0));
-        slotBindings.insert(gpu::Shader::Binding(std::string("iChannel1"), 1));
-        slotBindings.insert(gpu::Shader::Binding(std::string("iChannel2"), 2));
-        slotBindings.insert(gpu::Shader::Binding(std::string("iChannel3"), 3));
-        gpu::Shader::makeProgram(*_shader, slotBindings);
+        _shader = getProgram(_vertexSource, fragmentShaderSource);
 
         _opaquePipeline = gpu::Pipeline::create(_shader, _opaqueState);
         _transparentPipeline = gpu::Pipeline::create(_shader, _transparentState);
@@ -94,9 +94,7 @@ protected:
     NetworkTexturePointer _channels[MAX_PROCEDURAL_TEXTURE_CHANNELS];
     gpu::PipelinePointer _opaquePipeline;
     gpu::PipelinePointer _transparentPipeline;
-    gpu::ShaderPointer _vertexShader;
-    gpu::ShaderPointer _fragmentShader;
-    gpu::ShaderPointer _shader;
+    gpu::ShaderPointer _shader; // shared with the procedurals with the same shader sources
 
     // Entity metadata
     glm::vec3 _entityDimensions;
@@ -12,6 +12,7 @@
 
 #include "impl/FileClip.h"
 #include "impl/BufferClip.h"
+#include "impl/ChunkedClip.h"
 
 #include <QtCore/QJsonDocument>
 #include <QtCore/QJsonObject>
@@ -21,7 +22,12 @@
 using namespace recording;
 
 Clip::Pointer Clip::fromFile(const QString& filePath) {
-    auto result = std::make_shared<FileClip>(filePath);
+    Clip::Pointer result;
+    if (ChunkedFileClip::isChunkedFile(filePath)) {
+        result = std::make_shared<ChunkedFileClip>(filePath);
+    } else {
+        result = std::make_shared<FileClip>(filePath);
+    }
     if (result->frameCount() == 0) {
         return Clip::Pointer();
     }
@@ -101,20 +107,87 @@ bool Clip::write(QIODevice& output) {
 
     QJsonObject rootObject;
     rootObject.insert(FRAME_TYPE_MAP, frameTypeObj);
-    // Always mark new files as compressed
+    // Always mark new files as compressed, the frames are compressed by the chunk
     rootObject.insert(FRAME_COMREPSSION_FLAG, true);
     QByteArray headerFrameData = QJsonDocument(rootObject).toBinaryData();
     // Never compress the header frame
     if (!writeFrame(output, Frame({ Frame::TYPE_HEADER, 0, headerFrameData }), false)) {
         return false;
     }
+    quint64 offset = PointerClip::MINIMUM_FRAME_SIZE + headerFrameData.size();
+
+    // The frames are written in compressed chunks, followed by the index of the chunks, see ChunkedClip.h
+    std::vector<ChunkIndexEntry> chunkIndex;
+    QMap<FrameType, FrameTypeTotal> frameTypeTotals;
+    QByteArray chunk;
+    ChunkIndexEntry chunkEntry {};
+
+    auto writeChunk = [&]()->bool {
+        if (chunkEntry.frameCount == 0) {
+            return true;
+        }
+        QByteArray compressedChunk = qCompress(chunk);
+        if (output.write(compressedChunk) != compressedChunk.size()) {
+            return false;
+        }
+        chunkEntry.offset = offset;
+        chunkEntry.size = compressedChunk.size();
+        chunkIndex.push_back(chunkEntry);
+        offset += chunkEntry.size;
+
+        chunk.clear();
+        chunkEntry = ChunkIndexEntry {};
+        return true;
+    };
 
     seek(0);
 
     for (auto frame = nextFrame(); frame; frame = nextFrame()) {
-        if (!writeFrame(output, *frame)) {
+        if (frame->type == Frame::TYPE_INVALID) {
+            qWarning() << "Attempting to write invalid frame";
+            continue;
+        }
+        if (frame->data.size() > std::numeric_limits<FrameSize>::max()) {
+            qWarning() << "Skipping frame of" << frame->data.size() << "bytes, too large to be written";
+            continue;
+        }
+
+        if (chunkEntry.frameCount == 0) {
+            chunkEntry.firstFrameTime = frame->timeOffset;
+        }
+        chunkEntry.lastFrameTime = frame->timeOffset;
+        ++chunkEntry.frameCount;
+        ChunkedClip::appendFrame(chunk, *frame);
+
+        auto& frameTypeTotal = frameTypeTotals[frame->type];
+        frameTypeTotal.type = frame->type;
+        ++frameTypeTotal.frameCount;
+        frameTypeTotal.lastFrameTime = frame->timeOffset;
+
+        if (chunk.size() >= ChunkedClip::TARGET_CHUNK_SIZE && !writeChunk()) {
             return false;
         }
     }
-    return true;
+
+    if (!writeChunk()) {
+        return false;
+    }
+
+    ChunkedClipTrailer trailer;
+    trailer.indexOffset = offset;
+    trailer.numChunks = (uint32_t)chunkIndex.size();
+    trailer.numFrameTypes = (uint32_t)frameTypeTotals.size();
+    trailer.version = ChunkedClip::VERSION;
+    trailer.magic = ChunkedClip::MAGIC;
+
+    qint64 indexSize = chunkIndex.size() * sizeof(ChunkIndexEntry);
+    if (output.write((const char*)chunkIndex.data(), indexSize) != indexSize) {
+        return false;
+    }
+    for (const auto& frameTypeTotal : frameTypeTotals) {
+        if (output.write((const char*)&frameTypeTotal, sizeof(FrameTypeTotal)) != sizeof(FrameTypeTotal)) {
+            return false;
+        }
+    }
+    return output.write((const char*)&trailer, sizeof(ChunkedClipTrailer)) == sizeof(ChunkedClipTrailer);
 }
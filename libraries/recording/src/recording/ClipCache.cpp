@@ -10,19 +10,36 @@
 
 using namespace recording;
 NetworkClipLoader::NetworkClipLoader(const QUrl& url) :
-    Resource(url),
-    _clip(std::make_shared<NetworkClip>(url)) {}
+    Resource(url) {}
 
 void NetworkClip::init(const QByteArray& clipData) {
     _clipData = clipData;
-    PointerClip::init((uchar*)_clipData.data(), _clipData.size());
+    PointerClip::init((uchar*)_clipData.constData(), _clipData.size());
+}
+
+NetworkChunkedClip::NetworkChunkedClip(const QUrl& url, const QByteArray& clipData) :
+    _clipData(clipData),
+    _url(url)
+{
+    // the clip data is shared with the loader, and only read
+    init((uchar*)_clipData.constData(), _clipData.size());
 }
 
 void NetworkClipLoader::downloadFinished(const QByteArray& data) {
-    _clip->init(data);
+    _clipData = data;
+    _isChunked = ChunkedClip::isChunked((const uchar*)data.constData(), data.size());
     finishedLoading(true);
 }
 
+ClipPointer NetworkClipLoader::getClip() {
+    if (_isChunked) {
+        return std::make_shared<NetworkChunkedClip>(getURL(), _clipData);
+    }
+    auto clip = std::make_shared<NetworkClip>(getURL());
+    clip->init(_clipData);
+    return clip;
+}
+
 ClipCache& ClipCache::instance() {
     static ClipCache _instance;
     return _instance;
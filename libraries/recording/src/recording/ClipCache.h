@@ -13,6 +13,7 @@
 
 #include "Forward.h"
 #include "impl/PointerClip.h"
+#include "impl/ChunkedClip.h"
 
 namespace recording {
 
@@ -29,15 +30,30 @@ private:
     QUrl _url;
 };
 
+class NetworkChunkedClip : public ChunkedClip {
+public:
+    using Pointer = std::shared_ptr<NetworkChunkedClip>;
+
+    NetworkChunkedClip(const QUrl& url, const QByteArray& clipData);
+    virtual QString getName() const override { return _url.toString(); }
+
+private:
+    QByteArray _clipData;
+    QUrl _url;
+};
+
 class NetworkClipLoader : public Resource {
 public:
     NetworkClipLoader(const QUrl& url);
     virtual void downloadFinished(const QByteArray& data) override;
-    ClipPointer getClip() { return _clip; }
+
+    // every call returns a clip with its own position, the clips of a chunked clip share its decompressed chunks
+    ClipPointer getClip();
     bool completed() { return _failedToLoad || isLoaded(); }
 
 private:
-    const NetworkClip::Pointer _clip;
+    QByteArray _clipData;
+    bool _isChunked { false };
 };
 
 using NetworkClipLoaderPointer = QSharedPointer<NetworkClipLoader>;
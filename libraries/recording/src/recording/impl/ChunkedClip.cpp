@@ -0,0 +1,332 @@
+//
+//  Created by Sam Gateau on 10/15/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ChunkedClip.h"
+
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+
+#include <QtCore/QDebug>
+#include <QtCore/QJsonObject>
+
+#include "../Frame.h"
+#include "../Logging.h"
+#include "PointerClip.h"
+
+using namespace recording;
+
+static const size_t CHUNK_FRAME_HEADER_SIZE = sizeof(FrameType) + sizeof(Frame::Time) + sizeof(FrameSize);
+
+bool ChunkedClip::isChunked(const uchar* data, size_t size) {
+    if (!data || size < sizeof(ChunkedClipTrailer)) {
+        return false;
+    }
+    ChunkedClipTrailer trailer;
+    memcpy(&trailer, data + size - sizeof(ChunkedClipTrailer), sizeof(ChunkedClipTrailer));
+    return trailer.magic == MAGIC;
+}
+
+void ChunkedClip::appendFrame(QByteArray& chunk, const Frame& frame) {
+    FrameSize dataSize = frame.data.size();
+    chunk.append((const char*)&(frame.type), sizeof(FrameType));
+    chunk.append((const char*)&(frame.timeOffset), sizeof(Frame::Time));
+    chunk.append((const char*)&dataSize, sizeof(FrameSize));
+    chunk.append(frame.data);
+}
+
+void ChunkedClip::reset() {
+    _header = QJsonDocument();
+    _data = nullptr;
+    _size = 0;
+    _index = nullptr;
+    _numChunks = 0;
+    _frameCount = 0;
+    _lastFrameTime = 0;
+    _translationMap.clear();
+
+    _chunkIndex = 0;
+    _chunkFrameIndex = 0;
+    _loadedChunkIndex = SIZE_MAX;
+    _chunk.reset();
+}
+
+void ChunkedClip::init(uchar* data, size_t size) {
+    reset();
+
+    if (!isChunked(data, size)) {
+        qCWarning(recordingLog) << "Missing chunk index, invalid file";
+        return;
+    }
+
+    ChunkedClipTrailer trailer;
+    memcpy(&trailer, data + size - sizeof(ChunkedClipTrailer), sizeof(ChunkedClipTrailer));
+    if (trailer.version != VERSION) {
+        qCWarning(recordingLog) << "Unsupported chunked clip version" << trailer.version;
+        return;
+    }
+
+    quint64 indexSize = (quint64)trailer.numChunks * sizeof(ChunkIndexEntry);
+    quint64 totalsSize = (quint64)trailer.numFrameTypes * sizeof(FrameTypeTotal);
+    if (trailer.indexOffset + indexSize + totalsSize + sizeof(ChunkedClipTrailer) != size) {
+        qCWarning(recordingLog) << "Chunk index does not match the file size, invalid file";
+        return;
+    }
+
+    // Grab the file header, the first frame of the file
+    {
+        FrameType type;
+        FrameSize headerSize;
+        if (trailer.indexOffset < CHUNK_FRAME_HEADER_SIZE) {
+            qCWarning(recordingLog) << "Missing header frame, invalid file";
+            return;
+        }
+        memcpy(&type, data, sizeof(FrameType));
+        memcpy(&headerSize, data + sizeof(FrameType) + sizeof(Frame::Time), sizeof(FrameSize));
+        if (type != Frame::TYPE_HEADER || CHUNK_FRAME_HEADER_SIZE + headerSize > trailer.indexOffset) {
+            qCWarning(recordingLog) << "Missing header frame, invalid file";
+            return;
+        }
+
+        QByteArray fileHeaderData((const char*)data + CHUNK_FRAME_HEADER_SIZE, headerSize);
+        _header = QJsonDocument::fromBinaryData(fileHeaderData);
+    }
+
+    _translationMap = parseTranslationMap(_header);
+    if (_translationMap.empty()) {
+        qCWarning(recordingLog) << "Header missing frame type map, invalid file";
+        reset();
+        return;
+    }
+
+    _data = data;
+    _size = size;
+    _index = data + trailer.indexOffset;
+    _numChunks = trailer.numChunks;
+
+    // the frames of types we don't know are skipped, they are not counted either
+    const uchar* totals = _index + indexSize;
+    for (uint32_t i = 0; i < trailer.numFrameTypes; ++i) {
+        FrameTypeTotal total;
+        memcpy(&total, totals + i * sizeof(FrameTypeTotal), sizeof(FrameTypeTotal));
+        if (_translationMap.contains(total.type)) {
+            _frameCount += total.frameCount;
+            _lastFrameTime = std::max(_lastFrameTime, total.lastFrameTime);
+        }
+    }
+
+    qCDebug(recordingLog) << "Opened chunked clip with" << _frameCount << "frames in" << _numChunks << "chunks";
+}
+
+ChunkIndexEntry ChunkedClip::readIndexEntry(size_t chunkIndex) const {
+    ChunkIndexEntry entry;
+    memcpy(&entry, _index + chunkIndex * sizeof(ChunkIndexEntry), sizeof(ChunkIndexEntry));
+    return entry;
+}
+
+// The decompressed chunks in use, by the data they were decompressed from and their index
+using DecodedChunkKey = std::pair<const uchar*, size_t>;
+
+struct DecodedChunkKeyHash {
+    size_t operator()(const DecodedChunkKey& key) const {
+        return std::hash<const uchar*>()(key.first) ^ (std::hash<size_t>()(key.second) << 1);
+    }
+};
+
+static std::mutex decodedChunksMutex;
+static std::unordered_map<DecodedChunkKey, std::weak_ptr<const void>, DecodedChunkKeyHash> decodedChunks;
+static size_t decodedChunksSweepSize { 64 };
+
+// Internal only function, needs no locking
+void ChunkedClip::loadChunk(size_t chunkIndex) const {
+    if (chunkIndex == _loadedChunkIndex) {
+        return;
+    }
+    _loadedChunkIndex = chunkIndex;
+
+    DecodedChunkKey key { _data, chunkIndex };
+    {
+        std::lock_guard<std::mutex> lock(decodedChunksMutex);
+        auto it = decodedChunks.find(key);
+        if (it != decodedChunks.end()) {
+            _chunk = std::static_pointer_cast<const DecodedChunk>(it->second.lock());
+            if (_chunk) {
+                return;
+            }
+        }
+    }
+
+    // decompress outside of the lock, two clips missing the same chunk at once both decompress it
+    _chunk = decodeChunk(chunkIndex);
+
+    std::lock_guard<std::mutex> lock(decodedChunksMutex);
+    decodedChunks[key] = _chunk;
+
+    // drop the chunks no clip holds anymore once the map doubled in size
+    if (decodedChunks.size() >= decodedChunksSweepSize) {
+        for (auto it = decodedChunks.begin(); it != decodedChunks.end();) {
+            if (it->second.expired()) {
+                it = decodedChunks.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        decodedChunksSweepSize = std::max(decodedChunks.size() * 2, (size_t)64);
+    }
+}
+
+ChunkedClip::DecodedChunkPointer ChunkedClip::decodeChunk(size_t chunkIndex) const {
+    auto chunk = std::make_shared<DecodedChunk>();
+
+    auto entry = readIndexEntry(chunkIndex);
+    if (entry.offset + entry.size > (quint64)(_index - _data)) {
+        qCWarning(recordingLog) << "Chunk" << chunkIndex << "runs past the chunk index, skipping it";
+        return chunk;
+    }
+
+    chunk->data = qUncompress(QByteArray::fromRawData((const char*)_data + entry.offset, entry.size));
+
+    const char* start = chunk->data.constData();
+    const char* current = start;
+    const char* end = start + chunk->data.size();
+    chunk->frames.reserve(entry.frameCount);
+    while ((size_t)(end - current) >= CHUNK_FRAME_HEADER_SIZE) {
+        ChunkFrame frame;
+        memcpy(&(frame.type), current, sizeof(FrameType));
+        current += sizeof(FrameType);
+        memcpy(&(frame.timeOffset), current, sizeof(Frame::Time));
+        current += sizeof(Frame::Time);
+        memcpy(&(frame.size), current, sizeof(FrameSize));
+        current += sizeof(FrameSize);
+        frame.dataOffset = (int)(current - start);
+        if (end - current < frame.size) {
+            break;
+        }
+        current += frame.size;
+
+        auto translated = _translationMap.find(frame.type);
+        if (translated != _translationMap.end()) {
+            frame.type = translated.value();
+            chunk->frames.push_back(frame);
+        }
+    }
+    return chunk;
+}
+
+// Moves the position past the end of chunks that have no frames left, returns false at the end of the clip
+bool ChunkedClip::settlePosition() const {
+    while (_chunkIndex < _numChunks) {
+        loadChunk(_chunkIndex);
+        if (_chunkFrameIndex < _chunk->frames.size()) {
+            return true;
+        }
+        ++_chunkIndex;
+        _chunkFrameIndex = 0;
+    }
+    return false;
+}
+
+FrameConstPointer ChunkedClip::readFrame(const ChunkFrame& chunkFrame) const {
+    auto result = std::make_shared<Frame>();
+    result->type = chunkFrame.type;
+    result->timeOffset = chunkFrame.timeOffset;
+    if (chunkFrame.size) {
+        result->data = QByteArray(_chunk->data.constData() + chunkFrame.dataOffset, chunkFrame.size);
+    }
+    return result;
+}
+
+Clip::Pointer ChunkedClip::duplicate() const {
+    auto result = newClip();
+    Locker lock(_mutex);
+    for (size_t i = 0; i < _numChunks; ++i) {
+        loadChunk(i);
+        for (const auto& chunkFrame : _chunk->frames) {
+            result->addFrame(readFrame(chunkFrame));
+        }
+    }
+    return result;
+}
+
+float ChunkedClip::duration() const {
+    Locker lock(_mutex);
+    return Frame::frameTimeToSeconds(_lastFrameTime);
+}
+
+size_t ChunkedClip::frameCount() const {
+    Locker lock(_mutex);
+    return _frameCount;
+}
+
+void ChunkedClip::seekFrameTime(Frame::Time offset) {
+    Locker lock(_mutex);
+
+    // find the first chunk that ends at or after the offset
+    size_t first = 0;
+    size_t count = _numChunks;
+    while (count > 0) {
+        size_t step = count / 2;
+        if (readIndexEntry(first + step).lastFrameTime < offset) {
+            first += step + 1;
+            count -= step + 1;
+        } else {
+            count = step;
+        }
+    }
+
+    _chunkIndex = first;
+    _chunkFrameIndex = 0;
+    if (_chunkIndex < _numChunks) {
+        loadChunk(_chunkIndex);
+        const auto& frames = _chunk->frames;
+        auto itr = std::lower_bound(frames.begin(), frames.end(), offset,
+            [](const ChunkFrame& a, Frame::Time b)->bool {
+                return a.timeOffset < b;
+            }
+        );
+        _chunkFrameIndex = itr - frames.begin();
+    }
+}
+
+Frame::Time ChunkedClip::positionFrameTime() const {
+    Locker lock(_mutex);
+    Frame::Time result = Frame::INVALID_TIME;
+    if (settlePosition()) {
+        result = _chunk->frames[_chunkFrameIndex].timeOffset;
+    }
+    return result;
+}
+
+FrameConstPointer ChunkedClip::peekFrame() const {
+    Locker lock(_mutex);
+    FrameConstPointer result;
+    if (settlePosition()) {
+        result = readFrame(_chunk->frames[_chunkFrameIndex]);
+    }
+    return result;
+}
+
+FrameConstPointer ChunkedClip::nextFrame() {
+    Locker lock(_mutex);
+    FrameConstPointer result;
+    if (settlePosition()) {
+        result = readFrame(_chunk->frames[_chunkFrameIndex++]);
+    }
+    return result;
+}
+
+void ChunkedClip::skipFrame() {
+    Locker lock(_mutex);
+    if (settlePosition()) {
+        ++_chunkFrameIndex;
+    }
+}
+
+void ChunkedClip::addFrame(FrameConstPointer) {
+    throw std::runtime_error("Chunked clips are read only, use duplicate to create a read/write clip");
+}
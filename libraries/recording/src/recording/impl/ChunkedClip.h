@@ -0,0 +1,130 @@
+//
+//  Created by Sam Gateau on 10/15/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+#ifndef hifi_Recording_Impl_ChunkedClip_h
+#define hifi_Recording_Impl_ChunkedClip_h
+
+#include "../Clip.h"
+
+#include <cstdint>
+#include <vector>
+
+#include <QtCore/QJsonDocument>
+#include <QtCore/QMap>
+
+#include "../Frame.h"
+
+namespace recording {
+
+// The layout of a chunked clip file:
+//  - the header frame, framed like the frames of the older clip files
+//  - the chunks, each a qCompress'ed run of about TARGET_CHUNK_SIZE bytes of frames framed as type, time, size, data
+//  - a ChunkIndexEntry per chunk, in time order
+//  - a FrameTypeTotal per frame type in the clip
+//  - the ChunkedClipTrailer
+struct ChunkIndexEntry {
+    quint64 offset;
+    uint32_t size;
+    uint32_t frameCount;
+    Frame::Time firstFrameTime;
+    Frame::Time lastFrameTime;
+};
+
+struct FrameTypeTotal {
+    FrameType type;
+    uint16_t padding;
+    uint32_t frameCount;
+    Frame::Time lastFrameTime;
+};
+
+struct ChunkedClipTrailer {
+    quint64 indexOffset;
+    uint32_t numChunks;
+    uint32_t numFrameTypes;
+    uint32_t version;
+    uint32_t magic;
+};
+
+// Reads a chunked clip in place: seeking is a binary search of the chunk index, and only the chunk holding the
+// position is decompressed, so a mapped file takes the same memory however long the clip is. The clips reading the
+// same data, like the ones the clip cache hands out for a URL, share the decompressed chunks.
+class ChunkedClip : public Clip {
+public:
+    using Pointer = std::shared_ptr<ChunkedClip>;
+
+    static const uint32_t MAGIC = 0x49524648; // "HFRI"
+    static const uint32_t VERSION = 1;
+    static const int TARGET_CHUNK_SIZE = 64 * 1024;
+
+    static bool isChunked(const uchar* data, size_t size);
+    static void appendFrame(QByteArray& chunk, const Frame& frame);
+
+    ChunkedClip() {};
+    ChunkedClip(uchar* data, size_t size) { init(data, size); }
+
+    void init(uchar* data, size_t size);
+    const QJsonDocument& getHeader() const {
+        return _header;
+    }
+
+    virtual Clip::Pointer duplicate() const override;
+
+    virtual float duration() const override;
+    virtual size_t frameCount() const override;
+
+    virtual void seekFrameTime(Frame::Time offset) override;
+    virtual Frame::Time positionFrameTime() const override;
+
+    virtual FrameConstPointer peekFrame() const override;
+    virtual FrameConstPointer nextFrame() override;
+    virtual void skipFrame() override;
+    virtual void addFrame(FrameConstPointer) override;
+
+protected:
+    struct ChunkFrame {
+        FrameType type;
+        Frame::Time timeOffset;
+        FrameSize size;
+        int dataOffset;
+    };
+
+    // frames of unknown types are left out
+    struct DecodedChunk {
+        QByteArray data;
+        std::vector<ChunkFrame> frames;
+    };
+    using DecodedChunkPointer = std::shared_ptr<const DecodedChunk>;
+
+    virtual void reset() override;
+
+    ChunkIndexEntry readIndexEntry(size_t chunkIndex) const;
+    void loadChunk(size_t chunkIndex) const;
+    DecodedChunkPointer decodeChunk(size_t chunkIndex) const;
+    bool settlePosition() const;
+    FrameConstPointer readFrame(const ChunkFrame& chunkFrame) const;
+
+    QJsonDocument _header;
+    uchar* _data { nullptr };
+    size_t _size { 0 };
+    const uchar* _index { nullptr };
+    size_t _numChunks { 0 };
+    size_t _frameCount { 0 };
+    Frame::Time _lastFrameTime { 0 };
+    QMap<FrameType, FrameType> _translationMap;
+
+    // the position, and the decompressed chunk it is in
+    mutable size_t _chunkIndex { 0 };
+    mutable size_t _chunkFrameIndex { 0 };
+    mutable size_t _loadedChunkIndex { SIZE_MAX };
+    mutable DecodedChunkPointer _chunk;
+};
+
+}
+
+#endif
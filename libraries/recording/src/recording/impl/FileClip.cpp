@@ -65,3 +65,37 @@ FileClip::~FileClip() {
     }
     reset();
 }
+
+ChunkedFileClip::ChunkedFileClip(const QString& fileName) : _file(fileName) {
+    auto size = _file.size();
+    bool opened = _file.open(QIODevice::ReadOnly);
+    if (!opened) {
+        qCWarning(recordingLog) << "Unable to open file " << fileName;
+        return;
+    }
+    auto mappedFile = _file.map(0, size, QFile::MapPrivateOption);
+    init(mappedFile, size);
+}
+
+QString ChunkedFileClip::getName() const {
+    return _file.fileName();
+}
+
+bool ChunkedFileClip::isChunkedFile(const QString& filePath) {
+    QFile file(filePath);
+    if (file.size() < (qint64)sizeof(ChunkedClipTrailer) || !file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    file.seek(file.size() - sizeof(ChunkedClipTrailer));
+    QByteArray trailer = file.read(sizeof(ChunkedClipTrailer));
+    return ChunkedClip::isChunked(reinterpret_cast<const uchar*>(trailer.constData()), trailer.size());
+}
+
+ChunkedFileClip::~ChunkedFileClip() {
+    Locker lock(_mutex);
+    _file.unmap(_data);
+    if (_file.isOpen()) {
+        _file.close();
+    }
+    reset();
+}
@@ -11,6 +11,7 @@
 #define hifi_Recording_Impl_FileClip_h
 
 #include "PointerClip.h"
+#include "ChunkedClip.h"
 
 #include <QtCore/QFile>
 
@@ -31,6 +32,22 @@ private:
     QFile _file;
 };
 
+// A chunked clip file, mapped rather than read, see ChunkedClip
+class ChunkedFileClip : public ChunkedClip {
+public:
+    using Pointer = std::shared_ptr<ChunkedFileClip>;
+
+    ChunkedFileClip(const QString& file);
+    virtual ~ChunkedFileClip();
+
+    virtual QString getName() const override;
+
+    static bool isChunkedFile(const QString& filePath);
+
+private:
+    QFile _file;
+};
+
 }
 
 #endif
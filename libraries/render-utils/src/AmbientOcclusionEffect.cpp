@@ -33,6 +33,8 @@
 #include "ssao_debugOcclusion_frag.h"
 #include "ssao_makeHorizontalBlur_frag.h"
 #include "ssao_makeVerticalBlur_frag.h"
+#include "ssao_makeTemporal_frag.h"
+#include "ssao_makeUpsample_frag.h"
 
 
 AmbientOcclusionFramebuffer::AmbientOcclusionFramebuffer() {
@@ -58,17 +60,46 @@ void AmbientOcclusionFramebuffer::updateLinearDepth(const gpu::TexturePointer& l
     }
 }
 
+void AmbientOcclusionFramebuffer::updateUpsampling(const gpu::TexturePointer& sourceLinearDepthBuffer) {
+    bool reset = false;
+    if (_sourceLinearDepthTexture != sourceLinearDepthBuffer) {
+        _sourceLinearDepthTexture = sourceLinearDepthBuffer;
+        reset = true;
+    }
+    if (_sourceLinearDepthTexture) {
+        auto newFrameSize = glm::ivec2(_sourceLinearDepthTexture->getDimensions());
+        if (_sourceFrameSize != newFrameSize) {
+            _sourceFrameSize = newFrameSize;
+            reset = true;
+        }
+    }
+
+    if (reset) {
+        _occlusionUpsampledFramebuffer.reset();
+        _occlusionUpsampledTexture.reset();
+    }
+}
+
 void AmbientOcclusionFramebuffer::clear() {
     _occlusionFramebuffer.reset();
     _occlusionTexture.reset();
     _occlusionBlurredFramebuffer.reset();
     _occlusionBlurredTexture.reset();
+    for (int i = 0; i < NUM_HISTORY_BUFFERS; i++) {
+        _occlusionHistoryFramebuffers[i].reset();
+        _occlusionHistoryTextures[i].reset();
+    }
+    _isHistoryValid = false;
 }
 
 gpu::TexturePointer AmbientOcclusionFramebuffer::getLinearDepthTexture() {
     return _linearDepthTexture;
 }
 
+gpu::TexturePointer AmbientOcclusionFramebuffer::getSourceLinearDepthTexture() {
+    return _sourceLinearDepthTexture;
+}
+
 void AmbientOcclusionFramebuffer::allocate() {
     
     auto width = _frameSize.x;
@@ -81,6 +112,21 @@ void AmbientOcclusionFramebuffer::allocate() {
     _occlusionBlurredTexture = gpu::TexturePointer(gpu::Texture::create2D(gpu::Element::COLOR_RGBA_32, width, height, gpu::Sampler(gpu::Sampler::FILTER_MIN_MAG_LINEAR_MIP_POINT)));
     _occlusionBlurredFramebuffer = gpu::FramebufferPointer(gpu::Framebuffer::create("occlusionBlurred"));
     _occlusionBlurredFramebuffer->setRenderBuffer(0, _occlusionBlurredTexture);
+
+    for (int i = 0; i < NUM_HISTORY_BUFFERS; i++) {
+        _occlusionHistoryTextures[i] = gpu::TexturePointer(gpu::Texture::create2D(gpu::Element::COLOR_RGBA_32, width, height, gpu::Sampler(gpu::Sampler::FILTER_MIN_MAG_POINT)));
+        _occlusionHistoryFramebuffers[i] = gpu::FramebufferPointer(gpu::Framebuffer::create("occlusionHistory"));
+        _occlusionHistoryFramebuffers[i]->setRenderBuffer(0, _occlusionHistoryTextures[i]);
+    }
+}
+
+void AmbientOcclusionFramebuffer::allocateUpsampled() {
+    auto width = _sourceFrameSize.x;
+    auto height = _sourceFrameSize.y;
+
+    _occlusionUpsampledTexture = gpu::TexturePointer(gpu::Texture::create2D(gpu::Element::COLOR_RGBA_32, width, height, gpu::Sampler(gpu::Sampler::FILTER_MIN_MAG_LINEAR_MIP_POINT)));
+    _occlusionUpsampledFramebuffer = gpu::FramebufferPointer(gpu::Framebuffer::create("occlusionUpsampled"));
+    _occlusionUpsampledFramebuffer->setRenderBuffer(0, _occlusionUpsampledTexture);
 }
 
 gpu::FramebufferPointer AmbientOcclusionFramebuffer::getOcclusionFramebuffer() {
@@ -111,6 +157,41 @@ gpu::TexturePointer AmbientOcclusionFramebuffer::getOcclusionBlurredTexture() {
     return _occlusionBlurredTexture;
 }
 
+gpu::FramebufferPointer AmbientOcclusionFramebuffer::getOcclusionHistoryFramebuffer(int index) {
+    if (!_occlusionHistoryFramebuffers[index]) {
+        allocate();
+    }
+    return _occlusionHistoryFramebuffers[index];
+}
+
+gpu::TexturePointer AmbientOcclusionFramebuffer::getOcclusionHistoryTexture(int index) {
+    if (!_occlusionHistoryTextures[index]) {
+        allocate();
+    }
+    return _occlusionHistoryTextures[index];
+}
+
+gpu::FramebufferPointer AmbientOcclusionFramebuffer::getOcclusionUpsampledFramebuffer() {
+    if (!_occlusionUpsampledFramebuffer) {
+        allocateUpsampled();
+    }
+    return _occlusionUpsampledFramebuffer;
+}
+
+gpu::TexturePointer AmbientOcclusionFramebuffer::getOcclusionUpsampledTexture() {
+    if (!_occlusionUpsampledTexture) {
+        allocateUpsampled();
+    }
+    return _occlusionUpsampledTexture;
+}
+
+gpu::TexturePointer AmbientOcclusionFramebuffer::getOcclusionResultTexture() {
+    if (_sourceLinearDepthTexture) {
+        return getOcclusionUpsampledTexture();
+    }
+    return getOcclusionTexture();
+}
+
 
 class GaussianDistribution {
 public:
@@ -172,6 +253,8 @@ const int AmbientOcclusionEffect_ParamsSlot = 1;
 const int AmbientOcclusionEffect_CameraCorrectionSlot = 2;
 const int AmbientOcclusionEffect_LinearDepthMapSlot = 0;
 const int AmbientOcclusionEffect_OcclusionMapSlot = 0;
+const int AmbientOcclusionEffect_OcclusionHistoryMapSlot = 1;
+const int AmbientOcclusionEffect_SourceLinearDepthMapSlot = 1;
 
 AmbientOcclusionEffect::AmbientOcclusionEffect() {
 }
@@ -216,11 +299,8 @@ void AmbientOcclusionEffect::configure(const Config& config) {
         current.z = config.numSpiralTurns;
     }
 
-    if (config.numSamples != _parametersBuffer->getNumSamples()) {
-        auto& current = _parametersBuffer->sampleInfo;
-        current.x = config.numSamples;
-        current.y = 1.0f / config.numSamples;
-    }
+    // The samples evaluated per frame depend on the temporal accumulation, they are updated every frame
+    _numSamples = config.numSamples;
 
     if (config.fetchMipsEnabled != _parametersBuffer->isFetchMipsEnabled()) {
         auto& current = _parametersBuffer->sampleInfo;
@@ -255,6 +335,18 @@ void AmbientOcclusionEffect::configure(const Config& config) {
         current.w = (float)config.borderingEnabled;
     }
 
+    if (config.temporalEnabled != _parametersBuffer->isTemporalEnabled()) {
+        auto& current = _parametersBuffer->temporalInfo;
+        current.z = (float)config.temporalEnabled;
+    }
+
+    if (config.temporalFrameCount != _parametersBuffer->getTemporalFrameCount()) {
+        auto& current = _parametersBuffer->temporalInfo;
+        current.x = (float)config.temporalFrameCount;
+    }
+
+    _isUpsamplingEnabled = config.upsamplingEnabled;
+
     if (shouldUpdateGaussian) {
         updateGaussianDistribution();
     }
@@ -333,6 +425,54 @@ const gpu::PipelinePointer& AmbientOcclusionEffect::getVBlurPipeline() {
     return _vBlurPipeline;
 }
 
+const gpu::PipelinePointer& AmbientOcclusionEffect::getTemporalPipeline() {
+    if (!_temporalPipeline) {
+        auto vs = gpu::StandardShaderLib::getDrawViewportQuadTransformTexcoordVS();
+        auto ps = gpu::Shader::createPixel(std::string(ssao_makeTemporal_frag));
+        gpu::ShaderPointer program = gpu::Shader::createProgram(vs, ps);
+
+        gpu::Shader::BindingSet slotBindings;
+        slotBindings.insert(gpu::Shader::Binding(std::string("deferredFrameTransformBuffer"), AmbientOcclusionEffect_FrameTransformSlot));
+        slotBindings.insert(gpu::Shader::Binding(std::string("cameraCorrectionBuffer"), AmbientOcclusionEffect_CameraCorrectionSlot));
+        slotBindings.insert(gpu::Shader::Binding(std::string("ambientOcclusionParamsBuffer"), AmbientOcclusionEffect_ParamsSlot));
+        slotBindings.insert(gpu::Shader::Binding(std::string("occlusionMap"), AmbientOcclusionEffect_OcclusionMapSlot));
+        slotBindings.insert(gpu::Shader::Binding(std::string("occlusionHistoryMap"), AmbientOcclusionEffect_OcclusionHistoryMapSlot));
+        gpu::Shader::makeProgram(*program, slotBindings);
+
+        gpu::StatePointer state = gpu::StatePointer(new gpu::State());
+
+        state->setColorWriteMask(true, true, true, false);
+
+        // Good to go add the brand new pipeline
+        _temporalPipeline = gpu::Pipeline::create(program, state);
+    }
+    return _temporalPipeline;
+}
+
+const gpu::PipelinePointer& AmbientOcclusionEffect::getUpsamplePipeline() {
+    if (!_upsamplePipeline) {
+        auto vs = gpu::StandardShaderLib::getDrawViewportQuadTransformTexcoordVS();
+        auto ps = gpu::Shader::createPixel(std::string(ssao_makeUpsample_frag));
+        gpu::ShaderPointer program = gpu::Shader::createProgram(vs, ps);
+
+        gpu::Shader::BindingSet slotBindings;
+        slotBindings.insert(gpu::Shader::Binding(std::string("deferredFrameTransformBuffer"), AmbientOcclusionEffect_FrameTransformSlot));
+        slotBindings.insert(gpu::Shader::Binding(std::string("cameraCorrectionBuffer"), AmbientOcclusionEffect_CameraCorrectionSlot));
+        slotBindings.insert(gpu::Shader::Binding(std::string("ambientOcclusionParamsBuffer"), AmbientOcclusionEffect_ParamsSlot));
+        slotBindings.insert(gpu::Shader::Binding(std::string("occlusionMap"), AmbientOcclusionEffect_OcclusionMapSlot));
+        slotBindings.insert(gpu::Shader::Binding(std::string("linearDepthMap"), AmbientOcclusionEffect_SourceLinearDepthMapSlot));
+        gpu::Shader::makeProgram(*program, slotBindings);
+
+        gpu::StatePointer state = gpu::StatePointer(new gpu::State());
+
+        state->setColorWriteMask(true, true, true, false);
+
+        // Good to go add the brand new pipeline
+        _upsamplePipeline = gpu::Pipeline::create(program, state);
+    }
+    return _upsamplePipeline;
+}
+
 void AmbientOcclusionEffect::updateGaussianDistribution() {
     auto coefs = _parametersBuffer->_gaussianCoefs;
     GaussianDistribution::evalSampling(coefs, Parameters::GAUSSIAN_COEFS_LENGTH, _parametersBuffer->getBlurRadius(), _parametersBuffer->getBlurDeviation());
@@ -355,16 +495,50 @@ void AmbientOcclusionEffect::run(const render::SceneContextPointer& sceneContext
         _framebuffer = std::make_shared<AmbientOcclusionFramebuffer>();
     }
     
+    bool isUpsampling = false;
     if (_parametersBuffer->getResolutionLevel() > 0) {
         linearDepthTexture = linearDepthFramebuffer->getHalfLinearDepthTexture();
         occlusionViewport = occlusionViewport >> _parametersBuffer->getResolutionLevel();
+        isUpsampling = _isUpsamplingEnabled;
     }
 
     _framebuffer->updateLinearDepth(linearDepthTexture);
-  
+    _framebuffer->updateUpsampling(isUpsampling ? linearDepthFramebuffer->getLinearDepthTexture() : gpu::TexturePointer());
+
+    // Only the main view has a history, the mirror evaluates its samples every frame
+    bool isTemporal = _parametersBuffer->isTemporalEnabled() && (args->_renderMode == RenderArgs::DEFAULT_RENDER_MODE);
+    if (!isTemporal && (args->_renderMode == RenderArgs::DEFAULT_RENDER_MODE)) {
+        _framebuffer->setHistoryValid(false);
+    }
+
+    // Spread the samples over the frames, each frame evaluates its share of them along a rotated spiral
+    int frameCount = (isTemporal ? _parametersBuffer->getTemporalFrameCount() : 1);
+    int numSamples = std::max(1, (_numSamples + frameCount - 1) / frameCount);
+    float frameDithering = 0.0f;
+    if (isTemporal) {
+        _frameIndex = (_frameIndex + 1) % frameCount;
+        frameDithering = (float)_frameIndex * TWO_PI / (float)frameCount;
+    }
+    _parametersBuffer->sampleInfo.x = (float)numSamples;
+    _parametersBuffer->sampleInfo.y = 1.0f / (float)numSamples;
+    _parametersBuffer->ditheringInfo.y = frameDithering;
+    _parametersBuffer->temporalInfo.y = 1.0f / (float)frameCount;
     
     auto occlusionFBO = _framebuffer->getOcclusionFramebuffer();
     auto occlusionBlurredFBO = _framebuffer->getOcclusionBlurredFramebuffer();
+
+    // The accumulated occlusion is written in one history buffer from the other one
+    auto historyFBO = _framebuffer->getOcclusionHistoryFramebuffer(_historyIndex);
+    auto previousHistoryFBO = _framebuffer->getOcclusionHistoryFramebuffer(1 - _historyIndex);
+    bool isHistoryValid = _framebuffer->isHistoryValid();
+    if (isTemporal) {
+        _historyIndex = 1 - _historyIndex;
+        _framebuffer->setHistoryValid(true);
+    }
+    auto blurSourceFBO = (isTemporal ? historyFBO : occlusionFBO);
+
+    auto upsampledFBO = (isUpsampling ? _framebuffer->getOcclusionUpsampledFramebuffer() : gpu::FramebufferPointer());
+    auto sourceLinearDepthTexture = _framebuffer->getSourceLinearDepthTexture();
     
     outputs.edit0() = _framebuffer;
     outputs.edit1() = _parametersBuffer;
@@ -380,6 +554,8 @@ void AmbientOcclusionEffect::run(const render::SceneContextPointer& sceneContext
     auto occlusionPipeline = getOcclusionPipeline();
     auto firstHBlurPipeline = getHBlurPipeline();
     auto lastVBlurPipeline = getVBlurPipeline();
+    auto temporalPipeline = getTemporalPipeline();
+    auto upsamplePipeline = getUpsamplePipeline();
     
     gpu::doInBatch(args->_context, [=](gpu::Batch& batch) {
         batch.enableStereo(false);
@@ -409,12 +585,27 @@ void AmbientOcclusionEffect::run(const render::SceneContextPointer& sceneContext
         batch.setResourceTexture(AmbientOcclusionEffect_LinearDepthMapSlot, _framebuffer->getLinearDepthTexture());
         batch.draw(gpu::TRIANGLE_STRIP, 4);
 
+        if (isTemporal) {
+            // A null depth key never matches the reprojected surfaces
+            if (!isHistoryValid) {
+                batch.setFramebuffer(previousHistoryFBO);
+                batch.clearColorFramebuffer(gpu::Framebuffer::BUFFER_COLOR0, glm::vec4(1.0f, 0.0f, 0.0f, 1.0f));
+            }
+
+            // Accumulate the occlusion with the one of the previous frames
+            batch.setFramebuffer(historyFBO);
+            batch.setPipeline(temporalPipeline);
+            batch.setResourceTexture(AmbientOcclusionEffect_OcclusionMapSlot, occlusionFBO->getRenderBuffer(0));
+            batch.setResourceTexture(AmbientOcclusionEffect_OcclusionHistoryMapSlot, previousHistoryFBO->getRenderBuffer(0));
+            batch.draw(gpu::TRIANGLE_STRIP, 4);
+            batch.setResourceTexture(AmbientOcclusionEffect_OcclusionHistoryMapSlot, nullptr);
+        }
         
         if (_parametersBuffer->getBlurRadius() > 0) {
             // Blur 1st pass
             batch.setFramebuffer(occlusionBlurredFBO);
             batch.setPipeline(firstHBlurPipeline);
-            batch.setResourceTexture(AmbientOcclusionEffect_OcclusionMapSlot, occlusionFBO->getRenderBuffer(0));
+            batch.setResourceTexture(AmbientOcclusionEffect_OcclusionMapSlot, blurSourceFBO->getRenderBuffer(0));
             batch.draw(gpu::TRIANGLE_STRIP, 4);
 
             // Blur 2nd pass
@@ -422,8 +613,22 @@ void AmbientOcclusionEffect::run(const render::SceneContextPointer& sceneContext
             batch.setPipeline(lastVBlurPipeline);
             batch.setResourceTexture(AmbientOcclusionEffect_OcclusionMapSlot, occlusionBlurredFBO->getRenderBuffer(0));
             batch.draw(gpu::TRIANGLE_STRIP, 4);
+        } else if (isTemporal) {
+            // The result is always expected in the occlusion buffer
+            gpu::Vec4i rect(occlusionViewport.x, occlusionViewport.y, occlusionViewport.x + occlusionViewport.z, occlusionViewport.y + occlusionViewport.w);
+            batch.blit(historyFBO, rect, occlusionFBO, rect);
+        }
+
+        if (isUpsampling) {
+            // Upsample pass, the low resolution occlusion is filtered respecting the full resolution depth edges
+            batch.setViewportTransform(sourceViewport);
+            batch.setFramebuffer(upsampledFBO);
+            batch.setPipeline(upsamplePipeline);
+            batch.setResourceTexture(AmbientOcclusionEffect_OcclusionMapSlot, occlusionFBO->getRenderBuffer(0));
+            batch.setResourceTexture(AmbientOcclusionEffect_SourceLinearDepthMapSlot, sourceLinearDepthTexture);
+            batch.draw(gpu::TRIANGLE_STRIP, 4);
+            batch.setResourceTexture(AmbientOcclusionEffect_SourceLinearDepthMapSlot, nullptr);
         }
-        
         
         batch.setResourceTexture(AmbientOcclusionEffect_LinearDepthMapSlot, nullptr);
         batch.setResourceTexture(AmbientOcclusionEffect_OcclusionMapSlot, nullptr);
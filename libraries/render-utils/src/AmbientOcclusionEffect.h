@@ -29,26 +29,53 @@ public:
     
     gpu::FramebufferPointer getOcclusionBlurredFramebuffer();
     gpu::TexturePointer getOcclusionBlurredTexture();
+
+    // The occlusion accumulated over the previous frames, the two buffers swap every frame
+    gpu::FramebufferPointer getOcclusionHistoryFramebuffer(int index);
+    gpu::TexturePointer getOcclusionHistoryTexture(int index);
+    bool isHistoryValid() const { return _isHistoryValid; }
+    void setHistoryValid(bool valid) { _isHistoryValid = valid; }
+
+    // The occlusion brought back to the source frame size when evaluated at a lower resolution
+    gpu::FramebufferPointer getOcclusionUpsampledFramebuffer();
+    gpu::TexturePointer getOcclusionUpsampledTexture();
+
+    // The occlusion to light the frame with, upsampled or not
+    gpu::TexturePointer getOcclusionResultTexture();
     
     // Update the source framebuffer size which will drive the allocation of all the other resources.
     void updateLinearDepth(const gpu::TexturePointer& linearDepthBuffer);
     gpu::TexturePointer getLinearDepthTexture();
     const glm::ivec2& getSourceFrameSize() const { return _frameSize; }
+
+    // Update the full resolution linear depth the occlusion is upsampled against, null when not upsampling
+    void updateUpsampling(const gpu::TexturePointer& sourceLinearDepthBuffer);
+    gpu::TexturePointer getSourceLinearDepthTexture();
         
 protected:
     void clear();
     void allocate();
+    void allocateUpsampled();
     
     gpu::TexturePointer _linearDepthTexture;
+    gpu::TexturePointer _sourceLinearDepthTexture;
     
     gpu::FramebufferPointer _occlusionFramebuffer;
     gpu::TexturePointer _occlusionTexture;
     
     gpu::FramebufferPointer _occlusionBlurredFramebuffer;
     gpu::TexturePointer _occlusionBlurredTexture;
-    
+
+    static const int NUM_HISTORY_BUFFERS = 2;
+    gpu::FramebufferPointer _occlusionHistoryFramebuffers[NUM_HISTORY_BUFFERS];
+    gpu::TexturePointer _occlusionHistoryTextures[NUM_HISTORY_BUFFERS];
+    bool _isHistoryValid{ false };
+
+    gpu::FramebufferPointer _occlusionUpsampledFramebuffer;
+    gpu::TexturePointer _occlusionUpsampledTexture;
     
     glm::ivec2 _frameSize;
+    glm::ivec2 _sourceFrameSize;
 };
 
 using AmbientOcclusionFramebufferPointer = std::shared_ptr<AmbientOcclusionFramebuffer>;
@@ -68,12 +95,16 @@ class AmbientOcclusionEffectConfig : public render::GPUJobConfig::Persistent {
     Q_PROPERTY(int numSamples MEMBER numSamples WRITE setNumSamples)
     Q_PROPERTY(int resolutionLevel MEMBER resolutionLevel WRITE setResolutionLevel)
     Q_PROPERTY(int blurRadius MEMBER blurRadius WRITE setBlurRadius)
+    Q_PROPERTY(bool upsamplingEnabled MEMBER upsamplingEnabled NOTIFY dirty)
+    Q_PROPERTY(bool temporalEnabled MEMBER temporalEnabled NOTIFY dirty)
+    Q_PROPERTY(int temporalFrameCount MEMBER temporalFrameCount WRITE setTemporalFrameCount)
 
 public:
     AmbientOcclusionEffectConfig() : render::GPUJobConfig::Persistent("Ambient Occlusion", false) {}
 
     const int MAX_RESOLUTION_LEVEL = 4;
     const int MAX_BLUR_RADIUS = 6;
+    const int MAX_TEMPORAL_FRAME_COUNT = 8;
 
     void setRadius(float newRadius) { radius = std::max(0.01f, newRadius); emit dirty(); }
     void setObscuranceLevel(float level) { obscuranceLevel = std::max(0.01f, level); emit dirty(); }
@@ -84,6 +115,7 @@ public:
     void setNumSamples(int samples) { numSamples = std::max(1.0f, (float)samples); emit dirty(); }
     void setResolutionLevel(int level) { resolutionLevel = std::max(0, std::min(level, MAX_RESOLUTION_LEVEL)); emit dirty(); }
     void setBlurRadius(int radius) { blurRadius = std::max(0, std::min(MAX_BLUR_RADIUS, radius)); emit dirty(); }
+    void setTemporalFrameCount(int count) { temporalFrameCount = std::max(1, std::min(MAX_TEMPORAL_FRAME_COUNT, count)); emit dirty(); }
 
     float radius{ 0.5f };
     float perspectiveScale{ 1.0f };
@@ -98,6 +130,9 @@ public:
     bool ditheringEnabled{ true }; // randomize the distribution of taps per pixel, should always be true
     bool borderingEnabled{ true }; // avoid evaluating information from non existing pixels out of the frame, should always be true
     bool fetchMipsEnabled{ true }; // fetch taps in sub mips to otpimize cache, should always be true
+    bool upsamplingEnabled{ true }; // upsample a lower resolution occlusion respecting the depth edges
+    bool temporalEnabled{ false }; // spread the samples over the frames and accumulate the reprojected occlusion
+    int temporalFrameCount{ 4 }; // number of frames the samples are spread over
 
 signals:
     void dirty();
@@ -149,6 +184,8 @@ public:
         glm::vec4 sampleInfo { 11.0f, 1.0f/11.0f, 7.0f, 1.0f };
         // Blurring info
         glm::vec4 blurInfo { 1.0f, 3.0f, 2.0f, 0.0f };
+        // Temporal info is { frameCount, weight of the current frame, enabled, spare }
+        glm::vec4 temporalInfo { 1.0f, 1.0f, 0.0f, 0.0f };
          // gaussian distribution coefficients first is the sampling radius (max is 6)
         const static int GAUSSIAN_COEFS_LENGTH = 8;
         float _gaussianCoefs[GAUSSIAN_COEFS_LENGTH];
@@ -170,6 +207,8 @@ public:
         int getBlurRadius() const { return (int)blurInfo.y; }
         bool isDitheringEnabled() const { return ditheringInfo.x; }
         bool isBorderingEnabled() const { return ditheringInfo.w; }
+        int getTemporalFrameCount() const { return (int)temporalInfo.x; }
+        bool isTemporalEnabled() const { return temporalInfo.z; }
     };
     using ParametersBuffer = gpu::UniformBuffer<Parameters>;
 
@@ -181,12 +220,21 @@ private:
     const gpu::PipelinePointer& getOcclusionPipeline();
     const gpu::PipelinePointer& getHBlurPipeline(); // first
     const gpu::PipelinePointer& getVBlurPipeline(); // second
+    const gpu::PipelinePointer& getTemporalPipeline();
+    const gpu::PipelinePointer& getUpsamplePipeline();
 
     gpu::PipelinePointer _occlusionPipeline;
     gpu::PipelinePointer _hBlurPipeline;
     gpu::PipelinePointer _vBlurPipeline;
+    gpu::PipelinePointer _temporalPipeline;
+    gpu::PipelinePointer _upsamplePipeline;
 
     AmbientOcclusionFramebufferPointer _framebuffer;
+
+    int _numSamples{ 16 };
+    bool _isUpsamplingEnabled{ true };
+    int _frameIndex{ 0 };
+    int _historyIndex{ 0 };
     
     gpu::RangeTimer _gpuTimer;
 
@@ -432,7 +432,7 @@ void DebugDeferredBuffer::run(const SceneContextPointer& sceneContext, const Ren
             batch.setResourceTexture(DiffusedCurvature, surfaceGeometryFramebuffer->getLowCurvatureTexture());
         }
         if (ambientOcclusionFramebuffer) {
-            batch.setResourceTexture(AmbientOcclusion, ambientOcclusionFramebuffer->getOcclusionTexture());
+            batch.setResourceTexture(AmbientOcclusion, ambientOcclusionFramebuffer->getOcclusionResultTexture());
             batch.setResourceTexture(AmbientOcclusionBlurred, ambientOcclusionFramebuffer->getOcclusionBlurredTexture());
         }
         const glm::vec4 color(1.0f, 1.0f, 1.0f, 1.0f);
@@ -36,6 +36,15 @@ void DeferredFrameTransform::update(RenderArgs* args) {
     cameraTransform.getMatrix(frameTransformBuffer.invView);
     cameraTransform.getInverseMatrix(frameTransformBuffer.view);
 
+    // Only the main view has a previous frame, the mirror reprojects on itself
+    if (args->_renderMode == RenderArgs::DEFAULT_RENDER_MODE) {
+        frameTransformBuffer.previousView = (_hasLastView ? _lastView : frameTransformBuffer.view);
+        _lastView = frameTransformBuffer.view;
+        _hasLastView = true;
+    } else {
+        frameTransformBuffer.previousView = frameTransformBuffer.view;
+    }
+
     args->getViewFrustum().evalProjectionMatrix(frameTransformBuffer.projectionMono);
 
     // Running in stero ?
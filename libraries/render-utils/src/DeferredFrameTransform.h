@@ -51,11 +51,16 @@ protected:
         glm::mat4 invView;
         // View matrix from world space to eye space (mono)
         glm::mat4 view;
+        // View matrix of the previous frame of the main view, to reproject the results of the previous frames
+        glm::mat4 previousView;
 
         FrameTransform() {}
     };
     UniformBufferView _frameTransformBuffer;
 
+    glm::mat4 _lastView;
+    bool _hasLastView{ false };
+
    
 };
 
@@ -13,6 +13,7 @@
 
 #include <GLMHelpers.h>
 #include <PathUtils.h>
+#include <SharedUtil.h>
 #include <ViewFrustum.h>
 
 #include <gpu/Batch.h>
@@ -37,6 +38,7 @@
 
 #include "point_light_frag.h"
 #include "spot_light_frag.h"
+#include "clustered_lights_frag.h"
 
 using namespace render;
 
@@ -71,32 +73,56 @@ enum DeferredShader_BufferSlot {
     SCATTERING_PARAMETERS_BUFFER_SLOT,
     LIGHTING_MODEL_BUFFER_SLOT = render::ShapePipeline::Slot::LIGHTING_MODEL,
     LIGHT_GPU_SLOT = render::ShapePipeline::Slot::LIGHT,
+    LIGHT_CLUSTERS_PARAMETERS_BUFFER_SLOT = 8,
+    CLUSTERED_LIGHTS_BUFFER_SLOT,
+    LIGHT_CLUSTERS_GRID_BUFFER_SLOT,
 };
 
-static void loadLightProgram(const char* vertSource, const char* fragSource, bool lightVolume, gpu::PipelinePointer& program, LightLocationsPtr& locations);
+static void loadLightProgram(const char* vertSource, const char* fragSource, const std::string& fragDefines, bool lightVolume, gpu::PipelinePointer& program, LightLocationsPtr& locations);
 
-void DeferredLightingEffect::init() {
-    _directionalLightLocations = std::make_shared<LightLocations>();
-    _directionalAmbientSphereLightLocations = std::make_shared<LightLocations>();
-    _directionalSkyboxLightLocations = std::make_shared<LightLocations>();
+struct DeferredLightingEffect::LightPrograms {
+    gpu::PipelinePointer directionalSkyboxLight;
+    gpu::PipelinePointer directionalAmbientSphereLight;
+    gpu::PipelinePointer directionalLight;
+
+    gpu::PipelinePointer directionalSkyboxLightShadow;
+    gpu::PipelinePointer directionalAmbientSphereLightShadow;
+    gpu::PipelinePointer directionalLightShadow;
 
-    _directionalLightShadowLocations = std::make_shared<LightLocations>();
-    _directionalAmbientSphereLightShadowLocations = std::make_shared<LightLocations>();
-    _directionalSkyboxLightShadowLocations = std::make_shared<LightLocations>();
+    gpu::PipelinePointer pointLight;
+    gpu::PipelinePointer spotLight;
+    gpu::PipelinePointer clusteredLights;
 
-    _pointLightLocations = std::make_shared<LightLocations>();
-    _spotLightLocations = std::make_shared<LightLocations>();
+    LightLocationsPtr directionalSkyboxLightLocations { std::make_shared<LightLocations>() };
+    LightLocationsPtr directionalAmbientSphereLightLocations { std::make_shared<LightLocations>() };
+    LightLocationsPtr directionalLightLocations { std::make_shared<LightLocations>() };
 
-    loadLightProgram(deferred_light_vert, directional_light_frag, false, _directionalLight, _directionalLightLocations);
-    loadLightProgram(deferred_light_vert, directional_ambient_light_frag, false, _directionalAmbientSphereLight, _directionalAmbientSphereLightLocations);
-    loadLightProgram(deferred_light_vert, directional_skybox_light_frag, false, _directionalSkyboxLight, _directionalSkyboxLightLocations);
+    LightLocationsPtr directionalSkyboxLightShadowLocations { std::make_shared<LightLocations>() };
+    LightLocationsPtr directionalAmbientSphereLightShadowLocations { std::make_shared<LightLocations>() };
+    LightLocationsPtr directionalLightShadowLocations { std::make_shared<LightLocations>() };
 
-    loadLightProgram(deferred_light_vert, directional_light_shadow_frag, false, _directionalLightShadow, _directionalLightShadowLocations);
-    loadLightProgram(deferred_light_vert, directional_ambient_light_shadow_frag, false, _directionalAmbientSphereLightShadow, _directionalAmbientSphereLightShadowLocations);
-    loadLightProgram(deferred_light_vert, directional_skybox_light_shadow_frag, false, _directionalSkyboxLightShadow, _directionalSkyboxLightShadowLocations);
+    LightLocationsPtr pointLightLocations { std::make_shared<LightLocations>() };
+    LightLocationsPtr spotLightLocations { std::make_shared<LightLocations>() };
+    LightLocationsPtr clusteredLightsLocations { std::make_shared<LightLocations>() };
 
-    loadLightProgram(deferred_light_limited_vert, point_light_frag, true, _pointLight, _pointLightLocations);
-    loadLightProgram(deferred_light_spot_vert, spot_light_frag, true, _spotLight, _spotLightLocations);
+    LightPrograms(const std::string& fragDefines) {
+        loadLightProgram(deferred_light_vert, directional_light_frag, fragDefines, false, directionalLight, directionalLightLocations);
+        loadLightProgram(deferred_light_vert, directional_ambient_light_frag, fragDefines, false, directionalAmbientSphereLight, directionalAmbientSphereLightLocations);
+        loadLightProgram(deferred_light_vert, directional_skybox_light_frag, fragDefines, false, directionalSkyboxLight, directionalSkyboxLightLocations);
+
+        loadLightProgram(deferred_light_vert, directional_light_shadow_frag, fragDefines, false, directionalLightShadow, directionalLightShadowLocations);
+        loadLightProgram(deferred_light_vert, directional_ambient_light_shadow_frag, fragDefines, false, directionalAmbientSphereLightShadow, directionalAmbientSphereLightShadowLocations);
+        loadLightProgram(deferred_light_vert, directional_skybox_light_shadow_frag, fragDefines, false, directionalSkyboxLightShadow, directionalSkyboxLightShadowLocations);
+
+        loadLightProgram(deferred_light_limited_vert, point_light_frag, fragDefines, true, pointLight, pointLightLocations);
+        loadLightProgram(deferred_light_spot_vert, spot_light_frag, fragDefines, true, spotLight, spotLightLocations);
+        loadLightProgram(deferred_light_vert, clustered_lights_frag, fragDefines, false, clusteredLights, clusteredLightsLocations);
+    }
+};
+
+void DeferredLightingEffect::init() {
+    // Compile the variant of the default lighting model up front
+    useLightingModel(LightingModel());
 
     // Allocate a global light representing the Global Directional light casting shadow (the sun) and the ambient light
     _globalLights.push_back(0);
@@ -161,9 +187,48 @@ void DeferredLightingEffect::setupKeyLightBatch(gpu::Batch& batch, int lightBuff
     }
 }
 
-static void loadLightProgram(const char* vertSource, const char* fragSource, bool lightVolume, gpu::PipelinePointer& pipeline, LightLocationsPtr& locations) {
+void DeferredLightingEffect::useLightingModel(const LightingModel& lightingModel) {
+    auto flags = lightingModel.getFlags();
+    if (_lightPrograms && flags == _lightProgramsFlags) {
+        return;
+    }
+
+    auto& programs = _lightProgramVariants[flags];
+    if (!programs) {
+        programs = std::make_shared<LightPrograms>(lightingModel.getShaderDefines());
+    }
+    _lightPrograms = programs;
+    _lightProgramsFlags = flags;
+
+    _directionalSkyboxLight = programs->directionalSkyboxLight;
+    _directionalAmbientSphereLight = programs->directionalAmbientSphereLight;
+    _directionalLight = programs->directionalLight;
+
+    _directionalSkyboxLightShadow = programs->directionalSkyboxLightShadow;
+    _directionalAmbientSphereLightShadow = programs->directionalAmbientSphereLightShadow;
+    _directionalLightShadow = programs->directionalLightShadow;
+
+    _pointLight = programs->pointLight;
+    _spotLight = programs->spotLight;
+    _clusteredLights = programs->clusteredLights;
+
+    _directionalSkyboxLightLocations = programs->directionalSkyboxLightLocations;
+    _directionalAmbientSphereLightLocations = programs->directionalAmbientSphereLightLocations;
+    _directionalLightLocations = programs->directionalLightLocations;
+
+    _directionalSkyboxLightShadowLocations = programs->directionalSkyboxLightShadowLocations;
+    _directionalAmbientSphereLightShadowLocations = programs->directionalAmbientSphereLightShadowLocations;
+    _directionalLightShadowLocations = programs->directionalLightShadowLocations;
+
+    _pointLightLocations = programs->pointLightLocations;
+    _spotLightLocations = programs->spotLightLocations;
+    _clusteredLightsLocations = programs->clusteredLightsLocations;
+}
+
+static void loadLightProgram(const char* vertSource, const char* fragSource, const std::string& fragDefines, bool lightVolume, gpu::PipelinePointer& pipeline, LightLocationsPtr& locations) {
     auto VS = gpu::Shader::createVertex(std::string(vertSource));
-    auto PS = gpu::Shader::createPixel(std::string(fragSource));
+    // The defines come before the scribed source, right after the version the backend puts first
+    auto PS = gpu::Shader::createPixel(fragDefines + std::string(fragSource));
     
     gpu::ShaderPointer program = gpu::Shader::createProgram(VS, PS);
 
@@ -187,6 +252,9 @@ static void loadLightProgram(const char* vertSource, const char* fragSource, boo
     slotBindings.insert(gpu::Shader::Binding(std::string("lightingModelBuffer"), LIGHTING_MODEL_BUFFER_SLOT));
     slotBindings.insert(gpu::Shader::Binding(std::string("subsurfaceScatteringParametersBuffer"), SCATTERING_PARAMETERS_BUFFER_SLOT));
     slotBindings.insert(gpu::Shader::Binding(std::string("lightBuffer"), LIGHT_GPU_SLOT));
+    slotBindings.insert(gpu::Shader::Binding(std::string("lightClustersParametersBuffer"), LIGHT_CLUSTERS_PARAMETERS_BUFFER_SLOT));
+    slotBindings.insert(gpu::Shader::Binding(std::string("clusteredLightsBuffer"), CLUSTERED_LIGHTS_BUFFER_SLOT));
+    slotBindings.insert(gpu::Shader::Binding(std::string("lightClustersGridBuffer"), LIGHT_CLUSTERS_GRID_BUFFER_SLOT));
     
 
     gpu::Shader::makeProgram(*program, slotBindings);
@@ -333,7 +401,45 @@ model::MeshPointer DeferredLightingEffect::getSpotLightMesh() {
     return _spotLightMesh;
 }
 
-void PreparePrimaryFramebuffer::run(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext, gpu::FramebufferPointer& primaryFramebuffer) {
+// The resolution scale changes by at most this much per second, proportionally to the gpu time over or under the target
+static const float RESOLUTION_SCALE_RATE_PER_MS = 0.05f;
+static const float MAX_RESOLUTION_SCALE_RATE = 0.5f;
+// Long stalls (loading, window dragged) are not meaningful frame times
+static const float MAX_RESOLUTION_UPDATE_DT = 0.1f;
+
+PreparePrimaryFramebuffer::PreparePrimaryFramebuffer() {
+    _resolutionController.setKP(RESOLUTION_SCALE_RATE_PER_MS);
+    _resolutionController.setControlledValueLowLimit(-MAX_RESOLUTION_SCALE_RATE);
+    _resolutionController.setControlledValueHighLimit(MAX_RESOLUTION_SCALE_RATE);
+}
+
+void PreparePrimaryFramebuffer::configure(const Config& config) {
+    _dynamicResolution = config.dynamicResolution;
+    _minResolutionScale = glm::clamp(config.minResolutionScale, 0.1f, 1.0f);
+    _resolutionController.setMeasuredValueSetpoint(config.targetGPUTime);
+
+    if (!_dynamicResolution) {
+        _resolutionScale = 1.0f;
+        _lastUpdateTime = 0;
+    }
+}
+
+void PreparePrimaryFramebuffer::updateResolutionScale(float gpuTime) {
+    auto now = usecTimestampNow();
+    if (_lastUpdateTime != 0 && now > _lastUpdateTime) {
+        float dt = std::min((float)(now - _lastUpdateTime) / (float)USECS_PER_SECOND, MAX_RESOLUTION_UPDATE_DT);
+
+        // The controller gives the rate of change of the scale, integrating it here keeps the scale where it was
+        // once the gpu time reaches the target
+        float rate = _resolutionController.update(gpuTime, dt);
+        _resolutionScale = glm::clamp(_resolutionScale + rate * dt, _minResolutionScale, 1.0f);
+    }
+    _lastUpdateTime = now;
+}
+
+void PreparePrimaryFramebuffer::run(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext, const Inputs& inputs, Outputs& outputs) {
+    auto args = renderContext->args;
+    auto config = std::static_pointer_cast<Config>(renderContext->jobConfig);
 
     auto framebufferCache = DependencyManager::get<FramebufferCache>();
     auto framebufferSize = framebufferCache->getFrameBufferSize();
@@ -362,7 +468,25 @@ void PreparePrimaryFramebuffer::run(const SceneContextPointer& sceneContext, con
         _primaryFramebuffer->setDepthStencilBuffer(primaryDepthTexture, depthFormat);
     }
 
-    primaryFramebuffer = _primaryFramebuffer;
+    outputs.edit0() = _primaryFramebuffer;
+    outputs.edit1() = args->_viewport;
+
+    // Only the main view is scaled, the mirror is small already and its gpu time is not the one the frame rate depends on
+    float resolutionScale = 1.0f;
+    if (_dynamicResolution && args->_renderMode == RenderArgs::DEFAULT_RENDER_MODE) {
+        // The timer only returns the gpu time a few frames later, the scale is driven by that recent average
+        updateResolutionScale((float)inputs->getGPUAverage());
+        resolutionScale = _resolutionScale;
+    }
+
+    // Render in the lower corner of the primary framebuffer, the Blit upscales the result to the display viewport.
+    // The framebuffers stay the same size so changing the scale every frame does not reallocate them.
+    if (resolutionScale < 1.0f) {
+        // Keep the width even for the stereo views to split it evenly
+        args->_viewport.z = std::max(2 * (int)(0.5f * resolutionScale * (float)args->_viewport.z), 2);
+        args->_viewport.w = std::max((int)(resolutionScale * (float)args->_viewport.w), 1);
+    }
+    config->setResolutionScale(resolutionScale);
 }
 
 void PrepareDeferred::run(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext, const Inputs& inputs, Outputs& outputs) {
@@ -411,6 +535,10 @@ void RenderDeferredSetup::run(const render::SceneContextPointer& sceneContext, c
     const SubsurfaceScatteringResourcePointer& subsurfaceScatteringResource) {
     
     auto args = renderContext->args;
+
+    // Switch to the light pipelines specialized for the lighting model, for this pass and the local lights after it
+    DependencyManager::get<DeferredLightingEffect>()->useLightingModel(*lightingModel);
+
     gpu::doInBatch(args->_context, [&](gpu::Batch& batch) {
         
         // Framebuffer copy operations cannot function as multipass stereo operations.
@@ -438,7 +566,7 @@ void RenderDeferredSetup::run(const render::SceneContextPointer& sceneContext, c
         
         // FIXME: Different render modes should have different tasks
         if (args->_renderMode == RenderArgs::DEFAULT_RENDER_MODE && deferredLightingEffect->isAmbientOcclusionEnabled()) {
-            batch.setResourceTexture(DEFERRED_BUFFER_OBSCURANCE_UNIT, ambientOcclusionFramebuffer->getOcclusionTexture());
+            batch.setResourceTexture(DEFERRED_BUFFER_OBSCURANCE_UNIT, ambientOcclusionFramebuffer->getOcclusionResultTexture());
         } else {
             // need to assign the white texture if ao is off
             batch.setResourceTexture(DEFERRED_BUFFER_OBSCURANCE_UNIT, textureCache->getWhiteTexture());
@@ -569,6 +697,39 @@ void RenderDeferredLocals::run(const render::SceneContextPointer& sceneContext,
 
         auto textureFrameTransform = gpu::Framebuffer::evalSubregionTexcoordTransformCoefficients(deferredFramebuffer->getFrameSize(), monoViewport);
 
+        // With many lights, bin them in clusters of the mono frustum and light each pixel with its cluster's lights only
+        size_t numLocalLights = (points ? deferredLightingEffect->_pointLights.size() : 0) +
+            (spots ? deferredLightingEffect->_spotLights.size() : 0);
+        if (numLocalLights >= DeferredLightingEffect::CLUSTERED_LIGHTS_THRESHOLD) {
+            LightClusters::Lights lights;
+            lights.reserve(numLocalLights);
+            if (points) {
+                for (auto lightID : deferredLightingEffect->_pointLights) {
+                    lights.push_back(deferredLightingEffect->_allocatedLights[lightID]);
+                }
+            }
+            if (spots) {
+                for (auto lightID : deferredLightingEffect->_spotLights) {
+                    lights.push_back(deferredLightingEffect->_allocatedLights[lightID]);
+                }
+            }
+
+            auto& lightClusters = deferredLightingEffect->_lightClusters;
+            lightClusters.setFrustum(glm::inverse(monoViewMat), monoProjMat, viewFrustum.getNearClip());
+            lightClusters.updateLights(lights);
+
+            batch.setPipeline(deferredLightingEffect->_clusteredLights);
+            batch._glUniform4fv(deferredLightingEffect->_clusteredLightsLocations->texcoordFrameTransform, 1, reinterpret_cast< const float* >(&textureFrameTransform));
+            batch.setUniformBuffer(LIGHT_CLUSTERS_PARAMETERS_BUFFER_SLOT, lightClusters.getParametersBuffer());
+
+            for (size_t pass = 0; pass < lightClusters.getNumPasses(); ++pass) {
+                batch.setUniformBuffer(CLUSTERED_LIGHTS_BUFFER_SLOT, lightClusters.getLightsBuffer(pass));
+                batch.setUniformBuffer(LIGHT_CLUSTERS_GRID_BUFFER_SLOT, lightClusters.getGridBuffer(pass));
+                batch.draw(gpu::TRIANGLE_STRIP, 4);
+            }
+            return;
+        }
+
         batch.setProjectionTransform(monoProjMat);
         batch.setViewTransform(monoViewTransform, true);
 
@@ -673,6 +834,9 @@ void RenderDeferredCleanup::run(const render::SceneContextPointer& sceneContext,
         batch.setResourceTexture(SCATTERING_SPECULAR_UNIT, nullptr);
         
         batch.setUniformBuffer(SCATTERING_PARAMETERS_BUFFER_SLOT, nullptr);
+        batch.setUniformBuffer(LIGHT_CLUSTERS_PARAMETERS_BUFFER_SLOT, nullptr);
+        batch.setUniformBuffer(CLUSTERED_LIGHTS_BUFFER_SLOT, nullptr);
+        batch.setUniformBuffer(LIGHT_CLUSTERS_GRID_BUFFER_SLOT, nullptr);
    //     batch.setUniformBuffer(LIGHTING_MODEL_BUFFER_SLOT, nullptr);
         batch.setUniformBuffer(DEFERRED_FRAME_TRANSFORM_BUFFER_SLOT, nullptr);
     });
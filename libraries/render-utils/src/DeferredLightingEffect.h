@@ -12,10 +12,13 @@
 #ifndef hifi_DeferredLightingEffect_h
 #define hifi_DeferredLightingEffect_h
 
+#include <unordered_map>
+
 #include <QVector>
 
 #include <DependencyManager.h>
 #include <NumericalConstants.h>
+#include <PIDController.h>
 
 #include "model/Light.h"
 #include "model/Geometry.h"
@@ -28,6 +31,7 @@
 #include "LightingModel.h"
 
 #include "LightStage.h"
+#include "LightClusters.h"
 #include "SurfaceGeometryPass.h"
 #include "SubsurfaceScattering.h"
 #include "AmbientOcclusionEffect.h"
@@ -41,6 +45,9 @@ class DeferredLightingEffect : public Dependency {
     SINGLETON_DEPENDENCY
     
 public:
+    // From this many local lights on, they are binned in clusters and applied in full screen passes
+    static const size_t CLUSTERED_LIGHTS_THRESHOLD = 32;
+
     void init();
     
     /// Adds a point light to render for the current frame.
@@ -83,6 +90,7 @@ private:
 
     gpu::PipelinePointer _pointLight;
     gpu::PipelinePointer _spotLight;
+    gpu::PipelinePointer _clusteredLights;
 
     LightLocationsPtr _directionalSkyboxLightLocations;
     LightLocationsPtr _directionalAmbientSphereLightLocations;
@@ -94,6 +102,18 @@ private:
 
     LightLocationsPtr _pointLightLocations;
     LightLocationsPtr _spotLightLocations;
+    LightLocationsPtr _clusteredLightsLocations;
+
+    // The light pipelines above are the variant specialized for the flags of the LightingModel last used,
+    // the variants are compiled the first time their flags are used
+    struct LightPrograms;
+    using LightProgramsPointer = std::shared_ptr<LightPrograms>;
+    std::unordered_map<LightingModel::Flags, LightProgramsPointer> _lightProgramVariants;
+    LightProgramsPointer _lightPrograms;
+    LightingModel::Flags _lightProgramsFlags { 0 };
+    void useLightingModel(const LightingModel& lightingModel);
+
+    LightClusters _lightClusters;
 
     using Lights = std::vector<model::LightPointer>;
 
@@ -107,13 +127,53 @@ private:
     friend class RenderDeferredCleanup;
 };
 
+class PreparePrimaryFramebufferConfig : public render::Job::Config {
+    Q_OBJECT
+    Q_PROPERTY(bool dynamicResolution MEMBER dynamicResolution NOTIFY dirty)
+    Q_PROPERTY(float targetGPUTime MEMBER targetGPUTime NOTIFY dirty)
+    Q_PROPERTY(float minResolutionScale MEMBER minResolutionScale NOTIFY dirty)
+    Q_PROPERTY(float resolutionScale READ getResolutionScale NOTIFY newStats)
+public:
+    float getResolutionScale() const { return _resolutionScale; }
+    void setResolutionScale(float scale) { _resolutionScale = scale; emit newStats(); }
+
+    bool dynamicResolution{ true };
+    float targetGPUTime{ 1000.0f / 90.0f }; // in ms, the HMD frame rate by default
+    float minResolutionScale{ 0.5f };
+
+signals:
+    void dirty();
+    void newStats();
+
+protected:
+    float _resolutionScale{ 1.0f };
+};
+
 class PreparePrimaryFramebuffer {
 public:
-    using JobModel = render::Job::ModelO<PreparePrimaryFramebuffer, gpu::FramebufferPointer>;
+    // Input: the gpu timer of the full frame
+    using Inputs = gpu::RangeTimerPointer;
+    // Outputs: primaryFramebuffer and the viewport of the display to upscale the frame to
+    using Outputs = render::VaryingSet2<gpu::FramebufferPointer, glm::ivec4>;
+    using Config = PreparePrimaryFramebufferConfig;
+    using JobModel = render::Job::ModelIO<PreparePrimaryFramebuffer, Inputs, Outputs, Config>;
+
+    PreparePrimaryFramebuffer();
 
-    void run(const render::SceneContextPointer& sceneContext, const render::RenderContextPointer& renderContext, gpu::FramebufferPointer& primaryFramebuffer);
+    void configure(const Config& config);
+    void run(const render::SceneContextPointer& sceneContext, const render::RenderContextPointer& renderContext, const Inputs& inputs, Outputs& outputs);
 
     gpu::FramebufferPointer _primaryFramebuffer;
+
+protected:
+    void updateResolutionScale(float gpuTime);
+
+    // Drives the rate of change of the resolution scale from the gpu time of the frame
+    PIDController _resolutionController;
+    quint64 _lastUpdateTime{ 0 };
+    float _resolutionScale{ 1.0f };
+    float _minResolutionScale{ 0.5f };
+    bool _dynamicResolution{ true };
 };
 
 class PrepareDeferred {
@@ -0,0 +1,139 @@
+//
+//  LightClusters.cpp
+//  render-utils/src
+//
+//  Created by Sam Gateau on 10/15/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "LightClusters.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+const float LightClusters::FAR_DEPTH = 100.0f;
+
+LightClusters::LightClusters() {
+    Parameters parameters;
+    _parametersBuffer = gpu::BufferView(std::make_shared<gpu::Buffer>(sizeof(Parameters), (const gpu::Byte*) &parameters));
+}
+
+LightClusters::Pass::Pass() {
+    lightsBuffer = gpu::BufferView(std::make_shared<gpu::Buffer>(sizeof(LightsSchema), nullptr));
+    gridBuffer = gpu::BufferView(std::make_shared<gpu::Buffer>(sizeof(GridSchema), nullptr));
+}
+
+void LightClusters::setFrustum(const glm::mat4& view, const glm::mat4& projection, float nearDepth) {
+    _parameters.view = view;
+    _parameters.projection = projection;
+
+    float nearSlice = std::min(nearDepth, FAR_DEPTH * 0.5f);
+    _parameters.depths = glm::vec4(nearSlice, FAR_DEPTH, (float)GRID_DEPTH / logf(FAR_DEPTH / nearSlice), 0.0f);
+
+    _parametersBuffer.edit<Parameters>() = _parameters;
+}
+
+int LightClusters::evalSlice(float depth) const {
+    if (depth <= _parameters.depths.x) {
+        return 0;
+    }
+    int slice = (int)(logf(depth / _parameters.depths.x) * _parameters.depths.z);
+    return std::min(slice, GRID_DEPTH - 1);
+}
+
+bool LightClusters::evalLightClusters(const model::LightPointer& light, glm::ivec3& low, glm::ivec3& high) const {
+    // The spots are binned by the sphere bounding their cone
+    glm::vec3 center = glm::vec3(_parameters.view * glm::vec4(light->getPosition(), 1.0f));
+    float radius = light->getMaximumRadius();
+
+    float nearDepth = -center.z - radius;
+    float farDepth = -center.z + radius;
+    if (farDepth < _parameters.depths.x) {
+        return false;
+    }
+    low.z = evalSlice(nearDepth);
+    high.z = evalSlice(farDepth);
+
+    // A light reaching the near plane can cover any pixel
+    if (nearDepth <= _parameters.depths.x) {
+        low.x = 0;
+        low.y = 0;
+        high.x = GRID_WIDTH - 1;
+        high.y = GRID_HEIGHT - 1;
+        return true;
+    }
+
+    // Otherwise project the corners of the box bounding the light, they are all in front of the eye
+    glm::vec2 ndcMin(1.0f);
+    glm::vec2 ndcMax(-1.0f);
+    for (int i = 0; i < 8; ++i) {
+        glm::vec3 corner = center + radius * glm::vec3((i & 1) ? 1.0f : -1.0f, (i & 2) ? 1.0f : -1.0f, (i & 4) ? 1.0f : -1.0f);
+        glm::vec4 clip = _parameters.projection * glm::vec4(corner, 1.0f);
+        glm::vec2 ndc = glm::vec2(clip) / clip.w;
+        ndcMin = glm::min(ndcMin, ndc);
+        ndcMax = glm::max(ndcMax, ndc);
+    }
+    if (ndcMax.x < -1.0f || ndcMax.y < -1.0f || ndcMin.x > 1.0f || ndcMin.y > 1.0f) {
+        return false;
+    }
+
+    glm::vec2 dimensions((float)GRID_WIDTH, (float)GRID_HEIGHT);
+    glm::ivec2 lowTile = glm::ivec2(glm::floor((ndcMin * 0.5f + 0.5f) * dimensions));
+    glm::ivec2 highTile = glm::ivec2(glm::floor((ndcMax * 0.5f + 0.5f) * dimensions));
+    low.x = std::max(lowTile.x, 0);
+    low.y = std::max(lowTile.y, 0);
+    high.x = std::min(highTile.x, GRID_WIDTH - 1);
+    high.y = std::min(highTile.y, GRID_HEIGHT - 1);
+    return true;
+}
+
+void LightClusters::updateLights(const Lights& lights) {
+    _numPasses = 0;
+
+    GridSchema* grid = nullptr;
+    LightsSchema* passLights = nullptr;
+    int numPassLights = MAX_LIGHTS_PER_PASS;
+
+    for (const auto& light : lights) {
+        glm::ivec3 low;
+        glm::ivec3 high;
+        if (!evalLightClusters(light, low, high)) {
+            continue;
+        }
+
+        // Start a new pass once the current one is full
+        if (numPassLights == MAX_LIGHTS_PER_PASS) {
+            if (_numPasses == _passes.size()) {
+                _passes.emplace_back();
+            }
+            auto& pass = _passes[_numPasses++];
+            grid = &pass.gridBuffer.edit<GridSchema>();
+            passLights = &pass.lightsBuffer.edit<LightsSchema>();
+            memset(grid, 0, sizeof(GridSchema));
+            numPassLights = 0;
+        }
+
+        const auto& schema = light->getSchemaBuffer().get<model::Light::Schema>();
+        auto& clusteredLight = passLights->lights[numPassLights];
+        clusteredLight.position = glm::vec4(glm::vec3(schema._position), (float)light->getType());
+        clusteredLight.direction = glm::vec4(schema._direction, schema._ambientIntensity);
+        clusteredLight.color = glm::vec4(schema._color, schema._intensity);
+        clusteredLight.attenuation = schema._attenuation;
+        clusteredLight.spot = schema._spot;
+
+        int component = numPassLights / 32;
+        glm::uint bit = 1u << (numPassLights % 32);
+        for (int z = low.z; z <= high.z; ++z) {
+            for (int y = low.y; y <= high.y; ++y) {
+                for (int x = low.x; x <= high.x; ++x) {
+                    grid->clusters[x + GRID_WIDTH * (y + GRID_HEIGHT * z)][component] |= bit;
+                }
+            }
+        }
+        ++numPassLights;
+    }
+}
@@ -0,0 +1,101 @@
+//
+//  LightClusters.h
+//  render-utils/src
+//
+//  Created by Sam Gateau on 10/15/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_render_utils_LightClusters_h
+#define hifi_render_utils_LightClusters_h
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "gpu/Resource.h"
+
+#include "model/Light.h"
+
+// Bins the local lights of a frame into a grid of clusters slicing the view frustum, so one full screen pass lights
+// each fragment with only the lights reaching its cluster instead of drawing a light volume per light.
+// A cluster holds one bit per light, so the lights are applied in passes of MAX_LIGHTS_PER_PASS lights each.
+// The layouts below match the ones declared in clustered_lights.slf.
+class LightClusters {
+public:
+    static const int GRID_WIDTH = 16;
+    static const int GRID_HEIGHT = 9;
+    static const int GRID_DEPTH = 6;
+    static const int NUM_CLUSTERS = GRID_WIDTH * GRID_HEIGHT * GRID_DEPTH;
+    static const int MAX_LIGHTS_PER_PASS = 128;
+
+    // The depth slices grow exponentially up to this depth, the last one runs to the far clip
+    static const float FAR_DEPTH;
+
+    using UniformBufferView = gpu::BufferView;
+    using Lights = std::vector<model::LightPointer>;
+
+    LightClusters();
+
+    void setFrustum(const glm::mat4& view, const glm::mat4& projection, float nearDepth);
+
+    // Bins the lights against the frustum last set, the lights outside of it are left out
+    void updateLights(const Lights& lights);
+
+    size_t getNumPasses() const { return _numPasses; }
+    const UniformBufferView& getParametersBuffer() const { return _parametersBuffer; }
+    const UniformBufferView& getLightsBuffer(size_t pass) const { return _passes[pass].lightsBuffer; }
+    const UniformBufferView& getGridBuffer(size_t pass) const { return _passes[pass].gridBuffer; }
+
+protected:
+    class Parameters {
+    public:
+        glm::mat4 view;
+        glm::mat4 projection;
+        glm::vec4 dimensions { (float)GRID_WIDTH, (float)GRID_HEIGHT, (float)GRID_DEPTH, 0.0f };
+        // near depth, far depth and the number of slices per log unit of depth
+        glm::vec4 depths { 0.1f, FAR_DEPTH, 0.0f, 0.0f };
+    };
+
+    class ClusteredLight {
+    public:
+        glm::vec4 position; // w is the light type
+        glm::vec4 direction;
+        glm::vec4 color;
+        glm::vec4 attenuation;
+        glm::vec4 spot;
+    };
+
+    class LightsSchema {
+    public:
+        ClusteredLight lights[MAX_LIGHTS_PER_PASS];
+    };
+
+    // One bit per light of the pass
+    class GridSchema {
+    public:
+        glm::uvec4 clusters[NUM_CLUSTERS];
+    };
+
+    class Pass {
+    public:
+        Pass();
+
+        UniformBufferView lightsBuffer;
+        UniformBufferView gridBuffer;
+    };
+
+    int evalSlice(float depth) const;
+    bool evalLightClusters(const model::LightPointer& light, glm::ivec3& low, glm::ivec3& high) const;
+
+    Parameters _parameters;
+    UniformBufferView _parametersBuffer;
+
+    std::vector<Pass> _passes;
+    size_t _numPasses { 0 };
+};
+
+#endif
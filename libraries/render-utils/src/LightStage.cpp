@@ -13,18 +13,84 @@
 
 #include "LightStage.h"
 
-LightStage::Shadow::Shadow(model::LightPointer light) : _light{ light}, _frustum{ std::make_shared<ViewFrustum>() } {
-    framebuffer = gpu::FramebufferPointer(gpu::Framebuffer::createShadowmap(MAP_SIZE));
+// The part of the fitted bounds added around them, so the view can move a bit before a cascade has to follow
+const float CASCADE_MARGIN = 0.1f;
+
+static gpu::FramebufferPointer createDepthFramebuffer(const std::string& name, gpu::uint16 width, gpu::uint16 height, bool shadowSampler) {
+    auto framebuffer = gpu::FramebufferPointer(gpu::Framebuffer::create(name));
+
+    auto depthFormat = gpu::Element(gpu::SCALAR, gpu::FLOAT, gpu::DEPTH); // Depth32 texel format
+    gpu::Sampler::Desc samplerDesc;
+    if (shadowSampler) {
+        samplerDesc._borderColor = glm::vec4(1.0f);
+        samplerDesc._wrapModeU = gpu::Sampler::WRAP_BORDER;
+        samplerDesc._wrapModeV = gpu::Sampler::WRAP_BORDER;
+        samplerDesc._filter = gpu::Sampler::FILTER_MIN_MAG_LINEAR;
+        samplerDesc._comparisonFunc = gpu::LESS_EQUAL;
+    } else {
+        samplerDesc._filter = gpu::Sampler::FILTER_MIN_MAG_POINT;
+    }
+    auto depthTexture = gpu::TexturePointer(gpu::Texture::create2D(depthFormat, width, height, gpu::Sampler(samplerDesc)));
+    framebuffer->setDepthStencilBuffer(depthTexture, depthFormat);
+
+    return framebuffer;
+}
+
+LightStage::Shadow::Cascade::Cascade(int index) :
+    _frustum{ std::make_shared<ViewFrustum>() },
+    _viewport{ index * MAP_SIZE, 0, (int)MAP_SIZE, (int)MAP_SIZE } {
+    cacheFramebuffer = createDepthFramebuffer("shadowCache", MAP_SIZE, MAP_SIZE, false);
+    cacheMap = cacheFramebuffer->getDepthStencilBuffer();
+}
+
+const glm::mat4& LightStage::Shadow::Cascade::getView() const {
+    return _frustum->getView();
+}
+
+const glm::mat4& LightStage::Shadow::Cascade::getProjection() const {
+    return _frustum->getProjection();
+}
+
+LightStage::Shadow::Shadow(model::LightPointer light) : _light{ light} {
+    framebuffer = createDepthFramebuffer("shadowmap", MAP_SIZE * NUM_CASCADES, MAP_SIZE, true);
     map = framebuffer->getDepthStencilBuffer();
+    for (int i = 0; i < NUM_CASCADES; ++i) {
+        _cascades.emplace_back(i);
+    }
     Schema schema;
     _schemaBuffer = std::make_shared<gpu::Buffer>(sizeof(Schema), (const gpu::Byte*) &schema);
 }
 
-void LightStage::Shadow::setKeylightFrustum(const ViewFrustum& viewFrustum, float nearDepth, float farDepth) {
+void LightStage::Shadow::setKeylightFrustum(int cascadeIndex, const ViewFrustum& viewFrustum, float nearDepth, float farDepth) {
     assert(nearDepth < farDepth);
+    auto& cascade = _cascades[cascadeIndex];
+    const auto& frustum = cascade._frustum;
 
-    // Orient the keylight frustum
     const auto& direction = glm::normalize(_light->getDirection());
+    auto nearCorners = viewFrustum.getCorners(nearDepth);
+    auto farCorners = viewFrustum.getCorners(farDepth);
+    const vec3 viewCorners[8] = {
+        nearCorners.bottomLeft, nearCorners.bottomRight, nearCorners.topLeft, nearCorners.topRight,
+        farCorners.bottomLeft, farCorners.bottomRight, farCorners.topLeft, farCorners.topRight
+    };
+
+    // Keep the cascade in place while the light did not turn and the cascade still holds this part of the view
+    if (direction == cascade._direction && cascade._min.x < cascade._max.x) {
+        const Transform viewInverse{ Transform(cascade.getView()).getInverseMatrix() };
+        bool isContained = true;
+        for (const auto& viewCorner : viewCorners) {
+            const auto corner = viewInverse.transform(viewCorner);
+            if (glm::any(glm::lessThan(corner, cascade._min)) || glm::any(glm::greaterThan(corner, cascade._max))) {
+                isContained = false;
+                break;
+            }
+        }
+        if (isContained) {
+            return;
+        }
+    }
+
+    // Orient the keylight frustum
     glm::quat orientation;
     if (direction == IDENTITY_UP) {
         orientation = glm::quat(glm::mat3(-IDENTITY_RIGHT, IDENTITY_FRONT, -IDENTITY_UP));
@@ -35,56 +101,39 @@ void LightStage::Shadow::setKeylightFrustum(const ViewFrustum& viewFrustum, floa
         auto up = glm::normalize(glm::cross(side, direction));
         orientation = glm::quat_cast(glm::mat3(side, up, -direction));
     }
-    _frustum->setOrientation(orientation);
+    frustum->setOrientation(orientation);
 
     // Position the keylight frustum
-    _frustum->setPosition(viewFrustum.getPosition() - (nearDepth + farDepth)*direction);
+    frustum->setPosition(viewFrustum.getPosition() - (nearDepth + farDepth)*direction);
 
-    const Transform view{ _frustum->getView()};
+    const Transform view{ frustum->getView()};
     const Transform viewInverse{ view.getInverseMatrix() };
 
-    auto nearCorners = viewFrustum.getCorners(nearDepth);
-    auto farCorners = viewFrustum.getCorners(farDepth);
-
-    vec3 min{ viewInverse.transform(nearCorners.bottomLeft) };
+    vec3 min{ viewInverse.transform(viewCorners[0]) };
     vec3 max{ min };
     // Expand keylight frustum  to fit view frustum
-    auto fitFrustum = [&min, &max, &viewInverse](const vec3& viewCorner) {
+    for (const auto& viewCorner : viewCorners) {
         const auto corner = viewInverse.transform(viewCorner);
-
-        min.x = glm::min(min.x, corner.x);
-        min.y = glm::min(min.y, corner.y);
-        min.z = glm::min(min.z, corner.z);
-
-        max.x = glm::max(max.x, corner.x);
-        max.y = glm::max(max.y, corner.y);
-        max.z = glm::max(max.z, corner.z);
-    };
-    fitFrustum(nearCorners.bottomRight);
-    fitFrustum(nearCorners.topLeft);
-    fitFrustum(nearCorners.topRight);
-    fitFrustum(farCorners.bottomLeft);
-    fitFrustum(farCorners.bottomRight);
-    fitFrustum(farCorners.topLeft);
-    fitFrustum(farCorners.topRight);
+        min = glm::min(min, corner);
+        max = glm::max(max, corner);
+    }
+    vec3 margin = CASCADE_MARGIN * (max - min);
+    min -= margin;
+    max += margin;
 
     glm::mat4 ortho = glm::ortho<float>(min.x, max.x, min.y, max.y, -max.z, -min.z);
-    _frustum->setProjection(ortho);
+    frustum->setProjection(ortho);
 
     // Calculate the frustum's internal state
-    _frustum->calculate();
+    frustum->calculate();
 
-    // Update the buffer
-    _schemaBuffer.edit<Schema>().projection = ortho;
-    _schemaBuffer.edit<Schema>().viewInverse = viewInverse.getMatrix();
-}
+    cascade._direction = direction;
+    cascade._min = min;
+    cascade._max = max;
+    cascade.isCacheValid = false;
 
-const glm::mat4& LightStage::Shadow::getView() const {
-    return _frustum->getView();
-}
-
-const glm::mat4& LightStage::Shadow::getProjection() const {
-    return _frustum->getProjection();
+    // Update the buffer
+    _schemaBuffer.edit<Schema>().reprojection[cascadeIndex] = ortho * viewInverse.getMatrix();
 }
 
 const LightStage::LightPointer LightStage::addLight(model::LightPointer light) {
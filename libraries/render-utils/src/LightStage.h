@@ -12,6 +12,8 @@
 #ifndef hifi_render_utils_LightStage_h
 #define hifi_render_utils_LightStage_h
 
+#include <vector>
+
 #include "gpu/Framebuffer.h"
 
 #include "model/Light.h"
@@ -26,14 +28,48 @@ public:
         using UniformBufferView = gpu::BufferView;
         static const int MAP_SIZE = 1024;
 
-        Shadow(model::LightPointer light);
+        // The cascades split the view depth, each in its own MAP_SIZE square of the map, side by side
+        static const int NUM_CASCADES = 3;
+
+        class Cascade {
+        public:
+            Cascade(int index);
+
+            const std::shared_ptr<ViewFrustum>& getFrustum() const { return _frustum; }
+            const glm::mat4& getView() const;
+            const glm::mat4& getProjection() const;
+
+            const glm::ivec4& getViewport() const { return _viewport; }
+
+            // The depth of the static casters, kept across frames while the cascade stays in place
+            gpu::FramebufferPointer cacheFramebuffer;
+            gpu::TexturePointer cacheMap;
+            bool isCacheValid { false };
+            uint32_t cacheFrame { 0 };
 
-        void setKeylightFrustum(const ViewFrustum& viewFrustum, float nearDepth, float farDepth);
+            // Whether the cascade's part of the map holds casters drawn over the cache
+            bool hasDynamicCasters { true };
+
+        protected:
+            std::shared_ptr<ViewFrustum> _frustum;
+            glm::ivec4 _viewport;
+
+            // The light direction and light space bounds the frustum was fitted for
+            glm::vec3 _direction;
+            glm::vec3 _min;
+            glm::vec3 _max;
+
+            friend class Shadow;
+        };
+
+        Shadow(model::LightPointer light);
 
-        const std::shared_ptr<ViewFrustum> getFrustum() const { return _frustum; }
+        // Fits the cascade to the view frustum between the depths.
+        // The cascade stays in place while it still holds that part of the view frustum, the cache is dropped when it moves
+        void setKeylightFrustum(int cascade, const ViewFrustum& viewFrustum, float nearDepth, float farDepth);
 
-        const glm::mat4& getView() const;
-        const glm::mat4& getProjection() const;
+        Cascade& getCascade(int cascade) { return _cascades[cascade]; }
+        const Cascade& getCascade(int cascade) const { return _cascades[cascade]; }
 
         const UniformBufferView& getBuffer() const { return _schemaBuffer; }
 
@@ -41,15 +77,16 @@ public:
         gpu::TexturePointer map;
     protected:
         model::LightPointer _light;
-        std::shared_ptr<ViewFrustum> _frustum;
+        std::vector<Cascade> _cascades;
 
         class Schema {
         public:
-            glm::mat4 projection;
-            glm::mat4 viewInverse;
+            // from world space to each cascade's clip space
+            glm::mat4 reprojection[NUM_CASCADES];
 
             glm::float32 bias = 0.005f;
             glm::float32 scale = 1 / MAP_SIZE;
+            glm::vec2 spare;
         };
         UniformBufferView _schemaBuffer = nullptr;
         
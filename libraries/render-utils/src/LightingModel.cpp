@@ -15,6 +15,48 @@ LightingModel::LightingModel() {
     _parametersBuffer = gpu::BufferView(std::make_shared<gpu::Buffer>(sizeof(Parameters), (const gpu::Byte*) &parameters));
 }
 
+LightingModel::Flags LightingModel::getFlags() const {
+    const auto& parameters = _parametersBuffer.get<Parameters>();
+    const float values[] = {
+        parameters.enableUnlit, parameters.enableEmissive, parameters.enableLightmap, parameters.enableBackground,
+        parameters.enableObscurance,
+        parameters.enableScattering, parameters.enableDiffuse, parameters.enableSpecular, parameters.enableAlbedo,
+        parameters.enableAmbientLight, parameters.enableDirectionalLight, parameters.enablePointLight, parameters.enableSpotLight,
+        parameters.showLightContour
+    };
+
+    Flags flags = 0;
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); ++i) {
+        if (values[i] != 0.0f) {
+            flags |= (Flags)(1 << i);
+        }
+    }
+    return flags;
+}
+
+std::string LightingModel::getShaderDefines() const {
+    const auto& parameters = _parametersBuffer.get<Parameters>();
+    auto define = [](const char* name, float value) {
+        return std::string("#define ") + name + ((value != 0.0f) ? " 1.0\n" : " 0.0\n");
+    };
+
+    return std::string("#define LIGHTING_MODEL_STATIC\n") +
+        define("LIGHTING_MODEL_UNLIT", parameters.enableUnlit) +
+        define("LIGHTING_MODEL_EMISSIVE", parameters.enableEmissive) +
+        define("LIGHTING_MODEL_LIGHTMAP", parameters.enableLightmap) +
+        define("LIGHTING_MODEL_BACKGROUND", parameters.enableBackground) +
+        define("LIGHTING_MODEL_OBSCURANCE", parameters.enableObscurance) +
+        define("LIGHTING_MODEL_SCATTERING", parameters.enableScattering) +
+        define("LIGHTING_MODEL_DIFFUSE", parameters.enableDiffuse) +
+        define("LIGHTING_MODEL_SPECULAR", parameters.enableSpecular) +
+        define("LIGHTING_MODEL_ALBEDO", parameters.enableAlbedo) +
+        define("LIGHTING_MODEL_AMBIENT", parameters.enableAmbientLight) +
+        define("LIGHTING_MODEL_DIRECTIONAL", parameters.enableDirectionalLight) +
+        define("LIGHTING_MODEL_POINT", parameters.enablePointLight) +
+        define("LIGHTING_MODEL_SPOT", parameters.enableSpotLight) +
+        define("LIGHTING_MODEL_SHOW_LIGHT_CONTOUR", parameters.showLightContour);
+}
+
 void LightingModel::setUnlit(bool enable) {
     if (enable != isUnlitEnabled()) {
         _parametersBuffer.edit<Parameters>().enableUnlit = (float) enable;
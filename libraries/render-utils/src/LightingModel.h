@@ -12,6 +12,8 @@
 #ifndef hifi_LightingModel_h
 #define hifi_LightingModel_h
 
+#include <string>
+
 #include "gpu/Resource.h"
 #include "render/DrawTask.h"
 
@@ -64,6 +66,13 @@ public:
 
     UniformBufferView getParametersBuffer() const { return _parametersBuffer; }
 
+    // One bit per flag, the key of the shader variants specialized for the flags
+    using Flags = uint16_t;
+    Flags getFlags() const;
+
+    // Defining LIGHTING_MODEL_STATIC and the flags as constants, for the shaders of a specialized variant
+    std::string getShaderDefines() const;
+
 protected:
 
 
@@ -41,9 +41,23 @@ template <> const ShapeKey shapeGetShapeKey(const MeshPartPayload::Pointer& payl
     return ShapeKey::Builder::invalid();
 }
 
+template <> uint32_t shapeGetStateSortKey(const MeshPartPayload::Pointer& payload) {
+    if (payload) {
+        return payload->getStateSortKey();
+    }
+    return 0;
+}
+
 template <> void payloadRender(const MeshPartPayload::Pointer& payload, RenderArgs* args) {
     return payload->render(args);
 }
+
+template <> void payloadUpdateTransform(const MeshPartPayload::Pointer& payload, const Transform& transform,
+                                        const Transform& offset) {
+    if (payload) {
+        payload->updateTransform(transform, offset);
+    }
+}
 }
 
 MeshPartPayload::MeshPartPayload(const std::shared_ptr<const model::Mesh>& mesh, int partIndex, model::MaterialPointer material) {
@@ -53,6 +67,7 @@ MeshPartPayload::MeshPartPayload(const std::shared_ptr<const model::Mesh>& mesh,
 
 void MeshPartPayload::updateMeshPart(const std::shared_ptr<const model::Mesh>& drawMesh, int partIndex) {
     _drawMesh = drawMesh;
+    _partIndex = partIndex;
     if (_drawMesh) {
         auto vertexFormat = _drawMesh->getVertexFormat();
         _hasColorAttrib = vertexFormat->hasAttribute(gpu::Stream::COLOR);
@@ -113,6 +128,19 @@ ShapeKey MeshPartPayload::getShapeKey() const {
     return builder.build();
 }
 
+// folds an address into 16 bits, skipping the low bits the allocator aligns
+static uint32_t foldPointer(const void* pointer) {
+    quint64 value = (quint64)(uintptr_t)pointer >> 4;
+    value ^= value >> 32;
+    value ^= value >> 16;
+    return (uint32_t)(value & 0xffff);
+}
+
+uint32_t MeshPartPayload::getStateSortKey() const {
+    // the material binds the most state (textures and its uniform buffer), the mesh the vertex format and buffers
+    return (foldPointer(_drawMaterial.get()) << 16) | foldPointer(_drawMesh.get());
+}
+
 void MeshPartPayload::drawCall(gpu::Batch& batch) const {
     batch.drawIndexed(gpu::TRIANGLES, _drawPart._numIndices, _drawPart._startIndex);
 }
@@ -257,6 +285,25 @@ void MeshPartPayload::bindTransform(gpu::Batch& batch, const ShapePipeline::Loca
 }
 
 
+void MeshPartPayload::reportTextureVisibleSize(RenderArgs* args) const {
+    // The shadows are seen from the light, they don't tell what the textures need
+    if (!_drawMaterial || args->_renderMode == RenderArgs::SHADOW_RENDER_MODE) {
+        return;
+    }
+
+    const float MIN_DISTANCE = 0.01f;
+    float distance = glm::distance(args->getViewFrustum().getPosition(), _worldBound.calcCenter());
+    float visibleSize = glm::length(_worldBound.getDimensions()) / std::max(distance, MIN_DISTANCE);
+    for (const auto& textureMap : _drawMaterial->getTextureMaps()) {
+        if (textureMap.second && textureMap.second->isDefined()) {
+            auto textureView = textureMap.second->getTextureView();
+            if (textureView._texture) {
+                textureView._texture->reportVisibleSize(visibleSize);
+            }
+        }
+    }
+}
+
 void MeshPartPayload::render(RenderArgs* args) const {
     PerformanceTimer perfTimer("MeshPartPayload::render");
 
@@ -268,6 +315,8 @@ void MeshPartPayload::render(RenderArgs* args) const {
     // Bind the model transform and the skinCLusterMatrices if needed
     bindTransform(batch, locations);
 
+    reportTextureVisibleSize(args);
+
     //Bind the index buffer and vertex buffer and Blend shapes if needed
     bindMesh(batch);
 
@@ -312,9 +361,23 @@ template <> const ShapeKey shapeGetShapeKey(const ModelMeshPartPayload::Pointer&
     return ShapeKey::Builder::invalid();
 }
 
+template <> uint32_t shapeGetStateSortKey(const ModelMeshPartPayload::Pointer& payload) {
+    if (payload) {
+        return payload->getStateSortKey();
+    }
+    return 0;
+}
+
 template <> void payloadRender(const ModelMeshPartPayload::Pointer& payload, RenderArgs* args) {
     return payload->render(args);
 }
+
+template <> void payloadUpdateTransform(const ModelMeshPartPayload::Pointer& payload, const Transform& transform,
+                                        const Transform& offset) {
+    if (payload) {
+        payload->updateModelTransform(transform, offset);
+    }
+}
 }
 
 ModelMeshPartPayload::ModelMeshPartPayload(Model* model, int _meshIndex, int partIndex, int shapeIndex, const Transform& transform, const Transform& offsetTransform) :
@@ -325,6 +388,7 @@ ModelMeshPartPayload::ModelMeshPartPayload(Model* model, int _meshIndex, int par
     assert(_model && _model->isLoaded());
     auto& modelMesh = _model->getGeometry()->getMeshes().at(_meshIndex);
     updateMeshPart(modelMesh, partIndex);
+    _lodPart = _drawPart;
 
     updateTransform(transform, offsetTransform);
     initCache();
@@ -354,18 +418,35 @@ void ModelMeshPartPayload::notifyLocationChanged() {
 
 }
 
-void ModelMeshPartPayload::updateTransformForSkinnedMesh(const Transform& transform, const Transform& offsetTransform, const QVector<glm::mat4>& clusterMatrices) {
+void ModelMeshPartPayload::updateModelTransform(const Transform& modelTransform, const Transform& modelMeshOffset) {
+    if (!hasStartedFade() && _model && _model->isLoaded() && _model->getGeometry()->areTexturesLoaded()) {
+        startFade();
+    }
+    // Ensure the model geometry was not reset since the transform was published
+    if (_model && _model->isLoaded() && _model->_renderItemsDeleteGeometryCounter == _model->_deleteGeometryCounter) {
+        // lazy update of cluster matrices used for rendering, the first part of the model to get here updates them for all.
+        // We need to update them here, so we can correctly update the bounding box.
+        _model->updateClusterMatrices(modelTransform.getTranslation(), modelTransform.getRotation());
+
+        // update the model transform and bounding box for this render item.
+        const Model::MeshState& state = _model->_meshStates.at(_meshIndex);
+        updateTransformForSkinnedMesh(modelTransform, modelMeshOffset, state.clusterTransforms);
+    }
+}
+
+void ModelMeshPartPayload::updateTransformForSkinnedMesh(const Transform& transform, const Transform& offsetTransform,
+                                                         const QVector<Model::ClusterTransform>& clusterTransforms) {
     ModelMeshPartPayload::updateTransform(transform, offsetTransform);
 
-    if (clusterMatrices.size() > 0) {
+    if (clusterTransforms.size() > 0) {
         _worldBound = AABox();
-        for (auto& clusterMatrix : clusterMatrices) {
+        for (auto& clusterTransform : clusterTransforms) {
             AABox clusterBound = _localBound;
-            clusterBound.transform(clusterMatrix);
+            clusterBound.transform(clusterTransform.getMatrix());
             _worldBound += clusterBound;
         }
 
-        // clusterMatrix has world rotation but not world translation.
+        // clusterTransform has world rotation but not world translation.
         _worldBound.translate(transform.getTranslation());
     }
 }
@@ -507,17 +588,141 @@ void ModelMeshPartPayload::bindTransform(gpu::Batch& batch, const ShapePipeline:
             batch.setUniformBuffer(ShapePipeline::Slot::BUFFER::SKINNING, state.clusterBuffer);
         }
     } else {
-        if (canCauterize && _model->getCauterizeBones()) {
-            transform = Transform(state.cauterizedClusterMatrices[0]);
-        } else {
-            transform = Transform(state.clusterMatrices[0]);
-        }
+        const Model::ClusterTransform& clusterTransform = (canCauterize && _model->getCauterizeBones()) ?
+            state.cauterizedClusterTransforms[0] : state.clusterTransforms[0];
+        transform = Transform(clusterTransform.getRotation(), clusterTransform.getScale(), clusterTransform.getTranslation());
     }
 
     transform.preTranslate(_transform.getTranslation());
     batch.setModelTransform(transform);
 }
 
+static const size_t DRAW_COMMAND_BUFFER = 0;
+
+// Regroups the commands of a named call drawing the same range of the mesh, typically the same part of many copies
+// of a model, into one instanced command, moving their draw call infos next to each other
+// \return the number of commands left
+static size_t instanceDrawCommands(gpu::Batch::NamedBatchData& data) {
+    using Command = gpu::Batch::DrawIndexedIndirectCommand;
+    auto& commandBuffer = data.buffers[DRAW_COMMAND_BUFFER];
+    size_t numCommands = commandBuffer->getTypedSize<Command>();
+    const Command* commands = reinterpret_cast<const Command*>(commandBuffer->getData());
+
+    std::vector<Command> instancedCommands;
+    std::vector<std::vector<gpu::Batch::DrawCallInfo>> instances;
+    for (size_t i = 0; i < numCommands; i++) {
+        const auto& command = commands[i];
+        size_t j = 0;
+        for (; j < instancedCommands.size(); j++) {
+            if (instancedCommands[j]._firstIndex == command._firstIndex && instancedCommands[j]._count == command._count) {
+                break;
+            }
+        }
+        if (j == instancedCommands.size()) {
+            instancedCommands.push_back(command);
+            instancedCommands.back()._instanceCount = 0;
+            instances.emplace_back();
+        }
+        instancedCommands[j]._instanceCount++;
+        instances[j].push_back(data.drawCallInfos[command._baseInstance]);
+    }
+    if (instancedCommands.size() == numCommands) {
+        return numCommands;
+    }
+
+    data.drawCallInfos.clear();
+    for (size_t j = 0; j < instancedCommands.size(); j++) {
+        instancedCommands[j]._baseInstance = (gpu::uint32)data.drawCallInfos.size();
+        data.drawCallInfos.insert(data.drawCallInfos.end(), instances[j].begin(), instances[j].end());
+    }
+    commandBuffer->setData(instancedCommands.size() * sizeof(Command), reinterpret_cast<const gpu::Byte*>(instancedCommands.data()));
+    return instancedCommands.size();
+}
+
+bool ModelMeshPartPayload::canDrawIndirect(RenderArgs* args) const {
+    // Skinning, blendshapes and fading all need per part state
+    if (!args->_enableMultiDrawIndirect || _isSkinned || _isBlendShaped || _isFading || !_hasFinishedFade) {
+        return false;
+    }
+    return !(_drawMaterial && _drawMaterial->getKey().isTranslucent());
+}
+
+void ModelMeshPartPayload::drawIndirectCall(RenderArgs* args) const {
+    gpu::Batch& batch = *(args->_batch);
+    auto pipeline = args->_pipeline;
+
+    // The model copies share their meshes and materials through the geometry cache, so all their parts
+    // with the same pipeline, mesh and material land in the same named call
+    std::string instanceName = "ModelMeshPartPayload:" + std::to_string((uintptr_t)pipeline.get()) + ":" +
+        std::to_string((uintptr_t)_drawMesh.get()) + ":" + std::to_string((uintptr_t)_drawMaterial.get());
+
+    // One command per part, its base instance picks the model transform captured by setupNamedCalls
+    auto commandBuffer = batch.getNamedBuffer(instanceName, DRAW_COMMAND_BUFFER);
+    gpu::Batch::DrawIndexedIndirectCommand command;
+    command._count = _lodPart._numIndices;
+    command._instanceCount = 1;
+    command._firstIndex = _lodPart._startIndex;
+    command._baseInstance = (gpu::uint32)commandBuffer->getTypedSize<gpu::Batch::DrawIndexedIndirectCommand>();
+    commandBuffer->append(command);
+
+    auto drawMesh = _drawMesh;
+    auto drawMaterial = _drawMaterial;
+    bool hasColorAttrib = _hasColorAttrib;
+    batch.setupNamedCalls(instanceName, [pipeline, drawMesh, drawMaterial, hasColorAttrib](gpu::Batch& batch, gpu::Batch::NamedBatchData& data) {
+        batch.setPipeline(pipeline->pipeline);
+        pipeline->prepare(batch);
+
+        MeshPartPayload drawState;
+        drawState._drawMesh = drawMesh;
+        drawState._drawMaterial = drawMaterial;
+        drawState._hasColorAttrib = hasColorAttrib;
+        drawState.bindMesh(batch);
+        drawState.bindMaterial(batch, pipeline->locations);
+
+        size_t numCommands = instanceDrawCommands(data);
+        if (numCommands == 1) {
+            // A single range drawn many times is a plain instanced draw
+            const auto& command = *reinterpret_cast<const gpu::Batch::DrawIndexedIndirectCommand*>(data.buffers[DRAW_COMMAND_BUFFER]->getData());
+            batch.drawIndexedInstanced(command._instanceCount, gpu::TRIANGLES, command._count, command._firstIndex);
+        } else {
+            batch.setIndirectBuffer(data.buffers[DRAW_COMMAND_BUFFER], 0, sizeof(gpu::Batch::DrawIndexedIndirectCommand));
+            batch.multiDrawIndexedIndirect((gpu::uint32)numCommands, gpu::TRIANGLES);
+        }
+    });
+}
+
+void ModelMeshPartPayload::evalLOD(RenderArgs* args) const {
+    int numLODs = _drawMesh ? _drawMesh->getNumPartLODs() : 0;
+    if (numLODs <= 1) {
+        _lod = 0;
+        _lodPart = _drawPart;
+        return;
+    }
+
+    // The shadows keep the lod picked for the view
+    if (args->_renderMode != RenderArgs::SHADOW_RENDER_MODE) {
+        // The size of the part on screen switches to the next coarser lod below its threshold, and back
+        // to the finer one only once it grows past the threshold by the hysteresis, so it doesn't flicker
+        const float LOD_SIZE_THRESHOLDS[] = { 0.2f, 0.05f };
+        const int NUM_LOD_THRESHOLDS = (int)(sizeof(LOD_SIZE_THRESHOLDS) / sizeof(float));
+        const float LOD_HYSTERESIS = 1.25f;
+        const float MIN_DISTANCE = 0.01f;
+        float distance = glm::distance(args->getViewFrustum().getPosition(), _worldBound.calcCenter());
+        float size = args->_meshLODBias * glm::length(_worldBound.getDimensions()) / std::max(distance, MIN_DISTANCE);
+
+        int maxLOD = std::min(numLODs - 1, NUM_LOD_THRESHOLDS);
+        int lod = std::min(_lod, maxLOD);
+        while (lod < maxLOD && size < LOD_SIZE_THRESHOLDS[lod]) {
+            lod++;
+        }
+        while (lod > 0 && size > LOD_SIZE_THRESHOLDS[lod - 1] * LOD_HYSTERESIS) {
+            lod--;
+        }
+        _lod = lod;
+    }
+    _lodPart = _drawMesh->getPartLOD(_partIndex, std::min(_lod, numLODs - 1));
+}
+
 void ModelMeshPartPayload::startFade() {
     bool shouldFade = EntityItem::getEntitiesShouldFadeFunction()();
     if (shouldFade) {
@@ -574,6 +779,17 @@ void ModelMeshPartPayload::render(RenderArgs* args) const {
     _model->updateClusterMatrices(_transform.getTranslation(), _transform.getRotation());
     bindTransform(batch, locations, canCauterize);
 
+    reportTextureVisibleSize(args);
+    evalLOD(args);
+
+    if (canDrawIndirect(args)) {
+        drawIndirectCall(args);
+
+        const int INDICES_PER_TRIANGLE = 3;
+        args->_details._trianglesRendered += _lodPart._numIndices / INDICES_PER_TRIANGLE;
+        return;
+    }
+
     //Bind the index buffer and vertex buffer and Blend shapes if needed
     bindMesh(batch);
 
@@ -587,12 +803,12 @@ void ModelMeshPartPayload::render(RenderArgs* args) const {
     // Draw!
     {
         PerformanceTimer perfTimer("batch.drawIndexed()");
-        drawCall(batch);
+        batch.drawIndexed(gpu::TRIANGLES, _lodPart._numIndices, _lodPart._startIndex);
     }
 
     if (args) {
         const int INDICES_PER_TRIANGLE = 3;
-        args->_details._trianglesRendered += _drawPart._numIndices / INDICES_PER_TRIANGLE;
+        args->_details._trianglesRendered += _lodPart._numIndices / INDICES_PER_TRIANGLE;
     }
 }
 
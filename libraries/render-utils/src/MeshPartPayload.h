@@ -21,7 +21,7 @@
 
 #include <model/Geometry.h>
 
-class Model;
+#include "Model.h"
 
 class MeshPartPayload {
 public:
@@ -42,6 +42,7 @@ public:
     virtual render::ItemKey getKey() const;
     virtual render::Item::Bound getBound() const;
     virtual render::ShapeKey getShapeKey() const; // shape interface
+    uint32_t getStateSortKey() const;
     virtual void render(RenderArgs* args) const;
 
     // ModelMeshPartPayload functions to perform render
@@ -49,6 +50,8 @@ public:
     virtual void bindMesh(gpu::Batch& batch) const;
     virtual void bindMaterial(gpu::Batch& batch, const render::ShapePipeline::LocationsPointer locations) const;
     virtual void bindTransform(gpu::Batch& batch, const render::ShapePipeline::LocationsPointer locations, bool canCauterize = true) const;
+    // Tell the material textures how large the part appears, for streaming their mips
+    void reportTextureVisibleSize(RenderArgs* args) const;
 
     // Payload resource cached values
     std::shared_ptr<const model::Mesh> _drawMesh;
@@ -75,7 +78,10 @@ namespace render {
     template <> const ItemKey payloadGetKey(const MeshPartPayload::Pointer& payload);
     template <> const Item::Bound payloadGetBound(const MeshPartPayload::Pointer& payload);
     template <> const ShapeKey shapeGetShapeKey(const MeshPartPayload::Pointer& payload);
+    template <> uint32_t shapeGetStateSortKey(const MeshPartPayload::Pointer& payload);
     template <> void payloadRender(const MeshPartPayload::Pointer& payload, RenderArgs* args);
+    template <> void payloadUpdateTransform(const MeshPartPayload::Pointer& payload, const Transform& transform,
+                                            const Transform& offset);
 }
 
 class ModelMeshPartPayload : public MeshPartPayload {
@@ -86,7 +92,10 @@ public:
     typedef Payload::DataPointer Pointer;
 
     void notifyLocationChanged() override;
-    void updateTransformForSkinnedMesh(const Transform& transform, const Transform& offsetTransform, const QVector<glm::mat4>& clusterMatrices);
+    void updateTransformForSkinnedMesh(const Transform& transform, const Transform& offsetTransform, const QVector<Model::ClusterTransform>& clusterTransforms);
+
+    // applies the model transform published by Model::updateRenderItems(), with the cluster matrices of the model
+    void updateModelTransform(const Transform& modelTransform, const Transform& modelMeshOffset);
 
     // Entity fade in
     void startFade();
@@ -102,6 +111,13 @@ public:
     void bindMesh(gpu::Batch& batch) const override;
     void bindTransform(gpu::Batch& batch, const render::ShapePipeline::LocationsPointer locations, bool canCauterize) const override;
 
+    // Static opaque parts sharing a pipeline, mesh and material are drawn with one multi draw indirect
+    bool canDrawIndirect(RenderArgs* args) const;
+    void drawIndirectCall(RenderArgs* args) const;
+
+    // Picks the simplified level of detail of the part matching its size on screen
+    void evalLOD(RenderArgs* args) const;
+
     void initCache();
 
     Model* _model;
@@ -112,6 +128,10 @@ public:
     bool _isSkinned{ false };
     bool _isBlendShaped{ false };
 
+    // The level of detail drawn and its part
+    mutable int _lod { 0 };
+    mutable model::Mesh::Part _lodPart;
+
 private:
     quint64 _fadeStartTime { 0 };
     bool _hasStartedFade { false };
@@ -123,7 +143,10 @@ namespace render {
     template <> const ItemKey payloadGetKey(const ModelMeshPartPayload::Pointer& payload);
     template <> const Item::Bound payloadGetBound(const ModelMeshPartPayload::Pointer& payload);
     template <> const ShapeKey shapeGetShapeKey(const ModelMeshPartPayload::Pointer& payload);
+    template <> uint32_t shapeGetStateSortKey(const ModelMeshPartPayload::Pointer& payload);
     template <> void payloadRender(const ModelMeshPartPayload::Pointer& payload, RenderArgs* args);
+    template <> void payloadUpdateTransform(const ModelMeshPartPayload::Pointer& payload, const Transform& transform,
+                                            const Transform& offset);
 }
 
 #endif // hifi_MeshPartPayload_h
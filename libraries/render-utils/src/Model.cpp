@@ -21,6 +21,7 @@
 #include <PerfStat.h>
 #include <ViewFrustum.h>
 #include <GLMHelpers.h>
+#include <NumericalConstants.h>
 
 #include "AbstractViewStateInterface.h"
 #include "MeshPartPayload.h"
@@ -38,6 +39,7 @@ float Model::FAKE_DIMENSION_PLACEHOLDER = -1.0f;
 
 const int NUM_COLLISION_HULL_COLORS = 24;
 std::vector<model::MaterialPointer> _collisionMaterials;
+model::MaterialPointer _collisionVertexColorMaterial; // for the collision meshes colored per hull in their vertices
 
 void initCollisionMaterials() {
     // generates bright colors in red, green, blue, yellow, magenta, and cyan spectrums
@@ -75,6 +77,11 @@ void initCollisionMaterials() {
             _collisionMaterials.push_back(material);
         }
     }
+
+    _collisionVertexColorMaterial = std::make_shared<model::Material>();
+    _collisionVertexColorMaterial->setAlbedo(glm::vec3(1.0f));
+    _collisionVertexColorMaterial->setMetallic(0.02f);
+    _collisionVertexColorMaterial->setRoughness(0.5f);
 }
 
 Model::Model(RigPointer rig, QObject* parent) :
@@ -228,37 +235,26 @@ void Model::updateRenderItems() {
             modelMeshOffset.postTranslate(self->_offset);
         }
 
-        uint32_t deleteGeometryCounter = self->_deleteGeometryCounter;
+        // the mesh parts check against it that the model geometry was not reset between frames
+        self->_renderItemsDeleteGeometryCounter = self->_deleteGeometryCounter;
 
+        // one transform record per mesh part, applied by ModelMeshPartPayload::updateModelTransform(), rather than a
+        // heap allocated update functor each
         render::PendingChanges pendingChanges;
-        foreach (auto itemID, self->_modelMeshRenderItems.keys()) {
-            pendingChanges.updateItem<ModelMeshPartPayload>(itemID, [modelTransform, modelMeshOffset, deleteGeometryCounter](ModelMeshPartPayload& data) {
-                if (!data.hasStartedFade() && data._model && data._model->isLoaded() && data._model->getGeometry()->areTexturesLoaded()) {
-                    data.startFade();
-                }
-                // Ensure the model geometry was not reset between frames
-                if (data._model && data._model->isLoaded() && deleteGeometryCounter == data._model->_deleteGeometryCounter) {
-                    // lazy update of cluster matrices used for rendering.  We need to update them here, so we can correctly update the bounding box.
-                    data._model->updateClusterMatrices(modelTransform.getTranslation(), modelTransform.getRotation());
-
-                    // update the model transform and bounding box for this render item.
-                    const Model::MeshState& state = data._model->_meshStates.at(data._meshIndex);
-                    data.updateTransformForSkinnedMesh(modelTransform, modelMeshOffset, state.clusterMatrices);
-                }
-            });
+        pendingChanges._transformUpdates.reserve(self->_modelMeshRenderItems.size() + self->_collisionRenderItems.size());
+        for (auto it = self->_modelMeshRenderItems.constBegin(); it != self->_modelMeshRenderItems.constEnd(); ++it) {
+            pendingChanges.updateItemTransform(it.key(), modelTransform, modelMeshOffset);
         }
 
         // collision mesh does not share the same unit scale as the FBX file's mesh: only apply offset
         Transform collisionMeshOffset;
         collisionMeshOffset.setIdentity();
         foreach (auto itemID, self->_collisionRenderItems.keys()) {
-            pendingChanges.updateItem<MeshPartPayload>(itemID, [modelTransform, collisionMeshOffset](MeshPartPayload& data) {
-                // update the model transform for this render item.
-                data.updateTransform(modelTransform, collisionMeshOffset);
-            });
+            // update the model transform for this render item.
+            pendingChanges.updateItemTransform(itemID, modelTransform, collisionMeshOffset);
         }
 
-        scene->enqueuePendingChanges(pendingChanges);
+        scene->enqueuePendingChanges(std::move(pendingChanges));
     });
 }
 
@@ -274,8 +270,7 @@ void Model::init() {
 
 void Model::reset() {
     if (isLoaded()) {
-        const FBXGeometry& geometry = getFBXGeometry();
-        _rig->reset(geometry);
+        _rig->reset(_renderGeometry->getFBXGeometryPointer());
     }
 }
 
@@ -295,8 +290,11 @@ bool Model::updateGeometry() {
         const FBXGeometry& fbxGeometry = getFBXGeometry();
         foreach (const FBXMesh& mesh, fbxGeometry.meshes) {
             MeshState state;
-            state.clusterMatrices.resize(mesh.clusters.size());
-            state.cauterizedClusterMatrices.resize(mesh.clusters.size());
+            foreach (const FBXCluster& cluster, mesh.clusters) {
+                state.clusterBindPoses.append(AnimPose(cluster.inverseBindMatrix));
+            }
+            state.clusterTransforms.resize(mesh.clusters.size());
+            state.cauterizedClusterTransforms.resize(mesh.clusters.size());
 
             _meshStates.append(state);
 
@@ -316,10 +314,9 @@ bool Model::updateGeometry() {
 
 // virtual
 void Model::initJointStates() {
-    const FBXGeometry& geometry = getFBXGeometry();
     glm::mat4 modelOffset = glm::scale(_scale) * glm::translate(_offset);
 
-    _rig->initJointStates(geometry, modelOffset);
+    _rig->initJointStates(_renderGeometry->getFBXGeometryPointer(), modelOffset);
 }
 
 bool Model::findRayIntersectionAgainstSubMeshes(const glm::vec3& origin, const glm::vec3& direction, float& distance,
@@ -361,17 +358,39 @@ bool Model::findRayIntersectionAgainstSubMeshes(const glm::vec3& origin, const g
 
         const FBXGeometry& geometry = getFBXGeometry();
 
+        // triangles are picked in mesh space, where the geometry's hierarchies stay valid as the model moves and are
+        // shared by every model of it - a mirroring transform flips the winding, so that falls back to world triangles
+        glm::mat4 meshToWorldMatrix = modelToWorldMatrix * glm::scale(_scale) * glm::translate(_offset) * geometry.offset;
+        glm::mat4 worldToMeshMatrix = glm::inverse(meshToWorldMatrix);
+        bool pickAgainstMeshBVHs = pickAgainstTriangles && glm::determinant(meshToWorldMatrix) > 0.0f;
+        bool pickAgainstWorldTriangles = pickAgainstTriangles && !pickAgainstMeshBVHs;
+        glm::vec3 meshFrameOrigin = glm::vec3(worldToMeshMatrix * glm::vec4(origin, 1.0f));
+        glm::vec3 meshFrameDirection = glm::vec3(worldToMeshMatrix * glm::vec4(direction, 0.0f));
+
         // If we hit the models box, then consider the submeshes...
         _mutex.lock();
-        if (!_calculatedMeshBoxesValid || (pickAgainstTriangles && !_calculatedMeshTrianglesValid)) {
-            recalculateMeshBoxes(pickAgainstTriangles);
+        if (!_calculatedMeshBoxesValid || (pickAgainstWorldTriangles && !_calculatedMeshTrianglesValid)) {
+            recalculateMeshBoxes(pickAgainstWorldTriangles);
         }
 
         for (const auto& subMeshBox : _calculatedMeshBoxes) {
 
             if (subMeshBox.findRayIntersection(origin, direction, distanceToSubMesh, subMeshFace, subMeshSurfaceNormal)) {
                 if (distanceToSubMesh < bestDistance) {
-                    if (pickAgainstTriangles) {
+                    if (pickAgainstMeshBVHs) {
+                        // the ray parameter is the same in mesh space, since the direction is transformed with it
+                        const TriangleBVH& meshBVH = _renderGeometry->getMeshBVH(subMeshIndex);
+                        float thisTriangleDistance = bestDistance;
+                        int triangleIndex;
+                        if (meshBVH.findRayIntersection(meshFrameOrigin, meshFrameDirection, thisTriangleDistance, triangleIndex)) {
+                            bestDistance = thisTriangleDistance;
+                            intersectedSomething = true;
+                            face = subMeshFace;
+                            glm::vec3 meshFrameNormal = meshBVH.getTriangle(triangleIndex).getNormal();
+                            surfaceNormal = glm::normalize(glm::vec3(glm::transpose(worldToMeshMatrix) * glm::vec4(meshFrameNormal, 0.0f)));
+                            extraInfo = geometry.getModelNameOfMesh(subMeshIndex);
+                        }
+                    } else if (pickAgainstTriangles) {
                         // check our triangles here....
                         const QVector<Triangle>& meshTriangles = _calculatedMeshTriangles[subMeshIndex];
                         for(const auto& triangle : meshTriangles) {
@@ -883,6 +902,22 @@ void Model::setURL(const QUrl& url) {
     onInvalidate();
 }
 
+void Model::setLoadingPriority(float priority) {
+    _loadingPriority = priority;
+    _renderWatcher.setLoadPriority(this, priority);
+    if (isLoaded()) {
+        _renderGeometry->setTexturesLoadPriority(this, priority);
+    }
+}
+
+float Model::computeLoadingPriority(float size, float distance, bool isInView) {
+    if (size <= 0.0f) {
+        return 0.0f;
+    }
+    float priority = atan2f(size, distance);
+    return isInView ? priority : priority - PI_OVER_TWO;
+}
+
 void Model::loadURLFinished(bool success) {
     if (!success) {
         _visualGeometryRequestFailed = true;
@@ -1115,7 +1150,11 @@ void Model::simulate(float deltaTime, bool fullUpdate) {
 //virtual
 void Model::updateRig(float deltaTime, glm::mat4 parentTransform) {
     _needsUpdateClusterMatrices = true;
-    _rig->updateAnimations(deltaTime, parentTransform);
+    if (_animationUpdatePeriod > 0.0f) {
+        _rig->updateAnimationsAtReducedRate(deltaTime, parentTransform, _animationUpdatePeriod);
+    } else {
+        _rig->updateAnimations(deltaTime, parentTransform);
+    }
 }
 
 void Model::simulateInternal(float deltaTime) {
@@ -1124,61 +1163,99 @@ void Model::simulateInternal(float deltaTime) {
     updateRig(deltaTime, parentTransform);
 }
 
+Model::ClusterTransform::ClusterTransform(const glm::vec3& scale, const glm::quat& rotation, const glm::vec3& translation) {
+    glm::quat dual = glm::quat(0.0f, translation) * rotation * 0.5f;
+    _scale = glm::vec4(scale, 0.0f);
+    _real = glm::vec4(rotation.x, rotation.y, rotation.z, rotation.w);
+    _dual = glm::vec4(dual.x, dual.y, dual.z, dual.w);
+}
+
+glm::vec3 Model::ClusterTransform::getTranslation() const {
+    glm::vec3 real(_real);
+    glm::vec3 dual(_dual);
+    return 2.0f * (_real.w * dual - _dual.w * real + glm::cross(real, dual));
+}
+
+glm::mat4 Model::ClusterTransform::getMatrix() const {
+    return AnimPose(getScale(), getRotation(), getTranslation());
+}
+
+void Model::updateClusterTransforms(MeshState& state, const FBXMesh& mesh, const AnimPoseVec& jointPoses,
+                                    const AnimPoseVec* cauterizedJointPoses) {
+    for (int j = 0; j < mesh.clusters.size(); j++) {
+        const FBXCluster& cluster = mesh.clusters.at(j);
+        const AnimPose& bindPose = state.clusterBindPoses[j];
+        bool isValidJoint = cluster.jointIndex >= 0 && cluster.jointIndex < (int)jointPoses.size();
+        const AnimPose& jointPose = isValidJoint ? jointPoses[cluster.jointIndex] : AnimPose::identity;
+
+        // the joints only carry the uniform scale of the model, so the scales compose per axis
+        state.clusterTransforms[j] = ClusterTransform(jointPose.scale * bindPose.scale, jointPose.rot * bindPose.rot,
+                                                      jointPose.trans + jointPose.rot * (jointPose.scale * bindPose.trans));
+
+        if (cauterizedJointPoses && isValidJoint) {
+            const AnimPose& cauterizedPose = (*cauterizedJointPoses)[cluster.jointIndex];
+            state.cauterizedClusterTransforms[j] = ClusterTransform(cauterizedPose.scale * bindPose.scale,
+                cauterizedPose.rot * bindPose.rot, cauterizedPose.trans + cauterizedPose.rot * (cauterizedPose.scale * bindPose.trans));
+        } else if (cauterizedJointPoses) {
+            state.cauterizedClusterTransforms[j] = state.clusterTransforms[j];
+        }
+    }
+
+    // Once computed the cluster transforms, update the buffer(s)
+    if (mesh.clusters.size() > 1) {
+        size_t size = state.clusterTransforms.size() * sizeof(ClusterTransform);
+        if (!state.clusterBuffer) {
+            state.clusterBuffer = std::make_shared<gpu::Buffer>(size, (const gpu::Byte*) state.clusterTransforms.constData());
+        } else {
+            state.clusterBuffer->setSubData(0, size, (const gpu::Byte*) state.clusterTransforms.constData());
+        }
+
+        if (cauterizedJointPoses) {
+            if (!state.cauterizedClusterBuffer) {
+                state.cauterizedClusterBuffer = std::make_shared<gpu::Buffer>(size,
+                    (const gpu::Byte*) state.cauterizedClusterTransforms.constData());
+            } else {
+                state.cauterizedClusterBuffer->setSubData(0, size, (const gpu::Byte*) state.cauterizedClusterTransforms.constData());
+            }
+        }
+    }
+}
+
 // virtual
 void Model::updateClusterMatrices(glm::vec3 modelPosition, glm::quat modelOrientation) {
     PerformanceTimer perfTimer("Model::updateClusterMatrices");
 
+    std::lock_guard<std::mutex> lock(_clusterMatricesMutex);
     if (!_needsUpdateClusterMatrices || !isLoaded()) {
         return;
     }
     _needsUpdateClusterMatrices = false;
     const FBXGeometry& geometry = getFBXGeometry();
-    glm::mat4 zeroScale(glm::vec4(0.0f, 0.0f, 0.0f, 0.0f),
-        glm::vec4(0.0f, 0.0f, 0.0f, 0.0f),
-        glm::vec4(0.0f, 0.0f, 0.0f, 0.0f),
-        glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
-    auto cauterizeMatrix = _rig->getJointTransform(geometry.neckJointIndex) * zeroScale;
 
-    glm::mat4 modelToWorld = glm::mat4_cast(modelOrientation);
-    for (int i = 0; i < _meshStates.size(); i++) {
-        MeshState& state = _meshStates[i];
-        const FBXMesh& mesh = geometry.meshes.at(i);
-
-        for (int j = 0; j < mesh.clusters.size(); j++) {
-            const FBXCluster& cluster = mesh.clusters.at(j);
-            auto jointMatrix = _rig->getJointTransform(cluster.jointIndex);
-            state.clusterMatrices[j] = modelToWorld * jointMatrix * cluster.inverseBindMatrix;
-
-            // as an optimization, don't build cautrizedClusterMatrices if the boneSet is empty.
-            if (!_cauterizeBoneSet.empty()) {
-                if (_cauterizeBoneSet.find(cluster.jointIndex) != _cauterizeBoneSet.end()) {
-                    jointMatrix = cauterizeMatrix;
-                }
-                state.cauterizedClusterMatrices[j] = modelToWorld * jointMatrix * cluster.inverseBindMatrix;
-            }
-        }
+    // pose the joints in the world once, the meshes then only compose them with the bind poses of their clusters
+    int numJoints = _rig->getJointStateCount();
+    _jointPoses.resize(numJoints);
+    for (int i = 0; i < numJoints; i++) {
+        AnimPose jointPose = _rig->getJointPose(i);
+        _jointPoses[i] = AnimPose(jointPose.scale, modelOrientation * jointPose.rot, modelOrientation * jointPose.trans);
+    }
 
-        // Once computed the cluster matrices, update the buffer(s)
-        if (mesh.clusters.size() > 1) {
-            if (!state.clusterBuffer) {
-                state.clusterBuffer = std::make_shared<gpu::Buffer>(state.clusterMatrices.size() * sizeof(glm::mat4),
-                                                                    (const gpu::Byte*) state.clusterMatrices.constData());
-            } else {
-                state.clusterBuffer->setSubData(0, state.clusterMatrices.size() * sizeof(glm::mat4),
-                                                (const gpu::Byte*) state.clusterMatrices.constData());
-            }
-
-            if (!_cauterizeBoneSet.empty() && (state.cauterizedClusterMatrices.size() > 1)) {
-                if (!state.cauterizedClusterBuffer) {
-                    state.cauterizedClusterBuffer =
-                        std::make_shared<gpu::Buffer>(state.cauterizedClusterMatrices.size() * sizeof(glm::mat4),
-                                                      (const gpu::Byte*) state.cauterizedClusterMatrices.constData());
-                } else {
-                    state.cauterizedClusterBuffer->setSubData(0, state.cauterizedClusterMatrices.size() * sizeof(glm::mat4),
-                                                              (const gpu::Byte*) state.cauterizedClusterMatrices.constData());
-                }
+    // the cauterized joints collapse to the neck
+    const AnimPoseVec* cauterizedJointPoses = nullptr;
+    if (!_cauterizeBoneSet.empty()) {
+        AnimPose neckPose = _rig->getJointPose(geometry.neckJointIndex);
+        AnimPose cauterizedPose(glm::vec3(0.0f), modelOrientation * neckPose.rot, modelOrientation * neckPose.trans);
+        _cauterizedJointPoses = _jointPoses;
+        for (int jointIndex : _cauterizeBoneSet) {
+            if (jointIndex >= 0 && jointIndex < numJoints) {
+                _cauterizedJointPoses[jointIndex] = cauterizedPose;
             }
         }
+        cauterizedJointPoses = &_cauterizedJointPoses;
+    }
+
+    for (int i = 0; i < _meshStates.size(); i++) {
+        updateClusterTransforms(_meshStates[i], geometry.meshes.at(i), _jointPoses, cauterizedJointPoses);
     }
 
     // post the blender if we're not currently waiting for one to finish
@@ -1343,10 +1420,12 @@ void Model::createCollisionRenderItemSet() {
             continue;
         }
 
-        // Create the render payloads
+        // Create the render payloads, the meshes that carry their hull colors draw with a white material
+        bool hasHullColors = mesh->getVertexFormat()->hasAttribute(gpu::Stream::COLOR);
         int numParts = (int)mesh->getNumParts();
         for (int partIndex = 0; partIndex < numParts; partIndex++) {
-            model::MaterialPointer& material = _collisionMaterials[partIndex % NUM_COLLISION_HULL_COLORS];
+            model::MaterialPointer& material = hasHullColors ? _collisionVertexColorMaterial :
+                _collisionMaterials[partIndex % NUM_COLLISION_HULL_COLORS];
             auto payload = std::make_shared<MeshPartPayload>(mesh, partIndex, material);
             payload->updateTransform(identity, offset);
             _collisionRenderItemsSet << payload;
@@ -1435,6 +1514,9 @@ ModelBlender::~ModelBlender() {
 }
 
 void ModelBlender::noteRequiresBlend(ModelPointer model) {
+    // the avatars note their blends from the threads simulating them
+    Lock lock(_mutex);
+
     if (_pendingBlenders < QThread::idealThreadCount()) {
         if (model->maybeStartBlender()) {
             _pendingBlenders++;
@@ -1442,10 +1524,7 @@ void ModelBlender::noteRequiresBlend(ModelPointer model) {
         return;
     }
 
-    {
-        Lock lock(_mutex);
-        _modelsRequiringBlends.insert(model);
-    }
+    _modelsRequiringBlends.insert(model);
 }
 
 void ModelBlender::setBlendedVertices(ModelPointer model, int blendNumber,
@@ -1453,9 +1532,9 @@ void ModelBlender::setBlendedVertices(ModelPointer model, int blendNumber,
     if (model) {
         model->setBlendedVertices(blendNumber, geometry, vertices, normals);
     }
-    _pendingBlenders--;
     {
         Lock lock(_mutex);
+        _pendingBlenders--;
         for (auto i = _modelsRequiringBlends.begin(); i != _modelsRequiringBlends.end();) {
             auto weakPtr = *i;
             _modelsRequiringBlends.erase(i++); // remove front of the set
@@ -17,6 +17,7 @@
 #include <QUrl>
 #include <QMutex>
 
+#include <mutex>
 #include <unordered_map>
 #include <unordered_set>
 #include <functional>
@@ -230,7 +231,17 @@ public:
     bool updateGeometry();
     void setCollisionMesh(model::MeshPointer mesh);
 
-    void setLoadingPriority(float priority) { _loadingPriority = priority; }
+    // Sets the priority of the geometry and textures still loading, renewed as the model moves on and off screen
+    void setLoadingPriority(float priority);
+    bool isLoadingComplete() const { return isLoaded() && _renderGeometry->areTexturesLoaded(); }
+
+    // The loading priority of something of a given size at a given distance from the view: its angular size,
+    // lowered for the things out of view so they all rank below the ones in view
+    static float computeLoadingPriority(float size, float distance, bool isInView);
+
+    // Evaluates the animations of the rig once per period, interpolating the joints in between. 0 for every frame
+    void setAnimationUpdatePeriod(float period) { _animationUpdatePeriod = period; }
+    float getAnimationUpdatePeriod() const { return _animationUpdatePeriod; }
 
     size_t getRenderInfoVertexCount() const { return _renderInfoVertexCount; }
     size_t getRenderInfoTextureSize();
@@ -297,15 +308,38 @@ protected:
     bool _snappedToRegistrationPoint; /// are we currently snapped to a registration point
     glm::vec3 _registrationPoint = glm::vec3(0.5f); /// the point in model space our center is snapped to
 
+    // The skinning transform of a cluster as a scale, applied first, and a dual quaternion for the rotation and
+    // translation, laid out as the skinClusterBuffer of Skinning.slh expects it
+    class ClusterTransform {
+    public:
+        ClusterTransform() {}
+        ClusterTransform(const glm::vec3& scale, const glm::quat& rotation, const glm::vec3& translation);
+
+        glm::vec3 getScale() const { return glm::vec3(_scale); }
+        glm::quat getRotation() const { return glm::quat(_real.w, _real.x, _real.y, _real.z); }
+        glm::vec3 getTranslation() const;
+        glm::mat4 getMatrix() const;
+
+    private:
+        glm::vec4 _scale;
+        glm::vec4 _real;
+        glm::vec4 _dual;
+    };
+
     class MeshState {
     public:
-        QVector<glm::mat4> clusterMatrices;
-        QVector<glm::mat4> cauterizedClusterMatrices;
+        QVector<AnimPose> clusterBindPoses;
+        QVector<ClusterTransform> clusterTransforms;
+        QVector<ClusterTransform> cauterizedClusterTransforms;
         gpu::BufferPointer clusterBuffer;
         gpu::BufferPointer cauterizedClusterBuffer;
 
     };
 
+    // Composes the cluster transforms of the mesh from the world poses of the joints, computed once for all the meshes
+    static void updateClusterTransforms(MeshState& state, const FBXMesh& mesh, const AnimPoseVec& jointPoses,
+                                        const AnimPoseVec* cauterizedJointPoses);
+
     QVector<MeshState> _meshStates;
     std::unordered_set<int> _cauterizeBoneSet;
     bool _cauterizeBones;
@@ -394,12 +428,17 @@ protected:
     bool _needsFixupInScene { true }; // needs to be removed/re-added to scene
     bool _needsReload { true };
     bool _needsUpdateClusterMatrices { true };
+    float _animationUpdatePeriod { 0.0f };
+    std::mutex _clusterMatricesMutex; // the mesh parts of the model can be rendered from several threads
+    AnimPoseVec _jointPoses; // world frame without the model translation, shared by the meshes
+    AnimPoseVec _cauterizedJointPoses;
     mutable bool _needsUpdateTextures { true };
 
     friend class ModelMeshPartPayload;
     RigPointer _rig;
 
     uint32_t _deleteGeometryCounter { 0 };
+    uint32_t _renderItemsDeleteGeometryCounter { 0 }; // the _deleteGeometryCounter when the render items were last updated
 
     bool _visualGeometryRequestFailed { false };
     bool _collisionGeometryRequestFailed { false };
@@ -23,6 +23,7 @@
 #include <render/DrawTask.h>
 #include <render/DrawStatus.h>
 #include <render/DrawSceneOctree.h>
+#include <render/OcclusionCull.h>
 #include <render/BlurTask.h>
 
 #include "LightingModel.h"
@@ -61,8 +62,8 @@ RenderDeferredTask::RenderDeferredTask(CullFunctor cullFunctor) {
     const auto spatialSelection = addJob<FetchSpatialTree>("FetchSceneSelection", spatialFilter);
     const auto culledSpatialSelection = addJob<CullSpatialSelection>("CullSceneSelection", spatialSelection, cullFunctor, RenderDetails::ITEM, spatialFilter);
 
-    // Overlays are not culled
-    const auto nonspatialSelection = addJob<FetchNonspatialItems>("FetchOverlaySelection");
+    // Overlays are not culled, the concurrent jobs run on worker threads when they don't need each other's output
+    const auto nonspatialSelection = addConcurrentJob<FetchNonspatialItems>("FetchOverlaySelection");
 
     // Multi filter visible items into different buckets
     const int NUM_FILTERS = 3;
@@ -80,27 +81,33 @@ RenderDeferredTask::RenderDeferredTask(CullFunctor cullFunctor) {
             ItemFilter::Builder::transparentShape(),
             ItemFilter::Builder::background()
     } };
-    const auto filteredSpatialBuckets = addJob<MultiFilterItem<NUM_FILTERS>>("FilterSceneSelection", culledSpatialSelection, spatialFilters).get<MultiFilterItem<NUM_FILTERS>::ItemBoundsArray>();
-    const auto filteredNonspatialBuckets = addJob<MultiFilterItem<NUM_FILTERS>>("FilterOverlaySelection", nonspatialSelection, nonspatialFilters).get<MultiFilterItem<NUM_FILTERS>::ItemBoundsArray>();
+    const auto filteredSpatialBuckets = addConcurrentJob<MultiFilterItem<NUM_FILTERS>>("FilterSceneSelection", culledSpatialSelection, spatialFilters).get<MultiFilterItem<NUM_FILTERS>::ItemBoundsArray>();
+    const auto filteredNonspatialBuckets = addConcurrentJob<MultiFilterItem<NUM_FILTERS>>("FilterOverlaySelection", nonspatialSelection, nonspatialFilters).get<MultiFilterItem<NUM_FILTERS>::ItemBoundsArray>();
+
+    // Drop the opaques hidden at the last occlusion queries, the queries themselves are drawn after the opaque pass
+    auto occlusionState = std::make_shared<OcclusionState>();
+    const auto occlusionCulledOpaques = addConcurrentJob<OcclusionCull>("OcclusionCullOpaque", filteredSpatialBuckets[OPAQUE_SHAPE_BUCKET], occlusionState);
 
     // Extract / Sort opaques / Transparents / Lights / Overlays
-    const auto opaques = addJob<DepthSortItems>("DepthSortOpaque", filteredSpatialBuckets[OPAQUE_SHAPE_BUCKET]);
-    const auto transparents = addJob<DepthSortItems>("DepthSortTransparent", filteredSpatialBuckets[TRANSPARENT_SHAPE_BUCKET], DepthSortItems(false));
+    const auto opaques = addConcurrentJob<DepthSortItems>("DepthSortOpaque", occlusionCulledOpaques);
+    const auto transparents = addConcurrentJob<DepthSortItems>("DepthSortTransparent", filteredSpatialBuckets[TRANSPARENT_SHAPE_BUCKET], DepthSortItems(false));
     const auto lights = filteredSpatialBuckets[LIGHT_BUCKET];
 
-    const auto overlayOpaques = addJob<DepthSortItems>("DepthSortOverlayOpaque", filteredNonspatialBuckets[OPAQUE_SHAPE_BUCKET]);
-    const auto overlayTransparents = addJob<DepthSortItems>("DepthSortOverlayTransparent", filteredNonspatialBuckets[TRANSPARENT_SHAPE_BUCKET], DepthSortItems(false));
+    const auto overlayOpaques = addConcurrentJob<DepthSortItems>("DepthSortOverlayOpaque", filteredNonspatialBuckets[OPAQUE_SHAPE_BUCKET]);
+    const auto overlayTransparents = addConcurrentJob<DepthSortItems>("DepthSortOverlayTransparent", filteredNonspatialBuckets[TRANSPARENT_SHAPE_BUCKET], DepthSortItems(false));
     const auto background = filteredNonspatialBuckets[BACKGROUND_BUCKET];
 
+    // GPU jobs: Start preparing the primary, deferred and lighting buffer
+    // The full frame gpu time drives the resolution of the primary buffer, which sets the viewport of the next jobs
+    const auto fullFrameRangeTimer = addJob<BeginGPURangeTimer>("BeginRangeTimer");
+    const auto preparePrimaryOutputs = addJob<PreparePrimaryFramebuffer>("PreparePrimaryBuffer", fullFrameRangeTimer);
+    const auto primaryFramebuffer = preparePrimaryOutputs.getN<PreparePrimaryFramebuffer::Outputs>(0);
+    const auto displayViewport = preparePrimaryOutputs.getN<PreparePrimaryFramebuffer::Outputs>(1);
+
     // Prepare deferred, generate the shared Deferred Frame Transform
     const auto deferredFrameTransform = addJob<GenerateDeferredFrameTransform>("DeferredFrameTransform");
     const auto lightingModel = addJob<MakeLightingModel>("LightingModel");
 
-
-    // GPU jobs: Start preparing the primary, deferred and lighting buffer
-    const auto primaryFramebuffer = addJob<PreparePrimaryFramebuffer>("PreparePrimaryBuffer");
-
-   // const auto fullFrameRangeTimer = addJob<BeginGPURangeTimer>("BeginRangeTimer");
     const auto opaqueRangeTimer = addJob<BeginGPURangeTimer>("BeginOpaqueRangeTimer");
 
     const auto prepareDeferredInputs = PrepareDeferred::Inputs(primaryFramebuffer, lightingModel).hasVarying();
@@ -115,6 +122,9 @@ RenderDeferredTask::RenderDeferredTask(CullFunctor cullFunctor) {
     // Once opaque is all rendered create stencil background
     addJob<DrawStencilDeferred>("DrawOpaqueStencil", deferredFramebuffer);
 
+    // Test all the opaques, the culled ones included, against the opaque depth still bound for the next frame's culling
+    addJob<DrawOcclusionQueries>("DrawOcclusionQueries", filteredSpatialBuckets[OPAQUE_SHAPE_BUCKET], occlusionState);
+
     addJob<EndGPURangeTimer>("OpaqueRangeTimer", opaqueRangeTimer);
 
 
@@ -205,11 +215,11 @@ RenderDeferredTask::RenderDeferredTask(CullFunctor cullFunctor) {
 
     addJob<EndGPURangeTimer>("ToneAndPostRangeTimer", toneAndPostRangeTimer);
 
-    // Blit!
-    addJob<Blit>("Blit", primaryFramebuffer);
-
- //   addJob<EndGPURangeTimer>("RangeTimer", fullFrameRangeTimer);
+    addJob<EndGPURangeTimer>("RangeTimer", fullFrameRangeTimer);
 
+    // Blit!
+    const auto blitInputs = Blit::Inputs(primaryFramebuffer, displayViewport).hasVarying();
+    addJob<Blit>("Blit", blitInputs);
 }
 
 void RenderDeferredTask::run(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext) {
@@ -227,9 +237,7 @@ void RenderDeferredTask::run(const SceneContextPointer& sceneContext, const Rend
 
     auto config = std::static_pointer_cast<Config>(renderContext->jobConfig);
 
-    for (auto job : _jobs) {
-        job.run(sceneContext, renderContext);
-    }
+    runJobs(sceneContext, renderContext);
 }
 
 void BeginGPURangeTimer::run(const render::SceneContextPointer& sceneContext, const render::RenderContextPointer& renderContext, gpu::RangeTimerPointer& timer) {
@@ -296,31 +304,35 @@ void DrawStateSortDeferred::run(const SceneContextPointer& sceneContext, const R
 
     RenderArgs* args = renderContext->args;
 
-    gpu::doInBatch(args->_context, [&](gpu::Batch& batch) {
-        args->_batch = &batch;
+    glm::mat4 projMat;
+    Transform viewMat;
+    args->getViewFrustum().evalProjectionMatrix(projMat);
+    args->getViewFrustum().evalViewTransform(viewMat);
 
+    auto setupBatch = [&](gpu::Batch& batch) {
         // Setup camera, projection and viewport for all items
         batch.setViewportTransform(args->_viewport);
         batch.setStateScissorRect(args->_viewport);
 
-        glm::mat4 projMat;
-        Transform viewMat;
-        args->getViewFrustum().evalProjectionMatrix(projMat);
-        args->getViewFrustum().evalViewTransform(viewMat);
-
         batch.setProjectionTransform(projMat);
         batch.setViewTransform(viewMat);
 
         // Setup lighting model for all items;
         batch.setUniformBuffer(render::ShapePipeline::Slot::LIGHTING_MODEL, lightingModel->getParametersBuffer());
+    };
 
-        if (_stateSort) {
-            renderStateSortShapes(sceneContext, renderContext, _shapePlumber, inItems, _maxDrawn);
-        } else {
+    args->_enableMultiDrawIndirect = _multiDrawIndirect;
+    if (_stateSort) {
+        renderStateSortShapesInBatches(sceneContext, renderContext, _shapePlumber, inItems, _maxDrawn, setupBatch);
+    } else {
+        gpu::doInBatch(args->_context, [&](gpu::Batch& batch) {
+            args->_batch = &batch;
+            setupBatch(batch);
             renderShapes(sceneContext, renderContext, _shapePlumber, inItems, _maxDrawn);
-        }
-        args->_batch = nullptr;
-    });
+            args->_batch = nullptr;
+        });
+    }
+    args->_enableMultiDrawIndirect = false;
 
     config->setNumDrawn((int)inItems.size());
 }
@@ -461,23 +473,28 @@ void DrawBackgroundDeferred::run(const SceneContextPointer& sceneContext, const
    // std::static_pointer_cast<Config>(renderContext->jobConfig)->gpuTime = _gpuTimer.getAverage();
 }
 
-void Blit::run(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext, const gpu::FramebufferPointer& srcFramebuffer) {
+void Blit::run(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext, const Inputs& inputs) {
     assert(renderContext->args);
     assert(renderContext->args->_context);
 
     RenderArgs* renderArgs = renderContext->args;
     auto blitFbo = renderArgs->_blitFramebuffer;
 
+    // The frame was rendered at the viewport scaled by the dynamic resolution, restore the one of the display
+    auto renderViewport = renderArgs->_viewport;
+    const auto& displayViewport = inputs.get1();
+    renderArgs->_viewport = displayViewport;
+
     if (!blitFbo) {
         return;
     }
 
     // Determine size from viewport
-    int width = renderArgs->_viewport.z;
-    int height = renderArgs->_viewport.w;
+    int width = renderViewport.z;
+    int height = renderViewport.w;
 
     // Blit primary to blit FBO
-    auto primaryFbo = srcFramebuffer;
+    auto primaryFbo = inputs.get0();
 
     gpu::doInBatch(renderArgs->_context, [&](gpu::Batch& batch) {
         batch.setFramebuffer(blitFbo);
@@ -522,11 +539,16 @@ void Blit::run(const SceneContextPointer& sceneContext, const RenderContextPoint
                 batch.blit(primaryFbo, srcRect, blitFbo, destRect);
             }
         } else {
-            gpu::Vec4i rect;
-            rect.z = width;
-            rect.w = height;
+            gpu::Vec4i srcRect;
+            srcRect.z = width;
+            srcRect.w = height;
+
+            // Upscales the frame when rendered at a lower resolution
+            gpu::Vec4i destRect;
+            destRect.z = displayViewport.z;
+            destRect.w = displayViewport.w;
 
-            batch.blit(primaryFbo, rect, blitFbo, rect);
+            batch.blit(primaryFbo, srcRect, blitFbo, destRect);
         }
     });
 }
@@ -86,6 +86,7 @@ class DrawStateSortConfig : public render::Job::Config {
         Q_PROPERTY(int numDrawn READ getNumDrawn NOTIFY numDrawnChanged)
         Q_PROPERTY(int maxDrawn MEMBER maxDrawn NOTIFY dirty)
         Q_PROPERTY(bool stateSort MEMBER stateSort NOTIFY dirty)
+        Q_PROPERTY(bool multiDrawIndirect MEMBER multiDrawIndirect NOTIFY dirty)
 public:
 
     int getNumDrawn() { return numDrawn; }
@@ -93,6 +94,7 @@ public:
 
     int maxDrawn{ -1 };
     bool stateSort{ true };
+    bool multiDrawIndirect{ true };
 
 signals:
     void numDrawnChanged();
@@ -111,13 +113,14 @@ public:
 
     DrawStateSortDeferred(render::ShapePlumberPointer shapePlumber) : _shapePlumber{ shapePlumber } {}
 
-    void configure(const Config& config) { _maxDrawn = config.maxDrawn; _stateSort = config.stateSort; }
+    void configure(const Config& config) { _maxDrawn = config.maxDrawn; _stateSort = config.stateSort; _multiDrawIndirect = config.multiDrawIndirect; }
     void run(const render::SceneContextPointer& sceneContext, const render::RenderContextPointer& renderContext, const Inputs& inputs);
 
 protected:
     render::ShapePlumberPointer _shapePlumber;
     int _maxDrawn; // initialized by Config
     bool _stateSort;
+    bool _multiDrawIndirect;
 };
 
 class DeferredFramebuffer;
@@ -187,9 +190,11 @@ protected:
 
 class Blit {
 public:
-    using JobModel = render::Job::ModelI<Blit, gpu::FramebufferPointer>;
+    // Inputs: primaryFramebuffer and the viewport of the display to upscale it to
+    using Inputs = render::VaryingSet2<gpu::FramebufferPointer, glm::ivec4>;
+    using JobModel = render::Job::ModelI<Blit, Inputs>;
 
-    void run(const render::SceneContextPointer& sceneContext, const render::RenderContextPointer& renderContext, const gpu::FramebufferPointer& srcFramebuffer);
+    void run(const render::SceneContextPointer& sceneContext, const render::RenderContextPointer& renderContext, const Inputs& inputs);
 };
 
 using RenderDeferredTaskConfig = render::GPUTaskConfig;
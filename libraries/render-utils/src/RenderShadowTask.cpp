@@ -12,6 +12,7 @@
 #include "RenderShadowTask.h"
 
 #include <gpu/Context.h>
+#include <gpu/StandardShaderLib.h>
 
 #include <ViewFrustum.h>
 
@@ -28,9 +29,71 @@
 
 #include "model_shadow_frag.h"
 #include "skin_model_shadow_frag.h"
+#include "shadow_cache_frag.h"
 
 using namespace render;
 
+// The view depths the cascades reach from the near clip, and the number of frames between their updates
+const float CASCADE_FAR_DEPTHS[LightStage::Shadow::NUM_CASCADES] = { 6.0f, 20.0f, 60.0f };
+const uint32_t CASCADE_UPDATE_PERIODS[LightStage::Shadow::NUM_CASCADES] = { 1, 2, 4 };
+
+const int CACHE_MAP_SLOT = 0;
+
+// Whether the item went unchanged for STATIC_FRAME_COUNT frames as of the frame
+static bool isStaticAt(const Scene& scene, const ItemBound& item, uint32_t frame) {
+    return (int32_t)(frame - scene.getItem(item.id).getChangeFrame()) >= (int32_t)Scene::STATIC_FRAME_COUNT;
+}
+
+const gpu::PipelinePointer& RenderShadowMap::getCachePipeline() {
+    if (!_cachePipeline) {
+        auto vs = gpu::StandardShaderLib::getDrawUnitQuadTexcoordVS();
+        auto ps = gpu::Shader::createPixel(std::string(shadow_cache_frag));
+        gpu::ShaderPointer program = gpu::Shader::createProgram(vs, ps);
+
+        gpu::Shader::BindingSet slotBindings;
+        slotBindings.insert(gpu::Shader::Binding(std::string("cacheMap"), CACHE_MAP_SLOT));
+        gpu::Shader::makeProgram(*program, slotBindings);
+
+        auto state = std::make_shared<gpu::State>();
+        state->setDepthTest(true, true, gpu::ALWAYS);
+        state->setColorWriteMask(false, false, false, false);
+
+        _cachePipeline = gpu::Pipeline::create(program, state);
+    }
+    return _cachePipeline;
+}
+
+void RenderShadowMap::renderShapes(const render::SceneContextPointer& sceneContext, const render::RenderContextPointer& renderContext,
+                                   const render::ShapeBounds& inShapes) {
+    RenderArgs* args = renderContext->args;
+    auto& batch = *(args->_batch);
+
+    auto shadowPipeline = _shapePlumber->pickPipeline(args, ShapeKey());
+    auto shadowSkinnedPipeline = _shapePlumber->pickPipeline(args, ShapeKey::Builder().withSkinned());
+
+    std::vector<ShapeKey> skinnedShapeKeys{};
+
+    // Iterate through all inShapes and render the unskinned
+    args->_pipeline = shadowPipeline;
+    batch.setPipeline(shadowPipeline->pipeline);
+    for (auto items : inShapes) {
+        if (items.first.isSkinned()) {
+            skinnedShapeKeys.push_back(items.first);
+        } else {
+            renderItems(sceneContext, renderContext, items.second);
+        }
+    }
+
+    // Reiterate to render the skinned
+    args->_pipeline = shadowSkinnedPipeline;
+    batch.setPipeline(shadowSkinnedPipeline->pipeline);
+    for (const auto& key : skinnedShapeKeys) {
+        renderItems(sceneContext, renderContext, inShapes.at(key));
+    }
+
+    args->_pipeline = nullptr;
+}
+
 void RenderShadowMap::run(const render::SceneContextPointer& sceneContext, const render::RenderContextPointer& renderContext,
                           const render::ShapeBounds& inShapes) {
     assert(renderContext->args);
@@ -38,49 +101,89 @@ void RenderShadowMap::run(const render::SceneContextPointer& sceneContext, const
 
     const auto& lightStage = DependencyManager::get<DeferredLightingEffect>()->getLightStage();
     const auto globalLight = lightStage.lights[0];
-    const auto& shadow = globalLight->shadow;
+    auto& shadow = globalLight->shadow;
+    auto& cascade = shadow.getCascade(_cascade->index);
     const auto& fbo = shadow.framebuffer;
+    const auto& scene = *(sceneContext->_scene);
+
+    // The casters static when the cache was built are drawn from it, so the cache is rebuilt when one of them changed
+    // or when more casters became static since
+    uint32_t frame = scene.getFrame();
+    bool rebuildCache = !cascade.isCacheValid || (int32_t)(scene.getStaticChangeFrame() - cascade.cacheFrame) > 0;
+    for (auto itemsItr = inShapes.begin(); !rebuildCache && itemsItr != inShapes.end(); ++itemsItr) {
+        if (itemsItr->first.isSkinned()) {
+            continue;
+        }
+        for (const auto& item : itemsItr->second) {
+            if (isStaticAt(scene, item, frame) && !isStaticAt(scene, item, cascade.cacheFrame)) {
+                rebuildCache = true;
+                break;
+            }
+        }
+    }
+    if (rebuildCache) {
+        cascade.cacheFrame = frame;
+        cascade.isCacheValid = true;
+    }
+
+    // Skinned shapes deform without changing, they are never cached
+    ShapeBounds cachedShapes;
+    ShapeBounds dynamicShapes;
+    for (const auto& items : inShapes) {
+        if (items.first.isSkinned()) {
+            dynamicShapes[items.first] = items.second;
+            continue;
+        }
+        for (const auto& item : items.second) {
+            if (isStaticAt(scene, item, cascade.cacheFrame)) {
+                cachedShapes[items.first].push_back(item);
+            } else {
+                dynamicShapes[items.first].push_back(item);
+            }
+        }
+    }
+
+    // Nothing to do when the cascade already holds the cache alone
+    bool hasDynamicCasters = !dynamicShapes.empty();
+    if (!rebuildCache && !hasDynamicCasters && !cascade.hasDynamicCasters) {
+        return;
+    }
+    cascade.hasDynamicCasters = hasDynamicCasters;
 
     RenderArgs* args = renderContext->args;
     gpu::doInBatch(args->_context, [&](gpu::Batch& batch) {
         args->_batch = &batch;
 
-        glm::ivec4 viewport{0, 0, fbo->getWidth(), fbo->getHeight()};
-        batch.setViewportTransform(viewport);
-        batch.setStateScissorRect(viewport);
+        if (rebuildCache) {
+            glm::ivec4 cacheViewport{ 0, 0, (int)LightStage::Shadow::MAP_SIZE, (int)LightStage::Shadow::MAP_SIZE };
+            batch.setViewportTransform(cacheViewport);
+            batch.setStateScissorRect(cacheViewport);
 
-        batch.setFramebuffer(fbo);
-        batch.clearFramebuffer(
-            gpu::Framebuffer::BUFFER_COLOR0 | gpu::Framebuffer::BUFFER_DEPTH,
-            vec4(vec3(1.0, 1.0, 1.0), 0.0), 1.0, 0, true);
+            batch.setFramebuffer(cascade.cacheFramebuffer);
+            batch.clearFramebuffer(gpu::Framebuffer::BUFFER_DEPTH, vec4(vec3(1.0, 1.0, 1.0), 0.0), 1.0, 0, true);
 
-        batch.setProjectionTransform(shadow.getProjection());
-        batch.setViewTransform(shadow.getView(), false);
+            batch.setProjectionTransform(cascade.getProjection());
+            batch.setViewTransform(cascade.getView(), false);
 
-        auto shadowPipeline = _shapePlumber->pickPipeline(args, ShapeKey());
-        auto shadowSkinnedPipeline = _shapePlumber->pickPipeline(args, ShapeKey::Builder().withSkinned());
+            renderShapes(sceneContext, renderContext, cachedShapes);
+        }
 
-        std::vector<ShapeKey> skinnedShapeKeys{};
+        const auto& viewport = cascade.getViewport();
+        batch.setViewportTransform(viewport);
+        batch.setStateScissorRect(viewport);
 
-        // Iterate through all inShapes and render the unskinned
-        args->_pipeline = shadowPipeline;
-        batch.setPipeline(shadowPipeline->pipeline);
-        for (auto items : inShapes) {
-            if (items.first.isSkinned()) {
-                skinnedShapeKeys.push_back(items.first);
-            } else {
-                renderItems(sceneContext, renderContext, items.second);
-            }
-        }
+        // Start the cascade from the cached casters
+        batch.setFramebuffer(fbo);
+        batch.setPipeline(getCachePipeline());
+        batch.setResourceTexture(CACHE_MAP_SLOT, cascade.cacheMap);
+        batch.draw(gpu::TRIANGLE_STRIP, 4);
+        batch.setResourceTexture(CACHE_MAP_SLOT, nullptr);
 
-        // Reiterate to render the skinned
-        args->_pipeline = shadowSkinnedPipeline;
-        batch.setPipeline(shadowSkinnedPipeline->pipeline);
-        for (const auto& key : skinnedShapeKeys) {
-            renderItems(sceneContext, renderContext, inShapes.at(key));
-        }
+        batch.setProjectionTransform(cascade.getProjection());
+        batch.setViewTransform(cascade.getView(), false);
+
+        renderShapes(sceneContext, renderContext, dynamicShapes);
 
-        args->_pipeline = nullptr;
         args->_batch = nullptr;
     });
 }
@@ -121,7 +224,7 @@ RenderShadowTask::RenderShadowTask(CullFunctor cullFunctor) {
     const auto sortedShapes = addJob<DepthSortShapes>("DepthSortShadowMap", sortedPipelines);
 
     // GPU jobs: Render to shadow map
-    addJob<RenderShadowMap>("RenderShadowMap", sortedShapes, shapePlumber);
+    addJob<RenderShadowMap>("RenderShadowMap", sortedShapes, shapePlumber, _cascade);
 }
 
 void RenderShadowTask::configure(const Config& configuration) {
@@ -149,23 +252,32 @@ void RenderShadowTask::run(const SceneContextPointer& sceneContext, const render
 
     // Cache old render args
     RenderArgs::RenderMode mode = args->_renderMode;
+    args->_renderMode = RenderArgs::SHADOW_RENDER_MODE;
 
     auto nearClip = args->getViewFrustum().getNearClip();
-    float nearDepth = -args->_boomOffset.z;
-    const int SHADOW_FAR_DEPTH = 20;
-    globalLight->shadow.setKeylightFrustum(args->getViewFrustum(), nearDepth, nearClip + SHADOW_FAR_DEPTH);
+    float nearDepth = std::min(-args->_boomOffset.z, nearClip + 0.5f * CASCADE_FAR_DEPTHS[0]);
 
-    // Set the keylight render args
-    args->pushViewFrustum(*(globalLight->shadow.getFrustum()));
-    args->_renderMode = RenderArgs::SHADOW_RENDER_MODE;
+    // The far cascades are updated every few frames, on different frames
+    ++_frame;
+    for (int i = 0; i < LightStage::Shadow::NUM_CASCADES; ++i) {
+        if ((_frame + i) % CASCADE_UPDATE_PERIODS[i] != 0) {
+            continue;
+        }
+
+        float cascadeNearDepth = (i == 0) ? nearDepth : nearClip + CASCADE_FAR_DEPTHS[i - 1];
+        globalLight->shadow.setKeylightFrustum(i, args->getViewFrustum(), cascadeNearDepth, nearClip + CASCADE_FAR_DEPTHS[i]);
+
+        // Set the keylight render args
+        args->pushViewFrustum(*(globalLight->shadow.getCascade(i).getFrustum()));
+        _cascade->index = i;
+
+        // TODO: Allow runtime manipulation of culling ShouldRenderFunctor
 
-    // TODO: Allow runtime manipulation of culling ShouldRenderFunctor
+        runJobs(sceneContext, renderContext);
 
-    for (auto job : _jobs) {
-        job.run(sceneContext, renderContext);
+        args->popViewFrustum();
     }
 
     // Reset the render args
-    args->popViewFrustum();
     args->_renderMode = mode;
 };
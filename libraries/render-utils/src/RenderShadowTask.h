@@ -19,16 +19,30 @@
 
 class ViewFrustum;
 
+// The shadow cascade being rendered, set by the shadow task for its jobs
+class RenderShadowCascade {
+public:
+    int index { 0 };
+};
+using RenderShadowCascadePointer = std::shared_ptr<RenderShadowCascade>;
+
 class RenderShadowMap {
 public:
     using JobModel = render::Job::ModelI<RenderShadowMap, render::ShapeBounds>;
 
-    RenderShadowMap(render::ShapePlumberPointer shapePlumber) : _shapePlumber{ shapePlumber } {}
+    RenderShadowMap(render::ShapePlumberPointer shapePlumber, RenderShadowCascadePointer cascade) :
+        _shapePlumber{ shapePlumber }, _cascade{ cascade } {}
     void run(const render::SceneContextPointer& sceneContext, const render::RenderContextPointer& renderContext,
              const render::ShapeBounds& inShapes);
 
 protected:
+    void renderShapes(const render::SceneContextPointer& sceneContext, const render::RenderContextPointer& renderContext,
+                      const render::ShapeBounds& inShapes);
+    const gpu::PipelinePointer& getCachePipeline();
+
     render::ShapePlumberPointer _shapePlumber;
+    RenderShadowCascadePointer _cascade;
+    gpu::PipelinePointer _cachePipeline;
 };
 
 class RenderShadowTaskConfig : public render::Task::Config::Persistent {
@@ -50,6 +64,10 @@ public:
 
     void configure(const Config& configuration);
     void run(const render::SceneContextPointer& sceneContext, const render::RenderContextPointer& renderContext);
+
+protected:
+    RenderShadowCascadePointer _cascade { std::make_shared<RenderShadowCascade>() };
+    uint32_t _frame { 0 };
 };
 
 #endif // hifi_RenderShadowTask_h
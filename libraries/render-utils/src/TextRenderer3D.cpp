@@ -70,11 +70,16 @@ float TextRenderer3D::getFontSize() const {
 
 void TextRenderer3D::draw(gpu::Batch& batch, float x, float y, const QString& str, const glm::vec4& color,
                          const glm::vec2& bounds, bool layered) {
+    draw(batch, _drawInfo, x, y, str, color, bounds, layered);
+}
+
+void TextRenderer3D::draw(gpu::Batch& batch, Font::DrawInfo& drawInfo, float x, float y, const QString& str,
+                          const glm::vec4& color, const glm::vec2& bounds, bool layered) {
     // The font does all the OpenGL work
     if (_font) {
         // Cache color so that the pointer stays valid.
         _color = color;
-        _font->drawString(batch, x, y, str, &_color, _effectType, bounds, layered);
+        _font->drawString(batch, drawInfo, x, y, str, &_color, _effectType, bounds, layered);
     }
 }
 
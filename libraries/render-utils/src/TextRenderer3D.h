@@ -16,13 +16,9 @@
 #include <glm/glm.hpp>
 #include <QColor>
 
-namespace gpu {
-class Batch;
-}
-class Font;
-
 #include "text/EffectType.h"
 #include "text/FontFamilies.h"
+#include "text/Font.h"
 
 // TextRenderer3D is actually a fairly thin wrapper around a Font class
 // defined in the cpp file.
@@ -38,6 +34,9 @@ public:
     
     void draw(gpu::Batch& batch, float x, float y, const QString& str, const glm::vec4& color = glm::vec4(1.0f),
               const glm::vec2& bounds = glm::vec2(-1.0f), bool layered = false);
+    // Draws with the glyph quads kept by the caller, for a renderer shared by several text items
+    void draw(gpu::Batch& batch, Font::DrawInfo& drawInfo, float x, float y, const QString& str,
+              const glm::vec4& color = glm::vec4(1.0f), const glm::vec2& bounds = glm::vec2(-1.0f), bool layered = false);
 
 private:
     TextRenderer3D(const char* family, float pointSize, int weight = -1, bool italic = false,
@@ -53,6 +52,9 @@ private:
     glm::vec4 _color;
 
     std::shared_ptr<Font> _font;
+
+    // the glyph quads of the last string drawn by draw() without a DrawInfo
+    Font::DrawInfo _drawInfo;
 };
 
 
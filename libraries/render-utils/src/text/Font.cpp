@@ -261,14 +261,16 @@ void Font::setupGPU() {
     }
 }
 
-void Font::rebuildVertices(float x, float y, const QString& str, const glm::vec2& bounds) {
-    _verticesBuffer = std::make_shared<gpu::Buffer>();
-    _numVertices = 0;
-    _indicesBuffer = std::make_shared<gpu::Buffer>();
-    _numIndices = 0;
+void Font::rebuildVertices(DrawInfo& drawInfo, float x, float y, const QString& str, const glm::vec2& bounds) {
+    drawInfo.string = str;
+    drawInfo.origin = glm::vec2(x, y);
+    drawInfo.bounds = bounds;
 
-    _lastStringRendered = str;
-    _lastBounds = bounds;
+    // The quads are gathered first and uploaded in one go, the buffers of a previous frame may still be in flight
+    std::vector<QuadBuilder> quads;
+    std::vector<quint16> indices;
+    quads.reserve(str.size());
+    indices.reserve(str.size() * NUMBER_OF_INDICES_PER_QUAD);
 
     // Top left of text
     glm::vec2 advance = glm::vec2(x, y);
@@ -302,11 +304,9 @@ void Font::rebuildVertices(float x, float y, const QString& str, const glm::vec2
         if (!isNewLine) {
             for (auto c : token) {
                 auto glyph = _glyphs[c];
-                quint16 verticesOffset = _numVertices;
+                quint16 verticesOffset = (quint16)(quads.size() * VERTICES_PER_QUAD);
 
-                QuadBuilder qd(glyph, advance - glm::vec2(0.0f, _ascent));
-                _verticesBuffer->append(sizeof(QuadBuilder), (const gpu::Byte*)&qd);
-                _numVertices += 4;
+                quads.push_back(QuadBuilder(glyph, advance - glm::vec2(0.0f, _ascent)));
                 
                 // Sam's recommended triangle slices
                 // Triangle tri1 = { v0, v1, v3 };
@@ -325,16 +325,13 @@ void Font::rebuildVertices(float x, float y, const QString& str, const glm::vec2
                 //  0 -- 1
                 //
                 //  { 0, 1, 2 } -> { 2, 1, 3 }
-                quint16 indices[NUMBER_OF_INDICES_PER_QUAD];
-                indices[0] = verticesOffset + 0;
-                indices[1] = verticesOffset + 1;
-                indices[2] = verticesOffset + 2;
-                indices[3] = verticesOffset + 2;
-                indices[4] = verticesOffset + 1;
-                indices[5] = verticesOffset + 3;
-                _indicesBuffer->append(sizeof(indices), (const gpu::Byte*)indices);
-                _numIndices += NUMBER_OF_INDICES_PER_QUAD;
-                
+                indices.push_back(verticesOffset + 0);
+                indices.push_back(verticesOffset + 1);
+                indices.push_back(verticesOffset + 2);
+                indices.push_back(verticesOffset + 2);
+                indices.push_back(verticesOffset + 1);
+                indices.push_back(verticesOffset + 3);
+
 
                 // Advance by glyph size
                 advance.x += glyph.d;
@@ -344,16 +341,23 @@ void Font::rebuildVertices(float x, float y, const QString& str, const glm::vec2
             advance.x += _spaceWidth;
         }
     }
+
+    drawInfo.verticesBuffer = std::make_shared<gpu::Buffer>(quads.size() * sizeof(QuadBuilder), (const gpu::Byte*)quads.data());
+    drawInfo.indicesBuffer = std::make_shared<gpu::Buffer>(indices.size() * sizeof(quint16), (const gpu::Byte*)indices.data());
+    drawInfo.numIndices = (unsigned int)indices.size();
 }
 
-void Font::drawString(gpu::Batch& batch, float x, float y, const QString& str, const glm::vec4* color,
+void Font::drawString(gpu::Batch& batch, DrawInfo& drawInfo, float x, float y, const QString& str, const glm::vec4* color,
                       EffectType effectType, const glm::vec2& bounds, bool layered) {
     if (str == "") {
         return;
     }
 
-    if (str != _lastStringRendered || bounds != _lastBounds) {
-        rebuildVertices(x, y, str, bounds);
+    if (str != drawInfo.string || glm::vec2(x, y) != drawInfo.origin || bounds != drawInfo.bounds) {
+        rebuildVertices(drawInfo, x, y, str, bounds);
+    }
+    if (!drawInfo.numIndices) {
+        return;
     }
 
     setupGPU();
@@ -367,7 +371,7 @@ void Font::drawString(gpu::Batch& batch, float x, float y, const QString& str, c
     batch._glUniform4fv(_colorLoc, 1, (const float*)&lrgba);
 
     batch.setInputFormat(_format);
-    batch.setInputBuffer(0, _verticesBuffer, 0, _format->getChannels().at(0)._stride);
-    batch.setIndexBuffer(gpu::UINT16, _indicesBuffer, 0);
-    batch.drawIndexed(gpu::TRIANGLES, _numIndices, 0);
+    batch.setInputBuffer(0, drawInfo.verticesBuffer, 0, _format->getChannels().at(0)._stride);
+    batch.setIndexBuffer(gpu::UINT16, drawInfo.indicesBuffer, 0);
+    batch.drawIndexed(gpu::TRIANGLES, drawInfo.numIndices, 0);
 }
@@ -19,6 +19,18 @@ class Font {
 public:
     using Pointer = std::shared_ptr<Font>;
 
+    // The glyph quads of a laid out string. Each text item keeps its own, so its vertices are only rebuilt
+    // when its string, origin or bounds change, and not whenever another item draws with the same font
+    struct DrawInfo {
+        gpu::BufferPointer verticesBuffer;
+        gpu::BufferPointer indicesBuffer;
+        unsigned int numIndices { 0 };
+
+        QString string;
+        glm::vec2 origin;
+        glm::vec2 bounds;
+    };
+
     Font();
 
     void read(QIODevice& path);
@@ -27,7 +39,7 @@ public:
     float getFontSize() const { return _fontSize; }
 
     // Render string to batch
-    void drawString(gpu::Batch& batch, float x, float y, const QString& str,
+    void drawString(gpu::Batch& batch, DrawInfo& drawInfo, float x, float y, const QString& str,
         const glm::vec4* color, EffectType effectType,
         const glm::vec2& bound, bool layered = false);
 
@@ -40,7 +52,7 @@ private:
     glm::vec2 computeTokenExtent(const QString& str) const;
 
     const Glyph& getGlyph(const QChar& c) const;
-    void rebuildVertices(float x, float y, const QString& str, const glm::vec2& bounds);
+    void rebuildVertices(DrawInfo& drawInfo, float x, float y, const QString& str, const glm::vec2& bounds);
 
     void setupGPU();
 
@@ -66,19 +78,11 @@ private:
     gpu::PipelinePointer _layeredPipeline;
     gpu::TexturePointer _texture;
     gpu::Stream::FormatPointer _format;
-    gpu::BufferPointer _verticesBuffer;
-    gpu::BufferPointer _indicesBuffer;
     gpu::BufferStreamPointer _stream;
-    unsigned int _numVertices = 0;
-    unsigned int _numIndices = 0;
 
     int _fontLoc = -1;
     int _outlineLoc = -1;
     int _colorLoc = -1;
-
-    // last string render characteristics
-    QString _lastStringRendered;
-    glm::vec2 _lastBounds;
 };
 
 #endif
@@ -13,6 +13,11 @@
 
 #include <algorithm>
 #include <assert.h>
+#include <memory>
+
+#include <QtCore/QRunnable>
+#include <QtCore/QSemaphore>
+#include <QtCore/QThreadPool>
 
 #include <OctreeUtils.h>
 #include <PerfStat.h>
@@ -21,6 +26,21 @@
 
 using namespace render;
 
+// the bounds are tested against the frustum in batches of this size
+static const size_t FRUSTUM_TEST_BATCH_SIZE = 64;
+
+// sets inView[i] to whether bounds[i] intersects the frustum
+static void boundsIntersectFrustum(const ViewFrustum& frustum, const ItemBound* bounds, size_t numBounds, bool* inView) {
+    AABox boxes[FRUSTUM_TEST_BATCH_SIZE];
+    for (size_t begin = 0; begin < numBounds; begin += FRUSTUM_TEST_BATCH_SIZE) {
+        size_t batchSize = std::min(FRUSTUM_TEST_BATCH_SIZE, numBounds - begin);
+        for (size_t i = 0; i < batchSize; i++) {
+            boxes[i] = bounds[begin + i].bound;
+        }
+        frustum.boxesIntersectFrustum(boxes, batchSize, inView + begin);
+    }
+}
+
 void render::cullItems(const RenderContextPointer& renderContext, const CullFunctor& cullFunctor, RenderDetails::Item& details,
                        const ItemBounds& inItems, ItemBounds& outItems) {
     assert(renderContext->args);
@@ -31,8 +51,15 @@ void render::cullItems(const RenderContextPointer& renderContext, const CullFunc
 
     details._considered += (int)inItems.size();
 
+    std::unique_ptr<bool[]> inView(new bool[inItems.size()]);
+    {
+        PerformanceTimer perfTimer("boxIntersectsFrustum");
+        boundsIntersectFrustum(frustum, inItems.data(), inItems.size(), inView.get());
+    }
+
     // Culling / LOD
-    for (auto item : inItems) {
+    for (size_t i = 0; i < inItems.size(); i++) {
+        const auto& item = inItems[i];
         if (item.bound.isNull()) {
             outItems.emplace_back(item); // One more Item to render
             continue;
@@ -40,12 +67,7 @@ void render::cullItems(const RenderContextPointer& renderContext, const CullFunc
 
         // TODO: some entity types (like lights) might want to be rendered even
         // when they are outside of the view frustum...
-        bool inView;
-        {
-            PerformanceTimer perfTimer("boxIntersectsFrustum");
-            inView = frustum.boxIntersectsFrustum(item.bound);
-        }
-        if (inView) {
+        if (inView[i]) {
             bool bigEnoughToRender;
             {
                 PerformanceTimer perfTimer("shouldRender");
@@ -114,6 +136,142 @@ void CullSpatialSelection::configure(const Config& config) {
     _skipCulling = config.skipCulling;
 }
 
+// Culling Frustum / solidAngle test helper class
+struct CullTest {
+    CullFunctor _functor;
+    RenderArgs* _args;
+    RenderDetails::Item& _renderDetails;
+    glm::vec3 _eyePos;
+    float _squareTanAlpha;
+
+    CullTest(const CullFunctor& functor, RenderArgs* pargs, RenderDetails::Item& renderDetails) :
+        _functor(functor),
+        _args(pargs),
+        _renderDetails(renderDetails)
+    {
+        // FIXME: Keep this code here even though we don't use it yet
+        /*_eyePos = _args->getViewFrustum().getPosition();
+        float a = glm::degrees(Octree::getAccuracyAngle(_args->_sizeScale, _args->_boundaryLevelAdjust));
+        auto angle = std::min(glm::radians(45.0f), a); // no worse than 45 degrees
+        angle = std::max(glm::radians(1.0f / 60.0f), a); // no better than 1 minute of degree
+        auto tanAlpha = tan(angle);
+        _squareTanAlpha = (float)(tanAlpha * tanAlpha);
+        */
+    }
+
+    // removes the bounds outside of the frustum from bounds, from index first on
+    void frustumTest(ItemBounds& bounds, size_t first) {
+        bool inView[FRUSTUM_TEST_BATCH_SIZE];
+        size_t numKept = first;
+        for (size_t begin = first; begin < bounds.size(); begin += FRUSTUM_TEST_BATCH_SIZE) {
+            size_t batchSize = std::min(FRUSTUM_TEST_BATCH_SIZE, bounds.size() - begin);
+            boundsIntersectFrustum(_args->getViewFrustum(), bounds.data() + begin, batchSize, inView);
+            for (size_t i = 0; i < batchSize; i++) {
+                if (inView[i]) {
+                    bounds[numKept++] = bounds[begin + i];
+                } else {
+                    _renderDetails._outOfView++;
+                }
+            }
+        }
+        bounds.erase(bounds.begin() + numKept, bounds.end());
+    }
+
+    // removes the bounds too small to render from bounds, from index first on
+    void solidAngleTest(ItemBounds& bounds, size_t first) {
+        size_t numKept = first;
+        for (size_t i = first; i < bounds.size(); i++) {
+            // FIXME: Keep this code here even though we don't use it yet
+            //auto eyeToPoint = bound.calcCenter() - _eyePos;
+            //auto boundSize = bound.getDimensions();
+            //float test = (glm::dot(boundSize, boundSize) / glm::dot(eyeToPoint, eyeToPoint)) - squareTanAlpha;
+            //if (test < 0.0f) {
+            if (_functor(_args, bounds[i].bound)) {
+                bounds[numKept++] = bounds[i];
+            } else {
+                _renderDetails._tooSmall++;
+            }
+        }
+        bounds.erase(bounds.begin() + numKept, bounds.end());
+    }
+};
+
+// the selections with more items than this are culled in chunks of this size on the cull thread pool
+static const size_t CULL_CHUNK_SIZE = 2048;
+
+class CullChunkRunnable : public QRunnable {
+public:
+    CullChunkRunnable(std::function<void()> cull, QSemaphore& done) : _cull(cull), _done(done) {}
+    virtual void run() override {
+        _cull();
+        _done.release();
+    }
+
+private:
+    std::function<void()> _cull;
+    QSemaphore& _done;
+};
+
+static QThreadPool& getCullThreadPool() {
+    // a pool of its own, so the culling never waits behind the background work of the global pool
+    static QThreadPool pool;
+    return pool;
+}
+
+// Appends to outItems the items that pass the filter, then drops those outside of the frustum if testFrustum and those
+// too small to render if testSolidAngle. Every chunk has its own test, output and counts, merged in chunk order once all
+// are done, so the result is the same as that of one loop over the items.
+// The calling thread culls the first chunk, so the functor must only read shared state.
+static void cullItemsInChunks(const Scene& scene, const ItemIDs& ids, const ItemFilter& filter, bool testFrustum,
+                              bool testSolidAngle, const CullFunctor& functor, RenderArgs* args,
+                              RenderDetails::Item& details, ItemBounds& outItems) {
+    auto cullRange = [&](CullTest& test, size_t begin, size_t end, ItemBounds& out) {
+        size_t first = out.size();
+        for (size_t i = begin; i < end; i++) {
+            auto& item = scene.getItem(ids[i]);
+            if (filter.test(item.getKey())) {
+                out.emplace_back(ItemBound(ids[i], item.getBound()));
+            }
+        }
+        if (testFrustum) {
+            test.frustumTest(out, first);
+        }
+        if (testSolidAngle) {
+            test.solidAngleTest(out, first);
+        }
+    };
+
+    size_t numChunks = (ids.size() + CULL_CHUNK_SIZE - 1) / CULL_CHUNK_SIZE;
+    if (numChunks <= 1) {
+        CullTest test(functor, args, details);
+        cullRange(test, 0, ids.size(), outItems);
+        return;
+    }
+
+    std::vector<ItemBounds> chunkItems(numChunks);
+    std::vector<RenderDetails::Item> chunkDetails(numChunks);
+    auto cullChunk = [&](size_t chunk) {
+        CullTest test(functor, args, chunkDetails[chunk]);
+        size_t begin = chunk * CULL_CHUNK_SIZE;
+        size_t end = std::min(begin + CULL_CHUNK_SIZE, ids.size());
+        chunkItems[chunk].reserve(end - begin);
+        cullRange(test, begin, end, chunkItems[chunk]);
+    };
+
+    QSemaphore done;
+    for (size_t chunk = 1; chunk < numChunks; chunk++) {
+        getCullThreadPool().start(new CullChunkRunnable([&cullChunk, chunk] { cullChunk(chunk); }, done));
+    }
+    cullChunk(0);
+    done.acquire((int)numChunks - 1);
+
+    for (size_t chunk = 0; chunk < numChunks; chunk++) {
+        outItems.insert(outItems.end(), chunkItems[chunk].begin(), chunkItems[chunk].end());
+        details._outOfView += chunkDetails[chunk]._outOfView;
+        details._tooSmall += chunkDetails[chunk]._tooSmall;
+    }
+}
+
 void CullSpatialSelection::run(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext,
     const ItemSpatialTree::ItemSelection& inSelection, ItemBounds& outItems) {
     assert(renderContext->args);
@@ -133,51 +291,6 @@ void CullSpatialSelection::run(const SceneContextPointer& sceneContext, const Re
         args->pushViewFrustum(_frozenFrutstum); // replace the true view frustum by the frozen one
     }
 
-    // Culling Frustum / solidAngle test helper class
-    struct Test {
-        CullFunctor _functor;
-        RenderArgs* _args;
-        RenderDetails::Item& _renderDetails;
-        glm::vec3 _eyePos;
-        float _squareTanAlpha;
-
-        Test(CullFunctor& functor, RenderArgs* pargs, RenderDetails::Item& renderDetails) :
-            _functor(functor),
-            _args(pargs),
-            _renderDetails(renderDetails)
-        {
-            // FIXME: Keep this code here even though we don't use it yet
-            /*_eyePos = _args->getViewFrustum().getPosition();
-            float a = glm::degrees(Octree::getAccuracyAngle(_args->_sizeScale, _args->_boundaryLevelAdjust));
-            auto angle = std::min(glm::radians(45.0f), a); // no worse than 45 degrees
-            angle = std::max(glm::radians(1.0f / 60.0f), a); // no better than 1 minute of degree
-            auto tanAlpha = tan(angle);
-            _squareTanAlpha = (float)(tanAlpha * tanAlpha);
-            */
-        }
-
-        bool frustumTest(const AABox& bound) {
-            if (!_args->getViewFrustum().boxIntersectsFrustum(bound)) {
-                _renderDetails._outOfView++;
-                return false;
-            }
-            return true;
-        }
-
-        bool solidAngleTest(const AABox& bound) {
-            // FIXME: Keep this code here even though we don't use it yet
-            //auto eyeToPoint = bound.calcCenter() - _eyePos;
-            //auto boundSize = bound.getDimensions();
-            //float test = (glm::dot(boundSize, boundSize) / glm::dot(eyeToPoint, eyeToPoint)) - squareTanAlpha;
-            //if (test < 0.0f) {
-            if (!_functor(_args, bound)) {
-                _renderDetails._tooSmall++;
-                return false;
-            }
-            return true;
-        }
-    };
-    Test test(_cullFunctor, args, details);
 
     // Now we have a selection of items to render
     outItems.clear();
@@ -254,45 +367,22 @@ void CullSpatialSelection::run(const SceneContextPointer& sceneContext, const Re
         // inside & subcell items: filter & distance cull
         {
             PerformanceTimer perfTimer("insideSmallItems");
-            for (auto id : inSelection.insideSubcellItems) {
-                auto& item = scene->getItem(id);
-                if (_filter.test(item.getKey())) {
-                    ItemBound itemBound(id, item.getBound());
-                    if (test.solidAngleTest(itemBound.bound)) {
-                        outItems.emplace_back(itemBound);
-                    }
-                }
-            }
+            cullItemsInChunks(*scene, inSelection.insideSubcellItems, _filter, false, true, _cullFunctor, args, details,
+                              outItems);
         }
 
         // partial & fit items: filter & frustum cull
         {
             PerformanceTimer perfTimer("partialFitItems");
-            for (auto id : inSelection.partialItems) {
-                auto& item = scene->getItem(id);
-                if (_filter.test(item.getKey())) {
-                    ItemBound itemBound(id, item.getBound());
-                    if (test.frustumTest(itemBound.bound)) {
-                        outItems.emplace_back(itemBound);
-                    }
-                }
-            }
+            cullItemsInChunks(*scene, inSelection.partialItems, _filter, true, false, _cullFunctor, args, details,
+                              outItems);
         }
 
         // partial & subcell items:: filter & frutum cull & solidangle cull
         {
             PerformanceTimer perfTimer("partialSmallItems");
-            for (auto id : inSelection.partialSubcellItems) {
-                auto& item = scene->getItem(id);
-                if (_filter.test(item.getKey())) {
-                    ItemBound itemBound(id, item.getBound());
-                    if (test.frustumTest(itemBound.bound)) {
-                        if (test.solidAngleTest(itemBound.bound)) {
-                            outItems.emplace_back(itemBound);
-                        }
-                    }
-                }
-            }
+            cullItemsInChunks(*scene, inSelection.partialSubcellItems, _filter, true, true, _cullFunctor, args, details,
+                              outItems);
         }
     }
 
@@ -17,6 +17,7 @@
 
 namespace render {
 
+    // CullSpatialSelection calls it from several threads at once for the large selections, it must only read its inputs
     using CullFunctor = std::function<bool(const RenderArgs*, const AABox&)>;
 
     void cullItems(const RenderContextPointer& renderContext, const CullFunctor& cullFunctor, RenderDetails::Item& details,
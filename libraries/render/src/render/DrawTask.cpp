@@ -14,6 +14,10 @@
 #include <algorithm>
 #include <assert.h>
 
+#include <QtCore/QRunnable>
+#include <QtCore/QSemaphore>
+#include <QtCore/QThreadPool>
+
 #include <PerfStat.h>
 #include <ViewFrustum.h>
 #include <gpu/Context.h>
@@ -65,56 +69,159 @@ void render::renderShapes(const SceneContextPointer& sceneContext, const RenderC
     }
 }
 
-void render::renderStateSortShapes(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext,
-    const ShapePlumberPointer& shapeContext, const ItemBounds& inItems, int maxDrawnItems) {
+// Each shape gets a 64 bit sort key: the pipeline in the order it first shows up (16 bits), then the state sort key
+// of the payload, material and mesh (32 bits), then the rank of the item in the depth sorted input (16 bits)
+struct SortedShape {
+    uint64_t key;
+    const Item* item;
+    bool operator<(const SortedShape& other) const { return key < other.key; }
+};
+
+struct SortedShapes {
+    std::vector<render::ShapeKey> pipelines;
+    std::vector<SortedShape> shapes;
+    std::vector<const Item*> ownPipelineBucket;
+};
+
+static void sortShapes(const SceneContextPointer& sceneContext, const ItemBounds& inItems, int maxDrawnItems, SortedShapes& sorted) {
+    using PipelineIndices = std::unordered_map<render::ShapeKey, uint64_t, render::ShapeKey::Hash, render::ShapeKey::KeyEqual>;
+    static const uint64_t MAX_SORT_DEPTH_RANK = 0xffff;
     auto& scene = sceneContext->_scene;
-    RenderArgs* args = renderContext->args;
 
     int numItemsToDraw = (int)inItems.size();
     if (maxDrawnItems != -1) {
         numItemsToDraw = glm::min(numItemsToDraw, maxDrawnItems);
     }
 
-    using SortedPipelines = std::vector<render::ShapeKey>;
-    using SortedShapes = std::unordered_map<render::ShapeKey, std::vector<Item>, render::ShapeKey::Hash, render::ShapeKey::KeyEqual>;
-    SortedPipelines sortedPipelines;
-    SortedShapes sortedShapes;
-    std::vector<Item> ownPipelineBucket;
+    PipelineIndices pipelineIndices;
+    sorted.shapes.reserve(numItemsToDraw);
 
     for (auto i = 0; i < numItemsToDraw; ++i) {
-        auto item = scene->getItem(inItems[i].id);
+        const auto& item = scene->getItem(inItems[i].id);
 
         {
             assert(item.getKey().isShape());
             const auto key = item.getShapeKey();
             if (key.isValid() && !key.hasOwnPipeline()) {
-                auto& bucket = sortedShapes[key];
-                if (bucket.empty()) {
-                    sortedPipelines.push_back(key);
+                auto pipelineIndex = pipelineIndices.find(key);
+                if (pipelineIndex == pipelineIndices.end()) {
+                    pipelineIndex = pipelineIndices.emplace(key, (uint64_t)sorted.pipelines.size()).first;
+                    sorted.pipelines.push_back(key);
                 }
-                bucket.push_back(item);
+                uint64_t sortKey = (pipelineIndex->second << 48) | ((uint64_t)item.getStateSortKey() << 16) |
+                    std::min((uint64_t)i, MAX_SORT_DEPTH_RANK);
+                sorted.shapes.push_back({ sortKey, &item });
             } else if (key.hasOwnPipeline()) {
-                ownPipelineBucket.push_back(item);
+                sorted.ownPipelineBucket.push_back(&item);
             } else {
                 qDebug() << "Item could not be rendered with invalid key" << key;
             }
         }
     }
 
-    // Then render
-    for (auto& pipelineKey : sortedPipelines) {
-        auto& bucket = sortedShapes[pipelineKey];
-        args->_pipeline = shapeContext->pickPipeline(args, pipelineKey);
-        if (!args->_pipeline) {
-            continue;
+    std::sort(sorted.shapes.begin(), sorted.shapes.end());
+}
+
+// Renders the sorted shapes in [begin, end), picking the pipeline only when it changes
+static void renderSortedShapes(RenderArgs* args, const ShapePlumberPointer& shapeContext, const SortedShapes& sorted,
+                               size_t begin, size_t end) {
+    uint64_t pipelineIndex = (uint64_t)-1;
+    for (size_t i = begin; i < end; i++) {
+        auto& shape = sorted.shapes[i];
+        uint64_t shapePipelineIndex = shape.key >> 48;
+        if (shapePipelineIndex != pipelineIndex) {
+            pipelineIndex = shapePipelineIndex;
+            args->_pipeline = shapeContext->pickPipeline(args, sorted.pipelines[pipelineIndex]);
         }
-        for (auto& item : bucket) {
-            item.render(args);
+        if (args->_pipeline) {
+            shape.item->render(args);
         }
     }
     args->_pipeline = nullptr;
-    for (auto& item : ownPipelineBucket) {
-        item.render(args);
+}
+
+void render::renderStateSortShapes(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext,
+    const ShapePlumberPointer& shapeContext, const ItemBounds& inItems, int maxDrawnItems) {
+    RenderArgs* args = renderContext->args;
+
+    SortedShapes sorted;
+    sortShapes(sceneContext, inItems, maxDrawnItems, sorted);
+
+    renderSortedShapes(args, shapeContext, sorted, 0, sorted.shapes.size());
+    for (auto item : sorted.ownPipelineBucket) {
+        item->render(args);
+    }
+}
+
+// below this many shapes per batch the recording is quicker on the one thread
+static const size_t MIN_SHAPES_PER_BATCH = 256;
+
+class RecordBatchRunnable : public QRunnable {
+public:
+    RecordBatchRunnable(std::function<void()> record, QSemaphore& done) : _record(record), _done(done) {}
+    virtual void run() override {
+        _record();
+        _done.release();
+    }
+
+private:
+    std::function<void()> _record;
+    QSemaphore& _done;
+};
+
+static QThreadPool& getRecordThreadPool() {
+    static QThreadPool pool;
+    return pool;
+}
+
+void render::renderStateSortShapesInBatches(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext,
+    const ShapePlumberPointer& shapeContext, const ItemBounds& inItems, int maxDrawnItems, const BatchSetup& batchSetup) {
+    RenderArgs* args = renderContext->args;
+
+    SortedShapes sorted;
+    sortShapes(sceneContext, inItems, maxDrawnItems, sorted);
+
+    // PerformanceTimer is not thread safe, so the batches are only recorded concurrently when it is off
+    size_t numShapes = sorted.shapes.size();
+    size_t maxBatches = (size_t)getRecordThreadPool().maxThreadCount() + 1;
+    size_t numBatches = PerformanceTimer::isActive() ? 1 : std::min(maxBatches, numShapes / MIN_SHAPES_PER_BATCH);
+    numBatches = std::max(numBatches, (size_t)1);
+
+    // Every batch is recorded with its own copy of the args, and the batches of the ranges are appended in order
+    std::vector<gpu::Batch> batches(numBatches);
+    std::vector<RenderArgs> batchArgs(numBatches, *args);
+    auto recordBatch = [&](size_t b) {
+        RenderArgs* recordArgs = &batchArgs[b];
+        recordArgs->_batch = &batches[b];
+        recordArgs->_details = RenderDetails();
+        batchSetup(batches[b]);
+        renderSortedShapes(recordArgs, shapeContext, sorted, (b * numShapes) / numBatches, ((b + 1) * numShapes) / numBatches);
+        recordArgs->_batch = nullptr;
+    };
+
+    QSemaphore done;
+    for (size_t b = 1; b < numBatches; b++) {
+        getRecordThreadPool().start(new RecordBatchRunnable([&recordBatch, b] { recordBatch(b); }, done));
+    }
+    recordBatch(0);
+    done.acquire((int)numBatches - 1);
+
+    for (size_t b = 0; b < numBatches; b++) {
+        args->_details._materialSwitches += batchArgs[b]._details._materialSwitches;
+        args->_details._trianglesRendered += batchArgs[b]._details._trianglesRendered;
+        args->_context->appendFrameBatch(batches[b]);
+    }
+
+    // The shapes with their own pipeline may not be safe to record off the render thread
+    if (!sorted.ownPipelineBucket.empty()) {
+        gpu::doInBatch(args->_context, [&](gpu::Batch& batch) {
+            args->_batch = &batch;
+            batchSetup(batch);
+            for (auto item : sorted.ownPipelineBucket) {
+                item->render(args);
+            }
+            args->_batch = nullptr;
+        });
     }
 }
 
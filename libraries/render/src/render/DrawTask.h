@@ -20,6 +20,12 @@ void renderItems(const SceneContextPointer& sceneContext, const RenderContextPoi
 void renderShapes(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext, const ShapePlumberPointer& shapeContext, const ItemBounds& inItems, int maxDrawnItems = -1);
 void renderStateSortShapes(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext, const ShapePlumberPointer& shapeContext, const ItemBounds& inItems, int maxDrawnItems = -1);
 
+// Same as renderStateSortShapes, but records the sorted shapes in several batches, on worker threads when there are
+// enough of them, and appends the batches to the frame in order. batchSetup starts every batch with the state the
+// shapes expect (viewport, camera, buffers). The payloads of these shapes must be safe to render from several threads.
+using BatchSetup = std::function<void(gpu::Batch& batch)>;
+void renderStateSortShapesInBatches(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext, const ShapePlumberPointer& shapeContext, const ItemBounds& inItems, int maxDrawnItems, const BatchSetup& batchSetup);
+
 
 
 class DrawLightConfig : public Job::Config {
@@ -53,9 +53,7 @@ void Engine::load() {
 }
 
 void Engine::run() {
-    for (auto job : _jobs) {
-        job.run(_sceneContext, _renderContext);
-    }
+    runJobs(_sceneContext, _renderContext);
 
 }
 
@@ -50,6 +50,12 @@ void EngineStats::run(const SceneContextPointer& sceneContext, const RenderConte
     config->frameTextureMemoryUsage = _gpuStats._RSAmountTextureMemoryBounded - gpuStats._RSAmountTextureMemoryBounded;
 
     config->frameSetPipelineCount = _gpuStats._PSNumSetPipelines - gpuStats._PSNumSetPipelines;
+    config->frameSetUniformBufferCount = _gpuStats._RSNumUniformBufferBounded - gpuStats._RSNumUniformBufferBounded;
+    config->frameSetInputFormatCount = _gpuStats._ISNumFormatChanges - gpuStats._ISNumFormatChanges;
+    config->frameSetInputBufferCount = _gpuStats._ISNumInputBufferChanges - gpuStats._ISNumInputBufferChanges;
+
+    config->frameBufferTransferCount = _gpuStats._RSNumBufferTransfers - gpuStats._RSNumBufferTransfers;
+    config->frameBufferTransferMemory = _gpuStats._RSAmountBufferTransferred - gpuStats._RSAmountBufferTransferred;
 
     config->emitDirty();
 }
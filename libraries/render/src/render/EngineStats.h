@@ -48,6 +48,12 @@ namespace render {
         Q_PROPERTY(quint32 frameTextureMemoryUsage MEMBER frameTextureMemoryUsage NOTIFY dirty)
 
         Q_PROPERTY(quint32 frameSetPipelineCount MEMBER frameSetPipelineCount NOTIFY dirty)
+        Q_PROPERTY(quint32 frameSetUniformBufferCount MEMBER frameSetUniformBufferCount NOTIFY dirty)
+        Q_PROPERTY(quint32 frameSetInputFormatCount MEMBER frameSetInputFormatCount NOTIFY dirty)
+        Q_PROPERTY(quint32 frameSetInputBufferCount MEMBER frameSetInputBufferCount NOTIFY dirty)
+
+        Q_PROPERTY(quint32 frameBufferTransferCount MEMBER frameBufferTransferCount NOTIFY dirty)
+        Q_PROPERTY(quint32 frameBufferTransferMemory MEMBER frameBufferTransferMemory NOTIFY dirty)
 
 
     public:
@@ -77,6 +83,12 @@ namespace render {
         qint64 frameTextureMemoryUsage{ 0 };
 
         quint32 frameSetPipelineCount{ 0 };
+        quint32 frameSetUniformBufferCount{ 0 };
+        quint32 frameSetInputFormatCount{ 0 };
+        quint32 frameSetInputBufferCount{ 0 };
+
+        quint32 frameBufferTransferCount{ 0 };
+        qint64 frameBufferTransferMemory{ 0 };
 
 
 
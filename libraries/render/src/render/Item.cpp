@@ -64,9 +64,23 @@ void Item::PayloadInterface::addStatusGetters(const Status::Getters& getters) {
 }
 
 void Item::update(const UpdateFunctorPointer& updateFunctor) {
-    if (updateFunctor) {
+    updatePayload(updateFunctor);
+    updateKey();
+}
+
+void Item::updatePayload(const UpdateFunctorPointer& updateFunctor) {
+    if (updateFunctor && _payload) {
         _payload->update(updateFunctor);
     }
+}
+
+void Item::updatePayloadTransform(const Transform& transform, const Transform& offset) {
+    if (_payload) {
+        _payload->updateTransform(transform, offset);
+    }
+}
+
+void Item::updateKey() {
     _key = _payload->getKey();
 }
 
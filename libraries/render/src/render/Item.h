@@ -23,6 +23,7 @@
 
 #include <AABox.h>
 #include <RenderArgs.h>
+#include <Transform.h>
 
 #include "model/Material.h"
 #include "ShapePipeline.h"
@@ -294,6 +295,7 @@ public:
         virtual void render(RenderArgs* args) = 0;
 
         virtual const ShapeKey getShapeKey() const = 0;
+        virtual uint32_t getStateSortKey() const { return 0; }
 
         ~PayloadInterface() {}
 
@@ -307,6 +309,7 @@ public:
 
         friend class Item;
         virtual void update(const UpdateFunctorPointer& functor) = 0;
+        virtual void updateTransform(const Transform& transform, const Transform& offset) = 0;
     };
     typedef std::shared_ptr<PayloadInterface> PayloadPointer;
 
@@ -317,6 +320,10 @@ public:
     void resetPayload(const PayloadPointer& payload);
     void resetCell(ItemCell cell = INVALID_CELL, bool _small = false) { _cell = cell; _key.setSmaller(_small); }
     void update(const UpdateFunctorPointer& updateFunctor); // communicate update to payload
+    // The two halves of update(): the scene runs the functors on the payloads first, then brings the keys up to date
+    void updatePayload(const UpdateFunctorPointer& updateFunctor);
+    void updatePayloadTransform(const Transform& transform, const Transform& offset);
+    void updateKey();
     void kill() { _payload.reset(); resetCell(); _key._flags.reset(); } // forget the payload, key, cell
 
     // Check heuristic key
@@ -325,6 +332,9 @@ public:
     // Check spatial cell
     const ItemCell& getCell() const { return _cell; }
 
+    // The scene frame the item was last reset or updated on
+    uint32_t getChangeFrame() const { return _changeFrame; }
+
     // Payload Interface
 
     // Get the bound of the item expressed in world space (or eye space depending on the key.isWorldSpace())
@@ -338,6 +348,7 @@ public:
 
     // Shape Type Interface
     const ShapeKey getShapeKey() const { return _payload->getShapeKey(); }
+    uint32_t getStateSortKey() const { return _payload->getStateSortKey(); }
 
     // Access the status
     const StatusPointer& getStatus() const { return _payload->getStatus(); }
@@ -346,6 +357,7 @@ protected:
     PayloadPointer _payload;
     ItemKey _key;
     ItemCell _cell{ INVALID_CELL };
+    uint32_t _changeFrame{ 0 };
 
     friend class Scene;
 };
@@ -378,12 +390,19 @@ template <class T> const ItemKey payloadGetKey(const std::shared_ptr<T>& payload
 template <class T> const Item::Bound payloadGetBound(const std::shared_ptr<T>& payloadData) { return Item::Bound(); }
 template <class T> int payloadGetLayer(const std::shared_ptr<T>& payloadData) { return 0; }
 template <class T> void payloadRender(const std::shared_ptr<T>& payloadData, RenderArgs* args) { }
+// Transform-only updates, see PendingChanges::updateItemTransform(), are applied to the payload through this call,
+// which does nothing unless specialized
+template <class T> void payloadUpdateTransform(const std::shared_ptr<T>& payloadData, const Transform& transform,
+                                               const Transform& offset) { }
 
 // Shape type interface
 // This allows shapes to characterize their pipeline via a ShapeKey, to be picked with a subclass of Shape.
 // When creating a new shape payload you need to create a specialized version, or the ShapeKey will be ownPipeline,
 // implying that the shape will setup its own pipeline without the use of the ShapeKey.
 template <class T> const ShapeKey shapeGetShapeKey(const std::shared_ptr<T>& payloadData) { return ShapeKey::Builder::ownPipeline(); }
+// Within a pipeline, the shapes with the same state sort key are drawn together to spare the state changes between them,
+// a shape payload can return one made from its material (high bits) and mesh (low bits); the default of 0 keeps the order.
+template <class T> uint32_t shapeGetStateSortKey(const std::shared_ptr<T>& payloadData) { return 0; }
 
 template <class T> class Payload : public Item::PayloadInterface {
 public:
@@ -402,6 +421,7 @@ public:
 
     // Shape Type interface
     virtual const ShapeKey getShapeKey() const override { return shapeGetShapeKey<T>(_data); }
+    virtual uint32_t getStateSortKey() const override { return shapeGetStateSortKey<T>(_data); }
 
 protected:
     DataPointer _data;
@@ -410,6 +430,9 @@ protected:
     virtual void update(const UpdateFunctorPointer& functor) override {
         std::static_pointer_cast<Updater>(functor)->_func((*_data));
     }
+    virtual void updateTransform(const Transform& transform, const Transform& offset) override {
+        payloadUpdateTransform<T>(_data, transform, offset);
+    }
     friend class Item;
 };
 
@@ -0,0 +1,194 @@
+//
+//  OcclusionCull.cpp
+//  render/src/render
+//
+//  Created by Sam Gateau on 10/15/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "OcclusionCull.h"
+
+#include <assert.h>
+
+#include <PerfStat.h>
+#include <ViewFrustum.h>
+#include <gpu/Context.h>
+
+#include "drawOcclusionBox_vert.h"
+#include "drawOcclusionBox_frag.h"
+
+using namespace render;
+
+// Entries of the items which left the selection are dropped after that many frames
+static const uint32_t UNUSED_ENTRY_FRAMES = 120;
+
+// The bounds are scaled up a bit, so the faces of a visible item's bound are never behind the item itself
+static const float BOUND_SCALE = 1.02f;
+
+static int drawBoundPosLoc = -1;
+static int drawBoundDimLoc = -1;
+
+bool OcclusionState::isOccluded(ItemID id) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _entries.find(id);
+    return (it != _entries.end()) && !it->second->visible;
+}
+
+OcclusionState::EntryPointer OcclusionState::getEntry(ItemID id) {
+    auto& entry = _entries[id];
+    if (!entry) {
+        entry = std::make_shared<Entry>();
+        // The query outlives the entry in the batches still referencing it, so the handler only holds a weak pointer
+        std::weak_ptr<Entry> weakEntry = entry;
+        entry->query = std::make_shared<gpu::Query>([weakEntry](const gpu::Query& query) {
+            auto entry = weakEntry.lock();
+            if (entry) {
+                entry->visible = query.anySamplesPassed();
+                entry->pending = false;
+            }
+        }, gpu::Query::ANY_SAMPLES_PASSED);
+    }
+    entry->lastUsedFrame = _frame;
+    return entry;
+}
+
+void OcclusionState::dropUnusedEntries() {
+    for (auto it = _entries.begin(); it != _entries.end();) {
+        if (_frame - it->second->lastUsedFrame > UNUSED_ENTRY_FRAMES) {
+            it = _entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+int OcclusionState::recordQueries(gpu::Batch& batch, const ItemBounds& items, const glm::vec3& eyePosition, float nearClip, int maxQueries) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    ++_frame;
+
+    // Pull the results of the queries issued in the previous frames first, the one frame delay keeps the pipeline from stalling
+    for (auto& entry : _entries) {
+        if (entry.second->pending) {
+            batch.getQuery(entry.second->query);
+        }
+    }
+
+    // Walk the items from where the previous frame stopped, so every item is tested again when there are more than maxQueries
+    int numQueries = 0;
+    size_t numItems = items.size();
+    if (_nextQueryIndex >= numItems) {
+        _nextQueryIndex = 0;
+    }
+    for (size_t i = 0; i < numItems && numQueries < maxQueries; ++i) {
+        const auto& item = items[(_nextQueryIndex + i) % numItems];
+        if (item.bound.isNull()) {
+            continue;
+        }
+
+        auto entry = getEntry(item.id);
+
+        // A bound clipped by the near plane can't be tested, the item is visible
+        if (item.bound.touchesSphere(eyePosition, 2.0f * nearClip)) {
+            entry->visible = true;
+            continue;
+        }
+        if (entry->pending) {
+            continue;
+        }
+
+        glm::vec3 dimensions = BOUND_SCALE * item.bound.getScale();
+        glm::vec3 corner = item.bound.getCorner() - 0.5f * (dimensions - item.bound.getScale());
+        batch._glUniform3fv(drawBoundPosLoc, 1, (const float*)(&corner));
+        batch._glUniform3fv(drawBoundDimLoc, 1, (const float*)(&dimensions));
+
+        entry->pending = true;
+        batch.beginQuery(entry->query);
+        batch.draw(gpu::TRIANGLES, 36, 0);
+        batch.endQuery(entry->query);
+        ++numQueries;
+    }
+    _nextQueryIndex = numItems ? (_nextQueryIndex + numQueries) % numItems : 0;
+
+    dropUnusedEntries();
+    return numQueries;
+}
+
+void OcclusionCull::configure(const Config& config) {
+    _state->setEnabled(config.occlusionCulling);
+}
+
+void OcclusionCull::run(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext, const ItemBounds& inItems, ItemBounds& outItems) {
+    PerformanceTimer perfTimer("occlusionCull");
+    outItems.clear();
+
+    if (!_state->isEnabled()) {
+        outItems = inItems;
+        std::static_pointer_cast<Config>(renderContext->jobConfig)->numOccluded = 0;
+        return;
+    }
+
+    outItems.reserve(inItems.size());
+    for (const auto& item : inItems) {
+        if (!_state->isOccluded(item.id)) {
+            outItems.emplace_back(item);
+        }
+    }
+    std::static_pointer_cast<Config>(renderContext->jobConfig)->numOccluded = (int)(inItems.size() - outItems.size());
+}
+
+const gpu::PipelinePointer DrawOcclusionQueries::getQueryPipeline() {
+    static gpu::PipelinePointer queryPipeline;
+    if (!queryPipeline) {
+        auto vs = gpu::Shader::createVertex(std::string(drawOcclusionBox_vert));
+        auto ps = gpu::Shader::createPixel(std::string(drawOcclusionBox_frag));
+        gpu::ShaderPointer program = gpu::Shader::createProgram(vs, ps);
+
+        gpu::Shader::BindingSet slotBindings;
+        gpu::Shader::makeProgram(*program, slotBindings);
+
+        drawBoundPosLoc = program->getUniforms().findLocation("inBoundPos");
+        drawBoundDimLoc = program->getUniforms().findLocation("inBoundDim");
+
+        // Test against the opaque depth without touching it nor the colors
+        auto state = std::make_shared<gpu::State>();
+        state->setDepthTest(true, false, gpu::LESS_EQUAL);
+        state->setCullMode(gpu::State::CULL_NONE);
+        state->setColorWriteMask(false, false, false, false);
+
+        queryPipeline = gpu::Pipeline::create(program, state);
+    }
+    return queryPipeline;
+}
+
+void DrawOcclusionQueries::run(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext, const ItemBounds& inItems) {
+    assert(renderContext->args);
+    assert(renderContext->args->hasViewFrustum());
+    RenderArgs* args = renderContext->args;
+    auto config = std::static_pointer_cast<Config>(renderContext->jobConfig);
+
+    if (!_state->isEnabled()) {
+        config->numQueries = 0;
+        return;
+    }
+
+    gpu::doInBatch(args->_context, [&](gpu::Batch& batch) {
+        glm::mat4 projMat;
+        Transform viewMat;
+        args->getViewFrustum().evalProjectionMatrix(projMat);
+        args->getViewFrustum().evalViewTransform(viewMat);
+        batch.setViewportTransform(args->_viewport);
+        batch.setStateScissorRect(args->_viewport);
+
+        batch.setProjectionTransform(projMat);
+        batch.setViewTransform(viewMat);
+        batch.setModelTransform(Transform());
+
+        batch.setPipeline(getQueryPipeline());
+
+        const auto& frustum = args->getViewFrustum();
+        config->numQueries = _state->recordQueries(batch, inItems, frustum.getPosition(), frustum.getNearClip(), _maxQueries);
+    });
+}
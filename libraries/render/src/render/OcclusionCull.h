@@ -0,0 +1,129 @@
+//
+//  OcclusionCull.h
+//  render/src/render
+//
+//  Created by Sam Gateau on 10/15/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_render_OcclusionCull_h
+#define hifi_render_OcclusionCull_h
+
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
+#include <gpu/Pipeline.h>
+#include <gpu/Query.h>
+
+#include "Engine.h"
+
+namespace render {
+
+    // The occlusion state of the items, shared by the OcclusionCull and DrawOcclusionQueries jobs.
+    // The bounds of the items are drawn against the depth of the opaque pass in occlusion queries,
+    // the results are read back in the following frame and the items found hidden are culled from then on,
+    // until a later query finds them visible again.
+    class OcclusionState {
+    public:
+        class Entry {
+        public:
+            gpu::QueryPointer query;
+            // written by the backend when the query result returns
+            std::atomic<bool> visible { true };
+            std::atomic<bool> pending { false };
+            uint32_t lastUsedFrame { 0 };
+        };
+        using EntryPointer = std::shared_ptr<Entry>;
+
+        bool isEnabled() const { return _enabled; }
+        void setEnabled(bool enabled) { _enabled = enabled; }
+
+        // Returns true if the last query of the item found it hidden
+        bool isOccluded(ItemID id) const;
+
+        // Records the occlusion queries of the items in the batch, at most maxQueries of them, and returns how many it issued
+        int recordQueries(gpu::Batch& batch, const ItemBounds& items, const glm::vec3& eyePosition, float nearClip, int maxQueries);
+
+    protected:
+        EntryPointer getEntry(ItemID id);
+        void dropUnusedEntries();
+
+        mutable std::mutex _mutex;
+        std::unordered_map<ItemID, EntryPointer> _entries;
+        std::atomic<bool> _enabled { true };
+        uint32_t _frame { 0 };
+        size_t _nextQueryIndex { 0 };
+    };
+    using OcclusionStatePointer = std::shared_ptr<OcclusionState>;
+
+    class OcclusionCullConfig : public Job::Config {
+        Q_OBJECT
+        Q_PROPERTY(bool occlusionCulling MEMBER occlusionCulling WRITE setOcclusionCulling)
+        Q_PROPERTY(int numOccluded READ getNumOccluded)
+    public:
+        bool occlusionCulling{ true };
+
+        int numOccluded{ 0 };
+        int getNumOccluded() const { return numOccluded; }
+
+    public slots:
+        void setOcclusionCulling(bool enabled) { occlusionCulling = enabled; emit dirty(); }
+
+    signals:
+        void dirty();
+    };
+
+    // Filters out the items hidden at the last occlusion query
+    class OcclusionCull {
+    public:
+        using Config = OcclusionCullConfig;
+        using JobModel = Job::ModelIO<OcclusionCull, ItemBounds, ItemBounds, Config>;
+
+        OcclusionCull(const OcclusionStatePointer& state) : _state(state) {}
+
+        void configure(const Config& config);
+        void run(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext, const ItemBounds& inItems, ItemBounds& outItems);
+
+    protected:
+        OcclusionStatePointer _state;
+    };
+
+    class DrawOcclusionQueriesConfig : public Job::Config {
+        Q_OBJECT
+        Q_PROPERTY(int maxQueries MEMBER maxQueries NOTIFY dirty)
+        Q_PROPERTY(int numQueries READ getNumQueries)
+    public:
+        int maxQueries{ 2048 };
+
+        int numQueries{ 0 };
+        int getNumQueries() const { return numQueries; }
+
+    signals:
+        void dirty();
+    };
+
+    // Draws the bounds of the items in occlusion queries, in the framebuffer bound holding the depth of the opaque pass.
+    // It must be given the items before the OcclusionCull, so the hidden items are tested again.
+    class DrawOcclusionQueries {
+    public:
+        using Config = DrawOcclusionQueriesConfig;
+        using JobModel = Job::ModelI<DrawOcclusionQueries, ItemBounds, Config>;
+
+        DrawOcclusionQueries(const OcclusionStatePointer& state) : _state(state) {}
+
+        void configure(const Config& config) { _maxQueries = config.maxQueries; }
+        void run(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext, const ItemBounds& inItems);
+
+        static const gpu::PipelinePointer getQueryPipeline();
+
+    protected:
+        OcclusionStatePointer _state;
+        int _maxQueries{ 2048 };
+    };
+}
+
+#endif // hifi_render_OcclusionCull_h
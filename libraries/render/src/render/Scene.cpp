@@ -34,12 +34,71 @@ void PendingChanges::updateItem(ItemID id, const UpdateFunctorPointer& functor)
     _updateFunctors.push_back(functor);
 }
 
+void PendingChanges::updateItemTransform(ItemID id, const Transform& transform, const Transform& offset) {
+    _transformUpdates.push_back({ id, transform, offset });
+}
+
 void PendingChanges::merge(PendingChanges& changes) {
     _resetItems.insert(_resetItems.end(), changes._resetItems.begin(), changes._resetItems.end());
     _resetPayloads.insert(_resetPayloads.end(), changes._resetPayloads.begin(), changes._resetPayloads.end());
     _removedItems.insert(_removedItems.end(), changes._removedItems.begin(), changes._removedItems.end());
     _updatedItems.insert(_updatedItems.end(), changes._updatedItems.begin(), changes._updatedItems.end());
     _updateFunctors.insert(_updateFunctors.end(), changes._updateFunctors.begin(), changes._updateFunctors.end());
+    _transformUpdates.insert(_transformUpdates.end(), changes._transformUpdates.begin(), changes._transformUpdates.end());
+}
+
+void PendingChanges::merge(PendingChanges&& changes) {
+    _resetItems.insert(_resetItems.end(), changes._resetItems.begin(), changes._resetItems.end());
+    _resetPayloads.insert(_resetPayloads.end(), std::make_move_iterator(changes._resetPayloads.begin()),
+                          std::make_move_iterator(changes._resetPayloads.end()));
+    _removedItems.insert(_removedItems.end(), changes._removedItems.begin(), changes._removedItems.end());
+    _updatedItems.insert(_updatedItems.end(), changes._updatedItems.begin(), changes._updatedItems.end());
+    _updateFunctors.insert(_updateFunctors.end(), std::make_move_iterator(changes._updateFunctors.begin()),
+                           std::make_move_iterator(changes._updateFunctors.end()));
+    _transformUpdates.insert(_transformUpdates.end(), changes._transformUpdates.begin(), changes._transformUpdates.end());
+}
+
+void PendingChanges::clear() {
+    _resetItems.clear();
+    _resetPayloads.clear();
+    _removedItems.clear();
+    _updatedItems.clear();
+    _updateFunctors.clear();
+    _transformUpdates.clear();
+}
+
+PendingChangesQueue::~PendingChangesQueue() {
+    Node* node = _head.exchange(nullptr);
+    while (node) {
+        Node* next = node->next;
+        delete node;
+        node = next;
+    }
+}
+
+void PendingChangesQueue::push(PendingChanges&& changes) {
+    Node* node = new Node { std::move(changes), _head.load(std::memory_order_relaxed) };
+    while (!_head.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed)) {
+    }
+}
+
+void PendingChangesQueue::consolidate(PendingChanges& batch) {
+    // take the whole list, newest first, and reverse it
+    Node* node = _head.exchange(nullptr, std::memory_order_acquire);
+    Node* oldest = nullptr;
+    while (node) {
+        Node* next = node->next;
+        node->next = oldest;
+        oldest = node;
+        node = next;
+    }
+
+    while (oldest) {
+        Node* next = oldest->next;
+        batch.merge(std::move(oldest->changes));
+        delete oldest;
+        oldest = next;
+    }
 }
 
 Scene::Scene(glm::vec3 origin, float size) :
@@ -63,30 +122,25 @@ bool Scene::isAllocatedID(const ItemID& id) {
 
 /// Enqueue change batch to the scene
 void Scene::enqueuePendingChanges(const PendingChanges& pendingChanges) {
-    _changeQueueMutex.lock();
-    _changeQueue.push(pendingChanges);
-    _changeQueueMutex.unlock();
+    _changeQueue.push(PendingChanges(pendingChanges));
 }
 
-void consolidateChangeQueue(PendingChangesQueue& queue, PendingChanges& singleBatch) {
-    while (!queue.empty()) {
-        auto pendingChanges = queue.front();
-        singleBatch.merge(pendingChanges);
-        queue.pop();
-    };
+void Scene::enqueuePendingChanges(PendingChanges&& pendingChanges) {
+    _changeQueue.push(std::move(pendingChanges));
 }
- 
+
 void Scene::processPendingChangesQueue() {
     PROFILE_RANGE(__FUNCTION__);
-    _changeQueueMutex.lock();
-    PendingChanges consolidatedPendingChanges;
-    consolidateChangeQueue(_changeQueue, consolidatedPendingChanges);
-    _changeQueueMutex.unlock();
-    
+    auto& changes = _consolidatedChanges;
+    _changeQueue.consolidate(changes);
+
+    // Here we should be able to check the value of last ItemID allocated
+    // and allocate new items accordingly
+    ItemID maxID = _IDAllocator.load();
+
     _itemsMutex.lock();
-        // Here we should be able to check the value of last ItemID allocated 
-        // and allocate new items accordingly
-        ItemID maxID = _IDAllocator.load();
+        ++_frame;
+
         if (maxID > _items.size()) {
             _items.resize(maxID + 100); // allocate the maxId and more
         }
@@ -94,22 +148,46 @@ void Scene::processPendingChangesQueue() {
         // capture anything coming from the pendingChanges
 
         // resets and potential NEW items
-        resetItems(consolidatedPendingChanges._resetItems, consolidatedPendingChanges._resetPayloads);
+        _masterSpatialTree.beginBatch();
+        resetItems(changes._resetItems, changes._resetPayloads);
+        _masterSpatialTree.endBatch();
 
         // Update the numItemsAtomic counter AFTER the reset changes went through
         _numAllocatedItems.exchange(maxID);
+    _itemsMutex.unlock();
+
+    // The update functors only touch their payloads, so they run without holding the items
+    updatePayloads(changes._updatedItems, changes._updateFunctors);
+    updatePayloads(changes._transformUpdates);
+
+    _itemsMutex.lock();
+        // the cells emptied by the updates and removes are only cleaned once they all went through
+        _masterSpatialTree.beginBatch();
 
-        // updates
-        updateItems(consolidatedPendingChanges._updatedItems, consolidatedPendingChanges._updateFunctors);
+        // updates, the keys and cells of the items catch up with their payloads
+        updateItems(changes._updatedItems);
+        updateItems(changes._transformUpdates);
 
         // removes
-        removeItems(consolidatedPendingChanges._removedItems);
+        removeItems(changes._removedItems);
+
+        _masterSpatialTree.endBatch();
 
         // Update the numItemsAtomic counter AFTER the pending changes went through
         _numAllocatedItems.exchange(maxID);
 
      // ready to go back to rendering activities
     _itemsMutex.unlock();
+
+    // the functors and payloads of the changes are released outside of the lock
+    changes.clear();
+}
+
+void Scene::markItemChanged(Item& item) {
+    if (item._payload && isItemStatic(item)) {
+        _staticChangeFrame = _frame;
+    }
+    item._changeFrame = _frame;
 }
 
 void Scene::resetItems(const ItemIDs& ids, Payloads& payloads) {
@@ -119,6 +197,7 @@ void Scene::resetItems(const ItemIDs& ids, Payloads& payloads) {
         auto& item = _items[resetID];
         auto oldKey = item.getKey();
         auto oldCell = item.getCell();
+        markItemChanged(item);
 
         // Reset the item with a new payload
         item.resetPayload(*resetPayload);
@@ -144,6 +223,7 @@ void Scene::removeItems(const ItemIDs& ids) {
         auto& item = _items[removedID];
         auto oldCell = item.getCell();
         auto oldKey = item.getKey();
+        markItemChanged(item);
 
         // Remove the item
         if (oldKey.isSpatial()) {
@@ -157,46 +237,68 @@ void Scene::removeItems(const ItemIDs& ids) {
     }
 }
 
-void Scene::updateItems(const ItemIDs& ids, UpdateFunctors& functors) {
-
+void Scene::updatePayloads(const ItemIDs& ids, const UpdateFunctors& functors) {
     auto updateFunctor = functors.begin();
     for (auto updateID : ids) {
-        if (updateID == Item::INVALID_ITEM_ID) {
-            updateFunctor++;
-            continue;
+        if (updateID != Item::INVALID_ITEM_ID) {
+            _items[updateID].updatePayload(*updateFunctor);
         }
+        updateFunctor++;
+    }
+}
 
-        // Access the true item
-        auto& item = _items[updateID];
-        auto oldCell = item.getCell();
-        auto oldKey = item.getKey();
+void Scene::updatePayloads(const TransformUpdates& updates) {
+    for (auto& update : updates) {
+        if (update.id != Item::INVALID_ITEM_ID) {
+            _items[update.id].updatePayloadTransform(update.transform, update.offset);
+        }
+    }
+}
 
-        // Update the item
-        item.update((*updateFunctor));
-        auto newKey = item.getKey();
+void Scene::updateItems(const ItemIDs& ids) {
+    for (auto updateID : ids) {
+        if (updateID != Item::INVALID_ITEM_ID) {
+            updateItem(updateID);
+        }
+    }
+}
 
-        // Update the item's container
-        if (oldKey.isSpatial() == newKey.isSpatial()) {
-            if (newKey.isSpatial()) {
-                auto newCell = _masterSpatialTree.resetItem(oldCell, oldKey, item.getBound(), updateID, newKey);
-                item.resetCell(newCell, newKey.isSmall());
-            }
-        } else {
-            if (newKey.isSpatial()) {
-                _masterNonspatialSet.erase(updateID);
+void Scene::updateItems(const TransformUpdates& updates) {
+    for (auto& update : updates) {
+        if (update.id != Item::INVALID_ITEM_ID) {
+            updateItem(update.id);
+        }
+    }
+}
+
+void Scene::updateItem(ItemID updateID) {
+    // Access the true item
+    auto& item = _items[updateID];
+    auto oldCell = item.getCell();
+    auto oldKey = item.getKey();
+    markItemChanged(item);
 
-                auto newCell = _masterSpatialTree.resetItem(oldCell, oldKey, item.getBound(), updateID, newKey);
-                item.resetCell(newCell, newKey.isSmall());
-            } else {
-                _masterSpatialTree.removeItem(oldCell, oldKey, updateID);
-                item.resetCell();
+    // Update the item, its payload was already updated
+    item.updateKey();
+    auto newKey = item.getKey();
 
-                _masterNonspatialSet.insert(updateID);
-            }
+    // Update the item's container
+    if (oldKey.isSpatial() == newKey.isSpatial()) {
+        if (newKey.isSpatial()) {
+            auto newCell = _masterSpatialTree.resetItem(oldCell, oldKey, item.getBound(), updateID, newKey);
+            item.resetCell(newCell, newKey.isSmall());
         }
+    } else {
+        if (newKey.isSpatial()) {
+            _masterNonspatialSet.erase(updateID);
 
+            auto newCell = _masterSpatialTree.resetItem(oldCell, oldKey, item.getBound(), updateID, newKey);
+            item.resetCell(newCell, newKey.isSmall());
+        } else {
+            _masterSpatialTree.removeItem(oldCell, oldKey, updateID);
+            item.resetCell();
 
-        // next loop
-        updateFunctor++;
+            _masterNonspatialSet.insert(updateID);
+        }
     }
 }
@@ -19,11 +19,17 @@ namespace render {
 
 class Engine;
 
-class PendingChanges {
+// A transform-only update of an item: plain data, so unlike an update functor it allocates nothing of its own
+class TransformUpdate {
 public:
-    PendingChanges() {}
-    ~PendingChanges() {}
+    ItemID id;
+    Transform transform;
+    Transform offset;
+};
+using TransformUpdates = std::vector<TransformUpdate>;
 
+class PendingChanges {
+public:
     void resetItem(ItemID id, const PayloadPointer& payload);
     void removeItem(ItemID id);
 
@@ -34,17 +40,46 @@ public:
     void updateItem(ItemID id, const UpdateFunctorPointer& functor);
     void updateItem(ItemID id) { updateItem(id, nullptr); }
 
+    // Prefer this to an update functor when only the transform of the item changes, see payloadUpdateTransform()
+    void updateItemTransform(ItemID id, const Transform& transform, const Transform& offset);
+
     void merge(PendingChanges& changes);
+    void merge(PendingChanges&& changes);
+
+    // Empties the changes but keeps the capacity of the containers
+    void clear();
 
     ItemIDs _resetItems; 
     Payloads _resetPayloads;
     ItemIDs _removedItems;
     ItemIDs _updatedItems;
     UpdateFunctors _updateFunctors;
+    TransformUpdates _transformUpdates;
 
 protected:
 };
-typedef std::queue<PendingChanges> PendingChangesQueue;
+
+// Multi-producer, single-consumer queue of the pending changes.
+// Enqueuing is a compare and swap on the head of a list, and the consumer takes the whole list at once,
+// so neither side ever waits on the other
+class PendingChangesQueue {
+public:
+    PendingChangesQueue() {}
+    ~PendingChangesQueue();
+
+    void push(PendingChanges&& changes);
+
+    // Moves all of the queued changes into the batch, in the order they were pushed
+    void consolidate(PendingChanges& batch);
+
+private:
+    class Node {
+    public:
+        PendingChanges changes;
+        Node* next;
+    };
+    std::atomic<Node*> _head { nullptr };
+};
 
 
 // Scene is a container for Items
@@ -66,8 +101,9 @@ public:
     // THis is the total number of allocated items, this a threadsafe call
     size_t getNumItems() const { return _numAllocatedItems.load(); }
 
-    // Enqueue change batch to the scene
+    // Enqueue change batch to the scene, this a threadsafe and lock free call
     void enqueuePendingChanges(const PendingChanges& pendingChanges);
+    void enqueuePendingChanges(PendingChanges&& pendingChanges);
 
     // Process the penging changes equeued
     void processPendingChangesQueue();
@@ -84,13 +120,24 @@ public:
     // Access non-spatialized items (overlays, backgrounds)
     const ItemIDSet& getNonspatialSet() const { return _masterNonspatialSet; }
 
+    // The frames count the flushes of the pending changes.
+    // An item is static once it went STATIC_FRAME_COUNT frames without a change
+    static const uint32_t STATIC_FRAME_COUNT = 60;
+    uint32_t getFrame() const { return _frame; }
+    bool isItemStatic(const Item& item) const { return (_frame - item.getChangeFrame()) >= STATIC_FRAME_COUNT; }
+
+    // The last frame a static item was reset, updated or removed on, so caches of the static items know to rebuild
+    uint32_t getStaticChangeFrame() const { return _staticChangeFrame; }
+
 protected:
     // Thread safe elements that can be accessed from anywhere
     std::atomic<unsigned int> _IDAllocator{ 1 }; // first valid itemID will be One
     std::atomic<unsigned int> _numAllocatedItems{ 1 }; // num of allocated items, matching the _items.size()
-    std::mutex _changeQueueMutex;
     PendingChangesQueue _changeQueue;
 
+    // The changes being processed, kept from frame to frame for the capacity of their containers
+    PendingChanges _consolidatedChanges;
+
     // The actual database
     // database of items is protected for editing by a mutex
     std::mutex _itemsMutex;
@@ -98,9 +145,17 @@ protected:
     ItemSpatialTree _masterSpatialTree;
     ItemIDSet _masterNonspatialSet;
 
+    uint32_t _frame{ STATIC_FRAME_COUNT };
+    uint32_t _staticChangeFrame{ 0 };
+
+    void markItemChanged(Item& item);
     void resetItems(const ItemIDs& ids, Payloads& payloads);
     void removeItems(const ItemIDs& ids);
-    void updateItems(const ItemIDs& ids, UpdateFunctors& functors);
+    void updatePayloads(const ItemIDs& ids, const UpdateFunctors& functors);
+    void updatePayloads(const TransformUpdates& updates);
+    void updateItems(const ItemIDs& ids);
+    void updateItems(const TransformUpdates& updates);
+    void updateItem(ItemID id);
 
     friend class Engine;
 };
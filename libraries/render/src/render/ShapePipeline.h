@@ -12,6 +12,7 @@
 #ifndef hifi_render_ShapePipeline_h
 #define hifi_render_ShapePipeline_h
 
+#include <mutex>
 #include <unordered_set>
 
 #include <gpu/Batch.h>
@@ -278,6 +279,8 @@ protected:
     PipelineMap _pipelineMap;
 
 private:
+    // pickPipeline can be called from several threads recording their own batches
+    mutable std::mutex _missingKeysMutex;
     mutable std::unordered_set<Key, Key::Hash, Key::KeyEqual> _missingKeys;
 };
 
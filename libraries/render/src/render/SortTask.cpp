@@ -13,6 +13,9 @@
 #include "ShapePipeline.h"
 
 #include <assert.h>
+#include <limits>
+
+#include <Radix2InplaceSort.h>
 #include <ViewFrustum.h>
 
 using namespace render;
@@ -40,19 +43,11 @@ struct BackToFrontSort {
     }
 };
 
-void render::depthSortItems(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext, bool frontToBack, const ItemBounds& inItems, ItemBounds& outItems) {
-    assert(renderContext->args);
-    assert(renderContext->args->hasViewFrustum());
-
+static void depthSortFewItems(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext, bool frontToBack,
+                              const ItemBounds& inItems, ItemBounds& outItems) {
     auto& scene = sceneContext->_scene;
     RenderArgs* args = renderContext->args;
 
-
-    // Allocate and simply copy
-    outItems.clear();
-    outItems.reserve(inItems.size());
-
-
     // Make a local dataset of the center distance and closest point distance
     std::vector<ItemBoundSort> itemBoundSorts;
     itemBoundSorts.reserve(outItems.size());
@@ -80,6 +75,127 @@ void render::depthSortItems(const SceneContextPointer& sceneContext, const Rende
     }
 }
 
+// the depths are quantized to this many bits for the radix sort, finer than the order of rendering needs
+static const int DEPTH_KEY_BITS = 16;
+static const uint32_t MAX_DEPTH_KEY = (1u << DEPTH_KEY_BITS) - 1;
+// below this many items the comparison sort is as quick
+static const size_t MIN_RADIX_SORT_ITEMS = 256;
+// the insertion sort from the last order gives up for the radix sort past this many moves per item
+static const size_t MAX_INSERTION_MOVES_PER_ITEM = 4;
+
+struct DepthKey {
+    uint32_t key;
+    uint32_t index; // in the input items
+};
+
+struct DepthKeyScanner {
+    typedef uint32_t state_type;
+
+    state_type initial_state() const { return 1u << (DEPTH_KEY_BITS - 1); }
+    bool advance(state_type& s) const { return (s >>= 1) != 0u; }
+    bool bit(const DepthKey& v, const state_type& s) const { return (v.key & s) != 0u; }
+};
+
+// \return false, with the keys partly sorted, if the keys are too far from sorted for it to be worth it
+static bool insertionSort(std::vector<DepthKey>& keys) {
+    size_t maxMoves = MAX_INSERTION_MOVES_PER_ITEM * keys.size();
+    size_t numMoves = 0;
+    for (size_t i = 1; i < keys.size(); i++) {
+        DepthKey key = keys[i];
+        size_t j = i;
+        for (; j > 0 && keys[j - 1].key > key.key; j--) {
+            keys[j] = keys[j - 1];
+        }
+        keys[j] = key;
+        numMoves += i - j;
+        if (numMoves > maxMoves) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void render::depthSortItems(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext, bool frontToBack,
+                            const ItemBounds& inItems, ItemBounds& outItems, DepthSortHistory* history) {
+    assert(renderContext->args);
+    assert(renderContext->args->hasViewFrustum());
+
+    RenderArgs* args = renderContext->args;
+
+    // Allocate and simply copy
+    outItems.clear();
+    outItems.reserve(inItems.size());
+
+    if (!history && inItems.size() < MIN_RADIX_SORT_ITEMS) {
+        depthSortFewItems(sceneContext, renderContext, frontToBack, inItems, outItems);
+        return;
+    }
+
+    std::vector<float> depths;
+    depths.reserve(inItems.size());
+    float minDepth = std::numeric_limits<float>::max();
+    float maxDepth = 0.0f;
+    for (auto& itemDetails : inItems) {
+        float depth = args->getViewFrustum().distanceToCamera(itemDetails.bound.calcCenter());
+        minDepth = std::min(minDepth, depth);
+        maxDepth = std::max(maxDepth, depth);
+        depths.push_back(depth);
+    }
+    float scale = maxDepth > minDepth ? (float)MAX_DEPTH_KEY / (maxDepth - minDepth) : 0.0f;
+    auto computeKey = [&](size_t i) {
+        uint32_t key = std::min((uint32_t)((depths[i] - minDepth) * scale), MAX_DEPTH_KEY);
+        return DepthKey { frontToBack ? key : MAX_DEPTH_KEY - key, (uint32_t)i };
+    };
+
+    std::vector<DepthKey> keys;
+    keys.reserve(inItems.size());
+    bool isSorted = false;
+    if (history && !history->order.empty()) {
+        // from one frame to the next few items change places: start from the last order, the items that were
+        // not in it at the end, and insertion sort what moved
+        auto& slots = history->slots;
+        for (size_t i = 0; i < inItems.size(); i++) {
+            ItemID id = inItems[i].id;
+            if (id >= slots.size()) {
+                slots.resize(id + 1, 0);
+            }
+            slots[id] = (uint32_t)i + 1;
+        }
+        for (auto id : history->order) {
+            if (id < slots.size() && slots[id] != 0) {
+                keys.push_back(computeKey(slots[id] - 1));
+                slots[id] = 0;
+            }
+        }
+        for (size_t i = 0; i < inItems.size(); i++) {
+            ItemID id = inItems[i].id;
+            if (slots[id] != 0) {
+                keys.push_back(computeKey(i));
+                slots[id] = 0;
+            }
+        }
+        isSorted = insertionSort(keys);
+    } else {
+        for (size_t i = 0; i < inItems.size(); i++) {
+            keys.push_back(computeKey(i));
+        }
+    }
+    if (!isSorted) {
+        radix2InplaceSort(keys.begin(), keys.end(), DepthKeyScanner());
+    }
+
+    for (auto& key : keys) {
+        outItems.emplace_back(inItems[key.index]);
+    }
+    if (history) {
+        history->order.clear();
+        history->order.reserve(outItems.size());
+        for (auto& item : outItems) {
+            history->order.push_back(item.id);
+        }
+    }
+}
+
 void PipelineSortShapes::run(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext, const ItemBounds& inItems, ShapeBounds& outShapes) {
     auto& scene = sceneContext->_scene;
     outShapes.clear();
@@ -116,5 +232,5 @@ void DepthSortShapes::run(const SceneContextPointer& sceneContext, const RenderC
 }
 
 void DepthSortItems::run(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext, const ItemBounds& inItems, ItemBounds& outItems) {
-    depthSortItems(sceneContext, renderContext, _frontToBack, inItems, outItems);
+    depthSortItems(sceneContext, renderContext, _frontToBack, inItems, outItems, &_history);
 }
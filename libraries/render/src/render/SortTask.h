@@ -15,7 +15,16 @@
 #include "Engine.h"
 
 namespace render {
-    void depthSortItems(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext, bool frontToBack, const ItemBounds& inItems, ItemBounds& outItems);
+    // The order of the last sort of a list of items, for the next one to start from
+    struct DepthSortHistory {
+        ItemIDs order;
+        std::vector<uint32_t> slots; // indexed by ItemID, all zero between sorts
+    };
+
+    // The large lists are sorted on their quantized depths, in linear time, and a list with a history is insertion
+    // sorted from its last order as long as few items change places
+    void depthSortItems(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext, bool frontToBack,
+                        const ItemBounds& inItems, ItemBounds& outItems, DepthSortHistory* history = nullptr);
 
     class PipelineSortShapes {
     public:
@@ -41,6 +50,9 @@ namespace render {
         DepthSortItems(bool frontToBack = true) : _frontToBack(frontToBack) {}
 
         void run(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext, const ItemBounds& inItems, ItemBounds& outItems);
+
+    protected:
+        DepthSortHistory _history;
     };
 }
 
@@ -34,6 +34,8 @@ const float Octree::INV_DEPTH_DIM[] = {
     1.0f / 16384.0f,
     1.0f / 32768.0f };
 
+const float Octree::LOOSE_CELL_MARGIN = 0.25f;
+
 /*
 const float Octree::COORD_SUBCELL_WIDTH[] = { // 2 ^ MAX_DEPTH / 2 ^ (depth + 1)
     16384.0f,
@@ -210,6 +212,38 @@ Octree::Indices Octree::indexCellPath(const Locations& path) {
     return cellPath;
 }
 
+Octree::Index Octree::indexCell(const Location& loc) {
+    Index currentIndex = ROOT_CELL;
+
+    // Walk down from the root, allocating the missing cells on the way
+    for (Depth depth = ROOT_DEPTH + 1; depth <= loc.depth; depth++) {
+        Location location(loc.pos >> Coord3(loc.depth - depth), depth);
+        Index nextIndex = _cells[currentIndex].child(location.octant());
+        if (nextIndex == INVALID_CELL) {
+            nextIndex = allocateCell(currentIndex, location);
+            if (nextIndex == INVALID_CELL) {
+                // no more cellID available
+                return INVALID_CELL;
+            }
+        }
+        currentIndex = nextIndex;
+    }
+
+    return currentIndex;
+}
+
+void Octree::endBatch() {
+    _batching = false;
+
+    for (auto cellIdx : _emptiedCells) {
+        // The cell may already be freed along with the branch of another
+        if (checkCellIndex(cellIdx) && (cellIdx == ROOT_CELL || getConcreteCell(cellIdx).hasParent())) {
+            cleanCellBranch(cellIdx);
+        }
+    }
+    _emptiedCells.clear();
+}
+
 Octree::Index Octree::allocateBrick() {
     if (_freeBricks.empty()) {
         Index brickIdx = (int)_bricks.size();
@@ -283,6 +317,13 @@ Octree::Location ItemSpatialTree::evalLocation(const AABox& bound, Coord3f& minC
     return Location::evalFromRange(minCoord, maxCoord);
 }
 
+bool ItemSpatialTree::isInLooseCell(const Location& loc, const Coord3f& minCoordf, const Coord3f& maxCoordf) const {
+    float cellWidth = getDepthDimensionf(METRIC_COORD_DEPTH - loc.depth);
+    Coord3f looseMin = Coord3f(loc.pos) * cellWidth - Coord3f(LOOSE_CELL_MARGIN * cellWidth);
+    Coord3f looseMax = looseMin + Coord3f((1.0f + 2.0f * LOOSE_CELL_MARGIN) * cellWidth);
+    return glm::all(glm::greaterThanEqual(minCoordf, looseMin)) && glm::all(glm::lessThanEqual(maxCoordf, looseMax));
+}
+
 Octree::Locations ItemSpatialTree::evalLocations(const ItemBounds& bounds) const {
     Locations locations;
     Coord3f minCoordf, maxCoordf;
@@ -354,9 +395,13 @@ bool ItemSpatialTree::removeItem(Index cellIdx, const ItemKey& key, const ItemID
         success = true;
     }, false); // do not create brick!
 
-    // Because we know the cell is now empty, lets try to clean the octree here
+    // Because we know the cell is now empty, lets try to clean the octree here, or at the end of the batch
     if (emptyCell) {
-        cleanCellBranch(cellIdx);
+        if (_batching) {
+            _emptiedCells.push_back(cellIdx);
+        } else {
+            cleanCellBranch(cellIdx);
+        }
     }
 
     return success;
@@ -368,6 +413,17 @@ ItemSpatialTree::Index ItemSpatialTree::resetItem(Index oldCell, const ItemKey&
         Coord3f minCoordf, maxCoordf;
         auto location = evalLocation(bound, minCoordf, maxCoordf);
 
+        // A moving item stays in its cell while its bound is within the loose bound of the cell, unless it now fits
+        // in a deeper cell, so that small moves across the cell boundaries cost nothing
+        if (oldCell != INVALID_CELL) {
+            const auto& oldLocation = getConcreteCell(oldCell).getlocation();
+            if ((location == oldLocation) ||
+                (location.depth <= oldLocation.depth && isInLooseCell(oldLocation, minCoordf, maxCoordf))) {
+                location = oldLocation;
+                newCell = oldCell;
+            }
+        }
+
         // Compare range size vs cell location size and tag itemKey accordingly
         // If Item bound fits in sub cell then tag as small
         auto rangeSizef = maxCoordf - minCoordf;
@@ -379,7 +435,9 @@ ItemSpatialTree::Index ItemSpatialTree::resetItem(Index oldCell, const ItemKey&
             newKey.setSmaller(false);
         }
 
-        newCell = indexCell(location);
+        if (newCell == INVALID_CELL) {
+            newCell = indexCell(location);
+        }
     } else {
         // A very rare case, if we were adding items with boundary semantic expressed in view space
     }
@@ -465,8 +523,10 @@ Octree::Location::Intersection Octree::Location::intersectCell(const Location& c
         }
     };
 
+    // The items may overhang their cell by the loose margin
     Coord3f cellSize = Coord3f(Octree::getInvDepthDimension(cell.depth));
-    Coord3f cellPos = Coord3f(cell.pos) * cellSize;
+    Coord3f cellPos = Coord3f(cell.pos) * cellSize - cellSize * LOOSE_CELL_MARGIN;
+    cellSize *= (1.0f + 2.0f * LOOSE_CELL_MARGIN);
 
     bool partialFlag = false;
     for (int p = 0; p < ViewFrustum::NUM_PLANES; p++) {
@@ -32,6 +32,7 @@ namespace render {
         std::vector<ItemID> items;
         std::vector<ItemID> subcellItems;
 
+        // A freed brick is pooled for reuse and keeps the capacity of its item lists
         void free() {};
     };
 
@@ -99,6 +100,10 @@ namespace render {
         static float getInvDepthDimension(Depth depth) { return INV_DEPTH_DIM[depth]; }
         static float getCoordSubcellWidth(Depth depth) { return (1.7320f * getInvDepthDimension(depth) * 0.5f); }
 
+        // The cells are loose: a moving item stays in its cell while its bound overhangs the cell by less than this
+        // fraction of the cell width, and the cells are tested for selection with that margin
+        static const float LOOSE_CELL_MARGIN;
+
         // Need 16bits integer coordinates on each axes: 32768 cell positions
         using Coord = int16_t;
         using Coord3 = glm::i16vec3;
@@ -255,7 +260,8 @@ namespace render {
         // Indexing/Allocating the cells as the tree gets populated
         // Return the cell Index/Indices at the specified location/path, allocate all the cells on the path from the root if needed
         Indices indexCellPath(const Locations& path);
-        Index indexCell(const Location& loc) { return indexCellPath(Location::pathTo(loc)).back(); }
+        // Same as indexCellPath(Location::pathTo(loc)).back() but without allocating the path
+        Index indexCell(const Location& loc);
 
         // Same as indexCellPath except that NO cells are allocated, only the COncrete cells previously allocated
         // the returned indices stops at the last existing cell on the requested path.
@@ -339,7 +345,12 @@ namespace render {
 
         int getNumAllocatedCells() const { return (int)_cells.size(); }
         int getNumFreeCells() const { return (int)_freeCells.size(); }
-            
+
+        // Between beginBatch() and endBatch() the cells left empty are only cleaned at endBatch(), so the cells that
+        // the moving items of a batch leave and enter are neither freed nor reallocated
+        void beginBatch() { _batching = true; }
+        void endBatch();
+
     protected:
         Index allocateCell(Index parent, const Location& location);
         void freeCell(Index index);
@@ -358,6 +369,9 @@ namespace render {
         Bricks _bricks;
         Indices _freeCells; // stack of free cells to be reused for allocation
         Indices _freeBricks; // stack of free bricks to be reused for allocation
+
+        bool _batching { false };
+        Indices _emptiedCells; // cells left empty during the current batch
     };
 }
 
@@ -432,6 +446,9 @@ namespace render {
         // Eval the cell location for a given arbitrary Bound,
         // if the Bound crosses any of the Octree planes then the root cell is returned
         Location evalLocation(const AABox& bound, Coord3f& minCoordf, Coord3f& maxCoordf) const;
+
+        // Check that a range of metric coordinates is within the loose bound of a cell
+        bool isInLooseCell(const Location& loc, const Coord3f& minCoordf, const Coord3f& maxCoordf) const;
         Locations evalLocations(const ItemBounds& bounds) const;
 
         // Managing itemsInserting items in cells
@@ -9,7 +9,12 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
+
+#include <QtCore/QRunnable>
+#include <QtCore/QSemaphore>
 #include <QtCore/QThread>
+#include <QtCore/QThreadPool>
 
 #include "Task.h"
 
@@ -24,3 +29,98 @@ void TaskConfig::refresh() {
     _task->configure(*this);
 }
 
+
+void Varying::collectData(std::vector<const void*>& data) const {
+    if (!_concept) {
+        return;
+    }
+    data.push_back(_concept.get());
+    uint8_t numSubVaryings = length();
+    for (uint8_t i = 0; i < numSubVaryings; i++) {
+        (*this)[i].collectData(data);
+    }
+}
+
+bool Varying::sharesDataWith(const Varying& other) const {
+    std::vector<const void*> data;
+    std::vector<const void*> otherData;
+    collectData(data);
+    other.collectData(otherData);
+    for (auto item : data) {
+        if (std::find(otherData.begin(), otherData.end(), item) != otherData.end()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+class JobRunnable : public QRunnable {
+public:
+    JobRunnable(std::function<void()> run, QSemaphore& done) : _run(run), _done(done) {}
+    virtual void run() override {
+        _run();
+        _done.release();
+    }
+
+private:
+    std::function<void()> _run;
+    QSemaphore& _done;
+};
+
+static QThreadPool& getJobThreadPool() {
+    static QThreadPool pool;
+    return pool;
+}
+
+static bool sharesDataWithAny(const Job& job, const Task::Jobs& jobs, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+        const Job& other = jobs[i];
+        if (job.getInput().sharesDataWith(other.getOutput()) || job.getOutput().sharesDataWith(other.getInput()) ||
+            job.getOutput().sharesDataWith(other.getOutput())) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void Task::runJobs(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext) {
+    size_t numJobs = _jobs.size();
+    size_t i = 0;
+    while (i < numJobs) {
+        // the run of concurrent jobs ends at the first job that is not, or that needs the work of one in the run
+        size_t end = i + 1;
+        if (_jobs[i].isConcurrent()) {
+            while (end < numJobs && _jobs[end].isConcurrent() && !sharesDataWithAny(_jobs[end], _jobs, i, end)) {
+                end++;
+            }
+        }
+        if (end == i + 1) {
+            _jobs[i].run(sceneContext, renderContext);
+            i = end;
+            continue;
+        }
+
+        // every job gets its own context, the job config is set in it for the time of the run
+        size_t numConcurrentJobs = end - i;
+        std::vector<RenderContextPointer> contexts(numConcurrentJobs);
+        std::vector<quint64> runUsecs(numConcurrentJobs);
+        for (size_t j = 0; j < numConcurrentJobs; j++) {
+            contexts[j] = std::make_shared<RenderContext>(*renderContext);
+        }
+        auto runJob = [&](size_t j) {
+            runUsecs[j] = _jobs[i + j].runOnWorker(sceneContext, contexts[j]);
+        };
+
+        QSemaphore done;
+        for (size_t j = 1; j < numConcurrentJobs; j++) {
+            getJobThreadPool().start(new JobRunnable([&runJob, j] { runJob(j); }, done));
+        }
+        runJob(0);
+        done.acquire((int)numConcurrentJobs - 1);
+
+        for (size_t j = 0; j < numConcurrentJobs; j++) {
+            _jobs[i + j].recordWorkerRun(runUsecs[j]);
+        }
+        i = end;
+    }
+}
@@ -12,6 +12,8 @@
 #ifndef hifi_render_Task_h
 #define hifi_render_Task_h
 #include <tuple>
+#include <type_traits>
+#include <vector>
 
 #include <QtCore/qobject.h>
 
@@ -55,7 +57,27 @@ public:
     template <class T> Varying getN (uint8_t index) const { return get<T>()[index]; }
     template <class T> Varying editN (uint8_t index) { return edit<T>()[index]; }
 
+    // whether the two are, or contain, any of the same data
+    bool sharesDataWith(const Varying& other) const;
+
 protected:
+    void collectData(std::vector<const void*>& data) const;
+
+    // the sets and arrays of varyings expose the varyings they hold, so the Task can find the data its jobs share
+    template <class T> static auto subVarying(const T& data, uint8_t index, int) -> typename std::enable_if<
+        std::is_same<typename std::decay<decltype(data[index])>::type, Varying>::value, Varying>::type {
+        return data[index];
+    }
+    template <class T> static Varying subVarying(const T&, uint8_t, ...) { return Varying(); }
+    template <class T> static auto numSubVaryings(const T& data, int) -> decltype((uint8_t)data.length()) {
+        return data.length();
+    }
+    template <class T> static auto numSubVaryings(const T& data, long) -> typename std::enable_if<
+        std::is_same<typename T::value_type, Varying>::value, uint8_t>::type {
+        return (uint8_t)data.size();
+    }
+    template <class T> static uint8_t numSubVaryings(const T&, ...) { return 0; }
+
     class Concept {
     public:
         virtual ~Concept() = default;
@@ -70,11 +92,8 @@ protected:
         Model(const Data& data) : _data(data) {}
         virtual ~Model() = default;
 
-        virtual Varying operator[] (uint8_t index) const override {
-            Varying var;
-            return var;
-        }
-        virtual uint8_t length() const override { return 0; }
+        virtual Varying operator[] (uint8_t index) const override { return subVarying(_data, index, 0); }
+        virtual uint8_t length() const override { return numSubVaryings(_data, 0); }
 
         Data _data;
     };
@@ -524,6 +543,10 @@ public:
 
     Job(std::string name, ConceptPointer concept) : _concept(concept), _name(name) {}
 
+    // a concurrent job may run on a worker thread, alongside the other concurrent jobs it shares no data with
+    bool isConcurrent() const { return _isConcurrent; }
+    void setConcurrent(bool isConcurrent) { _isConcurrent = isConcurrent; }
+
     const Varying getInput() const { return _concept->getInput(); }
     const Varying getOutput() const { return _concept->getOutput(); }
     QConfigPointer& getConfiguration() const { return _concept->getConfiguration(); }
@@ -545,9 +568,28 @@ public:
         _concept->setCPURunTime((double)(usecTimestampNow() - start) / 1000.0);
     }
 
+    // PerformanceTimer is not thread safe, so a job run on a worker thread returns its run time to be recorded
+    // by recordWorkerRun() once back on the thread of the task
+    quint64 runOnWorker(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext) {
+        PROFILE_RANGE(_name.c_str());
+        auto start = usecTimestampNow();
+
+        _concept->run(sceneContext, renderContext);
+
+        return usecTimestampNow() - start;
+    }
+
+    void recordWorkerRun(quint64 usecs) {
+        if (PerformanceTimer::isActive()) {
+            PerformanceTimer::addTimerRecord(PerformanceTimer::getContextName() + "/" + _name.c_str(), usecs);
+        }
+        _concept->setCPURunTime((double)usecs / 1000.0);
+    }
+
     protected:
     ConceptPointer _concept;
     std::string _name = "";
+    bool _isConcurrent { false };
 };
 
 // A task is a specialized job to run a collection of other jobs
@@ -620,6 +662,22 @@ public:
         return addJob<T>(name, input, std::forward<A>(args)...);
     }
 
+    // Create a new job that only reads the scene and its input and writes its output, so it can run on a worker thread;
+    // it must not record a gpu::Batch, use a PerformanceTimer, or change the RenderArgs
+    template <class T, class... A> const Varying addConcurrentJob(std::string name, const Varying& input, A&&... args) {
+        const auto output = addJob<T>(name, input, std::forward<A>(args)...);
+        _jobs.back().setConcurrent(true);
+        return output;
+    }
+    template <class T, class... A> const Varying addConcurrentJob(std::string name, A&&... args) {
+        const auto input = Varying(typename T::JobModel::Input());
+        return addConcurrentJob<T>(name, input, std::forward<A>(args)...);
+    }
+
+    // Runs the jobs in order, except that each run of concurrent jobs with no data in common is spread over the
+    // worker threads, and waited on before the next job
+    void runJobs(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext);
+
     template <class C> void createConfiguration() {
         auto config = std::make_shared<C>();
         if (_config) {
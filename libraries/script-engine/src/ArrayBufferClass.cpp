@@ -80,6 +80,8 @@ QScriptValue ArrayBufferClass::newInstance(qint32 size) {
 }
 
 QScriptValue ArrayBufferClass::newInstance(const QByteArray& ba) {
+    // The buffer shares the storage of ba, until either side writes to it
+    engine()->reportAdditionalMemoryCost(ba.size());
     QScriptValue data = engine()->newVariant(QVariant::fromValue(ba));
     return engine()->newObject(this, data);
 }
@@ -150,6 +152,21 @@ QScriptValue ArrayBufferClass::toScriptValue(QScriptEngine* engine, const QByteA
 }
 
 void ArrayBufferClass::fromScriptValue(const QScriptValue& obj, QByteArray& ba) {
-    ba = qvariant_cast<QByteArray>(obj.data().toVariant());
+    QScriptValue data = obj.data();
+    QScriptValue viewBuffer = data.property(BUFFER_PROPERTY_NAME);
+    if (viewBuffer.isValid()) {
+        // A typed array or a data view, that shares its buffer when it views all of it
+        QByteArray buffer = qvariant_cast<QByteArray>(viewBuffer.data().toVariant());
+        qint32 byteOffset = data.property(BYTE_OFFSET_PROPERTY_NAME).toInt32();
+        qint32 byteLength = data.property(BYTE_LENGTH_PROPERTY_NAME).toInt32();
+        if (byteOffset == 0 && byteLength == buffer.size()) {
+            ba = buffer;
+        } else {
+            ba = buffer.mid(byteOffset, byteLength);
+        }
+        return;
+    }
+    // Shares the storage of the ArrayBuffer, the native side copies it only if it writes to it
+    ba = qvariant_cast<QByteArray>(data.toVariant());
 }
 
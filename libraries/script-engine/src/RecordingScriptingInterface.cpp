@@ -55,6 +55,18 @@ float RecordingScriptingInterface::playerLength() const {
 bool RecordingScriptingInterface::loadRecording(const QString& url) {
     using namespace recording;
 
+    // local recordings are mapped rather than read into memory
+    QUrl clipURL(url);
+    if (clipURL.isLocalFile()) {
+        auto clip = Clip::fromFile(clipURL.toLocalFile());
+        if (!clip) {
+            qWarning() << "Clip failed to load from " << url;
+            return false;
+        }
+        _player->queueClip(clip);
+        return true;
+    }
+
     auto loader = ClipCache::instance().getClipLoader(url);
     if (!loader->isLoaded()) {
         QEventLoop loop;
@@ -75,7 +87,7 @@ bool RecordingScriptingInterface::loadRecording(const QString& url) {
 
 void RecordingScriptingInterface::startPlaying() {
     if (QThread::currentThread() != thread()) {
-        QMetaObject::invokeMethod(this, "startPlaying", Qt::BlockingQueuedConnection);
+        QMetaObject::invokeMethod(this, "startPlaying", Qt::QueuedConnection);
         return;
     }
 
@@ -92,7 +104,7 @@ void RecordingScriptingInterface::setPlayerAudioOffset(float audioOffset) {
 
 void RecordingScriptingInterface::setPlayerTime(float time) {
     if (QThread::currentThread() != thread()) {
-        QMetaObject::invokeMethod(this, "setPlayerTime", Qt::BlockingQueuedConnection, Q_ARG(float, time));
+        QMetaObject::invokeMethod(this, "setPlayerTime", Qt::QueuedConnection, Q_ARG(float, time));
         return;
     }
     _player->seek(time);
@@ -124,7 +136,7 @@ void RecordingScriptingInterface::setPlayerUseSkeletonModel(bool useSkeletonMode
 
 void RecordingScriptingInterface::pausePlayer() {
     if (QThread::currentThread() != thread()) {
-        QMetaObject::invokeMethod(this, "pausePlayer", Qt::BlockingQueuedConnection);
+        QMetaObject::invokeMethod(this, "pausePlayer", Qt::QueuedConnection);
         return;
     }
     _player->pause();
@@ -132,7 +144,7 @@ void RecordingScriptingInterface::pausePlayer() {
 
 void RecordingScriptingInterface::stopPlaying() {
     if (QThread::currentThread() != thread()) {
-        QMetaObject::invokeMethod(this, "stopPlaying", Qt::BlockingQueuedConnection);
+        QMetaObject::invokeMethod(this, "stopPlaying", Qt::QueuedConnection);
         return;
     }
     _player->stop();
@@ -153,7 +165,7 @@ void RecordingScriptingInterface::startRecording() {
     }
 
     if (QThread::currentThread() != thread()) {
-        QMetaObject::invokeMethod(this, "startRecording", Qt::BlockingQueuedConnection);
+        QMetaObject::invokeMethod(this, "startRecording", Qt::QueuedConnection);
         return;
     }
 
@@ -161,6 +173,12 @@ void RecordingScriptingInterface::startRecording() {
 }
 
 void RecordingScriptingInterface::stopRecording() {
+    if (QThread::currentThread() != thread()) {
+        // queued behind the commands before it, so that it can't overtake startRecording()
+        QMetaObject::invokeMethod(this, "stopRecording", Qt::QueuedConnection);
+        return;
+    }
+
     _recorder->stop();
     _lastClip = _recorder->getClip();
     _lastClip->seek(0);
@@ -168,7 +186,7 @@ void RecordingScriptingInterface::stopRecording() {
 
 void RecordingScriptingInterface::saveRecording(const QString& filename) {
     if (QThread::currentThread() != thread()) {
-        QMetaObject::invokeMethod(this, "saveRecording", Qt::BlockingQueuedConnection,
+        QMetaObject::invokeMethod(this, "saveRecording", Qt::QueuedConnection,
             Q_ARG(QString, filename));
         return;
     }
@@ -224,7 +242,7 @@ bool RecordingScriptingInterface::saveRecordingToAsset(QScriptValue getClipAtpUr
 
 void RecordingScriptingInterface::loadLastRecording() {
     if (QThread::currentThread() != thread()) {
-        QMetaObject::invokeMethod(this, "loadLastRecording", Qt::BlockingQueuedConnection);
+        QMetaObject::invokeMethod(this, "loadLastRecording", Qt::QueuedConnection);
         return;
     }
 
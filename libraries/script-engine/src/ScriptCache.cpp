@@ -78,6 +78,32 @@ QString ScriptCache::getScript(const QUrl& unnormalizedURL, ScriptUser* scriptUs
     return scriptContents;
 }
 
+bool ScriptCache::getCachedProgram(QScriptEngine* engine, const QString& sourceCode, const QString& fileName,
+                                   int lineNumber, QScriptProgram& program) {
+    Lock lock(_containerLock);
+    auto engineIt = _programs.constFind(engine);
+    if (engineIt == _programs.constEnd()) {
+        return false;
+    }
+    auto it = engineIt->constFind(ProgramKey(fileName, lineNumber));
+    if (it == engineIt->constEnd() || it->sourceCode() != sourceCode) {
+        return false;
+    }
+    program = *it;
+    return true;
+}
+
+void ScriptCache::cacheProgram(QScriptEngine* engine, const QScriptProgram& program) {
+    Lock lock(_containerLock);
+    // a file that changed replaces its old program
+    _programs[engine][ProgramKey(program.fileName(), program.firstLineNumber())] = program;
+}
+
+void ScriptCache::releasePrograms(QScriptEngine* engine) {
+    Lock lock(_containerLock);
+    _programs.remove(engine);
+}
+
 void ScriptCache::deleteScript(const QUrl& unnormalizedURL) {
     QUrl url = ResourceManager::normalizeURL(unnormalizedURL);
     Lock lock(_containerLock);
@@ -13,8 +13,13 @@
 #define hifi_ScriptCache_h
 
 #include <mutex>
+
+#include <QtScript/QScriptProgram>
+
 #include <ResourceCache.h>
 
+class QScriptEngine;
+
 using contentAvailableCallback = std::function<void(const QString& scriptOrURL, const QString& contents, bool isURL, bool contentAvailable)>;
 
 class ScriptUser {
@@ -49,7 +54,15 @@ public:
     // FIXME - how do we remove a script from the bad script list in the case of a redownload?
     void addScriptToBadScriptList(const QUrl& url) { _badScripts.insert(url); }
     bool isInBadScriptList(const QUrl& url) { return _badScripts.contains(url); }
-    
+
+    // Programs an engine has compiled, so that evaluating the same source again (an entity script that many entities
+    // share, or an include) does not parse it again. Qt keeps the compiled form of a program for the engine that
+    // evaluated it, so programs are kept per engine. Returns false if there is none for this source, file and line.
+    bool getCachedProgram(QScriptEngine* engine, const QString& sourceCode, const QString& fileName, int lineNumber,
+                          QScriptProgram& program);
+    void cacheProgram(QScriptEngine* engine, const QScriptProgram& program);
+    void releasePrograms(QScriptEngine* engine); // when the engine is going away
+
 private slots:
     void scriptDownloaded(); // old version
     void scriptContentAvailable(); // new version
@@ -63,6 +76,9 @@ private:
     QHash<QUrl, QString> _scriptCache;
     QMultiMap<QUrl, ScriptUser*> _scriptUsers;
     QSet<QUrl> _badScripts;
+
+    using ProgramKey = QPair<QString, int>; // file name and first line
+    QHash<QScriptEngine*, QHash<ProgramKey, QScriptProgram>> _programs;
 };
 
 #endif // hifi_ScriptCache_h
@@ -9,6 +9,7 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
 #include <chrono>
 #include <thread>
 
@@ -40,6 +41,7 @@
 #include <PathUtils.h>
 #include <ResourceScriptingInterface.h>
 #include <NodeList.h>
+#include <Trace.h>
 #include <udt/PacketHeaders.h>
 #include <UUID.h>
 #include <ui/Menu.h>
@@ -57,6 +59,7 @@
 #include "ScriptCache.h"
 #include "ScriptEngineLogging.h"
 #include "ScriptEngine.h"
+#include "ScriptProfiler.h"
 #include "TypedArrays.h"
 #include "XMLHttpRequestClass.h"
 #include "WebSocketClass.h"
@@ -163,7 +166,8 @@ ScriptEngine::ScriptEngine(const QString& scriptContents, const QString& fileNam
     _scriptContents(scriptContents),
     _timerFunctionMap(),
     _fileNameString(fileNameString),
-    _arrayBufferClass(new ArrayBufferClass(this))
+    _arrayBufferClass(new ArrayBufferClass(this)),
+    _profiler(new ScriptProfiler(this))
 {
     DependencyManager::get<ScriptEngines>()->addScriptEngine(this);
 
@@ -183,6 +187,11 @@ ScriptEngine::~ScriptEngine() {
     } else {
         qCWarning(scriptengine) << "Script destroyed after ScriptEngines!";
     }
+
+    auto scriptCache = DependencyManager::get<ScriptCache>();
+    if (scriptCache) {
+        scriptCache->releasePrograms(this);
+    }
 }
 
 void ScriptEngine::disconnectNonEssentialSignals() {
@@ -491,6 +500,7 @@ void ScriptEngine::init() {
     qScriptRegisterMetaType(this, RayToAvatarIntersectionResultToScriptValue, RayToAvatarIntersectionResultFromScriptValue);
     qScriptRegisterSequenceMetaType<QVector<QUuid>>(this);
     qScriptRegisterSequenceMetaType<QVector<EntityItemID>>(this);
+    qScriptRegisterSequenceMetaType<QVector<EntityItemProperties>>(this);
 
     qScriptRegisterSequenceMetaType<QVector<glm::vec2> >(this);
     qScriptRegisterSequenceMetaType<QVector<glm::quat> >(this);
@@ -805,14 +815,23 @@ QScriptValue ScriptEngine::evaluate(const QString& sourceCode, const QString& fi
         return result;
     }
 
-    // Check syntax
-    const QScriptProgram program(sourceCode, fileName, lineNumber);
-    if (!hasCorrectSyntax(program)) {
-        return QScriptValue();
+    // Check syntax, unless this engine already compiled the same program
+    auto scriptCache = DependencyManager::get<ScriptCache>();
+    QScriptProgram program;
+    if (!scriptCache->getCachedProgram(this, sourceCode, fileName, lineNumber, program)) {
+        program = QScriptProgram(sourceCode, fileName, lineNumber);
+        if (!hasCorrectSyntax(program)) {
+            return QScriptValue();
+        }
+        scriptCache->cacheProgram(this, program);
     }
 
     ++_evaluatesPending;
-    const auto result = QScriptEngine::evaluate(program);
+    QScriptValue result;
+    {
+        ScriptProfiler::CallSource callSource(_profiler, "evaluate");
+        result = QScriptEngine::evaluate(program);
+    }
     --_evaluatesPending;
 
     const auto hadUncaughtException = hadUncaughtExceptions(*this, program.fileName());
@@ -923,7 +942,10 @@ void ScriptEngine::run() {
             float deltaTime = (float) (now - _lastUpdate) / (float) USECS_PER_SECOND;
             if (!_isFinished) {
                 auto preUpdate = clock::now();
-                emit update(deltaTime);
+                {
+                    ScriptProfiler::CallSource callSource(_profiler, "update");
+                    emit update(deltaTime);
+                }
                 auto postUpdate = clock::now();
                 auto elapsed = (postUpdate - preUpdate);
                 totalUpdates += std::chrono::duration_cast<std::chrono::microseconds>(elapsed);
@@ -1058,6 +1080,7 @@ void ScriptEngine::timerFired() {
 
     // call the associated JS function, if it exists
     if (timerData.function.isValid()) {
+        ScriptProfiler::CallSource callSource(_profiler, "timer");
         callWithEnvironment(timerData.definingEntityIdentifier, timerData.definingSandboxURL, timerData.function, timerData.function, QScriptValueList());
     }
 }
@@ -1310,6 +1333,7 @@ void ScriptEngine::forwardHandlerCall(const EntityItemID& entityID, const QStrin
             // and the entity scripts may be for entities other than the one this is a handler for.
             // Fortunately, the definingEntityIdentifier captured the entity script id (if any) when the handler was added.
             CallbackData& handler = handlersForEvent[i];
+            ScriptProfiler::CallSource callSource(_profiler, "entityEvent");
             callWithEnvironment(handler.definingEntityIdentifier, handler.definingSandboxURL, handler.function, QScriptValue(), eventHandlerArgs);
         }
     }
@@ -1362,59 +1386,65 @@ void ScriptEngine::entityScriptContentAvailable(const EntityItemID& entityID, co
     bool isFileUrl = isURL && scriptOrURL.startsWith("file://");
     auto fileName = isURL ? scriptOrURL : "EmbeddedEntityScript";
 
-    QScriptProgram program(contents, fileName);
-    if (!hasCorrectSyntax(program)) {
-        if (!isFileUrl) {
-            scriptCache->addScriptToBadScriptList(scriptOrURL);
+    // this engine checks a script the first time it compiles it, which the other entities using the script can skip
+    QScriptProgram program;
+    if (!scriptCache->getCachedProgram(this, contents, fileName, 1, program)) {
+        program = QScriptProgram(contents, fileName);
+        if (!hasCorrectSyntax(program)) {
+            if (!isFileUrl) {
+                scriptCache->addScriptToBadScriptList(scriptOrURL);
+            }
+            return; // done processing script
         }
-        return; // done processing script
-    }
 
-    if (isURL) {
-        setParentURL(scriptOrURL);
-    }
+        const int SANDBOX_TIMEOUT = 0.25 * MSECS_PER_SECOND;
+        QScriptEngine sandbox;
+        sandbox.setProcessEventsInterval(SANDBOX_TIMEOUT);
+        QScriptValue testConstructor;
+        {
+            QTimer timeout;
+            timeout.setSingleShot(true);
+            timeout.start(SANDBOX_TIMEOUT);
+            connect(&timeout, &QTimer::timeout, [&sandbox, SANDBOX_TIMEOUT]{
+                auto context = sandbox.currentContext();
+                if (context) {
+                    // Guard against infinite loops and non-performant code
+                    context->throwError(QString("Timed out (entity constructors are limited to %1ms)").arg(SANDBOX_TIMEOUT));
+                }
+            });
+            testConstructor = sandbox.evaluate(program);
+        }
+        if (hadUncaughtExceptions(sandbox, program.fileName())) {
+            return;
+        }
 
-    const int SANDBOX_TIMEOUT = 0.25 * MSECS_PER_SECOND;
-    QScriptEngine sandbox;
-    sandbox.setProcessEventsInterval(SANDBOX_TIMEOUT);
-    QScriptValue testConstructor;
-    {
-        QTimer timeout;
-        timeout.setSingleShot(true);
-        timeout.start(SANDBOX_TIMEOUT);
-        connect(&timeout, &QTimer::timeout, [&sandbox, SANDBOX_TIMEOUT]{
-            auto context = sandbox.currentContext();
-            if (context) {
-                // Guard against infinite loops and non-performant code
-                context->throwError(QString("Timed out (entity constructors are limited to %1ms)").arg(SANDBOX_TIMEOUT));
+        if (!testConstructor.isFunction()) {
+            QString testConstructorType = QString(testConstructor.toVariant().typeName());
+            if (testConstructorType == "") {
+                testConstructorType = "empty";
             }
-        });
-        testConstructor = sandbox.evaluate(program);
-    }
-    if (hadUncaughtExceptions(sandbox, program.fileName())) {
-        return;
-    }
+            QString testConstructorValue = testConstructor.toString();
+            const int maxTestConstructorValueSize = 80;
+            if (testConstructorValue.size() > maxTestConstructorValueSize) {
+                testConstructorValue = testConstructorValue.mid(0, maxTestConstructorValueSize) + "...";
+            }
+            qCDebug(scriptengine) << "Error -- ScriptEngine::loadEntityScript() entity:" << entityID
+                                  << "failed to load entity script -- expected a function, got " + testConstructorType
+                                  << "," << testConstructorValue
+                                  << "," << scriptOrURL;
 
-    if (!testConstructor.isFunction()) {
-        QString testConstructorType = QString(testConstructor.toVariant().typeName());
-        if (testConstructorType == "") {
-            testConstructorType = "empty";
-        }
-        QString testConstructorValue = testConstructor.toString();
-        const int maxTestConstructorValueSize = 80;
-        if (testConstructorValue.size() > maxTestConstructorValueSize) {
-            testConstructorValue = testConstructorValue.mid(0, maxTestConstructorValueSize) + "...";
-        }
-        qCDebug(scriptengine) << "Error -- ScriptEngine::loadEntityScript() entity:" << entityID
-                              << "failed to load entity script -- expected a function, got " + testConstructorType
-                              << "," << testConstructorValue
-                              << "," << scriptOrURL;
+            if (!isFileUrl) {
+                scriptCache->addScriptToBadScriptList(scriptOrURL);
+            }
 
-        if (!isFileUrl) {
-            scriptCache->addScriptToBadScriptList(scriptOrURL);
+            return; // done processing script
         }
 
-        return; // done processing script
+        scriptCache->cacheProgram(this, program);
+    }
+
+    if (isURL) {
+        setParentURL(scriptOrURL);
     }
 
     int64_t lastModified = 0;
@@ -1428,7 +1458,10 @@ void ScriptEngine::entityScriptContentAvailable(const EntityItemID& entityID, co
         entityScriptConstructor = evaluate(contents, fileName);
         entityScriptObject = entityScriptConstructor.construct();
     };
-    doWithEnvironment(entityID, sandboxURL, initialization);
+    {
+        ScriptProfiler::CallSource callSource(_profiler, "entityLoad");
+        doWithEnvironment(entityID, sandboxURL, initialization);
+    }
 
     EntityScriptDetails newDetails = { scriptOrURL, entityScriptObject, lastModified, sandboxURL };
     _entityScripts[entityID] = newDetails;
@@ -1535,6 +1568,10 @@ void ScriptEngine::doWithEnvironment(const EntityItemID& entityID, const QUrl& s
     currentEntityIdentifier = entityID;
     currentSandboxURL = sandboxURL;
 
+    // only the outermost call is timed, the time of any entity script it calls into is counted in its own
+    bool isOutermostEntityCall = !entityID.isInvalidID() && (_entityCallDepth++ == 0);
+    quint64 startTime = isOutermostEntityCall ? usecTimestampNow() : 0;
+
 #if DEBUG_CURRENT_ENTITY
     QScriptValue oldData = this->globalObject().property("debugEntityID");
     this->globalObject().setProperty("debugEntityID", entityID.toScriptValue(this)); // Make the entityID available to javascript as a global.
@@ -1545,9 +1582,71 @@ void ScriptEngine::doWithEnvironment(const EntityItemID& entityID, const QUrl& s
 #endif
     hadUncaughtExceptions(*this, _fileNameString);
 
+    if (!entityID.isInvalidID()) {
+        --_entityCallDepth;
+        if (isOutermostEntityCall) {
+            recordEntityScriptTime(entityID, sandboxURL, usecTimestampNow() - startTime);
+        }
+    }
+
     currentEntityIdentifier = oldIdentifier;
     currentSandboxURL = oldSandboxURL;
 }
+
+void ScriptEngine::recordEntityScriptTime(const EntityItemID& entityID, const QUrl& sandboxURL, quint64 usecs) {
+    bool isFirstOverBudget = false;
+    {
+        QMutexLocker locker(&_entityScriptTimesLock);
+        EntityScriptTime& time = _entityScriptTimes[sandboxURL];
+        time.totalUsecs += usecs;
+        time.maxUsecs = std::max(time.maxUsecs, usecs);
+        ++time.calls;
+        if (usecs > ENTITY_SCRIPT_CALL_BUDGET_USECS) {
+            isFirstOverBudget = (time.overBudgetCalls++ == 0);
+        }
+    }
+
+    // the times keep the count, so we only warn once per script
+    if (isFirstOverBudget) {
+        qCWarning(scriptengine) << "Entity script" << sandboxURL << "of entity" << entityID << "took" << usecs
+            << "usecs, over the budget of" << ENTITY_SCRIPT_CALL_BUDGET_USECS << "usecs per call";
+    }
+}
+
+void ScriptEngine::startProfiling() {
+    if (_debuggable) {
+        // the debugger is the agent of a debuggable engine, and an engine has only one
+        qCWarning(scriptengine) << "Script.startProfiling() is not available in a debuggable script:" << getFilename();
+        return;
+    }
+    _profiler->start();
+}
+
+void ScriptEngine::stopProfiling() {
+    _profiler->stop();
+}
+
+QVariantMap ScriptEngine::getProfile() const {
+    return _profiler->getProfile();
+}
+
+QString ScriptEngine::getProfileReport(int maxFunctions) const {
+    return _profiler->getReport(maxFunctions);
+}
+
+void ScriptEngine::startTracing() {
+    Tracer::start();
+}
+
+QString ScriptEngine::stopTracing(const QString& path) {
+    QString tracePath = path.isEmpty() ? Tracer::getDefaultPath() : path;
+    return Tracer::stop(tracePath) ? tracePath : QString();
+}
+
+QHash<QUrl, EntityScriptTime> ScriptEngine::getEntityScriptTimes() const {
+    QMutexLocker locker(&_entityScriptTimesLock);
+    return _entityScriptTimes;
+}
 void ScriptEngine::callWithEnvironment(const EntityItemID& entityID, const QUrl& sandboxURL, QScriptValue function, QScriptValue thisObject, QScriptValueList args) {
     auto operation = [&]() {
         function.call(thisObject, args);
@@ -1581,6 +1680,7 @@ void ScriptEngine::callEntityScriptMethod(const EntityItemID& entityID, const QS
             QScriptValueList args;
             args << entityID.toScriptValue(this);
             args << qScriptValueFromSequence(this, params);
+            ScriptProfiler::CallSource callSource(_profiler, "entityMethod");
             callWithEnvironment(entityID, details.definingSandboxURL, entityScript.property(methodName), entityScript, args);
         }
 
@@ -1613,6 +1713,7 @@ void ScriptEngine::callEntityScriptMethod(const EntityItemID& entityID, const QS
             QScriptValueList args;
             args << entityID.toScriptValue(this);
             args << event.toScriptValue(this);
+            ScriptProfiler::CallSource callSource(_profiler, "entityMethod");
             callWithEnvironment(entityID, details.definingSandboxURL, entityScript.property(methodName), entityScript, args);
         }
     }
@@ -1647,6 +1748,7 @@ void ScriptEngine::callEntityScriptMethod(const EntityItemID& entityID, const QS
             args << entityID.toScriptValue(this);
             args << otherID.toScriptValue(this);
             args << collisionToScriptValue(this, collision);
+            ScriptProfiler::CallSource callSource(_profiler, "entityMethod");
             callWithEnvironment(entityID, details.definingSandboxURL, entityScript.property(methodName), entityScript, args);
         }
     }
@@ -14,6 +14,7 @@
 
 #include <vector>
 
+#include <QtCore/QMutex>
 #include <QtCore/QObject>
 #include <QtCore/QUrl>
 #include <QtCore/QSet>
@@ -29,6 +30,7 @@
 #include <LimitedNodeList.h>
 #include <EntityItemID.h>
 #include <EntitiesScriptEngineProvider.h>
+#include <NumericalConstants.h>
 
 #include "PointerEvent.h"
 #include "ArrayBufferClass.h"
@@ -41,6 +43,7 @@
 #include "Vec3.h"
 
 class QScriptEngineDebugger;
+class ScriptProfiler;
 
 static const QString NO_SCRIPT("");
 
@@ -53,6 +56,18 @@ public:
     QUrl definingSandboxURL;
 };
 
+// Time spent running an entity script, counted on the thread of its engine from the outermost call into the script
+// (loading, methods, event handlers and timers) so that calls between entity scripts are not counted twice.
+class EntityScriptTime {
+public:
+    quint64 totalUsecs { 0 };
+    quint64 maxUsecs { 0 };
+    int calls { 0 };
+    int overBudgetCalls { 0 };
+};
+
+static const quint64 ENTITY_SCRIPT_CALL_BUDGET_USECS = 10 * USECS_PER_MSEC;
+
 typedef QList<CallbackData> CallbackList;
 typedef QHash<QString, CallbackList> RegisteredEventHandlers;
 
@@ -144,10 +159,25 @@ public:
     Q_INVOKABLE void callEntityScriptMethod(const EntityItemID& entityID, const QString& methodName, const PointerEvent& event);
     Q_INVOKABLE void callEntityScriptMethod(const EntityItemID& entityID, const QString& methodName, const EntityItemID& otherID, const Collision& collision);
 
+    // time spent in each of the entity scripts this engine has run, by the URL of the script - thread safe
+    QHash<QUrl, EntityScriptTime> getEntityScriptTimes() const;
+
     Q_INVOKABLE void requestGarbageCollection() { collectGarbage(); }
 
     Q_INVOKABLE QUuid generateUUID() { return QUuid::createUuid(); }
 
+    // profiling of the time spent in each script function, and under each kind of callback (timers, update, signals,
+    // entity methods and events), from startProfiling() until stopProfiling(). Starting again resets the profile.
+    Q_INVOKABLE void startProfiling();
+    Q_INVOKABLE void stopProfiling();
+    Q_INVOKABLE QVariantMap getProfile() const;
+    Q_INVOKABLE QString getProfileReport(int maxFunctions = 20) const; // the profile as text, e.g. for the console
+
+    // tracing of the spans of all the threads of the process, see Tracer. stopTracing() writes the trace to the path,
+    // or to a new file in the traces directory, and returns the path written or an empty string
+    Q_INVOKABLE void startTracing();
+    Q_INVOKABLE QString stopTracing(const QString& path = QString());
+
     bool isFinished() const { return _isFinished; } // used by Application and ScriptWidget
     bool isRunning() const { return _isRunning; } // used by ScriptWidget
 
@@ -231,6 +261,7 @@ protected:
     bool _isReloading { false };
 
     ArrayBufferClass* _arrayBufferClass;
+    ScriptProfiler* _profiler; // owned by the engine, as its agent
 
     AssetScriptingInterface _assetScriptingInterface{ this };
 
@@ -243,6 +274,11 @@ protected:
     void doWithEnvironment(const EntityItemID& entityID, const QUrl& sandboxURL, std::function<void()> operation);
     void callWithEnvironment(const EntityItemID& entityID, const QUrl& sandboxURL, QScriptValue function, QScriptValue thisObject, QScriptValueList args);
 
+    void recordEntityScriptTime(const EntityItemID& entityID, const QUrl& sandboxURL, quint64 usecs);
+    int _entityCallDepth { 0 };
+    mutable QMutex _entityScriptTimesLock;
+    QHash<QUrl, EntityScriptTime> _entityScriptTimes;
+
     std::function<bool()> _emitScriptUpdates{ [](){ return true; }  };
 
 };
@@ -0,0 +1,186 @@
+//
+//  ScriptProfiler.cpp
+//  libraries/script-engine/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ScriptProfiler.h"
+
+#include <algorithm>
+
+#include <QtCore/QVariantList>
+#include <QtScript/QScriptContext>
+#include <QtScript/QScriptContextInfo>
+#include <QtScript/QScriptEngine>
+
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
+// calls from Qt signals connected to script functions don't go through the engine, so anything unmarked came from one
+static const char* SIGNAL_SOURCE = "signal";
+
+ScriptProfiler::CallSource::CallSource(ScriptProfiler* profiler, const char* source) :
+    _profiler(profiler),
+    _previousSource(profiler->_currentSource),
+    _stackDepth(profiler->_stack.size()),
+    _traceSpan(source)
+{
+    _profiler->_currentSource = source;
+}
+
+ScriptProfiler::CallSource::~CallSource() {
+    // the engine does not report the exit of every function an exception unwinds through, so close those frames here
+    if (_profiler->_stack.size() > _stackDepth) {
+        _profiler->unwindTo(_stackDepth);
+    }
+    _profiler->_currentSource = _previousSource;
+}
+
+ScriptProfiler::ScriptProfiler(QScriptEngine* engine) :
+    QScriptEngineAgent(engine)
+{
+
+}
+
+void ScriptProfiler::start() {
+    if (_isProfiling) {
+        return;
+    }
+
+    _functions.clear();
+    _sources.clear();
+    _stack.clear();
+    _profiledUsecs = 0;
+    _startTime = usecTimestampNow();
+    _isProfiling = true;
+
+    engine()->setAgent(this);
+}
+
+void ScriptProfiler::stop() {
+    if (!_isProfiling) {
+        return;
+    }
+
+    unwindTo(0);
+    engine()->setAgent(nullptr);
+
+    _profiledUsecs = usecTimestampNow() - _startTime;
+    _isProfiling = false;
+}
+
+void ScriptProfiler::functionEntry(qint64 scriptId) {
+    if (_stack.empty()) {
+        _stackSource = _currentSource ? _currentSource : SIGNAL_SOURCE;
+    }
+
+    Frame frame { QString(), usecTimestampNow(), 0 };
+    if (scriptId != -1) {
+        QScriptContext* context = engine()->currentContext();
+        QScriptContextInfo info(context);
+        QString name = info.functionName();
+        if (name.isEmpty()) {
+            name = context->callee().isValid() ? "(anonymous)" : "(top level)";
+        }
+        frame.function = QString("%1 (%2:%3)").arg(name).arg(info.fileName()).arg(info.functionStartLineNumber());
+    }
+    _stack.push_back(frame);
+}
+
+void ScriptProfiler::functionExit(qint64 scriptId, const QScriptValue& returnValue) {
+    if (!_stack.empty()) {
+        popFrame(usecTimestampNow());
+    }
+}
+
+void ScriptProfiler::popFrame(quint64 now) {
+    Frame frame = _stack.back();
+    _stack.pop_back();
+
+    quint64 usecs = now - frame.startTime;
+    if (!frame.function.isEmpty()) {
+        FunctionProfile& function = _functions[frame.function];
+        function.totalUsecs += usecs;
+        function.selfUsecs += (usecs > frame.childUsecs) ? usecs - frame.childUsecs : 0;
+        ++function.calls;
+    }
+
+    if (!_stack.empty()) {
+        // the own time of a native function is left in the self time of its caller, but not the script it called back
+        _stack.back().childUsecs += frame.function.isEmpty() ? frame.childUsecs : usecs;
+    } else {
+        SourceProfile& source = _sources[_stackSource];
+        source.usecs += usecs;
+        ++source.calls;
+    }
+}
+
+void ScriptProfiler::unwindTo(size_t stackDepth) {
+    quint64 now = usecTimestampNow();
+    while (_stack.size() > stackDepth) {
+        popFrame(now);
+    }
+}
+
+QVariantMap ScriptProfiler::getProfile() const {
+    QVariantMap profile;
+    profile["durationMsecs"] = (double)(_isProfiling ? usecTimestampNow() - _startTime : _profiledUsecs) / USECS_PER_MSEC;
+
+    QVariantMap sources;
+    for (auto it = _sources.constBegin(); it != _sources.constEnd(); ++it) {
+        QVariantMap source;
+        source["calls"] = it.value().calls;
+        source["msecs"] = (double)it.value().usecs / USECS_PER_MSEC;
+        sources[it.key()] = source;
+    }
+    profile["sources"] = sources;
+
+    QVector<QString> names = _functions.keys().toVector();
+    std::sort(names.begin(), names.end(), [this](const QString& a, const QString& b) {
+        return _functions[a].selfUsecs > _functions[b].selfUsecs;
+    });
+
+    QVariantList functions;
+    for (const auto& name : names) {
+        const FunctionProfile& function = _functions[name];
+        QVariantMap entry;
+        entry["name"] = name;
+        entry["calls"] = function.calls;
+        entry["totalMsecs"] = (double)function.totalUsecs / USECS_PER_MSEC;
+        entry["selfMsecs"] = (double)function.selfUsecs / USECS_PER_MSEC;
+        functions << entry;
+    }
+    profile["functions"] = functions;
+
+    return profile;
+}
+
+QString ScriptProfiler::getReport(int maxFunctions) const {
+    QVariantMap profile = getProfile();
+
+    QString report = QString("Profiled %1 ms%2\n").arg(profile["durationMsecs"].toDouble(), 0, 'f', 1)
+        .arg(_isProfiling ? " (still profiling)" : "");
+
+    QVariantMap sources = profile["sources"].toMap();
+    for (auto it = sources.constBegin(); it != sources.constEnd(); ++it) {
+        QVariantMap source = it.value().toMap();
+        report += QString("  %1: %2 ms in %3 calls\n").arg(it.key())
+            .arg(source["msecs"].toDouble(), 0, 'f', 2).arg(source["calls"].toInt());
+    }
+
+    report += "  self ms / total ms / calls / function\n";
+    QVariantList functions = profile["functions"].toList();
+    int count = std::min(maxFunctions, functions.size());
+    for (int i = 0; i < count; i++) {
+        QVariantMap function = functions[i].toMap();
+        report += QString("  %1 / %2 / %3 / %4\n").arg(function["selfMsecs"].toDouble(), 0, 'f', 2)
+            .arg(function["totalMsecs"].toDouble(), 0, 'f', 2).arg(function["calls"].toInt())
+            .arg(function["name"].toString());
+    }
+
+    return report;
+}
@@ -0,0 +1,94 @@
+//
+//  ScriptProfiler.h
+//  libraries/script-engine/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_ScriptProfiler_h
+#define hifi_ScriptProfiler_h
+
+#include <vector>
+
+#include <QtCore/QHash>
+#include <QtCore/QString>
+#include <QtCore/QVariantMap>
+#include <QtScript/QScriptEngineAgent>
+
+#include <Trace.h>
+
+// Records the time spent in each script function, from the function entry and exit the engine reports to its agent,
+// and which kind of callback (timer, update, entity method...) the time was spent under. It is only installed as the
+// agent of the engine while profiling, so it costs nothing otherwise. Everything runs on the thread of the engine.
+//
+// The engine owns its agents, so a profiler is created with new and never deleted by hand.
+class ScriptProfiler : public QScriptEngineAgent {
+public:
+    // marks the script run while it is in scope as called from the given source, time is counted under the outermost one
+    class CallSource {
+    public:
+        CallSource(ScriptProfiler* profiler, const char* source);
+        ~CallSource();
+
+    private:
+        ScriptProfiler* _profiler;
+        const char* _previousSource;
+        size_t _stackDepth;
+        TraceSpan _traceSpan; // the callbacks are also spans of the trace while the Tracer records
+    };
+
+    ScriptProfiler(QScriptEngine* engine);
+
+    void start();
+    void stop();
+    bool isProfiling() const { return _isProfiling; }
+
+    // { durationMsecs, sources: { <source>: { calls, msecs } }, functions: [ { name, calls, totalMsecs, selfMsecs } ] }
+    // with the functions sorted by the time spent in their own code
+    QVariantMap getProfile() const;
+
+    // the profile as text, with at most maxFunctions functions
+    QString getReport(int maxFunctions) const;
+
+    virtual void functionEntry(qint64 scriptId) override;
+    virtual void functionExit(qint64 scriptId, const QScriptValue& returnValue) override;
+
+private:
+    struct Frame {
+        QString function; // empty for native functions, their time is counted in their caller
+        quint64 startTime;
+        quint64 childUsecs;
+    };
+
+    struct FunctionProfile {
+        quint64 totalUsecs { 0 }; // including the functions it called - a recursive function is counted at every level
+        quint64 selfUsecs { 0 };
+        int calls { 0 };
+    };
+
+    struct SourceProfile {
+        quint64 usecs { 0 };
+        int calls { 0 };
+    };
+
+    void popFrame(quint64 now);
+    void unwindTo(size_t stackDepth);
+
+    bool _isProfiling { false };
+    quint64 _startTime { 0 };
+    quint64 _profiledUsecs { 0 };
+
+    const char* _currentSource { nullptr };
+    const char* _stackSource { nullptr }; // the source of the outermost frame on the stack
+    std::vector<Frame> _stack;
+
+    QHash<QString, FunctionProfile> _functions;
+    QHash<QString, SourceProfile> _sources;
+};
+
+#endif // hifi_ScriptProfiler_h
@@ -9,6 +9,10 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <cstring>
+
+#include <QtCore/QtEndian>
+
 #include <glm/glm.hpp>
 
 #include "ScriptEngine.h"
@@ -200,19 +204,15 @@ void TypedArray::setBytesPerElement(quint32 bytesPerElement) {
 }
 
 // templated helper functions
-// don't work for floats as they require single precision settings
+// The elements are read and written in place: a read never detaches a buffer shared with the C++ side,
+// and the first write to a shared buffer is the only one that copies it
 template<class T>
 QScriptValue propertyHelper(const QByteArray* arrayBuffer, const QScriptString& name, uint id) {
     bool ok = false;
     name.toArrayIndex(&ok);
     
-    if (ok && arrayBuffer) {
-        QDataStream stream(*arrayBuffer);
-        stream.skipRawData(id);
-        
-        stream.setByteOrder(QDataStream::LittleEndian);
-        T result;
-        stream >> result;
+    if (ok && arrayBuffer && id + sizeof(T) <= (uint)arrayBuffer->size()) {
+        T result = qFromLittleEndian<T>(reinterpret_cast<const uchar*>(arrayBuffer->constData() + id));
         return result;
     }
     return QScriptValue();
@@ -220,12 +220,36 @@ QScriptValue propertyHelper(const QByteArray* arrayBuffer, const QScriptString&
 
 template<class T>
 void setPropertyHelper(QByteArray* arrayBuffer, const QScriptString& name, uint id, const QScriptValue& value) {
-    if (arrayBuffer && value.isNumber()) {
-        QDataStream stream(arrayBuffer, QIODevice::ReadWrite);
-        stream.skipRawData(id);
-        stream.setByteOrder(QDataStream::LittleEndian);
-        
-        stream << (T)value.toNumber();
+    if (arrayBuffer && value.isNumber() && id + sizeof(T) <= (uint)arrayBuffer->size()) {
+        qToLittleEndian<T>((T)value.toNumber(), reinterpret_cast<uchar*>(arrayBuffer->data() + id));
+    }
+}
+
+// floats go through their bits, as the endian helpers only take integers
+template<class F, class I>
+QScriptValue floatPropertyHelper(const QByteArray* arrayBuffer, const QScriptString& name, uint id) {
+    bool ok = false;
+    name.toArrayIndex(&ok);
+
+    if (ok && arrayBuffer && id + sizeof(F) <= (uint)arrayBuffer->size()) {
+        I bits = qFromLittleEndian<I>(reinterpret_cast<const uchar*>(arrayBuffer->constData() + id));
+        F result;
+        memcpy(&result, &bits, sizeof(F));
+        if (isNaN(result)) {
+            return QScriptValue();
+        }
+        return result;
+    }
+    return QScriptValue();
+}
+
+template<class F, class I>
+void setFloatPropertyHelper(QByteArray* arrayBuffer, uint id, const QScriptValue& value) {
+    if (arrayBuffer && value.isNumber() && id + sizeof(F) <= (uint)arrayBuffer->size()) {
+        F number = (F)value.toNumber();
+        I bits;
+        memcpy(&bits, &number, sizeof(F));
+        qToLittleEndian<I>(bits, reinterpret_cast<uchar*>(arrayBuffer->data() + id));
     }
 }
 
@@ -274,15 +298,13 @@ QScriptValue Uint8ClampedArrayClass::property(const QScriptValue& object, const
 void Uint8ClampedArrayClass::setProperty(QScriptValue& object, const QScriptString& name,
                                   uint id, const QScriptValue& value) {
     QByteArray* ba = qscriptvalue_cast<QByteArray*>(object.data().property(_bufferName).data());
-    if (ba && value.isNumber()) {
-        QDataStream stream(ba, QIODevice::ReadWrite);
-        stream.skipRawData(id);
+    if (ba && value.isNumber() && id < (uint)ba->size()) {
         if (value.toNumber() > 255) {
-            stream << (quint8)255;
+            ba->data()[id] = (char)255;
         } else if (value.toNumber() < 0) {
-            stream << (quint8)0;
+            ba->data()[id] = 0;
         } else {
-            stream << (quint8)glm::clamp(qRound(value.toNumber()), 0, 255);
+            ba->data()[id] = (char)(quint8)glm::clamp(qRound(value.toNumber()), 0, 255);
         }
     }
 }
@@ -357,21 +379,11 @@ Float32ArrayClass::Float32ArrayClass(ScriptEngine* scriptEngine) : TypedArray(sc
 }
 
 QScriptValue Float32ArrayClass::property(const QScriptValue& object, const QScriptString& name, uint id) {
-    QByteArray* arrayBuffer = qscriptvalue_cast<QByteArray*>(object.data().property(_bufferName).data());bool ok = false;
+    QByteArray* arrayBuffer = qscriptvalue_cast<QByteArray*>(object.data().property(_bufferName).data());
+    bool ok = false;
     name.toArrayIndex(&ok);
-    
-    if (ok && arrayBuffer) {
-        QDataStream stream(*arrayBuffer);
-        stream.skipRawData(id);
-        stream.setByteOrder(QDataStream::LittleEndian);
-        stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
-        
-        float result;
-        stream >> result;
-        if (isNaN(result)) {
-            return QScriptValue();
-        }
-        return result;
+    if (ok) {
+        return floatPropertyHelper<float, quint32>(arrayBuffer, name, id);
     }
     return TypedArray::property(object, name, id);
 }
@@ -379,14 +391,7 @@ QScriptValue Float32ArrayClass::property(const QScriptValue& object, const QScri
 void Float32ArrayClass::setProperty(QScriptValue& object, const QScriptString& name,
                                   uint id, const QScriptValue& value) {
     QByteArray* ba = qscriptvalue_cast<QByteArray*>(object.data().property(_bufferName).data());
-    if (ba && value.isNumber()) {
-        QDataStream stream(ba, QIODevice::ReadWrite);
-        stream.skipRawData(id);
-        stream.setByteOrder(QDataStream::LittleEndian);
-        stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
-        
-        stream << (float)value.toNumber();
-    }
+    setFloatPropertyHelper<float, quint32>(ba, id, value);
 }
 
 Float64ArrayClass::Float64ArrayClass(ScriptEngine* scriptEngine) : TypedArray(scriptEngine, FLOAT_64_ARRAY_CLASS_NAME) {
@@ -394,21 +399,11 @@ Float64ArrayClass::Float64ArrayClass(ScriptEngine* scriptEngine) : TypedArray(sc
 }
 
 QScriptValue Float64ArrayClass::property(const QScriptValue& object, const QScriptString& name, uint id) {
-    QByteArray* arrayBuffer = qscriptvalue_cast<QByteArray*>(object.data().property(_bufferName).data());bool ok = false;
+    QByteArray* arrayBuffer = qscriptvalue_cast<QByteArray*>(object.data().property(_bufferName).data());
+    bool ok = false;
     name.toArrayIndex(&ok);
-    
-    if (ok && arrayBuffer) {
-        QDataStream stream(*arrayBuffer);
-        stream.skipRawData(id);
-        stream.setByteOrder(QDataStream::LittleEndian);
-        stream.setFloatingPointPrecision(QDataStream::DoublePrecision);
-        
-        double result;
-        stream >> result;
-        if (isNaN(result)) {
-            return QScriptValue();
-        }
-        return result;
+    if (ok) {
+        return floatPropertyHelper<double, quint64>(arrayBuffer, name, id);
     }
     return TypedArray::property(object, name, id);
 }
@@ -416,13 +411,6 @@ QScriptValue Float64ArrayClass::property(const QScriptValue& object, const QScri
 void Float64ArrayClass::setProperty(QScriptValue& object, const QScriptString& name,
                                   uint id, const QScriptValue& value) {
     QByteArray* ba = qscriptvalue_cast<QByteArray*>(object.data().property(_bufferName).data());
-    if (ba && value.isNumber()) {
-        QDataStream stream(ba, QIODevice::ReadWrite);
-        stream.skipRawData(id);
-        stream.setByteOrder(QDataStream::LittleEndian);
-        stream.setFloatingPointPrecision(QDataStream::DoublePrecision);
-        
-        stream << (double)value.toNumber();
-    }
+    setFloatPropertyHelper<double, quint64>(ba, id, value);
 }
 
@@ -13,13 +13,17 @@
 #define hifi_CPUDetect_h
 
 //
-// Lightweight functions to detect SSE/AVX/AVX2 support
+// Lightweight functions to detect SSE/AVX/AVX2/NEON support
 //
 
 #if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
 #define ARCH_X86
 #endif
 
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define ARCH_NEON
+#endif
+
 #define MASK_SSE3   (1 << 0)                // SSE3
 #define MASK_SSSE3  (1 << 9)                // SSSE3
 #define MASK_SSE41  (1 << 19)               // SSE4.1
@@ -178,4 +182,15 @@ static inline bool cpuSupportsAVX2() {
 
 #endif
 
+//
+// NEON is mandatory on aarch64, and on 32-bit ARM it is only used when the compiler targets it
+//
+static inline bool cpuSupportsNEON() {
+#if defined(ARCH_NEON)
+    return true;
+#else
+    return false;
+#endif
+}
+
 #endif // hifi_CPUDetect_h
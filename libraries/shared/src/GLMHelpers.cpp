@@ -218,6 +218,73 @@ int unpackOrientationQuatFromSixBytes(const unsigned char* buffer, glm::quat& qu
 }
 
 
+int packOrientationQuatToFourBytes(unsigned char* buffer, const glm::quat& quatInput) {
+
+    // find largest component
+    uint8_t largestComponent = 0;
+    for (int i = 1; i < 4; i++) {
+        if (fabs(quatInput[i]) > fabs(quatInput[largestComponent])) {
+            largestComponent = i;
+        }
+    }
+
+    // ensure that the sign of the dropped component is always negative.
+    glm::quat q = quatInput[largestComponent] > 0 ? -quatInput : quatInput;
+
+    const float MAGNITUDE = 1.0f / sqrtf(2.0f);
+    const uint32_t NUM_BITS_PER_COMPONENT = 10;
+    const uint32_t RANGE = (1 << NUM_BITS_PER_COMPONENT) - 1;
+
+    // the largestComponent goes in the top 2 bits, followed by the smallest three components
+    uint32_t packed = largestComponent;
+    for (int i = 0; i < 4; i++) {
+        if (i != largestComponent) {
+            float value = glm::clamp((q[i] + MAGNITUDE) / (2.0f * MAGNITUDE), 0.0f, 1.0f);
+            packed = (packed << NUM_BITS_PER_COMPONENT) | (uint32_t)(value * RANGE + 0.5f);
+        }
+    }
+
+    buffer[0] = (unsigned char)(packed >> 24);
+    buffer[1] = (unsigned char)(packed >> 16);
+    buffer[2] = (unsigned char)(packed >> 8);
+    buffer[3] = (unsigned char)packed;
+
+    return 4;
+}
+
+int unpackOrientationQuatFromFourBytes(const unsigned char* buffer, glm::quat& quatOutput) {
+
+    uint32_t packed = ((uint32_t)buffer[0] << 24) | ((uint32_t)buffer[1] << 16) | ((uint32_t)buffer[2] << 8) | buffer[3];
+
+    const uint32_t NUM_BITS_PER_COMPONENT = 10;
+    const uint32_t MASK = (1 << NUM_BITS_PER_COMPONENT) - 1;
+    const float RANGE = (float)MASK;
+    const float MAGNITUDE = 1.0f / sqrtf(2.0f);
+
+    uint8_t largestComponent = (uint8_t)(packed >> (3 * NUM_BITS_PER_COMPONENT));
+    float floatComponents[3];
+    for (int i = 0; i < 3; i++) {
+        uint32_t component = (packed >> ((2 - i) * NUM_BITS_PER_COMPONENT)) & MASK;
+        floatComponents[i] = ((float)component / RANGE) * (2.0f * MAGNITUDE) - MAGNITUDE;
+    }
+
+    // missingComponent is always negative.
+    float missingComponent = -sqrtf(glm::max(0.0f, 1.0f - floatComponents[0] * floatComponents[0]
+        - floatComponents[1] * floatComponents[1] - floatComponents[2] * floatComponents[2]));
+
+    for (int i = 0, j = 0; i < 4; i++) {
+        if (i != largestComponent) {
+            quatOutput[i] = floatComponents[j];
+            j++;
+        } else {
+            quatOutput[i] = missingComponent;
+        }
+    }
+
+    return 4;
+}
+
+
 //  Safe version of glm::eulerAngles; uses the factorization method described in David Eberly's
 //  http://www.geometrictools.com/Documentation/EulerAngles.pdf (via Clyde,
 // https://github.com/threerings/clyde/blob/master/src/main/java/com/threerings/math/Quaternion.java)
@@ -107,6 +107,11 @@ int unpackOrientationQuatFromBytes(const unsigned char* buffer, glm::quat& quatO
 int packOrientationQuatToSixBytes(unsigned char* buffer, const glm::quat& quatInput);
 int unpackOrientationQuatFromSixBytes(const unsigned char* buffer, glm::quat& quatOutput);
 
+// coarser version of the smallest three compression, with 10 bits per component, for rotations that
+// do not need the precision (fingers). The final result will have a maximum error of +- 2.1e-3 per component.
+int packOrientationQuatToFourBytes(unsigned char* buffer, const glm::quat& quatInput);
+int unpackOrientationQuatFromFourBytes(const unsigned char* buffer, glm::quat& quatOutput);
+
 // Ratios need the be highly accurate when less than 10, but not very accurate above 10, and they
 // are never greater than 1000 to 1, this allows us to encode each component in 16bits
 int packFloatRatioToTwoByte(unsigned char* buffer, float ratio);
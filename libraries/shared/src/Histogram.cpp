@@ -0,0 +1,95 @@
+//
+//  Histogram.cpp
+//  libraries/shared/src
+//
+//  Created by Sam Gateau on 10/15/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "Histogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+static int highestBit(quint64 value) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return (int)index;
+#else
+    return 63 - __builtin_clzll(value);
+#endif
+}
+
+Histogram::Histogram() {
+    for (auto& bucket : _buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+int Histogram::bucketIndex(quint64 value) {
+    if (value < (quint64)SUB_BUCKET_COUNT) {
+        return (int)value;
+    }
+    // keep the top SUB_BUCKET_BITS bits of the value, the first of them is always set
+    int shift = highestBit(value) - (SUB_BUCKET_BITS - 1);
+    int subBucket = (int)(value >> shift) - HALF_SUB_BUCKET_COUNT;
+    return SUB_BUCKET_COUNT + (shift - 1) * HALF_SUB_BUCKET_COUNT + subBucket;
+}
+
+quint64 Histogram::bucketHighestValue(int index) {
+    if (index < SUB_BUCKET_COUNT) {
+        return (quint64)index;
+    }
+    int shift = (index - SUB_BUCKET_COUNT) / HALF_SUB_BUCKET_COUNT + 1;
+    quint64 subBucket = (quint64)((index - SUB_BUCKET_COUNT) % HALF_SUB_BUCKET_COUNT + HALF_SUB_BUCKET_COUNT);
+    return ((subBucket + 1) << shift) - 1;
+}
+
+Histogram::Snapshot Histogram::takeSnapshot() {
+    Snapshot snapshot;
+    snapshot._buckets.resize(NUM_BUCKETS);
+    for (int i = 0; i < NUM_BUCKETS; ++i) {
+        quint64 count = _buckets[i].exchange(0, std::memory_order_relaxed);
+        snapshot._buckets[i] = count;
+        snapshot._count += count;
+    }
+    snapshot._max = _max.exchange(0, std::memory_order_relaxed);
+    return snapshot;
+}
+
+quint64 Histogram::Snapshot::getValueAtPercentile(float percentile) const {
+    if (_count == 0) {
+        return 0;
+    }
+
+    quint64 rank = std::max((quint64)1, (quint64)std::ceil(std::min(std::max(percentile, 0.0f), 1.0f) * _count));
+    quint64 seen = 0;
+    for (int i = 0; i < (int)_buckets.size(); ++i) {
+        seen += _buckets[i];
+        if (seen >= rank) {
+            quint64 highest = bucketHighestValue(i);
+            quint64 lowest = (i > 0) ? bucketHighestValue(i - 1) + 1 : 0;
+            // not past the largest sample, unless it was counted while the snapshot was taken and missed the max
+            return (_max >= lowest) ? std::min(highest, _max) : highest;
+        }
+    }
+    return _max;
+}
+
+QJsonObject Histogram::Snapshot::toJson() const {
+    QJsonObject json;
+    json["count"] = (double)_count;
+    json["p50"] = (double)getValueAtPercentile(0.5f);
+    json["p99"] = (double)getValueAtPercentile(0.99f);
+    json["p999"] = (double)getValueAtPercentile(0.999f);
+    json["max"] = (double)_max;
+    return json;
+}
@@ -0,0 +1,69 @@
+//
+//  Histogram.h
+//  libraries/shared/src
+//
+//  Created by Sam Gateau on 10/15/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_Histogram_h
+#define hifi_Histogram_h
+
+#include <array>
+#include <atomic>
+#include <vector>
+
+#include <QtCore/QJsonObject>
+
+// A lock-free histogram of the distribution of positive samples (times in usecs, queue depths...), in the style of the
+// HDR histograms: the values up to 64 have their own bucket, the larger ones share buckets 1/32 of their magnitude wide,
+// so a percentile read from it is within about 3% of the exact one whatever the range of the samples.
+// Any thread can record, the stats go through takeSnapshot() that moves out what was recorded since the last one.
+class Histogram {
+public:
+    static const int SUB_BUCKET_BITS = 6;
+    static const int SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS;
+    static const int HALF_SUB_BUCKET_COUNT = SUB_BUCKET_COUNT / 2;
+    static const int NUM_BUCKETS = SUB_BUCKET_COUNT + (64 - SUB_BUCKET_BITS) * HALF_SUB_BUCKET_COUNT;
+
+    class Snapshot {
+    public:
+        quint64 getCount() const { return _count; }
+        quint64 getMax() const { return _max; }
+
+        // the highest value of the bucket holding the sample at the percentile, in [0, 1]
+        quint64 getValueAtPercentile(float percentile) const;
+
+        // { count, p50, p99, p999, max }
+        QJsonObject toJson() const;
+
+    private:
+        friend class Histogram;
+        std::vector<quint64> _buckets;
+        quint64 _count { 0 };
+        quint64 _max { 0 };
+    };
+
+    Histogram();
+
+    void record(quint64 value) {
+        _buckets[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+        quint64 max = _max.load(std::memory_order_relaxed);
+        while (value > max && !_max.compare_exchange_weak(max, value, std::memory_order_relaxed)) {}
+    }
+
+    // the samples recorded since the last snapshot, the ones recorded meanwhile go in this one or the next
+    Snapshot takeSnapshot();
+
+    static int bucketIndex(quint64 value);
+    static quint64 bucketHighestValue(int index);
+
+private:
+    std::array<std::atomic<quint64>, NUM_BUCKETS> _buckets;
+    std::atomic<quint64> _max { 0 };
+};
+
+#endif // hifi_Histogram_h
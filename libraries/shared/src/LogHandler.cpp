@@ -18,18 +18,26 @@
 #include <QtCore/QDateTime>
 #include <QtCore/QDebug>
 #include <QtCore/QMutexLocker>
-#include <QtCore/QRegExp>
 #include <QtCore/QThread>
 #include <QtCore/QTimer>
 
 QMutex LogHandler::_mutex;
 
+// the lines logged faster than the writer can write them past this are dropped, and counted
+static const size_t WRITE_QUEUE_CAPACITY = 4096;
+static const std::chrono::milliseconds WRITER_WAIT_INTERVAL { 10 };
+
 LogHandler& LogHandler::getInstance() {
     static LogHandler staticInstance;
     return staticInstance;
 }
 
-LogHandler::LogHandler() {
+LogHandler::LogHandler() :
+    _writeQueue(WRITE_QUEUE_CAPACITY)
+{
+    _isWriterRunning = true;
+    _writerThread = std::thread([this] { runWriter(); });
+
     // when the log handler is first setup we should print our timezone
     QString timezoneString = "Time zone: " + QDateTime::currentDateTime().toString("t");
     printMessage(LogMsgType::LogInfo, QMessageLogContext(), timezoneString);
@@ -38,6 +46,64 @@ LogHandler::LogHandler() {
 LogHandler::~LogHandler() {
     flushRepeatedMessages();
     printMessage(LogMsgType::LogDebug, QMessageLogContext(), "LogHandler shutdown.");
+
+    // the writer writes what is left in the queue before it stops
+    _shouldStopWriter = true;
+    _writerCondition.notify_one();
+    if (_writerThread.joinable()) {
+        _writerThread.join();
+    }
+}
+
+void LogHandler::runWriter() {
+    while (true) {
+        bool shouldStop = _shouldStopWriter.load();
+
+        bool hasWritten = false;
+        QByteArray line;
+        while (_writeQueue.pop(line)) {
+            fwrite(line.constData(), 1, line.size(), stdout);
+            hasWritten = true;
+        }
+
+        int numDropped = _numDroppedMessages.exchange(0);
+        if (numDropped > 0) {
+            fprintf(stdout, "[SUPPRESS] %d log entries dropped, logged faster than they could be written\n", numDropped);
+            hasWritten = true;
+        }
+
+        if (hasWritten) {
+            fflush(stdout);
+        }
+
+        if (shouldStop) {
+            break;
+        }
+
+        // the loggers don't take the lock to notify, so this also wakes up on its own to catch a missed notify
+        std::unique_lock<std::mutex> lock(_writerMutex);
+        _writerCondition.wait_for(lock, WRITER_WAIT_INTERVAL);
+    }
+
+    _isWriterRunning = false;
+}
+
+void LogHandler::writeMessage(LogMsgType type, const QString& logMessage) {
+    QByteArray line = logMessage.toLocal8Bit();
+    line.append('\n');
+
+    // a fatal message is written before the process aborts, and the lines from after shutdown have no writer
+    if (type == LogFatal || !_isWriterRunning) {
+        fwrite(line.constData(), 1, line.size(), stdout);
+        fflush(stdout);
+        return;
+    }
+
+    if (_writeQueue.push(std::move(line))) {
+        _writerCondition.notify_one();
+    } else {
+        ++_numDroppedMessages;
+    }
 }
 
 const char* stringForLogType(LogMsgType msgType) {
@@ -114,9 +180,9 @@ QString LogHandler::printMessage(LogMsgType type, const QMessageLogContext& cont
 
     if (type == LogDebug) {
         // for debug messages, check if this matches any of our regexes for repeated log messages
-        foreach(const QString& regexString, getInstance()._repeatedMessageRegexes) {
-            QRegExp repeatRegex(regexString);
-            if (repeatRegex.indexIn(message) != -1) {
+        foreach(const MessageMatcher& matcher, _repeatedMessageMatchers) {
+            const QString& regexString = matcher.first;
+            if (matcher.second.match(message).hasMatch()) {
 
                 if (!_repeatMessageCountHash.contains(regexString)) {
                     // we have a match but didn't have this yet - output the first one
@@ -137,9 +203,8 @@ QString LogHandler::printMessage(LogMsgType type, const QMessageLogContext& cont
     }
     if (type == LogDebug) {
         // see if this message is one we should only print once
-        foreach(const QString& regexString, getInstance()._onlyOnceMessageRegexes) {
-            QRegExp onlyOnceRegex(regexString);
-            if (onlyOnceRegex.indexIn(message) != -1) {
+        foreach(const MessageMatcher& matcher, _onlyOnceMessageMatchers) {
+            if (matcher.second.match(message).hasMatch()) {
                 if (!_onlyOnceMessageCountHash.contains(message)) {
                     // we have a match and haven't yet printed this message.
                     _onlyOnceMessageCountHash[message] = 1;
@@ -153,32 +218,44 @@ QString LogHandler::printMessage(LogMsgType type, const QMessageLogContext& cont
         }
     }
 
+    // the rest doesn't touch the suppression state, so other threads can log while this one formats
+    bool shouldDisplayMilliseconds = _shouldDisplayMilliseconds;
+    bool shouldOutputProcessID = _shouldOutputProcessID;
+    bool shouldOutputThreadID = _shouldOutputThreadID;
+    QString targetName = _targetName;
+    lock.unlock();
+
     // log prefix is in the following format
     // [TIMESTAMP] [DEBUG] [PID] [TID] [TARGET] logged string
 
     const QString* dateFormatPtr = &DATE_STRING_FORMAT;
-    if (_shouldDisplayMilliseconds) {
+    if (shouldDisplayMilliseconds) {
         dateFormatPtr = &DATE_STRING_FORMAT_WITH_MILLISECONDS;
     }
 
     QString prefixString = QString("[%1] [%2] [%3]").arg(QDateTime::currentDateTime().toString(*dateFormatPtr),
         stringForLogType(type), context.category);
 
-    if (_shouldOutputProcessID) {
+    if (shouldOutputProcessID) {
         prefixString.append(QString(" [%1]").arg(QCoreApplication::applicationPid()));
     }
 
-    if (_shouldOutputThreadID) {
+    if (shouldOutputThreadID) {
         size_t threadID = (size_t)QThread::currentThreadId();
         prefixString.append(QString(" [%1]").arg(threadID));
     }
 
-    if (!_targetName.isEmpty()) {
-        prefixString.append(QString(" [%1]").arg(_targetName));
+    if (!targetName.isEmpty()) {
+        prefixString.append(QString(" [%1]").arg(targetName));
     }
 
-    QString logMessage = QString("%1 %2").arg(prefixString, message.split("\n").join("\n" + prefixString + " "));
-    fprintf(stdout, "%s\n", qPrintable(logMessage));
+    QString logMessage;
+    if (message.contains('\n')) {
+        logMessage = QString("%1 %2").arg(prefixString, message.split("\n").join("\n" + prefixString + " "));
+    } else {
+        logMessage = prefixString + ' ' + message;
+    }
+    writeMessage(type, logMessage);
     return logMessage;
 }
 
@@ -196,10 +273,20 @@ const QString& LogHandler::addRepeatedMessageRegex(const QString& regexString) {
     });
 
     QMutexLocker lock(&_mutex);
+    if (!_repeatedMessageRegexes.contains(regexString)) {
+        QRegularExpression regex(regexString);
+        regex.optimize();
+        _repeatedMessageMatchers.push_back(MessageMatcher(regexString, regex));
+    }
     return *_repeatedMessageRegexes.insert(regexString);
 }
 
 const QString& LogHandler::addOnlyOnceMessageRegex(const QString& regexString) {
     QMutexLocker lock(&_mutex);
+    if (!_onlyOnceMessageRegexes.contains(regexString)) {
+        QRegularExpression regex(regexString);
+        regex.optimize();
+        _onlyOnceMessageMatchers.push_back(MessageMatcher(regexString, regex));
+    }
     return *_onlyOnceMessageRegexes.insert(regexString);
 }
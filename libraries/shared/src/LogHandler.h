@@ -13,14 +13,38 @@
 #ifndef hifi_LogHandler_h
 #define hifi_LogHandler_h
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 #include <QHash>
 #include <QObject>
+#include <QRegularExpression>
 #include <QSet>
 #include <QString>
 #include <QMutex>
+#include <QVector>
+
+#include "MPSCQueue.h"
 
 const int VERBOSE_LOG_INTERVAL_SECONDS = 5;
 
+// logs the statement at most once every intervalMsecs from this call site, for the logs on paths that can run for every
+// packet, e.g. HIFI_LOG_EVERY_MSECS(1000, qCDebug(audio) << "Mismatched codec" << codec);
+#define HIFI_LOG_EVERY_MSECS(intervalMsecs, statement) \
+    do { \
+        static std::atomic<long long> hifiNextLogMsecs { 0 }; \
+        long long hifiNowMsecs = std::chrono::duration_cast<std::chrono::milliseconds>( \
+            std::chrono::steady_clock::now().time_since_epoch()).count(); \
+        long long hifiNextMsecs = hifiNextLogMsecs.load(std::memory_order_relaxed); \
+        if (hifiNowMsecs >= hifiNextMsecs && \
+            hifiNextLogMsecs.compare_exchange_strong(hifiNextMsecs, hifiNowMsecs + (intervalMsecs))) { \
+            statement; \
+        } \
+    } while (false)
+
 enum LogMsgType {
     LogInfo = QtInfoMsg,
     LogDebug = QtDebugMsg,
@@ -31,6 +55,7 @@ enum LogMsgType {
 };
 
 /// Handles custom message handling and sending of stats/logs to Logstash instance
+/// The messages are formatted on the thread that logs them, and written to stdout by a writer thread
 class LogHandler : public QObject {
     Q_OBJECT
 public:
@@ -59,6 +84,10 @@ private:
 
     void flushRepeatedMessages();
 
+    // queues the line for the writer thread, or writes it if the writer isn't running
+    void writeMessage(LogMsgType type, const QString& logMessage);
+    void runWriter();
+
     QString _targetName;
     bool _shouldOutputProcessID { false };
     bool _shouldOutputThreadID { false };
@@ -70,7 +99,20 @@ private:
     QSet<QString> _onlyOnceMessageRegexes;
     QHash<QString, int> _onlyOnceMessageCountHash;
 
+    // the regexes compiled once when they are added, rather than for every message
+    using MessageMatcher = QPair<QString, QRegularExpression>;
+    QVector<MessageMatcher> _repeatedMessageMatchers;
+    QVector<MessageMatcher> _onlyOnceMessageMatchers;
+
     static QMutex _mutex;
+
+    MPSCQueue<QByteArray> _writeQueue;
+    std::atomic<int> _numDroppedMessages { 0 };
+    std::atomic<bool> _isWriterRunning { false };
+    std::atomic<bool> _shouldStopWriter { false };
+    std::mutex _writerMutex;
+    std::condition_variable _writerCondition;
+    std::thread _writerThread;
 };
 
 #endif // hifi_LogHandler_h
@@ -0,0 +1,91 @@
+//
+//  MPSCQueue.h
+//  libraries/shared/src
+//
+//  Created by Sam Gateau on 10/15/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_MPSCQueue_h
+#define hifi_MPSCQueue_h
+
+#include <atomic>
+#include <memory>
+#include <stdint.h>
+
+// A bounded lock-free queue from any number of producer threads to one consumer thread.
+// Any thread may push, only one thread may pop, a push to a full queue fails.
+// Each slot carries a sequence number telling the producers and the consumer whose turn it is to use it.
+template <typename T>
+class MPSCQueue {
+public:
+    MPSCQueue(size_t capacity) {
+        size_t size = 1;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        _mask = size - 1;
+        _slots.reset(new Slot[size]);
+        for (size_t i = 0; i < size; i++) {
+            _slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // any thread
+    bool push(T value) {
+        size_t tail = _tail.load(std::memory_order_relaxed);
+        while (true) {
+            Slot& slot = _slots[tail & _mask];
+            intptr_t difference = (intptr_t)slot.sequence.load(std::memory_order_acquire) - (intptr_t)tail;
+            if (difference == 0) {
+                // the slot is free, claim it unless another producer got there first
+                if (_tail.compare_exchange_weak(tail, tail + 1, std::memory_order_relaxed)) {
+                    slot.value = std::move(value);
+                    slot.sequence.store(tail + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (difference < 0) {
+                // the consumer hasn't freed the slot a lap ago, the queue is full
+                return false;
+            } else {
+                tail = _tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // consumer only
+    bool pop(T& value) {
+        Slot& slot = _slots[_head & _mask];
+        if (slot.sequence.load(std::memory_order_acquire) != _head + 1) {
+            return false;
+        }
+        value = std::move(slot.value);
+        slot.value = T();
+        slot.sequence.store(_head + _mask + 1, std::memory_order_release);
+        ++_head;
+        return true;
+    }
+
+    // consumer only
+    bool isEmpty() const {
+        return _slots[_head & _mask].sequence.load(std::memory_order_acquire) != _head + 1;
+    }
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Slot[]> _slots;
+    size_t _mask { 0 };
+
+    // on their own cache lines, so the producers and the consumer don't invalidate each other's
+    alignas(64) std::atomic<size_t> _tail { 0 };
+    alignas(64) size_t _head { 0 };
+};
+
+#endif // hifi_MPSCQueue_h
@@ -20,6 +20,7 @@
 
 #include "NumericalConstants.h"
 #include "SharedLogging.h"
+#include "Trace.h"
 
 // ----------------------------------------------------------------------------
 // PerformanceWarning
@@ -80,6 +81,7 @@ void PerformanceTimerRecord::tallyResult(const quint64& now) {
 // ----------------------------------------------------------------------------
 
 std::atomic<bool> PerformanceTimer::_isActive(false);
+std::mutex PerformanceTimer::_mutex;
 QHash<QThread*, QString> PerformanceTimer::_fullNames;
 QMap<QString, PerformanceTimerRecord> PerformanceTimer::_records;
 
@@ -87,21 +89,30 @@ QMap<QString, PerformanceTimerRecord> PerformanceTimer::_records;
 PerformanceTimer::PerformanceTimer(const QString& name) {
     if (_isActive) {
         _name = name;
+        std::lock_guard<std::mutex> lock(_mutex);
         QString& fullName = _fullNames[QThread::currentThread()];
         fullName.append("/");
         fullName.append(_name);
         _start = usecTimestampNow();
     }
+    if (Tracer::isActive()) {
+        _name = name;
+        _traceStart = usecTimestampNow();
+    }
 }
 
 PerformanceTimer::~PerformanceTimer() {
     if (_isActive && _start != 0) {
         quint64 elapsedUsec = (usecTimestampNow() - _start);
+        std::lock_guard<std::mutex> lock(_mutex);
         QString& fullName = _fullNames[QThread::currentThread()];
         PerformanceTimerRecord& namedRecord = _records[fullName];
         namedRecord.accumulateResult(elapsedUsec);
         fullName.resize(fullName.size() - (_name.size() + 1));
     }
+    if (_traceStart != 0) {
+        Tracer::addSpan(_name, _traceStart, usecTimestampNow() - _traceStart);
+    }
 }
 
 // static
@@ -111,11 +122,13 @@ bool PerformanceTimer::isActive() {
 
 // static
 QString PerformanceTimer::getContextName() {
+    std::lock_guard<std::mutex> lock(_mutex);
     return _fullNames[QThread::currentThread()];
 }
 
 // static
 void PerformanceTimer::addTimerRecord(const QString& fullName, quint64 elapsedUsec) {
+    std::lock_guard<std::mutex> lock(_mutex);
     PerformanceTimerRecord& namedRecord = _records[fullName];
     namedRecord.accumulateResult(elapsedUsec);
 }
@@ -125,6 +138,7 @@ void PerformanceTimer::setActive(bool active) {
     if (active != _isActive) {
         _isActive.store(active);
         if (!active) {
+            std::lock_guard<std::mutex> lock(_mutex);
             _fullNames.clear();
             _records.clear();
         }
@@ -135,6 +149,7 @@ void PerformanceTimer::setActive(bool active) {
 
 // static
 void PerformanceTimer::tallyAllTimerRecords() {
+    std::lock_guard<std::mutex> lock(_mutex);
     QMap<QString, PerformanceTimerRecord>::iterator recordsItr = _records.begin();
     QMap<QString, PerformanceTimerRecord>::const_iterator recordsEnd = _records.end();
     quint64 now = usecTimestampNow();
@@ -23,6 +23,7 @@
 #include <cstring>
 #include <string>
 #include <map>
+#include <mutex>
 
 using AtomicUIntStat = std::atomic<uintmax_t>;
 
@@ -91,8 +92,10 @@ public:
 
 private:
     quint64 _start = 0;
+    quint64 _traceStart = 0; // the timers are also spans of the trace while the Tracer records
     QString _name;
     static std::atomic<bool> _isActive;
+    static std::mutex _mutex; // the timers are also used on the worker threads
     static QHash<QThread*, QString> _fullNames;
     static QMap<QString, PerformanceTimerRecord> _records;
 };
@@ -22,6 +22,17 @@
 const int PHYSICS_ENGINE_MAX_NUM_SUBSTEPS = 6; // Bullet will start to "lose time" at 10 FPS.
 const float PHYSICS_ENGINE_FIXED_SUBSTEP = 1.0f / 90.0f;
 
+// a step does no more substeps than fit in this budget (but at least the minimum), so that a late frame loses time
+// rather than making the next frame later still
+const quint64 PHYSICS_ENGINE_STEP_BUDGET_USECS = 10000;
+const int PHYSICS_ENGINE_MIN_NUM_BUDGETED_SUBSTEPS = 2;
+
+// dynamic bodies further than the freeze radius from the center of the physics LOD stop being simulated until they are
+// back within the smaller thaw radius, the difference keeps a body at the edge from toggling
+const float PHYSICS_LOD_FREEZE_RADIUS = 200.0f; // meters
+const float PHYSICS_LOD_THAW_RADIUS = 150.0f; // meters
+const quint64 PHYSICS_LOD_UPDATE_PERIOD = 500 * 1000; // usecs
+
 const float DYNAMIC_LINEAR_SPEED_THRESHOLD = 0.05f;  // 5 cm/sec
 const float DYNAMIC_ANGULAR_SPEED_THRESHOLD = 0.087266f;  // ~5 deg/sec
 const float KINEMATIC_LINEAR_SPEED_THRESHOLD = 0.001f;  // 1 mm/sec
@@ -124,7 +124,42 @@ QScriptValue vec3toScriptValue(QScriptEngine* engine, const glm::vec3 &vec3) {
     return obj;
 }
 
+bool numbersFromScriptArray(const QScriptValue& object, float* numbers, int count) {
+    if (!object.isObject()) {
+        return false;
+    }
+    QScriptValue length = object.property("length");
+    if (!length.isNumber() || length.toInt32() < count) {
+        return false;
+    }
+    for (int i = 0; i < count; i++) {
+        numbers[i] = (float)object.property((quint32)i).toNumber();
+    }
+    return true;
+}
+
+bool numbersFromVariantList(const QVariant& object, float* numbers, int count) {
+    if (object.type() != QVariant::List) {
+        return false;
+    }
+    QVariantList list = object.toList();
+    if (list.size() < count) {
+        return false;
+    }
+    for (int i = 0; i < count; i++) {
+        bool valid = false;
+        numbers[i] = list[i].toFloat(&valid);
+        if (!valid) {
+            return false;
+        }
+    }
+    return true;
+}
+
 void vec3FromScriptValue(const QScriptValue &object, glm::vec3 &vec3) {
+    if (numbersFromScriptArray(object, &vec3.x, 3)) {
+        return;
+    }
     vec3.x = object.property("x").toVariant().toFloat();
     vec3.y = object.property("y").toVariant().toFloat();
     vec3.z = object.property("z").toVariant().toFloat();
@@ -178,6 +213,8 @@ glm::vec3 vec3FromVariant(const QVariant& object, bool& valid) {
         v.y = qvec3.y();
         v.z = qvec3.z();
         valid = true;
+    } else if (numbersFromVariantList(object, &v.x, 3)) {
+        valid = true;
     } else {
         auto map = object.toMap();
         auto x = map["x"];
@@ -583,6 +620,13 @@ void xColorFromScriptValue(const QScriptValue &object, xColor& color) {
             color.green = (uint8_t)qcolor.green();
         }
     } else {
+        float rgb[3];
+        if (numbersFromScriptArray(object, rgb, 3)) {
+            color.red = (uint8_t)rgb[0];
+            color.green = (uint8_t)rgb[1];
+            color.blue = (uint8_t)rgb[2];
+            return;
+        }
         color.red = object.property("red").toVariant().toInt();
         color.green = object.property("green").toVariant().toInt();
         color.blue = object.property("blue").toVariant().toInt();
@@ -623,6 +667,14 @@ xColor xColorFromVariant(const QVariant &object, bool& isValid) {
             color.blue = (uint8_t)qcolor.blue();
             color.green = (uint8_t)qcolor.green();
         }
+    } else if (object.type() == QVariant::List) {
+        float rgb[3];
+        isValid = numbersFromVariantList(object, rgb, 3);
+        if (isValid) {
+            color.red = (uint8_t)rgb[0];
+            color.green = (uint8_t)rgb[1];
+            color.blue = (uint8_t)rgb[2];
+        }
     } else {
         QVariantMap map = object.toMap();
         color.red = map["red"].toInt(&isValid);
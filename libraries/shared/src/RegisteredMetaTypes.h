@@ -40,6 +40,12 @@ void registerMetaTypes(QScriptEngine* engine);
 QScriptValue mat4toScriptValue(QScriptEngine* engine, const glm::mat4& mat4);
 void mat4FromScriptValue(const QScriptValue& object, glm::mat4& mat4);
 
+// Reads the first count numbers of a script array or typed array ([1, 2, 3], new Float32Array(3)...),
+// returns false if the value isn't an array or is too short
+bool numbersFromScriptArray(const QScriptValue& object, float* numbers, int count);
+// The same for a variant converted from a script array
+bool numbersFromVariantList(const QVariant& object, float* numbers, int count);
+
 // Vec4
 QScriptValue vec4toScriptValue(QScriptEngine* engine, const glm::vec4& vec4);
 void vec4FromScriptValue(const QScriptValue& object, glm::vec4& vec4);
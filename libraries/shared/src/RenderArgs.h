@@ -120,6 +120,10 @@ public:
     RenderSide _renderSide = MONO;
     DebugFlags _debugFlags = RENDER_DEBUG_NONE;
     gpu::Batch* _batch = nullptr;
+    // Lets the static opaque mesh parts be gathered into multi draw indirect calls at the end of the batch
+    bool _enableMultiDrawIndirect = false;
+    // Scales the size of the mesh parts on screen when picking their level of detail, lower switches to the simplified ones sooner
+    float _meshLODBias = 1.0f;
 
     std::shared_ptr<gpu::Texture> _whiteTexture;
 
@@ -14,6 +14,7 @@
 
 #include <stdlib.h>
 #include <iterator>
+#include <utility>
 
 #include <qvector.h>
 
@@ -66,6 +67,18 @@ public:
         }
     }
 
+    // inserts entry and hands back in it the entry it overwrote, so that its storage can be reused
+    void swapInsert(T& entry) {
+        // increment newest entry index cyclically
+        _newestEntryAtIndex = (_newestEntryAtIndex + 1) % _size;
+
+        // swap the new entry with the one past the oldest
+        std::swap(_buffer[_newestEntryAtIndex], entry);
+        if (_numEntries < _capacity) {
+            _numEntries++;
+        }
+    }
+
     // 0 retrieves the most recent entry, _numEntries - 1 retrieves the oldest.
     // returns NULL if entryAge not within [0, _numEntries-1]
     const T* get(int entryAge) const {
@@ -0,0 +1,65 @@
+//
+//  SPSCQueue.h
+//  libraries/shared/src
+//
+//  Created by Sam Gateau on 10/15/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SPSCQueue_h
+#define hifi_SPSCQueue_h
+
+#include <atomic>
+#include <vector>
+
+// A bounded lock-free queue between one producer thread and one consumer thread.
+// Only one thread may push and only one thread may pop, a push to a full queue fails.
+template <typename T>
+class SPSCQueue {
+public:
+    SPSCQueue(size_t capacity) : _slots(capacity + 1) {}
+
+    // producer only
+    bool push(T value) {
+        size_t tail = _tail.load(std::memory_order_relaxed);
+        size_t nextTail = next(tail);
+        if (nextTail == _head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        _slots[tail] = std::move(value);
+        _tail.store(nextTail, std::memory_order_release);
+        return true;
+    }
+
+    // consumer only
+    bool pop(T& value) {
+        size_t head = _head.load(std::memory_order_relaxed);
+        if (head == _tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        value = std::move(_slots[head]);
+        _slots[head] = T();
+        _head.store(next(head), std::memory_order_release);
+        return true;
+    }
+
+    // consumer only
+    void clear() {
+        T value;
+        while (pop(value)) {}
+    }
+
+private:
+    size_t next(size_t index) const { return (index + 1) % _slots.size(); }
+
+    std::vector<T> _slots;
+
+    // on their own cache lines, so the producer and the consumer don't invalidate each other's
+    alignas(64) std::atomic<size_t> _head { 0 };
+    alignas(64) std::atomic<size_t> _tail { 0 };
+};
+
+#endif // hifi_SPSCQueue_h
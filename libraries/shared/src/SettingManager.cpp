@@ -51,17 +51,28 @@ namespace Setting {
 
     void Manager::loadSetting(Interface* handle) {
         const auto& key = handle->getKey();
-        withWriteLock([&] {
-            QVariant loadedValue;
-            if (_pendingChanges.contains(key) && _pendingChanges[key] != UNSET_VALUE) {
-                loadedValue = _pendingChanges[key];
-            } else {
-                loadedValue = value(key);
-            }
-            if (loadedValue.isValid()) {
-                handle->setVariant(loadedValue);
+        QVariant loadedValue;
+        bool isUnsaved = false;
+        withReadLock([&] {
+            // the latest change is in _pendingChanges, or in _savingChanges while saveAll writes it
+            auto pending = _pendingChanges.constFind(key);
+            if (pending == _pendingChanges.cend() || pending.value() == UNSET_VALUE) {
+                pending = _savingChanges.constFind(key);
+                if (pending == _savingChanges.cend() || pending.value() == UNSET_VALUE) {
+                    return;
+                }
             }
+            loadedValue = pending.value();
+            isUnsaved = true;
         });
+
+        if (!isUnsaved) {
+            std::lock_guard<std::mutex> lock(_settingsMutex);
+            loadedValue = value(key);
+        }
+        if (loadedValue.isValid()) {
+            handle->setVariant(loadedValue);
+        }
     }
 
 
@@ -96,10 +107,20 @@ namespace Setting {
     }
 
     void Manager::saveAll() {
-        bool forceSync = false;
+        // take the changed keys, each with its last value, and write them without holding the lock
+        // so saveSetting and loadSetting never wait on the QSettings writes (the registry on Windows)
+        QHash<QString, QVariant> changes;
         withWriteLock([&] {
-            for (auto key : _pendingChanges.keys()) {
-                auto newValue = _pendingChanges[key];
+            changes.swap(_pendingChanges);
+            _savingChanges = changes;
+        });
+
+        if (!changes.isEmpty()) {
+            std::lock_guard<std::mutex> lock(_settingsMutex);
+            bool forceSync = false;
+            for (auto it = changes.cbegin(); it != changes.cend(); ++it) {
+                const auto& key = it.key();
+                const auto& newValue = it.value();
                 auto savedValue = value(key, UNSET_VALUE);
                 if (newValue == savedValue) {
                     continue;
@@ -112,13 +133,16 @@ namespace Setting {
                     setValue(key, newValue);
                 }
             }
-            _pendingChanges.clear();
-        });
 
-        if (forceSync) {
-            sync();
+            if (forceSync) {
+                sync();
+            }
         }
 
+        withWriteLock([&] {
+            _savingChanges.clear();
+        });
+
         // Restart timer
         if (_saveTimer) {
             _saveTimer->start();
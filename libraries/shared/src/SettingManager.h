@@ -12,6 +12,8 @@
 #ifndef hifi_SettingManager_h
 #define hifi_SettingManager_h
 
+#include <mutex>
+
 #include <QtCore/QPointer>
 #include <QtCore/QSettings>
 #include <QtCore/QTimer>
@@ -48,6 +50,9 @@ namespace Setting {
         QPointer<QTimer> _saveTimer = nullptr;
         const QVariant UNSET_VALUE { QUuid::createUuid() };
         QHash<QString, QVariant> _pendingChanges;
+        // the changes saveAll is writing, taken out of _pendingChanges so the handles don't wait on the writes
+        QHash<QString, QVariant> _savingChanges;
+        std::mutex _settingsMutex; // guards the QSettings, which is read and written outside of the lock
 
         friend class Interface;
         friend void cleanupPrivateInstance();
@@ -13,6 +13,8 @@
 
 #include <math.h>
 
+#include <QDataStream>
+
 #include "NumericalConstants.h" // for MILLIMETERS_PER_METER
 
 void ShapeInfo::clear() {
@@ -239,3 +241,58 @@ const DoubleHashKey& ShapeInfo::getHash() const {
     }
     return _doubleHashKey;
 }
+
+static const quint32 POINT_COLLECTION_MAGIC = 0x48464843; // "HFHC"
+static const quint32 POINT_COLLECTION_VERSION = 1;
+
+QByteArray ShapeInfo::writePointCollection(const PointCollection& pointCollection) {
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+    stream << POINT_COLLECTION_MAGIC << POINT_COLLECTION_VERSION << (quint32)pointCollection.size();
+    for (const auto& points : pointCollection) {
+        stream << (quint32)points.size();
+        for (const auto& point : points) {
+            stream << point.x << point.y << point.z;
+        }
+    }
+    return data;
+}
+
+bool ShapeInfo::readPointCollection(const QByteArray& data, PointCollection& pointCollection) {
+    QDataStream stream(data);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    quint32 numPointLists = 0;
+    stream >> magic >> version >> numPointLists;
+    if (stream.status() != QDataStream::Ok || magic != POINT_COLLECTION_MAGIC || version != POINT_COLLECTION_VERSION) {
+        return false;
+    }
+
+    // each point takes 12 bytes, so a corrupt count can't make us allocate more than the data could hold
+    const quint32 BYTES_PER_POINT = 3 * sizeof(float);
+    PointCollection result;
+    for (quint32 i = 0; i < numPointLists; i++) {
+        quint32 numPoints = 0;
+        stream >> numPoints;
+        if (stream.status() != QDataStream::Ok || (qint64)numPoints * BYTES_PER_POINT > (qint64)data.size()) {
+            return false;
+        }
+        PointList points;
+        points.resize(numPoints);
+        for (auto& point : points) {
+            stream >> point.x >> point.y >> point.z;
+        }
+        if (stream.status() != QDataStream::Ok) {
+            return false;
+        }
+        result.push_back(points);
+    }
+    pointCollection = result;
+    return true;
+}
@@ -12,6 +12,7 @@
 #ifndef hifi_ShapeInfo_h
 #define hifi_ShapeInfo_h
 
+#include <QByteArray>
 #include <QVector>
 #include <QString>
 #include <QUrl>
@@ -87,6 +88,11 @@ public:
 
     const DoubleHashKey& getHash() const;
 
+    // A compact binary form of the point collection of a compound shape, as vhacd-util writes the hulls it computes,
+    // so they can be loaded without reading a model. readPointCollection returns false if data isn't one.
+    static QByteArray writePointCollection(const PointCollection& pointCollection);
+    static bool readPointCollection(const QByteArray& data, PointCollection& pointCollection);
+
 protected:
     QUrl _url; // url for model of convex collision hulls
     PointCollection _pointCollection;
@@ -0,0 +1,55 @@
+//
+//  SlabPool.cpp
+//  libraries/shared/src
+//
+//  Created by Sam Gateau on 10/15/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SlabPool.h"
+
+#include <algorithm>
+#include <cstddef>
+
+// blocks are aligned as any object new would return
+static const size_t BLOCK_ALIGNMENT = alignof(std::max_align_t);
+
+SlabPool::SlabPool(size_t blockSize, size_t blocksPerSlab) :
+    _blockSize((std::max(blockSize, sizeof(FreeBlock)) + BLOCK_ALIGNMENT - 1) & ~(BLOCK_ALIGNMENT - 1)),
+    _blocksPerSlab(blocksPerSlab),
+    _nextBlockInSlab(blocksPerSlab)
+{
+}
+
+void* SlabPool::allocate() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    ++_allocatedCount;
+
+    // reuse the most recently freed block, it is the most likely to still be in the cache
+    if (_freeBlocks) {
+        FreeBlock* block = _freeBlocks;
+        _freeBlocks = block->next;
+        return block;
+    }
+
+    if (_nextBlockInSlab == _blocksPerSlab) {
+        _slabs.emplace_back(new char[_blockSize * _blocksPerSlab]);
+        _nextBlockInSlab = 0;
+    }
+    return _slabs.back().get() + _blockSize * _nextBlockInSlab++;
+}
+
+void SlabPool::deallocate(void* block) {
+    if (!block) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(_mutex);
+    --_allocatedCount;
+
+    FreeBlock* freeBlock = static_cast<FreeBlock*>(block);
+    freeBlock->next = _freeBlocks;
+    _freeBlocks = freeBlock;
+}
@@ -0,0 +1,50 @@
+//
+//  SlabPool.h
+//  libraries/shared/src
+//
+//  Created by Sam Gateau on 10/15/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SlabPool_h
+#define hifi_SlabPool_h
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Hands out fixed size blocks carved from slabs of many blocks, so objects allocated one after the other sit next to
+// each other in memory. The freed blocks are kept on a free list for reuse, the slabs are only released with the pool.
+// Any thread may allocate and deallocate.
+class SlabPool {
+public:
+    SlabPool(size_t blockSize, size_t blocksPerSlab);
+
+    size_t getBlockSize() const { return _blockSize; }
+
+    void* allocate();
+    void deallocate(void* block);
+
+    // only exact when no other thread is allocating
+    size_t getAllocatedCount() const { return _allocatedCount; }
+    size_t getSlabCount() const { return _slabs.size(); }
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    const size_t _blockSize;
+    const size_t _blocksPerSlab;
+
+    std::mutex _mutex;
+    std::vector<std::unique_ptr<char[]>> _slabs;
+    FreeBlock* _freeBlocks { nullptr };
+    size_t _nextBlockInSlab { 0 };
+    size_t _allocatedCount { 0 };
+};
+
+#endif // hifi_SlabPool_h
@@ -17,6 +17,39 @@
 
 const float defaultAACubeSize = 1.0f;
 const int maxParentingChain = 30;
+const int maxOptimisticTransformReads = 4; // before a reader waits on the writer instead
+
+template <typename F>
+void SpatiallyNestable::withTransformReadLock(F&& f) const {
+    // f only copies out of _transform - a copy that raced a writer may hold a torn value, which is then discarded
+    for (int i = 0; i < maxOptimisticTransformReads; i++) {
+        uint32_t sequence = _transformSequence.load(std::memory_order_acquire);
+        if ((sequence & 1) == 0) {
+            f();
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (_transformSequence.load(std::memory_order_relaxed) == sequence) {
+                return;
+            }
+        }
+    }
+    // a busy writer, take the lock (which also works from within a write on this thread)
+    _transformLock.withReadLock(std::forward<F>(f));
+}
+
+template <typename F>
+void SpatiallyNestable::withTransformWriteLock(F&& f) const {
+    _transformLock.withWriteLock([&] {
+        // only the outermost of nested writes marks the transform as being written
+        if (_transformWriteDepth++ == 0) {
+            _transformSequence.store(_transformSequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+        }
+        f();
+        if (--_transformWriteDepth == 0) {
+            _transformSequence.store(_transformSequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+    });
+}
 
 SpatiallyNestable::SpatiallyNestable(NestableType nestableType, QUuid id) :
     _nestableType(nestableType),
@@ -392,7 +425,7 @@ void SpatiallyNestable::setPosition(const glm::vec3& position, bool& success, bo
     bool changed = false;
     Transform parentTransform = getParentTransform(success);
     Transform myWorldTransform;
-    _transformLock.withWriteLock([&] {
+    withTransformWriteLock([&] {
         Transform::mult(myWorldTransform, parentTransform, _transform);
         if (myWorldTransform.getTranslation() != position) {
             changed = true;
@@ -444,7 +477,7 @@ void SpatiallyNestable::setOrientation(const glm::quat& orientation, bool& succe
     bool changed = false;
     Transform parentTransform = getParentTransform(success);
     Transform myWorldTransform;
-    _transformLock.withWriteLock([&] {
+    withTransformWriteLock([&] {
         Transform::mult(myWorldTransform, parentTransform, _transform);
         if (myWorldTransform.getRotation() != orientation) {
             changed = true;
@@ -589,7 +622,7 @@ const Transform SpatiallyNestable::getTransform(bool& success, int depth) const
     Transform result;
     // return a world-space transform for this object's location
     Transform parentTransform = getParentTransform(success, depth);
-    _transformLock.withReadLock([&] {
+    withTransformReadLock([&] {
         Transform::mult(result, parentTransform, _transform);
     });
     return result;
@@ -643,7 +676,7 @@ void SpatiallyNestable::setTransform(const Transform& transform, bool& success)
 
     bool changed = false;
     Transform parentTransform = getParentTransform(success);
-    _transformLock.withWriteLock([&] {
+    withTransformWriteLock([&] {
         Transform beforeTransform = _transform;
         Transform::inverseMult(_transform, parentTransform, transform);
         if (_transform != beforeTransform) {
@@ -664,7 +697,7 @@ bool SpatiallyNestable::setTransform(const Transform& transform) {
 glm::vec3 SpatiallyNestable::getScale() const {
     // TODO: scale
     glm::vec3 result;
-    _transformLock.withReadLock([&] {
+    withTransformReadLock([&] {
         result = _transform.getScale();
     });
     return result;
@@ -684,7 +717,7 @@ void SpatiallyNestable::setScale(const glm::vec3& scale) {
 
     bool changed = false;
     // TODO: scale
-    _transformLock.withWriteLock([&] {
+    withTransformWriteLock([&] {
         if (_transform.getScale() != scale) {
             _transform.setScale(scale);
             changed = true;
@@ -704,7 +737,7 @@ void SpatiallyNestable::setScale(float value) {
 
     bool changed = false;
     // TODO: scale
-    _transformLock.withWriteLock([&] {
+    withTransformWriteLock([&] {
         glm::vec3 beforeScale = _transform.getScale();
         _transform.setScale(value);
         if (_transform.getScale() != beforeScale) {
@@ -719,7 +752,7 @@ void SpatiallyNestable::setScale(float value) {
 
 const Transform SpatiallyNestable::getLocalTransform() const {
     Transform result;
-    _transformLock.withReadLock([&] {
+    withTransformReadLock([&] {
         result =_transform;
     });
     return result;
@@ -733,7 +766,7 @@ void SpatiallyNestable::setLocalTransform(const Transform& transform) {
     }
 
     bool changed = false;
-    _transformLock.withWriteLock([&] {
+    withTransformWriteLock([&] {
         if (_transform != transform) {
             _transform = transform;
             changed = true;
@@ -747,7 +780,7 @@ void SpatiallyNestable::setLocalTransform(const Transform& transform) {
 
 glm::vec3 SpatiallyNestable::getLocalPosition() const {
     glm::vec3 result;
-    _transformLock.withReadLock([&] {
+    withTransformReadLock([&] {
         result = _transform.getTranslation();
     });
     return result;
@@ -760,7 +793,7 @@ void SpatiallyNestable::setLocalPosition(const glm::vec3& position, bool tellPhy
         return;
     }
     bool changed = false;
-    _transformLock.withWriteLock([&] {
+    withTransformWriteLock([&] {
         if (_transform.getTranslation() != position) {
             _transform.setTranslation(position);
             changed = true;
@@ -773,7 +806,7 @@ void SpatiallyNestable::setLocalPosition(const glm::vec3& position, bool tellPhy
 
 glm::quat SpatiallyNestable::getLocalOrientation() const {
     glm::quat result;
-    _transformLock.withReadLock([&] {
+    withTransformReadLock([&] {
         result = _transform.getRotation();
     });
     return result;
@@ -786,7 +819,7 @@ void SpatiallyNestable::setLocalOrientation(const glm::quat& orientation) {
         return;
     }
     bool changed = false;
-    _transformLock.withWriteLock([&] {
+    withTransformWriteLock([&] {
         if (_transform.getRotation() != orientation) {
             _transform.setRotation(orientation);
             changed = true;
@@ -828,7 +861,7 @@ void SpatiallyNestable::setLocalAngularVelocity(const glm::vec3& angularVelocity
 glm::vec3 SpatiallyNestable::getLocalScale() const {
     // TODO: scale
     glm::vec3 result;
-    _transformLock.withReadLock([&] {
+    withTransformReadLock([&] {
         result = _transform.getScale();
     });
     return result;
@@ -843,7 +876,7 @@ void SpatiallyNestable::setLocalScale(const glm::vec3& scale) {
 
     bool changed = false;
     // TODO: scale
-    _transformLock.withWriteLock([&] {
+    withTransformWriteLock([&] {
         if (_transform.getScale() != scale) {
             _transform.setScale(scale);
             changed = true;
@@ -1033,7 +1066,7 @@ void SpatiallyNestable::getLocalTransformAndVelocities(
         glm::vec3& velocity,
         glm::vec3& angularVelocity) const {
     // transform
-    _transformLock.withReadLock([&] {
+    withTransformReadLock([&] {
         transform = _transform;
     });
     // linear velocity
@@ -1054,7 +1087,7 @@ void SpatiallyNestable::setLocalTransformAndVelocities(
     bool changed = false;
 
     // transform
-    _transformLock.withWriteLock([&] {
+    withTransformWriteLock([&] {
         if (_transform != localTransform) {
             _transform = localTransform;
             changed = true;
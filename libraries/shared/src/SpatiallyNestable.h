@@ -12,6 +12,8 @@
 #ifndef hifi_SpatiallyNestable_h
 #define hifi_SpatiallyNestable_h
 
+#include <atomic>
+
 #include <QUuid>
 
 #include "Transform.h"
@@ -201,7 +203,14 @@ protected:
     bool _missingAncestor { false };
 
 private:
-    mutable ReadWriteLockable _transformLock;
+    // _transform is read without its lock: a reader copies it and retries if a writer changed it during the copy,
+    // so the many readers of a transform (render, physics, scripts, network encoding) don't contend with each other
+    template <typename F> void withTransformReadLock(F&& f) const;
+    template <typename F> void withTransformWriteLock(F&& f) const;
+
+    mutable ReadWriteLockable _transformLock; // serializes the writers of _transform
+    mutable std::atomic<uint32_t> _transformSequence { 0 }; // odd while _transform is being written
+    mutable int _transformWriteDepth { 0 };
     mutable ReadWriteLockable _idLock;
     mutable ReadWriteLockable _velocityLock;
     mutable ReadWriteLockable _angularVelocityLock;
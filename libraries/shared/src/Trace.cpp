@@ -0,0 +1,173 @@
+//
+//  Trace.cpp
+//  libraries/shared/src
+//
+//  Created by Sam Gateau on 10/15/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "Trace.h"
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QThread>
+#include <QtCore/QTimer>
+
+#include "NumericalConstants.h"
+#include "SPSCQueue.h"
+#include "SharedLogging.h"
+
+std::atomic<bool> Tracer::_isActive { false };
+
+namespace {
+
+struct TraceEvent {
+    QString name;
+    quint64 start;
+    quint64 duration;
+};
+
+// about 15 seconds of the busiest threads, the spans recorded past that are dropped
+const size_t MAX_EVENTS_PER_THREAD = 1 << 16;
+
+// The thread records into its queue and the tracer drains it, a queue outlives its thread until the next drain
+struct ThreadEvents {
+    ThreadEvents(int id, const QString& name) : id(id), name(name), events(MAX_EVENTS_PER_THREAD) {}
+
+    const int id;
+    const QString name;
+    SPSCQueue<TraceEvent> events;
+    std::atomic<size_t> droppedEvents { 0 };
+};
+using ThreadEventsPointer = std::shared_ptr<ThreadEvents>;
+
+// guards the list of threads and the draining of their queues, never taken by a thread recording a span
+std::mutex threadsMutex;
+std::vector<ThreadEventsPointer> threads;
+int nextThreadId { 1 };
+
+thread_local ThreadEventsPointer localEvents;
+
+ThreadEvents& getLocalEvents() {
+    if (!localEvents) {
+        QThread* thread = QThread::currentThread();
+        QString name = thread->objectName();
+        if (name.isEmpty() && QCoreApplication::instance() && thread == QCoreApplication::instance()->thread()) {
+            name = "main thread";
+        }
+
+        std::lock_guard<std::mutex> lock(threadsMutex);
+        int id = nextThreadId++;
+        localEvents = std::make_shared<ThreadEvents>(id, name.isEmpty() ? QString("thread %1").arg(id) : name);
+        threads.push_back(localEvents);
+    }
+    return *localEvents;
+}
+
+// the queues of the threads that ended are only held by the list once drained
+void dropEndedThreads() {
+    threads.erase(std::remove_if(threads.begin(), threads.end(), [](const ThreadEventsPointer& thread) {
+        return thread.use_count() == 1;
+    }), threads.end());
+}
+
+}
+
+void Tracer::start() {
+    std::lock_guard<std::mutex> lock(threadsMutex);
+    for (auto& thread : threads) {
+        thread->events.clear();
+        thread->droppedEvents = 0;
+    }
+    dropEndedThreads();
+
+    _isActive = true;
+    qCDebug(shared) << "Tracer started recording";
+}
+
+bool Tracer::stop(const QString& path) {
+    if (!_isActive.exchange(false)) {
+        return false;
+    }
+
+    const qint64 pid = QCoreApplication::applicationPid();
+    QJsonArray traceEvents;
+    size_t droppedEvents = 0;
+    {
+        std::lock_guard<std::mutex> lock(threadsMutex);
+        for (auto& thread : threads) {
+            QJsonObject threadName;
+            threadName["name"] = "thread_name";
+            threadName["ph"] = "M";
+            threadName["pid"] = pid;
+            threadName["tid"] = thread->id;
+            threadName["args"] = QJsonObject { { "name", thread->name } };
+            traceEvents.append(threadName);
+
+            TraceEvent event;
+            while (thread->events.pop(event)) {
+                QJsonObject traceEvent;
+                traceEvent["name"] = event.name;
+                traceEvent["ph"] = "X";
+                traceEvent["ts"] = (qint64)event.start;
+                traceEvent["dur"] = (qint64)event.duration;
+                traceEvent["pid"] = pid;
+                traceEvent["tid"] = thread->id;
+                traceEvents.append(traceEvent);
+            }
+            droppedEvents += thread->droppedEvents.exchange(0);
+        }
+        dropEndedThreads();
+    }
+
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCWarning(shared) << "Tracer could not write the trace to" << path;
+        return false;
+    }
+    QJsonObject trace;
+    trace["traceEvents"] = traceEvents;
+    trace["displayTimeUnit"] = "ms";
+    file.write(QJsonDocument(trace).toJson(QJsonDocument::Compact));
+
+    qCDebug(shared) << "Tracer wrote" << traceEvents.size() << "events to" << path;
+    if (droppedEvents > 0) {
+        qCWarning(shared) << "Tracer dropped" << droppedEvents << "events past the capacity of the threads";
+    }
+    return true;
+}
+
+void Tracer::record(const QString& path, int seconds) {
+    start();
+    QTimer::singleShot(seconds * (int)MSECS_PER_SECOND, [path] {
+        stop(path);
+    });
+}
+
+QString Tracer::getDefaultPath() {
+    QString fileName = QString("trace-%1.json").arg(QDateTime::currentDateTime().toString("yyyy-MM-dd_hh-mm-ss"));
+    return QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/traces/" + fileName;
+}
+
+void Tracer::addSpan(const QString& name, quint64 start, quint64 duration) {
+    auto& localThread = getLocalEvents();
+    if (!localThread.events.push({ name, start, duration })) {
+        ++localThread.droppedEvents;
+    }
+}
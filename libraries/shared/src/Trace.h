@@ -0,0 +1,62 @@
+//
+//  Trace.h
+//  libraries/shared/src
+//
+//  Created by Sam Gateau on 10/15/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_Trace_h
+#define hifi_Trace_h
+
+#include <atomic>
+
+#include <QtCore/QString>
+
+#include "SharedUtil.h"
+
+// Records timed spans from all the threads of the process on one timeline, and writes them in the Chrome trace event
+// format, to open in chrome://tracing or ui.perfetto.dev.
+// Every thread records in its own lock-free queue, a span costs a timestamp when recording and nothing otherwise.
+class Tracer {
+public:
+    static bool isActive() { return _isActive.load(std::memory_order_relaxed); }
+
+    // drops the spans recorded so far and starts recording
+    static void start();
+
+    // stops recording and writes the spans to the file, returns false if it can't be written
+    static bool stop(const QString& path);
+
+    // records from now for the duration then writes the spans to the file, from the event loop of the caller's thread
+    static void record(const QString& path, int seconds);
+
+    // a file named after the current time in the traces directory of the application data
+    static QString getDefaultPath();
+
+    static void addSpan(const QString& name, quint64 start, quint64 duration);
+
+private:
+    static std::atomic<bool> _isActive;
+};
+
+class TraceSpan {
+public:
+    TraceSpan(const char* name) : _name(name), _start(Tracer::isActive() ? usecTimestampNow() : 0) {}
+    ~TraceSpan() {
+        if (_start != 0) {
+            Tracer::addSpan(_name, _start, usecTimestampNow() - _start);
+        }
+    }
+
+private:
+    const char* _name;
+    const quint64 _start;
+};
+
+#define TRACE_SPAN(name) TraceSpan traceSpanThis(name);
+
+#endif // hifi_Trace_h
@@ -0,0 +1,170 @@
+//
+//  TriangleBVH.cpp
+//  libraries/shared/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "TriangleBVH.h"
+
+#include <algorithm>
+#include <limits>
+
+// a median split halves the triangles at each level, so this covers any mesh we can hold in memory
+static const int MAX_TRAVERSAL_DEPTH = 64;
+
+TriangleBVH::TriangleBVH(const QVector<Triangle>& triangles) {
+    int numTriangles = triangles.size();
+    if (numTriangles == 0) {
+        return;
+    }
+
+    _triangles.assign(triangles.begin(), triangles.end());
+
+    std::vector<glm::vec3> centroids;
+    std::vector<int> order;
+    centroids.reserve(numTriangles);
+    order.reserve(numTriangles);
+    for (int i = 0; i < numTriangles; i++) {
+        const Triangle& triangle = _triangles[i];
+        centroids.push_back((triangle.v0 + triangle.v1 + triangle.v2) / 3.0f);
+        order.push_back(i);
+    }
+
+    _nodes.reserve(2 * (numTriangles / MAX_TRIANGLES_PER_LEAF + 1));
+    build(0, numTriangles, order, centroids);
+
+    // store the triangles in leaf order, so that each leaf is a range
+    std::vector<Triangle> sortedTriangles;
+    sortedTriangles.reserve(numTriangles);
+    for (int index : order) {
+        sortedTriangles.push_back(_triangles[index]);
+    }
+    _triangles.swap(sortedTriangles);
+}
+
+int TriangleBVH::build(int first, int count, std::vector<int>& order, const std::vector<glm::vec3>& centroids) {
+    const float BIG_FLOAT = std::numeric_limits<float>::max();
+    Node node;
+    node.minimum = glm::vec3(BIG_FLOAT);
+    node.maximum = glm::vec3(-BIG_FLOAT);
+    glm::vec3 minimumCentroid(BIG_FLOAT);
+    glm::vec3 maximumCentroid(-BIG_FLOAT);
+
+    auto begin = order.begin() + first;
+    auto end = begin + count;
+    for (auto it = begin; it != end; ++it) {
+        const Triangle& triangle = _triangles[*it];
+        node.minimum = glm::min(node.minimum, glm::min(triangle.v0, glm::min(triangle.v1, triangle.v2)));
+        node.maximum = glm::max(node.maximum, glm::max(triangle.v0, glm::max(triangle.v1, triangle.v2)));
+        minimumCentroid = glm::min(minimumCentroid, centroids[*it]);
+        maximumCentroid = glm::max(maximumCentroid, centroids[*it]);
+    }
+
+    int index = (int)_nodes.size();
+    if (count <= MAX_TRIANGLES_PER_LEAF) {
+        node.first = first;
+        node.count = count;
+        _nodes.push_back(node);
+        return index;
+    }
+    node.count = 0;
+    _nodes.push_back(node);
+
+    // split at the median centroid along the longest axis of the centroids
+    glm::vec3 extent = maximumCentroid - minimumCentroid;
+    int axis = (extent.x >= extent.y && extent.x >= extent.z) ? 0 : (extent.y >= extent.z ? 1 : 2);
+    int half = count / 2;
+    std::nth_element(begin, begin + half, end, [&](int a, int b) {
+        return centroids[a][axis] < centroids[b][axis];
+    });
+
+    // the first child follows its parent, so only the second child's index needs storing
+    build(first, half, order, centroids);
+    int secondChild = build(first + half, count - half, order, centroids);
+    _nodes[index].first = secondChild;
+    return index;
+}
+
+bool TriangleBVH::findRayBoxEntry(const glm::vec3& origin, const glm::vec3& inverseDirection, const Node& node,
+                                  float maxDistance, float& entryDistance) {
+    glm::vec3 toMinimum = (node.minimum - origin) * inverseDirection;
+    glm::vec3 toMaximum = (node.maximum - origin) * inverseDirection;
+    glm::vec3 nearest = glm::min(toMinimum, toMaximum);
+    glm::vec3 farthest = glm::max(toMinimum, toMaximum);
+    float entry = std::max(std::max(nearest.x, nearest.y), std::max(nearest.z, 0.0f));
+    float exit = std::min(std::min(farthest.x, farthest.y), std::min(farthest.z, maxDistance));
+    if (entry > exit) {
+        return false;
+    }
+    entryDistance = entry;
+    return true;
+}
+
+bool TriangleBVH::findRayIntersection(const glm::vec3& origin, const glm::vec3& direction,
+                                      float& distance, int& triangleIndex) const {
+    if (_nodes.empty()) {
+        return false;
+    }
+    glm::vec3 inverseDirection = 1.0f / direction;
+
+    float entryDistance;
+    if (!findRayBoxEntry(origin, inverseDirection, _nodes[0], distance, entryDistance)) {
+        return false;
+    }
+
+    struct StackEntry {
+        int node;
+        float entryDistance;
+    };
+    StackEntry stack[MAX_TRAVERSAL_DEPTH];
+    int stackSize = 0;
+    stack[stackSize++] = { 0, entryDistance };
+
+    bool intersects = false;
+    while (stackSize > 0) {
+        StackEntry entry = stack[--stackSize];
+        if (entry.entryDistance >= distance) {
+            continue; // we found a closer triangle since this was pushed
+        }
+        const Node& node = _nodes[entry.node];
+
+        if (node.count > 0) {
+            for (int i = node.first, end = node.first + node.count; i < end; i++) {
+                float triangleDistance;
+                if (findRayTriangleIntersection(origin, direction, _triangles[i], triangleDistance)
+                        && triangleDistance < distance) {
+                    distance = triangleDistance;
+                    triangleIndex = i;
+                    intersects = true;
+                }
+            }
+            continue;
+        }
+
+        int firstChild = entry.node + 1;
+        int secondChild = node.first;
+        float firstDistance, secondDistance;
+        bool hitsFirst = findRayBoxEntry(origin, inverseDirection, _nodes[firstChild], distance, firstDistance);
+        bool hitsSecond = findRayBoxEntry(origin, inverseDirection, _nodes[secondChild], distance, secondDistance);
+
+        // push the farther child first, so that the nearer one is visited first and can prune the other
+        if (hitsFirst && hitsSecond) {
+            if (firstDistance < secondDistance) {
+                stack[stackSize++] = { secondChild, secondDistance };
+                stack[stackSize++] = { firstChild, firstDistance };
+            } else {
+                stack[stackSize++] = { firstChild, firstDistance };
+                stack[stackSize++] = { secondChild, secondDistance };
+            }
+        } else if (hitsFirst) {
+            stack[stackSize++] = { firstChild, firstDistance };
+        } else if (hitsSecond) {
+            stack[stackSize++] = { secondChild, secondDistance };
+        }
+    }
+    return intersects;
+}
@@ -0,0 +1,57 @@
+//
+//  TriangleBVH.h
+//  libraries/shared/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_TriangleBVH_h
+#define hifi_TriangleBVH_h
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <QVector>
+
+#include "GeometryUtil.h"
+
+// Bounding volume hierarchy over a set of triangles, for ray picks that only test the triangles near the ray.
+// It is immutable once built, so one can be shared by any number of readers.
+class TriangleBVH {
+public:
+    static const int MAX_TRIANGLES_PER_LEAF = 4;
+
+    TriangleBVH() = default;
+    TriangleBVH(const QVector<Triangle>& triangles);
+
+    bool isEmpty() const { return _triangles.empty(); }
+    int getNumTriangles() const { return (int)_triangles.size(); }
+    const Triangle& getTriangle(int index) const { return _triangles[index]; }
+
+    // finds the closest triangle (by the same test as findRayTriangleIntersection) that is nearer than distance,
+    // distance is in units of direction, which does not need to be normalized
+    bool findRayIntersection(const glm::vec3& origin, const glm::vec3& direction, float& distance, int& triangleIndex) const;
+
+private:
+    struct Node {
+        glm::vec3 minimum;
+        glm::vec3 maximum;
+        int first; // first triangle of a leaf, or the second child of an inner node (the first child follows it)
+        int count; // triangles in a leaf, 0 for an inner node
+    };
+
+    int build(int first, int count, std::vector<int>& order, const std::vector<glm::vec3>& centroids);
+    static bool findRayBoxEntry(const glm::vec3& origin, const glm::vec3& inverseDirection, const Node& node,
+                                float maxDistance, float& entryDistance);
+
+    std::vector<Node> _nodes;
+    std::vector<Triangle> _triangles;
+};
+
+#endif // hifi_TriangleBVH_h
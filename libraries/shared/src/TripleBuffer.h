@@ -0,0 +1,59 @@
+//
+//  TripleBuffer.h
+//  libraries/shared/src
+//
+//  Created by Sam Gateau on 10/15/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_TripleBuffer_h
+#define hifi_TripleBuffer_h
+
+#include <atomic>
+#include <stdint.h>
+
+// Lock free hand-off of the latest value of a type from one writer thread to one reader thread.
+// The writer fills getWriteBuffer() and publish()es it, the reader consume()s the latest published value and reads it
+// with getReadBuffer(). Neither ever waits for the other, and the values published between two consume() are dropped.
+//
+// For example: This is used to hand the avatar data decoded on the network thread to the main thread.
+
+template <typename T>
+class TripleBuffer {
+public:
+    // the buffer the writer fills, which holds whatever was in it from before
+    T& getWriteBuffer() { return _buffers[_writeIndex]; }
+
+    // hands the write buffer over to the reader, and takes back the buffer it isn't using
+    void publish() {
+        uint8_t previous = _shared.exchange(_writeIndex | FRESH_BIT, std::memory_order_acq_rel);
+        _writeIndex = previous & INDEX_MASK;
+    }
+
+    // takes the latest published buffer, returns false if nothing was published since the last consume()
+    bool consume() {
+        if (!(_shared.load(std::memory_order_relaxed) & FRESH_BIT)) {
+            return false;
+        }
+        uint8_t previous = _shared.exchange(_readIndex, std::memory_order_acq_rel);
+        _readIndex = previous & INDEX_MASK;
+        return true;
+    }
+
+    // the buffer taken by the last consume()
+    const T& getReadBuffer() const { return _buffers[_readIndex]; }
+
+private:
+    static const uint8_t INDEX_MASK = 0x3;
+    static const uint8_t FRESH_BIT = 0x4;
+
+    T _buffers[3];
+    uint8_t _writeIndex { 0 };
+    std::atomic<uint8_t> _shared { 1 };
+    uint8_t _readIndex { 2 };
+};
+
+#endif // hifi_TripleBuffer_h
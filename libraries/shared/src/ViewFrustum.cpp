@@ -17,6 +17,10 @@
 #include <glm/gtx/vector_angle.hpp>
 #include <QtCore/QDebug>
 
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#include <xmmintrin.h>
+#define VIEW_FRUSTUM_SSE
+#endif
 
 #include "GeometryUtil.h"
 #include "GLMHelpers.h"
@@ -211,6 +215,46 @@ bool ViewFrustum::boxIntersectsFrustum(const AABox& box) const {
     return true;
 }
 
+void ViewFrustum::boxesIntersectFrustum(const AABox* boxes, size_t numBoxes, bool* results) const {
+    size_t i = 0;
+#ifdef VIEW_FRUSTUM_SSE
+    // four boxes at a time, with one register per axis of their corners and scales
+    const __m128 zero = _mm_setzero_ps();
+    for (; i + 4 <= numBoxes; i += 4) {
+        const AABox* box = boxes + i;
+        __m128 cornerX = _mm_setr_ps(box[0].getCorner().x, box[1].getCorner().x, box[2].getCorner().x, box[3].getCorner().x);
+        __m128 cornerY = _mm_setr_ps(box[0].getCorner().y, box[1].getCorner().y, box[2].getCorner().y, box[3].getCorner().y);
+        __m128 cornerZ = _mm_setr_ps(box[0].getCorner().z, box[1].getCorner().z, box[2].getCorner().z, box[3].getCorner().z);
+        __m128 scaleX = _mm_setr_ps(box[0].getScale().x, box[1].getScale().x, box[2].getScale().x, box[3].getScale().x);
+        __m128 scaleY = _mm_setr_ps(box[0].getScale().y, box[1].getScale().y, box[2].getScale().y, box[3].getScale().y);
+        __m128 scaleZ = _mm_setr_ps(box[0].getScale().z, box[1].getScale().z, box[2].getScale().z, box[3].getScale().z);
+
+        __m128 outside = zero;
+        for (int p = 0; p < NUM_FRUSTUM_PLANES; p++) {
+            const glm::vec3& normal = _planes[p].getNormal();
+            // the farthest box vertex along the normal, as in AABox::getFarthestVertex()
+            __m128 vertexX = (normal.x > 0.0f) ? _mm_add_ps(cornerX, scaleX) : cornerX;
+            __m128 vertexY = (normal.y > 0.0f) ? _mm_add_ps(cornerY, scaleY) : cornerY;
+            __m128 vertexZ = (normal.z > 0.0f) ? _mm_add_ps(cornerZ, scaleZ) : cornerZ;
+            __m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(normal.x), vertexX),
+                                               _mm_mul_ps(_mm_set1_ps(normal.y), vertexY)),
+                                    _mm_mul_ps(_mm_set1_ps(normal.z), vertexZ));
+            __m128 distance = _mm_add_ps(_mm_set1_ps(_planes[p].getDCoefficient()), dot);
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(distance, zero));
+        }
+
+        int outsideMask = _mm_movemask_ps(outside);
+        results[i] = !(outsideMask & 0x1);
+        results[i + 1] = !(outsideMask & 0x2);
+        results[i + 2] = !(outsideMask & 0x4);
+        results[i + 3] = !(outsideMask & 0x8);
+    }
+#endif
+    for (; i < numBoxes; i++) {
+        results[i] = boxIntersectsFrustum(boxes[i]);
+    }
+}
+
 bool ViewFrustum::sphereIntersectsKeyhole(const glm::vec3& center, float radius) const {
     // check positive touch against central sphere
     if (glm::length(center - _position) <= (radius + _centerSphereRadius)) {
@@ -102,6 +102,8 @@ public:
     bool sphereIntersectsFrustum(const glm::vec3& center, float radius) const;
     bool cubeIntersectsFrustum(const AACube& box) const;
     bool boxIntersectsFrustum(const AABox& box) const;
+    // sets results[i] to boxIntersectsFrustum(boxes[i]), testing the boxes four at a time where SSE is available
+    void boxesIntersectFrustum(const AABox* boxes, size_t numBoxes, bool* results) const;
 
     bool sphereIntersectsKeyhole(const glm::vec3& center, float radius) const;
     bool cubeIntersectsKeyhole(const AACube& cube) const;
@@ -9,8 +9,11 @@
 #ifndef hifi_gl_NsightHelpers_h
 #define hifi_gl_NsightHelpers_h
 
+#include "../Trace.h"
+
 bool nsightActive();
 
+// The ranges are also spans of the trace while the Tracer records
 #if defined(_WIN32) && defined(NSIGHT_FOUND)
 #include <stdint.h>
 
@@ -23,11 +26,11 @@ private:
     uint64_t _rangeId{ 0 };
 };
 
-#define PROFILE_RANGE(name) ProfileRange profileRangeThis(name);
-#define PROFILE_RANGE_EX(name, argbColor, payload) ProfileRange profileRangeThis(name, argbColor, (uint64_t)payload);
+#define PROFILE_RANGE(name) ProfileRange profileRangeThis(name); TRACE_SPAN(name)
+#define PROFILE_RANGE_EX(name, argbColor, payload) ProfileRange profileRangeThis(name, argbColor, (uint64_t)payload); TRACE_SPAN(name)
 #else
-#define PROFILE_RANGE(name)
-#define PROFILE_RANGE_EX(name, argbColor, payload)
+#define PROFILE_RANGE(name) TRACE_SPAN(name)
+#define PROFILE_RANGE_EX(name, argbColor, payload) TRACE_SPAN(name)
 #endif
 
 #endif
@@ -65,6 +65,26 @@ public:
         AudioDecoder::process((const int16_t*)encodedBuffer.constData(), (int16_t*)decodedBuffer.data(), AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL, true);
     }
 
+    virtual int decodeInPlace(const QByteArray& encodedBuffer, int16_t* decodedSamples, int maxSamples) override {
+        int numSamples = _decodedSize / (int)sizeof(int16_t);
+        if (maxSamples < numSamples) {
+            return Decoder::decodeInPlace(encodedBuffer, decodedSamples, maxSamples);
+        }
+        AudioDecoder::process((const int16_t*)encodedBuffer.constData(), decodedSamples, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL, true);
+        return numSamples;
+    }
+
+    virtual int concealLostFrame(int16_t* decodedSamples, int maxSamples) override {
+        int numSamples = _decodedSize / (int)sizeof(int16_t);
+        if (maxSamples < numSamples) {
+            return 0;
+        }
+        // decoding without a packet has the codec extrapolate the lost frame from the previous ones
+        QByteArray encodedBuffer;
+        AudioDecoder::process((const int16_t*)encodedBuffer.constData(), decodedSamples, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL, false);
+        return numSamples;
+    }
+
     virtual void trackLostFrames(int numFrames)  override { 
         QByteArray encodedBuffer;
         QByteArray decodedBuffer;
@@ -35,12 +35,19 @@ public:
     virtual void releaseEncoder(Encoder* encoder) override;
     virtual void releaseDecoder(Decoder* decoder) override;
 
+    virtual bool isStateless() const override { return true; }
+
     virtual void encode(const QByteArray& decodedBuffer, QByteArray& encodedBuffer) override {
         encodedBuffer = decodedBuffer;
     }
     virtual void decode(const QByteArray& encodedBuffer, QByteArray& decodedBuffer) override {
         decodedBuffer = encodedBuffer;
     }
+    virtual int decodeInPlace(const QByteArray& encodedBuffer, int16_t* decodedSamples, int maxSamples) override {
+        int numSamples = std::min(encodedBuffer.size() / (int)sizeof(int16_t), maxSamples);
+        memcpy(decodedSamples, encodedBuffer.constData(), numSamples * sizeof(int16_t));
+        return numSamples;
+    }
 
     virtual void trackLostFrames(int numFrames)  override { }
 
@@ -69,6 +76,8 @@ public:
     virtual void releaseEncoder(Encoder* encoder) override;
     virtual void releaseDecoder(Decoder* decoder) override;
 
+    virtual bool isStateless() const override { return true; }
+
     virtual void encode(const QByteArray& decodedBuffer, QByteArray& encodedBuffer) override {
         encodedBuffer = qCompress(decodedBuffer);
     }
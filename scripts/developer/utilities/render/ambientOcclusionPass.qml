@@ -28,6 +28,8 @@ Column {
                     "Falloff Bias:falloffBias:0.2:false",
                     "Edge Sharpness:edgeSharpness:1.0:false",
                     "Blur Radius:blurRadius:10.0:false",
+                    "Resolution Level:resolutionLevel:2:true",
+                    "Temporal Frames:temporalFrameCount:8:true",
                 ]
                 ConfigSlider {
                     label: qsTr(modelData.split(":")[0])
@@ -43,10 +45,11 @@ Column {
             Column {
                 Repeater {
                     model: [
-                        "resolutionLevel:resolutionLevel",
                         "ditheringEnabled:ditheringEnabled",
                         "fetchMipsEnabled:fetchMipsEnabled",
-                        "borderingEnabled:borderingEnabled"
+                        "borderingEnabled:borderingEnabled",
+                        "upsamplingEnabled:upsamplingEnabled",
+                        "temporalEnabled:temporalEnabled"
                     ]
                     CheckBox {
                         text: qsTr(modelData.split(":")[0])
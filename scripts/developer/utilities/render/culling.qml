@@ -49,6 +49,11 @@ Column {
                         Render.getConfig("CullSceneSelection").freezeFrustum = checked;
                     }
                 }
+                CheckBox {
+                    text: "Occlusion Culling"
+                    checked: Render.getConfig("OcclusionCullOpaque").occlusionCulling
+                    onCheckedChanged: { Render.getConfig("OcclusionCullOpaque").occlusionCulling = checked }
+                }
                 Label {
                     text: "Octree"
                 }
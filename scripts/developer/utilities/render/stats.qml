@@ -173,6 +173,16 @@ Item {
                     prop: "frameSetPipelineCount",
                     label: "Pipelines",
                     color: "#E2334D"
+                },
+                {
+                    prop: "frameSetUniformBufferCount",
+                    label: "Uniform Buffers",
+                    color: "#1AC567"
+                },
+                {
+                    prop: "frameSetInputFormatCount",
+                    label: "Input Formats",
+                    color: "#FED959"
                 }
             ]
         }  
@@ -0,0 +1,207 @@
+//
+//  AudioHRTFBenchmarks.cpp
+//  tests/audio/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioHRTFBenchmarks.h"
+
+#include <cmath>
+
+#include <CPUDetect.h>
+#include <NumericalConstants.h>
+
+#include "AudioHRTF.h"
+
+QTEST_MAIN(AudioHRTFBenchmarks)
+
+static const int NUM_SOURCES = 64;
+static const int NUM_FRAMES = 100;
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+void FIR_1x4_SSE(float* src, float* dst0, float* dst1, float* dst2, float* dst3, float coef[4][HRTF_TAPS], int numFrames);
+void FIR_1x4_AVX(float* src, float* dst0, float* dst1, float* dst2, float* dst3, float coef[4][HRTF_TAPS], int numFrames);
+void FIR_1x4_AVX2(float* src, float* dst0, float* dst1, float* dst2, float* dst3, float coef[4][HRTF_TAPS], int numFrames);
+#endif
+
+static const char* detectedISA() {
+    if (cpuSupportsAVX2()) {
+        return "AVX2";
+    } else if (cpuSupportsAVX()) {
+        return "AVX";
+    } else if (cpuSupportsSSE3()) {
+        return "SSE3";
+    } else if (cpuSupportsNEON()) {
+        return "NEON";
+    }
+    return "portable";
+}
+
+static void fillInput(int16_t* input, int numSamples) {
+    for (int i = 0; i < numSamples; i++) {
+        input[i] = (int16_t)(16384.0f * sinf(i * 0.05f));
+    }
+}
+
+static void report(const char* name, qint64 nsecs, int numSourceFrames) {
+    qDebug("%-24s %8.1f ns per source-frame (%s)", name, (double)nsecs / numSourceFrames, detectedISA());
+}
+
+void AudioHRTFBenchmarks::render() {
+    static AudioHRTF hrtf[NUM_SOURCES];
+    int16_t input[HRTF_BLOCK];
+    float output[2 * HRTF_BLOCK] = {};
+
+    fillInput(input, HRTF_BLOCK);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for (int frame = 0; frame < NUM_FRAMES; frame++) {
+        for (int i = 0; i < NUM_SOURCES; i++) {
+            float azimuth = (float)(i + frame) / NUM_SOURCES * TWO_PI;
+            hrtf[i].render(input, output, 0, azimuth, 1.0f + i, 0.5f, HRTF_BLOCK);
+        }
+    }
+
+    report("AudioHRTF::render", timer.nsecsElapsed(), NUM_SOURCES * NUM_FRAMES);
+
+    for (int i = 0; i < 2 * HRTF_BLOCK; i++) {
+        QVERIFY(std::isfinite(output[i]));
+    }
+}
+
+void AudioHRTFBenchmarks::renderBatch() {
+    static AudioHRTF hrtf[NUM_SOURCES];
+    static AudioHRTF reference[NUM_SOURCES];
+    int16_t input[HRTF_BLOCK];
+    float output[2 * HRTF_BLOCK] = {};
+    float expected[2 * HRTF_BLOCK] = {};
+
+    fillInput(input, HRTF_BLOCK);
+
+    AudioHRTF::Source sources[NUM_SOURCES];
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for (int frame = 0; frame < NUM_FRAMES; frame++) {
+        for (int i = 0; i < NUM_SOURCES; i++) {
+            float azimuth = (float)(i + frame) / NUM_SOURCES * TWO_PI;
+            sources[i] = { &hrtf[i], input, azimuth, 1.0f + i, 0.5f };
+        }
+        AudioHRTF::renderBatch(sources, NUM_SOURCES, output, 0, HRTF_BLOCK);
+    }
+
+    report("AudioHRTF::renderBatch", timer.nsecsElapsed(), NUM_SOURCES * NUM_FRAMES);
+
+    // the batch must match rendering the same sources one at a time
+    for (int frame = 0; frame < NUM_FRAMES; frame++) {
+        for (int i = 0; i < NUM_SOURCES; i++) {
+            float azimuth = (float)(i + frame) / NUM_SOURCES * TWO_PI;
+            reference[i].render(input, expected, 0, azimuth, 1.0f + i, 0.5f, HRTF_BLOCK);
+        }
+    }
+    for (int i = 0; i < 2 * HRTF_BLOCK; i++) {
+        QVERIFY(fabsf(output[i] - expected[i]) < 1.0e-3f);
+    }
+}
+
+void AudioHRTFBenchmarks::directMix() {
+    static AudioHRTF hrtf[NUM_SOURCES];
+    int16_t input[2 * HRTF_BLOCK];
+    float output[2 * HRTF_BLOCK] = {};
+
+    fillInput(input, 2 * HRTF_BLOCK);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for (int frame = 0; frame < NUM_FRAMES; frame++) {
+        for (int i = 0; i < NUM_SOURCES; i++) {
+            hrtf[i].mixMono(input, output, 0.5f, HRTF_BLOCK);
+        }
+    }
+
+    report("AudioHRTF::mixMono", timer.nsecsElapsed(), NUM_SOURCES * NUM_FRAMES);
+
+    timer.restart();
+
+    for (int frame = 0; frame < NUM_FRAMES; frame++) {
+        for (int i = 0; i < NUM_SOURCES; i++) {
+            hrtf[i].mixStereo(input, output, 0.5f, HRTF_BLOCK);
+        }
+    }
+
+    report("AudioHRTF::mixStereo", timer.nsecsElapsed(), NUM_SOURCES * NUM_FRAMES);
+
+    // once the gain has settled, a single mono mix is the input scaled by the gain on both channels
+    float mono[2 * HRTF_BLOCK] = {};
+    hrtf[0].mixMono(input, mono, 0.5f, HRTF_BLOCK);
+    for (int i = 0; i < HRTF_BLOCK; i++) {
+        float expected = input[i] * 0.5f / 32768.0f;
+        QVERIFY(fabsf(mono[2 * i + 0] - expected) < 1.0e-6f);
+        QVERIFY(fabsf(mono[2 * i + 1] - expected) < 1.0e-6f);
+    }
+}
+
+void AudioHRTFBenchmarks::firKernels() {
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+    static float src[HRTF_TAPS + HRTF_BLOCK];
+    static float dst[4][HRTF_BLOCK];
+    static float reference[4][HRTF_BLOCK];
+    static float coef[4][HRTF_TAPS];
+
+    for (int i = 0; i < HRTF_TAPS + HRTF_BLOCK; i++) {
+        src[i] = sinf(i * 0.05f);
+    }
+    for (int k = 0; k < HRTF_TAPS; k++) {
+        for (int j = 0; j < 4; j++) {
+            coef[j][k] = 1.0f / (1 + k + j);
+        }
+    }
+
+    using FIR = void (*)(float*, float*, float*, float*, float*, float[4][HRTF_TAPS], int);
+    struct Kernel {
+        const char* name;
+        FIR fir;
+        bool supported;
+    };
+    const Kernel kernels[] = {
+        { "FIR_1x4_SSE", FIR_1x4_SSE, true },
+        { "FIR_1x4_AVX", FIR_1x4_AVX, cpuSupportsAVX() },
+        { "FIR_1x4_AVX2", FIR_1x4_AVX2, cpuSupportsAVX2() },
+    };
+
+    FIR_1x4_SSE(&src[HRTF_TAPS], reference[0], reference[1], reference[2], reference[3], coef, HRTF_BLOCK);
+
+    for (auto& kernel : kernels) {
+        if (!kernel.supported) {
+            qDebug("%-24s not supported on this CPU", kernel.name);
+            continue;
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+
+        for (int i = 0; i < NUM_SOURCES * NUM_FRAMES; i++) {
+            (*kernel.fir)(&src[HRTF_TAPS], dst[0], dst[1], dst[2], dst[3], coef, HRTF_BLOCK);
+        }
+
+        report(kernel.name, timer.nsecsElapsed(), NUM_SOURCES * NUM_FRAMES);
+
+        // every kernel must agree with the SSE kernel, up to rounding
+        for (int j = 0; j < 4; j++) {
+            for (int i = 0; i < HRTF_BLOCK; i++) {
+                QVERIFY(fabsf(dst[j][i] - reference[j][i]) < 1.0e-4f);
+            }
+        }
+    }
+#else
+    qDebug("FIR kernels are selected at compile time on this architecture (%s)", detectedISA());
+#endif
+}
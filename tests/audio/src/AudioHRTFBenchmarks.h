@@ -0,0 +1,26 @@
+//
+//  AudioHRTFBenchmarks.h
+//  tests/audio/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioHRTFBenchmarks_h
+#define hifi_AudioHRTFBenchmarks_h
+
+#include <QtTest/QtTest>
+
+// times the HRTF render and direct mix paths, reported in ns per source-frame
+class AudioHRTFBenchmarks : public QObject {
+    Q_OBJECT
+private slots:
+    void render();
+    void renderBatch();
+    void directMix();
+    void firKernels();
+};
+
+#endif // hifi_AudioHRTFBenchmarks_h
@@ -11,6 +11,8 @@
 
 #include "AudioRingBufferTests.h"
 
+#include <algorithm>
+
 #include "SharedUtil.h"
 
 // Adds an implicit cast to make sure that actual and expected are of the same type.
@@ -125,3 +127,80 @@ void AudioRingBufferTests::runAllTests() {
         assertBufferSize(ringBuffer, 0);
     }
 }
+
+void AudioRingBufferTests::zeroCopyWrites() {
+    const int FRAME_SAMPLES = 10;
+    AudioRingBuffer ringBuffer(FRAME_SAMPLES, 4); // 4 frames of capacity, plus one always free
+
+    int16_t readData[FRAME_SAMPLES];
+
+    for (int frame = 0; frame < 20; frame++) {
+        // whole frames written in place never wrap, since the buffer is a whole number of frames
+        int16_t* slot = ringBuffer.beginWrite(FRAME_SAMPLES);
+        QVERIFY(slot != nullptr);
+        for (int i = 0; i < FRAME_SAMPLES; i++) {
+            slot[i] = frame * FRAME_SAMPLES + i;
+        }
+        QCOMPARE(ringBuffer.commitWrite(FRAME_SAMPLES), FRAME_SAMPLES);
+
+        // the buffer fills up to its capacity, then overwrites the oldest frame
+        assertBufferSize(ringBuffer, std::min(frame + 1, 4) * FRAME_SAMPLES);
+
+        // the newest frame can be read in place
+        const int16_t* frameSamples = ringBuffer.lastFrameWritten().contiguousSamples(FRAME_SAMPLES);
+        QVERIFY(frameSamples != nullptr);
+        QCOMPARE(frameSamples[0], (int16_t)(frame * FRAME_SAMPLES));
+    }
+
+    // the oldest frames were dropped
+    QCOMPARE(ringBuffer.getOverflowCount(), 16);
+    ringBuffer.readSamples(readData, FRAME_SAMPLES);
+    QCOMPARE(readData[0], (int16_t)(16 * FRAME_SAMPLES));
+
+    // a write that would wrap around the end of the buffer has no slot
+    AudioRingBuffer wrapBuffer(FRAME_SAMPLES, 4);
+    int16_t wrapData[4 * FRAME_SAMPLES] = {};
+    wrapBuffer.writeSamples(wrapData, 4 * FRAME_SAMPLES);
+    wrapBuffer.readSamples(wrapData, 4 * FRAME_SAMPLES);
+    wrapBuffer.writeSamples(wrapData, FRAME_SAMPLES / 2);
+    QVERIFY(wrapBuffer.beginWrite(FRAME_SAMPLES) == nullptr);
+}
+
+void AudioRingBufferTests::spans() {
+    const int FRAME_SAMPLES = 10;
+    AudioRingBuffer ringBuffer(FRAME_SAMPLES, 4); // 50 samples long
+
+    int16_t writeData[3 * FRAME_SAMPLES];
+    for (int i = 0; i < 3 * FRAME_SAMPLES; i++) {
+        writeData[i] = i;
+    }
+    int16_t readData[3 * FRAME_SAMPLES];
+
+    // samples that do not wrap are all in the head
+    ringBuffer.writeSamples(writeData, 3 * FRAME_SAMPLES);
+    AudioRingBuffer::ConstIterator::Span head, tail;
+    ringBuffer.nextOutput().getSpans(3 * FRAME_SAMPLES, head, tail);
+    QCOMPARE(head.numSamples, 3 * FRAME_SAMPLES);
+    QCOMPARE(tail.numSamples, 0);
+    QCOMPARE(head.samples[0], (int16_t)0);
+
+    // samples that wrap are split at the end of the buffer
+    ringBuffer.readSamples(readData, 3 * FRAME_SAMPLES);
+    ringBuffer.writeSamples(writeData, 3 * FRAME_SAMPLES);
+    ringBuffer.nextOutput().getSpans(3 * FRAME_SAMPLES, head, tail);
+    QCOMPARE(head.numSamples, 2 * FRAME_SAMPLES);
+    QCOMPARE(tail.numSamples, FRAME_SAMPLES);
+    QCOMPARE(head.samples[0], (int16_t)0);
+    QCOMPARE(tail.samples[0], (int16_t)(2 * FRAME_SAMPLES));
+
+    // and read back in order
+    QCOMPARE(ringBuffer.readSamples(readData, 3 * FRAME_SAMPLES), 3 * FRAME_SAMPLES);
+    for (int i = 0; i < 3 * FRAME_SAMPLES; i++) {
+        QCOMPARE(readData[i], (int16_t)i);
+    }
+
+    // shifts in both directions wrap without leaving the buffer
+    AudioRingBuffer::ConstIterator at = ringBuffer.nextOutput();
+    QCOMPARE(at[-1], (int16_t)(3 * FRAME_SAMPLES - 1));
+    QCOMPARE((at - 3 * FRAME_SAMPLES)[0], (int16_t)0);
+}
@@ -21,6 +21,8 @@ class AudioRingBufferTests : public QObject {
     Q_OBJECT
 private slots:
     void runAllTests();
+    void zeroCopyWrites();
+    void spans();
 private:
     void assertBufferSize(const AudioRingBuffer& buffer, int samples);
 };
@@ -0,0 +1,235 @@
+//
+//  NetworkingBenchmarks.cpp
+//  tests/networking/src
+//
+//  Created by Sam Gateau on 10/15/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "NetworkingBenchmarks.h"
+
+#include <NLPacket.h>
+#include <NumericalConstants.h>
+#include <SequenceNumberStats.h>
+#include <udt/BBRCC.h>
+#include <udt/CongestionControl.h>
+#include <udt/LossList.h>
+#include <udt/PacketList.h>
+#include <udt/Socket.h>
+#include <udt/TCPVegasCC.h>
+
+QTEST_MAIN(NetworkingBenchmarks)
+
+static const int NUM_PACKETS = 100000;
+static const int NUM_MESSAGES = 1000;
+static const int MESSAGE_SIZE = 64 * 1024;
+static const int NUM_LOSS_LIST_RANGES = 1000;
+static const int NUM_LOOPBACK_PACKETS = 20000;
+static const int LOOPBACK_TIMEOUT_MSECS = 30000;
+
+static void report(const char* name, qint64 nsecs, int numOperations) {
+    qDebug("%-36s %10.1f ns per op", name, (double)nsecs / numOperations);
+}
+
+// exposes the packets of a written list, as the send queue takes them
+class BenchmarkPacketList : public udt::PacketList {
+public:
+    BenchmarkPacketList() : udt::PacketList(PacketType::Unknown, QByteArray(), true, true) { open(WriteOnly); }
+
+    std::list<std::unique_ptr<udt::Packet>> takePackets() {
+        closeCurrentPacket();
+        return std::move(_packets);
+    }
+};
+
+static std::list<std::unique_ptr<udt::Packet>> writeMessage(const QByteArray& message) {
+    BenchmarkPacketList packetList;
+    packetList.write(message);
+    return packetList.takePackets();
+}
+
+void NetworkingBenchmarks::packetCreate() {
+    QByteArray payload(512, 'x');
+    size_t totalSize = 0;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for (int i = 0; i < NUM_PACKETS; i++) {
+        auto packet = NLPacket::create(PacketType::MixedAudio);
+        packet->write(payload);
+        totalSize += packet->getDataSize();
+    }
+
+    report("NLPacket::create + write", timer.nsecsElapsed(), NUM_PACKETS);
+    QVERIFY(totalSize > (size_t)NUM_PACKETS * payload.size());
+}
+
+void NetworkingBenchmarks::packetFromReceived() {
+    auto packet = NLPacket::create(PacketType::MixedAudio);
+    packet->write(QByteArray(512, 'x'));
+    auto size = packet->getDataSize();
+    int numRead = 0;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for (int i = 0; i < NUM_PACKETS; i++) {
+        auto data = std::unique_ptr<char[]>(new char[size]);
+        memcpy(data.get(), packet->getData(), size);
+        auto received = NLPacket::fromReceivedPacket(std::move(data), size, HifiSockAddr());
+        if (received->getType() == PacketType::MixedAudio) {
+            ++numRead;
+        }
+    }
+
+    report("NLPacket::fromReceivedPacket", timer.nsecsElapsed(), NUM_PACKETS);
+    QCOMPARE(numRead, NUM_PACKETS);
+}
+
+void NetworkingBenchmarks::packetListSegmentation() {
+    QByteArray message(MESSAGE_SIZE, 'x');
+    size_t numPackets = 0;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for (int i = 0; i < NUM_MESSAGES; i++) {
+        numPackets += writeMessage(message).size();
+    }
+
+    report("PacketList write 64KB", timer.nsecsElapsed(), NUM_MESSAGES);
+    QVERIFY(numPackets >= (size_t)NUM_MESSAGES * (MESSAGE_SIZE / udt::MAX_PACKET_SIZE));
+}
+
+void NetworkingBenchmarks::packetListReassembly() {
+    QByteArray message(MESSAGE_SIZE, 'x');
+    std::vector<std::list<std::unique_ptr<udt::Packet>>> messages;
+    for (int i = 0; i < NUM_MESSAGES; i++) {
+        messages.push_back(writeMessage(message));
+    }
+
+    QByteArray lastMessage;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for (auto& packets : messages) {
+        auto packetList = udt::PacketList::fromReceivedPackets(std::move(packets));
+        lastMessage = packetList->getMessage();
+    }
+
+    report("PacketList reassemble 64KB", timer.nsecsElapsed(), NUM_MESSAGES);
+    QCOMPARE(lastMessage, message);
+}
+
+void NetworkingBenchmarks::lossList() {
+    udt::LossList lossList;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // every other packet lost, as ranges of one
+    for (int i = 0; i < NUM_LOSS_LIST_RANGES; i++) {
+        lossList.append(udt::SequenceNumber(2 * i));
+    }
+    // the retransmissions come back in order
+    for (int i = 0; i < NUM_LOSS_LIST_RANGES; i++) {
+        lossList.remove(udt::SequenceNumber(2 * i));
+    }
+
+    report("LossList append + remove", timer.nsecsElapsed(), 2 * NUM_LOSS_LIST_RANGES);
+    QVERIFY(lossList.isEmpty());
+
+    timer.restart();
+
+    for (int i = 0; i < NUM_LOSS_LIST_RANGES; i++) {
+        lossList.append(udt::SequenceNumber(10 * i), udt::SequenceNumber(10 * i + 4));
+    }
+    int numPopped = 0;
+    while (!lossList.isEmpty()) {
+        lossList.popFirstSequenceNumber();
+        ++numPopped;
+    }
+
+    report("LossList append range + pop", timer.nsecsElapsed(), NUM_LOSS_LIST_RANGES + numPopped);
+    QCOMPARE(numPopped, 5 * NUM_LOSS_LIST_RANGES);
+}
+
+void NetworkingBenchmarks::sequenceNumberStats() {
+    SequenceNumberStats stats;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // in order, with one packet in 100 late and one in 1000 lost
+    quint16 sequence = 0;
+    for (int i = 0; i < NUM_PACKETS; i++) {
+        if (i % 1000 == 999) {
+            ++sequence;
+        }
+        if (i % 100 == 50) {
+            stats.sequenceNumberReceived(sequence + 1);
+            stats.sequenceNumberReceived(sequence);
+            sequence += 2;
+            ++i;
+        } else {
+            stats.sequenceNumberReceived(sequence++);
+        }
+    }
+
+    report("SequenceNumberStats::received", timer.nsecsElapsed(), NUM_PACKETS);
+    QVERIFY(stats.getLost() > 0);
+}
+
+void NetworkingBenchmarks::socketLoopback() {
+    struct Controller {
+        const char* name;
+        std::function<std::unique_ptr<udt::CongestionControlVirtualFactory>()> factory;
+    };
+    const Controller controllers[] = {
+        { "DefaultCC", [] { return std::unique_ptr<udt::CongestionControlVirtualFactory>(new udt::CongestionControlFactory<udt::DefaultCC>()); } },
+        { "TCPVegasCC", [] { return std::unique_ptr<udt::CongestionControlVirtualFactory>(new udt::CongestionControlFactory<udt::TCPVegasCC>()); } },
+        { "BBRCC", [] { return std::unique_ptr<udt::CongestionControlVirtualFactory>(new udt::CongestionControlFactory<udt::BBRCC>()); } },
+    };
+
+    for (auto& controller : controllers) {
+        udt::Socket sender(nullptr, false);
+        udt::Socket receiver(nullptr, false);
+        sender.setCongestionControlFactory(controller.factory());
+        receiver.setCongestionControlFactory(controller.factory());
+        sender.bind(QHostAddress::LocalHost);
+        receiver.bind(QHostAddress::LocalHost);
+
+        int numReceived = 0;
+        receiver.setPacketHandler([&](std::unique_ptr<udt::Packet> packet) {
+            ++numReceived;
+        });
+
+        HifiSockAddr receiverSockAddr(QHostAddress::LocalHost, receiver.localPort());
+        qint64 payloadSize = 0;
+
+        QElapsedTimer timer;
+        timer.start();
+
+        for (int i = 0; i < NUM_LOOPBACK_PACKETS; i++) {
+            auto packet = udt::Packet::create(-1, true);
+            packet->setPayloadSize(packet->getPayloadCapacity());
+            payloadSize = packet->getPayloadSize();
+            sender.writePacket(std::move(packet), receiverSockAddr);
+        }
+
+        // the acks and the packets are both read on this thread
+        while (numReceived < NUM_LOOPBACK_PACKETS && timer.elapsed() < LOOPBACK_TIMEOUT_MSECS) {
+            QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+        }
+
+        double seconds = (double)timer.nsecsElapsed() / (double)(NSECS_PER_USEC * USECS_PER_SECOND);
+        qDebug("%-36s %10.1f MB/s, %d of %d packets", qPrintable(QString("udt::Socket loopback %1").arg(controller.name)),
+            (double)(numReceived * payloadSize) / (seconds * 1024.0 * 1024.0), numReceived, NUM_LOOPBACK_PACKETS);
+        QCOMPARE(numReceived, NUM_LOOPBACK_PACKETS);
+    }
+}
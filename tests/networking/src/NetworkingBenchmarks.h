@@ -0,0 +1,31 @@
+//
+//  NetworkingBenchmarks.h
+//  tests/networking/src
+//
+//  Created by Sam Gateau on 10/15/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_NetworkingBenchmarks_h
+#define hifi_NetworkingBenchmarks_h
+
+#include <QtTest/QtTest>
+
+// times the packet, packet list, loss list and sequence number paths, reported in ns per operation,
+// and the reliable loopback throughput of a udt::Socket under each congestion control
+class NetworkingBenchmarks : public QObject {
+    Q_OBJECT
+private slots:
+    void packetCreate();
+    void packetFromReceived();
+    void packetListSegmentation();
+    void packetListReassembly();
+    void lossList();
+    void sequenceNumberStats();
+    void socketLoopback();
+};
+
+#endif // hifi_NetworkingBenchmarks_h
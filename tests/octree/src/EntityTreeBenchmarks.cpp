@@ -0,0 +1,434 @@
+//
+//  EntityTreeBenchmarks.cpp
+//  tests/octree/src
+//
+//  Created by Sam Gateau on 10/15/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityTreeBenchmarks.h"
+
+#include <random>
+
+#include <QtCore/QJsonDocument>
+#include <QtCore/QTemporaryDir>
+
+#include <AccountManager.h>
+#include <AddressManager.h>
+#include <DependencyManager.h>
+#include <EntityItemProperties.h>
+#include <GLMHelpers.h>
+#include <MovingEntitiesOperator.h>
+#include <NodeList.h>
+#include <OctreePacketData.h>
+#include <ViewFrustum.h>
+#include <udt/PacketHeaders.h>
+
+QTEST_MAIN(EntityTreeBenchmarks)
+
+static const QList<int> DEFAULT_SIZES { 10000, 100000 };
+static const QString DEFAULT_OUTPUT = "entity-tree-benchmarks.json";
+
+// the entities are spread over the middle of the domain, as a large scene would be
+static const float SCENE_HALF_SIZE = 1000.0f;
+static const float MIN_DIMENSION = 0.1f;
+static const float MAX_DIMENSION = 5.0f;
+static const float MAX_QUERY_RADIUS = 50.0f;
+static const int NUM_QUERIES = 1000;
+static const int NUM_RAYS = 1000;
+// the share of the entities that move between two re-sorts
+static const int MOVING_ENTITIES_DIVISOR = 100;
+static const float MAX_MOVE = 10.0f;
+static const quint32 SEED = 1;
+
+struct ClientView {
+    const char* name;
+    glm::vec3 position;
+    glm::vec3 target;
+};
+
+static const ClientView CLIENT_VIEWS[] = {
+    { "overview", glm::vec3(0.0f, 500.0f, 1500.0f), glm::vec3(0.0f) },
+    { "ground", glm::vec3(0.0f, 2.0f, 0.0f), glm::vec3(0.0f, 2.0f, -100.0f) },
+    { "corner", glm::vec3(900.0f, 10.0f, 900.0f), glm::vec3(0.0f) },
+};
+
+static glm::vec3 randomPosition(std::mt19937& random, float halfSize) {
+    std::uniform_real_distribution<float> distribution(-halfSize, halfSize);
+    return glm::vec3(distribution(random), distribution(random), distribution(random));
+}
+
+static int countEntities(EntityTreePointer tree) {
+    QVector<EntityItemPointer> entities;
+    tree->withReadLock([&] {
+        tree->findEntities(AACube(glm::vec3(-HALF_TREE_SCALE), TREE_SCALE), entities);
+    });
+    return entities.size();
+}
+
+static EntityTreePointer createServerTree() {
+    auto tree = std::make_shared<EntityTree>();
+    tree->createRootElement();
+    tree->setIsServer(true);
+    return tree;
+}
+
+static ViewFrustum createViewFrustum(const ClientView& view) {
+    ViewFrustum frustum;
+    frustum.setProjection(glm::perspective(glm::radians(DEFAULT_FIELD_OF_VIEW_DEGREES), DEFAULT_ASPECT_RATIO,
+                                           DEFAULT_NEAR_CLIP, DEFAULT_FAR_CLIP));
+    frustum.setPosition(view.position);
+    frustum.setOrientation(rotationBetween(Vectors::FRONT, glm::normalize(view.target - view.position)));
+    frustum.calculate();
+    return frustum;
+}
+
+// encodes all of what the client sees into compressed packets, the way the OctreeSendThread does for a full scene
+static bool encodeView(EntityTreePointer tree, const ViewFrustum& frustum, std::vector<QByteArray>& packets) {
+    OctreeElementBag bag;
+    OctreeElementExtraEncodeData extraEncodeData;
+    OctreePacketData packetData(true);
+    bag.insert(tree->getRoot());
+
+    bool success = true;
+    while (OctreeElementPointer subTree = bag.extract()) {
+        EncodeBitstreamParams params(INT_MAX, WANT_EXISTS_BITS, DONT_CHOP, false, NO_BOUNDARY_ADJUST,
+                                     DEFAULT_OCTREE_SIZE_SCALE, IGNORE_LAST_SENT, true, IGNORE_SCENE_STATS,
+                                     IGNORE_JURISDICTION_MAP, &extraEncodeData);
+        params.viewFrustum = frustum;
+
+        int bytesWritten = 0;
+        tree->withReadLock([&] {
+            bytesWritten = tree->encodeTreeBitstream(subTree, &packetData, bag, params);
+        });
+
+        if (bytesWritten == 0 && params.stopReason == EncodeBitstreamParams::DIDNT_FIT) {
+            if (!packetData.hasContent()) {
+                // doesn't fit in an empty packet either
+                success = false;
+                break;
+            }
+            packets.emplace_back((const char*)packetData.getFinalizedData(), packetData.getFinalizedSize());
+            packetData.reset();
+            bag.insert(subTree);
+        }
+    }
+    if (packetData.hasContent()) {
+        packets.emplace_back((const char*)packetData.getFinalizedData(), packetData.getFinalizedSize());
+    }
+
+    tree->releaseSceneEncodeData(&extraEncodeData);
+    return success;
+}
+
+void EntityTreeBenchmarks::initTestCase() {
+    // the tree adds the entities through the NodeList, for its permissions
+    DependencyManager::set<AccountManager>();
+    DependencyManager::set<AddressManager>();
+    DependencyManager::set<NodeList>(NodeType::Unassigned);
+
+    QString sizes = qgetenv("ENTITY_TREE_BENCHMARK_SIZES");
+    for (auto& size : sizes.split(',', QString::SkipEmptyParts)) {
+        if (size.toInt() > 0) {
+            _sizes << size.toInt();
+        }
+    }
+    if (_sizes.isEmpty()) {
+        _sizes = DEFAULT_SIZES;
+    }
+}
+
+void EntityTreeBenchmarks::cleanupTestCase() {
+    _trees.clear();
+
+    QString output = qgetenv("ENTITY_TREE_BENCHMARK_OUTPUT");
+    if (output.isEmpty()) {
+        output = DEFAULT_OUTPUT;
+    }
+    QFile file(output);
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write(QJsonDocument(_results).toJson());
+        qDebug() << "results written to" << QFileInfo(file).absoluteFilePath();
+    } else {
+        qWarning() << "could not write the results to" << output;
+    }
+
+    DependencyManager::destroy<NodeList>();
+}
+
+void EntityTreeBenchmarks::report(int numEntities, const QString& name, qint64 nsecs, int numOperations,
+                                  QJsonObject extra) {
+    qDebug("%-40s %10.1f ns per op", qPrintable(QString("%1 %2").arg(name).arg(numEntities)),
+           (double)nsecs / numOperations);
+
+    extra["operations"] = numOperations;
+    extra["total_nsecs"] = (double)nsecs;
+    extra["nsecs_per_op"] = (double)nsecs / numOperations;
+
+    QString key = QString::number(numEntities);
+    QJsonObject results = _results[key].toObject();
+    results[name] = extra;
+    _results[key] = results;
+}
+
+void EntityTreeBenchmarks::buildTree() {
+    for (int numEntities : _sizes) {
+        std::mt19937 random(SEED);
+        std::uniform_real_distribution<float> dimension(MIN_DIMENSION, MAX_DIMENSION);
+
+        auto tree = createServerTree();
+
+        QElapsedTimer timer;
+        timer.start();
+
+        for (int i = 0; i < numEntities; i++) {
+            EntityItemProperties properties;
+            properties.setType(EntityTypes::Box);
+            properties.setPosition(randomPosition(random, SCENE_HALF_SIZE));
+            properties.setDimensions(glm::vec3(dimension(random), dimension(random), dimension(random)));
+            tree->withWriteLock([&] {
+                tree->addEntity(EntityItemID(QUuid::createUuid()), properties);
+            });
+        }
+
+        report(numEntities, "addEntity", timer.nsecsElapsed(), numEntities);
+        QCOMPARE(countEntities(tree), numEntities);
+        _trees[numEntities] = tree;
+    }
+}
+
+void EntityTreeBenchmarks::encodeAndDecode() {
+    for (int numEntities : _sizes) {
+        auto tree = _trees[numEntities];
+        QVERIFY(tree);
+
+        for (auto& view : CLIENT_VIEWS) {
+            ViewFrustum frustum = createViewFrustum(view);
+            std::vector<QByteArray> packets;
+
+            QElapsedTimer timer;
+            timer.start();
+
+            QVERIFY(encodeView(tree, frustum, packets));
+
+            qint64 encodeNsecs = timer.nsecsElapsed();
+            qint64 numBytes = 0;
+            for (auto& packet : packets) {
+                numBytes += packet.size();
+            }
+            QJsonObject encodeStats { { "packets", (int)packets.size() }, { "bytes", (double)numBytes } };
+            report(numEntities, QString("encodeTreeBitstream %1").arg(view.name), encodeNsecs, (int)packets.size(),
+                   encodeStats);
+
+            // the client reads what it was sent into a tree of its own
+            auto clientTree = std::make_shared<EntityTree>();
+            clientTree->createRootElement();
+            clientTree->setIsClient(true);
+
+            timer.restart();
+
+            for (auto& packet : packets) {
+                ReadBitstreamToTreeParams args(WANT_EXISTS_BITS, NULL, QUuid(), SharedNodePointer(), false,
+                                               versionForPacketType(PacketType::EntityData));
+                clientTree->withWriteLock([&] {
+                    OctreePacketData packetData(true);
+                    packetData.loadFinalizedContent(reinterpret_cast<const unsigned char*>(packet.constData()),
+                                                    packet.size());
+                    clientTree->readBitstreamToTree(packetData.getUncompressedData(), packetData.getUncompressedSize(),
+                                                    args);
+                });
+            }
+
+            qint64 decodeNsecs = timer.nsecsElapsed();
+            int numDecoded = countEntities(clientTree);
+            report(numEntities, QString("readBitstreamToTree %1").arg(view.name), decodeNsecs, (int)packets.size(),
+                   QJsonObject { { "entities", numDecoded } });
+            QVERIFY(numDecoded <= numEntities);
+        }
+    }
+}
+
+void EntityTreeBenchmarks::findEntities() {
+    for (int numEntities : _sizes) {
+        auto tree = _trees[numEntities];
+        QVERIFY(tree);
+
+        std::mt19937 random(SEED);
+        std::uniform_real_distribution<float> radius(1.0f, MAX_QUERY_RADIUS);
+        std::vector<glm::vec3> centers;
+        std::vector<float> radii;
+        for (int i = 0; i < NUM_QUERIES; i++) {
+            centers.push_back(randomPosition(random, SCENE_HALF_SIZE));
+            radii.push_back(radius(random));
+        }
+
+        auto measure = [&](const char* name, std::function<void(int, QVector<EntityItemPointer>&)> query) {
+            int numFound = 0;
+
+            QElapsedTimer timer;
+            timer.start();
+
+            for (int i = 0; i < NUM_QUERIES; i++) {
+                QVector<EntityItemPointer> found;
+                tree->withReadLock([&] {
+                    query(i, found);
+                });
+                numFound += found.size();
+            }
+
+            report(numEntities, name, timer.nsecsElapsed(), NUM_QUERIES, QJsonObject { { "found", numFound } });
+        };
+
+        measure("findEntities sphere", [&](int i, QVector<EntityItemPointer>& found) {
+            tree->findEntities(centers[i], radii[i], found);
+        });
+        measure("findEntities cube", [&](int i, QVector<EntityItemPointer>& found) {
+            tree->findEntities(AACube(centers[i] - radii[i], 2.0f * radii[i]), found);
+        });
+        measure("findEntities box", [&](int i, QVector<EntityItemPointer>& found) {
+            tree->findEntities(AABox(centers[i] - radii[i], glm::vec3(2.0f * radii[i], radii[i], 2.0f * radii[i])), found);
+        });
+
+        int numFound = 0;
+
+        QElapsedTimer timer;
+        timer.start();
+
+        for (auto& view : CLIENT_VIEWS) {
+            QVector<EntityItemPointer> found;
+            ViewFrustum frustum = createViewFrustum(view);
+            tree->withReadLock([&] {
+                tree->findEntities(frustum, found);
+            });
+            numFound += found.size();
+        }
+
+        int numViews = sizeof(CLIENT_VIEWS) / sizeof(CLIENT_VIEWS[0]);
+        report(numEntities, "findEntities frustum", timer.nsecsElapsed(), numViews, QJsonObject { { "found", numFound } });
+        QVERIFY(numFound > 0);
+    }
+}
+
+void EntityTreeBenchmarks::findRayIntersection() {
+    for (int numEntities : _sizes) {
+        auto tree = _trees[numEntities];
+        QVERIFY(tree);
+
+        std::mt19937 random(SEED);
+        std::vector<glm::vec3> origins;
+        std::vector<glm::vec3> directions;
+        for (int i = 0; i < NUM_RAYS; i++) {
+            origins.push_back(randomPosition(random, SCENE_HALF_SIZE));
+            directions.push_back(glm::normalize(randomPosition(random, SCENE_HALF_SIZE) - origins.back()));
+        }
+
+        for (bool precisionPicking : { false, true }) {
+            int numHits = 0;
+
+            QElapsedTimer timer;
+            timer.start();
+
+            for (int i = 0; i < NUM_RAYS; i++) {
+                OctreeElementPointer element;
+                float distance;
+                BoxFace face;
+                glm::vec3 surfaceNormal;
+                if (tree->findRayIntersection(origins[i], directions[i], QVector<EntityItemID>(), QVector<EntityItemID>(),
+                                              false, false, precisionPicking, element, distance, face, surfaceNormal,
+                                              nullptr, Octree::Lock)) {
+                    ++numHits;
+                }
+            }
+
+            report(numEntities, precisionPicking ? "findRayIntersection precise" : "findRayIntersection",
+                   timer.nsecsElapsed(), NUM_RAYS, QJsonObject { { "hits", numHits } });
+        }
+    }
+}
+
+void EntityTreeBenchmarks::persist() {
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+
+    for (int numEntities : _sizes) {
+        auto tree = _trees[numEntities];
+        QVERIFY(tree);
+
+        // each format has a name of its own, as the tree reads the most recent of the persist files of a name
+        struct Format {
+            const char* name;
+            QString fileName;
+            std::function<bool(const char*)> write;
+        };
+        const Format formats[] = {
+            { "json", "text.json", [&](const char* fileName) { return tree->writeToJSONFile(fileName); } },
+            { "json.gz", "gzipped.json.gz", [&](const char* fileName) { return tree->writeToJSONFile(fileName, NULL, true); } },
+            { "bin", "binary.bin", [&](const char* fileName) { return tree->writeToBinaryFile(fileName); } },
+        };
+
+        for (auto& format : formats) {
+            QByteArray fileName = directory.filePath(QString("%1-%2").arg(numEntities).arg(format.fileName)).toUtf8();
+
+            QElapsedTimer timer;
+            timer.start();
+
+            QVERIFY(format.write(fileName.constData()));
+
+            qint64 writeNsecs = timer.nsecsElapsed();
+            QJsonObject fileStats { { "bytes", (double)QFileInfo(fileName).size() } };
+            report(numEntities, QString("write %1").arg(format.name), writeNsecs, 1, fileStats);
+
+            auto readTree = createServerTree();
+
+            timer.restart();
+
+            QVERIFY(readTree->readFromFile(fileName.constData()));
+
+            report(numEntities, QString("readFromFile %1").arg(format.name), timer.nsecsElapsed(), 1);
+            QCOMPARE(countEntities(readTree), numEntities);
+        }
+    }
+}
+
+void EntityTreeBenchmarks::moveEntities() {
+    for (int numEntities : _sizes) {
+        auto tree = _trees[numEntities];
+        QVERIFY(tree);
+
+        QVector<EntityItemPointer> entities;
+        tree->withReadLock([&] {
+            tree->findEntities(AACube(glm::vec3(-HALF_TREE_SCALE), TREE_SCALE), entities);
+        });
+
+        std::mt19937 random(SEED);
+        int numMoving = std::max(numEntities / MOVING_ENTITIES_DIVISOR, 1);
+
+        // the entities are moved first, only the re-sort of the tree is measured
+        std::vector<std::pair<EntityItemPointer, AACube>> moves;
+        for (int i = 0; i < numMoving; i++) {
+            auto entity = entities[random() % entities.size()];
+            entity->setPosition(entity->getPosition() + randomPosition(random, MAX_MOVE));
+            entity->checkAndAdjustQueryAACube();
+            moves.emplace_back(entity, entity->getQueryAACube());
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+
+        tree->withWriteLock([&] {
+            MovingEntitiesOperator moveOperator(tree);
+            for (auto& move : moves) {
+                moveOperator.addEntityToMoveList(move.first, move.second);
+            }
+            if (moveOperator.hasMovingEntities()) {
+                tree->recurseTreeWithOperator(&moveOperator);
+            }
+        });
+
+        report(numEntities, "MovingEntitiesOperator", timer.nsecsElapsed(), numMoving);
+        QCOMPARE(countEntities(tree), numEntities);
+    }
+}
@@ -0,0 +1,48 @@
+//
+//  EntityTreeBenchmarks.h
+//  tests/octree/src
+//
+//  Created by Sam Gateau on 10/15/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityTreeBenchmarks_h
+#define hifi_EntityTreeBenchmarks_h
+
+#include <map>
+
+#include <QtCore/QJsonObject>
+#include <QtTest/QtTest>
+
+#include <EntityTree.h>
+
+// times the build, the per view encode and the decode, the queries, the persistence and the re-sorting of moving
+// entities of synthetic entity trees, for each of the sizes in ENTITY_TREE_BENCHMARK_SIZES (10000,100000 by default).
+// The results are reported in ns per op, and written as JSON to ENTITY_TREE_BENCHMARK_OUTPUT
+// (entity-tree-benchmarks.json by default)
+class EntityTreeBenchmarks : public QObject {
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void buildTree();
+    void encodeAndDecode();
+    void findEntities();
+    void findRayIntersection();
+    void persist();
+    void moveEntities();
+
+private:
+    void report(int numEntities, const QString& name, qint64 nsecs, int numOperations,
+                QJsonObject extra = QJsonObject());
+
+    QList<int> _sizes;
+    std::map<int, EntityTreePointer> _trees;
+    QJsonObject _results;
+};
+
+#endif // hifi_EntityTreeBenchmarks_h
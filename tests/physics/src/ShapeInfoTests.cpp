@@ -216,3 +216,25 @@ void ShapeInfoTests::testCapsuleShape() {
     */
 }
 
+
+void ShapeInfoTests::testPointCollectionData() {
+    ShapeInfo::PointCollection pointCollection;
+    pointCollection.push_back({ glm::vec3(0.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f) });
+    pointCollection.push_back({ glm::vec3(-1.5f, 2.25f, 3.0f), glm::vec3(4.0f, -5.0f, 6.125f) });
+
+    QByteArray data = ShapeInfo::writePointCollection(pointCollection);
+    ShapeInfo::PointCollection readCollection;
+    QCOMPARE(ShapeInfo::readPointCollection(data, readCollection), true);
+    QCOMPARE(readCollection.size(), pointCollection.size());
+    for (int i = 0; i < pointCollection.size(); i++) {
+        QCOMPARE(readCollection[i].size(), pointCollection[i].size());
+        for (int j = 0; j < pointCollection[i].size(); j++) {
+            QCOMPARE(readCollection[i][j] == pointCollection[i][j], true);
+        }
+    }
+
+    // a truncated file is rejected, and leaves the collection alone
+    QCOMPARE(ShapeInfo::readPointCollection(data.left(data.size() - 4), readCollection), false);
+    QCOMPARE(readCollection.size(), pointCollection.size());
+    QCOMPARE(ShapeInfo::readPointCollection(QByteArray("not hulls"), readCollection), false);
+}
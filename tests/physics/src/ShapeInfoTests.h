@@ -30,6 +30,7 @@ private slots:
     void testSphereShape();
     void testCylinderShape();
     void testCapsuleShape();
+    void testPointCollectionData();
 };
 
 #endif // hifi_ShapeInfoTests_h
@@ -6,7 +6,9 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
 #include <iostream>
+#include <map>
 #include <string>
 #include <vector>
 #include <sstream>
@@ -14,8 +16,12 @@
 #include <gl/Config.h>
 #include <gl/Context.h>
 
+#include <QtCore/QCommandLineParser>
 #include <QtCore/QDir>
 #include <QtCore/QElapsedTimer>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
 #include <QtCore/QLoggingCategory>
 #include <QtCore/QRegularExpression>
 #include <QtCore/QSettings>
@@ -40,6 +46,7 @@
 #include <shared/FileUtils.h>
 #include <LogHandler.h>
 #include <AssetClient.h>
+#include <ResourceCache.h>
 
 #include <gpu/gl/GLBackend.h>
 #include <gpu/gl/GLFramebuffer.h>
@@ -49,6 +56,7 @@
 #include <WebEntityItem.h>
 #include <OctreeUtils.h>
 #include <render/Engine.h>
+#include <render/EngineStats.h>
 #include <Model.h>
 #include <model/Stage.h>
 #include <TextureCache.h>
@@ -71,6 +79,68 @@
 static const QString LAST_SCENE_KEY = "lastSceneFile";
 static const QString LAST_LOCATION_KEY = "lastLocation";
 
+// a scene is only measured once its resources are loaded and it has been drawn for this many frames at least
+static const int BENCHMARK_MIN_LOAD_FRAMES = 10;
+static const int DEFAULT_BENCHMARK_WARMUP_FRAMES = 120;
+static const int DEFAULT_BENCHMARK_FRAMES = 600;
+
+static bool parseViewpoint(const QString& viewpointString, glm::vec3& position, glm::quat& orientation, bool& hasOrientation) {
+    static const QString FLOAT_REGEX_STRING = "([-+]?[0-9]*\\.?[0-9]+(?:[eE][-+]?[0-9]+)?)";
+    static const QString SPACED_COMMA_REGEX_STRING = "\\s*,\\s*";
+    static const QString POSITION_REGEX_STRING = QString("\\/") + FLOAT_REGEX_STRING + SPACED_COMMA_REGEX_STRING +
+        FLOAT_REGEX_STRING + SPACED_COMMA_REGEX_STRING + FLOAT_REGEX_STRING + "\\s*(?:$|\\/)";
+    static const QString QUAT_REGEX_STRING = QString("\\/") + FLOAT_REGEX_STRING + SPACED_COMMA_REGEX_STRING +
+        FLOAT_REGEX_STRING + SPACED_COMMA_REGEX_STRING + FLOAT_REGEX_STRING + SPACED_COMMA_REGEX_STRING +
+        FLOAT_REGEX_STRING + "\\s*$";
+
+    static QRegExp orientationRegex(QUAT_REGEX_STRING);
+    static QRegExp positionRegex(POSITION_REGEX_STRING);
+
+    hasOrientation = false;
+    if (positionRegex.indexIn(viewpointString) == -1) {
+        return false;
+    }
+
+    position = glm::vec3(positionRegex.cap(1).toFloat(), positionRegex.cap(2).toFloat(), positionRegex.cap(3).toFloat());
+    if (glm::any(glm::isnan(position))) {
+        return true;
+    }
+
+    // we may also have an orientation
+    if (viewpointString[positionRegex.matchedLength() - 1] == QChar('/')
+        && orientationRegex.indexIn(viewpointString, positionRegex.matchedLength() - 1) != -1) {
+
+        glm::vec4 v = glm::vec4(
+            orientationRegex.cap(1).toFloat(),
+            orientationRegex.cap(2).toFloat(),
+            orientationRegex.cap(3).toFloat(),
+            orientationRegex.cap(4).toFloat());
+        if (!glm::any(glm::isnan(v))) {
+            orientation = glm::normalize(glm::quat(v.w, v.x, v.y, v.z));
+            hasOrientation = true;
+        }
+    }
+    return true;
+}
+
+// mean, median, 95th percentile and max of the samples of one metric over the measured frames
+static QJsonObject summarizeSamples(std::vector<double> samples) {
+    QJsonObject summary;
+    if (samples.empty()) {
+        return summary;
+    }
+    std::sort(samples.begin(), samples.end());
+    double total = 0.0;
+    for (auto sample : samples) {
+        total += sample;
+    }
+    summary["mean"] = total / (double)samples.size();
+    summary["p50"] = samples[samples.size() / 2];
+    summary["p95"] = samples[std::min(samples.size() - 1, (samples.size() * 95) / 100)];
+    summary["max"] = samples.back();
+    return summary;
+}
+
 class ParentFinder : public SpatialParentFinder {
 public:
     EntityTreePointer _tree;
@@ -197,6 +267,7 @@ public:
     std::queue<gpu::FramePointer> _pendingFrames;
     gpu::FramePointer _activeFrame;
     QSize _size;
+    std::atomic<bool> _benchmarkRequested { false };
     static const size_t FRAME_TIME_BUFFER_SIZE{ 8192 };
 
     void submitFrame(const gpu::FramePointer& frame) {
@@ -322,7 +393,57 @@ public:
         }
     }
 
+    // Measures how fast the backend replays the state changes and draws of a batch
+    void benchmarkCommands() {
+        static const int NUM_TEXTURES = 16;
+        static const int NUM_BUFFERS = 16;
+        static const int NUM_DRAWS = 100000;
+        static const int NUM_RUNS = 8;
+
+        std::vector<gpu::TexturePointer> textures;
+        for (int i = 0; i < NUM_TEXTURES; ++i) {
+            gpu::TexturePointer texture(gpu::Texture::create2D(gpu::Element::COLOR_RGBA_32, 1, 1));
+            uint32_t texel = 0xff000000 | (i * 0x0f0f0f);
+            texture->assignStoredMip(0, gpu::Element::COLOR_RGBA_32, sizeof(texel), (const gpu::Byte*)&texel);
+            textures.push_back(texture);
+        }
+        std::vector<gpu::BufferPointer> buffers;
+        for (int i = 0; i < NUM_BUFFERS; ++i) {
+            glm::vec4 value(i);
+            buffers.push_back(std::make_shared<gpu::Buffer>(sizeof(value), (const gpu::Byte*)&value));
+        }
+
+        _context.makeCurrent();
+        quint64 totalUsecs = 0;
+        size_t numCommands = 0;
+        for (int run = 0; run < NUM_RUNS; ++run) {
+            gpu::Batch batch;
+            batch.setViewportTransform({ 0, 0, 1, 1 });
+            batch.setFramebuffer(gpu::FramebufferPointer());
+            batch.setPipeline(_presentPipeline);
+            for (int i = 0; i < NUM_DRAWS; ++i) {
+                batch.setResourceTexture(0, textures[i % NUM_TEXTURES]);
+                batch.setUniformBuffer(0, buffers[i % NUM_BUFFERS], 0, sizeof(glm::vec4));
+                batch.draw(gpu::TRIANGLE_STRIP, 4);
+            }
+            numCommands += batch.getCommands().size();
+
+            auto start = usecTimestampNow();
+            _gpuContext->executeBatch(batch);
+            glFinish();
+            totalUsecs += usecTimestampNow() - start;
+        }
+        _context.doneCurrent();
+
+        qDebug() << "Replayed" << numCommands << "commands in" << totalUsecs << "usecs:"
+            << (numCommands * USECS_PER_SECOND / std::max(totalUsecs, (quint64)1)) << "commands/s";
+    }
+
     bool process() override {
+        if (_benchmarkRequested.exchange(false)) {
+            benchmarkCommands();
+        }
+
         std::queue<gpu::FramePointer> pendingFrames;
         {
             std::unique_lock<std::mutex> lock(_frameLock);
@@ -550,6 +671,54 @@ public:
         _commandIndex = 0;
     }
 
+    // Runs the scenes of the suite one after the other, flying each camera path once to warm up and once measuring,
+    // then writes the frame and job times to the output (or the log) and quits
+    void loadBenchmark(const QString& suitePath, const QString& outputPath) {
+        QFile suiteFile(suitePath);
+        if (!suiteFile.open(QFile::ReadOnly)) {
+            qWarning() << "Cannot open benchmark suite" << suitePath;
+            return;
+        }
+        QJsonObject suite = QJsonDocument::fromJson(suiteFile.readAll()).object();
+        QDir suiteDir = QFileInfo(suitePath).absoluteDir();
+
+        // the scenes refer to their models as atp:/, served from the assets directory of the suite
+        if (suite.contains("assets")) {
+            QString assetsUrl = QUrl::fromLocalFile(suiteDir.absoluteFilePath(suite["assets"].toString())).toString();
+            ResourceManager::setUrlPrefixOverride("atp:/", assetsUrl + "/");
+        }
+
+        int warmupFrames = suite["warmup"].toInt(DEFAULT_BENCHMARK_WARMUP_FRAMES);
+        int frames = suite["frames"].toInt(DEFAULT_BENCHMARK_FRAMES);
+        _benchmarkScenes.clear();
+        for (auto sceneValue : suite["scenes"].toArray()) {
+            QJsonObject sceneObject = sceneValue.toObject();
+            BenchmarkScene scene;
+            scene.name = sceneObject["name"].toString();
+            scene.file = suiteDir.absoluteFilePath(sceneObject["file"].toString());
+            scene.warmupFrames = sceneObject["warmup"].toInt(warmupFrames);
+            scene.frames = std::max(sceneObject["frames"].toInt(frames), 1);
+            for (auto viewpoint : sceneObject["path"].toArray()) {
+                glm::vec3 position;
+                glm::quat orientation;
+                bool hasOrientation;
+                if (parseViewpoint(viewpoint.toString(), position, orientation, hasOrientation)) {
+                    scene.path.push_back({ position, orientation });
+                }
+            }
+            if (scene.path.empty()) {
+                qWarning() << "Skipping benchmark scene" << scene.name << "without a camera path";
+                continue;
+            }
+            _benchmarkScenes.push_back(scene);
+        }
+
+        _benchmarkOutputPath = outputPath;
+        _benchmarkResults = QJsonArray();
+        _benchmarkSceneIndex = 0;
+        startBenchmarkScene();
+    }
+
 protected:
 
     bool eventFilter(QObject *obj, QEvent *event) override {
@@ -594,6 +763,10 @@ protected:
             toggleCulling();
             return;
 
+        case Qt::Key_F10:
+            _renderThread._benchmarkRequested = true;
+            return;
+
         case Qt::Key_Home:
             gpu::Texture::setAllowedGPUMemoryUsage(0);
             return;
@@ -622,6 +795,21 @@ protected:
     }
 
 private:
+    class BenchmarkScene {
+    public:
+        QString name;
+        QString file;
+        int warmupFrames { DEFAULT_BENCHMARK_WARMUP_FRAMES };
+        int frames { DEFAULT_BENCHMARK_FRAMES };
+        std::vector<std::pair<glm::vec3, glm::quat>> path;
+    };
+
+    enum BenchmarkState {
+        BENCHMARK_IDLE = 0,
+        BENCHMARK_LOAD,
+        BENCHMARK_WARMUP,
+        BENCHMARK_MEASURE,
+    };
 
     static bool cull(const RenderArgs* args, const AABox& bounds) {
         float renderAccuracy = calculateRenderAccuracy(args->getViewFrustum().getPosition(), bounds, args->_sizeScale, args->_boundaryLevelAdjust);
@@ -686,6 +874,10 @@ private:
         // Final framebuffer that will be handled to the display-plugin
         render(&renderArgs);
 
+        if (_benchmarkState == BENCHMARK_MEASURE) {
+            recordBenchmarkFrame();
+        }
+
         if (_fps != _renderThread._fps) {
             _fps = _renderThread._fps;
             updateText();
@@ -781,6 +973,8 @@ private:
                 return;
             }
             parsePath(commandParams[1]);
+        } else if (verb == "benchmark") {
+            _renderThread._benchmarkRequested = true;
         } else {
             qDebug() << "Unknown command " << command;
         }
@@ -814,6 +1008,9 @@ private:
         float delta = now - last;
         // Update the camera
         _camera.update(delta / USECS_PER_SECOND);
+        if (_benchmarkState != BENCHMARK_IDLE) {
+            updateBenchmark();
+        }
         {
             _viewFrustum = ViewFrustum();
             _viewFrustum.setProjection(_camera.matrices.perspective);
@@ -917,38 +1114,14 @@ private:
     }
 
     void parsePath(const QString& viewpointString) {
-        static const QString FLOAT_REGEX_STRING = "([-+]?[0-9]*\\.?[0-9]+(?:[eE][-+]?[0-9]+)?)";
-        static const QString SPACED_COMMA_REGEX_STRING = "\\s*,\\s*";
-        static const QString POSITION_REGEX_STRING = QString("\\/") + FLOAT_REGEX_STRING + SPACED_COMMA_REGEX_STRING +
-            FLOAT_REGEX_STRING + SPACED_COMMA_REGEX_STRING + FLOAT_REGEX_STRING + "\\s*(?:$|\\/)";
-        static const QString QUAT_REGEX_STRING = QString("\\/") + FLOAT_REGEX_STRING + SPACED_COMMA_REGEX_STRING +
-            FLOAT_REGEX_STRING + SPACED_COMMA_REGEX_STRING + FLOAT_REGEX_STRING + SPACED_COMMA_REGEX_STRING +
-            FLOAT_REGEX_STRING + "\\s*$";
-
-        static QRegExp orientationRegex(QUAT_REGEX_STRING);
-        static QRegExp positionRegex(POSITION_REGEX_STRING);
-
-        if (positionRegex.indexIn(viewpointString) != -1) {
+        glm::vec3 position;
+        glm::quat orientation;
+        bool hasOrientation;
+        if (parseViewpoint(viewpointString, position, orientation, hasOrientation)) {
             // we have at least a position, so emit our signal to say we need to change position
-            glm::vec3 newPosition(positionRegex.cap(1).toFloat(),
-                positionRegex.cap(2).toFloat(),
-                positionRegex.cap(3).toFloat());
-            _camera.setPosition(newPosition);
-
-            if (!glm::any(glm::isnan(newPosition))) {
-                // we may also have an orientation
-                if (viewpointString[positionRegex.matchedLength() - 1] == QChar('/')
-                    && orientationRegex.indexIn(viewpointString, positionRegex.matchedLength() - 1) != -1) {
-
-                    glm::vec4 v = glm::vec4(
-                        orientationRegex.cap(1).toFloat(),
-                        orientationRegex.cap(2).toFloat(),
-                        orientationRegex.cap(3).toFloat(),
-                        orientationRegex.cap(4).toFloat());
-                    if (!glm::any(glm::isnan(v))) {
-                        _camera.setRotation(glm::normalize(glm::quat(v.w, v.x, v.y, v.z)));
-                    }
-                }
+            _camera.setPosition(position);
+            if (hasOrientation) {
+                _camera.setRotation(orientation);
             }
         }
     }
@@ -1008,6 +1181,8 @@ private:
             arg(v.x).arg(v.y).arg(v.z).
             arg(q.x).arg(q.y).arg(q.z).arg(q.w);
         _settings.setValue(LAST_LOCATION_KEY, viewpoint);
+        // so it can be pasted in the path of a benchmark scene
+        qDebug() << "Saved viewpoint" << viewpoint;
     }
 
     void restorePosition() {
@@ -1045,6 +1220,127 @@ private:
         return _octree;
     }
 
+    void startBenchmarkScene() {
+        if (_benchmarkSceneIndex >= _benchmarkScenes.size()) {
+            finishBenchmark();
+            return;
+        }
+
+        const auto& scene = _benchmarkScenes[_benchmarkSceneIndex];
+        qDebug() << "Benchmarking" << scene.name;
+        importScene(scene.file);
+        _benchmarkSamples.clear();
+        _benchmarkFrame = 0;
+        _benchmarkState = BENCHMARK_LOAD;
+    }
+
+    // the camera at t in [0, 1] along the path of the scene, moving at a constant rate from one viewpoint to the next
+    void setBenchmarkCamera(const BenchmarkScene& scene, float t) {
+        float segment = glm::clamp(t, 0.0f, 1.0f) * (float)(scene.path.size() - 1);
+        size_t index = std::min((size_t)segment, scene.path.size() - 1);
+        size_t nextIndex = std::min(index + 1, scene.path.size() - 1);
+        float alpha = segment - (float)index;
+        _camera.setPosition(glm::mix(scene.path[index].first, scene.path[nextIndex].first, alpha));
+        _camera.setRotation(glm::slerp(scene.path[index].second, scene.path[nextIndex].second, alpha));
+    }
+
+    // the frames are counted rather than timed so the camera sees the same views whatever the frame rate
+    void updateBenchmark() {
+        const auto& scene = _benchmarkScenes[_benchmarkSceneIndex];
+        switch (_benchmarkState) {
+        case BENCHMARK_LOAD:
+            setBenchmarkCamera(scene, 0.0f);
+            if (++_benchmarkFrame >= BENCHMARK_MIN_LOAD_FRAMES &&
+                ResourceCache::getPendingRequestCount() == 0 && ResourceCache::getLoadingRequests().isEmpty()) {
+                _benchmarkState = BENCHMARK_WARMUP;
+                _benchmarkFrame = 0;
+            }
+            break;
+
+        case BENCHMARK_WARMUP:
+            setBenchmarkCamera(scene, (float)_benchmarkFrame / (float)std::max(scene.warmupFrames, 1));
+            if (++_benchmarkFrame > scene.warmupFrames) {
+                _benchmarkState = BENCHMARK_MEASURE;
+                _benchmarkFrame = 0;
+                _lastBenchmarkFrameTime = usecTimestampNow();
+            }
+            break;
+
+        case BENCHMARK_MEASURE:
+            setBenchmarkCamera(scene, (float)_benchmarkFrame / (float)scene.frames);
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    void recordBenchmarkFrame() {
+        auto now = usecTimestampNow();
+        _benchmarkSamples["frame"].push_back((double)(now - _lastBenchmarkFrameTime) / (double)USECS_PER_MSEC);
+        _lastBenchmarkFrameTime = now;
+
+        // the cpu time of every job, the gpu time of the ones timed by a GPURangeTimer, and the counts of the EngineStats
+        auto engineConfig = _renderEngine->getConfiguration();
+        for (auto config : engineConfig->findChildren<render::JobConfig*>()) {
+            QString name = config->objectName();
+            if (name.isEmpty()) {
+                continue;
+            }
+            _benchmarkSamples["cpu/" + name].push_back(config->getCPURunTime());
+            if (auto gpuConfig = qobject_cast<render::GPUJobConfig*>(config)) {
+                _benchmarkSamples["gpu/" + name].push_back(gpuConfig->getGPURunTime());
+                _benchmarkSamples["batch/" + name].push_back(gpuConfig->getBatchRunTime());
+            }
+            if (auto statsConfig = qobject_cast<render::EngineStatsConfig*>(config)) {
+                _benchmarkSamples["drawcalls"].push_back(statsConfig->frameDrawcallCount);
+                _benchmarkSamples["triangles"].push_back(statsConfig->frameTriangleCount);
+                _benchmarkSamples["pipelines"].push_back(statsConfig->frameSetPipelineCount);
+                _benchmarkSamples["textures"].push_back(statsConfig->frameTextureCount);
+            }
+        }
+
+        const auto& scene = _benchmarkScenes[_benchmarkSceneIndex];
+        if (++_benchmarkFrame < scene.frames) {
+            return;
+        }
+
+        QJsonObject metrics;
+        for (const auto& samples : _benchmarkSamples) {
+            metrics[samples.first] = summarizeSamples(samples.second);
+        }
+        QJsonObject result;
+        result["name"] = scene.name;
+        result["warmup"] = scene.warmupFrames;
+        result["frames"] = scene.frames;
+        result["metrics"] = metrics;
+        _benchmarkResults.append(result);
+
+        ++_benchmarkSceneIndex;
+        startBenchmarkScene();
+    }
+
+    void finishBenchmark() {
+        _benchmarkState = BENCHMARK_IDLE;
+
+        QJsonObject report;
+        report["resolution"] = QJsonArray { _size.width(), _size.height() };
+        report["culling"] = _cullingEnabled;
+        report["scenes"] = _benchmarkResults;
+        QByteArray json = QJsonDocument(report).toJson();
+
+        QFile outputFile(_benchmarkOutputPath);
+        if (!_benchmarkOutputPath.isEmpty() && outputFile.open(QFile::WriteOnly | QFile::Truncate)) {
+            outputFile.write(json);
+            qDebug() << "Wrote the benchmark results to" << _benchmarkOutputPath;
+        } else {
+            qDebug().noquote() << json;
+        }
+
+        close();
+        QCoreApplication::quit();
+    }
+
 private:
     render::CullFunctor _cullFunctor { [&](const RenderArgs* args, const AABox& bounds)->bool{
         if (_cullingEnabled) {
@@ -1069,6 +1365,15 @@ private:
     model::LightPointer _globalLight { std::make_shared<model::Light>() };
     bool _ready { false };
 
+    std::vector<BenchmarkScene> _benchmarkScenes;
+    size_t _benchmarkSceneIndex { 0 };
+    BenchmarkState _benchmarkState { BENCHMARK_IDLE };
+    int _benchmarkFrame { 0 };
+    quint64 _lastBenchmarkFrameTime { 0 };
+    std::map<QString, std::vector<double>> _benchmarkSamples;
+    QJsonArray _benchmarkResults;
+    QString _benchmarkOutputPath;
+
     QStringList _commands;
     QString _commandPath;
     int _commandLoops { 0 };
@@ -1116,8 +1421,21 @@ int main(int argc, char** argv) {
 
     qInstallMessageHandler(messageHandler);
     QLoggingCategory::setFilterRules(LOG_FILTER_RULES);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("High Fidelity render performance test");
+    parser.addHelpOption();
+    const QCommandLineOption benchmarkOption("benchmark", "run the scenes and camera paths of a benchmark suite", "suite.json");
+    parser.addOption(benchmarkOption);
+    const QCommandLineOption outputOption("output", "where to write the benchmark results", "results.json");
+    parser.addOption(outputOption);
+    parser.process(app);
+
     QTestWindow::setup();
     QTestWindow window;
+    if (parser.isSet(benchmarkOption)) {
+        window.loadBenchmark(parser.value(benchmarkOption), parser.value(outputOption));
+    }
     //window.loadCommands("C:/Users/bdavis/Git/dreaming/exports/commands.txt");
     app.exec();
     return 0;
@@ -102,3 +102,42 @@ void GLMHelpersTests::testSixByteOrientationCompression() {
     testQuatCompression(-(ROT_Y_180 * ROT_Z_30 * ROT_X_90));
     testQuatCompression(-(ROT_Z_30 * ROT_X_90 * ROT_Y_180));
 }
+
+static void testCoarseQuatCompression(glm::quat testQuat) {
+
+    float MAX_COMPONENT_ERROR = 2.1e-3f;
+
+    glm::quat q;
+    uint8_t bytes[4];
+    packOrientationQuatToFourBytes(bytes, testQuat);
+    unpackOrientationQuatFromFourBytes(bytes, q);
+    if (glm::dot(q, testQuat) < 0.0f) {
+        q = -q;
+    }
+    QCOMPARE_WITH_ABS_ERROR(q.x, testQuat.x, MAX_COMPONENT_ERROR);
+    QCOMPARE_WITH_ABS_ERROR(q.y, testQuat.y, MAX_COMPONENT_ERROR);
+    QCOMPARE_WITH_ABS_ERROR(q.z, testQuat.z, MAX_COMPONENT_ERROR);
+    QCOMPARE_WITH_ABS_ERROR(q.w, testQuat.w, MAX_COMPONENT_ERROR);
+}
+
+void GLMHelpersTests::testFourByteOrientationCompression() {
+    const glm::quat ROT_X_90 = glm::angleAxis(PI / 2.0f, glm::vec3(1.0f, 0.0f, 0.0f));
+    const glm::quat ROT_Y_180 = glm::angleAxis(PI, glm::vec3(0.0f, 1.0, 0.0f));
+    const glm::quat ROT_Z_30 = glm::angleAxis(PI / 6.0f, glm::vec3(1.0f, 0.0f, 0.0f));
+    const glm::quat ROT_FINGER_CURL = glm::angleAxis(PI / 8.0f, glm::normalize(glm::vec3(1.0f, 0.2f, 0.1f)));
+
+    testCoarseQuatCompression(glm::quat());
+    testCoarseQuatCompression(ROT_X_90);
+    testCoarseQuatCompression(ROT_Y_180);
+    testCoarseQuatCompression(ROT_Z_30);
+    testCoarseQuatCompression(ROT_FINGER_CURL);
+    testCoarseQuatCompression(ROT_X_90 * ROT_Y_180 * ROT_Z_30);
+    testCoarseQuatCompression(ROT_Y_180 * ROT_Z_30 * ROT_X_90);
+    testCoarseQuatCompression(ROT_Z_30 * ROT_X_90 * ROT_FINGER_CURL);
+
+    testCoarseQuatCompression(-ROT_X_90);
+    testCoarseQuatCompression(-ROT_Y_180);
+    testCoarseQuatCompression(-ROT_FINGER_CURL);
+    testCoarseQuatCompression(-(ROT_X_90 * ROT_Y_180 * ROT_Z_30));
+    testCoarseQuatCompression(-(ROT_Z_30 * ROT_X_90 * ROT_FINGER_CURL));
+}
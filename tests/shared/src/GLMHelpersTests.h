@@ -20,6 +20,7 @@ class GLMHelpersTests : public QObject {
 private slots:
     void testEulerDecomposition();
     void testSixByteOrientationCompression();
+    void testFourByteOrientationCompression();
 };
 
 float getErrorDifference(const float& a, const float& b);
@@ -0,0 +1,55 @@
+//
+//  SlabPoolTests.cpp
+//  tests/shared/src
+//
+//  Created by Sam Gateau on 10/15/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SlabPoolTests.h"
+
+#include <cstddef>
+
+#include <SlabPool.h>
+
+QTEST_MAIN(SlabPoolTests)
+
+static const size_t BLOCKS_PER_SLAB = 8;
+
+void SlabPoolTests::contiguousBlocks() {
+    SlabPool pool(20, BLOCKS_PER_SLAB);
+
+    // the blocks are rounded up to keep them aligned
+    QVERIFY(pool.getBlockSize() >= 20);
+    QCOMPARE(pool.getBlockSize() % alignof(std::max_align_t), (size_t)0);
+
+    // the blocks of one slab follow each other
+    char* first = static_cast<char*>(pool.allocate());
+    for (size_t i = 1; i < BLOCKS_PER_SLAB; i++) {
+        QCOMPARE(static_cast<char*>(pool.allocate()), first + i * pool.getBlockSize());
+    }
+    QCOMPARE(pool.getSlabCount(), (size_t)1);
+
+    // and the next one starts a new slab
+    pool.allocate();
+    QCOMPARE(pool.getSlabCount(), (size_t)2);
+    QCOMPARE(pool.getAllocatedCount(), BLOCKS_PER_SLAB + 1);
+}
+
+void SlabPoolTests::reuseFreedBlocks() {
+    SlabPool pool(32, BLOCKS_PER_SLAB);
+
+    void* a = pool.allocate();
+    void* b = pool.allocate();
+    pool.deallocate(a);
+    pool.deallocate(b);
+    QCOMPARE(pool.getAllocatedCount(), (size_t)0);
+
+    // the most recently freed block comes back first, without a new slab
+    QCOMPARE(pool.allocate(), b);
+    QCOMPARE(pool.allocate(), a);
+    QCOMPARE(pool.getSlabCount(), (size_t)1);
+}
@@ -0,0 +1,24 @@
+//
+//  SlabPoolTests.h
+//  tests/shared/src
+//
+//  Created by Sam Gateau on 10/15/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SlabPoolTests_h
+#define hifi_SlabPoolTests_h
+
+#include <QtTest/QtTest>
+
+class SlabPoolTests : public QObject {
+    Q_OBJECT
+private slots:
+    void contiguousBlocks();
+    void reuseFreedBlocks();
+};
+
+#endif // hifi_SlabPoolTests_h
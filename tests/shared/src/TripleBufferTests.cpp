@@ -0,0 +1,79 @@
+//
+//  TripleBufferTests.cpp
+//  tests/shared/src
+//
+//  Created by Sam Gateau on 10/15/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "TripleBufferTests.h"
+
+#include <atomic>
+#include <thread>
+
+#include <TripleBuffer.h>
+
+QTEST_MAIN(TripleBufferTests)
+
+void TripleBufferTests::consumeLatest() {
+    TripleBuffer<int> buffer;
+
+    // nothing published yet
+    QVERIFY(!buffer.consume());
+
+    buffer.getWriteBuffer() = 1;
+    buffer.publish();
+    QVERIFY(buffer.consume());
+    QCOMPARE(buffer.getReadBuffer(), 1);
+
+    // only the latest of the values published between two consume() is read
+    buffer.getWriteBuffer() = 2;
+    buffer.publish();
+    buffer.getWriteBuffer() = 3;
+    buffer.publish();
+    QVERIFY(buffer.consume());
+    QCOMPARE(buffer.getReadBuffer(), 3);
+
+    // and it stays readable until the next one
+    QVERIFY(!buffer.consume());
+    QCOMPARE(buffer.getReadBuffer(), 3);
+}
+
+void TripleBufferTests::concurrentHandOff() {
+    struct Value {
+        int first { 0 };
+        int second { 0 };
+    };
+    TripleBuffer<Value> buffer;
+
+    const int NUM_VALUES = 100000;
+    std::thread writer([&] {
+        for (int i = 1; i <= NUM_VALUES; i++) {
+            Value& value = buffer.getWriteBuffer();
+            value.first = i;
+            value.second = -i;
+            buffer.publish();
+        }
+    });
+
+    // the reader never sees a half written value, nor goes back in time
+    int last = 0;
+    bool torn = false;
+    bool backwards = false;
+    while (last < NUM_VALUES) {
+        if (buffer.consume()) {
+            const Value& value = buffer.getReadBuffer();
+            torn = torn || value.first != -value.second;
+            backwards = backwards || value.first <= last;
+            last = value.first;
+        }
+    }
+    writer.join();
+
+    QVERIFY(!torn);
+    QVERIFY(!backwards);
+    QCOMPARE(last, NUM_VALUES);
+}
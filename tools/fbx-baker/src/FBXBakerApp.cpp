@@ -0,0 +1,97 @@
+//
+//  FBXBakerApp.cpp
+//  tools/fbx-baker/src
+//
+//  Created by Sam Gateau on 10/15/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "FBXBakerApp.h"
+
+#include <memory>
+
+#include <QCommandLineParser>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+#include <FBXBaked.h>
+#include <FSTReader.h>
+
+FBXBakerApp::FBXBakerApp(int argc, char* argv[]) : QCoreApplication(argc, argv) {
+
+    // parse command-line
+    QCommandLineParser parser;
+    parser.setApplicationDescription("High Fidelity FBX Baker");
+    const QCommandLineOption helpOption = parser.addHelpOption();
+
+    const QCommandLineOption inputFilenameOption("i", "input model, or the fst mapping it", "model.fbx");
+    parser.addOption(inputFilenameOption);
+
+    const QCommandLineOption outputFilenameOption("o", "output file, the model file with the hfb extension by default", "model.hfb");
+    parser.addOption(outputFilenameOption);
+
+    if (!parser.parse(QCoreApplication::arguments())) {
+        qCritical() << parser.errorText() << endl;
+        parser.showHelp();
+        _returnCode = 1;
+        return;
+    }
+
+    if (parser.isSet(helpOption) || !parser.isSet(inputFilenameOption)) {
+        parser.showHelp();
+        return;
+    }
+
+    // The mapping is applied at bake time, the fst of a baked model points the filename at the hfb file
+    QString inputFilename = parser.value(inputFilenameOption);
+    QVariantHash mapping;
+    if (QFileInfo(inputFilename).suffix().toLower() == "fst") {
+        QFile fstFile(inputFilename);
+        if (!fstFile.open(QIODevice::ReadOnly)) {
+            qCritical() << "Failed to open file " << inputFilename;
+            _returnCode = 2;
+            return;
+        }
+        mapping = FSTReader::readMapping(fstFile.readAll());
+        inputFilename = QFileInfo(inputFilename).dir().filePath(mapping.value("filename").toString());
+    }
+
+    QString outputFilename = parser.value(outputFilenameOption);
+    if (outputFilename.isEmpty()) {
+        QFileInfo inputInfo(inputFilename);
+        outputFilename = inputInfo.path() + "/" + inputInfo.completeBaseName() + "." + fbxbaked::FILE_EXTENSION;
+    }
+
+    QFile file(inputFilename);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCritical() << "Failed to open file " << inputFilename;
+        _returnCode = 2;
+        return;
+    }
+
+    std::unique_ptr<FBXGeometry> geometry;
+    try {
+        geometry.reset(readFBX(&file, mapping, inputFilename));
+    } catch (const QString& error) {
+        qCritical() << "Failed to read " << inputFilename << ":" << error;
+        _returnCode = 2;
+        return;
+    }
+
+    QByteArray baked = fbxbaked::write(*geometry);
+    QFile outputFile(outputFilename);
+    if (!outputFile.open(QIODevice::WriteOnly) || outputFile.write(baked) != baked.size()) {
+        qCritical() << "Failed to write " << outputFilename;
+        _returnCode = 3;
+        return;
+    }
+    qDebug() << "Baked" << inputFilename << "into" << outputFilename << geometry->meshes.size() << "meshes," << baked.size() << "bytes";
+}
+
+FBXBakerApp::~FBXBakerApp() {
+}
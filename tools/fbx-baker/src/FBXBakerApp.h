@@ -0,0 +1,30 @@
+//
+//  FBXBakerApp.h
+//  tools/fbx-baker/src
+//
+//  Created by Sam Gateau on 10/15/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_FBXBakerApp_h
+#define hifi_FBXBakerApp_h
+
+#include <QCoreApplication>
+
+// Bakes an FBX model, with the mapping of its FST if given one, into a geometry the client loads without parsing the FBX
+class FBXBakerApp : public QCoreApplication {
+    Q_OBJECT
+public:
+    FBXBakerApp(int argc, char* argv[]);
+    ~FBXBakerApp();
+
+    int getReturnCode() const { return _returnCode; }
+
+private:
+    int _returnCode { 0 };
+};
+
+#endif //hifi_FBXBakerApp_h
@@ -0,0 +1,199 @@
+//
+//  LoadClient.cpp
+//  tools/load-client/src
+//
+//  Created by Sam Gateau on 10/15/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "LoadClient.h"
+
+#include <glm/gtc/quaternion.hpp>
+
+#include <AudioConstants.h>
+#include <NLPacket.h>
+#include <SharedUtil.h>
+#include <ViewFrustum.h>
+
+static const int AVATAR_FRAMES_PER_SECOND = 60;
+static const int NUM_JOINTS = 60;
+static const float JOINT_CHURN_RATIO = 0.1f; // of the joints moving on each avatar frame
+static const float WALK_RADIUS = 10.0f;
+static const float WALK_SPEED = 1.4f; // meters per second
+static const float TALK_PERIOD_SECS = 5.0f;
+static const float TALK_RATIO = 0.6f;
+static const int ENTITY_QUERY_PACKETS_PER_SECOND = 200;
+
+LoadClient::LoadClient(int index, quint32 seed, QObject* parent) :
+    QObject(parent),
+    _index(index),
+    _random(seed + index),
+    _audioTimer(new QTimer(this)),
+    _avatarTimer(new QTimer(this)),
+    _identityTimer(new QTimer(this))
+{
+    auto nodeList = DependencyManager::get<NodeList>();
+    connect(nodeList.data(), &LimitedNodeList::uuidChanged, this, [this](const QUuid& ownerUUID) {
+        _avatar.setSessionUUID(ownerUUID);
+    });
+
+    auto& packetReceiver = nodeList->getPacketReceiver();
+    packetReceiver.registerListenerForTypes({ PacketType::MixedAudio, PacketType::SilentAudioFrame }, this, "handleMixedAudio");
+    packetReceiver.registerListener(PacketType::BulkAvatarData, this, "handleAvatarData");
+    packetReceiver.registerListener(PacketType::EntityData, this, "handleEntityData");
+
+    _avatar.setSkeletonModelURL(QUrl());
+    _avatar.setDisplayName(QString("load-client-%1").arg(index));
+
+    _entityQuery.setCameraFov(DEFAULT_FIELD_OF_VIEW_DEGREES);
+    _entityQuery.setCameraAspectRatio(16.0f / 9.0f);
+    _entityQuery.setCameraNearClip(DEFAULT_NEAR_CLIP);
+    _entityQuery.setCameraFarClip(DEFAULT_FAR_CLIP);
+    _entityQuery.setMaxQueryPacketsPerSecond(ENTITY_QUERY_PACKETS_PER_SECOND);
+
+    _audioTimer->setTimerType(Qt::PreciseTimer);
+    connect(_audioTimer, &QTimer::timeout, this, &LoadClient::sendAudio);
+    _avatarTimer->setTimerType(Qt::PreciseTimer);
+    connect(_avatarTimer, &QTimer::timeout, this, &LoadClient::sendAvatar);
+    connect(_identityTimer, &QTimer::timeout, this, &LoadClient::sendIdentityAndQuery);
+}
+
+void LoadClient::start() {
+    _clock.start();
+    _nextAudioFrame = 0;
+
+    // the timer only wakes us up, the frames are sent on the schedule of the clock so the stream doesn't drift
+    _audioTimer->start((int)AudioConstants::NETWORK_FRAME_MSECS / 2);
+    _avatarTimer->start((int)MSECS_PER_SECOND / AVATAR_FRAMES_PER_SECOND);
+    _identityTimer->start(AVATAR_IDENTITY_PACKET_SEND_INTERVAL_MSECS);
+}
+
+glm::vec3 LoadClient::getPosition(float seconds) const {
+    // each client walks its own circle, offset around the origin so they spread across the mixer's culling
+    float angle = (seconds * WALK_SPEED / WALK_RADIUS) + (float)_index;
+    glm::vec3 center((float)(_index % 8) * WALK_RADIUS, 0.0f, (float)(_index / 8) * WALK_RADIUS);
+    return center + WALK_RADIUS * glm::vec3(cosf(angle), 0.0f, sinf(angle));
+}
+
+bool LoadClient::isTalking(float seconds) const {
+    float phase = fmodf(seconds / TALK_PERIOD_SECS + (float)_index * 0.37f, 1.0f);
+    return phase < TALK_RATIO;
+}
+
+void LoadClient::sendAudio() {
+    auto nodeList = DependencyManager::get<NodeList>();
+    SharedNodePointer audioMixer = nodeList->soloNodeOfType(NodeType::AudioMixer);
+
+    quint64 now = _clock.nsecsElapsed() / NSECS_PER_USEC;
+    while (_nextAudioFrame <= now) {
+        float seconds = (float)_nextAudioFrame / USECS_PER_SECOND;
+        _nextAudioFrame += AudioConstants::NETWORK_FRAME_USECS;
+        if (!audioMixer || !audioMixer->getActiveSocket()) {
+            continue;
+        }
+
+        bool talking = isTalking(seconds);
+        auto audioPacket = NLPacket::create(talking ? PacketType::MicrophoneAudioNoEcho : PacketType::SilentAudioFrame);
+        audioPacket->writePrimitive(_audioSequenceNumber++);
+        audioPacket->writeString(QString());
+        if (talking) {
+            // mono
+            audioPacket->writePrimitive((quint8)0);
+        } else {
+            audioPacket->writePrimitive((quint16)AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+        }
+        audioPacket->writePrimitive(getPosition(seconds));
+        audioPacket->writePrimitive(_avatar.getOrientation());
+
+        if (talking) {
+            // a tone of its own pitch for each client
+            AudioConstants::AudioSample samples[AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL];
+            float frequency = 200.0f + 10.0f * (float)(_index % 40);
+            for (int i = 0; i < AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL; ++i) {
+                float t = seconds + (float)i / AudioConstants::SAMPLE_RATE;
+                samples[i] = (AudioConstants::AudioSample)(0.25f * AudioConstants::MAX_SAMPLE_VALUE * sinf(TWO_PI * frequency * t));
+            }
+            audioPacket->write(reinterpret_cast<const char*>(samples), sizeof(samples));
+        }
+
+        nodeList->sendUnreliablePacket(*audioPacket, *audioMixer);
+    }
+}
+
+void LoadClient::sendAvatar() {
+    float seconds = (float)_clock.elapsed() / MSECS_PER_SECOND;
+    glm::vec3 position = getPosition(seconds);
+    glm::vec3 heading = getPosition(seconds + 0.1f) - position;
+    _avatar.setPosition(position);
+    _avatar.setOrientation(glm::quat(glm::vec3(0.0f, atan2f(-heading.x, -heading.z), 0.0f)));
+
+    std::uniform_int_distribution<int> jointDistribution(0, NUM_JOINTS - 1);
+    std::uniform_real_distribution<float> angleDistribution(-PI_OVER_TWO, PI_OVER_TWO);
+    int numChurned = (int)(JOINT_CHURN_RATIO * NUM_JOINTS);
+    for (int i = 0; i < numChurned; ++i) {
+        glm::vec3 angles(angleDistribution(_random), angleDistribution(_random), angleDistribution(_random));
+        _avatar.setJointData(jointDistribution(_random), glm::quat(angles), glm::vec3(0.0f));
+    }
+
+    auto nodeList = DependencyManager::get<NodeList>();
+    std::uniform_real_distribution<float> fullUpdateDistribution(0.0f, 1.0f);
+    bool sendFullUpdate = fullUpdateDistribution(_random) < AVATAR_SEND_FULL_UPDATE_RATIO;
+    QByteArray avatarByteArray = _avatar.toByteArray(true, sendFullUpdate);
+    _avatar.doneEncoding(true);
+
+    auto avatarPacket = NLPacket::create(PacketType::AvatarData, avatarByteArray.size() + sizeof(_avatarSequenceNumber));
+    avatarPacket->writePrimitive(_avatarSequenceNumber++);
+    avatarPacket->write(avatarByteArray);
+    nodeList->broadcastToNodes(std::move(avatarPacket), NodeSet() << NodeType::AvatarMixer);
+}
+
+void LoadClient::sendIdentityAndQuery() {
+    _avatar.sendIdentityPacket();
+
+    _entityQuery.setCameraPosition(_avatar.getPosition());
+    _entityQuery.setCameraOrientation(_avatar.getOrientation());
+
+    auto nodeList = DependencyManager::get<NodeList>();
+    nodeList->eachMatchingNode([](const SharedNodePointer& node) {
+        return node->getType() == NodeType::EntityServer && node->getActiveSocket();
+    }, [&](const SharedNodePointer& node) {
+        auto queryPacket = NLPacket::create(PacketType::EntityQuery);
+        int querySize = _entityQuery.getBroadcastData(reinterpret_cast<unsigned char*>(queryPacket->getPayload()));
+        queryPacket->setPayloadSize(querySize);
+        nodeList->sendPacket(std::move(queryPacket), *node);
+    });
+}
+
+void LoadClient::recordGap(Histogram& gaps, quint64& lastTime) {
+    quint64 now = usecTimestampNow();
+    if (lastTime != 0) {
+        gaps.record(now - lastTime);
+    }
+    lastTime = now;
+}
+
+void LoadClient::handleMixedAudio(QSharedPointer<ReceivedMessage> message) {
+    recordGap(_mixedAudioGaps, _lastMixedAudio);
+}
+
+void LoadClient::handleAvatarData(QSharedPointer<ReceivedMessage> message) {
+    recordGap(_avatarDataGaps, _lastAvatarData);
+}
+
+void LoadClient::handleEntityData(QSharedPointer<ReceivedMessage> message) {
+    recordGap(_entityDataGaps, _lastEntityData);
+    _entityBytes += message->getSize();
+}
+
+QJsonObject LoadClient::getStats() {
+    QJsonObject stats;
+    stats["index"] = _index;
+    stats["mixed_audio_gap_usecs"] = _mixedAudioGaps.takeSnapshot().toJson();
+    stats["avatar_data_gap_usecs"] = _avatarDataGaps.takeSnapshot().toJson();
+    stats["entity_data_gap_usecs"] = _entityDataGaps.takeSnapshot().toJson();
+    stats["entity_bytes"] = (double)_entityBytes;
+    return stats;
+}
@@ -0,0 +1,82 @@
+//
+//  LoadClient.h
+//  tools/load-client/src
+//
+//  Created by Sam Gateau on 10/15/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_LoadClient_h
+#define hifi_LoadClient_h
+
+#include <random>
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QJsonObject>
+#include <QtCore/QObject>
+#include <QtCore/QTimer>
+
+#include <AvatarData.h>
+#include <Histogram.h>
+#include <NodeList.h>
+#include <OctreeQuery.h>
+#include <ReceivedMessage.h>
+
+// One synthetic client: it handshakes with the domain through the NodeList, streams a mic tone with talk spurts,
+// an avatar walking a circle with a churning skeleton, queries the entities around it,
+// and measures the gaps between the mixes, the avatar updates and the entity packets it gets back.
+// Everything it sends derives from its index and the seed, so two runs load the servers the same way.
+class LoadClient : public QObject {
+    Q_OBJECT
+public:
+    LoadClient(int index, quint32 seed, QObject* parent = nullptr);
+
+    // the gaps between the packets received, as Histogram snapshots
+    QJsonObject getStats();
+
+public slots:
+    void start();
+
+private slots:
+    void sendAudio();
+    void sendAvatar();
+    void sendIdentityAndQuery();
+
+    void handleMixedAudio(QSharedPointer<ReceivedMessage> message);
+    void handleAvatarData(QSharedPointer<ReceivedMessage> message);
+    void handleEntityData(QSharedPointer<ReceivedMessage> message);
+
+private:
+    static void recordGap(Histogram& gaps, quint64& lastTime);
+
+    glm::vec3 getPosition(float seconds) const;
+    bool isTalking(float seconds) const;
+
+    int _index;
+    std::mt19937 _random;
+    QElapsedTimer _clock;
+
+    QTimer* _audioTimer;
+    QTimer* _avatarTimer;
+    QTimer* _identityTimer;
+
+    quint64 _nextAudioFrame { 0 };
+    quint16 _audioSequenceNumber { 0 };
+    AvatarDataSequenceNumber _avatarSequenceNumber { 0 };
+
+    AvatarData _avatar;
+    OctreeQuery _entityQuery;
+
+    Histogram _mixedAudioGaps;
+    Histogram _avatarDataGaps;
+    Histogram _entityDataGaps;
+    quint64 _lastMixedAudio { 0 };
+    quint64 _lastAvatarData { 0 };
+    quint64 _lastEntityData { 0 };
+    quint64 _entityBytes { 0 };
+};
+
+#endif // hifi_LoadClient_h
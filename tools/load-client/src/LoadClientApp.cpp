@@ -0,0 +1,282 @@
+//
+//  LoadClientApp.cpp
+//  tools/load-client/src
+//
+//  Created by Sam Gateau on 10/15/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "LoadClientApp.h"
+
+#include <iostream>
+
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QThread>
+#include <QtCore/QTimer>
+#include <QtNetwork/QNetworkReply>
+
+#include <AccountManager.h>
+#include <AddressManager.h>
+#include <DependencyManager.h>
+#include <NetworkAccessManager.h>
+#include <NetworkLogging.h>
+#include <NodeList.h>
+#include <SettingHandle.h>
+#include <SharedLogging.h>
+
+#include "LoadClient.h"
+
+// the clients are started apart so the domain-server isn't flooded with handshakes
+static const int CLIENT_RAMP_MSECS = 100;
+// the server metrics are taken while all the clients are still connected
+static const int METRICS_MARGIN_SECS = 2;
+
+static const QStringList CLIENT_STATS_KEYS { "mixed_audio_gap_usecs", "avatar_data_gap_usecs", "entity_data_gap_usecs" };
+
+LoadClientApp::LoadClientApp(int argc, char* argv[]) :
+    QCoreApplication(argc, argv)
+{
+    // parse command-line
+    QCommandLineParser parser;
+    parser.setApplicationDescription("High Fidelity load client");
+
+    const QCommandLineOption helpOption = parser.addHelpOption();
+
+    const QCommandLineOption verboseOutput("v", "verbose output");
+    parser.addOption(verboseOutput);
+
+    const QCommandLineOption domainAddressOption("d", "domain-server address", "127.0.0.1");
+    parser.addOption(domainAddressOption);
+
+    const QCommandLineOption numClientsOption("n", "number of clients", "1");
+    parser.addOption(numClientsOption);
+
+    const QCommandLineOption durationOption("duration", "seconds each client stays connected", "30");
+    parser.addOption(durationOption);
+
+    const QCommandLineOption seedOption("seed", "seed of the motion of the clients", "0");
+    parser.addOption(seedOption);
+
+    const QCommandLineOption metricsURLOption("metrics-url", "domain-server metrics to report, e.g. http://127.0.0.1:40100/metrics", "url");
+    parser.addOption(metricsURLOption);
+
+    const QCommandLineOption clientOption("client", "run only the client of this index", "index");
+    parser.addOption(clientOption);
+
+    if (!parser.parse(QCoreApplication::arguments())) {
+        qCritical() << parser.errorText() << endl;
+        parser.showHelp();
+        Q_UNREACHABLE();
+    }
+
+    if (parser.isSet(helpOption)) {
+        parser.showHelp();
+        Q_UNREACHABLE();
+    }
+
+    _verbose = parser.isSet(verboseOutput);
+    if (!_verbose) {
+        QLoggingCategory::setFilterRules("qt.network.ssl.warning=false");
+
+        const_cast<QLoggingCategory*>(&networking())->setEnabled(QtDebugMsg, false);
+        const_cast<QLoggingCategory*>(&networking())->setEnabled(QtInfoMsg, false);
+        const_cast<QLoggingCategory*>(&networking())->setEnabled(QtWarningMsg, false);
+
+        const_cast<QLoggingCategory*>(&shared())->setEnabled(QtDebugMsg, false);
+        const_cast<QLoggingCategory*>(&shared())->setEnabled(QtInfoMsg, false);
+        const_cast<QLoggingCategory*>(&shared())->setEnabled(QtWarningMsg, false);
+    }
+
+    _domainServerAddress = "127.0.0.1:40103";
+    if (parser.isSet(domainAddressOption)) {
+        _domainServerAddress = parser.value(domainAddressOption);
+    }
+    if (parser.isSet(numClientsOption)) {
+        _numClients = std::max(parser.value(numClientsOption).toInt(), 1);
+    }
+    if (parser.isSet(durationOption)) {
+        _durationSecs = std::max(parser.value(durationOption).toInt(), 1);
+    }
+    if (parser.isSet(seedOption)) {
+        _seed = parser.value(seedOption).toUInt();
+    }
+    if (parser.isSet(metricsURLOption)) {
+        _metricsURL = parser.value(metricsURLOption);
+    }
+
+    if (parser.isSet(clientOption)) {
+        runClient(parser.value(clientOption).toInt());
+        return;
+    }
+
+    if (_verbose) {
+        qDebug() << "loading" << _domainServerAddress << "with" << _numClients << "clients for" << _durationSecs << "seconds";
+    }
+
+    startNextClient();
+
+    int lastClientStartMsecs = (_numClients - 1) * CLIENT_RAMP_MSECS;
+    QTimer::singleShot(lastClientStartMsecs + std::max(_durationSecs - METRICS_MARGIN_SECS, 0) * (int)MSECS_PER_SECOND,
+        this, &LoadClientApp::requestServerMetrics);
+}
+
+void LoadClientApp::runClient(int index) {
+    Setting::preInit();
+    DependencyManager::registerInheritance<LimitedNodeList, NodeList>();
+    Setting::init();
+
+    DependencyManager::set<AccountManager>([&]{ return QString("Mozilla/5.0 (HighFidelityLoadClient)"); });
+    DependencyManager::set<AddressManager>();
+    DependencyManager::set<NodeList>(NodeType::Agent);
+
+    auto nodeList = DependencyManager::get<NodeList>();
+
+    // start the nodeThread so its event loop is running
+    QThread* nodeThread = new QThread(this);
+    nodeThread->setObjectName("NodeList Thread");
+    nodeThread->start();
+
+    // setup a timer for domain-server check ins
+    QTimer* domainCheckInTimer = new QTimer(nodeList.data());
+    connect(domainCheckInTimer, &QTimer::timeout, nodeList.data(), &NodeList::sendDomainServerCheckIn);
+    domainCheckInTimer->start(DOMAIN_SERVER_CHECK_IN_MSECS);
+
+    // put the NodeList and datagram processing on the node thread
+    nodeList->moveToThread(nodeThread);
+
+    nodeList->addSetOfNodeTypesToNodeInterestSet(NodeSet() << NodeType::AudioMixer << NodeType::AvatarMixer
+                                                 << NodeType::EntityServer);
+
+    _client = new LoadClient(index, _seed, this);
+    _client->start();
+
+    DependencyManager::get<AddressManager>()->handleLookupString(_domainServerAddress, false);
+
+    QTimer::singleShot(_durationSecs * (int)MSECS_PER_SECOND, this, &LoadClientApp::finishClient);
+}
+
+void LoadClientApp::finishClient() {
+    // the stats are the last line of the output, for the launcher to pick up
+    std::cout << QJsonDocument(_client->getStats()).toJson(QJsonDocument::Compact).toStdString() << std::endl;
+
+    auto nodeList = DependencyManager::get<NodeList>();
+
+    // send the domain a disconnect packet, force stoppage of domain-server check-ins
+    nodeList->getDomainHandler().disconnect();
+    nodeList->setIsShuttingDown(true);
+
+    // tell the packet receiver we're shutting down, so it can drop packets
+    nodeList->getPacketReceiver().setShouldDropPackets(true);
+
+    QThread* nodeThread = nodeList->thread();
+    nodeList.reset();
+    // remove the NodeList from the DependencyManager
+    DependencyManager::destroy<NodeList>();
+    // ask the node thread to quit and wait until it is done
+    nodeThread->quit();
+    nodeThread->wait();
+
+    QCoreApplication::exit(0);
+}
+
+void LoadClientApp::startNextClient() {
+    int index = _clientProcesses.size();
+    if (index >= _numClients) {
+        return;
+    }
+
+    QStringList arguments;
+    arguments << "--client" << QString::number(index)
+        << "-d" << _domainServerAddress
+        << "--duration" << QString::number(_durationSecs)
+        << "--seed" << QString::number(_seed);
+    if (_verbose) {
+        arguments << "-v";
+    }
+
+    QProcess* process = new QProcess(this);
+    process->setProcessChannelMode(_verbose ? QProcess::ForwardedErrorChannel : QProcess::SeparateChannels);
+    connect(process, static_cast<void (QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished), this, [this, index] {
+        clientFinished(index);
+    });
+    _clientProcesses.push_back(process);
+    process->start(QCoreApplication::applicationFilePath(), arguments);
+
+    QTimer::singleShot(CLIENT_RAMP_MSECS, this, &LoadClientApp::startNextClient);
+}
+
+void LoadClientApp::clientFinished(int index) {
+    QProcess* process = _clientProcesses[index];
+    QList<QByteArray> lines = process->readAllStandardOutput().trimmed().split('\n');
+    QJsonObject stats = QJsonDocument::fromJson(lines.last()).object();
+    if (stats.isEmpty()) {
+        qWarning() << "client" << index << "exited with" << process->exitCode() << "and no stats";
+    } else {
+        _clientStats.append(stats);
+    }
+
+    if (++_numFinishedClients == _numClients && !_waitingForMetrics) {
+        finishReport();
+    }
+}
+
+void LoadClientApp::requestServerMetrics() {
+    if (_metricsURL.isEmpty()) {
+        return;
+    }
+
+    _waitingForMetrics = true;
+    QNetworkReply* reply = NetworkAccessManager::getInstance().get(QNetworkRequest(QUrl(_metricsURL)));
+    connect(reply, &QNetworkReply::finished, this, [this, reply] {
+        if (reply->error() == QNetworkReply::NoError) {
+            // keep the histograms of the servers
+            for (auto& line : reply->readAll().split('\n')) {
+                if (line.startsWith("hifi_")) {
+                    _serverMetrics << QString::fromUtf8(line);
+                }
+            }
+        } else {
+            qWarning() << "could not get the metrics from" << _metricsURL << reply->errorString();
+        }
+        reply->deleteLater();
+
+        _waitingForMetrics = false;
+        if (_numFinishedClients == _numClients) {
+            finishReport();
+        }
+    });
+}
+
+void LoadClientApp::finishReport() {
+    // the worst of the clients, for each gap
+    QJsonObject worst;
+    for (auto& key : CLIENT_STATS_KEYS) {
+        double worstP50 = 0.0;
+        double worstP99 = 0.0;
+        double worstMax = 0.0;
+        for (auto stats : _clientStats) {
+            QJsonObject histogram = stats.toObject()[key].toObject();
+            worstP50 = std::max(worstP50, histogram["p50"].toDouble());
+            worstP99 = std::max(worstP99, histogram["p99"].toDouble());
+            worstMax = std::max(worstMax, histogram["max"].toDouble());
+        }
+        worst[key] = QJsonObject { { "p50", worstP50 }, { "p99", worstP99 }, { "max", worstMax } };
+    }
+
+    QJsonObject report;
+    report["clients"] = _numClients;
+    report["duration"] = _durationSecs;
+    report["seed"] = (double)_seed;
+    report["worst"] = worst;
+    report["client_stats"] = _clientStats;
+    report["server_metrics"] = QJsonArray::fromStringList(_serverMetrics);
+
+    std::cout << QJsonDocument(report).toJson().toStdString();
+    QCoreApplication::exit(_clientStats.size() == _numClients ? 0 : 1);
+}
@@ -0,0 +1,59 @@
+//
+//  LoadClientApp.h
+//  tools/load-client/src
+//
+//  Created by Sam Gateau on 10/15/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_LoadClientApp_h
+#define hifi_LoadClientApp_h
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QJsonArray>
+#include <QtCore/QProcess>
+#include <QtCore/QStringList>
+
+class LoadClient;
+
+// Loads the mixers and the entity server of a domain with synthetic clients, and reports the timing of what
+// they receive along with the histograms of the servers' hot paths.
+// The NodeList is a singleton, so each client runs in a child process of its own (with --client) and this one
+// only launches them and gathers their stats.
+class LoadClientApp : public QCoreApplication {
+    Q_OBJECT
+public:
+    LoadClientApp(int argc, char* argv[]);
+
+private slots:
+    void startNextClient();
+    void clientFinished(int index);
+    void requestServerMetrics();
+
+private:
+    void runClient(int index);
+    void finishClient();
+    void finishReport();
+
+    bool _verbose { false };
+    QString _domainServerAddress;
+    int _numClients { 1 };
+    int _durationSecs { 30 };
+    quint32 _seed { 0 };
+    QString _metricsURL;
+
+    // as a client
+    LoadClient* _client { nullptr };
+
+    // as the launcher
+    QList<QProcess*> _clientProcesses;
+    int _numFinishedClients { 0 };
+    QJsonArray _clientStats;
+    QStringList _serverMetrics;
+    bool _waitingForMetrics { false };
+};
+
+#endif // hifi_LoadClientApp_h
@@ -0,0 +1,16 @@
+//
+//  main.cpp
+//  tools/load-client/src
+//
+//  Created by Sam Gateau on 10/15/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+
+#include "LoadClientApp.h"
+
+int main(int argc, char* argv[]) {
+    LoadClientApp app(argc, argv);
+    return app.exec();
+}
@@ -0,0 +1,198 @@
+//
+//  BlockCompression.cpp
+//  tools/texture-baker/src
+//
+//  Created by Sam Gateau on 10/15/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "BlockCompression.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+using namespace BlockCompression;
+
+static const int BLOCK_DIM = 4;
+static const int BLOCK_TEXELS = BLOCK_DIM * BLOCK_DIM;
+static const uint8_t ALPHA_THRESHOLD = 128;
+
+using Block = uint8_t[BLOCK_TEXELS][4];
+
+static void fetchBlock(const uint8_t* rgba, int width, int height, int blockX, int blockY, Block& block) {
+    for (int y = 0; y < BLOCK_DIM; ++y) {
+        int srcY = std::min(blockY * BLOCK_DIM + y, height - 1);
+        for (int x = 0; x < BLOCK_DIM; ++x) {
+            int srcX = std::min(blockX * BLOCK_DIM + x, width - 1);
+            memcpy(block[y * BLOCK_DIM + x], rgba + 4 * (srcY * width + srcX), 4);
+        }
+    }
+}
+
+static uint16_t packColor565(const int color[3]) {
+    return (uint16_t)(((color[0] * 31 + 127) / 255) << 11 | ((color[1] * 63 + 127) / 255) << 5 | ((color[2] * 31 + 127) / 255));
+}
+
+static void unpackColor565(uint16_t packed, int color[3]) {
+    int r = (packed >> 11) & 0x1F;
+    int g = (packed >> 5) & 0x3F;
+    int b = packed & 0x1F;
+    color[0] = (r << 3) | (r >> 2);
+    color[1] = (g << 2) | (g >> 4);
+    color[2] = (b << 3) | (b >> 2);
+}
+
+static int colorDistance(const int a[3], const uint8_t* b) {
+    int dr = a[0] - b[0];
+    int dg = a[1] - b[1];
+    int db = a[2] - b[2];
+    return dr * dr + dg * dg + db * db;
+}
+
+// 8 bytes: two 565 endpoints and 2 bit indices. With allowTransparent, the transparent texels use the 3 color mode
+static void compressColorBlock(const Block& block, bool allowTransparent, uint8_t* dest) {
+    bool hasTransparent = false;
+    int minColor[3] = { 255, 255, 255 };
+    int maxColor[3] = { 0, 0, 0 };
+    for (int i = 0; i < BLOCK_TEXELS; ++i) {
+        if (allowTransparent && block[i][3] < ALPHA_THRESHOLD) {
+            hasTransparent = true;
+            continue;
+        }
+        for (int c = 0; c < 3; ++c) {
+            minColor[c] = std::min(minColor[c], (int)block[i][c]);
+            maxColor[c] = std::max(maxColor[c], (int)block[i][c]);
+        }
+    }
+    if (minColor[0] > maxColor[0]) {
+        // every texel is transparent
+        minColor[0] = minColor[1] = minColor[2] = 0;
+        maxColor[0] = maxColor[1] = maxColor[2] = 0;
+    }
+
+    // Inset the bounding box a bit, the extremes are rarely worth an endpoint
+    for (int c = 0; c < 3; ++c) {
+        int inset = (maxColor[c] - minColor[c]) / 16;
+        minColor[c] += inset;
+        maxColor[c] -= inset;
+    }
+
+    uint16_t color0 = packColor565(maxColor);
+    uint16_t color1 = packColor565(minColor);
+    // The 4 color mode needs color0 > color1, the 3 color mode color0 <= color1
+    if (hasTransparent ? (color0 > color1) : (color0 < color1)) {
+        std::swap(color0, color1);
+    }
+
+    int palette[4][3];
+    unpackColor565(color0, palette[0]);
+    unpackColor565(color1, palette[1]);
+    int numColors = 4;
+    if (hasTransparent || color0 == color1) {
+        numColors = 3;
+        for (int c = 0; c < 3; ++c) {
+            palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+        }
+    } else {
+        for (int c = 0; c < 3; ++c) {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        }
+    }
+
+    uint32_t indices = 0;
+    for (int i = 0; i < BLOCK_TEXELS; ++i) {
+        uint32_t index = 3;
+        if (!(hasTransparent && block[i][3] < ALPHA_THRESHOLD)) {
+            int bestDistance = colorDistance(palette[0], block[i]);
+            index = 0;
+            for (int p = 1; p < numColors; ++p) {
+                int distance = colorDistance(palette[p], block[i]);
+                if (distance < bestDistance) {
+                    bestDistance = distance;
+                    index = p;
+                }
+            }
+        }
+        indices |= index << (2 * i);
+    }
+
+    memcpy(dest, &color0, 2);
+    memcpy(dest + 2, &color1, 2);
+    memcpy(dest + 4, &indices, 4);
+}
+
+// 8 bytes: two 8 bit endpoints and 3 bit indices in the 8 values mode
+static void compressChannelBlock(const Block& block, int channel, uint8_t* dest) {
+    int minValue = 255;
+    int maxValue = 0;
+    for (int i = 0; i < BLOCK_TEXELS; ++i) {
+        minValue = std::min(minValue, (int)block[i][channel]);
+        maxValue = std::max(maxValue, (int)block[i][channel]);
+    }
+
+    int palette[8];
+    palette[0] = maxValue;
+    palette[1] = minValue;
+    for (int p = 2; p < 8; ++p) {
+        palette[p] = ((8 - p) * maxValue + (p - 1) * minValue) / 7;
+    }
+
+    uint64_t indices = 0;
+    for (int i = 0; i < BLOCK_TEXELS; ++i) {
+        int value = block[i][channel];
+        uint64_t index = 0;
+        int bestDistance = std::abs(palette[0] - value);
+        for (int p = 1; p < 8; ++p) {
+            int distance = std::abs(palette[p] - value);
+            if (distance < bestDistance) {
+                bestDistance = distance;
+                index = p;
+            }
+        }
+        indices |= index << (3 * i);
+    }
+
+    dest[0] = (uint8_t)maxValue;
+    dest[1] = (uint8_t)minValue;
+    for (int b = 0; b < 6; ++b) {
+        dest[2 + b] = (uint8_t)(indices >> (8 * b));
+    }
+}
+
+std::vector<uint8_t> BlockCompression::compress(Format format, const uint8_t* rgba, int width, int height) {
+    int blocksWide = (width + BLOCK_DIM - 1) / BLOCK_DIM;
+    int blocksHigh = (height + BLOCK_DIM - 1) / BLOCK_DIM;
+    size_t blockSize = (format == BC1 || format == BC4) ? 8 : 16;
+
+    std::vector<uint8_t> result(blocksWide * blocksHigh * blockSize);
+    uint8_t* dest = result.data();
+    Block block;
+    for (int blockY = 0; blockY < blocksHigh; ++blockY) {
+        for (int blockX = 0; blockX < blocksWide; ++blockX) {
+            fetchBlock(rgba, width, height, blockX, blockY, block);
+            switch (format) {
+                case BC1:
+                    compressColorBlock(block, true, dest);
+                    break;
+                case BC3:
+                    compressChannelBlock(block, 3, dest);
+                    compressColorBlock(block, false, dest + 8);
+                    break;
+                case BC4:
+                    compressChannelBlock(block, 0, dest);
+                    break;
+                case BC5:
+                    compressChannelBlock(block, 0, dest);
+                    compressChannelBlock(block, 1, dest + 8);
+                    break;
+            }
+            dest += blockSize;
+        }
+    }
+    return result;
+}
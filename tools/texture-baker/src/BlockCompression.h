@@ -0,0 +1,33 @@
+//
+//  BlockCompression.h
+//  tools/texture-baker/src
+//
+//  Created by Sam Gateau on 10/15/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_BlockCompression_h
+#define hifi_BlockCompression_h
+
+#include <cstdint>
+#include <vector>
+
+// Range fit encoders of the BC formats the baker produces, fast rather than optimal.
+// The source is RGBA8 rows of width * height texels, the partial blocks on the edges repeat the last texels.
+namespace BlockCompression {
+
+    enum Format {
+        BC1 = 0, // RGB, or RGB with a 1 bit alpha when any texel is transparent
+        BC3, // RGBA
+        BC4, // R
+        BC5, // RG
+    };
+
+    std::vector<uint8_t> compress(Format format, const uint8_t* rgba, int width, int height);
+
+}
+
+#endif // hifi_BlockCompression_h
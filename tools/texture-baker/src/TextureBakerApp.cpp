@@ -0,0 +1,156 @@
+//
+//  TextureBakerApp.cpp
+//  tools/texture-baker/src
+//
+//  Created by Sam Gateau on 10/15/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "TextureBakerApp.h"
+
+#include <memory>
+
+#include <QCommandLineParser>
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QImage>
+
+#include <gpu/KTX.h>
+
+#include "BlockCompression.h"
+
+static const int MAX_DIMENSION = 0xFFFF;
+
+TextureBakerApp::TextureBakerApp(int argc, char* argv[]) : QCoreApplication(argc, argv) {
+
+    // parse command-line
+    QCommandLineParser parser;
+    parser.setApplicationDescription("High Fidelity Texture Baker");
+    const QCommandLineOption helpOption = parser.addHelpOption();
+
+    const QCommandLineOption inputFilenameOption("i", "input image", "image.png");
+    parser.addOption(inputFilenameOption);
+
+    const QCommandLineOption outputFilenameOption("o", "output file, the input file with the ktx extension by default", "image.ktx");
+    parser.addOption(outputFilenameOption);
+
+    const QCommandLineOption typeOption("t", "texture type: color (BC1 or BC3), normal (BC5), gray (BC4) or uncompressed (RGBA8)", "type", "color");
+    parser.addOption(typeOption);
+
+    if (!parser.parse(QCoreApplication::arguments())) {
+        qCritical() << parser.errorText() << endl;
+        parser.showHelp();
+        _returnCode = 1;
+        return;
+    }
+
+    if (parser.isSet(helpOption) || !parser.isSet(inputFilenameOption)) {
+        parser.showHelp();
+        return;
+    }
+
+    QString inputFilename = parser.value(inputFilenameOption);
+    QString outputFilename = parser.value(outputFilenameOption);
+    if (outputFilename.isEmpty()) {
+        QFileInfo inputInfo(inputFilename);
+        outputFilename = inputInfo.path() + "/" + inputInfo.completeBaseName() + "." + gpu::ktx::FILE_EXTENSION;
+    }
+    QString type = parser.value(typeOption);
+
+    QImage image(inputFilename);
+    if (image.isNull() || image.width() > MAX_DIMENSION || image.height() > MAX_DIMENSION) {
+        qCritical() << "Failed to load image " << inputFilename;
+        _returnCode = 2;
+        return;
+    }
+    image = image.convertToFormat(QImage::Format_RGBA8888);
+
+    // Pick the format from the type and the alpha of the image
+    bool hasAlpha = false;
+    bool alphaAsMask = true;
+    for (int y = 0; y < image.height(); ++y) {
+        const uchar* line = image.constScanLine(y);
+        for (int x = 0; x < image.width(); ++x) {
+            uchar alpha = line[4 * x + 3];
+            if (alpha != 255) {
+                hasAlpha = true;
+                if (alpha != 0) {
+                    alphaAsMask = false;
+                }
+            }
+        }
+    }
+
+    gpu::Element format;
+    BlockCompression::Format blockFormat = BlockCompression::BC1;
+    auto usage = gpu::Texture::Usage::Builder();
+    if (type == "color") {
+        usage.withColor();
+        if (!hasAlpha) {
+            format = gpu::Element::COLOR_COMPRESSED_BC1_SRGB;
+        } else if (alphaAsMask) {
+            format = gpu::Element::COLOR_COMPRESSED_BC1_SRGBA;
+            usage.withAlpha().withAlphaMask();
+        } else {
+            format = gpu::Element::COLOR_COMPRESSED_BC3_SRGBA;
+            blockFormat = BlockCompression::BC3;
+            usage.withAlpha();
+        }
+    } else if (type == "normal") {
+        format = gpu::Element::VEC2_COMPRESSED_BC5_XY;
+        blockFormat = BlockCompression::BC5;
+        usage.withNormal();
+    } else if (type == "gray") {
+        format = gpu::Element::COLOR_COMPRESSED_BC4_RED;
+        blockFormat = BlockCompression::BC4;
+    } else if (type == "uncompressed") {
+        format = gpu::Element::COLOR_SRGBA_32;
+        usage.withColor();
+        if (hasAlpha) {
+            usage.withAlpha();
+            if (alphaAsMask) {
+                usage.withAlphaMask();
+            }
+        }
+    } else {
+        qCritical() << "Unknown texture type " << type;
+        _returnCode = 1;
+        return;
+    }
+
+    std::unique_ptr<gpu::Texture> texture(gpu::Texture::create2D(format, image.width(), image.height(),
+        gpu::Sampler(gpu::Sampler::FILTER_MIN_MAG_MIP_LINEAR)));
+    texture->setSource(inputFilename.toStdString());
+    texture->setUsage(usage.build());
+
+    // Every mip is downsampled from the full image and compressed
+    gpu::uint16 numMips = texture->evalNumMips();
+    for (gpu::uint16 level = 0; level < numMips; ++level) {
+        QImage mip = image;
+        if (level > 0) {
+            mip = image.scaled(texture->evalMipWidth(level), texture->evalMipHeight(level), Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        }
+        if (format.isBlockCompressed()) {
+            auto blocks = BlockCompression::compress(blockFormat, mip.constBits(), mip.width(), mip.height());
+            texture->assignStoredMip(level, format, blocks.size(), blocks.data());
+        } else {
+            texture->assignStoredMip(level, format, mip.byteCount(), mip.constBits());
+        }
+    }
+
+    auto ktx = gpu::ktx::write(*texture);
+    QFile file(outputFilename);
+    if (ktx.empty() || !file.open(QIODevice::WriteOnly) || file.write((const char*)ktx.data(), ktx.size()) != (qint64)ktx.size()) {
+        qCritical() << "Failed to write " << outputFilename;
+        _returnCode = 3;
+        return;
+    }
+    qDebug() << "Baked" << inputFilename << "into" << outputFilename << numMips << "mips," << ktx.size() << "bytes";
+}
+
+TextureBakerApp::~TextureBakerApp() {
+}
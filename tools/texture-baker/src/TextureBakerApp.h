@@ -0,0 +1,30 @@
+//
+//  TextureBakerApp.h
+//  tools/texture-baker/src
+//
+//  Created by Sam Gateau on 10/15/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_TextureBakerApp_h
+#define hifi_TextureBakerApp_h
+
+#include <QCoreApplication>
+
+// Bakes an image into a KTX texture holding all its mips block compressed, ready for the client to upload
+class TextureBakerApp : public QCoreApplication {
+    Q_OBJECT
+public:
+    TextureBakerApp(int argc, char* argv[]);
+    ~TextureBakerApp();
+
+    int getReturnCode() const { return _returnCode; }
+
+private:
+    int _returnCode { 0 };
+};
+
+#endif //hifi_TextureBakerApp_h
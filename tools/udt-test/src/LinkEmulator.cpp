@@ -0,0 +1,101 @@
+//
+//  LinkEmulator.cpp
+//  tools/udt-test/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "LinkEmulator.h"
+
+#include <algorithm>
+
+#include <QtCore/QDebug>
+
+LinkEmulator::LinkEmulator(quint16 port, const HifiSockAddr& target, int oneWayDelayMsecs, float lossRate,
+                           QObject* parent) :
+    QObject(parent),
+    _target(target),
+    _delay(oneWayDelayMsecs),
+    _lossRate(lossRate)
+{
+    _socket.bind(QHostAddress::AnyIPv4, port);
+    connect(&_socket, &QUdpSocket::readyRead, this, &LinkEmulator::readPendingDatagrams);
+
+    _sendTimer.setSingleShot(true);
+    _sendTimer.setTimerType(Qt::PreciseTimer);
+    connect(&_sendTimer, &QTimer::timeout, this, &LinkEmulator::sendDueDatagrams);
+
+    static const int STATS_INTERVAL_MSECS = 1000;
+    connect(&_statsTimer, &QTimer::timeout, this, &LinkEmulator::printStats);
+    _statsTimer.start(STATS_INTERVAL_MSECS);
+
+    qDebug() << "Emulating a link to" << _target << "on port" << _socket.localPort() << "with"
+        << (2 * oneWayDelayMsecs) << "ms RTT and" << (lossRate * 100.0f) << "% loss";
+}
+
+void LinkEmulator::readPendingDatagrams() {
+    auto now = p_high_resolution_clock::now();
+
+    while (_socket.hasPendingDatagrams()) {
+        QByteArray datagram(_socket.pendingDatagramSize(), 0);
+        HifiSockAddr senderSockAddr;
+
+        _socket.readDatagram(datagram.data(), datagram.size(),
+                             senderSockAddr.getAddressPointer(), senderSockAddr.getPortPointer());
+
+        if (senderSockAddr != _target) {
+            _sender = senderSockAddr;
+        } else if (_sender.isNull()) {
+            // nobody to send this back to yet
+            continue;
+        }
+
+        if (_distribution(_generator) < _lossRate) {
+            ++_numDropped;
+            continue;
+        }
+
+        // the delay is the same for every datagram, so the queue stays sorted by send time
+        HifiSockAddr destination = (senderSockAddr == _target) ? _sender : _target;
+        _delayedDatagrams.push_back({ now + _delay, datagram, destination });
+    }
+
+    if (!_sendTimer.isActive()) {
+        scheduleSendTimer();
+    }
+}
+
+void LinkEmulator::sendDueDatagrams() {
+    auto now = p_high_resolution_clock::now();
+
+    while (!_delayedDatagrams.empty() && _delayedDatagrams.front().sendTime <= now) {
+        auto& delayed = _delayedDatagrams.front();
+        _socket.writeDatagram(delayed.datagram, delayed.destination.getAddress(), delayed.destination.getPort());
+        ++_numForwarded;
+
+        _delayedDatagrams.pop_front();
+    }
+
+    scheduleSendTimer();
+}
+
+void LinkEmulator::scheduleSendTimer() {
+    if (_delayedDatagrams.empty()) {
+        return;
+    }
+
+    auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(_delayedDatagrams.front().sendTime
+                                                                      - p_high_resolution_clock::now());
+    _sendTimer.start(std::max((int)wait.count(), 0));
+}
+
+void LinkEmulator::printStats() {
+    qDebug() << "Forwarded" << _numForwarded << "datagrams and dropped" << _numDropped
+        << "-" << _delayedDatagrams.size() << "in flight";
+
+    _numForwarded = 0;
+    _numDropped = 0;
+}
@@ -0,0 +1,69 @@
+//
+//  LinkEmulator.h
+//  tools/udt-test/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_LinkEmulator_h
+#define hifi_LinkEmulator_h
+
+#include <chrono>
+#include <deque>
+#include <random>
+
+#include <QtCore/QObject>
+#include <QtCore/QTimer>
+#include <QtNetwork/QUdpSocket>
+
+#include <HifiSockAddr.h>
+#include <PortableHighResolutionClock.h>
+
+// Relays datagrams between a sender and a target with a fixed one-way delay and random loss, so that a sender and a
+// receiver on one machine see a long, lossy link. The sender is whoever last sent to us from anywhere but the target.
+class LinkEmulator : public QObject {
+    Q_OBJECT
+public:
+    LinkEmulator(quint16 port, const HifiSockAddr& target, int oneWayDelayMsecs, float lossRate,
+                 QObject* parent = nullptr);
+
+private slots:
+    void readPendingDatagrams();
+    void sendDueDatagrams();
+    void printStats();
+
+private:
+    void scheduleSendTimer();
+
+    struct DelayedDatagram {
+        p_high_resolution_clock::time_point sendTime;
+        QByteArray datagram;
+        HifiSockAddr destination;
+    };
+
+    QUdpSocket _socket { this };
+    QTimer _sendTimer { this };
+    QTimer _statsTimer { this };
+
+    HifiSockAddr _target;
+    HifiSockAddr _sender;
+
+    std::chrono::milliseconds _delay;
+    float _lossRate;
+
+    std::deque<DelayedDatagram> _delayedDatagrams;
+
+    std::random_device _randomDevice;
+    std::mt19937 _generator { _randomDevice() };
+    std::uniform_real_distribution<float> _distribution { 0.0f, 1.0f };
+
+    int _numForwarded { 0 };
+    int _numDropped { 0 };
+};
+
+#endif // hifi_LinkEmulator_h
@@ -19,6 +19,8 @@
 
 #include <LogHandler.h>
 
+#include "LinkEmulator.h"
+
 const QCommandLineOption PORT_OPTION { "p", "listening port for socket (defaults to random)", "port", 0 };
 const QCommandLineOption TARGET_OPTION {
     "target", "target for sent packets (default is listen only)",
@@ -55,6 +57,16 @@ const QCommandLineOption MESSAGE_SEED {
 const QCommandLineOption STATS_INTERVAL {
     "stats-interval", "stats output interval (default is 100ms)", "milliseconds"
 };
+const QCommandLineOption EMULATE_LINK {
+    "emulate-link", "relay packets between senders and this receiver over an emulated link, on the listening port",
+    "IP:PORT"
+};
+const QCommandLineOption LINK_DELAY {
+    "link-delay", "one-way delay of the emulated link (default is 50ms, for a 100ms RTT)", "milliseconds"
+};
+const QCommandLineOption LINK_LOSS {
+    "link-loss", "random loss of the emulated link (default is 1%)", "percent"
+};
 
 const QStringList CLIENT_STATS_TABLE_HEADERS {
     "Send (Mb/s)", "Est. Max (Mb/s)", "RTT (ms)", "CW (P)", "Period (us)",
@@ -75,6 +87,36 @@ UDTTest::UDTTest(int& argc, char** argv) :
     
     parseArguments();
     
+    if (_argumentParser.isSet(EMULATE_LINK)) {
+        // this is only a link between a sender and a receiver, e.g. for the high bandwidth-delay product scenario
+        //   udt-test -p 8000
+        //   udt-test -p 8001 --emulate-link 127.0.0.1:8000
+        //   udt-test --target 127.0.0.1:8001 --max-send-bytes 100000000
+        // which sends through a 100ms RTT link with 1% loss
+        QString hostnamePortString = _argumentParser.value(EMULATE_LINK);
+        QHostAddress address { hostnamePortString.left(hostnamePortString.indexOf(':')) };
+        quint16 port { (quint16) hostnamePortString.mid(hostnamePortString.indexOf(':') + 1).toUInt() };
+        
+        if (address.isNull() || port == 0) {
+            qCritical() << "Could not parse an IP address and port combination from" << hostnamePortString;
+            QMetaObject::invokeMethod(this, "quit", Qt::QueuedConnection);
+            return;
+        }
+        
+        static const int DEFAULT_LINK_DELAY_MSECS = 50;
+        static const float DEFAULT_LINK_LOSS_PERCENT = 1.0f;
+        
+        int delay = _argumentParser.isSet(LINK_DELAY)
+            ? _argumentParser.value(LINK_DELAY).toInt() : DEFAULT_LINK_DELAY_MSECS;
+        float lossPercent = _argumentParser.isSet(LINK_LOSS)
+            ? _argumentParser.value(LINK_LOSS).toFloat() : DEFAULT_LINK_LOSS_PERCENT;
+        
+        // the emulator takes the listening port, so our own socket is not used
+        new LinkEmulator(_argumentParser.value(PORT_OPTION).toUInt(), HifiSockAddr(address, port),
+                         delay, lossPercent / 100.0f, this);
+        return;
+    }
+    
     // randomize the seed for packet size randomization
     srand(time(NULL));
 
@@ -228,7 +270,7 @@ void UDTTest::parseArguments() {
     _argumentParser.addOptions({
         PORT_OPTION, TARGET_OPTION, PACKET_SIZE, MIN_PACKET_SIZE, MAX_PACKET_SIZE,
         MAX_SEND_BYTES, MAX_SEND_PACKETS, UNRELIABLE_PACKETS, ORDERED_PACKETS,
-        MESSAGE_SIZE, MESSAGE_SEED, STATS_INTERVAL
+        MESSAGE_SIZE, MESSAGE_SEED, STATS_INTERVAL, EMULATE_LINK, LINK_DELAY, LINK_LOSS
     });
     
     if (!_argumentParser.parse(arguments())) {
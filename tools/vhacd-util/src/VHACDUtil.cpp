@@ -11,6 +11,9 @@
 
 #include "VHACDUtil.h"
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
 #include <unordered_map>
 #include <QVector>
 
@@ -287,153 +290,92 @@ float computeDt(uint64_t start) {
     return (float)(usecTimestampNow() - start) / (float)USECS_PER_SECOND;
 }
 
-bool vhacd::VHACDUtil::computeVHACD(FBXGeometry& geometry,
-                                    VHACD::IVHACD::Parameters params,
-                                    FBXGeometry& result,
-                                    float minimumMeshSize, float maximumMeshSize) {
-    if (_verbose) {
-        qDebug() << "meshes =" << geometry.meshes.size();
+// appends to resultMesh the hulls of the parts of mesh, returns the number of parts that were decomposed
+int vhacd::VHACDUtil::decomposeMesh(const FBXMesh& mesh, const glm::mat4& geometryOffset, int meshIndex,
+                                    VHACD::IVHACD* convexifier, const VHACD::IVHACD::Parameters& params,
+                                    FBXMesh& resultMesh, float minimumMeshSize, float maximumMeshSize) const {
+    const uint32_t POINT_STRIDE = 3;
+    const uint32_t TRIANGLE_STRIDE = 3;
+
+    // find duplicate points
+    int numDupes = 0;
+    std::vector<int> dupeIndexMap;
+    dupeIndexMap.reserve(mesh.vertices.size());
+    for (int i = 0; i < mesh.vertices.size(); ++i) {
+        dupeIndexMap.push_back(i);
+        for (int j = 0; j < i; ++j) {
+            float distance = glm::distance2(mesh.vertices[i], mesh.vertices[j]);
+            const float MAX_DUPE_DISTANCE_SQUARED = 0.000001f;
+            if (distance < MAX_DUPE_DISTANCE_SQUARED) {
+                dupeIndexMap[i] = j;
+                ++numDupes;
+                break;
+            }
+        }
     }
 
-    // count the mesh-parts
-    int numParts = 0;
-    foreach (const FBXMesh& mesh, geometry.meshes) {
-        numParts += mesh.parts.size();
+    // each mesh has its own transform to move it to model-space
+    std::vector<glm::vec3> vertices;
+    glm::mat4 totalTransform = geometryOffset * mesh.modelTransform;
+    foreach (glm::vec3 vertex, mesh.vertices) {
+        vertices.push_back(glm::vec3(totalTransform * glm::vec4(vertex, 1.0f)));
     }
+    uint32_t numVertices = (uint32_t)vertices.size();
+
     if (_verbose) {
-        qDebug() << "total parts =" << numParts;
+        qDebug() << "mesh" << meshIndex << ": "
+            << " parts =" << mesh.parts.size() << " clusters =" << mesh.clusters.size()
+            << " vertices =" << numVertices;
     }
 
-    VHACD::IVHACD * convexifier = VHACD::CreateVHACD();
+    std::vector<int> openParts;
 
-    result.meshExtents.reset();
-    result.meshes.append(FBXMesh());
-    FBXMesh &resultMesh = result.meshes.last();
-
-    const uint32_t POINT_STRIDE = 3;
-    const uint32_t TRIANGLE_STRIDE = 3;
-
-    int meshIndex = 0;
+    int partIndex = 0;
     int validPartsFound = 0;
-    foreach (const FBXMesh& mesh, geometry.meshes) {
+    std::vector<int> triangleIndices;
+    foreach (const FBXMeshPart &meshPart, mesh.parts) {
+        triangleIndices.clear();
+        getTrianglesInMeshPart(meshPart, triangleIndices);
 
-        // find duplicate points
-        int numDupes = 0;
-        std::vector<int> dupeIndexMap;
-        dupeIndexMap.reserve(mesh.vertices.size());
-        for (int i = 0; i < mesh.vertices.size(); ++i) {
-            dupeIndexMap.push_back(i);
-            for (int j = 0; j < i; ++j) {
-                float distance = glm::distance2(mesh.vertices[i], mesh.vertices[j]);
-                const float MAX_DUPE_DISTANCE_SQUARED = 0.000001f;
-                if (distance < MAX_DUPE_DISTANCE_SQUARED) {
-                    dupeIndexMap[i] = j;
-                    ++numDupes;
-                    break;
-                }
+        // only process meshes with triangles
+        if (triangleIndices.size() <= 0) {
+            if (_verbose) {
+                qDebug() << "  skip part" << partIndex << "(zero triangles)";
             }
+            ++partIndex;
+            continue;
         }
 
-        // each mesh has its own transform to move it to model-space
-        std::vector<glm::vec3> vertices;
-        glm::mat4 totalTransform = geometry.offset * mesh.modelTransform;
-        foreach (glm::vec3 vertex, mesh.vertices) {
-            vertices.push_back(glm::vec3(totalTransform * glm::vec4(vertex, 1.0f)));
-        }
-        uint32_t numVertices = (uint32_t)vertices.size();
-
-        if (_verbose) {
-            qDebug() << "mesh" << meshIndex << ": "
-                << " parts =" << mesh.parts.size() << " clusters =" << mesh.clusters.size()
-                << " vertices =" << numVertices;
+        // collapse dupe indices
+        for (auto& index : triangleIndices) {
+            index = dupeIndexMap[index];
         }
-        ++meshIndex;
-
-        std::vector<int> openParts;
-
-        int partIndex = 0;
-        std::vector<int> triangleIndices;
-        foreach (const FBXMeshPart &meshPart, mesh.parts) {
-            triangleIndices.clear();
-            getTrianglesInMeshPart(meshPart, triangleIndices);
 
-            // only process meshes with triangles
-            if (triangleIndices.size() <= 0) {
-                if (_verbose) {
-                    qDebug() << "  skip part" << partIndex << "(zero triangles)";
-                }
-                ++partIndex;
-                continue;
-            }
-
-            // collapse dupe indices
-            for (auto& index : triangleIndices) {
-                index = dupeIndexMap[index];
-            }
+        AABox aaBox = getAABoxForMeshPart(mesh, meshPart);
+        const float largestDimension = aaBox.getLargestDimension();
 
-            AABox aaBox = getAABoxForMeshPart(mesh, meshPart);
-            const float largestDimension = aaBox.getLargestDimension();
-
-            if (largestDimension < minimumMeshSize) {
-                if (_verbose) {
-                    qDebug() << "  skip part" << partIndex << ":  dimension =" << largestDimension << "(too small)";
-                }
-                ++partIndex;
-                continue;
-            }
-
-            if (maximumMeshSize > 0.0f && largestDimension > maximumMeshSize) {
-                if (_verbose) {
-                    qDebug() << "  skip part" << partIndex << ":  dimension =" << largestDimension << "(too large)";
-                }
-                ++partIndex;
-                continue;
-            }
-
-            // figure out if the mesh is a closed manifold or not
-            bool closed = isClosedManifold(triangleIndices);
-            if (closed) {
-                uint32_t triangleCount = (uint32_t)(triangleIndices.size()) / TRIANGLE_STRIDE;
-                if (_verbose) {
-                    qDebug() << "  process closed part" << partIndex << ": " << " triangles =" << triangleCount;
-                }
-
-                // compute approximate convex decomposition
-                bool success = convexifier->Compute(&vertices[0].x, POINT_STRIDE, numVertices,
-                        &triangleIndices[0], TRIANGLE_STRIDE, triangleCount, params);
-                if (success) {
-                    getConvexResults(convexifier, resultMesh);
-                } else if (_verbose) {
-                    qDebug() << "  failed to convexify";
-                }
-            } else {
-                if (_verbose) {
-                    qDebug() << "  postpone open part" << partIndex;
-                }
-                openParts.push_back(partIndex);
+        if (largestDimension < minimumMeshSize) {
+            if (_verbose) {
+                qDebug() << "  skip part" << partIndex << ":  dimension =" << largestDimension << "(too small)";
             }
             ++partIndex;
-            ++validPartsFound;
+            continue;
         }
-        if (! openParts.empty()) {
-            // combine open meshes in an attempt to produce a closed mesh
-
-            triangleIndices.clear();
-            for (auto index : openParts) {
-                const FBXMeshPart &meshPart = mesh.parts[index];
-                getTrianglesInMeshPart(meshPart, triangleIndices);
-            }
 
-            // collapse dupe indices
-            for (auto& index : triangleIndices) {
-                index = dupeIndexMap[index];
+        if (maximumMeshSize > 0.0f && largestDimension > maximumMeshSize) {
+            if (_verbose) {
+                qDebug() << "  skip part" << partIndex << ":  dimension =" << largestDimension << "(too large)";
             }
+            ++partIndex;
+            continue;
+        }
 
-            // this time we don't care if the parts are closed or not
+        // figure out if the mesh is a closed manifold or not
+        bool closed = isClosedManifold(triangleIndices);
+        if (closed) {
             uint32_t triangleCount = (uint32_t)(triangleIndices.size()) / TRIANGLE_STRIDE;
             if (_verbose) {
-                qDebug() << "  process remaining open parts =" << openParts.size() << ": "
-                    << " triangles =" << triangleCount;
+                qDebug() << "  process closed part" << partIndex << ": " << " triangles =" << triangleCount;
             }
 
             // compute approximate convex decomposition
@@ -444,16 +386,135 @@ bool vhacd::VHACDUtil::computeVHACD(FBXGeometry& geometry,
             } else if (_verbose) {
                 qDebug() << "  failed to convexify";
             }
+        } else {
+            if (_verbose) {
+                qDebug() << "  postpone open part" << partIndex;
+            }
+            openParts.push_back(partIndex);
+        }
+        ++partIndex;
+        ++validPartsFound;
+    }
+    if (! openParts.empty()) {
+        // combine open meshes in an attempt to produce a closed mesh
+
+        triangleIndices.clear();
+        for (auto index : openParts) {
+            const FBXMeshPart &meshPart = mesh.parts[index];
+            getTrianglesInMeshPart(meshPart, triangleIndices);
+        }
+
+        // collapse dupe indices
+        for (auto& index : triangleIndices) {
+            index = dupeIndexMap[index];
+        }
+
+        // this time we don't care if the parts are closed or not
+        uint32_t triangleCount = (uint32_t)(triangleIndices.size()) / TRIANGLE_STRIDE;
+        if (_verbose) {
+            qDebug() << "  process remaining open parts =" << openParts.size() << ": "
+                << " triangles =" << triangleCount;
+        }
+
+        // compute approximate convex decomposition
+        bool success = convexifier->Compute(&vertices[0].x, POINT_STRIDE, numVertices,
+                &triangleIndices[0], TRIANGLE_STRIDE, triangleCount, params);
+        if (success) {
+            getConvexResults(convexifier, resultMesh);
+        } else if (_verbose) {
+            qDebug() << "  failed to convexify";
+        }
+    }
+    return validPartsFound;
+}
+
+bool vhacd::VHACDUtil::computeVHACD(FBXGeometry& geometry,
+                                    VHACD::IVHACD::Parameters params,
+                                    FBXGeometry& result,
+                                    float minimumMeshSize, float maximumMeshSize) {
+    if (_verbose) {
+        qDebug() << "meshes =" << geometry.meshes.size();
+    }
+
+    // count the mesh-parts
+    int numParts = 0;
+    foreach (const FBXMesh& mesh, geometry.meshes) {
+        numParts += mesh.parts.size();
+    }
+    if (_verbose) {
+        qDebug() << "total parts =" << numParts;
+    }
+
+    // the meshes are decomposed concurrently, each into a mesh of its own, by threads taking the next mesh in turn
+    int numMeshes = geometry.meshes.size();
+    int numThreads = std::max(1, std::min(_numThreads, numMeshes));
+    if (numThreads > 1) {
+        // the progress of several decompositions would be printed over each other
+        params.m_callback = nullptr;
+    }
+
+    std::vector<FBXMesh> meshResults(numMeshes);
+    std::atomic<int> nextMesh { 0 };
+    std::atomic<int> validPartsFound { 0 };
+    auto decompose = [&] {
+        VHACD::IVHACD* convexifier = VHACD::CreateVHACD();
+        for (int i = nextMesh++; i < numMeshes; i = nextMesh++) {
+            validPartsFound += decomposeMesh(geometry.meshes[i], geometry.offset, i, convexifier, params,
+                                             meshResults[i], minimumMeshSize, maximumMeshSize);
         }
+
+        //release memory
+        convexifier->Clean();
+        convexifier->Release();
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 1; i < numThreads; i++) {
+        threads.emplace_back(decompose);
+    }
+    decompose();
+    for (auto& thread : threads) {
+        thread.join();
     }
 
-    //release memory
-    convexifier->Clean();
-    convexifier->Release();
+    // gather the hulls of all the meshes in one, in the order of the meshes
+    result.meshExtents.reset();
+    result.meshes.append(FBXMesh());
+    FBXMesh &resultMesh = result.meshes.last();
+    for (auto& meshResult : meshResults) {
+        int indexOffset = resultMesh.vertices.size();
+        resultMesh.vertices += meshResult.vertices;
+        for (auto& part : meshResult.parts) {
+            for (auto& index : part.triangleIndices) {
+                index += indexOffset;
+            }
+            resultMesh.parts.append(part);
+        }
+    }
 
     return validPartsFound > 0;
 }
 
+ShapeInfo::PointCollection vhacd::VHACDUtil::getHullPoints(const FBXMesh& resultMesh) {
+    ShapeInfo::PointCollection pointCollection;
+    pointCollection.reserve(resultMesh.parts.size());
+    std::vector<bool> isInHull(resultMesh.vertices.size(), false);
+    foreach (const FBXMeshPart& meshPart, resultMesh.parts) {
+        // the vertices of each hull are only used by its own triangles
+        ShapeInfo::PointList points;
+        for (auto index : meshPart.triangleIndices) {
+            if (!isInHull[index]) {
+                isInHull[index] = true;
+                points.push_back(resultMesh.vertices[index]);
+            }
+        }
+        if (!points.isEmpty()) {
+            pointCollection.push_back(points);
+        }
+    }
+    return pointCollection;
+}
+
 vhacd::VHACDUtil:: ~VHACDUtil(){
     //nothing to be cleaned
 }
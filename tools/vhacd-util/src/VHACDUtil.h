@@ -20,12 +20,16 @@
 #include <QFile>
 #include <FBXReader.h>
 #include <OBJReader.h>
+#include <ShapeInfo.h>
 #include <VHACD.h>
 
 namespace vhacd {
     class VHACDUtil {
     public:
         void setVerbose(bool verbose) { _verbose = verbose; }
+        bool isVerbose() const { return _verbose; }
+        // how many meshes of a model computeVHACD decomposes at the same time
+        void setNumThreads(int numThreads) { _numThreads = numThreads; }
 
         bool loadFBX(const QString filename, FBXGeometry& result);
 
@@ -38,10 +42,18 @@ namespace vhacd {
 
         void getConvexResults(VHACD::IVHACD* convexifier, FBXMesh& resultMesh) const;
 
+        // the hulls of resultMesh as the point collection of a compound shape
+        static ShapeInfo::PointCollection getHullPoints(const FBXMesh& resultMesh);
+
         ~VHACDUtil();
 
     private:
+        int decomposeMesh(const FBXMesh& mesh, const glm::mat4& geometryOffset, int meshIndex,
+                          VHACD::IVHACD* convexifier, const VHACD::IVHACD::Parameters& params,
+                          FBXMesh& resultMesh, float minimumMeshSize, float maximumMeshSize) const;
+
         bool _verbose { false };
+        int _numThreads { 1 };
     };
 
     class ProgressCallback : public VHACD::IVHACD::IUserCallback {
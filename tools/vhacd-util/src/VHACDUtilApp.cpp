@@ -9,7 +9,13 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
 #include <QCommandLineParser>
+#include <QRegExp>
+#include <QTextStream>
 #include <VHACD.h>
 #include "VHACDUtilApp.h"
 #include "VHACDUtil.h"
@@ -93,6 +99,139 @@ bool VHACDUtilApp::writeOBJ(QString outFileName, FBXGeometry& geometry, bool out
 
 
 
+bool VHACDUtilApp::writeHulls(QString outFileName, const FBXGeometry& geometry) {
+    QFile file(outFileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "unable to write to" << outFileName;
+        _returnCode = VHACD_RETURN_CODE_FAILURE_TO_WRITE;
+        return false;
+    }
+    file.write(ShapeInfo::writePointCollection(vhacd::VHACDUtil::getHullPoints(geometry.meshes[0])));
+    return true;
+}
+
+bool VHACDUtilApp::generateModelHulls(vhacd::VHACDUtil& vUtil, FBXGeometry& fbx, const VHACD::IVHACD::Parameters& params,
+                                      float minimumMeshSize, float maximumMeshSize, QString outputFilename,
+                                      bool outputCentimeters, bool outputHulls) {
+    //perform vhacd computation
+    if (vUtil.isVerbose()) {
+        qDebug() << "running V-HACD algorithm ...";
+    }
+    auto begin = std::chrono::high_resolution_clock::now();
+
+    FBXGeometry result;
+    bool success = vUtil.computeVHACD(fbx, params, result, minimumMeshSize, maximumMeshSize);
+
+    auto end = std::chrono::high_resolution_clock::now();
+    auto computeDuration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count();
+    if (vUtil.isVerbose()) {
+        qDebug() << "run time =" << (double)computeDuration / 1000000000.00 << " seconds";
+    }
+
+    if (!success) {
+        if (vUtil.isVerbose()) {
+            qDebug() << "failed to convexify model";
+        }
+        _returnCode = VHACD_RETURN_CODE_FAILURE_TO_CONVEXIFY;
+        return false;
+    }
+
+    int totalVertices = 0;
+    int totalTriangles = 0;
+    foreach (const FBXMesh& mesh, result.meshes) {
+        totalVertices += mesh.vertices.size();
+        foreach (const FBXMeshPart &meshPart, mesh.parts) {
+            totalTriangles += meshPart.triangleIndices.size() / 3;
+            // each quad was made into two triangles
+            totalTriangles += 2 * meshPart.quadIndices.size() / 4;
+        }
+    }
+
+    if (vUtil.isVerbose()) {
+        int totalHulls = result.meshes[0].parts.size();
+        qDebug() << "output file =" << outputFilename;
+        qDebug() << "vertices =" << totalVertices;
+        qDebug() << "triangles =" << totalTriangles;
+        qDebug() << "hulls =" << totalHulls;
+    }
+
+    if (!writeOBJ(outputFilename, result, outputCentimeters)) {
+        return false;
+    }
+    if (outputHulls) {
+        QVector<QString> outfileExtensions = { "obj" };
+        return writeHulls(fileNameWithoutExtension(outputFilename, outfileExtensions) + ".hulls", result);
+    }
+    return true;
+}
+
+void VHACDUtilApp::generateBatchHulls(QString batchFilename, bool verbose, int numThreads,
+                                      const VHACD::IVHACD::Parameters& params, float minimumMeshSize,
+                                      float maximumMeshSize, bool outputCentimeters, bool outputHulls) {
+    QFile batchFile(batchFilename);
+    if (!batchFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        qWarning() << "unable to open batch file =" << batchFilename;
+        _returnCode = VHACD_RETURN_CODE_FAILURE_TO_READ;
+        return;
+    }
+
+    std::vector<std::pair<QString, QString>> models;
+    QTextStream in(&batchFile);
+    while (!in.atEnd()) {
+        QStringList files = in.readLine().split(QRegExp("\\s+"), QString::SkipEmptyParts);
+        if (files.size() == 2) {
+            models.emplace_back(files[0], files[1]);
+        } else if (!files.isEmpty()) {
+            qWarning() << "skipping batch line without an input and an output file =" << files.join(" ");
+        }
+    }
+
+    // the models are spread over the threads, and the threads left over go to the meshes of each model
+    int numModelThreads = std::max(1, std::min(numThreads, (int)models.size()));
+    int numMeshThreads = std::max(1, numThreads / numModelThreads);
+
+    // the progress of several decompositions would be printed over each other
+    VHACD::IVHACD::Parameters batchParams = params;
+    batchParams.m_callback = nullptr;
+
+    std::atomic<int> nextModel { 0 };
+    std::atomic<int> numFailed { 0 };
+    auto generate = [&] {
+        for (int i = nextModel++; i < (int)models.size(); i = nextModel++) {
+            vhacd::VHACDUtil vUtil;
+            vUtil.setVerbose(verbose);
+            vUtil.setNumThreads(numMeshThreads);
+
+            FBXGeometry fbx;
+            if (!vUtil.loadFBX(models[i].first, fbx)) {
+                _returnCode = VHACD_RETURN_CODE_FAILURE_TO_READ;
+                ++numFailed;
+                continue;
+            }
+            if (!generateModelHulls(vUtil, fbx, batchParams, minimumMeshSize, maximumMeshSize, models[i].second,
+                                    outputCentimeters, outputHulls)) {
+                qWarning() << "failed to generate the hulls of" << models[i].first;
+                ++numFailed;
+            }
+        }
+    };
+
+    auto begin = std::chrono::high_resolution_clock::now();
+    std::vector<std::thread> threads;
+    for (int i = 1; i < numModelThreads; i++) {
+        threads.emplace_back(generate);
+    }
+    generate();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+
+    auto batchDuration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count();
+    qDebug() << "decomposed" << (int)models.size() - numFailed << "of" << models.size() << "models in"
+        << (double)batchDuration / 1000000000.00 << "seconds";
+}
+
 VHACDUtilApp::VHACDUtilApp(int argc, char* argv[]) :
     QCoreApplication(argc, argv)
 {
@@ -126,6 +265,18 @@ VHACDUtilApp::VHACDUtilApp(int argc, char* argv[]) :
     const QCommandLineOption outputCentimetersOption("c", "output units are centimeters");
     parser.addOption(outputCentimetersOption);
 
+    const QCommandLineOption outputHullsOption("hulls", "with -g, also write the hulls next to each output file, "
+                                               "as a .hulls point collection that ShapeInfo loads without parsing");
+    parser.addOption(outputHullsOption);
+
+    const QCommandLineOption batchOption("batch", "with -g, decompose many models in parallel, read from a file with "
+                                         "one \"input-file output-file\" pair per line", "batch.txt");
+    parser.addOption(batchOption);
+
+    const QCommandLineOption threadsOption("j", "number of threads, shared between the models of a batch and the "
+                                           "meshes of a model (default: one per core)", "threads");
+    parser.addOption(threadsOption);
+
     const QCommandLineOption minimumMeshSizeOption("m", "minimum mesh (diagonal) size to consider", "0");
     parser.addOption(minimumMeshSizeOption);
 
@@ -212,13 +363,25 @@ VHACDUtilApp::VHACDUtilApp(int argc, char* argv[]) :
     }
 
 
-    if (inputFilename == "") {
+    QString batchFilename;
+    if (parser.isSet(batchOption)) {
+        batchFilename = parser.value(batchOption);
+    }
+
+    int numThreads = std::max(1, (int)std::thread::hardware_concurrency());
+    if (parser.isSet(threadsOption)) {
+        numThreads = std::max(1, parser.value(threadsOption).toInt());
+    }
+
+    bool outputHulls = parser.isSet(outputHullsOption);
+
+    if (inputFilename == "" && batchFilename == "") {
         cerr << "input filename is required.";
         parser.showHelp();
         Q_UNREACHABLE();
     }
 
-    if (outputFilename == "") {
+    if (outputFilename == "" && batchFilename == "") {
         cerr << "output filename is required.";
         parser.showHelp();
         Q_UNREACHABLE();
@@ -290,6 +453,43 @@ VHACDUtilApp::VHACDUtilApp(int argc, char* argv[]) :
         Q_UNREACHABLE();
     }
 
+    VHACD::IVHACD::Parameters params;
+    vhacd::ProgressCallback progressCallback;
+
+    //set parameters for V-HACD
+    if (verbose) {
+        params.m_callback = &progressCallback; //progress callback
+    } else {
+        params.m_callback = nullptr;
+    }
+    params.m_resolution = vHacdResolution;
+    params.m_depth = vHacdDepth;
+    params.m_concavity = vHacdConcavity;
+    params.m_delta = vHacdDelta;
+    params.m_planeDownsampling = vHacdPlanedownsampling;
+    params.m_convexhullDownsampling = vHacdConvexhulldownsampling;
+    params.m_alpha = vHacdAlpha;
+    params.m_beta = vHacdBeta;
+    params.m_gamma = vHacdGamma;
+    params.m_pca = 0; // 0  enable/disable normalizing the mesh before applying the convex decomposition
+    params.m_mode = 0; // 0: voxel-based (recommended), 1: tetrahedron-based
+    params.m_maxNumVerticesPerCH = vHacdMaxVerticesPerCH;
+    params.m_minVolumePerCH = 0.0001; // 0.0001
+    params.m_logger = nullptr;
+    params.m_convexhullApproximation = true; // true
+    params.m_oclAcceleration = true; // true
+
+    if (!batchFilename.isEmpty()) {
+        if (!generateHulls) {
+            cerr << "\nThe batch mode only generates hulls, use -g\n\n";
+            parser.showHelp();
+            Q_UNREACHABLE();
+        }
+        generateBatchHulls(batchFilename, verbose, numThreads, params, minimumMeshSize, maximumMeshSize,
+                           outputCentimeters, outputHulls);
+        return;
+    }
+
     // load the mesh
     FBXGeometry fbx;
     auto begin = std::chrono::high_resolution_clock::now();
@@ -320,75 +520,11 @@ VHACDUtilApp::VHACDUtilApp(int argc, char* argv[]) :
     }
 
     if (generateHulls) {
-        VHACD::IVHACD::Parameters params;
-        vhacd::ProgressCallback progressCallback;
-
-        //set parameters for V-HACD
-        if (verbose) {
-            params.m_callback = &progressCallback; //progress callback
-        } else {
-            params.m_callback = nullptr;
-        }
-        params.m_resolution = vHacdResolution;
-        params.m_depth = vHacdDepth;
-        params.m_concavity = vHacdConcavity;
-        params.m_delta = vHacdDelta;
-        params.m_planeDownsampling = vHacdPlanedownsampling;
-        params.m_convexhullDownsampling = vHacdConvexhulldownsampling;
-        params.m_alpha = vHacdAlpha;
-        params.m_beta = vHacdBeta;
-        params.m_gamma = vHacdGamma;
-        params.m_pca = 0; // 0  enable/disable normalizing the mesh before applying the convex decomposition
-        params.m_mode = 0; // 0: voxel-based (recommended), 1: tetrahedron-based
-        params.m_maxNumVerticesPerCH = vHacdMaxVerticesPerCH;
-        params.m_minVolumePerCH = 0.0001; // 0.0001
-        params.m_logger = nullptr;
-        params.m_convexhullApproximation = true; // true
-        params.m_oclAcceleration = true; // true
-
-        //perform vhacd computation
-        if (verbose) {
-            qDebug() << "running V-HACD algorithm ...";
-        }
-        begin = std::chrono::high_resolution_clock::now();
-
-        FBXGeometry result;
-        bool success = vUtil.computeVHACD(fbx, params, result, minimumMeshSize, maximumMeshSize);
-
-        end = std::chrono::high_resolution_clock::now();
-        auto computeDuration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count();
-        if (verbose) {
-            qDebug() << "run time =" << (double)computeDuration / 1000000000.00 << " seconds";
-        }
-
-        if (!success) {
-            if (verbose) {
-                qDebug() << "failed to convexify model";
-            }
-            _returnCode = VHACD_RETURN_CODE_FAILURE_TO_CONVEXIFY;
+        vUtil.setNumThreads(numThreads);
+        if (!generateModelHulls(vUtil, fbx, params, minimumMeshSize, maximumMeshSize, outputFilename,
+                                outputCentimeters, outputHulls)) {
             return;
         }
-
-        int totalVertices = 0;
-        int totalTriangles = 0;
-        foreach (const FBXMesh& mesh, result.meshes) {
-            totalVertices += mesh.vertices.size();
-            foreach (const FBXMeshPart &meshPart, mesh.parts) {
-                totalTriangles += meshPart.triangleIndices.size() / 3;
-                // each quad was made into two triangles
-                totalTriangles += 2 * meshPart.quadIndices.size() / 4;
-            }
-        }
-
-        if (verbose) {
-            int totalHulls = result.meshes[0].parts.size();
-            qDebug() << "output file =" << outputFilename;
-            qDebug() << "vertices =" << totalVertices;
-            qDebug() << "triangles =" << totalTriangles;
-            qDebug() << "hulls =" << totalHulls;
-        }
-
-        writeOBJ(outputFilename, result, outputCentimeters);
     }
 
     if (fattenFaces) {
@@ -13,10 +13,14 @@
 #ifndef hifi_VHACDUtilApp_h
 #define hifi_VHACDUtilApp_h
 
+#include <atomic>
+
 #include <QApplication>
 
 #include <FBXReader.h>
 
+#include "VHACDUtil.h"
+
 const int VHACD_RETURN_CODE_FAILURE_TO_READ = 1;
 const int VHACD_RETURN_CODE_FAILURE_TO_WRITE = 2;
 const int VHACD_RETURN_CODE_FAILURE_TO_CONVEXIFY = 3;
@@ -29,11 +33,20 @@ public:
     ~VHACDUtilApp();
 
     bool writeOBJ(QString outFileName, FBXGeometry& geometry, bool outputCentimeters, int whichMeshPart = -1);
+    bool writeHulls(QString outFileName, const FBXGeometry& geometry);
 
     int getReturnCode() const { return _returnCode; }
 
 private:
-    int _returnCode { 0 };
+    bool generateModelHulls(vhacd::VHACDUtil& vUtil, FBXGeometry& fbx, const VHACD::IVHACD::Parameters& params,
+                            float minimumMeshSize, float maximumMeshSize, QString outputFilename,
+                            bool outputCentimeters, bool outputHulls);
+    void generateBatchHulls(QString batchFilename, bool verbose, int numThreads,
+                            const VHACD::IVHACD::Parameters& params, float minimumMeshSize, float maximumMeshSize,
+                            bool outputCentimeters, bool outputHulls);
+
+    // set by the threads of a batch
+    std::atomic<int> _returnCode { 0 };
 };
 
 